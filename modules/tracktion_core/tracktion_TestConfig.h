@@ -11,6 +11,7 @@
 // Defined in tracktion_core
 #define TRACKTION_UNIT_TESTS_TIME                       1
 #define TRACKTION_UNIT_TESTS_ALGORITHM                  1
+#define TRACKTION_UNIT_TESTS_CONTENT_HASH               1
 
 // Defined in tracktion_engine
 #define GRAPH_UNIT_TESTS_WAVENODE                       1
@@ -21,14 +22,18 @@
 #define ENGINE_UNIT_TESTS_AUTOMATION                    1
 #define ENGINE_UNIT_TESTS_AUTOMATION_CURVE_LIST         1
 #define ENGINE_UNIT_TESTS_AUX_SEND                      1
+#define ENGINE_UNIT_TESTS_BINARY_EDIT_FILE              1
 #define ENGINE_UNIT_TESTS_CLICKNODE                     1
 #define ENGINE_UNIT_TESTS_CLIPBOARD                     1
 #define ENGINE_UNIT_TESTS_CLIPSLOT                      1
 #define ENGINE_UNIT_TESTS_CONSTRAINED_CACHED_VALUE      1
+#define ENGINE_UNIT_TESTS_CONVOLUTION                   1
 #define ENGINE_UNIT_TESTS_DELAY_PLUGIN                  1
 #define ENGINE_UNIT_TESTS_EDIT                          1
 #define ENGINE_UNIT_TESTS_EDITCLIP                      1
+#define ENGINE_UNIT_TESTS_EDIT_FILE_OPERATIONS          1
 #define ENGINE_UNIT_TESTS_EDIT_LOADER                   1
+#define ENGINE_UNIT_TESTS_EDIT_SNAPSHOT                 1
 #define ENGINE_UNIT_TESTS_EDIT_TIME                     1
 #define ENGINE_UNIT_TESTS_FREEZE                        1
 #define ENGINE_UNIT_TESTS_FOLLOW_ACTIONS                1
@@ -38,12 +43,14 @@
 #define ENGINE_UNIT_TESTS_LAUNCH_QUANTISATION           1
 #define ENGINE_UNIT_TESTS_LOOPINGMIDINODE               1
 #define ENGINE_UNIT_TESTS_LOOP_INFO                     1
+#define ENGINE_UNIT_TESTS_LOUDNESS_METER                1
 #define ENGINE_UNIT_TESTS_MIDILIST                      1
 #define ENGINE_UNIT_TESTS_MODIFIERS                     1
 #define ENGINE_UNIT_TESTS_PAN_LAW                       1
 #define ENGINE_UNIT_TESTS_PLAYBACK                      1
 #define ENGINE_UNIT_TESTS_PLUGINS                       1
 #define ENGINE_UNIT_TESTS_PDC                           1
+#define ENGINE_UNIT_TESTS_PROJECT_SEARCH_INDEX          1
 #define ENGINE_UNIT_TESTS_RACKINSTANCE                  1
 #define ENGINE_UNIT_TESTS_RECORDING                     1
 #define ENGINE_UNIT_TESTS_RENDERING                     1
@@ -52,6 +59,8 @@
 #define ENGINE_UNIT_TESTS_SELECTABLE                    1
 #define ENGINE_UNIT_TESTS_AUDIO_FILE                    1
 #define ENGINE_UNIT_TESTS_AUDIO_FILE_CACHE              1
+#define ENGINE_UNIT_TESTS_AUDIO_FILE_INFO_CACHE         1
+#define ENGINE_UNIT_TESTS_MIPMAP_THUMBNAIL              1
 #define ENGINE_UNIT_TESTS_VOLPANPLUGIN                  1
 #define ENGINE_UNIT_TESTS_TEMPO_SEQUENCE                1
 #define ENGINE_UNIT_TESTS_QUANTISATION_TYPE             1
@@ -63,17 +72,34 @@
 #define GRAPH_UNIT_TESTS_PLAYHEADSTATE                  1
 #define GRAPH_UNIT_TESTS_NODE                           1
 #define GRAPH_UNIT_TESTS_NODEVISITING                   1
+#define GRAPH_UNIT_TESTS_GRAPHEXPORT                    1
+#define GRAPH_UNIT_TESTS_RANDOMGRAPH                    1
 #define GRAPH_UNIT_TESTS_SAMPLECONVERSION               1
 #define GRAPH_UNIT_TESTS_CONNECTEDNODE                  1
+#define GRAPH_UNIT_TESTS_LATENCYCOMPENSATIONUPDATER     1
+#define GRAPH_UNIT_TESTS_SHAREDNODETHREADPOOL           1
 
 #define GRAPH_UNIT_TESTS_AUDIOBUFFERPOOL                1
+#define GRAPH_UNIT_TESTS_NODEPROFILER                   1
+#define GRAPH_UNIT_TESTS_PACKEDMIDIBUFFER               1
+#define GRAPH_UNIT_TESTS_TRACERECORDER                  1
+#define GRAPH_UNIT_TESTS_MIRROREDAUDIOFIFO              1
+#define GRAPH_UNIT_TESTS_SUMMINGKERNELS                 1
+#define GRAPH_UNIT_TESTS_LEVELKERNELS                   1
 #define GRAPH_UNIT_TESTS_SEMAPHORE                      1
 #define GRAPH_UNIT_TESTS_ALLOCATION                     1
+#define GRAPH_UNIT_TESTS_DEFERREDDELETER                1
+#define GRAPH_UNIT_TESTS_LOCKFREEOBJECT                 1
+#define GRAPH_UNIT_TESTS_REALTIMESPINLOCK               1
+#define GRAPH_UNIT_TESTS_DEADLINEWORKERPOOL             1
 
 // Benchmarks
 #define CORE_BENCHMARKS_TEMPO                           1
 
 #define GRAPH_BENCHMARKS_THREADS                        1
+#define GRAPH_BENCHMARKS_SUMMING                        1
+#define GRAPH_BENCHMARKS_LOADGENERATION                 1
+#define GRAPH_BENCHMARKS_RANDOMGRAPHS                   1
 
 #define ENGINE_BENCHMARKS_AUTOMATIONITERATOR            1
 #define ENGINE_BENCHMARKS_AUDIOFILECACHE                1
@@ -85,3 +111,5 @@
 #define ENGINE_BENCHMARKS_RACKS                         1
 #define ENGINE_BENCHMARKS_SELECTABLE                    1
 #define ENGINE_BENCHMARKS_PLUGINNODE                    1
+#define ENGINE_BENCHMARKS_HEADLESSENGINE                1
+#define ENGINE_BENCHMARKS_EDITPLAYBACK                  1
@@ -52,6 +52,7 @@
 #include "utilities/tracktion_AlgorithmAdapters.h"
 #include "utilities/tracktion_CPU.h"
 #include "utilities/tracktion_Hash.h"
+#include "utilities/tracktion_ContentHash.h"
 #include "utilities/tracktion_Maths.h"
 #include "utilities/tracktion_Tempo.h"
 #include "utilities/tracktion_Time.h"
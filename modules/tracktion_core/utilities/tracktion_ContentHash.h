@@ -0,0 +1,268 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#if __has_include(<choc/memory/choc_xxHash.h>)
+ #include <choc/memory/choc_xxHash.h>
+#else
+ #include "../../3rd_party/choc/memory/choc_xxHash.h"
+#endif
+
+#include <array>
+#include <bit>
+#include <optional>
+#include <span>
+
+namespace tracktion::inline core
+{
+
+//==============================================================================
+//==============================================================================
+/** A 128-bit hash value. */
+struct Hash128
+{
+    uint64_t low = 0, high = 0;
+
+    bool operator== (const Hash128&) const = default;
+
+    /** Returns the hash as a 32 character hex string. */
+    juce::String toString() const
+    {
+        return juce::String::toHexString ((juce::int64) high).paddedLeft ('0', 16)
+             + juce::String::toHexString ((juce::int64) low).paddedLeft ('0', 16);
+    }
+};
+
+//==============================================================================
+//==============================================================================
+/**
+    A fast streaming hasher for content, using xxHash64.
+
+    Unlike hash_combine, which uses std::hash and so can change between platforms
+    and standard libraries, the hashes this creates only depend on the data added.
+    Numbers are added as their little-endian bytes, so the same values give the
+    same hash on every platform, making this suitable for keys that are saved to
+    disk or shared between runs, such as render caches.
+
+    The 128-bit version runs two xxHash64 lanes with different seeds so is
+    half the speed. Use it where collisions must be vanishingly unlikely.
+
+    @code
+    ContentHasher hasher;
+    hasher.add (sampleRate);
+    hasher.add (std::span (samples, numSamples));
+    const auto key = hasher.getHash();
+    @endcode
+*/
+template<int numLanes>
+class BasicContentHasher
+{
+public:
+    static_assert (numLanes == 1 || numLanes == 2);
+
+    /** Creates a hasher with an optional seed. */
+    explicit BasicContentHasher (uint64_t seed = 0)
+        : lanes (createLanes (seed))
+    {
+    }
+
+    //==============================================================================
+    /** Adds some raw bytes. */
+    void add (const void* data, size_t numBytes) noexcept
+    {
+        for (auto& lane : lanes)
+            lane.addInput (data, numBytes);
+    }
+
+    /** Adds the bytes of a string. */
+    void add (std::string_view s) noexcept
+    {
+        add (s.data(), s.size());
+    }
+
+    /** Adds a number or enum as its little-endian bytes. */
+    template<typename Type>
+    requires std::is_arithmetic_v<Type> || std::is_enum_v<Type>
+    void add (Type value) noexcept
+    {
+        const auto bytes = toLittleEndian (value);
+        add (&bytes, sizeof (bytes));
+    }
+
+    /** Adds a block of numbers, such as audio samples.
+        On little-endian platforms this hashes the memory directly so, unlike adding
+        single values, -0 and 0 floating point values hash differently.
+    */
+    template<typename Type>
+    requires std::is_arithmetic_v<Type>
+    void add (std::span<const Type> values) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            add (values.data(), values.size_bytes());
+        }
+        else
+        {
+            for (auto v : values)
+                add (v);
+        }
+    }
+
+    /** Adds a block of numbers. */
+    template<typename Type>
+    requires std::is_arithmetic_v<Type>
+    void add (std::span<Type> values) noexcept
+    {
+        add (std::span<const Type> (values));
+    }
+
+    //==============================================================================
+    /** Returns the hash of everything added so far. More data can still be added afterwards. */
+    auto getHash() const noexcept
+    {
+        if constexpr (numLanes == 1)
+            return lanes[0].getHash();
+        else
+            return Hash128 { lanes[0].getHash(), lanes[1].getHash() };
+    }
+
+private:
+    std::array<choc::hash::xxHash64, (size_t) numLanes> lanes;
+
+    static std::array<choc::hash::xxHash64, (size_t) numLanes> createLanes (uint64_t seed)
+    {
+        if constexpr (numLanes == 1)
+            return { choc::hash::xxHash64 (seed) };
+        else
+            return { choc::hash::xxHash64 (seed), choc::hash::xxHash64 (seed ^ 0x9e3779b97f4a7c15ull) };
+    }
+
+    template<typename Type>
+    static auto toLittleEndian (Type value) noexcept
+    {
+        if constexpr (std::is_enum_v<Type>)
+        {
+            return toLittleEndian (static_cast<std::underlying_type_t<Type>> (value));
+        }
+        else if constexpr (std::is_same_v<Type, bool>)
+        {
+            return static_cast<uint8_t> (value ? 1 : 0);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            // -0 and 0 compare equal so they should hash the same
+            if (value == Type())
+                value = Type();
+
+            if constexpr (sizeof (Type) == 4)
+                return toLittleEndian (std::bit_cast<uint32_t> (static_cast<float> (value)));
+            else
+                return toLittleEndian (std::bit_cast<uint64_t> (static_cast<double> (value)));
+        }
+        else
+        {
+            using Unsigned = std::make_unsigned_t<Type>;
+            auto bits = static_cast<Unsigned> (value);
+
+            if constexpr (std::endian::native == std::endian::big && sizeof (Type) > 1)
+            {
+                Unsigned swapped = 0;
+
+                for (size_t i = 0; i < sizeof (Type); ++i)
+                    swapped |= static_cast<Unsigned> (((bits >> (i * 8)) & 0xff) << ((sizeof (Type) - 1 - i) * 8));
+
+                bits = swapped;
+            }
+
+            return bits;
+        }
+    }
+};
+
+/** A 64-bit content hasher. @see BasicContentHasher */
+using ContentHasher = BasicContentHasher<1>;
+
+/** A 128-bit content hasher. @see BasicContentHasher */
+using ContentHasher128 = BasicContentHasher<2>;
+
+//==============================================================================
+/** Adds the contents of a file to a hasher, reading it in chunks through memory-mapped
+    sections where possible.
+    Returns false if the file couldn't be read.
+*/
+template<int numLanes>
+bool addFileContents (BasicContentHasher<numLanes>& hasher, const juce::File& file)
+{
+    constexpr juce::int64 chunkSize = 32 * 1024 * 1024;
+    const auto fileSize = file.getSize();
+
+    if (! file.existsAsFile())
+        return false;
+
+    for (juce::int64 pos = 0; pos < fileSize;)
+    {
+        const auto numThisTime = std::min (chunkSize, fileSize - pos);
+        juce::MemoryMappedFile mappedChunk (file, { pos, pos + numThisTime }, juce::MemoryMappedFile::readOnly);
+
+        // Mapping can fail, for example on some network drives, so read the rest instead
+        if (mappedChunk.getData() == nullptr || mappedChunk.getRange() != juce::Range<juce::int64> (pos, pos + numThisTime))
+        {
+            juce::FileInputStream in (file);
+
+            if (! in.openedOk() || ! in.setPosition (pos))
+                return false;
+
+            juce::HeapBlock<char> buffer ((size_t) std::min (chunkSize, fileSize - pos));
+
+            while (pos < fileSize)
+            {
+                const auto numRead = in.read (buffer, (int) std::min (chunkSize, fileSize - pos));
+
+                if (numRead <= 0)
+                    return false;
+
+                hasher.add (buffer, (size_t) numRead);
+                pos += numRead;
+            }
+
+            return true;
+        }
+
+        hasher.add (mappedChunk.getData(), mappedChunk.getSize());
+        pos += numThisTime;
+    }
+
+    return true;
+}
+
+/** Returns a stable 64-bit hash of some numbers or enums.
+    Use this rather than hash or hash_combine for IDs that need to match between runs.
+*/
+template<typename... Types>
+[[ nodiscard ]] uint64_t stable_hash (const Types&... values) noexcept
+{
+    ContentHasher hasher;
+    (hasher.add (values), ...);
+    return hasher.getHash();
+}
+
+/** Returns a 64-bit hash of a file's contents, or nullopt if it couldn't be read. */
+inline std::optional<uint64_t> hashFileContents (const juce::File& file, uint64_t seed = 0)
+{
+    ContentHasher hasher (seed);
+
+    if (! addFileContents (hasher, file))
+        return std::nullopt;
+
+    return hasher.getHash();
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#if TRACKTION_UNIT_TESTS && TRACKTION_UNIT_TESTS_CONTENT_HASH
+
+namespace tracktion::inline core
+{
+
+//==============================================================================
+//==============================================================================
+class ContentHashTests  : public juce::UnitTest
+{
+public:
+    ContentHashTests()
+        : juce::UnitTest ("ContentHash", "tracktion_core")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Known values");
+        {
+            // These are the reference xxHash64 values so mustn't change
+            expect (ContentHasher().getHash() == 0xef46db3751d8e999ull);
+
+            ContentHasher hasher;
+            hasher.add (std::string_view ("abc"));
+            expect (hasher.getHash() == 0x44bc2cf5ad770999ull);
+        }
+
+        beginTest ("Streaming");
+        {
+            std::vector<float> samples (10000);
+
+            for (size_t i = 0; i < samples.size(); ++i)
+                samples[i] = std::sin ((float) i * 0.01f);
+
+            ContentHasher whole, chunked;
+            whole.add (std::span (samples));
+
+            for (size_t i = 0; i < samples.size(); i += 333)
+                chunked.add (std::span (samples).subspan (i, std::min<size_t> (333, samples.size() - i)));
+
+            expect (whole.getHash() == chunked.getHash());
+
+            samples[5000] += 0.001f;
+            ContentHasher changed;
+            changed.add (std::span (samples));
+            expect (changed.getHash() != whole.getHash());
+        }
+
+        beginTest ("Values");
+        {
+            expect (stable_hash (0.0) == stable_hash (-0.0));
+            expect (stable_hash (1, 2) != stable_hash (2, 1));
+            expect (stable_hash ((int32_t) 1) != stable_hash ((int64_t) 1));
+
+            ContentHasher128 hasher;
+            hasher.add (42);
+            const auto hash = hasher.getHash();
+            expect (hash.low != hash.high);
+            expectEquals (hash.toString().length(), 32);
+        }
+
+        beginTest ("File contents");
+        {
+            juce::TemporaryFile tempFile;
+            juce::MemoryBlock data;
+
+            for (int i = 0; i < 100000; ++i)
+                data.append (&i, sizeof (i));
+
+            expect (tempFile.getFile().replaceWithData (data.getData(), data.getSize()));
+
+            const auto fileHash = hashFileContents (tempFile.getFile());
+            expect (fileHash.has_value());
+
+            ContentHasher hasher;
+            hasher.add (data.getData(), data.getSize());
+            expect (*fileHash == hasher.getHash());
+
+            expect (! hashFileContents (juce::File()).has_value());
+        }
+    }
+};
+
+static ContentHashTests contentHashTests;
+
+}
+
+#endif // TRACKTION_UNIT_TESTS && TRACKTION_UNIT_TESTS_CONTENT_HASH
@@ -12,12 +12,20 @@
 
 #include <cassert>
 #include <algorithm>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include "tracktion_CPU.h"
 #include "tracktion_Time.h"
 #include "tracktion_TimeRange.h"
 #include "tracktion_Bezier.h"
 
+#if TRACKTION_ARM && __has_include(<arm_neon.h>)
+ #include <arm_neon.h>
+#endif
+
 namespace tracktion { inline namespace core
 {
 
@@ -158,6 +166,21 @@ namespace tempo
         /** Converts a time to a number of BarsAndBeats. */
         BarsAndBeats toBarsAndBeats (TimePosition) const;
 
+        //==============================================================================
+        /** Converts a number of times to beats in one go.
+            This is much quicker than converting them individually, especially if the
+            times are sorted as the sections only need to be searched once.
+            The destination must be at least as big as the source.
+        */
+        void toBeats (std::span<const TimePosition>, std::span<BeatPosition>) const;
+
+        /** Converts a number of beats to times in one go.
+            This is much quicker than converting them individually, especially if the
+            beats are sorted as the sections only need to be searched once.
+            The destination must be at least as big as the source.
+        */
+        void toTime (std::span<const BeatPosition>, std::span<TimePosition>) const;
+
         //==============================================================================
         /** Returns the tempo at a position. */
         double getBpmAt (TimePosition) const;
@@ -372,73 +395,180 @@ struct Sequence::Section
 
 namespace details
 {
-    inline BeatPosition toBeats (const std::vector<Sequence::Section>& sections, TimePosition time)
+    /** Returns the index of the last section that starts at or before a value, or 0 if
+        they all start after it. getStart should return the start of a section in the
+        same units as the value, which must increase with the section index.
+        The hint and the section after it are checked before the sections are searched
+        so sequential lookups don't need to search at all.
+    */
+    template<typename ValueType, typename GetStartFunction>
+    inline size_t findSection (const std::vector<Sequence::Section>& sections, ValueType value,
+                               GetStartFunction&& getStart, size_t hint = 0)
     {
-        for (int i = (int) sections.size(); --i > 0;)
+        assert (! sections.empty());
+        const auto maxIndex = sections.size() - 1;
+
+        auto containsValue = [&] (size_t i)
+        {
+            return (i == 0 || getStart (sections[i]) <= value)
+                && (i == maxIndex || value < getStart (sections[i + 1]));
+        };
+
+        if (hint <= maxIndex)
         {
-            auto& it = sections[(size_t) i];
+            if (containsValue (hint))
+                return hint;
 
-            if (it.startTime <= time)
-                return it.startBeat + (time - it.startTime) * it.beatsPerSecond;
+            if (hint < maxIndex && containsValue (hint + 1))
+                return hint + 1;
         }
 
-        auto& it = sections[0];
-        return it.startBeat + ((time - it.startTime) * it.beatsPerSecond);
+        auto iter = std::upper_bound (sections.begin(), sections.end(), value,
+                                      [&] (const auto& v, const auto& section) { return v < getStart (section); });
+
+        return iter == sections.begin() ? 0 : (size_t) std::distance (sections.begin(), iter) - 1;
     }
 
-    inline TimePosition toTime (const std::vector<Sequence::Section>& sections, BeatPosition beats)
+    inline size_t findSectionForTime (const std::vector<Sequence::Section>& sections, TimePosition time, size_t hint = 0)
     {
-        for (int i = (int) sections.size(); --i >= 0;)
-        {
-            auto& it = sections[(size_t) i];
+        return findSection (sections, time, [] (const auto& s) { return s.startTime; }, hint);
+    }
 
-            if (toPosition (beats - it.startBeat) >= BeatPosition())
-                return it.startTime + it.secondsPerBeat * (beats - it.startBeat);
-        }
+    inline size_t findSectionForBeat (const std::vector<Sequence::Section>& sections, BeatPosition beat, size_t hint = 0)
+    {
+        return findSection (sections, beat, [] (const auto& s) { return s.startBeat; }, hint);
+    }
 
-        auto& it = sections[0];
+    inline BeatPosition toBeats (const Sequence::Section& it, TimePosition time)
+    {
+        return it.startBeat + (time - it.startTime) * it.beatsPerSecond;
+    }
+
+    inline TimePosition toTime (const Sequence::Section& it, BeatPosition beats)
+    {
         return it.startTime + it.secondsPerBeat * (beats - it.startBeat);
     }
 
-    inline TimePosition toTime (const std::vector<Sequence::Section>& sections, BarsAndBeats barsBeats)
+    /** Sets dest[i] = destStart + (source[i] - sourceStart) * scale for a number of values.
+        This is the mapping within a single section so is used to convert a run of
+        values in one go. The operations are the same as the scalar conversions so the
+        results are identical.
+    */
+    inline void mapLinear (const double* source, double* dest, size_t num,
+                           double sourceStart, double destStart, double scale) noexcept
     {
-        for (int i = (int) sections.size(); --i >= 0;)
+        size_t i = 0;
+
+       #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        const auto sourceStartV = _mm_set1_pd (sourceStart);
+        const auto destStartV = _mm_set1_pd (destStart);
+        const auto scaleV = _mm_set1_pd (scale);
+
+        for (; i + 2 <= num; i += 2)
+            _mm_storeu_pd (dest + i, _mm_add_pd (destStartV, _mm_mul_pd (_mm_sub_pd (_mm_loadu_pd (source + i), sourceStartV), scaleV)));
+       #elif TRACKTION_ARM && defined (__ARM_NEON) && defined (__aarch64__)
+        const auto sourceStartV = vdupq_n_f64 (sourceStart);
+        const auto destStartV = vdupq_n_f64 (destStart);
+        const auto scaleV = vdupq_n_f64 (scale);
+
+        // N.B. This deliberately doesn't use a fused multiply-add so it matches the scalar version
+        for (; i + 2 <= num; i += 2)
+            vst1q_f64 (dest + i, vaddq_f64 (destStartV, vmulq_f64 (vsubq_f64 (vld1q_f64 (source + i), sourceStartV), scaleV)));
+       #endif
+
+        for (; i < num; ++i)
+            dest[i] = destStart + (source[i] - sourceStart) * scale;
+    }
+
+    /** Converts a span of positions to another type, a run of values in the same section at a time.
+        findSection should return the index of the section containing a value given a hint,
+        getStart the start of a section in the source units and map the parameters for mapLinear.
+    */
+    template<typename SourceType, typename DestType, typename FindSectionFunction, typename GetStartFunction, typename MapFunction>
+    inline void convertInSections (const std::vector<Sequence::Section>& sections,
+                                   std::span<const SourceType> source, std::span<DestType> dest,
+                                   FindSectionFunction&& findSectionFor, GetStartFunction&& getStart, MapFunction&& map)
+    {
+        static_assert (sizeof (SourceType) == sizeof (double) && std::is_standard_layout_v<SourceType>);
+        static_assert (sizeof (DestType) == sizeof (double) && std::is_standard_layout_v<DestType>);
+        assert (dest.size() >= source.size());
+
+        const auto sourceData = reinterpret_cast<const double*> (source.data());
+        const auto destData = reinterpret_cast<double*> (dest.data());
+        const auto maxIndex = sections.size() - 1;
+        size_t index = 0;
+
+        for (size_t start = 0; start < source.size();)
         {
-            const auto& it = sections[(size_t) i];
+            index = findSectionFor (sections, source[start], index);
 
-            if (it.barNumberOfFirstBar == barsBeats.bars + 1
-                  && barsBeats.beats.inBeats() >= it.prevNumerator - it.beatsUntilFirstBar.inBeats())
-                return it.timeOfFirstBar - it.secondsPerBeat * (BeatDuration::fromBeats (it.prevNumerator) - barsBeats.beats);
+            // Find the end of the run of values in this section
+            const auto sectionStart = getStart (sections[index]);
+            auto end = start + 1;
 
-            if (it.barNumberOfFirstBar <= barsBeats.bars || i == 0)
-                return it.timeOfFirstBar + it.secondsPerBeat * (BeatDuration::fromBeats (((barsBeats.bars - it.barNumberOfFirstBar) * it.numerator)) + barsBeats.beats);
+            if (index == maxIndex)
+            {
+                while (end < source.size() && (index == 0 || ! (source[end] < sectionStart)))
+                    ++end;
+            }
+            else
+            {
+                const auto nextStart = getStart (sections[index + 1]);
+
+                while (end < source.size() && source[end] < nextStart && (index == 0 || ! (source[end] < sectionStart)))
+                    ++end;
+            }
+
+            const auto [sourceStart, destStart, scale] = map (sections[index]);
+            mapLinear (sourceData + start, destData + start, end - start, sourceStart, destStart, scale);
+            start = end;
         }
+    }
 
-        return {};
+    inline BeatPosition toBeats (const std::vector<Sequence::Section>& sections, TimePosition time)
+    {
+        return toBeats (sections[findSectionForTime (sections, time)], time);
     }
 
-    inline BarsAndBeats toBarsAndBeats (const std::vector<Sequence::Section>& sections, TimePosition time)
+    inline TimePosition toTime (const std::vector<Sequence::Section>& sections, BeatPosition beats)
     {
-        for (int i = (int) sections.size(); --i >= 0;)
+        return toTime (sections[findSectionForBeat (sections, beats)], beats);
+    }
+
+    inline TimePosition toTime (const std::vector<Sequence::Section>& sections, BarsAndBeats barsBeats)
+    {
+        // Bar numbers never decrease so only the sections starting in the next bar need
+        // checking for a position in the bar before them, otherwise it's the last
+        // section starting before the bar
+        auto isBeforeBar = [] (int bar, const auto& section) { return bar < section.barNumberOfFirstBar; };
+        const auto firstAfterBar = (size_t) std::distance (sections.begin(), std::upper_bound (sections.begin(), sections.end(), barsBeats.bars, isBeforeBar));
+        const auto firstAfterNextBar = (size_t) std::distance (sections.begin(), std::upper_bound (sections.begin(), sections.end(), barsBeats.bars + 1, isBeforeBar));
+
+        for (auto i = firstAfterNextBar; i > firstAfterBar;)
         {
-            auto& it = sections[(size_t) i];
+            const auto& it = sections[--i];
 
-            if (it.startTime <= time || i == 0)
-            {
-                const auto beatsSinceFirstBar = ((time - it.timeOfFirstBar) * it.beatsPerSecond).inBeats();
+            if (barsBeats.beats.inBeats() >= it.prevNumerator - it.beatsUntilFirstBar.inBeats())
+                return it.timeOfFirstBar - it.secondsPerBeat * (BeatDuration::fromBeats (it.prevNumerator) - barsBeats.beats);
+        }
 
-                if (beatsSinceFirstBar < 0)
-                    return { it.barNumberOfFirstBar + (int) std::floor (beatsSinceFirstBar / it.numerator),
-                             BeatDuration::fromBeats (std::fmod (std::fmod (beatsSinceFirstBar, it.numerator) + it.numerator, it.numerator)),
-                             it.numerator };
+        const auto& it = sections[firstAfterBar > 0 ? firstAfterBar - 1 : 0];
+        return it.timeOfFirstBar + it.secondsPerBeat * (BeatDuration::fromBeats (((barsBeats.bars - it.barNumberOfFirstBar) * it.numerator)) + barsBeats.beats);
+    }
 
-                return { it.barNumberOfFirstBar + (int) std::floor (beatsSinceFirstBar / it.numerator),
-                         BeatDuration::fromBeats (std::fmod (beatsSinceFirstBar, it.numerator)),
-                         it.numerator };
-            }
-        }
+    inline BarsAndBeats toBarsAndBeats (const std::vector<Sequence::Section>& sections, TimePosition time)
+    {
+        auto& it = sections[findSectionForTime (sections, time)];
+        const auto beatsSinceFirstBar = ((time - it.timeOfFirstBar) * it.beatsPerSecond).inBeats();
 
-        return { 0, {} };
+        if (beatsSinceFirstBar < 0)
+            return { it.barNumberOfFirstBar + (int) std::floor (beatsSinceFirstBar / it.numerator),
+                     BeatDuration::fromBeats (std::fmod (std::fmod (beatsSinceFirstBar, it.numerator) + it.numerator, it.numerator)),
+                     it.numerator };
+
+        return { it.barNumberOfFirstBar + (int) std::floor (beatsSinceFirstBar / it.numerator),
+                 BeatDuration::fromBeats (std::fmod (beatsSinceFirstBar, it.numerator)),
+                 it.numerator };
     }
 }
 
@@ -690,61 +820,42 @@ inline BarsAndBeats Sequence::toBarsAndBeats (TimePosition t) const
     return details::toBarsAndBeats (sections, t);
 }
 
-//==============================================================================
-inline double Sequence::getBpmAt (TimePosition t) const
+inline void Sequence::toBeats (std::span<const TimePosition> times, std::span<BeatPosition> beats) const
 {
-    for (int i = (int) sections.size(); --i >= 0;)
-    {
-        auto& it = sections[(size_t) i];
+    details::convertInSections (sections, times, beats,
+                                details::findSectionForTime,
+                                [] (const auto& section) { return section.startTime; },
+                                [] (const auto& section) { return std::tuple (section.startTime.inSeconds(), section.startBeat.inBeats(), section.beatsPerSecond.v); });
+}
 
-        if (it.startTime <= t || i == 0)
-            return it.bpm;
-    }
+inline void Sequence::toTime (std::span<const BeatPosition> beats, std::span<TimePosition> times) const
+{
+    details::convertInSections (sections, beats, times,
+                                details::findSectionForBeat,
+                                [] (const auto& section) { return section.startBeat; },
+                                [] (const auto& section) { return std::tuple (section.startBeat.inBeats(), section.startTime.inSeconds(), section.secondsPerBeat.v); });
+}
 
-    assert(false);
-    return 120.0;
+//==============================================================================
+inline double Sequence::getBpmAt (TimePosition t) const
+{
+    return sections[details::findSectionForTime (sections, t)].bpm;
 }
 
 inline Key Sequence::getKeyAt (TimePosition t) const
 {
-    for (int i = (int) sections.size(); --i >= 0;)
-    {
-        auto& it = sections[(size_t) i];
-
-        if (it.startTime <= t || i == 0)
-            return it.key;
-    }
-
-    assert(false);
-    return {};
+    return sections[details::findSectionForTime (sections, t)].key;
 }
 
 inline TimeSignature Sequence::getTimeSignatureAt (TimePosition t) const
 {
-    for (int i = (int) sections.size(); --i >= 0;)
-    {
-        auto& it = sections[(size_t) i];
-
-        if (it.startTime <= t || i == 0)
-            return { .numerator = it.numerator, .denominator = it.denominator };
-    }
-
-    assert(false);
-    return {};
+    auto& it = sections[details::findSectionForTime (sections, t)];
+    return { .numerator = it.numerator, .denominator = it.denominator };
 }
 
 inline BeatsPerSecond Sequence::getBeatsPerSecondAt (TimePosition t) const
 {
-    for (int i = (int) sections.size(); --i >= 0;)
-    {
-        auto& it = sections[(size_t) i];
-
-        if (it.startTime <= t || i == 0)
-            return it.beatsPerSecond;
-    }
-
-    assert(false);
-    return { 2.0 };
+    return sections[details::findSectionForTime (sections, t)].beatsPerSecond;
 }
 
 inline size_t Sequence::hash() const
@@ -769,8 +880,7 @@ inline Sequence::Position::Position (const Position& o)
 
 inline BeatPosition Sequence::Position::getBeats() const
 {
-    const auto& it = sequence.sections[index];
-    return it.startBeat + (time - it.startTime) * it.beatsPerSecond;
+    return details::toBeats (sequence.sections[index], time);
 }
 
 inline BarsAndBeats Sequence::Position::getBarsBeats() const
@@ -808,25 +918,7 @@ inline Key Sequence::Position::getKey() const
 //==============================================================================
 inline void Sequence::Position::set (TimePosition t)
 {
-    const auto maxIndex = sequence.sections.size() - 1;
-
-    if (index > maxIndex)
-    {
-        index = maxIndex;
-        time = sequence.sections[index].startTime;
-    }
-
-    if (t >= time)
-    {
-        while (index < maxIndex && sequence.sections[index + 1].startTime <= t)
-            ++index;
-    }
-    else
-    {
-        while (index > 0 && sequence.sections[index].startTime > t)
-            --index;
-    }
-
+    index = details::findSectionForTime (sequence.sections, t, index);
     time = t;
 }
 
@@ -949,13 +1041,7 @@ inline BeatPosition Sequence::Position::getBeatOfNextChange() const
 //==============================================================================
 inline void Sequence::Position::setPPQTime (double ppq)
 {
-    for (int i = (int) sequence.sections.size(); --i >= 0;)
-    {
-        index = (size_t) i;
-
-        if (sequence.sections[index].ppqAtStart <= ppq)
-            break;
-    }
+    index = details::findSection (sequence.sections, ppq, [] (const auto& s) { return s.ppqAtStart; }, index);
 
     const auto& it = sequence.sections[index];
     const auto beatsSinceStart = BeatPosition::fromBeats (((ppq - it.ppqAtStart) * it.denominator) / 4.0);
@@ -202,6 +202,7 @@ public:
     void runTest() override
     {
         runPositionTests();
+        runManyChangeTests();
     }
 
 private:
@@ -425,6 +426,71 @@ private:
             }
         }
     }
+
+    void runManyChangeTests()
+    {
+        beginTest ("Many changes");
+        {
+            // A tempo change every beat, like a live-recorded rubato performance
+            std::vector<tempo::TempoChange> tempos;
+
+            for (int i = 0; i < 1000; ++i)
+                tempos.push_back ({ BeatPosition::fromBeats (i), 60.0 + (i % 2) * 60.0, 1.0f });
+
+            tempo::Sequence seq (tempos,
+                                 {{ BeatPosition(), 4, 4, false }},
+                                 tempo::LengthOfOneBeat::isAlwaysACrotchet);
+            tempo::Sequence::Position pos (seq);
+
+            // Every two beats take 1.5s
+            for (int beat : { 999, 10, 500, 0, 501, 2, 998 })
+            {
+                const auto expectedTime = (beat / 2) * 1.5 + (beat % 2);
+                expectWithinAbsoluteError (seq.toTime (BeatPosition::fromBeats (beat)).inSeconds(), expectedTime, 0.0001);
+
+                pos.set (TimePosition::fromSeconds (expectedTime + 0.25));
+                expectWithinAbsoluteError (pos.getBeats().inBeats(), beat + (beat % 2 == 0 ? 0.25 : 0.5), 0.0001);
+                expectEquals (pos.getTempo(), beat % 2 == 0 ? 60.0 : 120.0);
+            }
+
+            std::vector<TimePosition> times;
+
+            for (int i = 0; i < 1000; ++i)
+                times.push_back (TimePosition::fromSeconds (i * 0.73));
+
+            times.push_back (TimePosition::fromSeconds (3.0));
+
+            std::vector<BeatPosition> beats (times.size());
+            seq.toBeats (times, beats);
+
+            for (size_t i = 0; i < times.size(); ++i)
+                expect (beats[i] == seq.toBeats (times[i]));
+
+            std::vector<TimePosition> convertedTimes (beats.size());
+            seq.toTime (beats, convertedTimes);
+
+            for (size_t i = 0; i < times.size(); ++i)
+                expectWithinAbsoluteError (convertedTimes[i].inSeconds(), times[i].inSeconds(), 0.0001);
+
+            // Lots of values in each section, including some before the start
+            times.clear();
+
+            for (int i = -100; i < 80000; ++i)
+                times.push_back (TimePosition::fromSeconds (i * 0.01));
+
+            beats.resize (times.size());
+            seq.toBeats (times, beats);
+
+            for (size_t i = 0; i < times.size(); ++i)
+                expect (beats[i] == seq.toBeats (times[i]));
+
+            convertedTimes.resize (beats.size());
+            seq.toTime (beats, convertedTimes);
+
+            for (size_t i = 0; i < times.size(); ++i)
+                expect (convertedTimes[i] == seq.toTime (beats[i]));
+        }
+    }
 };
 
 static SequenceTests sequenceTests;
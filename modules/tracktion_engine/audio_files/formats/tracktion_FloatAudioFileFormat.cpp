@@ -13,6 +13,13 @@ namespace tracktion { inline namespace engine
 
 static int getFloatFileHeaderIntV1()  { return (int) juce::ByteOrder::littleEndianInt ("TRKF"); }
 static int getFloatFileHeaderIntV2()  { return (int) juce::ByteOrder::littleEndianInt ("TF64"); }
+static int getFloatFileLevelsTag()    { return (int) juce::ByteOrder::littleEndianInt ("LVLS"); }
+
+static constexpr int floatFileHeaderSize = 512;
+static constexpr int floatFileMaxNumChannels = 16;
+
+// The levels follow the fields common to both header versions, in space that used to be zeroed
+static_assert (24 + 4 + 8 * floatFileMaxNumChannels <= floatFileHeaderSize);
 
 
 //==============================================================================
@@ -48,6 +55,8 @@ public:
 
             if (sampleRate < 32000 || sampleRate > 192000 || numChannels < 1 || numChannels > 16)
                 sampleRate = 0;
+            else
+                readLevels();
         }
     }
 
@@ -93,6 +102,22 @@ public:
 
     int dataStartOffset;
     bool bigEndian = false;
+    std::vector<FloatAudioFormat::LevelSummary> levels;
+
+private:
+    void readLevels()
+    {
+        if (dataStartOffset < 24 + 4 + 8 * (int) numChannels || input->readInt() != getFloatFileLevelsTag())
+            return;
+
+        levels.resize (numChannels);
+
+        for (auto& l : levels)
+        {
+            l.peak = input->readFloat();
+            l.rms  = input->readFloat();
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FloatAudioFormatReader)
 };
@@ -110,6 +135,8 @@ public:
           lengthInSamples (0)
     {
         usesFloatingPointData = true;
+        peaks.resize (numChannels);
+        sumsOfSquares.resize (numChannels);
         writeHeader();
     }
 
@@ -122,23 +149,41 @@ public:
     //==============================================================================
     bool write (const int** data, int numSamps) override
     {
+        // Channels after a null one were never written so the frames get shorter
+        unsigned int numChannelsToWrite = 0;
+
+        while (numChannelsToWrite < numChannels && data[numChannelsToWrite] != nullptr)
+            ++numChannelsToWrite;
+
         lengthInSamples += numSamps;
 
-        for (int j = 0; j < numSamps; ++j)
+        if (numChannelsToWrite == 0)
+            return true;
+
+        for (unsigned int i = 0; i < numChannelsToWrite; ++i)
+            updateLevels (i, (const float*) data[i], numSamps);
+
+        // Frames are interleaved in to a block and written in one go rather than a sample at a time
+        constexpr int maxFramesPerBlock = 1024;
+        interleaved.resize ((size_t) maxFramesPerBlock * numChannelsToWrite);
+
+        for (int start = 0; start < numSamps; start += maxFramesPerBlock)
         {
-            for (unsigned int i = 0; i < numChannels; ++i)
+            const int numThisTime = std::min (maxFramesPerBlock, numSamps - start);
+            auto dest = interleaved.data();
+
+            for (int j = start; j < start + numThisTime; ++j)
             {
-                if (const float* chan = (float*) (data[i]))
+                for (unsigned int i = 0; i < numChannelsToWrite; ++i)
                 {
-                    float val = chan[j];
+                    float val = ((const float*) data[i])[j];
                     JUCE_UNDENORMALISE (val);
-                    output->writeFloat (val);
-                }
-                else
-                {
-                    break;
+                    *dest++ = juce::ByteOrder::swapIfBigEndian (val);
                 }
             }
+
+            if (! output->write (interleaved.data(), sizeof (float) * (size_t) numThisTime * numChannelsToWrite))
+                return false;
         }
 
         return true;
@@ -156,18 +201,43 @@ public:
 
 private:
     juce::int64 lengthInSamples;
+    std::vector<float> interleaved, peaks;
+    std::vector<double> sumsOfSquares;
+
+    void updateLevels (unsigned int channel, const float* samples, int numSamps)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax (samples, numSamps);
+        peaks[channel] = std::max ({ peaks[channel], -range.getStart(), range.getEnd() });
+
+        double sum = 0.0;
+
+        for (int i = 0; i < numSamps; ++i)
+            sum += samples[i] * samples[i];
+
+        sumsOfSquares[channel] += sum;
+    }
 
     void writeHeader()
     {
-        const int headerSize = 512;
         output->writeInt (getFloatFileHeaderIntV2());
-        output->writeInt (headerSize);
+        output->writeInt (floatFileHeaderSize);
         output->writeInt (juce::roundToInt (sampleRate));
         output->writeInt64 (lengthInSamples);
         output->writeShort ((short)numChannels);
         output->writeShort (0); // big-endian
 
-        while (output->getPosition() < headerSize)
+        if (numChannels <= (unsigned int) floatFileMaxNumChannels)
+        {
+            output->writeInt (getFloatFileLevelsTag());
+
+            for (unsigned int i = 0; i < numChannels; ++i)
+            {
+                output->writeFloat (peaks[i]);
+                output->writeFloat (lengthInSamples > 0 ? (float) std::sqrt (sumsOfSquares[i] / (double) lengthInSamples) : 0.0f);
+            }
+        }
+
+        while (output->getPosition() < floatFileHeaderSize)
             output->writeByte (0);
     }
 
@@ -314,6 +384,19 @@ juce::AudioFormatReader* FloatAudioFormat::createReaderFor (juce::InputStream* i
     return {};
 }
 
+std::vector<FloatAudioFormat::LevelSummary> FloatAudioFormat::getLevelSummaries (const juce::File& file)
+{
+    if (auto fin = file.createInputStream())
+    {
+        FloatAudioFormatReader reader (fin.release());
+
+        if (reader.sampleRate > 0)
+            return reader.levels;
+    }
+
+    return {};
+}
+
 juce::MemoryMappedAudioFormatReader* FloatAudioFormat::createMemoryMappedReader (const juce::File& file)
 {
     if (auto fin = file.createInputStream())
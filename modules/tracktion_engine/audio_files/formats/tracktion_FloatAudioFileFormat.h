@@ -29,6 +29,19 @@ public:
     bool canDoMono() override;
     bool canHandleFile (const juce::File&) override;
 
+    //==============================================================================
+    /** The levels of one channel of a file, stored in its header by the writer. */
+    struct LevelSummary
+    {
+        float peak = 0.0f;  /**< The highest absolute sample value. */
+        float rms = 0.0f;   /**< The RMS level over the whole file. */
+    };
+
+    /** Returns the level of each channel without reading any audio.
+        This will be empty if the file was written before levels were stored.
+    */
+    static std::vector<LevelSummary> getLevelSummaries (const juce::File&);
+
     //==============================================================================
     using juce::AudioFormat::createReaderFor;
     juce::AudioFormatReader* createReaderFor (juce::InputStream*, bool deleteStreamIfOpeningFails) override;
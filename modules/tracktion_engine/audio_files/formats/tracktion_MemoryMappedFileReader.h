@@ -14,6 +14,11 @@ namespace tracktion { inline namespace engine
 //==============================================================================
 /**
     FallbackReader that wraps a MemoryMappedFile which usually improves read speeds.
+
+    If the file is a WAV or Tracktion float file containing native-endian 32-bit
+    float samples, reads bypass the wrapped reader and de-interleave straight from
+    the mapped memory. The data can also be accessed without any copying using
+    getMappedFloatData.
 */
 //==============================================================================
 struct MemoryMappedFileReader    : public FallbackReader
@@ -28,6 +33,18 @@ struct MemoryMappedFileReader    : public FallbackReader
         numChannels             = source->reader->numChannels;
         usesFloatingPointData   = source->reader->usesFloatingPointData;
         metadataValues          = source->reader->metadataValues;
+
+        mappedFloatData = findMappedFloatData();
+    }
+
+    /** If the mapped file contains native-endian 32-bit float samples, this returns
+        a view of all the interleaved frames directly in the mapped memory.
+        Otherwise this returns an empty view.
+        The view is only valid for the lifetime of this reader.
+    */
+    choc::buffer::InterleavedView<const float> getMappedFloatData() const
+    {
+        return mappedFloatData;
     }
 
     /** @internal */
@@ -39,12 +56,161 @@ struct MemoryMappedFileReader    : public FallbackReader
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       juce::int64 startSampleInFile, int numSamples) override
     {
+        if (mappedFloatData.getNumFrames() > 0)
+            return readMappedFloatSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples);
+
         return source->reader->readSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
                                             startSampleInFile, numSamples);
     }
 
 private:
     std::unique_ptr<AudioFileUtils::MappedFileAndReader> source;
+    choc::buffer::InterleavedView<const float> mappedFloatData;
+
+    //==============================================================================
+    choc::buffer::InterleavedView<const float> findMappedFloatData() const
+    {
+        if (! usesFloatingPointData || bitsPerSample != 32 || numChannels == 0 || lengthInSamples <= 0)
+            return {};
+
+        auto data = static_cast<const char*> (source->mappedFile->getData());
+        const auto size = (juce::int64) source->mappedFile->getSize();
+        const auto offset = findFloatDataOffset (data, size);
+
+        // Float samples have to be aligned to be read in place
+        if (offset <= 0 || (offset % (juce::int64) sizeof (float)) != 0
+             || (reinterpret_cast<juce::pointer_sized_uint> (data) % sizeof (float)) != 0)
+            return {};
+
+        const auto bytesPerFrame = (juce::int64) (sizeof (float) * numChannels);
+        const auto numFrames = std::min (lengthInSamples, (size - offset) / bytesPerFrame);
+
+        if (numFrames <= 0 || numFrames > (juce::int64) std::numeric_limits<choc::buffer::FrameCount>::max())
+            return {};
+
+        return choc::buffer::createInterleavedView (reinterpret_cast<const float*> (data + offset),
+                                                    (choc::buffer::ChannelCount) numChannels,
+                                                    (choc::buffer::FrameCount) numFrames);
+    }
+
+    /** Returns the offset of the sample data if the file is a format that's known
+        to store native-endian floats, or -1 if not.
+    */
+    static juce::int64 findFloatDataOffset (const char* data, juce::int64 size)
+    {
+        if (size < 24)
+            return -1;
+
+        auto readLE32 = [data] (juce::int64 pos) { return (juce::int64) juce::ByteOrder::littleEndianInt (data + pos); };
+        auto readLE16 = [data] (juce::int64 pos) { return (int) juce::ByteOrder::littleEndianShort (data + pos); };
+
+        const auto header = juce::ByteOrder::littleEndianInt (data);
+
+        if (header == juce::ByteOrder::littleEndianInt ("TRKF") || header == juce::ByteOrder::littleEndianInt ("TF64"))
+        {
+            // The bigEndian flag comes after an int or int64 length
+            const bool isBigEndian = readLE16 (header == juce::ByteOrder::littleEndianInt ("TRKF") ? 18 : 22) != 0;
+
+            if (isBigEndian != (JUCE_BIG_ENDIAN != 0))
+                return -1;
+
+            return readLE32 (4);
+        }
+
+       #if JUCE_LITTLE_ENDIAN
+        if (header == juce::ByteOrder::littleEndianInt ("RIFF")
+             && juce::ByteOrder::littleEndianInt (data + 8) == juce::ByteOrder::littleEndianInt ("WAVE"))
+        {
+            for (juce::int64 pos = 12; pos + 8 <= size;)
+            {
+                const auto chunkSize = readLE32 (pos + 4);
+
+                if (juce::ByteOrder::littleEndianInt (data + pos) == juce::ByteOrder::littleEndianInt ("data"))
+                    return pos + 8;
+
+                pos += 8 + chunkSize + (chunkSize & 1);
+            }
+        }
+       #endif
+
+        return -1;
+    }
+
+    bool readMappedFloatSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                 juce::int64 startSampleInFile, int numSamples)
+    {
+        const auto numMappedFrames = (juce::int64) mappedFloatData.getNumFrames();
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, numMappedFrames);
+
+        if (numSamples <= 0)
+            return true;
+
+        const auto numSourceChannels = (int) mappedFloatData.getNumChannels();
+        const auto stride = (size_t) numSourceChannels;
+        const auto src = mappedFloatData.getIterator (0).sample + (size_t) startSampleInFile * stride;
+
+        auto getDest = [&] (int chan) -> float*
+        {
+            if (chan >= numDestChannels || destSamples[chan] == nullptr)
+                return nullptr;
+
+            return reinterpret_cast<float*> (destSamples[chan]) + startOffsetInDestBuffer;
+        };
+
+        if (numSourceChannels == 1)
+        {
+            if (auto d = getDest (0))
+                std::memcpy (d, src, (size_t) numSamples * sizeof (float));
+        }
+        else if (numSourceChannels == 2 && getDest (0) != nullptr && getDest (1) != nullptr)
+        {
+            deinterleaveStereo (getDest (0), getDest (1), src, (size_t) numSamples);
+        }
+        else
+        {
+            for (int chan = 0; chan < numSourceChannels; ++chan)
+                if (auto d = getDest (chan))
+                    for (size_t i = 0; i < (size_t) numSamples; ++i)
+                        d[i] = src[i * stride + (size_t) chan];
+        }
+
+        // Any extra destination channels are cleared in the same way the wrapped readers do
+        for (int chan = numSourceChannels; chan < numDestChannels; ++chan)
+            if (destSamples[chan] != nullptr)
+                juce::zeromem (destSamples[chan] + startOffsetInDestBuffer, sizeof (float) * (size_t) numSamples);
+
+        return true;
+    }
+
+    static void deinterleaveStereo (float* left, float* right, const float* src, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto a = _mm_loadu_ps (src + i * 2);
+            auto b = _mm_loadu_ps (src + i * 2 + 4);
+            _mm_storeu_ps (left + i,  _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+            _mm_storeu_ps (right + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+        }
+       #elif TRACKTION_ARM && defined (__ARM_NEON)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto lr = vld2q_f32 (src + i * 2);
+            vst1q_f32 (left + i,  lr.val[0]);
+            vst1q_f32 (right + i, lr.val[1]);
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            left[i]  = src[i * 2];
+            right[i] = src[i * 2 + 1];
+        }
+    }
 };
 
 
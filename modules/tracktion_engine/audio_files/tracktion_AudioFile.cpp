@@ -149,8 +149,10 @@ AudioFileWriter::AudioFileWriter (const AudioFile& f,
                                   double sampleRate,
                                   int bitsPerSample,
                                   const juce::StringPairArray& metadata,
-                                  int quality)
-    : file (f), samplesUntilFlush (numSamplesPerFlush)
+                                  int quality,
+                                  const AudioFileWriteOptions& options)
+    : file (f), flushPolicy (options.flushPolicy), samplesUntilFlush (numSamplesPerFlush),
+      lastFlushRequest (f.engine->getAudioFileManager().getNumWriterFlushRequests())
 {
     CRASH_TRACER
     f.engine->getAudioFileManager().releaseFile (file);
@@ -160,7 +162,7 @@ AudioFileWriter::AudioFileWriter (const AudioFile& f,
         const juce::ScopedLock sl (writerLock);
         writer.reset (AudioFileUtils::createWriterFor (formatToUse, file.getFile(), sampleRate,
                                                        (unsigned int) numChannels, bitsPerSample,
-                                                       metadata, quality));
+                                                       metadata, quality, options));
     }
 }
 
@@ -192,18 +194,35 @@ bool AudioFileWriter::appendBuffer (juce::AudioBuffer<float>& buffer, int num)
 
     if (writer != nullptr && writer->writeFromAudioSampleBuffer (buffer, 0, num))
     {
-        samplesUntilFlush -= num;
+        flushIfDue (num);
+        return true;
+    }
+
+    return false;
+}
+
+void AudioFileWriter::flushIfDue (int numSamplesWritten)
+{
+    if (flushPolicy == AudioFileWriteOptions::FlushPolicy::whenRequested)
+    {
+        const auto numRequests = file.engine->getAudioFileManager().getNumWriterFlushRequests();
 
-        if (samplesUntilFlush <= 0)
+        if (numRequests != lastFlushRequest)
         {
-            samplesUntilFlush = numSamplesPerFlush;
+            lastFlushRequest = numRequests;
             writer->flush();
         }
 
-        return true;
+        return;
     }
 
-    return false;
+    samplesUntilFlush -= numSamplesWritten;
+
+    if (samplesUntilFlush <= 0)
+    {
+        samplesUntilFlush = numSamplesPerFlush;
+        writer->flush();
+    }
 }
 
 bool AudioFileWriter::appendBuffer (const int** buffer, int num)
@@ -477,6 +496,11 @@ struct AudioFileManager::KnownFile
     {
     }
 
+    KnownFile (const AudioFile& f, AudioFileInfo i)
+        : file (f), info (std::move (i))
+    {
+    }
+
     AudioFile file;
     AudioFileInfo info;
 
@@ -780,10 +804,29 @@ void SmartThumbnail::timerCallback()
 AudioFileManager::AudioFileManager (Engine& e)
     : engine (e), cache (e), thumbnailCache (std::make_unique<TracktionThumbnailCache> (e))
 {
+    if (e.getEngineBehaviour().shouldCacheAudioFileInfo())
+    {
+        infoCache = std::make_unique<AudioFileInfoCache> (e, e.getTemporaryFileManager().getTempDirectory()
+                                                                                    .getChildFile ("audio_file_info.cache"));
+
+        infoCache->onEntryInvalidated = [this] (const AudioFile& f)
+        {
+            {
+                // Clear the time so checkFileTime re-parses the file, even if only its size has changed
+                const juce::ScopedLock sl (knownFilesLock);
+
+                if (auto kf = knownFiles.find (f.getHash()); kf != knownFiles.end())
+                    kf->second->info.fileModificationTime = {};
+            }
+
+            checkFileForChangesAsync (f);
+        };
+    }
 }
 
 AudioFileManager::~AudioFileManager()
 {
+    infoCache.reset();
     clearFiles();
 }
 
@@ -823,8 +866,51 @@ AudioFile AudioFileManager::getAudioFile (ProjectItemID sourceID)
 
 AudioFileInfo AudioFileManager::getInfo (const AudioFile& file)
 {
+    auto hash = file.getHash();
+
+    {
+        const juce::ScopedLock sl (knownFilesLock);
+        auto kf = knownFiles.find (hash);
+
+        if (kf != knownFiles.end())
+            return kf->second->info;
+    }
+
+    // Parse the header without holding the lock so different files can be probed concurrently
+    std::optional<AudioFileInfo> cachedInfo;
+
+    if (infoCache != nullptr && ! file.isNull())
+        cachedInfo = infoCache->find (file);
+
+    auto info = cachedInfo ? std::move (*cachedInfo) : AudioFileInfo::parse (file);
+
+    if (infoCache != nullptr && ! cachedInfo && ! file.isNull())
+        infoCache->add (file, info);
+
     const juce::ScopedLock sl (knownFilesLock);
-    return findOrCreateKnown (file).info;
+    auto& kf = knownFiles[hash];
+
+    if (kf == nullptr)
+        kf = std::make_unique<KnownFile> (file, std::move (info));
+
+    return kf->info;
+}
+
+void AudioFileManager::addAnalysisResult (const AudioFile& file, const juce::String& key, const juce::String& value)
+{
+    if (file.isNull() || ! getInfo (file).wasParsedOk)
+        return;
+
+    const juce::ScopedLock sl (knownFilesLock);
+    auto kf = knownFiles.find (file.getHash());
+
+    if (kf == knownFiles.end())
+        return;
+
+    kf->second->info.metadata.set (key, value);
+
+    if (infoCache != nullptr)
+        infoCache->add (kf->second->file, kf->second->info);
 }
 
 bool AudioFileManager::checkFileTime (KnownFile& f)
@@ -833,6 +919,10 @@ bool AudioFileManager::checkFileTime (KnownFile& f)
         || f.info.fileModificationTime != f.file.getFile().getLastModificationTime())
     {
         f.info = AudioFileInfo::parse (f.file);
+
+        if (infoCache != nullptr)
+            infoCache->add (f.file, f.info);
+
         return true;
     }
 
@@ -882,6 +972,18 @@ void AudioFileManager::checkFilesForChanges()
     }
 }
 
+void AudioFileManager::requestWriterFlush()
+{
+    // Multiple TransportControls can call this so it's rate-limited here
+    const auto now = juce::Time::getMillisecondCounter();
+
+    if (now - lastWriterFlushRequestTime.load() >= (juce::uint32) minMillisecondsBetweenWriterFlushes)
+    {
+        lastWriterFlushRequestTime = now;
+        ++numWriterFlushRequests;
+    }
+}
+
 void AudioFileManager::releaseAllFiles()
 {
     cache.releaseAllFiles();
@@ -946,11 +1048,35 @@ void AudioFileManager::forceFileUpdate (const AudioFile& file)
     if (f != knownFiles.end())
     {
         f->second->info = AudioFileInfo::parse (f->second->file);
+
+        if (infoCache != nullptr)
+            infoCache->add (f->second->file, f->second->info);
+
         releaseFile (file);
         callListeners (file);
     }
 }
 
+void AudioFileManager::forceFileUpdate (const AudioFile& file, AudioFileInfo newInfo)
+{
+    CRASH_TRACER
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    const juce::ScopedLock sl (knownFilesLock);
+    auto& kf = knownFiles[file.getHash()];
+
+    if (kf == nullptr)
+        kf = std::make_unique<KnownFile> (file, std::move (newInfo));
+    else
+        kf->info = std::move (newInfo);
+
+    if (infoCache != nullptr)
+        infoCache->add (kf->file, kf->info);
+
+    releaseFile (file);
+    callListeners (file);
+}
+
 void AudioFileManager::validateFile (const AudioFile& file, bool updateInfo)
 {
     if (updateInfo)
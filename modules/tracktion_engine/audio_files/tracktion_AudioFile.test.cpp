@@ -26,6 +26,7 @@ public:
     void runTest() override
     {
         runFileInfoTest();
+        runPreallocatedWriteTest();
     }
 
 private:
@@ -80,6 +81,50 @@ private:
             expectEquals (info.getLengthInSeconds(), 1.0);
         }
     }
+
+    void runPreallocatedWriteTest()
+    {
+        beginTest ("Preallocated writing");
+
+        auto& engine = *Engine::getEngines().getFirst();
+
+        juce::WavAudioFormat format;
+        juce::TemporaryFile grownFile (format.getFileExtensions()[0]), preallocatedFile (format.getFileExtensions()[0]);
+
+        const int numChannels = 2;
+        const double sampleRate = 44100.0;
+        juce::Random random (42);
+
+        juce::AudioBuffer<float> buffer (numChannels, 1000);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (chan, i, random.nextFloat() * 2.0f - 1.0f);
+
+        auto writeFile = [&] (const juce::File& f, const AudioFileWriteOptions& options)
+        {
+            AudioFileWriter writer (AudioFile (engine, f), &format, numChannels, sampleRate, 24, {}, 0, options);
+            expect (writer.isOpen());
+
+            // Odd sized blocks so the writes don't line up with the aligned blocks
+            for (int i = 0; i < 300; ++i)
+                expect (writer.appendBuffer (buffer, 1 + (i * 37) % buffer.getNumSamples()));
+        };
+
+        auto options = AudioFileWriteOptions::forRecording();
+        options.preallocationBytes = 64 * 1024;
+        options.writeBlockBytes = 4096;
+
+        writeFile (grownFile.getFile(), {});
+        writeFile (preallocatedFile.getFile(), options);
+
+        // The files should be identical, with any unused space released
+        juce::MemoryBlock grownData, preallocatedData;
+        expect (grownFile.getFile().loadFileAsData (grownData));
+        expect (preallocatedFile.getFile().loadFileAsData (preallocatedData));
+        expectEquals (preallocatedFile.getFile().getSize(), grownFile.getFile().getSize());
+        expect (grownData == preallocatedData);
+    }
 };
 
 static AudioFileTests audioFileTests;
@@ -28,6 +28,159 @@ static void clearSetOfChannels (int* const* channels, int numChannels, int offse
             juce::FloatVectorOperations::clear (chan + offset, numSamples);
 }
 
+/** Returns true if more than a number of milliseconds have passed between two times
+    from getApproximateMillisecondCounter. This is still correct once the counter wraps.
+*/
+static bool isLongerThan (uint32_t startTime, uint32_t endTime, uint32_t milliseconds) noexcept
+{
+    return endTime - startTime > milliseconds;
+}
+
+//==============================================================================
+//==============================================================================
+/** Asks the OS to start reading a range of a file in the background.
+    This means the reads for many files can be in flight at once rather than each
+    page fault blocking the thread touching the memory-mapped data in turn.
+    On platforms without a suitable API this does nothing and the pages will just
+    be read when they're touched.
+*/
+class FileReadAheadHint
+{
+public:
+    FileReadAheadHint() = default;
+    ~FileReadAheadHint()        { close(); }
+
+    void prefetch (const juce::File& file, int64_t startByte, int64_t numBytes)
+    {
+       #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+        if (numBytes <= 0 || ! open (file))
+            return;
+
+        #if JUCE_MAC || JUCE_IOS
+         radvisory advice;
+         advice.ra_offset = (off_t) startByte;
+         advice.ra_count = (int) std::min<int64_t> (numBytes, std::numeric_limits<int>::max());
+         ::fcntl (fd, F_RDADVISE, &advice);
+        #else
+         ::posix_fadvise (fd, (off_t) startByte, (off_t) numBytes, POSIX_FADV_WILLNEED);
+        #endif
+       #else
+        juce::ignoreUnused (file, startByte, numBytes);
+       #endif
+    }
+
+    void close()
+    {
+       #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+        if (fd >= 0)
+            ::close (fd);
+
+        fd = -1;
+       #endif
+        failedToOpen = false;
+    }
+
+private:
+   #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+    int fd = -1;
+
+    bool open (const juce::File& file)
+    {
+        if (fd >= 0)
+            return true;
+
+        if (failedToOpen)
+            return false;
+
+        fd = ::open (file.getFullPathName().toRawUTF8(), O_RDONLY | O_CLOEXEC);
+        failedToOpen = fd < 0;
+
+        return ! failedToOpen;
+    }
+   #endif
+
+    bool failedToOpen = false;
+
+    JUCE_DECLARE_NON_COPYABLE (FileReadAheadHint)
+};
+
+
+//==============================================================================
+//==============================================================================
+/** Decodes a compressed file to a 32-bit float WAV that can be memory-mapped. */
+class DecodedSidecarJob  : public AudioProxyGenerator::GeneratorJob
+{
+public:
+    DecodedSidecarJob (const AudioFile& source_, const AudioFile& sidecar, int64_t diskQuota_)
+        : GeneratorJob (sidecar), source (source_), diskQuota (diskQuota_)
+    {
+        setName (TRANS("Decoding") + ": " + source.getFile().getFileName());
+    }
+
+    ~DecodedSidecarJob() override
+    {
+        prepareForJobDeletion();
+    }
+
+private:
+    AudioFile source;
+    const int64_t diskQuota;
+
+    bool render() override
+    {
+        CRASH_TRACER
+        auto& engine = *source.engine;
+        AudioFile tempFile (engine, proxy.getFile()
+                                     .getSiblingFile ("temp_decoded_" + juce::String::toHexString (juce::Random().nextInt64()))
+                                     .withFileExtension (proxy.getFile().getFileExtension()));
+
+        bool ok = render (tempFile) && tempFile.getFile().moveFileTo (proxy.getFile());
+        tempFile.deleteFile();
+
+        if (ok)
+            engine.getTemporaryFileManager().purgeDecodedSidecars (diskQuota);
+
+        return ok;
+    }
+
+    bool render (const AudioFile& tempFile)
+    {
+        auto& engine = *source.engine;
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, source.getFile()));
+
+        if (reader == nullptr)
+            return false;
+
+        AudioFileWriter writer (tempFile, engine.getAudioFileFormatManager().getWavFormat(),
+                                (int) reader->numChannels, reader->sampleRate, 32, {}, 0);
+
+        if (! writer.isOpen())
+            return false;
+
+        SampleCount sourceSample = 0;
+        const auto length = (SampleCount) reader->lengthInSamples;
+
+        while (! shouldExit())
+        {
+            auto numThisTime = (int) std::min (length - sourceSample, (SampleCount) 65536);
+
+            if (numThisTime <= 0)
+                return true;
+
+            if (! writer.writeFromAudioReader (*reader, sourceSample, numThisTime))
+                break;
+
+            sourceSample += numThisTime;
+            progress = juce::jlimit (0.0f, 1.0f, (float) (sourceSample / (double) length));
+        }
+
+        return false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedSidecarJob)
+};
+
+
 //==============================================================================
 //==============================================================================
 struct AudioFileCache::ScopedFileRead
@@ -58,6 +211,17 @@ struct AudioFileCache::ScopedFileRead
     const double startTimeMs { juce::Time::getMillisecondCounterHiRes() };
 };
 
+/** Adds a span from the start of a read to now to the active TraceRecorder, if there is one. */
+static void addFileCacheTraceEvent ([[ maybe_unused ]] const char* name,
+                                    [[ maybe_unused ]] size_t id,
+                                    [[ maybe_unused ]] std::chrono::steady_clock::time_point startTime) noexcept
+{
+   #if TRACKTION_GRAPH_TRACING
+    if (auto recorder = tracktion::graph::TraceRecorder::getActive())
+        recorder->addEvent ({ name, "file_cache", id, std::this_thread::get_id(), startTime, std::chrono::steady_clock::now() });
+   #endif
+}
+
 
 //==============================================================================
 //==============================================================================
@@ -73,43 +237,111 @@ public:
             mapEntireFile = true;
     }
 
-    enum { readAheadSamples = 48000 };
+    enum { readAheadSamples = 48000, upcomingReadAheadSamples = 8192 };
 
-    void touchFiles()
+    /** The positions that readers are currently at and the positions they're
+        expected to jump to soon.
+    */
+    struct ReadPoints
     {
-        juce::Array<SampleCount> readPoints;
-        readPoints.ensureStorageAllocated (64);
+        juce::Array<SampleCount> current, upcoming;
+    };
+
+    ReadPoints getReadPoints() const
+    {
+        ReadPoints readPoints;
+        readPoints.current.ensureStorageAllocated (64);
+
+        const juce::ScopedReadLock sl (clientListLock);
 
+        for (auto r : clients)
         {
-            const juce::ScopedReadLock sl (clientListLock);
+            if (r->getReferenceCount() <= 1)
+                continue;
 
-            for (auto r : clients)
+            const auto readPos = r->readPos.load();
+            const auto loopLength = r->loopLength.load();
+
+            if (readPos > -readAheadSamples)
             {
-                const auto readPos = r->readPos.load();
-                const auto loopLength = r->loopLength.load();
+                if (loopLength > 0)
+                    if (readPos + readAheadSamples > r->loopStart + loopLength)
+                        readPoints.current.addIfNotAlreadyThere (r->loopStart);
 
-                if (r->getReferenceCount() > 1 && readPos > -readAheadSamples)
-                {
-                    if (loopLength > 0)
-                        if (readPos + readAheadSamples > r->loopStart + loopLength)
-                            readPoints.addIfNotAlreadyThere (r->loopStart);
+                readPoints.current.addIfNotAlreadyThere (std::max (SampleCount(), readPos));
+            }
 
-                    readPoints.addIfNotAlreadyThere (std::max (SampleCount(), readPos));
-                }
+            // These are kept even if the reader is parked before the start, so that
+            // a reader waiting to be used can keep the data it'll start with ready
+            for (auto& upcoming : r->upcomingReadPos)
+                if (const auto pos = upcoming.load(); pos >= 0)
+                    readPoints.upcoming.addIfNotAlreadyThere (pos);
+        }
+
+        return readPoints;
+    }
+
+    /** Starts the OS reading the mapped data that touchFiles is about to touch.
+        This should be called for all the files before touching any of them.
+    */
+    void prefetchFiles()
+    {
+        auto readPoints = getReadPoints();
+
+        const juce::ScopedReadLock sl (readerLock);
+
+        for (auto pos : readPoints.current)
+            prefetchAllReaders ({ pos, pos + readAheadSamples });
+
+        for (auto pos : readPoints.upcoming)
+            prefetchAllReaders ({ pos, pos + readAheadSamples });
+    }
+
+    void prefetchAllReaders (SampleRange range)
+    {
+        const auto bytesPerFrame = (int64_t) info.numChannels * (info.bitsPerSample / 8);
+
+        if (bytesPerFrame <= 0)
+            return;
+
+        // The exact offset of the audio data isn't known here but it can only be
+        // within the non-audio part of the file so extend the range to cover that
+        const auto maxHeaderBytes = std::max<int64_t> (0, fileSizeBytes.load() - info.lengthInSamples * bytesPerFrame);
+
+        for (auto* r : readers)
+        {
+            if (r != nullptr)
+            {
+                auto section = r->getMappedSection();
+                auto rangeToPrefetch = range.getIntersectionWith (SampleRange (section.getStart(), section.getEnd()));
+
+                if (! rangeToPrefetch.isEmpty())
+                    readAheadHint.prefetch (file.getFile(),
+                                            rangeToPrefetch.getStart() * bytesPerFrame,
+                                            rangeToPrefetch.getLength() * bytesPerFrame + maxHeaderBytes);
             }
         }
+    }
+
+    void touchFiles()
+    {
+        auto readPoints = getReadPoints();
 
         const juce::ScopedReadLock sl (readerLock);
 
-        for (auto pos : readPoints)
-            touchAllReaders ({ pos, pos + 128 });
+        // Readers that are playing are touched before any upcoming positions as they'll be read first
+        for (auto* points : { &readPoints.current, &readPoints.upcoming })
+        {
+            for (auto pos : *points)
+                touchAllReaders ({ pos, pos + 128 });
 
-        for (auto pos : readPoints)
-            touchAllReaders ({ pos + 128, pos + 4096 });
+            for (auto pos : *points)
+                touchAllReaders ({ pos + 128, pos + 4096 });
 
-        for (int distanceAhead = 4096; distanceAhead < 48000; distanceAhead += 8192)
-            for (auto pos : readPoints)
-                touchAllReaders ({ pos + distanceAhead, pos + distanceAhead + 8192 });
+            for (int distanceAhead = 4096; distanceAhead < 48000; distanceAhead += 8192)
+                for (auto pos : *points)
+                    touchAllReaders ({ pos + distanceAhead, pos + distanceAhead + 8192 });
+        }
     }
 
     void touchAllReaders (SampleRange range) const
@@ -129,6 +361,10 @@ public:
 
     bool updateBlocks()
     {
+        // Stay released until something tries to read the file again
+        if (isEvicted)
+            return false;
+
         {
             const juce::ScopedReadLock sl (readerLock);
 
@@ -147,11 +383,20 @@ public:
                             < lastFailedOpenAttempt + 4000 + (uint32_t) random.nextInt (3000))
                     return false;
 
-                const juce::ScopedWriteLock sl (readerLock);
+                // Create the reader before taking the lock as prefaulting it may take a while
+                const auto refillStartTicks = juce::Time::getHighResolutionTicks();
 
                 if (auto r = createNewReader (nullptr))
                 {
-                    readers.add (r);
+                    if (shouldPrefaultPages())
+                        prefaultNewReader (*r);
+
+                    {
+                        const juce::ScopedWriteLock sl (readerLock);
+                        readers.add (r);
+                    }
+
+                    addRefillLatency (refillStartTicks);
                 }
                 else
                 {
@@ -204,13 +449,28 @@ public:
                         for (int i = start; i <= end; ++i)
                             blocksNeeded.addIfNotAlreadyThere (i);
                     }
+
+                    // Only map enough around upcoming positions to cover the first few blocks after a jump
+                    for (auto& upcoming : r->upcomingReadPos)
+                    {
+                        if (const auto pos = upcoming.load(); pos >= 0)
+                        {
+                            auto start = std::min (lastPossibleBlockIndex, (int) (pos / blockSize));
+                            auto end   = std::min (lastPossibleBlockIndex, (int) ((pos + upcomingReadAheadSamples) / blockSize));
+
+                            for (int i = start; i <= end; ++i)
+                                blocksNeeded.addIfNotAlreadyThere (i);
+                        }
+                    }
                 }
             }
         }
 
         if (blocksNeeded != currentBlocks)
         {
+            const auto refillStartTicks = juce::Time::getHighResolutionTicks();
             juce::OwnedArray<juce::MemoryMappedAudioFormatReader> newReaders;
+            juce::Array<juce::MemoryMappedAudioFormatReader*> readersToPrefault;
 
             {
                 const juce::ScopedReadLock sl (readerLock);
@@ -232,6 +492,7 @@ public:
                         auto pos = block * (SampleCount) blockSize;
                         SampleRange range (pos, pos + blockSize);
                         newReader = createNewReader (&range);
+                        readersToPrefault.add (newReader);
                     }
 
                     if (newReader != nullptr)
@@ -241,6 +502,11 @@ public:
                 }
             }
 
+            if (shouldPrefaultPages())
+                for (auto r : readersToPrefault)
+                    if (r != nullptr)
+                        prefaultNewReader (*r);
+
             {
                 const juce::ScopedWriteLock sl (readerLock);
                 newReaders.swapWith (readers);
@@ -253,6 +519,9 @@ public:
                 if (m != nullptr)
                     totalBytesInUse -= static_cast<int64_t> (m->getNumBytesUsed());
 
+            if (! readersToPrefault.isEmpty())
+                addRefillLatency (refillStartTicks);
+
             anythingChanged = true;
         }
 
@@ -288,6 +557,7 @@ public:
         {
             totalBytesInUse += static_cast<int64_t> (r->getNumBytesUsed());
             failedToOpenFile = false;
+            fileSizeBytes = file.getFile().getSize();
 
             info = AudioFileInfo (file, r.get(), af);
             return r.release();
@@ -296,6 +566,39 @@ public:
         return {};
     }
 
+    bool shouldPrefaultPages() const
+    {
+        return cache.engine.getEngineBehaviour().getMemoryMappedAudioSettings().prefaultPages;
+    }
+
+    /** Touches a page at a time of the parts of a newly mapped reader that are about
+        to be read so the audio thread doesn't hit the page faults.
+    */
+    void prefaultNewReader (juce::MemoryMappedAudioFormatReader& r) const
+    {
+        const auto bytesPerFrame = (int) (r.numChannels * (unsigned int) r.bitsPerSample / 8);
+
+        if (bytesPerFrame <= 0)
+            return;
+
+        const auto samplesPerPage = std::max (1, 4096 / bytesPerFrame);
+        const auto section = r.getMappedSection();
+
+        const auto readPoints = getReadPoints();
+
+        for (auto* points : { &readPoints.current, &readPoints.upcoming })
+        {
+            for (auto pos : *points)
+            {
+                auto range = SampleRange (pos, pos + readAheadSamples)
+                                .getIntersectionWith (SampleRange (section.getStart(), section.getEnd()));
+
+                for (auto i = range.getStart(); i < range.getEnd(); i += samplesPerPage)
+                    r.touchSample (i);
+            }
+        }
+    }
+
     void purgeOrphanReaders()
     {
         const juce::ScopedWriteLock sl (clientListLock);
@@ -314,9 +617,19 @@ public:
 
     void releaseReader()
     {
+        const juce::ScopedLock scl (blockUpdateLock);
         const juce::ScopedWriteLock sl (readerLock);
         readers.clear();
         currentBlocks.clear();
+        readAheadHint.close();
+        totalBytesInUse = 0;
+    }
+
+    /** Releases the mapped data until the file is next read. */
+    void evict()
+    {
+        isEvicted = true;
+        releaseReader();
     }
 
     void validateFile()
@@ -331,6 +644,16 @@ public:
         {
             uint32_t startTime = 0;
 
+            // Time spent waiting during playback is reported to the DeviceManager's telemetry
+            auto& telemetry = f.cache.engine.getDeviceManager().getAudioCallbackTelemetry();
+            juce::int64 waitStartTicks = 0;
+
+            auto finishWaiting = [&]
+            {
+                if (waitStartTicks != 0)
+                    telemetry.addFileCacheWaitTime (juce::Time::getHighResolutionTicks() - waitStartTicks);
+            };
+
             for (;;)
             {
                 if (lock.tryEnterRead())
@@ -338,11 +661,20 @@ public:
                     reader = f.findReaderFor (startSample);
 
                     if (reader != nullptr)
+                    {
+                        finishWaiting();
                         return;
+                    }
 
                     lock.exitRead();
                 }
 
+                if (timeoutMs > 0)
+                    hadToWait = true;
+
+                if (waitStartTicks == 0 && timeoutMs > 0 && telemetry.isActive())
+                    waitStartTicks = juce::Time::getHighResolutionTicks();
+
                 if (timeoutMs < 0)
                 {
                     if (startTime != 0) // second failed after calling updateBlocks failed
@@ -370,6 +702,7 @@ public:
                     juce::Thread::yield();
             }
 
+            finishWaiting();
             isLocked = false;
         }
 
@@ -381,18 +714,21 @@ public:
 
         juce::MemoryMappedAudioFormatReader* reader = nullptr;
         juce::ReadWriteLock& lock;
-        bool isLocked = true;
+        bool isLocked = true, hadToWait = false;
 
         JUCE_DECLARE_NON_COPYABLE (LockedReaderFinder)
     };
 
     bool read (SampleCount startSample, int* const* destSamples, int numDestChannels,
-               int startOffsetInDestBuffer, int numSamples, int timeoutMs)
+               int startOffsetInDestBuffer, int numSamples, int timeoutMs, bool& hadToWait)
     {
         jassert (destSamples != nullptr);
         jassert (startSample >= 0);
         jassert (startOffsetInDestBuffer >= 0);
 
+        if (isEvicted)
+            isEvicted = false;
+
         bool allDataRead = true;
 
         while (numSamples > 0)
@@ -406,6 +742,9 @@ public:
             const LockedReaderFinder l (*this, startSample, timeoutMs);
             SCOPED_REALTIME_CHECK
 
+            if (l.hadToWait)
+                hadToWait = true;
+
             if (l.isLocked && l.reader != nullptr)
             {
                 auto numThisTime = int (std::min<int64_t> (numSamples, l.reader->getMappedSection().getEnd() - startSample));
@@ -436,6 +775,9 @@ public:
         jassert (startSample >= 0);
         bool allDataRead = true, isFirst = true;
 
+        if (isEvicted)
+            isEvicted = false;
+
         while (numSamples > 0)
         {
             const LockedReaderFinder l (*this, startSample, timeoutMs);
@@ -490,6 +832,47 @@ public:
 
     std::atomic<uint32_t> lastReadTime { juce::Time::getApproximateMillisecondCounter() };
     std::atomic<int64_t> totalBytesInUse { 0 };
+    std::atomic<bool> isEvicted { false };
+
+    Reader::ReadCounters counters;
+    std::array<std::atomic<uint64_t>, numRefillLatencyBins> refillLatencyHistogram {};
+
+    int64_t getBytesPerFrame() const noexcept
+    {
+        return (int64_t) info.numChannels * (info.bitsPerSample / 8);
+    }
+
+    FileStatistics getStatistics() const
+    {
+        FileStatistics stats;
+        stats.file = file;
+        stats.reads = counters.get();
+
+        for (size_t i = 0; i < refillLatencyHistogram.size(); ++i)
+            stats.refillLatencyHistogram[i] = refillLatencyHistogram[i].load (std::memory_order_relaxed);
+
+        const juce::ScopedReadLock sl (clientListLock);
+        stats.readers.reserve ((size_t) clients.size());
+
+        for (auto r : clients)
+            if (r->getReferenceCount() > 1)
+                stats.readers.push_back ({ r->getOwnerID(), r->getStatistics() });
+
+        return stats;
+    }
+
+    void resetStatistics()
+    {
+        counters.reset();
+
+        for (auto& bin : refillLatencyHistogram)
+            bin.store (0, std::memory_order_relaxed);
+
+        const juce::ScopedReadLock sl (clientListLock);
+
+        for (auto r : clients)
+            r->counters.reset();
+    }
 
 private:
     juce::OwnedArray<juce::MemoryMappedAudioFormatReader> readers;
@@ -498,6 +881,9 @@ private:
     juce::CriticalSection blockUpdateLock;
     juce::Array<int> currentBlocks;
 
+    FileReadAheadHint readAheadHint;
+    std::atomic<int64_t> fileSizeBytes { 0 };
+
     bool mapEntireFile = false;
     std::atomic<bool> failedToOpenFile { false };
     uint32_t lastFailedOpenAttempt = 0;
@@ -505,6 +891,17 @@ private:
 
     juce::ReadWriteLock clientListLock, readerLock;
 
+    void addRefillLatency (juce::int64 startTicks) noexcept
+    {
+        const auto ms = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+        size_t bin = 0;
+
+        for (double binEndMs = 0.125; bin < refillLatencyHistogram.size() - 1 && ms >= binEndMs; binEndMs *= 2.0)
+            ++bin;
+
+        refillLatencyHistogram[bin].fetch_add (1, std::memory_order_relaxed);
+    }
+
     juce::MemoryMappedAudioFormatReader* findReaderFor (SampleCount sample) const
     {
         for (auto r : readers)
@@ -544,13 +941,15 @@ public:
 
             auto now = juce::Time::getApproximateMillisecondCounter();
 
-            if (now > lastOldFlePurge + 2000)
+            if (isLongerThan (lastOldFlePurge, now, 2000))
             {
                 lastOldFlePurge = now;
                 owner.purgeOldFiles();
                 continue;
             }
 
+            owner.enforceMemoryLimit();
+
             wait (20);
 
             //DBG ("Total cache mapping: " << owner.getBytesInUse() / (1024 * 1024) << " Mb");
@@ -596,6 +995,7 @@ AudioFileCache::AudioFileCache (Engine& e)  : engine (e)
 
     // TODO: when we drop 32-bit support, delete the cache size and related code
     setCacheSizeSamples (static_cast<juce::int64> (engine.getPropertyStorage().getProperty (SettingID::cacheSizeSamples, defaultSize)));
+    setNumBackgroundReaderThreads (juce::SystemStats::getNumCpus() / 4);
 }
 
 AudioFileCache::~AudioFileCache()
@@ -649,6 +1049,11 @@ void AudioFileCache::setCacheSizeSamples (SampleCount samples)
     }
 }
 
+int64_t AudioFileCache::getUpcomingReadAheadBytes (const AudioFileInfo& info)
+{
+    return (int64_t) CachedFile::upcomingReadAheadSamples * info.numChannels * (info.bitsPerSample / 8);
+}
+
 //==============================================================================
 AudioFileCache::CachedFile* AudioFileCache::getOrCreateCachedFile (const AudioFile& f)
 {
@@ -701,7 +1106,7 @@ void AudioFileCache::validateFile (const AudioFile& file)
 void AudioFileCache::purgeOldFiles()
 {
     CRASH_TRACER
-    auto oldestAllowedTime = juce::Time::getApproximateMillisecondCounter() - 2000;
+    const auto now = juce::Time::getApproximateMillisecondCounter();
 
     const juce::ScopedWriteLock sl (fileListLock);
 
@@ -712,11 +1117,49 @@ void AudioFileCache::purgeOldFiles()
     {
         auto f = activeFiles.getUnchecked (i);
 
-        if (f->lastReadTime < oldestAllowedTime && f->isUnused())
+        if (isLongerThan (f->lastReadTime, now, 2000) && f->isUnused())
             activeFiles.remove (i);
     }
 }
 
+void AudioFileCache::enforceMemoryLimit()
+{
+    const auto maxBytes = maxBytesInUse.load();
+
+    if (maxBytes <= 0)
+        return;
+
+    const juce::ScopedReadLock sl (fileListLock);
+    int64_t totalBytes = 0;
+
+    for (auto f : activeFiles)
+        totalBytes += f->totalBytesInUse;
+
+    if (totalBytes <= maxBytes)
+        return;
+
+    // Release the least recently read files first but leave any that are being played
+    const auto now = juce::Time::getApproximateMillisecondCounter();
+    juce::Array<CachedFile*> filesToEvict;
+
+    for (auto f : activeFiles)
+        if (f->totalBytesInUse > 0 && isLongerThan (f->lastReadTime, now, 1000))
+            filesToEvict.add (f);
+
+    std::sort (filesToEvict.begin(), filesToEvict.end(),
+               [now] (auto a, auto b) { return now - a->lastReadTime > now - b->lastReadTime; });
+
+    for (auto f : filesToEvict)
+    {
+        if (totalBytes <= maxBytes)
+            break;
+
+        totalBytes -= f->totalBytesInUse;
+        f->evict();
+        ++numEvictions;
+    }
+}
+
 bool AudioFileCache::serviceNextReader()
 {
     const juce::ScopedReadLock sl (fileListLock);
@@ -741,6 +1184,9 @@ void AudioFileCache::touchReaders()
 
     const juce::ScopedReadLock sl (fileListLock);
 
+    for (auto f : activeFiles)
+        f->prefetchFiles();
+
     for (auto f : activeFiles)
     {
         f->touchFiles();
@@ -750,6 +1196,120 @@ void AudioFileCache::touchReaders()
     totalBytesUsed = totalBytes;
 }
 
+void AudioFileCache::setNumBackgroundReaderThreads (int numThreads)
+{
+    const juce::ScopedLock sl (backgroundReaderThreadLock);
+    numBackgroundReaderThreads = juce::jlimit (1, 16, numThreads);
+}
+
+int AudioFileCache::getNumBackgroundReaderThreads() const
+{
+    const juce::ScopedLock sl (backgroundReaderThreadLock);
+    return numBackgroundReaderThreads;
+}
+
+juce::TimeSliceThread& AudioFileCache::getBackgroundReaderThread()
+{
+    const juce::ScopedLock sl (backgroundReaderThreadLock);
+
+    // Threads beyond the current limit are kept for their existing readers but not given any new ones
+    juce::TimeSliceThread* leastBusy = nullptr;
+
+    for (int i = 0; i < std::min (numBackgroundReaderThreads, backgroundReaderThreads.size()); ++i)
+    {
+        auto t = backgroundReaderThreads.getUnchecked (i);
+
+        if (leastBusy == nullptr || t->getNumClients() < leastBusy->getNumClients())
+            leastBusy = t;
+    }
+
+    if (leastBusy == nullptr
+         || (leastBusy->getNumClients() > 0 && backgroundReaderThreads.size() < numBackgroundReaderThreads))
+    {
+        leastBusy = backgroundReaderThreads.add (std::make_unique<juce::TimeSliceThread> ("Preview Buffer " + juce::String (backgroundReaderThreads.size() + 1)));
+        leastBusy->startThread (juce::Thread::Priority::low);
+    }
+
+    return *leastBusy;
+}
+
+void AudioFileCache::setDecodedSidecarDiskQuota (int64_t maxBytes)
+{
+    decodedSidecarDiskQuota = std::max<int64_t> (0, maxBytes);
+}
+
+void AudioFileCache::setMaxBytesInUse (int64_t maxBytes)
+{
+    maxBytesInUse = std::max<int64_t> (0, maxBytes);
+}
+
+int64_t AudioFileCache::getBytesInUse (const AudioFile& file) const
+{
+    const juce::ScopedReadLock sl (fileListLock);
+
+    for (auto f : activeFiles)
+        if (f->info.hashCode == file.getHash())
+            return f->totalBytesInUse;
+
+    return 0;
+}
+
+int64_t AudioFileCache::releaseIdleFiles (const juce::Array<AudioFile>& files)
+{
+    const juce::ScopedReadLock sl (fileListLock);
+    const auto now = juce::Time::getApproximateMillisecondCounter();
+    int64_t numBytesReleased = 0;
+
+    for (auto f : activeFiles)
+    {
+        if (f->totalBytesInUse > 0 && isLongerThan (f->lastReadTime, now, 1000)
+             && std::any_of (files.begin(), files.end(), [f] (auto& af) { return af.getHash() == f->info.hashCode; }))
+        {
+            numBytesReleased += f->totalBytesInUse;
+            f->evict();
+            ++numEvictions;
+        }
+    }
+
+    return numBytesReleased;
+}
+
+AudioFileCache::Statistics AudioFileCache::getStatistics() const
+{
+    Statistics stats;
+    stats.numHits = numHits;
+    stats.numMisses = numMisses;
+    stats.numEvictions = numEvictions;
+    stats.bytesInUse = totalBytesUsed;
+
+    return stats;
+}
+
+std::vector<AudioFileCache::FileStatistics> AudioFileCache::getFileStatistics() const
+{
+    std::vector<FileStatistics> stats;
+
+    const juce::ScopedReadLock sl (fileListLock);
+    stats.reserve ((size_t) activeFiles.size());
+
+    for (auto f : activeFiles)
+        stats.push_back (f->getStatistics());
+
+    return stats;
+}
+
+void AudioFileCache::resetStatistics()
+{
+    numHits = 0;
+    numMisses = 0;
+    numEvictions = 0;
+
+    const juce::ScopedReadLock sl (fileListLock);
+
+    for (auto f : activeFiles)
+        f->resetStatistics();
+}
+
 bool AudioFileCache::hasCacheMissed (bool clearMissedFlag)
 {
     const bool didMiss = cacheMissed;
@@ -799,13 +1359,12 @@ AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file)
         return r;
     }
 
-    if (auto reader = AudioFileUtils::createReaderFor (engine, file.getFile()))
-    {
-        backgroundReaderThread.startThread (juce::Thread::Priority::low);
+    if (auto r = createDecodedSidecarReader (file))
+        return r;
 
-        return new Reader (*this, nullptr, std::make_unique<BufferingAudioReaderWrapper> (std::make_unique<juce::BufferingAudioReader> (reader, backgroundReaderThread,
+    if (auto reader = AudioFileUtils::createReaderFor (engine, file.getFile()))
+        return new Reader (*this, nullptr, std::make_unique<BufferingAudioReaderWrapper> (std::make_unique<juce::BufferingAudioReader> (reader, getBackgroundReaderThread(),
                                                                                                                                         48000 * 5)));
-    }
 
     return {};
 }
@@ -825,10 +1384,12 @@ AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file,
         return r;
     }
 
+    if (auto r = createDecodedSidecarReader (file))
+        return r;
+
     if (auto reader = AudioFileUtils::createReaderFor (engine, file.getFile()))
     {
-        backgroundReaderThread.startThread (juce::Thread::Priority::low);
-        auto fallbackReader = createFallbackReader (reader, backgroundReaderThread,
+        auto fallbackReader = createFallbackReader (reader, getBackgroundReaderThread(),
                                                     48000 * 5);
         return new Reader (*this, nullptr, std::move (fallbackReader));
     }
@@ -836,12 +1397,44 @@ AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file,
     return {};
 }
 
+AudioFileCache::Reader::Ptr AudioFileCache::createDecodedSidecarReader (const AudioFile& file)
+{
+    const auto quota = decodedSidecarDiskQuota.load();
+
+    if (quota <= 0 || ! file.getInfo().needsCachedProxy)
+        return {};
+
+    auto& afm = engine.getAudioFileManager();
+    auto sidecar = engine.getTemporaryFileManager().getFileForDecodedSidecar (file);
+
+    if (! afm.proxyGenerator.isProxyBeingGenerated (sidecar))
+    {
+        if (sidecar.getFile().existsAsFile() && sidecar.isValid())
+        {
+            if (auto f = getOrCreateCachedFile (sidecar))
+            {
+                // Some file systems don't update this on reads so set it for the LRU purge
+                sidecar.getFile().setLastAccessTime (juce::Time::getCurrentTime());
+
+                auto r = new Reader (*this, f, nullptr);
+                f->addClient (r);
+                return r;
+            }
+        }
+        else
+        {
+            afm.proxyGenerator.beginJob (new DecodedSidecarJob (file, sidecar, quota));
+        }
+    }
+
+    return {};
+}
+
 AudioFileCache::Reader::Ptr AudioFileCache::createFallbackReader (const std::function<std::unique_ptr<FallbackReader> (juce::TimeSliceThread& timeSliceThread,
                                                                                                                        int samplesToBuffer)>&
                                                                   createFallbackReader)
 {
-    backgroundReaderThread.startThread (juce::Thread::Priority::low);
-    auto fallbackReader = createFallbackReader (backgroundReaderThread,
+    auto fallbackReader = createFallbackReader (getBackgroundReaderThread(),
                                                 48000 * 5);
     return new Reader (*this, nullptr, std::move (fallbackReader));
 }
@@ -867,17 +1460,66 @@ AudioFileCache::Reader::~Reader()
 {
 }
 
-void AudioFileCache::Reader::setReadPosition (SampleCount pos) noexcept
+SampleCount AudioFileCache::Reader::wrapToLoopRange (SampleCount pos) const noexcept
 {
     const auto localLoopStart = loopStart.load();
     const auto localLoopLength = loopLength.load();
 
-    if (loopLength == 0)
-        readPos = pos;
-    else if (pos >= 0)
-        readPos = localLoopStart + (pos % localLoopLength);
-    else
-        readPos = localLoopStart + juce::negativeAwareModulo (pos, localLoopLength);
+    if (localLoopLength == 0)
+        return pos;
+
+    if (pos >= 0)
+        return localLoopStart + (pos % localLoopLength);
+
+    return localLoopStart + juce::negativeAwareModulo (pos, localLoopLength);
+}
+
+void AudioFileCache::Reader::setReadPosition (SampleCount pos) noexcept
+{
+    readPos = wrapToLoopRange (pos);
+}
+
+void AudioFileCache::Reader::setUpcomingReadPositions (std::optional<SampleCount> first,
+                                                       std::optional<SampleCount> second) noexcept
+{
+    upcomingReadPos[0] = first ? std::max (SampleCount(), wrapToLoopRange (*first)) : -1;
+    upcomingReadPos[1] = second ? std::max (SampleCount(), wrapToLoopRange (*second)) : -1;
+}
+
+void AudioFileCache::Reader::setOwnerID (EditItemID newOwnerID) noexcept
+{
+    ownerID = newOwnerID.getRawID();
+}
+
+EditItemID AudioFileCache::Reader::getOwnerID() const noexcept
+{
+    return EditItemID::fromRawID (ownerID.load());
+}
+
+void AudioFileCache::Reader::ReadCounters::addRead (bool allDataRead, bool hadToWait, uint64_t numBytes) noexcept
+{
+    (allDataRead ? numHits : numMisses).fetch_add (1, std::memory_order_relaxed);
+
+    if (hadToWait)
+        numBlockingWaits.fetch_add (1, std::memory_order_relaxed);
+
+    numBytesRead.fetch_add (numBytes, std::memory_order_relaxed);
+}
+
+AudioFileCache::ReadStatistics AudioFileCache::Reader::ReadCounters::get() const noexcept
+{
+    return { numHits.load (std::memory_order_relaxed),
+             numMisses.load (std::memory_order_relaxed),
+             numBlockingWaits.load (std::memory_order_relaxed),
+             numBytesRead.load (std::memory_order_relaxed) };
+}
+
+void AudioFileCache::Reader::ReadCounters::reset() noexcept
+{
+    numHits = 0;
+    numMisses = 0;
+    numBlockingWaits = 0;
+    numBytesRead = 0;
 }
 
 int AudioFileCache::Reader::getNumChannels() const noexcept
@@ -1026,6 +1668,7 @@ bool AudioFileCache::Reader::readSamples (int numSamples,
 bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestChannels,
                                           int startOffsetInDestBuffer, int numSamples, int timeoutMs)
 {
+    TRACKTION_GRAPH_TRACE_SCOPE ("AudioFileCache::Reader::readSamples", "file_cache", (size_t) numSamples)
     jassert (numSamples < CachedFile::readAheadSamples); // this method fails unless broken down into chunks smaller than this
     jassert (getReferenceCount() > 1 || file == nullptr); // may be being used after the cache has been deleted
     jassert (timeoutMs >= 0);
@@ -1046,14 +1689,16 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
             return true;
     }
 
-    bool allOk = true;
+    bool allOk = true, hadToWait = false;
     const ScopedFileRead sfr (cache);
+    const auto readStartTime = std::chrono::steady_clock::now();
+    const auto numSamplesToRead = numSamples;
 
     if (loopLength == 0)
     {
         if (auto cf = static_cast<CachedFile*> (file))
         {
-            allOk = cf->read (readPos, destSamples, numDestChannels, startOffsetInDestBuffer, numSamples, timeoutMs);
+            allOk = cf->read (readPos, destSamples, numDestChannels, startOffsetInDestBuffer, numSamples, timeoutMs, hadToWait);
         }
         else
         {
@@ -1073,7 +1718,7 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
 
             if (auto cf = static_cast<CachedFile*> (file))
             {
-                allOk = cf->read (readPos, destSamples, numDestChannels, startOffsetInDestBuffer, numToRead, timeoutMs) && allOk;
+                allOk = cf->read (readPos, destSamples, numDestChannels, startOffsetInDestBuffer, numToRead, timeoutMs, hadToWait) && allOk;
             }
             else
             {
@@ -1089,16 +1734,40 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
             startOffsetInDestBuffer += numToRead;
             numSamples -= numToRead;
         }
-
-        return allOk;
     }
     else
     {
         clearSetOfChannels (destSamples, numDestChannels, startOffsetInDestBuffer, numSamples);
     }
 
-    if (! allOk)
+    if (allOk)
+    {
+        ++cache.numHits;
+    }
+    else
+    {
+        ++cache.numMisses;
         cache.cacheMissed = true;
+    }
+
+    const auto cf = static_cast<CachedFile*> (file);
+    const auto bytesPerFrame = cf != nullptr ? cf->getBytesPerFrame()
+                                             : (int64_t) fallbackReader->numChannels * (fallbackReader->bitsPerSample / 8);
+    const auto numBytes = (uint64_t) (numSamplesToRead * bytesPerFrame);
+
+    counters.addRead (allOk, hadToWait, numBytes);
+
+    if (cf != nullptr)
+        cf->counters.addRead (allOk, hadToWait, numBytes);
+
+    if (! allOk || hadToWait)
+    {
+        const auto owner = ownerID.load();
+        const auto traceID = owner != 0 ? (size_t) owner
+                                        : (cf != nullptr ? (size_t) cf->info.hashCode : 0);
+
+        addFileCacheTraceEvent (allOk ? "AudioFileCache wait" : "AudioFileCache miss", traceID, readStartTime);
+    }
 
     return allOk;
 }
@@ -33,6 +33,16 @@ public:
     AudioFileCache (Engine&);
     ~AudioFileCache();
 
+    //==============================================================================
+    /** Counters for the reads made by a Reader, or of a file by all its Readers. */
+    struct ReadStatistics
+    {
+        uint64_t numHits = 0;           /**< The number of reads that found all their data. */
+        uint64_t numMisses = 0;         /**< The number of reads that were missing some data. */
+        uint64_t numBlockingWaits = 0;  /**< The number of reads that had to wait, up to their timeout, for data to be mapped. */
+        uint64_t numBytesRead = 0;      /**< The number of bytes of the file's audio that were read. */
+    };
+
     //==============================================================================
     class Reader  : public juce::ReferenceCountedObject
     {
@@ -64,17 +74,56 @@ public:
 
         void setLoopRange (SampleRange);
 
+        /** Sets positions that reading is expected to jump to soon, e.g. the start of
+            a transport loop or a pending position change. The cache will start
+            reading the file at these positions so the first block after the jump
+            doesn't miss. These are wrapped to the loop range like setReadPosition.
+            Pass std::nullopt to clear a position.
+            Upcoming positions are used even while the read position is before the
+            start of the file so an idle reader can keep the data it'll start from
+            ready. They're read after the positions of readers that are playing.
+        */
+        void setUpcomingReadPositions (std::optional<SampleCount> first,
+                                       std::optional<SampleCount> second = std::nullopt) noexcept;
+
         int getNumChannels() const noexcept;
         double getSampleRate() const noexcept;
 
+        /** Sets the item, e.g. a clip, that this Reader is reading for.
+            This is used to attribute its statistics and trace events.
+        */
+        void setOwnerID (EditItemID) noexcept;
+
+        /** Returns the ID set with setOwnerID. */
+        EditItemID getOwnerID() const noexcept;
+
+        /** Returns the statistics of the reads this Reader has made.
+            This can be called from any thread.
+        */
+        ReadStatistics getStatistics() const noexcept   { return counters.get(); }
+
     private:
         friend class AudioFileCache;
 
+        struct ReadCounters
+        {
+            std::atomic<uint64_t> numHits { 0 }, numMisses { 0 }, numBlockingWaits { 0 }, numBytesRead { 0 };
+
+            void addRead (bool allDataRead, bool hadToWait, uint64_t numBytes) noexcept;
+            ReadStatistics get() const noexcept;
+            void reset() noexcept;
+        };
+
         AudioFileCache& cache;
         void* file;
         std::atomic<SampleCount> readPos { 0 }, loopStart { 0 }, loopLength { 0 };
+        std::atomic<SampleCount> upcomingReadPos[2] { { -1 }, { -1 } };
+        std::atomic<uint64_t> ownerID { 0 };
+        ReadCounters counters;
         std::unique_ptr<FallbackReader> fallbackReader;
 
+        SampleCount wrapToLoopRange (SampleCount) const noexcept;
+
         Reader (AudioFileCache&, void*, std::unique_ptr<FallbackReader>);
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Reader)
@@ -101,10 +150,113 @@ public:
     void setCacheSizeSamples (SampleCount samplesPerFile);
     SampleCount getCacheSizeSamples() const         { return cacheSizeSamples; }
 
+    /** Returns the number of bytes of a file kept ready to read from each of a
+        Reader's upcoming read positions.
+        @see Reader::setUpcomingReadPositions
+    */
+    static int64_t getUpcomingReadAheadBytes (const AudioFileInfo&);
+
     SampleCount getBytesInUse() const               { return totalBytesUsed; }
 
+    /** Sets the number of background threads used to read files that can't be
+        memory-mapped, e.g. compressed formats that need decoding.
+        Each new reader is given to the thread that has the fewest readers. Each
+        thread then services the readers that are closest to running out of data first.
+        Changing this doesn't move any existing readers between threads.
+    */
+    void setNumBackgroundReaderThreads (int);
+
+    /** Returns the number of threads used to read files that can't be memory-mapped. */
+    int getNumBackgroundReaderThreads() const;
+
     bool hasCacheMissed (bool clearMissedFlag);
 
+    //==============================================================================
+    /** Sets a limit for the total number of bytes mapped by the cache.
+        When this is exceeded, files that haven't been read recently are released,
+        least recently read first. They'll be mapped again when they're next read.
+        Files that are being actively read are never released so this is a soft limit.
+        A value of 0 means no limit.
+    */
+    void setMaxBytesInUse (int64_t maxBytes);
+
+    /** Returns the limit set by setMaxBytesInUse. */
+    int64_t getMaxBytesInUse() const                { return maxBytesInUse; }
+
+    /** Returns the number of bytes currently mapped for a file. */
+    int64_t getBytesInUse (const AudioFile&) const;
+
+    /** Releases the mapped data of any of these files that haven't been read recently.
+        Like the memory limit, files that are being actively read are left alone.
+        They'll be mapped again when they're next read.
+        @returns the number of bytes released
+        @see EditMemoryBudget
+    */
+    int64_t releaseIdleFiles (const juce::Array<AudioFile>&);
+
+    /** Counters describing how well the cache is performing. */
+    struct Statistics
+    {
+        uint64_t numHits = 0;           /**< The number of reads that found all their data. */
+        uint64_t numMisses = 0;         /**< The number of reads that were missing some data. */
+        uint64_t numEvictions = 0;      /**< The number of files released to stay in the memory limit. */
+        int64_t bytesInUse = 0;         /**< The number of bytes currently mapped. */
+
+        /** Returns the proportion of reads that were hits, 0 to 1. */
+        double getHitRate() const       { return numHits + numMisses > 0 ? numHits / (double) (numHits + numMisses) : 1.0; }
+    };
+
+    /** Enables decoded sidecar files for compressed sources such as MP3, OGG and FLAC.
+        When a reader is created for one of these, a 32-bit float copy is decoded in
+        the background to a file in the TemporaryFileManager's folder. Readers created
+        after that's finished will use the memory-mapped path instead of decoding.
+        The least recently used sidecars are deleted to keep their total size within
+        the given number of bytes. A value of 0, the default, disables sidecars.
+        @see TemporaryFileManager::getFileForDecodedSidecar
+    */
+    void setDecodedSidecarDiskQuota (int64_t maxBytes);
+
+    /** Returns the quota set by setDecodedSidecarDiskQuota. */
+    int64_t getDecodedSidecarDiskQuota() const      { return decodedSidecarDiskQuota; }
+
+    /** Returns the statistics gathered since the cache was created or resetStatistics was called. */
+    Statistics getStatistics() const;
+
+    /** The number of bins in a FileStatistics' refill latency histogram.
+        Bin i counts refills that took less than 0.125ms * 2^i, with the last
+        bin holding everything longer.
+    */
+    static constexpr int numRefillLatencyBins = 16;
+
+    /** The statistics of a file and the Readers currently reading it. */
+    struct FileStatistics
+    {
+        /** The statistics of one of the file's Readers. */
+        struct ReaderStatistics
+        {
+            EditItemID ownerID;         /**< @see Reader::setOwnerID */
+            ReadStatistics reads;
+        };
+
+        AudioFile file;
+        ReadStatistics reads;                                       /**< All the reads of the file, including by Readers that have been deleted. */
+        std::array<uint64_t, numRefillLatencyBins> refillLatencyHistogram {};  /**< The time taken to map the new parts of the file as the read positions move. */
+        std::vector<ReaderStatistics> readers;                      /**< The Readers currently using the file. */
+    };
+
+    /** Returns the statistics of each of the files in the cache, to find out which
+        files and clips are missing the cache.
+        The counters are updated with atomics so this never blocks the audio thread.
+        Readers that aren't reading from a cached file, e.g. ones created with
+        createFallbackReader, aren't included but can be checked with Reader::getStatistics.
+        If TRACKTION_GRAPH_TRACING is enabled, misses and blocking waits are also added
+        to the active TraceRecorder, with the ID of the Reader's owner.
+    */
+    std::vector<FileStatistics> getFileStatistics() const;
+
+    /** Resets the hit, miss and eviction counters, along with those of the files and Readers. */
+    void resetStatistics();
+
     /** Returns the amount of time spent reading files in the last block. */
     TimeDuration getCpuUsage() const;
 
@@ -118,6 +270,8 @@ private:
     Engine& engine;
     SampleCount totalBytesUsed = 0, cacheSizeSamples = 0;
     bool cacheMissed = false;
+    std::atomic<int64_t> maxBytesInUse { 0 }, decodedSidecarDiskQuota { 0 };
+    std::atomic<uint64_t> numHits { 0 }, numMisses { 0 }, numEvictions { 0 };
 
     std::atomic<double> blockDurationMs { 0.0 }, lastBlockDurationMs { 0.0 };
     struct ScopedFileRead;
@@ -129,6 +283,7 @@ private:
     juce::ReadWriteLock fileListLock;
 
     CachedFile* getOrCreateCachedFile (const AudioFile&);
+    Reader::Ptr createDecodedSidecarReader (const AudioFile&);
     bool serviceNextReader();
     void touchReaders();
 
@@ -137,11 +292,16 @@ private:
     class RefresherThread;
     std::unique_ptr<RefresherThread> refresherThread;
 
-    juce::TimeSliceThread backgroundReaderThread { "Preview Buffer" };
+    juce::CriticalSection backgroundReaderThreadLock;
+    juce::OwnedArray<juce::TimeSliceThread> backgroundReaderThreads;
+    int numBackgroundReaderThreads = 1;
+
+    juce::TimeSliceThread& getBackgroundReaderThread();
 
     void stopThreads();
 
     void purgeOldFiles();
+    void enforceMemoryLimit();
     void purgeOrphanReaders();
 
     friend class AudioFileManager;
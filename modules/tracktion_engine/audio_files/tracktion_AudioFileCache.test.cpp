@@ -32,6 +32,9 @@ public:
     void runTest() override
     {
         runCacheReadTest();
+        runEvictionTest();
+        runBufferedFileReaderTest();
+        runMemoryMappedFileReaderTest();
     }
 
 private:
@@ -46,7 +49,11 @@ private:
         juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
         fileReader->read (&bufferFromFile, 0, (int) fileReader->lengthInSamples, 0, true, true);
 
-        auto cacheReader = engine.getAudioFileManager().cache.createReader (AudioFile (engine, tempFile->getFile()));
+        auto& cache = engine.getAudioFileManager().cache;
+        cache.resetStatistics();
+
+        auto cacheReader = cache.createReader (AudioFile (engine, tempFile->getFile()));
+        cacheReader->setOwnerID (EditItemID::fromRawID (42));
         juce::AudioBuffer<float> bufferFromCache ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
 
         for (int i = 0; i < bufferFromCache.getNumSamples(); i += 32'768)
@@ -59,6 +66,210 @@ private:
 
         beginTest ("Read a sin wav file");
         expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
+
+        beginTest ("Statistics");
+        {
+            const auto stats = cache.getStatistics();
+            expect (stats.numHits > 0);
+            expectEquals (stats.numMisses, (uint64_t) 0);
+            expectEquals (stats.getHitRate(), 1.0);
+
+            const auto readerStats = cacheReader->getStatistics();
+            expectEquals (readerStats.numHits, stats.numHits);
+            expectEquals (readerStats.numMisses, (uint64_t) 0);
+            expectEquals (readerStats.numBytesRead, (uint64_t) (fileReader->lengthInSamples * fileReader->numChannels * (fileReader->bitsPerSample / 8)));
+
+            const auto fileStats = cache.getFileStatistics();
+            auto found = std::find_if (fileStats.begin(), fileStats.end(),
+                                       [&] (auto& f) { return f.file.getFile() == tempFile->getFile(); });
+            expect (found != fileStats.end());
+
+            if (found != fileStats.end())
+            {
+                expectEquals (found->reads.numHits, readerStats.numHits);
+                expectEquals (found->reads.numBytesRead, readerStats.numBytesRead);
+                expect (std::accumulate (found->refillLatencyHistogram.begin(), found->refillLatencyHistogram.end(), (uint64_t) 0) > 0);
+                expectEquals ((int) found->readers.size(), 1);
+
+                if (! found->readers.empty())
+                    expect (found->readers.front().ownerID == EditItemID::fromRawID (42));
+            }
+
+            cache.resetStatistics();
+            expectEquals (cache.getStatistics().numHits, (uint64_t) 0);
+            expectEquals (cacheReader->getStatistics().numHits, (uint64_t) 0);
+        }
+    }
+
+    void runEvictionTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+        auto& cache = engine.getAudioFileManager().cache;
+
+        beginTest ("Idle times when the millisecond counter wraps");
+        {
+            expect (! isLongerThan (1000, 1500, 1000));
+            expect (isLongerThan (1000, 2001, 1000));
+            expect (! isLongerThan (0xffffff00, 0x100, 1000));
+            expect (isLongerThan (0xffffff00, 0x500, 1000));
+        }
+
+        using namespace graph::test_utilities;
+        auto tempFileA = getSquareFile<juce::WavAudioFormat> (44100.0, 10.0, 2);
+        auto tempFileB = getSquareFile<juce::WavAudioFormat> (44100.0, 10.0, 2);
+        AudioFile fileA (engine, tempFileA->getFile()), fileB (engine, tempFileB->getFile());
+
+        auto readerA = cache.createReader (fileA);
+        auto readerB = cache.createReader (fileB);
+
+        auto readBlock = [] (AudioFileCache::Reader& reader)
+        {
+            juce::AudioBuffer<float> buffer (2, 4096);
+            reader.setReadPosition (0);
+            return reader.readSamples (buffer.getNumSamples(), buffer, juce::AudioChannelSet::stereo(),
+                                       0, juce::AudioChannelSet::stereo(), 5'000);
+        };
+
+        beginTest ("Releasing idle files");
+        {
+            expect (readBlock (*readerA));
+            expect (cache.getBytesInUse (fileA) > 0);
+
+            // Files that have just been read are left alone
+            expectEquals (cache.releaseIdleFiles ({ fileA }), (int64_t) 0);
+            expect (cache.getBytesInUse (fileA) > 0);
+
+            juce::Thread::sleep (1200);
+            const auto numEvictions = cache.getStatistics().numEvictions;
+            expect (cache.releaseIdleFiles ({ fileA }) > 0);
+            expectEquals (cache.getBytesInUse (fileA), (int64_t) 0);
+            expectEquals (cache.getStatistics().numEvictions, numEvictions + 1);
+
+            // They're mapped again when they're next read
+            expect (readBlock (*readerA));
+            expect (cache.getBytesInUse (fileA) > 0);
+        }
+
+        beginTest ("Releasing idle files over the memory limit");
+        {
+            expect (readBlock (*readerA));
+            expect (readBlock (*readerB));
+
+            // Keep reading one file whilst the other goes idle and should be released
+            cache.setMaxBytesInUse (1);
+
+            for (int i = 0; i < 50 && cache.getBytesInUse (fileA) > 0; ++i)
+            {
+                expect (readBlock (*readerB));
+                juce::Thread::sleep (100);
+            }
+
+            expectEquals (cache.getBytesInUse (fileA), (int64_t) 0);
+            expect (cache.getBytesInUse (fileB) > 0);
+
+            cache.setMaxBytesInUse (0);
+        }
+    }
+
+    void runBufferedFileReaderTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::WavAudioFormat> (44100.0, 10.0, 2);
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        const auto numSamples = (int) fileReader->lengthInSamples;
+        juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, numSamples);
+        fileReader->read (&bufferFromFile, 0, numSamples, 0, true, true);
+
+        juce::TimeSliceThread thread ("BufferedFileReader test");
+        thread.startThread();
+
+        BufferedFileReader reader (AudioFileUtils::createReaderFor (engine, tempFile->getFile()), thread, 44100 * 2);
+        reader.setReadTimeout (-1);
+        expectEquals (reader.getSamplesPerBlock(), 32768);
+
+        constexpr int blockSize = 512;
+
+        beginTest ("BufferedFileReader forwards");
+        {
+            juce::AudioBuffer<float> bufferFromReader (bufferFromFile.getNumChannels(), numSamples);
+
+            for (int i = 0; i < numSamples; i += blockSize)
+                reader.read (&bufferFromReader, i, std::min (blockSize, numSamples - i), i, true, true);
+
+            expectAudioBuffer (*this, bufferFromFile, bufferFromReader);
+        }
+
+        beginTest ("BufferedFileReader backwards");
+        {
+            juce::AudioBuffer<float> bufferFromReader (bufferFromFile.getNumChannels(), numSamples);
+
+            for (int end = numSamples; end > 0; end -= blockSize)
+            {
+                const auto start = std::max (0, end - blockSize);
+                reader.read (&bufferFromReader, start, end - start, start, true, true);
+            }
+
+            expectAudioBuffer (*this, bufferFromFile, bufferFromReader);
+        }
+
+        const auto stats = reader.getStatistics();
+        expect (stats.numHits + stats.numMisses > 0);
+    }
+
+    void runMemoryMappedFileReaderTest()
+    {
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+
+        for (int numChannels : { 1, 2, 3 })
+        {
+            beginTest ("MemoryMappedFileReader float data: " + juce::String (numChannels) + " channels");
+
+            auto buffer = createSquareBuffer (numChannels, 44100, getPhaseIncrement (220.0f, 44100.0));
+            juce::TemporaryFile tempFile (".wav");
+
+            {
+                auto os = std::unique_ptr<juce::OutputStream> (tempFile.getFile().createOutputStream());
+                auto writer = std::unique_ptr<juce::AudioFormatWriter> (juce::WavAudioFormat().createWriterFor (os,
+                                                                                                              juce::AudioFormatWriterOptions()
+                                                                                                                .withSampleRate (44100.0)
+                                                                                                                .withNumChannels (numChannels)
+                                                                                                                .withBitsPerSample (32)));
+                expect (writer != nullptr);
+                writer->writeFromAudioSampleBuffer (toAudioBuffer (buffer.getView()), 0, (int) buffer.getNumFrames());
+            }
+
+            MemoryMappedFileReader reader (AudioFileUtils::createMappedFileAndReaderFor (engine, tempFile.getFile()));
+            auto mappedData = reader.getMappedFloatData();
+            expectEquals ((int) mappedData.getNumChannels(), numChannels);
+            expectEquals ((int) mappedData.getNumFrames(), (int) buffer.getNumFrames());
+            expect (contentMatches (buffer.getView().getFrameRange ({ 100, 200 }),
+                                    mappedData.getFrameRange ({ 100, 200 })));
+
+            // Read past the end to check the remainder is cleared
+            const auto numFrames = (int) buffer.getNumFrames();
+            juce::AudioBuffer<float> readBuffer (numChannels, numFrames + 100);
+            reader.read (&readBuffer, 0, numFrames + 100, 0, true, true);
+
+            juce::AudioBuffer<float> expected (numChannels, numFrames + 100);
+            expected.clear();
+
+            for (int c = 0; c < numChannels; ++c)
+                expected.copyFrom (c, 0, toAudioBuffer (buffer.getView()), c, 0, numFrames);
+
+            expectAudioBuffer (*this, expected, readBuffer);
+        }
+
+        beginTest ("MemoryMappedFileReader integer data");
+        {
+            auto tempFile = getSquareFile<juce::WavAudioFormat> (44100.0, 1.0, 2);
+            MemoryMappedFileReader reader (AudioFileUtils::createMappedFileAndReaderFor (engine, tempFile->getFile()));
+            expectEquals ((int) reader.getMappedFloatData().getNumFrames(), 0);
+        }
     }
 };
 
@@ -0,0 +1,454 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace audio_file_info_cache
+{
+    // The file is a header, an index of { path hash, entry offset } pairs sorted
+    // by hash and then the entries, each of which is prefixed by its size
+    static constexpr int magic = 0x43494154; // "TAIC"
+    static constexpr int version = 1;
+    static constexpr int headerSize = 12;
+    static constexpr int indexEntrySize = 16;
+
+    struct EntryHeader
+    {
+        juce::String path;
+        int64_t fileSize = 0, modificationTime = 0;
+    };
+
+    static int64_t getKey (const juce::String& path)
+    {
+        return path.hashCode64();
+    }
+
+    static juce::String getPath (const AudioFile& file)
+    {
+        return file.getFile().getFullPathName();
+    }
+
+    static EntryHeader readEntryHeader (juce::InputStream& in)
+    {
+        EntryHeader header;
+        header.path = in.readString();
+        header.fileSize = in.readInt64();
+        header.modificationTime = in.readInt64();
+        return header;
+    }
+
+    static EntryHeader readEntryHeader (const juce::MemoryBlock& entry)
+    {
+        juce::MemoryInputStream in (entry, false);
+        return readEntryHeader (in);
+    }
+
+    static juce::MemoryBlock createEntry (const juce::String& path, int64_t fileSize, const AudioFileInfo& info)
+    {
+        juce::MemoryOutputStream out;
+        out.writeString (path);
+        out.writeInt64 (fileSize);
+        out.writeInt64 (info.fileModificationTime.toMilliseconds());
+
+        out.writeString (info.format != nullptr ? info.format->getFormatName() : juce::String());
+        out.writeDouble (info.sampleRate);
+        out.writeInt64 (info.lengthInSamples);
+        out.writeInt (info.numChannels);
+        out.writeInt (info.bitsPerSample);
+        out.writeBool (info.isFloatingPoint);
+        out.writeBool (info.needsCachedProxy);
+
+        auto keys = info.metadata.getAllKeys();
+        auto values = info.metadata.getAllValues();
+        out.writeInt (keys.size());
+
+        for (int i = 0; i < keys.size(); ++i)
+        {
+            out.writeString (keys[i]);
+            out.writeString (values[i]);
+        }
+
+        info.loopInfo.state.writeToStream (out);
+
+        return out.getMemoryBlock();
+    }
+
+    static juce::AudioFormat* findFormat (Engine& engine, const juce::String& formatName)
+    {
+        if (formatName.isEmpty())
+            return nullptr;
+
+        auto& formatManager = engine.getAudioFileFormatManager().readFormatManager;
+
+        for (int i = 0; i < formatManager.getNumKnownFormats(); ++i)
+            if (auto f = formatManager.getKnownFormat (i); f->getFormatName() == formatName)
+                return f;
+
+        return nullptr;
+    }
+
+    static std::optional<AudioFileInfo> readInfo (Engine& engine, const AudioFile& file, const juce::MemoryBlock& entry)
+    {
+        juce::MemoryInputStream in (entry, false);
+        auto header = readEntryHeader (in);
+
+        AudioFileInfo info (engine);
+        info.wasParsedOk        = true;
+        info.hashCode           = file.getHash();
+        info.fileModificationTime = juce::Time (header.modificationTime);
+        info.format             = findFormat (engine, in.readString());
+        info.sampleRate         = in.readDouble();
+        info.lengthInSamples    = in.readInt64();
+        info.numChannels        = in.readInt();
+        info.bitsPerSample      = in.readInt();
+        info.isFloatingPoint    = in.readBool();
+        info.needsCachedProxy   = in.readBool();
+
+        // The format may no longer be available so the file needs re-parsing
+        if (info.format == nullptr)
+            return {};
+
+        for (int i = in.readInt(); --i >= 0;)
+        {
+            auto key = in.readString();
+            info.metadata.set (key, in.readString());
+        }
+
+        if (auto loopState = juce::ValueTree::readFromStream (in); loopState.isValid())
+            info.loopInfo = LoopInfo (engine, loopState, nullptr);
+
+        return info;
+    }
+}
+
+//==============================================================================
+AudioFileInfoCache::AudioFileInfoCache (Engine& e, const juce::File& f)
+    : juce::Thread ("AudioFileInfoCache"), engine (e), cacheFile (f)
+{
+    mapFile();
+    startThread (juce::Thread::Priority::low);
+}
+
+AudioFileInfoCache::~AudioFileInfoCache()
+{
+    stopThread (5000);
+
+    if (isDirty)
+        save();
+}
+
+//==============================================================================
+std::optional<AudioFileInfo> AudioFileInfoCache::find (const AudioFile& file)
+{
+    using namespace audio_file_info_cache;
+    const auto path = getPath (file);
+    std::optional<juce::MemoryBlock> entry;
+
+    {
+        const std::scoped_lock sl (mutex);
+
+        if (removedEntries.contains (path))
+            return {};
+
+        if (auto added = addedEntries.find (path); added != addedEntries.end())
+            entry = added->second;
+        else
+            entry = findMappedEntry (path);
+
+        if (! entry)
+            return {};
+
+        if (validatedEntries.insert (path).second)
+        {
+            entriesToValidate.push_back (path);
+            notify();
+        }
+    }
+
+    return readInfo (engine, file, *entry);
+}
+
+void AudioFileInfoCache::add (const AudioFile& file, const AudioFileInfo& info)
+{
+    if (! info.wasParsedOk)
+    {
+        remove (file);
+        return;
+    }
+
+    const auto path = audio_file_info_cache::getPath (file);
+    auto entry = audio_file_info_cache::createEntry (path, file.getFile().getSize(), info);
+
+    const std::scoped_lock sl (mutex);
+    addedEntries[path] = std::move (entry);
+    removedEntries.erase (path);
+    validatedEntries.insert (path);
+    isDirty = true;
+    lastChangeTime = juce::Time::getApproximateMillisecondCounter();
+}
+
+void AudioFileInfoCache::remove (const AudioFile& file)
+{
+    const auto path = audio_file_info_cache::getPath (file);
+
+    const std::scoped_lock sl (mutex);
+
+    if (addedEntries.erase (path) > 0 || findMappedEntry (path))
+    {
+        removedEntries.insert (path);
+        isDirty = true;
+        lastChangeTime = juce::Time::getApproximateMillisecondCounter();
+    }
+}
+
+int AudioFileInfoCache::getNumEntries()
+{
+    const std::scoped_lock sl (mutex);
+    return (int) getAllEntries().size();
+}
+
+bool AudioFileInfoCache::save()
+{
+    CRASH_TRACER
+    using namespace audio_file_info_cache;
+
+    const std::scoped_lock sl (mutex);
+    auto entries = getAllEntries();
+
+    std::sort (entries.begin(), entries.end(),
+               [] (auto& a, auto& b) { return getKey (a.first) < getKey (b.first); });
+
+    cacheFile.getParentDirectory().createDirectory();
+    juce::TemporaryFile tempFile (cacheFile);
+
+    {
+        juce::FileOutputStream out (tempFile.getFile());
+
+        if (! out.openedOk())
+            return false;
+
+        out.writeInt (magic);
+        out.writeInt (version);
+        out.writeInt ((int) entries.size());
+
+        auto offset = (int64_t) headerSize + (int64_t) entries.size() * indexEntrySize;
+
+        for (auto& [path, entry] : entries)
+        {
+            out.writeInt64 (getKey (path));
+            out.writeInt64 (offset);
+            offset += 4 + (int64_t) entry.getSize();
+        }
+
+        for (auto& [path, entry] : entries)
+        {
+            out.writeInt ((int) entry.getSize());
+            out.write (entry.getData(), entry.getSize());
+        }
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    // The file has to be unmapped before it can be replaced on some platforms
+    mappedFile.reset();
+    mappedIndex = nullptr;
+    numMappedEntries = 0;
+
+    const bool ok = tempFile.overwriteTargetFileWithTemporary();
+    mapFile();
+
+    if (ok)
+    {
+        addedEntries.clear();
+        removedEntries.clear();
+        isDirty = false;
+    }
+
+    return ok;
+}
+
+//==============================================================================
+void AudioFileInfoCache::mapFile()
+{
+    using namespace audio_file_info_cache;
+
+    if (! cacheFile.existsAsFile())
+        return;
+
+    auto mf = std::make_unique<juce::MemoryMappedFile> (cacheFile, juce::MemoryMappedFile::readOnly);
+    auto data = static_cast<const char*> (mf->getData());
+    const auto size = (int64_t) mf->getSize();
+
+    if (data == nullptr || size < headerSize
+         || juce::ByteOrder::littleEndianInt (data) != (uint32_t) magic
+         || (int) juce::ByteOrder::littleEndianInt (data + 4) != version)
+       return;
+
+    const auto numEntries = (int) juce::ByteOrder::littleEndianInt (data + 8);
+
+    if (numEntries < 0 || headerSize + (int64_t) numEntries * indexEntrySize > size)
+        return;
+
+    mappedFile = std::move (mf);
+    mappedIndex = data + headerSize;
+    numMappedEntries = numEntries;
+}
+
+std::optional<juce::MemoryBlock> AudioFileInfoCache::findMappedEntry (const juce::String& path) const
+{
+    using namespace audio_file_info_cache;
+
+    if (mappedIndex == nullptr)
+        return {};
+
+    auto getIndexKey = [this] (int i)    { return (int64_t) juce::ByteOrder::littleEndianInt64 (mappedIndex + i * indexEntrySize); };
+    auto getIndexOffset = [this] (int i) { return (int64_t) juce::ByteOrder::littleEndianInt64 (mappedIndex + i * indexEntrySize + 8); };
+
+    const auto key = getKey (path);
+    const auto data = static_cast<const char*> (mappedFile->getData());
+    const auto size = (int64_t) mappedFile->getSize();
+
+    // Binary search for the first entry with this key, then check the paths of any with the same hash
+    int start = 0, end = numMappedEntries;
+
+    while (start < end)
+    {
+        auto mid = (start + end) / 2;
+
+        if (getIndexKey (mid) < key)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    for (int i = start; i < numMappedEntries && getIndexKey (i) == key; ++i)
+    {
+        const auto offset = getIndexOffset (i);
+
+        if (offset < 0 || offset + 4 > size)
+            return {};
+
+        const auto entrySize = (int64_t) juce::ByteOrder::littleEndianInt (data + offset);
+
+        if (entrySize < 0 || offset + 4 + entrySize > size)
+            return {};
+
+        juce::MemoryBlock entry (data + offset + 4, (size_t) entrySize);
+
+        if (readEntryHeader (entry).path == path)
+            return entry;
+    }
+
+    return {};
+}
+
+std::vector<std::pair<juce::String, juce::MemoryBlock>> AudioFileInfoCache::getAllEntries() const
+{
+    using namespace audio_file_info_cache;
+    std::vector<std::pair<juce::String, juce::MemoryBlock>> entries;
+
+    if (mappedIndex != nullptr)
+    {
+        const auto data = static_cast<const char*> (mappedFile->getData());
+        const auto size = (int64_t) mappedFile->getSize();
+
+        for (int i = 0; i < numMappedEntries; ++i)
+        {
+            const auto offset = (int64_t) juce::ByteOrder::littleEndianInt64 (mappedIndex + i * indexEntrySize + 8);
+
+            if (offset < 0 || offset + 4 > size)
+                continue;
+
+            const auto entrySize = (int64_t) juce::ByteOrder::littleEndianInt (data + offset);
+
+            if (entrySize < 0 || offset + 4 + entrySize > size)
+                continue;
+
+            juce::MemoryBlock entry (data + offset + 4, (size_t) entrySize);
+            auto path = readEntryHeader (entry).path;
+
+            if (! removedEntries.contains (path) && ! addedEntries.contains (path))
+                entries.emplace_back (std::move (path), std::move (entry));
+        }
+    }
+
+    for (auto& [path, entry] : addedEntries)
+        entries.emplace_back (path, entry);
+
+    return entries;
+}
+
+void AudioFileInfoCache::validateEntries()
+{
+    std::vector<juce::String> paths;
+
+    {
+        const std::scoped_lock sl (mutex);
+        std::swap (paths, entriesToValidate);
+    }
+
+    for (auto& path : paths)
+    {
+        if (threadShouldExit())
+            return;
+
+        std::optional<juce::MemoryBlock> entry;
+
+        {
+            const std::scoped_lock sl (mutex);
+
+            if (auto added = addedEntries.find (path); added != addedEntries.end())
+                entry = added->second;
+            else if (! removedEntries.contains (path))
+                entry = findMappedEntry (path);
+        }
+
+        if (! entry)
+            continue;
+
+        const auto header = audio_file_info_cache::readEntryHeader (*entry);
+        const juce::File file (path);
+
+        if (file.getSize() == header.fileSize
+            && file.getLastModificationTime().toMilliseconds() == header.modificationTime)
+           continue;
+
+        const AudioFile audioFile (engine, file);
+        remove (audioFile);
+
+        if (onEntryInvalidated)
+            onEntryInvalidated (audioFile);
+    }
+}
+
+void AudioFileInfoCache::run()
+{
+    while (! threadShouldExit())
+    {
+        wait (500);
+        validateEntries();
+
+        bool shouldSave = false;
+
+        {
+            const std::scoped_lock sl (mutex);
+            shouldSave = isDirty && juce::Time::getApproximateMillisecondCounter() - lastChangeTime > 5000;
+        }
+
+        if (shouldSave && ! threadShouldExit())
+            save();
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,90 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    A persistent cache of AudioFileInfos so audio file headers don't have to be
+    re-read each time the engine starts.
+
+    Entries are keyed by the file's path and store the size and modification time
+    the file had when it was parsed. The cache file is memory-mapped and searched
+    in place so only the entries that are used get decoded.
+
+    Entries are trusted when they're found and validated lazily afterwards, on a
+    background thread. If the file's size or modification time no longer match,
+    the entry is removed and onEntryInvalidated is called so the info can be
+    re-read.
+
+    The AudioFileManager has one of these if
+    EngineBehaviour::shouldCacheAudioFileInfo returns true.
+*/
+class AudioFileInfoCache  : private juce::Thread
+{
+public:
+    /** Creates a cache that reads from and saves to the given file. */
+    AudioFileInfoCache (Engine&, const juce::File& cacheFile);
+
+    /** Destructor. Saves the cache if it has changed. */
+    ~AudioFileInfoCache() override;
+
+    //==============================================================================
+    /** Returns the cached info for a file, if there is any.
+        This doesn't access the file itself. Instead, the file is queued so the
+        entry can be validated on a background thread.
+    */
+    std::optional<AudioFileInfo> find (const AudioFile&);
+
+    /** Adds or replaces the info for a file.
+        Only info that was parsed successfully is stored.
+    */
+    void add (const AudioFile&, const AudioFileInfo&);
+
+    /** Removes any info for a file. */
+    void remove (const AudioFile&);
+
+    /** Returns the number of files the cache has info for. */
+    int getNumEntries();
+
+    /** Writes the cache to disk, returning true if it succeeded. */
+    bool save();
+
+    /** Called on the background thread when an entry's file has changed. */
+    std::function<void (const AudioFile&)> onEntryInvalidated;
+
+private:
+    //==============================================================================
+    Engine& engine;
+    const juce::File cacheFile;
+    std::mutex mutex;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* mappedIndex = nullptr;
+    int numMappedEntries = 0;
+
+    std::map<juce::String, juce::MemoryBlock> addedEntries;
+    std::set<juce::String> removedEntries, validatedEntries;
+    std::vector<juce::String> entriesToValidate;
+    bool isDirty = false;
+    uint32_t lastChangeTime = 0;
+
+    //==============================================================================
+    void mapFile();
+    std::optional<juce::MemoryBlock> findMappedEntry (const juce::String& path) const;
+    std::vector<std::pair<juce::String, juce::MemoryBlock>> getAllEntries() const;
+    void validateEntries();
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFileInfoCache)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,79 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_AUDIO_FILE_INFO_CACHE
+
+#include "../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE("tracktion_engine")
+{
+    static void writeSilence (const AudioFile& file, int numSamples)
+    {
+        juce::WavAudioFormat format;
+        AudioFileWriter writer (file, &format, 2, 44100.0, 16, {}, 0);
+        REQUIRE (writer.isOpen());
+
+        juce::AudioBuffer<float> buffer (2, numSamples);
+        buffer.clear();
+        writer.appendBuffer (buffer, buffer.getNumSamples());
+    }
+
+    TEST_CASE ("AudioFileInfoCache")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        juce::TemporaryFile cacheFile, wavFile (".wav");
+        AudioFile audioFile (engine, wavFile.getFile());
+        writeSilence (audioFile, 44100);
+
+        const auto info = AudioFileInfo::parse (audioFile);
+        REQUIRE (info.wasParsedOk);
+
+        {
+            AudioFileInfoCache cache (engine, cacheFile.getFile());
+            CHECK (! cache.find (audioFile));
+
+            cache.add (audioFile, info);
+            CHECK_EQ (cache.getNumEntries(), 1);
+            CHECK (cache.save());
+        }
+
+        AudioFileInfoCache cache (engine, cacheFile.getFile());
+        juce::WaitableEvent invalidated;
+        cache.onEntryInvalidated = [&] (const AudioFile& f) { CHECK (f == audioFile); invalidated.signal(); };
+
+        // Entries are trusted when they're first found, even if the file has changed...
+        writeSilence (audioFile, 22050);
+
+        auto cachedInfo = cache.find (audioFile);
+        REQUIRE (cachedInfo);
+        CHECK (cachedInfo->wasParsedOk);
+        CHECK (cachedInfo->format == info.format);
+        CHECK_EQ (cachedInfo->sampleRate, info.sampleRate);
+        CHECK_EQ (cachedInfo->lengthInSamples, info.lengthInSamples);
+        CHECK_EQ (cachedInfo->numChannels, info.numChannels);
+        CHECK_EQ (cachedInfo->bitsPerSample, info.bitsPerSample);
+        CHECK (cachedInfo->fileModificationTime == info.fileModificationTime);
+        CHECK (cachedInfo->metadata == info.metadata);
+
+        CHECK (! cache.find (AudioFile (engine, wavFile.getFile().getSiblingFile ("missing.wav"))));
+
+        // ...and then invalidated once they've been validated
+        CHECK (invalidated.wait (5000));
+        CHECK (! cache.find (audioFile));
+        CHECK_EQ (cache.getNumEntries(), 0);
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_AUDIO_FILE_INFO_CACHE
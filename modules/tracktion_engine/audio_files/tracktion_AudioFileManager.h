@@ -29,13 +29,44 @@ public:
     void checkFileForChanges (const AudioFile&);
     void checkFilesForChanges();
     void forceFileUpdate (const AudioFile&);
+
+    /** Like forceFileUpdate, but uses info that's already been parsed, e.g. on a
+        background thread once the file has been written. Unlike forceFileUpdate,
+        this also adds the file if it isn't already known.
+    */
+    void forceFileUpdate (const AudioFile&, AudioFileInfo newInfo);
     void validateFile (const AudioFile&, bool updateInfo);
 
     void releaseFile (const AudioFile&);
     void releaseAllFiles();
 
+    /** Asks AudioFileWriters using AudioFileWriteOptions::FlushPolicy::whenRequested
+        to flush their files the next time they're written to. This is called
+        regularly by each TransportControl and is ignored if it was called less than
+        minMillisecondsBetweenWriterFlushes ago.
+    */
+    void requestWriterFlush();
+
+    /** Returns the number of times requestWriterFlush has triggered a flush. */
+    uint32_t getNumWriterFlushRequests() const noexcept     { return numWriterFlushRequests.load (std::memory_order_relaxed); }
+
+    /** The minimum time between flushes of files being recorded. */
+    static constexpr int minMillisecondsBetweenWriterFlushes = 5000;
+
+    /** Adds the result of analysing a file, e.g. its detected tempo, to the
+        metadata of its AudioFileInfo so it doesn't need analysing again.
+        This is also stored in the info cache if there is one and is discarded
+        if the file changes.
+    */
+    void addAnalysisResult (const AudioFile&, const juce::String& key, const juce::String& value);
+
     juce::AudioThumbnailCache& getAudioThumbnailCache()     { return *thumbnailCache; }
 
+    /** Returns the on-disk AudioFileInfo cache, if it's enabled.
+        @see EngineBehaviour::shouldCacheAudioFileInfo
+    */
+    AudioFileInfoCache* getInfoCache() const noexcept       { return infoCache.get(); }
+
     Engine& engine;
     AudioProxyGenerator proxyGenerator;
     AudioFileCache cache;
@@ -51,6 +82,9 @@ private:
 
     juce::Array<AudioFile> filesToCheck;
 
+    std::atomic<uint32_t> numWriterFlushRequests { 0 };
+    std::atomic<juce::uint32> lastWriterFlushRequestTime { 0 };
+
     void handleAsyncUpdate();
     bool checkFileTime (KnownFile&);
     void callListeners (const AudioFile&);
@@ -64,6 +98,8 @@ private:
     juce::Array<SmartThumbnail*> activeThumbnails;
     juce::CriticalSection activeThumbnailLock;
 
+    std::unique_ptr<AudioFileInfoCache> infoCache;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioFileManager)
 };
 
@@ -76,6 +76,8 @@ std::unique_ptr<AudioFileUtils::MappedFileAndReader> AudioFileUtils::createMappe
 
         if (reader)
         {
+            adviseMappedMemory (engine, mf->getData(), mf->getSize());
+
             auto result = std::make_unique<MappedFileAndReader>();
             result->mappedFile = std::move (mf);
             result->reader = std::move (reader);
@@ -88,11 +90,83 @@ std::unique_ptr<AudioFileUtils::MappedFileAndReader> AudioFileUtils::createMappe
     return {};
 }
 
+void AudioFileUtils::adviseMappedMemory (Engine& engine, const void* data, size_t numBytes)
+{
+    if (data == nullptr || numBytes == 0)
+        return;
+
+    const auto settings = engine.getEngineBehaviour().getMemoryMappedAudioSettings();
+
+    if (! (settings.useHugePages || settings.prefaultPages))
+        return;
+
+   #if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+    // madvise needs a page-aligned start address
+    const auto pageSize = (juce::pointer_sized_uint) ::sysconf (_SC_PAGESIZE);
+    const auto start = reinterpret_cast<juce::pointer_sized_uint> (data);
+    const auto alignedStart = start - (start % pageSize);
+    auto alignedData = reinterpret_cast<void*> (alignedStart);
+    const auto alignedSize = (size_t) (numBytes + (start - alignedStart));
+
+    #if defined (MADV_HUGEPAGE)
+     if (settings.useHugePages)
+         ::madvise (alignedData, alignedSize, MADV_HUGEPAGE);
+    #endif
+
+    if (settings.prefaultPages)
+        ::madvise (alignedData, alignedSize, MADV_WILLNEED);
+   #endif
+
+    if (settings.prefaultPages)
+        prefaultMappedMemory (data, numBytes);
+}
+
+void AudioFileUtils::prefaultMappedMemory (const void* data, size_t numBytes)
+{
+    constexpr size_t pageSize = 4096;
+    auto bytes = static_cast<const volatile char*> (data);
+
+    for (size_t i = 0; i < numBytes; i += pageSize)
+        (void) bytes[i];
+
+    if (numBytes > 0)
+        (void) bytes[numBytes - 1];
+}
+
+juce::AudioFormatWriter* AudioFileUtils::createWriterFor (juce::AudioFormat* format, const juce::File& file,
+                                                          double sampleRate, unsigned int numChannels, int bitsPerSample,
+                                                          const juce::StringPairArray& metadata, int quality)
+{
+    return createWriterFor (format, file, sampleRate, numChannels, bitsPerSample, metadata, quality, {});
+}
+
 juce::AudioFormatWriter* AudioFileUtils::createWriterFor (juce::AudioFormat* format, const juce::File& file,
+                                                          double sampleRate, unsigned int numChannels, int bitsPerSample,
+                                                          const juce::StringPairArray& metadata, int quality,
+                                                          const AudioFileWriteOptions& options)
+{
+    return createWriterFor (format, createOutputStream (file, options),
+                            sampleRate, numChannels, bitsPerSample, metadata, quality);
+}
+
+std::unique_ptr<juce::OutputStream> AudioFileUtils::createOutputStream (const juce::File& file, const AudioFileWriteOptions& options)
+{
+    if (options.preallocationBytes <= 0)
+        return std::unique_ptr<juce::OutputStream> (file.createOutputStream());
+
+    auto out = std::make_unique<PreallocatingFileOutputStream> (file, options.preallocationBytes, options.writeBlockBytes);
+
+    if (! out->openedOk())
+        return {};
+
+    return out;
+}
+
+juce::AudioFormatWriter* AudioFileUtils::createWriterFor (juce::AudioFormat* format, std::unique_ptr<juce::OutputStream> out,
                                                           double sampleRate, unsigned int numChannels, int bitsPerSample,
                                                           const juce::StringPairArray& metadata, int quality)
 {
-    if (auto out = std::unique_ptr<juce::OutputStream> (file.createOutputStream()))
+    if (out != nullptr)
     {
         std::unordered_map<juce::String, juce::String> metadataMap;
 
@@ -28,6 +28,18 @@ struct AudioFileUtils
 
     static std::unique_ptr<MappedFileAndReader> createMappedFileAndReaderFor (Engine&, const juce::File&);
 
+    /** Applies the EngineBehaviour::MemoryMappedAudioSettings to a range of mapped memory.
+        This can ask for huge pages and, if prefaulting is enabled, will start the OS
+        reading the range in and then touch each page, so this may block and shouldn't
+        be called from the audio thread.
+    */
+    static void adviseMappedMemory (Engine&, const void* data, size_t numBytes);
+
+    /** Touches each page in a range of mapped memory so they're faulted in to memory
+        before they're needed.
+    */
+    static void prefaultMappedMemory (const void* data, size_t numBytes);
+
     static juce::AudioFormatWriter* createWriterFor (Engine&, const juce::File&,
                                                      double sampleRate, unsigned int numChannels, int bitsPerSample,
                                                      const juce::StringPairArray& metadata, int quality);
@@ -36,6 +48,19 @@ struct AudioFileUtils
                                                      double sampleRate, unsigned int numChannels, int bitsPerSample,
                                                      const juce::StringPairArray& metadata, int quality);
 
+    /** Creates a writer for a file, reserving space for it as the options specify. */
+    static juce::AudioFormatWriter* createWriterFor (juce::AudioFormat*, const juce::File&,
+                                                     double sampleRate, unsigned int numChannels, int bitsPerSample,
+                                                     const juce::StringPairArray& metadata, int quality,
+                                                     const AudioFileWriteOptions&);
+
+    /** Opens a file to write to with some options, returning nullptr if it can't be opened. */
+    static std::unique_ptr<juce::OutputStream> createOutputStream (const juce::File&, const AudioFileWriteOptions&);
+
+    static juce::AudioFormatWriter* createWriterFor (juce::AudioFormat*, std::unique_ptr<juce::OutputStream>,
+                                                     double sampleRate, unsigned int numChannels, int bitsPerSample,
+                                                     const juce::StringPairArray& metadata, int quality);
+
     static SampleRange scanForNonZeroSamples (Engine&, const juce::File&, float maxZeroLevelDb);
 
     static SampleRange copyNonSilentSectionToNewFile (Engine&,
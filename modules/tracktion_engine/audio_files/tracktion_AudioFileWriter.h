@@ -11,6 +11,41 @@
 namespace tracktion { inline namespace engine
 {
 
+//==============================================================================
+/**
+    Options for how audio files are written to disk.
+
+    By default files grow as they're written, which is fine for short files. For
+    long recordings and renders, disk space can be reserved in large chunks ahead
+    of the write position to avoid fragmenting the file and updating the file
+    system's metadata on every write. @see PreallocatingFileOutputStream
+*/
+struct AudioFileWriteOptions
+{
+    /** How often an AudioFileWriter asks the OS to write its file to disk. */
+    enum class FlushPolicy
+    {
+        everyFewSeconds,    /**< Flush after every few seconds of audio, on the writing thread. */
+        whenRequested       /**< Flush on the writing thread after AudioFileManager::requestWriterFlush is called. */
+    };
+
+    int64_t preallocationBytes = 0;     /**< The size of the chunks of space to reserve, 0 to just grow the file. */
+    int writeBlockBytes = 256 * 1024;   /**< If preallocating, the size of the aligned blocks to write in. */
+    FlushPolicy flushPolicy = FlushPolicy::everyFewSeconds;
+
+    /** Options for recordings, which reserve space and are flushed by the TransportControl's timer. */
+    static AudioFileWriteOptions forRecording()
+    {
+        return { 32 * 1024 * 1024, 256 * 1024, FlushPolicy::whenRequested };
+    }
+
+    /** Options for renders, which reserve space. */
+    static AudioFileWriteOptions forRendering()
+    {
+        return { 32 * 1024 * 1024, 256 * 1024, FlushPolicy::everyFewSeconds };
+    }
+};
+
 //==============================================================================
 /**
     Smart wrapper for writing to an audio file.
@@ -27,7 +62,8 @@ public:
                      double sampleRate,
                      int bitsPerSample,
                      const juce::StringPairArray& metadata,
-                     int quality);
+                     int quality,
+                     const AudioFileWriteOptions& options = {});
 
     /** Destructor, calls closeForWriting. */
     ~AudioFileWriter();
@@ -58,9 +94,13 @@ public:
     AudioFile file;
 
 private:
+    const AudioFileWriteOptions::FlushPolicy flushPolicy;
     int samplesUntilFlush;
+    uint32_t lastFlushRequest = 0;
     std::unique_ptr<juce::AudioFormatWriter> writer;
     juce::CriticalSection writerLock;
+
+    void flushIfDue (int numSamplesWritten);
 };
 
 }} // namespace tracktion { inline namespace engine
@@ -16,6 +16,7 @@ BufferedFileReader::BufferedFileReader (juce::AudioFormatReader* sourceReader,
                                         int samplesToBuffer)
     : juce::AudioFormatReader (nullptr, sourceReader->getFormatName()),
       source (sourceReader), thread (timeSliceThread),
+      samplesPerBlock (getSamplesPerBlockForSampleRate (sourceReader->sampleRate)),
       isFullyBuffering (samplesToBuffer < 0)
 {
     static_assert (std::atomic<BufferedBlock*>::is_always_lock_free);
@@ -30,7 +31,9 @@ BufferedFileReader::BufferedFileReader (juce::AudioFormatReader* sourceReader,
 
     const size_t totalNumSlotsRequired = 1 + (size_t (lengthInSamples) / samplesPerBlock);
     assert (totalNumSlotsRequired <= std::numeric_limits<int>::max());
-    numBlocksToBuffer = samplesToBuffer > -1 ? static_cast<size_t> (1 + (samplesToBuffer / samplesPerBlock))
+    // Always have enough blocks for the current one, one behind it and one ahead
+    numBlocksToBuffer = samplesToBuffer > -1 ? std::min (totalNumSlotsRequired,
+                                                         std::max<size_t> (3, static_cast<size_t> (1 + (samplesToBuffer / samplesPerBlock))))
                                              : totalNumSlotsRequired;
 
     slots = std::vector<std::atomic<BufferedBlock*>> (totalNumSlotsRequired);
@@ -43,7 +46,7 @@ BufferedFileReader::BufferedFileReader (juce::AudioFormatReader* sourceReader,
     {
         // The following code makes the assumption that the pointers are at least 8-bit aligned
         static_assert (alignof (BufferedBlock*) >= 8);
-        blocks.push_back (std::make_unique<BufferedBlock> (*source));
+        blocks.push_back (std::make_unique<BufferedBlock> (*source, samplesPerBlock));
 
         // Check the least significant bit is actually 0
         assert (! std::bitset<sizeof (BufferedBlock*)> (size_t (blocks.back().get()))[0]);
@@ -68,6 +71,11 @@ bool BufferedFileReader::isFullyBuffered() const
         && numBlocksBuffered == numBlocksToBuffer;
 }
 
+BufferedFileReader::Statistics BufferedFileReader::getStatistics() const
+{
+    return { numHits.load(), numMisses.load() };
+}
+
 bool BufferedFileReader::readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                                       juce::int64 startSampleInFile, int numSamples)
 {
@@ -140,10 +148,15 @@ bool BufferedFileReader::readSamples (int* const* destSamples, int numDestChanne
         }
     }
 
+    if (allSamplesRead && ! hasNotified)
+        ++numHits;
+    else
+        ++numMisses;
+
     return allSamplesRead;
 }
 
-BufferedFileReader::BufferedBlock::BufferedBlock (juce::AudioFormatReader& reader)
+BufferedFileReader::BufferedBlock::BufferedBlock (juce::AudioFormatReader& reader, int samplesPerBlock)
     : buffer ((int) reader.numChannels, samplesPerBlock)
 {
 }
@@ -160,7 +173,6 @@ void BufferedFileReader::BufferedBlock::update (juce::AudioFormatReader& reader,
     assert (slotIndex == static_cast<int> (currentSlotIndex));
     slotIndex = static_cast<int> (currentSlotIndex);
     lastUseTime = juce::Time::getMillisecondCounter();
-    DBG(slotIndex);
 }
 
 BufferedFileReader::ScopedSlotAccess::ScopedSlotAccess (BufferedFileReader& reader_, size_t slotIndex_)
@@ -180,7 +192,7 @@ BufferedFileReader::ScopedSlotAccess::~ScopedSlotAccess()
 
 BufferedFileReader::ScopedSlotAccess BufferedFileReader::ScopedSlotAccess::fromPosition (BufferedFileReader& reader, juce::int64 position)
 {
-    return { reader, static_cast<size_t> (position / (float) samplesPerBlock) };
+    return { reader, reader.getSlotIndexFromSamplePosition (position) };
 }
 
 void BufferedFileReader::ScopedSlotAccess::setBlock (BufferedBlock* blockToReferTo)
@@ -215,68 +227,146 @@ BufferedFileReader::PositionStatus BufferedFileReader::readNextBufferChunk()
     if (isFullyBuffered())
         return PositionStatus::fullyLoaded;
 
-    // First find the slot the audio thread is trying to read
-    // If that needs reading, set the next-slot-to-read to this
-    // If it's already read, use the current next-slot-to-read value
     const auto currentReadPosition = nextReadPosition.load();
+    updateReadVelocity (currentReadPosition);
+
     const auto currentSlotIndex = getSlotIndexFromSamplePosition (currentReadPosition);
+    const auto depth = getPrefetchDepth();
+
+    if (auto slotToReadIndex = findNextSlotToRead (currentSlotIndex, depth))
+        readSlot (*slotToReadIndex, currentSlotIndex, depth);
+    else if (nextReadPosition == currentReadPosition)
+        return PositionStatus::blocksFull;
+
+    // If the read position hasn't changed by the audio thread let the thread reschedule us
+    if (nextReadPosition == currentReadPosition)
+        return PositionStatus::nextChunkScheduled;
+
+    // Otherwise, the audio thread has changed the position so read the block asap
+    return PositionStatus::positionChangedByAudioThread;
+}
 
-    // Check if the slot being read by the audio thread is buffered
+int BufferedFileReader::getSamplesPerBlockForSampleRate (double rate)
+{
+    // Around half a second of audio, which is 32768 samples at 44.1 and 48kHz
+    return juce::jlimit (8192, 131072, juce::nextPowerOfTwo (juce::roundToInt (rate / 2.0)));
+}
+
+void BufferedFileReader::updateReadVelocity (juce::int64 readPosition)
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+
+    if (readPosition == lastObservedReadPosition)
     {
-        // Take exclusive control of the current slot
-        ScopedSlotAccess currentSlot (*this, currentSlotIndex);
+        // If reading has stopped, fall back to only buffering the current block
+        if (now - lastObservedReadTimeMs > 1000.0)
+            readVelocity = 0.0;
 
-        if (auto currentBlockInCurrentSlot = currentSlot.getBlock())
-        {
-            // If the slot has a valid block, it should have the correct range
-            assert (currentBlockInCurrentSlot->range == getSlotRange (currentSlotIndex));
+        return;
+    }
 
-            // If the block contains invalid data, we need to re-read this
-            if (! currentBlockInCurrentSlot->allSamplesRead)
-                nextSlotScheduled = currentSlotIndex;
-        }
+    const auto delta = readPosition - lastObservedReadPosition;
+    const auto elapsedMs = std::max (1.0, now - lastObservedReadTimeMs);
+    lastObservedReadPosition = readPosition;
+    lastObservedReadTimeMs = now;
+
+    // Treat big changes as jumps rather than fast playback
+    if (std::abs (delta) > samplesPerBlock)
+    {
+        readVelocity = 0.0;
+        return;
+    }
+
+    readVelocity = 0.8 * readVelocity + 0.2 * (delta / elapsedMs);
+    readDirection = readVelocity < 0.0 ? -1 : 1;
+}
+
+size_t BufferedFileReader::getPrefetchDepth() const
+{
+    if (isFullyBuffering)
+        return slots.size();
+
+    // Buffer about a second ahead at the current speed, keeping one block behind the current one free
+    constexpr double prefetchTimeMs = 1000.0;
+    const auto depth = 1 + static_cast<size_t> (std::abs (readVelocity) * prefetchTimeMs / samplesPerBlock);
+
+    return std::min (depth, numBlocksToBuffer > 2 ? numBlocksToBuffer - 2 : 1);
+}
+
+bool BufferedFileReader::isInPrefetchWindow (size_t slotIndex, size_t currentSlotIndex, size_t depth) const
+{
+    const auto distance = (static_cast<juce::int64> (slotIndex) - static_cast<juce::int64> (currentSlotIndex)) * readDirection;
+    return distance >= 0 && distance <= static_cast<juce::int64> (depth);
+}
+
+std::optional<size_t> BufferedFileReader::findNextSlotToRead (size_t currentSlotIndex, size_t depth)
+{
+    const auto numSlots = static_cast<juce::int64> (slots.size());
+
+    for (size_t i = 0; i <= depth; ++i)
+    {
+        auto slotIndex = static_cast<juce::int64> (currentSlotIndex) + readDirection * static_cast<juce::int64> (i);
+
+        if (isFullyBuffering)
+            slotIndex = juce::negativeAwareModulo (slotIndex, numSlots);
+        else if (slotIndex < 0 || slotIndex >= numSlots)
+            break;
+
+        ScopedSlotAccess slot (*this, static_cast<size_t> (slotIndex));
+
+        if (auto block = slot.getBlock(); block == nullptr || ! block->allSamplesRead)
+            return static_cast<size_t> (slotIndex);
     }
 
-    const auto slotToReadIndex = nextSlotScheduled.load();
-    bool readScheduledSlot = true;
+    return {};
+}
 
+void BufferedFileReader::readSlot (size_t slotToReadIndex, size_t currentSlotIndex, size_t depth)
+{
     {
-        // Take exclusive control of the scheduled slot
-        ScopedSlotAccess scheduledSlot (*this, slotToReadIndex);
+        // If the slot already has a block with a failed read, just re-read it
+        ScopedSlotAccess slot (*this, slotToReadIndex);
 
-        // If that block is inthe correct slot with all the samples read, don't re-read
-        if (auto currentBlockInScheduledSlot = scheduledSlot.getBlock())
-            if (currentBlockInScheduledSlot->allSamplesRead)
-                readScheduledSlot = false;
+        if (auto block = slot.getBlock())
+        {
+            block->update (*source, getSlotRange (slotToReadIndex), slotToReadIndex);
+            return;
+        }
     }
 
-    // Read the next scheduled slot if its out of date
-    if (readScheduledSlot)
+    BufferedBlock* blockToUse = nullptr;
+
     {
-        // This can be done without taking any exclusive access as the
-        // blocks won't move around and their time stamps are atomic
+        // Use a free block if there is one, otherwise the oldest block outside the
+        // prefetch window. This can be done without taking any exclusive access as
+        // the blocks won't move around and their time stamps are atomic
         juce::uint32 oldestTime = std::numeric_limits<juce::uint32>::max();
-        BufferedBlock* blockToUse = nullptr;
 
-        for (size_t i = 0; i < blocks.size(); ++i)
+        for (auto& block : blocks)
         {
-            auto& block = blocks[i];
-            const auto useTime = block->lastUseTime.load (std::memory_order_relaxed);
+            const int blockSlotIndex = block->slotIndex.load (std::memory_order_relaxed);
 
-            if (useTime > oldestTime)
-                continue;
+            if (blockSlotIndex < 0)
+            {
+                blockToUse = block.get();
+                break;
+            }
 
-            blockToUse = block.get();
-            oldestTime = useTime;
+            if (isInPrefetchWindow (static_cast<size_t> (blockSlotIndex), currentSlotIndex, depth))
+                continue;
 
-            const int curentBlockSlotIndex = block->slotIndex.load (std::memory_order_relaxed);
+            const auto useTime = block->lastUseTime.load (std::memory_order_relaxed);
 
-            // If the block is free, we can simply use it
-            if (curentBlockSlotIndex < 0)
-                break;
+            if (useTime <= oldestTime)
+            {
+                blockToUse = block.get();
+                oldestTime = useTime;
+            }
         }
 
-        assert (blockToUse != nullptr);
+        if (blockToUse == nullptr)
+            return;
+
         const int blockToUseSlotIndex = blockToUse->slotIndex.load (std::memory_order_relaxed);
         ScopedSlotAccess desiredSlot (*this, slotToReadIndex);
 
@@ -291,64 +381,28 @@ BufferedFileReader::PositionStatus BufferedFileReader::readNextBufferChunk()
             ScopedSlotAccess slotWithOldestBlock (*this, static_cast<size_t> (blockToUseSlotIndex));
             assert (blockToUse == slotWithOldestBlock.getBlock());
 
-            // Swap the blocks
+            // Move the block
             slotWithOldestBlock.setBlock (nullptr);
             desiredSlot.setBlock (blockToUse);
         }
 
         // Update the block's data
-        const juce::Range<juce::int64> slotSampleRange = getSlotRange (slotToReadIndex);
-        blockToUse->update (*source, slotSampleRange, slotToReadIndex);
+        blockToUse->update (*source, getSlotRange (slotToReadIndex), slotToReadIndex);
 
         // Increment the number of blocks in use if this was a fresh block
         if (blockToUseSlotIndex < 0 && blockToUse->allSamplesRead)
             ++numBlocksBuffered;
     }
-
-    // If all the slots are in use, free the oldest slot from the current read position so a future one can be queued up
-//ddd    if (numBlocksBuffered == blocks.size() && slotToReadIndex > 0)
-//    {
-//        for (auto& block : blocks)
-//        {
-//            // This won't change during this function
-//            const auto blockSlotIndex = block->slotIndex.load();
-//
-//            if (blockSlotIndex < 0)
-//                continue;
-//
-//            if (blockSlotIndex < int (slotToReadIndex) - 1)
-//            {
-//                ScopedSlotAccess slotAccess (*this, size_t (blockSlotIndex));
-//                slotAccess.setBlock (nullptr);
-//                --numBlocksBuffered;
-//            }
-//        }
-//
-//        return PositionStatus::nextChunkScheduled;
-//    }
-
-    // If the read position hasn't changed by the audio thread let the thread reschedule us
-    if (nextReadPosition == currentReadPosition)
-    {
-        assert (blocks.size() > 0);
-        const auto startSlot = std::max (size_t (0), getSlotIndexFromSamplePosition (currentReadPosition));
-        nextSlotScheduled = (startSlot + 1) % slots.size();
-
-        return PositionStatus::nextChunkScheduled;
-    }
-
-    // Otherwise, the audio thread has changed the position so read the block asap
-    return PositionStatus::positionChangedByAudioThread;
 }
 
-size_t BufferedFileReader::getSlotIndexFromSamplePosition (juce::int64 samplePos)
+size_t BufferedFileReader::getSlotIndexFromSamplePosition (juce::int64 samplePos) const
 {
-    return static_cast<size_t> (samplePos / (float) samplesPerBlock);
+    return static_cast<size_t> (juce::jlimit ((juce::int64) 0, (juce::int64) slots.size() - 1, samplePos / samplesPerBlock));
 }
 
-juce::Range<juce::int64> BufferedFileReader::getSlotRange (size_t slotIndex)
+juce::Range<juce::int64> BufferedFileReader::getSlotRange (size_t slotIndex) const
 {
-    const juce::int64 slotStartSamplePos = static_cast<juce::int64> (slotIndex * samplesPerBlock);
+    const juce::int64 slotStartSamplePos = static_cast<juce::int64> (slotIndex) * samplesPerBlock;
     const juce::int64 slotEndSamplePos = std::min (slotStartSamplePos + samplesPerBlock, lengthInSamples);
 
     return { slotStartSamplePos, slotEndSamplePos };
@@ -12,12 +12,14 @@ namespace tracktion { inline namespace engine
 {
 
 //==============================================================================
-/** @internal
-
+/**
     An AudioFormatReader that uses a background thread to pre-read data from
     another reader.
 
-    N.B. This class is in development and not ready for public use yet!!
+    The source is read in blocks sized for the file's sample rate. The reader
+    tracks how fast, and in which direction, it's being read so it can read
+    further ahead for faster playback and behind the read position for reverse
+    playback.
 */
 class BufferedFileReader    : public juce::AudioFormatReader,
                               private juce::TimeSliceClient
@@ -54,6 +56,19 @@ public:
     */
     bool isFullyBuffered() const;
 
+    /** Returns the number of samples in each block read from the source. */
+    int getSamplesPerBlock() const noexcept         { return samplesPerBlock; }
+
+    /** Counters describing how well the buffering is keeping up. */
+    struct Statistics
+    {
+        uint64_t numHits = 0;       /**< The number of reads where all the data was already buffered. */
+        uint64_t numMisses = 0;     /**< The number of reads that had to wait for or skip some data. */
+    };
+
+    /** Returns the statistics gathered since this was created. */
+    Statistics getStatistics() const;
+
     //==============================================================================
     /** @internal */
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
@@ -62,7 +77,7 @@ public:
 private:
     struct BufferedBlock
     {
-        BufferedBlock (juce::AudioFormatReader&);
+        BufferedBlock (juce::AudioFormatReader&, int samplesPerBlock);
 
         void update (juce::AudioFormatReader&, juce::Range<juce::int64> range, size_t slotIndex);
 
@@ -101,23 +116,35 @@ private:
 
     PositionStatus readNextBufferChunk();
 
-    static constexpr int samplesPerBlock = 32768;
-
     std::unique_ptr<juce::AudioFormatReader> source;
     juce::TimeSliceThread& thread;
+    const int samplesPerBlock;
     std::atomic<juce::int64> nextReadPosition { 0 };
     int timeoutMs = 0;
+    std::atomic<uint64_t> numHits { 0 }, numMisses { 0 };
+
+    // These are only used by the background thread
+    juce::int64 lastObservedReadPosition = 0;
+    double lastObservedReadTimeMs = 0.0, readVelocity = 0.0;
+    int readDirection = 1;
 
     std::vector<std::unique_ptr<BufferedBlock>> blocks;
     std::vector<std::atomic<BufferedBlock*>> slots;
     std::vector<std::atomic<bool>> slotsInUse;
 
     size_t numBlocksToBuffer = 0;
-    std::atomic<size_t> numBlocksBuffered { 0 }, nextSlotScheduled { 0 };
+    std::atomic<size_t> numBlocksBuffered { 0 };
     const bool isFullyBuffering = false;
 
-    size_t getSlotIndexFromSamplePosition (juce::int64 samplePos);
-    juce::Range<juce::int64> getSlotRange (size_t slotIndex);
+    static int getSamplesPerBlockForSampleRate (double);
+    void updateReadVelocity (juce::int64 readPosition);
+    size_t getPrefetchDepth() const;
+    bool isInPrefetchWindow (size_t slotIndex, size_t currentSlotIndex, size_t depth) const;
+    std::optional<size_t> findNextSlotToRead (size_t currentSlotIndex, size_t depth);
+    void readSlot (size_t slotIndex, size_t currentSlotIndex, size_t depth);
+
+    size_t getSlotIndexFromSamplePosition (juce::int64 samplePos) const;
+    juce::Range<juce::int64> getSlotRange (size_t slotIndex) const;
     void markSlotUseState (size_t slotIndex, bool isInUse);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferedFileReader)
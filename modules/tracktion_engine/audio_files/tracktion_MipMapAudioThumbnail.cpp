@@ -0,0 +1,724 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace mipmap_thumbnail_utils
+{
+    static int getMipMapFileHeaderInt()     { return (int) juce::ByteOrder::littleEndianInt ("TMM1"); }
+
+    static int getNumLevelsForLength (juce::int64 numSamples, int baseDecimationShift)
+    {
+        if (numSamples <= 0)
+            return 0;
+
+        auto numValues = ((numSamples - 1) >> baseDecimationShift) + 1;
+        int numLevels = 1;
+
+        while (numValues > 1)
+        {
+            numValues = (numValues + 1) / 2;
+            ++numLevels;
+        }
+
+        return numLevels;
+    }
+
+    static juce::int64 getNumValuesForLevel (juce::int64 numSamples, int baseDecimationShift, int level)
+    {
+        if (numSamples <= 0)
+            return 0;
+
+        return ((numSamples - 1) >> (baseDecimationShift + level)) + 1;
+    }
+
+    static double getSumOfSquares (const float* data, int numSamples) noexcept
+    {
+        // Separate accumulators let the compiler vectorise this
+        float sums[4] = {};
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+            for (int j = 0; j < 4; ++j)
+                sums[j] += data[i + j] * data[i + j];
+
+        double total = (double) sums[0] + sums[1] + sums[2] + sums[3];
+
+        for (; i < numSamples; ++i)
+            total += data[i] * (double) data[i];
+
+        return total;
+    }
+
+    static int getHeaderSize (int numLevels)
+    {
+        return 4 + 4 + 8 + 8 + 8 + 8 + 4 + 4 + 8 * numLevels;
+    }
+}
+
+//==============================================================================
+MipMapAudioThumbnail::MipMapAudioThumbnail (int samplesPerThumbSample,
+                                            juce::AudioFormatManager& fm,
+                                            juce::TimeSliceThread& t,
+                                            juce::File folder)
+    : formatManager (fm), thread (t), cacheFolder (std::move (folder)),
+      baseDecimationShift (juce::jlimit (0, 16, (int) std::ceil (std::log2 (std::max (1, samplesPerThumbSample)))))
+{
+}
+
+MipMapAudioThumbnail::~MipMapAudioThumbnail()
+{
+    thread.removeTimeSliceClient (this);
+}
+
+//==============================================================================
+MipMapAudioThumbnail::Levels MipMapAudioThumbnail::getLevels (int channel, juce::int64 startSample, juce::int64 endSample,
+                                                              juce::int64 maxSamplesPerValue) const
+{
+    const juce::ScopedLock sl (lock);
+
+    const auto numLevels = getNumLevels();
+    endSample = std::min (endSample, numSamplesFinished.load());
+
+    if (numLevels == 0 || endSample <= startSample || ! juce::isPositiveAndBelow (channel, numChannels))
+        return {};
+
+    // Use the coarsest level that still has the requested resolution
+    int level = 0;
+
+    while (level + 1 < numLevels && ((juce::int64) 1 << (baseDecimationShift + level + 1)) <= maxSamplesPerValue)
+        ++level;
+
+    const auto data = getLevelData (level, channel);
+    const auto shift = baseDecimationShift + level;
+    const auto first = std::max ((juce::int64) 0, startSample >> shift);
+    const auto last = std::min (data.numValues - 1, (endSample - 1) >> shift);
+
+    if (data.values == nullptr || last < first)
+        return {};
+
+    int min = 127, max = -128;
+    juce::int64 sumOfSquares = 0;
+
+    for (auto i = first; i <= last; ++i)
+    {
+        auto& v = data.values[i];
+        min = std::min (min, (int) v.min);
+        max = std::max (max, (int) v.max);
+        sumOfSquares += (int) v.rms * (int) v.rms;
+    }
+
+    const auto numValues = last - first + 1;
+
+    return { min / 127.0f, max / 127.0f,
+             (float) std::sqrt (sumOfSquares / (double) numValues) / 255.0f };
+}
+
+int MipMapAudioThumbnail::getNumLevels() const noexcept
+{
+    const juce::ScopedLock sl (lock);
+    return numChannels > 0 ? (int) levels.size() / numChannels : 0;
+}
+
+bool MipMapAudioThumbnail::isMemoryMapped() const noexcept
+{
+    const juce::ScopedLock sl (lock);
+    return mappedFile != nullptr;
+}
+
+//==============================================================================
+void MipMapAudioThumbnail::clear()
+{
+    thread.removeTimeSliceClient (this);
+
+    const juce::ScopedLock sl (lock);
+    reader.reset();
+    hash = 0;
+    numChannels = 0;
+    sampleRate = 0.0;
+    totalSamples = 0;
+    fingerprint = 0;
+    clearLevels();
+    sendChangeMessage();
+}
+
+bool MipMapAudioThumbnail::setSource (juce::InputSource* newSource)
+{
+    std::unique_ptr<juce::InputSource> source (newSource);
+
+    if (source == nullptr)
+    {
+        clear();
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> newReader;
+
+    if (auto stream = source->createInputStream())
+        newReader.reset (formatManager.createReaderFor (std::unique_ptr<juce::InputStream> (stream)));
+
+    if (newReader == nullptr)
+    {
+        clear();
+        return false;
+    }
+
+    setReader (newReader.release(), source->hashCode());
+    return true;
+}
+
+void MipMapAudioThumbnail::setReader (juce::AudioFormatReader* newReader, juce::int64 hashCode)
+{
+    clear();
+
+    if (newReader == nullptr)
+        return;
+
+    {
+        const juce::ScopedLock sl (lock);
+        reader.reset (newReader);
+        hash = hashCode;
+        numChannels = (int) reader->numChannels;
+        sampleRate = reader->sampleRate;
+        totalSamples = reader->lengthInSamples;
+        needsToCheckCache = true;
+    }
+
+    thread.addTimeSliceClient (this);
+}
+
+bool MipMapAudioThumbnail::loadFrom (juce::InputStream& input)
+{
+    juce::MemoryBlock data;
+    input.readIntoMemoryBlock (data);
+
+    thread.removeTimeSliceClient (this);
+    reader.reset();
+
+    const juce::ScopedLock sl (lock);
+    clearLevels();
+
+    return loadFromMemory (data.getData(), data.getSize(), nullptr);
+}
+
+void MipMapAudioThumbnail::saveTo (juce::OutputStream& output) const
+{
+    const juce::ScopedLock sl (lock);
+    writeLevels (output);
+}
+
+int MipMapAudioThumbnail::getNumChannels() const noexcept
+{
+    return numChannels;
+}
+
+double MipMapAudioThumbnail::getTotalLength() const noexcept
+{
+    return sampleRate > 0.0 ? totalSamples / sampleRate : 0.0;
+}
+
+void MipMapAudioThumbnail::drawChannel (juce::Graphics& g, const juce::Rectangle<int>& area,
+                                        double startTimeSeconds, double endTimeSeconds,
+                                        int channelNum, float verticalZoomFactor)
+{
+    if (area.isEmpty() || endTimeSeconds <= startTimeSeconds || sampleRate <= 0.0)
+        return;
+
+    const auto startSample = startTimeSeconds * sampleRate;
+    const auto samplesPerPixel = (endTimeSeconds - startTimeSeconds) * sampleRate / area.getWidth();
+    const auto midY = (float) area.getCentreY();
+    const auto halfHeight = area.getHeight() * 0.5f * verticalZoomFactor;
+    const auto clip = g.getClipBounds().getIntersection (area);
+
+    juce::RectangleList<float> waveform;
+    waveform.ensureStorageAllocated (clip.getWidth());
+
+    for (int x = clip.getX(); x < clip.getRight(); ++x)
+    {
+        const auto pixelStart = (juce::int64) (startSample + (x - area.getX()) * samplesPerPixel);
+        const auto pixelEnd = std::max (pixelStart + 1, (juce::int64) (startSample + (x + 1 - area.getX()) * samplesPerPixel));
+        const auto l = getLevels (channelNum, pixelStart, pixelEnd, (juce::int64) samplesPerPixel);
+
+        const auto top = juce::jlimit ((float) area.getY(), (float) area.getBottom(), midY - l.max * halfHeight);
+        const auto bottom = juce::jlimit ((float) area.getY(), (float) area.getBottom(), midY - l.min * halfHeight);
+
+        waveform.addWithoutMerging ({ (float) x, top, 1.0f, std::max (1.0f, bottom - top) });
+    }
+
+    g.fillRectList (waveform);
+}
+
+void MipMapAudioThumbnail::drawChannels (juce::Graphics& g, const juce::Rectangle<int>& area,
+                                         double startTimeSeconds, double endTimeSeconds,
+                                         float verticalZoomFactor)
+{
+    const auto num = getNumChannels();
+
+    for (int i = 0; i < num; ++i)
+    {
+        const auto y1 = juce::roundToInt ((i * area.getHeight()) / (double) num);
+        const auto y2 = juce::roundToInt (((i + 1) * area.getHeight()) / (double) num);
+
+        drawChannel (g, { area.getX(), area.getY() + y1, area.getWidth(), y2 - y1 },
+                     startTimeSeconds, endTimeSeconds, i, verticalZoomFactor);
+    }
+}
+
+bool MipMapAudioThumbnail::isFullyLoaded() const noexcept
+{
+    return numSamplesFinished >= totalSamples;
+}
+
+juce::int64 MipMapAudioThumbnail::getNumSamplesFinished() const noexcept
+{
+    return numSamplesFinished;
+}
+
+float MipMapAudioThumbnail::getApproximatePeak() const
+{
+    float peak = 0.0f;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        auto l = getLevels (i, 0, totalSamples, totalSamples);
+        peak = std::max ({ peak, std::abs (l.min), std::abs (l.max) });
+    }
+
+    return juce::jlimit (0.0f, 1.0f, peak);
+}
+
+void MipMapAudioThumbnail::getApproximateMinMax (double startTime, double endTime, int channelIndex,
+                                                 float& minValue, float& maxValue) const noexcept
+{
+    const auto start = (juce::int64) (startTime * sampleRate);
+    const auto end = (juce::int64) (endTime * sampleRate);
+    const auto l = getLevels (channelIndex, start, end, end - start);
+
+    minValue = l.min;
+    maxValue = l.max;
+}
+
+juce::int64 MipMapAudioThumbnail::getHashCode() const
+{
+    return hash;
+}
+
+void MipMapAudioThumbnail::reset (int newNumChannels, double newSampleRate, juce::int64 totalSamplesInSource)
+{
+    clear();
+
+    const juce::ScopedLock sl (lock);
+    numChannels = newNumChannels;
+    sampleRate = newSampleRate;
+    totalSamples = 0;
+    resizeLevels (totalSamplesInSource);
+}
+
+void MipMapAudioThumbnail::addBlock (juce::int64 sampleNumberInSource, const juce::AudioBuffer<float>& buffer,
+                                     int startOffsetInBuffer, int numSamples)
+{
+    if (numSamples <= 0 || sampleNumberInSource < 0)
+        return;
+
+    {
+        const juce::ScopedLock sl (lock);
+        const auto endSample = sampleNumberInSource + numSamples;
+
+        if (endSample > totalSamples)
+            resizeLevels (endSample);
+
+        for (int i = 0; i < std::min (numChannels, buffer.getNumChannels()); ++i)
+            addSamples (i, sampleNumberInSource, buffer.getReadPointer (i, startOffsetInBuffer), numSamples);
+
+        updateParents (sampleNumberInSource >> baseDecimationShift, (endSample - 1) >> baseDecimationShift);
+        numSamplesFinished = std::max (numSamplesFinished.load(), endSample);
+    }
+
+    sendChangeMessage();
+}
+
+//==============================================================================
+int MipMapAudioThumbnail::useTimeSlice()
+{
+    if (reader == nullptr)
+        return -1;
+
+    if (needsToCheckCache)
+    {
+        needsToCheckCache = false;
+        const auto newFingerprint = getReaderFingerprint();
+
+        const juce::ScopedLock sl (lock);
+        fingerprint = newFingerprint;
+
+        if (loadFromCache())
+        {
+            reader.reset();
+            sendChangeMessage();
+            return -1;
+        }
+
+        const auto length = totalSamples;
+        totalSamples = 0;
+        resizeLevels (length);
+    }
+
+    constexpr int samplesPerSlice = 65536;
+    const auto startSample = numSamplesFinished.load();
+    const auto numThisTime = (int) std::min ((juce::int64) samplesPerSlice, totalSamples - startSample);
+
+    if (numThisTime > 0)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numThisTime);
+        reader->read (&buffer, 0, numThisTime, startSample, true, true);
+
+        const juce::ScopedLock sl (lock);
+
+        for (int i = 0; i < numChannels; ++i)
+            addSamples (i, startSample, buffer.getReadPointer (i), numThisTime);
+
+        updateParents (startSample >> baseDecimationShift, (startSample + numThisTime - 1) >> baseDecimationShift);
+        numSamplesFinished = startSample + numThisTime;
+    }
+
+    sendChangeMessage();
+
+    if (numSamplesFinished < totalSamples)
+        return 0;
+
+    reader.reset();
+    saveToCache();
+
+    return -1;
+}
+
+//==============================================================================
+void MipMapAudioThumbnail::clearLevels()
+{
+    levelStorage.clear();
+    levels.clear();
+    mappedFile.reset();
+    partialValues.clear();
+    numSamplesFinished = 0;
+}
+
+void MipMapAudioThumbnail::resizeLevels (juce::int64 numSamples)
+{
+    using namespace mipmap_thumbnail_utils;
+
+    // Copy any mapped data so it can be added to
+    if (mappedFile != nullptr)
+    {
+        levelStorage.clear();
+
+        for (auto& l : levels)
+            levelStorage.emplace_back (l.values, l.values + l.numValues);
+
+        mappedFile.reset();
+    }
+
+    totalSamples = std::max (totalSamples, numSamples);
+    const auto numLevels = getNumLevelsForLength (totalSamples, baseDecimationShift);
+    levelStorage.resize ((size_t) (numLevels * numChannels));
+
+    for (int level = 0; level < numLevels; ++level)
+        for (int chan = 0; chan < numChannels; ++chan)
+            levelStorage[(size_t) (level * numChannels + chan)].resize ((size_t) getNumValuesForLevel (totalSamples, baseDecimationShift, level));
+
+    partialValues.resize ((size_t) numChannels);
+    updateLevelData();
+}
+
+void MipMapAudioThumbnail::updateLevelData()
+{
+    levels.resize (levelStorage.size());
+
+    for (size_t i = 0; i < levelStorage.size(); ++i)
+        levels[i] = { levelStorage[i].data(), (juce::int64) levelStorage[i].size() };
+}
+
+MipMapAudioThumbnail::LevelData MipMapAudioThumbnail::getLevelData (int level, int channel) const
+{
+    const auto index = (size_t) (level * numChannels + channel);
+    return index < levels.size() ? levels[index] : LevelData();
+}
+
+void MipMapAudioThumbnail::addSamples (int channel, juce::int64 startSample, const float* data, int numSamples)
+{
+    auto& values = levelStorage[(size_t) channel];
+    auto& partial = partialValues[(size_t) channel];
+    const auto baseDecimation = getBaseDecimation();
+
+    while (numSamples > 0)
+    {
+        const auto index = startSample >> baseDecimationShift;
+        const auto offsetInValue = (int) (startSample - (index << baseDecimationShift));
+        const auto numThisTime = std::min (numSamples, baseDecimation - offsetInValue);
+
+        if (partial.index != index || offsetInValue == 0)
+            partial = { index, 1.0f, -1.0f, 0.0, 0 };
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax (data, numThisTime);
+        partial.min = std::min (partial.min, range.getStart());
+        partial.max = std::max (partial.max, range.getEnd());
+        partial.sumOfSquares += mipmap_thumbnail_utils::getSumOfSquares (data, numThisTime);
+        partial.numSamples += numThisTime;
+
+        if (index < (juce::int64) values.size())
+            values[(size_t) index] = createValue (partial.min, partial.max, partial.sumOfSquares, partial.numSamples);
+
+        startSample += numThisTime;
+        data += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+void MipMapAudioThumbnail::updateParents (juce::int64 firstIndex, juce::int64 lastIndex)
+{
+    const auto numLevels = getNumLevels();
+
+    for (int level = 1; level < numLevels; ++level)
+    {
+        firstIndex >>= 1;
+        lastIndex >>= 1;
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            auto& children = levelStorage[(size_t) ((level - 1) * numChannels + chan)];
+            auto& parents = levelStorage[(size_t) (level * numChannels + chan)];
+            const auto numChildren = (juce::int64) children.size();
+
+            for (auto i = firstIndex; i <= lastIndex && i < (juce::int64) parents.size(); ++i)
+            {
+                const auto child = i * 2;
+                parents[(size_t) i] = child + 1 < numChildren ? combine (children[(size_t) child], children[(size_t) child + 1])
+                                                              : children[(size_t) child];
+            }
+        }
+    }
+}
+
+//==============================================================================
+juce::File MipMapAudioThumbnail::getCacheFile() const
+{
+    if (cacheFolder == juce::File() || hash == 0)
+        return {};
+
+    return cacheFolder.getChildFile ("mipmap_" + juce::String::toHexString (hash) + ".thumb");
+}
+
+juce::int64 MipMapAudioThumbnail::getReaderFingerprint() const
+{
+    // This is a cheap check that the source hasn't changed since the cache was written
+    constexpr int numSamplesToCheck = 256;
+    auto fingerprintHash = (juce::int64) reader->lengthInSamples * 31 + (juce::int64) reader->numChannels * 7
+                             + (juce::int64) reader->sampleRate;
+
+    juce::AudioBuffer<float> buffer ((int) reader->numChannels, numSamplesToCheck);
+    const auto length = reader->lengthInSamples;
+
+    for (auto start : { (juce::int64) 0, length / 2, length - numSamplesToCheck })
+    {
+        if (start < 0)
+            continue;
+
+        reader->read (&buffer, 0, numSamplesToCheck, start, true, true);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = 0; i < numSamplesToCheck; ++i)
+                fingerprintHash = fingerprintHash * 101 + (juce::int64) juce::roundToInt (buffer.getSample (chan, i) * 32767.0f);
+    }
+
+    return fingerprintHash;
+}
+
+bool MipMapAudioThumbnail::loadFromCache()
+{
+    auto file = getCacheFile();
+
+    if (! file.existsAsFile())
+        return false;
+
+    const auto expectedChannels = numChannels;
+    const auto expectedSampleRate = sampleRate;
+    const auto expectedLength = totalSamples;
+    const auto expectedFingerprint = fingerprint;
+
+    auto mf = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly);
+
+    if (mf->getData() != nullptr)
+    {
+        auto data = mf->getData();
+        auto size = mf->getSize();
+
+        if (loadFromMemory (data, size, std::move (mf))
+             && numChannels == expectedChannels
+             && sampleRate == expectedSampleRate
+             && totalSamples == expectedLength
+             && fingerprint == expectedFingerprint
+             && numSamplesFinished == totalSamples)
+            return true;
+    }
+
+    clearLevels();
+    numChannels = expectedChannels;
+    sampleRate = expectedSampleRate;
+    totalSamples = expectedLength;
+    fingerprint = expectedFingerprint;
+    file.deleteFile();
+
+    return false;
+}
+
+void MipMapAudioThumbnail::saveToCache()
+{
+    auto file = getCacheFile();
+
+    if (file == juce::File())
+        return;
+
+    file.getParentDirectory().createDirectory();
+    juce::TemporaryFile tempFile (file);
+
+    {
+        juce::FileOutputStream out (tempFile.getFile());
+
+        if (! out.openedOk())
+            return;
+
+        saveTo (out);
+    }
+
+    if (! tempFile.overwriteTargetFileWithTemporary())
+        return;
+
+    // Switch to the mapped file so the levels don't have to be kept in memory
+    const juce::ScopedLock sl (lock);
+    auto levelsInMemory = std::move (levelStorage);
+
+    if (! loadFromCache())
+    {
+        levelStorage = std::move (levelsInMemory);
+        updateLevelData();
+        numSamplesFinished = totalSamples;
+    }
+}
+
+bool MipMapAudioThumbnail::loadFromMemory (const void* data, size_t numBytes, std::unique_ptr<juce::MemoryMappedFile> mapped)
+{
+    using namespace mipmap_thumbnail_utils;
+
+    juce::MemoryInputStream in (data, numBytes, false);
+
+    if (numBytes < (size_t) getHeaderSize (0) || in.readInt() != getMipMapFileHeaderInt())
+        return false;
+
+    const auto newNumChannels = in.readInt();
+    const auto newSampleRate = in.readDouble();
+    const auto newTotalSamples = in.readInt64();
+    const auto newNumSamplesFinished = in.readInt64();
+    const auto newFingerprint = in.readInt64();
+    const auto newShift = in.readInt();
+    const auto numLevels = in.readInt();
+
+    if (newShift != baseDecimationShift || newNumChannels <= 0 || newNumChannels > 64
+         || numLevels < 0 || numLevels > 64 || numBytes < (size_t) getHeaderSize (numLevels))
+        return false;
+
+    std::vector<juce::int64> numValuesPerLevel;
+    auto totalBytes = (juce::int64) getHeaderSize (numLevels);
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        numValuesPerLevel.push_back (in.readInt64());
+        totalBytes += numValuesPerLevel.back() * newNumChannels * (juce::int64) sizeof (Value);
+    }
+
+    if ((juce::int64) numBytes < totalBytes)
+        return false;
+
+    numChannels = newNumChannels;
+    sampleRate = newSampleRate;
+    totalSamples = newTotalSamples;
+    fingerprint = newFingerprint;
+    levelStorage.clear();
+    levels.clear();
+
+    auto values = reinterpret_cast<const Value*> (static_cast<const char*> (data) + getHeaderSize (numLevels));
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            const auto numValues = numValuesPerLevel[(size_t) level];
+
+            if (mapped != nullptr)
+                levels.push_back ({ values, numValues });
+            else
+                levelStorage.emplace_back (values, values + numValues);
+
+            values += numValues;
+        }
+    }
+
+    mappedFile = std::move (mapped);
+
+    if (mappedFile == nullptr)
+        updateLevelData();
+
+    partialValues.assign ((size_t) numChannels, {});
+    numSamplesFinished = newNumSamplesFinished;
+
+    return true;
+}
+
+void MipMapAudioThumbnail::writeLevels (juce::OutputStream& out) const
+{
+    const auto numLevels = getNumLevels();
+
+    out.writeInt (mipmap_thumbnail_utils::getMipMapFileHeaderInt());
+    out.writeInt (numChannels);
+    out.writeDouble (sampleRate);
+    out.writeInt64 (totalSamples);
+    out.writeInt64 (numSamplesFinished);
+    out.writeInt64 (fingerprint);
+    out.writeInt (baseDecimationShift);
+    out.writeInt (numLevels);
+
+    for (int level = 0; level < numLevels; ++level)
+        out.writeInt64 (getLevelData (level, 0).numValues);
+
+    for (auto& l : levels)
+        out.write (l.values, (size_t) l.numValues * sizeof (Value));
+}
+
+//==============================================================================
+MipMapAudioThumbnail::Value MipMapAudioThumbnail::createValue (float min, float max, double sumOfSquares, int numSamples) noexcept
+{
+    const auto rms = numSamples > 0 ? std::sqrt (sumOfSquares / numSamples) : 0.0;
+
+    Value v;
+    v.min = (int8_t) juce::jlimit (-128, 127, (int) std::floor (min * 127.0f));
+    v.max = (int8_t) juce::jlimit (-128, 127, (int) std::ceil (max * 127.0f));
+    v.rms = (uint8_t) juce::jlimit (0, 255, juce::roundToInt (rms * 255.0));
+    return v;
+}
+
+MipMapAudioThumbnail::Value MipMapAudioThumbnail::combine (const Value& a, const Value& b) noexcept
+{
+    Value v;
+    v.min = std::min (a.min, b.min);
+    v.max = std::max (a.max, b.max);
+    v.rms = (uint8_t) juce::roundToInt (std::sqrt ((a.rms * a.rms + b.rms * b.rms) * 0.5f));
+    return v;
+}
+
+}} // namespace tracktion { inline namespace engine
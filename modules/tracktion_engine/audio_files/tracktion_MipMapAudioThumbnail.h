@@ -0,0 +1,182 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An AudioThumbnailBase that stores a pyramid of min, max and RMS levels.
+
+    The first level holds a value for every getBaseDecimation() samples and each
+    level after that halves the resolution, so drawing at any zoom level only needs
+    to look at one or two values per pixel.
+
+    Once generated, the pyramid is saved to a file in the cache folder named after the
+    thumbnail's hash code. This is memory-mapped when the thumbnail is next loaded so
+    only the parts that get drawn have to be read in to memory.
+
+    To use these for all SmartThumbnails, return one from UIBehaviour::createAudioThumbnail.
+*/
+class MipMapAudioThumbnail  : public juce::AudioThumbnailBase,
+                              private juce::TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a MipMapAudioThumbnail.
+        @param samplesPerThumbSample    The decimation of the first level. This is
+                                        rounded up to a power of two.
+        @param formatManager            Used to create readers for setSource.
+        @param thread                   The thread to generate the levels on.
+        @param cacheFolder              Where to save the levels. If this is empty
+                                        they'll only be kept in memory.
+    */
+    MipMapAudioThumbnail (int samplesPerThumbSample,
+                          juce::AudioFormatManager& formatManager,
+                          juce::TimeSliceThread& thread,
+                          juce::File cacheFolder);
+
+    /** Destructor. */
+    ~MipMapAudioThumbnail() override;
+
+    //==============================================================================
+    /** The levels of a range of samples in a channel. */
+    struct Levels
+    {
+        float min = 0.0f, max = 0.0f, rms = 0.0f;
+    };
+
+    /** Returns the levels for a range of samples in a channel, using the coarsest
+        level of the pyramid that has at least the given resolution.
+        If the range hasn't been generated yet, this returns silence.
+    */
+    Levels getLevels (int channel, juce::int64 startSample, juce::int64 endSample,
+                      juce::int64 maxSamplesPerValue) const;
+
+    /** Returns the number of samples represented by each value in the first level. */
+    int getBaseDecimation() const noexcept          { return 1 << baseDecimationShift; }
+
+    /** Returns the number of levels in the pyramid. */
+    int getNumLevels() const noexcept;
+
+    /** Returns true if the levels are being read from a memory-mapped file. */
+    bool isMemoryMapped() const noexcept;
+
+    //==============================================================================
+    /** @internal */
+    void clear() override;
+    /** @internal */
+    bool setSource (juce::InputSource*) override;
+    /** @internal */
+    void setReader (juce::AudioFormatReader*, juce::int64 hashCode) override;
+    /** @internal */
+    bool loadFrom (juce::InputStream&) override;
+    /** @internal */
+    void saveTo (juce::OutputStream&) const override;
+    /** @internal */
+    int getNumChannels() const noexcept override;
+    /** @internal */
+    double getTotalLength() const noexcept override;
+    /** @internal */
+    void drawChannel (juce::Graphics&, const juce::Rectangle<int>& area,
+                      double startTimeSeconds, double endTimeSeconds,
+                      int channelNum, float verticalZoomFactor) override;
+    /** @internal */
+    void drawChannels (juce::Graphics&, const juce::Rectangle<int>& area,
+                       double startTimeSeconds, double endTimeSeconds,
+                       float verticalZoomFactor) override;
+    /** @internal */
+    bool isFullyLoaded() const noexcept override;
+    /** @internal */
+    juce::int64 getNumSamplesFinished() const noexcept override;
+    /** @internal */
+    float getApproximatePeak() const override;
+    /** @internal */
+    void getApproximateMinMax (double startTime, double endTime, int channelIndex,
+                               float& minValue, float& maxValue) const noexcept override;
+    /** @internal */
+    juce::int64 getHashCode() const override;
+    /** @internal */
+    void reset (int numChannels, double sampleRate, juce::int64 totalSamplesInSource) override;
+    /** @internal */
+    void addBlock (juce::int64 sampleNumberInSource, const juce::AudioBuffer<float>&,
+                   int startOffsetInBuffer, int numSamples) override;
+
+private:
+    //==============================================================================
+    /** A single value in the pyramid, quantised to save space. */
+    struct Value
+    {
+        int8_t min = 0, max = 0;
+        uint8_t rms = 0, unused = 0;
+    };
+
+    /** A range of values for one channel at one level. */
+    struct LevelData
+    {
+        const Value* values = nullptr;
+        juce::int64 numValues = 0;
+    };
+
+    juce::AudioFormatManager& formatManager;
+    juce::TimeSliceThread& thread;
+    const juce::File cacheFolder;
+    const int baseDecimationShift;
+
+    mutable juce::CriticalSection lock;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::int64 hash = 0;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    juce::int64 totalSamples = 0;
+    juce::int64 fingerprint = 0;
+    std::atomic<juce::int64> numSamplesFinished { 0 };
+
+    // The levels are either in these vectors, indexed by level then channel, or the mapped file
+    std::vector<std::vector<Value>> levelStorage;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::vector<LevelData> levels;
+    bool needsToCheckCache = false;
+
+    // Values being accumulated for the end of the first level
+    struct PartialValue
+    {
+        juce::int64 index = -1;
+        float min = 0.0f, max = 0.0f;
+        double sumOfSquares = 0.0;
+        int numSamples = 0;
+    };
+
+    std::vector<PartialValue> partialValues;
+
+    //==============================================================================
+    int useTimeSlice() override;
+
+    void clearLevels();
+    void resizeLevels (juce::int64 numSamples);
+    void updateLevelData();
+    LevelData getLevelData (int level, int channel) const;
+    void addSamples (int channel, juce::int64 startSample, const float* data, int numSamples);
+    void updateParents (juce::int64 firstBaseIndex, juce::int64 lastBaseIndex);
+
+    juce::File getCacheFile() const;
+    juce::int64 getReaderFingerprint() const;
+    bool loadFromCache();
+    void saveToCache();
+    bool loadFromMemory (const void* data, size_t numBytes, std::unique_ptr<juce::MemoryMappedFile>);
+    void writeLevels (juce::OutputStream&) const;
+
+    static Value createValue (float min, float max, double sumOfSquares, int numSamples) noexcept;
+    static Value combine (const Value&, const Value&) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MipMapAudioThumbnail)
+};
+
+}} // namespace tracktion { inline namespace engine
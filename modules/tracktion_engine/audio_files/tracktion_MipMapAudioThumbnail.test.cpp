@@ -0,0 +1,141 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_MIPMAP_THUMBNAIL
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class MipMapAudioThumbnailTests : public juce::UnitTest
+{
+public:
+    MipMapAudioThumbnailTests()
+        : juce::UnitTest ("MipMapAudioThumbnail", "tracktion_engine")
+    {
+    }
+
+    void runTest() override
+    {
+        juce::AudioFormatManager formatManager;
+        juce::TimeSliceThread thread ("MipMapAudioThumbnail test");
+
+        // Half a second of silence followed by a half-scale square wave on the left
+        // and a full scale one on the right
+        constexpr int numSamples = 44100;
+        juce::AudioBuffer<float> buffer (2, numSamples);
+        buffer.clear();
+
+        for (int i = numSamples / 2; i < numSamples; ++i)
+        {
+            const auto sign = (i / 50) % 2 == 0 ? 1.0f : -1.0f;
+            buffer.setSample (0, i, sign * 0.5f);
+            buffer.setSample (1, i, sign);
+        }
+
+        MipMapAudioThumbnail thumb (256, formatManager, thread, {});
+
+        beginTest ("Adding blocks");
+        {
+            thumb.reset (2, 44100.0, 0);
+            expectEquals (thumb.getBaseDecimation(), 256);
+
+            for (int start = 0; start < numSamples; start += 1000)
+                thumb.addBlock (start, buffer, start, std::min (1000, numSamples - start));
+
+            expect (thumb.isFullyLoaded());
+            expectEquals (thumb.getNumSamplesFinished(), (juce::int64) numSamples);
+            expectEquals (thumb.getNumLevels(), 9);
+            expectWithinAbsoluteError (thumb.getApproximatePeak(), 1.0f, 0.01f);
+        }
+
+        beginTest ("Reading levels");
+        {
+            // Ranges are aligned to the coarsest level used so the silence doesn't overlap the square
+            for (auto samplesPerValue : { 1, 256, 4096 })
+            {
+                auto silence = thumb.getLevels (1, 0, 16384, samplesPerValue);
+                expectEquals (silence.min, 0.0f);
+                expectEquals (silence.max, 0.0f);
+                expectEquals (silence.rms, 0.0f);
+
+                auto left = thumb.getLevels (0, 24576, numSamples, samplesPerValue);
+                expectWithinAbsoluteError (left.min, -0.5f, 0.01f);
+                expectWithinAbsoluteError (left.max, 0.5f, 0.01f);
+                expectWithinAbsoluteError (left.rms, 0.5f, 0.01f);
+
+                auto right = thumb.getLevels (1, 24576, numSamples, samplesPerValue);
+                expectWithinAbsoluteError (right.min, -1.0f, 0.01f);
+                expectWithinAbsoluteError (right.max, 1.0f, 0.01f);
+                expectWithinAbsoluteError (right.rms, 1.0f, 0.01f);
+            }
+
+            auto whole = thumb.getLevels (0, 0, numSamples, numSamples);
+            expectWithinAbsoluteError (whole.min, -0.5f, 0.01f);
+            expectWithinAbsoluteError (whole.max, 0.5f, 0.01f);
+        }
+
+        beginTest ("Saving and loading");
+        {
+            juce::MemoryOutputStream out;
+            thumb.saveTo (out);
+
+            MipMapAudioThumbnail loaded (256, formatManager, thread, {});
+            juce::MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expect (loaded.loadFrom (in));
+            expectEquals (loaded.getNumChannels(), 2);
+            expectEquals (loaded.getTotalLength(), 1.0);
+            expect (loaded.isFullyLoaded());
+            expectEquals (loaded.getNumLevels(), thumb.getNumLevels());
+
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                auto a = thumb.getLevels (chan, 1000, 30000, 1024);
+                auto b = loaded.getLevels (chan, 1000, 30000, 1024);
+                expectEquals (a.min, b.min);
+                expectEquals (a.max, b.max);
+                expectEquals (a.rms, b.rms);
+            }
+
+            // Mismatched decimation shouldn't be loaded
+            MipMapAudioThumbnail other (512, formatManager, thread, {});
+            juce::MemoryInputStream in2 (out.getData(), out.getDataSize(), false);
+            expect (! other.loadFrom (in2));
+        }
+
+        beginTest ("Reading levels of long files");
+        {
+            // Enough full-scale values at the finest level to overflow an int sum of their squares
+            constexpr int blockSize = 16384, numBlocks = 640;
+            juce::AudioBuffer<float> block (1, blockSize);
+
+            for (int i = 0; i < blockSize; ++i)
+                block.setSample (0, i, (i / 100) % 2 == 0 ? 1.0f : -1.0f);
+
+            MipMapAudioThumbnail longThumb (256, formatManager, thread, {});
+            longThumb.reset (1, 44100.0, 0);
+
+            for (int i = 0; i < numBlocks; ++i)
+                longThumb.addBlock ((juce::int64) i * blockSize, block, 0, blockSize);
+
+            auto levels = longThumb.getLevels (0, 0, (juce::int64) numBlocks * blockSize, 256);
+            expectWithinAbsoluteError (levels.min, -1.0f, 0.01f);
+            expectWithinAbsoluteError (levels.max, 1.0f, 0.01f);
+            expectWithinAbsoluteError (levels.rms, 1.0f, 0.01f);
+        }
+    }
+};
+
+static MipMapAudioThumbnailTests mipMapAudioThumbnailTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -0,0 +1,258 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+PreallocatingFileOutputStream::PreallocatingFileOutputStream (const juce::File& file,
+                                                              int64_t preallocationBytes_,
+                                                              int writeBlockBytes)
+    : preallocationBytes (preallocationBytes_),
+      bufferSize ((size_t) std::max (writeBlockBytes, 4096))
+{
+   #if JUCE_WINDOWS
+    handle = CreateFileW (file.getFullPathName().toWideCharPointer(), GENERIC_WRITE, FILE_SHARE_READ,
+                          nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER size;
+
+    if (GetFileSizeEx (handle, &size))
+        fileLength = (int64_t) size.QuadPart;
+   #else
+    fd = ::open (file.getFullPathName().toRawUTF8(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+
+    if (fd < 0)
+        return;
+
+    fileLength = (int64_t) ::lseek (fd, 0, SEEK_END);
+   #endif
+
+    buffer.malloc (bufferSize);
+    bufferStart = position = allocatedEnd = fileLength;
+    canPreallocate = preallocationBytes > 0;
+}
+
+PreallocatingFileOutputStream::~PreallocatingFileOutputStream()
+{
+    truncateAndClose();
+}
+
+bool PreallocatingFileOutputStream::openedOk() const noexcept
+{
+   #if JUCE_WINDOWS
+    return handle != INVALID_HANDLE_VALUE;
+   #else
+    return fd >= 0;
+   #endif
+}
+
+int64_t PreallocatingFileOutputStream::getNumBytesPreallocated() const noexcept
+{
+    return std::max<int64_t> (0, allocatedEnd - fileLength);
+}
+
+//==============================================================================
+void PreallocatingFileOutputStream::flush()
+{
+    if (writeBuffer())
+        syncToDisk();
+}
+
+bool PreallocatingFileOutputStream::setPosition (juce::int64 newPosition)
+{
+    if (newPosition == position)
+        return true;
+
+    if (newPosition < 0 || ! writeBuffer())
+        return false;
+
+    bufferStart = position = newPosition;
+    return true;
+}
+
+juce::int64 PreallocatingFileOutputStream::getPosition()
+{
+    return position;
+}
+
+bool PreallocatingFileOutputStream::write (const void* data, size_t numBytes)
+{
+    if (! openedOk())
+        return false;
+
+    auto src = static_cast<const char*> (data);
+    const auto blockSize = (int64_t) bufferSize;
+
+    while (numBytes > 0)
+    {
+        // Whole blocks that start on a boundary can go straight to the file
+        if (numBuffered == 0 && bufferStart % blockSize == 0 && numBytes >= bufferSize)
+        {
+            const auto numToWrite = numBytes - numBytes % bufferSize;
+
+            if (! writeToFile (bufferStart, src, numToWrite))
+                return false;
+
+            bufferStart += (int64_t) numToWrite;
+            src += numToWrite;
+            numBytes -= numToWrite;
+            continue;
+        }
+
+        // Otherwise the buffer is filled up to the next block boundary
+        const auto blockEnd = (bufferStart / blockSize + 1) * blockSize;
+        const auto spaceInBlock = (size_t) (blockEnd - (bufferStart + (int64_t) numBuffered));
+        const auto numToCopy = std::min (numBytes, spaceInBlock);
+
+        memcpy (buffer + numBuffered, src, numToCopy);
+        numBuffered += numToCopy;
+        src += numToCopy;
+        numBytes -= numToCopy;
+
+        if (numToCopy == spaceInBlock && ! writeBuffer())
+            return false;
+    }
+
+    position = bufferStart + (int64_t) numBuffered;
+    return true;
+}
+
+//==============================================================================
+bool PreallocatingFileOutputStream::writeBuffer()
+{
+    if (numBuffered == 0)
+        return true;
+
+    const bool ok = writeToFile (bufferStart, buffer, numBuffered);
+    bufferStart += (int64_t) numBuffered;
+    numBuffered = 0;
+
+    return ok;
+}
+
+bool PreallocatingFileOutputStream::writeToFile (int64_t filePos, const void* data, size_t numBytes)
+{
+    reserveSpaceFor (filePos + (int64_t) numBytes);
+    auto src = static_cast<const char*> (data);
+
+    for (auto pos = filePos, end = filePos + (int64_t) numBytes; pos < end;)
+    {
+       #if JUCE_WINDOWS
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD) (pos & 0xffffffff);
+        overlapped.OffsetHigh = (DWORD) (pos >> 32);
+
+        DWORD numWritten = 0;
+        const auto numToWrite = (DWORD) std::min<int64_t> (end - pos, 1 << 30);
+
+        if (! WriteFile (handle, src, numToWrite, &numWritten, &overlapped) || numWritten == 0)
+            return false;
+       #else
+        const auto numWritten = ::pwrite (fd, src, (size_t) (end - pos), (off_t) pos);
+
+        if (numWritten < 0 && errno == EINTR)
+            continue;
+
+        if (numWritten <= 0)
+            return false;
+       #endif
+
+        pos += (int64_t) numWritten;
+        src += numWritten;
+        fileLength = std::max (fileLength, pos);
+    }
+
+    return true;
+}
+
+void PreallocatingFileOutputStream::reserveSpaceFor (int64_t endPos)
+{
+    if (! canPreallocate || endPos <= allocatedEnd)
+        return;
+
+    // Reserves up to the chunk boundary after the end so small writes don't keep asking for more
+    const auto newEnd = (endPos / preallocationBytes + 1) * preallocationBytes;
+
+    if (allocate (newEnd))
+        allocatedEnd = newEnd;
+    else
+        canPreallocate = false;
+}
+
+bool PreallocatingFileOutputStream::allocate (int64_t newEnd)
+{
+    // Each of these reserves the space without changing the file's length
+   #if JUCE_WINDOWS
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = newEnd;
+    return SetFileInformationByHandle (handle, FileAllocationInfo, &info, sizeof (info)) != 0;
+   #elif JUCE_MAC || JUCE_IOS
+    fstore_t store = {};
+    store.fst_flags = F_ALLOCATECONTIG;
+    store.fst_posmode = F_PEOFPOSMODE;
+    store.fst_length = (off_t) (newEnd - allocatedEnd);
+
+    if (::fcntl (fd, F_PREALLOCATE, &store) != -1)
+        return true;
+
+    // Contiguous space isn't always available, but any space helps
+    store.fst_flags = F_ALLOCATEALL;
+    return ::fcntl (fd, F_PREALLOCATE, &store) != -1;
+   #elif (JUCE_LINUX || JUCE_ANDROID) && defined (FALLOC_FL_KEEP_SIZE)
+    return ::fallocate (fd, FALLOC_FL_KEEP_SIZE, (off_t) allocatedEnd, (off_t) (newEnd - allocatedEnd)) == 0;
+   #else
+    juce::ignoreUnused (newEnd);
+    return false;
+   #endif
+}
+
+void PreallocatingFileOutputStream::syncToDisk()
+{
+   #if JUCE_WINDOWS
+    FlushFileBuffers (handle);
+   #elif JUCE_LINUX || JUCE_ANDROID
+    ::fdatasync (fd);
+   #else
+    ::fsync (fd);
+   #endif
+}
+
+void PreallocatingFileOutputStream::truncateAndClose()
+{
+    if (! openedOk())
+        return;
+
+    writeBuffer();
+
+   #if JUCE_WINDOWS
+    if (allocatedEnd > fileLength)
+    {
+        LARGE_INTEGER size;
+        size.QuadPart = fileLength;
+
+        if (SetFilePointerEx (handle, size, nullptr, FILE_BEGIN))
+            SetEndOfFile (handle);
+    }
+
+    CloseHandle (handle);
+    handle = INVALID_HANDLE_VALUE;
+   #else
+    if (allocatedEnd > fileLength)
+        ::ftruncate (fd, (off_t) fileLength);
+
+    ::close (fd);
+    fd = -1;
+   #endif
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,91 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An OutputStream for writing long files, such as recordings, that reserves disk
+    space ahead of the write position and writes in aligned blocks.
+
+    Growing a file a block at a time fragments it on spinning disks and means
+    the file system has to update its metadata for almost every write, which can
+    cause latency spikes on slow or network drives. This reserves space in large
+    chunks instead, without changing the file's length, so a crash never leaves
+    the file with unwritten data at the end. When the stream is deleted the file
+    is truncated to the data written, releasing any space that wasn't used.
+
+    Writes are collected and passed to the OS in blocks aligned to the start of
+    the file. If the OS or file system can't reserve space, the stream carries on
+    without it.
+
+    Like juce::FileOutputStream, an existing file is opened with the position at
+    its end.
+*/
+class PreallocatingFileOutputStream  : public juce::OutputStream
+{
+public:
+    /** Opens a file for writing.
+
+        @param file                 the file to write to, which is created if it doesn't exist
+        @param preallocationBytes   the size of the chunks to reserve, 0 to not reserve any
+        @param writeBlockBytes      the size of the aligned blocks to write in
+    */
+    PreallocatingFileOutputStream (const juce::File& file,
+                                   int64_t preallocationBytes,
+                                   int writeBlockBytes);
+
+    /** Destructor. Writes any remaining data and truncates the file to its length. */
+    ~PreallocatingFileOutputStream() override;
+
+    /** Returns true if the file was opened. */
+    bool openedOk() const noexcept;
+
+    /** Returns the number of bytes reserved beyond the end of the data so far. */
+    int64_t getNumBytesPreallocated() const noexcept;
+
+    //==============================================================================
+    /** Writes any buffered data and asks the OS to write the file to disk. */
+    void flush() override;
+
+    /** @internal */
+    bool setPosition (juce::int64) override;
+    /** @internal */
+    juce::int64 getPosition() override;
+    /** @internal */
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+   #if JUCE_WINDOWS
+    HANDLE handle = INVALID_HANDLE_VALUE;
+   #else
+    int fd = -1;
+   #endif
+
+    const int64_t preallocationBytes;
+    juce::HeapBlock<char> buffer;
+    const size_t bufferSize;
+    size_t numBuffered = 0;
+    int64_t bufferStart = 0, position = 0, fileLength = 0, allocatedEnd = 0;
+    bool canPreallocate = false;
+
+    bool writeBuffer();
+    bool writeToFile (int64_t filePos, const void*, size_t);
+    void reserveSpaceFor (int64_t endPos);
+    bool allocate (int64_t newEnd);
+    void syncToDisk();
+    void truncateAndClose();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PreallocatingFileOutputStream)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -19,11 +19,22 @@ class RecordingThumbnailManager
 public:
     RecordingThumbnailManager (Engine& e) : engine (e) {}
 
+    /** Destructor. */
+    ~RecordingThumbnailManager()
+    {
+        reducerThread.stopThread (5000);
+    }
+
     /**
         A thumbnail represeting a recording file.
         Get one of these for a file with the getThumbnailFor function.
+
+        Recorded blocks are pushed on to a lock-free FIFO and added to the thumbnail
+        on a shared background thread, so the recording thread never has to wait
+        for the thumbnail's lock whilst it's being drawn.
     */
-    struct Thumbnail  : public juce::ReferenceCountedObject
+    struct Thumbnail  : public juce::ReferenceCountedObject,
+                        private juce::TimeSliceClient
     {
         using Ptr = juce::ReferenceCountedObjectPtr<Thumbnail>;
 
@@ -37,28 +48,65 @@ public:
         ~Thumbnail()
         {
             TRACKTION_ASSERT_MESSAGE_THREAD
-            engine.getRecordingThumbnailManager().thumbs.removeAllInstancesOf (this);
+            auto& manager = engine.getRecordingThumbnailManager();
+            manager.reducerThread.removeTimeSliceClient (this);
+            manager.thumbs.removeAllInstancesOf (this);
         }
 
-        /** Destructor */
+        /** Clears the thumbnail ready for a new recording. */
         void reset (int numChannels, double sampleRate)
         {
+            auto& reducerThread = engine.getRecordingThumbnailManager().reducerThread;
+            reducerThread.removeTimeSliceClient (this);
+
+            fifo.setSize (numChannels, std::max (1, (int) (sampleRate * fifoLengthSeconds)));
             thumb->reset (numChannels, sampleRate, 0);
             nextSampleNum = 0;
+            numSamplesDropped = 0;
+            numSamplesReduced = 0;
+
+            reducerThread.addTimeSliceClient (this);
         }
 
         /** Adss a block of recorded data to the thumbnail.
             This is called by the engine so shouldn't need to be called manually.
+            It doesn't lock or allocate, it just pushes the samples on to a FIFO.
         */
         void addBlock (const juce::AudioBuffer<float>& incoming, int startOffsetInBuffer, int numSamples)
         {
-            thumb->addBlock (nextSampleNum, incoming, startOffsetInBuffer, numSamples);
+            if (! fifo.write (incoming, startOffsetInBuffer, numSamples))
+                numSamplesDropped += numSamples;
+
             nextSampleNum += numSamples;
         }
 
     private:
         friend class RecordingThumbnailManager;
-        std::atomic<int64_t> nextSampleNum { 0 };
+        static constexpr double fifoLengthSeconds = 4.0;
+
+        AudioFifo fifo { 1, 1 };
+        juce::AudioBuffer<float> reduceBuffer;
+        std::atomic<int64_t> nextSampleNum { 0 }, numSamplesDropped { 0 };
+        int64_t numSamplesReduced = 0;
+
+        int useTimeSlice() override
+        {
+            const auto numReady = fifo.getNumReady();
+
+            if (numReady > 0)
+            {
+                reduceBuffer.setSize (fifo.getNumChannels(), numReady, false, false, true);
+                fifo.read (reduceBuffer, 0, numReady);
+                thumb->addBlock (numSamplesReduced, reduceBuffer, 0, numReady);
+                numSamplesReduced += numReady;
+            }
+
+            // If the FIFO overflowed, the dropped samples came after the ones that were
+            // in it, so leave a gap to keep the rest of the recording in the right place
+            numSamplesReduced += numSamplesDropped.exchange (0);
+
+            return numReady > 0 ? 0 : 20;
+        }
 
         Thumbnail (Engine& e, const juce::File& f)
             : engine (e),
@@ -67,7 +115,11 @@ public:
               file (f), hash (f.hashCode64())
         {
             TRACKTION_ASSERT_MESSAGE_THREAD
-            engine.getRecordingThumbnailManager().thumbs.addIfNotAlreadyThere (this);
+            auto& manager = engine.getRecordingThumbnailManager();
+            manager.thumbs.addIfNotAlreadyThere (this);
+
+            if (! manager.reducerThread.isThreadRunning())
+                manager.reducerThread.startThread (juce::Thread::Priority::low);
         }
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Thumbnail)
@@ -91,6 +143,7 @@ public:
 private:
     Engine& engine;
     juce::Array<Thumbnail*> thumbs;
+    juce::TimeSliceThread reducerThread { "Recording Thumbnails" };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RecordingThumbnailManager)
 };
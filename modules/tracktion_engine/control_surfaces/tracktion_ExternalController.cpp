@@ -16,6 +16,12 @@ ExternalController::ExternalController (Engine& e, ControlSurface* c)  : engine
     CRASH_TRACER
     controlSurface->owner = this;
 
+    parameterUpdateTimer.setCallback ([this]
+    {
+        parameterUpdateTimer.stopTimer();
+        triggerAsyncUpdate();
+    });
+
     auto& cs = getControlSurface();
     auto& storage = engine.getPropertyStorage();
 
@@ -71,6 +77,7 @@ ExternalController::ExternalController (Engine& e, ControlSurface* c)  : engine
 ExternalController::~ExternalController()
 {
     CRASH_TRACER
+    parameterUpdateTimer.stopTimer();
 
     if (auto af = getCurrentPlugin())
         for (auto p : af->getAutomatableParameters())
@@ -474,14 +481,25 @@ void ExternalController::moveFader (int channelNum, float newSliderPos)
     int i = getFaderIndexInActiveRegion (channelNum);
 
     if (i >= 0)
+    {
+        auto last = lastFaderPositions.find (i);
+
+        if (last != lastFaderPositions.end() && last->second == newSliderPos)
+            return;
+
+        lastFaderPositions[i] = newSliderPos;
         getControlSurface().moveFader (i, newSliderPos);
+    }
 }
 
 void ExternalController::moveMasterFader (float newPos)
 {
     CRASH_TRACER
-    if (controlSurface != nullptr)
+    if (controlSurface != nullptr && lastMasterFaderPosition != newPos)
+    {
+        lastMasterFaderPosition = newPos;
         getControlSurface().moveMasterLevelFader (newPos);
+    }
 }
 
 void ExternalController::movePanPot (int channelNum, float newPan)
@@ -489,12 +507,24 @@ void ExternalController::movePanPot (int channelNum, float newPan)
     int i = getFaderIndexInActiveRegion (channelNum);
 
     if (i >= 0)
+    {
+        auto last = lastPanPositions.find (i);
+
+        if (last != lastPanPositions.end() && last->second == newPan)
+            return;
+
+        lastPanPositions[i] = newPan;
         getControlSurface().movePanPot (i, newPan);
+    }
 }
 
 void ExternalController::moveMasterPanPot (float newPan)
 {
-    getControlSurface().moveMasterPanPot (newPan);
+    if (lastMasterPanPosition != newPan)
+    {
+        lastMasterPanPosition = newPan;
+        getControlSurface().moveMasterPanPot (newPan);
+    }
 }
 
 void ExternalController::updateSoloAndMute (int channelNum, Track::MuteAndSoloLightState state, bool isBright)
@@ -695,6 +725,7 @@ void ExternalController::changeParamBank (int delta)
     {
         CRASH_TRACER
         startParamNumber += delta;
+        lastParameterSettings.clear();
         updateParamList();
         updateParameters();
     }
@@ -854,7 +885,7 @@ void ExternalController::updateParameters()
 
                 s.copyToUTF8 (param.valueDescription, 6);
 
-                cs.parameterChanged (i, param);
+                sendParameter (i, param);
             }
             else
             {
@@ -873,7 +904,7 @@ void ExternalController::updateParameters()
                                 .copyToUTF8 (param.label, (size_t) std::min (cs.numCharactersForParameterLabels,
                                                                              (int) sizeof (param.label) - 1));
 
-                        cs.parameterChanged (i, param);
+                        sendParameter (i, param);
                     }
                     else if (startParamNumber + i == 1)
                     {
@@ -881,11 +912,11 @@ void ExternalController::updateParameters()
                             .copyToUTF8 (param.label, (size_t) std::min (cs.numCharactersForParameterLabels,
                                                                          (int) sizeof (param.label) - 1));
 
-                        cs.parameterChanged (i, param);
+                        sendParameter (i, param);
                     }
                     else
                     {
-                        cs.clearParameter(i);
+                        clearParameter (i);
                     }
                 }
             }
@@ -897,7 +928,41 @@ void ExternalController::updateParameters()
     }
 
     for (int i = numAvailableParams; i < cs.numParameterControls; ++i)
-        cs.clearParameter (i);
+        clearParameter (i);
+}
+
+void ExternalController::sendParameter (int paramIndex, const ParameterSetting& param)
+{
+    auto last = lastParameterSettings.find (paramIndex);
+
+    if (last != lastParameterSettings.end() && last->second.has_value()
+         && last->second->value == param.value
+         && std::strcmp (last->second->label, param.label) == 0
+         && std::strcmp (last->second->valueDescription, param.valueDescription) == 0)
+        return;
+
+    lastParameterSettings[paramIndex] = param;
+    getControlSurface().parameterChanged (paramIndex, param);
+}
+
+void ExternalController::clearParameter (int paramIndex)
+{
+    auto last = lastParameterSettings.find (paramIndex);
+
+    if (last != lastParameterSettings.end() && ! last->second.has_value())
+        return;
+
+    lastParameterSettings[paramIndex] = std::nullopt;
+    getControlSurface().clearParameter (paramIndex);
+}
+
+void ExternalController::clearLastSentValues()
+{
+    lastFaderPositions.clear();
+    lastPanPositions.clear();
+    lastMasterFaderPosition.reset();
+    lastMasterPanPosition.reset();
+    lastParameterSettings.clear();
 }
 
 void ExternalController::selectedPluginChanged()
@@ -963,8 +1028,12 @@ void ExternalController::curveHasChanged (AutomatableParameter&)
 
 void ExternalController::currentValueChanged (AutomatableParameter&)
 {
+    // Automated parameters can change every block so only update the
+    // surface at the manager's rate with the latest values
     updateParams = true;
-    triggerAsyncUpdate();
+
+    if (! parameterUpdateTimer.isTimerRunning())
+        parameterUpdateTimer.startTimer (getExternalControllerManager().getUpdateIntervalMs());
 }
 
 void ExternalController::updateTrackSelectLights()
@@ -1211,6 +1280,9 @@ void ExternalController::updateDeviceState()
 {
     if (controlSurface != nullptr)
     {
+        // This is used to refresh the whole surface so make sure everything gets sent
+        clearLastSentValues();
+
         if (auto edit = getEdit())
         {
             auto& ecm = getExternalControllerManager();
@@ -214,6 +214,18 @@ private:
     juce::Array<std::pair<int, juce::MidiMessage>> pendingMidiMessages;
     juce::CriticalSection incomingMidiLock;
 
+    LambdaTimer parameterUpdateTimer;
+
+    // The last values sent to the surface, so unchanged ones aren't sent again.
+    // A parameter mapped to nullopt has been cleared.
+    std::map<int, float> lastFaderPositions, lastPanPositions;
+    std::optional<float> lastMasterFaderPosition, lastMasterPanPosition;
+    std::map<int, std::optional<ParameterSetting>> lastParameterSettings;
+
+    void clearLastSentValues();
+    void sendParameter (int paramIndex, const ParameterSetting&);
+    void clearParameter (int paramIndex);
+
     int getMarkerBankOffset() const   { return startMarkerNumber; }
     int getFaderBankOffset() const    { return channelStart;      }
     int getAuxBankOffset() const      { return auxBank;           }
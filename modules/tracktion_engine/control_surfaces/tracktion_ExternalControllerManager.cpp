@@ -88,7 +88,7 @@ struct ExternalControllerManager::EditTreeWatcher   : private juce::ValueTree::L
     {
         edit.state.addListener (this);
         edit.getSceneList().sceneWatcher.addListener (this);
-        startTimer (40);
+        startTimer (owner.getUpdateIntervalMs());
     }
 
     ~EditTreeWatcher() override
@@ -102,6 +102,11 @@ struct ExternalControllerManager::EditTreeWatcher   : private juce::ValueTree::L
         updatePads.set (true);
     }
 
+    void setInterval (int intervalMs)
+    {
+        startTimer (intervalMs);
+    }
+
 private:
     //==============================================================================
     ExternalControllerManager& owner;
@@ -109,7 +114,7 @@ private:
 
     juce::Array<juce::ValueTree, juce::CriticalSection> pluginsToUpdate;
     juce::Atomic<int> updateAux;
-    juce::Atomic<bool> updatePads;
+    juce::Atomic<bool> updatePads, updateDevices;
 
     void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i) override
     {
@@ -132,7 +137,7 @@ private:
         else if (v.hasType (IDs::TRACK))
         {
             if (i == IDs::name)
-                owner.updateDeviceState();
+                updateDevices.set (true);
         }
     }
 
@@ -153,6 +158,13 @@ private:
 
     void timerCallback() override
     {
+        // A full update re-sends all the faders so there's no need to do the plugins separately
+        if (updateDevices.compareAndSetBool (false, true))
+        {
+            pluginsToUpdate.clear();
+            owner.updateDeviceState();
+        }
+
         {
             juce::Array<juce::ValueTree, juce::CriticalSection> plugins;
             plugins.swapWith (pluginsToUpdate);
@@ -537,6 +549,19 @@ void ExternalControllerManager::timerCallback()
     updateMarkers();
 }
 
+void ExternalControllerManager::setUpdateIntervalMs (int newIntervalMs)
+{
+    newIntervalMs = std::max (1, newIntervalMs);
+
+    if (updateIntervalMs == newIntervalMs)
+        return;
+
+    updateIntervalMs = newIntervalMs;
+
+    if (editTreeWatcher != nullptr)
+        editTreeWatcher->setInterval (updateIntervalMs);
+}
+
 //==============================================================================
 ExternalControllerManager::BlinkTimer::BlinkTimer (ExternalControllerManager& e) : ecm (e)
 {
@@ -100,6 +100,17 @@ public:
     ExternalController* addController (ControlSurface*);
     void deleteController (ExternalController*);
 
+    //==============================================================================
+    /** Sets how often changes to the Edit are sent on to the controllers.
+        Any fader, pan, track name and plugin parameter changes that happen between
+        updates are collected together and only the latest values get sent, so
+        busy automation doesn't flood slow devices with messages.
+    */
+    void setUpdateIntervalMs (int newIntervalMs);
+
+    /** Returns the interval set with setUpdateIntervalMs. */
+    int getUpdateIntervalMs() const noexcept            { return updateIntervalMs; }
+
     //==============================================================================
     // these get called by stuff in the application to make the controllers react
     // appropriately..
@@ -206,6 +217,7 @@ private:
     NovationAutomap* automap = nullptr;
 
     uint32_t lastUpdate = 0;
+    int updateIntervalMs = 40;
     Edit* currentEdit = nullptr;
     SelectionManager* currentSelectionManager = nullptr;
 
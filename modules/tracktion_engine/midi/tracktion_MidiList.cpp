@@ -1177,8 +1177,14 @@ void MidiList::initialise (juce::UndoManager* um)
     sysexList       = std::make_unique<EventList<MidiSysexEvent>> (state);
 }
 
+MidiList::ScopedBulkChange::ScopedBulkChange (MidiList& ml)
+    : notes (*ml.noteList), controllers (*ml.controllerList), sysexes (*ml.sysexList)
+{
+}
+
 void MidiList::clear (juce::UndoManager* um)
 {
+    const ScopedBulkChange bulkChange (*this);
     state.removeAllChildren (um);
     importedName = {};
 }
@@ -1187,6 +1193,7 @@ void MidiList::copyFrom (const MidiList& other, juce::UndoManager* um)
 {
     if (this != &other)
     {
+        const ScopedBulkChange bulkChange (*this);
         clear (um);
         state.copyPropertiesFrom (other.state, um);
         addFrom (other, um);
@@ -1196,8 +1203,12 @@ void MidiList::copyFrom (const MidiList& other, juce::UndoManager* um)
 void MidiList::addFrom (const MidiList& other, juce::UndoManager* um)
 {
     if (this != &other)
+    {
+        const ScopedBulkChange bulkChange (*this);
+
         for (int i = 0; i < other.state.getNumChildren(); ++i)
             state.addChild (other.state.getChild (i).createCopy(), -1, um);
+    }
 }
 
 void MidiList::setMidiChannel (MidiChannel newChannel)
@@ -1353,9 +1364,20 @@ juce::Range<int> MidiList::getNoteNumberRange() const
     return { min, max };
 }
 
+juce::Range<int> MidiList::getNoteIndexesOverlapping (BeatRange range) const
+{
+    jassert (noteList != nullptr);
+    return noteList->getIndexesOverlapping (range);
+}
+
 MidiNote* MidiList::addNote (const MidiNote& note, juce::UndoManager* um)
 {
-    auto v = note.state.createCopy();
+    return addNoteWithState (note.state.createCopy(), um);
+}
+
+MidiNote* MidiList::addNoteWithState (const juce::ValueTree& v, juce::UndoManager* um)
+{
+    jassert (v.hasType (IDs::NOTE) && ! v.getParent().isValid());
     state.addChild (v, -1, um);
     return noteList->getEventFor (v);
 }
@@ -1375,17 +1397,125 @@ void MidiList::removeNote (MidiNote& note, juce::UndoManager* um)
 
 void MidiList::removeAllNotes (juce::UndoManager* um)
 {
+    const ScopedBulkChange bulkChange (*this);
+
     for (int i = state.getNumChildren(); --i >= 0;)
         if (state.getChild (i).hasType (IDs::NOTE))
             state.removeChild (i, um);
 }
 
+//==============================================================================
+std::vector<MidiList::NoteValues> MidiList::getNoteValues (const juce::Array<MidiNote*>& notes)
+{
+    std::vector<NoteValues> values;
+    values.reserve ((size_t) notes.size());
+
+    for (auto n : notes)
+        values.push_back ({ n->getStartBeat(), n->getLengthBeats(), n->getNoteNumber(), n->getVelocity() });
+
+    return values;
+}
+
+void MidiList::setNoteValues (const juce::Array<MidiNote*>& notes, const std::vector<NoteValues>& values, juce::UndoManager* um)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    jassert ((size_t) notes.size() == values.size());
+
+    {
+        // The setters keep the notes up to date so the list doesn't need to look
+        // up each changed note, which would be quadratic for large lists
+        const juce::ScopedValueSetter<bool> svs (noteList->isSettingValues, true);
+
+        for (int i = 0; i < notes.size(); ++i)
+        {
+            auto& n = *notes.getUnchecked (i);
+            jassert (n.state.getParent() == state);
+            auto& v = values[(size_t) i];
+
+            n.setStartAndLength (v.startBeat, v.lengthBeats, um);
+            n.setNoteNumber (v.noteNumber, um);
+            n.setVelocity (v.velocity, um);
+        }
+    }
+
+    noteList->triggerSort();
+}
+
+void MidiList::transformNotes (const juce::Array<MidiNote*>& notes, const std::function<void (NoteValues&)>& transform, juce::UndoManager* um)
+{
+    CRASH_TRACER
+    auto values = getNoteValues (notes);
+
+    auto transformRange = [&values, &transform] (size_t start, size_t end)
+    {
+        for (auto i = start; i < end; ++i)
+            transform (values[i]);
+    };
+
+    const auto numNotes = values.size();
+    const auto numCores = (size_t) std::max (1u, std::thread::hardware_concurrency());
+    const auto numThreads = std::clamp (numNotes / (size_t) minNumNotesPerThread, (size_t) 1, numCores);
+    const auto numPerThread = (numNotes + numThreads - 1) / numThreads;
+
+    // The first chunk is done on this thread
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < numThreads; ++i)
+        threads.emplace_back (transformRange, i * numPerThread, std::min (numNotes, (i + 1) * numPerThread));
+
+    transformRange (0, std::min (numNotes, numPerThread));
+
+    for (auto& t : threads)
+        t.join();
+
+    setNoteValues (notes, values, um);
+}
+
+void MidiList::quantiseNotes (const juce::Array<MidiNote*>& notes, const QuantisationType& quantisation,
+                              BeatPosition contentStartBeat, juce::UndoManager* um)
+{
+    if (! quantisation.isEnabled())
+        return;
+
+    const auto offset = toDuration (contentStartBeat);
+    const bool quantiseEnds = quantisation.isQuantisingNoteOffs();
+
+    transformNotes (notes, [&] (NoteValues& v)
+                    {
+                        const auto newStart = quantisation.roundBeatToNearest (v.startBeat + offset) - offset;
+
+                        if (quantiseEnds)
+                        {
+                            const auto newEnd = quantisation.roundBeatToNearest (v.startBeat + v.lengthBeats + offset) - offset;
+
+                            // Notes shorter than the grid keep their length rather than vanishing
+                            if (newEnd > newStart)
+                                v.lengthBeats = newEnd - newStart;
+                        }
+
+                        v.startBeat = newStart;
+                    }, um);
+}
+
+void MidiList::transposeNotes (const juce::Array<MidiNote*>& notes, int numSemitones, juce::UndoManager* um)
+{
+    if (numSemitones != 0)
+        transformNotes (notes, [numSemitones] (NoteValues& v) { v.noteNumber = juce::jlimit (0, 127, v.noteNumber + numSemitones); }, um);
+}
+
+void MidiList::scaleNoteVelocities (const juce::Array<MidiNote*>& notes, float factor, juce::UndoManager* um)
+{
+    if (factor != 1.0f)
+        transformNotes (notes, [factor] (NoteValues& v) { v.velocity = juce::jlimit (1, 127, juce::roundToInt ((float) v.velocity * factor)); }, um);
+}
+
 //==============================================================================
 MidiControllerEvent* MidiList::getControllerEventAt (BeatPosition beatNumber, int controllerType) const
 {
     auto& controllerEvents = getControllerEvents();
 
-    for (int i = controllerEvents.size(); --i >= 0;)
+    // Start from the last event at or before the beat
+    for (int i = controllerList->getNumStartingUpTo (beatNumber); --i >= 0;)
     {
         auto e = controllerEvents.getUnchecked (i);
 
@@ -1396,6 +1526,12 @@ MidiControllerEvent* MidiList::getControllerEventAt (BeatPosition beatNumber, in
     return {};
 }
 
+juce::Range<int> MidiList::getControllerEventIndexesIn (BeatRange range) const
+{
+    jassert (controllerList != nullptr);
+    return controllerList->getIndexesStartingIn (range);
+}
+
 bool MidiList::containsController (int controllerType) const
 {
     for (auto e : getControllerEvents())
@@ -1407,7 +1543,12 @@ bool MidiList::containsController (int controllerType) const
 
 MidiControllerEvent* MidiList::addControllerEvent (const MidiControllerEvent& event, juce::UndoManager* um)
 {
-    auto v = event.state.createCopy();
+    return addControllerEventWithState (event.state.createCopy(), um);
+}
+
+MidiControllerEvent* MidiList::addControllerEventWithState (const juce::ValueTree& v, juce::UndoManager* um)
+{
+    jassert (v.hasType (IDs::CONTROL) && ! v.getParent().isValid());
     state.addChild (v, -1, um);
     return controllerList->getEventFor (v);
 }
@@ -1500,10 +1641,16 @@ void MidiList::insertRepeatedControllerValue (int type, int startVal, int endVal
 
 void MidiList::removeControllersBetween (int controllerType, BeatPosition beatStart, BeatPosition beatEnd, juce::UndoManager* um)
 {
+    if (beatEnd <= beatStart)
+        return;
+
     juce::Array<juce::ValueTree> itemsToRemove;
+    auto& controllerEvents = getControllerEvents();
 
-    for (auto e : getControllerEvents())
-        if (e->getType() == controllerType && e->getBeatPosition() >= beatStart && e->getBeatPosition() < beatEnd)
+    const auto indexes = getControllerEventIndexesIn ({ beatStart, beatEnd });
+
+    for (int i = indexes.getStart(); i < indexes.getEnd(); ++i)
+        if (auto e = controllerEvents.getUnchecked (i); e->getType() == controllerType)
             itemsToRemove.add (e->state);
 
     for (auto& v : itemsToRemove)
@@ -1511,6 +1658,12 @@ void MidiList::removeControllersBetween (int controllerType, BeatPosition beatSt
 }
 
 //==============================================================================
+juce::Range<int> MidiList::getSysexEventIndexesIn (BeatRange range) const
+{
+    jassert (sysexList != nullptr);
+    return sysexList->getIndexesStartingIn (range);
+}
+
 MidiSysexEvent* MidiList::getSysexEventFor (const juce::ValueTree& v) const
 {
     for (auto n : getSysexEvents())
@@ -1755,19 +1908,49 @@ bool MidiList::readSeparateTracksFromFile (const juce::File& f,
 }
 
 //==============================================================================
+/** Returns the beat of each event in a sequence relative to firstBeatNum.
+    These are all converted in one go which is much quicker than doing them one by one.
+*/
+static std::vector<BeatPosition> getEventBeats (const juce::MidiMessageSequence& sequence,
+                                                const TempoSequence* ts, BeatPosition firstBeatNum)
+{
+    const auto numEvents = (size_t) sequence.getNumEvents();
+    std::vector<BeatPosition> beats (numEvents);
+
+    if (ts == nullptr)
+    {
+        for (size_t i = 0; i < numEvents; ++i)
+            beats[i] = BeatPosition::fromBeats (sequence.getEventPointer ((int) i)->message.getTimeStamp());
+
+        return beats;
+    }
+
+    std::vector<TimePosition> times (numEvents);
+
+    for (size_t i = 0; i < numEvents; ++i)
+        times[i] = TimePosition::fromSeconds (sequence.getEventPointer ((int) i)->message.getTimeStamp());
+
+    ts->toBeats (times, beats);
+
+    for (auto& b : beats)
+        b = b - toDuration (firstBeatNum);
+
+    return beats;
+}
+
 void MidiList::importMidiSequence (const juce::MidiMessageSequence& sequence, Edit* edit,
                                    TimePosition editTimeOfListTimeZero, juce::UndoManager* um)
 {
     auto ts = edit != nullptr ? &edit->tempoSequence : nullptr;
     auto firstBeatNum = ts != nullptr ? ts->toBeats (editTimeOfListTimeZero) : BeatPosition();
     const int channelNumber = getMidiChannel().getChannelNumber();
+    const auto eventBeats = getEventBeats (sequence, ts, firstBeatNum);
+    const ScopedBulkChange bulkChange (*this);
 
     for (int i = 0; i < sequence.getNumEvents(); ++i)
     {
         auto& m = sequence.getEventPointer (i)->message;
-
-        auto beatTime = ts != nullptr ? ts->toBeats (TimePosition::fromSeconds (m.getTimeStamp())) - toDuration (firstBeatNum)
-                                      : BeatPosition::fromBeats (m.getTimeStamp());
+        auto beatTime = eventBeats[(size_t) i];
 
         if (m.isSysEx())
         {
@@ -1785,12 +1968,15 @@ void MidiList::importMidiSequence (const juce::MidiMessageSequence& sequence, Ed
 
             if (m.isNoteOn())
             {
-                const auto keyUpTime = TimePosition::fromSeconds (sequence.getTimeOfMatchingKeyUp (i));
+                // Notes without a note-off end at time 0, as getTimeOfMatchingKeyUp would return
+                const auto keyUpIndex = sequence.getIndexOfMatchingKeyUp (i);
+                const auto keyUpBeat = keyUpIndex >= 0 ? eventBeats[(size_t) keyUpIndex]
+                                                       : (ts != nullptr ? ts->toBeats (TimePosition()) - toDuration (firstBeatNum)
+                                                                        : BeatPosition());
 
                 addNote (m.getNoteNumber(),
                          beatTime,
-                         ts != nullptr ? ((ts->toBeats (keyUpTime) - firstBeatNum) - toDuration (beatTime))
-                                       : (BeatDuration::fromBeats (keyUpTime.inSeconds()) - toDuration (beatTime)),
+                         keyUpBeat - beatTime,
                          m.getVelocity(), edit != nullptr ? edit->engine.getEngineBehaviour().getDefaultNoteColour() : 0, um);
             }
             else if (m.isAftertouch())
@@ -1830,16 +2016,17 @@ void MidiList::importFromEditTimeSequenceWithNoteExpression (const juce::MidiMes
     auto ts = edit != nullptr ? &edit->tempoSequence : nullptr;
     auto firstBeatNum = ts != nullptr ? ts->toBeats (editTimeOfListTimeZero) : BeatPosition();
     const int channelNumber = getMidiChannel().getChannelNumber();
+    const ScopedBulkChange bulkChange (*this);
 
     juce::MPEZoneLayout layout;
     layout.setLowerZone (15);
     MPEtoNoteExpression noteQueue (*this, ts, layout, firstBeatNum, um);
+    const auto eventBeats = getEventBeats (sequence, ts, firstBeatNum);
 
     for (int i = 0; i < sequence.getNumEvents(); ++i)
     {
         auto& m = sequence.getEventPointer (i)->message;
-        const auto beatTime = ts != nullptr ? ts->toBeats (TimePosition::fromSeconds (m.getTimeStamp())) - toDuration (firstBeatNum)
-                                            : BeatPosition::fromBeats (m.getTimeStamp());
+        const auto beatTime = eventBeats[(size_t) i];
 
         if (m.isSysEx())
         {
@@ -1911,6 +2098,12 @@ juce::MidiMessageSequence MidiList::createDefaultPlaybackMidiSequence (const Mid
     auto lastNoteBeat  = timeBase == TimeBase::beatsRaw ? list.getLastBeatNumber() + overlapAllowance
                                                         : toPosition (ts.toBeats (clip.getPosition().getEnd())   - midiStartBeat + overlapAllowance);
 
+    // Only the events in these indexes can end up in the sequence
+    const BeatRange range (firstNoteBeat, std::max (firstNoteBeat, lastNoteBeat));
+    const auto noteIndexes = list.getNoteIndexesOverlapping (range);
+    const auto controllerIndexes = list.getControllerEventIndexesIn (range);
+    const auto sysexIndexes = list.getSysexEventIndexesIn (range);
+
     auto& notes = list.getNotes();
     const auto numNotes = notes.size();
     auto selectedEvents = clip.getSelectedEvents();
@@ -1927,34 +2120,26 @@ juce::MidiMessageSequence MidiList::createDefaultPlaybackMidiSequence (const Mid
         // Add cumulative controller events that are off the start
         juce::Array<int> doneControllers;
 
-        for (auto e : controllerEvents)
+        for (int i = 0; i < controllerIndexes.getStart(); ++i)
         {
-            auto beat = e->getBeatPosition();
+            auto e = controllerEvents.getUnchecked (i);
 
-            if (beat < firstNoteBeat)
+            if (! doneControllers.contains (e->getType()))
             {
-                if (! doneControllers.contains (e->getType()))
-                {
-                    addToSequence (destSequence, clip, timeBase, *e, channelNumber);
-                    doneControllers.add (e->getType());
-                }
+                addToSequence (destSequence, clip, timeBase, *e, channelNumber);
+                doneControllers.add (e->getType());
             }
         }
     }
 
     // Add the real controller events:
-    for (auto e : controllerEvents)
-    {
-        auto beat = e->getBeatPosition();
-
-        if (beat >= firstNoteBeat && beat < lastNoteBeat)
-            addToSequence (destSequence, clip, timeBase, *e, channelNumber);
-    }
+    for (int i = controllerIndexes.getStart(); i < controllerIndexes.getEnd(); ++i)
+        addToSequence (destSequence, clip, timeBase, *controllerEvents.getUnchecked (i), channelNumber);
 
     // Then the note events
     if (! generateMPE)
     {
-        for (int i = 0; i < numNotes; ++i)
+        for (int i = noteIndexes.getStart(); i < numNotes; ++i)
         {
             auto& note = *notes.getUnchecked (i);
 
@@ -2004,13 +2189,10 @@ juce::MidiMessageSequence MidiList::createDefaultPlaybackMidiSequence (const Mid
     }
 
     // Add the SysEx events:
-    for (auto e : list.getSysexEvents())
-    {
-        auto beat = e->getBeatPosition();
+    auto& sysexEvents = list.getSysexEvents();
 
-        if (beat >= firstNoteBeat && beat < lastNoteBeat)
-            addToSequence (destSequence, clip, timeBase, *e);
-    }
+    for (int i = sysexIndexes.getStart(); i < sysexIndexes.getEnd(); ++i)
+        addToSequence (destSequence, clip, timeBase, *sysexEvents.getUnchecked (i));
 
     return destSequence;
 }
@@ -28,6 +28,22 @@ public:
     /** Adds copies of the events in another list to this one. */
     void addFrom (const MidiList&, juce::UndoManager*);
 
+    //==============================================================================
+    /** Defers updating the sorted event lists for events added or removed whilst
+        it's in scope, so adding or removing lots of events only sorts them once.
+        The sorted lists may not include the changes until this is destroyed.
+        @see ValueTreeObjectList::ScopedBulkChange
+    */
+    struct ScopedBulkChange
+    {
+        ScopedBulkChange (MidiList&);
+
+    private:
+        ValueTreeObjectList<MidiNote>::ScopedBulkChange notes;
+        ValueTreeObjectList<MidiControllerEvent>::ScopedBulkChange controllers;
+        ValueTreeObjectList<MidiSysexEvent>::ScopedBulkChange sysexes;
+    };
+
     //==============================================================================
     enum class NoteAutomationType
     {
@@ -75,6 +91,12 @@ public:
 
     juce::Range<int> getNoteNumberRange() const;
 
+    /** Returns the indexes in getNotes() of the notes that might overlap a range of beats.
+        Notes outside these indexes are known not to overlap the range so this can be used
+        to avoid checking every note.
+    */
+    juce::Range<int> getNoteIndexesOverlapping (BeatRange) const;
+
     /** Beat number of first event in the list */
     BeatPosition getFirstBeatNumber() const;
 
@@ -83,19 +105,77 @@ public:
 
     MidiNote* addNote (const MidiNote&, juce::UndoManager*);
     MidiNote* addNote (int pitch, BeatPosition startBeat, BeatDuration lengthInBeats, int velocity, int colourIndex, juce::UndoManager*);
+
+    /** Adds a note using a state that has already been created, e.g. a copy of some
+        clipboard content, rather than making another copy of it.
+        The state mustn't already have a parent.
+    */
+    MidiNote* addNoteWithState (const juce::ValueTree&, juce::UndoManager*);
     void removeNote (MidiNote&, juce::UndoManager*);
     void removeAllNotes (juce::UndoManager*);
 
+    //==============================================================================
+    /** The values of a note that can be changed in bulk. @see transformNotes */
+    struct NoteValues
+    {
+        BeatPosition startBeat;
+        BeatDuration lengthBeats;
+        int noteNumber = 0, velocity = 0;
+    };
+
+    /** Returns the values of some notes of this list, in the same order. */
+    static std::vector<NoteValues> getNoteValues (const juce::Array<MidiNote*>&);
+
+    /** Sets the values of some notes of this list, e.g. ones returned by getNoteValues.
+        Only the values that have changed are set, and the sorted note list is only
+        updated once at the end rather than for every note. To undo a large change
+        in one compact step, pass the UndoManager of a CompactUndoableChange.
+    */
+    void setNoteValues (const juce::Array<MidiNote*>&, const std::vector<NoteValues>&, juce::UndoManager*);
+
+    /** Changes lots of notes at once by calling a function with the values of each one.
+        For large numbers of notes, the calls are shared between several threads so the
+        function mustn't use the Edit or anything else that isn't thread-safe. The new
+        values are then set with setNoteValues.
+    */
+    void transformNotes (const juce::Array<MidiNote*>&, const std::function<void (NoteValues&)>&, juce::UndoManager*);
+
+    /** Quantises the starts of some notes, and their ends if the QuantisationType
+        quantises note-offs.
+        @param contentStartBeat  the beat in the Edit that beat 0 of this list is at,
+                                 e.g. MidiClip::getContentStartBeat, so the notes are
+                                 snapped to the Edit's grid
+    */
+    void quantiseNotes (const juce::Array<MidiNote*>&, const QuantisationType&,
+                        BeatPosition contentStartBeat, juce::UndoManager*);
+
+    /** Moves the pitches of some notes up or down, limiting them to 0 to 127. */
+    void transposeNotes (const juce::Array<MidiNote*>&, int numSemitones, juce::UndoManager*);
+
+    /** Multiplies the velocities of some notes, limiting them to 1 to 127. */
+    void scaleNoteVelocities (const juce::Array<MidiNote*>&, float factor, juce::UndoManager*);
+
+    /** The number of notes transformNotes gives each thread it uses. */
+    static constexpr int minNumNotesPerThread = 8192;
+
     //==============================================================================
     int getNumControllerEvents() const                              { return getControllerEvents().size(); }
 
     MidiControllerEvent* getControllerEvent (int index) const       { return getControllerEvents()[index]; }
     MidiControllerEvent* getControllerEventAt (BeatPosition, int controllerType) const;
 
+    /** Returns the indexes in getControllerEvents() of the events in a range of beats. */
+    juce::Range<int> getControllerEventIndexesIn (BeatRange) const;
+
     MidiControllerEvent* addControllerEvent (const MidiControllerEvent&, juce::UndoManager*);
     MidiControllerEvent* addControllerEvent (BeatPosition, int controllerType, int controllerValue, juce::UndoManager*);
     MidiControllerEvent* addControllerEvent (BeatPosition, int controllerType, int controllerValue, int metadata, juce::UndoManager*);
 
+    /** Adds a controller event using a state that has already been created, rather
+        than making another copy of it. The state mustn't already have a parent.
+    */
+    MidiControllerEvent* addControllerEventWithState (const juce::ValueTree&, juce::UndoManager*);
+
     void removeControllerEvent (MidiControllerEvent&, juce::UndoManager*);
     void removeAllControllers (juce::UndoManager*);
 
@@ -117,6 +197,9 @@ public:
     MidiSysexEvent* getSysexEventUnchecked (int index) const        { return getSysexEvents().getUnchecked (index); }
     MidiSysexEvent* getSysexEventFor (const juce::ValueTree&) const;
 
+    /** Returns the indexes in getSysexEvents() of the events in a range of beats. */
+    juce::Range<int> getSysexEventIndexesIn (BeatRange) const;
+
     MidiSysexEvent& addSysExEvent (const juce::MidiMessage&, BeatPosition, juce::UndoManager*);
 
     void removeSysExEvent (const MidiSysexEvent&, juce::UndoManager*);
@@ -223,9 +306,12 @@ private:
 
         EventType* getEventFor (const juce::ValueTree& v)
         {
-            for (auto m : ValueTreeObjectList<EventType>::objects)
-                if (m->state == v)
-                    return m;
+            // Search backwards as new events are appended and are the ones most often looked up
+            auto& objects = ValueTreeObjectList<EventType>::objects;
+
+            for (int i = objects.size(); --i >= 0;)
+                if (objects.getUnchecked (i)->state == v)
+                    return objects.getUnchecked (i);
 
             return {};
         }
@@ -233,15 +319,40 @@ private:
         bool isSuitableType (const juce::ValueTree& v) const override   { return EventDelegate<EventType>::isSuitableType (v); }
         EventType* createNewObject (const juce::ValueTree& v) override  { return new EventType (v); }
         void deleteObject (EventType* m) override                       { delete m; }
-        void newObjectAdded (EventType*) override                       { triggerSort(); }
-        void objectRemoved (EventType* m) override                      { EventDelegate<EventType>::removeFromSelection (m); triggerSort(); }
+        void newObjectAdded (EventType* e) override                     { addChange (*e, e->getBeatPosition(), true); }
+        void objectRemoved (EventType* m) override                      { EventDelegate<EventType>::removeFromSelection (m); addChange (*m, m->getBeatPosition(), false); }
         void objectOrderChanged() override                              { triggerSort(); }
 
+        void bulkChangeEnded (const juce::Array<EventType*>&, const juce::Array<EventType*>& removed, bool) override
+        {
+            for (auto e : removed)
+                EventDelegate<EventType>::removeFromSelection (e);
+
+            // Sorting once is quicker than applying lots of individual changes
+            triggerSort();
+        }
+
         void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i) override
         {
+            // The events being changed are already up to date and get sorted afterwards
+            if (isSettingValues)
+                return;
+
             if (auto e = getEventFor (v))
+            {
+                const auto oldBeat = e->getBeatPosition();
+
                 if (EventDelegate<EventType>::updateObject (*e, i))
-                    triggerSort();
+                {
+                    addChange (*e, oldBeat, false);
+                    addChange (*e, e->getBeatPosition(), true);
+                }
+                else
+                {
+                    const juce::ScopedLock sl (lock);
+                    needsEndBeatsUpdate = true;
+                }
+            }
         }
 
         void triggerSort()
@@ -257,17 +368,160 @@ private:
             const juce::ScopedLock sl (lock);
 
             if (needsSorting)
+                sortAll();
+            else if (! pendingChanges.empty())
+                applyPendingChanges();
+
+            return sortedEvents;
+        }
+
+        void sortAll()
+        {
+            needsSorting = false;
+            needsEndBeatsUpdate = true;
+            pendingChanges.clear();
+            sortedEvents = ValueTreeObjectList<EventType>::objects;
+            sortMidiEventsByTime (sortedEvents);
+
+            sortedBeats.clear();
+            sortedBeats.reserve ((size_t) sortedEvents.size());
+
+            for (auto e : sortedEvents)
+                sortedBeats.push_back (e->getBeatPosition());
+        }
+
+        /** Returns the indexes in the sorted list of the events that start in a range. */
+        juce::Range<int> getIndexesStartingIn (BeatRange range)
+        {
+            getSortedList();
+
+            const juce::ScopedLock sl (lock);
+            auto start = std::lower_bound (sortedBeats.begin(), sortedBeats.end(), range.getStart());
+            auto end = std::lower_bound (start, sortedBeats.end(), range.getEnd());
+
+            return { (int) std::distance (sortedBeats.begin(), start),
+                     (int) std::distance (sortedBeats.begin(), end) };
+        }
+
+        /** Returns the number of events in the sorted list that start at or before a beat. */
+        int getNumStartingUpTo (BeatPosition beat)
+        {
+            getSortedList();
+
+            const juce::ScopedLock sl (lock);
+            return (int) std::distance (sortedBeats.begin(), std::upper_bound (sortedBeats.begin(), sortedBeats.end(), beat));
+        }
+
+        /** Returns the indexes in the sorted list of the events that might overlap a range.
+            Events before these all end before the range starts and those after start after it.
+        */
+        juce::Range<int> getIndexesOverlapping (BeatRange range)
+        {
+            getSortedList();
+
+            const juce::ScopedLock sl (lock);
+
+            if (needsEndBeatsUpdate)
+            {
+                // The latest end of all the events up to each one, so this is sorted too
+                needsEndBeatsUpdate = false;
+                maxEndBeats.resize (sortedBeats.size());
+                BeatPosition maxEnd;
+
+                for (size_t i = 0; i < maxEndBeats.size(); ++i)
+                {
+                    maxEnd = i == 0 ? getEndBeat (*sortedEvents.getUnchecked (0))
+                                    : std::max (maxEnd, getEndBeat (*sortedEvents.getUnchecked ((int) i)));
+                    maxEndBeats[i] = maxEnd;
+                }
+            }
+
+            auto first = std::upper_bound (maxEndBeats.begin(), maxEndBeats.end(), range.getStart());
+            const auto firstIndex = std::distance (maxEndBeats.begin(), first);
+            auto end = std::lower_bound (sortedBeats.begin() + firstIndex, sortedBeats.end(), range.getEnd());
+
+            return { (int) firstIndex, (int) std::distance (sortedBeats.begin(), end) };
+        }
+
+        static BeatPosition getEndBeat (const EventType& e)
+        {
+            if constexpr (std::is_same_v<EventType, MidiNote>)
+                return e.getEndBeat();
+            else
+                return e.getBeatPosition();
+        }
+
+        //==============================================================================
+        /** A change to apply to the sorted list the next time it's used.
+            These are held rather than applied straight away so the list doesn't change
+            while it's being iterated. The event is only used as an identifier here as it
+            might have been deleted by the time the change is applied.
+        */
+        struct PendingChange
+        {
+            const EventType* event;
+            BeatPosition beat;
+            bool isInsertion;
+        };
+
+        // Changes are applied in place until there are enough that it's quicker to re-sort the list
+        static constexpr size_t maxNumPendingChanges = 64;
+
+        void addChange (const EventType& e, BeatPosition beat, bool isInsertion)
+        {
+            const juce::ScopedLock sl (lock);
+
+            if (needsSorting)
+                return;
+
+            if (pendingChanges.size() >= maxNumPendingChanges)
             {
-                needsSorting = false;
-                sortedEvents = ValueTreeObjectList<EventType>::objects;
-                sortMidiEventsByTime (sortedEvents);
+                triggerSort();
+                return;
             }
 
-            return sortedEvents;
+            pendingChanges.push_back ({ &e, beat, isInsertion });
+        }
+
+        void applyPendingChanges()
+        {
+            needsEndBeatsUpdate = true;
+
+            for (auto& change : pendingChanges)
+            {
+                if (change.isInsertion)
+                {
+                    auto pos = std::upper_bound (sortedBeats.begin(), sortedBeats.end(), change.beat);
+                    sortedEvents.insert ((int) std::distance (sortedBeats.begin(), pos), const_cast<EventType*> (change.event));
+                    sortedBeats.insert (pos, change.beat);
+                    continue;
+                }
+
+                const auto range = std::equal_range (sortedBeats.begin(), sortedBeats.end(), change.beat);
+                auto index = (int) std::distance (sortedBeats.begin(), range.first);
+                const auto endIndex = (int) std::distance (sortedBeats.begin(), range.second);
+
+                while (index < endIndex && sortedEvents.getUnchecked (index) != change.event)
+                    ++index;
+
+                if (index == endIndex)
+                {
+                    jassertfalse;
+                    sortAll();
+                    return;
+                }
+
+                sortedEvents.remove (index);
+                sortedBeats.erase (sortedBeats.begin() + index);
+            }
+
+            pendingChanges.clear();
         }
 
-        bool needsSorting = true;
+        bool needsSorting = true, needsEndBeatsUpdate = true, isSettingValues = false;
         juce::Array<EventType*> sortedEvents;
+        std::vector<BeatPosition> sortedBeats, maxEndBeats;
+        std::vector<PendingChange> pendingChanges;
         juce::CriticalSection lock;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventList)
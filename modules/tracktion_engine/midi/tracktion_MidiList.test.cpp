@@ -11,6 +11,7 @@
 #if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_MIDILIST
 
 #include "../utilities/tracktion_TestUtilities.h"
+#include "../../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h"
 
 namespace tracktion { inline namespace engine
 {
@@ -55,6 +56,289 @@ public:
             um->dispatchPendingMessages();
             expect (edit->hasChangedSinceSaved());
         }
+
+        beginTest ("Event indexes");
+        {
+            MidiList list;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                list.addNote (60, BeatPosition::fromBeats (i), 0.5_bd, 127, 0, nullptr);
+                list.addControllerEvent (BeatPosition::fromBeats (i), 1, i, nullptr);
+            }
+
+            // A long note overlaps everything after it
+            auto longNote = list.addNote (62, 10.25_bp, 20_bd, 127, 0, nullptr);
+
+            expect (list.getNoteIndexesOverlapping ({ 25_bp, 27_bp }) == juce::Range<int> (11, 28));
+            expect (list.getControllerEventIndexesIn ({ 25_bp, 27_bp }) == juce::Range<int> (25, 27));
+            expectEquals (list.getControllerEventAt (25.5_bp, 1)->getControllerValue(), 25);
+
+            // Moving and removing events should keep the order
+            longNote->setStartAndLength (50_bp, 1_bd, nullptr);
+            list.removeControllerEvent (*list.getControllerEvent (0), nullptr);
+
+            auto& notes = list.getNotes();
+            expectEquals (notes.size(), 101);
+
+            for (int i = 1; i < notes.size(); ++i)
+                expect (notes[i - 1]->getStartBeat() <= notes[i]->getStartBeat());
+
+            expect (list.getNoteIndexesOverlapping ({ 25_bp, 27_bp }) == juce::Range<int> (25, 27));
+            expect (list.getControllerEventIndexesIn ({ 25_bp, 27_bp }) == juce::Range<int> (24, 26));
+        }
+
+        beginTest ("Paste events");
+        {
+            auto& engine = *Engine::getEngines()[0];
+            auto edit = createTestEdit (engine);
+            auto track = getAudioTracks (*edit)[0];
+            auto mc = insertMIDIClip (*track, { 0_tp, 16_tp });
+
+            Clipboard::MIDIEvents events;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                events.notes.push_back (MidiNote::createNote (MidiNote (createValueTree (IDs::NOTE, IDs::p, 60, IDs::v, 100)),
+                                                              BeatPosition::fromBeats (i * 0.01), 0.01_bd));
+                events.controllers.push_back (MidiControllerEvent::createControllerEvent (BeatPosition::fromBeats (i * 0.01), 1, i % 128));
+            }
+
+            const auto firstNoteState = events.notes.front().createCopy();
+
+            // Pasting twice should add two sets of events without changing the clipboard content
+            for (auto cursor : { 0_tp, 8_tp })
+            {
+                auto [notesAdded, eventsAdded] = events.pasteIntoClip (*mc, {}, {}, cursor, nullptr, -1);
+                expectEquals (notesAdded.size(), 1000);
+                expectEquals (eventsAdded.size(), 1000);
+            }
+
+            expect (events.notes.front().isEquivalentTo (firstNoteState));
+            expect (! events.notes.front().getParent().isValid());
+
+            auto& list = mc->getSequence();
+            expectEquals (list.getNumNotes(), 2000);
+            expectEquals (list.getNumControllerEvents(), 2000);
+
+            for (int i = 1; i < list.getNumNotes(); ++i)
+                expect (list.getNote (i - 1)->getStartBeat() <= list.getNote (i)->getStartBeat());
+        }
+
+        beginTest ("Bulk changes");
+        {
+            MidiList list;
+
+            {
+                const MidiList::ScopedBulkChange bulkChange (list);
+
+                for (int i = 0; i < 1000; ++i)
+                    expect (list.addNote (60, BeatPosition::fromBeats (999 - i), 1_bd, 100, 0, nullptr) != nullptr);
+
+                // Insert one at the start and remove another, both whilst the list is deferring changes
+                list.state.addChild (MidiNote::createNote (MidiNote (createValueTree (IDs::NOTE, IDs::p, 61, IDs::v, 100)), 0.5_bp, 1_bd), 0, nullptr);
+                list.state.removeChild (list.state.getNumChildren() - 1, nullptr);
+            }
+
+            auto& notes = list.getNotes();
+            expectEquals (notes.size(), 1000);
+
+            for (int i = 1; i < notes.size(); ++i)
+                expect (notes[i - 1]->getStartBeat() <= notes[i]->getStartBeat());
+
+            expectEquals (notes[0]->getNoteNumber(), 61);
+            expectEquals (notes[1]->getNoteNumber(), 60);
+            expect (notes[1]->getStartBeat() == 1_bp);
+
+            {
+                const MidiList::ScopedBulkChange bulkChange (list);
+                list.removeAllNotes (nullptr);
+            }
+
+            expectEquals (list.getNumNotes(), 0);
+        }
+
+        beginTest ("Bulk note transforms");
+        {
+            MidiList list;
+            constexpr int numNotes = MidiList::minNumNotesPerThread * 3;
+
+            {
+                const MidiList::ScopedBulkChange bulkChange (list);
+
+                for (int i = 0; i < numNotes; ++i)
+                    list.addNote (60 + i % 12, BeatPosition::fromBeats (i * 0.3), 0.2_bd, 100, 0, nullptr);
+            }
+
+            auto notes = list.getNotes();
+            const auto originalValues = MidiList::getNoteValues (notes);
+
+            QuantisationType q;
+            q.setType ("1/2");
+            q.setIsQuantisingNoteOffs (false);
+            list.quantiseNotes (notes, q, 0_bp, nullptr);
+            list.transposeNotes (notes, 64, nullptr);
+            list.scaleNoteVelocities (notes, 0.5f, nullptr);
+
+            bool allMatch = true;
+
+            for (int i = 0; i < notes.size(); ++i)
+            {
+                auto& n = *notes[i];
+                auto& original = originalValues[(size_t) i];
+
+                allMatch = allMatch
+                            && n.getStartBeat() == q.roundBeatToNearest (original.startBeat)
+                            && n.getLengthBeats() == original.lengthBeats
+                            && n.getNoteNumber() == std::min (127, original.noteNumber + 64)
+                            && n.getVelocity() == 50
+                            && static_cast<double> (n.state[IDs::b]) == n.getStartBeat().inBeats();
+            }
+
+            expect (allMatch);
+
+            auto& sortedNotes = list.getNotes();
+            expectEquals (sortedNotes.size(), numNotes);
+            expect (std::is_sorted (sortedNotes.begin(), sortedNotes.end(),
+                                    [] (auto a, auto b) { return a->getStartBeat() < b->getStartBeat(); }));
+        }
+
+        beginTest ("Bulk note transforms match the note setters");
+        {
+            auto& engine = *Engine::getEngines()[0];
+            auto edit = createTestEdit (engine, 2);
+            juce::MessageManager::getInstance()->runDispatchLoopUntil (20);
+
+            auto& um = edit->getUndoManager();
+            auto tracks = getAudioTracks (*edit);
+
+            // The first two of every three notes start together, and the clip starts part
+            // way through a beat so the content start offset matters when quantising
+            auto createClip = [&] (AudioTrack& track, int numNotes)
+            {
+                auto clip = insertMIDIClip (track, { 0.3_tp, 400_tp });
+                auto& list = clip->getSequence();
+                const MidiList::ScopedBulkChange bulkChange (list);
+
+                for (int i = 0; i < numNotes; ++i)
+                    list.addNote (20 + (i * 7) % 100,
+                                  BeatPosition::fromBeats ((i / 3) * 0.04 + (i % 3 == 2 ? 0.013 : 0.0)),
+                                  BeatDuration::fromBeats (0.01 + (i % 5) * 0.07),
+                                  1 + (i * 13) % 127, 0, nullptr);
+
+                return clip;
+            };
+
+            // The notes' values should match their states and be in order
+            auto expectNotesMatchState = [this] (MidiList& list)
+            {
+                auto& notes = list.getNotes();
+                expectEquals (notes.size(), list.state.getNumChildren());
+
+                bool allMatch = true;
+
+                for (auto n : notes)
+                    allMatch = allMatch
+                                && n->state.getParent() == list.state
+                                && static_cast<double> (n->state[IDs::b]) == n->getStartBeat().inBeats()
+                                && static_cast<double> (n->state[IDs::l]) == n->getLengthBeats().inBeats()
+                                && static_cast<int> (n->state[IDs::p]) == n->getNoteNumber()
+                                && static_cast<int> (n->state[IDs::v]) == n->getVelocity();
+
+                expect (allMatch);
+                expect (std::is_sorted (notes.begin(), notes.end(),
+                                        [] (auto a, auto b) { return a->getStartBeat() < b->getStartBeat(); }));
+            };
+
+            // Changes one clip in bulk and another by calling setNote for each note,
+            // then checks they're the same and that a single undo reverts the bulk change
+            auto expectSameAsNoteSetters = [&] (int numNotes,
+                                                const std::function<void (MidiClip&, const juce::Array<MidiNote*>&)>& transform,
+                                                const std::function<void (MidiClip&, const juce::Array<MidiNote*>&, MidiNote&)>& setNote)
+            {
+                auto bulkClip = createClip (*tracks[0], numNotes);
+                auto noteClip = createClip (*tracks[1], numNotes);
+                auto& bulkList = bulkClip->getSequence();
+                auto& noteList = noteClip->getSequence();
+                const auto originalState = bulkList.state.createCopy();
+
+                um.beginNewTransaction();
+                transform (*bulkClip, juce::Array<MidiNote*> (bulkList.getNotes()));
+
+                {
+                    const auto notes = noteList.getNotes();
+
+                    for (auto n : notes)
+                        setNote (*noteClip, notes, *n);
+                }
+
+                expect (! bulkList.state.isEquivalentTo (originalState));
+                expect (bulkList.state.isEquivalentTo (noteList.state));
+                expectNotesMatchState (bulkList);
+
+                um.undo();
+                expect (bulkList.state.isEquivalentTo (originalState));
+                expectNotesMatchState (bulkList);
+
+                bulkClip->removeFromParent();
+                noteClip->removeFromParent();
+            };
+
+            constexpr int numNotes = MidiList::minNumNotesPerThread * 2;
+
+            QuantisationType q;
+            q.setType ("1/16 beat");
+            q.setIsQuantisingNoteOffs (true);
+
+            expectSameAsNoteSetters (numNotes,
+                                     [&] (MidiClip& clip, const juce::Array<MidiNote*>& notes)
+                                     {
+                                         const CompactUndoableChange change (*edit, clip.getSequence().state, notes.size());
+                                         expect (change.isCompacting());
+                                         clip.getSequence().quantiseNotes (notes, q, clip.getContentStartBeat(), change.getUndoManager());
+                                     },
+                                     [&] (MidiClip& clip, const juce::Array<MidiNote*>&, MidiNote& n)
+                                     {
+                                         const auto offset = toDuration (clip.getContentStartBeat());
+                                         const auto start = q.roundBeatToNearest (n.getStartBeat() + offset) - offset;
+                                         const auto end = q.roundBeatToNearest (n.getEndBeat() + offset) - offset;
+                                         n.setStartAndLength (start, end > start ? end - start : n.getLengthBeats(), nullptr);
+                                     });
+
+            expectSameAsNoteSetters (numNotes,
+                                     [&] (MidiClip& clip, const juce::Array<MidiNote*>& notes)
+                                     {
+                                         clip.getSequence().transposeNotes (notes, 40, &um);
+                                     },
+                                     [] (MidiClip&, const juce::Array<MidiNote*>&, MidiNote& n)
+                                     {
+                                         n.setNoteNumber (n.getNoteNumber() + 40, nullptr);
+                                     });
+
+            expectSameAsNoteSetters (numNotes,
+                                     [&] (MidiClip& clip, const juce::Array<MidiNote*>& notes)
+                                     {
+                                         const CompactUndoableChange change (*edit, clip.getSequence().state, notes.size());
+                                         clip.getSequence().scaleNoteVelocities (notes, 1.7f, change.getUndoManager());
+                                     },
+                                     [] (MidiClip&, const juce::Array<MidiNote*>&, MidiNote& n)
+                                     {
+                                         n.setVelocity (juce::jlimit (1, 127, juce::roundToInt ((float) n.getVelocity() * 1.7f)), nullptr);
+                                     });
+
+            // legatoNote searches the array for every note so this uses fewer notes
+            juce::UndoManager legatoUndoManager;
+
+            expectSameAsNoteSetters (3000,
+                                     [&] (MidiClip& clip, const juce::Array<MidiNote*>& notes)
+                                     {
+                                         clip.legatoNotes (notes, 300_bp, um);
+                                     },
+                                     [&] (MidiClip& clip, const juce::Array<MidiNote*>& notes, MidiNote& n)
+                                     {
+                                         clip.legatoNote (n, notes, 300_bp, legatoUndoManager);
+                                     });
+        }
     }
 };
 
@@ -99,18 +99,17 @@ namespace BezierHelpers
 }
 
 //==============================================================================
-struct BreakpointOscillatorModifier::BreakpointOscillatorModifierTimer    : public ModifierTimer
+struct BreakpointOscillatorModifier::BreakpointOscillatorModifierTimer    : public ControlRateModifierTimer
 {
     BreakpointOscillatorModifierTimer (BreakpointOscillatorModifier& bom)
-        : modifier (bom)
+        : ControlRateModifierTimer (bom), modifier (bom)
     {
     }
 
-    void updateStreamTime (TimePosition editTime, int numSamples) override
+    void evaluate (TimePosition editTime, int numSamples) override
     {
         using namespace ModifierCommon;
         const double blockLength = numSamples / modifier.getSampleRate();
-        modifier.setEditTime (editTime);
         modifier.updateParameterStreams (editTime);
 
         const auto syncTypeThisBlock = getTypedParamValue<SyncType> (*modifier.syncTypeParam);
@@ -164,7 +163,7 @@ struct BreakpointOscillatorModifier::BreakpointOscillatorModifierTimer    : publ
         }
     }
 
-    void resync (double duration)
+    void evaluateResync (double duration) override
     {
         if (juce::roundToInt (modifier.syncTypeParam->getCurrentValue()) == ModifierCommon::note)
         {
@@ -176,6 +175,14 @@ struct BreakpointOscillatorModifier::BreakpointOscillatorModifierTimer    : publ
         }
     }
 
+    void publishValues (TimePosition editTime) override
+    {
+        modifier.setEditTime (editTime);
+        modifier.currentPhase.store (modifier.evaluatedPhase, std::memory_order_release);
+        modifier.currentEnvelopeValue.store (modifier.evaluatedEnvelopeValue, std::memory_order_release);
+        modifier.currentValue.store (modifier.evaluatedValue, std::memory_order_release);
+    }
+
     BreakpointOscillatorModifier& modifier;
     Ramp ramp;
     tempo::Sequence::Position tempoSequence { createPosition (modifier.edit.tempoSequence) };
@@ -419,7 +426,7 @@ void BreakpointOscillatorModifier::setPhase (float newPhase)
 
     using namespace BreakpointInterpolation;
     jassert (juce::isPositiveAndBelow (newPhase, 1.0f));
-    currentPhase.store (newPhase, std::memory_order_release);
+    evaluatedPhase = newPhase;
 
     const float totalTime = getTotalTime();
     float timeForPhase = totalTime * newPhase;
@@ -436,7 +443,7 @@ void BreakpointOscillatorModifier::setPhase (float newPhase)
     else
         newValue = quadraticInterpolate (timeForPhase, { s1.time, s1.value }, { s2.time, s2.value }, curve);
 
-    currentEnvelopeValue.store (newValue, std::memory_order_release);
+    evaluatedEnvelopeValue = newValue;
 
     newValue = newValue * depthParam->getCurrentValue();
 
@@ -444,7 +451,7 @@ void BreakpointOscillatorModifier::setPhase (float newPhase)
         newValue = (newValue * 2.0f) - 1.0f;
 
     jassert (! std::isnan (newValue));
-    currentValue.store (newValue, std::memory_order_release);
+    evaluatedValue = newValue;
 }
 
 void BreakpointOscillatorModifier::valueTreeChanged()
@@ -88,6 +88,7 @@ private:
     std::unique_ptr<BreakpointOscillatorModifierTimer> modifierTimer;
     LambdaTimer changedTimer;
     std::atomic<float> currentPhase { 1.0f }, currentValue { 0.0f }, currentEnvelopeValue { 0.0f };
+    float evaluatedPhase = 1.0f, evaluatedValue = 0.0f, evaluatedEnvelopeValue = 0.0f;
 
     struct Section { float value = 0.0f, time = 0.0f, curve = 0.0f; };
     std::array<Section, 5> getAllSections() const;
@@ -11,17 +11,16 @@
 namespace tracktion { inline namespace engine
 {
 
-struct LFOModifier::LFOModifierTimer    : public ModifierTimer
+struct LFOModifier::LFOModifierTimer    : public ControlRateModifierTimer
 {
     LFOModifierTimer (LFOModifier& lfo)
-        : modifier (lfo)
+        : ControlRateModifierTimer (lfo), modifier (lfo)
     {
     }
 
-    void updateStreamTime (TimePosition editTime, int numSamples) override
+    void evaluate (TimePosition editTime, int numSamples) override
     {
         const double blockLength = numSamples / modifier.getSampleRate();
-        modifier.setEditTime (editTime);
         modifier.updateParameterStreams (editTime);
 
         const auto syncTypeThisBlock = juce::roundToInt (modifier.syncTypeParam->getCurrentValue());
@@ -83,7 +82,7 @@ struct LFOModifier::LFOModifierTimer    : public ModifierTimer
         while (newPhase >= 1.0f)    newPhase -= 1.0f;
         while (newPhase < 0.0f)     newPhase += 1.0f;
 
-        if (newPhase < modifier.getCurrentPhase())
+        if (newPhase < phase)
         {
             previousRandom = currentRandom;
             currentRandom = rand.nextFloat();
@@ -91,7 +90,7 @@ struct LFOModifier::LFOModifierTimer    : public ModifierTimer
         }
 
         jassert (juce::isPositiveAndBelow (newPhase, 1.0f));
-        modifier.currentPhase.store (newPhase, std::memory_order_release);
+        phase = newPhase;
 
         auto getValue = [this, newPhase]
         {
@@ -121,10 +120,10 @@ struct LFOModifier::LFOModifierTimer    : public ModifierTimer
         if (getBoolParamValue (*modifier.bipolarParam))
             newValue = (newValue * 2.0f) - 1.0f;
 
-        modifier.currentValue.store (newValue, std::memory_order_release);
+        value = newValue;
     }
 
-    void resync (double duration)
+    void evaluateResync (double duration) override
     {
         const auto type = juce::roundToInt (modifier.syncTypeParam->getCurrentValue());
 
@@ -138,8 +137,16 @@ struct LFOModifier::LFOModifierTimer    : public ModifierTimer
         }
     }
 
+    void publishValues (TimePosition editTime) override
+    {
+        modifier.setEditTime (editTime);
+        modifier.currentPhase.store (phase, std::memory_order_release);
+        modifier.currentValue.store (value, std::memory_order_release);
+    }
+
     LFOModifier& modifier;
     Ramp ramp;
+    float phase = 0.0f, value = 0.0f;
     tempo::Sequence::Position tempoSequence { createPosition (modifier.edit.tempoSequence) };
 
     juce::Random rand;
@@ -11,17 +11,16 @@
 namespace tracktion { inline namespace engine
 {
 
-struct RandomModifier::RandomModifierTimer    : public ModifierTimer
+struct RandomModifier::RandomModifierTimer    : public ControlRateModifierTimer
 {
     RandomModifierTimer (RandomModifier& rm)
-        : modifier (rm)
+        : ControlRateModifierTimer (rm), modifier (rm)
     {
     }
 
-    void updateStreamTime (TimePosition editTime, int numSamples) override
+    void evaluate (TimePosition editTime, int numSamples) override
     {
         const double blockLength = numSamples / modifier.getSampleRate();
-        modifier.setEditTime (editTime);
         modifier.updateParameterStreams (editTime);
 
         const auto syncTypeThisBlock = juce::roundToInt (modifier.syncTypeParam->getCurrentValue());
@@ -76,7 +75,7 @@ struct RandomModifier::RandomModifierTimer    : public ModifierTimer
         }
     }
 
-    void resync (double duration)
+    void evaluateResync (double duration) override
     {
         if (juce::roundToInt (modifier.syncTypeParam->getCurrentValue()) == ModifierCommon::note)
         {
@@ -88,6 +87,13 @@ struct RandomModifier::RandomModifierTimer    : public ModifierTimer
         }
     }
 
+    void publishValues (TimePosition editTime) override
+    {
+        modifier.setEditTime (editTime);
+        modifier.currentPhase.store (modifier.evaluatedPhase, std::memory_order_release);
+        modifier.currentValue.store (modifier.evaluatedValue, std::memory_order_release);
+    }
+
     RandomModifier& modifier;
     Ramp ramp;
     tempo::Sequence::Position tempoSequence { createPosition (modifier.edit.tempoSequence) };
@@ -242,7 +248,7 @@ void RandomModifier::setPhase (float newPhase)
     while (newPhase >= 1.0f)    newPhase -= 1.0f;
     while (newPhase < 0.0f)     newPhase += 1.0f;
 
-    if (newPhase < getCurrentPhase())
+    if (newPhase < evaluatedPhase)
     {
         previousRandom = currentRandom;
 
@@ -257,7 +263,7 @@ void RandomModifier::setPhase (float newPhase)
     }
 
     jassert (juce::isPositiveAndBelow (newPhase, 1.0f));
-    currentPhase.store (newPhase, std::memory_order_release);
+    evaluatedPhase = newPhase;
 
     auto newValue = [this, newPhase, shapeVal = shapeParam->getCurrentValue()]
     {
@@ -271,7 +277,7 @@ void RandomModifier::setPhase (float newPhase)
 
     newValue *= depthParam->getCurrentValue();
 
-    currentValue.store (newValue, std::memory_order_release);
+    evaluatedValue = newValue;
 }
 
 void RandomModifier::valueTreeChanged()
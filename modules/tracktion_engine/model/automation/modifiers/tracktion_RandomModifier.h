@@ -77,6 +77,7 @@ private:
     juce::Random rand;
     LambdaTimer changedTimer;
     std::atomic<float> currentPhase { 1.0f }, currentValue { 0.0f };
+    float evaluatedPhase = 1.0f, evaluatedValue = 0.0f;
     float previousRandom = 0.0f, currentRandom = 0.0f, randomDifference = 0.0f;
 
     void setPhase (float newPhase);
@@ -11,17 +11,16 @@
 namespace tracktion { inline namespace engine
 {
 
-struct StepModifier::StepModifierTimer : public ModifierTimer
+struct StepModifier::StepModifierTimer : public ControlRateModifierTimer
 {
     StepModifierTimer (StepModifier& sm)
-        : modifier (sm)
+        : ControlRateModifierTimer (sm), modifier (sm)
     {
     }
 
-    void updateStreamTime (TimePosition editTime, int numSamples) override
+    void evaluate (TimePosition editTime, int numSamples) override
     {
         const double blockLength = numSamples / modifier.getSampleRate();
-        modifier.setEditTime (editTime);
         modifier.updateParameterStreams (editTime);
 
         const auto syncTypeThisBlock = juce::roundToInt (modifier.syncTypeParam->getCurrentValue());
@@ -38,8 +37,7 @@ struct StepModifier::StepModifierTimer : public ModifierTimer
             if (syncTypeThisBlock == ModifierCommon::transport)
                 ramp.setPosition (std::fmod ((float) editTime.inSeconds(), durationPerPattern));
 
-            const int step = static_cast<int> (std::floor (numStepsThisBlock * ramp.getProportion()));
-            modifier.currentStep.store (step, std::memory_order_release);
+            step = static_cast<int> (std::floor (numStepsThisBlock * ramp.getProportion()));
 
             // Move the ramp on for the next block
             ramp.process ((float) blockLength);
@@ -59,8 +57,7 @@ struct StepModifier::StepModifierTimer : public ModifierTimer
                 if (rateTypeThisBlock >= ModifierCommon::fourBars && rateTypeThisBlock <= ModifierCommon::sixtyFourthD)
                 {
                     const double virtualBars = bars / proportionOfBar;
-                    const int step = static_cast<int> (std::fmod (virtualBars, numStepsThisBlock));
-                    modifier.currentStep.store (step, std::memory_order_release);
+                    step = static_cast<int> (std::fmod (virtualBars, numStepsThisBlock));
                 }
             }
             else
@@ -71,8 +68,7 @@ struct StepModifier::StepModifierTimer : public ModifierTimer
                 const float secondsPerPattern = (numStepsThisBlock * secondsPerStep);
                 ramp.setDuration (secondsPerPattern);
 
-                const int step = static_cast<int> (std::floor (numStepsThisBlock * ramp.getProportion()));
-                modifier.currentStep.store (step, std::memory_order_release);
+                step = static_cast<int> (std::floor (numStepsThisBlock * ramp.getProportion()));
 
                 // Move the ramp on for the next block
                 ramp.process ((float) blockLength);
@@ -80,22 +76,29 @@ struct StepModifier::StepModifierTimer : public ModifierTimer
         }
     }
 
-    void resync (double duration)
+    void evaluateResync (double duration) override
     {
         const auto type = juce::roundToInt (modifier.syncTypeParam->getCurrentValue());
 
         if (type == ModifierCommon::note)
         {
             ramp.setPosition (0.0f);
-            modifier.currentStep.store (0, std::memory_order_release);
+            step = 0;
 
             // Move the ramp on for the next block
             ramp.process ((float) duration);
         }
     }
 
+    void publishValues (TimePosition editTime) override
+    {
+        modifier.setEditTime (editTime);
+        modifier.currentStep.store (step, std::memory_order_release);
+    }
+
     StepModifier& modifier;
     Ramp ramp;
+    int step = 0;
     tempo::Sequence::Position tempoSequence { createPosition (modifier.edit.tempoSequence) };
 };
 
@@ -27,6 +27,9 @@ AutomatableEditItem::~AutomatableEditItem()
 //==============================================================================
 void AutomatableEditItem::flushPluginStateToValueTree()
 {
+    for (auto ap : automatableParams)
+        ap->flushPendingStateUpdate();
+
     saveChangedParametersToState();
 }
 
@@ -60,6 +63,9 @@ AutomatableParameter::Ptr AutomatableEditItem::getAutomatableParameterByID (cons
 
 void AutomatableEditItem::deleteParameter (AutomatableParameter* p)
 {
+    if (p != nullptr)
+        removeActiveParameter (*p);
+
     automatableParams.removeObject (p);
     rebuildParameterTree();
 }
@@ -151,9 +157,8 @@ void AutomatableEditItem::updateAutomatableParamPosition (TimePosition time)
     if (! isAutomationNeeded())
         return;
 
-    for (auto p : automatableParams)
-        if (p->isAutomationActive())
-            p->updateToFollowCurve (time);
+    for (auto p : getActiveParameters())
+        p->updateToFollowCurve (time);
 }
 
 void AutomatableEditItem::updateParameterStreams (TimePosition time)
@@ -172,7 +177,9 @@ void AutomatableEditItem::resetRecordingStatus()
 
 void AutomatableEditItem::updateStreamIterators()
 {
-    for (auto p : automatableParams)
+    // Parameters without any automation become active as soon as a curve gets
+    // points or a source is added, so only the active ones can have streams to update
+    for (auto p : getActiveParameters())
         p->updateStream();
 }
 
@@ -258,6 +265,16 @@ void AutomatableEditItem::updateLastPlaybackTime()
 void AutomatableEditItem::clearParameterList()
 {
     automatableParams.clear();
+
+    {
+        juce::ReferenceCountedArray<AutomatableParameter> nowActiveParams;
+
+        {
+            const std::scoped_lock sl (activeParameterLock);
+            std::swap (activeParameters, nowActiveParams);
+        }
+    }
+
     rebuildParameterTree();
 }
 
@@ -299,6 +316,25 @@ bool AutomatableEditItem::isActiveParameter (AutomatableParameter& p)
     return activeParameters.contains (p);
 }
 
+juce::ReferenceCountedArray<AutomatableParameter> AutomatableEditItem::getActiveParameters() const
+{
+    // The copy is taken under the lock as updating a parameter can add or remove active ones
+    juce::ReferenceCountedArray<AutomatableParameter> params;
+    int numParams = 0;
+
+    {
+        const std::scoped_lock sl (activeParameterLock);
+        numParams = activeParameters.size();
+    }
+
+    params.ensureStorageAllocated (numParams);
+
+    const std::scoped_lock sl (activeParameterLock);
+    params.addArray (activeParameters);
+
+    return params;
+}
+
 void AutomatableEditItem::saveChangedParametersToState()
 {
     juce::MemoryOutputStream stream;
@@ -58,7 +58,8 @@ public:
     // true if it's not been more than a few hundred ms since a block was processed
     bool isBeingActivelyPlayed() const;
 
-    /** Updates all the auto params to their positions at this time.
+    /** Updates all the automated params to their positions at this time.
+        Only parameters with active automation are visited.
         [[ message_thread ]]
     */
     virtual void updateAutomatableParamPosition (TimePosition);
@@ -101,7 +102,7 @@ protected:
     void restoreChangedParametersFromState();
 
 private:
-    RealTimeSpinLock activeParameterLock;
+    mutable RealTimeSpinLock activeParameterLock;
     juce::ReferenceCountedArray<AutomatableParameter> automatableParams, activeParameters;
     mutable AutomatableParameterTree parameterTree;
 
@@ -124,6 +125,7 @@ private:
 
     //==============================================================================
     juce::ReferenceCountedArray<AutomatableParameter> getFlattenedParameterTree (AutomatableParameterTree::TreeNode&) const;
+    juce::ReferenceCountedArray<AutomatableParameter> getActiveParameters() const;
 
     JUCE_DECLARE_WEAK_REFERENCEABLE (AutomatableEditItem)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomatableEditItem)
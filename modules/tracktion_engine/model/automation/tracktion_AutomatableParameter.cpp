@@ -117,6 +117,25 @@ struct AutomationSource  : public juce::ReferenceCountedObject
         modValue += currentModValue;
     }
 
+    /** The most values addValues will be asked for at once. */
+    static constexpr int maxNumValuesToAdd = 64;
+
+    /** Should return true if addValues can be used to add this source's values sample by sample. */
+    virtual bool canAddValues() const
+    {
+        return false;
+    }
+
+    /** Is called during processing to add the source's values for a run of samples to
+        modValues, in the same way processValue adds the current value.
+        The first value is a number of samples after the last position set.
+        Only called if canAddValues returns true.
+    */
+    virtual void addValues (int /*startSample*/, float* /*modValues*/, int /*numValues*/)
+    {
+        jassertfalse;
+    }
+
     juce::ValueTree state;
 };
 
@@ -176,12 +195,156 @@ struct ModifierAutomationSource : public AutomationModifierSource
         return AutomationScaleHelpers::mapValue (baseValue, assignment->offset, assignment->value, assignment->curve);
     }
 
+    bool canAddValues() const override
+    {
+        return true;
+    }
+
+    void addValues (int startSample, float* modValues, int numValues) override
+    {
+        jassert (numValues <= maxNumValuesToAdd);
+        float values[maxNumValuesToAdd];
+
+        // Reads the values the Modifier stored when it was processed rather than evaluating it again
+        const auto startTime = editTimeToReturn + TimeDuration::fromSamples (startSample, modifier->getSampleRate());
+        const auto deltaTime = modifier->getCurrentTime() - startTime;
+
+        if (deltaTime > 0s && deltaTime < Modifier::maxHistoryTime)
+            modifier->copyValues (deltaTime, values, numValues);
+        else
+            juce::FloatVectorOperations::fill (values, modifier->getCurrentValue(), numValues);
+
+        const float offset = assignment->offset, value = assignment->value, curve = assignment->curve;
+
+        if (curve == 0.0f)
+        {
+            // A linear mapping is just a gain and offset
+            juce::FloatVectorOperations::addWithMultiply (modValues, values, value, numValues);
+            juce::FloatVectorOperations::add (modValues, offset, numValues);
+        }
+        else
+        {
+            for (int i = 0; i < numValues; ++i)
+                modValues[i] += AutomationScaleHelpers::mapValue (values[i], offset, value, curve);
+        }
+    }
+
     const Modifier::Ptr modifier;
     TimePosition editTimeToReturn;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModifierAutomationSource)
 };
 
+//==============================================================================
+/**
+    Publishes snapshots of an AutomationCurve from the message thread to be read
+    on the audio thread.
+
+    New snapshots are swapped in without blocking so building one never holds up
+    playback. Readers are serialised by a spin lock which also guards the cursor.
+*/
+class AutomationCurveStream
+{
+public:
+    AutomationCurveStream (Edit& edit)
+        : tempoSequence (edit.tempoSequence.getInternalSequence())
+    {
+    }
+
+    /** Takes a new snapshot of the curve, returning true if it has enough points to be used. */
+    bool update (const AutomationCurve& curve)
+    {
+        AutomationCurveSnapshot newSnapshot;
+
+        if (curve.getNumPoints() > 0)
+            newSnapshot = AutomationCurveSnapshot (curve);
+
+        const bool isUsable = ! newSnapshot.isEmpty();
+        snapshot.pushNonRealTime (std::move (newSnapshot));
+        active.store (isUsable, std::memory_order_relaxed);
+
+        {
+            const std::lock_guard sl (readerLock);
+            constantRange = {};
+        }
+
+        return isUsable;
+    }
+
+    bool isActive() const noexcept
+    {
+        return active.load (std::memory_order_relaxed);
+    }
+
+    void setPosition (EditPosition position) noexcept
+    {
+        const std::lock_guard sl (readerLock);
+        auto access = snapshot.getScopedAccess();
+
+        if (auto s = access.get(); s != nullptr && ! s->isEmpty())
+        {
+            const auto curvePosition = s->toCurvePosition (position, tempoSequence);
+            currentValue.store (s->getValueAt (curvePosition, cursor), std::memory_order_relaxed);
+
+            const auto time = toTime (position, tempoSequence);
+            constantRange = { time, std::max (time, getEndTime (*s, s->getEndOfConstantValue (curvePosition, cursor))) };
+        }
+    }
+
+    float getCurrentValue() const noexcept
+    {
+        return currentValue.load (std::memory_order_relaxed);
+    }
+
+    /** Returns true if the value is known to be the same at this time as at the last position set. */
+    bool isValueConstantAt (TimePosition time) noexcept
+    {
+        const std::lock_guard sl (readerLock);
+        return constantRange.getStart() <= time && time < constantRange.getEnd();
+    }
+
+    /** Fills a buffer with values at evenly spaced positions through a range of the Edit.
+        Returns false if there isn't a usable snapshot, in which case the buffer is untouched.
+    */
+    bool getValues (TimeRange range, float* dest, int numValues) noexcept
+    {
+        const std::lock_guard sl (readerLock);
+        auto access = snapshot.getScopedAccess();
+        auto s = access.get();
+
+        if (s == nullptr || s->isEmpty())
+            return false;
+
+        if (numValues > 0)
+        {
+            const auto start = s->toCurvePosition (range.getStart(), tempoSequence);
+            const auto delta = std::max (0.0, (s->toCurvePosition (range.getEnd(), tempoSequence) - start) / numValues);
+            s->getValues (start, delta, dest, numValues, cursor);
+        }
+
+        return true;
+    }
+
+private:
+    const tempo::Sequence& tempoSequence;
+    LockFreeObject<AutomationCurveSnapshot> snapshot;
+    RealTimeSpinLock readerLock;
+    AutomationCurveSnapshot::Cursor cursor;
+    TimeRange constantRange;
+    std::atomic<float> currentValue { 0.0f };
+    std::atomic<bool> active { false };
+
+    TimePosition getEndTime (const AutomationCurveSnapshot& s, double curvePosition) const
+    {
+        if (s.timeBase == AutomationCurve::TimeBase::time || std::isinf (curvePosition))
+            return TimePosition::fromSeconds (curvePosition);
+
+        return toTime (BeatPosition::fromBeats (curvePosition), tempoSequence);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (AutomationCurveStream)
+};
+
 //==============================================================================
 class AutomationCurveSource : public AutomationSource
 {
@@ -227,7 +390,7 @@ public:
 
     bool isActive() const noexcept
     {
-        return automationActive.load (std::memory_order_relaxed);
+        return stream.isActive();
     }
 
     float getValueAt (TimePosition time) override
@@ -248,10 +411,8 @@ public:
                 if (! plugin->isClipEffectPlugin())
                     return;
 
-        const juce::ScopedLock sl (parameterStreamLock);
-
         if (lastTime.exchange (time) != time)
-            parameterStream->setPosition (time);
+            stream.setPosition (time);
     }
 
     bool isEnabled() override
@@ -261,8 +422,26 @@ public:
 
     float getCurrentValue() override
     {
-        const juce::ScopedLock sl (parameterStreamLock);
-        return parameterStream->getCurrentValue();
+        return stream.getCurrentValue();
+    }
+
+    /** Returns true if the curve's value is known to be the same at this time as at the last position set. */
+    bool isValueConstantAt (TimePosition time) noexcept
+    {
+        return stream.isValueConstantAt (time);
+    }
+
+    /** Fills a buffer with the curve's values over a range of the Edit.
+        Returns false if the curve isn't being read, in which case the buffer is untouched.
+    */
+    bool getValues (TimeRange range, float* dest, int numValues)
+    {
+        if (! parameter.getEdit().getAutomationRecordManager().isReadingAutomation())
+            if (auto plugin = parameter.getPlugin())
+                if (! plugin->isClipEffectPlugin())
+                    return false;
+
+        return stream.getValues (range, dest, numValues);
     }
 
     AutomatableParameter& parameter;
@@ -270,9 +449,7 @@ public:
 
 private:
     LambdaTimer deferredUpdateTimer;
-    juce::CriticalSection parameterStreamLock;
-    std::unique_ptr<AutomationIterator> parameterStream;
-    std::atomic<bool> automationActive { false };
+    AutomationCurveStream stream { parameter.getEdit() };
     std::atomic<TimePosition> lastTime { TimePosition::fromSeconds (-1.0) };
     std::unique_ptr<AutomatableParameter::ScopedActiveParameter> scopedActiveParameter;
 
@@ -285,36 +462,20 @@ private:
         if (! editLoading)
             TRACKTION_ASSERT_MESSAGE_THREAD
 
-        std::unique_ptr<AutomationIterator> newStream;
-
-        if (curve.getNumPoints() > 0)
+        if (stream.update (curve))
         {
-            auto s = std::make_unique<AutomationIterator> (parameter);
-
-            if (! s->isEmpty())
-                newStream = std::move (s);
+            auto activeParam = std::make_unique<AutomatableParameter::ScopedActiveParameter> (parameter);
+            std::swap (scopedActiveParameter, activeParam);
         }
-
+        else
         {
-            const juce::ScopedLock sl (parameterStreamLock);
-            automationActive.store (newStream != nullptr, std::memory_order_relaxed);
-            parameterStream = std::move (newStream);
-
-            if (parameterStream)
-            {
-                auto activeParam = std::make_unique<AutomatableParameter::ScopedActiveParameter> (parameter);
-                std::swap (scopedActiveParameter, activeParam);
-            }
-            else
-            {
-                scopedActiveParameter.reset();
-
-                if (! editLoading)
-                    parameter.updateToFollowCurve (lastTime);
-            }
+            scopedActiveParameter.reset();
 
-            lastTime = -1.0s;
+            if (! editLoading)
+                parameter.updateToFollowCurve (lastTime);
         }
+
+        lastTime = -1.0s;
     }
 
     static juce::ValueTree getState (AutomatableParameter& ap)
@@ -537,28 +698,24 @@ private:
         AutomatableParameter& parameter;
         AutomationCurveModifier::CurveInfo curveInfo;
         std::shared_ptr<AutomationCurvePlayhead> playhead { curveModifier.getPlayhead (curveInfo.type) };
-        std::unique_ptr<AutomationIterator> parameterStream;
-        juce::CriticalSection parameterStreamLock;
-        std::atomic<bool> automationActive { false };
+        AutomationCurveStream stream { curveInfo.curve.edit };
 
         bool isActive() const
         {
-            return automationActive.load (std::memory_order_relaxed);
+            return stream.isActive();
         }
 
         bool setPosition (TimePosition editTime)
         {
-            const juce::ScopedLock sl (parameterStreamLock);
-
-            if (parameterStream)
+            if (isActive())
             {
                 auto modifiedPos = editPositionToCurvePosition (curveModifier, curveInfo.type, editTime);
                 playhead->position.store (modifiedPos);
 
                 if (modifiedPos)
                 {
-                    parameterStream->setPosition (toTime (*modifiedPos,
-                                                  getTempoSequence (curveModifier).getInternalSequence()));
+                    stream.setPosition (toTime (*modifiedPos,
+                                                getTempoSequence (curveModifier).getInternalSequence()));
                     return true;
                 }
             }
@@ -568,10 +725,8 @@ private:
 
         float getCurrentValue()
         {
-            const juce::ScopedLock sl (parameterStreamLock);
-
-            if (parameterStream)
-                return parameterStream->getCurrentValue();
+            if (isActive())
+                return stream.getCurrentValue();
 
             return 0.0f;
         }
@@ -581,21 +736,7 @@ private:
             CRASH_TRACER
             TRACKTION_ASSERT_MESSAGE_THREAD
 
-            std::unique_ptr<AutomationIterator> newStream;
-
-            if (curveInfo.curve.getNumPoints() > 0)
-            {
-                auto s = std::make_unique<AutomationIterator> (curveInfo.curve.edit, curveInfo.curve);
-
-                if (! s->isEmpty())
-                    newStream = std::move (s);
-            }
-
-            {
-                const juce::ScopedLock sl (parameterStreamLock);
-                automationActive.store (newStream != nullptr, std::memory_order_relaxed);
-                parameterStream = std::move (newStream);
-            }
+            stream.update (curveInfo.curve);
         }
 
         void processValue (float& baseValue, float& modValue)
@@ -690,6 +831,11 @@ struct AutomatableParameter::AutomationSourceList  : private ValueTreeObjectList
                 f (*as);
     }
 
+    bool hasSources() const noexcept
+    {
+        return cachedSources != nullptr;
+    }
+
     juce::ReferenceCountedObjectPtr<AutomationModifierSource> getSourceFor (ModifierAssignment& ass)
     {
         TRACKTION_ASSERT_MESSAGE_THREAD
@@ -858,12 +1004,50 @@ private:
 };
 
 //==============================================================================
-struct AutomatableParameter::AttachedValue  : public juce::AsyncUpdater
+struct AutomatableParameter::AttachedValue  : public juce::AsyncUpdater,
+                                              private juce::Timer
 {
     AttachedValue (AutomatableParameter& p)
         : parameter (p) {}
 
-    virtual ~AttachedValue() { cancelPendingUpdate(); }
+    virtual ~AttachedValue() { cancelPendingUpdate(); stopTimer(); }
+
+    /** Sets the value straight away, or if an interval is given and the value was
+        set less than the interval ago, the next time the interval elapses.
+    */
+    void setValueThrottled (float v, int intervalMs)
+    {
+        if (intervalMs > 0 && isTimerRunning())
+        {
+            pendingValue = v;
+            return;
+        }
+
+        setValue (v);
+
+        if (intervalMs > 0)
+            startTimer (intervalMs);
+    }
+
+    /** Sets any value that's waiting for the interval to elapse. */
+    void flushPendingValue()
+    {
+        stopTimer();
+
+        if (auto v = std::exchange (pendingValue, std::nullopt))
+            setValue (*v);
+    }
+
+    /** Returns true if the value has been set recently and further values are being throttled. */
+    bool isThrottling() const   { return isTimerRunning(); }
+
+    void timerCallback() override
+    {
+        if (auto v = std::exchange (pendingValue, std::nullopt))
+            setValue (*v);
+        else
+            stopTimer();
+    }
 
     virtual void setValue (float v) = 0;
     virtual float getValue() = 0;
@@ -873,6 +1057,7 @@ struct AutomatableParameter::AttachedValue  : public juce::AsyncUpdater
     virtual void updateParameterFromValue() = 0;
 
     AutomatableParameter& parameter;
+    std::optional<float> pendingValue;
 };
 
 struct AutomatableParameter::AttachedFloatValue : public AutomatableParameter::AttachedValue
@@ -1169,14 +1354,24 @@ void AutomatableParameter::updateFromAutomationSources (TimePosition time)
     if (updateParametersRecursionCheck)
         return;
 
+    // If the curve is flat here and nothing else has changed the value there's nothing to update
+    if (isBaseValueFollowingCurve
+        && currentBaseValue.load() == baseValueFromLastUpdate.load()
+        && curveSource->isValueConstantAt (time)
+        && curveSource->isEnabledAt (time)
+        && ! isCurrentlyRecording()
+        && ! getAutomationSourceList().hasSources())
+        return;
+
     const juce::ScopedValueSetter<bool> svs (updateParametersRecursionCheck, true);
 
     float newModifierValue = 0.0f;
-    float newBaseValue = [this, time]
+    const bool isFollowingCurve = curveSource->isActive()
+                                    && curveSource->isEnabledAt (time)
+                                    && ! isCurrentlyRecording();
+    float newBaseValue = [this, time, isFollowingCurve]
                          {
-                             if (curveSource->isActive()
-                                 && curveSource->isEnabledAt (time)
-                                 && ! isCurrentlyRecording())
+                             if (isFollowingCurve)
                              {
                                  curveSource->setPosition (time);
                                  return curveSource->getCurrentValue();
@@ -1184,16 +1379,28 @@ void AutomatableParameter::updateFromAutomationSources (TimePosition time)
 
                              return currentParameterValue.load();
                          }();
+    const auto curveValue = newBaseValue;
+    int numEnabledSources = 0, numSourcesWithValues = 0;
 
     getAutomationSourceList()
-        .visitSources ([&newBaseValue, &newModifierValue, time] (AutomationSource& m) mutable
+        .visitSources ([&newBaseValue, &newModifierValue, &numEnabledSources, &numSourcesWithValues, time] (AutomationSource& m) mutable
                        {
                            m.setPosition (time);
 
                            if (m.isEnabled())
+                           {
                                m.processValue (newBaseValue, newModifierValue);
+                               ++numEnabledSources;
+
+                               if (m.canAddValues())
+                                   ++numSourcesWithValues;
+                           }
                        });
 
+    // Absolute curve modifiers replace the base value so it won't follow the curve
+    isBaseValueFollowingCurve = isFollowingCurve && newBaseValue == curveValue;
+    canAddModifierValuesPerSample = numEnabledSources > 0 && numSourcesWithValues == numEnabledSources;
+
     if (newModifierValue != 0.0f)
     {
         auto normalisedBase = valueRange.convertTo0to1 (newBaseValue);
@@ -1205,6 +1412,62 @@ void AutomatableParameter::updateFromAutomationSources (TimePosition time)
     }
 
     setParameterValue (newBaseValue, true);
+    baseValueFromLastUpdate = currentBaseValue.load();
+}
+
+bool AutomatableParameter::getValuesForBlock (TimeRange editTime, float* dest, int numSamples)
+{
+    if (numSamples <= 0 || isDiscrete())
+        return false;
+
+    const bool addModifierValues = canAddModifierValuesPerSample;
+
+    if (isBaseValueFollowingCurve)
+    {
+        if (! curveSource->getValues (editTime, dest, numSamples))
+            return false;
+    }
+    else if (addModifierValues)
+    {
+        juce::FloatVectorOperations::fill (dest, currentBaseValue.load(), numSamples);
+    }
+    else
+    {
+        return false;
+    }
+
+    if (addModifierValues)
+    {
+        // Modifier values are combined in the normalised range, the same as updateFromAutomationSources
+        for (int start = 0; start < numSamples; start += AutomationSource::maxNumValuesToAdd)
+        {
+            const auto numThisTime = std::min (AutomationSource::maxNumValuesToAdd, numSamples - start);
+            float modValues[AutomationSource::maxNumValuesToAdd] = {};
+
+            getAutomationSourceList()
+                .visitSources ([start, numThisTime, &modValues] (AutomationSource& m)
+                               {
+                                   if (m.isEnabled() && m.canAddValues())
+                                       m.addValues (start, modValues, numThisTime);
+                               });
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                auto& v = dest[start + i];
+                v = valueRange.convertFrom0to1 (juce::jlimit (0.0f, 1.0f, valueRange.convertTo0to1 (v) + modValues[i]));
+            }
+        }
+    }
+    else if (const auto modifierValue = currentModifierValue.load(); modifierValue != 0.0f)
+    {
+        // Other modifiers are only updated once per block so are applied as the same offset as setParameterValue uses
+        juce::FloatVectorOperations::add (dest, modifierValue, numSamples);
+    }
+
+    const auto range = getValueRange();
+    juce::FloatVectorOperations::clip (dest, dest, range.getStart(), range.getEnd(), numSamples);
+
+    return true;
 }
 
 //==============================================================================
@@ -1289,11 +1552,18 @@ void AutomatableParameter::updateFromAttachedValue()
         attachedValue->updateParameterFromValue();
 }
 
+void AutomatableParameter::flushPendingStateUpdate()
+{
+    if (attachedValue != nullptr)
+        attachedValue->flushPendingValue();
+}
+
 void AutomatableParameter::detachFromCurrentValue()
 {
     if (attachedValue == nullptr)
         return;
 
+    attachedValue->flushPendingValue();
     attachedValue->detach (this);
     attachedValue.reset();
 }
@@ -1438,7 +1708,7 @@ void AutomatableParameter::setParameterValue (float value, bool isFollowingCurve
             if (attachedValue != nullptr)
             {
                 attachedValue->cancelPendingUpdate();
-                attachedValue->setValue (value);
+                attachedValue->setValueThrottled (value, ed.engine.getEngineBehaviour().getParameterStateUpdateIntervalMs (ed));
             }
         }
 
@@ -1461,11 +1731,10 @@ void AutomatableParameter::setParameter (float value, juce::NotificationType nt)
         listeners.call (&Listener::parameterChanged, *this, currentValue);
         getEdit().getParameterChangeHandler().parameterChanged (*this, false);
 
-        if (attachedValue != nullptr)
-        {
-            // Updates the ValueTree via the CachedValue to the current parameter value synchronously
+        // Updates the ValueTree via the CachedValue to the current parameter value synchronously,
+        // unless it's being throttled in which case it'll be updated when the interval elapses
+        if (attachedValue != nullptr && ! attachedValue->isThrottling())
             attachedValue->handleAsyncUpdate();
-        }
     }
 }
 
@@ -1588,6 +1857,7 @@ void AutomatableParameter::parameterChangeGestureEnd()
     jassert(gestureCount == 0);
 
     TRACKTION_ASSERT_MESSAGE_THREAD
+    flushPendingStateUpdate();
     listeners.call (&Listener::parameterChangeGestureEnd, *this);
 }
 
@@ -1706,74 +1976,168 @@ AutomatableParameter* getParameter (AutomatableParameter::ModifierAssignment& as
 }
 
 //==============================================================================
-AutomationIterator::AutomationIterator (Edit& edit, const AutomationCurve& curve)
-    : tempoSequence (edit.tempoSequence.getInternalSequence()),
-      timeBase (curve.timeBase)
+AutomationCurveSnapshot::AutomationCurveSnapshot (const AutomationCurve& curve)
+    : timeBase (curve.timeBase)
 {
     const int numPoints = curve.getNumPoints();
-    jassert (numPoints > 0);
+    times.reserve ((size_t) numPoints);
+    values.reserve ((size_t) numPoints);
+    curves.reserve ((size_t) numPoints);
 
     for (int i = 0; i < numPoints; i++)
     {
         auto src = curve.getPoint (i);
         assert (src.time.isBeats() == (timeBase == AutomationCurve::TimeBase::beats));
 
-        AutoPoint dst;
-        dst.time = toUnderlying (src.time);
-        dst.value = src.value;
-        dst.curve = src.curve;
-
-        points.add (dst);
+        times.push_back (toUnderlying (src.time));
+        values.push_back (src.value);
+        curves.push_back (src.curve);
     }
 }
 
-AutomationIterator::AutomationIterator (const AutomatableParameter& param)
-    : AutomationIterator (param.getEdit(), param.getCurve())
+double AutomationCurveSnapshot::toCurvePosition (EditPosition pos, const tempo::Sequence& tempoSequence) const
 {
+    if (timeBase == AutomationCurve::TimeBase::time)
+        return toTime (pos, tempoSequence).inSeconds();
+
+    return toBeats (pos, tempoSequence).inBeats();
 }
 
-void AutomationIterator::setPosition (EditPosition newTime) noexcept
+float AutomationCurveSnapshot::getValueAt (double position, Cursor& cursor) const noexcept
 {
-    jassert (points.size() > 0);
+    jassert (size() > 0);
 
-    const double newPostion = [this, &newTime]
-                              {
-                                  if (timeBase == AutomationCurve::TimeBase::time)
-                                      return toTime (newTime, tempoSequence).inSeconds();
+    cursor.index = updateIndex (position, cursor.index);
 
-                                  return toBeats (newTime, tempoSequence).inBeats();
-                              }();
+    if (position < times[0])
+        return values[0];
 
-    auto newIndex = updateIndex (newPostion);
+    if (cursor.index == size() - 1)
+        return values[(size_t) cursor.index];
 
-    if (newPostion < points[0].time)
+    return getValueBetween (cursor.index, position);
+}
+
+double AutomationCurveSnapshot::getEndOfConstantValue (double position, const Cursor& cursor) const noexcept
+{
+    jassert (size() > 0);
+    const auto lastIndex = size() - 1;
+    auto index = 0;
+
+    if (position >= times[0])
     {
-        currentIndex = newIndex;
-        currentValue = points.getReference (0).value;
-        return;
+        index = cursor.index;
+        jassert (juce::isPositiveAndBelow (index, size()));
+
+        if (index < lastIndex && values[(size_t) index] != values[(size_t) index + 1])
+            return position;
+    }
+
+    // Segments between points with the same value are flat whatever their curve
+    while (index < lastIndex && values[(size_t) index] == values[(size_t) index + 1])
+        ++index;
+
+    if (index == lastIndex)
+        return std::numeric_limits<double>::infinity();
+
+    return times[(size_t) index];
+}
+
+/** Sets dest[i] = start + step * i. */
+static void fillRamp (float* dest, int num, float start, float step) noexcept
+{
+    int i = 0;
+
+   #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    const auto startV = _mm_set1_ps (start), stepV = _mm_set1_ps (step), four = _mm_set1_ps (4.0f);
+    auto indexes = _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f);
+
+    for (; i + 4 <= num; i += 4)
+    {
+        _mm_storeu_ps (dest + i, _mm_add_ps (startV, _mm_mul_ps (stepV, indexes)));
+        indexes = _mm_add_ps (indexes, four);
     }
+   #elif TRACKTION_ARM && defined (__ARM_NEON)
+    const float firstIndexes[] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const auto startV = vdupq_n_f32 (start), stepV = vdupq_n_f32 (step), four = vdupq_n_f32 (4.0f);
+    auto indexes = vld1q_f32 (firstIndexes);
 
-    if (newIndex == points.size() - 1)
+    for (; i + 4 <= num; i += 4)
     {
-        currentIndex = newIndex;
-        currentValue = points.getReference (newIndex).value;
-        return;
+        vst1q_f32 (dest + i, vaddq_f32 (startV, vmulq_f32 (stepV, indexes)));
+        indexes = vaddq_f32 (indexes, four);
     }
+   #endif
 
-    const auto& p1 = points.getReference (newIndex);
-    const auto& p2 = points.getReference (newIndex + 1);
+    for (; i < num; ++i)
+        dest[i] = start + step * (float) i;
+}
+
+void AutomationCurveSnapshot::getValues (double start, double delta, float* dest, int numValues, Cursor& cursor) const noexcept
+{
+    jassert (size() > 0);
+    const auto lastIndex = size() - 1;
 
-    const auto t = newPostion;
+    for (int i = 0; i < numValues;)
+    {
+        const auto position = start + i * delta;
+        cursor.index = updateIndex (position, cursor.index);
 
-    const auto t1 = p1.time;
-    const auto t2 = p2.time;
+        // Find the end of the run of values in this segment
+        auto end = i + 1;
 
-    const auto v1 = p1.value;
-    const auto v2 = p2.value;
+        if (position < times[0])
+        {
+            while (end < numValues && start + end * delta < times[0])
+                ++end;
 
-    const auto c = p1.curve;
+            juce::FloatVectorOperations::fill (dest + i, values[0], end - i);
+        }
+        else if (cursor.index == lastIndex)
+        {
+            juce::FloatVectorOperations::fill (dest + i, values[(size_t) lastIndex], numValues - i);
+            return;
+        }
+        else
+        {
+            const auto index = (size_t) cursor.index;
+            const auto t1 = times[index], t2 = times[index + 1];
 
-    float v = p2.value;
+            while (end < numValues && start + end * delta <= t2)
+                ++end;
+
+            if (curves[index] == 0.0f && t2 != t1)
+            {
+                // Linear segments are a ramp so can be filled all at once
+                const auto v1 = values[index], v2 = values[index + 1];
+                const auto proportion = (position - t1) / (t2 - t1);
+                const auto proportionStep = delta / (t2 - t1);
+                fillRamp (dest + i, end - i,
+                          v1 + (v2 - v1) * (float) proportion,
+                          (v2 - v1) * (float) proportionStep);
+            }
+            else
+            {
+                for (int j = i; j < end; ++j)
+                    dest[j] = getValueBetween (cursor.index, start + j * delta);
+            }
+        }
+
+        i = end;
+    }
+}
+
+float AutomationCurveSnapshot::getValueBetween (int index, double t) const noexcept
+{
+    const auto t1 = times[(size_t) index];
+    const auto t2 = times[(size_t) index + 1];
+
+    const auto v1 = values[(size_t) index];
+    const auto v2 = values[(size_t) index + 1];
+
+    const auto c = curves[(size_t) index];
+
+    float v = v2;
 
     if (t2 != t1)
     {
@@ -1783,7 +2147,7 @@ void AutomationIterator::setPosition (EditPosition newTime) noexcept
         }
         else if (c >= -0.5 && c <= 0.5)
         {
-            auto bp = getBezierPoint (p1.time, p1.value, p2.time, p2.value, p1.curve);
+            auto bp = getBezierPoint (t1, v1, t2, v2, c);
             v = float (getBezierYFromX (t, t1, v1, bp.first, bp.second, t2, v2));
         }
         else
@@ -1791,10 +2155,10 @@ void AutomationIterator::setPosition (EditPosition newTime) noexcept
             double x1end = 0, x2end = 0;
             double y1end = 0, y2end = 0;
 
-            auto bp = getBezierPoint (p1.time, p1.value, p2.time, p2.value, p1.curve);
-            getBezierEnds (p1.time, p1.value,
-                           p2.time, p2.value,
-                           p1.curve,
+            auto bp = getBezierPoint (t1, v1, t2, v2, c);
+            getBezierEnds (t1, v1,
+                           t2, v2,
+                           c,
                            x1end, y1end, x2end, y2end);
 
             if (t >= t1 && t <= x1end)
@@ -1806,33 +2170,58 @@ void AutomationIterator::setPosition (EditPosition newTime) noexcept
         }
     }
 
-    currentIndex = newIndex;
-    currentValue = v;
+    return v;
 }
 
-int AutomationIterator::updateIndex (double newPosition)
+int AutomationCurveSnapshot::updateIndex (double newPosition, int newIndex) const noexcept
 {
-    auto newIndex = currentIndex;
-
-    if (! juce::isPositiveAndBelow (newIndex, points.size()))
+    if (! juce::isPositiveAndBelow (newIndex, size()))
         newIndex = 0;
 
-    if (newIndex > 0 && points.getReference (newIndex).time >= newPosition)
+    if (newIndex > 0 && times[(size_t) newIndex] >= newPosition)
     {
         --newIndex;
 
-        while (newIndex > 0 && points.getReference (newIndex).time >= newPosition)
+        while (newIndex > 0 && times[(size_t) newIndex] >= newPosition)
             --newIndex;
     }
     else
     {
-        while (newIndex < points.size() - 1 && points.getReference (newIndex + 1).time < newPosition)
+        while (newIndex < size() - 1 && times[(size_t) newIndex + 1] < newPosition)
             ++newIndex;
     }
 
     return newIndex;
 }
 
+//==============================================================================
+AutomationIterator::AutomationIterator (Edit& edit, const AutomationCurve& curve)
+    : tempoSequence (edit.tempoSequence.getInternalSequence()),
+      snapshot (curve)
+{
+    jassert (snapshot.size() > 0);
+}
+
+AutomationIterator::AutomationIterator (const AutomatableParameter& param)
+    : AutomationIterator (param.getEdit(), param.getCurve())
+{
+}
+
+void AutomationIterator::setPosition (EditPosition newTime) noexcept
+{
+    currentValue = snapshot.getValueAt (snapshot.toCurvePosition (newTime, tempoSequence), cursor);
+}
+
+void AutomationIterator::getValues (TimeRange range, float* dest, int numValues) noexcept
+{
+    if (numValues <= 0)
+        return;
+
+    const auto start = snapshot.toCurvePosition (range.getStart(), tempoSequence);
+    const auto delta = std::max (0.0, (snapshot.toCurvePosition (range.getEnd(), tempoSequence) - start) / numValues);
+    snapshot.getValues (start, delta, dest, numValues, cursor);
+}
+
 
 //==============================================================================
 const char* AutomationDragDropTarget::automatableDragString = "automatableParamDrag";
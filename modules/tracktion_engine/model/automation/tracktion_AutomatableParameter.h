@@ -45,6 +45,11 @@ public:
     void updateFromAttachedValue();
     void detachFromCurrentValue();
 
+    /** Writes any value to the attached CachedValue that's being held back by
+        EngineBehaviour::getParameterStateUpdateIntervalMs.
+    */
+    void flushPendingStateUpdate();
+
     //==============================================================================
     virtual juce::String getParameterName() const               { return paramName; }
     virtual juce::String getParameterShortName (int) const      { return paramName; }
@@ -170,6 +175,20 @@ public:
     /** Updates the parameter and modifier values from its current automation sources. */
     void updateFromAutomationSources (TimePosition);
 
+    /** Fills a buffer with the value of the parameter at each sample of a block.
+        This follows the automation curve sample by sample, so plugins can use it to apply
+        automation without zipper noise or having to process in smaller blocks.
+        If all the enabled sources are Modifiers, their stored values are added sample by
+        sample too, otherwise modifiers are applied at the value they had at the start of
+        the block.
+        This should be called from the audio thread after updateFromAutomationSources
+        has been called for the block, e.g. in Plugin::applyToBuffer.
+        @returns false if the parameter isn't following a curve or Modifiers at the moment,
+                 in which case the buffer won't have been filled and getCurrentValue()
+                 should be used for the whole block
+    */
+    bool getValuesForBlock (TimeRange editTime, float* dest, int numSamples);
+
     //==============================================================================
     virtual bool isParameterActive() const                          { return true; }
     virtual bool isDiscrete() const                                 { return false; }
@@ -257,6 +276,8 @@ protected:
     std::atomic<float> currentValue { 0.0f }, currentParameterValue { 0.0f },  currentBaseValue { 0.0f }, currentModifierValue { 0.0f };
     mutable std::atomic<int> numActiveAutomationSources { 0 };
     std::atomic<bool> isRecording { false };
+    std::atomic<bool> isBaseValueFollowingCurve { false }, canAddModifierValuesPerSample { false };
+    std::atomic<float> baseValueFromLastUpdate { 0.0f };
     bool updateParametersRecursionCheck = false;
     AsyncCaller parameterChangedCaller { [this] { listeners.call (&Listener::currentValueChanged, *this); } };
     int gestureCount = 0;
@@ -411,6 +432,82 @@ public:
 };
 
 
+//==============================================================================
+/**
+    An immutable, flattened copy of an AutomationCurve's points that can be read
+    on the audio thread.
+
+    The times, values and curves are kept in separate cache-line aligned arrays so
+    moving through the times doesn't have to pull the rest in to the cache. Points
+    are found by moving a Cursor from the previous position rather than by searching.
+*/
+struct AutomationCurveSnapshot
+{
+    /** Creates an empty snapshot. */
+    AutomationCurveSnapshot() = default;
+
+    /** Creates a snapshot of the current points of a curve. */
+    AutomationCurveSnapshot (const AutomationCurve&);
+
+    AutomationCurveSnapshot (AutomationCurveSnapshot&&) noexcept = default;
+    AutomationCurveSnapshot& operator= (AutomationCurveSnapshot&&) noexcept = default;
+
+    /** Returns the number of points. */
+    int size() const noexcept                   { return (int) times.size(); }
+
+    /** Returns true if there aren't enough points to vary the value. */
+    bool isEmpty() const noexcept               { return times.size() <= 1; }
+
+    /** The time base of the curve, which the point times are in. */
+    AutomationCurve::TimeBase timeBase = AutomationCurve::TimeBase::time;
+
+    /** Converts a position in the Edit to the time base of the point times. */
+    double toCurvePosition (EditPosition, const tempo::Sequence&) const;
+
+    //==============================================================================
+    /** A position in a snapshot, moved along as values are read. */
+    struct Cursor
+    {
+        int index = -1;
+    };
+
+    /** Returns the value at a position in the curve's time base, moving the cursor to it. */
+    float getValueAt (double position, Cursor&) const noexcept;
+
+    /** Returns the position up to which the value stays the same as it is at a given position,
+        or the position itself if the value is changing there.
+        This can be infinite if the value doesn't change again. The cursor must already have
+        been moved to the position with getValueAt.
+    */
+    double getEndOfConstantValue (double position, const Cursor&) const noexcept;
+
+    /** Fills a buffer with the values at evenly spaced positions in the curve's time base,
+        the first being at the start, moving the cursor through them.
+    */
+    void getValues (double start, double delta, float* dest, int numValues, Cursor&) const noexcept;
+
+private:
+    template<typename Type>
+    struct CacheAlignedAllocator
+    {
+        using value_type = Type;
+
+        CacheAlignedAllocator() noexcept = default;
+        template<typename Other> CacheAlignedAllocator (const CacheAlignedAllocator<Other>&) noexcept {}
+
+        Type* allocate (size_t n)               { return static_cast<Type*> (::operator new (n * sizeof (Type), std::align_val_t (64))); }
+        void deallocate (Type* p, size_t)       { ::operator delete (p, std::align_val_t (64)); }
+
+        template<typename Other> bool operator== (const CacheAlignedAllocator<Other>&) const noexcept { return true; }
+    };
+
+    std::vector<double, CacheAlignedAllocator<double>> times; // Could be time or beats depending on the timeBase
+    std::vector<float, CacheAlignedAllocator<float>> values, curves;
+
+    int updateIndex (double position, int index) const noexcept;
+    float getValueBetween (int index, double position) const noexcept;
+};
+
 //==============================================================================
 /**
     A cache of automation points, with a cursor which moves through it.
@@ -420,26 +517,22 @@ struct AutomationIterator
     AutomationIterator (Edit&, const AutomationCurve&);
     AutomationIterator (const AutomatableParameter&);
 
-    bool isEmpty() const noexcept               { return points.size() <= 1; }
+    bool isEmpty() const noexcept               { return snapshot.isEmpty(); }
 
     void setPosition (EditPosition) noexcept;
     float getCurrentValue() noexcept            { return currentValue; }
 
-private:
-    int updateIndex (double position);
-
-    struct AutoPoint
-    {
-        double time = 0.0; // Could be time or beats depending on the curve's timeBase
-        float value = 0.0f;
-        float curve = 0.0f;
-    };
+    /** Fills a buffer with the values of the curve at evenly spaced positions through
+        a range of the Edit, the first being at the start of the range.
+        This moves the cursor through the range but doesn't change the current value.
+    */
+    void getValues (TimeRange, float* dest, int numValues) noexcept;
 
+private:
     const tempo::Sequence& tempoSequence;
-    juce::Array<AutoPoint> points;
-    int currentIndex = -1;
+    const AutomationCurveSnapshot snapshot;
+    AutomationCurveSnapshot::Cursor cursor;
     float currentValue = 0.0f;
-    const AutomationCurve::TimeBase timeBase;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationIterator)
 };
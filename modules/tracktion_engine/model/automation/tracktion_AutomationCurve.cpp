@@ -94,6 +94,28 @@ TimePosition AutomationCurve::getPointTime (int index) const noexcept
     return toTime (pos, edit.tempoSequence);
 }
 
+std::vector<TimePosition> AutomationCurve::getPointTimes() const
+{
+    const auto numPoints = (size_t) getNumPoints();
+    std::vector<TimePosition> times (numPoints);
+
+    if (timeBase == TimeBase::time)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+            times[i] = TimePosition::fromSeconds (static_cast<double> (state.getChild ((int) i)[IDs::t]));
+
+        return times;
+    }
+
+    std::vector<BeatPosition> beats (numPoints);
+
+    for (size_t i = 0; i < numPoints; ++i)
+        beats[i] = BeatPosition::fromBeats (static_cast<double> (state.getChild ((int) i)[IDs::t]));
+
+    edit.tempoSequence.toTime (beats, times);
+    return times;
+}
+
 float AutomationCurve::getPointValue (int index) const noexcept
 {
     assert (index >= 0);
@@ -753,9 +775,12 @@ void AutomationCurve::removeRegionAndCloseGap (AutomatableParameter& param, Time
     if (getNumPoints() == 0)
         return;
 
+    // Removing points doesn't change the ones before them so the times can all be found first
+    auto times = getPointTimes();
+
     for (int i = getNumPoints(); --i >= 0;)
     {
-        auto t = getPointTime (i);
+        auto t = times[(size_t) i];
 
         if (t >= range.getStart() && t <= range.getEnd())
             removePoint (i, um);
@@ -879,17 +904,25 @@ void AutomationCurve::rescaleAllPositions (double factor, juce::UndoManager* um)
 void AutomationCurve::rescaleValues (float factor, TimeRange range, juce::Range<float> limits, juce::UndoManager* um)
 {
     if (factor != 1.0f)
+    {
+        auto times = getPointTimes();
+
         for (int i = getNumPoints(); --i >= 0;)
-            if (range.contains (getPointTime (i)))
+            if (range.contains (times[(size_t) i]))
                 setPointValue (i, juce::jlimit (limits.getStart(), limits.getEnd(), getPointValue (i) * factor), um);
+    }
 }
 
 void AutomationCurve::addToValues (float valueDelta, TimeRange range, juce::Range<float> limits, juce::UndoManager* um)
 {
     if (valueDelta != 0)
+    {
+        auto times = getPointTimes();
+
         for (int i = getNumPoints(); --i >= 0;)
-            if (range.contains (getPointTime (i)))
+            if (range.contains (times[(size_t) i]))
                 setPointValue (i, juce::jlimit (limits.getStart(), limits.getEnd(), getPointValue (i) + valueDelta), um);
+    }
 }
 
 CurvePoint AutomationCurve::getBezierPoint (int index) const noexcept
@@ -68,6 +68,12 @@ public:
 
     AutomationPoint getPoint (int index) const noexcept;
     EditPosition getPointPosition (int index) const noexcept;
+
+    /** Returns the times of all the points.
+        For beat based curves these are converted in one go, which is much quicker
+        than calling getPointTime for each point.
+    */
+    std::vector<TimePosition> getPointTimes() const;
     float getPointValue (int index) const noexcept;
     float getPointCurve (int index) const noexcept;
 
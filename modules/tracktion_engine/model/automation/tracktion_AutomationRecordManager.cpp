@@ -171,6 +171,7 @@ namespace tracktion::inline engine
                     punchOut (recordedParams.getUnchecked (i)->parameter, toEnd);
 
                 recordedParams.clear();
+                recordedParamLookup.clear();
                 flushTimer.stopTimer();
             }
 
@@ -240,6 +241,7 @@ namespace tracktion::inline engine
             Edit& edit;
             juce::CriticalSection lock;
             juce::OwnedArray<AutomationParamData> recordedParams;
+            std::unordered_map<AutomatableParameter*, AutomationParamData*> recordedParamLookup;
             juce::CachedValue<AtomicWrapper<bool>> readingAutomation, writingAutomation;
             bool wasPlaying = false;
             LambdaTimer flushTimer { [this] { flushAutomation(); } };
@@ -268,6 +270,7 @@ namespace tracktion::inline engine
                 entry->changed();
 
                 const juce::ScopedLock sl (lock);
+                recordedParamLookup[&param] = entry.get();
                 recordedParams.add (entry.release());
             }
 
@@ -276,17 +279,26 @@ namespace tracktion::inline engine
                 TRACKTION_ASSERT_MESSAGE_THREAD
                 const juce::ScopedLock sl (lock);
 
-                for (auto p : recordedParams)
+                // Changes are only buffered here, they're written to the curve by the flush timer
+                if (auto found = recordedParamLookup.find (&param); found != recordedParamLookup.end())
                 {
-                    if (&p->parameter == &param)
-                    {
-                        p->changes.add (AutomationParamData::Change (time, value));
-                        p->changed();
-                        break;
-                    }
+                    auto& p = *found->second;
+
+                    // Drop changes that don't move the value, such as a control surface resending its position
+                    if (! p.changes.isEmpty() && p.changes.getReference (p.changes.size() - 1).value == value)
+                        return;
+
+                    p.changes.add (AutomationParamData::Change (time, value));
+                    p.changed();
                 }
             }
 
+            void removeRecordedParam (int index)
+            {
+                recordedParamLookup.erase (&recordedParams.getUnchecked (index)->parameter);
+                recordedParams.remove (index);
+            }
+
             void punchOut (AutomatableParameter& param, bool toEnd)
             {
                 auto recordedParam = std::ranges::find_if (recordedParams,
@@ -338,7 +350,7 @@ namespace tracktion::inline engine
                     if (auto t = param.getTrack())
                         t->automationMode = AutomationMode::latch;
 
-                recordedParams.removeObject (*recordedParam);
+                removeRecordedParam (recordedParams.indexOf (*recordedParam));
 
                 if (recordedParams.isEmpty())
                     flushTimer.stopTimer();
@@ -350,7 +362,7 @@ namespace tracktion::inline engine
 
                 for (int i = recordedParams.size(); --i >= 0;)
                     if (&recordedParams.getUnchecked (i)->parameter == &param)
-                        recordedParams.remove (i);
+                        removeRecordedParam (i);
             }
 
             void parameterChangeGestureEnd (AutomatableParameter& param)
@@ -480,6 +492,17 @@ namespace tracktion::inline engine
 
                 auto um = &parameter.getEdit().getUndoManager();
 
+                // Thin the changes before they're added, as each point added to the curve
+                // is a ValueTree change and an undoable action. The same tolerances are used
+                // when the recorded sections are simplified on punch out.
+                std::vector<AutomationParamData::Change> thinnedChanges;
+
+                if (parameter.getEngine().getPropertyStorage().getProperty (SettingID::simplifyAfterRecording, true))
+                {
+                    thinnedChanges = thinChanges (changes, 0.01_td, 0.002f, parameter.isDiscrete());
+                    changes = thinnedChanges;
+                }
+
                 // Remove all events in this range
                 curve.removePointsInRegion (time.withStart (time.getStart() + 1us), um);
 
@@ -492,6 +515,55 @@ namespace tracktion::inline engine
                 }
             }
 
+            /** Removes changes that are too close to their neighbours, or in line with them, to make a difference. */
+            static std::vector<AutomationParamData::Change> thinChanges (std::span<const AutomationParamData::Change> changes,
+                                                                         TimeDuration minTimeDifference, float minValueDifference,
+                                                                         bool isDiscrete)
+            {
+                std::vector<AutomationParamData::Change> thinned;
+                thinned.reserve (changes.size());
+
+                for (size_t i = 0; i < changes.size(); ++i)
+                {
+                    auto& change = changes[i];
+                    const bool isFirstOrLast = i == 0 || i == changes.size() - 1;
+
+                    if (! isFirstOrLast)
+                    {
+                        auto& previous = thinned.back();
+
+                        if (change.time - previous.time < minTimeDifference
+                            && std::abs (change.value - previous.value) < minValueDifference)
+                            continue;
+
+                        // Discrete parameters step between values so only repeated values can go
+                        if (isDiscrete)
+                        {
+                            if (change.value == previous.value)
+                                continue;
+                        }
+                        else
+                        {
+                            auto& next = changes[i + 1];
+                            const auto length = next.time - previous.time;
+
+                            if (length > 0_td)
+                            {
+                                const auto proportion = (float) ((change.time - previous.time) / length);
+                                const auto interpolated = previous.value + (next.value - previous.value) * proportion;
+
+                                if (std::abs (change.value - interpolated) < minValueDifference)
+                                    continue;
+                            }
+                        }
+                    }
+
+                    thinned.push_back (change);
+                }
+
+                return thinned;
+            }
+
             void changeListenerCallback (juce::ChangeBroadcaster* source) override
             {
                 // called back when transport state changes
@@ -518,6 +590,7 @@ namespace tracktion::inline engine
                             const juce::ScopedLock sl (lock);
                             jassert (recordedParams.isEmpty());
                             recordedParams.clear();
+                            recordedParamLookup.clear();
                         }
                     }
                 }
@@ -56,6 +56,22 @@ public:
         return values[valueIndex];
     }
 
+    void copyValues (TimeDuration numSeconds, float* dest, int numValues) const
+    {
+        const auto numStored = values.size();
+        const auto sampleDelta = std::min ((size_t) tracktion::toSamples (numSeconds, sampleRate), numStored - 1);
+        const auto numFromHistory = std::min ((size_t) numValues, sampleDelta + 1);
+        const auto index = (size_t) juce::negativeAwareModulo (int (headIndex) - int (sampleDelta), (int) numStored);
+
+        // The values are stored in a ring so might need copying in two parts
+        const auto numBeforeWrap = std::min (numFromHistory, numStored - index);
+        juce::FloatVectorOperations::copy (dest, values.data() + index, (int) numBeforeWrap);
+        juce::FloatVectorOperations::copy (dest + numBeforeWrap, values.data(), (int) (numFromHistory - numBeforeWrap));
+
+        if ((size_t) numValues > numFromHistory)
+            juce::FloatVectorOperations::fill (dest + numFromHistory, values[headIndex], numValues - (int) numFromHistory);
+    }
+
     [[nodiscard]] std::vector<float> getValues (TimeDuration numSecondsBeforeNow) const
     {
         std::vector<float> v;
@@ -85,6 +101,66 @@ private:
 };
 
 //==============================================================================
+//==============================================================================
+ControlRateModifierTimer::ControlRateModifierTimer (Modifier& m)
+    : timedModifier (m)
+{
+}
+
+void ControlRateModifierTimer::updateStreamTime (TimePosition editTime, int numSamples)
+{
+    const std::unique_lock lock (evaluationMutex, std::try_to_lock);
+
+    // The block after this is being evaluated so keep the current values
+    if (! lock.owns_lock())
+        return;
+
+    if (const auto duration = pendingResyncDuration.exchange (-1.0, std::memory_order_acq_rel); duration >= 0.0)
+    {
+        evaluateResync (duration);
+        evaluatedBlock.reset();
+    }
+
+    // The edit time may have been rounded differently so only needs to be within a sample
+    const bool wasEvaluatedAhead = evaluatedBlock
+                                    && evaluatedBlock->second == numSamples
+                                    && std::abs ((evaluatedBlock->first - editTime).inSeconds()) < 0.5 / timedModifier.getSampleRate();
+
+    if (! wasEvaluatedAhead)
+        evaluate (editTime, numSamples);
+
+    evaluatedBlock.reset();
+    publishedTime = editTime;
+    publishValues (editTime);
+}
+
+void ControlRateModifierTimer::resync (double duration)
+{
+    if (const std::unique_lock lock (evaluationMutex, std::try_to_lock); lock.owns_lock())
+    {
+        evaluateResync (duration);
+        evaluatedBlock.reset();
+        publishValues (publishedTime);
+    }
+    else
+    {
+        pendingResyncDuration.store (duration, std::memory_order_release);
+    }
+}
+
+void ControlRateModifierTimer::evaluateAhead (TimePosition editTime, int numSamples)
+{
+    // N.B. The evaluationMutex is held by the caller
+
+    // Any resync has to be applied before the next block is evaluated
+    if (pendingResyncDuration.load (std::memory_order_acquire) >= 0.0)
+        return;
+
+    const auto nextEditTime = editTime + TimeDuration::fromSamples (numSamples, timedModifier.getSampleRate());
+    evaluate (nextEditTime, numSamples);
+    evaluatedBlock = std::make_pair (nextEditTime, numSamples);
+}
+
 //==============================================================================
 Modifier::Modifier (Edit& e, const juce::ValueTree& v)
     : AutomatableEditItem (e, v),
@@ -201,6 +277,14 @@ float Modifier::getValueAt (TimeDuration numSecondsBeforeNow) const
     return {};
 }
 
+void Modifier::copyValues (TimeDuration numSecondsBeforeNow, float* dest, int numValues) const
+{
+    if (valueFifo)
+        valueFifo->copyValues (numSecondsBeforeNow, dest, numValues);
+    else
+        juce::FloatVectorOperations::clear (dest, numValues);
+}
+
 std::vector<float> Modifier::getValues (TimeDuration numSecondsBeforeNow) const
 {
     if (! messageThreadValueFifo)
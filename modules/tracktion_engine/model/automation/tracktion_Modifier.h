@@ -20,6 +20,60 @@ struct ModifierTimer
     virtual void updateStreamTime (TimePosition editTime, int numSamples) = 0;
 };
 
+struct Modifier;
+
+//==============================================================================
+/**
+    A ModifierTimer for Modifiers whose values only change once per block, e.g. LFOs.
+
+    If the Edit has been told to with Edit::setEvaluateModifiersAhead, these are evaluated
+    one block ahead on a background thread and the values are published when that block
+    starts, which takes the work off the audio thread. If the evaluated block doesn't
+    match the one being played, e.g. after a jump, it's evaluated on the audio thread instead.
+
+    Subclasses calculate their values in evaluate without changing anything the audio
+    thread reads and then make them visible in publishValues.
+*/
+class ControlRateModifierTimer  : public ModifierTimer
+{
+public:
+    /** Creates a timer for a Modifier. */
+    ControlRateModifierTimer (Modifier&);
+
+    /** Publishes the values evaluated for this block, evaluating them now if they
+        haven't been already.
+    */
+    void updateStreamTime (TimePosition editTime, int numSamples) final;
+
+    /** Restarts the Modifier, e.g. when a note starts.
+        If the next block is being evaluated in the background, this is applied before
+        the one after it is played.
+        [[ audio_thread ]]
+    */
+    void resync (double duration);
+
+protected:
+    /** Subclasses should calculate their values for a block here. */
+    virtual void evaluate (TimePosition editTime, int numSamples) = 0;
+
+    /** Subclasses should restart their values here, as if a block of the given length had been played. */
+    virtual void evaluateResync (double duration) = 0;
+
+    /** Subclasses should make the values last calculated visible here. */
+    virtual void publishValues (TimePosition editTime) = 0;
+
+private:
+    friend class Edit;
+
+    Modifier& timedModifier;
+    std::mutex evaluationMutex;
+    std::optional<std::pair<TimePosition, int>> evaluatedBlock;
+    TimePosition publishedTime;
+    std::atomic<double> pendingResyncDuration { -1.0 };
+
+    void evaluateAhead (TimePosition editTime, int numSamples);
+};
+
 //==============================================================================
 /**
     Bass class for parameter Modifiers.
@@ -109,6 +163,14 @@ struct Modifier : public AutomatableEditItem,
     */
     float getValueAt (TimeDuration numSecondsBeforeNow) const;
 
+    /** Copies consecutive sample values, starting at a given time in the past, in to a buffer.
+        These are the values stored when the Modifier was last processed so any number of
+        assignments can read them without re-evaluating the Modifier. Positions after the
+        current value are given the current value.
+        [[ audio_thread ]]
+    */
+    void copyValues (TimeDuration numSecondsBeforeNow, float* dest, int numValues) const;
+
     /** Returns a vector of previous sample values.
         N.B. you might not get back as many seconds as requested with numSecondsBeforeNow.
         [[ message_thread ]]
@@ -35,47 +35,8 @@ public:
     /** Performs the actual detection. */
     JobStatus runJob() override
     {
-        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, sourceFile));
-
-        if (reader == nullptr)
-            return jobHasFinished;
-
-        auto numChannels = (int) reader->numChannels;
-        auto numSamples = reader->lengthInSamples;
-        auto sampleRate = reader->sampleRate;
-
-        if (numSamples <= 0)
-            return jobHasFinished;
-
-        // main detection loop
-        {
-            TempoDetect detector (numChannels, sampleRate);
-            const int blockSize = 65536;
-            const bool useRightChan = numChannels > 1;
-
-            // can't use an AudioScratchBuffer yet
-            juce::AudioBuffer<float> buffer (numChannels, blockSize);
-
-            auto numLeft = numSamples;
-            SampleCount startSample = 0;
-
-            while (numLeft > 0)
-            {
-                if (shouldExit())
-                    return jobHasFinished;
-
-                auto numThisTime = (int) std::min ((SampleCount) numLeft, (SampleCount) blockSize);
-                reader->read (&buffer, 0, numThisTime, startSample, true, useRightChan);
-                detector.processSection (buffer, numThisTime);
-
-                startSample += numThisTime;
-                numLeft -= numThisTime;
-                progress = numLeft / (float) numSamples;
-            }
-
-            bpm = detector.finishAndDetect();
-            isSensible = bpm > 0;
-        }
+        bpm = TempoDetect::detectTempoOfFile (engine, sourceFile, progress, [this] { return shouldExit(); });
+        isSensible = bpm > 0;
 
         return jobHasFinished;
     }
@@ -87,7 +48,7 @@ private:
     //==============================================================================
     Engine& engine;
     juce::File sourceFile;
-    float progress = 0;
+    std::atomic<float> progress { 0.0f };
     bool isSensible = false;
     float bpm = 12.0f;
 
@@ -208,6 +169,7 @@ AudioClipBase::AudioClipBase (const juce::ValueTree& v, EditItemID id, Type t, C
     level->dbGain.referTo (state, IDs::gain, um);
     level->pan.referTo (state, IDs::pan, um);
     level->mute.referTo (state, IDs::mute, um);
+    panWasCentred = getPan() == 0.0f;
     channels.referTo (state, IDs::channels, um, juce::AudioChannelSet::stereo().getSpeakerArrangementAsString());
 
     if (channels.get().isEmpty())
@@ -1049,7 +1011,34 @@ void AudioClipBase::clearCachedAudioSegmentList()
     if (! edit.isLoading())
         TRACKTION_ASSERT_MESSAGE_THREAD
 
-    audioSegmentList.reset();
+    // The chord progression isn't part of the hash so these always need rebuilding
+    if (getAutoPitch() && getAutoPitchMode() == chordTrackMono)
+        audioSegmentList.reset();
+    else
+        audioSegmentListNeedsCheck = true;
+}
+
+HashCode AudioClipBase::createAudioSegmentListHash()
+{
+    // Everything the segments are built from: the source, the clip's position,
+    // loop and pitch properties, its loop info and the tempo and pitch sequences
+    size_t hash = 0;
+    hash_combine (hash, getHash());
+    hashValueTreeProperties (hash, state, false);
+    hashValueTreeProperties (hash, loopInfo.state, true);
+    hash_combine (hash, edit.tempoSequence.getInternalSequence().hash());
+
+    if (getAutoPitch())
+    {
+        for (auto p : edit.pitchSequence.getPitches())
+        {
+            hash_combine (hash, p->getStartBeatNumber().inBeats());
+            hash_combine (hash, p->getPitch());
+            hash_combine (hash, static_cast<int> (p->getScale()));
+        }
+    }
+
+    return static_cast<HashCode> (hash);
 }
 
 const AudioSegmentList& AudioClipBase::getAudioSegmentList()
@@ -1057,8 +1046,19 @@ const AudioSegmentList& AudioClipBase::getAudioSegmentList()
     if (! edit.isLoading())
         TRACKTION_ASSERT_MESSAGE_THREAD
 
-    if (audioSegmentList == nullptr)
-        audioSegmentList = AudioSegmentList::create (*this, false, false);
+    // Only rebuild the list if something it depends on has actually changed as
+    // lots of things call changed() that don't affect the segments
+    if (audioSegmentList == nullptr || audioSegmentListNeedsCheck)
+    {
+        audioSegmentListNeedsCheck = false;
+        auto newHash = createAudioSegmentListHash();
+
+        if (audioSegmentList == nullptr || newHash != audioSegmentListHash)
+        {
+            audioSegmentList = AudioSegmentList::create (*this, false, false);
+            audioSegmentListHash = newHash;
+        }
+    }
 
     return *audioSegmentList;
 }
@@ -1207,37 +1207,18 @@ LoopInfo AudioClipBase::autoDetectBeatMarkers (const LoopInfo& current, bool aut
 
     if (autoBeat)
     {
-        if (auto reader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (edit.engine, getCurrentSourceFile())))
+        const auto sourceFile = getCurrentSourceFile();
+        const auto wi = AudioFile (edit.engine, sourceFile).getInfo();
+
+        if (wi.wasParsedOk)
         {
             const auto start = loopInfo.getInMarker();
-            const auto end = (loopInfo.getOutMarker() == -1) ? reader->lengthInSamples
+            const auto end = (loopInfo.getOutMarker() == -1) ? wi.lengthInSamples
                                                              : loopInfo.getOutMarker();
 
-            BeatDetect detect;
-            detect.setSensitivity (sens);
-            detect.setSampleRate (reader->sampleRate);
-
-            if ((end - start) > reader->sampleRate)
-            {
-                auto blockLength = detect.getBlockSize();
-                auto blockSize = choc::buffer::Size::create (reader->numChannels, blockLength);
-                auto pos = start;
-
-                choc::buffer::ChannelArrayBuffer<float> buffer (blockSize);
-
-                while (pos + blockLength < end)
-                {
-                    if (! reader->read (buffer.getView().data.channels,
-                                        (int) reader->numChannels, pos, (int) blockLength))
-                        break;
-
-                    detect.audioProcess (buffer);
-                    pos += blockLength;
-                }
-
-                for (auto beat : detect.getBeats())
+            if ((end - start) > wi.sampleRate)
+                for (auto beat : BeatDetect::detectBeatsInFile (edit.engine, sourceFile, { start, end }, sens))
                     res.addLoopPoint (start + beat, LoopInfo::LoopPointType::automatic);
-            }
         }
     }
 
@@ -1919,6 +1900,8 @@ struct StretchSegment
                     const AudioClipBase::ProxyRenderingInfo& info,
                     double sampleRate, const AudioSegmentList::Segment& s)
         : segment (s),
+          pool (engine.getBackgroundJobs().getPool()),
+          mode (info.mode), options (info.options),
           fileInfo (file.getInfo()),
           crossfadeSamples ((int) tracktion::toSamples (info.audioSegmentList->getCrossfadeLength(), sampleRate)),
           numChannelsToUse (juce::jlimit (1, maxNumChannels, fileInfo.numChannels))
@@ -1940,12 +1923,20 @@ struct StretchSegment
                 reader->setReadPosition (0);
             }
 
-            timestretcher.initialise (fileInfo.sampleRate, outputBufferSize, numChannelsToUse,
-                                      info.mode, info.options, false);
-            jassert (timestretcher.isInitialised()); // Have you enabled a TimeStretcher mode?
+            // Segments that are short enough to buffer are stretched in one go which is much quicker
+            numOfflineOutputSamples = (int) std::ceil (segment.getRange().getLength().inSeconds() * sampleRate) + outputBufferSize;
+            numOfflineInputSamples = (int) std::ceil (numOfflineOutputSamples * segment.getStretchRatio());
+            useOfflineRender = numChannelsToUse * ((int64_t) numOfflineInputSamples + numOfflineOutputSamples) <= maxOfflineSamples;
+
+            if (! useOfflineRender)
+            {
+                timestretcher.initialise (fileInfo.sampleRate, outputBufferSize, numChannelsToUse,
+                                          info.mode, info.options, false);
+                jassert (timestretcher.isInitialised()); // Have you enabled a TimeStretcher mode?
 
-            timestretcher.setSpeedAndPitch ((float) (1.0 / segment.getStretchRatio()),
-                                            segment.getTranspose());
+                timestretcher.setSpeedAndPitch ((float) (1.0 / segment.getStretchRatio()),
+                                                segment.getTranspose());
+            }
         }
     }
 
@@ -2001,6 +1992,9 @@ struct StretchSegment
 
     int fillNextBlock()
     {
+        if (useOfflineRender)
+            return fillNextBlockFromOfflineRender();
+
         CRASH_TRACER
         float* outs[maxNumChannels] = {};
 
@@ -2045,6 +2039,59 @@ struct StretchSegment
         return numRead;
     }
 
+    int fillNextBlockFromOfflineRender()
+    {
+        if (offlineBuffer.getNumChannels() == 0)
+            renderOffline();
+
+        const int numReady = std::min (outputBufferSize, offlineBuffer.getNumSamples() - offlineReadPos);
+
+        for (int i = 0; i < numChannelsToUse; ++i)
+        {
+            if (numReady > 0)
+                fifo.copyFrom (i, 0, offlineBuffer, i, offlineReadPos, numReady);
+
+            if (numReady < outputBufferSize)
+                fifo.clear (i, std::max (0, numReady), outputBufferSize - std::max (0, numReady));
+        }
+
+        offlineReadPos += outputBufferSize;
+        readySamplesStart = 0;
+        readySamplesEnd = outputBufferSize;
+
+        return outputBufferSize;
+    }
+
+    void renderOffline()
+    {
+        CRASH_TRACER
+        juce::AudioBuffer<float> input (numChannelsToUse, numOfflineInputSamples);
+        input.clear();
+        auto bufferChannels = juce::AudioChannelSet::canonicalChannelSet (numChannelsToUse);
+
+        for (int pos = 0; pos < numOfflineInputSamples; pos += outputBufferSize * 32)
+        {
+            const int numThisTime = std::min (outputBufferSize * 32, numOfflineInputSamples - pos);
+            juce::AudioBuffer<float> block (input.getArrayOfWritePointers(), numChannelsToUse, pos, numThisTime);
+
+           #if JUCE_DEBUG
+            jassert (reader->readSamples (numThisTime, block, bufferChannels, 0, bufferChannels, 5000));
+           #else
+            reader->readSamples (numThisTime, block, bufferChannels, 0, bufferChannels, 5000);
+           #endif
+        }
+
+        offlineBuffer.setSize (numChannelsToUse, numOfflineOutputSamples);
+
+        const bool ok = TimeStretcher::stretchOfflineChannelSplit (input, offlineBuffer, fileInfo.sampleRate, mode, options,
+                                                                   (float) (1.0 / segment.getStretchRatio()),
+                                                                   segment.getTranspose(), pool);
+        jassert (ok); // Have you enabled a TimeStretcher mode?
+
+        if (! ok)
+            offlineBuffer.clear();
+    }
+
     void renderFades (int numSamples)
     {
         CRASH_TRACER
@@ -2095,8 +2142,13 @@ struct StretchSegment
         }
     }
 
+    static constexpr int64_t maxOfflineSamples = 16 * 1024 * 1024;
+
     const AudioSegmentList::Segment& segment;
     TimeStretcher timestretcher;
+    juce::ThreadPool& pool;
+    const TimeStretcher::Mode mode;
+    const TimeStretcher::ElastiqueProOptions options;
 
     AudioFileInfo fileInfo;
     AudioFileCache::Reader::Ptr reader;
@@ -2107,9 +2159,220 @@ struct StretchSegment
     const int crossfadeSamples, numChannelsToUse;
     juce::AudioBuffer<float> fifo { numChannelsToUse, outputBufferSize };
 
+    bool useOfflineRender = false;
+    int numOfflineInputSamples = 0, numOfflineOutputSamples = 0, offlineReadPos = 0;
+    juce::AudioBuffer<float> offlineBuffer;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StretchSegment)
 };
 
+//==============================================================================
+/**
+    Renders a set of StretchSegments in parallel.
+
+    Each segment has its own reader and time-stretcher so they can be rendered
+    independently and then mixed together. The calling thread works through the output
+    in order, rendering any segment that hasn't been started yet directly into the
+    block being written, so the start of the file is always completed first.
+    Meanwhile, helper jobs on the engine's background pool render later segments in to
+    their own buffers which are mixed in when the output reaches them.
+    The amount of audio helpers can buffer ahead is limited so long files don't use
+    huge amounts of memory.
+*/
+struct ParallelStretchRender
+{
+    static constexpr int samplesPerBlock = 1024;
+    static constexpr int64_t maxSamplesToBufferAhead = 32 * 1024 * 1024;
+
+    ParallelStretchRender (Engine& e, juce::OwnedArray<StretchSegment>& segmentsToRender,
+                           int numChannels_, double sampleRate_, int numBlocks_)
+        : engine (e), numChannels (numChannels_), sampleRate (sampleRate_), numBlocks (numBlocks_)
+    {
+        while (! segmentsToRender.isEmpty())
+        {
+            auto entry = std::make_unique<Entry>();
+            entry->segment.reset (segmentsToRender.removeAndReturn (0));
+
+            const auto range = entry->segment->segment.getRange();
+            entry->firstBlock = juce::jlimit (0, numBlocks - 1, (int) (range.getStart().inSeconds() * sampleRate / samplesPerBlock));
+            entry->lastBlock = juce::jlimit (entry->firstBlock, numBlocks - 1, (int) (range.getEnd().inSeconds() * sampleRate / samplesPerBlock));
+
+            entries.push_back (std::move (entry));
+        }
+    }
+
+    ~ParallelStretchRender()
+    {
+        shouldStop = true;
+        bufferFreed.signal();
+
+        for (auto& h : helpers)
+            engine.getBackgroundJobs().getPool().removeJob (h.get(), true, -1);
+    }
+
+    bool render (AudioFileWriter& writer, juce::ThreadPoolJob* const& job, std::atomic<float>& progress)
+    {
+        auto& pool = engine.getBackgroundJobs().getPool();
+        const auto numHelpers = std::min ((int) entries.size(), pool.getNumThreads()) - 1;
+
+        for (int i = 0; i < numHelpers; ++i)
+        {
+            helpers.push_back (std::make_unique<HelperJob> (*this));
+            pool.addJob (helpers.back().get(), false);
+        }
+
+        juce::AudioBuffer<float> buffer (numChannels, samplesPerBlock);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+
+            for (auto& e : entries)
+            {
+                if (block < e->firstBlock || block > e->lastBlock)
+                    continue;
+
+                auto expected = unclaimed;
+
+                if (e->state == streaming || e->state.compare_exchange_strong (expected, streaming))
+                {
+                    e->segment->renderNextBlock (buffer, getBlockTime (block), samplesPerBlock);
+                    continue;
+                }
+
+                while (e->state != done)
+                {
+                    if (job != nullptr && job->shouldExit())
+                        return false;
+
+                    segmentRendered.wait (50);
+                }
+
+                const auto offset = (block - e->firstBlock) * samplesPerBlock;
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    buffer.addFrom (chan, 0, e->buffer, chan, offset, samplesPerBlock);
+
+                if (block == e->lastBlock)
+                {
+                    numSamplesBuffered -= e->buffer.getNumChannels() * (int64_t) e->buffer.getNumSamples();
+                    e->buffer.setSize (0, 0);
+                    bufferFreed.signal();
+                }
+            }
+
+            if (job != nullptr && job->shouldExit())
+                return false;
+
+            if (! writer.appendBuffer (buffer, samplesPerBlock))
+                return false;
+
+            progress = block / (float) numBlocks;
+        }
+
+        return true;
+    }
+
+private:
+    enum State { unclaimed, streaming, rendering, done };
+
+    struct Entry
+    {
+        std::unique_ptr<StretchSegment> segment;
+        int firstBlock = 0, lastBlock = 0;
+        juce::AudioBuffer<float> buffer;
+        std::atomic<State> state { unclaimed };
+    };
+
+    struct HelperJob  : public juce::ThreadPoolJob
+    {
+        HelperJob (ParallelStretchRender& o)
+            : ThreadPoolJob ("Stretch segment render"), owner (o) {}
+
+        JobStatus runJob() override
+        {
+            juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+            while (! shouldExit() && owner.renderNextSegment())
+            {}
+
+            return jobHasFinished;
+        }
+
+        ParallelStretchRender& owner;
+    };
+
+    Engine& engine;
+    const int numChannels;
+    const double sampleRate;
+    const int numBlocks;
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::vector<std::unique_ptr<HelperJob>> helpers;
+    std::atomic<int64_t> numSamplesBuffered { 0 };
+    std::atomic<bool> shouldStop { false };
+    juce::WaitableEvent segmentRendered, bufferFreed;
+
+    TimeRange getBlockTime (int block) const
+    {
+        return { TimePosition::fromSeconds (block * samplesPerBlock / sampleRate),
+                 TimePosition::fromSeconds ((block + 1) * samplesPerBlock / sampleRate) };
+    }
+
+    /** Claims and renders the next segment that hasn't been started.
+        Returns false once there are none left.
+    */
+    bool renderNextSegment()
+    {
+        for (auto& entryPtr : entries)
+        {
+            auto& e = *entryPtr;
+
+            if (e.state != unclaimed)
+                continue;
+
+            const auto numSegmentBlocks = e.lastBlock - e.firstBlock + 1;
+            const auto numSamples = numChannels * (int64_t) numSegmentBlocks * samplesPerBlock;
+
+            // Leave segments that won't fit for the calling thread to stream
+            if (numSamples > maxSamplesToBufferAhead)
+                continue;
+
+            // Wait for the writer to catch up rather than buffer too far ahead
+            while (numSamplesBuffered + numSamples > maxSamplesToBufferAhead)
+            {
+                if (shouldStop || e.state != unclaimed)
+                    break;
+
+                bufferFreed.wait (50);
+            }
+
+            auto expected = unclaimed;
+
+            if (shouldStop || ! e.state.compare_exchange_strong (expected, rendering))
+                continue;
+
+            numSamplesBuffered += numSamples;
+            e.buffer.setSize (numChannels, numSegmentBlocks * samplesPerBlock);
+            e.buffer.clear();
+
+            for (int i = 0; i < numSegmentBlocks && ! shouldStop; ++i)
+            {
+                juce::AudioBuffer<float> blockBuffer (e.buffer.getArrayOfWritePointers(), numChannels,
+                                                      i * samplesPerBlock, samplesPerBlock);
+                e.segment->renderNextBlock (blockBuffer, getBlockTime (e.firstBlock + i), samplesPerBlock);
+            }
+
+            e.state = done;
+            segmentRendered.signal();
+            return true;
+        }
+
+        return false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelStretchRender)
+};
+
 //==============================================================================
 std::unique_ptr<AudioClipBase::ProxyRenderingInfo> AudioClipBase::createProxyRenderingInfo()
 {
@@ -2140,33 +2403,10 @@ bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile&
     for (auto& segment : audioSegmentList->getSegments())
         segments.add (new StretchSegment (engine, sourceFile, *this, sampleRate, segment));
 
-    const int samplesPerBlock = 1024;
-    juce::AudioBuffer<float> buffer (sourceFile.getNumChannels(), samplesPerBlock);
-    double time = 0.0;
-
-    auto numBlocks = 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / samplesPerBlock);
-
-    for (int i = 0; i < numBlocks; ++i)
-    {
-        if (job != nullptr && job->shouldExit())
-            return false;
-
-        buffer.clear();
+    auto numBlocks = 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / ParallelStretchRender::samplesPerBlock);
 
-        auto endTime = time + samplesPerBlock / sampleRate;
-        const auto editTime = TimeRange (TimePosition::fromSeconds (time), TimePosition::fromSeconds (endTime));
-        time = endTime;
-
-        for (auto s : segments)
-            s->renderNextBlock (buffer, editTime, samplesPerBlock);
-
-        if (! writer.appendBuffer (buffer, samplesPerBlock))
-            return false;
-
-        progress = i / (float) numBlocks;
-    }
-
-    return true;
+    ParallelStretchRender parallelRender (engine, segments, sourceFile.getNumChannels(), sampleRate, numBlocks);
+    return parallelRender.render (writer, job, progress);
 }
 
 AudioFile AudioClipBase::getPlaybackFile()
@@ -2385,6 +2625,14 @@ void AudioClipBase::valueTreePropertyChanged (juce::ValueTree& tree, const juce:
             {
                 updateAutoCrossfadesAsync (true);
             }
+            else if (id == IDs::pan)
+            {
+                // Centred mono clips are played back in mono so the graph needs rebuilding when they move off centre
+                const bool isCentred = static_cast<float> (state[IDs::pan]) == 0.0f;
+
+                if (std::exchange (panWasCentred, isCentred) != isCentred && activeChannels.size() == 1)
+                    edit.restartPlayback();
+            }
         }
         else if (id == IDs::autoTempo)
         {
@@ -650,11 +650,14 @@ protected:
 
     mutable WarpTimeManager::Ptr warpTimeManager;
     mutable std::unique_ptr<AudioSegmentList> audioSegmentList;
+    HashCode audioSegmentListHash = 0;
+    bool audioSegmentListNeedsCheck = false;
     std::unique_ptr<ClipEffects> clipEffects;
     mutable AsyncFunctionCaller asyncFunctionCaller;
 
     juce::AudioChannelSet activeChannels;
     void updateLeftRightChannelActivenessFlags();
+    bool panWasCentred = true;
 
     PluginList pluginList;
 
@@ -704,6 +707,7 @@ private:
     bool shouldAttemptRender() const    { return (! lastRenderJobFailed) && needsRender(); }
 
     void clearCachedAudioSegmentList();
+    HashCode createAudioSegmentListHash();
 
     //==============================================================================
     void jobFinished (RenderManager::Job& job, bool completedOk) override;
@@ -81,6 +81,28 @@ struct ClipOwner::ClipList : public ValueTreeObjectList<Clip>,
     void objectRemoved (Clip* c) override       { objectAddedOrRemoved (c); }
     void objectOrderChanged() override          { objectAddedOrRemoved (nullptr); }
 
+    void bulkChangeEnded (const juce::Array<Clip*>& added, const juce::Array<Clip*>& removed, bool orderChanged) override
+    {
+        for (auto c : added)
+            if (c->getParent())
+                c->updateAutomationCurveListDestinations();
+
+        // Notify the owner once for all the changes
+        if (orderChanged)
+            clipOwner.clipOrderChanged();
+
+        if (! (added.isEmpty() && removed.isEmpty()))
+            clipOwner.clipAddedOrRemoved();
+
+        if (! edit.isLoading() && ! edit.getUndoManager().isPerformingUndoRedo())
+        {
+            triggerAsyncUpdate();
+
+            for (auto c : added)
+                edit.engine.getEngineBehaviour().newClipAdded (*c, edit.getTransport().isRecordingStopping());
+        }
+    }
+
     void objectAddedOrRemoved (Clip* c)
     {
         if (c == nullptr || c->type != TrackItem::Type::unknown)
@@ -192,13 +214,21 @@ const juce::Array<Clip*>& ClipOwner::getClips() const
     return clipList->objects;
 }
 
+ClipOwner::ScopedBulkChange::ScopedBulkChange (ClipOwner& co)
+    : bulkChange (*co.clipList)
+{
+}
+
 //==============================================================================
 //==============================================================================
 Clip* findClipForState (ClipOwner& co, const juce::ValueTree& v)
 {
-    for (auto c : co.getClips())
-        if (c->state == v)
-            return c;
+    // Search backwards as this is mostly used to find clips that have just been added
+    auto& clips = co.getClips();
+
+    for (int i = clips.size(); --i >= 0;)
+        if (clips.getUnchecked (i)->state == v)
+            return clips.getUnchecked (i);
 
     return {};
 }
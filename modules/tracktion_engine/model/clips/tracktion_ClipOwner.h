@@ -41,6 +41,19 @@ public:
     /** Returns the clips this owner contains. */
     const juce::Array<Clip*>& getClips() const;
 
+    /** Defers the notifications for clips added, removed or reordered whilst it's
+        in scope so adding lots of clips at once only notifies the owner once.
+        The clips are still created straight away so they can be looked up.
+        @see ValueTreeObjectList::ScopedBulkChange
+    */
+    struct ScopedBulkChange
+    {
+        ScopedBulkChange (ClipOwner&);
+
+    private:
+        ValueTreeObjectList<Clip>::ScopedBulkChange bulkChange;
+    };
+
 protected:
     /** Must be called once from the subclass constructor to init the clip owner. */
     void initialiseClipOwner (Edit&, juce::ValueTree clipParentState);
@@ -637,12 +637,23 @@ struct WaveCompManager::CompRenderContext
     {
     }
 
+    ~CompRenderContext()
+    {
+        previousCompFile.deleteFile();
+    }
+
     Engine& engine;
     juce::Array<ProjectItemID> takesIDs;
     const juce::ValueTree takeTree;
     const int activeTakeIndex;
     const double sourceTimeMultiplier, offset, maxLength, crossfadeLength;
 
+    /** A finished render of an earlier version of the comp and the context it was
+        rendered with. The file is owned by this context and deleted with it.
+    */
+    std::unique_ptr<CompRenderContext> previousContext;
+    juce::File previousCompFile;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompRenderContext)
 };
 
@@ -1013,6 +1024,117 @@ WaveCompManager::CompRenderContext* WaveCompManager::createRenderContext() const
                                   getSourceTimeMultiplier(), getOffset(), getMaxCompLength(), xFadeMs / 1000.0);
 }
 
+namespace comp_render
+{
+    /** A take index and the time it ends at, in the comp's output time. */
+    using Segments = std::vector<std::pair<double, int>>;
+
+    static Segments getSegments (const WaveCompManager::CompRenderContext& context)
+    {
+        Segments segments;
+        const auto offset = context.offset / context.sourceTimeMultiplier;
+
+        for (auto compSegment : context.takeTree)
+            segments.emplace_back ((double) compSegment.getProperty (IDs::endTime) / context.sourceTimeMultiplier + offset,
+                                   (int) compSegment.getProperty (IDs::takeIndex));
+
+        return segments;
+    }
+
+    static int getTakeIndexAt (const Segments& segments, double time)
+    {
+        for (auto& segment : segments)
+            if (segment.first > time)
+                return segment.second;
+
+        return -1;
+    }
+
+    static bool containsBoundary (const Segments& segments, double time)
+    {
+        return std::find_if (segments.begin(), segments.end(),
+                             [time] (auto& segment) { return segment.first == time; }) != segments.end();
+    }
+
+    /** Returns the ranges of a comp that will render differently to its previous
+        render, or the whole comp if the previous render can't be used.
+    */
+    static std::vector<TimeRange> getChangedRanges (const WaveCompManager::CompRenderContext& context, TimeRange totalRange)
+    {
+        auto previous = context.previousContext.get();
+
+        if (previous == nullptr
+            || previous->takesIDs != context.takesIDs
+            || previous->sourceTimeMultiplier != context.sourceTimeMultiplier
+            || previous->offset != context.offset
+            || previous->maxLength != context.maxLength
+            || previous->crossfadeLength != context.crossfadeLength)
+            return { totalRange };
+
+        const auto newSegments = getSegments (context);
+        const auto oldSegments = getSegments (*previous);
+
+        std::vector<double> boundaries { context.offset / context.sourceTimeMultiplier };
+
+        for (auto& segment : newSegments)  boundaries.push_back (segment.first);
+        for (auto& segment : oldSegments)  boundaries.push_back (segment.first);
+
+        std::sort (boundaries.begin(), boundaries.end());
+        boundaries.erase (std::unique (boundaries.begin(), boundaries.end()), boundaries.end());
+
+        // A section has changed if it plays a different take or one of its ends only
+        // exists in one of the comps. Either way, the crossfades around it change too
+        std::vector<TimeRange> changedRanges;
+        const auto crossfadeLength = TimeDuration::fromSeconds (context.crossfadeLength);
+
+        auto addChangedRange = [&] (double start, double end)
+        {
+            auto range = TimeRange (TimePosition::fromSeconds (start), TimePosition::fromSeconds (end))
+                           .expanded (crossfadeLength);
+
+            if (! changedRanges.empty() && changedRanges.back().getEnd() >= range.getStart())
+                changedRanges.back() = changedRanges.back().getUnionWith (range);
+            else
+                changedRanges.push_back (range);
+        };
+
+        for (size_t i = 0; i < boundaries.size(); ++i)
+        {
+            const auto boundary = boundaries[i];
+
+            if (containsBoundary (newSegments, boundary) != containsBoundary (oldSegments, boundary))
+                addChangedRange (boundary, boundary);
+
+            if (i + 1 < boundaries.size())
+            {
+                const auto midTime = (boundary + boundaries[i + 1]) / 2.0;
+
+                if (getTakeIndexAt (newSegments, midTime) != getTakeIndexAt (oldSegments, midTime))
+                    addChangedRange (boundary, boundaries[i + 1]);
+            }
+        }
+
+        return changedRanges;
+    }
+
+    static std::unique_ptr<juce::AudioFormatReader> createPreviousRenderReader (const WaveCompManager::CompRenderContext& context,
+                                                                                const AudioFileWriter& writer, SampleCount numSamplesNeeded)
+    {
+        if (context.previousContext == nullptr || ! context.previousCompFile.existsAsFile())
+            return {};
+
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (context.engine, context.previousCompFile));
+
+        if (reader == nullptr
+            || reader->sampleRate != writer.getSampleRate()
+            || (int) reader->numChannels != writer.getNumChannels()
+            || reader->lengthInSamples < numSamplesNeeded)
+            return {};
+
+        return reader;
+    }
+}
+
 bool WaveCompManager::renderTake (CompRenderContext& context, Edit& edit, AudioFileWriter& writer,
                                   juce::ThreadPoolJob& job, std::atomic<float>& progress)
 {
@@ -1096,6 +1218,20 @@ bool WaveCompManager::renderTake (CompRenderContext& context, Edit& edit, AudioF
     const SampleCount totalSamples = juce::roundToInt (totalRange.getLength().inSeconds() * writer.getSampleRate());
     SampleCount samplesDone = 0;
 
+    // Blocks that don't overlap any changes can be copied from the previous render
+    auto previousRenderReader = comp_render::createPreviousRenderReader (context, writer, totalSamples);
+    const auto changedRanges = previousRenderReader != nullptr ? comp_render::getChangedRanges (context, totalRange)
+                                                               : std::vector<TimeRange> { totalRange };
+
+    auto needsRendering = [&changedRanges, sampleRate] (SampleCount start, SampleCount end)
+    {
+        const auto blockTime = TimeRange (TimePosition::fromSamples (start, sampleRate),
+                                          TimePosition::fromSamples (end, sampleRate));
+
+        return std::any_of (changedRanges.begin(), changedRanges.end(),
+                            [&blockTime] (auto r) { return r.intersects (blockTime); });
+    };
+
     playHead.playSyncedToRange ({ 0, totalSamples });
 
     for (;;)
@@ -1119,8 +1255,19 @@ bool WaveCompManager::renderTake (CompRenderContext& context, Edit& edit, AudioF
         pc.buffers.audio.clear();
         pc.buffers.midi.clear();
 
-        auto misses = nodePlayer->process (pc);
-        jassert (misses == 0); (void) misses;
+        juce::AudioBuffer<float> buffer (pc.buffers.audio.data.channels,
+                                         (int) pc.buffers.audio.getNumChannels(),
+                                         (int) pc.buffers.audio.getNumFrames());
+
+        if (needsRendering (samplesDone, samplesDone + samplesToDo))
+        {
+            auto misses = nodePlayer->process (pc);
+            jassert (misses == 0); (void) misses;
+        }
+        else
+        {
+            previousRenderReader->read (&buffer, 0, buffer.getNumSamples(), samplesDone, true, true);
+        }
 
         samplesDone += samplesToDo;
         progress = juce::jlimit (0.0f, 0.9f, (float) (0.9 * samplesDone / (double) totalSamples));
@@ -1128,10 +1275,6 @@ bool WaveCompManager::renderTake (CompRenderContext& context, Edit& edit, AudioF
         if (job.shouldExit() || ! writer.isOpen())
             return false;
 
-        juce::AudioBuffer<float> buffer (pc.buffers.audio.data.channels,
-                                         (int) pc.buffers.audio.getNumChannels(),
-                                         (int) pc.buffers.audio.getNumFrames());
-
         if (! writer.appendBuffer (buffer, buffer.getNumSamples()))
             break;
     }
@@ -1148,11 +1291,15 @@ class CompGeneratorJob  : public AudioProxyGenerator::GeneratorJob
 public:
     using Ptr = juce::ReferenceCountedObjectPtr<GeneratorJob>;
 
-    CompGeneratorJob (WaveAudioClip& wc, const AudioFile& comp)
+    CompGeneratorJob (WaveAudioClip& wc, const AudioFile& comp,
+                      std::unique_ptr<WaveCompManager::CompRenderContext> previousContext,
+                      const juce::File& previousCompFile)
         : GeneratorJob (comp), engine (wc.edit.engine), edit (wc.edit),
           context (wc.getCompManager().createRenderContext())
     {
         setName (TRANS("Creating Comp") + ": " + wc.getName());
+        context->previousContext = std::move (previousContext);
+        context->previousCompFile = previousCompFile;
     }
 
 private:
@@ -1222,13 +1369,16 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompGeneratorJob)
 };
 
-static void beginCompGeneration (WaveAudioClip& clip, int takeIndex)
+static void beginCompGeneration (WaveAudioClip& clip, int takeIndex,
+                                 std::unique_ptr<WaveCompManager::CompRenderContext> previousContext,
+                                 const juce::File& previousCompFile)
 {
     CRASH_TRACER
     auto& cm = clip.getCompManager();
 
     clip.edit.engine.getAudioFileManager()
-       .proxyGenerator.beginJob (new CompGeneratorJob (clip, TemporaryFileManager::getFileForCachedCompRender (clip, cm.getTakeHash (takeIndex))));
+       .proxyGenerator.beginJob (new CompGeneratorJob (clip, TemporaryFileManager::getFileForCachedCompRender (clip, cm.getTakeHash (takeIndex)),
+                                                       std::move (previousContext), previousCompFile));
 }
 
 void WaveCompManager::timerCallback()
@@ -1244,11 +1394,33 @@ void WaveCompManager::timerCallback()
     auto takeIndex = getActiveTakeIndex();
     auto hash = getTakeHash (takeIndex);
 
+    std::unique_ptr<CompRenderContext> previousContext;
+    juce::File previousCompFile;
+
     if (isTakeComp (lastRenderedTake) && hash != lastHash)
     {
+        auto& afm = clip.edit.engine.getAudioFileManager();
+        auto lastRender = TemporaryFileManager::getFileForCachedCompRender (clip, lastHash);
+
+        // If the last render finished, move it aside so the next one can copy the unchanged sections from it
+        if (lastRenderContext != nullptr
+            && ! afm.proxyGenerator.isProxyBeingGenerated (lastRender)
+            && lastRender.isValid())
+        {
+            auto tempFile = lastRender.getFile().getSiblingFile ("previous_comp_" + juce::String::toHexString (juce::Random::getSystemRandom().nextInt64()))
+                              .withFileExtension (lastRender.getFile().getFileExtension());
+            afm.releaseFile (lastRender);
+
+            if (lastRender.getFile().moveFileTo (tempFile))
+            {
+                previousContext = std::move (lastRenderContext);
+                previousCompFile = tempFile;
+            }
+        }
+
         // stops the last render job and deletes the source
-        clip.edit.engine.getAudioFileManager().proxyGenerator
-           .deleteProxy (TemporaryFileManager::getFileForCachedCompRender (clip, lastHash));
+        afm.proxyGenerator.deleteProxy (lastRender);
+        lastRenderContext.reset();
     }
 
     lastRenderedTake = takeIndex;
@@ -1259,13 +1431,16 @@ void WaveCompManager::timerCallback()
 
     if (isComp && (! lastCompFile.isValid()))
     {
-        auto takeTree = takesTree.getChild (lastRenderedTake);
-        beginCompGeneration (clip, lastRenderedTake);
+        lastRenderContext.reset (createRenderContext());
+        beginCompGeneration (clip, lastRenderedTake, std::move (previousContext), previousCompFile);
         compUpdater->setCompFile (lastCompFile);
     }
-    else if (! isComp)
+    else
     {
-        lastHash = 0;
+        if (! isComp)
+            lastHash = 0;
+
+        previousCompFile.deleteFile();
     }
 
     if (clip.getCurrentSourceFile() != lastCompFile.getFile())
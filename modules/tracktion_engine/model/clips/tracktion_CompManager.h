@@ -280,6 +280,8 @@ public:
     CompRenderContext* createRenderContext() const;
 
     /** Renders the comp using the given writer and ThreadPoolJob.
+        If the context has a previous render of the same takes, only the sections
+        around the changed parts of the comp are rendered and the rest is copied from it.
         This will return true if the comp was successfully completed or false if it failed.
         Note that this should only be called for comp takes and will simply return true for full takes.
     */
@@ -300,6 +302,8 @@ private:
     struct CompUpdater;
     std::unique_ptr<CompUpdater> compUpdater;
 
+    std::unique_ptr<CompRenderContext> lastRenderContext;
+
     void setProjectItemIDForTake (int takeIndex, ProjectItemID) const;
     ProjectItemID getProjectItemIDForTake (int takeIndex) const;
     AudioFile getSourceFileForTake (int takeIndex) const;
@@ -11,8 +11,83 @@
 namespace tracktion { inline namespace engine
 {
 
+//==============================================================================
+struct ContainerClip::ContentsRenderer  : public juce::AsyncUpdater,
+                                          private RenderManager::Job::Listener
+{
+    ContentsRenderer (ContainerClip& c)
+        : clip (c)
+    {
+    }
+
+    ~ContentsRenderer() override
+    {
+        cancelPendingUpdate();
+        stopJob();
+    }
+
+private:
+    ContainerClip& clip;
+    RenderManager::Job::Ptr job;
+    AudioFile lastFailedRender;
+
+    void handleAsyncUpdate() override
+    {
+        if (! clip.canPreRenderContents())
+        {
+            stopJob();
+            return;
+        }
+
+        auto file = TemporaryFileManager::getFileForCachedClipRender (clip, clip.getContentsRenderHash());
+
+        if (file.getFile().existsAsFile() || file == lastFailedRender)
+        {
+            stopJob();
+            return;
+        }
+
+        if (job != nullptr && job->proxy == file)
+            return;
+
+        stopJob();
+        job = ContainerClipRenderJob::getOrCreateRenderJob (clip, file);
+
+        if (job != nullptr)
+            job->addListener (this);
+    }
+
+    void jobFinished (RenderManager::Job& finishedJob, bool completedOk) override
+    {
+        TRACKTION_ASSERT_MESSAGE_THREAD
+
+        if (&finishedJob != job.get())
+            return;
+
+        if (! completedOk)
+            lastFailedRender = job->proxy;
+
+        stopJob();
+
+        // Rebuilds the graph so the render is played
+        if (completedOk)
+            clip.edit.restartPlayback();
+    }
+
+    void stopJob()
+    {
+        if (job != nullptr)
+        {
+            job->removeListener (this);
+            job = nullptr;
+        }
+    }
+};
+
+//==============================================================================
 ContainerClip::ContainerClip (const juce::ValueTree& v, EditItemID clipID, ClipOwner& targetParent)
-    : AudioClipBase (v, clipID, Type::container, targetParent)
+    : AudioClipBase (v, clipID, Type::container, targetParent),
+      contentsRenderer (std::make_unique<ContentsRenderer> (*this))
 {
 }
 
@@ -77,6 +152,100 @@ HashCode ContainerClip::getHash() const
     return static_cast<HashCode> (hash);
 }
 
+//==============================================================================
+bool ContainerClip::canPreRenderContents() const
+{
+    const auto& clips = getClips();
+
+    if (clips.isEmpty())
+        return false;
+
+    for (auto c : clips)
+    {
+        // Plugins can't be used by a render and live playback at the same time
+        // and anything other than an audio clip is played live
+        auto acb = dynamic_cast<AudioClipBase*> (c);
+
+        if (acb == nullptr || dynamic_cast<ContainerClip*> (c) != nullptr || acb->isUsingMelodyne())
+            return false;
+
+        if (auto pluginList = acb->getPluginList(); pluginList != nullptr && pluginList->size() > 0)
+            return false;
+    }
+
+    return true;
+}
+
+HashCode ContainerClip::getContentsRenderHash() const
+{
+    auto hash = static_cast<size_t> (getHash());
+
+    auto combinePosition = [&hash] (ClipPosition pos)
+    {
+        hash_combine (hash, pos.getStart().inSeconds());
+        hash_combine (hash, pos.getLength().inSeconds());
+        hash_combine (hash, pos.getOffset().inSeconds());
+    };
+
+    combinePosition (getPosition());
+    hash_combine (hash, getLoopRangeBeats().getStart().inBeats());
+    hash_combine (hash, getLoopRangeBeats().getLength().inBeats());
+    hash_combine (hash, getLoopRange().getStart().inSeconds());
+    hash_combine (hash, getLoopRange().getLength().inSeconds());
+
+    for (auto c : getClipsOfType<AudioClipBase> (*this))
+    {
+        combinePosition (c->getPosition());
+        hash_combine (hash, c->disabled.get());
+        hash_combine (hash, c->getGainDB());
+        hash_combine (hash, c->getPan());
+        hash_combine (hash, c->isMuted());
+        hash_combine (hash, c->getFadeIn().inSeconds());
+        hash_combine (hash, c->getFadeOut().inSeconds());
+        hash_combine (hash, static_cast<int> (c->getFadeInType()));
+        hash_combine (hash, static_cast<int> (c->getFadeOutType()));
+        hash_combine (hash, static_cast<int> (c->getFadeInBehaviour()));
+        hash_combine (hash, static_cast<int> (c->getFadeOutBehaviour()));
+        hash_combine (hash, c->getAutoTempo());
+        hash_combine (hash, c->getSpeedRatio());
+        hash_combine (hash, c->getPitchChange());
+        hash_combine (hash, c->getLoopRangeBeats().getStart().inBeats());
+        hash_combine (hash, c->getLoopRangeBeats().getLength().inBeats());
+        hash_combine (hash, c->getLoopRange().getStart().inSeconds());
+        hash_combine (hash, c->getLoopRange().getLength().inSeconds());
+
+        for (auto type : c->getActiveChannels().getChannelTypes())
+            hash_combine (hash, static_cast<int> (type));
+    }
+
+    // The contents are positioned in beats so any tempo change can move them
+    for (auto t : edit.tempoSequence.getTempos())
+    {
+        hash_combine (hash, t->getStartBeat().inBeats());
+        hash_combine (hash, t->getBpm());
+        hash_combine (hash, t->getCurve());
+    }
+
+    return static_cast<HashCode> (hash);
+}
+
+AudioFile ContainerClip::getPreRenderedContents()
+{
+    if (! canPreRenderContents())
+        return {};
+
+    auto file = TemporaryFileManager::getFileForCachedClipRender (*this, getContentsRenderHash());
+
+    // The render is written to a temporary file first so if this exists it's complete
+    if (file.getFile().existsAsFile())
+        return file;
+
+    // This can be called whilst the graph is built on other threads so the render is started asynchronously
+    contentsRenderer->triggerAsyncUpdate();
+    return {};
+}
+
+//==============================================================================
 void ContainerClip::setLoopDefaults()
 {
     auto& ts = edit.tempoSequence;
@@ -63,6 +63,24 @@ public:
     /** @internal */
     HashCode getHash() const override;
 
+    //==============================================================================
+    /** Returns true if the contents of this clip can be rendered to a file and played back from that.
+        This is only possible if all the contained clips are audio clips without any plugins.
+    */
+    bool canPreRenderContents() const;
+
+    /** Returns a hash of everything that changes the sound of the contents, used to name their render. */
+    HashCode getContentsRenderHash() const;
+
+    /** Returns the render of this clip's contents if it has been made.
+        If it hasn't, a render is started in the background and a null AudioFile returned.
+        Once the render completes, playback is restarted so it can be used.
+        This can be called on any thread.
+        @see CreateNodeParams::usePreRenderedContainerClips
+    */
+    AudioFile getPreRenderedContents();
+
+    //==============================================================================
     /** @internal */
     void setLoopDefaults() override;
     /** @internal */
@@ -78,6 +96,9 @@ private:
     //==============================================================================
     juce::ValueTree clipListState;
 
+    struct ContentsRenderer;
+    std::unique_ptr<ContentsRenderer> contentsRenderer;
+
     void clipCreated (Clip&) override;
     void clipAddedOrRemoved() override;
     void clipOrderChanged() override;
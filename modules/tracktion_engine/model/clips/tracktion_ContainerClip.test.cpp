@@ -29,6 +29,7 @@ public:
     {
         runBasicContainerClipTests();
         runContainerClipTests();
+        runPreRenderTests();
     }
 
 private:
@@ -375,6 +376,53 @@ private:
             expectPeak (*this, res, { 4_tp, 5_tp }, 0.25f);
         }
     }
+
+    void runPreRenderTests()
+    {
+        using namespace tracktion::graph::test_utilities;
+        using namespace tracktion::engine::test_utilities;
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = createTestEdit (engine);
+        auto audioTrack = getAudioTracks (*edit)[0];
+        auto squareFile = getSquareFile<juce::WavAudioFormat> (44100.0, 2.0, 1, 220.0f);
+
+        auto cc = dynamic_cast<ContainerClip*> (insertNewClip (*audioTrack, TrackItem::Type::container, { 0_tp, 5_tp }));
+        expect (cc != nullptr);
+
+        beginTest ("Pre-render eligibility");
+        {
+            expect (! cc->canPreRenderContents(), "Empty clips shouldn't be rendered");
+
+            auto clip = insertWaveClip (*cc, {}, squareFile->getFile(), {{ 1_tp, 2_tp }}, DeleteExistingClips::no);
+            expect (cc->canPreRenderContents());
+
+            clip->getPluginList()->insertPlugin (VolumeAndPanPlugin::create(), 0);
+            expect (! cc->canPreRenderContents(), "Clips with plugins should be played live");
+        }
+
+        beginTest ("Pre-render hash");
+        {
+            auto clip = insertWaveClip (*cc, {}, squareFile->getFile(), {{ 3_tp, 4_tp }}, DeleteExistingClips::no);
+            const auto originalHash = cc->getContentsRenderHash();
+            expectEquals (cc->getContentsRenderHash(), originalHash);
+
+            clip->setStart (3.5s, false, true);
+            const auto movedChildHash = cc->getContentsRenderHash();
+            expect (movedChildHash != originalHash, "Moving a child should change the hash");
+
+            clip->setGainDB (-6.0f);
+            const auto gainHash = cc->getContentsRenderHash();
+            expect (gainHash != movedChildHash, "Changing a child's gain should change the hash");
+
+            cc->setStart (1s, false, true);
+            const auto movedHash = cc->getContentsRenderHash();
+            expect (movedHash != gainHash, "Moving the container should change the hash");
+
+            edit->tempoSequence.getTempos()[0]->setBpm (90.0);
+            expect (cc->getContentsRenderHash() != movedHash, "Changing the tempo should change the hash");
+        }
+    }
 };
 
 static ContainerClipTests containerClipTests;
@@ -0,0 +1,198 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+struct ContainerClipRenderJob::RenderContext
+{
+    RenderContext (const tempo::Sequence& sequenceToCopy)
+        : tempoSequence (sequenceToCopy)
+    {
+    }
+
+    // The tempo sequence is copied so the render doesn't depend on the Edit's
+    const tempo::Sequence tempoSequence;
+    tracktion::graph::PlayHead playHead;
+    tracktion::graph::PlayHeadState playHeadState { playHead };
+    ProcessState processState { playHeadState, tempoSequence };
+    std::unique_ptr<TracktionNodePlayer> nodePlayer;
+
+    std::unique_ptr<juce::TemporaryFile> tempFile;
+    std::unique_ptr<AudioFileWriter> writer;
+    juce::AudioBuffer<float> buffer;
+    MidiMessageArray midi;
+    TimePosition streamTime;
+};
+
+//==============================================================================
+RenderManager::Job::Ptr ContainerClipRenderJob::getOrCreateRenderJob (ContainerClip& clip, const AudioFile& destination)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (auto ptr = clip.edit.engine.getRenderManager().getRenderJobWithoutCreating (destination))
+        return ptr;
+
+    return *new ContainerClipRenderJob (clip, destination);
+}
+
+ContainerClipRenderJob::ContainerClipRenderJob (ContainerClip& clip, const AudioFile& destination)
+    : Job (clip.edit.engine, destination),
+      edit (clip.edit),
+      clipID (clip.itemID),
+      timeRange (clip.getEditTimeRange()),
+      sampleRate (clip.edit.engine.getDeviceManager().getSampleRate()),
+      blockSize (clip.edit.engine.getDeviceManager().getBlockSize()),
+      context (std::make_unique<RenderContext> (clip.edit.tempoSequence.getInternalSequence()))
+{
+}
+
+ContainerClipRenderJob::~ContainerClipRenderJob()
+{
+    // The Nodes may hold on to Edit objects so must be deleted on the message thread
+    if (context != nullptr && context->nodePlayer != nullptr)
+        callBlockingCatching ([this] { context->nodePlayer.reset(); });
+}
+
+//==============================================================================
+bool ContainerClipRenderJob::setUpRender()
+{
+    CRASH_TRACER
+
+    if (sampleRate <= 0.0 || blockSize <= 0 || timeRange.isEmpty())
+        return false;
+
+    std::unique_ptr<tracktion::graph::Node> node;
+
+    try
+    {
+        callBlocking ([this, &node]
+                      {
+                          if (auto clip = dynamic_cast<ContainerClip*> (findClipForID (edit, clipID)))
+                          {
+                              if (! clip->canPreRenderContents())
+                                  return;
+
+                              CreateNodeParams cnp { context->processState };
+                              cnp.sampleRate = sampleRate;
+                              cnp.blockSize = blockSize;
+                              cnp.forRendering = true;
+                              cnp.allowMonoClips = false;
+
+                              node = createNodeForContainerClipContents (*clip, cnp);
+                          }
+                      });
+
+        if (node == nullptr)
+            return false;
+
+        callBlocking ([this, &node]
+                      {
+                          context->nodePlayer = std::make_unique<TracktionNodePlayer> (context->processState);
+                          context->nodePlayer->setNode (std::move (node), sampleRate, blockSize);
+                      });
+    }
+    catch (std::runtime_error&)
+    {
+        return false;
+    }
+
+    context->tempFile = std::make_unique<juce::TemporaryFile> (proxy.getFile(), juce::TemporaryFile::useHiddenFile);
+    context->writer = std::make_unique<AudioFileWriter> (AudioFile (engine, context->tempFile->getFile()),
+                                                         engine.getAudioFileFormatManager().getWavFormat(),
+                                                         2, sampleRate, 32, juce::StringPairArray(), 0);
+
+    if (! context->writer->isOpen())
+        return false;
+
+    context->buffer.setSize (2, blockSize);
+    context->streamTime = timeRange.getStart();
+
+    auto& playHead = context->playHead;
+    playHead.stop();
+    playHead.setPosition (toSamples (context->streamTime, sampleRate));
+    playHead.playSyncedToRange (toSamples ({ context->streamTime, Edit::getMaximumLength() }, sampleRate));
+
+    // Wait for any clips to render their proxies
+    auto leafNodesReady = [nodes = getNodes (*context->nodePlayer->getNode(), tracktion::graph::VertexOrdering::postordering)]
+    {
+        for (auto n : nodes)
+            if (n->getDirectInputNodes().empty() && ! n->isReadyToProcess())
+                return false;
+
+        return true;
+    };
+
+    while (! leafNodesReady())
+    {
+        if (shouldExit())
+            return false;
+
+        juce::Thread::sleep (100);
+    }
+
+    return true;
+}
+
+bool ContainerClipRenderJob::renderNextBlock()
+{
+    CRASH_TRACER
+    auto& c = *context;
+
+    if (c.streamTime >= timeRange.getEnd())
+        return true;
+
+    const auto blockEnd = std::min (c.streamTime + TimeDuration::fromSamples (blockSize, sampleRate), timeRange.getEnd());
+    const auto referenceSampleRange = toSamples ({ c.streamTime, blockEnd }, sampleRate);
+    const auto numSamples = (int) referenceSampleRange.getLength();
+
+    if (numSamples > 0)
+    {
+        c.buffer.clear();
+        c.midi.clear();
+        auto destView = choc::buffer::createChannelArrayView (c.buffer.getArrayOfWritePointers(),
+                                                              (choc::buffer::ChannelCount) c.buffer.getNumChannels(),
+                                                              (choc::buffer::FrameCount) numSamples);
+        c.nodePlayer->process ({ (choc::buffer::FrameCount) numSamples, referenceSampleRange, { destView, c.midi } });
+
+        if (! c.writer->appendBuffer (c.buffer, numSamples))
+            return true;
+    }
+
+    c.streamTime = blockEnd;
+    progress = juce::jlimit (0.0f, 1.0f, (float) ((c.streamTime - timeRange.getStart()) / timeRange.getLength()));
+
+    if (c.streamTime < timeRange.getEnd())
+        return false;
+
+    success = true;
+    return true;
+}
+
+bool ContainerClipRenderJob::completeRender()
+{
+    CRASH_TRACER
+    auto& c = *context;
+    c.playHead.stop();
+
+    if (c.writer != nullptr)
+        c.writer->closeForWriting();
+
+    if (success && c.tempFile != nullptr)
+        success = c.tempFile->overwriteTargetFileWithTemporary();
+
+    if (success)
+        engine.getAudioFileManager().checkFileForChangesAsync (proxy);
+
+    return success;
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,58 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Renders the contents of a ContainerClip, without its plugins or fades, to a
+    file so it can be played back as a single wave file.
+
+    The contents are rendered over the clip's position in the Edit so the file
+    starts at the start of the clip and already includes its offset and looping.
+*/
+class ContainerClipRenderJob   : public RenderManager::Job
+{
+public:
+    /** Returns a job that will have been started to render the clip's contents to the destination.
+        To be notified of when the job completes add yourself as a listener.
+        This job will continue to run untill all references to it are deleted. Once this happens the
+        render will be abandoned. If you delete yourself, make sure to unregister as a listener too.
+    */
+    static Ptr getOrCreateRenderJob (ContainerClip&, const AudioFile& destination);
+
+    /** Destructor. */
+    ~ContainerClipRenderJob() override;
+
+protected:
+    //==============================================================================
+    bool setUpRender() override;
+    bool renderNextBlock() override;
+    bool completeRender() override;
+
+private:
+    //==============================================================================
+    ContainerClipRenderJob (ContainerClip&, const AudioFile& destination);
+
+    Edit& edit;
+    const EditItemID clipID;
+    const TimeRange timeRange;
+    const double sampleRate;
+    const int blockSize;
+
+    struct RenderContext;
+    std::unique_ptr<RenderContext> context;
+    bool success = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ContainerClipRenderJob)
+};
+
+}} // namespace tracktion { inline namespace engine
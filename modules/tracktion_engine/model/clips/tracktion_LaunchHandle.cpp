@@ -70,12 +70,7 @@ void LaunchHandle::stop (std::optional<MonotonicBeat> pos)
 {
     if (currentPlayState.load (std::memory_order_acquire) == PlayState::stopped)
     {
-        if (getQueuedStatus() == QueueState::playQueued)
-        {
-            const std::scoped_lock sl (nextStateMutex);
-            nextState = std::nullopt;
-        }
-
+        clearQueuedPlay();
         return;
     }
 
@@ -113,16 +108,21 @@ auto LaunchHandle::advance (const SyncRange& syncRange) -> SplitStatus
 
     std::optional<NextState> ns;
 
-    const std::unique_lock sl (nextStateMutex, std::try_to_lock); // Keep this lock alive for the block
+    // Most handles won't have anything queued so avoid taking the lock for them
+    std::unique_lock sl (nextStateMutex, std::defer_lock); // Keep this lock alive for the block
 
-    if (sl.owns_lock() && nextState.has_value())
+    if (hasNextState.load (std::memory_order_acquire) && sl.try_lock()
+        && nextState.has_value() && isPublished (*nextState))
         ns = *nextState;
 
     auto clearNextState = [&]
                           {
                               // If ns has a value, nextState must be locked
                               if (ns.has_value())
+                              {
                                   nextState = std::nullopt;
+                                  hasNextState.store (false, std::memory_order_release);
+                              }
                           };
 
     std::optional<QueueState> queuedState       = ns ? std::optional (ns->queuedState) : std::nullopt;
@@ -415,10 +415,56 @@ auto LaunchHandle::advance (const SyncRange& syncRange) -> SplitStatus
 }
 
 //==============================================================================
-void LaunchHandle::pushNextState (QueueState s, std::optional<MonotonicBeat> b)
+namespace launch_handle_batch
+{
+    inline std::atomic<uint64_t>& getNextBatchID()
+    {
+        static std::atomic<uint64_t> nextBatchID { 1 };
+        return nextBatchID;
+    }
+
+    inline std::atomic<uint64_t>& getLastPublishedBatchID()
+    {
+        static std::atomic<uint64_t> lastPublishedBatchID { 0 };
+        return lastPublishedBatchID;
+    }
+
+    inline std::atomic<uint64_t>& getQueueChangeCount()
+    {
+        static std::atomic<uint64_t> queueChangeCount { 0 };
+        return queueChangeCount;
+    }
+}
+
+uint64_t LaunchHandle::getQueueChangeCount()
 {
-    const std::scoped_lock sl (nextStateMutex);
-    nextState = NextState { s, b };
+    return launch_handle_batch::getQueueChangeCount().load (std::memory_order_acquire);
+}
+
+void LaunchHandle::pushNextState (QueueState s, std::optional<MonotonicBeat> b, uint64_t batchID)
+{
+    {
+        const std::scoped_lock sl (nextStateMutex);
+        nextState = NextState { s, b, batchID };
+        hasNextState.store (true, std::memory_order_release);
+    }
+
+    // Incremented after the lock is released so anyone seeing the new count can read the state
+    launch_handle_batch::getQueueChangeCount().fetch_add (1, std::memory_order_acq_rel);
+}
+
+void LaunchHandle::clearQueuedPlay()
+{
+    if (getQueuedStatus() != QueueState::playQueued)
+        return;
+
+    {
+        const std::scoped_lock sl (nextStateMutex);
+        nextState = std::nullopt;
+        hasNextState.store (false, std::memory_order_release);
+    }
+
+    launch_handle_batch::getQueueChangeCount().fetch_add (1, std::memory_order_acq_rel);
 }
 
 std::optional<LaunchHandle::NextState> LaunchHandle::peekNextState() const
@@ -432,4 +478,54 @@ std::optional<LaunchHandle::NextState> LaunchHandle::peekNextState() const
     return {};
 }
 
+bool LaunchHandle::isPublished (const NextState& ns)
+{
+    return ns.batchID <= launch_handle_batch::getLastPublishedBatchID().load (std::memory_order_acquire);
+}
+
+LaunchHandle::Batch::Batch()
+    : batchID (launch_handle_batch::getNextBatchID().fetch_add (1, std::memory_order_relaxed))
+{
+}
+
+LaunchHandle::Batch::~Batch()
+{
+    publish();
+}
+
+void LaunchHandle::Batch::play (LaunchHandle& lh, std::optional<MonotonicBeat> pos)
+{
+    assert (! hasBeenPublished);
+    lh.pushNextState (QueueState::playQueued, pos, batchID);
+}
+
+void LaunchHandle::Batch::stop (LaunchHandle& lh, std::optional<MonotonicBeat> pos)
+{
+    assert (! hasBeenPublished);
+
+    if (lh.getPlayingStatus() == PlayState::stopped)
+    {
+        lh.clearQueuedPlay();
+        return;
+    }
+
+    lh.pushNextState (QueueState::stopQueued, pos, batchID);
+}
+
+void LaunchHandle::Batch::publish()
+{
+    if (std::exchange (hasBeenPublished, true))
+        return;
+
+    // Batches can be published out of order so only ever move the published ID forwards
+    auto& lastPublished = launch_handle_batch::getLastPublishedBatchID();
+    auto current = lastPublished.load (std::memory_order_acquire);
+
+    while (current < batchID
+           && ! lastPublished.compare_exchange_weak (current, batchID, std::memory_order_acq_rel))
+    {}
+
+    launch_handle_batch::getQueueChangeCount().fetch_add (1, std::memory_order_acq_rel);
+}
+
 } // namespace tracktion::inline engine
@@ -74,6 +74,47 @@ public:
     /** Moves the playhead by a given number of beats. */
     void nudge (BeatDuration);
 
+    /** Returns a count that changes whenever an event is queued or cleared on any
+        LaunchHandle, or a Batch is published.
+        Handles only start playing after an event has been queued so if this hasn't
+        changed, any handles that were idle will still be idle.
+    */
+    static uint64_t getQueueChangeCount();
+
+    //==============================================================================
+    /**
+        Queues play and stop events for any number of LaunchHandles and makes them
+        all visible to the audio thread at once when published.
+        Use this when launching lots of clips together, e.g. a whole Scene, so they
+        all start in the same block even if queueing them takes longer than a block.
+        If it hasn't been published already, this will be published when it's destroyed.
+    */
+    class Batch
+    {
+    public:
+        /** Creates an empty Batch. */
+        Batch();
+
+        /** Destructor. Publishes the Batch if it hasn't been already. */
+        ~Batch();
+
+        Batch (const Batch&) = delete;
+        Batch& operator= (const Batch&) = delete;
+
+        /** Queues a LaunchHandle to start playing, optionally at a given beat position. */
+        void play (LaunchHandle&, std::optional<MonotonicBeat>);
+
+        /** Queues a LaunchHandle to stop playing, optionally at a given beat position. */
+        void stop (LaunchHandle&, std::optional<MonotonicBeat>);
+
+        /** Makes all the queued events visible to the audio thread. */
+        void publish();
+
+    private:
+        const uint64_t batchID;
+        bool hasBeenPublished = false;
+    };
+
     //==============================================================================
     /** Represents two beat ranges where the play state can be different in each. */
     struct SplitStatus
@@ -119,14 +160,18 @@ private:
     {
         QueueState queuedState;
         std::optional<MonotonicBeat> queuedPosition;
+        uint64_t batchID = 0;
     };
     static_assert (std::is_trivially_copyable_v<NextState>);
 
     std::optional<NextState> nextState;
     mutable crill::spin_mutex nextStateMutex;
+    std::atomic<bool> hasNextState { false };
 
-    void pushNextState (QueueState, std::optional<MonotonicBeat>);
+    void pushNextState (QueueState, std::optional<MonotonicBeat>, uint64_t batchID = 0);
+    void clearQueuedPlay();
     std::optional<NextState> peekNextState() const;
+    static bool isPublished (const NextState&);
 
     //==============================================================================
     // audio-write, message-read
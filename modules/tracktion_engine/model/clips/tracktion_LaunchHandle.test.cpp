@@ -31,9 +31,76 @@ public:
         runBasicLauchHandleTests();
         runQuantisedLauchHandleTests();
         legatoLauchHandleTests();
+        batchedLaunchHandleTests();
     }
 
 private:
+    void batchedLaunchHandleTests()
+    {
+        beginTest ("Batched launching");
+
+        {
+            SyncRange syncRange;
+            auto advanceSync = [&syncRange] (auto duration)
+                               {
+                                   auto newEnd = syncRange.end;
+                                   newEnd.monotonicBeat.v = newEnd.monotonicBeat.v + duration;
+                                   newEnd.beat = newEnd.beat + duration;
+                                   syncRange = SyncRange { syncRange.end, newEnd };
+
+                                   return syncRange;
+                               };
+
+            std::vector<LaunchHandle> handles (8);
+
+            {
+                LaunchHandle::Batch batch;
+
+                for (auto& h : handles)
+                    batch.play (h, {});
+
+                // Nothing should start until the batch has been published
+                const auto unpublishedRange = advanceSync (0.5_bd);
+
+                for (auto& h : handles)
+                {
+                    expect (h.getQueuedStatus() == LaunchHandle::QueueState::playQueued);
+                    expect (! h.advance (unpublishedRange).playing1);
+                    expect (h.getPlayingStatus() == LaunchHandle::PlayState::stopped);
+                }
+
+                batch.publish();
+            }
+
+            const auto publishedRange = advanceSync (0.5_bd);
+
+            for (auto& h : handles)
+            {
+                auto s = h.advance (publishedRange);
+                expect (s.playing1);
+                expect (s.range1 == BeatRange (0.5_bp, 1_bp));
+                expect (h.getPlayingStatus() == LaunchHandle::PlayState::playing);
+                expect (! h.getQueuedStatus());
+            }
+
+            // Stops are published when the batch goes out of scope
+            {
+                LaunchHandle::Batch batch;
+
+                for (auto& h : handles)
+                    batch.stop (h, {});
+            }
+
+            const auto stoppedRange = advanceSync (0.5_bd);
+
+            for (auto& h : handles)
+            {
+                expect (! h.advance (stoppedRange).playing1);
+                expect (h.getPlayingStatus() == LaunchHandle::PlayState::stopped);
+            }
+        }
+    }
+
     void runBasicLauchHandleTests()
     {
         beginTest ("Non-quantised launching");
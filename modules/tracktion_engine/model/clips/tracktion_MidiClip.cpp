@@ -23,6 +23,12 @@ static std::unique_ptr<MidiList> createLoopRangeDefinesAllRepetitionsSequence (M
     const auto& sysex = sourceSequence.getSysexEvents();
     const auto& controllers = sourceSequence.getControllerEvents();
 
+    // Each repetition uses the same events from the loop range
+    const BeatRange loopRange (loopStartBeats, loopLengthBeats);
+    const auto noteIndexes = sourceSequence.getNoteIndexesOverlapping (loopRange);
+    const auto sysexIndexes = sourceSequence.getSysexEventIndexesIn (loopRange);
+    const auto controllerIndexes = sourceSequence.getControllerEventIndexesIn (loopRange);
+
     auto v = MidiList::createMidiList();
 
     for (int i = 0; i < loopTimes; ++i)
@@ -31,8 +37,9 @@ static std::unique_ptr<MidiList> createLoopRangeDefinesAllRepetitionsSequence (M
         const auto nextLoopPos = loopLengthBeats * (i + 1);
 
         // add the midi notes
-        for (auto note : notes)
+        for (int j = noteIndexes.getStart(); j < noteIndexes.getEnd(); ++j)
         {
+            auto note   = notes.getUnchecked (j);
             auto start  = (note->getStartBeat() - loopStartBeats) + loopPos;
             auto length = note->getLengthBeats();
 
@@ -50,8 +57,9 @@ static std::unique_ptr<MidiList> createLoopRangeDefinesAllRepetitionsSequence (M
         }
 
         // add the sysex
-        for (auto oldEvent : sysex)
+        for (int j = sysexIndexes.getStart(); j < sysexIndexes.getEnd(); ++j)
         {
+            auto oldEvent = sysex.getUnchecked (j);
             const auto start = (oldEvent->getBeatPosition() - loopStartBeats) + loopPos;
 
             if (start >= loopPos && start < nextLoopPos)
@@ -59,8 +67,9 @@ static std::unique_ptr<MidiList> createLoopRangeDefinesAllRepetitionsSequence (M
         }
 
         // add the controller
-        for (auto oldEvent : controllers)
+        for (int j = controllerIndexes.getStart(); j < controllerIndexes.getEnd(); ++j)
         {
+            auto oldEvent = controllers.getUnchecked (j);
             const auto start = (oldEvent->getBeatPosition() - loopStartBeats) + loopPos;
 
             if (start >= loopPos && start < nextLoopPos)
@@ -96,7 +105,7 @@ MidiClip::MidiClip (const juce::ValueTree& v, EditItemID id, ClipOwner& targetPa
     sendPatch.referTo (state, IDs::sendProgramChange, um, true);
     sendBankChange.referTo (state, IDs::sendBankChange, um, true);
     mpeMode.referTo (state, IDs::mpeMode, um, false);
-    grooveStrength.referTo (state, IDs::grooveStrength, um, 0.1f);
+    grooveStrength->referTo (state, IDs::grooveStrength, um, 0.1f);
 
     loopStartBeats.referTo (state, IDs::loopStartBeats, um, BeatPosition());
     loopLengthBeats.referTo (state, IDs::loopLengthBeats, um, BeatDuration());
@@ -205,7 +214,7 @@ void MidiClip::cloneFrom (Clip* c)
         sendPatch               .setValue (other->sendPatch, nullptr);
         sendBankChange          .setValue (other->sendBankChange, nullptr);
         grooveTemplate          .setValue (other->grooveTemplate, nullptr);
-        grooveStrength          .setValue (other->grooveStrength, nullptr);
+        grooveStrength->setValue (*other->grooveStrength, nullptr);
 
         quantisation->setType (other->quantisation->getType (false));
         quantisation->setProportion (other->quantisation->getProportion());
@@ -369,6 +378,49 @@ void MidiClip::legatoNote (MidiNote& note, const juce::Array<MidiNote*>& notesTo
         note.setStartAndLength (note.getStartBeat(), diff, &um);
 }
 
+void MidiClip::legatoNotes (const juce::Array<MidiNote*>& notesToUse,
+                            const BeatPosition maxEndBeat, juce::UndoManager& um)
+{
+    if (notesToUse.isEmpty())
+        return;
+
+    auto& sequence = getSequence();
+    const auto lastInSequence = sequence.getNotes().getLast();
+    const auto numNotes = (size_t) notesToUse.size();
+
+    std::vector<BeatPosition> startBeats;
+    startBeats.reserve (numNotes);
+
+    for (auto n : notesToUse)
+        startBeats.push_back (n->getQuantisedStartBeat (*this));
+
+    // Working backwards finds the next different start for each note in one pass,
+    // where legatoNote has to search forwards from every note
+    std::vector<std::optional<BeatPosition>> nextStartBeats (numNotes);
+
+    for (auto i = numNotes - 1; i-- > 0;)
+        nextStartBeats[i] = startBeats[i + 1] != startBeats[i] ? std::optional (startBeats[i + 1])
+                                                               : nextStartBeats[i + 1];
+
+    auto values = MidiList::getNoteValues (notesToUse);
+
+    for (size_t i = 0; i < numNotes; ++i)
+    {
+        if (! nextStartBeats[i])
+        {
+            if (notesToUse.getUnchecked ((int) i) == lastInSequence)
+                values[i].lengthBeats = maxEndBeat - startBeats[i];
+
+            continue;
+        }
+
+        if (const auto diff = *nextStartBeats[i] - startBeats[i]; diff > BeatDuration())
+            values[i].lengthBeats = diff;
+    }
+
+    sequence.setNoteValues (notesToUse, values, &um);
+}
+
 //==============================================================================
 MidiList* MidiClip::getMidiListForState (const juce::ValueTree& v)
 {
@@ -81,8 +81,13 @@ public:
 
     bool usesGrooveStrength() const;
 
-    float getGrooveStrength() const                                 { return grooveStrength; }
-    void setGrooveStrength (float g)                                { grooveStrength = juce::jlimit (0.0f, 1.0f, g); }
+    float getGrooveStrength() const                                 { return grooveStrength->get(); }
+    void setGrooveStrength (float g)                                { *grooveStrength = juce::jlimit (0.0f, 1.0f, g); }
+
+    /** Returns the groove strength in a form that can be read whilst the clip is
+        playing, without worrying about the clip being deleted.
+    */
+    std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>> getLiveGrooveStrength() const   { return grooveStrength; }
 
     //==============================================================================
     void mergeInMidiSequence (juce::MidiMessageSequence&, MidiList::NoteAutomationType);
@@ -102,6 +107,14 @@ public:
     void legatoNote (MidiNote& note, const juce::Array<MidiNote*>& notesToUse,
                      BeatPosition maxEndBeat, juce::UndoManager&);
 
+    /** Applies legatoNote to all the notes in an array at once.
+        This is much quicker than calling legatoNote for each one when there are lots of notes.
+
+        @note notesToUse must be in ascending note start order.
+    */
+    void legatoNotes (const juce::Array<MidiNote*>& notesToUse,
+                      BeatPosition maxEndBeat, juce::UndoManager&);
+
     //==============================================================================
     float getVolumeDb() const                       { return level->dbGain.get(); }
     void setVolumeDb (float v)                      { level->dbGain = juce::jlimit (-100.0f, 0.0f, v); }
@@ -189,7 +202,7 @@ private:
     std::unique_ptr<FollowActions> followActions;
 
     juce::CachedValue<int> proxyAllowed, currentTake;
-    juce::CachedValue<float> grooveStrength;
+    std::shared_ptr<juce::CachedValue<AtomicWrapper<float>>> grooveStrength { std::make_shared<juce::CachedValue<AtomicWrapper<float>>>() };
     juce::CachedValue<BeatPosition> loopStartBeats;
     juce::CachedValue<BeatDuration> loopLengthBeats, originalLength;
     std::unique_ptr<QuantisationType> quantisation;
@@ -162,6 +162,9 @@ void StepClip::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identif
 {
     Clip::valueTreePropertyChanged (v, i);
 
+    if (v.hasType (IDs::CHANNEL) && v.getParent().hasType (IDs::PATTERN))
+        invalidateCachedPatterns (v);
+
     if (i == IDs::sequence || i == IDs::repeatSequence)
         updatePatternList();
 
@@ -184,6 +187,7 @@ void StepClip::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identif
 void StepClip::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
 {
     Clip::valueTreeChildAdded (p, c);
+    invalidateCachedPatterns (p);
 
     if (p.hasType (IDs::PATTERN))
         changed();
@@ -192,6 +196,7 @@ void StepClip::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
 void StepClip::valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree& c, int oldIndex)
 {
     Clip::valueTreeChildRemoved (p, c, oldIndex);
+    invalidateCachedPatterns (p);
 
     if (p.hasType (IDs::PATTERN))
         changed();
@@ -200,10 +205,67 @@ void StepClip::valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree& c, in
 void StepClip::valueTreeChildOrderChanged (juce::ValueTree& p, int o, int n)
 {
     Clip::valueTreeChildOrderChanged (p, o, n);
+    invalidateCachedPatterns (p);
 
     changed();
 }
 
+//==============================================================================
+const StepClip::Pattern::CachedPattern& StepClip::getCachedPattern (const Pattern& pattern, int channel)
+{
+    // This should only be called with the cachedPatternLock held
+    jassert (pattern.state.getParent().isValid());
+    const auto patternIndex = (size_t) std::max (0, pattern.state.getParent().indexOf (pattern.state));
+
+    if (patternIndex >= cachedPatterns.size())
+        cachedPatterns.resize (patternIndex + 1);
+
+    auto& rows = cachedPatterns[patternIndex];
+
+    if ((size_t) channel >= rows.size())
+        rows.resize ((size_t) channel + 1);
+
+    auto& row = rows[(size_t) channel];
+
+    if (row == nullptr)
+        row = std::make_unique<Pattern::CachedPattern> (pattern, channel);
+
+    return *row;
+}
+
+void StepClip::invalidateCachedPatterns (const juce::ValueTree& v)
+{
+    const juce::ScopedLock sl (cachedPatternLock);
+
+    if (v.hasType (IDs::CHANNEL))
+    {
+        // Just the one row of the pattern it belongs to
+        auto patternState = v.getParent();
+        const auto patternIndex = patternState.getParent().indexOf (patternState);
+        const auto channelIndex = patternState.indexOf (v);
+
+        if (juce::isPositiveAndBelow (patternIndex, (int) cachedPatterns.size()))
+        {
+            auto& rows = cachedPatterns[(size_t) patternIndex];
+
+            if (juce::isPositiveAndBelow (channelIndex, (int) rows.size()))
+                rows[(size_t) channelIndex].reset();
+        }
+    }
+    else if (v.hasType (IDs::PATTERN))
+    {
+        // Channels have been added, removed or moved so the rows no longer line up
+        const auto patternIndex = v.getParent().indexOf (v);
+
+        if (juce::isPositiveAndBelow (patternIndex, (int) cachedPatterns.size()))
+            cachedPatterns[(size_t) patternIndex].clear();
+    }
+    else if (v.hasType (IDs::PATTERNS) || v == state)
+    {
+        cachedPatterns.clear();
+    }
+}
+
 //==============================================================================
 bool StepClip::canBeAddedTo (ClipOwner& co)
 {
@@ -321,11 +383,21 @@ void StepClip::generateMidiSequenceForChannels (juce::MidiMessageSequence& resul
     auto numNotes = pattern.getNumNotes();
     auto noteLength = pattern.getNoteLength();
 
-    juce::OwnedArray<Pattern::CachedPattern> caches;
+    if (numNotes <= 0)
+        return;
+
+    // Each channel's steps and groove are looked up once rather than for every step
+    const juce::ScopedLock sl (cachedPatternLock);
+    juce::Array<const Pattern::CachedPattern*> caches;
+    juce::Array<const GrooveTemplate*> grooves;
     caches.ensureStorageAllocated (numChannels);
+    grooves.ensureStorageAllocated (numChannels);
 
     for (int f = 0; f < numChannels; ++f)
-        caches.add (new Pattern::CachedPattern (pattern, f));
+    {
+        caches.add (&getCachedPattern (pattern, f));
+        grooves.add (gtm.getTemplateByName (getChannels().getUnchecked (f)->grooveTemplate));
+    }
 
     for (int i = 0; i < numNotes; ++i)
     {
@@ -372,7 +444,7 @@ void StepClip::generateMidiSequenceForChannels (juce::MidiMessageSequence& resul
                             const auto startTime = tempoSequence.toTime (start) - toDuration (pos.getStart());
                             const auto endTime = tempoSequence.toTime (end) - toDuration (pos.getStart());
 
-                            if (auto gt = gtm.getTemplateByName (c.grooveTemplate))
+                            if (auto gt = grooves.getUnchecked (f))
                             {
                                 eventStart = gt->editTimeToGroovyTime (startTime, c.grooveStrength, edit).inSeconds();
                                 eventEnd = gt->editTimeToGroovyTime (endTime, c.grooveStrength, edit).inSeconds();
@@ -385,7 +457,7 @@ void StepClip::generateMidiSequenceForChannels (juce::MidiMessageSequence& resul
                         }
                         else
                         {
-                            if (auto gt = gtm.getTemplateByName (c.grooveTemplate))
+                            if (auto gt = grooves.getUnchecked (f))
                             {
                                 eventStart = gt->beatsTimeToGroovyTime (start, c.grooveStrength).inBeats();
                                 eventEnd = gt->beatsTimeToGroovyTime (end, c.grooveStrength).inBeats();
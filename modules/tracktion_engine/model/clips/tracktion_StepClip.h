@@ -302,9 +302,18 @@ private:
                                           const Pattern&, BeatPosition startBeat,
                                           BeatPosition clipStartBeat, BeatPosition clipEndBeat, const TempoSequence&);
 
+    const Pattern::CachedPattern& getCachedPattern (const Pattern&, int channel);
+    void invalidateCachedPatterns (const juce::ValueTree&);
+
     //==============================================================================
     struct ChannelList;
     std::unique_ptr<ChannelList> channelList;
+
+    // Parsed copies of each pattern's channels, indexed by pattern then channel.
+    // A row is only re-parsed after the CHANNEL state it came from has changed.
+    std::vector<std::vector<std::unique_ptr<Pattern::CachedPattern>>> cachedPatterns;
+    juce::CriticalSection cachedPatternLock;
+
     PatternArray patternInstanceList;
     std::shared_ptr<ClipLevel> level { std::make_shared<ClipLevel>() };
     juce::CachedValue<BeatPosition> loopStartBeats;
@@ -21,6 +21,102 @@ inline HashCode hashDouble (double d) noexcept
 
 HashCode WarpMarker::getHash() const noexcept    { return hashDouble (sourceTime.inSeconds()) ^ hashDouble (warpTime.inSeconds()); }
 
+//==============================================================================
+void WarpIndex::clear()
+{
+    sourceTimes.clear();
+    warpTimes.clear();
+    numUnsortedSourceTimes = 0;
+    numUnsortedWarpTimes = 0;
+}
+
+void WarpIndex::insert (size_t index, TimePosition sourceTime, TimePosition warpTime)
+{
+    jassert (index <= size());
+    addUnsortedCounts (index, index, -1);
+    sourceTimes.insert (sourceTimes.begin() + (std::ptrdiff_t) index, sourceTime.inSeconds());
+    warpTimes.insert (warpTimes.begin() + (std::ptrdiff_t) index, warpTime.inSeconds());
+    addUnsortedCounts (index, index + 1, 1);
+}
+
+void WarpIndex::remove (size_t index)
+{
+    jassert (index < size());
+    addUnsortedCounts (index, index + 1, -1);
+    sourceTimes.erase (sourceTimes.begin() + (std::ptrdiff_t) index);
+    warpTimes.erase (warpTimes.begin() + (std::ptrdiff_t) index);
+    addUnsortedCounts (index, index, 1);
+}
+
+void WarpIndex::set (size_t index, TimePosition sourceTime, TimePosition warpTime)
+{
+    jassert (index < size());
+    addUnsortedCounts (index, index + 1, -1);
+    sourceTimes[index] = sourceTime.inSeconds();
+    warpTimes[index] = warpTime.inSeconds();
+    addUnsortedCounts (index, index + 1, 1);
+}
+
+void WarpIndex::addUnsortedCounts (size_t firstPair, size_t lastPair, int delta)
+{
+    // Pairs are identified by the index of their second point
+    for (auto i = std::max (firstPair, (size_t) 1); i <= lastPair && i < size(); ++i)
+    {
+        if (sourceTimes[i] < sourceTimes[i - 1])
+            numUnsortedSourceTimes += delta;
+
+        if (warpTimes[i] < warpTimes[i - 1])
+            numUnsortedWarpTimes += delta;
+    }
+
+    jassert (numUnsortedSourceTimes >= 0 && numUnsortedWarpTimes >= 0);
+}
+
+size_t WarpIndex::findFirstWarpTimeNotBefore (TimePosition time, size_t hint) const
+{
+    const auto t = time.inSeconds();
+    const auto num = size();
+
+    if (numUnsortedWarpTimes > 0)
+    {
+        size_t index = 0;
+
+        while (index < num && warpTimes[index] < t)
+            ++index;
+
+        return index;
+    }
+
+    // Check the hint and the one after it as playback usually moves forwards slowly
+    for (auto i = hint; i <= std::min (hint + 1, num); ++i)
+        if ((i == 0 || warpTimes[i - 1] < t) && (i == num || warpTimes[i] >= t))
+            return i;
+
+    return (size_t) std::distance (warpTimes.begin(), std::lower_bound (warpTimes.begin(), warpTimes.end(), t));
+}
+
+size_t WarpIndex::findSegmentContainingSourceTime (TimePosition time) const
+{
+    jassert (size() > 1);
+    const auto t = time.inSeconds();
+    const auto num = size();
+
+    if (numUnsortedSourceTimes > 0)
+    {
+        for (size_t i = 1; i < num; ++i)
+            if (t >= sourceTimes[i - 1] && t <= sourceTimes[i])
+                return i;
+
+        return num - 1;
+    }
+
+    if (t < sourceTimes.front() || t > sourceTimes.back())
+        return num - 1;
+
+    const auto index = (size_t) std::distance (sourceTimes.begin(), std::lower_bound (sourceTimes.begin(), sourceTimes.end(), t));
+    return std::max ((size_t) 1, index);
+}
+
 template <typename FloatingPointType>
 struct Differentiator
 {
@@ -224,6 +320,51 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TransientDetectionJob)
 };
 
+//==============================================================================
+void WarpTimeManager::WarpMarkerList::newObjectAdded (WarpMarker* wm)
+{
+    const auto i = objects.indexOf (wm);
+    jassert (i >= 0);
+    index.insert ((size_t) i, wm->sourceTime, wm->warpTime);
+}
+
+void WarpTimeManager::WarpMarkerList::objectRemoved (WarpMarker*)
+{
+    // The marker has already been taken out of the objects so the first
+    // entry that doesn't match them is the one that was removed
+    jassert (index.size() == (size_t) objects.size() + 1);
+    size_t i = 0;
+
+    while (i < (size_t) objects.size()
+            && objects.getUnchecked ((int) i)->sourceTime == index.getSourceTime (i)
+            && objects.getUnchecked ((int) i)->warpTime == index.getWarpTime (i))
+        ++i;
+
+    index.remove (i);
+}
+
+void WarpTimeManager::WarpMarkerList::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i)
+{
+    if (v.hasType (IDs::WARPMARKER))
+    {
+        const auto objectIndex = v.getParent().indexOf (v);
+
+        if (auto wm = objects[objectIndex])
+        {
+            wm->updateFrom (v, i);
+            index.set ((size_t) objectIndex, wm->sourceTime, wm->warpTime);
+        }
+    }
+}
+
+void WarpTimeManager::WarpMarkerList::rebuildIndex()
+{
+    index.clear();
+
+    for (auto wm : objects)
+        index.insert (index.size(), wm->sourceTime, wm->warpTime);
+}
+
 //==============================================================================
 WarpTimeManager::WarpTimeManager (AudioClipBase& c)
     : edit (c.edit), clip (&c), sourceFile (c.edit.engine)
@@ -425,15 +566,16 @@ juce::Array<TimeRange> WarpTimeManager::getWarpTimeRegions (const TimeRange over
 
 TimePosition WarpTimeManager::warpTimeToSourceTime (TimePosition warpTime) const
 {
-    auto& markersArray = markers->objects;
+    auto& index = markers->index;
 
-    if (markersArray.isEmpty())
+    if (index.isEmpty())
         return warpTime;
 
     WarpMarker startMarker, endMarker;
 
-    auto first = *markersArray.getFirst();
-    auto last  = *markersArray.getLast();
+    const auto lastIndex = index.size() - 1;
+    const WarpMarker first (index.getSourceTime (0), index.getWarpTime (0));
+    const WarpMarker last (index.getSourceTime (lastIndex), index.getWarpTime (lastIndex));
 
     if (warpTime <= first.warpTime) //below or on the 1st marker
     {
@@ -448,16 +590,12 @@ TimePosition WarpTimeManager::warpTimeToSourceTime (TimePosition warpTime) const
     }
     else
     {
-        int index = 0;
-        auto numMarkers = markersArray.size();
-
-        while (index < numMarkers && markersArray.getUnchecked (index)->warpTime < warpTime)
-            index++;
+        const auto i = index.findFirstWarpTimeNotBefore (warpTime);
 
-        if (index > 0)
-            startMarker = *markersArray.getUnchecked (index - 1);
+        if (i > 0)
+            startMarker = WarpMarker (index.getSourceTime (i - 1), index.getWarpTime (i - 1));
 
-        endMarker = *markersArray.getUnchecked (index);
+        endMarker = WarpMarker (index.getSourceTime (i), index.getWarpTime (i));
     }
 
     const WarpMarker markerRanges (toPosition (endMarker.sourceTime - startMarker.sourceTime),
@@ -480,34 +618,23 @@ TimePosition WarpTimeManager::warpTimeToSourceTime (TimePosition warpTime) const
 
 TimePosition WarpTimeManager::sourceTimeToWarpTime (TimePosition sourceTime) const
 {
-    auto& markersArray = markers->objects;
+    auto& index = markers->index;
 
-    if (markersArray.isEmpty())
+    if (index.isEmpty())
         return sourceTime;
 
-    WarpMarker* before = nullptr;
-    WarpMarker* after = nullptr;
-
-    for (auto wm : markersArray)
-    {
-        before = after;
-        after = wm;
-
-        if (before != nullptr && after != nullptr
-            && (sourceTime >= before->sourceTime && sourceTime <= after->sourceTime))
-                break;
-    }
+    const auto after = index.size() > 1 ? index.findSegmentContainingSourceTime (sourceTime) : 0;
 
-    TimeRange source (before == nullptr ? TimePosition() : before->sourceTime,
-                      after == nullptr ? toPosition (getSourceLength()) : after->sourceTime);
+    TimeRange source (after == 0 ? TimePosition() : index.getSourceTime (after - 1),
+                      index.getSourceTime (after));
 
     if (source.getLength() == 0.0s)
         return sourceTime;
 
     auto prop = (sourceTime - source.getStart()) / source.getLength();
 
-    TimeRange warped (before == nullptr ? TimePosition() : before->warpTime,
-                          after == nullptr ? getWarpedEnd() : after->warpTime);
+    TimeRange warped (after == 0 ? TimePosition() : index.getWarpTime (after - 1),
+                      index.getWarpTime (after));
 
     return warped.getStart() + (warped.getLength() * prop);
 }
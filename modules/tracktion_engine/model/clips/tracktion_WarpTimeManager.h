@@ -50,6 +50,69 @@ struct WarpMarker
 };
 
 
+//==============================================================================
+//==============================================================================
+/**
+    A compiled, piecewise-linear table of source and warp times.
+
+    The times are kept in contiguous arrays so finding the segment a time falls in is a
+    binary search rather than a walk over the markers. Lookups close to the previous
+    one, as they are during playback, can pass a hint to skip the search entirely.
+    Points can be inserted, removed and changed individually so this can be kept up to
+    date as markers are edited without rebuilding the whole table.
+*/
+class WarpIndex
+{
+public:
+    /** Creates an empty WarpIndex. */
+    WarpIndex() = default;
+
+    //==============================================================================
+    /** Removes all the points. */
+    void clear();
+
+    /** Inserts a point before the given index. */
+    void insert (size_t index, TimePosition sourceTime, TimePosition warpTime);
+
+    /** Removes the point at the given index. */
+    void remove (size_t index);
+
+    /** Changes the times of the point at the given index. */
+    void set (size_t index, TimePosition sourceTime, TimePosition warpTime);
+
+    //==============================================================================
+    /** Returns the number of points. */
+    size_t size() const noexcept                                { return warpTimes.size(); }
+
+    /** Returns true if there are no points. */
+    bool isEmpty() const noexcept                               { return warpTimes.empty(); }
+
+    /** Returns the source time of a point. */
+    TimePosition getSourceTime (size_t index) const             { return TimePosition::fromSeconds (sourceTimes[index]); }
+
+    /** Returns the warp time of a point. */
+    TimePosition getWarpTime (size_t index) const               { return TimePosition::fromSeconds (warpTimes[index]); }
+
+    //==============================================================================
+    /** Returns the index of the first point with a warp time that isn't before the
+        given time, or size() if there isn't one.
+        @param hint An index to check before searching, e.g. the result of the last call.
+    */
+    size_t findFirstWarpTimeNotBefore (TimePosition, size_t hint = 0) const;
+
+    /** Returns the index of the end point of the first segment that contains the given
+        source time, or the last point if none do. There must be at least two points.
+    */
+    size_t findSegmentContainingSourceTime (TimePosition) const;
+
+private:
+    std::vector<double> sourceTimes, warpTimes;
+    int numUnsortedSourceTimes = 0, numUnsortedWarpTimes = 0;
+
+    void addUnsortedCounts (size_t firstPair, size_t lastPair, int delta);
+};
+
+
 //==============================================================================
 //==============================================================================
 /**
@@ -159,6 +222,7 @@ private:
             : ValueTreeObjectList<WarpMarker> (v), state (v)
         {
             rebuildObjects();
+            rebuildIndex();
         }
 
         ~WarpMarkerList() override
@@ -169,25 +233,17 @@ private:
         bool isSuitableType (const juce::ValueTree& v) const override   { return v.hasType (IDs::WARPMARKER); }
         WarpMarker* createNewObject (const juce::ValueTree& v) override { return new WarpMarker (v); }
         void deleteObject (WarpMarker* wm) override                     { delete wm; }
-        void newObjectAdded (WarpMarker*) override                      {}
-        void objectRemoved (WarpMarker*) override                       {}
-        void objectOrderChanged() override                              {}
+        void newObjectAdded (WarpMarker*) override;
+        void objectRemoved (WarpMarker*) override;
+        void objectOrderChanged() override                              { rebuildIndex(); }
 
-        void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i) override
-        {
-            if (v.hasType (IDs::WARPMARKER))
-                if (auto wm = getWarpMarkerFor (v))
-                    wm->updateFrom (v, i);
-        }
+        void valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i) override;
 
         juce::ValueTree state;
+        WarpIndex index;
 
     private:
-        WarpMarker* getWarpMarkerFor (const juce::ValueTree& v)
-        {
-            jassert (v.hasType (IDs::WARPMARKER));
-            return objects[v.getParent().indexOf (v)];
-        }
+        void rebuildIndex();
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WarpMarkerList)
     };
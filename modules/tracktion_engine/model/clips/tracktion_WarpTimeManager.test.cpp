@@ -0,0 +1,221 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_CLIPS
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+namespace warp_time_manager::test
+{
+    /** The markers as a plain list, searched the way WarpTimeManager used to walk them. */
+    struct LinearWarpMap
+    {
+        std::vector<WarpMarker> markers;
+
+        size_t findFirstWarpTimeNotBefore (TimePosition time) const
+        {
+            size_t index = 0;
+
+            while (index < markers.size() && markers[index].warpTime < time)
+                ++index;
+
+            return index;
+        }
+
+        size_t findSegmentContainingSourceTime (TimePosition time) const
+        {
+            for (size_t i = 1; i < markers.size(); ++i)
+                if (time >= markers[i - 1].sourceTime && time <= markers[i].sourceTime)
+                    return i;
+
+            return markers.size() - 1;
+        }
+    };
+
+    inline WarpMarker createRandomMarker (juce::Random& r)
+    {
+        return WarpMarker (TimePosition::fromSeconds (r.nextDouble() * 10.0),
+                           TimePosition::fromSeconds (r.nextDouble() * 10.0));
+    }
+
+    inline LinearWarpMap createSortedMap (juce::Random& r, int numMarkers)
+    {
+        LinearWarpMap map;
+        double sourceTime = 0.0, warpTime = 0.0;
+
+        for (int i = 0; i < numMarkers; ++i)
+        {
+            map.markers.emplace_back (TimePosition::fromSeconds (sourceTime), TimePosition::fromSeconds (warpTime));
+
+            // Some of the steps are zero so there are markers with equal times
+            sourceTime += r.nextInt (4) * 0.25;
+            warpTime += r.nextInt (4) * 0.25;
+        }
+
+        return map;
+    }
+
+    inline void insert (WarpIndex& index, LinearWarpMap& map, size_t i, WarpMarker marker)
+    {
+        index.insert (i, marker.sourceTime, marker.warpTime);
+        map.markers.insert (map.markers.begin() + (std::ptrdiff_t) i, marker);
+    }
+
+    inline WarpIndex createIndex (const LinearWarpMap& map)
+    {
+        WarpIndex index;
+
+        for (auto& m : map.markers)
+            index.insert (index.size(), m.sourceTime, m.warpTime);
+
+        return index;
+    }
+
+    /** Checks every lookup over the map's range, including times before, after and exactly on the markers. */
+    inline void checkLookupsMatch (const WarpIndex& index, const LinearWarpMap& map)
+    {
+        REQUIRE_EQ (index.size(), map.markers.size());
+
+        for (size_t i = 0; i < map.markers.size(); ++i)
+        {
+            CHECK_EQ (index.getSourceTime (i), map.markers[i].sourceTime);
+            CHECK_EQ (index.getWarpTime (i), map.markers[i].warpTime);
+        }
+
+        std::vector<TimePosition> times;
+
+        for (double t = -1.0; t <= 11.0; t += 0.1)
+            times.push_back (TimePosition::fromSeconds (t));
+
+        for (auto& m : map.markers)
+        {
+            times.push_back (m.sourceTime);
+            times.push_back (m.warpTime);
+        }
+
+        for (auto t : times)
+        {
+            const auto expectedWarpIndex = map.findFirstWarpTimeNotBefore (t);
+            CHECK_EQ (index.findFirstWarpTimeNotBefore (t), expectedWarpIndex);
+
+            // Any hint should give the same result as no hint
+            for (auto hint : { (size_t) 0, expectedWarpIndex > 0 ? expectedWarpIndex - 1 : 0, expectedWarpIndex,
+                               std::min (expectedWarpIndex + 1, index.size()), index.size() })
+                CHECK_EQ (index.findFirstWarpTimeNotBefore (t, hint), expectedWarpIndex);
+
+            if (index.size() > 1)
+                CHECK_EQ (index.findSegmentContainingSourceTime (t), map.findSegmentContainingSourceTime (t));
+        }
+    }
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("WarpIndex matches a linear search")
+    {
+        using namespace warp_time_manager::test;
+        juce::Random r (42);
+
+        SUBCASE ("Sorted maps")
+        {
+            for (int numMarkers : { 1, 2, 3, 8, 33 })
+            {
+                auto map = createSortedMap (r, numMarkers);
+                checkLookupsMatch (createIndex (map), map);
+            }
+        }
+
+        SUBCASE ("Unsorted maps")
+        {
+            for (int numMarkers : { 2, 3, 8, 33 })
+            {
+                LinearWarpMap map;
+
+                for (int i = 0; i < numMarkers; ++i)
+                    map.markers.push_back (createRandomMarker (r));
+
+                checkLookupsMatch (createIndex (map), map);
+            }
+        }
+
+        SUBCASE ("Sequential lookups with a hint")
+        {
+            auto map = createSortedMap (r, 20);
+            auto index = createIndex (map);
+            size_t hint = 0;
+
+            // As playback would, feeding each result back in as the next hint
+            for (double t = -1.0; t <= 11.0; t += 0.01)
+            {
+                const auto time = TimePosition::fromSeconds (t);
+                hint = index.findFirstWarpTimeNotBefore (time, hint);
+                CHECK_EQ (hint, map.findFirstWarpTimeNotBefore (time));
+            }
+        }
+
+        SUBCASE ("Edited maps")
+        {
+            // Edits move the map in and out of order so the unsorted counts have to follow them
+            auto map = createSortedMap (r, 10);
+            auto index = createIndex (map);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto numMarkers = (int) index.size();
+
+                switch (r.nextInt (3))
+                {
+                    case 0:
+                        insert (index, map, (size_t) r.nextInt (numMarkers + 1), createRandomMarker (r));
+                        break;
+
+                    case 1:
+                        if (numMarkers > 2)
+                        {
+                            const auto removeIndex = (size_t) r.nextInt (numMarkers);
+                            index.remove (removeIndex);
+                            map.markers.erase (map.markers.begin() + (std::ptrdiff_t) removeIndex);
+                        }
+                        break;
+
+                    default:
+                    {
+                        const auto setIndex = (size_t) r.nextInt (numMarkers);
+                        const auto marker = createRandomMarker (r);
+                        index.set (setIndex, marker.sourceTime, marker.warpTime);
+                        map.markers[setIndex] = marker;
+                        break;
+                    }
+                }
+
+                checkLookupsMatch (index, map);
+            }
+
+            // Sorting it again should go back to the binary search and still match
+            std::sort (map.markers.begin(), map.markers.end(),
+                       [] (auto& a, auto& b) { return a.sourceTime < b.sourceTime; });
+
+            for (size_t i = 0; i < map.markers.size(); ++i)
+                index.set (i, map.markers[i].sourceTime, map.markers[i].sourceTime);
+
+            for (auto& m : map.markers)
+                m.warpTime = m.sourceTime;
+
+            checkLookupsMatch (index, map);
+        }
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_CLIPS
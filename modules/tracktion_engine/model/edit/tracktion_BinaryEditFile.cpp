@@ -0,0 +1,445 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace binary_edit_file
+{
+    // Header: magic, version, table offset, table size
+    // Table:  num entries, then the offset, size and hash of each entry (the root is the first entry)
+    static constexpr char magic[] = { 'T', 'E', 'B', 'F' };
+    static constexpr int version = 1;
+    static constexpr int64_t headerSize = 24;
+    static constexpr int64_t entrySize = 24;
+    static constexpr int64_t tableOffsetPosition = 8;
+
+    // Smaller sub-trees aren't worth an entry in the table so are kept in their parent
+    static constexpr size_t minSectionSize = 256;
+
+    static const juce::Identifier& getSectionIndexID()
+    {
+        static const juce::Identifier id ("binaryEditFileSection");
+        return id;
+    }
+
+    static uint64_t hashSection (const juce::MemoryBlock& mb)
+    {
+        return std::hash<std::string_view>() (std::string_view (static_cast<const char*> (mb.getData()), mb.getSize()));
+    }
+
+    static juce::ValueTree splitIntoSections (const juce::ValueTree& v, std::vector<juce::MemoryBlock>& sections)
+    {
+        juce::ValueTree copy (v.getType());
+        copy.copyPropertiesFrom (v, nullptr);
+
+        for (const auto& c : v)
+        {
+            if (BinaryEditFile::isSectionType (c.getType()))
+            {
+                juce::MemoryBlock mb;
+
+                {
+                    juce::MemoryOutputStream os (mb, false);
+                    c.writeToStream (os);
+                }
+
+                if (mb.getSize() >= minSectionSize)
+                {
+                    copy.appendChild (juce::ValueTree (c.getType(), { { getSectionIndexID(), (int) sections.size() - 1 } }), nullptr);
+                    sections.push_back (std::move (mb));
+                    continue;
+                }
+            }
+
+            copy.appendChild (splitIntoSections (c, sections), nullptr);
+        }
+
+        return copy;
+    }
+
+    /** Returns the root section followed by the other sections. */
+    static std::vector<juce::MemoryBlock> createSections (const juce::ValueTree& state)
+    {
+        std::vector<juce::MemoryBlock> sections (1);
+        auto root = splitIntoSections (state, sections);
+
+        juce::MemoryOutputStream os (sections.front(), false);
+        root.writeToStream (os);
+
+        return sections;
+    }
+
+    static void writeHeader (juce::OutputStream& os, int64_t tableOffset, int64_t tableSize)
+    {
+        os.write (magic, sizeof (magic));
+        os.writeInt (version);
+        os.writeInt64 (tableOffset);
+        os.writeInt64 (tableSize);
+    }
+
+    static int64_t writeTable (juce::OutputStream& os, const std::vector<BinaryEditFile::SectionEntry>& entries)
+    {
+        const auto start = os.getPosition();
+        os.writeInt ((int) entries.size());
+
+        for (auto& e : entries)
+        {
+            os.writeInt64 (e.offset);
+            os.writeInt64 (e.size);
+            os.writeInt64 ((int64_t) e.hash);
+        }
+
+        return os.getPosition() - start;
+    }
+
+    static bool readTable (const void* data, size_t dataSize, std::vector<BinaryEditFile::SectionEntry>& entries)
+    {
+        if (data == nullptr || (int64_t) dataSize < headerSize
+            || std::memcmp (data, magic, sizeof (magic)) != 0)
+           return false;
+
+        juce::MemoryInputStream header (data, (size_t) headerSize, false);
+        header.skipNextBytes (sizeof (magic));
+
+        if (header.readInt() > version)
+            return false;
+
+        const auto tableOffset = header.readInt64();
+        const auto tableSize = header.readInt64();
+
+        if (tableOffset < headerSize || tableSize < 4 || tableOffset + tableSize > (int64_t) dataSize)
+            return false;
+
+        juce::MemoryInputStream table (static_cast<const char*> (data) + tableOffset, (size_t) tableSize, false);
+        const auto numEntries = table.readInt();
+
+        if (numEntries < 1 || 4 + numEntries * entrySize > tableSize)
+            return false;
+
+        entries.resize ((size_t) numEntries);
+
+        for (auto& e : entries)
+        {
+            e.offset = table.readInt64();
+            e.size = table.readInt64();
+            e.hash = (uint64_t) table.readInt64();
+
+            if (e.offset < headerSize || e.size < 0 || e.offset + e.size > tableOffset)
+                return false;
+        }
+
+        return true;
+    }
+
+    template<typename Function>
+    static void forEachConcurrently (size_t num, Function&& fn)
+    {
+        std::atomic<size_t> next { 0 };
+        std::vector<std::thread> threads;
+        const auto numThreads = std::min (num, (size_t) std::max (1, juce::SystemStats::getNumCpus()));
+
+        for (size_t i = 0; i < numThreads; ++i)
+            threads.emplace_back ([&]
+            {
+                for (auto index = next.fetch_add (1); index < num; index = next.fetch_add (1))
+                    fn (index);
+            });
+
+        for (auto& t : threads)
+            t.join();
+    }
+}
+
+//==============================================================================
+bool BinaryEditFile::isBinaryEditFile (const juce::File& f)
+{
+    char header[sizeof (binary_edit_file::magic)] = {};
+
+    if (juce::FileInputStream is (f); is.openedOk())
+        return is.read (header, (int) sizeof (header)) == (int) sizeof (header)
+                && std::memcmp (header, binary_edit_file::magic, sizeof (header)) == 0;
+
+    return false;
+}
+
+bool BinaryEditFile::isSectionType (const juce::Identifier& type)
+{
+    return type == IDs::SEQUENCE || type == IDs::AUTOMATIONCURVE || type == IDs::PLUGIN;
+}
+
+bool BinaryEditFile::isSectionPlaceholder (const juce::ValueTree& v)
+{
+    return v.hasProperty (binary_edit_file::getSectionIndexID());
+}
+
+bool BinaryEditFile::write (const juce::ValueTree& state, const juce::File& f)
+{
+    f.deleteFile();
+    return Writer (f).write (state);
+}
+
+//==============================================================================
+BinaryEditFile::Reader::Reader (const juce::File& f)
+    : mappedFile (std::make_unique<juce::MemoryMappedFile> (f, juce::MemoryMappedFile::readOnly))
+{
+    if (! binary_edit_file::readTable (mappedFile->getData(), mappedFile->getSize(), entries))
+    {
+        entries.clear();
+        return;
+    }
+
+    sections.resize (entries.size() - 1);
+
+    if (auto v = readEntry (entries.front()); v.isValid())
+        root = v;
+}
+
+BinaryEditFile::Reader::~Reader() = default;
+
+int BinaryEditFile::Reader::getNumSections() const
+{
+    return (int) sections.size();
+}
+
+juce::ValueTree BinaryEditFile::Reader::getSection (int index)
+{
+    if (! juce::isPositiveAndBelow (index, getNumSections()))
+        return {};
+
+    {
+        const std::scoped_lock sl (sectionsMutex);
+
+        if (auto& s = sections[(size_t) index]; s.isValid())
+            return s;
+    }
+
+    auto v = readEntry (entries[(size_t) index + 1]);
+
+    const std::scoped_lock sl (sectionsMutex);
+    auto& s = sections[(size_t) index];
+
+    if (! s.isValid())
+        s = v;
+
+    return s;
+}
+
+juce::ValueTree BinaryEditFile::Reader::getSectionFor (const juce::ValueTree& placeholder)
+{
+    if (! isSectionPlaceholder (placeholder))
+        return {};
+
+    return getSection (placeholder[binary_edit_file::getSectionIndexID()]);
+}
+
+juce::ValueTree BinaryEditFile::Reader::createFullState()
+{
+    CRASH_TRACER
+
+    if (! isValid())
+        return {};
+
+    // The sections are independent trees so can be read concurrently.
+    // These aren't cached as they'll be owned by the returned state
+    std::vector<juce::ValueTree> fullSections (sections.size());
+
+    binary_edit_file::forEachConcurrently (fullSections.size(), [this, &fullSections] (size_t index)
+    {
+        fullSections[index] = readEntry (entries[index + 1]);
+    });
+
+    auto state = root.createCopy();
+
+    std::function<void (juce::ValueTree&)> replacePlaceholders = [&] (juce::ValueTree& parent)
+    {
+        for (int i = 0; i < parent.getNumChildren(); ++i)
+        {
+            auto c = parent.getChild (i);
+
+            if (! isSectionPlaceholder (c))
+            {
+                replacePlaceholders (c);
+                continue;
+            }
+
+            const int index = c[binary_edit_file::getSectionIndexID()];
+            parent.removeChild (i, nullptr);
+
+            if (juce::isPositiveAndBelow (index, (int) fullSections.size()))
+            {
+                if (auto& section = fullSections[(size_t) index]; section.hasType (c.getType()))
+                {
+                    parent.addChild (std::exchange (section, {}), i, nullptr);
+                    continue;
+                }
+            }
+
+            jassertfalse; // Missing or corrupt section
+            --i;
+        }
+    };
+
+    replacePlaceholders (state);
+
+    return state;
+}
+
+juce::ValueTree BinaryEditFile::Reader::readEntry (const SectionEntry& e) const
+{
+    return juce::ValueTree::readFromData (static_cast<const char*> (mappedFile->getData()) + e.offset, (size_t) e.size);
+}
+
+//==============================================================================
+BinaryEditFile::Writer::Writer (const juce::File& f)
+    : file (f)
+{
+    if (! isBinaryEditFile (file))
+        return;
+
+    juce::MemoryMappedFile mappedFile (file, juce::MemoryMappedFile::readOnly);
+
+    if (binary_edit_file::readTable (mappedFile.getData(), mappedFile.getSize(), entries))
+        expectedFileSize = file.getSize();
+    else
+        entries.clear();
+}
+
+BinaryEditFile::Writer::~Writer() = default;
+
+bool BinaryEditFile::Writer::write (const juce::ValueTree& state)
+{
+    CRASH_TRACER
+    auto sections = binary_edit_file::createSections (state);
+
+    // If the file has changed since it was last written, start again
+    if (entries.empty() || expectedFileSize != file.getSize())
+        return writeAll (sections);
+
+    return append (sections);
+}
+
+bool BinaryEditFile::Writer::writeAll (const std::vector<juce::MemoryBlock>& sections)
+{
+    const juce::TemporaryFile temp (file);
+    std::vector<SectionEntry> newEntries;
+    int64_t numBytesWritten = 0;
+
+    {
+        juce::FileOutputStream os (temp.getFile());
+
+        if (! os.openedOk())
+            return false;
+
+        binary_edit_file::writeHeader (os, 0, 0);
+
+        for (auto& mb : sections)
+        {
+            newEntries.push_back ({ os.getPosition(), (int64_t) mb.getSize(), binary_edit_file::hashSection (mb) });
+            os.write (mb.getData(), mb.getSize());
+            numBytesWritten += (int64_t) mb.getSize();
+        }
+
+        const auto tableOffset = os.getPosition();
+        const auto tableSize = binary_edit_file::writeTable (os, newEntries);
+
+        if (! os.setPosition (binary_edit_file::tableOffsetPosition))
+            return false;
+
+        os.writeInt64 (tableOffset);
+        os.writeInt64 (tableSize);
+        os.flush();
+
+        if (! os.getStatus().wasOk())
+            return false;
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
+        return false;
+
+    entries = std::move (newEntries);
+    expectedFileSize = file.getSize();
+    numSectionBytesWrittenLastTime = numBytesWritten;
+
+    return true;
+}
+
+bool BinaryEditFile::Writer::append (const std::vector<juce::MemoryBlock>& sections)
+{
+    // Find the sections that are already in the file
+    std::map<std::pair<uint64_t, int64_t>, SectionEntry> existingEntries;
+
+    for (auto& e : entries)
+        existingEntries[{ e.hash, e.size }] = e;
+
+    std::vector<SectionEntry> newEntries;
+    std::vector<size_t> sectionsToAppend;
+    int64_t numLiveBytes = 0, numBytesToAppend = 0;
+
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        auto& mb = sections[i];
+        const SectionEntry entry { 0, (int64_t) mb.getSize(), binary_edit_file::hashSection (mb) };
+
+        if (auto found = existingEntries.find ({ entry.hash, entry.size }); found != existingEntries.end())
+        {
+            newEntries.push_back (found->second);
+        }
+        else
+        {
+            newEntries.push_back (entry);
+            sectionsToAppend.push_back (i);
+            numBytesToAppend += entry.size;
+        }
+
+        numLiveBytes += entry.size;
+    }
+
+    // If most of the file would be unused, compact it
+    if (expectedFileSize + numBytesToAppend - numLiveBytes > numLiveBytes)
+        return writeAll (sections);
+
+    juce::FileOutputStream os (file);
+
+    if (! os.openedOk())
+        return false;
+
+    for (auto i : sectionsToAppend)
+    {
+        newEntries[i].offset = os.getPosition();
+        os.write (sections[i].getData(), sections[i].getSize());
+    }
+
+    const auto tableOffset = os.getPosition();
+    const auto tableSize = binary_edit_file::writeTable (os, newEntries);
+    os.flush();
+
+    if (! os.getStatus().wasOk())
+        return false;
+
+    // Only point the header at the new table once everything else has been written
+    if (! os.setPosition (binary_edit_file::tableOffsetPosition))
+        return false;
+
+    os.writeInt64 (tableOffset);
+    os.writeInt64 (tableSize);
+    os.flush();
+
+    if (! os.getStatus().wasOk())
+        return false;
+
+    entries = std::move (newEntries);
+    expectedFileSize = tableOffset + tableSize;
+    numSectionBytesWrittenLastTime = numBytesToAppend;
+
+    return true;
+}
+
+}} // namespace tracktion { inline namespace engine
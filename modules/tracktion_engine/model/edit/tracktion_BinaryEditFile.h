@@ -0,0 +1,136 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    A binary container for Edit states which splits the bulky parts of the tree
+    (MIDI sequences, automation curves and plugin states) into separate sections
+    that are indexed by an offset table.
+
+    The file is laid out as a header, the section data and then the offset table.
+    Sections can be read lazily from a memory-mapped file and, because unchanged
+    sections are shared between writes, the Writer only has to append the
+    sections that have changed since the last time it wrote the file.
+
+    loadEditFromFile will detect and load these files.
+*/
+struct BinaryEditFile
+{
+    /** Returns true if the file starts with the BinaryEditFile header. */
+    static bool isBinaryEditFile (const juce::File&);
+
+    /** Returns true if a sub-tree of this type is written as a separate section. */
+    static bool isSectionType (const juce::Identifier&);
+
+    /** Returns true if this tree is a placeholder for a section that hasn't been read. */
+    static bool isSectionPlaceholder (const juce::ValueTree&);
+
+    /** Writes a whole state to a file, replacing any existing file. */
+    static bool write (const juce::ValueTree&, const juce::File&);
+
+    /** @internal The position of a section in the file. */
+    struct SectionEntry
+    {
+        int64_t offset = 0, size = 0;
+        uint64_t hash = 0;
+    };
+
+    //==============================================================================
+    /**
+        Memory-maps a BinaryEditFile and reads its sections on demand.
+    */
+    class Reader
+    {
+    public:
+        /** Opens a file, reading the header, offset table and root section. */
+        Reader (const juce::File&);
+
+        /** Destructor. */
+        ~Reader();
+
+        /** Returns true if the file was opened and its header and table are valid. */
+        bool isValid() const                    { return root.isValid(); }
+
+        /** Returns the root of the state with each section replaced by an empty
+            placeholder of the same type.
+            @see isSectionPlaceholder, getSectionFor
+        */
+        juce::ValueTree getRootState() const    { return root; }
+
+        /** Returns the number of sections, excluding the root. */
+        int getNumSections() const;
+
+        /** Reads a section, or returns the one already read.
+            This is thread safe.
+        */
+        juce::ValueTree getSection (int index);
+
+        /** Returns the section a placeholder in the root state refers to. */
+        juce::ValueTree getSectionFor (const juce::ValueTree& placeholder);
+
+        /** Reads all the sections and returns a copy of the complete state. */
+        juce::ValueTree createFullState();
+
+    private:
+        std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+        std::vector<SectionEntry> entries;
+        std::vector<juce::ValueTree> sections;
+        std::mutex sectionsMutex;
+        juce::ValueTree root;
+
+        juce::ValueTree readEntry (const SectionEntry&) const;
+
+        JUCE_DECLARE_NON_COPYABLE (Reader)
+    };
+
+    //==============================================================================
+    /**
+        Writes states to a file, re-using the sections that haven't changed since
+        the last write.
+
+        Changed sections and a new offset table are appended to the file and the
+        header is only updated once they've been written so an interrupted write
+        leaves the previous state intact. When more than half the file is taken up
+        by sections that are no longer used, the whole file is re-written.
+    */
+    class Writer
+    {
+    public:
+        /** Creates a Writer for a file.
+            If the file is already a BinaryEditFile, its sections will be re-used.
+        */
+        Writer (const juce::File&);
+
+        /** Destructor. */
+        ~Writer();
+
+        /** Writes a state to the file, returning true if it succeeded. */
+        bool write (const juce::ValueTree&);
+
+        /** Returns the number of bytes of section data written by the last call to write. */
+        int64_t getNumSectionBytesWrittenLastTime() const noexcept  { return numSectionBytesWrittenLastTime; }
+
+    private:
+        const juce::File file;
+        std::vector<SectionEntry> entries;
+        int64_t expectedFileSize = -1;
+        int64_t numSectionBytesWrittenLastTime = 0;
+
+        bool writeAll (const std::vector<juce::MemoryBlock>&);
+        bool append (const std::vector<juce::MemoryBlock>&);
+
+        JUCE_DECLARE_NON_COPYABLE (Writer)
+    };
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,119 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_BINARY_EDIT_FILE
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE("tracktion_engine")
+{
+    static juce::ValueTree createTestEditState (int numTracks)
+    {
+        juce::ValueTree state (IDs::EDIT);
+
+        for (int t = 0; t < numTracks; ++t)
+        {
+            juce::ValueTree track (IDs::TRACK);
+            track.setProperty (IDs::name, "Track " + juce::String (t), nullptr);
+
+            juce::ValueTree clip (IDs::MIDICLIP);
+            juce::ValueTree sequence (IDs::SEQUENCE);
+
+            for (int n = 0; n < 100; ++n)
+                sequence.appendChild (createValueTree (IDs::NOTE,
+                                                       IDs::p, 60 + (n % 12),
+                                                       IDs::b, n * 0.5,
+                                                       IDs::l, 0.5), nullptr);
+
+            clip.appendChild (sequence, nullptr);
+            track.appendChild (clip, nullptr);
+
+            juce::ValueTree plugin (IDs::PLUGIN);
+            plugin.setProperty (IDs::type, "vst", nullptr);
+            plugin.setProperty (IDs::state, juce::String::repeatedString ("0123456789", 100), nullptr);
+            track.appendChild (plugin, nullptr);
+
+            // Small sub-trees are kept in their parent
+            track.appendChild (createValueTree (IDs::PLUGIN, IDs::type, "volume"), nullptr);
+
+            state.appendChild (track, nullptr);
+        }
+
+        return state;
+    }
+
+    TEST_CASE ("BinaryEditFile")
+    {
+        juce::TemporaryFile tempFile;
+        const auto& file = tempFile.getFile();
+        auto state = createTestEditState (10);
+
+        BinaryEditFile::Writer writer (file);
+        CHECK (writer.write (state));
+        CHECK (BinaryEditFile::isBinaryEditFile (file));
+
+        const auto numBytesWrittenInitially = writer.getNumSectionBytesWrittenLastTime();
+
+        {
+            BinaryEditFile::Reader reader (file);
+            REQUIRE (reader.isValid());
+            CHECK_EQ (reader.getNumSections(), 20);
+
+            // The root only contains placeholders for the sections
+            auto firstTrack = reader.getRootState().getChild (0);
+            auto placeholder = firstTrack.getChild (0).getChild (0);
+            CHECK (BinaryEditFile::isSectionPlaceholder (placeholder));
+            CHECK_EQ (placeholder.getNumChildren(), 0);
+            CHECK (! BinaryEditFile::isSectionPlaceholder (firstTrack.getChild (2)));
+
+            CHECK (reader.getSectionFor (placeholder).isEquivalentTo (state.getChild (0).getChild (0).getChild (0)));
+            CHECK (reader.createFullState().isEquivalentTo (state));
+        }
+
+        // Only the changed section should be written
+        state.getChild (5).getChild (0).getChild (0).getChild (0).setProperty (IDs::p, 72, nullptr);
+        CHECK (writer.write (state));
+        CHECK (writer.getNumSectionBytesWrittenLastTime() > 0);
+        CHECK (writer.getNumSectionBytesWrittenLastTime() < numBytesWrittenInitially / 4);
+        CHECK (BinaryEditFile::Reader (file).createFullState().isEquivalentTo (state));
+
+        // A new Writer should re-use the sections in the file
+        {
+            BinaryEditFile::Writer newWriter (file);
+            CHECK (newWriter.write (state));
+            CHECK_EQ (newWriter.getNumSectionBytesWrittenLastTime(), 0);
+        }
+
+        // Changing every section should compact the file
+        const auto sizeBeforeCompacting = file.getSize();
+
+        for (int i = 0; i < 10; ++i)
+        {
+            auto track = state.getChild (i);
+            track.getChild (0).getChild (0).getChild (1).setProperty (IDs::p, 73, nullptr);
+            track.getChild (1).setProperty (IDs::state, juce::String::repeatedString ("9876543210", 100), nullptr);
+        }
+
+        CHECK (writer.write (state));
+        CHECK (file.getSize() <= sizeBeforeCompacting);
+        CHECK (BinaryEditFile::Reader (file).createFullState().isEquivalentTo (state));
+
+        // Edits should load from the file
+        auto& engine = *Engine::getEngines()[0];
+        CHECK (loadEditFromFile (engine, file, ProjectItemID::createNewID (0)).getNumChildren() >= 10);
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_BINARY_EDIT_FILE
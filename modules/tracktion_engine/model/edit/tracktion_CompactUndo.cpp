@@ -0,0 +1,286 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+struct UndoHistoryStore::Storage
+{
+    Storage (const juce::File& dir)
+        : spillFile (dir.getNonexistentChildFile ("undo_history", ".tmp", false))
+    {
+    }
+
+    ~Storage()
+    {
+        output.reset();
+        spillFile.deleteFile();
+    }
+
+    // Writes the oldest data in memory to the spill file until it's within the budget.
+    // Any data that's only kept alive by this is released once the lock has been
+    // released, as deleting it needs the lock.
+    void spill()
+    {
+        std::vector<std::shared_ptr<Data>> spilled;
+        const std::scoped_lock sl (mutex);
+
+        while (memoryBudget > 0 && numBytesInMemory > memoryBudget && ! inMemory.empty())
+        {
+            auto data = inMemory.front().lock();
+            inMemory.pop_front();
+
+            if (data == nullptr || data->block.isEmpty())
+                continue;
+
+            spilled.push_back (data);
+
+            if (output == nullptr)
+            {
+                output = std::make_unique<juce::FileOutputStream> (spillFile);
+
+                if (output->failedToOpen())
+                {
+                    output.reset();
+                    inMemory.push_front (data);
+                    return;
+                }
+            }
+
+            data->fileOffset = output->getPosition();
+            data->fileSize = data->block.getSize();
+
+            if (! output->write (data->block.getData(), data->block.getSize()))
+            {
+                data->fileOffset = -1;
+                inMemory.push_front (data);
+                return;
+            }
+
+            numBytesInMemory -= (int64_t) data->fileSize;
+            numBytesOnDisk += (int64_t) data->fileSize;
+            data->block.reset();
+        }
+    }
+
+    juce::MemoryBlock readFromFile (int64_t offset, size_t size)
+    {
+        const std::scoped_lock sl (mutex);
+        juce::MemoryBlock block;
+
+        if (output != nullptr)
+            output->flush();
+
+        juce::FileInputStream input (spillFile);
+
+        if (input.openedOk() && input.setPosition (offset))
+            input.readIntoMemoryBlock (block, (juce::ssize_t) size);
+
+        return block;
+    }
+
+    const juce::File spillFile;
+    std::mutex mutex;
+    std::unique_ptr<juce::FileOutputStream> output;
+    std::deque<std::weak_ptr<Data>> inMemory;
+    int64_t memoryBudget = 0, numBytesInMemory = 0, numBytesOnDisk = 0;
+};
+
+//==============================================================================
+struct UndoHistoryStore::Data
+{
+    Data (std::shared_ptr<Storage> s, juce::MemoryBlock b)
+        : storage (std::move (s)), block (std::move (b))
+    {
+    }
+
+    ~Data()
+    {
+        // Space in the spill file isn't reused until the store is deleted
+        const std::scoped_lock sl (storage->mutex);
+
+        if (block.isEmpty())
+            storage->numBytesOnDisk -= (int64_t) fileSize;
+        else
+            storage->numBytesInMemory -= (int64_t) block.getSize();
+    }
+
+    const std::shared_ptr<Storage> storage;
+    juce::MemoryBlock block;
+    int64_t fileOffset = -1;
+    size_t fileSize = 0;
+};
+
+//==============================================================================
+UndoHistoryStore::UndoHistoryStore (const juce::File& spillDirectory)
+    : storage (std::make_shared<Storage> (spillDirectory))
+{
+}
+
+UndoHistoryStore::~UndoHistoryStore()
+{
+}
+
+void UndoHistoryStore::setMemoryBudget (int64_t numBytes)
+{
+    {
+        const std::scoped_lock sl (storage->mutex);
+        storage->memoryBudget = numBytes;
+    }
+
+    storage->spill();
+}
+
+int64_t UndoHistoryStore::getMemoryBudget() const
+{
+    const std::scoped_lock sl (storage->mutex);
+    return storage->memoryBudget;
+}
+
+int64_t UndoHistoryStore::getNumBytesInMemory() const
+{
+    const std::scoped_lock sl (storage->mutex);
+    return storage->numBytesInMemory;
+}
+
+int64_t UndoHistoryStore::getNumBytesOnDisk() const
+{
+    const std::scoped_lock sl (storage->mutex);
+    return storage->numBytesOnDisk;
+}
+
+std::shared_ptr<UndoHistoryStore::Data> UndoHistoryStore::add (const juce::ValueTree& v)
+{
+    CRASH_TRACER
+    juce::MemoryBlock block;
+
+    {
+        juce::MemoryOutputStream out (block, false);
+        juce::GZIPCompressorOutputStream deflater (out, 6);
+        v.writeToStream (deflater);
+    }
+
+    auto data = std::make_shared<Data> (storage, std::move (block));
+
+    {
+        const std::scoped_lock sl (storage->mutex);
+        storage->numBytesInMemory += (int64_t) data->block.getSize();
+        storage->inMemory.push_back (data);
+    }
+
+    storage->spill();
+
+    return data;
+}
+
+juce::ValueTree UndoHistoryStore::read (const Data& data)
+{
+    CRASH_TRACER
+    auto block = data.block;
+
+    if (block.isEmpty())
+    {
+        jassert (data.fileOffset >= 0);
+        block = data.storage->readFromFile (data.fileOffset, data.fileSize);
+    }
+
+    juce::MemoryInputStream in (block, false);
+    juce::GZIPDecompressorInputStream inflater (in);
+
+    return juce::ValueTree::readFromStream (inflater);
+}
+
+int64_t UndoHistoryStore::getNumBytesInMemory (const Data& data)
+{
+    return (int64_t) data.block.getSize();
+}
+
+
+//==============================================================================
+//==============================================================================
+namespace
+{
+    struct CompactStateChangeAction  : public juce::UndoableAction
+    {
+        CompactStateChangeAction (juce::ValueTree t,
+                                  std::shared_ptr<UndoHistoryStore::Data> b,
+                                  std::shared_ptr<UndoHistoryStore::Data> a)
+            : target (std::move (t)), before (std::move (b)), after (std::move (a))
+        {
+        }
+
+        bool perform() override
+        {
+            // The change has already been made by the time this is first performed
+            if (std::exchange (isFirstPerform, false))
+                return true;
+
+            return restore (*after);
+        }
+
+        bool undo() override
+        {
+            return restore (*before);
+        }
+
+        int getSizeInUnits() override
+        {
+            // ValueTree's own actions count as 10 units so this keeps a similar scale
+            const auto numBytes = UndoHistoryStore::getNumBytesInMemory (*before)
+                                    + UndoHistoryStore::getNumBytesInMemory (*after);
+            return 10 + (int) (numBytes / 1024);
+        }
+
+        bool restore (const UndoHistoryStore::Data& data)
+        {
+            auto v = UndoHistoryStore::read (data);
+
+            if (! v.isValid() || ! target.hasType (v.getType()))
+            {
+                jassertfalse;
+                return false;
+            }
+
+            target.copyPropertiesAndChildrenFrom (v, nullptr);
+            return true;
+        }
+
+        juce::ValueTree target;
+        std::shared_ptr<UndoHistoryStore::Data> before, after;
+        bool isFirstPerform = true;
+    };
+}
+
+//==============================================================================
+CompactUndoableChange::CompactUndoableChange (Edit& e, juce::ValueTree v, int numItemsToChange)
+    : edit (e), target (std::move (v))
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (numItemsToChange >= minNumItemsToCompact && target.isValid())
+        before = edit.getUndoHistoryStore().add (target);
+}
+
+CompactUndoableChange::~CompactUndoableChange()
+{
+    if (before == nullptr)
+        return;
+
+    auto after = edit.getUndoHistoryStore().add (target);
+    edit.getUndoManager().perform (new CompactStateChangeAction (target, std::move (before), std::move (after)));
+}
+
+juce::UndoManager* CompactUndoableChange::getUndoManager() const noexcept
+{
+    return before != nullptr ? nullptr : &edit.getUndoManager();
+}
+
+} // namespace tracktion::inline engine
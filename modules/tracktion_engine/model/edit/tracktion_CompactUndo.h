@@ -0,0 +1,120 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Holds the compressed states used by CompactUndoableChanges and moves the oldest
+    of them to a file once they take up more than a memory budget.
+
+    Every Edit has one of these. @see Edit::getUndoHistoryStore
+*/
+class UndoHistoryStore
+{
+public:
+    /** Creates a store that spills to a file in a directory. */
+    UndoHistoryStore (const juce::File& spillDirectory);
+
+    /** Destructor. The spill file is deleted once any data still in use is released. */
+    ~UndoHistoryStore();
+
+    //==============================================================================
+    /** Sets the number of bytes to keep in memory before spilling to disk.
+        0 keeps everything in memory.
+    */
+    void setMemoryBudget (int64_t numBytes);
+
+    /** Returns the budget set by setMemoryBudget. */
+    int64_t getMemoryBudget() const;
+
+    /** Returns the number of compressed bytes held in memory. */
+    int64_t getNumBytesInMemory() const;
+
+    /** Returns the number of compressed bytes that have been moved to disk. */
+    int64_t getNumBytesOnDisk() const;
+
+    //==============================================================================
+    /** Some stored data. This is released from the store when it's deleted. */
+    struct Data;
+
+    /** Compresses a ValueTree and adds it to the store. */
+    std::shared_ptr<Data> add (const juce::ValueTree&);
+
+    /** Returns a ValueTree that was added to the store, reading it back from disk if necessary. */
+    static juce::ValueTree read (const Data&);
+
+    /** Returns the number of bytes the data uses in memory, 0 if it's been moved to disk. */
+    static int64_t getNumBytesInMemory (const Data&);
+
+private:
+    struct Storage;
+    std::shared_ptr<Storage> storage;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UndoHistoryStore)
+};
+
+
+//==============================================================================
+//==============================================================================
+/**
+    Makes a large change to part of an Edit undoable as a single compact action.
+
+    Rather than the UndoManager holding an action for every property and child
+    that changes, the state of the target ValueTree is stored before and after the
+    change, compressed, in the Edit's UndoHistoryStore. Undoing or redoing then
+    replaces the target's properties and children with the stored state.
+
+    Use it for bulk operations such as quantising or pasting thousands of notes.
+    Make the changes with getUndoManager(), which is nullptr whilst compacting,
+    and the action is added when this goes out of scope. Changes that don't
+    affect many items are left to the UndoManager as usual, as replacing the
+    children on undo recreates any objects that represent them.
+
+    @code
+    {
+        CompactUndoableChange change (edit, clip.getSequence().state, numNotes);
+
+        for (auto n : notes)
+            n->setStartAndLength (quantise (n->getStartBeat()), n->getLengthBeats(), change.getUndoManager());
+    }
+    @endcode
+*/
+class CompactUndoableChange
+{
+public:
+    /** Starts a change to a ValueTree that affects a number of items.
+        If this is fewer than minNumItemsToCompact, the change isn't compacted.
+    */
+    CompactUndoableChange (Edit&, juce::ValueTree target, int numItemsToChange);
+
+    /** Adds the compact action to the Edit's UndoManager. */
+    ~CompactUndoableChange();
+
+    /** Returns the UndoManager to make the changes with. */
+    juce::UndoManager* getUndoManager() const noexcept;
+
+    /** Returns true if the change is being compacted. */
+    bool isCompacting() const noexcept                  { return before != nullptr; }
+
+    /** The number of items a change needs to affect for it to be compacted. */
+    static constexpr int minNumItemsToCompact = 1000;
+
+private:
+    Edit& edit;
+    juce::ValueTree target;
+    std::shared_ptr<UndoHistoryStore::Data> before;
+
+    JUCE_DECLARE_NON_COPYABLE (CompactUndoableChange)
+};
+
+} // namespace tracktion::inline engine
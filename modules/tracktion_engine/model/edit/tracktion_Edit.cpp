@@ -164,13 +164,20 @@ struct Edit::TreeWatcher   : public juce::ValueTree::Listener
                         || i == IDs::autoPitch || i == IDs::autoTempo
                         || i == IDs::channels || i == IDs::isReversed
                         || i == IDs::currentTake || i == IDs::sequence || i == IDs::repeatSequence
-                        || i == IDs::loopedSequenceType || i == IDs::grooveStrength
+                        || i == IDs::loopedSequenceType
                         || i == IDs::proxyAllowed || i == IDs::resamplingQuality || i == IDs::warpTime
                         || i == IDs::disabled || i == IDs::followActionBeats || i == IDs::followActionNumLoops
                         || i == IDs::followActionDurationType)
             {
                 restart();
             }
+            else if (i == IDs::grooveStrength)
+            {
+                // MIDI clips played in beats pick up the strength whilst playing,
+                // proxied ones have the groove baked in so need rebuilding
+                if (! v.hasType (IDs::MIDICLIP) || (bool) v.getProperty (IDs::proxyAllowed, true))
+                    restart();
+            }
         }
         else if (v.hasType (IDs::COMPSECTION))
         {
@@ -571,6 +578,211 @@ struct Edit::MirroredPluginUpdateTimer  : private juce::Timer
 };
 
 //==============================================================================
+struct Edit::ModifierEvaluationThread
+{
+    ModifierEvaluationThread (const Edit& ed)
+        : edit (ed)
+    {
+        thread = std::thread ([this] { run(); });
+    }
+
+    ~ModifierEvaluationThread()
+    {
+        threadShouldExit.store (true, std::memory_order_release);
+        event.signal();
+        thread.join();
+    }
+
+    /** Starts evaluating the block after this one. [[ audio_thread ]] */
+    void evaluateBlockAfter (TimePosition editTime, int numSamples)
+    {
+        lastBlock.store ({ editTime, numSamples });
+        event.signal();
+    }
+
+private:
+    struct Block
+    {
+        TimePosition editTime;
+        int numSamples = 0;
+    };
+
+    const Edit& edit;
+    crill::seqlock_object<Block> lastBlock;
+    std::atomic<bool> threadShouldExit { false };
+    juce::WaitableEvent event;
+    std::thread thread;
+
+    void run()
+    {
+        std::vector<ControlRateModifierTimer*> timers;
+        std::vector<std::unique_lock<std::mutex>> locks;
+
+        for (;;)
+        {
+            event.wait (-1);
+
+            if (threadShouldExit.load (std::memory_order_acquire))
+                return;
+
+            const auto block = lastBlock.load();
+
+            // The timers are locked whilst the Edit's list is so they can't be removed
+            // part way through, the audio thread will keep their current values until they're done
+            {
+                const juce::ScopedLock sl (edit.modifierTimers.getLock());
+
+                for (auto mt : edit.modifierTimers)
+                {
+                    if (auto crt = dynamic_cast<ControlRateModifierTimer*> (mt))
+                    {
+                        locks.emplace_back (crt->evaluationMutex);
+                        timers.push_back (crt);
+                    }
+                }
+            }
+
+            for (auto crt : timers)
+                crt->evaluateAhead (block.editTime, block.numSamples);
+
+            locks.clear();
+            timers.clear();
+        }
+    }
+};
+
+//==============================================================================
+static int countNumExternalPlugins (const juce::ValueTree& v)
+{
+    int total = 0;
+
+    for (const auto& c : v)
+    {
+        if (c.hasType (IDs::PLUGIN) && c[IDs::type].toString() == ExternalPlugin::xmlTypeName)
+            ++total;
+
+        total += countNumExternalPlugins (c);
+    }
+
+    return total;
+}
+
+static int countNumExternalPluginsOnTracks (const juce::ValueTree& v)
+{
+    int total = 0;
+
+    for (const auto& c : v)
+        if (TrackList::isTrack (c.getType()))
+            total += countNumExternalPlugins (c);
+
+    return total;
+}
+
+//==============================================================================
+namespace edit_loading
+{
+    struct AudioFileToPreload
+    {
+        AudioFile file;
+        std::optional<double> startTime;
+    };
+
+    static void findAudioFilesToPreload (Edit& edit, const juce::ValueTree& v, TimePosition transportPosition,
+                                         std::map<juce::File, std::optional<double>>& files)
+    {
+        for (const auto& c : v)
+        {
+            if (c.hasType (IDs::AUDIOCLIP) && c.hasProperty (IDs::source))
+            {
+                auto file = SourceFileReference::findFileFromString (edit, c[IDs::source].toString());
+
+                if (file != juce::File())
+                {
+                    auto& startTime = files[file];
+
+                    // If the clip is under the transport, find the time in the file it'll start playing from
+                    const auto clipStart = TimePosition::fromSeconds (static_cast<double> (c[IDs::start]));
+                    const auto clipEnd = clipStart + TimeDuration::fromSeconds (static_cast<double> (c[IDs::length]));
+
+                    if (! startTime && transportPosition >= clipStart && transportPosition < clipEnd)
+                    {
+                        const auto speedRatio = c.getProperty (IDs::speed, 1.0);
+                        startTime = static_cast<double> (c[IDs::offset])
+                                      + (transportPosition - clipStart).inSeconds() * static_cast<double> (speedRatio);
+                    }
+                }
+            }
+
+            findAudioFilesToPreload (edit, c, transportPosition, files);
+        }
+    }
+
+    /** Reads the headers of all the audio files used by clips concurrently so the
+        clips don't each have to wait for them when they're created.
+        If the Edit will be played, the first second of the files under the transport
+        are read too so they're in the OS's file cache when playback starts.
+    */
+    static void preloadAudioFiles (Edit& edit, const juce::ValueTree& editState)
+    {
+        CRASH_TRACER
+        std::map<juce::File, std::optional<double>> filesFound;
+        const auto transportPosition = TimePosition::fromSeconds (static_cast<double> (editState.getChildWithName (IDs::TRANSPORT)[IDs::position]));
+
+        for (const auto& c : editState)
+            if (TrackList::isTrack (c.getType()))
+                findAudioFilesToPreload (edit, c, transportPosition, filesFound);
+
+        std::vector<AudioFileToPreload> files;
+
+        for (auto& [file, startTime] : filesFound)
+            files.push_back ({ AudioFile (edit.engine, file), edit.shouldPlay() ? startTime : std::nullopt });
+
+        if (files.size() < 2)
+            return;
+
+        std::atomic<size_t> nextFileToPreload { 0 };
+        std::vector<std::thread> threads;
+        const auto numThreads = std::min (files.size(),
+                                          (size_t) std::max (1, juce::SystemStats::getNumCpus() - 1));
+
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back ([&files, &nextFileToPreload, &edit]
+            {
+                for (;;)
+                {
+                    const auto index = nextFileToPreload.fetch_add (1);
+
+                    if (index >= files.size())
+                        break;
+
+                    auto& toPreload = files[index];
+                    const auto info = toPreload.file.getInfo();
+
+                    if (! toPreload.startTime || ! info.wasParsedOk || info.sampleRate <= 0 || info.numChannels <= 0)
+                        continue;
+
+                    if (auto reader = edit.engine.getAudioFileManager().cache.createReader (toPreload.file))
+                    {
+                        const int blockSize = 8192;
+                        const auto channels = juce::AudioChannelSet::canonicalChannelSet (info.numChannels);
+                        juce::AudioBuffer<float> scratch (info.numChannels, blockSize);
+
+                        reader->setReadPosition (juce::roundToInt (*toPreload.startTime * info.sampleRate));
+
+                        for (int numRead = 0; numRead < (int) info.sampleRate; numRead += blockSize)
+                            if (! reader->readSamples (blockSize, scratch, channels, 0, channels, 200))
+                                break;
+                    }
+                }
+            });
+        }
+
+        for (auto& t : threads)
+            t.join();
+    }
+}
+
 static int getNextInstanceId() noexcept
 {
     static juce::Atomic<int> nextId;
@@ -621,8 +833,13 @@ Edit::Edit (Options options)
         };
 
     if (loadContext != nullptr && ! loadContext->shouldExit)
+    {
         loadContext->totalNumTracks = countNumTracks (state);
 
+        if (options.initialisePluginsInBatch)
+            loadContext->totalNumPlugins = countNumExternalPluginsOnTracks (state);
+    }
+
     try
     {
         pluginCache                 = std::make_unique<PluginCache> (*this);
@@ -630,6 +847,10 @@ Edit::Edit (Options options)
         transportControl            = std::make_unique<TransportControl> (*this, state.getOrCreateChildWithName (IDs::TRANSPORT, nullptr));
         automationRecordManager     = std::make_unique<AutomationRecordManager> (*this);
         markerManager               = std::make_unique<MarkerManager> (*this, state.getOrCreateChildWithName (IDs::MARKERTRACK, nullptr));
+        memoryBudget                = std::make_unique<EditMemoryBudget> (*this);
+        undoHistoryStore            = std::make_unique<UndoHistoryStore> (engine.getTemporaryFileManager().getTempDirectory());
+        pluginStateCapture          = std::make_unique<PluginStateCapture> (*this);
+        cpuUsage                    = std::make_unique<EditCpuUsage> (*this);
         pluginChangeTimer           = std::make_unique<PluginChangeTimer> (*this);
         frozenTrackCallback         = std::make_unique<FrozenTrackCallback> (*this);
         masterPluginList            = std::make_unique<PluginList> (*this);
@@ -640,6 +861,7 @@ Edit::Edit (Options options)
         changedPluginsList          = std::make_unique<ChangedPluginsList>();
 
         undoManager.setMaxNumberOfStoredUnits (1000 * options.numUndoLevelsToStore, options.numUndoLevelsToStore);
+        undoHistoryStore->setMemoryBudget (32 * 1024 * 1024);
 
         initialise (options);
 
@@ -713,6 +935,7 @@ Edit::~Edit()
     engine.getActiveEdits().edits.removeFirstMatchingValue (this);
     masterReference.clear();
     changeResetterTimer.reset();
+    autosaveJournal.reset();
 
     if (transportControl != nullptr)
         transportControl->freePlaybackContext();
@@ -724,6 +947,10 @@ Edit::~Edit()
     jassert (numUndoTransactionInhibitors == 0);
 
     cancelAllProxyGeneratorJobs();
+    pluginStateCapture.reset();
+
+    // This is only deleted once the playback graph has gone as its Nodes might still be profiled
+    cpuUsage.reset();
     changedPluginsList.reset();
     editInputDevices.reset();
     treeWatcher.reset();
@@ -828,14 +1055,44 @@ void Edit::initialise (const Options& options)
     initialiseRacks();
     initialiseMasterPlugins();
     initialiseAudioDevices();
+    if (options.preloadAudioFiles)
+        edit_loading::preloadAudioFiles (*this, state);
+
+    if (options.initialisePluginsInBatch)
+        externalPluginBatchLoader = std::make_unique<ExternalPluginBatchLoader>();
+
     loadTracks();
 
     if (loadContext != nullptr)
-    {
         assert (loadContext->totalNumTracks == loadContext->numTracksLoaded);
-        loadContext->progress = 1.0f;
+
+    if (auto loader = std::move (externalPluginBatchLoader))
+    {
+        std::function<bool (ExternalPlugin&)> shouldDeferPlugin;
+
+        if (options.deferPluginsOnInactiveTracks)
+            shouldDeferPlugin = [] (ExternalPlugin& p)
+                                {
+                                    if (auto t = p.getOwnerTrack())
+                                        return t->isFrozen (Track::anyFreeze) || t->isMuted (true) || t->isHidden();
+
+                                    return false;
+                                };
+
+        loader->initialiseAll ([this]
+                               {
+                                   if (loadContext != nullptr)
+                                   {
+                                       loadContext->numPluginsLoaded.fetch_add (1);
+                                       updateLoadProgress();
+                                   }
+                               },
+                               shouldDeferPlugin);
     }
 
+    if (loadContext != nullptr)
+        loadContext->progress = 1.0f;
+
     initialiseTracks (options);
     initialiseARA();
     updateMuteSoloStatuses();
@@ -1140,6 +1397,31 @@ void Edit::initialiseARA()
 
 void Edit::flushState()
 {
+    flushState (true);
+}
+
+void Edit::flushStateAsync (std::function<void()> onFlushed)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    pluginStateCapture->captureAsync ([safeEdit = SafeSelectable<Edit> (*this), onFlushed = std::move (onFlushed)]
+                                      {
+                                          if (safeEdit == nullptr)
+                                              return;
+
+                                          safeEdit->flushState (false);
+
+                                          if (onFlushed)
+                                              onFlushed();
+                                      });
+}
+
+void Edit::flushState (bool captureExternalPluginStates)
+{
+    // Any states still being captured are older than the ones about to be read so must be written first
+    if (captureExternalPluginStates)
+        pluginStateCapture->waitForCapture();
+
    #if TRACKTION_ENABLE_AUTOMAP && TRACKTION_ENABLE_CONTROL_SURFACES
     if (shouldPlay())
         if (auto na = engine.getExternalControllerManager().getAutomap())
@@ -1154,7 +1436,13 @@ void Edit::flushState()
                             IDs::projectID, editProjectItemID.load().toString());
 
     for (auto p : getAllPlugins (*this, true))
-        p->flushPluginStateToValueTree();
+    {
+        // The PluginStateCapture has already written the states of any that have changed
+        if (auto ep = dynamic_cast<ExternalPlugin*> (p); ep != nullptr && ! captureExternalPluginStates)
+            ep->flushPluginStateToValueTree (std::nullopt);
+        else
+            p->flushPluginStateToValueTree();
+    }
 
     for (auto m : getAllModifiers (*this))
         m->flushPluginStateToValueTree();
@@ -1188,6 +1476,19 @@ void Edit::resetChangedStatus()
     hasChanged = false;
 }
 
+void Edit::setAutosaveJournalingEnabled (bool shouldBeEnabled)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (shouldBeEnabled == (autosaveJournal != nullptr))
+        return;
+
+    if (shouldBeEnabled)
+        autosaveJournal = std::make_unique<EditJournal> (*this);
+    else
+        autosaveJournal.reset();
+}
+
 void Edit::markAsChanged()
 {
     lastSignificantChange = juce::String::toHexString (juce::Time::getCurrentTime().toMilliseconds());
@@ -1414,13 +1715,23 @@ Track::Ptr Edit::loadedTrack (Track::Ptr t)
     if (! loadContext)
         return t;
 
-    if (const auto total = loadContext->totalNumTracks.load();
-        total > 0)
-       loadContext->progress = loadContext->numTracksLoaded.fetch_add (1) / static_cast<float> (total);
+    loadContext->numTracksLoaded.fetch_add (1);
+    updateLoadProgress();
 
     return t;
 }
 
+void Edit::updateLoadProgress()
+{
+    jassert (loadContext != nullptr);
+
+    // N.B. The number of plugins is counted from the state before the tracks load so is only an estimate
+    if (const auto total = loadContext->totalNumTracks.load() + loadContext->totalNumPlugins.load();
+        total > 0)
+       loadContext->progress = std::min (0.99f, (loadContext->numTracksLoaded.load() + loadContext->numPluginsLoaded.load())
+                                                  / static_cast<float> (total));
+}
+
 template <typename Type>
 static Track::Ptr createAndInitialiseTrack (Edit& ed, const juce::ValueTree& v)
 {
@@ -1472,6 +1783,9 @@ void Edit::updateMuteSoloStatuses()
         return true;
     });
 
+    anyTracksSoloAtLastUpdate.store (anySolo, std::memory_order_release);
+    muteSoloStatusVersion.fetch_add (1, std::memory_order_acq_rel);
+
     auto& ecm = engine.getExternalControllerManager();
 
     if (ecm.isAttachedToEdit (this))
@@ -2301,6 +2615,12 @@ void Edit::addModifierTimer (ModifierTimer& mt)
 void Edit::removeModifierTimer (ModifierTimer& mt)
 {
     modifierTimers.removeFirstMatchingValue (&mt);
+
+    // Wait for the timer to finish being evaluated in the background
+    if (auto crt = dynamic_cast<ControlRateModifierTimer*> (&mt))
+    {
+        const std::scoped_lock sl (crt->evaluationMutex);
+    }
 }
 
 void Edit::updateModifierTimers (TimePosition editTime, int numSamples) const
@@ -2309,6 +2629,26 @@ void Edit::updateModifierTimers (TimePosition editTime, int numSamples) const
 
     for (auto mt : modifierTimers)
         mt->updateStreamTime (editTime, numSamples);
+
+    if (modifierEvaluationThread)
+        modifierEvaluationThread->evaluateBlockAfter (editTime, numSamples);
+}
+
+void Edit::setEvaluateModifiersAhead (bool shouldEvaluateAhead)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (shouldEvaluateAhead == (modifierEvaluationThread != nullptr))
+        return;
+
+    auto newThread = shouldEvaluateAhead ? std::make_unique<ModifierEvaluationThread> (*this) : nullptr;
+
+    {
+        const juce::ScopedLock sl (modifierTimers.getLock());
+        std::swap (newThread, modifierEvaluationThread);
+    }
+
+    // Any old thread is stopped here, outside the lock, as it might be waiting for it
 }
 
 //==============================================================================
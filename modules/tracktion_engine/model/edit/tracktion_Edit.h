@@ -12,6 +12,7 @@ namespace tracktion { inline namespace engine
 {
 
 class ClipEffect;
+class EditJournal;
 
 //==============================================================================
 /**
@@ -97,6 +98,8 @@ public:
         friend Edit;
         std::atomic<int> totalNumTracks { 0 };
         std::atomic<int> numTracksLoaded { 0 };
+        std::atomic<int> totalNumPlugins { 0 };
+        std::atomic<int> numPluginsLoaded { 0 };
     };
 
     using EditFileRetriever = std::function<juce::File()>;
@@ -120,6 +123,10 @@ public:
         uint32_t numAudioTracks = 1;                                 ///< If non-zero, will ensure the edit has this many audio tracks
 
         float defaultMasterVolumedB = -3.0f;                         ///< The initial level for the edit's master volume
+
+        bool initialisePluginsInBatch = true;                        ///< If true, ExternalPlugins are initialised together once all the tracks have loaded. @see ExternalPluginBatchLoader
+        bool deferPluginsOnInactiveTracks = false;                   ///< If true (and initialisePluginsInBatch is), ExternalPlugins on frozen, muted or hidden tracks aren't instantiated until the graph needs them
+        bool preloadAudioFiles = true;                               ///< If true, the headers of the clips' audio files are read concurrently before the tracks are created
     };
 
     /** Creates an Edit from a set of Options.
@@ -198,6 +205,13 @@ public:
     /** Saves the plugin, automap and ARA states to the state ValueTree. */
     void flushState();
 
+    /** Saves the same states as flushState but captures the ExternalPlugin states with
+        the PluginStateCapture first so the message thread isn't blocked whilst they're read.
+        The function is called on the message thread once the ValueTree is up to date,
+        unless the Edit is deleted first.
+    */
+    void flushStateAsync (std::function<void()> onFlushed);
+
     /** Saves the specified plugin state to the state ValueTree. */
     void flushPluginStateIfNeeded (Plugin&);
 
@@ -212,6 +226,17 @@ public:
     /** Returns true if the Edit has changed since it was last saved. */
     bool hasChangedSinceSaved() const;
 
+    /** Enables or disables journaled autosaves.
+        When enabled, the quick saves made by EditFileOperations::saveTempVersion only
+        append the changes made since the previous one to a journal next to the temp
+        file, rather than writing the whole Edit.
+        @see EditJournal
+    */
+    void setAutosaveJournalingEnabled (bool);
+
+    /** Returns the journal used for autosaves if journaling is enabled. */
+    EditJournal* getAutosaveJournal() const noexcept                    { return autosaveJournal.get(); }
+
     /** Returns true if the Edit's not yet fully loaded */
     bool isLoading() const                                              { return isLoadInProgress; }
 
@@ -464,6 +489,17 @@ public:
     */
     void updateMuteSoloStatuses();
 
+    /** Returns a number that changes each time the tracks' mute/solo statuses are updated.
+        This can be called from the audio thread to find out if Track::shouldBePlayed()
+        needs checking again.
+    */
+    uint32_t getMuteSoloStatusVersion() const noexcept      { return muteSoloStatusVersion.load (std::memory_order_acquire); }
+
+    /** Returns whether any tracks were soloed the last time the mute/solo statuses were updated.
+        Unlike areAnyTracksSolo(), this is safe to call from the audio thread.
+    */
+    bool wereAnyTracksSoloAtLastUpdate() const noexcept     { return anyTracksSoloAtLastUpdate.load (std::memory_order_acquire); }
+
     //==============================================================================
     /** Returns the global launch quantisation. */
     LaunchQuantisation& getLaunchQuantisation();
@@ -509,6 +545,13 @@ public:
     /** Updates all the ModifierTimers with a given edit time and number of samples. */
     void updateModifierTimers (TimePosition editTime, int numSamples) const;
 
+    /** Enables evaluating any ControlRateModifierTimers one block ahead on a background thread.
+        Each call to updateModifierTimers publishes the values calculated for that block and
+        then starts evaluating the one after it.
+        @see EngineBehaviour::shouldEvaluateModifiersAhead
+    */
+    void setEvaluateModifiersAhead (bool);
+
     /** Holds the global Macros for the Edit. */
     struct GlobalMacros : public MacroParameterElement
     {
@@ -583,6 +626,11 @@ public:
     /** Returns the PluginCache which manages all active Plugin[s] for this Edit. */
     PluginCache& getPluginCache() noexcept;
 
+    /** @internal Returns the loader collecting ExternalPlugins whilst the tracks are
+        loading, or nullptr if there isn't one.
+    */
+    ExternalPluginBatchLoader* getExternalPluginBatchLoader() const noexcept    { return externalPluginBatchLoader.get(); }
+
     /** Returns the time of first clip. */
     TimePosition getFirstClipTime() const;
 
@@ -778,6 +826,18 @@ public:
     /// Returns the MarkerManager
     MarkerManager& getMarkerManager() const noexcept    { return *markerManager; }
 
+    /// Returns the EditMemoryBudget used to measure and limit the Edit's memory use
+    EditMemoryBudget& getMemoryBudget() const noexcept  { return *memoryBudget; }
+
+    /// Returns the UndoHistoryStore that holds the compressed states of CompactUndoableChanges
+    UndoHistoryStore& getUndoHistoryStore() const noexcept  { return *undoHistoryStore; }
+
+    /// Returns the PluginStateCapture used to save ExternalPlugin states in the background
+    PluginStateCapture& getPluginStateCapture() const noexcept  { return *pluginStateCapture; }
+
+    /// Returns the EditCpuUsage used to measure the processing time of the Edit's tracks, plugins and clips
+    EditCpuUsage& getCpuUsage() const noexcept          { return *cpuUsage; }
+
     /// Returns the ARA document handler
     ARADocumentHolder& getARADocument();
 
@@ -886,6 +946,10 @@ private:
     juce::ReferenceCountedObjectPtr<VolumeAndPanPlugin> masterVolumePlugin;
     mutable std::unique_ptr<AbletonLink> abletonLink;
     std::unique_ptr<MarkerManager> markerManager;
+    std::unique_ptr<EditMemoryBudget> memoryBudget;
+    std::unique_ptr<UndoHistoryStore> undoHistoryStore;
+    std::unique_ptr<PluginStateCapture> pluginStateCapture;
+    std::unique_ptr<EditCpuUsage> cpuUsage;
     struct UndoTransactionTimer;
     std::unique_ptr<UndoTransactionTimer> undoTransactionTimer;
     struct PluginChangeTimer;
@@ -893,13 +957,19 @@ private:
     struct FrozenTrackCallback;
     std::unique_ptr<FrozenTrackCallback> frozenTrackCallback;
     std::unique_ptr<PluginCache> pluginCache;
+    std::unique_ptr<EditJournal> autosaveJournal;
+    std::unique_ptr<ExternalPluginBatchLoader> externalPluginBatchLoader;
     std::unique_ptr<TrackCompManager> trackCompManager;
     juce::Array<ModifierTimer*, juce::CriticalSection> modifierTimers;
+    struct ModifierEvaluationThread;
+    std::unique_ptr<ModifierEvaluationThread> modifierEvaluationThread;
     std::unique_ptr<GlobalMacros> globalMacros;
 
     mutable std::optional<TimeDuration> totalEditLength;
     std::atomic<bool> isLoadInProgress { true };
     std::atomic<int> performingRenderCount { 0 };
+    std::atomic<uint32_t> muteSoloStatusVersion { 0 };
+    std::atomic<bool> anyTracksSoloAtLastUpdate { false };
     bool shouldRestartPlayback = false;
     bool blinkBright = false;
     bool lowLatencyMonitoring = false;
@@ -947,6 +1017,7 @@ private:
     Track::Ptr createTrack (const juce::ValueTree&);
     Track::Ptr loadTrackFrom (juce::ValueTree&);
     Track::Ptr loadedTrack (Track::Ptr);
+    void updateLoadProgress();
     void updateTrackStatuses();
     void updateTrackStatusesAsync();
     void moveTrackInternal (Track::Ptr, TrackInsertPoint);
@@ -954,6 +1025,7 @@ private:
     //==============================================================================
     void initialise (const Options&);
     void undoOrRedo (bool isUndo);
+    void flushState (bool captureExternalPluginStates);
 
     //==============================================================================
     void initialiseTempoAndPitch();
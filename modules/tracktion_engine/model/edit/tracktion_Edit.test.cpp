@@ -27,6 +27,71 @@ TEST_SUITE("tracktion_engine")
         CHECK(edit);
         CHECK(getAudioTracks (*edit).size() == 1);
     }
+
+    TEST_CASE("EditMemoryBudget")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine, Edit::EditRole::forRendering);
+        auto& budget = edit->getMemoryBudget();
+
+        auto report = budget.createReport();
+        CHECK(report.tracks.size() == getAllTracks (*edit).size());
+        CHECK(report.stateBytes > 0);
+        CHECK(report.getTotalBytes() >= report.stateBytes);
+
+        CHECK(budget.canAllocate (1024 * 1024));
+
+        EditMemoryBudget::Limits limits;
+        limits.softLimitBytes = report.getTotalBytes() / 2;
+        budget.setLimits (limits);
+
+        auto result = budget.enforceLimits();
+        CHECK(result.isOverLimit);
+        CHECK(result.frozenTracks.isEmpty());
+        CHECK(! budget.canAllocate (0));
+
+        limits.denyNewAllocations = false;
+        budget.setLimits (limits);
+        CHECK(budget.canAllocate (0));
+    }
+
+    TEST_CASE("CompactUndoableChange")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = Edit::createSingleTrackEdit (engine, Edit::EditRole::forEditing);
+        auto& um = edit->getUndoManager();
+        auto& store = edit->getUndoHistoryStore();
+        store.setMemoryBudget (1);
+
+        juce::ValueTree target ("TARGET");
+        edit->state.addChild (target, -1, nullptr);
+        um.beginNewTransaction();
+
+        {
+            const int numItems = CompactUndoableChange::minNumItemsToCompact;
+            CompactUndoableChange change (*edit, target, numItems);
+            CHECK(change.isCompacting());
+            CHECK(change.getUndoManager() == nullptr);
+
+            for (int i = 0; i < numItems; ++i)
+                target.appendChild (juce::ValueTree ("ITEM", { { "index", i } }), change.getUndoManager());
+        }
+
+        // The budget is too small to keep either snapshot in memory
+        CHECK(store.getNumBytesOnDisk() > 0);
+        CHECK(target.getNumChildren() == CompactUndoableChange::minNumItemsToCompact);
+
+        um.undo();
+        CHECK(target.getNumChildren() == 0);
+
+        um.redo();
+        CHECK(target.getNumChildren() == CompactUndoableChange::minNumItemsToCompact);
+        CHECK(target.getChild (10).getProperty ("index") == juce::var (10));
+
+        um.clearUndoHistory();
+        CHECK(store.getNumBytesInMemory() == 0);
+        CHECK(store.getNumBytesOnDisk() == 0);
+    }
 }
 
 //==============================================================================
@@ -23,10 +23,10 @@ struct ThreadedEditFileWriter   : private juce::Thread
         jassert (pending.isEmpty());
     }
 
-    void writeTreeToFile (juce::ValueTree&& v, const juce::File& f)
+    void writeTreeToFile (juce::ValueTree&& v, const juce::File& f, std::function<void (bool)> onWritten = {})
     {
         TRACKTION_ASSERT_MESSAGE_THREAD
-        pending.add (std::pair<juce::ValueTree, juce::File> (v, f));
+        pending.add ({ std::move (v), f, std::move (onWritten) });
         waiter.signal();
         startThread();
     }
@@ -53,14 +53,29 @@ private:
         }
     }
 
-    void writeToFile (std::pair<juce::ValueTree, juce::File> item)
+    struct PendingWrite
     {
-        item.second.deleteFile();
-        juce::FileOutputStream os (item.second);
-        item.first.writeToStream (os);
+        juce::ValueTree tree;
+        juce::File file;
+        std::function<void (bool)> onWritten;
+    };
+
+    void writeToFile (PendingWrite item)
+    {
+        // Keeping the writers around means only the sections that have changed get written
+        auto& writer = writers[item.file];
+
+        if (! writer)
+            writer = std::make_unique<BinaryEditFile::Writer> (item.file);
+
+        const bool ok = writer->write (item.tree);
+
+        if (item.onWritten)
+            item.onWritten (ok);
     }
 
-    juce::Array<std::pair<juce::ValueTree, juce::File>, juce::CriticalSection> pending;
+    juce::Array<PendingWrite, juce::CriticalSection> pending;
+    std::map<juce::File, std::unique_ptr<BinaryEditFile::Writer>> writers;
     juce::WaitableEvent waiter;
 };
 
@@ -81,7 +96,11 @@ struct SharedEditFileDataCache
 
             // If we managed to shutdown cleanly (i.e. without crashing) then delete the temp file
             if (auto item = getProjectItemForEdit (edit))
-                EditFileOperations::getTempVersionOfEditFile (item->getSourceFile()).deleteFile();
+            {
+                auto tempFile = EditFileOperations::getTempVersionOfEditFile (item->getSourceFile());
+                tempFile.deleteFile();
+                EditJournal::getJournalFileFor (tempFile).deleteFile();
+            }
         }
 
         void refresh()
@@ -140,9 +159,9 @@ struct EditFileOperations::SharedDataPimpl
         cache->cleanUp();
     }
 
-    void writeValueTreeToDisk (juce::ValueTree&& v, const juce::File& f)
+    void writeValueTreeToDisk (juce::ValueTree&& v, const juce::File& f, std::function<void (bool)> onWritten = {})
     {
-        editFileWriter->writeTreeToFile (std::move (v), f);
+        editFileWriter->writeTreeToFile (std::move (v), f, std::move (onWritten));
     }
 
     juce::SharedResourcePointer<SharedEditFileDataCache> cache;
@@ -186,7 +205,10 @@ bool EditFileOperations::writeToFile (const juce::File& file, bool writeQuickBin
     {
         if (writeQuickBinaryVersion)
         {
-            sharedDataPimpl->writeValueTreeToDisk (edit.state.createCopy(), file);
+            if (auto journal = edit.getAutosaveJournal())
+                ok = journal->save (file);
+            else
+                sharedDataPimpl->writeValueTreeToDisk (edit.state.createCopy(), file);
         }
         else
         {
@@ -195,7 +217,9 @@ bool EditFileOperations::writeToFile (const juce::File& file, bool writeQuickBin
             if (editSnapshot != nullptr)
                 editSnapshot->setState (edit.state, edit.getLength());
 
-            if (auto xml = edit.state.createXml())
+            if (edit.engine.getEngineBehaviour().shouldSaveEditsAsBinaryEditFiles())
+                ok = BinaryEditFile::write (edit.state, file);
+            else if (auto xml = edit.state.createXml())
                 ok = xml->writeTo (file);
 
             jassert (ok);
@@ -279,6 +303,9 @@ bool EditFileOperations::save (bool warnOfFailure,
 
     tempFile.deleteFile();
 
+    if (auto journal = edit.getAutosaveJournal())
+        journal->reset();
+
     if (auto item = getProjectItemForEdit (edit))
         item->setLength (edit.getLength().inSeconds());
 
@@ -402,6 +429,62 @@ bool EditFileOperations::saveTempVersion (bool forceSaveEvenIfUnchanged)
     return writeToFile (getTempVersionFile(), ! forceSaveEvenIfUnchanged);
 }
 
+void EditFileOperations::saveTempVersionAsync (std::function<void (bool)> onSaved)
+{
+    CRASH_TRACER
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (! edit.hasChangedSinceSaved())
+    {
+        if (onSaved)
+            onSaved (true);
+
+        return;
+    }
+
+    edit.flushStateAsync ([safeEdit = SafeSelectable<Edit> (edit), onSaved = std::move (onSaved)]
+    {
+        auto callOnSaved = [onSaved] (bool ok)
+        {
+            if (onSaved)
+                onSaved (ok);
+        };
+
+        if (safeEdit == nullptr)
+            return;
+
+        EditFileOperations ops (*safeEdit);
+        const auto file = ops.getTempVersionFile();
+
+        if (! file.hasWriteAccess() || file.isDirectory())
+        {
+            callOnSaved (false);
+            return;
+        }
+
+        if (ops.editSnapshot != nullptr)
+            ops.editSnapshot->setState (safeEdit->state, safeEdit->getLength());
+
+        if (auto journal = safeEdit->getAutosaveJournal())
+        {
+            const bool ok = journal->save (file);
+
+            if (ok)
+                ops.timeOfLastSave = juce::Time::getCurrentTime();
+
+            callOnSaved (ok);
+            return;
+        }
+
+        ops.timeOfLastSave = juce::Time::getCurrentTime();
+        ops.sharedDataPimpl->writeValueTreeToDisk (safeEdit->state.createCopy(), file,
+                                                   [callOnSaved] (bool ok)
+                                                   {
+                                                       juce::MessageManager::callAsync ([callOnSaved, ok] { callOnSaved (ok); });
+                                                   });
+    });
+}
+
 juce::File EditFileOperations::getTempVersionOfEditFile (const juce::File& f)
 {
     return f != juce::File() ? f.getSiblingFile (".tmp_" + f.getFileNameWithoutExtension())
@@ -416,6 +499,331 @@ juce::File EditFileOperations::getTempVersionFile() const
 void EditFileOperations::deleteTempVersion()
 {
     getTempVersionFile().deleteFile();
+
+    if (auto journal = edit.getAutosaveJournal())
+        journal->reset();
+    else
+        EditJournal::getJournalFileFor (getTempVersionFile()).deleteFile();
+}
+
+//==============================================================================
+namespace edit_journal
+{
+    enum class Change
+    {
+        propertyChanged = 1,
+        propertyRemoved,
+        childAdded,
+        childRemoved,
+        childMoved
+    };
+
+    // The snapshot and each chunk of the journal are tagged with the ID of the EditJournal
+    // that wrote them and the generation of the snapshot the changes were made after
+    static const juce::Identifier& getJournalID()
+    {
+        static const juce::Identifier id ("journalID");
+        return id;
+    }
+
+    static const juce::Identifier& getGenerationID()
+    {
+        static const juce::Identifier id ("journalGeneration");
+        return id;
+    }
+
+    static constexpr int chunkHeaderSize = 16;
+
+    static juce::ValueTree readTree (juce::InputStream& in, juce::ValueTree root)
+    {
+        for (int i = in.readCompressedInt(); --i >= 0 && root.isValid();)
+            root = root.getChild (in.readCompressedInt());
+
+        return root;
+    }
+
+    static bool applyChange (juce::InputStream& in, juce::ValueTree& root)
+    {
+        const auto change = (Change) in.readByte();
+        auto v = readTree (in, root);
+
+        if (! v.isValid())
+            return false;
+
+        switch (change)
+        {
+            case Change::propertyChanged:
+            {
+                const juce::Identifier property (in.readString());
+                v.setProperty (property, juce::var::readFromStream (in), nullptr);
+                return true;
+            }
+            case Change::propertyRemoved:
+                v.removeProperty (juce::Identifier (in.readString()), nullptr);
+                return true;
+            case Change::childAdded:
+            {
+                const auto index = in.readCompressedInt();
+                v.addChild (juce::ValueTree::readFromStream (in), index, nullptr);
+                return true;
+            }
+            case Change::childRemoved:
+                v.removeChild (in.readCompressedInt(), nullptr);
+                return true;
+            case Change::childMoved:
+            {
+                const auto oldIndex = in.readCompressedInt();
+                v.moveChild (oldIndex, in.readCompressedInt(), nullptr);
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+EditJournal::EditJournal (Edit& e)
+    : state (e.state)
+{
+    state.addListener (this);
+}
+
+EditJournal::~EditJournal()
+{
+    state.removeListener (this);
+}
+
+bool EditJournal::save (const juce::File& newSnapshotFile)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    CRASH_TRACER
+
+    if (snapshotFile != newSnapshotFile)
+    {
+        snapshotFile = newSnapshotFile;
+        hasSnapshot = false;
+    }
+
+    const bool snapshotWritten = lastWrittenGeneration->load() == generation;
+    const auto maxJournalSize = std::max ((int64_t) 1024 * 1024, snapshotFile.getSize() / 2);
+
+    if (! hasSnapshot
+        || (snapshotWritten && ! snapshotFile.existsAsFile())
+        || (int64_t) currentGenerationChanges.getDataSize() > maxJournalSize)
+       return writeSnapshot();
+
+    if (pending.getDataSize() == 0)
+        return true;
+
+    auto chunk = createChunk();
+    currentGenerationChanges.write (chunk.getData(), chunk.getSize());
+
+    // Once the snapshot has been written, the changes made before it can be dropped
+    if (journalHasOlderGenerations && snapshotWritten)
+    {
+        journalHasOlderGenerations = false;
+        return getJournalFileFor (snapshotFile).replaceWithData (currentGenerationChanges.getData(),
+                                                                 currentGenerationChanges.getDataSize());
+    }
+
+    return appendToJournal (chunk);
+}
+
+void EditJournal::reset()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (snapshotFile != juce::File())
+        getJournalFileFor (snapshotFile).deleteFile();
+
+    hasSnapshot = false;
+    journalHasOlderGenerations = false;
+    pending.reset();
+    currentGenerationChanges.reset();
+}
+
+juce::File EditJournal::getJournalFileFor (const juce::File& f)
+{
+    return f != juce::File() ? f.getSiblingFile (f.getFileName() + ".journal")
+                             : juce::File();
+}
+
+juce::ValueTree EditJournal::applyJournal (juce::ValueTree snapshot, const juce::File& journalFile)
+{
+    CRASH_TRACER
+    const auto snapshotJournalID = static_cast<juce::int64> (snapshot[edit_journal::getJournalID()]);
+    const int snapshotGeneration = snapshot[edit_journal::getGenerationID()];
+    snapshot.removeProperty (edit_journal::getJournalID(), nullptr);
+    snapshot.removeProperty (edit_journal::getGenerationID(), nullptr);
+
+    juce::MemoryBlock journal;
+
+    if (snapshotGeneration == 0 || ! journalFile.loadFileAsData (journal))
+        return snapshot;
+
+    juce::MemoryInputStream in (journal, false);
+
+    while (in.getNumBytesRemaining() >= edit_journal::chunkHeaderSize)
+    {
+        const auto chunkJournalID = in.readInt64();
+        const auto chunkGeneration = in.readInt();
+        const auto chunkSize = in.readInt();
+
+        // Stop at a partially written chunk
+        if (chunkSize < 0 || chunkSize > in.getNumBytesRemaining())
+            break;
+
+        if (chunkJournalID == snapshotJournalID && chunkGeneration >= snapshotGeneration)
+        {
+            juce::MemoryInputStream changes (static_cast<const char*> (journal.getData()) + in.getPosition(),
+                                             (size_t) chunkSize, false);
+
+            while (! changes.isExhausted())
+            {
+                if (! edit_journal::applyChange (changes, snapshot))
+                {
+                    jassertfalse; // The journal doesn't match the snapshot
+                    return snapshot;
+                }
+            }
+        }
+
+        in.skipNextBytes (chunkSize);
+    }
+
+    return snapshot;
+}
+
+bool EditJournal::writeSnapshot()
+{
+    // Make sure the changes leading up to the new snapshot are in the journal in case it doesn't get written
+    if (hasSnapshot && pending.getDataSize() > 0)
+        appendToJournal (createChunk());
+    else if (! hasSnapshot)
+        getJournalFileFor (snapshotFile).deleteFile();
+
+    journalHasOlderGenerations = hasSnapshot;
+    hasSnapshot = true;
+    pending.reset();
+    currentGenerationChanges.reset();
+    ++generation;
+
+    auto snapshot = state.createCopy();
+    snapshot.setProperty (edit_journal::getJournalID(), journalID, nullptr);
+    snapshot.setProperty (edit_journal::getGenerationID(), generation, nullptr);
+
+    juce::SharedResourcePointer<ThreadedEditFileWriter>()->writeTreeToFile (std::move (snapshot), snapshotFile,
+                                                                            [written = lastWrittenGeneration, g = generation] (bool ok)
+                                                                            {
+                                                                                if (ok)
+                                                                                    written->store (g);
+                                                                            });
+
+    return true;
+}
+
+bool EditJournal::appendToJournal (const juce::MemoryBlock& chunk)
+{
+    juce::FileOutputStream os (getJournalFileFor (snapshotFile));
+
+    if (! os.openedOk())
+        return false;
+
+    os.write (chunk.getData(), chunk.getSize());
+    os.flush();
+
+    return os.getStatus().wasOk();
+}
+
+juce::MemoryBlock EditJournal::createChunk()
+{
+    juce::MemoryOutputStream chunk;
+    chunk.writeInt64 (journalID);
+    chunk.writeInt (generation);
+    chunk.writeInt ((int) pending.getDataSize());
+    chunk.write (pending.getData(), pending.getDataSize());
+    pending.reset();
+
+    return chunk.getMemoryBlock();
+}
+
+bool EditJournal::writePath (juce::OutputStream& os, const juce::ValueTree& v) const
+{
+    std::vector<int> path;
+
+    for (auto t = v; t != state;)
+    {
+        auto parent = t.getParent();
+
+        if (! parent.isValid())
+            return false;
+
+        path.push_back (parent.indexOf (t));
+        t = parent;
+    }
+
+    os.writeCompressedInt ((int) path.size());
+
+    for (auto i = path.rbegin(); i != path.rend(); ++i)
+        os.writeCompressedInt (*i);
+
+    return true;
+}
+
+void EditJournal::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& property)
+{
+    juce::MemoryOutputStream change;
+    const bool removed = ! v.hasProperty (property);
+    change.writeByte ((char) (removed ? edit_journal::Change::propertyRemoved : edit_journal::Change::propertyChanged));
+
+    if (! writePath (change, v))
+        return;
+
+    change.writeString (property.toString());
+
+    if (! removed)
+        v[property].writeToStream (change);
+
+    pending.write (change.getData(), change.getDataSize());
+}
+
+void EditJournal::valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree& child)
+{
+    juce::MemoryOutputStream change;
+    change.writeByte ((char) edit_journal::Change::childAdded);
+
+    if (! writePath (change, parent))
+        return;
+
+    change.writeCompressedInt (parent.indexOf (child));
+    child.writeToStream (change);
+
+    pending.write (change.getData(), change.getDataSize());
+}
+
+void EditJournal::valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree&, int index)
+{
+    juce::MemoryOutputStream change;
+    change.writeByte ((char) edit_journal::Change::childRemoved);
+
+    if (! writePath (change, parent))
+        return;
+
+    change.writeCompressedInt (index);
+    pending.write (change.getData(), change.getDataSize());
+}
+
+void EditJournal::valueTreeChildOrderChanged (juce::ValueTree& parent, int oldIndex, int newIndex)
+{
+    juce::MemoryOutputStream change;
+    change.writeByte ((char) edit_journal::Change::childMoved);
+
+    if (! writePath (change, parent))
+        return;
+
+    change.writeCompressedInt (oldIndex);
+    change.writeCompressedInt (newIndex);
+    pending.write (change.getData(), change.getDataSize());
 }
 
 //==============================================================================
@@ -443,7 +851,14 @@ juce::ValueTree loadEditFromFile (Engine& e, const juce::File& f, ProjectItemID
     CRASH_TRACER
     juce::ValueTree state;
 
-    if (auto xml = juce::parseXML (f))
+    if (BinaryEditFile::isBinaryEditFile (f))
+    {
+        if (state = BinaryEditFile::Reader (f).createFullState(); state.hasType (IDs::EDIT))
+            state = updateLegacyEdit (EditJournal::applyJournal (state, EditJournal::getJournalFileFor (f)));
+        else
+            state = {};
+    }
+    else if (auto xml = juce::parseXML (f))
     {
         updateLegacyEdit (*xml);
         state = juce::ValueTree::fromXml (*xml);
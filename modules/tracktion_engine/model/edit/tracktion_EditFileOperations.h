@@ -30,6 +30,14 @@ public:
     bool writeToFile (const juce::File&, bool writeQuickBinaryVersion);
 
     bool saveTempVersion (bool forceSaveEvenIfUnchanged);
+
+    /** Saves the temp version without blocking the message thread.
+        The plugin states are captured with Edit::flushStateAsync and the file is then
+        written on a background thread. The function is called on the message thread
+        with whether the file was written.
+    */
+    void saveTempVersionAsync (std::function<void (bool)> onSaved);
+
     void deleteTempVersion();
     juce::File getTempVersionFile() const;
     static juce::File getTempVersionOfEditFile (const juce::File&);
@@ -48,6 +56,70 @@ private:
     EditSnapshot::Ptr& editSnapshot;
 };
 
+//==============================================================================
+/**
+    Records the changes made to an Edit's state so autosaves only need to write
+    what has changed since the previous one.
+
+    The first save writes a full snapshot of the state in the background. After
+    that, each save appends the changes made since the previous save to a journal
+    next to the snapshot. Once the journal gets large compared to the snapshot, a
+    new snapshot is written in the background and the journal starts again.
+
+    loadEditFromFile applies the journal when it loads a snapshot.
+
+    @see Edit::setAutosaveJournalingEnabled
+*/
+class EditJournal  : private juce::ValueTree::Listener
+{
+public:
+    /** Starts recording the changes to an Edit's state. */
+    EditJournal (Edit&);
+
+    /** Destructor. */
+    ~EditJournal() override;
+
+    /** Saves the changes since the previous save to the journal for a snapshot file,
+        writing a new snapshot if there isn't one or the journal has got too large.
+    */
+    bool save (const juce::File& snapshotFile);
+
+    /** Deletes the journal so the next save writes a new snapshot. */
+    void reset();
+
+    /** Returns the number of bytes of changes waiting to be saved. */
+    size_t getNumPendingBytes() const noexcept          { return pending.getDataSize(); }
+
+    /** Returns the journal file used for a snapshot file. */
+    static juce::File getJournalFileFor (const juce::File& snapshotFile);
+
+    /** Applies the changes in a journal to the snapshot it was written for.
+        Changes made before the snapshot was taken are skipped.
+    */
+    static juce::ValueTree applyJournal (juce::ValueTree snapshot, const juce::File& journalFile);
+
+private:
+    juce::ValueTree state;
+    const juce::int64 journalID = juce::Random::getSystemRandom().nextInt64();
+    juce::File snapshotFile;
+    juce::MemoryOutputStream pending, currentGenerationChanges;
+    int generation = 0;
+    bool hasSnapshot = false, journalHasOlderGenerations = false;
+    std::shared_ptr<std::atomic<int>> lastWrittenGeneration = std::make_shared<std::atomic<int>> (0);
+
+    bool writeSnapshot();
+    bool appendToJournal (const juce::MemoryBlock&);
+    juce::MemoryBlock createChunk();
+    bool writePath (juce::OutputStream&, const juce::ValueTree&) const;
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override;
+
+    JUCE_DECLARE_NON_COPYABLE (EditJournal)
+};
+
 //==============================================================================
 /** Loads an edit from a file, ready for playback / editing */
 std::unique_ptr<Edit> loadEditFromFile (Engine&, const juce::File&,
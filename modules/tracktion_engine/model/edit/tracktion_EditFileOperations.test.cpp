@@ -0,0 +1,69 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT_FILE_OPERATIONS
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE("tracktion_engine")
+{
+    TEST_CASE ("EditJournal")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        juce::TemporaryFile tempEditFile;
+        const auto snapshotFile = EditFileOperations::getTempVersionOfEditFile (tempEditFile.getFile());
+        const auto journalFile = EditJournal::getJournalFileFor (snapshotFile);
+
+        auto edit = createEmptyEdit (engine, tempEditFile.getFile());
+        edit->setAutosaveJournalingEnabled (true);
+        auto journal = edit->getAutosaveJournal();
+        REQUIRE (journal != nullptr);
+
+        // The first save writes a snapshot in the background
+        CHECK (journal->save (snapshotFile));
+
+        for (int i = 0; i < 100 && ! snapshotFile.existsAsFile(); ++i)
+            juce::Thread::sleep (50);
+
+        REQUIRE (snapshotFile.existsAsFile());
+
+        // Subsequent saves only write the changes
+        edit->ensureNumberOfAudioTracks (8);
+        getAudioTracks (*edit)[3]->setName ("Journaled");
+        CHECK (journal->getNumPendingBytes() > 0);
+        CHECK (journal->save (snapshotFile));
+        CHECK_EQ (journal->getNumPendingBytes(), 0);
+        CHECK (journalFile.existsAsFile());
+
+        getAudioTracks (*edit)[1]->setName ("Second save");
+        CHECK (journal->save (snapshotFile));
+
+        // Loading the snapshot should apply the journal
+        auto recovered = loadEditFromFile (engine, snapshotFile, ProjectItemID::createNewID (0));
+        auto recoveredEdit = loadEditFromState (engine, recovered);
+        REQUIRE (recoveredEdit != nullptr);
+
+        auto tracks = getAudioTracks (*recoveredEdit);
+        REQUIRE_EQ (tracks.size(), 8);
+        CHECK_EQ (tracks[3]->getName(), juce::String ("Journaled"));
+        CHECK_EQ (tracks[1]->getName(), juce::String ("Second save"));
+
+        journal->reset();
+        CHECK (! journalFile.existsAsFile());
+        snapshotFile.deleteFile();
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT_FILE_OPERATIONS
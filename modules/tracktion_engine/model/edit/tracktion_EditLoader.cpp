@@ -105,7 +105,9 @@ std::shared_ptr<EditLoader::Handle> EditLoader::loadEdit (Engine& engine, juce::
 
                                           // Actually load the Edit
                                           auto opts = std::move (options);
-                                          opts.editState = loadValueTree (file, IDs::EDIT);
+                                          opts.editState = BinaryEditFile::isBinaryEditFile (file)
+                                                                ? BinaryEditFile::Reader (file).createFullState()
+                                                                : loadValueTree (file, IDs::EDIT);
 
                                           if (! opts.editState.isValid())
                                               return completionCallback ({});
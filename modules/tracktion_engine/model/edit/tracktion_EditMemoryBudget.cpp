@@ -0,0 +1,210 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+EditMemoryBudget::EditMemoryBudget (Edit& e)
+    : edit (e)
+{
+}
+
+//==============================================================================
+EditMemoryBudget::Report EditMemoryBudget::createReport()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    CRASH_TRACER
+
+    Report report;
+    auto& cache = edit.engine.getAudioFileManager().cache;
+
+    for (auto track : getAllTracks (edit))
+    {
+        TrackUsage usage;
+        usage.trackID = track->itemID;
+
+        for (auto& file : getAudioFiles (*track))
+            usage.fileCacheBytes += cache.getBytesInUse (file);
+
+        // Nested tracks are reported separately so aren't included in their parent's state
+        usage.stateBytes = getApproximateSizeInBytes (track->state);
+
+        for (auto child : track->state)
+            if (TrackList::isTrack (child))
+                usage.stateBytes -= getApproximateSizeInBytes (child);
+
+        report.tracks.push_back (usage);
+    }
+
+    for (auto plugin : getAllPlugins (edit, true))
+    {
+        const auto numBytes = (int64_t) plugin->getAllocatedBytes();
+        const bool isSampler = dynamic_cast<SamplerPlugin*> (plugin) != nullptr;
+
+        (isSampler ? report.samplerBytes : report.pluginBytes) += numBytes;
+
+        if (auto track = plugin->getOwnerTrack())
+        {
+            for (auto& usage : report.tracks)
+            {
+                if (usage.trackID == track->itemID)
+                {
+                    (isSampler ? usage.samplerBytes : usage.pluginBytes) += numBytes;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (auto& usage : report.tracks)
+        report.fileCacheBytes += usage.fileCacheBytes;
+
+    if (auto epc = edit.getTransport().getCurrentPlaybackContext())
+        report.graphBytes = (int64_t) epc->getAllocatedBytes();
+
+    report.undoBytes = edit.getUndoManager().getNumberOfUnitsTakenUpByStoredCommands();
+    report.stateBytes = getApproximateSizeInBytes (edit.state);
+
+    lastTotalBytes = report.getTotalBytes();
+
+    return report;
+}
+
+//==============================================================================
+void EditMemoryBudget::setLimits (Limits newLimits)
+{
+    const std::scoped_lock sl (limitsMutex);
+    limits = newLimits;
+}
+
+EditMemoryBudget::Limits EditMemoryBudget::getLimits() const
+{
+    const std::scoped_lock sl (limitsMutex);
+    return limits;
+}
+
+EditMemoryBudget::EnforcementResult EditMemoryBudget::enforceLimits()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    CRASH_TRACER
+
+    const auto l = getLimits();
+    EnforcementResult result;
+    result.report = createReport();
+
+    auto isOverLimit = [&l] (int64_t totalBytes)
+    {
+        return l.softLimitBytes > 0 && totalBytes > l.softLimitBytes;
+    };
+
+    if (! isOverLimit (result.report.getTotalBytes()))
+        return result;
+
+    if (l.releaseFileCache)
+    {
+        juce::Array<AudioFile> files;
+
+        for (auto track : getAllTracks (edit))
+            files.addArray (getAudioFiles (*track));
+
+        result.fileCacheBytesReleased = edit.engine.getAudioFileManager().cache.releaseIdleFiles (files);
+
+        if (result.fileCacheBytesReleased > 0)
+            result.report = createReport();
+    }
+
+    auto estimatedTotal = result.report.getTotalBytes();
+
+    if (l.freezeTracks && isOverLimit (estimatedTotal))
+    {
+        // Freeze the tracks with the most plugin and sample data first as that's what freezing saves
+        auto usages = result.report.tracks;
+        std::sort (usages.begin(), usages.end(),
+                   [] (auto& a, auto& b) { return a.pluginBytes + a.samplerBytes > b.pluginBytes + b.samplerBytes; });
+
+        for (auto& usage : usages)
+        {
+            if (! isOverLimit (estimatedTotal))
+                break;
+
+            const auto bytesSaved = usage.pluginBytes + usage.samplerBytes;
+
+            if (bytesSaved <= 0)
+                break;
+
+            if (auto at = dynamic_cast<AudioTrack*> (findTrackForID (edit, usage.trackID)))
+            {
+                if (at->isFrozen (Track::anyFreeze))
+                    continue;
+
+                at->setFrozen (true, Track::individualFreeze);
+                result.frozenTracks.add (usage.trackID);
+                estimatedTotal -= bytesSaved;
+            }
+        }
+    }
+
+    result.isOverLimit = isOverLimit (estimatedTotal);
+
+    return result;
+}
+
+bool EditMemoryBudget::canAllocate (int64_t numBytes) const
+{
+    const auto l = getLimits();
+
+    if (l.softLimitBytes <= 0 || ! l.denyNewAllocations)
+        return true;
+
+    return lastTotalBytes.load() + numBytes <= l.softLimitBytes;
+}
+
+//==============================================================================
+int64_t EditMemoryBudget::getApproximateSizeInBytes (const juce::ValueTree& v)
+{
+    // There's no way to measure the shared object behind a ValueTree so this adds
+    // up the size of its properties along with the obvious overheads
+    auto numBytes = (int64_t) (sizeof (juce::ValueTree) + sizeof (juce::ReferenceCountedObject) + sizeof (juce::NamedValueSet));
+
+    for (int i = 0; i < v.getNumProperties(); ++i)
+    {
+        auto& value = v.getProperty (v.getPropertyName (i));
+        numBytes += (int64_t) sizeof (juce::NamedValueSet::NamedValue);
+
+        if (auto mb = value.getBinaryData())
+            numBytes += (int64_t) mb->getSize();
+        else if (value.isString())
+            numBytes += (int64_t) value.toString().getNumBytesAsUTF8();
+    }
+
+    for (auto child : v)
+        numBytes += getApproximateSizeInBytes (child);
+
+    return numBytes;
+}
+
+juce::Array<AudioFile> EditMemoryBudget::getAudioFiles (Track& track)
+{
+    juce::Array<AudioFile> files;
+
+    if (auto ct = dynamic_cast<ClipTrack*> (&track))
+        for (auto clip : ct->getClips())
+            if (auto acb = dynamic_cast<AudioClipBase*> (clip))
+                files.addIfNotAlreadyThere (acb->getPlaybackFile());
+
+    if (auto at = dynamic_cast<AudioTrack*> (&track))
+        if (at->isFrozen (Track::individualFreeze))
+            files.addIfNotAlreadyThere (AudioFile (edit.engine, at->getFreezeFile()));
+
+    return files;
+}
+
+} // namespace tracktion::inline engine
@@ -0,0 +1,125 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Reports how much memory an Edit is using and keeps it within a soft limit.
+
+    A report breaks the usage down by subsystem and by track. The figures are
+    estimates: plugins only report what they choose to via Plugin::getAllocatedBytes,
+    data shared between Edits, such as IRs and mapped files, is counted in full by
+    each one, and the undo history is measured in the UndoManager's units.
+
+    When a limit is set, enforceLimits can release the Edit's idle files from the
+    AudioFileCache, freeze tracks and start denying new allocations, such as
+    samples being added to a SamplerPlugin, until the usage falls again.
+
+    Every Edit has one of these. @see Edit::getMemoryBudget
+*/
+class EditMemoryBudget
+{
+public:
+    /** Creates a budget for an Edit. */
+    EditMemoryBudget (Edit&);
+
+    //==============================================================================
+    /** The memory used by a track and the clips and plugins on it. */
+    struct TrackUsage
+    {
+        EditItemID trackID;
+        int64_t fileCacheBytes = 0;     ///< Audio file data mapped for the track's clips
+        int64_t pluginBytes = 0;        ///< Data allocated by the track's plugins, other than samplers
+        int64_t samplerBytes = 0;       ///< Samples loaded by the track's SamplerPlugins
+        int64_t stateBytes = 0;         ///< An estimate of the size of the track's ValueTree
+
+        /** Returns the total for the track. */
+        int64_t getTotalBytes() const   { return fileCacheBytes + pluginBytes + samplerBytes + stateBytes; }
+    };
+
+    /** The memory used by the Edit. */
+    struct Report
+    {
+        int64_t graphBytes = 0;         ///< Buffers allocated by the playback graph's Nodes
+        int64_t fileCacheBytes = 0;     ///< Audio file data mapped for the Edit's clips
+        int64_t pluginBytes = 0;        ///< Data allocated by plugins, other than samplers
+        int64_t samplerBytes = 0;       ///< Samples loaded by SamplerPlugins
+        int64_t undoBytes = 0;          ///< The size of the undo history in the UndoManager's units
+        int64_t stateBytes = 0;         ///< An estimate of the size of the Edit's ValueTree
+
+        std::vector<TrackUsage> tracks; ///< The usage of each track, which is included in the totals above
+
+        /** Returns the total for the Edit. */
+        int64_t getTotalBytes() const   { return graphBytes + fileCacheBytes + pluginBytes + samplerBytes + undoBytes + stateBytes; }
+    };
+
+    /** Measures the Edit's current memory usage.
+        This must be called on the message thread.
+    */
+    Report createReport();
+
+    //==============================================================================
+    /** The limit to keep the Edit within and what to do when it's exceeded. */
+    struct Limits
+    {
+        int64_t softLimitBytes = 0;     ///< The total to stay within, 0 means no limit
+        bool releaseFileCache = true;   ///< Releases the mapped data of files that aren't being played
+        bool freezeTracks = false;      ///< Freezes the tracks using the most memory
+        bool denyNewAllocations = true; ///< Makes canAllocate return false whilst over the limit
+    };
+
+    /** Sets the limits to keep to. */
+    void setLimits (Limits);
+
+    /** Returns the limits set by setLimits. */
+    Limits getLimits() const;
+
+    /** What enforceLimits did. */
+    struct EnforcementResult
+    {
+        Report report;                          ///< The usage after any files were released
+        int64_t fileCacheBytesReleased = 0;     ///< The number of bytes released from the AudioFileCache
+        juce::Array<EditItemID> frozenTracks;   ///< The tracks that were frozen
+        bool isOverLimit = false;               ///< True if the Edit is still over its limit
+    };
+
+    /** Measures the usage and, if it's over the limit, releases files and freezes
+        tracks as the Limits allow. Frozen tracks only free their memory once
+        they've been rendered and the graph is rebuilt so won't show in the report
+        until later. This must be called on the message thread.
+    */
+    EnforcementResult enforceLimits();
+
+    /** Returns false if allocating this many bytes would take the Edit over its
+        limit and new allocations should be denied.
+        This uses the usage measured by the last report so is quick to call.
+    */
+    bool canAllocate (int64_t numBytes) const;
+
+    //==============================================================================
+    /** Returns an estimate of the number of bytes a ValueTree and its children use. */
+    static int64_t getApproximateSizeInBytes (const juce::ValueTree&);
+
+private:
+    Edit& edit;
+
+    mutable std::mutex limitsMutex;
+    Limits limits;
+    std::atomic<int64_t> lastTotalBytes { 0 };
+
+    juce::Array<AudioFile> getAudioFiles (Track&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditMemoryBudget)
+};
+
+} // namespace tracktion::inline engine
@@ -53,6 +53,641 @@ struct EditSnapshot::ListHolder
     juce::SharedResourcePointer<EditSnapshotList> list;
 };
 
+//==============================================================================
+namespace edit_snapshot
+{
+    //==============================================================================
+    /** A minimal pull parser for XML that finds elements and their attributes
+        without building a DOM or decoding attributes that aren't asked for.
+        It doesn't validate that end tags match their start tags.
+    */
+    class XmlScanner
+    {
+    public:
+        XmlScanner (const char* data, size_t size)
+            : pos (data), end (data + size)
+        {
+        }
+
+        enum class Token
+        {
+            startElement,
+            endElement,
+            endOfDocument,
+            error
+        };
+
+        /** Moves to the next start or end tag. A self-closing tag returns a startElement then an endElement. */
+        Token next()
+        {
+            if (pendingEndElement)
+            {
+                pendingEndElement = false;
+                return Token::endElement;
+            }
+
+            for (;;)
+            {
+                pos = std::find (pos, end, '<');
+
+                if (pos == end)
+                    return Token::endOfDocument;
+
+                if (startsWith ("<?"))
+                {
+                    if (! skipPast ("?>"))
+                        return Token::error;
+                }
+                else if (startsWith ("<!--"))
+                {
+                    if (! skipPast ("-->"))
+                        return Token::error;
+                }
+                else if (startsWith ("<![CDATA["))
+                {
+                    if (! skipPast ("]]>"))
+                        return Token::error;
+                }
+                else if (startsWith ("<!"))
+                {
+                    if (! skipPast (">"))
+                        return Token::error;
+                }
+                else if (startsWith ("</"))
+                {
+                    return skipPast (">") ? Token::endElement : Token::error;
+                }
+                else
+                {
+                    return readStartTag() ? Token::startElement : Token::error;
+                }
+            }
+        }
+
+        /** Skips the children of the element just started, up to and including its end tag. */
+        bool skipChildren()
+        {
+            for (int depth = 1; depth > 0;)
+            {
+                switch (next())
+                {
+                    case Token::startElement:   ++depth; break;
+                    case Token::endElement:     --depth; break;
+                    case Token::endOfDocument:
+                    case Token::error:
+                    default:                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /** Returns the name of the element just started. */
+        std::string_view getTagName() const noexcept
+        {
+            return tagName;
+        }
+
+        /** Returns an attribute of the element just started, or nullopt if it doesn't have one. */
+        std::optional<juce::String> getAttribute (std::string_view name) const
+        {
+            for (auto p = attributesStart; p < attributesEnd;)
+            {
+                p = skipWhitespace (p, attributesEnd);
+                auto nameStart = p;
+
+                while (p < attributesEnd && *p != '=' && ! isWhitespace (*p))
+                    ++p;
+
+                const std::string_view attributeName (nameStart, (size_t) (p - nameStart));
+                p = skipWhitespace (p, attributesEnd);
+
+                if (p >= attributesEnd || *p != '=')
+                    return std::nullopt;
+
+                p = skipWhitespace (p + 1, attributesEnd);
+
+                if (p >= attributesEnd || (*p != '"' && *p != '\''))
+                    return std::nullopt;
+
+                const auto quote = *p++;
+                auto valueEnd = std::find (p, attributesEnd, quote);
+
+                if (valueEnd == attributesEnd)
+                    return std::nullopt;
+
+                if (attributeName == name)
+                    return decode (p, valueEnd);
+
+                p = valueEnd + 1;
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        const char* pos;
+        const char* const end;
+        std::string_view tagName;
+        const char* attributesStart = nullptr;
+        const char* attributesEnd = nullptr;
+        bool pendingEndElement = false;
+
+        static bool isWhitespace (char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        static const char* skipWhitespace (const char* p, const char* limit) noexcept
+        {
+            while (p < limit && isWhitespace (*p))
+                ++p;
+
+            return p;
+        }
+
+        bool startsWith (std::string_view s) const noexcept
+        {
+            return (size_t) (end - pos) >= s.size() && std::string_view (pos, s.size()) == s;
+        }
+
+        bool skipPast (std::string_view s)
+        {
+            auto found = std::search (pos, end, s.begin(), s.end());
+
+            if (found == end)
+                return false;
+
+            pos = found + s.size();
+            return true;
+        }
+
+        bool readStartTag()
+        {
+            auto nameStart = ++pos;
+
+            while (pos < end && ! isWhitespace (*pos) && *pos != '>' && *pos != '/')
+                ++pos;
+
+            tagName = std::string_view (nameStart, (size_t) (pos - nameStart));
+            attributesStart = pos;
+
+            // Attribute values can contain '>' so quotes need to be skipped
+            for (char quote = 0; pos < end; ++pos)
+            {
+                if (quote != 0)
+                {
+                    if (*pos == quote)
+                        quote = 0;
+                }
+                else if (*pos == '"' || *pos == '\'')
+                {
+                    quote = *pos;
+                }
+                else if (*pos == '>')
+                {
+                    break;
+                }
+            }
+
+            if (pos == end || tagName.empty())
+                return false;
+
+            attributesEnd = pos++;
+            pendingEndElement = attributesEnd[-1] == '/';
+
+            if (pendingEndElement)
+                --attributesEnd;
+
+            return true;
+        }
+
+        static juce::String decode (const char* start, const char* valueEnd)
+        {
+            auto ampersand = std::find (start, valueEnd, '&');
+
+            if (ampersand == valueEnd)
+                return juce::String::fromUTF8 (start, (int) (valueEnd - start));
+
+            juce::String result;
+
+            while (start < valueEnd)
+            {
+                result += juce::String::fromUTF8 (start, (int) (ampersand - start));
+
+                if (ampersand == valueEnd)
+                    break;
+
+                auto semicolon = std::find (ampersand, valueEnd, ';');
+
+                if (semicolon == valueEnd)
+                {
+                    result += juce::String::fromUTF8 (ampersand, (int) (valueEnd - ampersand));
+                    break;
+                }
+
+                const std::string_view entity (ampersand + 1, (size_t) (semicolon - ampersand - 1));
+
+                if (entity == "amp")        result += "&";
+                else if (entity == "lt")    result += "<";
+                else if (entity == "gt")    result += ">";
+                else if (entity == "quot")  result += "\"";
+                else if (entity == "apos")  result += "'";
+                else if (entity.size() > 2 && entity[0] == '#' && (entity[1] == 'x' || entity[1] == 'X'))
+                    result += juce::String::charToString ((juce::juce_wchar) juce::String (entity.data() + 2, entity.size() - 2).getHexValue32());
+                else if (entity.size() > 1 && entity[0] == '#')
+                    result += juce::String::charToString ((juce::juce_wchar) juce::String (entity.data() + 1, entity.size() - 1).getIntValue());
+                else
+                    result += juce::String::fromUTF8 (ampersand, (int) (semicolon + 1 - ampersand));
+
+                start = semicolon + 1;
+                ampersand = std::find (start, valueEnd, '&');
+            }
+
+            return result;
+        }
+    };
+
+    //==============================================================================
+    /** Builds a Summary from the elements of an Edit in document order.
+        The attribute getter passed to startElement is called with an Identifier
+        and should return the attribute's value or nullopt.
+    */
+    class SummaryBuilder
+    {
+    public:
+        /** Adds an element, returning true if its children need to be added too. */
+        template<typename GetAttribute>
+        bool startElement (std::string_view tag, GetAttribute&& getAttribute)
+        {
+            auto getString = [&getAttribute] (const juce::Identifier& id) -> juce::String
+            {
+                return getAttribute (id).value_or (juce::String());
+            };
+
+            const auto parent = stack.empty() ? Context::none : stack.back();
+            auto context = Context::ignored;
+
+            switch (parent)
+            {
+                case Context::none:
+                {
+                    summary.isValid = hasType (tag, IDs::EDIT);
+
+                    if (summary.isValid)
+                    {
+                        // last significant change
+                        auto changeHexString = getString (IDs::lastSignificantChange);
+
+                        if (changeHexString.isNotEmpty())
+                            summary.lastSignificantChange = juce::Time (changeHexString.getHexValue64());
+
+                        context = Context::edit;
+                    }
+
+                    break;
+                }
+
+                case Context::edit:
+                {
+                    if (hasType (tag, IDs::TRANSPORT) && ! hasSeenTransport)
+                    {
+                        // marks
+                        hasSeenTransport = true;
+                        auto loopRange = juce::Range<double>::between (getString (IDs::loopPoint1).getDoubleValue(),
+                                                                       getString (IDs::loopPoint2).getDoubleValue());
+                        summary.markIn = loopRange.getStart();
+                        summary.markOut = loopRange.getEnd();
+                        summary.marksActive = summary.markIn != summary.markOut;
+                    }
+                    else if (hasType (tag, IDs::TEMPOSEQUENCE) && ! hasSeenTempoSequence)
+                    {
+                        hasSeenTempoSequence = true;
+                        context = Context::tempoSequence;
+                    }
+                    else if (hasType (tag, IDs::PITCHSEQUENCE) && ! hasSeenPitchSequence)
+                    {
+                        hasSeenPitchSequence = true;
+                        context = Context::pitchSequence;
+                    }
+                    else
+                    {
+                        context = addTrackIfTrack (tag, getAttribute);
+                    }
+
+                    break;
+                }
+
+                case Context::tempoSequence:
+                {
+                    if (hasType (tag, IDs::TEMPO) && ! hasSeenTempo)
+                    {
+                        hasSeenTempo = true;
+                        summary.tempo = getString (IDs::bpm).getDoubleValue();
+                    }
+                    else if (hasType (tag, IDs::TIMESIG) && ! hasSeenTimeSig)
+                    {
+                        hasSeenTimeSig = true;
+                        summary.timeSigNumerator    = getString (IDs::numerator).getIntValue();
+                        summary.timeSigDenominator  = getString (IDs::denominator).getIntValue();
+                    }
+
+                    break;
+                }
+
+                case Context::pitchSequence:
+                {
+                    if (hasType (tag, IDs::PITCH) && ! hasSeenPitch)
+                    {
+                        hasSeenPitch = true;
+                        summary.pitch = getString (IDs::pitch).getIntValue();
+                    }
+
+                    break;
+                }
+
+                case Context::audioTrack:
+                {
+                    if (hasType (tag, IDs::EDITCLIP))
+                        summary.editClipIDs.add (ProjectItemID (getString (IDs::source)));
+
+                    auto sourceID = getString (IDs::source);
+
+                    if (sourceID.isNotEmpty())
+                        summary.clipSourceIDs.add (ProjectItemID (sourceID));
+
+                    context = addTrackIfTrack (tag, getAttribute);
+                    break;
+                }
+
+                case Context::markerTrack:
+                {
+                    EditSnapshot::Marker m;
+                    m.name      = getAttribute (IDs::name).value_or (TRANS("unnamed"));
+                    m.colour    = juce::Colour::fromString (getAttribute (IDs::colour).value_or (TRANS("unnamed")));
+                    auto start  = TimePosition::fromSeconds (getString (IDs::start).getDoubleValue());
+                    auto len    = TimeDuration::fromSeconds (getString (IDs::length).getDoubleValue());
+                    m.time      = { start, start + len };
+
+                    if (len > 0s)
+                        summary.markers.add (m);
+
+                    context = addTrackIfTrack (tag, getAttribute);
+                    break;
+                }
+
+                case Context::otherTrack:
+                {
+                    context = addTrackIfTrack (tag, getAttribute);
+                    break;
+                }
+
+                case Context::ignored:
+                default:
+                    break;
+            }
+
+            stack.push_back (context);
+            return context != Context::ignored;
+        }
+
+        /** Ends the last element started. */
+        bool endElement()
+        {
+            if (stack.empty())
+                return false;
+
+            stack.pop_back();
+            return true;
+        }
+
+        /** Returns true if every element started has been ended. */
+        bool isComplete() const noexcept
+        {
+            return stack.empty();
+        }
+
+        /** Returns the summary built so far. */
+        EditSnapshot::Summary getSummary()
+        {
+            summary.numAudioTracks = summary.audioTracks.countNumberOfSetBits();
+            return summary;
+        }
+
+    private:
+        enum class Context
+        {
+            none,
+            edit,
+            tempoSequence,
+            pitchSequence,
+            audioTrack,
+            markerTrack,
+            otherTrack,
+            ignored
+        };
+
+        EditSnapshot::Summary summary;
+        std::vector<Context> stack;
+        int audioTrackNameNumber = 1;
+        bool hasSeenTransport = false, hasSeenTempoSequence = false, hasSeenPitchSequence = false;
+        bool hasSeenTempo = false, hasSeenTimeSig = false, hasSeenPitch = false;
+
+        static bool hasType (std::string_view tag, const juce::Identifier& type)
+        {
+            return tag == type.toString().toRawUTF8();
+        }
+
+        static bool isTrack (std::string_view tag)
+        {
+            return hasType (tag, IDs::TRACK) || hasType (tag, IDs::FOLDERTRACK) || hasType (tag, IDs::AUTOMATIONTRACK)
+                || hasType (tag, IDs::MARKERTRACK) || hasType (tag, IDs::TEMPOTRACK) || hasType (tag, IDs::CHORDTRACK)
+                || hasType (tag, IDs::ARRANGERTRACK) || hasType (tag, IDs::MASTERTRACK);
+        }
+
+        static bool toBool (const std::optional<juce::String>& value)
+        {
+            // This matches juce::XmlElement::getBoolAttribute
+            if (! value)
+                return false;
+
+            auto firstChar = *(value->getCharPointer().findEndOfWhitespace());
+            return firstChar == '1' || firstChar == 't' || firstChar == 'y' || firstChar == 'T' || firstChar == 'Y';
+        }
+
+        template<typename GetAttribute>
+        Context addTrackIfTrack (std::string_view tag, GetAttribute& getAttribute)
+        {
+            if (! isTrack (tag))
+                return Context::ignored;
+
+            const auto index = summary.numTracks;
+            auto trackName = getAttribute (IDs::name).value_or (juce::String());
+            summary.trackIDs.add (EditItemID::fromString (getAttribute (IDs::id).value_or (juce::String())));
+
+            summary.mutedTracks.setBit (index, toBool (getAttribute (IDs::mute)));
+            summary.soloedTracks.setBit (index, toBool (getAttribute (IDs::solo)));
+            summary.soloIsolatedTracks.setBit (index, toBool (getAttribute (IDs::soloIsolate)));
+
+            auto context = Context::otherTrack;
+
+            if (hasType (tag, IDs::TRACK) || hasType (tag, IDs::MARKERTRACK))
+            {
+                if (trackName.isEmpty())
+                    trackName = TRANS("Track") + " "  + juce::String (audioTrackNameNumber);
+
+                if (hasType (tag, IDs::TRACK))
+                {
+                    summary.audioTracks.setBit (index);
+                    ++audioTrackNameNumber;
+                    context = Context::audioTrack;
+                }
+                else
+                {
+                    context = Context::markerTrack;
+                }
+            }
+
+            summary.trackNames.add (trackName);
+            ++summary.numTracks;
+
+            return context;
+        }
+    };
+
+    static void addElements (SummaryBuilder& builder, const juce::ValueTree& v)
+    {
+        auto getAttribute = [&v] (const juce::Identifier& id) -> std::optional<juce::String>
+        {
+            if (auto value = v.getPropertyPointer (id))
+                return value->toString();
+
+            return std::nullopt;
+        };
+
+        if (builder.startElement (v.getType().toString().toRawUTF8(), getAttribute))
+            for (const auto& child : v)
+                addElements (builder, child);
+
+        builder.endElement();
+    }
+
+    //==============================================================================
+    // Cache file: magic, version, Edit file size, modification time and hash, then the summary
+    static constexpr char cacheMagic[] = { 'T', 'E', 'S', 'S' };
+    static constexpr int cacheVersion = 1;
+    static constexpr int summaryEndMarker = 0x53554d4d;
+
+    struct CacheKey
+    {
+        int64_t fileSize = 0, modificationTime = 0;
+        uint64_t hash = 0;
+    };
+
+    static juce::File getCacheFile (Engine& engine, const juce::File& editFile)
+    {
+        ContentHasher hasher;
+        hasher.add (std::string_view (editFile.getFullPathName().toRawUTF8()));
+
+        return engine.getTemporaryFileManager().getTempFile ("edit_summaries")
+                 .getChildFile (juce::String::toHexString ((juce::int64) hasher.getHash()) + ".summary");
+    }
+
+    static std::optional<std::pair<CacheKey, EditSnapshot::Summary>> readCache (const juce::File& cacheFile)
+    {
+        juce::FileInputStream in (cacheFile);
+
+        if (! in.openedOk())
+            return std::nullopt;
+
+        char magic[sizeof (cacheMagic)] = {};
+
+        if (in.read (magic, (int) sizeof (magic)) != (int) sizeof (magic)
+            || ! std::equal (std::begin (magic), std::end (magic), std::begin (cacheMagic))
+            || in.readInt() != cacheVersion)
+            return std::nullopt;
+
+        CacheKey key;
+        key.fileSize = in.readInt64();
+        key.modificationTime = in.readInt64();
+        key.hash = (uint64_t) in.readInt64();
+
+        if (auto summary = EditSnapshot::Summary::readFromStream (in))
+            return std::make_pair (key, std::move (*summary));
+
+        return std::nullopt;
+    }
+
+    static void writeCache (const juce::File& cacheFile, const CacheKey& key, const EditSnapshot::Summary& summary)
+    {
+        if (! cacheFile.getParentDirectory().createDirectory())
+            return;
+
+        juce::TemporaryFile temp (cacheFile);
+
+        {
+            juce::FileOutputStream out (temp.getFile());
+
+            if (! out.openedOk())
+                return;
+
+            out.write (cacheMagic, sizeof (cacheMagic));
+            out.writeInt (cacheVersion);
+            out.writeInt64 (key.fileSize);
+            out.writeInt64 (key.modificationTime);
+            out.writeInt64 ((juce::int64) key.hash);
+            summary.writeToStream (out);
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    /** Returns the summary of an Edit file, using the cache if the file hasn't changed. */
+    static EditSnapshot::Summary loadSummary (Engine& engine, const juce::File& file)
+    {
+        CRASH_TRACER
+
+        if (BinaryEditFile::isBinaryEditFile (file))
+        {
+            // The bulky sections of these are only read on demand so the root is quick to read
+            BinaryEditFile::Reader reader (file);
+            return EditSnapshot::Summary::fromState (reader.getRootState());
+        }
+
+        CacheKey key;
+        key.fileSize = file.getSize();
+        key.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        const auto cacheFile = getCacheFile (engine, file);
+        auto cached = readCache (cacheFile);
+
+        if (cached && cached->first.fileSize == key.fileSize && cached->first.modificationTime == key.modificationTime)
+            return cached->second;
+
+        // The file may have been touched or copied without changing so check the contents
+        if (auto hash = hashFileContents (file))
+        {
+            key.hash = *hash;
+
+            if (cached && cached->first.fileSize == key.fileSize && cached->first.hash == key.hash)
+            {
+                writeCache (cacheFile, key, cached->second);
+                return cached->second;
+            }
+        }
+
+        auto summary = EditSnapshot::Summary::fromXmlFile (file);
+
+        if (! summary)
+            return {};
+
+        if (summary->isValid && key.hash != 0)
+            writeCache (cacheFile, key, *summary);
+
+        return *summary;
+    }
+}
+
 //==============================================================================
 EditSnapshot::Ptr EditSnapshot::getEditSnapshot (Engine& engine, ProjectItemID itemID)
 {
@@ -96,7 +731,8 @@ void EditSnapshot::setState (juce::ValueTree newState, TimeDuration editLength)
 
 bool EditSnapshot::isValid() const
 {
-    return state.hasType (IDs::EDIT);
+    // If the state hasn't been loaded yet, the summary says whether it's an Edit
+    return state.isValid() ? state.hasType (IDs::EDIT) : summary.isValid;
 }
 
 void EditSnapshot::refreshCacheAndNotifyListeners()
@@ -105,100 +741,212 @@ void EditSnapshot::refreshCacheAndNotifyListeners()
     listeners.call (&Listener::editChanged, *this);
 }
 
-void EditSnapshot::addSubTracksRecursively (const juce::XmlElement& parent, int& audioTrackNameNumber)
+juce::ValueTree EditSnapshot::getState()
 {
-    for (auto track : parent.getChildIterator())
+    if (! state.isValid() && summary.isValid && sourceFile.existsAsFile())
     {
-        juce::Identifier trackType (track->getTagName());
+        CRASH_TRACER
+        state = BinaryEditFile::isBinaryEditFile (sourceFile) ? BinaryEditFile::Reader (sourceFile).createFullState()
+                                                              : loadValueTree (sourceFile, true);
+    }
 
-        if (! TrackList::isTrack (trackType))
-            continue;
+    return state;
+}
 
-        auto trackName = track->getStringAttribute (IDs::name);
-        trackIDs.add (EditItemID::fromXML (*track, IDs::id));
+//==============================================================================
+EditSnapshot::Summary EditSnapshot::Summary::fromState (const juce::ValueTree& v)
+{
+    edit_snapshot::SummaryBuilder builder;
+    edit_snapshot::addElements (builder, v);
+    return builder.getSummary();
+}
 
-        mutedTracks.setBit (numTracks, track->getBoolAttribute (IDs::mute, false));
-        soloedTracks.setBit (numTracks, track->getBoolAttribute (IDs::solo, false));
-        soloIsolatedTracks.setBit (numTracks, track->getBoolAttribute (IDs::soloIsolate, false));
+std::optional<EditSnapshot::Summary> EditSnapshot::Summary::fromXmlFile (const juce::File& file)
+{
+    CRASH_TRACER
+    juce::MemoryMappedFile mappedFile (file, juce::MemoryMappedFile::readOnly);
+    juce::MemoryBlock fileData;
 
-        if (trackType == IDs::TRACK || trackType == IDs::MARKERTRACK)
-        {
-            if (trackName.isEmpty())
-                trackName = TRANS("Track") + " "  + juce::String (audioTrackNameNumber);
+    auto data = static_cast<const char*> (mappedFile.getData());
+    auto size = mappedFile.getSize();
+
+    // Mapping can fail, for example on some network drives, so read it instead
+    if (data == nullptr)
+    {
+        if (! file.loadFileAsData (fileData))
+            return std::nullopt;
+
+        data = static_cast<const char*> (fileData.getData());
+        size = fileData.getSize();
+    }
+
+    edit_snapshot::XmlScanner scanner (data, size);
+    edit_snapshot::SummaryBuilder builder;
 
-            if (trackType == IDs::TRACK)
+    for (;;)
+    {
+        switch (scanner.next())
+        {
+            case edit_snapshot::XmlScanner::Token::startElement:
             {
-                audioTracks.setBit (numTracks);
-                addEditClips (*track);
-                addClipSources (*track);
-                ++audioTrackNameNumber;
+                const bool isRoot = builder.isComplete();
+
+                auto getAttribute = [&scanner] (const juce::Identifier& id)
+                {
+                    return scanner.getAttribute (id.toString().toRawUTF8());
+                };
+
+                if (! builder.startElement (scanner.getTagName(), getAttribute))
+                {
+                    // If the root isn't an Edit, there's no need to read any further
+                    if (isRoot)
+                        return builder.getSummary();
+
+                    if (! scanner.skipChildren())
+                        return std::nullopt;
+
+                    builder.endElement();
+                }
+
+                break;
             }
-            else if (trackType == IDs::MARKERTRACK)
+
+            case edit_snapshot::XmlScanner::Token::endElement:
             {
-                addMarkers (*track);
+                if (! builder.endElement())
+                    return std::nullopt;
+
+                // Anything after the root element is ignored
+                if (builder.isComplete())
+                    return builder.getSummary();
+
+                break;
             }
+
+            case edit_snapshot::XmlScanner::Token::endOfDocument:
+            case edit_snapshot::XmlScanner::Token::error:
+            default:
+                return std::nullopt;
         }
+    }
+}
+
+void EditSnapshot::Summary::writeToStream (juce::OutputStream& out) const
+{
+    out.writeBool (isValid);
+    out.writeInt64 (lastSignificantChange.toMilliseconds());
 
-        trackNames.add (trackName);
-        ++numTracks;
+    out.writeInt (numTracks);
+    out.writeInt (numAudioTracks);
 
-        addSubTracksRecursively (*track, audioTrackNameNumber);
+    for (int i = 0; i < numTracks; ++i)
+    {
+        out.writeString (trackNames[i]);
+        out.writeInt64 ((juce::int64) trackIDs[i].getRawID());
+        out.writeBool (audioTracks[i]);
+        out.writeBool (mutedTracks[i]);
+        out.writeBool (soloedTracks[i]);
+        out.writeBool (soloIsolatedTracks[i]);
+    }
+
+    for (auto ids : { &editClipIDs, &clipSourceIDs })
+    {
+        out.writeInt (ids->size());
+
+        for (auto& id : *ids)
+            out.writeString (id.toString());
     }
+
+    out.writeDouble (markIn);
+    out.writeDouble (markOut);
+    out.writeDouble (tempo);
+    out.writeBool (marksActive);
+    out.writeInt (timeSigNumerator);
+    out.writeInt (timeSigDenominator);
+    out.writeInt (pitch);
+
+    out.writeInt (markers.size());
+
+    for (auto& m : markers)
+    {
+        out.writeString (m.name);
+        out.writeInt ((int) m.colour.getARGB());
+        out.writeDouble (m.time.getStart().inSeconds());
+        out.writeDouble (m.time.getEnd().inSeconds());
+    }
+
+    out.writeInt (edit_snapshot::summaryEndMarker);
 }
 
-void EditSnapshot::refreshFromXml (const juce::XmlElement& xml,
-                                   const juce::String& newName, double newLength)
+std::optional<EditSnapshot::Summary> EditSnapshot::Summary::readFromStream (juce::InputStream& in)
 {
-    clear();
-    name = newName;
-    length = newLength;
+    Summary s;
+    s.isValid = in.readBool();
+    s.lastSignificantChange = juce::Time (in.readInt64());
 
-    // last significant change
-    auto changeHexString = xml.getStringAttribute (IDs::lastSignificantChange);
-    lastSaveTime = changeHexString.isEmpty() ? sourceFile.getLastModificationTime()
-                                             : juce::Time (changeHexString.getHexValue64());
+    s.numTracks = in.readInt();
+    s.numAudioTracks = in.readInt();
 
-    // marks
-    if (auto viewState = xml.getChildByName (IDs::TRANSPORT))
-    {
-        auto loopRange = juce::Range<double>::between (viewState->getDoubleAttribute (IDs::loopPoint1),
-                                                       viewState->getDoubleAttribute (IDs::loopPoint2));
-        markIn = loopRange.getStart();
-        markOut = loopRange.getEnd();
+    if (s.numTracks < 0 || s.numTracks > 1000000)
+        return std::nullopt;
 
-        marksActive = markIn != markOut;
+    for (int i = 0; i < s.numTracks; ++i)
+    {
+        s.trackNames.add (in.readString());
+        s.trackIDs.add (EditItemID::fromRawID ((uint64_t) in.readInt64()));
+        s.audioTracks.setBit (i, in.readBool());
+        s.mutedTracks.setBit (i, in.readBool());
+        s.soloedTracks.setBit (i, in.readBool());
+        s.soloIsolatedTracks.setBit (i, in.readBool());
     }
 
-    // tempo, time sig & pitch
-    if (auto tempoSeq = xml.getChildByName (IDs::TEMPOSEQUENCE))
+    for (auto ids : { &s.editClipIDs, &s.clipSourceIDs })
     {
-        if (auto tempoItem = tempoSeq->getChildByName (IDs::TEMPO))
-            tempo = tempoItem->getDoubleAttribute (IDs::bpm);
+        const auto numIDs = in.readInt();
 
-        if (auto timeSigItem = tempoSeq->getChildByName (IDs::TIMESIG))
-        {
-            timeSigNumerator    = timeSigItem->getIntAttribute (IDs::numerator);
-            timeSigDenominator  = timeSigItem->getIntAttribute (IDs::denominator);
-        }
+        if (numIDs < 0 || numIDs > 1000000)
+            return std::nullopt;
+
+        for (int i = 0; i < numIDs; ++i)
+            ids->add (ProjectItemID (in.readString()));
     }
 
-    if (auto pitchSeq = xml.getChildByName (IDs::PITCHSEQUENCE))
-        if (auto pitchItem = pitchSeq->getChildByName (IDs::PITCH))
-            pitch = pitchItem->getIntAttribute (IDs::pitch);
+    s.markIn = in.readDouble();
+    s.markOut = in.readDouble();
+    s.tempo = in.readDouble();
+    s.marksActive = in.readBool();
+    s.timeSigNumerator = in.readInt();
+    s.timeSigDenominator = in.readInt();
+    s.pitch = in.readInt();
+
+    const auto numMarkers = in.readInt();
 
-    // tracks
-    trackNames.ensureStorageAllocated (xml.getNumChildElements());
+    if (numMarkers < 0 || numMarkers > 1000000)
+        return std::nullopt;
+
+    for (int i = 0; i < numMarkers; ++i)
+    {
+        Marker m;
+        m.name = in.readString();
+        m.colour = juce::Colour ((juce::uint32) in.readInt());
+        auto start = TimePosition::fromSeconds (in.readDouble());
+        m.time = { start, TimePosition::fromSeconds (in.readDouble()) };
+        s.markers.add (m);
+    }
 
-    int audioTrackNameNumber = 1;
-    addSubTracksRecursively (xml, audioTrackNameNumber);
-    numAudioTracks = audioTracks.countNumberOfSetBits();
+    // A truncated stream reads as zeros so this won't match
+    if (in.readInt() != edit_snapshot::summaryEndMarker)
+        return std::nullopt;
+
+    return s;
 }
 
+//==============================================================================
 int EditSnapshot::audioToGlobalTrackIndex (int audioIndex) const
 {
     int audioTrackIndex = 0;
 
-    for (int i = 0; i < numTracks; ++i)
+    for (int i = 0; i < summary.numTracks; ++i)
         if (isAudioTrack (i))
             if (audioTrackIndex++ == audioIndex)
                 return i;
@@ -221,80 +969,37 @@ void EditSnapshot::refreshFromProjectItem (ProjectItem::Ptr pi)
         return;
 
     sourceFile = pi->getSourceFile();
-    auto newState = loadValueTree (sourceFile, true);
+    auto newSummary = edit_snapshot::loadSummary (engine, sourceFile);
 
-    if (! newState.hasType (IDs::EDIT))
+    if (! newSummary.isValid)
         return;
 
+    // The state is loaded from the file when it's asked for
+    state = {};
     name = pi->getName();
-    setState (newState, TimeDuration::fromSeconds (pi->getLength()));
-    refreshFromState();
+    length = pi->getLength();
+    setSummary (std::move (newSummary));
 }
 
 void EditSnapshot::refreshFromState()
 {
-    auto editName = name;
-    auto editLength = length;
-    clear();
+    // If the state hasn't been loaded, the summary already matches the file
+    if (state.isValid())
+        setSummary (Summary::fromState (state));
+}
 
-    if (auto xml = state.createXml())
-        refreshFromXml (*xml, editName, editLength);
+void EditSnapshot::setSummary (Summary newSummary)
+{
+    summary = std::move (newSummary);
+    lastSaveTime = summary.lastSignificantChange.toMilliseconds() == 0 ? sourceFile.getLastModificationTime()
+                                                                       : summary.lastSignificantChange;
 }
 
 void EditSnapshot::clear()
 {
     name = {};
-    numTracks = 0;
-    numAudioTracks = 0;
-    trackNames.clearQuick();
-    audioTracks.clear();
-    trackIDs.clear();
-    editClipIDs.clear();
-    clipSourceIDs.clear();
     length = 0.0;
-    markIn = 0.0;
-    markOut = 0.0;
-    tempo = 0.0;
-
-    marksActive = false;
-    timeSigNumerator = 4;
-    timeSigDenominator = 4;
-    pitch = 60;
-    markers.clear();
-}
-
-void EditSnapshot::addEditClips (const juce::XmlElement& track)
-{
-    for (auto clip : track.getChildIterator())
-        if (clip->hasTagName (IDs::EDITCLIP))
-            editClipIDs.add (ProjectItemID (clip->getStringAttribute ("source")));
-}
-
-void EditSnapshot::addClipSources (const juce::XmlElement& track)
-{
-    for (auto clip : track.getChildIterator())
-    {
-        auto sourceID = clip->getStringAttribute ("source");
-
-        if (sourceID.isNotEmpty())
-            clipSourceIDs.add (ProjectItemID (sourceID));
-    }
-}
-
-void EditSnapshot::addMarkers (const juce::XmlElement& track)
-{
-    for (auto clip : track.getChildIterator())
-    {
-        Marker m;
-        m.name      = clip->getStringAttribute ("name", TRANS("unnamed"));
-        m.colour    = juce::Colour::fromString (clip->getStringAttribute ("colour", TRANS("unnamed")));
-        auto start  = TimePosition::fromSeconds (clip->getDoubleAttribute ("start", 0.0));
-        auto len    = TimeDuration::fromSeconds (clip->getDoubleAttribute ("length", 0.0));
-        m.time      = { start, start + len };
-
-        if (len > 0s)
-            markers.add (m);
-    }
+    summary = {};
 }
 
 
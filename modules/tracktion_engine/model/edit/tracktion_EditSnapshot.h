@@ -14,6 +14,12 @@ namespace tracktion { inline namespace engine
 //==============================================================================
 /**
     Holds a snapshot of an Edit file of the last time it was saved.
+
+    The properties the snapshot needs are streamed from the file without loading
+    the whole Edit, and cached in a summary file in the TemporaryFileManager's
+    folder. The summary is keyed by the Edit file's size and modification time,
+    and then by a hash of its contents, so unchanged files don't need reading
+    again. The full state is only loaded when getState is called.
 */
 class EditSnapshot  : public juce::ReferenceCountedObject
 {
@@ -31,6 +37,40 @@ public:
         TimeRange time;
     };
 
+    //==============================================================================
+    /** The properties of an Edit that a snapshot caches. */
+    struct Summary
+    {
+        bool isValid = false;                               ///< True if the source was an Edit
+        juce::Time lastSignificantChange;                   ///< The Edit's last change time, or 0 if it wasn't stored
+
+        int numTracks = 0, numAudioTracks = 0;
+        juce::StringArray trackNames;
+        juce::BigInteger audioTracks, mutedTracks, soloedTracks, soloIsolatedTracks;
+        juce::Array<EditItemID> trackIDs;
+        juce::Array<ProjectItemID> editClipIDs, clipSourceIDs;
+
+        double markIn = 0.0, markOut = 0.0, tempo = 0.0;
+        bool marksActive = false;
+        int timeSigNumerator = 4, timeSigDenominator = 4, pitch = 60;
+        juce::Array<Marker> markers;
+
+        /** Creates a summary of an Edit state. */
+        static Summary fromState (const juce::ValueTree&);
+
+        /** Streams a summary from an Edit XML file, only decoding the elements it
+            needs rather than parsing the whole file.
+            Returns nullopt if the file can't be read or isn't well-formed.
+        */
+        static std::optional<Summary> fromXmlFile (const juce::File&);
+
+        /** Writes the summary in the format used by the cache. */
+        void writeToStream (juce::OutputStream&) const;
+
+        /** Reads a summary written by writeToStream. */
+        static std::optional<Summary> readFromStream (juce::InputStream&);
+    };
+
     //==============================================================================
     ~EditSnapshot();
 
@@ -40,8 +80,8 @@ public:
     /** Returns the File if this was created from one. */
     juce::File getFile() const                          { return sourceFile; }
 
-    /** Returns the source Xml. */
-    juce::ValueTree getState() noexcept                 { return state; }
+    /** Returns the source state, loading it from the file if it hasn't been set or loaded yet. */
+    juce::ValueTree getState();
 
     /** Sets the Edit XML that the XmlEdit should refer to.
         This will take ownership of the XmlElement so don't hang on to it.
@@ -70,33 +110,36 @@ public:
     //==============================================================================
     // Set of cached properties of the last saved state
     juce::String getName() const                                        { return name; }
-    int getNumTracks() const                                            { return numTracks; }
-    int getNumAudioTracks() const                                       { return numAudioTracks; }
-    int getIndexOfTrackID (EditItemID trackID) const                    { return trackIDs.indexOf (trackID); }
-    juce::String getTrackName (int index) const                         { return trackNames[index]; }
-    juce::String getTrackNameFromID (EditItemID trackID) const          { return trackNames[getIndexOfTrackID(trackID)]; }
-    bool isAudioTrack (int trackIndex) const                            { return audioTracks[trackIndex]; }
-    bool isTrackMuted (int trackIndex) const                            { return mutedTracks[trackIndex]; }
-    bool isTrackSoloed (int trackIndex) const                           { return soloedTracks[trackIndex]; }
-    bool isTrackSoloIsolated (int trackIndex) const                     { return soloIsolatedTracks[trackIndex]; }
+    int getNumTracks() const                                            { return summary.numTracks; }
+    int getNumAudioTracks() const                                       { return summary.numAudioTracks; }
+    int getIndexOfTrackID (EditItemID trackID) const                    { return summary.trackIDs.indexOf (trackID); }
+    juce::String getTrackName (int index) const                         { return summary.trackNames[index]; }
+    juce::String getTrackNameFromID (EditItemID trackID) const          { return summary.trackNames[getIndexOfTrackID(trackID)]; }
+    bool isAudioTrack (int trackIndex) const                            { return summary.audioTracks[trackIndex]; }
+    bool isTrackMuted (int trackIndex) const                            { return summary.mutedTracks[trackIndex]; }
+    bool isTrackSoloed (int trackIndex) const                           { return summary.soloedTracks[trackIndex]; }
+    bool isTrackSoloIsolated (int trackIndex) const                     { return summary.soloIsolatedTracks[trackIndex]; }
     int audioToGlobalTrackIndex (int audioIndex) const;
 
     TimeDuration getLength() const                                       { return TimeDuration::fromSeconds (length); }
-    TimePosition getMarkIn() const                                       { return TimePosition::fromSeconds (markIn); }
-    TimePosition getMarkOut() const                                      { return TimePosition::fromSeconds (markOut); }
-    bool areMarksActive() const                                          { return marksActive; }
-
-    double getTempo() const                                             { return tempo; }
-    int getTimeSigNumerator() const                                     { return timeSigNumerator; }
-    int getTimeSigDenominator() const                                   { return timeSigDenominator; }
-    int getPitch() const                                                { return pitch; }
-
-    const juce::Array<Marker>& getMarkers() const                       { return markers; }
-    const juce::Array<EditItemID>& getTracks() const                    { return trackIDs; }
-    const juce::Array<ProjectItemID>& getEditClips() const              { return editClipIDs; }
-    const juce::Array<ProjectItemID>& getClipsSourceIDs() const         { return clipSourceIDs; }
+    TimePosition getMarkIn() const                                       { return TimePosition::fromSeconds (summary.markIn); }
+    TimePosition getMarkOut() const                                      { return TimePosition::fromSeconds (summary.markOut); }
+    bool areMarksActive() const                                          { return summary.marksActive; }
+
+    double getTempo() const                                             { return summary.tempo; }
+    int getTimeSigNumerator() const                                     { return summary.timeSigNumerator; }
+    int getTimeSigDenominator() const                                   { return summary.timeSigDenominator; }
+    int getPitch() const                                                { return summary.pitch; }
+
+    const juce::Array<Marker>& getMarkers() const                       { return summary.markers; }
+    const juce::Array<EditItemID>& getTracks() const                    { return summary.trackIDs; }
+    const juce::Array<ProjectItemID>& getEditClips() const              { return summary.editClipIDs; }
+    const juce::Array<ProjectItemID>& getClipsSourceIDs() const         { return summary.clipSourceIDs; }
     HashCode getHash() const                                            { return lastSaveTime.toMilliseconds(); }
 
+    /** Returns the summary of the last saved state. */
+    const Summary& getSummary() const noexcept                          { return summary; }
+
     //==============================================================================
     struct Listener
     {
@@ -120,29 +163,17 @@ private:
     juce::Time lastSaveTime;
 
     juce::String name;
-    int numTracks, numAudioTracks;
-    juce::StringArray trackNames;
-    juce::BigInteger audioTracks, mutedTracks, soloedTracks, soloIsolatedTracks;
-
-    juce::Array<EditItemID> trackIDs;
-    juce::Array<ProjectItemID> editClipIDs, clipSourceIDs;
-    double length = 0.0, markIn = 0.0, markOut = 0.0, tempo = 0.0;
-    bool marksActive = false;
-    int timeSigNumerator = 4, timeSigDenominator = 4, pitch = 60;
-    juce::Array<Marker> markers;
+    double length = 0.0;
+    Summary summary;
 
     juce::ListenerList<Listener> listeners;
 
     //==============================================================================
     EditSnapshot (Engine&, ProjectItemID);
     void refreshFromProjectItem (ProjectItem::Ptr);
-    void refreshFromXml (const juce::XmlElement&, const juce::String&, double newLength);
     void refreshFromState();
+    void setSummary (Summary);
     void clear();
-    void addEditClips (const juce::XmlElement& track);
-    void addClipSources (const juce::XmlElement& track);
-    void addMarkers (const juce::XmlElement& track);
-    void addSubTracksRecursively (const juce::XmlElement& parent, int& audioTrackNameNumber);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditSnapshot)
 };
@@ -0,0 +1,179 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT_SNAPSHOT
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE("tracktion_engine")
+{
+    static juce::ValueTree createTestSnapshotState()
+    {
+        juce::ValueTree state (IDs::EDIT);
+        state.setProperty (IDs::lastSignificantChange, juce::String::toHexString ((juce::int64) 1234567890), nullptr);
+
+        state.appendChild (createValueTree (IDs::TRANSPORT, IDs::loopPoint1, 8.0, IDs::loopPoint2, 2.0), nullptr);
+
+        juce::ValueTree tempoSequence (IDs::TEMPOSEQUENCE);
+        tempoSequence.appendChild (createValueTree (IDs::TEMPO, IDs::bpm, 97.5), nullptr);
+        tempoSequence.appendChild (createValueTree (IDs::TEMPO, IDs::bpm, 140.0), nullptr);
+        tempoSequence.appendChild (createValueTree (IDs::TIMESIG, IDs::numerator, 7, IDs::denominator, 8), nullptr);
+        state.appendChild (tempoSequence, nullptr);
+
+        juce::ValueTree pitchSequence (IDs::PITCHSEQUENCE);
+        pitchSequence.appendChild (createValueTree (IDs::PITCH, IDs::pitch, 64), nullptr);
+        state.appendChild (pitchSequence, nullptr);
+
+        juce::ValueTree folder (IDs::FOLDERTRACK);
+        folder.setProperty (IDs::id, 10, nullptr);
+        folder.setProperty (IDs::name, "Folder & <friends>", nullptr);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            juce::ValueTree track (IDs::TRACK);
+            track.setProperty (IDs::id, 20 + i, nullptr);
+            track.setProperty (IDs::mute, i == 0, nullptr);
+            track.setProperty (IDs::solo, i == 1, nullptr);
+            track.setProperty (IDs::soloIsolate, i == 2, nullptr);
+
+            if (i == 1)
+                track.setProperty (IDs::name, juce::CharPointer_UTF8 ("Caf\xc3\xa9 \"quoted\"\nline"), nullptr);
+
+            track.appendChild (createValueTree (IDs::AUDIOCLIP, IDs::source, ProjectItemID (i + 1, 5).toString()), nullptr);
+            track.appendChild (createValueTree (IDs::EDITCLIP, IDs::source, ProjectItemID (i + 10, 5).toString()), nullptr);
+
+            // Elements inside clips shouldn't be picked up
+            juce::ValueTree midiClip (IDs::MIDICLIP);
+            midiClip.appendChild (createValueTree (IDs::TRACK, IDs::id, 99), nullptr);
+            track.appendChild (midiClip, nullptr);
+
+            folder.appendChild (track, nullptr);
+        }
+
+        state.appendChild (folder, nullptr);
+
+        juce::ValueTree markerTrack (IDs::MARKERTRACK);
+        markerTrack.setProperty (IDs::id, 30, nullptr);
+        markerTrack.appendChild (createValueTree (IDs::MARKERCLIP, IDs::name, "Verse", IDs::colour, "ff00ff00",
+                                                  IDs::start, 1.0, IDs::length, 2.5), nullptr);
+        markerTrack.appendChild (createValueTree (IDs::MARKERCLIP, IDs::start, 4.0, IDs::length, 1.0), nullptr);
+        markerTrack.appendChild (createValueTree (IDs::MARKERCLIP, IDs::name, "Empty", IDs::start, 6.0), nullptr);
+        state.appendChild (markerTrack, nullptr);
+
+        state.appendChild (createValueTree (IDs::TRACK, IDs::id, 40), nullptr);
+
+        return state;
+    }
+
+    static void checkSummariesMatch (const EditSnapshot::Summary& a, const EditSnapshot::Summary& b)
+    {
+        CHECK_EQ (a.isValid, b.isValid);
+        CHECK (a.lastSignificantChange == b.lastSignificantChange);
+        CHECK_EQ (a.numTracks, b.numTracks);
+        CHECK_EQ (a.numAudioTracks, b.numAudioTracks);
+        CHECK (a.trackNames == b.trackNames);
+        CHECK (a.audioTracks == b.audioTracks);
+        CHECK (a.mutedTracks == b.mutedTracks);
+        CHECK (a.soloedTracks == b.soloedTracks);
+        CHECK (a.soloIsolatedTracks == b.soloIsolatedTracks);
+        CHECK (a.trackIDs == b.trackIDs);
+        CHECK (a.editClipIDs == b.editClipIDs);
+        CHECK (a.clipSourceIDs == b.clipSourceIDs);
+        CHECK_EQ (a.markIn, b.markIn);
+        CHECK_EQ (a.markOut, b.markOut);
+        CHECK_EQ (a.marksActive, b.marksActive);
+        CHECK_EQ (a.tempo, b.tempo);
+        CHECK_EQ (a.timeSigNumerator, b.timeSigNumerator);
+        CHECK_EQ (a.timeSigDenominator, b.timeSigDenominator);
+        CHECK_EQ (a.pitch, b.pitch);
+        REQUIRE_EQ (a.markers.size(), b.markers.size());
+
+        for (int i = 0; i < a.markers.size(); ++i)
+        {
+            CHECK_EQ (a.markers[i].name, b.markers[i].name);
+            CHECK (a.markers[i].colour == b.markers[i].colour);
+            CHECK (a.markers[i].time == b.markers[i].time);
+        }
+    }
+
+    TEST_CASE ("EditSnapshot::Summary")
+    {
+        auto state = createTestSnapshotState();
+        auto summary = EditSnapshot::Summary::fromState (state);
+
+        CHECK (summary.isValid);
+        CHECK_EQ (summary.lastSignificantChange.toMilliseconds(), (juce::int64) 1234567890);
+        CHECK_EQ (summary.markIn, 2.0);
+        CHECK_EQ (summary.markOut, 8.0);
+        CHECK (summary.marksActive);
+        CHECK_EQ (summary.tempo, 97.5);
+        CHECK_EQ (summary.timeSigNumerator, 7);
+        CHECK_EQ (summary.timeSigDenominator, 8);
+        CHECK_EQ (summary.pitch, 64);
+
+        // The folder, its three tracks, the marker track and the last track
+        CHECK_EQ (summary.numTracks, 6);
+        CHECK_EQ (summary.numAudioTracks, 4);
+        CHECK_EQ (summary.trackNames[0], juce::String ("Folder & <friends>"));
+        CHECK_EQ (summary.trackNames[1], juce::String ("Track 1"));
+        CHECK_EQ (summary.trackNames[3], juce::String ("Track 3"));
+        CHECK_EQ (summary.trackNames[4], juce::String ("Track 4"));
+        CHECK_EQ (summary.trackNames[5], juce::String ("Track 4"));
+        CHECK (summary.mutedTracks[1]);
+        CHECK (summary.soloedTracks[2]);
+        CHECK (summary.soloIsolatedTracks[3]);
+        CHECK_EQ (summary.editClipIDs.size(), 3);
+        CHECK_EQ (summary.clipSourceIDs.size(), 6);
+        CHECK_EQ (summary.markers.size(), 2);
+        CHECK_EQ (summary.markers[1].name, TRANS("unnamed"));
+
+        SUBCASE ("Streaming from XML matches the state")
+        {
+            juce::TemporaryFile tempFile (".tracktionedit");
+            REQUIRE (state.createXml()->writeTo (tempFile.getFile()));
+
+            auto streamed = EditSnapshot::Summary::fromXmlFile (tempFile.getFile());
+            REQUIRE (streamed.has_value());
+            checkSummariesMatch (*streamed, summary);
+
+            // Truncated files can't be read
+            auto text = tempFile.getFile().loadFileAsString();
+            REQUIRE (tempFile.getFile().replaceWithText (text.substring (0, text.length() / 2)));
+            CHECK (! EditSnapshot::Summary::fromXmlFile (tempFile.getFile()).has_value());
+
+            // Other files aren't Edits
+            REQUIRE (juce::ValueTree (IDs::PROJECT).createXml()->writeTo (tempFile.getFile()));
+            auto other = EditSnapshot::Summary::fromXmlFile (tempFile.getFile());
+            REQUIRE (other.has_value());
+            CHECK (! other->isValid);
+        }
+
+        SUBCASE ("Cache round trip")
+        {
+            juce::MemoryOutputStream out;
+            summary.writeToStream (out);
+
+            juce::MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            auto read = EditSnapshot::Summary::readFromStream (in);
+            REQUIRE (read.has_value());
+            checkSummariesMatch (*read, summary);
+
+            juce::MemoryInputStream truncated (out.getData(), out.getDataSize() - 8, false);
+            CHECK (! EditSnapshot::Summary::readFromStream (truncated).has_value());
+        }
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT_SNAPSHOT
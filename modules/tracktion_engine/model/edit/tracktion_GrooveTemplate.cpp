@@ -166,6 +166,54 @@ bool GrooveTemplate::isEmpty() const
     return true;
 }
 
+//==============================================================================
+CompiledGrooveTemplate::CompiledGrooveTemplate (const GrooveTemplate& groove)
+    : notesPerBeat (groove.getNotesPerBeat()),
+      parameterized (groove.isParameterized())
+{
+    if (groove.isEmpty())
+        return;
+
+    const auto numNotes = groove.getNumberOfNotes();
+    latenesses.reserve ((size_t) numNotes);
+
+    // With a strength of 1 this is the stored lateness, or 0 past the end of the stored ones
+    for (int i = 0; i < numNotes; ++i)
+        latenesses.push_back (groove.getLatenessProportion (i, 1.0f));
+}
+
+bool CompiledGrooveTemplate::operator== (const CompiledGrooveTemplate& o) const
+{
+    return latenesses == o.latenesses
+        && notesPerBeat == o.notesPerBeat
+        && parameterized == o.parameterized;
+}
+
+float CompiledGrooveTemplate::getLateness (int gridPosition) const
+{
+    // Negative times wrap to negative positions, which have no lateness
+    return gridPosition >= 0 ? latenesses[(size_t) gridPosition] : 0.0f;
+}
+
+BeatPosition CompiledGrooveTemplate::beatsTimeToGroovyTime (BeatPosition beatsTime, float strength) const
+{
+    if (latenesses.empty())
+        return beatsTime;
+
+    const auto numNotes = (int) latenesses.size();
+    const auto activeStrength = parameterized ? strength : 1.0f;
+
+    const double beatNum    = std::floor (beatsTime.inBeats() * notesPerBeat);
+    const double offset     = notesPerBeat * (beatsTime.inBeats() - (beatNum / notesPerBeat));
+    const int latenessIndex = juce::roundToInt (beatNum) % numNotes;
+
+    const double lateness   = getLateness (latenessIndex) * activeStrength;
+    const double t1         = (beatNum + 0.5f * lateness);
+    const double t2minust1  = 1.0 + 0.5f * ((getLateness ((latenessIndex + 1) % numNotes) * activeStrength) - lateness);
+
+    return BeatPosition::fromBeats ((t1 + offset * t2minust1) / notesPerBeat);
+}
+
 //==============================================================================
 const char* basic8SwingXML  = "<GROOVETEMPLATE name=\"Basic 8th Swing\" numberOfNotes=\"2\" notesPerBeat=\"2\" parameterized=\"1\"><SHIFT delta=\"0.0\"/><SHIFT delta=\"0.66\"/></GROOVETEMPLATE>";
 const char* basic16SwingXML = "<GROOVETEMPLATE name=\"Basic 16th Swing\" numberOfNotes=\"2\" notesPerBeat=\"4\" parameterized=\"1\"><SHIFT delta=\"0.0\"/><SHIFT delta=\"0.66\"/></GROOVETEMPLATE>";
@@ -68,6 +68,42 @@ private:
     JUCE_LEAK_DETECTOR (GrooveTemplate)
 };
 
+//==============================================================================
+/**
+    A GrooveTemplate compiled in to a table of the lateness at each grid position.
+
+    This gives the same times as GrooveTemplate::beatsTimeToGroovyTime but doesn't
+    allocate or do any bounds checking so it can be applied to each event on the
+    audio thread, with a strength that can change whilst it plays.
+*/
+class CompiledGrooveTemplate
+{
+public:
+    /** Creates an empty table that leaves times unchanged. */
+    CompiledGrooveTemplate() = default;
+
+    /** Compiles a GrooveTemplate. */
+    CompiledGrooveTemplate (const GrooveTemplate&);
+
+    bool operator== (const CompiledGrooveTemplate&) const;
+
+    /** Returns true if this won't move any times. */
+    bool isEmpty() const                                    { return latenesses.empty(); }
+
+    /** Returns true if the strength changes how much times are moved. */
+    bool isParameterized() const                            { return parameterized; }
+
+    /** Apply the groove to a time, in beats. */
+    BeatPosition beatsTimeToGroovyTime (BeatPosition, float strength) const;
+
+private:
+    std::vector<float> latenesses;
+    int notesPerBeat = 1;
+    bool parameterized = false;
+
+    float getLateness (int gridPosition) const;
+};
+
 //==============================================================================
 /**
     Looks after the list of groove templates.
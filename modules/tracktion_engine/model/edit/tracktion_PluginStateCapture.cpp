@@ -0,0 +1,188 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+PluginStateCapture::PluginStateCapture (Edit& e)
+    : edit (e)
+{
+}
+
+PluginStateCapture::~PluginStateCapture()
+{
+    // Stops any pending messages touching this, then waits for the threads as they use the plugins
+    alive.reset();
+
+    for (auto& t : threads)
+        t.join();
+}
+
+//==============================================================================
+void PluginStateCapture::captureAsync (std::function<void()> onCaptured)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (capturing)
+    {
+        queuedCallbacks.push_back (std::move (onCaptured));
+        return;
+    }
+
+    callbacks.push_back (std::move (onCaptured));
+    startCapture();
+}
+
+void PluginStateCapture::waitForCapture()
+{
+    while (capturing)
+    {
+        TRACKTION_ASSERT_MESSAGE_THREAD
+
+        for (auto& t : threads)
+            t.join();
+
+        threads.clear();
+
+        while (nextMessageThreadJob < messageThreadJobs.size())
+            captureNextOnMessageThread();
+
+        finishIfDone();
+    }
+}
+
+//==============================================================================
+void PluginStateCapture::startCapture()
+{
+    CRASH_TRACER
+    jassert (! capturing);
+
+    capturing = true;
+    currentStatistics = {};
+    backgroundJobs.clear();
+    messageThreadJobs.clear();
+    nextBackgroundJob = 0;
+    nextMessageThreadJob = 0;
+
+    for (auto p : getAllPlugins (edit, true))
+    {
+        if (auto ep = dynamic_cast<ExternalPlugin*> (p))
+        {
+            if (! ep->hasStateChangedSinceCapture())
+            {
+                ++currentStatistics.numSkipped;
+                continue;
+            }
+
+            auto job = std::make_unique<Job>();
+            job->plugin = ep;
+
+            if (ep->canCaptureStateOnBackgroundThread())
+                backgroundJobs.push_back (std::move (job));
+            else
+                messageThreadJobs.push_back (std::move (job));
+        }
+    }
+
+    currentStatistics.numCapturedInBackground = (int) backgroundJobs.size();
+    currentStatistics.numCapturedOnMessageThread = (int) messageThreadJobs.size();
+
+    // The message thread is used for other plugins so the background ones get the other cores
+    const auto numCores = (size_t) std::max (2u, std::thread::hardware_concurrency());
+    const auto numThreads = std::min (backgroundJobs.size(), numCores - 1);
+    numThreadsRunning = numThreads;
+
+    for (size_t i = 0; i < numThreads; ++i)
+        threads.emplace_back ([this] { runBackgroundJobs(); });
+
+    postToMessageThread ([] (auto& c) { c.captureNextOnMessageThread(); });
+}
+
+void PluginStateCapture::runBackgroundJobs()
+{
+    for (;;)
+    {
+        const auto index = nextBackgroundJob++;
+
+        if (index >= backgroundJobs.size())
+            break;
+
+        auto& job = *backgroundJobs[index];
+        job.state = job.plugin->captureState();
+    }
+
+    if (--numThreadsRunning == 0)
+        postToMessageThread ([] (auto& c) { c.finishIfDone(); });
+}
+
+void PluginStateCapture::captureNextOnMessageThread()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (nextMessageThreadJob < messageThreadJobs.size())
+    {
+        // One plugin is captured per message so the UI can carry on in between them
+        auto& job = *messageThreadJobs[nextMessageThreadJob++];
+        job.state = job.plugin->captureState();
+        postToMessageThread ([] (auto& c) { c.captureNextOnMessageThread(); });
+        return;
+    }
+
+    finishIfDone();
+}
+
+void PluginStateCapture::finishIfDone()
+{
+    if (capturing
+        && numThreadsRunning == 0
+        && nextMessageThreadJob >= messageThreadJobs.size())
+        finish();
+}
+
+void PluginStateCapture::finish()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    CRASH_TRACER
+
+    for (auto& t : threads)
+        t.join();
+
+    threads.clear();
+
+    for (auto jobs : { &backgroundJobs, &messageThreadJobs })
+        for (auto& job : *jobs)
+            job->plugin->flushPluginStateToValueTree (job->state);
+
+    backgroundJobs.clear();
+    messageThreadJobs.clear();
+    lastStatistics = currentStatistics;
+    capturing = false;
+
+    auto callbacksToCall = std::exchange (callbacks, std::exchange (queuedCallbacks, {}));
+
+    if (! callbacks.empty())
+        startCapture();
+
+    for (auto& callback : callbacksToCall)
+        if (callback)
+            callback();
+}
+
+void PluginStateCapture::postToMessageThread (std::function<void (PluginStateCapture&)> f)
+{
+    juce::MessageManager::callAsync ([this, weakAlive = std::weak_ptr<bool> (alive), f = std::move (f)]
+                                     {
+                                         if (weakAlive.lock() != nullptr)
+                                             f (*this);
+                                     });
+}
+
+} // namespace tracktion::inline engine
@@ -0,0 +1,102 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Captures the states of an Edit's ExternalPlugins without blocking the message
+    thread, so autosaves and snapshots don't stall the UI while large plugin
+    states are read.
+
+    Plugins that haven't reported a parameter or state change since their state was
+    last written are skipped. The others are captured in parallel on background
+    threads if EngineBehaviour::canCapturePluginStateOnBackgroundThread allows it,
+    or one at a time on the message thread in between other messages if not.
+    Once they've all been captured, the states that have changed are written to
+    the Edit's ValueTree on the message thread.
+
+    Every Edit has one of these. @see Edit::getPluginStateCapture, Edit::flushStateAsync
+*/
+class PluginStateCapture
+{
+public:
+    /** Creates a PluginStateCapture for an Edit. */
+    PluginStateCapture (Edit&);
+
+    /** Destructor. This waits for any background captures to finish but doesn't
+        write their states to the Edit.
+    */
+    ~PluginStateCapture();
+
+    //==============================================================================
+    /** Starts capturing the plugin states, calling a function on the message thread
+        once they've been written to the Edit's ValueTree.
+        If a capture is already running, another one is started after it so any
+        changes made since the first one started are also captured.
+        This must be called on the message thread.
+    */
+    void captureAsync (std::function<void()> onCaptured);
+
+    /** Returns true if a capture is running. */
+    bool isCapturing() const noexcept           { return capturing; }
+
+    /** Finishes any running captures on this thread, writing their states and
+        calling their callbacks. If a capture is running, this must be called on
+        the message thread.
+    */
+    void waitForCapture();
+
+    //==============================================================================
+    /** The number of plugins handled by the last capture. */
+    struct Statistics
+    {
+        int numCapturedInBackground = 0;    ///< Plugins captured on background threads
+        int numCapturedOnMessageThread = 0; ///< Plugins captured on the message thread
+        int numSkipped = 0;                 ///< Plugins that hadn't changed so weren't captured
+    };
+
+    /** Returns the statistics for the last capture that finished. */
+    Statistics getLastStatistics() const noexcept   { return lastStatistics; }
+
+private:
+    //==============================================================================
+    struct Job
+    {
+        ExternalPlugin::Ptr plugin;
+        std::optional<ExternalPlugin::CapturedState> state;
+    };
+
+    Edit& edit;
+    std::shared_ptr<bool> alive { std::make_shared<bool> (true) };
+
+    std::vector<std::unique_ptr<Job>> backgroundJobs, messageThreadJobs;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextBackgroundJob { 0 };
+    std::atomic<size_t> numThreadsRunning { 0 };
+    size_t nextMessageThreadJob = 0;
+    bool capturing = false;
+
+    std::vector<std::function<void()>> callbacks, queuedCallbacks;
+    Statistics currentStatistics, lastStatistics;
+
+    void startCapture();
+    void runBackgroundJobs();
+    void captureNextOnMessageThread();
+    void finishIfDone();
+    void finish();
+    void postToMessageThread (std::function<void (PluginStateCapture&)>);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginStateCapture)
+};
+
+} // namespace tracktion::inline engine
@@ -0,0 +1,209 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+namespace plugin_state_capture::test
+{
+    /** A plugin whose state is a string, counting how many times it's read. */
+    class StateInstance  : public juce::AudioPluginInstance
+    {
+    public:
+        StateInstance()
+            : juce::AudioPluginInstance (BusesProperties().withInput ("Input", juce::AudioChannelSet::stereo())
+                                                          .withOutput ("Output", juce::AudioChannelSet::stereo()))
+        {
+        }
+
+        static juce::PluginDescription getDescription()
+        {
+            juce::PluginDescription desc;
+            desc.name = "State Capture Test";
+            desc.pluginFormatName = "StateCaptureTest";
+            desc.fileOrIdentifier = "state_capture_test";
+            desc.manufacturerName = "Tracktion";
+            desc.uniqueId = 0x53544354;
+            desc.isInstrument = false;
+            desc.numInputChannels = 2;
+            desc.numOutputChannels = 2;
+            return desc;
+        }
+
+        /** Changes the state and tells the host, as a plugin's editor would. */
+        void setState (const juce::String& newState)
+        {
+            {
+                const juce::ScopedLock sl (stateLock);
+                state = newState;
+            }
+
+            updateHostDisplay (ChangeDetails().withNonParameterStateChanged (true));
+        }
+
+        void getStateInformation (juce::MemoryBlock& destData) override
+        {
+            const juce::ScopedLock sl (stateLock);
+            ++numStateReads;
+            destData.reset();
+            juce::MemoryOutputStream (destData, false).writeString (state);
+        }
+
+        void setStateInformation (const void* data, int size) override
+        {
+            const juce::ScopedLock sl (stateLock);
+            state = juce::MemoryInputStream (data, (size_t) size, false).readString();
+        }
+
+        void fillInPluginDescription (juce::PluginDescription& desc) const override { desc = getDescription(); }
+        const juce::String getName() const override                         { return getDescription().name; }
+        void prepareToPlay (double, int) override                           {}
+        void releaseResources() override                                    {}
+        void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+        double getTailLengthSeconds() const override                        { return 0.0; }
+        bool acceptsMidi() const override                                   { return false; }
+        bool producesMidi() const override                                  { return false; }
+        juce::AudioProcessorEditor* createEditor() override                 { return nullptr; }
+        bool hasEditor() const override                                     { return false; }
+        int getNumPrograms() override                                       { return 1; }
+        int getCurrentProgram() override                                    { return 0; }
+        void setCurrentProgram (int) override                               {}
+        const juce::String getProgramName (int) override                    { return {}; }
+        void changeProgramName (int, const juce::String&) override          {}
+
+        std::atomic<int> numStateReads { 0 };
+
+    private:
+        juce::CriticalSection stateLock;
+        juce::String state;
+    };
+
+    /** Lets ExternalPlugins be created with a StateInstance whilst it's in scope. */
+    struct ScopedStateInstanceType
+    {
+        ScopedStateInstanceType (Engine& e)
+            : pluginManager (e.getPluginManager()),
+              oldCreatePluginInstance (pluginManager.createPluginInstance)
+        {
+            pluginManager.knownPluginList.addType (StateInstance::getDescription());
+            pluginManager.createPluginInstance = [this] (const juce::PluginDescription& d, double rate, int size, juce::String& error)
+                                                    -> std::unique_ptr<juce::AudioPluginInstance>
+            {
+                if (d.pluginFormatName == StateInstance::getDescription().pluginFormatName)
+                    return std::make_unique<StateInstance>();
+
+                return oldCreatePluginInstance (d, rate, size, error);
+            };
+        }
+
+        ~ScopedStateInstanceType()
+        {
+            pluginManager.createPluginInstance = oldCreatePluginInstance;
+            pluginManager.knownPluginList.removeType (StateInstance::getDescription());
+        }
+
+        PluginManager& pluginManager;
+        decltype (PluginManager::createPluginInstance) oldCreatePluginInstance;
+    };
+
+    inline juce::String getSavedState (ExternalPlugin& plugin)
+    {
+        juce::MemoryBlock mb;
+        plugin.getPluginStateFromTree (mb);
+        return juce::MemoryInputStream (mb, false).readString();
+    }
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("PluginStateCapture")
+    {
+        using namespace plugin_state_capture::test;
+        auto& engine = *Engine::getEngines()[0];
+        ScopedStateInstanceType scopedType (engine);
+        auto edit = engine::test_utilities::createTestEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+        auto& capture = edit->getPluginStateCapture();
+
+        auto createPlugin = [&]
+        {
+            auto plugin = edit->getPluginCache().createNewPlugin (ExternalPlugin::xmlTypeName, StateInstance::getDescription());
+            track->pluginList.insertPlugin (plugin, 0, nullptr);
+
+            auto externalPlugin = dynamic_cast<ExternalPlugin*> (plugin.get());
+            REQUIRE (externalPlugin != nullptr);
+            externalPlugin->initialiseFully();
+
+            auto instance = dynamic_cast<StateInstance*> (externalPlugin->getAudioPluginInstance());
+            REQUIRE (instance != nullptr);
+
+            return std::pair<ExternalPlugin::Ptr, StateInstance*> (externalPlugin, instance);
+        };
+
+        SUBCASE ("flushState writes the newest state after an async capture")
+        {
+            auto [plugin, instance] = createPlugin();
+            instance->setState ("first");
+
+            int numCallbacks = 0;
+            edit->flushStateAsync ([&numCallbacks] { ++numCallbacks; });
+            CHECK (capture.isCapturing());
+
+            // Changed before the capture has read it, so the capture mustn't leave an older state behind
+            instance->setState ("second");
+            edit->flushState();
+
+            CHECK (! capture.isCapturing());
+            CHECK_EQ (numCallbacks, 1);
+            CHECK_EQ (getSavedState (*plugin), "second");
+            CHECK (! plugin->hasStateChangedSinceCapture());
+        }
+
+        SUBCASE ("Unchanged plugins are skipped")
+        {
+            auto [changedPlugin, changedInstance] = createPlugin();
+            auto [unchangedPlugin, unchangedInstance] = createPlugin();
+            changedInstance->setState ("a");
+            unchangedInstance->setState ("b");
+
+            // A full flush captures every plugin
+            edit->flushState();
+            CHECK_EQ (getSavedState (*changedPlugin), "a");
+            CHECK_EQ (getSavedState (*unchangedPlugin), "b");
+            CHECK (! changedPlugin->hasStateChangedSinceCapture());
+            CHECK (! unchangedPlugin->hasStateChangedSinceCapture());
+
+            changedInstance->setState ("c");
+            CHECK (changedPlugin->hasStateChangedSinceCapture());
+            const int numUnchangedReads = unchangedInstance->numStateReads;
+
+            bool flushed = false;
+            edit->flushStateAsync ([&flushed] { flushed = true; });
+            capture.waitForCapture();
+            CHECK (flushed);
+
+            const auto stats = capture.getLastStatistics();
+            CHECK_EQ (stats.numSkipped, 1);
+            CHECK_EQ (stats.numCapturedInBackground + stats.numCapturedOnMessageThread, 1);
+            CHECK_EQ (unchangedInstance->numStateReads.load(), numUnchangedReads);
+
+            CHECK_EQ (getSavedState (*changedPlugin), "c");
+            CHECK_EQ (getSavedState (*unchangedPlugin), "b");
+        }
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT
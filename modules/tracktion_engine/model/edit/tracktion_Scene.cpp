@@ -33,6 +33,51 @@ int Scene::getIndex()
     return sceneList.getScenes().indexOf (this);
 }
 
+void Scene::launch (std::optional<MonotonicBeat> pos)
+{
+    const auto index = getIndex();
+
+    if (index < 0)
+        return;
+
+    LaunchHandle::Batch batch;
+
+    for (auto at : getAudioTracks (edit))
+    {
+        auto slots = at->getClipSlotList().getClipSlots();
+
+        for (int i = 0; i < slots.size(); ++i)
+        {
+            if (auto c = slots.getUnchecked (i)->getClip())
+            {
+                if (auto lh = c->getLaunchHandle())
+                {
+                    if (i == index)
+                        batch.play (*lh, pos);
+                    else if (lh->getPlayingStatus() == LaunchHandle::PlayState::playing)
+                        batch.stop (*lh, pos);
+                }
+            }
+        }
+    }
+
+    batch.publish();
+}
+
+void Scene::stop (std::optional<MonotonicBeat> pos)
+{
+    const auto index = getIndex();
+    LaunchHandle::Batch batch;
+
+    for (auto at : getAudioTracks (edit))
+        if (auto slot = at->getClipSlotList().getClipSlots()[index])
+            if (auto c = slot->getClip())
+                if (auto lh = c->getLaunchHandle())
+                    batch.stop (*lh, pos);
+
+    batch.publish();
+}
+
 juce::String Scene::getSelectableDescription()
 {
     return TRANS("Scene");
@@ -200,6 +245,86 @@ juce::Array<Scene*> SceneList::getScenes()
     return objects;
 }
 
+void SceneList::stopAllClips (std::optional<MonotonicBeat> pos)
+{
+    LaunchHandle::Batch batch;
+
+    edit.clipSlotCache.visitItems ([&] (auto cs)
+    {
+        if (auto c = cs->getClip())
+            if (auto lh = c->getLaunchHandle())
+                batch.stop (*lh, pos);
+    });
+
+    batch.publish();
+}
+
+//==============================================================================
+void SceneList::setPreloadedSceneRange (std::optional<juce::Range<int>> newRange)
+{
+    if (preloadedSceneRange == newRange)
+        return;
+
+    preloadedSceneRange = newRange;
+    edit.restartPlayback();
+}
+
+void SceneList::setPreloadBudgetBytes (int64_t newBudget)
+{
+    if (preloadBudgetBytes == newBudget)
+        return;
+
+    preloadBudgetBytes = newBudget;
+    edit.restartPlayback();
+}
+
+void SceneList::updatePreloadedSlots()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    preloadedSlots.clear();
+    preloadedBytes = 0;
+
+    std::vector<juce::Array<ClipSlot*>> trackSlots;
+
+    for (auto at : getAudioTracks (edit))
+        trackSlots.push_back (at->getClipSlotList().getClipSlots());
+
+    const auto sceneRange = preloadedSceneRange.value_or (juce::Range<int> (0, size()))
+                                .getIntersectionWith ({ 0, size() });
+
+    // Go through a Scene at a time so the first ones in the range get priority
+    for (int sceneIndex = sceneRange.getStart(); sceneIndex < sceneRange.getEnd(); ++sceneIndex)
+    {
+        for (auto& slots : trackSlots)
+        {
+            auto slot = slots[sceneIndex];
+
+            if (slot == nullptr)
+                continue;
+
+            auto audioClip = dynamic_cast<AudioClipBase*> (slot->getClip());
+
+            if (audioClip == nullptr)
+                continue;
+
+            const auto numBytes = AudioFileCache::getUpcomingReadAheadBytes (audioClip->getAudioFile().getInfo());
+
+            if (preloadedBytes + numBytes > preloadBudgetBytes)
+                continue;
+
+            preloadedBytes += numBytes;
+            preloadedSlots.push_back (slot->itemID);
+        }
+    }
+
+    std::sort (preloadedSlots.begin(), preloadedSlots.end());
+}
+
+bool SceneList::isSlotPreloaded (EditItemID slotID) const
+{
+    return std::binary_search (preloadedSlots.begin(), preloadedSlots.end(), slotID);
+}
+
 void SceneList::ensureNumberOfScenes (int numScenes)
 {
     for (int i = size(); i < numScenes; ++i)
@@ -31,6 +31,17 @@ public:
 
     int getIndex();
 
+    /** Launches the clips in all this Scene's slots, optionally at a given beat position.
+        Any other clips playing on the same tracks are stopped, as are the clips on
+        tracks where this Scene's slot is empty.
+        All the launches are published together so they start in the same block.
+        @see LaunchHandle::Batch
+    */
+    void launch (std::optional<MonotonicBeat>);
+
+    /** Stops the clips in all this Scene's slots, optionally at a given beat position. */
+    void stop (std::optional<MonotonicBeat>);
+
     juce::ValueTree state;
     Edit& edit;
 
@@ -147,6 +158,42 @@ public:
     /** Deletes a specific Scene. */
     void deleteScene (Scene&);
 
+    /** Stops all the clips playing in any slot, optionally at a given beat position.
+        All the stops are published together so they happen in the same block.
+    */
+    void stopAllClips (std::optional<MonotonicBeat>);
+
+    //==============================================================================
+    /** Sets the range of Scenes whose audio clips keep the start of their files
+        ready to play whilst stopped, so they start instantly when launched.
+        This would usually be the Scenes visible in the UI.
+        Passing std::nullopt preloads all the Scenes, which is the default.
+        Scenes are preloaded in order until the budget is reached.
+        @see setPreloadBudgetBytes
+    */
+    void setPreloadedSceneRange (std::optional<juce::Range<int>>);
+
+    /** Returns the range of Scenes set to be preloaded. */
+    std::optional<juce::Range<int>> getPreloadedSceneRange() const      { return preloadedSceneRange; }
+
+    /** Sets the maximum number of bytes of audio that can be kept ready for
+        preloaded slots. Slots that don't fit in this aren't preloaded.
+    */
+    void setPreloadBudgetBytes (int64_t);
+
+    /** Returns the maximum number of bytes used for preloaded slots. */
+    int64_t getPreloadBudgetBytes() const                               { return preloadBudgetBytes; }
+
+    /** Returns the number of bytes of audio being kept ready for the preloaded
+        slots when playback was last built.
+    */
+    int64_t getPreloadedBytes() const                                   { return preloadedBytes; }
+
+    /** @internal */
+    void updatePreloadedSlots();
+    /** @internal */
+    bool isSlotPreloaded (EditItemID) const;
+
     juce::ValueTree state;  /**< The state of this SceneList. */
     Edit& edit;             /**< The Edit this SceneList belongs to. */
 
@@ -154,6 +201,11 @@ public:
     SceneWatcher sceneWatcher { state, edit };
 
 private:
+    //==============================================================================
+    std::optional<juce::Range<int>> preloadedSceneRange;
+    int64_t preloadBudgetBytes = 64 * 1024 * 1024, preloadedBytes = 0;
+    std::vector<EditItemID> preloadedSlots;
+
     //==============================================================================
     /** @internal */
     bool isSuitableType (const juce::ValueTree&) const override;
@@ -543,6 +543,18 @@ tempo::BarsAndBeats TempoSequence::toBarsAndBeats (TimePosition t) const
     return internalSequence.toBarsAndBeats (t);
 }
 
+void TempoSequence::toBeats (std::span<const TimePosition> times, std::span<BeatPosition> beats) const
+{
+    updateTempoDataIfNeeded();
+    internalSequence.toBeats (times, beats);
+}
+
+void TempoSequence::toTime (std::span<const BeatPosition> beats, std::span<TimePosition> times) const
+{
+    updateTempoDataIfNeeded();
+    internalSequence.toTime (beats, times);
+}
+
 //==============================================================================
 const tempo::Sequence& TempoSequence::getInternalSequence() const
 {
@@ -186,6 +186,16 @@ public:
     /** Converts a time to a number of BarsAndBeats. */
     tempo::BarsAndBeats toBarsAndBeats (TimePosition) const;
 
+    /** Converts a number of times to beats in one go.
+        @see tempo::Sequence::toBeats
+    */
+    void toBeats (std::span<const TimePosition>, std::span<BeatPosition>) const;
+
+    /** Converts a number of beats to times in one go.
+        @see tempo::Sequence::toTime
+    */
+    void toTime (std::span<const BeatPosition>, std::span<TimePosition>) const;
+
     //==============================================================================
     /** N.B. It is only safe to call this from the message thread or during audio callbacks.
         Access at any other time could incur data races.
@@ -240,20 +240,92 @@ bool TracktionArchiveFile::extractFile (int index, const juce::File& destDirecto
 bool TracktionArchiveFile::extractAll (const juce::File& destDirectory,
                                        juce::Array<juce::File>& filesCreated)
 {
+    juce::Array<int> indexes;
+
+    for (int i = 0; i < entries.size(); ++i)
+        indexes.add (i);
+
+    return extractConcurrently (destDirectory, indexes, filesCreated, {}, {});
+}
+
+bool TracktionArchiveFile::extractConcurrently (const juce::File& destDirectory, const juce::Array<int>& indexes,
+                                                juce::Array<juce::File>& filesCreated,
+                                                const std::function<bool()>& shouldAbort,
+                                                const std::function<void (float)>& onProgress)
+{
+    CRASH_TRACER
+
     if (! destDirectory.createDirectory())
         return false;
 
-    for (int i = 0; i < entries.size(); ++i)
+    // Entries with the same name would be extracted to the same file so only the last
+    // of these is extracted, which is what extracting them in order would leave
+    juce::Array<int> indexesToExtract;
+    std::set<juce::String> namesFound;
+
+    for (int i = indexes.size(); --i >= 0;)
+        if (namesFound.insert (getOriginalFileName (indexes[i]).toLowerCase()).second)
+            indexesToExtract.insert (0, indexes[i]);
+
+    // Each thread only streams one entry at a time so the memory used is bounded by the number of threads
+    std::vector<juce::File> created ((size_t) indexesToExtract.size());
+    std::atomic<int> nextIndex { 0 }, numExtracted { 0 };
+    std::atomic<bool> failed { false }, aborted { false };
+    std::vector<std::thread> threads;
+    const auto numThreads = std::min ((size_t) indexesToExtract.size(),
+                                      (size_t) std::max (1, juce::SystemStats::getNumCpus() - 1));
+
+    for (size_t i = 0; i < numThreads; ++i)
     {
-        juce::File fileCreated;
+        threads.emplace_back ([&, this]
+        {
+            juce::FloatVectorOperations::disableDenormalisedNumberSupport();
 
-        if (! extractFile (i, destDirectory, fileCreated, false))
-            return false;
+            for (;;)
+            {
+                const auto index = nextIndex.fetch_add (1);
+
+                if (index >= indexesToExtract.size() || failed || aborted)
+                    break;
+
+                juce::File fileCreated;
+
+                if (! extractFile (indexesToExtract[index], destDirectory, fileCreated, false))
+                    failed = true;
+                else
+                    created[(size_t) index] = fileCreated;
 
-        filesCreated.add (fileCreated);
+                ++numExtracted;
+            }
+        });
     }
 
-    return true;
+    while (numExtracted < indexesToExtract.size() && ! failed && ! aborted)
+    {
+        if (shouldAbort && shouldAbort())
+            aborted = true;
+
+        if (onProgress)
+            onProgress (numExtracted / (float) indexesToExtract.size());
+
+        juce::Thread::sleep (50);
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& f : created)
+    {
+        if (f.exists())
+        {
+            if (aborted)
+                f.deleteFile();
+            else
+                filesCreated.addIfNotAlreadyThere (f);
+        }
+    }
+
+    return ! (failed || aborted);
 }
 
 //==============================================================================
@@ -281,30 +353,43 @@ public:
         if (! destDir.createDirectory())
             return jobHasFinished;
 
+        // Ask about any files that would be overwritten first so the rest can be extracted concurrently
+        juce::Array<int> indexes;
+
         for (int i = 0; i < archive.getNumFiles(); ++i)
         {
-            if (shouldExit())
+            auto destFile = destDir.getChildFile (archive.getOriginalFileName (i));
+
+            if (warnAboutOverwrite && destFile.existsAsFile())
             {
-                wasAborted = true;
+                auto r = archive.engine.getUIBehaviour()
+                            .showYesNoCancelAlertBox (TRANS("Unpacking archive"),
+                                                      TRANS("The file XZZX already exists - do you want to overwrite it?")
+                                                        .replace ("XZZX", destFile.getFullPathName()),
+                                                      TRANS("Overwrite"),
+                                                      TRANS("Leave existing"));
 
-                for (auto& f : filesCreated)
-                    f.deleteFile();
+                if (r == 0)  return jobHasFinished;
 
-                break;
+                if (r == 1)
+                {
+                    filesCreated.addIfNotAlreadyThere (destFile);
+                    continue;
+                }
             }
 
-            progress = i / (float) archive.getNumFiles();
-
-            juce::File fileCreated;
+            indexes.add (i);
+        }
 
-            if (! archive.extractFile (i, destDir, fileCreated, warnAboutOverwrite))
-                return jobHasFinished;
+        ok = archive.extractConcurrently (destDir, indexes, filesCreated,
+                                          [this] { return shouldExit(); },
+                                          [this] (float p) { progress = p; });
+        wasAborted = shouldExit();
 
-            if (fileCreated.exists())
-                filesCreated.add (fileCreated);
-        }
+        // An aborted extraction removes the files it created but still counts as finished
+        if (wasAborted)
+            ok = true;
 
-        ok = true;
         return jobHasFinished;
     }
 
@@ -333,182 +418,348 @@ bool TracktionArchiveFile::extractAllAsTask (const juce::File& destDirectory, bo
     return task.ok;
 }
 
-bool TracktionArchiveFile::addFile (const juce::File& f, const juce::File& rootDirectory,
-                                    CompressionType compression)
+juce::String TracktionArchiveFile::getFilenameToUse (const juce::File& f, const juce::File& rootDirectory)
 {
-    juce::String name;
-
     if (f.isAChildOf (rootDirectory))
-        name = f.getRelativePathFrom (rootDirectory)
+        return f.getRelativePathFrom (rootDirectory)
                 .replaceCharacter ('\\', '/');
-    else
-        name = f.getFileName();
 
-    return addFile (f, name, compression);
+    return f.getFileName();
 }
 
-bool TracktionArchiveFile::addFile (const juce::File& f, const juce::String& filenameToUse,
+bool TracktionArchiveFile::addFile (const juce::File& f, const juce::File& rootDirectory,
                                     CompressionType compression)
+{
+    return addFile (f, getFilenameToUse (f, rootDirectory), compression);
+}
+
+static TracktionArchiveFile::CompressionType getCompressionToUse (const juce::File& f, TracktionArchiveFile::CompressionType compression)
 {
     // don't risk using ogg or flac on small audio files
-    if (compression != CompressionType::none && f.getSize() <= 16 * 1024)
-        compression = CompressionType::zip;
+    if (compression != TracktionArchiveFile::CompressionType::none && f.getSize() <= 16 * 1024)
+        return TracktionArchiveFile::CompressionType::zip;
 
+    return compression;
+}
+
+bool TracktionArchiveFile::writeHeaderIfNeeded (juce::FileOutputStream& out)
+{
+    if (! valid)
+    {
+        out.setPosition (0);
+        out.writeInt (getMagicNumber());
+        out.writeInt (int (indexOffset));
+        valid = true;
+    }
+
+    jassert (indexOffset < 2147483648);
+
+    if (indexOffset >= 2147483648)
+        return false;
+
+    out.setPosition (indexOffset);
+    return true;
+}
+
+bool TracktionArchiveFile::writeStoredData (Engine& engine, const juce::File& f, CompressionType compression,
+                                            juce::OutputStream& out, IndexEntry& entry)
+{
     juce::FileInputStream in (f);
-    bool ok = false;
 
-    if (in.openedOk())
+    if (! in.openedOk())
+        return false;
+
+    auto filenameRoot = entry.originalName.substring (0, entry.originalName.lastIndexOfChar ('.'));
+
+    switch (compression)
     {
-        juce::FileOutputStream out (file);
+        case CompressionType::none:
+        {
+            out.writeFromInputStream (in, -1);
+            break;
+        }
 
-        if (out.openedOk())
+        case CompressionType::zip:
+        {
+            entry.storedName = filenameRoot + ".gz";
+
+            juce::GZIPCompressorOutputStream deflater (&out, 9, false);
+            deflater.writeFromInputStream (in, -1);
+            break;
+        }
+
+        case CompressionType::lossless:
         {
-            if (! valid)
+            AudioFile af (engine, f);
+
+            if (af.isOggFile() || af.isMp3File() || af.isFlacFile())
             {
-                out.setPosition (0);
-                out.writeInt (getMagicNumber());
-                out.writeInt (int (indexOffset));
-                valid = true;
+                out.writeFromInputStream (in, -1); // no point re-compressing these
             }
+            else
+            {
+                if (af.getBitsPerSample() > 24)
+                {
+                    // FLAC can't do higher than 24 bits so just have to zip it instead..
+                    entry.storedName = filenameRoot + ".gz";
 
-            auto initialPosition = out.getPosition();
+                    juce::GZIPCompressorOutputStream deflater (&out, 9, false);
+                    deflater.writeFromInputStream (in, -1);
+                }
+                else
+                {
+                    entry.storedName = filenameRoot + ".flac";
 
-            out.setPosition (indexOffset);
-            jassert (indexOffset < 2147483648);
+                    if (! AudioFileUtils::convertToFormat<juce::FlacAudioFormat> (engine, f, out, 0,
+                                                                                  juce::StringPairArray()))
+                    {
+                        TRACKTION_LOG_ERROR ("Failed to add file to archive flac: " + f.getFileName());
+                        return false;
+                    }
+                }
+            }
 
-            if (indexOffset >= 2147483648)
+            break;
+        }
+
+        case CompressionType::lossyGoodQuality:
+        case CompressionType::lossyMediumQuality:
+        case CompressionType::lossyLowQuality:
+        {
+            entry.storedName = filenameRoot + ".ogg";
+            entry.originalName = entry.storedName;  // oggs get extracted as oggs, not named back to how they were
+
+            auto quality = getOggQuality (compression);
+            AudioFile af (engine, f);
+
+            if (! isWorthConvertingToOgg (af, quality))
             {
-                TRACKTION_LOG_ERROR ("Archive too large when archiving file: " + f.getFileName());
+                out.writeFromInputStream (in, -1);
+            }
+            else if (! AudioFileUtils::convertToFormat<juce::OggVorbisAudioFormat> (engine, f, out, quality,
+                                                                                    juce::StringPairArray()))
+            {
+                TRACKTION_LOG_ERROR ("Failed to add file to archive ogg: " + f.getFileName());
                 return false;
             }
 
-            auto filenameRoot = filenameToUse.substring (0, filenameToUse.lastIndexOfChar ('.'));
+            break;
+        }
+
+        default:
+        {
+            TRACKTION_LOG_ERROR ("Unknown compression type when archiving file: " + f.getFileName());
+            jassertfalse;
+            break;
+        }
+    }
+
+    out.flush();
+    return true;
+}
+
+bool TracktionArchiveFile::addFile (const juce::File& f, const juce::String& filenameToUse,
+                                    CompressionType compression)
+{
+    compression = getCompressionToUse (f, compression);
+
+    if (! f.existsAsFile())
+        return false;
+
+    juce::FileOutputStream out (file);
+
+    if (! out.openedOk())
+        return false;
+
+    auto initialPosition = std::max<juce::int64> (8, out.getPosition());
+
+    if (! writeHeaderIfNeeded (out))
+    {
+        TRACKTION_LOG_ERROR ("Archive too large when archiving file: " + f.getFileName());
+        return false;
+    }
+
+    auto entry = std::make_unique<IndexEntry>();
+    entry->offset = indexOffset;
+    entry->length = 0;
+    entry->originalName = filenameToUse;
+    entry->storedName = filenameToUse;
+
+    if (! writeStoredData (engine, f, compression, out, *entry))
+    {
+        needToWriteIndex = true;
+        TRACKTION_LOG_ERROR ("Failed to add file to archive: " + f.getFileName());
+        return false;
+    }
+
+    jassert (out.getPosition() > indexOffset);
+
+    entry->length = std::max (juce::int64(), out.getPosition() - indexOffset);
 
-            std::unique_ptr<IndexEntry> entry (new IndexEntry());
-            entry->offset = indexOffset;
-            entry->length = 0;
-            entry->originalName = filenameToUse;
-            entry->storedName = filenameToUse;
+    jassert (indexOffset + entry->length < 2147483648);
+
+    if (indexOffset + entry->length >= 2147483648)
+    {
+        out.setPosition (initialPosition);
+        out.truncate();
+        TRACKTION_LOG_ERROR ("Archive too large when archiving file: " + f.getFileName());
+        return false;
+    }
+
+    indexOffset += entry->length;
+    needToWriteIndex = true;
+
+    entries.add (entry.release());
+    return true;
+}
+
+bool TracktionArchiveFile::addFiles (const std::vector<FileToAdd>& filesToAdd,
+                                     const std::function<void (size_t, bool)>& onFileAdded,
+                                     const std::function<bool()>& shouldAbort)
+{
+    CRASH_TRACER
+
+    struct Chunk
+    {
+        juce::File tempFile;
+        std::unique_ptr<IndexEntry> entry;
+        bool ok = false, done = false;
+    };
+
+    std::vector<Chunk> chunks (filesToAdd.size());
+    std::mutex mutex;
+    std::condition_variable chunkDone, chunkAppended;
+    size_t nextChunkToEncode = 0, numChunksAppended = 0;
+    bool aborted = false;
+
+    // Each worker compresses the next file into a temporary file, as long as it isn't
+    // too far ahead of the one being appended
+    const auto numThreads = std::min (filesToAdd.size(),
+                                      (size_t) std::max (1, juce::SystemStats::getNumCpus() - 1));
+    const auto maxChunksAhead = numThreads * 2;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back ([&, this]
+        {
+            juce::FloatVectorOperations::disableDenormalisedNumberSupport();
 
-            switch (compression)
+            for (;;)
             {
-                case CompressionType::none:
-                {
-                    out.writeFromInputStream (in, -1);
-                    break;
-                }
+                size_t index;
 
-                case CompressionType::zip:
                 {
-                    entry->storedName = filenameRoot + ".gz";
+                    std::unique_lock lock (mutex);
+                    chunkAppended.wait (lock, [&] { return aborted || nextChunkToEncode < numChunksAppended + maxChunksAhead; });
 
-                    juce::GZIPCompressorOutputStream deflater (&out, 9, false);
-                    deflater.writeFromInputStream (in, -1);
-                    break;
+                    if (aborted || nextChunkToEncode >= chunks.size())
+                        return;
+
+                    index = nextChunkToEncode++;
                 }
 
-                case CompressionType::lossless:
-                {
-                    AudioFile af (engine, f);
+                auto& toAdd = filesToAdd[index];
+                auto entry = std::make_unique<IndexEntry>();
+                entry->originalName = toAdd.filenameToUse;
+                entry->storedName = toAdd.filenameToUse;
 
-                    if (af.isOggFile() || af.isMp3File() || af.isFlacFile())
-                    {
-                        out.writeFromInputStream (in, -1); // no point re-compressing these
-                    }
-                    else
-                    {
-                        if (af.getBitsPerSample() > 24)
-                        {
-                            // FLAC can't do higher than 24 bits so just have to zip it instead..
-                            entry->storedName = filenameRoot + ".gz";
-
-                            juce::GZIPCompressorOutputStream deflater (&out, 9, false);
-                            deflater.writeFromInputStream (in, -1);
-                        }
-                        else
-                        {
-                            entry->storedName = filenameRoot + ".flac";
-
-                            if (! AudioFileUtils::convertToFormat<juce::FlacAudioFormat> (engine, f, out, 0,
-                                                                                          juce::StringPairArray()))
-                            {
-                                needToWriteIndex = true;
-                                TRACKTION_LOG_ERROR ("Failed to add file to archive flac: " + f.getFileName());
-                                return false;
-                            }
-                        }
-                    }
+                auto tempFile = engine.getTemporaryFileManager().getUniqueTempFile ("temp_archive", "tmp");
+                bool ok = false;
 
-                    break;
+                {
+                    juce::FileOutputStream out (tempFile);
+
+                    if (out.openedOk())
+                        ok = writeStoredData (engine, toAdd.file, getCompressionToUse (toAdd.file, toAdd.compression), out, *entry)
+                               && ! out.getStatus().failed();
                 }
 
-                case CompressionType::lossyGoodQuality:
-                case CompressionType::lossyMediumQuality:
-                case CompressionType::lossyLowQuality:
-                {
-                    entry->storedName = filenameRoot + ".ogg";
-                    entry->originalName = entry->storedName;  // oggs get extracted as oggs, not named back to how they were
+                const std::scoped_lock sl (mutex);
+                auto& chunk = chunks[index];
+                chunk.tempFile = tempFile;
+                chunk.entry = std::move (entry);
+                chunk.ok = ok;
+                chunk.done = true;
+                chunkDone.notify_all();
+            }
+        });
+    }
 
-                    auto quality = getOggQuality (compression);
-                    AudioFile af (engine, f);
+    // Meanwhile, the encoded files are appended to the archive in order
+    bool allOk = true;
 
-                    if (! isWorthConvertingToOgg (af, quality))
-                    {
-                        juce::FileInputStream fin (af.getFile());
+    {
+        juce::FileOutputStream out (file);
 
-                        if (! fin.openedOk())
-                        {
-                            needToWriteIndex = true;
-                            TRACKTION_LOG_ERROR ("Failed to add file to archive: " + f.getFileName());
-                            return false;
-                        }
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            auto& chunk = chunks[i];
 
-                        out.writeFromInputStream (fin, -1);
-                    }
-                    else if (! AudioFileUtils::convertToFormat<juce::OggVorbisAudioFormat> (engine, f, out, quality,
-                                                                                            juce::StringPairArray()))
-                    {
-                        needToWriteIndex = true;
-                        TRACKTION_LOG_ERROR ("Failed to add file to archive ogg: " + f.getFileName());
-                        return false;
-                    }
+            {
+                std::unique_lock lock (mutex);
 
-                    break;
-                }
+                while (! chunk.done && ! aborted)
+                    if (chunkDone.wait_for (lock, std::chrono::milliseconds (100)) == std::cv_status::timeout
+                         && shouldAbort && shouldAbort())
+                        aborted = true;
 
-                default:
-                {
-                    TRACKTION_LOG_ERROR ("Unknown compression type when archiving file: " + f.getFileName());
-                    jassertfalse;
+                if (aborted)
                     break;
-                }
             }
 
-            out.flush();
+            bool added = false;
 
-            jassert (out.getPosition() > indexOffset);
+            if (chunk.ok && out.openedOk() && writeHeaderIfNeeded (out))
+            {
+                juce::FileInputStream in (chunk.tempFile);
+                auto length = in.getTotalLength();
 
-            entry->length = std::max (juce::int64(), out.getPosition() - indexOffset);
+                if (in.openedOk() && indexOffset + length < 2147483648
+                     && out.writeFromInputStream (in, -1) == length)
+                {
+                    chunk.entry->offset = indexOffset;
+                    chunk.entry->length = length;
+                    indexOffset += length;
+                    needToWriteIndex = true;
+                    entries.add (chunk.entry.release());
+                    added = true;
+                }
+                else
+                {
+                    TRACKTION_LOG_ERROR ("Failed to add file to archive: " + filesToAdd[i].file.getFileName());
+                }
+            }
 
-            jassert (indexOffset + entry->length < 2147483648);
+            chunk.tempFile.deleteFile();
+            allOk = allOk && added;
 
-            if (indexOffset + entry->length >= 2147483648)
             {
-                out.setPosition (initialPosition);
-                out.truncate();
-                TRACKTION_LOG_ERROR ("Archive too large when archiving file: " + f.getFileName());
-                return false;
+                const std::scoped_lock sl (mutex);
+                ++numChunksAppended;
+                chunkAppended.notify_all();
             }
 
-            indexOffset += entry->length;
-            needToWriteIndex = true;
-            ok = true;
-
-            entries.add (entry.release());
+            if (onFileAdded)
+                onFileAdded (i, added);
         }
+
+        out.flush();
     }
 
-    return ok;
+    {
+        const std::scoped_lock sl (mutex);
+        aborted = true;
+        chunkAppended.notify_all();
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& chunk : chunks)
+        chunk.tempFile.deleteFile();
+
+    return allOk && numChunksAppended == chunks.size();
 }
 
 void TracktionArchiveFile::addFileInfo (const juce::String& filename,
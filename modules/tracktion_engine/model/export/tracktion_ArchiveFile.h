@@ -43,6 +43,7 @@ public:
 
     bool extractFile (int index, const juce::File& destDirectory,
                       juce::File& fileCreated, bool askBeforeOverwriting);
+    /** Extracts all the files, decoding several of them at once on background threads. */
     bool extractAll (const juce::File& destDirectory,
                      juce::Array<juce::File>& filesCreated);
     bool extractAllAsTask (const juce::File& destDirectory,
@@ -53,6 +54,33 @@ public:
     bool addFile (const juce::File&, const juce::File& rootDirectory, CompressionType);
     bool addFile (const juce::File&, const juce::String& filenameToUse, CompressionType);
 
+    /** Describes a file to add with addFiles. */
+    struct FileToAdd
+    {
+        juce::File file;
+        juce::String filenameToUse;
+        CompressionType compression = CompressionType::zip;
+    };
+
+    /** Adds a batch of files, compressing several of them at once on background threads.
+
+        Each file is compressed into a temporary file and these are appended to the
+        archive in order, so the archive ends up the same as if addFile had been
+        called for each one. Only a few files are compressed ahead of the one being
+        appended to limit the temporary disk space used.
+
+        @param onFileAdded  An optional callback, called on this thread with the index of
+                            each file and whether it was added, in the order they're passed in
+        @param shouldAbort  An optional function, polled to stop adding files early
+        @returns true if all the files were added
+    */
+    bool addFiles (const std::vector<FileToAdd>&,
+                   const std::function<void (size_t index, bool added)>& onFileAdded = {},
+                   const std::function<bool()>& shouldAbort = {});
+
+    /** Returns the name that addFile will store a file under, relative to a root directory. */
+    static juce::String getFilenameToUse (const juce::File&, const juce::File& rootDirectory);
+
     void addFileInfo (const juce::String& filename,
                       const juce::String& itemName,
                       const juce::String& itemValue);
@@ -82,6 +110,8 @@ public:
     };
 
 private:
+    friend class ExtractionTask;
+
     Engine& engine;
     juce::File file;
     int64_t indexOffset = 8;
@@ -89,6 +119,13 @@ private:
 
     juce::OwnedArray<IndexEntry> entries;
     void readIndex();
+    bool writeHeaderIfNeeded (juce::FileOutputStream&);
+    bool extractConcurrently (const juce::File& destDirectory, const juce::Array<int>& indexes,
+                              juce::Array<juce::File>& filesCreated,
+                              const std::function<bool()>& shouldAbort,
+                              const std::function<void (float)>& onProgress);
+
+    static bool writeStoredData (Engine&, const juce::File&, CompressionType, juce::OutputStream&, IndexEntry&);
 
     static int getOggQuality (CompressionType);
     static int getMagicNumber();
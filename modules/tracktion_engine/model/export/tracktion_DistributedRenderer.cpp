@@ -0,0 +1,725 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+/*  The protocol is a ValueTree per message, sent over an InterprocessConnection:
+
+    Coordinator -> worker:
+        RENDER       The Edit state, the range to render, the render settings and a MEDIA child per file it uses
+        MEDIA        A chunk of a file the worker asked for
+
+    Worker -> coordinator:
+        NEED_MEDIA   A MEDIA child for each file the worker doesn't have
+        RESULT       A chunk of the rendered segment
+        RENDER_ERROR The render failed
+*/
+namespace distributed_render
+{
+    namespace ids
+    {
+        #define DECLARE_ID(name)  static const juce::Identifier name (#name);
+        DECLARE_ID (RENDER)
+        DECLARE_ID (MEDIA)
+        DECLARE_ID (NEED_MEDIA)
+        DECLARE_ID (RESULT)
+        DECLARE_ID (RENDER_ERROR)
+        DECLARE_ID (segment)
+        DECLARE_ID (start)
+        DECLARE_ID (end)
+        DECLARE_ID (sampleRate)
+        DECLARE_ID (blockSize)
+        DECLARE_ID (usePlugins)
+        DECLARE_ID (useMasterPlugins)
+        DECLARE_ID (tracks)
+        DECLARE_ID (hash)
+        DECLARE_ID (extension)
+        DECLARE_ID (data)
+        DECLARE_ID (last)
+        DECLARE_ID (message)
+        DECLARE_ID (secret)
+        #undef DECLARE_ID
+    }
+
+    static constexpr size_t chunkSize = 4 * 1024 * 1024;
+
+    static juce::MemoryBlock toMessage (const juce::ValueTree& v)
+    {
+        juce::MemoryBlock mb;
+
+        {
+            juce::MemoryOutputStream mos (mb, false);
+            v.writeToStream (mos);
+        }
+
+        return mb;
+    }
+
+    static juce::ValueTree fromMessage (const juce::MemoryBlock& mb)
+    {
+        return juce::ValueTree::readFromData (mb.getData(), mb.getSize());
+    }
+
+    static juce::String getMediaName (const juce::String& hash, const juce::String& extension)
+    {
+        return hash + extension;
+    }
+
+    /** Media names come from the other end of a socket so they're only accepted if they're
+        a SHA-256 followed by a short file extension, otherwise they could point anywhere.
+    */
+    static bool isValidMediaName (const juce::String& hash, const juce::String& extension)
+    {
+        return hash.length() == 64
+            && hash.containsOnly ("0123456789abcdefABCDEF")
+            && extension.length() >= 2 && extension.length() <= 16
+            && extension.startsWithChar ('.')
+            && extension.substring (1).containsOnly ("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    }
+
+    /** Returns the file for a media name in the cache, if the name is valid. */
+    static std::optional<juce::File> getCacheFile (const juce::File& cacheDirectory, const juce::String& name)
+    {
+        const auto hash = name.upToFirstOccurrenceOf (".", false, false);
+        const auto extension = name.fromFirstOccurrenceOf (".", true, false);
+
+        if (! isValidMediaName (hash, extension))
+            return std::nullopt;
+
+        auto file = cacheDirectory.getChildFile (name);
+
+        if (! file.isAChildOf (cacheDirectory))
+            return std::nullopt;
+
+        return file;
+    }
+
+    /** Sends a file as a series of chunks, each made by the given function. */
+    static bool sendFileInChunks (juce::InterprocessConnection& connection, const juce::File& file,
+                                  const std::function<juce::ValueTree()>& createChunk)
+    {
+        juce::FileInputStream in (file);
+
+        if (! in.openedOk())
+            return false;
+
+        for (;;)
+        {
+            juce::MemoryBlock data;
+            const auto numRead = in.readIntoMemoryBlock (data, (juce::ssize_t) chunkSize);
+
+            auto chunk = createChunk();
+            chunk.setProperty (ids::data, data, nullptr);
+            chunk.setProperty (ids::last, in.isExhausted() || numRead == 0, nullptr);
+
+            if (! connection.sendMessage (toMessage (chunk)))
+                return false;
+
+            if (in.isExhausted() || numRead == 0)
+                return true;
+        }
+    }
+
+    static bool appendChunk (const juce::File& file, const juce::ValueTree& chunk, bool isFirstChunk = false)
+    {
+        if (auto data = chunk[ids::data].getBinaryData())
+        {
+            juce::FileOutputStream out (file);
+
+            if (isFirstChunk && out.openedOk())
+                out.truncate();
+
+            return out.openedOk() && out.write (data->getData(), data->getSize());
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+//==============================================================================
+struct DistributedRenderer::RenderState
+{
+    RenderState (const Renderer::Parameters& p, std::vector<Segment> s, juce::ValueTree state,
+                 std::map<juce::String, juce::File> media, juce::String secret)
+        : params (p), segments (std::move (s)), editState (std::move (state)), mediaFiles (std::move (media)),
+          sharedSecret (std::move (secret)),
+          segmentFiles (segments.size()), segmentFinished (segments.size(), false)
+    {
+        for (size_t i = 0; i < segments.size(); ++i)
+            pendingSegments.push_back (i);
+    }
+
+    juce::ValueTree createRenderMessage (size_t segmentIndex) const
+    {
+        using namespace distributed_render;
+        const auto range = segments[segmentIndex].getRenderRange();
+
+        juce::ValueTree v (ids::RENDER);
+        v.setProperty (ids::segment, (int) segmentIndex, nullptr);
+        v.setProperty (ids::start, range.getStart().inSeconds(), nullptr);
+        v.setProperty (ids::end, range.getEnd().inSeconds(), nullptr);
+        v.setProperty (ids::sampleRate, params.sampleRateForAudio, nullptr);
+        v.setProperty (ids::blockSize, params.blockSizeForAudio, nullptr);
+        v.setProperty (ids::usePlugins, params.usePlugins, nullptr);
+        v.setProperty (ids::useMasterPlugins, params.useMasterPlugins, nullptr);
+        v.setProperty (ids::tracks, params.tracksToDo.toString (16), nullptr);
+        v.setProperty (ids::secret, sharedSecret, nullptr);
+
+        for (auto& [name, file] : mediaFiles)
+        {
+            juce::ValueTree m (ids::MEDIA);
+            m.setProperty (ids::hash, name.upToFirstOccurrenceOf (".", false, false), nullptr);
+            m.setProperty (ids::extension, name.fromFirstOccurrenceOf (".", true, false), nullptr);
+            v.appendChild (m, nullptr);
+        }
+
+        v.appendChild (editState.createCopy(), nullptr);
+
+        return v;
+    }
+
+    void setFailed (const juce::String& error)
+    {
+        {
+            const std::scoped_lock sl (mutex);
+
+            if (errorMessage.isEmpty())
+                errorMessage = error;
+        }
+
+        condition.notify_all();
+    }
+
+    const Renderer::Parameters params;
+    const std::vector<Segment> segments;
+    const juce::ValueTree editState;
+    const std::map<juce::String, juce::File> mediaFiles;
+    const juce::String sharedSecret;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<size_t> pendingSegments;
+    std::vector<std::unique_ptr<juce::TemporaryFile>> segmentFiles;
+    std::vector<bool> segmentFinished;
+    size_t numFinished = 0;
+    int numWorkersConnected = 0;
+    juce::String errorMessage;
+};
+
+//==============================================================================
+struct DistributedRenderer::WorkerConnection  : public juce::InterprocessConnection
+{
+    WorkerConnection (RenderState& s)
+        : juce::InterprocessConnection (false), state (s)
+    {
+    }
+
+    ~WorkerConnection() override
+    {
+        disconnect();
+    }
+
+    /** Takes the next segment and sends it to the worker. */
+    void renderNextSegment()
+    {
+        std::optional<size_t> next;
+
+        {
+            const std::scoped_lock sl (state.mutex);
+
+            if (state.errorMessage.isEmpty() && ! state.pendingSegments.empty())
+            {
+                next = state.pendingSegments.front();
+                state.pendingSegments.pop_front();
+                currentSegment = next;
+                state.segmentFiles[*next] = std::make_unique<juce::TemporaryFile> (".trkaudio");
+            }
+        }
+
+        if (next && ! sendMessage (distributed_render::toMessage (state.createRenderMessage (*next))))
+            returnCurrentSegment();
+    }
+
+    void connectionMade() override
+    {
+    }
+
+    void connectionLost() override
+    {
+        returnCurrentSegment();
+
+        {
+            const std::scoped_lock sl (state.mutex);
+            --state.numWorkersConnected;
+        }
+
+        state.condition.notify_all();
+    }
+
+    void messageReceived (const juce::MemoryBlock& message) override
+    {
+        using namespace distributed_render;
+        auto v = fromMessage (message);
+
+        if (v.hasType (ids::NEED_MEDIA))
+        {
+            for (auto m : v)
+            {
+                const auto hash = m[ids::hash].toString();
+                const auto extension = m[ids::extension].toString();
+                auto found = state.mediaFiles.find (getMediaName (hash, extension));
+
+                if (found == state.mediaFiles.end()
+                    || ! sendFileInChunks (*this, found->second,
+                                           [&] { return juce::ValueTree (ids::MEDIA, { { ids::hash, hash }, { ids::extension, extension } }); }))
+                {
+                    state.setFailed (TRANS("Couldn't send media to render worker"));
+                    return;
+                }
+            }
+        }
+        else if (v.hasType (ids::RESULT))
+        {
+            const auto segment = (size_t) (int) v[ids::segment];
+            bool isFinished = false;
+
+            {
+                const std::scoped_lock sl (state.mutex);
+
+                if (currentSegment != segment || state.segmentFiles[segment] == nullptr)
+                    return;
+
+                if (! appendChunk (state.segmentFiles[segment]->getFile(), v))
+                {
+                    state.errorMessage = TRANS("Unable to write to temporary file");
+                }
+                else if (v[ids::last])
+                {
+                    state.segmentFinished[segment] = true;
+                    ++state.numFinished;
+                    currentSegment.reset();
+                    isFinished = true;
+                }
+            }
+
+            state.condition.notify_all();
+
+            if (isFinished)
+                renderNextSegment();
+        }
+        else if (v.hasType (ids::RENDER_ERROR))
+        {
+            state.setFailed (v[ids::message].toString());
+        }
+    }
+
+    void returnCurrentSegment()
+    {
+        {
+            const std::scoped_lock sl (state.mutex);
+
+            if (! currentSegment)
+                return;
+
+            state.segmentFiles[*currentSegment].reset();
+            state.pendingSegments.push_front (*currentSegment);
+            currentSegment.reset();
+        }
+
+        state.condition.notify_all();
+    }
+
+    RenderState& state;
+    std::optional<size_t> currentSegment;
+};
+
+//==============================================================================
+tl::expected<juce::File, std::string> DistributedRenderer::render (const Renderer::Parameters& params, const Options& options,
+                                                                   std::atomic<float>* progress,
+                                                                   const std::atomic<bool>* shouldCancel)
+{
+    CRASH_TRACER
+    using namespace distributed_render;
+    jassert (! juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (params.edit == nullptr || params.audioFormat == nullptr || options.workers.empty())
+        return tl::unexpected (NEEDS_TRANS("Nothing to render"));
+
+    if (params.createMidiFile || ! params.stems.empty())
+        return tl::unexpected (NEEDS_TRANS("Distributed renders can only create audio mixes"));
+
+    if (options.sharedSecret.isEmpty())
+        return tl::unexpected (NEEDS_TRANS("Distributed renders need a shared secret"));
+
+    // Take a copy of the Edit with each media file replaced by the hash of its contents.
+    // The files are found on the message thread but hashed here as that can take a while
+    juce::ValueTree editState;
+    std::vector<std::pair<juce::ValueTree, juce::File>> sourceProperties;
+
+    callBlocking ([&]
+    {
+        auto& edit = *params.edit;
+        edit.flushState();
+        editState = edit.state.createCopy();
+
+        std::function<void (juce::ValueTree)> findSources = [&] (juce::ValueTree v)
+        {
+            if (v.hasProperty (IDs::source))
+            {
+                auto file = SourceFileReference::findFileFromString (edit, v[IDs::source].toString());
+
+                if (file.existsAsFile())
+                    sourceProperties.emplace_back (v, file);
+            }
+
+            for (auto child : v)
+                findSources (child);
+        };
+
+        findSources (editState);
+    });
+
+    std::map<juce::String, juce::File> mediaFiles;
+    std::map<juce::File, juce::String> hashedFiles;
+
+    for (auto& [v, file] : sourceProperties)
+    {
+        auto& name = hashedFiles[file];
+
+        if (name.isEmpty())
+        {
+            name = getMediaName (juce::SHA256 (file).toHexString(), file.getFileExtension());
+            mediaFiles[name] = file;
+        }
+
+        v.setProperty (IDs::source, name, nullptr);
+    }
+
+    // Hand the segments out to the workers, giving them each a new one when they finish
+    const auto numSegments = options.numSegments > 0 ? options.numSegments : (int) options.workers.size() * 2;
+    RenderState state (params, ParallelRenderer::createSegments (params.time, numSegments, options.preRoll, options.crossfade),
+                       editState, std::move (mediaFiles), options.sharedSecret);
+    std::vector<std::unique_ptr<WorkerConnection>> connections;
+
+    for (auto& worker : options.workers)
+    {
+        auto connection = std::make_unique<WorkerConnection> (state);
+
+        if (! connection->connectToSocket (worker.host, worker.port, options.connectionTimeoutMs))
+            continue;
+
+        {
+            const std::scoped_lock sl (state.mutex);
+            ++state.numWorkersConnected;
+        }
+
+        connections.push_back (std::move (connection));
+    }
+
+    if (connections.empty())
+        return tl::unexpected (NEEDS_TRANS("Couldn't connect to any render workers"));
+
+    for (auto& connection : connections)
+        connection->renderNextSegment();
+
+    {
+        std::unique_lock lock (state.mutex);
+
+        for (;;)
+        {
+            if (state.numFinished == state.segments.size() || state.errorMessage.isNotEmpty())
+                break;
+
+            if (shouldCancel != nullptr && *shouldCancel)
+            {
+                state.errorMessage = NEEDS_TRANS("Cancelled");
+                break;
+            }
+
+            if (state.numWorkersConnected <= 0)
+            {
+                state.errorMessage = NEEDS_TRANS("Lost connection to the render workers");
+                break;
+            }
+
+            if (progress != nullptr)
+                *progress = 0.9f * (float) state.numFinished / (float) state.segments.size();
+
+            state.condition.wait_for (lock, std::chrono::milliseconds (100));
+        }
+    }
+
+    connections.clear();
+
+    if (state.errorMessage.isNotEmpty())
+        return tl::unexpected (state.errorMessage.toStdString());
+
+    std::vector<juce::File> segmentFiles;
+
+    for (auto& f : state.segmentFiles)
+        segmentFiles.push_back (f->getFile());
+
+    auto stitchParams = params;
+    auto result = ParallelRenderer::stitchSegments (stitchParams, state.segments, segmentFiles, progress);
+
+    if (result.failed())
+        return tl::unexpected (result.getErrorMessage().toStdString());
+
+    return params.destFile;
+}
+
+
+//==============================================================================
+//==============================================================================
+struct DistributedRenderWorker::Connection  : public juce::InterprocessConnection
+{
+    Connection (Engine& e, const juce::File& cacheDir, const juce::String& secret)
+        : juce::InterprocessConnection (true), engine (e), mediaCacheDirectory (cacheDir), sharedSecret (secret)
+    {
+    }
+
+    ~Connection() override
+    {
+        renderHandle.reset();
+        edit.reset();
+        disconnect();
+    }
+
+    bool canBeDeleted() const
+    {
+        return ! isConnected() && renderHandle == nullptr;
+    }
+
+    void connectionMade() override {}
+    void connectionLost() override
+    {
+        if (renderHandle != nullptr)
+            renderHandle->cancel();
+    }
+
+    void messageReceived (const juce::MemoryBlock& message) override
+    {
+        using namespace distributed_render;
+        auto v = fromMessage (message);
+
+        if (v.hasType (ids::RENDER))
+        {
+            if (v[ids::secret].toString() != sharedSecret)
+            {
+                sendError (TRANS("The render worker rejected the connection"));
+                disconnect();
+                return;
+            }
+
+            job = v;
+            missingMedia.clear();
+            receivingMedia.clear();
+
+            for (auto m : job)
+            {
+                if (! m.hasType (ids::MEDIA))
+                    continue;
+
+                const auto name = getMediaName (m[ids::hash].toString(), m[ids::extension].toString());
+                const auto file = getCacheFile (mediaCacheDirectory, name);
+
+                if (! file)
+                    return sendError (TRANS("Invalid media name"));
+
+                if (! file->existsAsFile())
+                    missingMedia.add (name);
+            }
+
+            if (missingMedia.isEmpty())
+            {
+                startRender();
+                return;
+            }
+
+            juce::ValueTree request (ids::NEED_MEDIA);
+
+            for (auto m : job)
+                if (m.hasType (ids::MEDIA) && missingMedia.contains (getMediaName (m[ids::hash].toString(), m[ids::extension].toString())))
+                    request.appendChild (m.createCopy(), nullptr);
+
+            sendMessage (toMessage (request));
+        }
+        else if (v.hasType (ids::MEDIA))
+        {
+            const auto hash = v[ids::hash].toString();
+            const auto name = getMediaName (hash, v[ids::extension].toString());
+
+            // Only media asked for by the current job is accepted, which also means it has a valid name
+            if (! missingMedia.contains (name))
+                return;
+
+            const auto destFile = *getCacheFile (mediaCacheDirectory, name);
+            const auto partFile = destFile.withFileExtension (destFile.getFileExtension() + ".part");
+
+            // Anything left from an interrupted transfer is overwritten by the first chunk
+            const bool isFirstChunk = ! receivingMedia.contains (name);
+            receivingMedia.addIfNotAlreadyThere (name);
+
+            if (! appendChunk (partFile, v, isFirstChunk))
+                return sendError (TRANS("Unable to write to the media cache"));
+
+            if (! v[ids::last])
+                return;
+
+            receivingMedia.removeString (name);
+
+            // Only keep files that arrived intact, otherwise they'd be used for every render after this
+            if (juce::SHA256 (partFile).toHexString() != hash || ! partFile.moveFileTo (destFile))
+            {
+                partFile.deleteFile();
+                return sendError (TRANS("Media was corrupted whilst being sent"));
+            }
+
+            missingMedia.removeString (name);
+
+            if (missingMedia.isEmpty())
+                startRender();
+        }
+    }
+
+    void startRender()
+    {
+        using namespace distributed_render;
+        CRASH_TRACER
+
+        if (renderHandle != nullptr)
+            return sendError (TRANS("A render is already in progress"));
+
+        auto editState = job.getChildWithName (IDs::EDIT).createCopy();
+
+        if (! editState.isValid())
+            return sendError (TRANS("No Edit to render"));
+
+        edit = Edit::createEdit ({ engine, editState, ProjectItemID::createNewID (0), Edit::forRendering,
+                                   nullptr, Edit::getDefaultNumUndoLevels(), {},
+                                   [dir = mediaCacheDirectory] (const juce::String& source)
+                                   {
+                                       // Sources can only refer to media in the cache, never anywhere else on the machine
+                                       return getCacheFile (dir, source).value_or (juce::File());
+                                   } });
+
+        if (edit == nullptr)
+            return sendError (TRANS("Unable to load the Edit"));
+
+        resultFile = std::make_unique<juce::TemporaryFile> (".trkaudio");
+
+        Renderer::Parameters r (*edit);
+        r.destFile = resultFile->getFile();
+        r.audioFormat = engine.getAudioFileFormatManager().getFrozenFileFormat();
+        r.bitDepth = 32;
+        r.sampleRateForAudio = job[ids::sampleRate];
+        r.blockSizeForAudio = job[ids::blockSize];
+        r.time = { TimePosition::fromSeconds ((double) job[ids::start]), TimePosition::fromSeconds ((double) job[ids::end]) };
+        r.usePlugins = job[ids::usePlugins];
+        r.useMasterPlugins = job[ids::useMasterPlugins];
+        r.tracksToDo.parseString (job[ids::tracks].toString(), 16);
+        r.canRenderInMono = false;
+        r.checkNodesForAudio = false;
+
+        renderHandle = EditRenderer::render (r, [weakThis = juce::WeakReference<Connection> (this)] (auto result)
+        {
+            juce::MessageManager::callAsync ([weakThis, result]
+            {
+                if (auto c = weakThis.get())
+                    c->renderFinished (result);
+            });
+        });
+    }
+
+    void renderFinished (tl::expected<juce::File, std::string> result)
+    {
+        using namespace distributed_render;
+        const auto segment = job[ids::segment];
+
+        if (! result)
+            sendError (juce::String (result.error()));
+        else if (! sendFileInChunks (*this, *result, [segment] { return juce::ValueTree (ids::RESULT, { { ids::segment, segment } }); }))
+            sendError (TRANS("Unable to send the rendered segment"));
+
+        renderHandle.reset();
+        edit.reset();
+        resultFile.reset();
+    }
+
+    void sendError (const juce::String& error)
+    {
+        using namespace distributed_render;
+        sendMessage (toMessage (juce::ValueTree (ids::RENDER_ERROR, { { ids::message, error } })));
+    }
+
+    Engine& engine;
+    const juce::File mediaCacheDirectory;
+    const juce::String sharedSecret;
+    juce::ValueTree job;
+    juce::StringArray missingMedia, receivingMedia;
+    std::unique_ptr<Edit> edit;
+    std::unique_ptr<juce::TemporaryFile> resultFile;
+    std::shared_ptr<EditRenderer::Handle> renderHandle;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (Connection)
+};
+
+//==============================================================================
+DistributedRenderWorker::DistributedRenderWorker (Engine& e, const juce::File& cacheDir, const juce::String& secret)
+    : engine (e), mediaCacheDirectory (cacheDir), sharedSecret (secret)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    jassert (sharedSecret.isNotEmpty() && "Workers won't start without a secret");
+    mediaCacheDirectory.createDirectory();
+}
+
+DistributedRenderWorker::~DistributedRenderWorker()
+{
+    stop();
+}
+
+bool DistributedRenderWorker::start (int port, const juce::String& bindAddress)
+{
+    // Without a secret, anyone who can reach the port could make this render
+    if (sharedSecret.isEmpty())
+        return false;
+
+    startTimer (1000);
+    return beginWaitingForSocket (port, bindAddress);
+}
+
+void DistributedRenderWorker::stop()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    juce::InterprocessConnectionServer::stop();
+    stopTimer();
+
+    const std::scoped_lock sl (connectionsMutex);
+    connections.clear();
+}
+
+juce::InterprocessConnection* DistributedRenderWorker::createConnectionObject()
+{
+    const std::scoped_lock sl (connectionsMutex);
+    connections.push_back (std::make_unique<Connection> (engine, mediaCacheDirectory, sharedSecret));
+    return connections.back().get();
+}
+
+void DistributedRenderWorker::timerCallback()
+{
+    // Connections are only removed on the message thread so none of their callbacks can be running
+    const std::scoped_lock sl (connectionsMutex);
+    std::erase_if (connections, [] (auto& c) { return c->canBeDeleted(); });
+}
+
+} // namespace tracktion::inline engine
@@ -0,0 +1,123 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Renders an Edit by splitting its timeline in to segments and rendering them on
+    other machines running a DistributedRenderWorker.
+
+    Each segment starts with some pre-roll so plugins have settled by the time the
+    part that's kept begins, and overlaps the next one so they can be crossfaded
+    together. Only the Edit's state and any media the worker doesn't already have
+    are sent over the network. Media is identified by the SHA-256 of its contents
+    so workers can keep it between renders.
+
+    The segments are rendered as 32-bit float and stitched together in to the
+    format given by the Parameters. Normalising, trimming, stems, additional
+    outputs and MIDI aren't supported.
+*/
+class DistributedRenderer
+{
+public:
+    //==============================================================================
+    /** The address of a machine running a DistributedRenderWorker. */
+    struct WorkerAddress
+    {
+        juce::String host;
+        int port = 0;
+    };
+
+    /** How to split up a render. */
+    struct Options
+    {
+        std::vector<WorkerAddress> workers;         ///< The workers to use, segments are handed out to them as they finish
+        int numSegments = 0;                        ///< The number of segments to split the render in to, 0 uses two per worker
+        TimeDuration preRoll = 2_td;                ///< How much to render before each segment and discard
+        TimeDuration crossfade = 0.05_td;           ///< How much each segment overlaps the next one by
+        int connectionTimeoutMs = 5000;             ///< How long to wait when connecting to a worker
+        juce::String sharedSecret;                  ///< Must match the secret the workers were created with and not be empty
+    };
+
+    /** A section of the timeline to render on one worker. */
+    using Segment = ParallelRenderer::Segment;
+
+    /** Renders the Edit in the Parameters to its destFile using the workers.
+        This blocks until the render has finished so should be called on a background
+        thread, not the message thread.
+        @param progress         If not nullptr, this is updated with the progress from 0 to 1
+        @param shouldCancel     If not nullptr, setting this to true stops the render
+        @returns the destFile or an error message
+    */
+    static tl::expected<juce::File, std::string> render (const Renderer::Parameters&, const Options&,
+                                                         std::atomic<float>* progress = nullptr,
+                                                         const std::atomic<bool>* shouldCancel = nullptr);
+
+private:
+    struct RenderState;
+    struct WorkerConnection;
+};
+
+
+//==============================================================================
+//==============================================================================
+/**
+    Listens for DistributedRenderers and renders segments of Edits for them.
+
+    Media sent to the worker is kept in a cache directory, named by its hash, so
+    it only has to be sent once. The worker must be created on the message thread
+    and its Engine needs to have any plugins the Edits use.
+
+    Workers only accept renders from coordinators that send the same shared secret
+    and only listen on the loopback interface unless given another address. The
+    secret isn't encrypted so workers should only be exposed on trusted networks.
+*/
+class DistributedRenderWorker   : private juce::InterprocessConnectionServer,
+                                  private juce::Timer
+{
+public:
+    /** Creates a worker that caches media in a directory and only accepts renders
+        from coordinators with the given secret. The secret must not be empty.
+    */
+    DistributedRenderWorker (Engine&, const juce::File& mediaCacheDirectory,
+                             const juce::String& sharedSecret);
+
+    /** Destructor. This cancels any renders in progress. */
+    ~DistributedRenderWorker() override;
+
+    /** Starts listening for connections on a port.
+        This fails if the worker was created with an empty secret.
+        @param bindAddress  The address of the interface to listen on. This defaults to
+                            localhost so pass an empty string to listen on all interfaces.
+    */
+    bool start (int port, const juce::String& bindAddress = "127.0.0.1");
+
+    /** Stops listening and cancels any renders in progress. */
+    void stop();
+
+private:
+    struct Connection;
+
+    Engine& engine;
+    const juce::File mediaCacheDirectory;
+    const juce::String sharedSecret;
+    std::mutex connectionsMutex;
+    std::vector<std::unique_ptr<Connection>> connections;
+
+    juce::InterprocessConnection* createConnectionObject() override;
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DistributedRenderWorker)
+};
+
+} // namespace tracktion::inline engine
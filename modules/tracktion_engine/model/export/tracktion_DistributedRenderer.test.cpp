@@ -0,0 +1,267 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+#include "../../utilities/tracktion_TestUtilities.h"
+#include "../../../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h"
+
+namespace tracktion::inline engine
+{
+
+#if ENGINE_UNIT_TESTS_RENDERING
+
+TEST_SUITE("tracktion_engine")
+{
+    TEST_CASE ("DistributedRenderer media names")
+    {
+        using namespace distributed_render;
+        const auto hash = juce::String::repeatedString ("0123456789abcdef", 4);
+        const auto cacheDir = juce::File::getSpecialLocation (juce::File::tempDirectory).getChildFile ("media_cache");
+
+        CHECK (isValidMediaName (hash, ".wav"));
+        CHECK (isValidMediaName (hash.toUpperCase(), ".flac"));
+        CHECK (! isValidMediaName (hash.dropLastCharacters (1), ".wav"));
+        CHECK (! isValidMediaName (hash.replaceCharacter ('a', 'g'), ".wav"));
+        CHECK (! isValidMediaName (hash, ""));
+        CHECK (! isValidMediaName (hash, "."));
+        CHECK (! isValidMediaName (hash, "wav"));
+        CHECK (! isValidMediaName (hash, ".wav/../../x"));
+        CHECK (! isValidMediaName (hash, ".wav.part"));
+        CHECK (! isValidMediaName (hash, "." + juce::String::repeatedString ("a", 16)));
+
+        auto file = getCacheFile (cacheDir, hash + ".wav");
+        REQUIRE (file);
+        CHECK (file->isAChildOf (cacheDir));
+
+        CHECK (! getCacheFile (cacheDir, "../../etc/passwd"));
+        CHECK (! getCacheFile (cacheDir, "/etc/passwd"));
+        CHECK (! getCacheFile (cacheDir, "../" + hash + ".wav"));
+        CHECK (! getCacheFile (cacheDir, {}));
+    }
+
+    TEST_CASE ("DistributedRenderer segment partitioning")
+    {
+        const TimeRange time { 1_tp, 11.3_tp };
+        auto segments = ParallelRenderer::createSegments (time, 7, 2_td, 0.05_td);
+        REQUIRE_EQ (segments.size(), 7u);
+        CHECK_EQ (segments.front().time.getStart(), time.getStart());
+        CHECK_EQ (segments.back().time.getEnd(), time.getEnd());
+
+        // The first segment can only pre-roll as far back as the start of the Edit
+        CHECK_EQ (segments.front().preRoll, 1_td);
+
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            auto& s = segments[i];
+            CHECK (s.time.getLength() > 0_td);
+            CHECK_EQ (s.overlap, i == segments.size() - 1 ? 0_td : 0.05_td);
+            CHECK_EQ (s.getRenderRange().getStart(), s.time.getStart() - s.preRoll);
+            CHECK_EQ (s.getRenderRange().getEnd(), s.time.getEnd() + s.overlap);
+
+            if (i > 0)
+            {
+                CHECK_EQ (s.time.getStart(), segments[i - 1].time.getEnd());
+                CHECK_EQ (s.preRoll, 2_td);
+            }
+        }
+
+        // Segments are never shorter than a second or twice the crossfade
+        CHECK_EQ (ParallelRenderer::createSegments ({ 0_tp, 3.5_tp }, 100, 2_td, 0.05_td).size(), 3u);
+        CHECK_EQ (ParallelRenderer::createSegments ({ 0_tp, 3.5_tp }, 100, 2_td, 1_td).size(), 1u);
+        CHECK_EQ (ParallelRenderer::createSegments ({ 0_tp, 3.5_tp }, 0, 2_td, 0.05_td).size(), 1u);
+    }
+
+    TEST_CASE ("DistributedRenderer segment stitching")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        const double sampleRate = 44100.0;
+        const TimeRange time { 0_tp, 6_tp };
+        auto segments = ParallelRenderer::createSegments (time, 4, 0.5_td, 0.1_td);
+        REQUIRE_EQ (segments.size(), 4u);
+
+        // The same signal as a function of the absolute sample position, so every
+        // segment agrees with its neighbours where they overlap
+        auto signal = [] (int64_t pos, int channel)
+        {
+            return 0.5f * std::sin ((float) pos * (channel == 0 ? 0.01f : 0.023f));
+        };
+
+        std::vector<std::unique_ptr<juce::TemporaryFile>> tempFiles;
+        std::vector<juce::File> segmentFiles;
+
+        for (auto& segment : segments)
+        {
+            auto& tempFile = tempFiles.emplace_back (std::make_unique<juce::TemporaryFile> (".trkaudio"));
+            segmentFiles.push_back (tempFile->getFile());
+
+            const auto range = toSamples (segment.getRenderRange(), sampleRate);
+            juce::AudioBuffer<float> buffer (2, (int) range.getLength());
+
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (c, i, signal (range.getStart() + i, c));
+
+            AudioFileWriter writer (AudioFile (engine, tempFile->getFile()), engine.getAudioFileFormatManager().getFrozenFileFormat(),
+                                    2, sampleRate, 32, {}, 0);
+            REQUIRE (writer.isOpen());
+            CHECK (writer.appendBuffer (buffer, buffer.getNumSamples()));
+        }
+
+        juce::TemporaryFile destFile (".wav");
+        Renderer::Parameters params (engine);
+        params.destFile = destFile.getFile();
+        params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+        params.bitDepth = 32;
+        params.time = time;
+        params.sampleRateForAudio = sampleRate;
+
+        auto result = ParallelRenderer::stitchSegments (params, segments, segmentFiles, nullptr);
+        CHECK (result.wasOk());
+
+        auto stitched = test_utilities::loadFileInToBuffer (engine, destFile.getFile());
+        REQUIRE (stitched);
+        CHECK_EQ (stitched->getNumChannels(), 2);
+        CHECK_EQ (stitched->getNumSamples(), toSamples (time.getLength(), sampleRate));
+
+        // Crossfading identical signals shouldn't change them and the pre-roll shouldn't be written
+        for (int c = 0; c < stitched->getNumChannels(); ++c)
+        {
+            float maxDifference = 0.0f;
+
+            for (int i = 0; i < stitched->getNumSamples(); ++i)
+                maxDifference = std::max (maxDifference, std::abs (stitched->getSample (c, i) - signal (i, c)));
+
+            CHECK (maxDifference < 0.0001f);
+        }
+    }
+
+    TEST_CASE ("DistributedRenderer loopback render")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto fileLength = 6_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto track = getAudioTracks (*edit)[0];
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        auto createParams = [&] (const juce::File& destFile)
+        {
+            Renderer::Parameters params (*edit);
+            params.destFile = destFile;
+            params.time = params.time.withLength (fileLength);
+            params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+            params.bitDepth = 32;
+            params.canRenderInMono = false;
+            return params;
+        };
+
+        juce::TemporaryFile expectedFile (".wav");
+
+        {
+            Renderer::RenderTask task ("Direct", createParams (expectedFile.getFile()), nullptr, nullptr);
+
+            while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+            {}
+
+            CHECK (task.errorMessage.isEmpty());
+        }
+
+        const auto cacheDir = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                .getNonexistentChildFile ("distributed_render_cache", {}, false);
+        DistributedRenderWorker worker (engine, cacheDir, "secret");
+
+        int port = 0;
+
+        for (int p = 50123; p < 50143 && port == 0; ++p)
+            if (worker.start (p))
+                port = p;
+
+        REQUIRE (port != 0);
+
+        auto renderDistributed = [&] (const juce::File& destFile, const juce::String& secret)
+        {
+            DistributedRenderer::Options options;
+            options.workers = { { "127.0.0.1", port } };
+            options.numSegments = 3;
+            options.sharedSecret = secret;
+
+            tl::expected<juce::File, std::string> result;
+            std::atomic<bool> finished { false };
+
+            std::thread renderThread ([&]
+            {
+                result = DistributedRenderer::render (createParams (destFile), options);
+                finished = true;
+            });
+
+            test_utilities::runDispatchLoopUntilTrue (finished);
+            renderThread.join();
+            return result;
+        };
+
+        SUBCASE ("Matches a direct render")
+        {
+            juce::TemporaryFile actualFile (".wav");
+            auto result = renderDistributed (actualFile.getFile(), "secret");
+            REQUIRE (result.has_value());
+
+            // The media should have been cached under its hash
+            CHECK_EQ (cacheDir.getNumberOfChildFiles (juce::File::findFiles, "*.wav"), 1);
+            CHECK_EQ (cacheDir.getNumberOfChildFiles (juce::File::findFiles, "*.part"), 0);
+
+            auto expected = test_utilities::loadFileInToBuffer (engine, expectedFile.getFile());
+            auto actual = test_utilities::loadFileInToBuffer (engine, actualFile.getFile());
+            REQUIRE (expected);
+            REQUIRE (actual);
+            CHECK_EQ (actual->getNumSamples(), expected->getNumSamples());
+            CHECK_EQ (actual->getNumChannels(), expected->getNumChannels());
+
+            for (int c = 0; c < std::min (actual->getNumChannels(), expected->getNumChannels()); ++c)
+            {
+                float maxDifference = 0.0f;
+
+                for (int i = 0; i < std::min (actual->getNumSamples(), expected->getNumSamples()); ++i)
+                    maxDifference = std::max (maxDifference, std::abs (actual->getSample (c, i) - expected->getSample (c, i)));
+
+                CHECK (maxDifference < 0.0001f);
+            }
+        }
+
+        SUBCASE ("Rejects the wrong secret")
+        {
+            juce::TemporaryFile actualFile (".wav");
+            auto result = renderDistributed (actualFile.getFile(), "wrong");
+            CHECK (! result.has_value());
+            CHECK_EQ (cacheDir.getNumberOfChildFiles (juce::File::findFiles, "*"), 0);
+        }
+
+        SUBCASE ("Rejects an empty secret")
+        {
+            juce::TemporaryFile actualFile (".wav");
+            auto result = renderDistributed (actualFile.getFile(), {});
+            CHECK (! result.has_value());
+            CHECK_EQ (cacheDir.getNumberOfChildFiles (juce::File::findFiles, "*"), 0);
+        }
+
+        worker.stop();
+        cacheDir.deleteRecursively();
+    }
+}
+
+#endif
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -58,7 +58,7 @@ juce::ThreadPoolJob::JobStatus ExportJob::runJob()
         copyProjectFilesToTempDir();
 
     if (archive != nullptr && ! shouldExit())
-        createArchiveFromTempFiles();
+        createArchive();
 
     if (shouldExit())
     {
@@ -108,8 +108,21 @@ void ExportJob::copyProjectFilesToTempDir()
             if (srcObject != nullptr && destObject != nullptr
                  && srcObject->getSourceFile().existsAsFile())
             {
-                auto dest = destDir.getChildFile (srcObject->getSourceFile().getFileName())
-                                   .getNonexistentSibling (true);
+                auto firstChoice = destDir.getChildFile (srcObject->getSourceFile().getFileName())
+                                          .getNonexistentSibling (true);
+                auto dest = firstChoice;
+
+                for (int suffix = 2; isAlreadyExported (dest); ++suffix)
+                    dest = firstChoice.getSiblingFile (firstChoice.getFileNameWithoutExtension()
+                                                         + " (" + juce::String (suffix) + ")"
+                                                         + firstChoice.getFileExtension());
+
+                // When archiving, the files are compressed straight from the source
+                if (addSourceFileToArchive (srcObject->getSourceFile(), dest))
+                {
+                    destObject->setSourceFile (dest);
+                    continue;
+                }
 
                 auto bytesFree = dest.getBytesFreeOnVolume();
                 auto bytesNeeded = std::max (2 * srcObject->getSourceFile().getSize(),
@@ -120,10 +133,10 @@ void ExportJob::copyProjectFilesToTempDir()
                      && ! showedSpaceWarning)
                 {
                     showedSpaceWarning = true;
-                    edit->engine.getUIBehaviour().showWarningAlert (TRANS("Exporting"),
-                                                                    TRANS("Disk space is critically low!")
-                                                                               + "\n\n"
-                                                                               + TRANS("Not all files may be exported correctly."));
+                    srcProject->engine.getUIBehaviour().showWarningAlert (TRANS("Exporting"),
+                                                                          TRANS("Disk space is critically low!")
+                                                                                     + "\n\n"
+                                                                                     + TRANS("Not all files may be exported correctly."));
                 }
 
                 if (! srcObject->getSourceFile().copyFileTo (dest))
@@ -222,11 +235,19 @@ void ExportJob::copyEditFilesToTempDir()
                     // the file we're creating as a section of the whole thing
                     auto newFile = destDir.getChildFile (newFilename);
 
-                    if (! newFile.exists())
+                    if (! isAlreadyExported (newFile))
                     {
-                        juce::File actualNewFile;
-
-                        if (! oldSourceMedia->copySectionToNewFile (newFile, actualNewFile, start, length))
+                        // Files that are used in their entirety don't need trimming so, when
+                        // archiving, they're compressed straight from the source
+                        const bool usesWholeFile = oldSourceMedia->isEdit()
+                                                    || (oldSourceMedia->isWave() && start <= 0.0
+                                                         && start + length >= oldSourceMedia->getLength());
+                        const bool addedFromSource = usesWholeFile
+                                                      && addSourceFileToArchive (oldSourceMedia->getSourceFile(), newFile);
+                        juce::File actualNewFile (newFile);
+
+                        if (! addedFromSource
+                             && ! oldSourceMedia->copySectionToNewFile (newFile, actualNewFile, start, length))
                         {
                             failedFiles.add (oldSourceMedia->getFileName());
                             TRACKTION_LOG_ERROR ("Failed to copy file during edit archive: " + newFile.getFullPathName());
@@ -243,7 +264,13 @@ void ExportJob::copyEditFilesToTempDir()
                                                                        true);
 
                             if (newSourceItem != nullptr)
+                            {
                                 newSourceItem->copyAllPropertiesFrom (*oldSourceMedia);
+
+                                // The file won't exist until it's extracted so can't be measured
+                                if (addedFromSource)
+                                    newSourceItem->setLength (oldSourceMedia->getLength());
+                            }
                         }
 
                         ++numThingsCopied;
@@ -273,7 +300,7 @@ void ExportJob::copyEditFilesToTempDir()
 }
 
 //==============================================================================
-void ExportJob::createArchiveFromTempFiles()
+void ExportJob::createArchive()
 {
     if (archive != nullptr && ! shouldExit())
     {
@@ -285,28 +312,60 @@ void ExportJob::createArchiveFromTempFiles()
 
         destDir.findChildFiles (filesForDeletion, juce::File::findFiles, true);
 
-        for (int i = 0; i < filesForDeletion.size(); ++i)
-        {
-            progress = 0.5f + 0.5f * i / filesForDeletion.size();
-
-            if (shouldExit())
-                break;
+        std::vector<TracktionArchiveFile::FileToAdd> filesToAdd;
 
+        for (auto& f : filesForDeletion)
+        {
             auto compression = TracktionArchiveFile::CompressionType::zip;
-            auto f = filesForDeletion[i];
 
             if (AudioFile (srcProject->engine, f).isValid())
                 compression = compressionType;
 
-            if (! archive->addFile (f, destDir, compression))
-                failedFiles.add (f.getFileName());
+            filesToAdd.push_back ({ f, TracktionArchiveFile::getFilenameToUse (f, destDir), compression });
         }
 
+        filesToAdd.insert (filesToAdd.end(), sourceFilesToArchive.begin(), sourceFilesToArchive.end());
+
+        archive->addFiles (filesToAdd,
+                           [this, &filesToAdd] (size_t index, bool added)
+                           {
+                               progress = 0.5f + 0.5f * (index + 1) / filesToAdd.size();
+
+                               if (! added)
+                                   failedFiles.add (filesToAdd[index].file.getFileName());
+                           },
+                           [this] { return shouldExit(); });
+
         filesForDeletion.clear();
         filesForDeletion.add (destDir);
     }
 }
 
+bool ExportJob::addSourceFileToArchive (const juce::File& source, const juce::File& destInTempDir)
+{
+    if (archive == nullptr || ! source.existsAsFile())
+        return false;
+
+    auto compression = TracktionArchiveFile::CompressionType::zip;
+
+    if (AudioFile (srcProject->engine, source).isValid())
+        compression = compressionType;
+
+    sourceFilesToArchive.push_back ({ source, TracktionArchiveFile::getFilenameToUse (destInTempDir, destDir), compression });
+    return true;
+}
+
+bool ExportJob::isAlreadyExported (const juce::File& destInTempDir) const
+{
+    if (destInTempDir.exists())
+        return true;
+
+    auto filenameToUse = TracktionArchiveFile::getFilenameToUse (destInTempDir, destDir);
+
+    return std::any_of (sourceFilesToArchive.begin(), sourceFilesToArchive.end(),
+                        [&] (auto& f) { return f.filenameToUse == filenameToUse; });
+}
+
 //==============================================================================
 float ExportJob::getCurrentTaskProgress()
 {
@@ -60,9 +60,16 @@ private:
     bool includeLibraryFiles = false;
     bool includeClips = false;
 
+    // Whole source files that go straight in to the archive, rather than being copied
+    // to the temp dir first
+    std::vector<TracktionArchiveFile::FileToAdd> sourceFilesToArchive;
+
     void copyEditFilesToTempDir();
     void copyProjectFilesToTempDir();
-    void createArchiveFromTempFiles();
+    void createArchive();
+
+    bool addSourceFileToArchive (const juce::File& source, const juce::File& destInTempDir);
+    bool isAlreadyExported (const juce::File& destInTempDir) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ExportJob)
 };
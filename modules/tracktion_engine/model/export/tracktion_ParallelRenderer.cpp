@@ -0,0 +1,318 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+std::vector<ParallelRenderer::Segment> ParallelRenderer::createSegments (TimeRange time, int numSegments,
+                                                                         TimeDuration preRoll, TimeDuration crossfade)
+{
+    // Each segment needs to be long enough to contain the crossfade from the previous one
+    const auto minLength = std::max (crossfade * 2.0, 1_td);
+    const auto maxNumSegments = std::max (1, (int) (time.getLength() / minLength));
+    numSegments = std::clamp (numSegments, 1, maxNumSegments);
+
+    std::vector<Segment> segments;
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const auto start = time.getStart() + time.getLength() * (i / (double) numSegments);
+        const auto end = i == numSegments - 1 ? time.getEnd()
+                                              : time.getStart() + time.getLength() * ((i + 1) / (double) numSegments);
+
+        Segment s;
+        s.time = { start, end };
+        s.preRoll = std::min (preRoll, toDuration (std::max (0_tp, start)));
+        s.overlap = i == numSegments - 1 ? 0_td : crossfade;
+        segments.push_back (s);
+    }
+
+    return segments;
+}
+
+juce::Result ParallelRenderer::stitchSegments (Renderer::Parameters& params,
+                                               const std::vector<Segment>& segments,
+                                               const std::vector<juce::File>& segmentFiles,
+                                               std::atomic<float>* progress)
+{
+    CRASH_TRACER
+    jassert (segments.size() == segmentFiles.size());
+
+    auto& engine = *params.engine;
+    auto& formatManager = engine.getAudioFileFormatManager();
+    const auto sampleRate = params.sampleRateForAudio;
+    const auto renderStart = toSamples (params.time.getStart(), sampleRate);
+    const auto initialProgress = progress != nullptr ? progress->load() : 0.0f;
+
+    std::unique_ptr<AudioFileWriter> writer;
+    std::vector<Ditherer> ditherers;
+    juce::AudioBuffer<float> buffer, tail;
+    const int blockSize = 65536;
+    float peak = 0.0f;
+    double rmsTotal = 0.0;
+    int64_t numSamplesWritten = 0;
+
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        auto& segment = segments[i];
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.getFrozenFileFormat()->createReaderFor (segmentFiles[i].createInputStream().release(), true));
+
+        if (reader == nullptr)
+            return juce::Result::fail (TRANS("Couldn't read a rendered segment"));
+
+        const auto numChannels = (int) reader->numChannels;
+
+        if (writer == nullptr)
+        {
+            writer = std::make_unique<AudioFileWriter> (AudioFile (engine, params.destFile), params.audioFormat,
+                                                        numChannels, sampleRate, params.bitDepth,
+                                                        params.metadata, params.quality,
+                                                        AudioFileWriteOptions::forRendering());
+
+            if (! writer->isOpen())
+                return juce::Result::fail (TRANS("Unable to write to destination file"));
+
+            if (params.ditheringEnabled && params.bitDepth < 32)
+            {
+                ditherers.resize ((size_t) numChannels);
+
+                for (auto& d : ditherers)
+                    d.reset (params.bitDepth);
+            }
+        }
+
+        // The segment's pre-roll is skipped, its body written and the overlap kept to crossfade with the next one
+        const auto bodyStart = toSamples (segment.time.getStart(), sampleRate) - renderStart;
+        const auto bodyEnd = toSamples (segment.time.getEnd(), sampleRate) - renderStart;
+        const auto preRollLength = toSamples (segment.preRoll, sampleRate);
+        const auto overlapLength = (int) toSamples (segment.overlap, sampleRate);
+        const auto fadeInLength = tail.getNumSamples();
+        auto readPos = preRollLength;
+
+        for (auto pos = bodyStart; pos < bodyEnd;)
+        {
+            const auto numThisTime = (int) std::min ((int64_t) blockSize, bodyEnd - pos);
+            buffer.setSize (numChannels, numThisTime, false, false, true);
+            reader->read (&buffer, 0, numThisTime, readPos, true, true);
+
+            // Crossfade the start of the body with the end of the previous segment
+            if (const auto offsetInFade = (int) (pos - bodyStart); offsetInFade < fadeInLength)
+            {
+                const auto numToFade = std::min (numThisTime, fadeInLength - offsetInFade);
+
+                for (int c = 0; c < numChannels; ++c)
+                {
+                    auto dest = buffer.getWritePointer (c);
+                    auto src = tail.getReadPointer (std::min (c, tail.getNumChannels() - 1));
+
+                    for (int s = 0; s < numToFade; ++s)
+                    {
+                        const auto gain = (float) (offsetInFade + s) / (float) fadeInLength;
+                        dest[s] = dest[s] * gain + src[offsetInFade + s] * (1.0f - gain);
+                    }
+                }
+            }
+
+            peak = std::max (peak, buffer.getMagnitude (0, numThisTime));
+
+            for (int c = 0; c < numChannels; ++c)
+                rmsTotal += buffer.getRMSLevel (c, 0, numThisTime) * numThisTime / numChannels;
+
+            for (int c = 0; c < (int) ditherers.size(); ++c)
+                ditherers[(size_t) c].process (buffer.getWritePointer (c), numThisTime);
+
+            if (! writer->appendBuffer (buffer, numThisTime))
+                return juce::Result::fail (TRANS("Unable to write to destination file"));
+
+            pos += numThisTime;
+            readPos += numThisTime;
+            numSamplesWritten += numThisTime;
+        }
+
+        tail.setSize (numChannels, overlapLength, false, false, true);
+
+        if (overlapLength > 0)
+            reader->read (&tail, 0, overlapLength, readPos, true, true);
+
+        if (progress != nullptr)
+            *progress = initialProgress + (1.0f - initialProgress) * (float) (i + 1) / (float) segments.size();
+    }
+
+    params.resultMagnitude = peak;
+    params.resultRMS = numSamplesWritten > 0 ? (float) (rmsTotal / (double) numSamplesWritten) : 0.0f;
+    params.resultAudioDuration = float (numSamplesWritten / sampleRate);
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+bool ParallelRenderer::canRenderInParallel (const Renderer::Parameters& r,
+                                            juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver* thumbnail)
+{
+    // The segments create their graphs on the message thread so it can't be blocked waiting for them
+    if (juce::MessageManager::existsAndIsCurrentThread() && ! shouldRunMessageThreadCallbacksOnCallingThread())
+        return false;
+
+    return r.numParallelSegments > 1
+        && r.edit != nullptr
+        && r.audioFormat != nullptr
+        && thumbnail == nullptr
+        && ! r.time.isEmpty()
+        && ! r.createMidiFile
+        && r.stems.empty()
+        && r.additionalOutputs.empty()
+        && r.streamingOutputs.empty()
+        && ! r.realTimeRender
+        && ! r.trimSilenceAtEnds
+        && ! r.shouldNormalise
+        && ! r.shouldNormaliseByRMS
+        && ! r.shouldNormaliseByLoudness
+        && r.endAllowance == 0_td;
+}
+
+juce::Result ParallelRenderer::render (Renderer::Parameters& params,
+                                       std::atomic<float>* progress,
+                                       std::function<bool()> shouldCancel)
+{
+    CRASH_TRACER
+    jassert (canRenderInParallel (params));
+
+    auto& engine = *params.engine;
+    const auto segments = createSegments (params.time, params.numParallelSegments,
+                                          params.parallelPreRoll, params.parallelCrossfade);
+
+    struct SegmentRender
+    {
+        std::unique_ptr<Edit> edit;
+        juce::TemporaryFile file { ".trkaudio" };
+        std::atomic<float> progress { 0.0f };
+        juce::String error;
+    };
+
+    std::vector<std::unique_ptr<SegmentRender>> renders;
+
+    for (size_t i = 0; i < segments.size(); ++i)
+        renders.push_back (std::make_unique<SegmentRender>());
+
+    // Each segment renders its own copy of the Edit so no plugins are shared between threads
+    try
+    {
+        callBlocking ([&]
+        {
+            auto& edit = *params.edit;
+            edit.flushState();
+
+            for (auto& r : renders)
+                r->edit = Edit::createEdit ({ engine, edit.state.createCopy(), edit.getProjectItemID(), Edit::forRendering,
+                                              nullptr, Edit::getDefaultNumUndoLevels(),
+                                              edit.editFileRetriever, edit.filePathResolver });
+        });
+    }
+    catch (std::runtime_error&)
+    {
+        return juce::Result::fail (TRANS("Couldn't copy the Edit to render"));
+    }
+
+    std::atomic<bool> cancelled { false };
+    std::atomic<size_t> numFinished { 0 };
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        auto& r = *renders[i];
+
+        if (r.edit == nullptr)
+        {
+            r.error = TRANS("Couldn't copy the Edit to render");
+            ++numFinished;
+            continue;
+        }
+
+        Renderer::Parameters p (params);
+        p.engine = &engine;
+        p.edit = r.edit.get();
+        p.allowedClips.clear();
+
+        for (auto clip : params.allowedClips)
+            if (auto c = findClipForID (*r.edit, clip->itemID))
+                p.allowedClips.add (c);
+
+        p.destFile = r.file.getFile();
+        p.audioFormat = engine.getAudioFileFormatManager().getFrozenFileFormat();
+        p.bitDepth = 32;
+        p.time = segments[i].getRenderRange();
+        p.canRenderInMono = false;
+        p.checkNodesForAudio = false;
+        p.ditheringEnabled = false;
+        p.metadata = {};
+        p.quality = 0;
+        p.numParallelSegments = 0;
+
+        threads.emplace_back ([&r, p, &cancelled, &numFinished]
+        {
+            {
+                Renderer::RenderTask task ("Render segment", p, &r.progress, nullptr);
+
+                while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+                    if (cancelled)
+                        break;
+
+                r.error = task.errorMessage;
+            }
+
+            ++numFinished;
+        });
+    }
+
+    while (numFinished < segments.size())
+    {
+        if (shouldCancel && shouldCancel())
+            cancelled = true;
+
+        if (progress != nullptr)
+        {
+            float total = 0.0f;
+
+            for (auto& r : renders)
+                total += r->progress;
+
+            *progress = 0.9f * total / (float) renders.size();
+        }
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (50));
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    callBlockingCatching ([&]
+    {
+        for (auto& r : renders)
+            r->edit.reset();
+    });
+
+    if (cancelled)
+        return juce::Result::fail (TRANS("Render cancelled"));
+
+    std::vector<juce::File> segmentFiles;
+
+    for (auto& r : renders)
+    {
+        if (r->error.isNotEmpty())
+            return juce::Result::fail (r->error);
+
+        segmentFiles.push_back (r->file.getFile());
+    }
+
+    return stitchSegments (params, segments, segmentFiles, progress);
+}
+
+} // namespace tracktion::inline engine
@@ -0,0 +1,79 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Renders an Edit by splitting its timeline in to segments and rendering each
+    one on its own thread with its own copy of the Edit.
+
+    Each segment starts with some pre-roll so plugins have settled by the time the
+    part that's kept begins, and overlaps the next one so they can be crossfaded
+    together. Plugins that aren't deterministic, or that depend on more history
+    than the pre-roll, can sound slightly different either side of a boundary.
+
+    This is used by Renderer::RenderTask when Parameters::numParallelSegments is
+    greater than 1 and the render is supported. @see canRenderInParallel
+*/
+class ParallelRenderer
+{
+public:
+    //==============================================================================
+    /** A section of the timeline rendered independently of the others. */
+    struct Segment
+    {
+        TimeRange time;                             ///< The part of the render this segment produces, before any overlap
+        TimeDuration preRoll;                       ///< The amount rendered before the time and discarded
+        TimeDuration overlap;                       ///< The amount rendered after the time to crossfade with the next segment
+
+        /** Returns the range of the Edit that needs rendering for this segment. */
+        TimeRange getRenderRange() const            { return { time.getStart() - preRoll, time.getEnd() + overlap }; }
+    };
+
+    /** Splits a time range in to segments.
+        The number of segments may be reduced so each one is longer than its crossfade.
+    */
+    static std::vector<Segment> createSegments (TimeRange, int numSegments, TimeDuration preRoll, TimeDuration crossfade);
+
+    /** Joins rendered segments together, crossfading their overlaps, and writes the
+        result to the destFile in the format the Parameters specify.
+        The peak, RMS and duration results in the Parameters are updated.
+        @param segmentFiles     A file for each segment, in the engine's frozen file format
+        @param progress         If not nullptr, this is moved from its current value to 1
+    */
+    static juce::Result stitchSegments (Renderer::Parameters&,
+                                        const std::vector<Segment>&,
+                                        const std::vector<juce::File>& segmentFiles,
+                                        std::atomic<float>* progress);
+
+    //==============================================================================
+    /** Returns true if a render can be split in to segments.
+        MIDI, stem, real-time and thumbnail-updating renders, along with normalising,
+        trimming, end allowances, additional and streaming outputs aren't supported.
+    */
+    static bool canRenderInParallel (const Renderer::Parameters&,
+                                     juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver* thumbnail = nullptr);
+
+    /** Renders Parameters::numParallelSegments segments at once and stitches them
+        together in to the destFile.
+        This blocks until the render has finished and mustn't be called on the
+        message thread unless callbacks are being run on the calling thread.
+        @param progress         If not nullptr, this is updated with the progress from 0 to 1
+        @param shouldCancel     If this returns true, the render is stopped
+    */
+    static juce::Result render (Renderer::Parameters&,
+                                std::atomic<float>* progress,
+                                std::function<bool()> shouldCancel);
+};
+
+} // namespace tracktion::inline engine
@@ -202,6 +202,31 @@ AudioFile RenderManager::getAudioFileForHash (Engine& engine, const juce::File&
     return AudioFile (engine, directory.getChildFile (getFileRenderPrefix() + juce::String (hash) + ".wav"));
 }
 
+AudioFile RenderManager::findCachedTrackRender (const Track& track, HashCode hash, const juce::String& fileExtension)
+{
+    auto cachedFile = TemporaryFileManager::getFileForCachedTrackRender (track, hash, fileExtension);
+
+    if (cachedFile.getFile().existsAsFile())
+        return cachedFile;
+
+    return AudioFile (track.edit.engine);
+}
+
+bool RenderManager::addCachedTrackRender (const Track& track, HashCode hash, const juce::File& renderedFile)
+{
+    CRASH_TRACER
+    auto cachedFile = TemporaryFileManager::getFileForCachedTrackRender (track, hash, renderedFile.getFileExtension()).getFile();
+
+    // Remove any older renders of this track as they'll never be used again
+    const auto prefix = cachedFile.getFileName().upToLastOccurrenceOf ("_", true, false);
+
+    for (auto entry : juce::RangedDirectoryIterator (cachedFile.getParentDirectory(), false, prefix + "*"))
+        if (entry.getFile() != cachedFile)
+            AudioFile (track.edit.engine, entry.getFile()).deleteFile();
+
+    return renderedFile.copyFileTo (cachedFile);
+}
+
 juce::ReferenceCountedArray<RenderManager::Job> RenderManager::getRenderJobsWithoutCreating (const AudioFile& af)
 {
     juce::ReferenceCountedArray<Job> js;
@@ -160,6 +160,19 @@ public:
     /** Returns the number of jobs in the pool. */
     int getNumJobs() noexcept;
 
+    //==============================================================================
+    /** Returns a previously rendered file for a track with the given hash, or an
+        invalid AudioFile if there isn't one.
+        Renders are cached in the Edit's temp directory so persist between sessions.
+        @see Renderer::Parameters::useRenderCache
+    */
+    static AudioFile findCachedTrackRender (const Track&, HashCode, const juce::String& fileExtension);
+
+    /** Copies a rendered file in to the cache for a track, replacing any renders
+        of the track with different hashes.
+    */
+    static bool addCachedTrackRender (const Track&, HashCode, const juce::File& renderedFile);
+
     //==============================================================================
     /** Returns the prefix used for render files. */
     static juce::StringRef getFileRenderPrefix()      { return "render_"; }
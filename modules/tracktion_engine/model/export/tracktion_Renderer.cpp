@@ -20,22 +20,31 @@ void Renderer::turnOffAllPlugins (Edit& edit)
 
 namespace render_utils
 {
-    std::unique_ptr<Renderer::RenderTask> createRenderTask (Renderer::Parameters r, juce::String desc,
-                                                            std::atomic<float>* progressToUpdate,
-                                                            juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver* thumbnail)
+    juce::Array<Track*> getStemTracks (const Renderer::Parameters& r)
+    {
+        juce::Array<Track*> tracks;
+
+        for (auto& stem : r.stems)
+            if (stem.track != nullptr)
+                tracks.addIfNotAlreadyThere (stem.track);
+
+        return tracks;
+    }
+
+    std::unique_ptr<tracktion::graph::Node> createNode (const Renderer::Parameters& r, ProcessState& processState)
     {
         auto tracksToDo = toTrackArray (*r.edit, r.tracksToDo);
+        auto stemTracks = getStemTracks (r);
 
-        // Initialise playhead and continuity
-        auto playHead = std::make_unique<tracktion::graph::PlayHead>();
-        auto playHeadState = std::make_unique<tracktion::graph::PlayHeadState> (*playHead);
-        auto processState = std::make_unique<ProcessState> (*playHeadState, r.edit->tempoSequence);
+        if (! stemTracks.isEmpty())
+            tracksToDo = stemTracks;
 
-        CreateNodeParams cnp { *processState };
+        CreateNodeParams cnp { processState };
         cnp.sampleRate = r.sampleRateForAudio;
         cnp.blockSize = r.blockSizeForAudio;
         cnp.allowedClips = r.allowedClips.isEmpty() ? nullptr : &r.allowedClips;
-        cnp.allowedTracks = r.tracksToDo.isZero() ? nullptr : &tracksToDo;
+        cnp.allowedTracks = (r.tracksToDo.isZero() && stemTracks.isEmpty()) ? nullptr : &tracksToDo;
+        cnp.stemTracks = stemTracks.isEmpty() ? nullptr : &stemTracks;
         cnp.forRendering = true;
         cnp.includePlugins = r.usePlugins;
         cnp.includeMasterPlugins = r.useMasterPlugins;
@@ -44,6 +53,33 @@ namespace render_utils
 
         std::unique_ptr<tracktion::graph::Node> node;
         callBlocking ([&r, &node, &cnp] { node = createNodeForEdit (*r.edit, cnp); });
+        return node;
+    }
+
+    std::vector<HashCode> getStemRenderHashes (const Renderer::Parameters& r)
+    {
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState (playHead);
+        ProcessState processState (playHeadState, r.edit->tempoSequence);
+
+        std::vector<HashCode> hashes (r.stems.size(), 0);
+
+        if (auto node = createNode (r, processState))
+            callBlocking ([&] { hashes = NodeRenderContext::getStemRenderHashes (*node, r); });
+
+        return hashes;
+    }
+
+    std::unique_ptr<Renderer::RenderTask> createRenderTask (Renderer::Parameters r, juce::String desc,
+                                                            std::atomic<float>* progressToUpdate,
+                                                            juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver* thumbnail)
+    {
+        // Initialise playhead and continuity
+        auto playHead = std::make_unique<tracktion::graph::PlayHead>();
+        auto playHeadState = std::make_unique<tracktion::graph::PlayHeadState> (*playHead);
+        auto processState = std::make_unique<ProcessState> (*playHeadState, r.edit->tempoSequence);
+
+        auto node = createNode (r, *processState);
 
         if (! node)
             return {};
@@ -52,6 +88,20 @@ namespace render_utils
                                                        std::move (node), std::move (playHead), std::move (playHeadState), std::move (processState),
                                                        progressToUpdate, thumbnail);
     }
+
+    void runRenderTask (Engine& engine, Renderer::RenderTask& task)
+    {
+        // With no UI to show a progress bar, just render on this thread
+        if (engine.getEngineBehaviour().isHeadlessBatchMode())
+        {
+            while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+            {}
+
+            return;
+        }
+
+        engine.getUIBehaviour().runTaskWithProgressBar (task);
+    }
 }
 
 //==============================================================================
@@ -127,6 +177,10 @@ Renderer::RenderTask::RenderTask (const juce::String& taskDescription,
       sourceToUpdate (source)
 {
     auto tracksToDo = toTrackArray (*r.edit, r.tracksToDo);
+    auto stemTracks = render_utils::getStemTracks (r);
+
+    if (! stemTracks.isEmpty())
+        tracksToDo = stemTracks;
 
     // Initialise playhead and continuity
     playHead = std::make_unique<tracktion::graph::PlayHead>();
@@ -137,7 +191,8 @@ Renderer::RenderTask::RenderTask (const juce::String& taskDescription,
     cnp.sampleRate = r.sampleRateForAudio;
     cnp.blockSize = r.blockSizeForAudio;
     cnp.allowedClips = r.allowedClips.isEmpty() ? nullptr : &r.allowedClips;
-    cnp.allowedTracks = r.tracksToDo.isZero() ? nullptr : &tracksToDo;
+    cnp.allowedTracks = (r.tracksToDo.isZero() && stemTracks.isEmpty()) ? nullptr : &tracksToDo;
+    cnp.stemTracks = stemTracks.isEmpty() ? nullptr : &stemTracks;
     cnp.forRendering = true;
     cnp.includePlugins = r.usePlugins;
     cnp.includeMasterPlugins = r.useMasterPlugins;
@@ -177,6 +232,8 @@ juce::ThreadPoolJob::JobStatus Renderer::RenderTask::runJob()
 
     if (params.createMidiFile)
         renderMidi (params);
+    else if (! params.stems.empty())
+        renderStems (params);
     else if (! renderAudio (params))
         return jobNeedsRunningAgain;
 
@@ -184,78 +241,153 @@ juce::ThreadPoolJob::JobStatus Renderer::RenderTask::runJob()
 }
 
 //==============================================================================
+static SampleRange findNonSilentRange (const juce::AudioBuffer<float>& audio, float maxZeroLevelDb)
+{
+    const auto maxZeroLevel = 2.0f * dbToGain (maxZeroLevelDb);
+    const auto numSamples = audio.getNumSamples();
+    int firstNonZero = numSamples, lastNonZero = -1;
+
+    for (int chan = audio.getNumChannels(); --chan >= 0;)
+    {
+        auto samples = audio.getReadPointer (chan);
+
+        for (int i = 0; i < firstNonZero; ++i)
+        {
+            if (std::abs (samples[i]) > maxZeroLevel)
+            {
+                firstNonZero = i;
+                break;
+            }
+        }
+
+        for (int i = numSamples; --i > lastNonZero;)
+        {
+            if (std::abs (samples[i]) > maxZeroLevel)
+            {
+                lastNonZero = i;
+                break;
+            }
+        }
+    }
+
+    if (lastNonZero < firstNonZero)
+        return {};
+
+    return { firstNonZero, lastNonZero + 1 };
+}
+
 bool Renderer::RenderTask::performNormalisingAndTrimming (const Renderer::Parameters& target,
-                                                          const Renderer::Parameters& intermediate)
+                                                          const Renderer::Parameters& intermediate,
+                                                          juce::AudioBuffer<float>& audio)
 {
     CRASH_TRACER
+    auto range = SampleRange (0, audio.getNumSamples());
 
     if (target.trimSilenceAtEnds)
     {
         setJobName (TRANS("Trimming silence") + "...");
         progress = 0.94f;
 
-        auto doneRange = AudioFileUtils::trimSilence (params.edit->engine, intermediate.destFile, -70.0f);
+        range = findNonSilentRange (audio, -70.0f);
 
-        if (doneRange.getLength() == 0)
+        if (range.getLength() == 0)
         {
             errorMessage = TRANS("The rendered section was completely silent - no file was produced");
             return false;
         }
-
-        AudioFileUtils::applyBWAVStartTime (intermediate.destFile,
-                                            (SampleCount) tracktion::toSamples (intermediate.time.getStart(), intermediate.sampleRateForAudio)
-                                               + doneRange.getStart());
     }
 
-    if (target.shouldNormalise || target.shouldNormaliseByRMS)
+    if (target.shouldNormalise || target.shouldNormaliseByRMS || target.shouldNormaliseByLoudness)
         setJobName (TRANS("Normalising") + "...");
 
-    std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (params.edit->engine,
-                                                                                      intermediate.destFile));
-
-    if (reader == nullptr)
+    if (audio.getNumChannels() == 0)
     {
         errorMessage = TRANS("Couldn't read intermediate file");
         return false;
     }
 
-    AudioFileWriter writer (AudioFile (params.edit->engine, target.destFile),
-                            target.audioFormat, (int) reader->numChannels, target.sampleRateForAudio,
-                            target.bitDepth, target.metadata, target.quality);
-
-    if (! writer.isOpen())
-    {
-        errorMessage = TRANS("Couldn't write to target file");
-        return false;
-    }
-
     progress = 0.96f;
     float gain = 1.0f;
 
-    if (target.shouldNormaliseByRMS)
+    if (target.shouldNormaliseByLoudness)
+    {
+        // Silence can't be normalised so is left as it is
+        if (intermediate.resultIntegratedLoudness > LoudnessMeter::minLoudness)
+        {
+            const auto maxGainDb = target.maxTruePeakDb - intermediate.resultTruePeakDb;
+            gain = juce::jlimit (0.0f, 100.0f, dbToGain (std::min (target.normaliseToLevelDb - intermediate.resultIntegratedLoudness, maxGainDb)));
+        }
+    }
+    else if (target.shouldNormaliseByRMS)
         gain = juce::jlimit (0.0f, 100.0f, dbToGain (target.normaliseToLevelDb) / (intermediate.resultRMS + 2.0f / 32768.0f));
     else if (target.shouldNormalise)
         gain = juce::jlimit (0.0f, 100.0f, dbToGain (target.normaliseToLevelDb) * (1.0f / (intermediate.resultMagnitude * 1.005f + 2.0f / 32768.0f)));
 
-    Ditherers ditherers ((int) reader->numChannels, target.bitDepth);
-
-    const int blockSize = 16384;
-    juce::AudioBuffer<float> tempBuffer ((int) reader->numChannels, blockSize + 256);
+    std::vector<AdditionalOutput> outputs { { target.destFile, target.audioFormat, target.bitDepth,
+                                              target.quality, target.ditheringEnabled } };
+    outputs.insert (outputs.end(), target.additionalOutputs.begin(), target.additionalOutputs.end());
 
-    for (SampleCount pos = 0; pos < reader->lengthInSamples;)
+    // The intermediate audio is memory-mapped and only read here, so each output
+    // can take its own copy of each block to process and hand to its encoder
+    auto writeOutput = [&] (const AdditionalOutput& output)
     {
-        auto numLeft = reader->lengthInSamples - pos;
-        auto samps = int (std::min (juce::int64 (tempBuffer.getNumSamples()), std::min (juce::int64 (blockSize), numLeft)));
+        if (output.audioFormat == nullptr)
+            return false;
+
+        AudioFileWriter writer (AudioFile (params.edit->engine, output.destFile),
+                                output.audioFormat, audio.getNumChannels(), target.sampleRateForAudio,
+                                output.bitDepth, target.metadata, output.quality,
+                                AudioFileWriteOptions::forRendering());
 
-        reader->read (&tempBuffer, 0, samps, pos, true, reader->numChannels > 1);
+        if (! writer.isOpen())
+            return false;
 
-        tempBuffer.applyGain (0, samps, gain);
+        Ditherers ditherers (audio.getNumChannels(), output.bitDepth);
+        const int blockSize = 16384;
+        juce::AudioBuffer<float> block (audio.getNumChannels(), blockSize);
 
-        if (target.ditheringEnabled && target.bitDepth < 32)
-            ditherers.apply (tempBuffer, samps);
+        for (auto pos = range.getStart(); pos < range.getEnd();)
+        {
+            auto samps = (int) std::min ((SampleCount) blockSize, range.getEnd() - pos);
 
-        writer.appendBuffer (tempBuffer, samps);
-        pos += samps;
+            for (int i = 0; i < audio.getNumChannels(); ++i)
+                block.copyFrom (i, 0, audio.getReadPointer (i, (int) pos), samps, gain);
+
+            if (output.ditheringEnabled && output.bitDepth < 32)
+                ditherers.apply (block, samps);
+
+            if (! writer.appendBuffer (block, samps))
+                return false;
+
+            pos += samps;
+        }
+
+        writer.closeForWriting();
+
+        if (target.trimSilenceAtEnds)
+            AudioFileUtils::applyBWAVStartTime (output.destFile,
+                                                (SampleCount) tracktion::toSamples (intermediate.time.getStart(), intermediate.sampleRateForAudio)
+                                                   + range.getStart());
+
+        return true;
+    };
+
+    // Each format is encoded on its own thread as the encoders are independent
+    std::vector<char> succeeded (outputs.size(), 0);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < outputs.size(); ++i)
+        threads.emplace_back ([&, i] { succeeded[i] = writeOutput (outputs[i]) ? 1 : 0; });
+
+    succeeded[0] = writeOutput (outputs[0]) ? 1 : 0;
+
+    for (auto& t : threads)
+        t.join();
+
+    if (std::find (succeeded.begin(), succeeded.end(), 0) != succeeded.end())
+    {
+        errorMessage = TRANS("Couldn't write to target file");
+        return false;
     }
 
     return true;
@@ -266,6 +398,17 @@ bool Renderer::RenderTask::renderAudio (Renderer::Parameters& r)
 {
     CRASH_TRACER
 
+    if (! nodeRenderContext && ParallelRenderer::canRenderInParallel (r, sourceToUpdate))
+    {
+        auto result = ParallelRenderer::render (r, &progress, [this] { return shouldExit(); });
+
+        if (result.failed())
+            errorMessage = result.getErrorMessage();
+
+        progress = 1.0f;
+        return true;
+    }
+
     if (! nodeRenderContext)
     {
         try
@@ -365,6 +508,18 @@ bool Renderer::RenderTask::renderMidi (Renderer::Parameters& r)
     return errorMessage.isEmpty();
 }
 
+bool Renderer::RenderTask::renderStems (Renderer::Parameters& r)
+{
+    CRASH_TRACER
+    errorMessage = NodeRenderContext::renderStems (*this, r,
+                                                   std::move (graphNode),
+                                                   std::move (playHead),
+                                                   std::move (playHeadState),
+                                                   std::move (processState),
+                                                   progress);
+    return errorMessage.isEmpty();
+}
+
 bool Renderer::RenderTask::addMidiMetaDataAndWriteToFile (juce::File destFile, juce::MidiMessageSequence outputSequence, const TempoSequence& tempoSequence)
 {
     outputSequence.updateMatchedPairs();
@@ -467,7 +622,7 @@ bool Renderer::renderToFile (const juce::String& taskDescription,
         {
             if (useThread)
             {
-                engine.getUIBehaviour().runTaskWithProgressBar (*task);
+                render_utils::runRenderTask (engine, *task);
             }
             else
             {
@@ -507,7 +662,7 @@ juce::File Renderer::renderToFile (const juce::String& taskDescription, const Pa
 
         if (auto task = render_utils::createRenderTask (r, taskDescription, nullptr, nullptr))
         {
-            ui.runTaskWithProgressBar (*task);
+            render_utils::runRenderTask (*r.engine, *task);
             turnOffAllPlugins (*r.edit);
 
             if (r.destFile.existsAsFile())
@@ -534,6 +689,87 @@ juce::File Renderer::renderToFile (const juce::String& taskDescription, const Pa
     return {};
 }
 
+juce::Array<juce::File> Renderer::renderStemsToFiles (const juce::String& taskDescription, const Parameters& r)
+{
+    CRASH_TRACER
+
+    jassert (r.sampleRateForAudio > 7000);
+    jassert (r.edit != nullptr);
+    jassert (r.engine != nullptr);
+    jassert (! r.stems.empty());
+
+    TransportControl::stopAllTransports (*r.engine, false, true);
+
+    turnOffAllPlugins (*r.edit);
+
+    juce::Array<juce::File> renderedFiles;
+    auto& ui = r.edit->engine.getUIBehaviour();
+
+    // Copy any stems that have already been rendered from the cache and only render the rest
+    auto toRender = r;
+    std::vector<HashCode> hashesToRender;
+
+    if (r.useRenderCache)
+    {
+        const auto hashes = render_utils::getStemRenderHashes (r);
+        const auto fileExtension = r.audioFormat != nullptr ? r.audioFormat->getFileExtensions()[0] : juce::String (".wav");
+        toRender.stems.clear();
+
+        for (size_t i = 0; i < r.stems.size(); ++i)
+        {
+            auto& stem = r.stems[i];
+
+            if (hashes[i] != 0)
+            {
+                auto cachedFile = RenderManager::findCachedTrackRender (*stem.track, hashes[i], fileExtension);
+
+                if (cachedFile.isValid() && cachedFile.getFile().copyFileTo (stem.destFile))
+                    continue;
+            }
+
+            toRender.stems.push_back (stem);
+            hashesToRender.push_back (hashes[i]);
+        }
+
+        if (toRender.stems.empty())
+        {
+            for (auto& stem : r.stems)
+                renderedFiles.add (stem.destFile);
+
+            return renderedFiles;
+        }
+    }
+
+    if (auto task = render_utils::createRenderTask (toRender, taskDescription, nullptr, nullptr))
+    {
+        render_utils::runRenderTask (*r.engine, *task);
+        turnOffAllPlugins (*r.edit);
+
+        if (task->errorMessage.isNotEmpty())
+        {
+            for (auto& stem : r.stems)
+                stem.destFile.deleteFile();
+
+            ui.showWarningMessage (task->errorMessage);
+            return {};
+        }
+
+        for (size_t i = 0; i < hashesToRender.size(); ++i)
+            if (hashesToRender[i] != 0 && toRender.stems[i].destFile.existsAsFile())
+                RenderManager::addCachedTrackRender (*toRender.stems[i].track, hashesToRender[i], toRender.stems[i].destFile);
+
+        for (auto& stem : r.stems)
+            if (stem.destFile.existsAsFile())
+                renderedFiles.add (stem.destFile);
+    }
+    else
+    {
+        ui.showWarningMessage (TRANS("Couldn't render, as the selected region was empty"));
+    }
+
+    return renderedFiles;
+}
+
 ProjectItem::Ptr Renderer::renderToProjectItem (const juce::String& taskDescription, const Parameters& r, ProjectItem::Category category)
 {
     CRASH_TRACER
@@ -608,7 +844,7 @@ Renderer::Statistics Renderer::measureStatistics (const juce::String& taskDescri
 
         if (auto task = render_utils::createRenderTask (r, taskDescription, nullptr, nullptr))
         {
-            edit.engine.getUIBehaviour().runTaskWithProgressBar (*task);
+            render_utils::runRenderTask (edit.engine, *task);
 
             result.peak          = task->params.resultMagnitude;
             result.average       = task->params.resultRMS;
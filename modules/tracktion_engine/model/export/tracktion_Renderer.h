@@ -29,6 +29,55 @@ struct ProcessState;
 class Renderer
 {
 public:
+    //==============================================================================
+    /**
+        A track to render to its own file.
+        @see Parameters::stems
+    */
+    struct Stem
+    {
+        Track* track = nullptr;                                 ///< The track to render, this must output to a device rather than another track
+        juce::File destFile;                                    ///< The file to write this track's output to
+    };
+
+    //==============================================================================
+    /**
+        An extra file to write a render to, with its own format.
+        @see Parameters::additionalOutputs
+    */
+    struct AdditionalOutput
+    {
+        juce::File destFile;                                    ///< The file to write to, must be writable
+        juce::AudioFormat* audioFormat = nullptr;               ///< The AudioFormat to use
+        int bitDepth = 16;                                      ///< The bit depth to use
+        int quality = 0;                                        ///< For audio formats that support it, the desired quality index
+        bool ditheringEnabled = false;                          ///< If true, low-level noise will be added to the output for non-float formats
+    };
+
+    //==============================================================================
+    /**
+        Receives the encoded audio of a render as it's produced rather than when
+        the file has been finished, e.g. to start streaming a preview straight away.
+
+        Formats that go back to rewrite their header when they're closed, like WAV
+        and AIFF, can't be streamed. Use a format such as Ogg or FLAC or leave the
+        format as nullptr to receive raw PCM.
+        @see Parameters::streamingOutputs
+    */
+    struct StreamingOutput
+    {
+        juce::AudioFormat* audioFormat = nullptr;               ///< The AudioFormat to encode with, if this is nullptr, interleaved 32-bit float PCM is sent
+        int bitDepth = 16;                                      ///< The bit depth to use
+        int quality = 0;                                        ///< For audio formats that support it, the desired quality index
+        bool ditheringEnabled = false;                          ///< If true, low-level noise will be added to the output for non-float formats
+        size_t chunkSize = 16384;                               ///< The number of bytes to collect before they're passed on, the last chunk may be smaller
+
+        /** Called on an encoding thread with each chunk of encoded data.
+            isLastChunk is true for the final call, once the render has finished or been cancelled.
+        */
+        std::function<void (const void* data, size_t numBytes, bool isLastChunk)> onChunk;
+    };
+
     //==============================================================================
     /**
         Holds all the properties of a single render operation.
@@ -59,6 +108,18 @@ public:
 
         int bitDepth = 16;                                      ///< If this is an audio render, the bit depth to use
         int blockSizeForAudio = 512;                            ///< The block size to use
+        int offlineBlockSize = 0;                               /**< If this is larger than blockSizeForAudio and this isn't a real-time render, the graph
+                                                                     will be processed in blocks of this size where it can be and the file written on a
+                                                                     background thread. Automated plugins still process in small sub-blocks so automation
+                                                                     and MIDI stay sample-accurate. Graphs containing modifiers, or plugins that don't use
+                                                                     fine-grain automation, will use blockSizeForAudio. */
+        int numParallelSegments = 0;                            /**< If this is greater than 1, an audio mix is split in to this many time segments which are
+                                                                     rendered at the same time, each by its own copy of the Edit, and then crossfaded together.
+                                                                     Plugins that aren't deterministic may sound slightly different either side of a boundary
+                                                                     and the result is always stereo unless mustRenderInMono is set.
+                                                                     @see ParallelRenderer::canRenderInParallel */
+        TimeDuration parallelPreRoll = 2_td;                    ///< How much to render and discard before each parallel segment so plugins can settle
+        TimeDuration parallelCrossfade = 0.05_td;               ///< How long parallel segments are crossfaded for
         double sampleRateForAudio = 44100.0;                    ///< The sample rate to use
 
         TimeRange time;                                         ///< The time range to render
@@ -72,7 +133,10 @@ public:
 
         bool shouldNormalise = false;                           ///< If true, the resulting audio will be normalised by peak level
         bool shouldNormaliseByRMS = false;                      ///< If true, the resulting audio will be normalised by RMS level
+        bool shouldNormaliseByLoudness = false;                 /**< If true, the resulting audio will be normalised so its BS.1770 integrated loudness
+                                                                     is normaliseToLevelDb LUFS. The loudness is measured as the Edit is rendered. */
         float normaliseToLevelDb = 0;                           ///< The level to normalise to
+        float maxTruePeakDb = 0;                                ///< When normalising by loudness, the gain is limited so the true-peak level doesn't exceed this
         bool canRenderInMono = true;                            ///< If false, the result audio will be forced to stereo
         bool mustRenderInMono = false;                          ///< If true, the resulting audio will be forced to mono
         bool usePlugins = true;                                 ///< If false, clip/tracks plugins will be ommited from the render
@@ -84,6 +148,24 @@ public:
         int quality = 0;                                        ///< For audio formats that support it, the desired quality index @see juce::AudioFormat::createWriterFor
         juce::StringPairArray metadata;                         ///< A map of meta data to add to the file
 
+        std::vector<AdditionalOutput> additionalOutputs;        /**< Other files to write the same audio to as destFile, e.g. to export several formats
+                                                                     at once. These are all written from a single pass of the Edit, each being encoded
+                                                                     on its own thread. They aren't used for MIDI or stem renders. */
+
+        std::vector<StreamingOutput> streamingOutputs;          /**< Callbacks to pass the encoded audio to as it's rendered. These are fed from the same pass
+                                                                     as destFile, which can be empty if only the streams are needed. They aren't
+                                                                     used for MIDI or stem renders, or when normalising or trimming. */
+
+        std::vector<Stem> stems;                                /**< If this isn't empty, rather than rendering a mix to destFile, the output of each of
+                                                                     these tracks will be written to its own file in a single pass.
+                                                                     Each stem is taken after the track's plugins but before the master bus.
+                                                                     Normalising and trimming aren't supported for stems.
+                                                                     @see Renderer::renderStemsToFiles */
+        bool useRenderCache = false;                            /**< If true, stems whose tracks, plugins and render settings haven't changed since
+                                                                     they were last rendered will be copied from a cache in the Edit's temp directory
+                                                                     rather than rendered again. Only used by Renderer::renderStemsToFiles.
+                                                                     @see RenderManager::findCachedTrackRender */
+
         /// @internal
         bool separateTracks = false;
         /// @internal
@@ -93,6 +175,10 @@ public:
         /// @internal
         float resultRMS = 0;
         /// @internal
+        float resultIntegratedLoudness = LoudnessMeter::minLoudness;
+        /// @internal
+        float resultTruePeakDb = LoudnessMeter::minLoudness;
+        /// @internal
         float resultAudioDuration = 0;
     };
 
@@ -143,7 +229,8 @@ public:
         static bool addMidiMetaDataAndWriteToFile (juce::File, juce::MidiMessageSequence, const TempoSequence&);
         /** @internal */
         bool performNormalisingAndTrimming (const Renderer::Parameters& target,
-                                            const Renderer::Parameters& intermediate);
+                                            const Renderer::Parameters& intermediate,
+                                            juce::AudioBuffer<float>& intermediateAudio);
 
     private:
         //==============================================================================
@@ -160,6 +247,7 @@ public:
         //==============================================================================
         bool renderAudio (Renderer::Parameters&);
         bool renderMidi (Renderer::Parameters&);
+        bool renderStems (Renderer::Parameters&);
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderTask)
     };
@@ -199,6 +287,14 @@ public:
     /** Renders an entire Edit to a file. */
     static bool renderToFile (Edit&, const juce::File&, bool useThread = true);
 
+    /** Renders each of the Parameters::stems to its own file in a single pass.
+
+        This is much quicker than calling renderToFile for each track as the graph is
+        only built and prepared once and each file is written on a background thread.
+        @returns the files that were successfully written
+    */
+    static juce::Array<juce::File> renderStemsToFiles (const juce::String& taskDescription, const Parameters&);
+
     //==============================================================================
     /** @see measureStatistics() */
     struct Statistics
@@ -65,6 +65,306 @@ TEST_SUITE("tracktion_engine")
         CHECK (thumbnail->getNumSamplesFinished() >= toSamples (fileLength, 44100.0));
         CHECK (thumbnail->getTotalLength() >= fileLength.inSeconds());
     }
+
+    TEST_CASE ("Renderer offline block size")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto fileLength = 5_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto track = getAudioTracks (*edit)[0];
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        auto render = [&] (int offlineBlockSize)
+        {
+            auto destFile = std::make_unique<juce::TemporaryFile> (".wav");
+            Renderer::Parameters params (*edit);
+            params.destFile = destFile->getFile();
+            params.time = params.time.withLength (fileLength);
+            params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+            params.bitDepth = 32;
+            params.offlineBlockSize = offlineBlockSize;
+
+            Renderer::RenderTask task ("Offline block size", params, nullptr, nullptr);
+
+            while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+            {}
+
+            CHECK (task.errorMessage.isEmpty());
+            return test_utilities::loadFileInToBuffer (engine, destFile->getFile());
+        };
+
+        auto expected = render (0);
+        auto actual = render (8192);
+        REQUIRE (expected);
+        REQUIRE (actual);
+        CHECK_EQ (actual->getNumSamples(), toSamples (fileLength, 44100.0));
+        CHECK_EQ (actual->getNumSamples(), expected->getNumSamples());
+        CHECK_EQ (actual->getNumChannels(), expected->getNumChannels());
+
+        // Larger blocks shouldn't change the output
+        for (int c = 0; c < std::min (actual->getNumChannels(), expected->getNumChannels()); ++c)
+        {
+            float maxDifference = 0.0f;
+
+            for (int i = 0; i < std::min (actual->getNumSamples(), expected->getNumSamples()); ++i)
+                maxDifference = std::max (maxDifference, std::abs (actual->getSample (c, i) - expected->getSample (c, i)));
+
+            CHECK (maxDifference < 0.0001f);
+        }
+    }
+
+    TEST_CASE ("Renderer parallel segments")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto fileLength = 10_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto track = getAudioTracks (*edit)[0];
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        auto segments = ParallelRenderer::createSegments ({ 0_tp, fileLength }, 4, 2_td, 0.05_td);
+        REQUIRE_EQ (segments.size(), 4u);
+        CHECK_EQ (segments.front().time.getStart(), 0_tp);
+        CHECK_EQ (segments.front().preRoll, 0_td);
+        CHECK_EQ (segments.back().time.getEnd(), toPosition (fileLength));
+        CHECK_EQ (segments.back().overlap, 0_td);
+
+        for (size_t i = 1; i < segments.size(); ++i)
+            CHECK_EQ (segments[i].time.getStart(), segments[i - 1].time.getEnd());
+
+        auto render = [&] (int numParallelSegments)
+        {
+            auto destFile = std::make_unique<juce::TemporaryFile> (".wav");
+            Renderer::Parameters params (*edit);
+            params.destFile = destFile->getFile();
+            params.time = params.time.withLength (fileLength);
+            params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+            params.bitDepth = 32;
+            params.canRenderInMono = false;
+            params.numParallelSegments = numParallelSegments;
+
+            Renderer::RenderTask task ("Parallel segments", params, nullptr, nullptr);
+
+            while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+            {}
+
+            CHECK (task.errorMessage.isEmpty());
+            return test_utilities::loadFileInToBuffer (engine, destFile->getFile());
+        };
+
+        auto expected = render (0);
+        auto actual = render (4);
+        REQUIRE (expected);
+        REQUIRE (actual);
+        CHECK_EQ (actual->getNumSamples(), expected->getNumSamples());
+        CHECK_EQ (actual->getNumChannels(), expected->getNumChannels());
+
+        // A clip without plugins is deterministic so the boundaries shouldn't be audible
+        for (int c = 0; c < std::min (actual->getNumChannels(), expected->getNumChannels()); ++c)
+        {
+            float maxDifference = 0.0f;
+
+            for (int i = 0; i < std::min (actual->getNumSamples(), expected->getNumSamples()); ++i)
+                maxDifference = std::max (maxDifference, std::abs (actual->getSample (c, i) - expected->getSample (c, i)));
+
+            CHECK (maxDifference < 0.0001f);
+        }
+    }
+
+    TEST_CASE ("Renderer streaming outputs")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto fileLength = 2_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto track = getAudioTracks (*edit)[0];
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        juce::MemoryBlock streamed;
+        int numChunks = 0, numLastChunks = 0;
+
+        Renderer::StreamingOutput output;
+        output.chunkSize = 4096;
+        output.onChunk = [&] (const void* data, size_t numBytes, bool isLastChunk)
+        {
+            streamed.append (data, numBytes);
+            ++numChunks;
+
+            if (isLastChunk)
+                ++numLastChunks;
+        };
+
+        // Only the stream is written, there's no destFile
+        Renderer::Parameters params (*edit);
+        params.time = params.time.withLength (fileLength);
+        params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+        params.canRenderInMono = false;
+        params.streamingOutputs.push_back (output);
+
+        {
+            Renderer::RenderTask task ("Streaming outputs", params, nullptr, nullptr);
+
+            while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+            {}
+
+            CHECK (task.errorMessage.isEmpty());
+        }
+
+        CHECK_EQ (numLastChunks, 1);
+        CHECK (numChunks > 1);
+        CHECK_EQ ((int64_t) streamed.getSize(), toSamples (fileLength, 44100.0) * 2 * (int64_t) sizeof (float));
+    }
+
+    TEST_CASE ("Renderer additional outputs")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+
+        auto fileLength = 2_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto track = getAudioTracks (*edit)[0];
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        for (bool normalise : { false, true })
+        {
+            juce::TemporaryFile wavFile (".wav"), aiffFile (".aiff"), flacFile (".flac");
+            Renderer::Parameters params (*edit);
+            params.destFile = wavFile.getFile();
+            params.time = params.time.withLength (fileLength);
+            params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+            params.bitDepth = 32;
+            params.shouldNormalise = normalise;
+            params.additionalOutputs = { { aiffFile.getFile(), engine.getAudioFileFormatManager().getAiffFormat(), 24 },
+                                         { flacFile.getFile(), engine.getAudioFileFormatManager().getFlacFormat(), 16 } };
+
+            Renderer::RenderTask task ("Additional outputs", params, nullptr, nullptr);
+
+            while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+            {}
+
+            CHECK (task.errorMessage.isEmpty());
+
+            auto wav = test_utilities::loadFileInToBuffer (engine, wavFile.getFile());
+            REQUIRE (wav);
+            CHECK_EQ (wav->getNumSamples(), toSamples (fileLength, 44100.0));
+
+            // Each format should contain the same audio, to within its bit depth
+            for (auto& file : { aiffFile.getFile(), flacFile.getFile() })
+            {
+                auto other = test_utilities::loadFileInToBuffer (engine, file);
+                REQUIRE (other);
+                REQUIRE_EQ (other->getNumSamples(), wav->getNumSamples());
+                REQUIRE_EQ (other->getNumChannels(), wav->getNumChannels());
+
+                float maxDifference = 0.0f;
+
+                for (int c = 0; c < wav->getNumChannels(); ++c)
+                    for (int i = 0; i < wav->getNumSamples(); ++i)
+                        maxDifference = std::max (maxDifference, std::abs (other->getSample (c, i) - wav->getSample (c, i)));
+
+                CHECK (maxDifference < 0.001f);
+            }
+        }
+    }
+
+    TEST_CASE ("Renderer stems")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, 2);
+
+        auto fileLength = 2_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto tracks = getAudioTracks (*edit);
+        insertWaveClip (*tracks[0], {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+        insertWaveClip (*tracks[1], {}, sinFile->getFile(), { .time = { toPosition (fileLength), fileLength } },
+                        DeleteExistingClips::no);
+
+        juce::TemporaryFile destFile1 (".wav"), destFile2 (".wav");
+        Renderer::Parameters params (*edit);
+        params.time = { 0_tp, fileLength * 2.0 };
+        params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+        params.stems = { { tracks[0], destFile1.getFile() },
+                         { tracks[1], destFile2.getFile() } };
+
+        Renderer::RenderTask task ("Stems", params, nullptr, nullptr);
+
+        while (task.runJob() == juce::ThreadPoolJob::jobNeedsRunningAgain)
+        {}
+
+        CHECK (task.errorMessage.isEmpty());
+
+        const auto fileLengthNumSamples = (int) toSamples (fileLength, 44100.0);
+        auto buffer1 = test_utilities::loadFileInToBuffer (engine, destFile1.getFile());
+        auto buffer2 = test_utilities::loadFileInToBuffer (engine, destFile2.getFile());
+        REQUIRE (buffer1);
+        REQUIRE (buffer2);
+        CHECK_EQ (buffer1->getNumSamples(), fileLengthNumSamples * 2);
+        CHECK_EQ (buffer2->getNumSamples(), fileLengthNumSamples * 2);
+
+        // Each stem should only contain its own track's clip
+        CHECK (buffer1->getMagnitude (0, fileLengthNumSamples) > 0.5f);
+        CHECK (buffer1->getMagnitude (fileLengthNumSamples, fileLengthNumSamples) < 0.001f);
+        CHECK (buffer2->getMagnitude (0, fileLengthNumSamples) < 0.001f);
+        CHECK (buffer2->getMagnitude (fileLengthNumSamples, fileLengthNumSamples) > 0.5f);
+    }
+
+    TEST_CASE ("Renderer stem cache")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, 2);
+
+        auto fileLength = 1_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+
+        auto tracks = getAudioTracks (*edit);
+
+        for (auto t : tracks)
+            insertWaveClip (*t, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                            DeleteExistingClips::no);
+
+        juce::TemporaryFile destFile1 (".wav"), destFile2 (".wav");
+        Renderer::Parameters params (*edit);
+        params.time = { 0_tp, fileLength };
+        params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+        params.useRenderCache = true;
+        params.stems = { { tracks[0], destFile1.getFile() },
+                         { tracks[1], destFile2.getFile() } };
+
+        auto hashes = render_utils::getStemRenderHashes (params);
+        REQUIRE_EQ (hashes.size(), 2u);
+        CHECK_NE (hashes[0], 0);
+        CHECK_NE (hashes[1], 0);
+        CHECK_NE (hashes[0], hashes[1]);
+        CHECK (hashes == render_utils::getStemRenderHashes (params));
+
+        CHECK_EQ (Renderer::renderStemsToFiles ("Stems", params).size(), 2);
+        CHECK (RenderManager::findCachedTrackRender (*tracks[0], hashes[0], ".wav").getFile().existsAsFile());
+        CHECK (RenderManager::findCachedTrackRender (*tracks[1], hashes[1], ".wav").getFile().existsAsFile());
+
+        // Changing a track should only change that stem's hash
+        tracks[1]->getVolumePlugin()->setVolumeDb (-6.0f);
+        auto newHashes = render_utils::getStemRenderHashes (params);
+        CHECK_EQ (newHashes[0], hashes[0]);
+        CHECK_NE (newHashes[1], hashes[1]);
+
+        // Dithered renders can't be cached
+        params.ditheringEnabled = true;
+        CHECK (render_utils::getStemRenderHashes (params) == std::vector<HashCode> { 0, 0 });
+    }
 }
 
 #endif
@@ -149,6 +449,49 @@ public:
                 expect (! freezeFile.getFile().exists());
             }
         }
+
+        beginTest ("Re-freezing changed clips");
+        {
+            auto edit = test_utilities::createTestEdit (engine);
+            auto track = getAudioTracks (*edit)[0];
+            auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, 1.0);
+
+            // Spread the clips out so moving one only changes a small part of the track
+            for (int i = 0; i < 10; ++i)
+                insertWaveClip (*track, {}, sinFile->getFile(), { .time = { TimePosition::fromSeconds (i * 2.0), 1_td } },
+                                DeleteExistingClips::no);
+
+            const auto freezeFile = TemporaryFileManager::getFreezeFileForTrack (*track);
+            track->setFrozen (true, AudioTrack::individualFreeze);
+            track->setFrozen (false, AudioTrack::individualFreeze);
+
+            // Freezing again should only render around the old and new clip positions
+            track->getClips()[4]->setStart (8.5s, false, true);
+            track->setFrozen (true, AudioTrack::individualFreeze);
+            auto updatedBuffer = test_utilities::loadFileInToBuffer (engine, freezeFile);
+            track->setFrozen (false, AudioTrack::individualFreeze);
+
+            // Which should match a full render
+            engine.getAudioFileManager().releaseAllFiles();
+            freezeFile.deleteFile();
+            track->setFrozen (true, AudioTrack::individualFreeze);
+            auto fullBuffer = test_utilities::loadFileInToBuffer (engine, freezeFile);
+
+            expect (updatedBuffer.has_value() && fullBuffer.has_value());
+            expectEquals (updatedBuffer->getNumChannels(), fullBuffer->getNumChannels());
+            expectEquals (updatedBuffer->getNumSamples(), fullBuffer->getNumSamples());
+
+            float maxDiff = 0.0f;
+
+            for (int c = 0; c < fullBuffer->getNumChannels(); ++c)
+                for (int s = 0; s < fullBuffer->getNumSamples(); ++s)
+                    maxDiff = std::max (maxDiff, std::abs (updatedBuffer->getSample (c, s) - fullBuffer->getSample (c, s)));
+
+            expectLessOrEqual (maxDiff, 0.0001f);
+
+            engine.getAudioFileManager().releaseAllFiles();
+            edit->getTempDirectory (false).deleteRecursively();
+        }
     }
 };
 
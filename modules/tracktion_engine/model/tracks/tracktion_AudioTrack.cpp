@@ -100,6 +100,258 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FreezeUpdater)
 };
 
+//==============================================================================
+/** Describes what a track's freeze file was rendered from, so the next freeze
+    can find the parts of it that need rendering again.
+*/
+struct AudioTrack::FreezeState
+{
+    FreezeState (AudioTrack& track, const juce::Array<Clip*>& clipsToFreeze, double rate, TimeDuration tail)
+        : sampleRate (rate), endAllowance (tail)
+    {
+        for (auto c : clipsToFreeze)
+        {
+            size_t clipHash = 0;
+            hashValueTreeProperties (clipHash, c->state, true);
+
+            if (auto acb = dynamic_cast<AudioClipBase*> (c))
+                hash_combine (clipHash, acb->getHash());
+
+            clips[c->itemID] = { c->getPosition().time, clipHash };
+        }
+
+        // Anything other than the clips changing means the whole track needs rendering again
+        hash_combine (renderHash, track.edit.tempoSequence.getInternalSequence().hash());
+        hash_combine (renderHash, track.getIndexOfFreezePoint());
+
+        for (int i = 0; i < track.getIndexOfFreezePoint(); ++i)
+            hashValueTreeProperties (renderHash, track.pluginList[i]->state, true);
+
+        for (auto inputTrack : track.getInputTracks())
+            for (auto p : inputTrack->pluginList)
+                hashValueTreeProperties (renderHash, p->state, true);
+    }
+
+    bool canBeUpdatedFrom (const FreezeState& previous) const
+    {
+        return renderHash == previous.renderHash
+            && sampleRate == previous.sampleRate
+            && endAllowance == previous.endAllowance;
+    }
+
+    /** Returns the ranges covered by any clips that have been added, removed or
+        changed since the previous freeze.
+    */
+    std::vector<TimeRange> getChangedRanges (const FreezeState& previous) const
+    {
+        std::vector<TimeRange> changedRanges;
+
+        for (auto& [id, clip] : clips)
+        {
+            auto oldClip = previous.clips.find (id);
+
+            if (oldClip == previous.clips.end())
+            {
+                changedRanges.push_back (clip.first);
+            }
+            else if (oldClip->second != clip)
+            {
+                changedRanges.push_back (oldClip->second.first);
+                changedRanges.push_back (clip.first);
+            }
+        }
+
+        for (auto& [id, clip] : previous.clips)
+            if (clips.find (id) == clips.end())
+                changedRanges.push_back (clip.first);
+
+        return changedRanges;
+    }
+
+    std::map<EditItemID, std::pair<TimeRange, size_t>> clips;
+    size_t renderHash = 0;
+    double sampleRate;
+    TimeDuration endAllowance;
+};
+
+//==============================================================================
+namespace track_freeze
+{
+    /** A re-rendered section of a freeze file and where it is spliced in. */
+    struct Splice
+    {
+        juce::Range<SampleCount> range;
+        SampleCount renderStart = 0;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+    };
+
+    /** Returns the sections of a freeze file to replace for some changed ranges.
+        Each includes the changed range's tail and crossfades at each end.
+    */
+    static std::vector<TimeRange> getSpliceRanges (std::vector<TimeRange> changedRanges, TimeDuration tail,
+                                                   TimeDuration crossfade, TimeRange totalRange)
+    {
+        std::sort (changedRanges.begin(), changedRanges.end(),
+                   [] (auto r1, auto r2) { return r1.getStart() < r2.getStart(); });
+
+        std::vector<TimeRange> spliceRanges;
+
+        for (auto r : changedRanges)
+        {
+            auto range = TimeRange (r.getStart() - crossfade, r.getEnd() + tail + crossfade)
+                           .getIntersectionWith (totalRange);
+
+            if (range.isEmpty())
+                continue;
+
+            if (! spliceRanges.empty() && spliceRanges.back().getEnd() >= range.getStart())
+                spliceRanges.back() = spliceRanges.back().getUnionWith (range);
+            else
+                spliceRanges.push_back (range);
+        }
+
+        return spliceRanges;
+    }
+
+    /** Writes the previous freeze file to a new one, crossfading to each of the
+        re-rendered sections.
+    */
+    static bool writeSplicedFile (Engine& engine, juce::AudioFormatReader& previous, std::vector<Splice>& splices,
+                                  const juce::File& destFile, SampleCount length, int crossfadeSamples)
+    {
+        const int numChannels = (int) previous.numChannels;
+        AudioFileWriter writer (AudioFile (engine, destFile), engine.getAudioFileFormatManager().getFrozenFileFormat(),
+                                numChannels, previous.sampleRate, (int) previous.bitsPerSample, {}, 0,
+                                AudioFileWriteOptions::forRendering());
+
+        if (! writer.isOpen())
+            return false;
+
+        constexpr int blockSize = 8192;
+        juce::AudioBuffer<float> buffer (numChannels, blockSize), renderBuffer (numChannels, blockSize);
+
+        for (SampleCount pos = 0; pos < length;)
+        {
+            const auto numThisTime = (int) std::min ((SampleCount) blockSize, length - pos);
+            previous.read (&buffer, 0, numThisTime, pos, true, true);
+
+            for (auto& splice : splices)
+            {
+                auto overlap = splice.range.getIntersectionWith ({ pos, pos + numThisTime });
+
+                if (overlap.isEmpty())
+                    continue;
+
+                const auto numToSplice = (int) overlap.getLength();
+                splice.reader->read (&renderBuffer, 0, numToSplice, overlap.getStart() - splice.renderStart, true, true);
+
+                for (int i = 0; i < numToSplice; ++i)
+                {
+                    const auto samplePos = overlap.getStart() + i;
+                    const auto fadePos = std::min (samplePos - splice.range.getStart(), splice.range.getEnd() - 1 - samplePos);
+                    const auto gain = juce::jlimit (0.0f, 1.0f, (float) (fadePos + 1) / (float) (crossfadeSamples + 1));
+                    const auto bufferIndex = (int) (samplePos - pos);
+
+                    for (int chan = 0; chan < numChannels; ++chan)
+                    {
+                        auto& dest = buffer.getWritePointer (chan)[bufferIndex];
+                        dest = dest * (1.0f - gain) + renderBuffer.getSample (chan, i) * gain;
+                    }
+                }
+            }
+
+            if (! writer.appendBuffer (buffer, numThisTime))
+                return false;
+
+            pos += numThisTime;
+        }
+
+        writer.closeForWriting();
+        return true;
+    }
+
+    /** Re-renders just the changed ranges of an existing freeze file and splices
+        them in to it. Returns false if a full render should be done instead.
+    */
+    static bool renderChangedRanges (const Renderer::Parameters& r, const std::vector<TimeRange>& changedRanges,
+                                     const juce::String& taskDescription)
+    {
+        auto& engine = *r.engine;
+        std::unique_ptr<juce::AudioFormatReader> previous (AudioFileUtils::createReaderFor (engine, r.destFile));
+
+        if (previous == nullptr
+            || previous->numChannels > 2
+            || previous->sampleRate != r.sampleRateForAudio)
+            return false;
+
+        if (changedRanges.empty())
+            return true;
+
+        const TimeDuration crossfade = 0.01s;
+        const auto totalRange = TimeRange (r.time.getStart(), r.time.getEnd() + r.endAllowance);
+        const auto spliceRanges = getSpliceRanges (changedRanges, r.endAllowance, crossfade, totalRange);
+
+        // If most of the track has changed it's quicker to just render it all again
+        TimeDuration lengthToRender;
+
+        for (auto range : spliceRanges)
+            lengthToRender = lengthToRender + range.getLength();
+
+        if (spliceRanges.empty() || lengthToRender > totalRange.getLength() * 0.5)
+            return false;
+
+        // Start each render early enough for the tails of anything before it to be present
+        const auto preRoll = std::max (r.endAllowance, TimeDuration (0.5s));
+        const auto sampleRate = previous->sampleRate;
+
+        std::vector<Splice> splices;
+        std::vector<std::unique_ptr<juce::TemporaryFile>> renderedFiles;
+
+        for (auto range : spliceRanges)
+        {
+            auto& renderedFile = renderedFiles.emplace_back (std::make_unique<juce::TemporaryFile> (r.destFile));
+
+            auto params = r;
+            params.time = range.withStart (std::max (totalRange.getStart(), range.getStart() - preRoll));
+            params.endAllowance = {};
+            params.destFile = renderedFile->getFile();
+            params.canRenderInMono = previous->numChannels == 1;
+            params.mustRenderInMono = false;
+
+            if (! Renderer::renderToFile (taskDescription, params).existsAsFile())
+                return false;
+
+            // If a mono track now has stereo content, the whole file needs to be stereo
+            std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, params.destFile));
+
+            if (reader == nullptr || reader->numChannels != previous->numChannels)
+                return false;
+
+            splices.push_back ({ toSamples (range, sampleRate), toSamples (params.time.getStart(), sampleRate), std::move (reader) });
+        }
+
+        const auto length = std::min (toSamples (totalRange.getEnd(), sampleRate),
+                                      std::max (previous->lengthInSamples, splices.back().range.getEnd()));
+        juce::TemporaryFile splicedFile (r.destFile);
+
+        if (! writeSplicedFile (engine, *previous, splices, splicedFile.getFile(), length,
+                                (int) toSamples (crossfade, sampleRate)))
+            return false;
+
+        previous.reset();
+        splices.clear();
+
+        const AudioFile freezeFile (engine, r.destFile);
+        engine.getAudioFileManager().releaseFile (freezeFile);
+
+        if (! splicedFile.overwriteTargetFileWithTemporary())
+            return false;
+
+        engine.getAudioFileManager().checkFileForChanges (freezeFile);
+        return true;
+    }
+}
+
 //==============================================================================
 AudioTrack::AudioTrack (Edit& ed, const juce::ValueTree& v)
     : ClipTrack (ed, v, true),
@@ -1030,7 +1282,6 @@ void AudioTrack::freezeTrack()
     juce::BigInteger trackNum;
     trackNum.setBit (getIndexInEditTrackList());
     auto freezeFile = getFreezeFile();
-    freezeFile.deleteFile();
 
     juce::Array<EditItemID> trackIDs { itemID };
     juce::Array<Clip*> clips (getClips());
@@ -1060,10 +1311,25 @@ void AudioTrack::freezeTrack()
     const auto desc = TRANS("Creating track freeze for \"XDVX\"")
                         .replace ("XDVX", getName()) + "...";
 
-    if (getProjectForEdit (edit) != nullptr)
-        Renderer::renderToProjectItem (desc, r, ProjectItem::Category::frozen);
-    else
-        Renderer::renderToFile (desc, r);
+    // If only some clips have changed since the last freeze, just the sections
+    // around them are rendered and spliced in to the existing freeze file
+    auto freezeState = std::make_unique<FreezeState> (*this, clips, r.sampleRateForAudio, r.endAllowance);
+
+    const bool updatedChangedRanges = lastFreezeState != nullptr
+                                        && freezeState->canBeUpdatedFrom (*lastFreezeState)
+                                        && track_freeze::renderChangedRanges (r, freezeState->getChangedRanges (*lastFreezeState), desc);
+
+    if (! updatedChangedRanges)
+    {
+        freezeFile.deleteFile();
+
+        if (getProjectForEdit (edit) != nullptr)
+            Renderer::renderToProjectItem (desc, r, ProjectItem::Category::frozen);
+        else
+            Renderer::renderToFile (desc, r);
+    }
+
+    lastFreezeState = r.destFile.existsAsFile() ? std::move (freezeState) : nullptr;
 
     freezePlugins (juce::Range<int> (0, getIndexOfFreezePoint()));
     setMute (shouldBeMuted);
@@ -206,6 +206,7 @@ private:
     //==============================================================================
     struct TrackMuter;
     struct FreezeUpdater;
+    struct FreezeState;
     friend struct TrackMuter;
     friend class Edit;
     friend class Clip;
@@ -229,6 +230,7 @@ private:
     juce::Array<int> currentlyPlayingGuideNotes;
 
     std::unique_ptr<FreezeUpdater> freezeUpdater;
+    std::unique_ptr<FreezeState> lastFreezeState;
     std::unique_ptr<TrackMuter> trackMuter;
 
     enum { updateAutoCrossfadesFlag = 1 };
@@ -284,6 +284,16 @@ void Track::sendMirrorUpdateToAllPlugins (Plugin& p) const
     pluginList.sendMirrorUpdateToAllPlugins (p);
 }
 
+double Track::getCpuSavedBySleepingPlugins() const
+{
+    double total = 0.0;
+
+    for (auto p : getAllPlugins())
+        total += p->getCpuSavedBySleeping();
+
+    return total;
+}
+
 void Track::flipAllPluginsEnablement()
 {
     auto isVolPanVCA = [] (Plugin* p)
@@ -459,10 +469,13 @@ void Track::insertSpaceIntoTrack (TimePosition time, TimeDuration amountOfSpace)
                 auto defaultValue = param->getCurrentBaseValue();
                 auto valueAtInsertionTime = curve.getValueAt (time, defaultValue);
 
+                // Points are moved from the end so the ones still to move keep their original times
+                auto pointTimes = curve.getPointTimes();
+
                 for (int k = curve.getNumPoints(); --k >= 0;)
-                    if (curve.getPointTime (k) >= time)
+                    if (pointTimes[(size_t) k] >= time)
                         curve.movePoint (*param, k,
-                                         curve.getPointTime (k) + amountOfSpace,
+                                         pointTimes[(size_t) k] + amountOfSpace,
                                          curve.getPointValue (k), false,
                                          um);
 
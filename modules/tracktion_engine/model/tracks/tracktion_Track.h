@@ -332,6 +332,12 @@ public:
     /** Toggles the Plugin::isEnabled state for all Plugin[s] on this Track. */
     void flipAllPluginsEnablement();
 
+    /** Returns the proportion of the current buffer size being saved by Plugin[s] on
+        this Track that are asleep as they've been silent.
+        @see Plugin::canSleepWhenSilent
+    */
+    double getCpuSavedBySleepingPlugins() const;
+
     //==============================================================================
     /** Returns the ModifierList for this track, if it has one. */
     ModifierList* getModifierList() const                   { return modifierList.get(); }
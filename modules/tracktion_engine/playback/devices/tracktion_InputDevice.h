@@ -224,6 +224,15 @@ public:
     */
     virtual void prepareToStopRecording (std::vector<EditItemID> targetsToStop) = 0;
 
+    /** Finishes writing the files of recordings stopped by prepareToStopRecording.
+        This writes any remaining samples and the files' headers so that stopRecording
+        only has to add the clips to the Edit. It's called on background threads when
+        several inputs are stopped together so their files can be finished in parallel.
+        Devices that don't record to files don't need to do anything here.
+        @param targetsToStop    The targets passed to prepareToStopRecording.
+    */
+    virtual void finishRecordingFiles (std::vector<EditItemID> /*targetsToStop*/) {}
+
     /** Stops a recording.
         @param StopRecordingParameters determines how stopped recordings are treated.
     */
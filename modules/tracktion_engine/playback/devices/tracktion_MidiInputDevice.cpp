@@ -140,6 +140,41 @@ private:
 };
 
 
+//==============================================================================
+/**
+   Periodically calls a function on a background thread.
+   Used to move recorded messages out of the MIDI thread's queues.
+*/
+class MidiRecordingDrainThread  : private juce::Thread
+{
+public:
+    MidiRecordingDrainThread (std::function<void()> drainCallback)
+        : juce::Thread ("MIDI Recording"), callback (std::move (drainCallback))
+    {
+        assert (callback);
+        startThread();
+    }
+
+    ~MidiRecordingDrainThread() override
+    {
+        stopThread (2000);
+    }
+
+private:
+    static constexpr int drainIntervalMs = 20;
+    std::function<void()> callback;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            callback();
+            wait (drainIntervalMs);
+        }
+    }
+};
+
+
 //==============================================================================
 //==============================================================================
 class MidiControllerParser  : private juce::AsyncUpdater
@@ -789,6 +824,7 @@ public:
     ~MidiInputDeviceInstanceBase() override
     {
         getMidiInput().removeInstance (this);
+        drainThread.reset();
     }
 
     bool isRecordingActive() const override
@@ -835,6 +871,18 @@ public:
         {
             liveNotes = std::make_shared<choc::fifo::SingleReaderSingleWriterFIFO<juce::MidiMessage>>();
             liveNotes->reset (100);
+            pendingMessages.reset (numPendingMessages);
+        }
+
+        /** Moves the messages queued by the MIDI thread to the recorded sequence.
+            Only one thread must call this at a time.
+        */
+        void drainPendingMessages()
+        {
+            juce::MidiMessage m;
+
+            while (pendingMessages.pop (m))
+                recorded.addEvent (m);
         }
 
         detail::ScopedActiveRecordingDevice scopedActiveRecordingDevice;
@@ -842,6 +890,11 @@ public:
         juce::MidiMessageSequence recorded;
         TimePosition unloopedStopTime;
 
+        // Enough for a second of very dense MPE data if the drain thread gets held up
+        static constexpr size_t numPendingMessages = 16384;
+        choc::fifo::SingleReaderMultipleWriterFIFO<juce::MidiMessage> pendingMessages;
+        std::atomic<uint32_t> numDroppedMessages { 0 };
+
         std::shared_ptr<choc::fifo::SingleReaderSingleWriterFIFO<juce::MidiMessage>> liveNotes;
 
         std::function<void (tl::expected<Clip::Array, juce::String>)> stopCallback;
@@ -891,6 +944,9 @@ public:
             }
         }
 
+        if (hasAddedContexts && ! drainThread)
+            drainThread = std::make_unique<MidiRecordingDrainThread> ([this] { drainPendingMessages(); });
+
         if (hasAddedContexts && ! edit.getTransport().isPlaying())
             edit.getTransport().play (false);
 
@@ -1041,20 +1097,30 @@ public:
                 activeNotes.clearNote (message.getChannel(), message.getNoteNumber());
         }
 
-        const bool recording = isRecording();
+        bool recording = false;
 
-        if (recording)
         {
-            auto m1 = juce::MidiMessage (message, context.globalStreamTimeToEditTime (message.getTimeStamp()).inSeconds());
-            auto m2 = juce::MidiMessage (message, context.globalStreamTimeToEditTimeUnlooped (message.getTimeStamp()).inSeconds());
+            // Messages are only queued here as adding them to the sequence allocates.
+            // The drain thread moves them to the sequence in batches.
+            const std::shared_lock sl (contextLock);
+            recording = ! recordingContexts.empty();
 
-            for (auto& recContext : recordingContexts)
-                recContext->liveNotes->push (m1);
+            if (recording)
+            {
+                auto m1 = juce::MidiMessage (message, context.globalStreamTimeToEditTime (message.getTimeStamp()).inSeconds());
+                auto m2 = juce::MidiMessage (message, context.globalStreamTimeToEditTimeUnlooped (message.getTimeStamp()).inSeconds());
 
-            const std::shared_lock sl (contextLock);
+                for (auto& recContext : recordingContexts)
+                {
+                    recContext->liveNotes->push (m1);
 
-            for (auto& recContext : recordingContexts)
-                recContext->recorded.addEvent (m2);
+                    if (! recContext->pendingMessages.push (m2))
+                    {
+                        recContext->numDroppedMessages.fetch_add (1, std::memory_order_relaxed);
+                        getMidiInput().incrementNumDroppedRecordingMessages();
+                    }
+                }
+            }
         }
 
         juce::ScopedLock sl (consumerLock);
@@ -1108,6 +1174,12 @@ public:
             return {};
         }
 
+        // The context has been removed from the list so the drain thread can't also be reading it
+        recContext->drainPendingMessages();
+
+        if (auto numDropped = recContext->numDroppedMessages.load())
+            TRACKTION_LOG_ERROR ("MIDI recording can't keep up! Dropped " + juce::String (numDropped) + " messages");
+
         if (recContext->recorded.getNumEvents() == 0)
             return {};
 
@@ -1495,6 +1567,14 @@ public:
     mutable std::shared_mutex contextLock;
     std::vector<std::unique_ptr<MidiRecordingContext>> recordingContexts;
 
+    void drainPendingMessages()
+    {
+        const std::shared_lock sl (contextLock);
+
+        for (auto& recContext : recordingContexts)
+            recContext->drainPendingMessages();
+    }
+
 private:
     juce::CriticalSection consumerLock, activeNotesLock;
     juce::Array<Consumer*> consumers;
@@ -1503,6 +1583,7 @@ private:
     MPESourceID midiSourceID = createUniqueMPESourceID();
     ActiveNoteList activeNotes;
     std::unique_ptr<RecordStopper> recordStopper;
+    std::unique_ptr<MidiRecordingDrainThread> drainThread;
 
     void addConsumer (Consumer* c) override      { juce::ScopedLock sl (consumerLock); consumers.addIfNotAlreadyThere (c); }
     void removeConsumer (Consumer* c) override   { juce::ScopedLock sl (consumerLock); consumers.removeAllInstancesOf (c); }
@@ -103,6 +103,22 @@ public:
     void updateRetrospectiveBufferLength (double length) override;
     double getAdjustSecs() const                                    { return adjustSecs; }
 
+    /** Returns the number of incoming messages that have been dropped because the
+        playback graph's input queue was full, e.g. because the audio thread stalled.
+    */
+    uint32_t getNumDroppedMessages() const                          { return numDroppedMessages.load (std::memory_order_relaxed); }
+
+    /** @internal */
+    void incrementNumDroppedMessages()                              { numDroppedMessages.fetch_add (1, std::memory_order_relaxed); }
+
+    /** Returns the number of messages that couldn't be recorded because the
+        recording queue was full, e.g. because the thread emptying it stalled.
+    */
+    uint32_t getNumDroppedRecordingMessages() const                 { return numDroppedRecordingMessages.load (std::memory_order_relaxed); }
+
+    /** @internal */
+    void incrementNumDroppedRecordingMessages()                     { numDroppedRecordingMessages.fetch_add (1, std::memory_order_relaxed); }
+
     juce::Array<AudioTrack*> getDestinationTracks();
 
     MidiChannel getMidiChannelFor (int rawChannelNumber) const;
@@ -132,6 +148,7 @@ protected:
     class NoteDispatcher;
 
     std::atomic<double> adjustSecs { 0 };
+    std::atomic<uint32_t> numDroppedMessages { 0 }, numDroppedRecordingMessages { 0 };
     double manualAdjustMs = 0;
     double minimumLengthMs = 0;
     bool overrideNoteVels = false, eventReceivedFromDevice = false;
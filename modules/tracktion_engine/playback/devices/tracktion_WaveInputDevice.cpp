@@ -135,37 +135,119 @@ static juce::String expandPatterns (Edit& ed, juce::String s, Track* track, int
 
 
 //==============================================================================
-struct RetrospectiveRecordBuffer
+/**
+    Keeps the last few seconds of a device's input so they can be turned into a
+    clip by applyRetrospectiveRecord.
+
+    The audio is kept in a circular buffer which the device thread writes to
+    without locking or allocating, even while a clip is being taken from it.
+    To save memory, the samples can be packed as 24 or 16-bit integers rather
+    than floats (SettingID::retrospectiveRecordBitDepth), and the buffer can be
+    a memory-mapped temporary file rather than RAM
+    (SettingID::retrospectiveRecordUseTempFile).
+
+    The buffer is only ever resized on the message thread. Until it has been
+    resized to match a change in the device's format, nothing is captured.
+*/
+struct RetrospectiveRecordBuffer  : private juce::Timer
 {
     RetrospectiveRecordBuffer (Engine& e)
+        : engine (e)
     {
-        lengthInSeconds = e.getPropertyStorage().getProperty (SettingID::retrospectiveRecord, 30);
+        auto& ps = e.getPropertyStorage();
+        lengthInSeconds = ps.getProperty (SettingID::retrospectiveRecord, 30);
+        bitDepth = ps.getProperty (SettingID::retrospectiveRecordBitDepth, 32);
+        useTempFile = ps.getProperty (SettingID::retrospectiveRecordUseTempFile, false);
+
+        startTimer (500);
     }
 
-    void updateSizeIfNeeded (int newNumChannels, double newSampleRate)
+    ~RetrospectiveRecordBuffer() override
     {
-        int newNumSamples = juce::roundToInt (lengthInSeconds * newSampleRate);
+        stopTimer();
+    }
 
-        if (newNumChannels != numChannels || newNumSamples != numSamples || newSampleRate != sampleRate)
-        {
-            numChannels = newNumChannels;
-            numSamples  = newNumSamples;
-            sampleRate  = newSampleRate;
+    /** Called on the device thread to say what the buffer should hold.
+        Returns false if it can't be written to until it's been resized.
+    */
+    bool updateSizeIfNeeded (int newNumChannels, double newSampleRate)
+    {
+        requiredNumChannels.store (newNumChannels, std::memory_order_relaxed);
+        requiredSampleRate.store (newSampleRate, std::memory_order_relaxed);
 
-            fifo.setSize (numChannels, std::max (1, numSamples));
-            fifo.reset();
-        }
+        return storage != nullptr
+                && storage->numChannels == newNumChannels
+                && sampleRate == newSampleRate;
     }
 
     void processBuffer (double streamTime, const juce::AudioBuffer<float>& inputBuffer, int numSamplesIn)
     {
-        if (numSamplesIn < numSamples)
+        if (storage == nullptr || numSamplesIn >= storage->numFrames)
+            return;
+
+        const auto start = numWritten.load (std::memory_order_relaxed);
+        storage->write (start, inputBuffer, numSamplesIn);
+
+        // The position and time are updated together so they can be read as a pair
+        const auto seq = sequence.load (std::memory_order_relaxed);
+        sequence.store (seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        lastStreamTime.store (streamTime, std::memory_order_relaxed);
+        numWritten.store (start + numSamplesIn, std::memory_order_relaxed);
+        sequence.store (seq + 2, std::memory_order_release);
+    }
+
+    /** Writes the audio that has been captured since the last call, up to the
+        buffer's length, to a writer.
+        Returns the number of samples written, or nullopt if the device overwrote
+        them before they could all be written.
+    */
+    std::optional<SampleCount> writeTo (AudioFileWriter& writer, double& streamTimeOfLastBlock)
+    {
+        TRACKTION_ASSERT_MESSAGE_THREAD
+
+        if (storage == nullptr)
+            return SampleCount (0);
+
+        SampleCount end = 0;
+
+        for (;;)
         {
-            lastStreamTime = streamTime;
+            const auto seq = sequence.load (std::memory_order_acquire);
+            end = numWritten.load (std::memory_order_relaxed);
+            streamTimeOfLastBlock = lastStreamTime.load (std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_acquire);
 
-            fifo.ensureFreeSpace (numSamplesIn);
-            fifo.write (inputBuffer);
+            if ((seq & 1) == 0 && sequence.load (std::memory_order_relaxed) == seq)
+                break;
         }
+
+        const auto lengthInSamples = std::min ((SampleCount) (lengthInSeconds * sampleRate), storage->numFrames - getSafetyMargin());
+        auto pos = std::max ({ (SampleCount) 0, end - lengthInSamples, extractedUpTo });
+        const auto numToWrite = end - pos;
+
+        juce::AudioBuffer<float> scratchBuffer (storage->numChannels, 8192);
+
+        while (pos < end)
+        {
+            const auto numThisTime = (int) std::min ((SampleCount) scratchBuffer.getNumSamples(), end - pos);
+            storage->read (pos, scratchBuffer, numThisTime);
+
+            // If the device has wrapped round on to what was just read, it can't be used.
+            // This allows for a block that's still being written but not counted yet
+            const auto maxBlockSize = (SampleCount) sampleRate;
+
+            if (numWritten.load (std::memory_order_acquire) + maxBlockSize - storage->numFrames > pos)
+                return {};
+
+            if (! writer.appendBuffer (scratchBuffer, numThisTime))
+                return {};
+
+            pos += numThisTime;
+        }
+
+        extractedUpTo = end;
+        return numToWrite;
     }
 
     void syncToEdit (Edit& edit, EditPlaybackContext& context, double streamTime, int numSamplesIn)
@@ -201,13 +283,12 @@ struct RetrospectiveRecordBuffer
             editInfo.erase (itr);
     }
 
-    double lengthInSeconds = 30.0;
+    int getNumChannels() const      { return storage != nullptr ? storage->numChannels : 0; }
 
-    AudioFifo fifo { 1, 1 };
-    double lastStreamTime = 0;
-
-    int numChannels = 0;
-    int numSamples = 0;
+    Engine& engine;
+    std::atomic<double> lengthInSeconds { 30.0 };
+    int bitDepth = 32;
+    bool useTempFile = false;
     double sampleRate = 0;
 
     struct PerEditInfo
@@ -219,6 +300,156 @@ struct RetrospectiveRecordBuffer
     std::map<ProjectItemID, PerEditInfo> editInfo;
     juce::SpinLock editInfoLock;
 
+private:
+    //==============================================================================
+    /** The interleaved samples, packed into floats or 16 or 24-bit integers. */
+    struct Storage
+    {
+        Storage (Engine& e, int numChans, SampleCount frames, int bits, bool shouldUseTempFile)
+            : numChannels (numChans), numFrames (frames),
+              bytesPerSample (bits == 16 ? 2 : (bits == 24 ? 3 : 4))
+        {
+            const auto numBytes = (size_t) numFrames * (size_t) numChannels * (size_t) bytesPerSample;
+
+            if (shouldUseTempFile)
+            {
+                tempFile = e.getTemporaryFileManager().getUniqueTempFile ("retrospective_", "tmp");
+
+                if (juce::FileOutputStream out (tempFile); out.openedOk() && out.setPosition ((juce::int64) numBytes))
+                {
+                    out.writeByte (0);
+                    out.flush();
+                }
+
+                mappedFile = std::make_unique<juce::MemoryMappedFile> (tempFile, juce::Range<juce::int64> (0, (juce::int64) numBytes),
+                                                                       juce::MemoryMappedFile::readWrite);
+                data = static_cast<char*> (mappedFile->getData());
+            }
+
+            // Fall back to memory if the file couldn't be mapped
+            if (data == nullptr)
+            {
+                memory.calloc (numBytes);
+                data = memory.get();
+            }
+        }
+
+        ~Storage()
+        {
+            mappedFile.reset();
+            tempFile.deleteFile();
+        }
+
+        void write (SampleCount position, const juce::AudioBuffer<float>& source, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto dest = getFrame (position + i);
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                {
+                    const auto sample = source.getSample (std::min (chan, source.getNumChannels() - 1), i);
+                    writeSample (dest + chan * bytesPerSample, sample);
+                }
+            }
+        }
+
+        void read (SampleCount position, juce::AudioBuffer<float>& dest, int numSamples) const
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto source = getFrame (position + i);
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    dest.setSample (chan, i, readSample (source + chan * bytesPerSample));
+            }
+        }
+
+        const int numChannels;
+        const SampleCount numFrames;
+
+    private:
+        const int bytesPerSample;
+        char* data = nullptr;
+        juce::HeapBlock<char> memory;
+        juce::File tempFile;
+        std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+
+        char* getFrame (SampleCount position) const
+        {
+            return data + (size_t) (position % numFrames) * (size_t) (numChannels * bytesPerSample);
+        }
+
+        void writeSample (char* dest, float sample) const
+        {
+            switch (bytesPerSample)
+            {
+                case 2:
+                {
+                    auto v = (juce::int16) juce::roundToInt (juce::jlimit (-1.0f, 1.0f, sample) * 32767.0f);
+                    std::memcpy (dest, &v, sizeof (v));
+                    break;
+                }
+
+                case 3:  juce::ByteOrder::littleEndian24BitToChars (juce::roundToInt (juce::jlimit (-1.0f, 1.0f, sample) * 8388607.0f), dest); break;
+                default: std::memcpy (dest, &sample, sizeof (float)); break;
+            }
+        }
+
+        float readSample (const char* source) const
+        {
+            switch (bytesPerSample)
+            {
+                case 2:  { juce::int16 v; std::memcpy (&v, source, 2); return v / 32767.0f; }
+                case 3:  return juce::ByteOrder::littleEndian24Bit (source) / 8388607.0f;
+                default: { float v; std::memcpy (&v, source, sizeof (float)); return v; }
+            }
+        }
+    };
+
+    std::unique_ptr<Storage> storage;
+    std::atomic<int> requiredNumChannels { 0 };
+    std::atomic<double> requiredSampleRate { 0.0 };
+    double storageLengthInSeconds = 0;
+
+    std::atomic<uint32_t> sequence { 0 };
+    std::atomic<SampleCount> numWritten { 0 };
+    std::atomic<double> lastStreamTime { 0.0 };
+    SampleCount extractedUpTo = 0;
+
+    /** Extra space so the device doesn't catch up with a clip that's being written. */
+    SampleCount getSafetyMargin() const     { return (SampleCount) (sampleRate * 10.0); }
+
+    void timerCallback() override
+    {
+        const auto newNumChannels = requiredNumChannels.load (std::memory_order_relaxed);
+        const auto newSampleRate = requiredSampleRate.load (std::memory_order_relaxed);
+
+        if (newNumChannels <= 0 || newSampleRate <= 0.0)
+            return;
+
+        if (storage != nullptr
+             && storage->numChannels == newNumChannels
+             && sampleRate == newSampleRate
+             && storageLengthInSeconds == lengthInSeconds)
+            return;
+
+        // Allocate the new buffer before swapping it in so the device is only blocked for the swap
+        const auto newLengthInSeconds = lengthInSeconds.load();
+        auto newStorage = std::make_unique<Storage> (engine, newNumChannels,
+                                                     std::max ((SampleCount) 1, (SampleCount) ((newLengthInSeconds + 10.0) * newSampleRate)),
+                                                     bitDepth, useTempFile);
+
+        {
+            const juce::ScopedLock sl (engine.getDeviceManager().deviceManager.getAudioCallbackLock());
+            std::swap (storage, newStorage);
+            sampleRate = newSampleRate;
+            storageLengthInSeconds = newLengthInSeconds;
+            numWritten = 0;
+            extractedUpTo = 0;
+        }
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RetrospectiveRecordBuffer)
 };
 
@@ -392,7 +623,8 @@ public:
 
             rc->fileWriter = std::make_unique<AudioFileWriter> (AudioFile (edit.engine, recordedFile), format,
                                                                 wi.isStereoPair() ? 2 : 1,
-                                                                rc->sampleRate, wi.bitDepth, metadata, 0);
+                                                                rc->sampleRate, wi.bitDepth, metadata, 0,
+                                                                AudioFileWriteOptions::forRecording());
 
             if (rc->fileWriter->isOpen())
             {
@@ -539,6 +771,22 @@ public:
         }
     }
 
+    void finishRecordingFiles (std::vector<EditItemID> targetsToStop) override
+    {
+        CRASH_TRACER
+        const std::shared_lock sl (contextLock);
+
+        for (auto& recContext : recordingContexts)
+        {
+            if (! targetsToStop.empty())
+                if (! contains_v (targetsToStop, recContext->targetID))
+                    continue;
+
+            if (recContext->isWaitingToClose.load (std::memory_order_acquire))
+                recContext->finishFile();
+        }
+    }
+
     tl::expected<Clip::Array, juce::String> stopRecording (StopRecordingParameters params) override
     {
         TRACKTION_ASSERT_MESSAGE_THREAD
@@ -697,6 +945,7 @@ public:
 
         std::function<void (tl::expected<Clip::Array, juce::String>)> stopCallback;
         StopRecordingParameters stopParams;
+        std::optional<AudioFileInfo> finishedFileInfo;  /**< Set if the file was finished by finishFile. */
 
         void addBlockToRecord (const juce::AudioBuffer<float>& buffer, int start, int numSamples)
         {
@@ -733,6 +982,18 @@ public:
             if (extractedFileWriter)
                 engine.getWaveInputRecordingThread().waitForWriterToFinish (*extractedFileWriter);
         }
+
+        /** Closes the file writer and reads back the file's info.
+            This can be called on any thread once the context has stopped recording.
+        */
+        void finishFile()
+        {
+            CRASH_TRACER
+            closeFileWriter();
+
+            if (file.existsAsFile() && file.getSize() > 0)
+                finishedFileInfo = AudioFileInfo::parse (AudioFile (engine, file));
+        }
     };
 
     tl::expected<Clip::Array, juce::String> applyRecording (std::unique_ptr<WaveRecordingContext> rc,
@@ -789,7 +1050,11 @@ public:
         CRASH_TRACER
         auto& engine = edit.engine;
         auto& afm = engine.getAudioFileManager();
-        afm.forceFileUpdate (recordedFile);
+
+        if (rc.finishedFileInfo)
+            afm.forceFileUpdate (recordedFile, *rc.finishedFileInfo);
+        else
+            afm.forceFileUpdate (recordedFile);
 
         auto recordedFileLength = TimeDuration::fromSeconds (recordedFile.getLength());
 
@@ -1041,27 +1306,18 @@ public:
 
             const auto recordedFile = res.value();
             juce::StringPairArray metadata;
+            double lastStreamTime = 0.0;
 
             {
                 AudioFileWriter writer (AudioFile (dstTrack->edit.engine, recordedFile), format,
-                                        recordBuffer->numChannels,
+                                        recordBuffer->getNumChannels(),
                                         recordBuffer->sampleRate,
-                                        wi.bitDepth, metadata, 0);
+                                        wi.bitDepth, metadata, 0,
+                                        AudioFileWriteOptions::forRecording());
 
                 if (writer.isOpen())
-                {
-                    int numReady;
-                    juce::AudioBuffer<float> scratchBuffer (recordBuffer->numChannels, 1000);
-
-                    while ((numReady = recordBuffer->fifo.getNumReady()) > 0)
-                    {
-                        auto toRead = std::min (numReady, scratchBuffer.getNumSamples());
-
-                        if (! recordBuffer->fifo.read (scratchBuffer, 0, toRead)
-                             || ! writer.appendBuffer (scratchBuffer, toRead))
-                            return nullptr;
-                    }
-                }
+                    if (! recordBuffer->writeTo (writer, lastStreamTime))
+                        return nullptr;
             }
 
             auto proj = getProjectForEdit (edit);
@@ -1099,10 +1355,11 @@ public:
 
                 if (context.isPlaying())
                 {
-                    start = context.globalStreamTimeToEditTime (recordBuffer->lastStreamTime) - recordedLength + adjust;
+                    start = context.globalStreamTimeToEditTime (lastStreamTime) - recordedLength + adjust;
                 }
                 else
                 {
+                    const juce::SpinLock::ScopedLockType sl (recordBuffer->editInfoLock);
                     auto& pei = recordBuffer->editInfo[edit.getProjectItemID()];
                     start = pei.lastEditTime + pei.pausedTime - recordedLength + adjust;
                     pei.lastEditTime = -1s;
@@ -1185,28 +1442,62 @@ public:
         }
     }
 
+    /** If this input's channels are a contiguous run of the device's channels in
+        the same order, points incomingDataView at them and returns true.
+        The view is only valid for the duration of the device callback.
+    */
+    bool referToIncomingData (const float* const* allChannels, int numChannels, int numSamples)
+    {
+        auto& wi = getWaveInput();
+        auto& channelSet = wi.getChannelSet();
+        auto& channels = wi.getChannels();
+
+        if (numChannels == 0 || channels.empty() || (int) channels.size() != channelSet.size())
+            return false;
+
+        const int firstIndex = channels.front().indexInDevice;
+
+        if (firstIndex < 0 || firstIndex + channelSet.size() > numChannels)
+            return false;
+
+        for (const auto& ci : channels)
+            if (ci.indexInDevice - firstIndex != channelSet.getChannelIndexForType (ci.channel))
+                return false;
+
+        // Nothing writes to this buffer so the device data won't be modified
+        incomingDataView.setDataToReferTo (const_cast<float* const*> (allChannels + firstIndex),
+                                           channelSet.size(), numSamples);
+        return true;
+    }
+
     void acceptInputBuffer (const float* const* allChannels, int numChannels, int numSamples,
                             double streamTime, LevelMeasurer* measurerToUpdate,
                             RetrospectiveRecordBuffer* retrospectiveBuffer, bool addToRetrospective)
     {
         CRASH_TRACER
-        copyIncomingDataIntoBuffer (allChannels, numChannels, numSamples);
-
         auto inputGainDb = getWaveInput().inputGainDb;
+        const bool needsGain = inputGainDb > 0.01f || inputGainDb < -0.01f;
+
+        // Without any gain to apply, the device's channels can often be used in place
+        auto& block = (! needsGain && referToIncomingData (allChannels, numChannels, numSamples))
+                        ? incomingDataView : inputBuffer;
+
+        if (&block == &inputBuffer)
+            copyIncomingDataIntoBuffer (allChannels, numChannels, numSamples);
 
-        if (inputGainDb > 0.01f || inputGainDb < -0.01f)
+        if (needsGain)
             inputBuffer.applyGain (0, numSamples, dbToGain (inputGainDb));
 
         if (measurerToUpdate != nullptr)
-            measurerToUpdate->processBuffer (inputBuffer, 0, numSamples);
+            measurerToUpdate->processBuffer (block, 0, numSamples);
 
         if (retrospectiveBuffer != nullptr)
         {
             if (addToRetrospective)
             {
-                retrospectiveBuffer->updateSizeIfNeeded (inputBuffer.getNumChannels(),
-                                                         edit.engine.getDeviceManager().getSampleRate());
-                retrospectiveBuffer->processBuffer (streamTime, inputBuffer, numSamples);
+                if (retrospectiveBuffer->updateSizeIfNeeded (block.getNumChannels(),
+                                                             edit.engine.getDeviceManager().getSampleRate()))
+                    retrospectiveBuffer->processBuffer (streamTime, block, numSamples);
             }
 
             retrospectiveBuffer->syncToEdit (edit, context, streamTime, numSamples);
@@ -1216,8 +1507,8 @@ public:
             const juce::ScopedLock sl (consumerLock);
 
             for (auto n : consumers)
-                n->acceptInputBuffer (choc::buffer::createChannelArrayView (inputBuffer.getArrayOfWritePointers(),
-                                                                            (choc::buffer::ChannelCount) inputBuffer.getNumChannels(),
+                n->acceptInputBuffer (choc::buffer::createChannelArrayView (block.getArrayOfWritePointers(),
+                                                                            (choc::buffer::ChannelCount) block.getNumChannels(),
                                                                             (choc::buffer::FrameCount) numSamples));
         }
 
@@ -1240,7 +1531,7 @@ public:
                 {
                     if (! recordingContext->hasHitThreshold)
                     {
-                        auto bufferLevelDb = gainToDb (inputBuffer.getMagnitude (0, numSamples));
+                        auto bufferLevelDb = gainToDb (block.getMagnitude (0, numSamples));
                         recordingContext->hasHitThreshold = bufferLevelDb > getWaveInput().recordTriggerDb;
 
                         if (! recordingContext->hasHitThreshold)
@@ -1265,7 +1556,7 @@ public:
                     if (adjustSamples < 0)
                     {
                         // add silence
-                        AudioScratchBuffer silence (inputBuffer.getNumChannels(), -adjustSamples);
+                        AudioScratchBuffer silence (block.getNumChannels(), -adjustSamples);
                         silence.buffer.clear();
 
                         recordingContext->addBlockToRecord (silence.buffer, 0, silence.buffer.getNumSamples());
@@ -1280,13 +1571,13 @@ public:
                         }
                         else
                         {
-                            recordingContext->addBlockToRecord (inputBuffer, adjustSamples, numSamples - adjustSamples);
+                            recordingContext->addBlockToRecord (block, adjustSamples, numSamples - adjustSamples);
                             recordingContext->adjustSamples = 0;
                         }
                     }
                     else
                     {
-                        recordingContext->addBlockToRecord (inputBuffer, 0, numSamples);
+                        recordingContext->addBlockToRecord (block, 0, numSamples);
                     }
                 }
             }
@@ -1298,7 +1589,7 @@ protected:
     std::vector<std::unique_ptr<WaveRecordingContext>> recordingContexts;
     std::unique_ptr<RecordStopper> recordStopper;
 
-    juce::AudioBuffer<float> inputBuffer;
+    juce::AudioBuffer<float> inputBuffer, incomingDataView;
 
     WaveRecordingContext* getContextForID (EditItemID targetID) const
     {
@@ -1687,7 +1978,7 @@ void WaveInputDevice::consumeNextAudioBlock (const float* const* allChannels, in
         {
             i->acceptInputBuffer (allChannels, numChannels, numSamples, streamTime,
                                   isFirst ? &levelMeasurer : nullptr,
-                                  (! retrospectiveRecordLock) ? retrospectiveBuffer.get() : nullptr, isFirst);
+                                  retrospectiveBuffer.get(), isFirst);
             isFirst = false;
         }
     }
@@ -1703,9 +1994,13 @@ void WaveInputDevice::updateRetrospectiveBufferLength (double length)
 //==============================================================================
 struct WaveInputRecordingThread::BlockQueue
 {
+    // Enough for a few blocks of 128 inputs, and sized so a load won't need to reallocate
+    static constexpr int numPreallocatedBlocks = 1024;
+    static constexpr int preallocatedNumChannels = 2, preallocatedNumSamples = 2048;
+
     BlockQueue()
     {
-        for (int i = 32; --i >= 0;)
+        for (int i = numPreallocatedBlocks; --i >= 0;)
             addToFreeQueue (new QueuedBlock());
     }
 
@@ -1716,7 +2011,7 @@ struct WaveInputRecordingThread::BlockQueue
         void load (AudioFileWriter& w, const juce::AudioBuffer<float>& newBuffer,
                    int start, int numSamples, const RecordingThumbnailManager::Thumbnail::Ptr& thumb)
         {
-            buffer.setSize (newBuffer.getNumChannels(), numSamples);
+            buffer.setSize (newBuffer.getNumChannels(), numSamples, false, false, true);
 
             for (int i = buffer.getNumChannels(); --i >= 0;)
                 buffer.copyFrom (i, 0, newBuffer, i, start, numSamples);
@@ -1727,35 +2022,41 @@ struct WaveInputRecordingThread::BlockQueue
 
         std::atomic<AudioFileWriter*> writer { nullptr };
         QueuedBlock* next = nullptr;
-        juce::AudioBuffer<float> buffer { 2, 512 };
+        juce::AudioBuffer<float> buffer { preallocatedNumChannels, preallocatedNumSamples };
         RecordingThumbnailManager::Thumbnail::Ptr thumbnail;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (QueuedBlock)
     };
 
-    juce::CriticalSection freeQueueLock, pendingQueueLock;
+    // These are only held for a few pointer swaps so are safe to take on the audio thread
+    mutable RealTimeSpinLock freeQueueLock, pendingQueueLock;
     QueuedBlock* firstPending = nullptr;
     QueuedBlock* lastPending = nullptr;
+    QueuedBlock* firstInFlight = nullptr;
     QueuedBlock* firstFree = nullptr;
     std::atomic<int> numPending { 0 };
 
     QueuedBlock* findFreeBlock()
     {
-        const juce::ScopedLock sl (freeQueueLock);
+        {
+            const std::scoped_lock sl (freeQueueLock);
 
-        if (firstFree == nullptr)
-            return new QueuedBlock();
+            if (auto* b = firstFree)
+            {
+                firstFree = b->next;
+                b->next = nullptr;
+                return b;
+            }
+        }
 
-        auto* b = firstFree;
-        firstFree = b->next;
-        b->next = nullptr;
-        return b;
+        // The pool has run out so the writer thread must be falling behind
+        return new QueuedBlock();
     }
 
     void addToFreeQueue (QueuedBlock* b) noexcept
     {
         jassert (b != nullptr);
-        const juce::ScopedLock sl (freeQueueLock);
+        const std::scoped_lock sl (freeQueueLock);
         b->writer = nullptr;
         b->next = firstFree;
         firstFree = b;
@@ -1765,7 +2066,7 @@ struct WaveInputRecordingThread::BlockQueue
     {
         jassert (b != nullptr);
         b->next = nullptr;
-        const juce::ScopedLock sl (pendingQueueLock);
+        const std::scoped_lock sl (pendingQueueLock);
 
         if (lastPending != nullptr)
             lastPending->next = b;
@@ -1778,7 +2079,7 @@ struct WaveInputRecordingThread::BlockQueue
 
     QueuedBlock* removeFirstPending() noexcept
     {
-        const juce::ScopedLock sl (pendingQueueLock);
+        const std::scoped_lock sl (pendingQueueLock);
 
         if (auto b = firstPending)
         {
@@ -1794,8 +2095,46 @@ struct WaveInputRecordingThread::BlockQueue
         return {};
     }
 
+    /** Moves all the pending blocks to the in-flight list and adds them to the array in order.
+        They still count as being in the queue for isWriterInQueue until releaseInFlightBlocks is called.
+    */
+    void takeAllPending (std::vector<QueuedBlock*>& dest)
+    {
+        dest.clear();
+
+        {
+            const std::scoped_lock sl (pendingQueueLock);
+            jassert (firstInFlight == nullptr);
+            firstInFlight = firstPending;
+            firstPending = nullptr;
+            lastPending = nullptr;
+            numPending = 0;
+        }
+
+        for (auto b = firstInFlight; b != nullptr; b = b->next)
+            dest.push_back (b);
+    }
+
+    void releaseInFlightBlocks() noexcept
+    {
+        auto b = [this]
+        {
+            const std::scoped_lock sl (pendingQueueLock);
+            return std::exchange (firstInFlight, nullptr);
+        }();
+
+        while (b != nullptr)
+        {
+            auto next = b->next;
+            addToFreeQueue (b);
+            b = next;
+        }
+    }
+
     void moveAnyPendingBlocksToFree() noexcept
     {
+        releaseInFlightBlocks();
+
         while (auto b = removeFirstPending())
             addToFreeQueue (b);
 
@@ -1805,11 +2144,12 @@ struct WaveInputRecordingThread::BlockQueue
 
     bool isWriterInQueue (AudioFileWriter& writer) const
     {
-        const juce::ScopedLock sl (pendingQueueLock);
+        const std::scoped_lock sl (pendingQueueLock);
 
-        for (auto b = firstPending; b != nullptr; b = b->next)
-            if (b->writer == &writer)
-                return true;
+        for (auto list : { firstPending, firstInFlight })
+            for (auto b = list; b != nullptr; b = b->next)
+                if (b->writer == &writer)
+                    return true;
 
         return false;
     }
@@ -1878,6 +2218,12 @@ void WaveInputRecordingThread::run()
     CRASH_TRACER
     juce::FloatVectorOperations::disableDenormalisedNumberSupport();
 
+    // Each writer's blocks are coalesced in to this so they can be written with a single call
+    constexpr int maxSamplesPerWrite = 32768;
+    juce::AudioBuffer<float> batchBuffer (BlockQueue::preallocatedNumChannels, maxSamplesPerWrite);
+    std::vector<BlockQueue::QueuedBlock*> blocks;
+    blocks.reserve (BlockQueue::numPreallocatedBlocks);
+
     for (;;)
     {
         if (queue->numPending > 500 && ! hasWarned)
@@ -1886,33 +2232,76 @@ void WaveInputRecordingThread::run()
             TRACKTION_LOG_ERROR ("Audio recording can't keep up!");
         }
 
-        if (auto block = queue->removeFirstPending())
+        queue->takeAllPending (blocks);
+
+        if (blocks.empty())
         {
-            if (! block->writer.load()->appendBuffer (block->buffer, block->buffer.getNumSamples()))
+            if (threadShouldExit())
+                break;
+
+            wait (401);
+            continue;
+        }
+
+        // Group the blocks by file, keeping them in order for each file
+        std::stable_sort (blocks.begin(), blocks.end(),
+                          [] (auto a, auto b) { return a->writer.load() < b->writer.load(); });
+
+        for (size_t i = 0; i < blocks.size();)
+        {
+            auto writer = blocks[i]->writer.load();
+            batchBuffer.setSize (blocks[i]->buffer.getNumChannels(), maxSamplesPerWrite, false, false, true);
+            int numBatched = 0;
+
+            auto append = [this, writer] (juce::AudioBuffer<float>& buffer, int numSamples)
             {
-                if (! hasSentStop)
+                if (! writer->appendBuffer (buffer, numSamples) && ! hasSentStop)
                 {
                     hasSentStop = true;
                     TRACKTION_LOG_ERROR ("Audio recording failed to write to disk!");
                     startTimer (1);
                 }
-            }
+            };
+
+            auto writeBatch = [&]
+            {
+                if (numBatched > 0)
+                    append (batchBuffer, numBatched);
 
-            if (block->thumbnail != nullptr)
+                numBatched = 0;
+            };
+
+            for (; i < blocks.size() && blocks[i]->writer.load() == writer; ++i)
             {
-                block->thumbnail->addBlock (block->buffer, 0, block->buffer.getNumSamples());
-                block->thumbnail = nullptr;
+                auto& block = *blocks[i];
+                const auto numSamples = block.buffer.getNumSamples();
+
+                if (numBatched + numSamples > maxSamplesPerWrite)
+                    writeBatch();
+
+                if (numSamples > maxSamplesPerWrite)
+                {
+                    append (block.buffer, numSamples);
+                }
+                else
+                {
+                    for (int chan = std::min (batchBuffer.getNumChannels(), block.buffer.getNumChannels()); --chan >= 0;)
+                        batchBuffer.copyFrom (chan, numBatched, block.buffer, chan, 0, numSamples);
+
+                    numBatched += numSamples;
+                }
+
+                if (block.thumbnail != nullptr)
+                {
+                    block.thumbnail->addBlock (block.buffer, 0, numSamples);
+                    block.thumbnail = nullptr;
+                }
             }
 
-            queue->addToFreeQueue (block);
+            writeBatch();
         }
-        else
-        {
-            if (threadShouldExit())
-                break;
 
-            wait (401);
-        }
+        queue->releaseInFlightBlocks();
     }
 }
 
@@ -0,0 +1,342 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+AnticipativeRenderNode::RenderState::RenderState (tracktion::graph::PlayHead& playHead, const tempo::Sequence* tempoSequence)
+    : playHeadState (playHead),
+      processState (playHeadState)
+{
+    processState.setUpdatesPlayHead (false);
+
+    if (tempoSequence != nullptr)
+        processState.setTempoSequence (tempoSequence);
+}
+
+//==============================================================================
+AnticipativeRenderNode::AnticipativeRenderNode (EditItemID itemIDToUse,
+                                                std::unique_ptr<RenderState> renderStateToUse,
+                                                std::unique_ptr<tracktion::graph::Node> inputNode,
+                                                int numBlocksToRenderAhead_)
+    : itemID (itemIDToUse),
+      renderState (std::move (renderStateToUse)),
+      input (std::move (inputNode)),
+      numBlocksToRenderAhead (std::max (1, numBlocksToRenderAhead_))
+{
+    jassert (renderState != nullptr);
+    jassert (input != nullptr);
+
+    setOptimisations ({ tracktion::graph::ClearBuffers::no,
+                        tracktion::graph::AllocateAudioBuffer::yes });
+}
+
+AnticipativeRenderNode::~AnticipativeRenderNode()
+{
+    workerPool->removeClient (*this);
+}
+
+//==============================================================================
+tracktion::graph::NodeProperties AnticipativeRenderNode::getNodeProperties()
+{
+    constexpr size_t anticipativeRenderMagicHash = size_t (0x616e7469636970);
+
+    auto props = getInput().getNodeProperties();
+    props.nodeID = (size_t) stable_hash (anticipativeRenderMagicHash, itemID.getRawID());
+
+    return props;
+}
+
+std::vector<tracktion::graph::Node*> AnticipativeRenderNode::getDirectInputNodes()
+{
+    // The input is processed by our own player so isn't part of the main graph
+    return {};
+}
+
+std::vector<tracktion::graph::Node*> AnticipativeRenderNode::getInternalNodes()
+{
+    return { &getInput() };
+}
+
+void AnticipativeRenderNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
+{
+    AnticipativeRenderNode* nodeToReplace = nullptr;
+
+    if (info.nodeGraphToReplace != nullptr)
+    {
+        // The Nodes being replaced use the same plugins as us so mustn't be rendered on the
+        // workers any more. Until the new graph is swapped in, they'll render on the audio thread
+        for (auto node : info.nodeGraphToReplace->orderedNodes)
+            if (auto oldNode = dynamic_cast<AnticipativeRenderNode*> (node))
+                oldNode->stopRendering();
+
+        nodeToReplace = findNodeWithID<AnticipativeRenderNode> (*info.nodeGraphToReplace, getNodeProperties().nodeID);
+    }
+
+    workerPool->removeClient (*this);
+
+    {
+        const std::scoped_lock sl (processMutex);
+        sampleRate = info.sampleRate;
+        blockSize = info.blockSize;
+
+        // Preparing the input with the graph it's replacing keeps it continuous between graph loads
+        if (input)
+            nodeGraph = nodePlayer.prepareToPlay (std::move (input), nodeToReplace != nullptr ? nodeToReplace->nodeGraph.get() : nullptr,
+                                                  sampleRate, blockSize);
+        else
+            nodeGraph = nodePlayer.prepareToPlay (std::move (nodeGraph->rootNode), nullptr, sampleRate, blockSize);
+
+        const auto numChannels = (choc::buffer::ChannelCount) getInput().getNodeProperties().numberOfChannels;
+        blocks.resize ((size_t) numBlocksToRenderAhead + 1);
+
+        for (auto& block : blocks)
+        {
+            block.audio = choc::buffer::ChannelArrayBuffer<float> (numChannels, (choc::buffer::FrameCount) blockSize);
+            block.midi.reserve (128);
+        }
+
+        scratchMidi.reserve (128);
+        fifo = std::make_unique<juce::AbstractFifo> ((int) blocks.size());
+        readOffset = 0;
+        nextReferenceSampleToRender.store (-1, std::memory_order_release);
+    }
+
+    workerPool->addClient (*this);
+}
+
+bool AnticipativeRenderNode::isReadyToProcess()
+{
+    return true;
+}
+
+void AnticipativeRenderNode::process (ProcessContext& pc)
+{
+    auto destAudio = pc.buffers.audio;
+    auto& destMidi = pc.buffers.midi;
+    const auto referenceSampleRange = pc.referenceSampleRange;
+    jassert (referenceSampleRange.getLength() == (int64_t) pc.numSamples);
+    destMidi.clear();
+
+    auto numRead = readBlocks (referenceSampleRange, destAudio, destMidi, 0.0);
+
+    if (numRead < pc.numSamples)
+    {
+        // If a worker is rendering a block we can't wait for it to finish so
+        // output silence for the rest of this block and try again next time
+        const std::unique_lock sl (processMutex, std::try_to_lock);
+
+        if (! sl.owns_lock())
+        {
+            numUnderruns.fetch_add (1, std::memory_order_relaxed);
+            totalNumUnderruns.fetch_add (1, std::memory_order_relaxed);
+            destAudio.fromFrame (numRead).clear();
+            workerPool->flagForProcessing (*this);
+            return;
+        }
+
+        // A worker might have just finished the next block so check again
+        numRead += readBlocks (referenceSampleRange.withStart (referenceSampleRange.getStart() + numRead),
+                               destAudio.fromFrame (numRead), destMidi, numRead / sampleRate);
+
+        if (numRead < pc.numSamples)
+        {
+            numUnderruns.fetch_add (1, std::memory_order_relaxed);
+            totalNumUnderruns.fetch_add (1, std::memory_order_relaxed);
+
+            // Anything rendered is now out of date so discard it and carry on from the end of this block
+            fifo->reset();
+            readOffset = 0;
+
+            render (referenceSampleRange.withStart (referenceSampleRange.getStart() + numRead),
+                    destAudio.fromFrame (numRead), destMidi, numRead / sampleRate);
+            nextReferenceSampleToRender.store (referenceSampleRange.getEnd(), std::memory_order_release);
+        }
+    }
+
+    workerPool->flagForProcessing (*this);
+}
+
+//==============================================================================
+tracktion::graph::Node& AnticipativeRenderNode::getInput()
+{
+    return input != nullptr ? *input : *nodeGraph->rootNode;
+}
+
+tracktion::graph::PlayHead& AnticipativeRenderNode::getPlayHead()
+{
+    return renderState->playHeadState.playHead;
+}
+
+void AnticipativeRenderNode::stopRendering()
+{
+    // Once this returns, none of the workers can be rendering this instance
+    workerPool->removeClient (*this);
+}
+
+int AnticipativeRenderNode::getNumBlocksReady() const
+{
+    return fifo->getNumReady();
+}
+
+std::optional<double> AnticipativeRenderNode::getSecondsUntilDeadline()
+{
+    const auto numReady = getNumBlocksReady();
+
+    if (numReady >= numBlocksToRenderAhead)
+        return {};
+
+    return numReady * blockSize / sampleRate;
+}
+
+bool AnticipativeRenderNode::processNextChunk()
+{
+    return renderNextBlock();
+}
+
+bool AnticipativeRenderNode::renderNextBlock()
+{
+    const std::unique_lock sl (processMutex, std::try_to_lock);
+
+    if (! sl.owns_lock())
+        return false;
+
+    // Wait until the audio thread has told us where to start
+    const auto startSample = nextReferenceSampleToRender.load (std::memory_order_acquire);
+
+    if (startSample < 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    fifo->prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+        return false;
+
+    auto& playHead = getPlayHead();
+    const auto version = playHead.getTimelineMappingVersion();
+
+    auto& block = blocks[(size_t) start1];
+    block.referenceSampleRange = { startSample, startSample + blockSize };
+    block.timelineMappingVersion = version;
+    block.midi.clear();
+    render (block.referenceSampleRange, block.audio.getView(), block.midi, 0.0);
+
+    // If the play head changed whilst rendering, the block might have used the old
+    // position so leave it to be rendered again
+    if (playHead.getTimelineMappingVersion() != version)
+        return true;
+
+    nextReferenceSampleToRender.store (block.referenceSampleRange.getEnd(), std::memory_order_release);
+    fifo->finishedWrite (1);
+
+    return true;
+}
+
+choc::buffer::FrameCount AnticipativeRenderNode::readBlocks (juce::Range<int64_t> referenceSampleRange,
+                                                              choc::buffer::ChannelArrayView<float> destAudio,
+                                                              MidiMessageArray& destMidi, double midiTimeOffset)
+{
+    const auto version = getPlayHead().getTimelineMappingVersion();
+    const auto numFrames = (choc::buffer::FrameCount) referenceSampleRange.getLength();
+    choc::buffer::FrameCount numRead = 0;
+
+    while (numRead < numFrames)
+    {
+        int start1, size1, start2, size2;
+        fifo->prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            break;
+
+        auto& block = blocks[(size_t) start1];
+
+        if (block.timelineMappingVersion != version
+            || block.referenceSampleRange.getStart() + readOffset != referenceSampleRange.getStart() + numRead)
+            break;
+
+        const auto blockLength = (choc::buffer::FrameCount) block.referenceSampleRange.getLength();
+        const auto startFrame = (choc::buffer::FrameCount) readOffset;
+        const auto numToRead = std::min (numFrames - numRead, blockLength - startFrame);
+        const bool isEndOfBlock = startFrame + numToRead == blockLength;
+
+        copy (destAudio.getFrameRange ({ numRead, numRead + numToRead }),
+              block.audio.getView().getFrameRange ({ startFrame, startFrame + numToRead }));
+
+        const auto startTime = startFrame / sampleRate;
+        const auto endTime = (startFrame + numToRead) / sampleRate;
+        const auto timeOffset = midiTimeOffset + numRead / sampleRate - startTime;
+
+        for (auto& m : block.midi)
+        {
+            const auto time = m.getTimeStamp();
+
+            if (time >= startTime && (isEndOfBlock || time < endTime))
+                destMidi.add (m, time + timeOffset);
+        }
+
+        if (startFrame == 0 && block.midi.isAllNotesOff)
+            destMidi.isAllNotesOff = true;
+
+        numRead += numToRead;
+        readOffset += (int) numToRead;
+
+        if (isEndOfBlock)
+        {
+            readOffset = 0;
+            fifo->finishedRead (1);
+        }
+    }
+
+    return numRead;
+}
+
+void AnticipativeRenderNode::render (juce::Range<int64_t> referenceSampleRange,
+                                     choc::buffer::ChannelArrayView<float> destAudio,
+                                     MidiMessageArray& destMidi, double midiTimeOffset)
+{
+    // Check to see if the timeline needs to be processed in two halves due to looping
+    const auto splitTimelineRange = referenceSampleRangeToSplitTimelineRange (getPlayHead(), referenceSampleRange);
+
+    if (splitTimelineRange.isSplit)
+    {
+        const auto firstRangeLength = (choc::buffer::FrameCount) splitTimelineRange.timelineRange1.getLength();
+
+        renderSection (referenceSampleRange.withLength (firstRangeLength),
+                       destAudio.getStart (firstRangeLength), destMidi, midiTimeOffset);
+        renderSection (referenceSampleRange.withStart (referenceSampleRange.getStart() + firstRangeLength),
+                       destAudio.fromFrame (firstRangeLength), destMidi, midiTimeOffset + firstRangeLength / sampleRate);
+    }
+    else
+    {
+        renderSection (referenceSampleRange, destAudio, destMidi, midiTimeOffset);
+    }
+}
+
+void AnticipativeRenderNode::renderSection (juce::Range<int64_t> referenceSampleRange,
+                                            choc::buffer::ChannelArrayView<float> destAudio,
+                                            MidiMessageArray& destMidi, double midiTimeOffset)
+{
+    if (referenceSampleRange.isEmpty())
+        return;
+
+    renderState->processState.update (sampleRate, referenceSampleRange, ProcessState::UpdateContinuityFlags::yes);
+
+    // The player adds the output to the buffers so they need to be cleared first
+    destAudio.clear();
+    scratchMidi.clear();
+
+    nodePlayer.processPostorderedNodes (*nodeGraph, { destAudio.getNumFrames(), referenceSampleRange, { destAudio, scratchMidi } });
+    destMidi.mergeFromWithOffset (scratchMidi, midiTimeOffset);
+}
+
+}} // namespace tracktion { inline namespace engine
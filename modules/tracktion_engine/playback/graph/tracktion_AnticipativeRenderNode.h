@@ -0,0 +1,132 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Renders a Node on background threads a number of blocks ahead of the audio
+    callback and returns the rendered blocks when the callback reaches them.
+
+    The input must be created with the ProcessState from the RenderState passed
+    in so it can be processed for reference sample ranges in the future, without
+    touching the PlayHead. It isn't part of the main graph so mustn't contain any
+    Nodes that need to connect to Nodes outside of it (e.g. sends and returns).
+
+    If the PlayHead's timeline mapping changes after a block is rendered (i.e. it
+    is repositioned, started, stopped or looped) or the background threads haven't
+    kept up, the rendered blocks are discarded and the input is processed on the
+    audio thread instead. The audio thread never waits for a background thread
+    though, so if one is in the middle of rendering a block at that point, the
+    rest of the block is output as silence and counted as an underrun.
+
+    N.B. Real-time changes to the input such as plugin parameters or mute states
+    will be heard a few blocks late so only use this for tracks that aren't
+    monitoring live input.
+*/
+class AnticipativeRenderNode final :  public tracktion::graph::Node,
+                                      private tracktion::graph::DeadlineWorkerPool::Client
+{
+public:
+    //==============================================================================
+    /** Holds the PlayHeadState and ProcessState the input should be created with. */
+    struct RenderState
+    {
+        RenderState (tracktion::graph::PlayHead&, const tempo::Sequence*);
+
+        tracktion::graph::PlayHeadState playHeadState;
+        ProcessState processState;
+    };
+
+    //==============================================================================
+    /** Creates an AnticipativeRenderNode.
+        @param itemID                   The ID of the item being rendered, used to find this Node between graph loads
+        @param renderState              The state the input was created with
+        @param input                    The Node to render ahead
+        @param numBlocksToRenderAhead   The number of blocks to try and keep rendered
+    */
+    AnticipativeRenderNode (EditItemID itemID,
+                            std::unique_ptr<RenderState> renderState,
+                            std::unique_ptr<tracktion::graph::Node> input,
+                            int numBlocksToRenderAhead = 8);
+
+    /** Destructor. */
+    ~AnticipativeRenderNode() override;
+
+    //==============================================================================
+    /** Returns the number of times the rendered blocks couldn't be used, either
+        because the PlayHead changed or the background threads hadn't rendered the
+        blocks in time. The input will have been processed on the audio thread or,
+        if a background thread was busy with it, the block filled with silence.
+    */
+    std::uint64_t getNumUnderruns() const           { return numUnderruns.load (std::memory_order_relaxed); }
+
+    /** Returns the total number of underruns across all instances. */
+    static std::uint64_t getTotalNumUnderruns()     { return totalNumUnderruns.load (std::memory_order_relaxed); }
+
+    //==============================================================================
+    tracktion::graph::NodeProperties getNodeProperties() override;
+    std::vector<Node*> getDirectInputNodes() override;
+    std::vector<Node*> getInternalNodes() override;
+    void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
+    bool isReadyToProcess() override;
+    void process (ProcessContext&) override;
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        choc::buffer::ChannelArrayBuffer<float> audio;
+        MidiMessageArray midi;
+        juce::Range<int64_t> referenceSampleRange;
+        uint32_t timelineMappingVersion = 0;
+    };
+
+    const EditItemID itemID;
+    std::unique_ptr<RenderState> renderState;
+    std::unique_ptr<tracktion::graph::Node> input;
+    std::unique_ptr<tracktion::graph::NodeGraph> nodeGraph;
+    tracktion::graph::NodePlayer nodePlayer;
+    const int numBlocksToRenderAhead;
+
+    std::vector<Block> blocks;
+    std::unique_ptr<juce::AbstractFifo> fifo;
+    int readOffset = 0;
+    std::atomic<int64_t> nextReferenceSampleToRender { 0 };
+    std::mutex processMutex;
+    MidiMessageArray scratchMidi;
+    double sampleRate = 44100.0;
+    int blockSize = 0;
+    std::atomic<std::uint64_t> numUnderruns { 0 };
+    inline static std::atomic<std::uint64_t> totalNumUnderruns { 0 };
+
+    juce::SharedResourcePointer<tracktion::graph::DeadlineWorkerPool> workerPool;
+
+    //==============================================================================
+    tracktion::graph::Node& getInput();
+    tracktion::graph::PlayHead& getPlayHead();
+
+    void stopRendering();
+    int getNumBlocksReady() const;
+    bool renderNextBlock();
+    choc::buffer::FrameCount readBlocks (juce::Range<int64_t>, choc::buffer::ChannelArrayView<float>, MidiMessageArray&, double midiTimeOffset);
+    void render (juce::Range<int64_t>, choc::buffer::ChannelArrayView<float>, MidiMessageArray&, double midiTimeOffset);
+    void renderSection (juce::Range<int64_t>, choc::buffer::ChannelArrayView<float>, MidiMessageArray&, double midiTimeOffset);
+
+    //==============================================================================
+    std::optional<double> getSecondsUntilDeadline() override;
+    bool processNextChunk() override;
+};
+
+}} // namespace tracktion { inline namespace engine
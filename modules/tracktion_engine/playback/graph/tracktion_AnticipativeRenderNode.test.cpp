@@ -0,0 +1,186 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLAYBACK
+
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+
+namespace tracktion::inline engine
+{
+
+namespace anticipative_render::test
+{
+    /** Outputs a signal that's a function of the timeline position so any block
+        rendered for the wrong position will be different.
+    */
+    class TimelineSignalNode final  : public tracktion::graph::Node,
+                                      public TracktionEngineNode
+    {
+    public:
+        TimelineSignalNode (ProcessState& processStateToUse)
+            : TracktionEngineNode (processStateToUse)
+        {
+        }
+
+        static float getSample (int64_t timelinePosition)
+        {
+            return 0.5f * std::sin ((float) (timelinePosition % 100000) * 0.01f);
+        }
+
+        tracktion::graph::NodeProperties getNodeProperties() override
+        {
+            tracktion::graph::NodeProperties props;
+            props.hasAudio = true;
+            props.numberOfChannels = 1;
+            props.nodeID = 1;
+            return props;
+        }
+
+        std::vector<tracktion::graph::Node*> getDirectInputNodes() override    { return {}; }
+        bool isReadyToProcess() override                                        { return true; }
+
+        void process (ProcessContext& pc) override
+        {
+            const auto timelineRange = getTimelineSampleRange();
+
+            for (choc::buffer::FrameCount i = 0; i < pc.numSamples; ++i)
+                pc.buffers.audio.getSample (0, i) = getSample (timelineRange.getStart() + (int64_t) i);
+        }
+    };
+
+    /** Plays a TimelineSignalNode directly and another through an AnticipativeRenderNode,
+        both following the same PlayHead.
+    */
+    struct Players
+    {
+        Players (double sampleRate_, int blockSize_)
+            : sampleRate (sampleRate_), blockSize (blockSize_)
+        {
+            auto renderState = std::make_unique<AnticipativeRenderNode::RenderState> (playHead, nullptr);
+            auto input = std::make_unique<TimelineSignalNode> (renderState->processState);
+            auto node = std::make_unique<AnticipativeRenderNode> (EditItemID::fromRawID (1), std::move (renderState), std::move (input));
+            anticipativeNode = node.get();
+
+            directPlayer = std::make_unique<TracktionNodePlayer> (std::make_unique<TimelineSignalNode> (directProcessState), directProcessState,
+                                                                  sampleRate, blockSize, getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+            anticipativePlayer = std::make_unique<TracktionNodePlayer> (std::move (node), anticipativeProcessState,
+                                                                        sampleRate, blockSize, getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+            directPlayer->setNumThreads (0);
+            anticipativePlayer->setNumThreads (0);
+        }
+
+        /** Processes the next block with both players, giving the workers some time
+            to render ahead first, and returns the largest difference between them.
+        */
+        float processNextBlock()
+        {
+            const juce::Range<int64_t> referenceSampleRange { referenceSamplePosition, referenceSamplePosition + blockSize };
+            referenceSamplePosition += blockSize;
+            float maxDifference = 0.0f;
+
+            choc::buffer::ChannelArrayBuffer<float> direct (1, (choc::buffer::FrameCount) blockSize), anticipative (1, (choc::buffer::FrameCount) blockSize);
+            direct.clear();
+            anticipative.clear();
+            MidiMessageArray midi;
+
+            directPlayer->process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { direct.getView(), midi } });
+            anticipativePlayer->process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { anticipative.getView(), midi } });
+
+            for (int i = 0; i < blockSize; ++i)
+                maxDifference = std::max (maxDifference, std::abs (direct.getSample (0, (choc::buffer::FrameCount) i)
+                                                                   - anticipative.getSample (0, (choc::buffer::FrameCount) i)));
+
+            std::this_thread::sleep_for (std::chrono::milliseconds (5));
+
+            return maxDifference;
+        }
+
+        float processBlocks (int numBlocks)
+        {
+            float maxDifference = 0.0f;
+
+            for (int i = 0; i < numBlocks; ++i)
+                maxDifference = std::max (maxDifference, processNextBlock());
+
+            return maxDifference;
+        }
+
+        const double sampleRate;
+        const int blockSize;
+        int64_t referenceSamplePosition = 0;
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState directPlayHeadState { playHead }, anticipativePlayHeadState { playHead };
+        ProcessState directProcessState { directPlayHeadState }, anticipativeProcessState { anticipativePlayHeadState };
+        AnticipativeRenderNode* anticipativeNode = nullptr;
+        std::unique_ptr<TracktionNodePlayer> directPlayer, anticipativePlayer;
+    };
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("AnticipativeRenderNode")
+    {
+        using namespace anticipative_render::test;
+        Players players (44100.0, 256);
+        auto& playHead = players.playHead;
+        auto& node = *players.anticipativeNode;
+
+        playHead.play ({ 0, 44100 * 60 }, false);
+
+        // The first block is always rendered on the audio thread, after that the
+        // workers should keep up and the rendered blocks should be identical
+        CHECK_EQ (players.processBlocks (50), 0.0f);
+        const auto numUnderrunsWhilstPlaying = node.getNumUnderruns();
+        CHECK (numUnderrunsWhilstPlaying >= 1);
+        CHECK (numUnderrunsWhilstPlaying < 25);
+
+        SUBCASE ("Seeking discards the blocks rendered for the old position")
+        {
+            const auto version = playHead.getTimelineMappingVersion();
+            playHead.setPosition (44100 * 10);
+            CHECK (playHead.getTimelineMappingVersion() != version);
+
+            CHECK_EQ (players.processNextBlock(), 0.0f);
+            CHECK (node.getNumUnderruns() > numUnderrunsWhilstPlaying);
+            CHECK_EQ (players.processBlocks (20), 0.0f);
+        }
+
+        SUBCASE ("Looping discards the blocks rendered past the loop end")
+        {
+            // Loop a short way ahead of the current position so the blocks already
+            // rendered cover the loop end
+            const auto position = playHead.getPosition();
+            const auto version = playHead.getTimelineMappingVersion();
+            playHead.setLoopRange (true, { position - 1000, position + 3 * players.blockSize + 17 });
+            CHECK (playHead.getTimelineMappingVersion() != version);
+
+            // Several times round the loop, which won't be a whole number of blocks
+            CHECK_EQ (players.processBlocks (30), 0.0f);
+            CHECK (node.getNumUnderruns() > numUnderrunsWhilstPlaying);
+
+            playHead.setLoopRange (false, {});
+            CHECK_EQ (players.processBlocks (20), 0.0f);
+        }
+
+        SUBCASE ("Stopping discards the blocks rendered whilst playing")
+        {
+            playHead.stop();
+            CHECK_EQ (players.processBlocks (10), 0.0f);
+
+            playHead.play();
+            CHECK_EQ (players.processBlocks (10), 0.0f);
+        }
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLAYBACK
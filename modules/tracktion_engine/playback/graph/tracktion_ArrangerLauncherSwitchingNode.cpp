@@ -33,6 +33,8 @@ ArrangerLauncherSwitchingNode::ArrangerLauncherSwitchingNode (ProcessState& ps,
         [] (auto& n) { return n.get(); });
     assert (launcherNodesCopy.size() == launcherNodes.size());
     assert (! contains_v (launcherNodesCopy, nullptr));
+
+    activeSlots.resize ((launcherNodes.size() + 63) / 64, 0);
 }
 
 //==============================================================================
@@ -149,9 +151,9 @@ void ArrangerLauncherSwitchingNode::process (ProcessContext& pc)
     //      - If we've just started playing the arranger, fade out the last slot samples and fade in the arranger
     const auto editBeatRange = getEditBeatRange();
     const auto playArranger = ! track->playSlotClips.get();
-    const auto slotStatus = getSlotsStatus (launcherNodes,
-                                            editBeatRange,
-                                            getProcessState().getSyncPoint().monotonicBeat);
+    updateActiveSlots();
+    const auto slotStatus = getActiveSlotsStatus (editBeatRange,
+                                                  getProcessState().getSyncPoint().monotonicBeat);
 
     launcherSampleFader->apply (destAudioView, SampleFader::FadeType::fadeOut);
     arrangerSampleFader->apply (destAudioView, SampleFader::FadeType::fadeOut);
@@ -163,33 +165,41 @@ void ArrangerLauncherSwitchingNode::process (ProcessContext& pc)
 }
 
 //==============================================================================
+template<typename Fn>
+void ArrangerLauncherSwitchingNode::forEachActiveSlot (Fn&& fn)
+{
+    for (size_t word = 0; word < activeSlots.size(); ++word)
+        for (auto bits = activeSlots[word]; bits != 0; bits &= bits - 1)
+            fn (*launcherNodes[word * 64 + (size_t) std::countr_zero (bits)]);
+}
+
 void ArrangerLauncherSwitchingNode::processLauncher (ProcessContext& pc, const SlotClipStatus& slotStatus)
 {
     auto destAudioView = pc.buffers.audio;
     const auto numFrames = destAudioView.getNumFrames();
     const auto editBeatRange = getEditBeatRange();
 
-    if (! launcherNodes.empty())
+    if (slotStatus.anyClipsPlaying || slotStatus.anyClipsQueued)
     {
-        sortPlayingOrQueuedClipsFirst();
-
-        if (slotStatus.anyClipsPlaying || slotStatus.anyClipsQueued)
+        // Playing slots are processed before any that are queued to start
+        for (auto processPlayingSlots : { true, false })
         {
-            for (auto& launcherNode : launcherNodes)
+            forEachActiveSlot ([&] (SlotControlNode& launcherNode)
             {
                 using enum LaunchHandle::PlayState;
                 using enum LaunchHandle::QueueState;
-                const auto& lh = launcherNode->getLaunchHandle();
+                const auto& lh = launcherNode.getLaunchHandle();
                 const bool slotWasPlaying = lh.getPlayingStatus() == playing;
                 const bool slotWasQueued = lh.getQueuedStatus() == playQueued;
 
-                if (! (slotWasPlaying || slotWasQueued))
-                    continue;
+                if (launcherNode.hasProcessed()
+                    || (processPlayingSlots ? ! slotWasPlaying : ! slotWasQueued))
+                    return;
 
-                launcherNode->Node::process (pc.numSamples, pc.referenceSampleRange);
+                launcherNode.Node::process (pc.numSamples, pc.referenceSampleRange);
 
                 const bool slotIsPlaying = lh.getPlayingStatus() == playing;
-                auto sourceBuffers = launcherNode->getProcessedOutput();
+                auto sourceBuffers = launcherNode.getProcessedOutput();
                 const auto numSourceChannels = sourceBuffers.audio.getNumChannels();
 
                 // We can add the whole block here as if the slot is stopped, part of the buffer will just be silent
@@ -204,7 +214,7 @@ void ArrangerLauncherSwitchingNode::processLauncher (ProcessContext& pc, const S
                     launcherSampleFader->trigger (10);
                     launcherSampleFader->applyAt (destAudioView,  endFrame, SampleFader::FadeType::fadeOut);
                 }
-            }
+            });
         }
     }
 
@@ -295,31 +305,40 @@ void ArrangerLauncherSwitchingNode::processArranger (ProcessContext& pc, const S
     }
 }
 
-void ArrangerLauncherSwitchingNode::sortPlayingOrQueuedClipsFirst()
+void ArrangerLauncherSwitchingNode::updateActiveSlots()
 {
-    using enum LaunchHandle::PlayState;
-    using enum LaunchHandle::QueueState;
-    sort (launcherNodes,
-          [](auto& n1, auto& n2)
-              {
-                  auto stateToValue = [] (const LaunchHandle& lh)
-                  {
-                      if (lh.getPlayingStatus() == playing) return 1;
-
-                      if (auto q1 = lh.getQueuedStatus())
-                      {
-                          if (q1 == playQueued) return 2;
-                          if (q1 == stopQueued) return 3;
-                      }
-
-                      return 4;
-                  };
-
-                  auto v1 = stateToValue (n1->getLaunchHandle());
-                  auto v2 = stateToValue (n2->getLaunchHandle());
-
-                  return v1 < v2;
-              });
+    auto isActive = [] (const SlotControlNode& n)
+    {
+        const auto& lh = n.getLaunchHandle();
+        return lh.getPlayingStatus() == LaunchHandle::PlayState::playing
+            || lh.getQueuedStatus().has_value();
+    };
+
+    // Slots can only become active once something has been queued on them so
+    // idle slots only need checking again when a queue has changed
+    const auto queueChangeCount = LaunchHandle::getQueueChangeCount();
+
+    if (std::exchange (lastQueueChangeCount, queueChangeCount) != queueChangeCount)
+    {
+        std::fill (activeSlots.begin(), activeSlots.end(), uint64_t (0));
+
+        for (size_t i = 0; i < launcherNodes.size(); ++i)
+            if (isActive (*launcherNodes[i]))
+                activeSlots[i / 64] |= uint64_t (1) << (i % 64);
+
+        return;
+    }
+
+    for (size_t word = 0; word < activeSlots.size(); ++word)
+    {
+        for (auto bits = activeSlots[word]; bits != 0; bits &= bits - 1)
+        {
+            const auto bit = std::countr_zero (bits);
+
+            if (! isActive (*launcherNodes[word * 64 + (size_t) bit]))
+                activeSlots[word] &= ~(uint64_t (1) << bit);
+        }
+    }
 }
 
 void ArrangerLauncherSwitchingNode::updatePlaySlotsState()
@@ -350,16 +369,15 @@ choc::buffer::FrameCount ArrangerLauncherSwitchingNode::beatToSamplePosition (st
     return static_cast<choc::buffer::FrameCount> (std::round (beat->inBeats() * framesPerBeats));
 }
 
-ArrangerLauncherSwitchingNode::SlotClipStatus ArrangerLauncherSwitchingNode::getSlotsStatus (const std::vector<std::unique_ptr<SlotControlNode>>& launcherNodes,
-                                                                                             BeatRange editBeatRange, MonotonicBeat monotonicBeat)
+ArrangerLauncherSwitchingNode::SlotClipStatus ArrangerLauncherSwitchingNode::getActiveSlotsStatus (BeatRange editBeatRange, MonotonicBeat monotonicBeat)
 {
     SlotClipStatus status;
 
     const BeatRange blockRange (monotonicBeat.v, editBeatRange.getLength());
 
-    for (auto& n : launcherNodes)
+    forEachActiveSlot ([&] (SlotControlNode& n)
     {
-        const auto& lh = n->getLaunchHandle();
+        const auto& lh = n.getLaunchHandle();
 
         if (lh.getPlayingStatus() == LaunchHandle::PlayState::playing)
             status.anyClipsPlaying = true;
@@ -391,7 +409,7 @@ ArrangerLauncherSwitchingNode::SlotClipStatus ArrangerLauncherSwitchingNode::get
             if (queuedPos && blockRange.contains (queuedPos->v))
                 status.beatsUntilQueuedStopTrimmedToBlock = queuedPos->v - blockRange.getStart();
         }
-    }
+    });
 
     return status;
 }
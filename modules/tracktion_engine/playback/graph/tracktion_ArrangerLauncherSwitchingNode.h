@@ -62,24 +62,34 @@ public:
         const auto numChannels = buffer.getNumChannels();
         const size_t numThisTime = std::min (numFrames, currentFadeFrameCountDown);
 
-        for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
+        // The gains are calculated once per chunk and then applied to each channel with vectorised operations
+        constexpr size_t chunkSize = 64;
+        float fadeInGains[chunkSize], fadeOutGains[chunkSize];
+
+        for (size_t offset = 0; offset < numThisTime; offset += chunkSize)
         {
-            const auto dest = buffer.getIterator (channel).sample;
-            const auto lastSample = samples[static_cast<size_t> (channel)];
-            auto channelCurrentFadeFrameCountDown = currentFadeFrameCountDown;
+            const auto num = std::min (chunkSize, numThisTime - offset);
+            const auto frameNum = numFramesToFade - currentFadeFrameCountDown + offset;
+            const auto startAlpha = frameNum / static_cast<float> (numFramesToFade);
+            const auto endAlpha = (frameNum + num) / static_cast<float> (numFramesToFade);
+            assert (startAlpha >= 0.0f && endAlpha <= 1.0f);
+
+            AudioFadeCurve::fillGains (fadeOutGains, static_cast<int> (num), AudioFadeCurve::linear,
+                                       1.0f - startAlpha, 1.0f - endAlpha);
 
-            for (size_t i = 0; i < numThisTime; ++i)
+            if (fadeType == FadeType::crossfade)
+                AudioFadeCurve::fillGains (fadeInGains, static_cast<int> (num), AudioFadeCurve::linear,
+                                           startAlpha, endAlpha);
+
+            for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
             {
-                const auto frameNum = numFramesToFade - channelCurrentFadeFrameCountDown;
-                auto alpha = frameNum / static_cast<float> (numFramesToFade);
-                assert (alpha >= 0.0f && alpha <= 1.0f);
+                const auto dest = buffer.getIterator (channel).sample + offset;
 
-                if (fadeType == FadeType::fadeOut)
-                    dest[i] = dest[i] + (lastSample * (1.0f - alpha));
-                else if (fadeType == FadeType::crossfade)
-                    dest[i] = (alpha * dest[i]) + (lastSample * (1.0f - alpha));
+                if (fadeType == FadeType::crossfade)
+                    juce::FloatVectorOperations::multiply (dest, fadeInGains, static_cast<int> (num));
 
-                --channelCurrentFadeFrameCountDown;
+                juce::FloatVectorOperations::addWithMultiply (dest, fadeOutGains, samples[static_cast<size_t> (channel)],
+                                                              static_cast<int> (num));
             }
         }
 
@@ -90,7 +100,7 @@ public:
     template<typename Buffer>
     void applyAt (Buffer& buffer, choc::buffer::FrameCount frameNum, FadeType fadeType)
     {
-        apply (buffer.getFrameRange (choc::buffer::FrameRange { .start = frameNum, .end = buffer.getNumFrames() - frameNum }),
+        apply (buffer.getFrameRange (choc::buffer::FrameRange { .start = frameNum, .end = buffer.getNumFrames() }),
                fadeType);
     }
 
@@ -145,6 +155,8 @@ private:
     std::unique_ptr<Node> arrangerNode;
     std::vector<std::unique_ptr<SlotControlNode>> launcherNodes;
     std::vector<SlotControlNode*> launcherNodesCopy;
+    std::vector<uint64_t> activeSlots;
+    std::optional<uint64_t> lastQueueChangeCount;
     std::shared_ptr<SampleFader> launcherSampleFader, arrangerSampleFader;
     std::shared_ptr<ActiveNoteList> arrangerActiveNoteList;
     std::shared_ptr<std::atomic<ArrangerLauncherSwitchingNode*>> activeNode;
@@ -155,9 +167,12 @@ private:
     void processLauncher (ProcessContext&, const SlotClipStatus&);
     void processArranger (ProcessContext&, const SlotClipStatus&);
 
-    void sortPlayingOrQueuedClipsFirst();
+    void updateActiveSlots();
     void updatePlaySlotsState();
 
+    template<typename Fn>
+    void forEachActiveSlot (Fn&&);
+
     //==============================================================================
     static choc::buffer::FrameCount beatToSamplePosition (std::optional<BeatDuration> beat, BeatDuration numBeats, choc::buffer::FrameCount);
 
@@ -170,8 +185,7 @@ private:
         std::optional<BeatDuration> beatsUntilQueuedStopTrimmedToBlock;
     };
 
-    static SlotClipStatus getSlotsStatus (const std::vector<std::unique_ptr<SlotControlNode>>&,
-                                         BeatRange editBeatRange, MonotonicBeat);
+    SlotClipStatus getActiveSlotsStatus (BeatRange editBeatRange, MonotonicBeat);
 
     //==============================================================================
     void sharedTimerCallback() override;
@@ -30,6 +30,8 @@ namespace benchmark_utilities
 
     enum class ShareNodeMemory          { no, yes };
 
+    enum class StaticBufferAllocation   { no, yes };
+
     struct BenchmarkOptions
     {
         Edit* edit = nullptr;
@@ -40,6 +42,7 @@ namespace benchmark_utilities
         tracktion::graph::ThreadPoolStrategy poolType;
         PoolMemoryAllocations poolMemoryAllocations = PoolMemoryAllocations::no;
         ShareNodeMemory shareNodeMemory = ShareNodeMemory::no;
+        StaticBufferAllocation staticBufferAllocation = StaticBufferAllocation::no;
     };
 
     inline juce::String getDescription (const BenchmarkOptions& opts)
@@ -57,6 +60,9 @@ namespace benchmark_utilities
         if (opts.shareNodeMemory == ShareNodeMemory::yes)
             s << ", share-node-memory";
 
+        if (opts.staticBufferAllocation == StaticBufferAllocation::yes)
+            s << ", static-buffers";
+
         if (opts.isMultiThreaded == MultiThreaded::yes)
             s << ", " + graph::test_utilities::getName (opts.poolType);
 
@@ -131,6 +137,7 @@ namespace benchmark_utilities
     {
         assert (opts.edit != nullptr);
         assert (opts.shareNodeMemory == ShareNodeMemory::no || opts.isLockFree == LockFree::yes); // Only supported in the lock-free player atm
+        assert (opts.staticBufferAllocation == StaticBufferAllocation::no || opts.isLockFree == LockFree::yes);
         const auto description = getDescription (opts);
 
         tracktion::graph::PlayHead playHead;
@@ -159,6 +166,9 @@ namespace benchmark_utilities
             if (opts.shareNodeMemory == ShareNodeMemory::yes)
                 testContext.getNodePlayer().enableNodeMemorySharing (true);
 
+            if (opts.staticBufferAllocation == StaticBufferAllocation::yes)
+                testContext.getNodePlayer().enableStaticBufferAllocation (true);
+
             {
                 const ScopedBenchmark sb2 (createBenchmarkDescription ("Node", (opts.editName + ": setting node").toStdString(), description.toStdString()));
                 testContext.setNode(std::move(node));
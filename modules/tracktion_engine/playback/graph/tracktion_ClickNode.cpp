@@ -53,6 +53,43 @@ namespace
 
         return loadWavDataIntoMemory (mb.getData(), mb.getSize(), targetSampleRate);
     }
+
+    /** Returns a click sound resampled to the given rate.
+        These are shared between all the ClickGenerators using the same sound and
+        rate so they don't have to be loaded and resampled each time the
+        playback graph is rebuilt.
+    */
+    std::shared_ptr<const juce::AudioBuffer<float>> getPreparedClick (Engine& engine, bool big, double sampleRate)
+    {
+        static std::mutex mutex;
+        static std::map<juce::String, std::weak_ptr<const juce::AudioBuffer<float>>> preparedClicks;
+
+        juce::File file (Click::getClickWaveFile (engine, big));
+        const bool useFile = file.existsAsFile();
+
+        auto key = (useFile ? file.getFullPathName() + ":" + juce::String (file.getLastModificationTime().toMilliseconds())
+                            : juce::String (big ? "big" : "little"))
+                     + ":" + juce::String (sampleRate);
+
+        const std::scoped_lock sl (mutex);
+
+        if (auto existing = preparedClicks[key].lock())
+            return existing;
+
+        juce::AudioBuffer<float> buffer;
+
+        if (useFile)
+            buffer = loadWavDataIntoMemory (file, sampleRate);
+
+        if (buffer.getNumSamples() == 0)
+            buffer = big ? loadWavDataIntoMemory (TracktionBinaryData::bigclick_wav, TracktionBinaryData::bigclick_wavSize, sampleRate)
+                         : loadWavDataIntoMemory (TracktionBinaryData::littleclick_wav, TracktionBinaryData::littleclick_wavSize, sampleRate);
+
+        auto prepared = std::make_shared<const juce::AudioBuffer<float>> (std::move (buffer));
+        preparedClicks[key] = prepared;
+
+        return prepared;
+    }
 }
 
 //==============================================================================
@@ -79,30 +116,15 @@ void ClickGenerator::prepareToPlay (double newSampleRate, TimePosition startTime
     }
     else
     {
-        if (bigClick.getNumSamples() == 0)
-        {
-            juce::File file (Click::getClickWaveFile (edit.engine, true));
-
-            if (file.existsAsFile())
-                bigClick = loadWavDataIntoMemory (file, sampleRate);
-
-            if (bigClick.getNumSamples() == 0)
-                bigClick = loadWavDataIntoMemory (TracktionBinaryData::bigclick_wav, TracktionBinaryData::bigclick_wavSize, sampleRate);
-        }
-
-        if (littleClick.getNumSamples() == 0)
-        {
-            juce::File file (Click::getClickWaveFile (edit.engine, false));
-
-            if (file.existsAsFile())
-                littleClick = loadWavDataIntoMemory (file, sampleRate);
+        if (bigClick == nullptr)
+            bigClick = getPreparedClick (edit.engine, true, sampleRate);
 
-            if (littleClick.getNumSamples() == 0)
-                littleClick = loadWavDataIntoMemory (TracktionBinaryData::littleclick_wav, TracktionBinaryData::littleclick_wavSize, sampleRate);
-        }
+        if (littleClick == nullptr)
+            littleClick = getPreparedClick (edit.engine, false, sampleRate);
     }
 
-    tempoPosition.set (startTime);
+    reset();
+    scheduleBeatsFrom (startTime);
 }
 
 namespace
@@ -131,72 +153,86 @@ void ClickGenerator::processBlock (choc::buffer::ChannelArrayView<float>* destBu
     if (isMutedAtTime (editTime.getEnd()))
         return;
 
+    if (midi ? bufferForMidiMessages == nullptr : destBuffer == nullptr)
+        return;
+
     const bool emphasis = edit.clickTrackEmphasiseBars;
 
-    tempoPosition.set (editTime.getStart());
-    auto beatInfo = getBeatInfo (sequence, tempoPosition);
+    // Start again if the tempo has changed or we've jumped somewhere else
+    if (sequence.hash() != scheduledSequenceHash
+        || editTime.getStart() < scheduledStart || editTime.getStart() > scheduledEnd)
+        scheduleBeatsFrom (editTime.getStart());
+    else if (nextScheduledBeat > 0 && scheduledBeats[nextScheduledBeat - 1].time >= editTime.getStart())
+        nextScheduledBeat = 0;
 
-    if (midi)
+    for (;;)
     {
-        if (bufferForMidiMessages == nullptr)
-            return;
+        for (; nextScheduledBeat < numScheduledBeats; ++nextScheduledBeat)
+        {
+            const auto& beat = scheduledBeats[nextScheduledBeat];
+            const auto t = beat.time;
 
-        auto gain = edit.getClickTrackVolume();
-        auto t = beatInfo.time;
+            if (t >= editTime.getEnd())
+                break;
 
-        while (t < editTime.getEnd())
-        {
-            auto note = (emphasis && beatInfo.isFirstBeatOfBar) ? bigClickMidiNote
-                                                                : littleClickMidiNote;
+            if (t < editTime.getStart())
+                continue;
 
-            if (t >= editTime.getStart())
-                bufferForMidiMessages->addMidiMessage (juce::MidiMessage::noteOn (10, note, gain),
+            const bool isBig = emphasis && beat.isFirstBeatOfBar;
+
+            if (midi)
+            {
+                bufferForMidiMessages->addMidiMessage (juce::MidiMessage::noteOn (10, isBig ? bigClickMidiNote : littleClickMidiNote,
+                                                                                  edit.getClickTrackVolume()),
                                                        (t - editTime.getStart()).inSeconds(),
                                                        {});
+            }
+            else
+            {
+                auto& b = isBig ? bigClick : littleClick;
 
-            tempoPosition.add (1_bd);
-            beatInfo = getBeatInfo (sequence, tempoPosition);
-            t = beatInfo.time;
+                if (b != nullptr && b->getNumSamples() > 0 && ! isMutedAtTime (t))
+                    trigger (*b, static_cast<int> (toSamples (t - editTime.getStart(), sampleRate)));
+            }
         }
-    }
-    else
-    {
-        if (destBuffer == nullptr)
-            return;
-
-        if (isPlaying())
-        {
-            auto num = std::min (samplesRemaining(), int (destBuffer->getNumFrames()));
-            auto dstView = destBuffer->getFrameRange ({ 0, (choc::buffer::FrameCount) num });
 
-            render (dstView);
-        }
+        if (nextScheduledBeat < numScheduledBeats || scheduledEnd >= editTime.getEnd())
+            break;
 
-        auto t = beatInfo.time;
+        scheduleNextBeats();
+    }
 
-        while (t < editTime.getEnd())
-        {
-            auto b = (emphasis && beatInfo.isFirstBeatOfBar) ? &bigClick : &littleClick;
+    if (! midi)
+        render (*destBuffer);
+}
 
-            if (b->getNumSamples() > 0 && t >= editTime.getStart() && ! isMutedAtTime (t))
-            {
-                const auto clickStartTime = t - editTime.getStart();
-                const auto clickStartOffset = static_cast<int> (toSamples (clickStartTime, sampleRate));
+void ClickGenerator::scheduleBeatsFrom (TimePosition startTime)
+{
+    tempoPosition.set (startTime);
+    scheduledSequenceHash = sequence.hash();
+    scheduleNextBeats();
+    scheduledStart = startTime;
+}
 
-                trigger (b);
-                isMutedAtTime (t);
+void ClickGenerator::scheduleNextBeats()
+{
+    // The position is left on the beat after the last one scheduled so
+    // this carries on from where the previous batch finished
+    numScheduledBeats = 0;
+    nextScheduledBeat = 0;
 
-                auto num = std::min (samplesRemaining(), int (destBuffer->getNumFrames()) - int (clickStartOffset));
-                auto dstView = destBuffer->getFrameRange ({ choc::buffer::FrameCount (clickStartOffset), choc::buffer::FrameCount (clickStartOffset + num) });
+    auto beatInfo = getBeatInfo (sequence, tempoPosition);
 
-                render (dstView);
-            }
+    while (numScheduledBeats < maxNumScheduledBeats)
+    {
+        scheduledBeats[numScheduledBeats++] = { beatInfo.time, beatInfo.isFirstBeatOfBar };
 
-            tempoPosition.add (1_bd);
-            beatInfo = getBeatInfo (sequence, tempoPosition);
-            t = beatInfo.time;
-        }
+        tempoPosition.add (1_bd);
+        beatInfo = getBeatInfo (sequence, tempoPosition);
     }
+
+    scheduledStart = scheduledEnd;
+    scheduledEnd = beatInfo.time;
 }
 
 bool ClickGenerator::isMutedAtTime (TimePosition time) const
@@ -216,39 +252,63 @@ bool ClickGenerator::isMutedAtTime (TimePosition time) const
     return ! clickEnabled;
 }
 
-bool ClickGenerator::isPlaying()
+void ClickGenerator::trigger (const juce::AudioBuffer<float>& sample, int offsetInBlock)
 {
-    return currentSample != nullptr && samplePos >= 0;
+    // Use a free voice or take over the one that's been playing longest
+    auto voice = std::max_element (voices.begin(), voices.end(),
+                                   [] (const Voice& v1, const Voice& v2)
+                                   {
+                                       if (v1.sample == nullptr || v2.sample == nullptr)
+                                           return v2.sample == nullptr && v1.sample != nullptr;
+
+                                       return v1.position < v2.position;
+                                   });
+
+    voice->sample = &sample;
+    voice->position = -offsetInBlock;
 }
 
-void ClickGenerator::trigger (juce::AudioBuffer<float>* s)
+void ClickGenerator::render (choc::buffer::ChannelArrayView<float>& view)
 {
-    currentSample = s;
-    samplePos = 0;
-}
+    const auto numFrames = static_cast<int> (view.getNumFrames());
+    const auto numChannels = static_cast<int> (view.getNumChannels());
+    const auto gain = edit.getClickTrackVolume();
 
-int ClickGenerator::samplesRemaining()
-{
-    return currentSample->getNumSamples() - samplePos;
-}
+    for (auto& voice : voices)
+    {
+        if (voice.sample == nullptr)
+            continue;
 
-void ClickGenerator::render (choc::buffer::ChannelArrayView<float>& view)
-{
-    auto todo = view.getNumFrames();
-    auto gain = edit.getClickTrackVolume();
+        const auto destStart = std::max (0, -voice.position);
+        const auto sourceStart = std::max (0, voice.position);
+        const auto num = std::min (numFrames - destStart, voice.sample->getNumSamples() - sourceStart);
+
+        if (num > 0)
+        {
+            // A mono click is added to all the channels, otherwise as many as there are
+            const auto numSourceChannels = voice.sample->getNumChannels();
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                if (numSourceChannels != 1 && chan >= numSourceChannels)
+                    break;
 
-    copyRemappingChannels (view, toBufferView (*currentSample).getFrameRange ({ choc::buffer::FrameCount (samplePos), choc::buffer::FrameCount (samplePos) + todo }));
-    applyGain (view, gain);
+                juce::FloatVectorOperations::addWithMultiply (view.getChannel ((choc::buffer::ChannelCount) chan).data.data + destStart,
+                                                              voice.sample->getReadPointer (numSourceChannels == 1 ? 0 : chan, sourceStart),
+                                                              gain, num);
+            }
+        }
+
+        voice.position += numFrames;
 
-    samplePos += static_cast<int> (todo);
-    if (samplePos >= currentSample->getNumSamples())
-        reset();
+        if (voice.position >= voice.sample->getNumSamples())
+            voice = {};
+    }
 }
 
 void ClickGenerator::reset()
 {
-    currentSample = nullptr;
-    samplePos = -1;
+    voices.fill ({});
 }
 
 //==============================================================================
@@ -288,6 +348,11 @@ bool ClickNode::isReadyToProcess()
     return true;
 }
 
+bool ClickNode::canProcessSplitTimelineRanges()
+{
+    return true;
+}
+
 void ClickNode::process (ProcessContext& pc)
 {
     SCOPED_REALTIME_CHECK
@@ -297,7 +362,23 @@ void ClickNode::process (ProcessContext& pc)
 
     const auto splitTimelinePosition = referenceSampleRangeToSplitTimelineRange (playHead, pc.referenceSampleRange);
     const auto editTime = tracktion::timeRangeFromSamples (splitTimelinePosition.timelineRange1, sampleRate);
-    clickGenerator.processBlock (&pc.buffers.audio, &pc.buffers.midi, editTime);
+
+    if (! splitTimelinePosition.isSplit)
+    {
+        clickGenerator.processBlock (&pc.buffers.audio, &pc.buffers.midi, editTime);
+        return;
+    }
+
+    // If the timeline wraps around in this block, the clicks either side of it are generated separately
+    jassert ((int64_t) pc.numSamples == pc.referenceSampleRange.getLength());
+    const auto numSamples1 = std::min (pc.numSamples, (choc::buffer::FrameCount) splitTimelinePosition.timelineRange1.getLength());
+    auto audio1 = pc.buffers.audio.getStart (numSamples1);
+    auto audio2 = pc.buffers.audio.fromFrame (numSamples1);
+    clickGenerator.processBlock (&audio1, &pc.buffers.midi, editTime);
+
+    scratchMidi.clear();
+    clickGenerator.processBlock (&audio2, &scratchMidi, tracktion::timeRangeFromSamples (splitTimelinePosition.timelineRange2, sampleRate));
+    pc.buffers.midi.mergeFromAndClearWithOffset (scratchMidi, numSamples1 / sampleRate);
 }
 
 
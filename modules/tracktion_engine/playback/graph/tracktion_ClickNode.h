@@ -47,18 +47,41 @@ private:
     tempo::Sequence::Position tempoPosition { sequence };
 
     double sampleRate = 44100.0;
-    juce::AudioBuffer<float> bigClick, littleClick;
+    std::shared_ptr<const juce::AudioBuffer<float>> bigClick, littleClick;
     int bigClickMidiNote = 37, littleClickMidiNote = 76;
 
     //==============================================================================
-    bool isPlaying();
-    void trigger (juce::AudioBuffer<float>*);
+    // The upcoming beats are worked out in batches so the tempo sequence doesn't
+    // have to be searched for every block
+    struct ScheduledBeat
+    {
+        TimePosition time;
+        bool isFirstBeatOfBar = false;
+    };
+
+    static constexpr size_t maxNumScheduledBeats = 32;
+    std::array<ScheduledBeat, maxNumScheduledBeats> scheduledBeats;
+    size_t numScheduledBeats = 0, nextScheduledBeat = 0;
+    TimePosition scheduledStart, scheduledEnd;
+    size_t scheduledSequenceHash = 0;
+
+    void scheduleBeatsFrom (TimePosition);
+    void scheduleNextBeats();
+
+    //==============================================================================
+    // A click that's playing. The position is negative if it starts part way
+    // through the current block
+    struct Voice
+    {
+        const juce::AudioBuffer<float>* sample = nullptr;
+        int position = 0;
+    };
+
+    std::array<Voice, 4> voices;
+
+    void trigger (const juce::AudioBuffer<float>&, int offsetInBlock);
     void render (choc::buffer::ChannelArrayView<float>&);
     void reset();
-    int samplesRemaining();
-
-    juce::AudioBuffer<float>* currentSample = nullptr;
-    int samplePos = -1;
 
     //==============================================================================
     bool isMutedAtTime (TimePosition) const;
@@ -68,6 +91,8 @@ private:
 //==============================================================================
 /**
     Adds audio and MIDI clicks to the input buffers.
+    This has no inputs so it can be used on its own for an output that only
+    plays the click, or summed with the tracks going to the same output.
 */
 class ClickNode final   : public tracktion::graph::Node
 {
@@ -78,6 +103,7 @@ public:
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
+    bool canProcessSplitTimelineRanges() override;
     void process (ProcessContext&) override;
 
 private:
@@ -88,6 +114,7 @@ private:
     const int numChannels;
     const bool generateMidi;
     double sampleRate = 44100.0;
+    MidiMessageArray scratchMidi;
 };
 
 }} // namespace tracktion { inline namespace engine
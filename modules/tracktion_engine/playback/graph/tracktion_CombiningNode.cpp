@@ -26,6 +26,14 @@ namespace combining_node_utils
     {
         return static_cast<int> (t.inSeconds()) / secondsPerGroup;
     }
+
+    /** Matches the checks used to find the inputs playing in a block. */
+    static inline bool overlaps (BeatRange inputTime, BeatRange blockBeats) noexcept
+    {
+        return ! blockBeats.isEmpty()
+                && inputTime.getEnd() > blockBeats.getStart()
+                && inputTime.getStart() < blockBeats.getEnd();
+    }
 }
 
 //==============================================================================
@@ -269,24 +277,37 @@ bool CombiningNode::isReadyToProcess()
     return isReadyToProcessBlock.load (std::memory_order_acquire);
 }
 
+bool CombiningNode::canProcessSplitTimelineRanges()
+{
+    return true;
+}
+
 void CombiningNode::prefetchBlock (juce::Range<int64_t> referenceSampleRange)
 {
     SCOPED_REALTIME_CHECK
 
-    const auto editTime = getEditTimeRange();
-    prefetchGroup (referenceSampleRange, editTime, getEditBeatRange());
-
     // Update ready to process state based on nodes intersecting this time
     isReadyToProcessBlock.store (true, std::memory_order_release);
 
-    if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
+    // If the timeline wraps around in this block, the inputs playing either side of
+    // the wrap are prepared once each for the whole block
+    const auto sections = getProcessState().getTimelineSections();
+
+    for (size_t i = 0; i < sections.size(); ++i)
     {
-        for (auto tan : *g)
+        const auto editTime = sections[i].editTimeRange;
+        prefetchGroup (referenceSampleRange, editTime, sections[i].editBeatRange,
+                       i > 0 ? sections[0].editBeatRange : BeatRange());
+
+        if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
         {
-            if (! tan->isReadyToProcess())
+            for (auto tan : *g)
             {
-                isReadyToProcessBlock.store (false, std::memory_order_release);
-                break;
+                if (! tan->isReadyToProcess())
+                {
+                    isReadyToProcessBlock.store (false, std::memory_order_release);
+                    break;
+                }
             }
         }
     }
@@ -294,34 +315,50 @@ void CombiningNode::prefetchBlock (juce::Range<int64_t> referenceSampleRange)
 
 void CombiningNode::process (ProcessContext& pc)
 {
-    const auto editBeats = getEditBeatRange();
-
     SCOPED_REALTIME_CHECK
     const auto initialEvents = pc.buffers.midi.size();
 
     // Merge any note-offs from clips that have been deleted
     pc.buffers.midi.mergeFromAndClear (noteOffEventsToSend);
 
-    // Then process the list
-    if (auto g = groups[combining_node_utils::timeToGroupIndex (getEditTimeRange().getStart())])
+    // Then process the list.
+    // Each input processes the whole block, handling any wrap in the timeline itself,
+    // so inputs already processed for the first side of a wrap are skipped for the second
+    const auto sections = getProcessState().getTimelineSections();
+    bool hasProcessedAny = false;
+
+    for (size_t i = 0; i < sections.size(); ++i)
     {
-        for (auto tan : *g)
+        const auto editBeats = sections[i].editBeatRange;
+        const auto processedBeats = i > 0 ? sections[0].editBeatRange : BeatRange();
+
+        if (auto g = groups[combining_node_utils::timeToGroupIndex (sections[i].editTimeRange.getStart())])
         {
-            if (tan->time.getEnd() > editBeats.getStart())
+            for (auto tan : *g)
             {
-                if (tan->time.getStart() >= editBeats.getEnd())
-                    break;
+                if (tan->time.getEnd() > editBeats.getStart())
+                {
+                    if (tan->time.getStart() >= editBeats.getEnd())
+                        break;
+
+                    if (combining_node_utils::overlaps (tan->time, processedBeats))
+                        continue;
 
-                // Clear the allocated storage
-                tempAudioBuffer.clear();
+                    // Clear the allocated storage
+                    tempAudioBuffer.clear();
 
-                // Then process the buffer.
-                // This will use the local buffer for the Nodes in the TimedNode and put the result in pc.buffers
-                tan->process (pc);
+                    // Then process the buffer.
+                    // This will use the local buffer for the Nodes in the TimedNode and put the result in pc.buffers
+                    tan->process (pc);
+                    hasProcessedAny = true;
+                }
             }
         }
     }
 
+    // With no clips in this block, the output is left cleared
+    pc.buffers.isAudioSilent = ! hasProcessedAny;
+
     if (pc.buffers.midi.size() > initialEvents)
         pc.buffers.midi.sortByTimestamp();
 }
@@ -336,7 +373,8 @@ size_t CombiningNode::getAllocatedBytes() const
     return size;
 }
 
-void CombiningNode::prefetchGroup (juce::Range<int64_t> referenceSampleRange, TimeRange editTime, BeatRange editBeats)
+void CombiningNode::prefetchGroup (juce::Range<int64_t> referenceSampleRange, TimeRange editTime, BeatRange editBeats,
+                                   BeatRange alreadyPrefetchedBeats)
 {
     if (auto g = groups[combining_node_utils::timeToGroupIndex (editTime.getStart())])
     {
@@ -347,6 +385,9 @@ void CombiningNode::prefetchGroup (juce::Range<int64_t> referenceSampleRange, Ti
                 if (tan->time.getStart() >= editBeats.getEnd())
                     break;
 
+                if (combining_node_utils::overlaps (tan->time, alreadyPrefetchedBeats))
+                    continue;
+
                 tan->prefetchBlock (referenceSampleRange);
             }
         }
@@ -26,6 +26,9 @@ public:
     CombiningNode (EditItemID, ProcessState&);
     ~CombiningNode() override;
 
+    /** Returns the EditItemID to identify this Node. */
+    EditItemID getItemID() const                            { return itemID; }
+
     //==============================================================================
     /** Adds an input node to be played at a given time range.
 
@@ -59,6 +62,7 @@ public:
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
+    bool canProcessSplitTimelineRanges() override;
     void prefetchBlock (juce::Range<int64_t> /*referenceSampleRange*/) override;
     void process (ProcessContext&) override;
 
@@ -76,7 +80,7 @@ private:
 
     tracktion::graph::NodeProperties nodeProperties;
 
-    void prefetchGroup (juce::Range<int64_t>, TimeRange, BeatRange);
+    void prefetchGroup (juce::Range<int64_t>, TimeRange, BeatRange, BeatRange alreadyPrefetchedBeats);
     void queueNoteOffsForClipsNoLongerPresent (const CombiningNode&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CombiningNode)
@@ -26,6 +26,9 @@ public:
                        BeatRange clipLoopRange,
                        std::unique_ptr<Node>);
 
+    /** Returns the EditItemID to identify this Node. */
+    EditItemID getItemID() const                            { return containerClipID; }
+
     //==============================================================================
     tracktion::graph::NodeProperties getNodeProperties() override;
     std::vector<Node*> getDirectInputNodes() override;
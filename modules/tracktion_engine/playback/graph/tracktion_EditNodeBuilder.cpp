@@ -358,6 +358,23 @@ namespace
         return false;
     }
 
+    /** Returns true if the track is playing live audio from a physical input. */
+    bool isMonitoringLiveAudio (Track& track, const CreateNodeParams& params)
+    {
+        if (params.forRendering)
+            return false;
+
+        if (auto context = track.edit.getCurrentPlaybackContext())
+            for (auto in : context->getAllInputs())
+                if (dynamic_cast<WaveInputDevice*> (&in->getInputDevice()) != nullptr
+                    && ! in->getInputDevice().isTrackDevice()
+                    && in->isLivePlayEnabled (track)
+                    && in->getTargets().contains (track.itemID))
+                    return true;
+
+        return false;
+    }
+
 //==============================================================================
 //==============================================================================
 std::unique_ptr<tracktion::graph::Node> createNodeForTrack (Track&, const CreateNodeParams&);
@@ -375,6 +392,29 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID, const ju
 std::unique_ptr<Node> createInsertReturnNode (InsertPlugin&, tracktion::graph::PlayHeadState&, const CreateNodeParams&);
 
 //==============================================================================
+//==============================================================================
+/** Returns the channels a clip's WaveNode should fill.
+    Clips are played back in stereo unless the params allow mono ones.
+*/
+juce::AudioChannelSet getDestChannelsForClip (AudioClipBase& clip, const CreateNodeParams& params)
+{
+    const auto activeChannels = clip.getActiveChannels();
+
+    if (params.allowMonoClips && activeChannels.size() == 1)
+        return activeChannels;
+
+    return juce::AudioChannelSet::canonicalChannelSet (std::max (2, activeChannels.size()));
+}
+
+/** Copies a mono Node to both channels of a stereo one, for anything that needs a stereo input. */
+std::unique_ptr<tracktion::graph::Node> makeStereoIfMono (std::unique_ptr<Node> node)
+{
+    if (node == nullptr || node->getNodeProperties().numberOfChannels != 1)
+        return node;
+
+    return makeNode<ChannelRemappingNode> (std::move (node), makeChannelMap ({ { 0, 0 }, { 0, 1 } }), true);
+}
+
 //==============================================================================
 std::unique_ptr<tracktion::graph::Node> createFadeNodeForClip (AudioClipBase& clip, EditTimeRange clipTimeRangeToUse,
                                                                std::unique_ptr<Node> node, const CreateNodeParams& params)
@@ -479,7 +519,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
                                                                   clip.getLiveClipLevel(),
                                                                   speed,
                                                                   clip.getActiveChannels(),
-                                                                  juce::AudioChannelSet::canonicalChannelSet (std::max (2, clip.getActiveChannels().size())),
+                                                                  getDestChannelsForClip (clip, params),
                                                                   params.processState,
                                                                   idToUse,
                                                                   params.forRendering,
@@ -494,7 +534,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
                                                          clip.getLiveClipLevel(),
                                                          speed,
                                                          clip.getActiveChannels(),
-                                                         juce::AudioChannelSet::canonicalChannelSet (std::max (2, clip.getActiveChannels().size())),
+                                                         getDestChannelsForClip (clip, params),
                                                          params.processState,
                                                          idToUse,
                                                          params.forRendering);
@@ -560,7 +600,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
                     .loopSection = clip.getLoopRangeBeats(),
                     .liveClipLevel = clip.getLiveClipLevel(),
                     .sourceChannelsToUse = clip.getActiveChannels(),
-                    .destChannelsToFill = juce::AudioChannelSet::canonicalChannelSet (std::max (2, clip.getActiveChannels().size())),
+                    .destChannelsToFill = getDestChannelsForClip (clip, params),
                     .itemID = idToUse,
                     .isOfflineRender = params.forRendering,
                     .resamplingQuality = clip.getResamplingQuality(),
@@ -585,7 +625,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
                                                    BeatRange (clip.getLoopStartBeats(), clip.getLoopLengthBeats()),
                                                    clip.getLiveClipLevel(),
                                                    clip.getActiveChannels(),
-                                                   juce::AudioChannelSet::canonicalChannelSet (std::max (2, clip.getActiveChannels().size())),
+                                                   getDestChannelsForClip (clip, params),
                                                    params.processState,
                                                    idToUse,
                                                    params.forRendering,
@@ -609,7 +649,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
                                                clip.getLiveClipLevel(),
                                                clip.getSpeedRatio(),
                                                clip.getActiveChannels(),
-                                               juce::AudioChannelSet::canonicalChannelSet (std::max (2, clip.getActiveChannels().size())),
+                                               getDestChannelsForClip (clip, params),
                                                params.processState,
                                                idToUse,
                                                params.forRendering,
@@ -674,25 +714,28 @@ std::unique_ptr<tracktion::graph::Node> createNodeForMidiClip (MidiClip& clip, c
         const auto clipBeatRange = role == ClipRole::launcher ? BeatRange (0_bp, BeatPosition::fromBeats (std::numeric_limits<double>::max()))
                                                               : BeatRange (clip.getStartBeat(), clip.getEndBeat());
 
-        return graph::makeNode<LoopingMidiNode> (std::move (sequences),
-                                                 channels,
-                                                 generateMPE,
-                                                 clipBeatRange,
-                                                 clip.getLoopRangeBeats(),
-                                                 clip.getOffsetInBeats(),
-                                                 clip.getLiveClipLevel(),
-                                                 params.processState,
-                                                 clip.itemID,
-                                                 clip.getQuantisation(),
-                                                 clip.edit.engine.getGrooveTemplateManager().getTemplateByName (clip.getGrooveTemplate()),
-                                                 clip.getGrooveStrength(),
-                                                 [&trackMuteState]
-                                                 {
-                                                      if (! trackMuteState.shouldTrackBeAudible())
-                                                         return ! trackMuteState.shouldTrackMidiBeProcessed();
+        auto node = std::make_unique<LoopingMidiNode> (std::move (sequences),
+                                                       channels,
+                                                       generateMPE,
+                                                       clipBeatRange,
+                                                       clip.getLoopRangeBeats(),
+                                                       clip.getOffsetInBeats(),
+                                                       clip.getLiveClipLevel(),
+                                                       params.processState,
+                                                       clip.itemID,
+                                                       clip.getQuantisation(),
+                                                       clip.edit.engine.getGrooveTemplateManager().getTemplateByName (clip.getGrooveTemplate()),
+                                                       clip.getGrooveStrength(),
+                                                       [&trackMuteState]
+                                                       {
+                                                            if (! trackMuteState.shouldTrackBeAudible())
+                                                               return ! trackMuteState.shouldTrackMidiBeProcessed();
+  
+                                                           return false;
+                                                       });
+        node->setLiveGrooveStrength (clip.getLiveGrooveStrength());
 
-                                                     return false;
-                                                 });
+        return node;
     }
 
     // Use looped sequence in seconds time base
@@ -791,6 +834,60 @@ std::unique_ptr<tracktion::graph::Node> createNodeForStepClip (StepClip& clip, c
     return node;
 }
 
+std::unique_ptr<tracktion::graph::Node> createNodeForContainerClipContents (ContainerClip& clip, const TrackMuteState& trackMuteState,
+                                                                            const CreateNodeParams& params)
+{
+    // Combiner clip and the contained clips need their own, local PlayHeadState.
+    // This also needs to persist across graph rebuilds to maintain continuity.
+    // Once the ContainerClipNode has been initialised it will update it's children with its own ProcessState
+    // The contained clips' times are relative to the container so the windows don't apply to them
+    auto contentsParams = params;
+    contentsParams.clipTimeWindows.clear();
+
+    return makeNode<ContainerClipNode> (params.processState,
+                                        clip.itemID,
+                                        BeatRange (clip.getStartBeat(), clip.getEndBeat()),
+                                        clip.getOffsetInBeats(),
+                                        clip.getLoopRangeBeats(),
+                                        createNodeForClips (clip.itemID, clip.getClips(), trackMuteState, contentsParams));
+}
+
+std::unique_ptr<tracktion::graph::Node> createNodeForContainerClipContents (ContainerClip& clip, const CreateNodeParams& params)
+{
+    // Only clips of audio are pre-rendered so none of the Nodes will refer to the TrackMuteState
+    jassert (clip.canPreRenderContents());
+    const TrackMuteState trackMuteState (clip.edit);
+
+    return createNodeForContainerClipContents (clip, trackMuteState, params);
+}
+
+/** Returns a WaveNode for a render of a ContainerClip's contents, if one has been made. */
+std::unique_ptr<tracktion::graph::Node> createNodeForPreRenderedContainerClip (ContainerClip& clip, const CreateNodeParams& params)
+{
+    if (params.forRendering || ! params.usePreRenderedContainerClips)
+        return {};
+
+    const auto renderedFile = clip.getPreRenderedContents();
+
+    if (renderedFile.isNull())
+        return {};
+
+    // The render starts at the start of the clip and already includes the offset and looping
+    const auto channels = juce::AudioChannelSet::canonicalChannelSet (2);
+
+    return makeNode<WaveNode> (renderedFile,
+                               clip.getEditTimeRange(),
+                               TimeDuration(),
+                               TimeRange(),
+                               LiveClipLevel(),
+                               1.0,
+                               channels,
+                               channels,
+                               params.processState,
+                               clip.itemID,
+                               params.forRendering);
+}
+
 std::unique_ptr<tracktion::graph::Node> createNodeForContainerClip (ContainerClip& clip, [[ maybe_unused ]] const TrackMuteState& trackMuteState,
                                                                     const CreateNodeParams& params, ClipRole role)
 {
@@ -832,15 +929,13 @@ std::unique_ptr<tracktion::graph::Node> createNodeForContainerClip (ContainerCli
         node = std::move (offsetNode);
     }
    #else
-    // Combiner clip and the contained clips need their own, local PlayHeadState.
-    // This also needs to persist across graph rebuilds to maintain continuity.
-    // Once the ContainerClipNode has been initialised it will update it's children with its own ProcessState
-    auto node = makeNode<ContainerClipNode> (params.processState,
-                                             clip.itemID,
-                                             BeatRange (clip.getStartBeat(), clip.getEndBeat()),
-                                             clip.getOffsetInBeats(),
-                                             clip.getLoopRangeBeats(),
-                                             createNodeForClips (clip.itemID, clips, trackMuteState, params));
+    std::unique_ptr<Node> node;
+
+    if (role != ClipRole::launcher)
+        node = createNodeForPreRenderedContainerClip (clip, params);
+
+    if (! node)
+        node = createNodeForContainerClipContents (clip, trackMuteState, params);
    #endif
 
     // Plugins
@@ -884,6 +979,24 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClip (Clip& clip, const Tra
     return {};
 }
 
+/** Returns true if a clip is allowed and overlaps one of the clip time windows. */
+static bool shouldIncludeArrangerClip (Clip& clip, const CreateNodeParams& params)
+{
+    if (params.allowedClips != nullptr && ! params.allowedClips->contains (&clip))
+        return false;
+
+    if (params.clipTimeWindows.empty())
+        return true;
+
+    const auto clipTimeRange = clip.getEditTimeRange();
+
+    for (auto window : params.clipTimeWindows)
+        if (window.overlaps (clipTimeRange))
+            return true;
+
+    return false;
+}
+
 std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID, const juce::Array<Clip*>& clips,
                                                             const TrackMuteState& trackMuteState, const CreateNodeParams& params)
 {
@@ -896,7 +1009,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID,
     {
         if (params.includePlugins)
             for (auto clip : clips)
-                if (params.allowedClips == nullptr || params.allowedClips->contains (clip))
+                if (shouldIncludeArrangerClip (*clip, params))
                     if (auto pluginList = clip->getPluginList())
                         for (auto p : *pluginList)
                             if (p->getLatencySeconds() > 0.0)
@@ -913,7 +1026,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID,
         auto combiner = std::make_unique<SummingNode>();
 
         for (auto clip : clips)
-            if (params.allowedClips == nullptr || params.allowedClips->contains (clip))
+            if (shouldIncludeArrangerClip (*clip, params))
                 if (auto clipNode = createNodeForClip (*clip, trackMuteState, params, ClipRole::arranger))
                     combiner->addInput (std::move (clipNode));
 
@@ -924,7 +1037,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID,
     {
         auto clip = clips.getFirst();
 
-        if (params.allowedClips == nullptr || params.allowedClips->contains (clip))
+        if (shouldIncludeArrangerClip (*clip, params))
         {
             auto combiner = std::make_unique<CombiningNode> (trackID, params.processState);
 
@@ -939,7 +1052,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForClips (EditItemID trackID,
 
     // Use a CombiningNode for most clips
     for (auto clip : clips)
-        if (params.allowedClips == nullptr || params.allowedClips->contains (clip))
+        if (shouldIncludeArrangerClip (*clip, params))
             if (auto clipNode = createNodeForClip (*clip, trackMuteState, params, ClipRole::arranger))
                 combiner->addInput (std::move (clipNode), clip->getPosition().time);
 
@@ -1003,6 +1116,9 @@ std::vector<std::unique_ptr<SlotControlNode>> createNodeForLauncherClips (const
                                                                       slot->itemID,
                                                                       std::move (clipNode));
 
+                if (! params.forRendering)
+                    controlNode->setPreloadsStart (slotList.track.edit.getSceneList().isSlotPreloaded (slot->itemID));
+
                 nodes.push_back (std::move (controlNode));
             }
         }
@@ -1044,7 +1160,7 @@ std::unique_ptr<tracktion::graph::Node> createARAClipsNode (const juce::Array<Cl
     juce::Array<AudioClipBase*> araClips;
 
     for (auto clip : clips)
-        if (params.allowedClips == nullptr || params.allowedClips->contains (clip))
+        if (shouldIncludeArrangerClip (*clip, params))
             if (auto acb = dynamic_cast<AudioClipBase*> (clip))
                 if (acb->isUsingMelodyne() && acb->melodyneProxy != nullptr)
                     araClips.add (acb);
@@ -1211,9 +1327,25 @@ std::unique_ptr<tracktion::graph::Node> createNodeForPlugin (Plugin& plugin, con
         return node;
 
     if (auto ep = dynamic_cast<ExternalPlugin*> (&plugin))
+    {
         if (ep->isInitialisingAsync())
             return node;
 
+        // Deferred plugins output silence until their instance has been created
+        if (ep->isInitialisationDeferred())
+        {
+            if (params.forRendering)
+            {
+                ep->initialiseFully();
+            }
+            else
+            {
+                ep->initialiseFullyAsync();
+                return makeNode<GainNode> (std::move (node), [] { return 0.0f; }, plugin.itemID.getRawID());
+            }
+        }
+    }
+
     if (! plugin.isEnabled() && ! params.includeBypassedPlugins)
         return node;
 
@@ -1224,15 +1356,19 @@ std::unique_ptr<tracktion::graph::Node> createNodeForPlugin (Plugin& plugin, con
         if (! plugin.getSidechainSourceID().isValid())
             maxNumChannels = 2;
 
-    node = createSidechainInputNodeForPlugin (plugin, std::move (node));
-    node = tracktion::graph::makeNode<PluginNode> (std::move (node),
-                                                   plugin,
-                                                   params.sampleRate, params.blockSize,
-                                                   trackMuteState, params.processState,
-                                                   params.forRendering, params.includeBypassedPlugins,
-                                                   maxNumChannels);
+    if (plugin.getSidechainSourceID().isValid())
+        node = makeStereoIfMono (std::move (node));
 
-    return node;
+    node = createSidechainInputNodeForPlugin (plugin, std::move (node));
+    auto pluginNode = std::make_unique<PluginNode> (std::move (node),
+                                                    plugin,
+                                                    params.sampleRate, params.blockSize,
+                                                    trackMuteState, params.processState,
+                                                    params.forRendering, params.includeBypassedPlugins,
+                                                    maxNumChannels);
+    pluginNode->setUpmixMonoInput (true);
+
+    return pluginNode;
 }
 
 std::unique_ptr<tracktion::graph::Node> createNodeForRackInstance (RackInstance& rackInstance, std::unique_ptr<Node> node,
@@ -1278,6 +1414,14 @@ std::unique_ptr<tracktion::graph::Node> createPluginNodeForList (PluginList& lis
         if (! params.forRendering && p->isFrozen())
             continue;
 
+        // Only PluginNodes can upmix a mono input, everything else expects stereo
+        if (dynamic_cast<LevelMeterPlugin*> (p) != nullptr
+            || dynamic_cast<AuxSendPlugin*> (p) != nullptr
+            || dynamic_cast<AuxReturnPlugin*> (p) != nullptr
+            || dynamic_cast<RackInstance*> (p) != nullptr
+            || dynamic_cast<InsertPlugin*> (p) != nullptr)
+           node = makeStereoIfMono (std::move (node));
+
         if (auto meterPlugin = dynamic_cast<LevelMeterPlugin*> (p))
         {
             node = makeNode<LevelMeasurerProcessingNode> (std::move (node), *meterPlugin);
@@ -1333,6 +1477,7 @@ std::unique_ptr<tracktion::graph::Node> createModifierNodeForList (ModifierList*
             if (modifier->getProcessingPosition() != position)
                 continue;
 
+            node = makeStereoIfMono (std::move (node));
             node = makeNode<ModifierNode> (std::move (node), modifier, params.sampleRate, params.blockSize,
                                            trackMuteState, playHeadState, params.forRendering);
         }
@@ -1356,7 +1501,8 @@ std::unique_ptr<tracktion::graph::Node> createPluginNodeForTrack (Track& t,
     node = createModifierNodeForList (t.getModifierList(), Modifier::ProcessingPosition::postFX,
                                       &trackMuteState, std::move (node), playHeadState, params);
 
-    return node;
+    // Tracks always output stereo
+    return makeStereoIfMono (std::move (node));
 }
 
 juce::Array<Track*> getDirectInputTracks (AudioTrack& at)
@@ -1410,6 +1556,42 @@ std::unique_ptr<tracktion::graph::Node> createTrackCompNode (AudioTrack& at, std
     return node;
 }
 
+/** Returns true if all the track's audio clips can be played back in mono.
+    This is only the case if they're all mono, centred, wave clips without any plugins of their own.
+*/
+bool canPlayClipsInMono (AudioTrack& at, const CreateNodeParams& params)
+{
+    if (! params.allowMonoClips)
+        return false;
+
+    if (params.allowClipSlots)
+        for (auto slot : at.getClipSlotList().getClipSlots())
+            if (dynamic_cast<AudioClipBase*> (slot->getClip()) != nullptr)
+                return false;
+
+    bool hasAudioClips = false;
+
+    for (auto clip : at.getClips())
+    {
+        if (params.allowedClips != nullptr && ! params.allowedClips->contains (clip))
+            continue;
+
+        if (auto acb = dynamic_cast<AudioClipBase*> (clip))
+        {
+            if (dynamic_cast<WaveAudioClip*> (acb) == nullptr
+                || acb->getActiveChannels().size() != 1
+                || acb->getPan() != 0.0f
+                || acb->isUsingMelodyne()
+                || (params.includePlugins && acb->getPluginList()->size() > 0))
+               return false;
+
+            hasAudioClips = true;
+        }
+    }
+
+    return hasAudioClips;
+}
+
 std::unique_ptr<tracktion::graph::Node> createNodeForAudioTrack (AudioTrack& at, const CreateNodeParams& params)
 {
     CRASH_TRACER
@@ -1424,7 +1606,11 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioTrack (AudioTrack& at,
     auto clipsMuteState = std::make_unique<TrackMuteState> (at, true, processMidiWhenMuted);
     auto trackMuteState = std::make_unique<TrackMuteState> (at, false, processMidiWhenMuted);
 
-    std::unique_ptr<Node> node = createClipsNode (at, *clipsMuteState, params);
+    // Mono clips stay mono until they reach a plugin or are mixed with anything else
+    auto clipParams = params;
+    clipParams.allowMonoClips = canPlayClipsInMono (at, params);
+
+    std::unique_ptr<Node> node = createClipsNode (at, *clipsMuteState, clipParams);
 
     if (node)
     {
@@ -1472,7 +1658,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioTrack (AudioTrack& at,
         if (node)
         {
             auto sumNode = std::make_unique<SummingNode>();
-            sumNode->addInput (std::move (node));
+            sumNode->addInput (makeStereoIfMono (std::move (node)));
             sumNode->addInput (std::move (liveInputNode));
             node = std::move (sumNode);
         }
@@ -1487,7 +1673,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioTrack (AudioTrack& at,
         auto sumNode = std::make_unique<SummingNode>();
 
         if (node)
-            sumNode->addInput (std::move (node));
+            sumNode->addInput (makeStereoIfMono (std::move (node)));
 
         for (auto inputTrack : inputTracks)
             if (auto n = createNodeForTrack (*inputTrack, params))
@@ -1515,6 +1701,79 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioTrack (AudioTrack& at,
     return node;
 }
 
+//==============================================================================
+bool canRenderAudioTrackAnticipatively (AudioTrack& at, const CreateNodeParams& params)
+{
+    if (params.forRendering)
+        return false;
+
+    // Anything live needs to be processed in the audio callback
+    if (! at.edit.getEditInputDevices().getDevicesForTargetTrack (at).isEmpty()
+        || at.getWaveInputDevice().isEnabled()
+        || at.getMidiInputDevice().isEnabled()
+        || ! at.getListeners().isEmpty())
+       return false;
+
+    if (params.allowClipSlots)
+        for (auto slot : at.getClipSlotList().getClipSlots())
+            if (slot->getClip() != nullptr)
+                return false;
+
+    // The track's Nodes are processed on their own so can't connect to any other tracks
+    if (! getDirectInputTracks (at).isEmpty() || isSidechainSource (at))
+        return false;
+
+    if (auto modifierList = at.getModifierList(); modifierList != nullptr && ! modifierList->getModifiers().isEmpty())
+        return false;
+
+    for (auto plugin : at.getAllPlugins())
+    {
+        if (dynamic_cast<AuxSendPlugin*> (plugin) != nullptr
+            || dynamic_cast<AuxReturnPlugin*> (plugin) != nullptr
+            || dynamic_cast<InsertPlugin*> (plugin) != nullptr
+            || dynamic_cast<RackInstance*> (plugin) != nullptr
+            || plugin->getSidechainSourceID().isValid())
+           return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<tracktion::graph::Node> createAnticipativeRenderNodeForAudioTrack (AudioTrack& at, const CreateNodeParams& params)
+{
+    auto& processState = params.processState;
+    auto renderState = std::make_unique<AnticipativeRenderNode::RenderState> (processState.playHeadState.playHead,
+                                                                              processState.getTempoSequence());
+
+    // The track's Nodes need to use the RenderState so they can be processed ahead of the PlayHead
+    const CreateNodeParams renderParams
+    {
+        .processState = renderState->processState,
+        .sampleRate = params.sampleRate,
+        .blockSize = params.blockSize,
+        .allowedClips = params.allowedClips,
+        .allowedTracks = params.allowedTracks,
+        .forRendering = params.forRendering,
+        .includePlugins = params.includePlugins,
+        .includeMasterPlugins = params.includeMasterPlugins,
+        .includeBypassedPlugins = params.includeBypassedPlugins,
+        .implicitlyIncludeSubmixChildTracks = params.implicitlyIncludeSubmixChildTracks,
+        .allowClipSlots = params.allowClipSlots,
+        .readAheadTimeStretchNodes = params.readAheadTimeStretchNodes,
+        .renderTracksAnticipatively = false,
+        .stemTracks = params.stemTracks,
+        .usePreRenderedContainerClips = params.usePreRenderedContainerClips,
+        .clipTimeWindows = params.clipTimeWindows
+    };
+
+    auto node = createNodeForAudioTrack (at, renderParams);
+
+    if (! node)
+        return {};
+
+    return makeNode<AnticipativeRenderNode> (at.itemID, std::move (renderState), std::move (node));
+}
+
 //==============================================================================
 std::unique_ptr<tracktion::graph::Node> createNodeForSubmixTrack (FolderTrack& submixTrack, const CreateNodeParams& params)
 {
@@ -1600,6 +1859,9 @@ std::unique_ptr<tracktion::graph::Node> createNodeForTrack (Track& track, const
         if (! params.forRendering && t->isFrozen (Track::groupFreeze))
             return {};
 
+        if (params.renderTracksAnticipatively && canRenderAudioTrackAnticipatively (*t, params))
+            return createAnticipativeRenderNodeForAudioTrack (*t, params);
+
         return createNodeForAudioTrack (*t, params);
     }
 
@@ -1804,19 +2066,84 @@ std::unique_ptr<tracktion::graph::Node> createMasterFadeInOutNode (Edit& edit,
     return node;
 }
 
+/** Creates the Nodes for a set of tracks, returning them in the same order.
+    Each track's Nodes are independent of the others so these can be created
+    on several threads if the params ask for it.
+*/
+std::vector<std::unique_ptr<Node>> createNodesForTracks (const std::vector<Track*>& tracks, const CreateNodeParams& params)
+{
+    std::vector<std::unique_ptr<Node>> nodes (tracks.size());
+    const auto numThreads = std::min (tracks.size(), (size_t) std::max (1, params.numThreadsForTrackNodes));
+
+    if (numThreads <= 1)
+    {
+        for (size_t i = 0; i < tracks.size(); ++i)
+            nodes[i] = createNodeForTrack (*tracks[i], params);
+
+        return nodes;
+    }
+
+    // Each thread takes the next track until they've all been created, from the same arena as the caller
+    std::atomic<size_t> nextTrack { 0 };
+    auto arena = NodeAllocationArena::getCurrent();
+
+    auto createNextNodes = [&]
+    {
+        const NodeAllocationArena::ScopedUse scopedArena (arena);
+
+        for (auto i = nextTrack.fetch_add (1); i < tracks.size(); i = nextTrack.fetch_add (1))
+            nodes[i] = createNodeForTrack (*tracks[i], params);
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < numThreads; ++i)
+        threads.emplace_back (createNextNodes);
+
+    createNextNodes();
+
+    for (auto& t : threads)
+        t.join();
+
+    return nodes;
+}
+
 }
 
 //==============================================================================
 std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext& epc, std::atomic<double>& audibleTimeToUpdate, const CreateNodeParams& params)
 {
+    NodeAllocationArena::Ptr arena (params.allocateNodesFromArena ? new NodeAllocationArena() : nullptr);
+    const NodeAllocationArena::ScopedUse scopedArena (arena.get());
+
     Edit& edit = epc.edit;
     auto& playHeadState = params.processState.playHeadState;
     auto insertPlugins = getAllPluginsOfType<InsertPlugin> (edit);
 
+    if (! params.forRendering)
+        edit.getSceneList().updatePreloadedSlots();
+
     using TrackNodeVector = std::vector<std::unique_ptr<tracktion::graph::Node>>;
     std::map<OutputDevice*, TrackNodeVector> deviceNodes;
     std::vector<OutputDevice*> devicesWithFrozenNodes;
 
+    // Work out what goes to each device first so the track Nodes can be created together.
+    // Frozen groups are added straight away and have a nullptr track
+    struct DeviceInput
+    {
+        OutputDevice* device = nullptr;
+        Track* track = nullptr;
+        std::unique_ptr<Node> node;
+        bool isDirectMonitor = false;
+    };
+
+    // With direct monitoring, tracks playing live input are mixed in after the master
+    // plugins so they don't wait for the latency of everything else
+    std::map<OutputDevice*, TrackNodeVector> directMonitorNodes;
+
+    std::vector<DeviceInput> deviceInputs;
+    std::vector<Track*> tracksToCreate;
+
     for (auto t : getAllTracks (edit))
     {
         if (params.allowedTracks != nullptr && ! params.allowedTracks->contains (t))
@@ -1837,18 +2164,44 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
 
                     if (auto node = createGroupFreezeNodeForDevice (edit, *device, params.processState))
                     {
-                        deviceNodes[device].push_back (std::move (node));
+                        deviceInputs.push_back ({ device, nullptr, std::move (node) });
                         devicesWithFrozenNodes.push_back (device);
                     }
                 }
-                else if (auto node = createNodeForTrack (*t, params))
+                else
                 {
-                    deviceNodes[device].push_back (std::move (node));
+                    const bool isDirectMonitor = params.directMonitoring && isMonitoringLiveAudio (*t, params);
+                    deviceInputs.push_back ({ device, t, nullptr, isDirectMonitor });
+                    tracksToCreate.push_back (t);
                 }
             }
         }
     }
 
+    {
+        auto trackNodes = createNodesForTracks (tracksToCreate, params);
+        size_t trackIndex = 0;
+
+        for (auto& input : deviceInputs)
+        {
+            if (input.track != nullptr)
+                input.node = std::move (trackNodes[trackIndex++]);
+
+            if (input.node == nullptr)
+                continue;
+
+            if (input.isDirectMonitor)
+            {
+                directMonitorNodes[input.device].push_back (std::move (input.node));
+                deviceNodes[input.device]; // Ensure the device is in the map
+            }
+            else
+            {
+                deviceNodes[input.device].push_back (std::move (input.node));
+            }
+        }
+    }
+
     // Add deviceNodes for any devices only being used by InsertPlugins
     for (auto ins : insertPlugins)
     {
@@ -1903,6 +2256,7 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
         auto device = deviceAndTrackNode.first;
         jassert (device != nullptr);
         auto tracksVector = std::move (deviceAndTrackNode.second);
+        const bool hasTracks = ! tracksVector.empty();
 
         auto sumNode = std::make_unique<SummingNode> (std::move (tracksVector));
         sumNode->setDoubleProcessingPrecision (edit.engine.getPropertyStorage().getProperty (SettingID::use64Bit, false));
@@ -1940,12 +2294,31 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
                     node = makeNode<SharedLevelMeasuringNode> (std::move (previewMeasurer), std::move (node));
         }
 
+        if (auto monitorNodes = directMonitorNodes.find (device); monitorNodes != directMonitorNodes.end())
+        {
+            // The monitored tracks are lined up with each other but not with the rest of the Edit
+            auto monitorSumNode = std::make_unique<SummingNode>();
+            monitorSumNode->setLatencyCompensationEnabled (false);
+            monitorSumNode->addInput (std::move (node));
+            monitorSumNode->addInput (std::make_unique<SummingNode> (std::move (monitorNodes->second)));
+
+            node = std::move (monitorSumNode);
+        }
+
         if (edit.isClickTrackDevice (*device))
         {
-            auto clickAndTracksNode = makeSummingNode ({ node.release(),
-                                                         makeNode<ClickNode> (edit, getNumChannelsFromDevice (*device),
-                                                                              device->isMidi(), playHeadState.playHead).release() });
-            node = std::move (clickAndTracksNode);
+            auto clickNode = makeNode<ClickNode> (edit, getNumChannelsFromDevice (*device),
+                                                  device->isMidi(), playHeadState.playHead);
+
+            // If nothing else is going to this device, e.g. it's a cue output,
+            // the click can go straight to it rather than being summed
+            const bool isClickOnlyDevice = ! hasTracks && ! deviceIsBeingUsedAsInsert && ! edit.getIsPreviewEdit()
+                                            && edit.engine.getDeviceManager().getDefaultWaveOutDeviceID() != device->getDeviceID();
+
+            if (isClickOnlyDevice)
+                node = std::move (clickNode);
+            else
+                node = makeSummingNode ({ node.release(), clickNode.release() });
         }
 
         if (auto outputDeviceNode = createNodeForDevice (epc, *device, playHeadState, std::move (node)))
@@ -1962,6 +2335,9 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&
 
 std::unique_ptr<tracktion::graph::Node> createNodeForEdit (Edit& edit, const CreateNodeParams& originalParams)
 {
+    NodeAllocationArena::Ptr arena (originalParams.allocateNodesFromArena ? new NodeAllocationArena() : nullptr);
+    const NodeAllocationArena::ScopedUse scopedArena (arena.get());
+
     std::vector<std::unique_ptr<tracktion::graph::Node>> trackNodes;
     auto params = originalParams;
     auto& playHeadState = params.processState.playHeadState;
@@ -1969,6 +2345,8 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (Edit& edit, const Cre
     if (params.implicitlyIncludeSubmixChildTracks && params.allowedTracks != nullptr)
         *params.allowedTracks = addImplicitSubmixChildTracks (*params.allowedTracks);
 
+    std::vector<Track*> tracksToCreate;
+
     for (auto t : getAllTracks (edit))
     {
         if (params.allowedTracks != nullptr && ! params.allowedTracks->contains (t))
@@ -1985,8 +2363,20 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (Edit& edit, const Cre
             continue;
         }
 
-        if (auto node = createNodeForTrack (*t, params))
+        tracksToCreate.push_back (t);
+    }
+
+    auto createdNodes = createNodesForTracks (tracksToCreate, params);
+
+    for (size_t i = 0; i < tracksToCreate.size(); ++i)
+    {
+        if (auto node = std::move (createdNodes[i]))
+        {
+            if (params.stemTracks != nullptr && params.stemTracks->contains (tracksToCreate[i]))
+                node = std::make_unique<StemTapNode> (std::move (node), tracksToCreate[i]->itemID);
+
             trackNodes.push_back (std::move (node));
+        }
     }
 
     auto sumNode = std::make_unique<SummingNode> (std::move (trackNodes));
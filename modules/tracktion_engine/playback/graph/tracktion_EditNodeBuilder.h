@@ -32,7 +32,15 @@ struct CreateNodeParams
     bool includeBypassedPlugins = true;                 /**< If false, bypassed plugins will be completely ommited from the graph. */
     bool implicitlyIncludeSubmixChildTracks = true;     /**< If true, child track in submixes will be included regardless of the allowedTracks param. Only relevent when forRendering is also true. */
     bool allowClipSlots = true;                         /**< If true, track's clip slots will be included, set to false to disable these (which will use a slightly more efficient Node). */
-    bool readAheadTimeStretchNodes = false;             /**< TEMPORARY: If true, real-time time-stretch Nodes will use a larger buffer and background thread to reduce audio CPU use. */
+    bool readAheadTimeStretchNodes = false;             /**< If true, real-time time-stretch Nodes will use a larger buffer and background threads to reduce audio CPU use. */
+    bool renderTracksAnticipatively = false;            /**< If true, tracks that don't have any live inputs will be rendered ahead on background threads. @see AnticipativeRenderNode */
+    const juce::Array<Track*>* stemTracks = nullptr;    /**< If set, the outputs of any of these tracks that feed the master bus will be captured by a StemTapNode. Only relevant when rendering an Edit. */
+    int numThreadsForTrackNodes = 1;                    /**< If more than 1, the Nodes for the top-level tracks are created concurrently on this many threads. The Edit mustn't be modified whilst this happens. */
+    bool allowMonoClips = true;                         /**< If true, tracks whose audio clips are all mono and centred play them in mono, only making them stereo when they reach a plugin or are mixed with other audio. */
+    bool allocateNodesFromArena = true;                 /**< If true, the Nodes are allocated from a NodeAllocationArena which is freed in one go when the last of them is deleted. */
+    bool usePreRenderedContainerClips = false;          /**< If true, ContainerClips play a render of their contents once one has been made in the background. Ignored when rendering. @see ContainerClip::getPreRenderedContents */
+    bool directMonitoring = false;                      /**< If true, tracks monitoring live audio input skip the master plugins and latency compensation. Ignored when rendering. @see EngineBehaviour::shouldUseDirectMonitoring */
+    std::vector<TimeRange> clipTimeWindows;             /**< If not empty, only arranger clips that overlap one of these ranges will be included. Clips inside ContainerClips are always included. @see EditPlaybackContext::setClipWindowLength */
 };
 
 //==============================================================================
@@ -51,5 +59,10 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext&,
 /** Creates a Node to render an Edit. */
 std::unique_ptr<tracktion::graph::Node> createNodeForEdit (Edit&, const CreateNodeParams&);
 
+/** Creates a Node to play the contents of a ContainerClip, without its plugins or fades.
+    This is used to render the contents to a file. @see ContainerClip::canPreRenderContents
+*/
+std::unique_ptr<tracktion::graph::Node> createNodeForContainerClipContents (ContainerClip&, const CreateNodeParams&);
+
 
 }} // namespace tracktion { inline namespace engine
@@ -50,6 +50,10 @@ public:
 
         runClipFade (ts, 3.0s, 2, false);
         runClipFade (ts, 3.0s, 2, true);
+
+        runParallelTrackCreation (ts, 3.0s, 2);
+
+        runMonoClips (ts, 3.0s, 2);
     }
 
 private:
@@ -503,15 +507,140 @@ private:
         }
     }
 
+    void runParallelTrackCreation (graph::test_utilities::TestSetup ts,
+                                   TimeDuration durationInSeconds,
+                                   int numChannels)
+    {
+        using namespace tracktion::graph;
+        using namespace tracktion::graph::test_utilities;
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+
+        auto sinFile = tracktion::graph::test_utilities::getSinFile<juce::WavAudioFormat> (ts.sampleRate, durationInSeconds.inSeconds(), 2, 220.0f);
+
+        auto edit = test_utilities::createTestEdit (engine);
+        edit->ensureNumberOfAudioTracks (16);
+        edit->getMasterVolumePlugin()->setVolumeDb (0.0f);
+
+        for (auto track : getAudioTracks (*edit))
+        {
+            track->insertWaveClip ({}, sinFile->getFile(), ClipPosition { { {}, durationInSeconds } }, false);
+            track->getVolumePlugin()->setVolumeDb (gainToDb (1.0f / 16.0f));
+        }
+
+        auto render = [&] (int numThreadsForTrackNodes)
+        {
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState { playHead };
+            ProcessState processState { playHeadState, edit->tempoSequence };
+
+            auto node = createNode (*edit, processState, ts.sampleRate, ts.blockSize, numThreadsForTrackNodes);
+            graph::test_utilities::TestProcess<TracktionNodePlayer> testContext (std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                                                                        getPoolCreatorFunction (ThreadPoolStrategy::hybrid)),
+                                                                                 ts, numChannels, durationInSeconds.inSeconds(), true);
+            testContext.getNodePlayer().setNumThreads (0);
+            testContext.setPlayHead (&playHeadState.playHead);
+            playHeadState.playHead.playSyncedToRange ({});
+
+            return testContext.processAll();
+        };
+
+        beginTest ("Parallel track Node creation: " + graph::test_utilities::getDescription (ts));
+        {
+            auto expected = render (1);
+            auto result = render (4);
+
+            expectAudioBuffer (*this, result->buffer, 0, 1.0f, 0.707f);
+            expectAudioBuffer (*this, result->buffer, 1, 1.0f, 0.707f);
+
+            // The tracks should be summed in the same order so the output is identical
+            expectEquals (result->buffer.getNumSamples(), expected->buffer.getNumSamples());
+
+            float maxDiff = 0.0f;
+
+            for (int c = 0; c < numChannels; ++c)
+                for (int i = 0; i < result->buffer.getNumSamples(); ++i)
+                    maxDiff = std::max (maxDiff, std::abs (result->buffer.getSample (c, i) - expected->buffer.getSample (c, i)));
+
+            expectEquals (maxDiff, 0.0f);
+        }
+    }
+
+    /** Mono clips are played back in mono up to the track's plugins so should
+        sound the same as when they're made stereo straight away.
+    */
+    void runMonoClips (graph::test_utilities::TestSetup ts,
+                       TimeDuration durationInSeconds,
+                       int numChannels)
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+
+        auto sinFile = tracktion::graph::test_utilities::getSinFile<juce::WavAudioFormat> (ts.sampleRate, durationInSeconds.inSeconds(), 1, 220.0f);
+
+        auto edit = test_utilities::createTestEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+        track->insertWaveClip ({}, sinFile->getFile(), ClipPosition { { {}, durationInSeconds } }, false);
+
+        auto render = [&] (bool allowMonoClips)
+        {
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState { playHead };
+            ProcessState processState { playHeadState, edit->tempoSequence };
+
+            auto node = createNode (*edit, processState, ts.sampleRate, ts.blockSize, 1, allowMonoClips);
+            graph::test_utilities::TestProcess<TracktionNodePlayer> testContext (std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                                                                        getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                                 ts, numChannels, durationInSeconds.inSeconds(), true);
+            testContext.getNodePlayer().setNumThreads (0);
+            testContext.setPlayHead (&playHeadState.playHead);
+            playHeadState.playHead.playSyncedToRange ({});
+
+            return testContext.processAll();
+        };
+
+        auto expectSameAsStereo = [&]
+        {
+            auto expected = render (false);
+            auto result = render (true);
+
+            expectEquals (result->buffer.getNumSamples(), expected->buffer.getNumSamples());
+            expectGreaterThan (result->buffer.getRMSLevel (0, 0, result->buffer.getNumSamples()), 0.1f);
+
+            float maxDiff = 0.0f;
+
+            for (int c = 0; c < numChannels; ++c)
+                for (int i = 0; i < result->buffer.getNumSamples(); ++i)
+                    maxDiff = std::max (maxDiff, std::abs (result->buffer.getSample (c, i) - expected->buffer.getSample (c, i)));
+
+            expectLessThan (maxDiff, 1.0e-6f);
+        };
+
+        beginTest ("Mono clips with track plugins: " + graph::test_utilities::getDescription (ts));
+        {
+            expectSameAsStereo();
+        }
+
+        beginTest ("Mono clips without track plugins: " + graph::test_utilities::getDescription (ts));
+        {
+            for (auto p : track->pluginList.getPlugins())
+                p->deleteFromParent();
+
+            expectSameAsStereo();
+        }
+    }
+
     //==============================================================================
     //==============================================================================
     static std::unique_ptr<tracktion::graph::Node> createNode (Edit& edit, ProcessState& processState,
-                                                               double sampleRate, int blockSize)
+                                                               double sampleRate, int blockSize,
+                                                               int numThreadsForTrackNodes = 1,
+                                                               bool allowMonoClips = true)
     {
         CreateNodeParams params { processState };
         params.sampleRate = sampleRate;
         params.blockSize = blockSize;
         params.forRendering = true; // Required for audio files to be read
+        params.numThreadsForTrackNodes = numThreadsForTrackNodes;
+        params.allowMonoClips = allowMonoClips;
         return createNodeForEdit (edit, params);
     }
 
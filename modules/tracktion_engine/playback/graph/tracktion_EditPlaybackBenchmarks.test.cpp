@@ -0,0 +1,405 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_EDITPLAYBACK
+
+#include "tracktion_BenchmarkUtilities.h"
+#include "../../utilities/tracktion_TestUtilities.h"
+
+
+namespace tracktion { inline namespace engine
+{
+
+using namespace tracktion::graph;
+
+//==============================================================================
+//==============================================================================
+/**
+    Plays back whole Edits, built to look like typical sessions, and times each
+    callback. As well as the usual totals, the 50th and 99th percentile and max
+    callback times are added to the BenchmarkList along with the proportion of
+    callbacks that missed the real-time deadline of the block size.
+*/
+class EditPlaybackBenchmarks : public juce::UnitTest
+{
+public:
+    EditPlaybackBenchmarks()
+        : juce::UnitTest ("Edit Playback Benchmarks", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+
+        for (auto size : { EditSize { 8, 4, 2 }, EditSize { 32, 8, 4 }, EditSize { 128, 16, 4 } })
+            runTracksClipsAndPluginsBenchmark (engine, size);
+
+        for (int numFiles : { 32, 128 })
+            runFileStreamingBenchmark (engine, numFiles);
+
+        runTimeStretchingBenchmark (engine);
+        runAutomationBenchmark (engine);
+        runClipLauncherBenchmark (engine);
+        runGraphRebuildBenchmark (engine);
+        runEditLoadBenchmark (engine);
+    }
+
+private:
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int blockSize = 256;
+
+    struct EditSize
+    {
+        int numTracks = 0, numClipsPerTrack = 0, numPluginsPerTrack = 0;
+
+        juce::String getDescription() const
+        {
+            return juce::String (numTracks) + " tracks x " + juce::String (numClipsPerTrack) + " clips x "
+                    + juce::String (numPluginsPerTrack) + " plugins";
+        }
+    };
+
+    //==============================================================================
+    /** Adds the percentiles of a set of durations to the BenchmarkList.
+        If a deadline is given, the max load and proportion of durations that
+        went over it are also added.
+    */
+    void addDurationResults (std::string category, std::string name, std::string description,
+                             std::vector<double> durations, double deadlineSeconds = 0.0)
+    {
+        if (durations.empty())
+            return expect (false);
+
+        std::sort (durations.begin(), durations.end());
+
+        const auto numDurations = durations.size();
+        const auto total = std::accumulate (durations.begin(), durations.end(), 0.0);
+        const auto mean = total / (double) numDurations;
+        const auto variance = std::accumulate (durations.begin(), durations.end(), 0.0,
+                                               [mean] (auto sum, auto d) { return sum + (d - mean) * (d - mean); })
+                                / (double) numDurations;
+
+        auto getPercentile = [&durations, numDurations] (double p)
+        {
+            return durations[std::min (numDurations - 1, (size_t) (p * (double) numDurations))];
+        };
+
+        auto addResult = [&] (std::string suffix, double value)
+        {
+            BenchmarkResult bmr { createBenchmarkDescription (category, name + suffix, description) };
+            bmr.totalSeconds = value;
+            BenchmarkList::getInstance().addResult (bmr);
+        };
+
+        BenchmarkResult bmr { createBenchmarkDescription (category, name, description) };
+        bmr.totalSeconds = total;
+        bmr.meanSeconds = mean;
+        bmr.minSeconds = durations.front();
+        bmr.maxSeconds = durations.back();
+        bmr.varianceSeconds = variance;
+        BenchmarkList::getInstance().addResult (bmr);
+
+        addResult (": p50", getPercentile (0.5));
+        addResult (": p99", getPercentile (0.99));
+        addResult (": max", durations.back());
+
+        std::cout << name << "\n\tp50: " << getPercentile (0.5) << "s, p99: " << getPercentile (0.99)
+                  << "s, max: " << durations.back() << "s";
+
+        if (deadlineSeconds > 0.0)
+        {
+            const auto numOverruns = std::count_if (durations.begin(), durations.end(),
+                                                    [deadlineSeconds] (auto d) { return d > deadlineSeconds; });
+
+            // N.B. These are stored as ratios, not seconds
+            addResult (": max load", durations.back() / deadlineSeconds);
+            addResult (": overruns", (double) numOverruns / (double) numDurations);
+
+            std::cout << ", deadline: " << deadlineSeconds << "s, overruns: " << numOverruns << "/" << numDurations;
+        }
+
+        std::cout << "\n";
+    }
+
+    /** Plays back an Edit from the start, timing each callback.
+        The optional callback is called before each block is processed, on the
+        same thread, so it can make changes to the Edit's playback.
+    */
+    void playEdit (Edit& edit, std::string name, std::string description,
+                   std::function<void (int)> beforeBlock = {})
+    {
+        beginTest (name + " - " + description);
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState, edit.tempoSequence };
+
+        auto node = benchmark_utilities::createNode (edit, processState, sampleRate, blockSize);
+        expect (node != nullptr);
+
+        tracktion::graph::test_utilities::TestSetup ts;
+        ts.sampleRate = sampleRate;
+        ts.blockSize = blockSize;
+
+        tracktion::graph::test_utilities::TestProcess<TracktionNodePlayer> testContext (std::make_unique<TracktionNodePlayer> (std::move (node), processState, sampleRate, blockSize,
+                                                                                                                               getPoolCreatorFunction (ThreadPoolStrategy::realTime)),
+                                                                                       ts, 2, edit.getLength().inSeconds(), false);
+        testContext.getNodePlayer().setNumThreads ((size_t) std::max (0, juce::SystemStats::getNumCpus() - 1));
+        testContext.setPlayHead (&playHeadState.playHead);
+        playHeadState.playHead.playSyncedToRange ({});
+
+        std::vector<double> durations;
+        bool hasMoreToProcess = true;
+
+        for (int blockIndex = 0; hasMoreToProcess; ++blockIndex)
+        {
+            if (beforeBlock)
+                beforeBlock (blockIndex);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            hasMoreToProcess = testContext.process (blockSize);
+            durations.push_back (juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start));
+        }
+
+        addDurationResults ("Edit Playback", name, description, std::move (durations), blockSize / sampleRate);
+    }
+
+    //==============================================================================
+    static void addPlugins (AudioTrack& track, int numPlugins)
+    {
+        const juce::StringArray pluginTypes { EqualiserPlugin::xmlTypeName,
+                                              CompressorPlugin::xmlTypeName,
+                                              DelayPlugin::xmlTypeName,
+                                              ReverbPlugin::xmlTypeName,
+                                              ChorusPlugin::xmlTypeName };
+
+        for (int i = 0; i < numPlugins; ++i)
+            if (auto plugin = track.edit.getPluginCache().createNewPlugin (pluginTypes[i % pluginTypes.size()], {}))
+                track.pluginList.insertPlugin (plugin, -1, nullptr);
+    }
+
+    /** Fills an Edit with tracks that each have a number of 1s clips, spaced 1s apart. */
+    static void addClips (Edit& edit, int numTracks, int numClipsPerTrack, std::function<juce::File (int)> getFileForTrack)
+    {
+        edit.ensureNumberOfAudioTracks (numTracks);
+
+        for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex)
+        {
+            auto track = getAudioTracks (edit)[trackIndex];
+            const auto file = getFileForTrack (trackIndex);
+
+            for (int clipIndex = 0; clipIndex < numClipsPerTrack; ++clipIndex)
+            {
+                const auto start = TimePosition::fromSeconds (clipIndex * 2.0);
+
+                if (auto clip = insertWaveClip (*track, {}, file, { { start, start + 1_td } }, DeleteExistingClips::no))
+                    clip->setUsesProxy (false);
+            }
+        }
+    }
+
+    std::unique_ptr<Edit> createEdit (Engine& engine, EditSize size, const juce::File& file)
+    {
+        auto edit = test_utilities::createTestEdit (engine, size.numTracks);
+        addClips (*edit, size.numTracks, size.numClipsPerTrack, [&file] (int) { return file; });
+
+        for (auto track : getAudioTracks (*edit))
+            addPlugins (*track, size.numPluginsPerTrack);
+
+        return edit;
+    }
+
+    //==============================================================================
+    void runTracksClipsAndPluginsBenchmark (Engine& engine, EditSize size)
+    {
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 1.0, 2);
+        auto edit = createEdit (engine, size, sinFile->getFile());
+
+        playEdit (*edit, "Tracks, clips and plugins", size.getDescription().toStdString());
+    }
+
+    void runFileStreamingBenchmark (Engine& engine, int numFiles)
+    {
+        // Every clip uses a different file so none of the reads are shared
+        std::vector<std::unique_ptr<juce::TemporaryFile>> files;
+
+        for (int i = 0; i < numFiles; ++i)
+            files.push_back (graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 20.0, 2, 220.0f + (float) i));
+
+        auto edit = test_utilities::createTestEdit (engine, numFiles);
+
+        for (int i = 0; i < numFiles; ++i)
+            if (auto clip = insertWaveClip (*getAudioTracks (*edit)[i], {}, files[(size_t) i]->getFile(), { { 0_tp, 20_tp } }, DeleteExistingClips::no))
+                clip->setUsesProxy (false);
+
+        playEdit (*edit, "File streaming", juce::String (numFiles).toStdString() + " files");
+    }
+
+    void runTimeStretchingBenchmark (Engine& engine)
+    {
+        constexpr int numTracks = 16;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 1.0, 2);
+        auto edit = createEdit (engine, { numTracks, 8, 0 }, sinFile->getFile());
+
+        // Each file is a 2 beat loop at 120bpm, so it's stretched to fit the Edit's tempo
+        edit->tempoSequence.getTempo (0)->setBpm (133.0);
+
+        for (auto track : getAudioTracks (*edit))
+        {
+            for (auto clip : track->getClips())
+            {
+                if (auto audioClip = dynamic_cast<AudioClipBase*> (clip))
+                {
+                    audioClip->getLoopInfo().setBpm (120.0, audioClip->getAudioFile().getInfo());
+                    audioClip->setAutoTempo (true);
+                    audioClip->setTimeStretchMode (TimeStretcher::defaultMode);
+                }
+            }
+        }
+
+        playEdit (*edit, "Tempo-synced stretching", juce::String (numTracks).toStdString() + " tracks, auto-tempo");
+    }
+
+    void runAutomationBenchmark (Engine& engine)
+    {
+        constexpr int numTracks = 32, numPoints = 1000;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 1.0, 2);
+        auto edit = createEdit (engine, { numTracks, 8, 2 }, sinFile->getFile());
+        const auto length = edit->getLength().inSeconds();
+
+        // Automate the volume and pan of every track, with a point every few blocks
+        for (auto track : getAudioTracks (*edit))
+        {
+            auto volumePlugin = track->getVolumePlugin();
+
+            for (auto param : { volumePlugin->volParam, volumePlugin->panParam })
+            {
+                auto& curve = param->getCurve();
+
+                for (int i = 0; i < numPoints; ++i)
+                    curve.addPoint (TimePosition::fromSeconds (length * i / numPoints),
+                                    (i % 2 == 0) ? param->valueRange.start : param->valueRange.end,
+                                    (i % 3) * 0.25f, nullptr);
+            }
+        }
+
+        playEdit (*edit, "Automation", juce::String (numTracks).toStdString() + " tracks, "
+                                        + juce::String (numPoints * 2).toStdString() + " points per track");
+    }
+
+    void runClipLauncherBenchmark (Engine& engine)
+    {
+        constexpr int numTracks = 32, numScenes = 8, blocksPerScene = 32;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 1.0, 2);
+        auto edit = test_utilities::createTestEdit (engine, numTracks);
+
+        // An arranger clip gives the Edit enough length to play all the scenes
+        addClips (*edit, 1, (numScenes * blocksPerScene * blockSize) / (int) (sampleRate * 2.0) + 1,
+                  [&sinFile] (int) { return sinFile->getFile(); });
+
+        std::vector<std::vector<std::shared_ptr<LaunchHandle>>> scenes ((size_t) numScenes);
+
+        for (auto track : getAudioTracks (*edit))
+        {
+            auto& clipSlotList = track->getClipSlotList();
+            clipSlotList.ensureNumberOfSlots (numScenes);
+            auto slots = clipSlotList.getClipSlots();
+
+            for (int sceneIndex = 0; sceneIndex < numScenes; ++sceneIndex)
+            {
+                if (auto clip = insertWaveClip (*slots[sceneIndex], {}, sinFile->getFile(), { { 0_tp, 1_tp } }, DeleteExistingClips::no))
+                {
+                    clip->setUsesProxy (false);
+                    clip->setLoopRange ({ 0_tp, 1_tp });
+                    scenes[(size_t) sceneIndex].push_back (clip->getLaunchHandle());
+                }
+            }
+        }
+
+        // Launch a whole scene at once every few blocks, stopping the last one
+        playEdit (*edit, "Clip launcher", juce::String (numTracks).toStdString() + " clips launched at once",
+                  [&scenes] (int blockIndex)
+                  {
+                      if (blockIndex % blocksPerScene != 0)
+                          return;
+
+                      const auto sceneIndex = (size_t) (blockIndex / blocksPerScene) % scenes.size();
+                      const auto lastSceneIndex = (sceneIndex + scenes.size() - 1) % scenes.size();
+
+                      LaunchHandle::Batch batch;
+
+                      for (auto& handle : scenes[lastSceneIndex])
+                          batch.stop (*handle, {});
+
+                      for (auto& handle : scenes[sceneIndex])
+                          batch.play (*handle, {});
+                  });
+    }
+
+    void runGraphRebuildBenchmark (Engine& engine)
+    {
+        constexpr int numRebuilds = 20;
+        const EditSize size { 128, 16, 4 };
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 1.0, 2);
+        auto edit = createEdit (engine, size, sinFile->getFile());
+
+        beginTest ("Graph rebuild - " + size.getDescription());
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState, edit->tempoSequence };
+        std::unique_ptr<NodeGraph> lastGraph;
+        std::vector<double> durations;
+
+        // Each rebuild gets the previous graph so it can reuse its memory, as happens during playback
+        for (int i = 0; i < numRebuilds; ++i)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            auto node = benchmark_utilities::createNode (*edit, processState, sampleRate, blockSize);
+            lastGraph = node_player_utils::prepareToPlay (std::move (node), lastGraph.get(), sampleRate, blockSize);
+            durations.push_back (juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start));
+        }
+
+        expect (lastGraph != nullptr);
+        addDurationResults ("Edit Playback", "Graph rebuild", size.getDescription().toStdString(), std::move (durations));
+    }
+
+    void runEditLoadBenchmark (Engine& engine)
+    {
+        constexpr int numLoads = 10;
+        const EditSize size { 128, 16, 4 };
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 1.0, 2);
+        auto editState = createEdit (engine, size, sinFile->getFile())->state.createCopy();
+
+        beginTest ("Edit load - " + size.getDescription());
+
+        std::vector<double> durations;
+
+        for (int i = 0; i < numLoads; ++i)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            auto edit = benchmark_utilities::loadEditFromValueTree (engine, editState.createCopy());
+            durations.push_back (juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start));
+
+            expect (edit != nullptr);
+        }
+
+        addDurationResults ("Edit Playback", "Edit load", size.getDescription().toStdString(), std::move (durations));
+    }
+};
+
+static EditPlaybackBenchmarks editPlaybackBenchmarks;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
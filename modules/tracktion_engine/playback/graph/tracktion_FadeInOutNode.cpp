@@ -56,14 +56,10 @@ namespace fade_utils
             }
 
             if (endSamp > startSamp)
-            {
-                auto buffer = tracktion::graph::toAudioBuffer (audio);
-                AudioFadeCurve::applyCrossfadeSection (buffer,
-                                                       startSamp, endSamp - startSamp,
-                                                       fadeInType,
-                                                       (float) alpha1,
-                                                       (float) alpha2);
-            }
+                AudioFadeCurve::applyGainRamp (audio.getFrameRange ({ (choc::buffer::FrameCount) startSamp, (choc::buffer::FrameCount) endSamp }),
+                                               fadeInType,
+                                               (float) alpha1,
+                                               (float) alpha2);
         }
         else if (clearExtraSamples && editTime.getStart() <= fadeIn.getStart())
         {
@@ -102,14 +98,10 @@ namespace fade_utils
             }
 
             if (endSamp > startSamp)
-            {
-                auto buffer = tracktion::graph::toAudioBuffer (audio);
-                AudioFadeCurve::applyCrossfadeSection (buffer,
-                                                       startSamp, endSamp - startSamp,
-                                                       fadeOutType,
-                                                       juce::jlimit (0.0f, 1.0f, (float) (1.0 - alpha1)),
-                                                       juce::jlimit (0.0f, 1.0f, (float) (1.0 - alpha2)));
-            }
+                AudioFadeCurve::applyGainRamp (audio.getFrameRange ({ (choc::buffer::FrameCount) startSamp, (choc::buffer::FrameCount) endSamp }),
+                                               fadeOutType,
+                                               juce::jlimit (0.0f, 1.0f, (float) (1.0 - alpha1)),
+                                               juce::jlimit (0.0f, 1.0f, (float) (1.0 - alpha2)));
         }
         else if (clearExtraSamples && editTime.getEnd() >= fadeOut.getEnd())
         {
@@ -180,10 +172,11 @@ void FadeInOutNode::process (ProcessContext& pc)
 
     destMidiBlock.copyFrom (sourceBuffers.midi);
 
-    if (! renderingNeeded (editTimeRange))
+    if (sourceBuffers.isAudioSilent || ! renderingNeeded (editTimeRange))
     {
-        // If we don't need to apply the fade, just pass through the buffer
+        // If the input is silent or we don't need to apply the fade, just pass through the buffer
         setAudioOutput (input.get(), sourceBuffers.audio);
+        pc.buffers.isAudioSilent = sourceBuffers.isAudioSilent;
         return;
     }
 
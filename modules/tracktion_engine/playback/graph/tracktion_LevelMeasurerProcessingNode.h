@@ -52,6 +52,11 @@ public:
         return input->hasProcessed();
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info) override
     {
         initialisePlugin();
@@ -112,10 +117,12 @@ public:
             copyIfNotAliased (pc.buffers.audio, sourceBuffers.audio);
         }
 
+        pc.buffers.isAudioSilent = sourceBuffers.isAudioSilent;
+
         // If we have no latency, simply process the meter
         if (! latencyProcessor)
         {
-            processLevelMeasurer (meterPlugin.measurer, sourceBuffers.audio, pc.buffers.midi);
+            processLevelMeasurer (meterPlugin.measurer, sourceBuffers.audio, pc.buffers.midi, sourceBuffers.isAudioSilent);
             return;
         }
 
@@ -153,10 +160,18 @@ private:
         isInitialised = true;
     }
 
-    void processLevelMeasurer (LevelMeasurer& measurer, choc::buffer::ChannelArrayView<float> block, MidiMessageArray& midi)
+    void processLevelMeasurer (LevelMeasurer& measurer, choc::buffer::ChannelArrayView<float> block, MidiMessageArray& midi,
+                               bool isSilent = false)
     {
-        auto buffer = tracktion::graph::toAudioBuffer (block);
-        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        if (isSilent)
+        {
+            measurer.processSilence ((int) block.getNumChannels());
+        }
+        else
+        {
+            auto buffer = tracktion::graph::toAudioBuffer (block);
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        }
 
         measurer.setShowMidi (meterPlugin.showMidiActivity);
         measurer.processMidi (midi, nullptr);
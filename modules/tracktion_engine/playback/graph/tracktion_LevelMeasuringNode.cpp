@@ -37,6 +37,7 @@ void LevelMeasuringNode::process (tracktion::graph::Node::ProcessContext& pc)
 
     // Just pass out input on to our output
     setAudioOutput (input.get(), sourceBuffers.audio);
+    pc.buffers.isAudioSilent = sourceBuffers.isAudioSilent;
 
     // If the source only outputs to this node, we can steal its data
     if (input->numOutputNodes == 1)
@@ -45,7 +46,11 @@ void LevelMeasuringNode::process (tracktion::graph::Node::ProcessContext& pc)
         pc.buffers.midi.copyFrom (sourceBuffers.midi);
 
     // Then update the levels
-    if (sourceBuffers.audio.getNumChannels() > 0)
+    if (sourceBuffers.isAudioSilent)
+    {
+        levelMeasurer.processSilence ((int) sourceBuffers.audio.getNumChannels());
+    }
+    else if (sourceBuffers.audio.getNumChannels() > 0)
     {
         auto buffer = tracktion::graph::toAudioBuffer (sourceBuffers.audio);
         levelMeasurer.processBuffer (buffer, 0, buffer.getNumSamples());
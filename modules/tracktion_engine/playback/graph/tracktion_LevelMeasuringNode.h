@@ -22,6 +22,7 @@ public:
     tracktion::graph::NodeProperties getNodeProperties() override;
     std::vector<tracktion::graph::Node*> getDirectInputNodes() override  { return { input.get() }; }
     bool isReadyToProcess() override                                    { return input->hasProcessed(); }
+    bool canProcessSplitTimelineRanges() override                       { return true; }
     void process (tracktion::graph::Node::ProcessContext&) override;
 
 private:
@@ -153,41 +153,39 @@ namespace chocMidiHelpers
         Kind lastSentKind = Kind::rpn, newestKind = Kind::rpn;
     };
 
-    inline void createControllerUpdatesForTime (const choc::midi::Sequence& sequence,
-                                                uint8_t channel, double time,
-                                                juce::Array<juce::MidiMessage>& dest)
+    /** The controller state of a single channel, built up by replaying its messages in order. */
+    struct ChannelControllerState
     {
-        ProgramChange programChange;
-        ControllerValues controllerValues;
-        PitchWheel pitchWheel;
-        ParameterNumberState parameterNumberState;
-
-        for (const auto& event : sequence)
+        /** Applies a message on this channel to the state.
+            Data entry messages can't be summarised so are added to the dest buffer as they're
+            found, preceded by their parameter number if needed.
+        */
+        void process (const choc::midi::Sequence::Event& event, uint8_t channel,
+                      juce::Array<juce::MidiMessage>* dest)
         {
-            if (! event.message.isShortMessage())
-                continue;
-
             const auto& mm = event.message;
 
-            if (! (mm.getChannel1to16() == channel && event.timeStamp <= time))
-                continue;
-
             if (mm.isController())
             {
                 const auto num = mm.getControllerNumber();
 
                 if (parameterNumberState.trySetProgramNumber (num, mm.getControllerValue()))
-                    continue;
+                    return;
 
                 if (programChange.trySetBank (num, mm.getControllerValue()))
-                    continue;
+                    return;
 
                 constexpr int passthroughs[] { 0x06, 0x26, 0x60, 0x61 };
 
                 if (std::find (std::begin (passthroughs), std::end (passthroughs), num) != std::end (passthroughs))
                 {
-                    parameterNumberState.sendIfNecessary (channel, event.timeStamp, dest);
-                    dest.add (toMidiMessage (event));
+                    hasDataEntry = true;
+
+                    if (dest != nullptr)
+                    {
+                        parameterNumberState.sendIfNecessary (channel, event.timeStamp, *dest);
+                        dest->add (toMidiMessage (event));
+                    }
                 }
                 else
                 {
@@ -204,16 +202,153 @@ namespace chocMidiHelpers
             }
         }
 
-        pitchWheel.addToBuffer (channel, dest);
+        /** Adds the messages needed to restore this state. */
+        void addToBuffer (uint8_t channel, double time, juce::Array<juce::MidiMessage>& dest)
+        {
+            pitchWheel.addToBuffer (channel, dest);
+
+            controllerValues.addToBuffer (channel, dest);
+
+            // Also emits bank change messages if necessary.
+            programChange.addToBuffer (channel, time, dest);
+
+            // Set the parameter number to its final state.
+            parameterNumberState.sendIfNecessary (channel, time, dest);
+        }
+
+        ProgramChange programChange;
+        ControllerValues controllerValues;
+        PitchWheel pitchWheel;
+        ParameterNumberState parameterNumberState;
+        bool hasDataEntry = false;
+    };
+
+    inline void createControllerUpdatesForTime (const choc::midi::Sequence& sequence,
+                                                uint8_t channel, double time,
+                                                juce::Array<juce::MidiMessage>& dest)
+    {
+        ChannelControllerState state;
+
+        for (const auto& event : sequence)
+        {
+            if (! event.message.isShortMessage())
+                continue;
 
-        controllerValues.addToBuffer (channel, dest);
+            if (! (event.message.getChannel1to16() == channel && event.timeStamp <= time))
+                continue;
 
-        // Also emits bank change messages if necessary.
-        programChange.addToBuffer (channel, time, dest);
+            state.process (event, channel, &dest);
+        }
 
-        // Set the parameter number to its final state.
-        parameterNumberState.sendIfNecessary (channel, time, dest);
+        state.addToBuffer (channel, time, dest);
     }
+
+    //==============================================================================
+    /** Checkpoints the controller state of every channel at regular intervals through a
+        sorted sequence, so chasing the state at a time only has to replay the events
+        since the closest checkpoint rather than the whole sequence.
+    */
+    class ControllerStateIndex
+    {
+    public:
+        /** Reserves space for sequences of up to this many events so that rebuilding
+            the index doesn't need to allocate.
+        */
+        void reserve (size_t maxNumEvents)
+        {
+            checkpoints.reserve (maxNumEvents / eventsPerCheckpoint + 1);
+        }
+
+        /** Call this when the sequence has changed so the index is rebuilt the next time it's used. */
+        void invalidate()
+        {
+            needsRebuilding = true;
+        }
+
+        /** Adds the messages needed to restore the state of a channel at the given time.
+            This produces the same messages as the free function of the same name.
+        */
+        void createControllerUpdatesForTime (const choc::midi::Sequence& sequence,
+                                             uint8_t channel, double time,
+                                             juce::Array<juce::MidiMessage>& dest)
+        {
+            jassert (channel >= 1 && channel <= 16);
+
+            if (needsRebuilding)
+                rebuild (sequence);
+
+            auto next = std::upper_bound (checkpoints.begin(), checkpoints.end(), time,
+                                          [] (double t, const Checkpoint& c) { return t < c.lastTimeStamp; });
+
+            // Data entry messages have to be replayed from the start
+            if (next == checkpoints.begin()
+                || std::prev (next)->channels[channel - 1].hasDataEntry)
+            {
+                chocMidiHelpers::createControllerUpdatesForTime (sequence, channel, time, dest);
+                return;
+            }
+
+            const auto& checkpoint = *std::prev (next);
+            auto state = checkpoint.channels[channel - 1];
+            const auto numEvents = sequence.events.size();
+
+            for (auto i = checkpoint.index; i < numEvents; ++i)
+            {
+                const auto& event = sequence.events[i];
+
+                if (event.timeStamp > time)
+                    break;
+
+                if (event.message.isShortMessage() && event.message.getChannel1to16() == channel)
+                    state.process (event, channel, &dest);
+            }
+
+            state.addToBuffer (channel, time, dest);
+        }
+
+    private:
+        static constexpr size_t eventsPerCheckpoint = 256;
+
+        struct Checkpoint
+        {
+            size_t index = 0;               // The first event not included in the state
+            double lastTimeStamp = 0.0;     // The time of the last event included in the state
+            ChannelControllerState channels[16];
+        };
+
+        std::vector<Checkpoint> checkpoints;
+        bool needsRebuilding = true;
+
+        void rebuild (const choc::midi::Sequence& sequence)
+        {
+            jassert (std::is_sorted (sequence.begin(), sequence.end()));
+            checkpoints.clear();
+
+            ChannelControllerState channels[16];
+            const auto numEvents = sequence.events.size();
+
+            for (size_t i = 0; i < numEvents; ++i)
+            {
+                const auto& event = sequence.events[i];
+
+                if (event.message.isShortMessage())
+                {
+                    const auto channel = event.message.getChannel1to16();
+                    channels[channel - 1].process (event, channel, nullptr);
+                }
+
+                if ((i + 1) % eventsPerCheckpoint == 0)
+                {
+                    auto& checkpoint = checkpoints.emplace_back();
+                    checkpoint.index = i + 1;
+                    checkpoint.lastTimeStamp = event.timeStamp;
+                    std::copy (std::begin (channels), std::end (channels), std::begin (checkpoint.channels));
+                }
+            }
+
+            needsRebuilding = false;
+        }
+    };
 }
 
 //==============================================================================
@@ -364,9 +499,20 @@ namespace MidiHelpers
         return dest;
     }
 
+    /** Finds the matching note-off for each note-on in the sequence.
+        Note-ons are paired with the next note-off on the same note and channel.
+        The map is sorted by note-on index so it can be searched with getNoteOff.
+    */
     inline void createNoteOffMap (std::vector<std::pair<size_t, size_t>>& noteOffMap,
                                   const choc::midi::Sequence& seq)
     {
+        constexpr auto none = std::numeric_limits<size_t>::max();
+
+        // Unmatched note-ons for each channel/note are chained through the
+        // second element of their map entries until a note-off is found
+        std::array<size_t, 16 * 128> lastUnmatched;
+        lastUnmatched.fill (none);
+
         noteOffMap.clear();
         const auto seqLen = seq.events.size();
 
@@ -377,64 +523,66 @@ namespace MidiHelpers
             if (! m.isShortMessage())
                 continue;
 
+            const auto key = (size_t) m.getChannel0to15() * 128 + m.getNoteNumber();
+
             if (m.isNoteOn())
             {
-                const auto note = m.getNoteNumber();
-                const auto chan = m.getChannel0to15();
+                noteOffMap.emplace_back (i, lastUnmatched[key]);
+                lastUnmatched[key] = noteOffMap.size() - 1;
+            }
+            else if (m.isNoteOff())
+            {
+                for (auto entry = lastUnmatched[key]; entry != none;)
+                    entry = std::exchange (noteOffMap[entry].second, i);
 
-                for (size_t j = i + 1; j < seqLen; ++j)
-                {
-                    const auto& m2 = seq.events[j].message;
+                lastUnmatched[key] = none;
+            }
+        }
 
-                    if (! m2.isShortMessage())
-                        continue;
+        // Note-ons without a note-off don't get an entry
+        bool anyUnmatched = false;
 
-                    if (m2.getNoteNumber() == note
-                         && m2.getChannel0to15() == chan
-                         && m2.isNoteOff())
-                    {
-                        noteOffMap.emplace_back (std::make_pair (i, j));
-                        break;
-                    }
-                }
+        for (auto& entry : lastUnmatched)
+        {
+            for (auto e = entry; e != none;)
+            {
+                e = std::exchange (noteOffMap[e].second, none);
+                anyUnmatched = true;
             }
         }
+
+        if (anyUnmatched)
+            std::erase_if (noteOffMap, [] (const auto& p) { return p.second == none; });
     }
 
-    inline choc::midi::Sequence::Event* getNoteOff (size_t noteOnIndex,
-                                                    choc::midi::Sequence& ms,
-                                                    const std::vector<std::pair<size_t, size_t>>& noteOffMap)
+    inline std::optional<size_t> getNoteOffIndex (size_t noteOnIndex,
+                                                  const std::vector<std::pair<size_t, size_t>>& noteOffMap)
     {
-        auto found = std::find_if (noteOffMap.begin(), noteOffMap.end(),
-                                   [noteOnIndex] (const auto& m) { return m.first == noteOnIndex; });
+        auto found = std::lower_bound (noteOffMap.begin(), noteOffMap.end(), noteOnIndex,
+                                       [] (const auto& m, size_t index) { return m.first < index; });
 
-        if (found != noteOffMap.end())
-            return &ms.events[found->second];
+        if (found != noteOffMap.end() && found->first == noteOnIndex)
+            return found->second;
 
         return {};
     }
 
-    inline const choc::midi::Sequence::Event* getNoteOff (size_t noteOnIndex,
-                                                          const choc::midi::Sequence& ms,
-                                                          const std::vector<std::pair<size_t, size_t>>& noteOffMap)
+    inline choc::midi::Sequence::Event* getNoteOff (size_t noteOnIndex,
+                                                    choc::midi::Sequence& ms,
+                                                    const std::vector<std::pair<size_t, size_t>>& noteOffMap)
     {
-        auto found = std::find_if (noteOffMap.begin(), noteOffMap.end(),
-                                   [noteOnIndex] (const auto& m) { return m.first == noteOnIndex; });
-
-        if (found != noteOffMap.end())
-            return &ms.events[found->second];
+        if (auto index = getNoteOffIndex (noteOnIndex, noteOffMap))
+            return &ms.events[*index];
 
         return {};
     }
 
-    inline std::optional<size_t> getNoteOffIndex (size_t noteOnIndex,
-                                                  const std::vector<std::pair<size_t, size_t>>& noteOffMap)
+    inline const choc::midi::Sequence::Event* getNoteOff (size_t noteOnIndex,
+                                                          const choc::midi::Sequence& ms,
+                                                          const std::vector<std::pair<size_t, size_t>>& noteOffMap)
     {
-        auto found = std::find_if (noteOffMap.begin(), noteOffMap.end(),
-                                   [noteOnIndex] (const auto& m) { return m.first == noteOnIndex; });
-
-        if (found != noteOffMap.end())
-            return found->second;
+        if (auto index = getNoteOffIndex (noteOnIndex, noteOffMap))
+            return &ms.events[*index];
 
         return {};
     }
@@ -492,7 +640,7 @@ namespace MidiHelpers
                        });
     }
 
-    inline void applyGrooveToSequence (const GrooveTemplate& groove, float grooveStrength, choc::midi::Sequence& ms)
+    inline void applyGrooveToSequence (const CompiledGrooveTemplate& groove, float grooveStrength, choc::midi::Sequence& ms)
     {
         for (auto& e : ms)
             if (e.message.isNoteOn() || e.message.isNoteOff())
@@ -502,6 +650,7 @@ namespace MidiHelpers
     inline void createMessagesForTime (MidiMessageArray& destBuffer,
                                        const choc::midi::Sequence& sourceSequence,
                                        const std::vector<std::pair<size_t, size_t>>& noteOffMap,
+                                       chocMidiHelpers::ControllerStateIndex& controllerStateIndex,
                                        double time,
                                        juce::Range<int> channelNumbers,
                                        LiveClipLevel& clipLevel,
@@ -512,11 +661,11 @@ namespace MidiHelpers
         {
             const auto indexOfTime = [&]() -> size_t
                                      {
-                                         const auto numEvents = sourceSequence.events.size();
+                                         auto found = std::lower_bound (sourceSequence.begin(), sourceSequence.end(), time,
+                                                                        [] (const auto& e, double t) { return e.timeStamp < t; });
 
-                                         for (size_t i = 0; i < numEvents; ++i)
-                                             if (sourceSequence.events[i].timeStamp >= time)
-                                                 return i;
+                                         if (found != sourceSequence.end())
+                                             return (size_t) std::distance (sourceSequence.begin(), found);
 
                                          return {};
                                      }();
@@ -535,7 +684,7 @@ namespace MidiHelpers
                 controllerMessagesScratchBuffer.clearQuick();
 
                 for (int i = channelNumbers.getStart(); i < channelNumbers.getEnd(); ++i)
-                    chocMidiHelpers::createControllerUpdatesForTime (sourceSequence, (uint8_t) i, time, controllerMessagesScratchBuffer);
+                    controllerStateIndex.createControllerUpdatesForTime (sourceSequence, (uint8_t) i, time, controllerMessagesScratchBuffer);
 
                 for (auto& m : controllerMessagesScratchBuffer)
                     destBuffer.addMidiMessage (m, midiSourceID);
@@ -686,6 +835,11 @@ public:
     //==============================================================================
     virtual void cacheSequence (double /*offset*/, std::optional<juce::Range<double>> /*clipRange*/) {}
 
+    /** Re-applies the groove if its strength has changed since the sequence was cached.
+        Returns true if the events may have moved, in which case setTime needs to be called.
+    */
+    virtual bool updateGrooveStrength()     { return false; }
+
     virtual void setTime (double) = 0;
     virtual bool advance() = 0;
 
@@ -698,8 +852,9 @@ public:
 struct EventGenerator   : public MidiGenerator
 {
     EventGenerator (const choc::midi::Sequence& seq,
-                    const std::vector<std::pair<size_t, size_t>>& noteOffs)
-        : sequence (seq), noteOffMap (noteOffs)
+                    const std::vector<std::pair<size_t, size_t>>& noteOffs,
+                    chocMidiHelpers::ControllerStateIndex& controllerIndex)
+        : sequence (seq), noteOffMap (noteOffs), controllerStateIndex (controllerIndex)
     {
     }
 
@@ -716,7 +871,7 @@ struct EventGenerator   : public MidiGenerator
         cleanedBufferToMerge.clear();
 
         MidiHelpers::createMessagesForTime (scratchBuffer,
-                                            sequence, noteOffMap,
+                                            sequence, noteOffMap, controllerStateIndex,
                                             time,
                                             channelNumbers,
                                             clipLevel,
@@ -802,47 +957,121 @@ struct EventGenerator   : public MidiGenerator
 
     const choc::midi::Sequence& sequence;
     const std::vector<std::pair<size_t, size_t>>& noteOffMap;
+    chocMidiHelpers::ControllerStateIndex& controllerStateIndex;
     size_t currentIndex = 0;
 };
 
 
 //==============================================================================
 //==============================================================================
-class CachingMidiEventGenerator : public MidiGenerator
+/** The looped sections of a clip's sequences and their note-off pairings.
+    These only depend on the MIDI content and loop range, so are never changed
+    once created and are shared between all the clips playing the same pattern.
+*/
+struct PreparedMidiSequences
 {
-public:
-    CachingMidiEventGenerator (std::vector<juce::MidiMessageSequence> seq,
-                               QuantisationType qt,
-                               const GrooveTemplate& grooveTemplate, float grooveStrength_)
-        : sequences (std::move (seq)),
-          quantisation (std::move (qt)),
-          groove (grooveTemplate),
-          grooveStrength (grooveStrength_)
+    PreparedMidiSequences (std::vector<juce::MidiMessageSequence> sourceSequences, ClipBeatRange loopRange)
+        : sequences (loopRange.isEmpty() ? std::move (sourceSequences)
+                                         : MidiHelpers::createLoopSection (std::move (sourceSequences), loopRange)),
+          hash (std::hash<std::vector<juce::MidiMessageSequence>>{} (sequences))
     {
-        // Cache the sequence at 0.0 time to reserve the required storage
-        cacheSequence (0.0, {});
-
-        // Reserve the scratch space for the note on/off map
-        size_t maxNumEvents = 0, maxNumNoteOns = 0;
-
+        // The note-off pairings don't depend on the offset so they can be found once
+        // up front and reused whenever the event order isn't changed when caching
         for (auto& sequence : sequences)
         {
-            size_t squenceNumEvents = 0, squenceNumNoteOns = 0;
+            choc::midi::Sequence seq;
+            MidiHelpers::addSequence (seq, sequence, 0.0);
 
-            for (auto meh : sequence)
-            {
-                ++squenceNumEvents;
+            auto& map = noteOffMaps.emplace_back();
+            MidiHelpers::createNoteOffMap (map, seq);
+
+            size_t squenceNumNoteOns = 0;
 
-                if (meh->message.isNoteOn())
+            for (auto& e : seq)
+                if (e.message.isNoteOn())
                     ++squenceNumNoteOns;
-            }
 
-            maxNumEvents = std::max (squenceNumEvents, maxNumEvents);
+            maxNumEvents = std::max (seq.events.size(), maxNumEvents);
             maxNumNoteOns = std::max (squenceNumNoteOns, maxNumNoteOns);
         }
+    }
+
+    const std::vector<juce::MidiMessageSequence> sequences;
+    std::vector<std::vector<std::pair<size_t, size_t>>> noteOffMaps;
+    size_t maxNumEvents = 0, maxNumNoteOns = 0;
+    const size_t hash;
+};
+
+/** Returns the PreparedMidiSequences for some sequences and loop range, reusing
+    the ones another Node is still holding if they have the same content.
+    Duplicated clips then only keep one copy of their pattern alive.
+*/
+static std::shared_ptr<const PreparedMidiSequences> getPreparedMidiSequences (std::vector<juce::MidiMessageSequence> sourceSequences,
+                                                                              ClipBeatRange loopRange)
+{
+    static std::mutex cacheMutex;
+    static std::unordered_map<size_t, std::weak_ptr<const PreparedMidiSequences>> cache;
+
+    auto key = std::hash<std::vector<juce::MidiMessageSequence>>{} (sourceSequences);
+    hash_combine (key, loopRange.getStart());
+    hash_combine (key, loopRange.getEnd());
+
+    {
+        const std::scoped_lock sl (cacheMutex);
+
+        if (auto found = cache.find (key); found != cache.end())
+            if (auto existing = found->second.lock())
+                return existing;
+    }
+
+    // Build these outside the lock so different patterns can be prepared in parallel
+    auto prepared = std::make_shared<const PreparedMidiSequences> (std::move (sourceSequences), loopRange);
+
+    const std::scoped_lock sl (cacheMutex);
+    auto& entry = cache[key];
+
+    // Another thread might have prepared the same pattern in the meantime
+    if (auto existing = entry.lock())
+        return existing;
+
+    entry = prepared;
+
+    // Clear out any entries for patterns that are no longer used
+    for (auto iter = cache.begin(); iter != cache.end();)
+    {
+        if (iter->second.expired())
+            iter = cache.erase (iter);
+        else
+            ++iter;
+    }
+
+    return prepared;
+}
+
+//==============================================================================
+//==============================================================================
+class CachingMidiEventGenerator : public MidiGenerator
+{
+public:
+    CachingMidiEventGenerator (std::shared_ptr<const PreparedMidiSequences> preparedSequences,
+                               QuantisationType qt,
+                               CompiledGrooveTemplate grooveTemplate, float grooveStrength_,
+                               std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>> liveGrooveStrength_)
+        : prepared (std::move (preparedSequences)),
+          sequences (prepared->sequences),
+          sequenceNoteOffMaps (prepared->noteOffMaps),
+          quantisation (std::move (qt)),
+          groove (std::move (grooveTemplate)),
+          liveGrooveStrength (std::move (liveGrooveStrength_)),
+          grooveStrength (getCurrentGrooveStrength (grooveStrength_))
+    {
+        // Reserve the scratch space for the sequence and note on/off map
+        noteOffMap.reserve (prepared->maxNumNoteOns);
+        currentSequence.events.reserve (prepared->maxNumEvents);
+        controllerStateIndex.reserve (prepared->maxNumEvents);
 
-        noteOffMap.reserve (maxNumNoteOns);
-        currentSequence.events.reserve (maxNumEvents);
+        // Cache the sequence at 0.0 time to reserve the required storage
+        cacheSequence (0.0, {});
     }
 
     void createMessagesForTime (MidiMessageArray& destBuffer,
@@ -877,43 +1106,28 @@ public:
 
     void cacheSequence (double offsetBeats, std::optional<juce::Range<double>> clipRange) override
     {
-        // Create a new sequence by:
-        // - Iterating the current sequence
-        // - Adding the offset timestamp to get Edit times
-        // - Applying the quantisation
-        // - Applying the groove
-        // - Sorting so events are in order
-        // - Setting the sequence to be iterated
-        // - Updating the offset used
-
         if (sequences.size() > 0)
             if (++currentSequenceIndex >= sequences.size())
                 currentSequenceIndex = 0;
 
-        // Create the cached sequence (without allocating)
-        currentSequence.events.clear();
-
-        if (currentSequenceIndex < sequences.size())
-            MidiHelpers::addSequence (currentSequence, sequences[currentSequenceIndex], offsetBeats);
-
-        jassert (std::is_sorted (currentSequence.begin(), currentSequence.end()));
-        MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
-        MidiHelpers::applyQuantisationToSequence (quantisation, false, currentSequence, noteOffMap);
-
-        if (! groove.isEmpty())
-            MidiHelpers::applyGrooveToSequence (groove, grooveStrength, currentSequence);
+        cacheCurrentSequence (offsetBeats, clipRange);
+    }
 
-        currentSequence.sortEvents();
+    bool updateGrooveStrength() override
+    {
+        if (groove.isEmpty() || ! groove.isParameterized())
+            return false;
 
-        if (clipRange)
-        {
-            MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
-            MidiHelpers::clipSequenceToRange (currentSequence, *clipRange, noteOffMap);
-        }
+        const auto newStrength = getCurrentGrooveStrength (grooveStrength);
 
-        MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
+        if (newStrength == grooveStrength)
+            return false;
 
-        cachedSequenceOffset = offsetBeats;
+        // The groove is applied when the sequence is cached so re-caching the same
+        // sequence moves the notes without anything being rebuilt
+        grooveStrength = newStrength;
+        cacheCurrentSequence (cachedSequenceOffset, cachedClipRange);
+        return true;
     }
 
     juce::MidiMessage getEvent() override
@@ -934,18 +1148,75 @@ public:
     }
 
 private:
-    std::vector<juce::MidiMessageSequence> sequences;
+    const std::shared_ptr<const PreparedMidiSequences> prepared;
+    const std::vector<juce::MidiMessageSequence>& sequences;
+    const std::vector<std::vector<std::pair<size_t, size_t>>>& sequenceNoteOffMaps;
 
     choc::midi::Sequence currentSequence;
     std::vector<std::pair<size_t, size_t>> noteOffMap;
-    EventGenerator generator { currentSequence, noteOffMap };
+    chocMidiHelpers::ControllerStateIndex controllerStateIndex;
+    EventGenerator generator { currentSequence, noteOffMap, controllerStateIndex };
 
     const QuantisationType quantisation;
-    const GrooveTemplate groove;
+    const CompiledGrooveTemplate groove;
+    const std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>> liveGrooveStrength;
     float grooveStrength = 0.0;
 
     size_t currentSequenceIndex = 0;
     double cachedSequenceOffset = 0.0;
+    std::optional<juce::Range<double>> cachedClipRange;
+
+    float getCurrentGrooveStrength (float fixedStrength) const
+    {
+        return liveGrooveStrength != nullptr ? static_cast<float> (liveGrooveStrength->get()) : fixedStrength;
+    }
+
+    void cacheCurrentSequence (double offsetBeats, std::optional<juce::Range<double>> clipRange)
+    {
+        // Create a new sequence by:
+        // - Iterating the current sequence
+        // - Adding the offset timestamp to get Edit times
+        // - Applying the quantisation
+        // - Applying the groove
+        // - Sorting so events are in order
+        // - Setting the sequence to be iterated
+        // - Updating the offset used
+
+        // Create the cached sequence (without allocating)
+        currentSequence.events.clear();
+
+        if (currentSequenceIndex < sequences.size())
+            MidiHelpers::addSequence (currentSequence, sequences[currentSequenceIndex], offsetBeats);
+
+        jassert (std::is_sorted (currentSequence.begin(), currentSequence.end()));
+
+        if (currentSequenceIndex < sequenceNoteOffMaps.size())
+            noteOffMap = sequenceNoteOffMaps[currentSequenceIndex];
+        else
+            noteOffMap.clear();
+
+        // Only re-sort and re-pair the notes if the events could have moved
+        if (quantisation.isEnabled() || ! groove.isEmpty())
+        {
+            MidiHelpers::applyQuantisationToSequence (quantisation, false, currentSequence, noteOffMap);
+
+            if (! groove.isEmpty())
+                MidiHelpers::applyGrooveToSequence (groove, grooveStrength, currentSequence);
+
+            currentSequence.sortEvents();
+            MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
+        }
+
+        if (clipRange)
+        {
+            MidiHelpers::clipSequenceToRange (currentSequence, *clipRange, noteOffMap);
+            MidiHelpers::createNoteOffMap (noteOffMap, currentSequence);
+        }
+
+        controllerStateIndex.invalidate();
+        cachedSequenceOffset = offsetBeats;
+        cachedClipRange = clipRange;
+    }
 };
 
 //==============================================================================
@@ -1018,6 +1289,11 @@ public:
         return e;
     }
 
+    bool updateGrooveStrength() override
+    {
+        return generator->updateGrooveStrength();
+    }
+
     bool advance() override
     {
         generator->advance();
@@ -1110,6 +1386,11 @@ public:
         generator->setTime (editBeatPosition + getOffset());
     }
 
+    bool updateGrooveStrength() override
+    {
+        return generator->updateGrooveStrength();
+    }
+
     juce::MidiMessage getEvent() override
     {
         auto e = generator->getEvent();
@@ -1156,12 +1437,19 @@ public:
           loopRange (loopRangeToUse),
           offset (offsetToUse),
           quantisation (quantisation_),
-          groove (groove_ != nullptr ? *groove_ : GrooveTemplate()),
+          groove (groove_ != nullptr ? CompiledGrooveTemplate (*groove_) : CompiledGrooveTemplate()),
           grooveStrength (grooveStrength_)
     {
         assert (sequences.size() > 0);
     }
 
+    void setLiveGrooveStrength (std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>> strength)
+    {
+        // This must be set before the generator is created
+        jassert (! isInitialised());
+        liveGrooveStrength = std::move (strength);
+    }
+
     void initialise (std::shared_ptr<ActiveNoteList> noteListToUse,
                      bool clipPropertiesHaveChanged, size_t lastSequencesHash,
                      std::shared_ptr<BeatDuration> dynamicOffsetBeatsToUse)
@@ -1178,16 +1466,16 @@ public:
         const EditBeatRange clipRangeRaw { editRange.getStart().inBeats(), editRange.getEnd().inBeats() };
         const ClipBeatRange loopRangeRaw { loopRange.getStart().inBeats(), loopRange.getEnd().inBeats() };
 
-        if (! loopRangeRaw.isEmpty())
-            sequences = MidiHelpers::createLoopSection (std::move (sequences), loopRangeRaw);
-
-        sequencesHash = std::hash<std::vector<juce::MidiMessageSequence>>{} (sequences);
+        auto preparedSequences = getPreparedMidiSequences (std::move (sequences), loopRangeRaw);
+        sequences.clear();
+        sequencesHash = preparedSequences->hash;
 
         if (sequencesHash != lastSequencesHash || clipPropertiesHaveChanged)
             shouldSendNoteOffsForNotesNoLongerPlaying = true;
 
-        auto cachingGenerator = std::make_unique<CachingMidiEventGenerator> (std::move (sequences),
-                                                                             std::move (quantisation), std::move (groove), grooveStrength);
+        auto cachingGenerator = std::make_unique<CachingMidiEventGenerator> (std::move (preparedSequences),
+                                                                             std::move (quantisation), groove, grooveStrength,
+                                                                             liveGrooveStrength);
         auto loopedGenerator = std::make_unique<LoopedMidiEventGenerator> (std::move (cachingGenerator),
                                                                            activeNoteList, clipRangeRaw, loopRangeRaw);
         generator = std::make_unique<OffsetMidiEventGenerator> (std::move (loopedGenerator),
@@ -1237,6 +1525,13 @@ public:
             return;
         }
 
+        // A change of groove strength moves the notes in the cached sequence, so any
+        // playing notes that have moved are stopped and playback carries on from here
+        const bool grooveStrengthChanged = generator->updateGrooveStrength();
+
+        if (grooveStrengthChanged)
+            shouldSendNoteOffsForNotesNoLongerPlaying = true;
+
         // This turns notes off that are no longer playing due to a change in the sequence
         // It is only called when the sequence changes
         if (shouldSendNoteOffsForNotesNoLongerPlaying)
@@ -1281,6 +1576,10 @@ public:
             // Ensure generator is initialised
             generator->setTime (clipIntersection.getStart().inBeats());
         }
+        else if (grooveStrengthChanged)
+        {
+            generator->setTime (clipIntersection.getStart().inBeats());
+        }
 
         // Iterate notes in blocks
         {
@@ -1377,8 +1676,9 @@ private:
     const BeatRange editRange, loopRange;
     const BeatDuration offset;
     QuantisationType quantisation;
-    GrooveTemplate groove;
+    CompiledGrooveTemplate groove;
     float grooveStrength = 0.0f;
+    std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>> liveGrooveStrength;
     bool initialised = false;
 
     bool shouldCreateMessagesForTime = false, shouldSendNoteOffsForNotesNoLongerPlaying = false;
@@ -1430,6 +1730,11 @@ const std::shared_ptr<ActiveNoteList>& LoopingMidiNode::getActiveNoteList() cons
     return generatorAndNoteList->getActiveNoteList();
 }
 
+void LoopingMidiNode::setLiveGrooveStrength (std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>> strength)
+{
+    generatorAndNoteList->setLiveGrooveStrength (std::move (strength));
+}
+
 //==============================================================================
 void LoopingMidiNode::setDynamicOffsetBeats (BeatDuration newOffset)
 {
@@ -1487,6 +1792,11 @@ bool LoopingMidiNode::isReadyToProcess()
     return true;
 }
 
+bool LoopingMidiNode::canProcessSplitTimelineRanges()
+{
+    return true;
+}
+
 void LoopingMidiNode::process (ProcessContext& pc)
 {
     SCOPED_REALTIME_CHECK
@@ -1510,16 +1820,19 @@ void LoopingMidiNode::process (ProcessContext& pc)
         return;
     }
 
-    generatorAndNoteList->processSection (pc.buffers.midi, pc.numSamples,
-                                          getEditBeatRange(),
-                                          getEditTimeRange(),
-                                          clipLevel,
-                                          channelNumbers,
-                                          useMPEChannelMode,
-                                          midiSourceID,
-                                          isPlaying,
-                                          getPlayHeadState().isContiguousWithPreviousBlock(),
-                                          getPlayHeadState().isLastBlockOfLoop());
+    forEachTimelineSection (pc, [this, isPlaying] (auto& sectionContext)
+    {
+        generatorAndNoteList->processSection (sectionContext.buffers.midi, sectionContext.numSamples,
+                                              getEditBeatRange(),
+                                              getEditTimeRange(),
+                                              clipLevel,
+                                              channelNumbers,
+                                              useMPEChannelMode,
+                                              midiSourceID,
+                                              isPlaying,
+                                              isContiguousWithPreviousBlock(),
+                                              isLastBlockOfLoop());
+    });
 }
 
 }} // namespace tracktion { inline namespace engine
@@ -52,6 +52,13 @@ public:
     */
     const std::shared_ptr<ActiveNoteList>& getActiveNoteList() const;
 
+    /** Makes the groove follow a strength that can change whilst playing, rather than
+        the fixed one it was created with. Changing this moves the notes as they're
+        generated so the sequences don't need to be rebuilt.
+        This must be called before the Node is prepared.
+    */
+    void setLiveGrooveStrength (std::shared_ptr<const juce::CachedValue<AtomicWrapper<float>>>);
+
     //==============================================================================
     /** Sets an offset to be applied to all times in this node, effectively shifting
         it forwards or backwards in time.
@@ -67,6 +74,7 @@ public:
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
+    bool canProcessSplitTimelineRanges() override;
     void process (ProcessContext&) override;
 
 private:
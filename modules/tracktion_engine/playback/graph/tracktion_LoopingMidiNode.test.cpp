@@ -47,6 +47,9 @@ public:
         runProgramChangeTests (true);
 
         runSequenceClippingTests();
+        runNoteOffMapTests();
+        runSharedSequenceTests();
+        runControllerStateIndexTests();
     }
 
 private:
@@ -321,6 +324,160 @@ private:
 
     }
 
+    void runNoteOffMapTests()
+    {
+        beginTest ("Note-off map");
+
+        choc::midi::Sequence seq;
+        seq.events.push_back ({ 0.0, choc::midi::ShortMessage (0x90, 60, 100) });
+        seq.events.push_back ({ 0.5, choc::midi::ShortMessage (0x90, 60, 100) });  // Overlapping note
+        seq.events.push_back ({ 0.5, choc::midi::ShortMessage (0x91, 60, 100) });  // Different channel
+        seq.events.push_back ({ 1.0, choc::midi::ShortMessage (0xb0, 60, 100) });  // Controller, not a note-off
+        seq.events.push_back ({ 1.0, choc::midi::ShortMessage (0x90, 62, 100) });  // No note-off
+        seq.events.push_back ({ 1.5, choc::midi::ShortMessage (0x90, 60, 0) });    // Zero velocity note-off
+        seq.events.push_back ({ 2.0, choc::midi::ShortMessage (0x81, 60, 0) });
+
+        std::vector<std::pair<size_t, size_t>> noteOffMap;
+        MidiHelpers::createNoteOffMap (noteOffMap, seq);
+
+        const std::vector<std::pair<size_t, size_t>> expected { { 0, 5 }, { 1, 5 }, { 2, 6 } };
+        expect (noteOffMap == expected);
+
+        expectEquals (MidiHelpers::getNoteOffIndex (2, noteOffMap).value_or (0), (size_t) 6);
+        expect (! MidiHelpers::getNoteOffIndex (4, noteOffMap));
+        expect (MidiHelpers::getNoteOff (1, seq, noteOffMap) == &seq.events[5]);
+    }
+
+    void runSharedSequenceTests()
+    {
+        beginTest ("Shared prepared sequences");
+
+        juce::MidiMessageSequence seq;
+        seq.addEvent (juce::MidiMessage::noteOn (1, 60, 0.8f), 0.0);
+        seq.addEvent (juce::MidiMessage::noteOff (1, 60), 1.0);
+        seq.addEvent (juce::MidiMessage::noteOn (1, 64, 0.8f), 2.0);
+        seq.addEvent (juce::MidiMessage::noteOff (1, 64), 3.0);
+        seq.updateMatchedPairs();
+
+        const ClipBeatRange loopRange { 0.0, 4.0 };
+        auto first = getPreparedMidiSequences ({ seq }, loopRange);
+        auto duplicate = getPreparedMidiSequences ({ seq }, loopRange);
+
+        expect (first == duplicate, "Sequences with the same content should be shared");
+        expectEquals (first->noteOffMaps.size(), (size_t) 1);
+        expectEquals (first->maxNumNoteOns, (size_t) 2);
+
+        auto differentLoop = getPreparedMidiSequences ({ seq }, { 0.0, 2.0 });
+        expect (differentLoop != first, "A different loop range should create new sequences");
+        expectEquals (differentLoop->maxNumNoteOns, (size_t) 1);
+
+        auto transposed = seq;
+        transposed.getEventPointer (0)->message.setNoteNumber (62);
+        expect (getPreparedMidiSequences ({ transposed }, loopRange) != first, "Different content should create new sequences");
+
+        // Once nothing is using them, they should be rebuilt
+        const auto firstHash = first->hash;
+        first.reset();
+        duplicate.reset();
+        auto rebuilt = getPreparedMidiSequences ({ seq }, loopRange);
+        expectEquals (rebuilt->hash, firstHash);
+    }
+
+    void runControllerStateIndexTests()
+    {
+        // Random controllers, bank and program changes, pitch wheels and parameter numbers on a few channels,
+        // with data entry messages only if asked for as they force a full replay
+        auto createSequence = [] (juce::Random& r, int numEvents, bool includeDataEntry)
+        {
+            choc::midi::Sequence seq;
+            double time = 0.0;
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                const auto channel = (uint8_t) r.nextInt (3);
+                const auto value = (uint8_t) r.nextInt (128);
+                constexpr uint8_t controllers[] { 0x00, 0x20, 0x01, 0x07, 0x0a, 0x40, 0x62, 0x63, 0x64, 0x65 };
+                constexpr uint8_t dataEntryControllers[] { 0x06, 0x26, 0x60, 0x61 };
+
+                // Some events share a time stamp
+                time += r.nextInt (3) * 0.125;
+
+                switch (r.nextInt (includeDataEntry ? 5 : 4))
+                {
+                    case 0:  seq.events.push_back ({ time, choc::midi::ShortMessage ((uint8_t) (0xc0 | channel), value, 0) }); break;
+                    case 1:  seq.events.push_back ({ time, choc::midi::ShortMessage ((uint8_t) (0xe0 | channel), value, (uint8_t) r.nextInt (128)) }); break;
+                    case 2:  seq.events.push_back ({ time, choc::midi::ShortMessage ((uint8_t) (0x90 | channel), value, 100) }); break;
+                    case 3:  seq.events.push_back ({ time, choc::midi::ShortMessage ((uint8_t) (0xb0 | channel), controllers[r.nextInt ((int) std::size (controllers))], value) }); break;
+                    default: seq.events.push_back ({ time, choc::midi::ShortMessage ((uint8_t) (0xb0 | channel), dataEntryControllers[r.nextInt ((int) std::size (dataEntryControllers))], value) }); break;
+                }
+            }
+
+            return seq;
+        };
+
+        // The index should always give the same messages as replaying the whole sequence
+        auto expectSameUpdatesAsFullReplay = [this] (const choc::midi::Sequence& seq, chocMidiHelpers::ControllerStateIndex& index)
+        {
+            const auto endTime = seq.events.empty() ? 0.0 : seq.events.back().timeStamp;
+            int numMismatches = 0;
+
+            for (double time = -0.5; time <= endTime + 0.5; time += 0.0625)
+            {
+                for (uint8_t channel = 1; channel <= 4; ++channel)
+                {
+                    juce::Array<juce::MidiMessage> expected, actual;
+                    chocMidiHelpers::createControllerUpdatesForTime (seq, channel, time, expected);
+                    index.createControllerUpdatesForTime (seq, channel, time, actual);
+
+                    bool matches = expected.size() == actual.size();
+
+                    for (int i = 0; matches && i < expected.size(); ++i)
+                        matches = expected[i].getRawDataSize() == actual[i].getRawDataSize()
+                                   && std::memcmp (expected[i].getRawData(), actual[i].getRawData(), (size_t) expected[i].getRawDataSize()) == 0
+                                   && expected[i].getTimeStamp() == actual[i].getTimeStamp();
+
+                    if (! matches)
+                        ++numMismatches;
+                }
+            }
+
+            expectEquals (numMismatches, 0);
+        };
+
+        beginTest ("Controller state index matches a full replay");
+        {
+            juce::Random r (42);
+
+            for (int numEvents : { 0, 10, 255, 256, 257, 2000 })
+            {
+                auto seq = createSequence (r, numEvents, false);
+                chocMidiHelpers::ControllerStateIndex index;
+                index.reserve (seq.events.size());
+                expectSameUpdatesAsFullReplay (seq, index);
+            }
+        }
+
+        beginTest ("Controller state index with data entry messages");
+        {
+            juce::Random r (43);
+            auto seq = createSequence (r, 2000, true);
+            chocMidiHelpers::ControllerStateIndex index;
+            expectSameUpdatesAsFullReplay (seq, index);
+        }
+
+        beginTest ("Controller state index is rebuilt after invalidation");
+        {
+            juce::Random r (44);
+            auto seq = createSequence (r, 1000, false);
+            chocMidiHelpers::ControllerStateIndex index;
+            expectSameUpdatesAsFullReplay (seq, index);
+
+            seq = createSequence (r, 1500, false);
+            index.invalidate();
+            expectSameUpdatesAsFullReplay (seq, index);
+        }
+    }
+
     void runSequenceClippingTest (std::vector<BytesAndTimeStamp> data, juce::Range<double> clipRange, size_t numEventsExpected)
     {
         choc::midi::Sequence seq;
@@ -0,0 +1,55 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+
+namespace tracktion { inline namespace engine
+{
+
+LoudnessMeasuringNode::LoudnessMeasuringNode (std::unique_ptr<tracktion::graph::Node> inputNode, LoudnessMeter& meter)
+    : input (std::move (inputNode)), loudnessMeter (meter)
+{
+    setOptimisations ({ tracktion::graph::ClearBuffers::no,
+                        tracktion::graph::AllocateAudioBuffer::no });
+}
+
+tracktion::graph::NodeProperties LoudnessMeasuringNode::getNodeProperties()
+{
+    auto props = input->getNodeProperties();
+
+    if (props.nodeID != 0)
+        hash_combine (props.nodeID, static_cast<size_t> (2029739460940294847)); // "LoudnessMeasuringNode"
+
+    return props;
+}
+
+void LoudnessMeasuringNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
+{
+    loudnessMeter.prepare (info.sampleRate, input->getNodeProperties().numberOfChannels);
+}
+
+void LoudnessMeasuringNode::process (tracktion::graph::Node::ProcessContext& pc)
+{
+    auto sourceBuffers = input->getProcessedOutput();
+    jassert (pc.buffers.audio.getSize() == sourceBuffers.audio.getSize());
+
+    // Just pass out input on to our output
+    setAudioOutput (input.get(), sourceBuffers.audio);
+
+    // If the source only outputs to this node, we can steal its data
+    if (input->numOutputNodes == 1)
+        pc.buffers.midi.swapWith (sourceBuffers.midi);
+    else
+        pc.buffers.midi.copyFrom (sourceBuffers.midi);
+
+    if (sourceBuffers.audio.getNumChannels() > 0)
+        loudnessMeter.process (sourceBuffers.audio);
+}
+
+}} // namespace tracktion { inline namespace engine
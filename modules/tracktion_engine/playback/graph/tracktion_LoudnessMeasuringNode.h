@@ -0,0 +1,37 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    A Node that passes its incoming audio and MIDI through unchanged whilst
+    measuring its loudness and true-peak level with a LoudnessMeter.
+
+    The meter is prepared for the input's format when the Node is.
+*/
+class LoudnessMeasuringNode final  : public tracktion::graph::Node
+{
+public:
+    LoudnessMeasuringNode (std::unique_ptr<tracktion::graph::Node> inputNode, LoudnessMeter&);
+
+    tracktion::graph::NodeProperties getNodeProperties() override;
+    std::vector<tracktion::graph::Node*> getDirectInputNodes() override  { return { input.get() }; }
+    bool isReadyToProcess() override                                    { return input->hasProcessed(); }
+    void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
+    void process (tracktion::graph::Node::ProcessContext&) override;
+
+private:
+    std::unique_ptr<tracktion::graph::Node> input;
+    LoudnessMeter& loudnessMeter;
+};
+
+}} // namespace tracktion { inline namespace engine
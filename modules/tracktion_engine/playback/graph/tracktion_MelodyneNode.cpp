@@ -101,16 +101,16 @@ MelodyneNode::MelodyneNode (AudioClipBase& c, tracktion::graph::PlayHead& ph, bo
       clipLevel (clip.getLiveClipLevel()), clipPtr (&c),
       melodyneProxy (c.melodyneProxy),
       fileInfo (clip.getAudioFile().getInfo()),
+      clipPosition (clip.getPosition()),
+      speedRatio (clip.getSpeedRatio()),
       isOfflineRender (isRendering)
 {
-    // Only need to check the analysing state when we're rendering
-    if (isOfflineRender)
-    {
-        updateAnalysingState();
+    // Analysis runs in the background so poll it until it's done. Renders wait
+    // for it and live playback falls back to the source file in the meantime
+    updateAnalysingState();
 
-        if (analysingContent)
-            startTimerHz (10);
-    }
+    if (analysingContent)
+        startTimerHz (10);
 }
 
 MelodyneNode::~MelodyneNode()
@@ -166,6 +166,14 @@ void MelodyneNode::prepareToPlay (const tracktion::graph::PlaybackInitialisation
             desc = p->getPluginDescription();
         }
     }
+
+    sampleRate = info.sampleRate;
+
+    // The source can only stand in for the plugin's output if it doesn't need resampling or stretching
+    if (! isOfflineRender && analysingContent
+         && juce::approximatelyEqual (fileInfo.sampleRate, info.sampleRate)
+         && juce::approximatelyEqual (speedRatio, 1.0))
+        sourceReader = clip.edit.engine.getAudioFileManager().cache.createReader (clip.getAudioFile());
 }
 
 bool MelodyneNode::isReadyToProcess()
@@ -184,6 +192,16 @@ void MelodyneNode::process (ProcessContext& pc)
     if (dest.getNumFrames() == 0 || dest.getNumChannels() == 0 || melodyneProxy == nullptr)
         return;
 
+    if (! isOfflineRender && analysingContent.load (std::memory_order_relaxed))
+    {
+        auto asb = tracktion::graph::toAudioBuffer (dest);
+
+        if (readSourceAudio (pc, asb))
+            applyClipLevel (asb);
+
+        return;
+    }
+
     if (auto plugin = melodyneProxy->getPlugin())
     {
         if (auto pluginInstance = plugin->getAudioPluginInstance())
@@ -205,28 +223,58 @@ void MelodyneNode::process (ProcessContext& pc)
 
             auto asb = tracktion::graph::toAudioBuffer (dest);
             pluginInstance->processBlock (asb, midiMessages);
+            applyClipLevel (asb);
+        }
+    }
+}
+
+//==============================================================================
+bool MelodyneNode::readSourceAudio (const ProcessContext& pc, juce::AudioBuffer<float>& dest)
+{
+    if (sourceReader == nullptr || ! playHead.isPlaying())
+        return false;
 
-            float gains[2];
+    const auto timelineStart = referenceSampleRangeToSplitTimelineRange (playHead, pc.referenceSampleRange).timelineRange1.getStart();
+    const auto blockRange = juce::Range<int64_t>::withStartAndLength (timelineStart, (int64_t) dest.getNumSamples());
+    const auto clipRange = toSamples (clipPosition.time, sampleRate);
+    const auto rangeToRead = blockRange.getIntersectionWith (clipRange);
 
-            if (asb.getNumChannels() > 1)
-                clipLevel.getLeftAndRightGains (gains[0], gains[1]);
-            else
-                gains[0] = gains[1] = clipLevel.getGainIncludingMute();
+    if (rangeToRead.isEmpty())
+        return false;
 
-            if (playHead.isUserDragging())
-            {
-                gains[0] *= 0.4f;
-                gains[1] *= 0.4f;
-            }
+    sourceReader->setReadPosition (rangeToRead.getStart() - clipRange.getStart() + toSamples (clipPosition.offset, sampleRate));
 
-            for (int i = 0; i < asb.getNumChannels(); ++i)
-            {
-                const float gain = gains[i & 1];
+    // Don't block the audio thread, any samples that aren't cached yet are left silent
+    sourceReader->readSamples ((int) rangeToRead.getLength(), dest,
+                               juce::AudioChannelSet::canonicalChannelSet (dest.getNumChannels()),
+                               (int) (rangeToRead.getStart() - timelineStart),
+                               juce::AudioChannelSet::canonicalChannelSet (fileInfo.numChannels),
+                               0);
 
-                if (gain != 1.0f)
-                    asb.applyGain (i, 0, asb.getNumSamples(), gain);
-            }
-        }
+    return true;
+}
+
+void MelodyneNode::applyClipLevel (juce::AudioBuffer<float>& buffer)
+{
+    float gains[2];
+
+    if (buffer.getNumChannels() > 1)
+        clipLevel.getLeftAndRightGains (gains[0], gains[1]);
+    else
+        gains[0] = gains[1] = clipLevel.getGainIncludingMute();
+
+    if (playHead.isUserDragging())
+    {
+        gains[0] *= 0.4f;
+        gains[1] *= 0.4f;
+    }
+
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+    {
+        const float gain = gains[i & 1];
+
+        if (gain != 1.0f)
+            buffer.applyGain (i, 0, buffer.getNumSamples(), gain);
     }
 }
 
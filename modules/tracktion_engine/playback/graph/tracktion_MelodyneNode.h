@@ -15,6 +15,10 @@ namespace tracktion { inline namespace engine
 //==============================================================================
 /**
     Plays back a Melodyne plugin.
+
+    Whilst the plugin is still analysing the clip's source, live playback
+    doesn't wait for it but plays the unprocessed source file instead. Offline
+    renders report they aren't ready to process until the analysis is done.
 */
 class MelodyneNode final  : public tracktion::graph::Node,
                             private juce::Timer
@@ -43,10 +47,16 @@ private:
     juce::MidiBuffer midiMessages;
     juce::PluginDescription desc;
     std::unique_ptr<MelodynePlayhead> playhead;
+    const ClipPosition clipPosition;
+    const double speedRatio;
+    AudioFileCache::Reader::Ptr sourceReader;
+    double sampleRate = 44100.0;
     bool isOfflineRender = false;
     std::atomic<bool> analysingContent { true };
 
     //==============================================================================
+    bool readSourceAudio (const ProcessContext&, juce::AudioBuffer<float>&);
+    void applyClipLevel (juce::AudioBuffer<float>&);
     void updateAnalysingState();
     void timerCallback() override;
 };
@@ -37,6 +37,7 @@ tracktion::graph::NodeProperties MidiInputDeviceNode::getNodeProperties()
 void MidiInputDeviceNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
 {
     sampleRate = info.sampleRate;
+    latencyNumSamples = info.blockSize;
     maxExpectedMsPerBuffer = (unsigned int) (((info.blockSize * 1000) / info.sampleRate) * 2 + 100);
     assert (getNodeProperties().nodeID == nodeID);
 
@@ -87,18 +88,13 @@ void MidiInputDeviceNode::handleIncomingMidiMessage (const juce::MidiMessage& me
     auto channelToUse = midiInputDevice.getChannelToUse().getChannelNumber();
 
     {
-        const std::lock_guard sl (state->incomingMessagesMutex);
+        MidiMessageWithSource m (message, sourceID);
 
-        if (state->numIncomingMessages < state->incomingMessages.size())
-        {
-            auto& m = *state->incomingMessages[state->numIncomingMessages];
-            m = { message, sourceID };
-
-            if (channelToUse > 0)
-                m.setChannel (channelToUse);
+        if (channelToUse > 0)
+            m.setChannel (channelToUse);
 
-            ++(state->numIncomingMessages);
-        }
+        if (! state->incomingMessages.try_push (std::move (m)))
+            midiInputDevice.incrementNumDroppedMessages();
     }
 
     auto& playHead = playHeadState.playHead;
@@ -142,36 +138,54 @@ void MidiInputDeviceNode::processSection (ProcessContext& pc, juce::Range<int64_
         createProgramChanges (destMidi);
 
     {
-        const std::lock_guard sl (state->incomingMessagesMutex);
+        auto& pending = state->pendingMessages;
+        MidiMessageWithSource incoming (juce::MidiMessage(), {});
 
         // if it's been a long time since the last block, clear the buffer because
         // it means we were muted or glitching
-        if (timeNow > state->lastReadTime + maxExpectedMsPerBuffer)
+        const bool discardMessages = timeNow > state->lastReadTime + maxExpectedMsPerBuffer;
+        state->lastReadTime = timeNow;
+
+        if (discardMessages)
+            pending.clear();
+
+        while (state->incomingMessages.try_pop (incoming))
         {
-            //jassertfalse;
-            state->numIncomingMessages = 0;
-        }
+            if (discardMessages)
+                continue;
 
-        state->lastReadTime = timeNow;
+            if (pending.size() < pending.capacity())
+                pending.push_back (std::move (incoming));
+            else
+                midiInputDevice.incrementNumDroppedMessages();
+        }
 
-        jassert (state->numIncomingMessages <= state->incomingMessages.size());
+        // The timestamps are in the same stream time as the reference samples so delaying
+        // them by a block puts each one at a fixed latency from when it arrived.
+        // Any that land past the end of this block are kept for the next one
+        const auto blockStart = pc.referenceSampleRange.getStart();
+        const auto numFrames = pc.referenceSampleRange.getLength();
+        size_t numKept = 0;
 
-        if (auto num = juce::jmin ((size_t) state->numIncomingMessages, state->incomingMessages.size()))
+        for (size_t i = 0; i < pending.size(); ++i)
         {
-            // not quite right as the first event won't be at the start of the buffer, but near enough for live stuff
-            const auto timeAdjust = state->incomingMessages.front()->getTimeStamp();
+            auto& m = pending[i];
+            const auto position = tracktion::graph::timeToSample (m.getTimeStamp(), sampleRate) + latencyNumSamples - blockStart;
 
-            for (size_t i = 0; i < num; ++i)
+            if (position >= numFrames && position < numFrames + latencyNumSamples)
             {
-                auto& m = *state->incomingMessages[i];
+                if (i != numKept)
+                    pending[numKept] = std::move (m);
 
-                destMidi.addMidiMessage (m,
-                                         juce::jlimit (0.0, juce::jmax (0.0, editTime.getLength()), m.getTimeStamp() - timeAdjust),
-                                         m.mpeSourceID);
+                ++numKept;
+                continue;
             }
+
+            const auto frame = std::clamp (position, (int64_t) 0, std::max ((int64_t) 0, numFrames - 1));
+            destMidi.addMidiMessage (m, tracktion::graph::sampleToTime (frame, sampleRate), m.mpeSourceID);
         }
 
-        state->numIncomingMessages = 0;
+        pending.erase (pending.begin() + (std::ptrdiff_t) numKept, pending.end());
     }
 
     const std::lock_guard sl (state->liveMessagesMutex);
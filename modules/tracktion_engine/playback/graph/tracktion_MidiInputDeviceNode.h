@@ -13,6 +13,11 @@ namespace tracktion { inline namespace engine
 
 /**
     A Node that intercepts incoming live MIDI and inserts it in to the playback graph.
+
+    Incoming messages are passed to the audio thread through a lock-free queue and
+    placed in the block using their timestamps, which come from the MIDI driver
+    where it provides them. Every message is delayed by one device block so they
+    keep their relative timing rather than being bunched at the start of a block.
 */
 class MidiInputDeviceNode final : public tracktion::graph::Node,
                                   public InputDeviceInstance::Consumer
@@ -43,6 +48,7 @@ private:
 
     unsigned int maxExpectedMsPerBuffer = 0;
     double sampleRate = 44100.0;
+    int64_t latencyNumSamples = 0;
 
     LambdaTimer loopOverdubsChecker { [this] { updateLoopOverdubs(); } };
 
@@ -50,15 +56,14 @@ private:
     {
         NodeState()
         {
-            for (int i = 256; --i >= 0;)
-                incomingMessages.push_back (std::make_unique<MidiMessageWithSource> (juce::MidiMessage (0x80, 0, 0), MPESourceID()));
+            pendingMessages.reserve (maxNumMessages);
         }
 
+        static constexpr size_t maxNumMessages = 256;
         std::atomic<MidiInputDeviceNode*> activeNode { nullptr };
 
-        std::mutex incomingMessagesMutex;
-        std::vector<std::unique_ptr<MidiMessageWithSource>> incomingMessages;
-        uint32_t numIncomingMessages = 0;
+        rigtorp::MPMCQueue<MidiMessageWithSource> incomingMessages { maxNumMessages };
+        std::vector<MidiMessageWithSource> pendingMessages; // Only accessed on the audio thread
 
         std::mutex liveMessagesMutex;
         MidiMessageArray liveRecordedMessages;
@@ -38,9 +38,26 @@ MidiNode::MidiNode (std::vector<juce::MidiMessageSequence> sequences,
     // -1 from the channel numbers end here as Range end is exclusive
     jassert (channelNumbers.getStart() > 0 && (channelNumbers.getEnd() - 1) <= 16);
 
+    // The events are played back from packed copies of the sequences, which are
+    // contiguous and can be read without touching the heap on the audio thread
+    packedSequences.reserve (ms.size());
+
     for (auto& s : ms)
+    {
         s.updateMatchedPairs();
 
+        size_t numSysexBytes = 0;
+
+        for (auto meh : s)
+            if ((size_t) meh->message.getRawDataSize() > PackedMidiBuffer::maxInlineSize)
+                numSysexBytes += (size_t) meh->message.getRawDataSize();
+
+        auto& packed = packedSequences.emplace_back ((size_t) s.getNumEvents(), numSysexBytes);
+
+        for (auto meh : s)
+            packed.add (meh->message, 0);
+    }
+
     controllerMessagesScratchBuffer.ensureStorageAllocated (32);
 }
 
@@ -95,7 +112,7 @@ void MidiNode::process (ProcessContext& pc)
 
         processSection (pc,
                         { sectionEditTime.getStart().inBeats(), sectionEditTime.getEnd().inBeats() },
-                        secondsPerBeat, ms[currentSequence]);
+                        secondsPerBeat, ms[currentSequence], packedSequences[currentSequence]);
     }
     else
     {
@@ -108,14 +125,15 @@ void MidiNode::process (ProcessContext& pc)
 
         processSection (pc,
                         { sectionEditTime.getStart().inSeconds(), sectionEditTime.getEnd().inSeconds() },
-                        1.0, ms[currentSequence]);
+                        1.0, ms[currentSequence], packedSequences[currentSequence]);
     }
 }
 
 void MidiNode::processSection (Node::ProcessContext& pc,
                                juce::Range<double> sectionEditRange,
                                double secondsPerTimeBase,
-                               juce::MidiMessageSequence& sequence)
+                               juce::MidiMessageSequence& sequence,
+                               const PackedMidiBuffer& events)
 {
     if (sectionEditRange.isEmpty()
         || sectionEditRange.getEnd() <= editRange.getStart()
@@ -144,20 +162,20 @@ void MidiNode::processSection (Node::ProcessContext& pc,
         shouldCreateMessagesForTime = false;
     }
 
-    auto numEvents = sequence.getNumEvents();
+    const auto numEvents = (int) events.size();
 
     if (numEvents != 0)
     {
         currentIndex = juce::jlimit (0, numEvents - 1, currentIndex);
 
-        if (sequence.getEventTime (currentIndex) >= localTime.getStart())
+        if (events[(size_t) currentIndex].timeStamp >= localTime.getStart())
         {
-            while (currentIndex > 0 && sequence.getEventTime (currentIndex - 1) >= localTime.getStart())
+            while (currentIndex > 0 && events[(size_t) currentIndex - 1].timeStamp >= localTime.getStart())
                 --currentIndex;
         }
         else
         {
-            while (currentIndex < numEvents && sequence.getEventTime (currentIndex) < localTime.getStart())
+            while (currentIndex < numEvents && events[(size_t) currentIndex].timeStamp < localTime.getStart())
                 ++currentIndex;
         }
     }
@@ -166,31 +184,25 @@ void MidiNode::processSection (Node::ProcessContext& pc,
     const auto lastBlockOfLoop = getPlayHeadState().isLastBlockOfLoop();
     const double durationOfOneSample = sectionEditRange.getLength() / pc.numSamples;
 
-    for (;;)
+    while (currentIndex < numEvents)
     {
-        if (auto meh = sequence.getEventPointer (currentIndex++))
-        {
-            auto eventTime = meh->message.getTimeStamp();
+        auto& e = events[(size_t) currentIndex++];
+        auto eventTime = e.timeStamp;
 
-            // This correction here is to avoid rounding errors converting to and from sample position and times
-            const auto timeCorrection = lastBlockOfLoop ? (meh->message.isNoteOff() ? 0.0 : durationOfOneSample) : 0.0;
+        // This correction here is to avoid rounding errors converting to and from sample position and times
+        const auto timeCorrection = lastBlockOfLoop ? (events.isNoteOff (e) ? 0.0 : durationOfOneSample) : 0.0;
 
-            if (eventTime >= (localTime.getEnd() - timeCorrection))
-                break;
+        if (eventTime >= (localTime.getEnd() - timeCorrection))
+            break;
 
-            eventTime -= localTime.getStart();
+        eventTime -= localTime.getStart();
 
-            if (eventTime >= 0.0)
-            {
-                juce::MidiMessage m (meh->message);
-                m.multiplyVelocity (volScale);
-                const auto eventTimeSeconds = eventTime * secondsPerTimeBase;
-                pc.buffers.midi.addMidiMessage (m, eventTimeSeconds, midiSourceID);
-            }
-        }
-        else
+        if (eventTime >= 0.0)
         {
-            break;
+            auto m = events.toMidiMessage (e);
+            m.multiplyVelocity (volScale);
+            const auto eventTimeSeconds = eventTime * secondsPerTimeBase;
+            pc.buffers.midi.addMidiMessage (m, eventTimeSeconds, midiSourceID);
         }
     }
 
@@ -28,6 +28,9 @@ public:
               EditItemID,
               std::function<bool()> shouldBeMutedDelegate = nullptr);
 
+    /** Returns the EditItemID to identify this Node. */
+    EditItemID getItemID() const                            { return editItemID; }
+
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
@@ -36,6 +39,7 @@ public:
 private:
     //==============================================================================
     std::vector<juce::MidiMessageSequence> ms;
+    std::vector<PackedMidiBuffer> packedSequences;
     const MidiList::TimeBase timeBase;
     int64_t lastStart = 0;
     size_t currentSequence = 0;
@@ -57,7 +61,8 @@ private:
     void processSection (Node::ProcessContext&,
                          juce::Range<double> sectionEditTime,
                          double secondsPerTimeBase,
-                         juce::MidiMessageSequence&);
+                         juce::MidiMessageSequence&,
+                         const PackedMidiBuffer&);
 };
 
 }} // namespace tracktion { inline namespace engine
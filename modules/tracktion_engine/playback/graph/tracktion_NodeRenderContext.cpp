@@ -32,6 +32,101 @@ namespace
         plugins.addArray (insideRacks);
         return plugins;
     }
+
+    static bool canUseOfflineBlockSize (tracktion::graph::Node& node)
+    {
+        // Modifiers are only updated once per block so would lose resolution with larger blocks
+        for (auto n : getNodes (node, VertexOrdering::preordering))
+            if (dynamic_cast<ModifierNode*> (n) != nullptr)
+                return false;
+
+        for (auto plugin : findAllPlugins (node))
+        {
+            if (auto rack = dynamic_cast<RackInstance*> (plugin))
+                if (auto type = rack->type)
+                    if (! type->getModifierList().getModifiers().isEmpty())
+                        return false;
+
+            // Automated plugins are processed in sub-blocks unless fine-grain automation has been disabled for them
+            auto& pluginManager = plugin->engine.getPluginManager();
+
+            if (plugin->isAutomationNeeded()
+                 && pluginManager.canUseFineGrainAutomation
+                 && ! pluginManager.canUseFineGrainAutomation (*plugin))
+                return false;
+        }
+
+        return true;
+    }
+
+    /** Collects written data in to chunks and passes them to a StreamingOutput's callback. */
+    struct ChunkedOutputStream  : public juce::OutputStream
+    {
+        ChunkedOutputStream (const Renderer::StreamingOutput& o)
+            : onChunk (o.onChunk), chunkSize (std::max ((size_t) 1, o.chunkSize))
+        {
+            pending.ensureSize (chunkSize);
+        }
+
+        ~ChunkedOutputStream() override
+        {
+            if (onChunk)
+                onChunk (pending.getData(), pending.getDataSize(), true);
+        }
+
+        void flush() override
+        {
+            if (pending.getDataSize() > 0 && onChunk)
+                onChunk (pending.getData(), pending.getDataSize(), false);
+
+            pending.reset();
+        }
+
+        juce::int64 getPosition() override                      { return position; }
+
+        // The data has already been passed on so can't be rewritten
+        bool setPosition (juce::int64 newPosition) override     { return newPosition == position; }
+
+        bool write (const void* data, size_t numBytes) override
+        {
+            pending.write (data, numBytes);
+            position += (juce::int64) numBytes;
+
+            if (pending.getDataSize() >= chunkSize)
+                flush();
+
+            return true;
+        }
+
+        const std::function<void (const void*, size_t, bool)> onChunk;
+        const size_t chunkSize;
+        juce::MemoryOutputStream pending;
+        juce::int64 position = 0;
+    };
+
+    /** Writes interleaved 32-bit float PCM with no header. */
+    struct RawFloatWriter  : public juce::AudioFormatWriter
+    {
+        RawFloatWriter (juce::OutputStream* out, double sampleRate, unsigned int numChannels)
+            : juce::AudioFormatWriter (out, "Raw PCM", sampleRate, numChannels, 32)
+        {
+            usesFloatingPointData = true;
+        }
+
+        bool write (const int** data, int numSamples) override
+        {
+            interleaved.resize ((size_t) numSamples * numChannels);
+
+            for (int c = 0; c < (int) numChannels; ++c)
+                if (auto src = reinterpret_cast<const float*> (data[c]))
+                    for (int i = 0; i < numSamples; ++i)
+                        interleaved[(size_t) i * numChannels + (size_t) c] = src[i];
+
+            return output->write (interleaved.data(), interleaved.size() * sizeof (float));
+        }
+
+        std::vector<float> interleaved;
+    };
 }
 
 
@@ -48,7 +143,6 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
       playHeadState (std::move (playHeadState_)),
       processState (std::move (processState_)),
       status (juce::Result::ok()),
-      ditherers (256, r.bitDepth),
       sourceToUpdate (sourceToUpdate_)
 {
     CRASH_TRACER
@@ -57,8 +151,23 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
     jassert (r.edit != nullptr);
     jassert (r.time.getLength() > 0.0s);
 
+    const bool useOfflineBlockSize = r.offlineBlockSize > r.blockSizeForAudio
+                                      && ! r.realTimeRender
+                                      && n != nullptr
+                                      && canUseOfflineBlockSize (*n);
+
+    if (useOfflineBlockSize)
+        r.blockSizeForAudio = r.offlineBlockSize;
+
+    // Measure the loudness as the graph is rendered so normalising doesn't need another pass to find it
+    if (r.shouldNormaliseByLoudness && n != nullptr)
+    {
+        loudnessMeter = std::make_unique<LoudnessMeter>();
+        n = std::make_unique<LoudnessMeasuringNode> (std::move (n), *loudnessMeter);
+    }
+
     nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (n), *processState, r.sampleRateForAudio, r.blockSizeForAudio,
-                                                        getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy())));
+                                                        getThreadPoolCreator (*p.engine, p.edit));
     nodePlayer->setNumThreads ((size_t) p.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
 
     numLatencySamplesToDrop = nodePlayer->getNode()->getNodeProperties().latencyNumSamples;
@@ -70,18 +179,14 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
         TRACKTION_LOG_ERROR("Rendering whilst attached to audio device");
     }
 
-    if (r.shouldNormalise || r.trimSilenceAtEnds || r.shouldNormaliseByRMS)
+    if (r.shouldNormalise || r.trimSilenceAtEnds || r.shouldNormaliseByRMS || r.shouldNormaliseByLoudness)
     {
         needsToNormaliseAndTrim = true;
 
-        r.audioFormat = r.engine->getAudioFileFormatManager().getFrozenFileFormat();
-
-        intermediateFile = std::make_unique<juce::TemporaryFile> (r.destFile.withFileExtension (r.audioFormat->getFileExtensions()[0]));
-        r.destFile = intermediateFile->getFile();
-
         r.shouldNormalise = false;
         r.trimSilenceAtEnds = false;
         r.shouldNormaliseByRMS = false;
+        r.shouldNormaliseByLoudness = false;
     }
 
     numOutputChans = 2;
@@ -101,17 +206,52 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
 
     AudioFileUtils::addBWAVStartToMetadata (r.metadata, toSamples (r.time.getStart(), r.sampleRateForAudio));
 
-    writer = std::make_unique<AudioFileWriter> (AudioFile (*originalParams.engine, r.destFile),
-                                                r.audioFormat, numOutputChans, r.sampleRateForAudio,
-                                                r.bitDepth, r.metadata, r.quality);
+    if (needsToNormaliseAndTrim)
+    {
+        // The float output is kept so the gain, dither and format conversion can all
+        // be applied in a single pass when the final file is written
+        intermediateAudio = std::make_unique<IntermediateAudio> (r.destFile, numOutputChans,
+                                                                 toSamples (r.time.getLength() + r.endAllowance, r.sampleRateForAudio));
+        r.destFile = intermediateAudio->tempFile.getFile();
+    }
+    else if (r.destFile != juce::File())
+    {
+        // Each file is encoded on its own thread so processing, encoding and disk I/O all overlap
+        // and a render to several formats only needs a single pass of the Edit
+        bool opened = openOutputWriter (r.destFile, r.audioFormat, r.bitDepth, r.quality, r.ditheringEnabled);
+
+        for (auto& output : r.additionalOutputs)
+            opened = opened && openOutputWriter (output.destFile, output.audioFormat, output.bitDepth,
+                                                 output.quality, output.ditheringEnabled);
 
-    if (r.destFile != juce::File() && ! writer->isOpen())
+        if (! opened)
+        {
+            status = juce::Result::fail (TRANS("Couldn't write to target file"));
+            return;
+        }
+    }
+
+    if (! needsToNormaliseAndTrim)
+    {
+        for (auto& output : r.streamingOutputs)
+        {
+            if (! openStreamingWriter (output))
+            {
+                status = juce::Result::fail (TRANS("Couldn't create the streaming output"));
+                return;
+            }
+        }
+    }
+
+    if (r.destFile != juce::File() && ! isWriterOpen())
     {
         status = juce::Result::fail (TRANS("Couldn't write to target file"));
         return;
     }
 
     blockLength = TimeDuration::fromSamples (r.blockSizeForAudio, r.sampleRateForAudio);
+    renderingBuffer.setSize (numOutputChans, r.blockSizeForAudio + 256);
+    ditherBuffer.setSize (numOutputChans, r.blockSizeForAudio + 256);
 
     // number of blank blocks to play before starting, to give plugins time to warm up
     numPreRenderBlocks = (int) ((r.sampleRateForAudio / 2) / r.blockSizeForAudio + 1);
@@ -157,18 +297,26 @@ NodeRenderContext::~NodeRenderContext()
     r.resultRMS = owner.params.resultRMS = rmsNumSamps > 0 ? (float) (rmsTotal / rmsNumSamps) : 0.0f;
     r.resultAudioDuration = owner.params.resultAudioDuration = float (numSamplesWrittenToSource / owner.params.sampleRateForAudio);
 
+    if (loudnessMeter)
+    {
+        r.resultIntegratedLoudness = owner.params.resultIntegratedLoudness = loudnessMeter->getIntegratedLoudness();
+        r.resultTruePeakDb = owner.params.resultTruePeakDb = loudnessMeter->getTruePeakDb();
+    }
+
     playHead->stop();
     Renderer::RenderTask::setAllPluginsRealtime (plugins, true);
 
-    if (writer != nullptr)
-        writer->closeForWriting();
+    closeWriter();
 
     try
     {
         callBlocking ([this] { nodePlayer.reset(); });
 
-        if (needsToNormaliseAndTrim)
-            owner.performNormalisingAndTrimming (originalParams, r);
+        if (needsToNormaliseAndTrim && intermediateAudio != nullptr && ! owner.shouldExit())
+        {
+            auto audio = intermediateAudio->getAudio();
+            owner.performNormalisingAndTrimming (originalParams, r, audio);
+        }
     }
     catch (std::runtime_error& err)
     {
@@ -189,9 +337,13 @@ bool NodeRenderContext::renderNextBlock (std::atomic<float>& progressToUpdate)
 
     if (owner.shouldExit())
     {
-        writer->closeForWriting();
+        closeWriter();
+        intermediateAudio.reset();
         r.destFile.deleteFile();
 
+        for (auto& output : r.additionalOutputs)
+            output.destFile.deleteFile();
+
         playHead->stop();
         Renderer::RenderTask::setAllPluginsRealtime (plugins, true);
 
@@ -210,6 +362,10 @@ bool NodeRenderContext::renderNextBlock (std::atomic<float>& progressToUpdate)
 
     if (precount == 0)
     {
+        // Only measure the loudness of what's written, not the pre-roll
+        if (loudnessMeter)
+            loudnessMeter->reset();
+
         streamTime = r.time.getStart();
         blockEnd = streamTime + blockLength;
 
@@ -255,7 +411,6 @@ bool NodeRenderContext::renderNextBlock (std::atomic<float>& progressToUpdate)
     while (! (leafNodesReady || owner.shouldExit()))
         return false;
 
-    juce::AudioBuffer<float> renderingBuffer (numOutputChans, r.blockSizeForAudio + 256);
     renderingBuffer.clear();
     midiBuffer.clear();
 
@@ -333,10 +488,9 @@ NodeRenderContext::WriteResult NodeRenderContext::writeAudioBlock (choc::buffer:
 
     juce::AudioBuffer<float> buffer (block.data.channels, numOutputChans, blockSizeSamples);
 
-    // Apply dithering and mag/rms analysis
-    if (r.ditheringEnabled && r.bitDepth < 32)
-        ditherers.apply (buffer, blockSizeSamples);
-
+    // Mag/rms analysis
+    // Dithering is applied per output as each may have a different bit depth, and if the
+    // audio is going to be normalised, it's dithered after the gain has been applied
     auto mag = buffer.getMagnitude (0, blockSizeSamples);
     peak = juce::jmax (peak, mag);
 
@@ -358,16 +512,193 @@ NodeRenderContext::WriteResult NodeRenderContext::writeAudioBlock (choc::buffer:
 
     numSamplesWrittenToSource += blockSizeSamples;
 
-    // And finally write to the file
+    // And finally write to the file(s)
     // NB buffer gets trashed by this call
     if (blockSizeSamples > 0 && hasStartedSavingToFile
-         && writer->isOpen()
-         && ! writer->appendBuffer (buffer, blockSizeSamples))
+         && isWriterOpen()
+         && ! appendToWriter (buffer, blockSizeSamples))
         return WriteResult::failed;
 
     return WriteResult::succeeded;
 }
 
+bool NodeRenderContext::openOutputWriter (const juce::File& file, juce::AudioFormat* format,
+                                          int bitDepth, int quality, bool ditheringEnabled)
+{
+    if (format == nullptr)
+        return false;
+
+    r.engine->getAudioFileManager().releaseFile (AudioFile (*r.engine, file));
+
+    if (! file.getParentDirectory().createDirectory())
+        return false;
+
+    auto afw = AudioFileUtils::createWriterFor (format, file, r.sampleRateForAudio,
+                                                (unsigned int) numOutputChans, bitDepth,
+                                                r.metadata, quality, AudioFileWriteOptions::forRendering());
+
+    if (afw == nullptr)
+        return false;
+
+    addOutputWriter (afw, file, bitDepth, ditheringEnabled);
+    return true;
+}
+
+bool NodeRenderContext::openStreamingWriter (const Renderer::StreamingOutput& streamingOutput)
+{
+    if (! streamingOutput.onChunk)
+        return false;
+
+    auto out = std::make_unique<ChunkedOutputStream> (streamingOutput);
+    juce::AudioFormatWriter* afw = nullptr;
+
+    if (streamingOutput.audioFormat == nullptr)
+        afw = new RawFloatWriter (out.release(), r.sampleRateForAudio, (unsigned int) numOutputChans);
+    else
+        afw = AudioFileUtils::createWriterFor (streamingOutput.audioFormat, std::move (out), r.sampleRateForAudio,
+                                               (unsigned int) numOutputChans, streamingOutput.bitDepth,
+                                               r.metadata, streamingOutput.quality);
+
+    if (afw == nullptr)
+        return false;
+
+    addOutputWriter (afw, {}, streamingOutput.audioFormat == nullptr ? 32 : streamingOutput.bitDepth,
+                     streamingOutput.ditheringEnabled);
+    return true;
+}
+
+void NodeRenderContext::addOutputWriter (juce::AudioFormatWriter* afw, const juce::File& file,
+                                         int bitDepth, bool ditheringEnabled)
+{
+    auto output = std::make_unique<OutputWriter>();
+    output->file = file;
+
+    if (ditheringEnabled && bitDepth < 32)
+        output->ditherers = std::make_unique<Ditherers> (numOutputChans, bitDepth);
+
+    // The FIFO holds a couple of seconds so a slow encoder only stalls the render
+    // if it can't keep up on average
+    const int fifoSize = std::max (r.blockSizeForAudio * 8, juce::roundToInt (r.sampleRateForAudio * 2.0));
+    output->thread = std::make_unique<juce::TimeSliceThread> ("Render Writer " + juce::String ((int) outputWriters.size() + 1));
+    output->thread->startThread();
+    output->writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter> (afw, *output->thread, fifoSize);
+
+    outputWriters.push_back (std::move (output));
+}
+
+bool NodeRenderContext::isWriterOpen() const
+{
+    return ! outputWriters.empty()
+        || (intermediateAudio != nullptr && intermediateAudio->isValid());
+}
+
+bool NodeRenderContext::appendToWriter (juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (intermediateAudio != nullptr)
+        return intermediateAudio->append (buffer, numSamples);
+
+    for (auto& output : outputWriters)
+    {
+        auto* source = &buffer;
+
+        // Each output is dithered to its own bit depth so needs its own copy of the block
+        if (output->ditherers != nullptr)
+        {
+            for (int i = 0; i < numOutputChans; ++i)
+                ditherBuffer.copyFrom (i, 0, buffer, i, 0, numSamples);
+
+            output->ditherers->apply (ditherBuffer, numSamples);
+            source = &ditherBuffer;
+        }
+
+        while (! output->writer->write (source->getArrayOfReadPointers(), numSamples))
+        {
+            // The FIFO is full so wait for the writer thread to catch up
+            if (owner.shouldExit())
+                return false;
+
+            juce::Thread::sleep (1);
+        }
+    }
+
+    return true;
+}
+
+void NodeRenderContext::closeWriter()
+{
+    auto& audioFileManager = r.engine->getAudioFileManager();
+
+    for (auto& output : outputWriters)
+    {
+        // Deleting the ThreadedWriter flushes any pending data
+        output->writer.reset();
+        output->thread.reset();
+
+        // Streaming outputs don't have a file
+        if (output->file == juce::File())
+            continue;
+
+        const AudioFile file (*r.engine, output->file);
+        audioFileManager.releaseFile (file);
+        audioFileManager.checkFileForChanges (file);
+    }
+
+    outputWriters.clear();
+}
+
+//==============================================================================
+NodeRenderContext::IntermediateAudio::IntermediateAudio (const juce::File& targetFile, int numChannels, int64_t maxNumFrames)
+    : tempFile (targetFile.withFileExtension ("tmp")),
+      capacity (std::max ((int64_t) 1, maxNumFrames))
+{
+    const auto numBytes = (int64_t) sizeof (float) * numChannels * capacity;
+
+    // Size the file up-front so the whole render can be mapped at once
+    {
+        juce::FileOutputStream out (tempFile.getFile());
+
+        if (! out.openedOk() || ! out.setPosition (numBytes) || out.truncate().failed())
+            return;
+    }
+
+    mappedFile = std::make_unique<juce::MemoryMappedFile> (tempFile.getFile(), juce::MemoryMappedFile::readWrite, true);
+
+    if (! isValid() || (int64_t) mappedFile->getSize() < numBytes)
+    {
+        mappedFile.reset();
+        return;
+    }
+
+    for (int i = 0; i < numChannels; ++i)
+        channels.push_back (static_cast<float*> (mappedFile->getData()) + i * capacity);
+}
+
+bool NodeRenderContext::IntermediateAudio::append (const juce::AudioBuffer<float>& buffer, int numFrames)
+{
+    jassert (isValid());
+    jassert (buffer.getNumChannels() >= (int) channels.size());
+
+    if (numFramesWritten + numFrames > capacity)
+    {
+        jassertfalse; // The render should never be longer than the capacity
+        return false;
+    }
+
+    for (size_t i = 0; i < channels.size(); ++i)
+        std::memcpy (channels[i] + numFramesWritten, buffer.getReadPointer ((int) i), (size_t) numFrames * sizeof (float));
+
+    numFramesWritten += numFrames;
+    return true;
+}
+
+juce::AudioBuffer<float> NodeRenderContext::IntermediateAudio::getAudio() const
+{
+    if (! isValid())
+        return {};
+
+    return juce::AudioBuffer<float> (channels.data(), (int) channels.size(), (int) numFramesWritten);
+}
+
 //==============================================================================
 juce::String NodeRenderContext::renderMidi (Renderer::RenderTask& owner,
                                             Renderer::Parameters& r,
@@ -387,7 +718,7 @@ juce::String NodeRenderContext::renderMidi (Renderer::RenderTask& owner,
                   {
                       nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (n), *processState,
                                                                           sampleRate, samplesPerBlock,
-                                                                          getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy())));
+                                                                          getThreadPoolCreator (*r.engine, r.edit));
                   });
     // Ensure the node player gets deleted on the message thread
     const juce::ErasedScopeGuard scope ([&nodePlayer] { callBlocking ([&] { nodePlayer.reset(); }); });
@@ -477,5 +808,327 @@ juce::String NodeRenderContext::renderMidi (Renderer::RenderTask& owner,
     return {};
 }
 
+//==============================================================================
+juce::String NodeRenderContext::renderStems (Renderer::RenderTask& owner,
+                                             Renderer::Parameters& r,
+                                             std::unique_ptr<tracktion::graph::Node> n,
+                                             std::unique_ptr<tracktion::graph::PlayHead> playHead,
+                                             std::unique_ptr<tracktion::graph::PlayHeadState> playHeadState,
+                                             std::unique_ptr<ProcessState> processState,
+                                             std::atomic<float>& progress)
+{
+    CRASH_TRACER
+    jassert (! r.stems.empty());
+    jassert (! (r.shouldNormalise || r.shouldNormaliseByRMS || r.shouldNormaliseByLoudness || r.trimSilenceAtEnds)); // Not supported for stems
+
+    const int samplesPerBlock = r.blockSizeForAudio;
+    const double sampleRate = r.sampleRateForAudio;
+
+    std::unique_ptr<TracktionNodePlayer> nodePlayer;
+    Plugin::Array plugins;
+
+    callBlocking ([&]
+                  {
+                      nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (n), *processState,
+                                                                          sampleRate, samplesPerBlock,
+                                                                          getThreadPoolCreator (*r.engine, r.edit));
+                      nodePlayer->setNumThreads ((size_t) r.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
+
+                      plugins = findAllPlugins (*nodePlayer->getNode());
+                      Renderer::RenderTask::setAllPluginsRealtime (plugins, false);
+                      nodePlayer->prepareToPlay (sampleRate, samplesPerBlock);
+                      Renderer::RenderTask::flushAllPlugins (plugins, sampleRate, samplesPerBlock);
+                  });
+
+    // Ensure the node player gets deleted on the message thread
+    const juce::ErasedScopeGuard scope ([&]
+                                        {
+                                            Renderer::RenderTask::setAllPluginsRealtime (plugins, true);
+                                            callBlocking ([&] { nodePlayer.reset(); });
+                                        });
+
+    // Find the tap for each stem and open a writer for it.
+    // The writers are fed from FIFOs and shared between a few background threads so
+    // encoding and disk access doesn't hold up the render. The threads need to outlive
+    // the writers so are declared first.
+    struct StemWriter
+    {
+        StemWriter (StemTapNode& t, juce::File f, int bitDepth)
+            : tap (t), file (std::move (f)), ditherers (2, bitDepth)
+        {}
+
+        StemTapNode& tap;
+        juce::File file;
+        Ditherers ditherers;
+        int numChannels = 2, numLatencySamplesToDrop = 0;
+        int64_t numSamplesLeftToWrite = 0;
+        std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> writer;
+    };
+
+    std::vector<std::unique_ptr<juce::TimeSliceThread>> writerThreads;
+    std::vector<StemWriter> stems;
+    stems.reserve (r.stems.size());
+
+    for (auto node : getNodes (*nodePlayer->getNode(), VertexOrdering::preordering))
+        if (auto tap = dynamic_cast<StemTapNode*> (node))
+            for (auto& stem : r.stems)
+                if (stem.track != nullptr && stem.track->itemID == tap->getTrackID())
+                    stems.emplace_back (*tap, stem.destFile, r.bitDepth);
+
+    if (stems.empty())
+        return TRANS("Didn't find any audio to render");
+
+    const auto numWriterThreads = std::min (stems.size(), (size_t) std::max (1, juce::SystemStats::getNumCpus() / 2));
+
+    for (size_t i = 0; i < numWriterThreads; ++i)
+    {
+        writerThreads.push_back (std::make_unique<juce::TimeSliceThread> ("Stem Writer " + juce::String ((int) i + 1)));
+        writerThreads.back()->startThread();
+    }
+
+    auto metadata = r.metadata;
+    AudioFileUtils::addBWAVStartToMetadata (metadata, toSamples (r.time.getStart(), sampleRate));
+
+    const auto numSamplesToWrite = tracktion::toSamples (r.time.getLength() + r.endAllowance, sampleRate);
+    const int fifoSize = std::max (samplesPerBlock * 16, juce::roundToInt (sampleRate));
+    int maxLatencyNumSamples = 0;
+
+    for (size_t i = 0; i < stems.size(); ++i)
+    {
+        auto& stem = stems[i];
+        const auto props = stem.tap.getNodeProperties();
+        stem.numChannels = (r.mustRenderInMono || (r.canRenderInMono && props.numberOfChannels < 2)) ? 1 : 2;
+        stem.numLatencySamplesToDrop = props.latencyNumSamples;
+        stem.numSamplesLeftToWrite = numSamplesToWrite;
+        maxLatencyNumSamples = std::max (maxLatencyNumSamples, props.latencyNumSamples);
+
+        r.engine->getAudioFileManager().releaseFile (AudioFile (*r.engine, stem.file));
+
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+
+        if (stem.file.getParentDirectory().createDirectory())
+            writer.reset (AudioFileUtils::createWriterFor (r.audioFormat, stem.file, sampleRate,
+                                                           (unsigned int) stem.numChannels, r.bitDepth,
+                                                           metadata, r.quality, AudioFileWriteOptions::forRendering()));
+
+        if (writer == nullptr)
+            return TRANS("Couldn't write to target file") + ": " + stem.file.getFullPathName();
+
+        stem.writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter> (writer.release(), *writerThreads[i % writerThreads.size()], fifoSize);
+    }
+
+    juce::AudioBuffer<float> stemBuffer (2, samplesPerBlock);
+
+    auto writeStemBlock = [&] (StemWriter& stem)
+    {
+        auto block = stem.tap.getLastBlock();
+        const auto numFrames = (int) block.getNumFrames();
+        int offset = 0;
+
+        if (stem.numLatencySamplesToDrop > 0)
+        {
+            offset = std::min (stem.numLatencySamplesToDrop, numFrames);
+            stem.numLatencySamplesToDrop -= offset;
+        }
+
+        const auto numToWrite = (int) std::min (stem.numSamplesLeftToWrite, (int64_t) (numFrames - offset));
+
+        if (numToWrite <= 0)
+            return true;
+
+        const auto numTapChannels = (int) block.getNumChannels();
+
+        for (int c = 0; c < stem.numChannels; ++c)
+            juce::FloatVectorOperations::copy (stemBuffer.getWritePointer (c),
+                                               block.getChannel ((choc::buffer::ChannelCount) std::min (c, numTapChannels - 1)).data.data + offset,
+                                               numToWrite);
+
+        if (r.ditheringEnabled && r.bitDepth < 32)
+            stem.ditherers.apply (stemBuffer, numToWrite);
+
+        while (! stem.writer->write (stemBuffer.getArrayOfReadPointers(), numToWrite))
+        {
+            // The FIFO is full so wait for the writer thread to catch up
+            if (owner.shouldExit())
+                return false;
+
+            juce::Thread::sleep (1);
+        }
+
+        stem.numSamplesLeftToWrite -= numToWrite;
+        return true;
+    };
+
+    // Wait for any nodes to render their sources or proxies
+    const auto startSample = toSamples (r.time.getStart(), sampleRate);
+
+    playHead->stop();
+    playHead->setPosition (startSample);
+    playHead->playSyncedToRange ({ startSample, std::numeric_limits<int64_t>::max() });
+
+    playHeadState->update (juce::Range<int64_t>::withStartAndLength (startSample, samplesPerBlock));
+
+    auto leafNodesReady = [nodes = getNodes (*nodePlayer->getNode(), VertexOrdering::postordering)]
+    {
+        for (auto node : nodes)
+            if (node->getDirectInputNodes().empty() && ! node->isReadyToProcess())
+                return false;
+
+        return true;
+    };
+
+    while (! leafNodesReady())
+    {
+        juce::Thread::sleep (100);
+
+        if (owner.shouldExit())
+            return TRANS("Render cancelled");
+    }
+
+    // Then render the blocks, the latency of each stem is dropped as it's written
+    auto currentTempoPosition = createPosition (r.edit->tempoSequence);
+
+    juce::AudioBuffer<float> renderingBuffer (2, samplesPerBlock + 256);
+    tracktion::engine::MidiMessageArray blockMidiBuffer;
+    const auto numSamplesToRender = numSamplesToWrite + maxLatencyNumSamples;
+
+    for (int64_t numSamplesDone = 0; numSamplesDone < numSamplesToRender; numSamplesDone += samplesPerBlock)
+    {
+        if (owner.shouldExit())
+            return TRANS("Render cancelled");
+
+        const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength (startSample + numSamplesDone, samplesPerBlock);
+        const auto streamTime = TimePosition::fromSamples (referenceSampleRange.getStart(), sampleRate);
+
+        // Update modifier timers
+        r.edit->updateModifierTimers (streamTime, samplesPerBlock);
+        currentTempoPosition.set (streamTime);
+
+        resetFP();
+
+        renderingBuffer.clear();
+        blockMidiBuffer.clear();
+        auto destView = choc::buffer::createChannelArrayView (renderingBuffer.getArrayOfWritePointers(),
+                                                              (choc::buffer::ChannelCount) renderingBuffer.getNumChannels(), (choc::buffer::FrameCount) referenceSampleRange.getLength());
+
+        nodePlayer->process ({ (choc::buffer::FrameCount) referenceSampleRange.getLength(), referenceSampleRange, { destView, blockMidiBuffer} });
+
+        for (auto& stem : stems)
+            if (! writeStemBlock (stem))
+                return owner.shouldExit() ? TRANS("Render cancelled") : TRANS("Couldn't write to target file");
+
+        progress = juce::jlimit (0.0f, 1.0f, (float) ((numSamplesDone + samplesPerBlock) / (double) numSamplesToRender));
+    }
+
+    playHead->stop();
+
+    // Flush the writers and let the AudioFileManager know the files have changed
+    for (auto& stem : stems)
+    {
+        stem.writer.reset();
+        r.engine->getAudioFileManager().checkFileForChanges (AudioFile (*r.engine, stem.file));
+    }
+
+    return {};
+}
+
+//==============================================================================
+std::vector<HashCode> NodeRenderContext::getStemRenderHashes (tracktion::graph::Node& node, const Renderer::Parameters& r)
+{
+    CRASH_TRACER
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    std::vector<HashCode> hashes (r.stems.size(), 0);
+
+    // Dithering adds random noise so the output won't be repeatable
+    if (r.ditheringEnabled && r.bitDepth < 32)
+        return hashes;
+
+    // Start with everything other than the tracks that affects the output
+    size_t paramsHash = 0;
+    hash_combine (paramsHash, toSamples (r.time.getStart(), r.sampleRateForAudio));
+    hash_combine (paramsHash, toSamples (r.time.getEnd(), r.sampleRateForAudio));
+    hash_combine (paramsHash, toSamples (r.endAllowance, r.sampleRateForAudio));
+    hash_combine (paramsHash, r.sampleRateForAudio);
+    hash_combine (paramsHash, r.bitDepth);
+    hash_combine (paramsHash, r.quality);
+    hash_combine (paramsHash, r.usePlugins);
+    hash_combine (paramsHash, r.canRenderInMono);
+    hash_combine (paramsHash, r.mustRenderInMono);
+    hash_combine (paramsHash, (r.audioFormat != nullptr ? r.audioFormat->getFormatName() : juce::String()).hashCode64());
+    hash_combine (paramsHash, r.metadata.getDescription().hashCode64());
+    hash_combine (paramsHash, r.edit->tempoSequence.getState().toXmlString().hashCode64());
+
+    for (auto n : getNodes (node, VertexOrdering::preordering))
+    {
+        auto tap = dynamic_cast<StemTapNode*> (n);
+
+        if (tap == nullptr)
+            continue;
+
+        auto track = findTrackForID (*r.edit, tap->getTrackID());
+
+        if (track == nullptr)
+            continue;
+
+        // Node IDs describe the connections but not plugin parameters, automation or
+        // clip properties, so the state of any plugins and tracks that feed the stem
+        // has to be included too
+        size_t hash = paramsHash;
+        bool canBeCached = true;
+
+        for (auto input : getNodes (*tap, VertexOrdering::preordering))
+            hash_combine (hash, input->getNodeProperties().nodeID);
+
+        for (auto plugin : findAllPlugins (*tap))
+        {
+            if (dynamic_cast<AuxReturnPlugin*> (plugin) != nullptr
+                 || plugin->getSidechainSourceID().isValid())
+            {
+                canBeCached = false;
+                break;
+            }
+
+            plugin->flushPluginStateToValueTree();
+            hash_combine (hash, plugin->state.toXmlString().hashCode64());
+
+            if (auto rack = dynamic_cast<RackInstance*> (plugin))
+                if (auto type = rack->type)
+                    hash_combine (hash, type->state.toXmlString().hashCode64());
+        }
+
+        if (! canBeCached)
+            continue;
+
+        juce::Array<Track*> tracksToHash { track };
+
+        for (int i = 0; i < tracksToHash.size(); ++i)
+        {
+            auto t = tracksToHash.getUnchecked (i);
+
+            for (auto input : t->getInputTracks())
+                tracksToHash.addIfNotAlreadyThere (input);
+
+            for (auto subTrack : t->getAllSubTracks (false))
+                tracksToHash.addIfNotAlreadyThere (subTrack);
+        }
+
+        for (auto t : tracksToHash)
+        {
+            hash_combine (hash, t->state.toXmlString().hashCode64());
+
+            if (auto clipOwner = dynamic_cast<ClipOwner*> (t))
+                for (auto clip : clipOwner->getClips())
+                    if (auto audioClip = dynamic_cast<AudioClipBase*> (clip))
+                        hash_combine (hash, audioClip->getAudioFile().getHash());
+        }
+
+        for (size_t i = 0; i < r.stems.size(); ++i)
+            if (r.stems[i].track == track)
+                hashes[i] = (HashCode) hash;
+    }
+
+    return hashes;
+}
+
 
 }} // namespace tracktion { inline namespace engine
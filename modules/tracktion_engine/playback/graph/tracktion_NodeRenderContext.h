@@ -49,6 +49,26 @@ public:
                                     std::unique_ptr<ProcessState>,
                                     std::atomic<float>& progressToUpdate);
 
+    /** Renders the outputs of any StemTapNodes in the graph to the files given by
+        Renderer::Parameters::stems.
+        Each file is written on a background thread so the render thread only has
+        to copy each block in to a FIFO.
+    */
+    static juce::String renderStems (Renderer::RenderTask&, Renderer::Parameters&,
+                                     std::unique_ptr<tracktion::graph::Node>,
+                                     std::unique_ptr<tracktion::graph::PlayHead>,
+                                     std::unique_ptr<tracktion::graph::PlayHeadState>,
+                                     std::unique_ptr<ProcessState>,
+                                     std::atomic<float>& progressToUpdate);
+
+    /** Returns a hash for each of the Renderer::Parameters::stems that describes
+        its output, so it can be used as a key to cache the render.
+        A hash will be 0 if the stem can't be cached, e.g. it uses dithering or takes
+        input from send or sidechain sources that can't be tracked.
+        This flushes plugin states so must be called on the message thread.
+    */
+    static std::vector<HashCode> getStemRenderHashes (tracktion::graph::Node&, const Renderer::Parameters&);
+
 private:
     //==============================================================================
     struct Ditherers
@@ -73,6 +93,26 @@ private:
         juce::Array<Ditherer> ditherers;
     };
 
+    /** Holds the float output of a render that's going to be normalised or trimmed
+        in a memory-mapped temporary file, so it can be processed in place when the
+        final file is written. Each channel is stored contiguously.
+    */
+    struct IntermediateAudio
+    {
+        IntermediateAudio (const juce::File& targetFile, int numChannels, int64_t maxNumFrames);
+
+        bool isValid() const noexcept       { return mappedFile != nullptr && mappedFile->getData() != nullptr; }
+        bool append (const juce::AudioBuffer<float>&, int numFrames);
+
+        /** Returns a buffer that refers to the audio written so far. */
+        juce::AudioBuffer<float> getAudio() const;
+
+        juce::TemporaryFile tempFile;
+        std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+        std::vector<float*> channels;
+        int64_t capacity = 0, numFramesWritten = 0;
+    };
+
     //==============================================================================
     Renderer::RenderTask& owner;
     Renderer::Parameters r, originalParams;
@@ -81,15 +121,27 @@ private:
     std::unique_ptr<tracktion::graph::PlayHead> playHead;
     std::unique_ptr<tracktion::graph::PlayHeadState> playHeadState;
     std::unique_ptr<ProcessState> processState;
+    std::unique_ptr<LoudnessMeter> loudnessMeter;
     std::unique_ptr<TracktionNodePlayer> nodePlayer;
 
+    /** Encodes one of the output files or streams on its own thread, fed by a lock-free
+        FIFO, so encoding doesn't hold up the render or the other outputs.
+    */
+    struct OutputWriter
+    {
+        juce::File file;
+        std::unique_ptr<Ditherers> ditherers;
+        std::unique_ptr<juce::TimeSliceThread> thread;
+        std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> writer;
+    };
+
     int numOutputChans = 0;
-    std::unique_ptr<AudioFileWriter> writer;
+    std::vector<std::unique_ptr<OutputWriter>> outputWriters;
     Plugin::Array plugins;
     juce::Result status;
 
     //==============================================================================
-    Ditherers ditherers;
+    juce::AudioBuffer<float> renderingBuffer, ditherBuffer;
     MidiMessageArray midiBuffer;
 
     const float thresholdForStopping { dbToGain (-70.0f) };
@@ -113,7 +165,7 @@ private:
     bool hasStartedSavingToFile = 0;
     int64_t samplesToWrite = 0, numSamplesWrittenToSource = 0;
 
-    std::unique_ptr<juce::TemporaryFile> intermediateFile;
+    std::unique_ptr<IntermediateAudio> intermediateAudio;
     juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver* sourceToUpdate;
 
     //==============================================================================
@@ -124,6 +176,12 @@ private:
     };
 
     WriteResult writeAudioBlock (choc::buffer::ChannelArrayView<float>);
+    bool openOutputWriter (const juce::File&, juce::AudioFormat*, int bitDepth, int quality, bool ditheringEnabled);
+    bool openStreamingWriter (const Renderer::StreamingOutput&);
+    void addOutputWriter (juce::AudioFormatWriter*, const juce::File&, int bitDepth, bool ditheringEnabled);
+    bool isWriterOpen() const;
+    bool appendToWriter (juce::AudioBuffer<float>&, int numSamples);
+    void closeWriter();
 };
 
 }} // namespace tracktion { inline namespace engine
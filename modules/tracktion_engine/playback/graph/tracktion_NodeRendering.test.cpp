@@ -54,6 +54,11 @@ public:
                 runWaveRendering (fileDuration, 20, 12, singleFile, opts);
             }
 
+            {
+                const juce::ScopedValueSetter svs (opts.staticBufferAllocation, StaticBufferAllocation::yes);
+                runWaveRendering (fileDuration, 20, 12, singleFile, opts);
+            }
+
             singleFile = false;
             runWaveRendering (fileDuration, 20, 12, singleFile, opts);
         }
@@ -190,6 +195,7 @@ public:
         runResamplingRendering ("sincFast",     ResamplingQuality::sincFast);
         runResamplingRendering ("sincMedium",   ResamplingQuality::sincMedium);
         runResamplingRendering ("sincBest",     ResamplingQuality::sincBest);
+        runResamplingRendering ("sincPolyphase", ResamplingQuality::sincPolyphase);
     }
 
 private:
@@ -25,6 +25,48 @@ namespace
 
         return true;
     }
+
+    static bool isSilent (const choc::buffer::ChannelArrayView<float>& view)
+    {
+        constexpr float silenceThreshold = 1.0e-5f; // About -100dB
+        const auto numFrames = (int) view.getNumFrames();
+
+        for (choc::buffer::ChannelCount i = 0; i < view.getNumChannels(); ++i)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax (view.getChannel (i).data.data, numFrames);
+
+            if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold)
+                return false;
+        }
+
+        return true;
+    }
+
+    static void multiplyGains (VolumeAndPanPlugin::BlockGains& dest, const VolumeAndPanPlugin::BlockGains& source,
+                               int numSamples, bool includeOther)
+    {
+        auto multiply = [&] (float* d, const float* s)
+        {
+            if (source.isConstant && dest.isConstant)
+                d[0] *= s[0];
+            else if (source.isConstant)
+                juce::FloatVectorOperations::multiply (d, s[0], numSamples);
+            else if (dest.isConstant)
+                juce::FloatVectorOperations::multiply (d, s, d[0], numSamples);
+            else
+                juce::FloatVectorOperations::multiply (d, s, numSamples);
+        };
+
+        multiply (dest.left, source.left);
+        multiply (dest.right, source.right);
+
+        if (includeOther)
+            multiply (dest.other, source.other);
+        else
+            dest.other[0] = 1.0f;
+
+        dest.isConstant = dest.isConstant && source.isConstant;
+    }
 }
 
 //==============================================================================
@@ -47,6 +89,11 @@ PluginNode::PluginNode (std::unique_ptr<Node> inputNode,
     jassert (input != nullptr);
     jassert (plugin != nullptr);
     initialisePlugin (sampleRateToUse, blockSizeToUse);
+
+    if (auto volumeAndPan = dynamic_cast<VolumeAndPanPlugin*> (plugin.get()))
+        gainStages.push_back ({ plugin.get(), volumeAndPan });
+    else if (dynamic_cast<VCAPlugin*> (plugin.get()) != nullptr)
+        gainStages.push_back ({ plugin.get(), nullptr });
 }
 
 PluginNode::~PluginNode()
@@ -74,10 +121,20 @@ tracktion::graph::NodeProperties PluginNode::getNodeProperties()
     props.hasMidi  = props.hasMidi || plugin->takesMidiInput();
     props.latencyNumSamples = std::max (0, props.latencyNumSamples + latencyNumSamples);
 
-    if (props.nodeID != 0)
-        hash_combine (props.nodeID, (size_t) plugin->itemID.getRawID());
+    auto addToNodeID = [&props] (Plugin& p)
+    {
+        if (props.nodeID != 0)
+            hash_combine (props.nodeID, (size_t) p.itemID.getRawID());
+        else
+            props.nodeID = (size_t) p.itemID.getRawID();
+    };
+
+    // Folded gain stages are added as if they were still separate Nodes so the ID doesn't change
+    if (gainStages.empty())
+        addToNodeID (*plugin);
     else
-        props.nodeID = (size_t) plugin->itemID.getRawID();
+        for (auto& stage : gainStages)
+            addToNodeID (*stage.plugin);
 
     if (isPrepared)
         cachedNodeProperties = props;
@@ -85,6 +142,41 @@ tracktion::graph::NodeProperties PluginNode::getNodeProperties()
     return props;
 }
 
+tracktion::graph::TransformResult PluginNode::transform (TransformOptions& options)
+{
+    if (gainStages.empty())
+        return tracktion::graph::TransformResult::none;
+
+    auto inputPluginNode = dynamic_cast<PluginNode*> (input.get());
+
+    if (inputPluginNode == nullptr
+        || inputPluginNode->gainStages.empty()
+        || inputPluginNode->trackMuteState != trackMuteState
+        || inputPluginNode->maxNumChannels != maxNumChannels
+        || inputPluginNode->upmixMonoInput != upmixMonoInput)
+       return tracktion::graph::TransformResult::none;
+
+    // The input can only be folded if this is the only Node using its output
+    for (auto node : options.postOrderedNodes)
+        if (node != this)
+            for (auto nodeInput : node->getDirectInputNodes())
+                if (nodeInput == inputPluginNode)
+                    return tracktion::graph::TransformResult::none;
+
+    // Take over the input's stages and keep the Node alive so its plugin stays initialised
+    gainStages.insert (gainStages.begin(), inputPluginNode->gainStages.begin(), inputPluginNode->gainStages.end());
+    foldedNodes.insert (foldedNodes.begin(),
+                        std::make_move_iterator (inputPluginNode->foldedNodes.begin()),
+                        std::make_move_iterator (inputPluginNode->foldedNodes.end()));
+    inputPluginNode->foldedNodes.clear();
+
+    auto nodeToFold = std::move (input);
+    input = std::move (inputPluginNode->input);
+    foldedNodes.push_back (std::move (nodeToFold));
+
+    return tracktion::graph::TransformResult::nodesDeleted;
+}
+
 void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
 {
     juce::ignoreUnused (info);
@@ -103,6 +195,9 @@ void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationIn
                             && dynamic_cast<ExternalPlugin*> (plugin.get()) != nullptr
                             && latencyNumSamples > 0;
 
+    bypassWhileScrubbing = ! isRendering && gainStages.empty()
+                            && plugin->engine.getEngineBehaviour().shouldBypassPluginWhileScrubbing (*plugin);
+
     if (canProcessBypassed)
     {
         replaceLatencyProcessorIfPossible (info.nodeGraphToReplace);
@@ -115,6 +210,21 @@ void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationIn
         }
     }
 
+    // Allow for a block of silence past the tail and latency before sleeping.
+    // Plugins with infinite (or practically infinite) tails never sleep.
+    canSleep = plugin->canSleepWhenSilent() && gainStages.empty();
+    const auto tailLength = canSleep ? plugin->getTailLength() : 0.0;
+
+    if (canSleep && tailLength < 60.0)
+        numSilentSamplesBeforeSleeping = juce::roundToInt (std::max (0.0, tailLength) * sampleRate) + latencyNumSamples + info.blockSize;
+    else
+        canSleep = false;
+
+    plugin->setSleeping (false);
+
+    if (! gainStages.empty())
+        gainBuffer.setSize (6, info.blockSize);
+
     isPrepared = true;
 
     if (info.enableNodeMemorySharing && input->numOutputNodes == 1)
@@ -144,6 +254,12 @@ void PluginNode::preProcess (choc::buffer::FrameCount, juce::Range<int64_t>)
 
 void PluginNode::process (ProcessContext& pc)
 {
+    if (! gainStages.empty())
+    {
+        processGainStages (pc);
+        return;
+    }
+
     auto inputBuffers = input->getProcessedOutput();
     auto& inputAudioBlock = inputBuffers.audio;
 
@@ -155,20 +271,32 @@ void PluginNode::process (ProcessContext& pc)
     const auto numInputChannelsToCopy = std::min (inputAudioBlock.getNumChannels(),
                                                   outputAudioView.getNumChannels());
 
-    if (latencyProcessor)
-    {
-        if (numInputChannelsToCopy > 0)
-            latencyProcessor->writeAudio (inputAudioBlock.getFirstChannels (numInputChannelsToCopy));
-
-        latencyProcessor->writeMIDI (inputBuffers.midi);
-    }
-
     // Copy the inputs to the outputs, then process using the
     // output buffers as that will be the correct size
     if (numInputChannelsToCopy > 0)
         tracktion::graph::copyIfNotAliased (outputAudioView.getFirstChannels (numInputChannelsToCopy),
                                             inputAudioBlock.getFirstChannels (numInputChannelsToCopy));
 
+    auto numChannelsCopied = numInputChannelsToCopy;
+
+    if (upmixMonoInput && numInputChannelsToCopy == 1)
+    {
+        for (choc::buffer::ChannelCount chan = 1; chan < outputAudioView.getNumChannels(); ++chan)
+            juce::FloatVectorOperations::copy (outputAudioView.getIterator (chan).sample,
+                                               outputAudioView.getIterator (0).sample, (int) blockNumSamples);
+
+        numChannelsCopied = outputAudioView.getNumChannels();
+    }
+
+    if (latencyProcessor)
+    {
+        // The output hasn't been processed yet so this is the same as the (possibly upmixed) input
+        if (numChannelsCopied > 0)
+            latencyProcessor->writeAudio (outputAudioView.getFirstChannels (numChannelsCopied));
+
+        latencyProcessor->writeMIDI (inputBuffers.midi);
+    }
+
     // Init block
     auto subBlockSize = subBlockSizeToUse < 0 ? blockNumSamples
                                               : (choc::buffer::FrameCount) subBlockSizeToUse;
@@ -176,7 +304,10 @@ void PluginNode::process (ProcessContext& pc)
     choc::buffer::FrameCount numSamplesDone = 0;
     auto numSamplesLeft = blockNumSamples;
 
-    bool shouldProcessPlugin = canProcessBypassed || plugin->isEnabled();
+    // Plugins can opt out of processing whilst scrubbing, in which case they're treated as bypassed
+    const bool isScrubBypassed = bypassWhileScrubbing && playHeadState.playHead.isUserDragging();
+    const bool isPluginActive = plugin->isEnabled() && ! isScrubBypassed;
+    bool shouldProcessPlugin = ! isScrubBypassed && (canProcessBypassed || plugin->isEnabled());
     bool isAllNotesOff = inputBuffers.midi.isAllNotesOff;
 
     if (playHeadState.didPlayheadJump())
@@ -193,14 +324,37 @@ void PluginNode::process (ProcessContext& pc)
         }
     }
 
+    // Skip processing if the plugin is asleep and nothing has arrived to wake it
+    const bool canSleepThisBlock = canSleep && shouldProcessPlugin && plugin->isEnabled();
+    const bool inputIsSilent = canSleepThisBlock && ! isAllNotesOff
+                                && inputBuffers.midi.isEmpty()
+                                && (inputBuffers.isAudioSilent || isSilent (inputAudioBlock));
+
+    if (isSleeping)
+    {
+        if (inputIsSilent)
+            shouldProcessPlugin = false;
+        else
+            setSleeping (false);
+    }
+
     const auto blockTimeRange = getEditTimeRange();
     auto inputMidiIter = inputBuffers.midi.begin();
 
+    // If the timeline wraps around in this block, the sub-blocks are split there so
+    // the plugin and its automation see a contiguous time range each time they're called
+    const auto sections = getTimelineSectionsForBlock (blockNumSamples);
+    const auto wrapSample = sections.size() > 1 ? (choc::buffer::FrameCount) sections[1].startSample
+                                                : blockNumSamples;
+
     // Process in blocks
     for (int subBlockNum = 0;; ++subBlockNum)
     {
         auto numSamplesThisBlock = std::min (subBlockSize, numSamplesLeft);
 
+        if (numSamplesDone < wrapSample)
+            numSamplesThisBlock = std::min (numSamplesThisBlock, wrapSample - numSamplesDone);
+
         auto outputAudioBuffer = toAudioBuffer (outputAudioView.getFrameRange (frameRangeWithStartAndLength (numSamplesDone, numSamplesThisBlock)));
 
         const auto blockPropStart = (numSamplesDone / (double) blockNumSamples);
@@ -227,9 +381,21 @@ void PluginNode::process (ProcessContext& pc)
 
         // Process the plugin
         if (shouldProcessPlugin)
-            plugin->applyToBufferWithAutomation (getPluginRenderContext ({ blockTimeRange.getStart() + toDuration (subBlockTimeRange.getStart()),
-                                                                           blockTimeRange.getStart() + toDuration (subBlockTimeRange.getEnd()) },
-                                                                         outputAudioBuffer));
+        {
+            TRACKTION_GRAPH_TRACE_SCOPE ("Plugin::applyToBufferWithAutomation", "plugin", (size_t) plugin->itemID.getRawID())
+            auto& telemetry = plugin->engine.getDeviceManager().getAudioCallbackTelemetry();
+            const auto startTicks = (! isRendering && telemetry.isActive()) ? juce::Time::getHighResolutionTicks() : 0;
+
+            const auto subBlockEditTime = sections.size() > 1
+                                            ? getSectionEditTimeRange (sections[numSamplesDone < wrapSample ? 0 : 1], numSamplesDone, numSamplesThisBlock)
+                                            : TimeRange (blockTimeRange.getStart() + toDuration (subBlockTimeRange.getStart()),
+                                                         blockTimeRange.getStart() + toDuration (subBlockTimeRange.getEnd()));
+
+            plugin->applyToBufferWithAutomation (getPluginRenderContext (subBlockEditTime, outputAudioBuffer));
+
+            if (startTicks != 0)
+                telemetry.addPluginTime (juce::Time::getHighResolutionTicks() - startTicks);
+        }
 
         // Then copy the buffers to the outputs
         if (subBlockNum == 0)
@@ -250,7 +416,7 @@ void PluginNode::process (ProcessContext& pc)
     if (latencyProcessor)
     {
         // A slightly better approach would be to crossfade between the processed and latency block to minimise any discrepancies
-        if (plugin->isEnabled())
+        if (isPluginActive)
         {
             auto numSamples = (int) blockNumSamples;
             latencyProcessor->clearAudio (numSamples);
@@ -270,9 +436,177 @@ void PluginNode::process (ProcessContext& pc)
 
     // Some plugins flake and add NaNs so zero these out to avoid killing all the audio downstream
     sanitise (outputAudioView);
+
+    // A sleeping plugin just passes on its input so if that was silent, so is the output
+    if (isSleeping && ! shouldProcessPlugin && ! latencyProcessor)
+        outputBuffers.isAudioSilent = inputBuffers.isAudioSilent;
+
+    // Once the input and output have been silent for long enough, stop processing
+    if (! isSleeping)
+    {
+        if (inputIsSilent && outputBuffers.midi.isEmpty() && isSilent (outputAudioView))
+            numSilentSamples += (int) blockNumSamples;
+        else
+            numSilentSamples = 0;
+
+        if (numSilentSamples > numSilentSamplesBeforeSleeping)
+            setSleeping (true);
+    }
 }
 
 //==============================================================================
+void PluginNode::processGainStages (ProcessContext& pc)
+{
+    auto inputBuffers = input->getProcessedOutput();
+    auto& inputAudioBlock = inputBuffers.audio;
+
+    auto& outputBuffers = pc.buffers;
+    auto outputAudioView = outputBuffers.audio;
+    const auto numSamples = (int) outputAudioView.getNumFrames();
+    jassert (inputAudioBlock.getNumFrames() == outputAudioView.getNumFrames());
+    jassert (numSamples <= gainBuffer.getNumSamples());
+
+    const bool shouldUpmix = upmixMonoInput && inputAudioBlock.getNumChannels() == 1;
+    const auto numChannels = shouldUpmix ? outputAudioView.getNumChannels()
+                                         : std::min (inputAudioBlock.getNumChannels(),
+                                                     outputAudioView.getNumChannels());
+
+    bool shouldApplyGains = true;
+    bool isAllNotesOff = inputBuffers.midi.isAllNotesOff || playHeadState.didPlayheadJump();
+
+    if (trackMuteState != nullptr && ! trackMuteState->shouldTrackContentsBeProcessed())
+    {
+        shouldApplyGains = trackMuteState->shouldTrackBeAudible();
+
+        if (trackMuteState->wasJustMuted())
+            isAllNotesOff = true;
+    }
+
+    midiMessageArray.copyFrom (inputBuffers.midi);
+    midiMessageArray.isAllNotesOff = isAllNotesOff;
+
+    // Combine the gains of all the stages, the first one is calculated straight in to the result
+    VolumeAndPanPlugin::BlockGains gains { gainBuffer.getWritePointer (0), gainBuffer.getWritePointer (1),
+                                           gainBuffer.getWritePointer (2) };
+    VolumeAndPanPlugin::BlockGains stageGains { gainBuffer.getWritePointer (3), gainBuffer.getWritePointer (4),
+                                                gainBuffer.getWritePointer (5) };
+    gains.left[0] = gains.right[0] = gains.other[0] = 1.0f;
+
+    if (shouldApplyGains)
+    {
+        auto& telemetry = plugin->engine.getDeviceManager().getAudioCallbackTelemetry();
+        const auto startTicks = (! isRendering && telemetry.isActive()) ? juce::Time::getHighResolutionTicks() : 0;
+
+        auto calculateGains = [&] (VolumeAndPanPlugin::BlockGains& destGains, TimeRange editTime,
+                                   choc::buffer::FrameRange frameRange, bool scaleMidi)
+        {
+            auto outputAudioBuffer = toAudioBuffer (outputAudioView.getFrameRange (frameRange));
+            auto fc = getPluginRenderContext (editTime, outputAudioBuffer);
+            bool isFirstGain = true;
+
+            if (! scaleMidi)
+                fc.bufferForMidiMessages = nullptr;
+
+            for (auto& stage : gainStages)
+            {
+                stage.plugin->updateAutomationForBlock (fc);
+
+                if (stage.volumeAndPan == nullptr)
+                    continue;
+
+                if (isFirstGain)
+                {
+                    stage.volumeAndPan->getGainsForBlock (fc, destGains);
+                    isFirstGain = false;
+                }
+                else
+                {
+                    stage.volumeAndPan->getGainsForBlock (fc, stageGains);
+                    multiplyGains (destGains, stageGains, (int) frameRange.size(), outputAudioView.getNumChannels() > 2);
+                }
+            }
+        };
+
+        if (const auto sections = getTimelineSectionsForBlock ((choc::buffer::FrameCount) numSamples); sections.size() > 1)
+        {
+            // Each side of a loop wrap reads its own automation so the gains end up varying
+            // over the block. The MIDI is only scaled once, with the gains of the first side
+            for (auto& section : sections)
+            {
+                VolumeAndPanPlugin::BlockGains sectionGains { gains.left + section.startSample, gains.right + section.startSample,
+                                                              gains.other + section.startSample };
+                sectionGains.left[0] = sectionGains.right[0] = sectionGains.other[0] = 1.0f;
+                calculateGains (sectionGains, section.editTimeRange,
+                                frameRangeWithStartAndLength ((choc::buffer::FrameCount) section.startSample, (choc::buffer::FrameCount) section.numSamples),
+                                section.startSample == 0);
+
+                if (sectionGains.isConstant)
+                    for (auto chanGains : { sectionGains.left, sectionGains.right, sectionGains.other })
+                        juce::FloatVectorOperations::fill (chanGains + 1, chanGains[0], section.numSamples - 1);
+            }
+
+            gains.isConstant = false;
+        }
+        else
+        {
+            calculateGains (gains, getEditTimeRange(), frameRangeWithStartAndLength (0, (choc::buffer::FrameCount) numSamples), true);
+        }
+
+        if (startTicks != 0)
+            telemetry.addPluginTime (juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    // The output is either cleared or the input's own buffer so silence needs no processing
+    if (inputBuffers.isAudioSilent)
+    {
+        outputBuffers.isAudioSilent = true;
+        outputBuffers.midi.swapWith (midiMessageArray);
+        return;
+    }
+
+    // Then apply them as the input is copied to the output.
+    // This goes backwards so an upmixed input isn't overwritten before the other channels have read it
+    for (auto chan = numChannels; chan-- > 0;)
+    {
+        auto src = inputAudioBlock.getIterator (shouldUpmix ? 0 : chan).sample;
+        auto dest = outputAudioView.getIterator (chan).sample;
+        auto chanGains = chan == 0 ? gains.left : (chan == 1 ? gains.right : gains.other);
+
+        if (! gains.isConstant)
+        {
+            if (src == dest)
+                juce::FloatVectorOperations::multiply (dest, chanGains, numSamples);
+            else
+                juce::FloatVectorOperations::multiply (dest, src, chanGains, numSamples);
+        }
+        else if (chanGains[0] != 1.0f)
+        {
+            if (src == dest)
+                juce::FloatVectorOperations::multiply (dest, chanGains[0], numSamples);
+            else
+                juce::FloatVectorOperations::multiply (dest, src, chanGains[0], numSamples);
+        }
+        else if (src != dest)
+        {
+            juce::FloatVectorOperations::copy (dest, src, numSamples);
+        }
+    }
+
+    outputBuffers.midi.swapWith (midiMessageArray);
+}
+
+void PluginNode::setSleeping (bool shouldSleep)
+{
+    if (! shouldSleep)
+        numSilentSamples = 0;
+
+    if (isSleeping == shouldSleep)
+        return;
+
+    isSleeping = shouldSleep;
+    plugin->setSleeping (shouldSleep);
+}
+
 void PluginNode::initialisePlugin (double sampleRateToUse, int blockSizeToUse)
 {
     plugin->baseClassInitialise ({ 0_tp, sampleRateToUse, blockSizeToUse });
@@ -282,6 +616,50 @@ void PluginNode::initialisePlugin (double sampleRateToUse, int blockSizeToUse)
     latencyNumSamples = juce::roundToInt (plugin->getLatencySeconds() * sampleRate);
 }
 
+std::optional<int> PluginNode::updateLatencyFromPlugin()
+{
+    const auto newLatencyNumSamples = juce::roundToInt (plugin->getLatencySeconds() * sampleRate);
+
+    // The dry signal used when the plugin is bypassed needs delaying by the new latency too
+    if (latencyProcessor)
+    {
+        if (! latencyProcessor->setLatencyNumSamplesLive (newLatencyNumSamples))
+            return std::nullopt;
+    }
+    else if (balanceLatency && newLatencyNumSamples > 0
+             && dynamic_cast<ExternalPlugin*> (plugin.get()) != nullptr)
+    {
+        return std::nullopt;
+    }
+
+    const auto delta = newLatencyNumSamples - latencyNumSamples;
+    latencyNumSamples = newLatencyNumSamples;
+
+    return delta;
+}
+
+std::span<const ProcessState::TimelineSection> PluginNode::getTimelineSectionsForBlock (choc::buffer::FrameCount blockNumSamples)
+{
+    auto sections = getProcessState().getTimelineSections();
+
+    // Only use the sections if this is the block they describe
+    if (sections.size() > 1 && (int) blockNumSamples == getProcessState().numSamples)
+        return sections;
+
+    return {};
+}
+
+TimeRange PluginNode::getSectionEditTimeRange (const ProcessState::TimelineSection& section,
+                                               choc::buffer::FrameCount startSample, choc::buffer::FrameCount numSamples)
+{
+    const auto sectionLength = section.editTimeRange.getLength();
+    const auto startProportion = (startSample - (choc::buffer::FrameCount) section.startSample) / (double) section.numSamples;
+    const auto endProportion = (startSample + numSamples - (choc::buffer::FrameCount) section.startSample) / (double) section.numSamples;
+
+    return { section.editTimeRange.getStart() + sectionLength * startProportion,
+             section.editTimeRange.getStart() + sectionLength * endProportion };
+}
+
 PluginRenderContext PluginNode::getPluginRenderContext (TimeRange editTime, juce::AudioBuffer<float>& destBuffer)
 {
     return { &destBuffer,
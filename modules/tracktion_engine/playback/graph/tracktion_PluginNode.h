@@ -18,6 +18,11 @@ class TrackMuteState;
 
 /**
     Node for processing a plugin.
+
+    VolumeAndPanPlugins and VCAPlugins are treated as pure gain stages. Rather than
+    processing them, their gains are applied as the input is copied to the output,
+    and consecutive gain stages are folded in to the last one during the graph's
+    transform so a chain of them takes a single pass over the audio.
 */
 class PluginNode final  : public tracktion::graph::Node,
                           public TracktionEngineNode
@@ -49,9 +54,28 @@ public:
     //==============================================================================
     Plugin& getPlugin()                                 { return *plugin; }
 
+    /** If set, a mono input is copied to all the output channels before the plugin
+        processes it, rather than only to the first one. This lets mono signals stay
+        mono up to the plugin. Must be called before the Node is initialised.
+    */
+    void setUpmixMonoInput (bool shouldUpmix)           { upmixMonoInput = shouldUpmix; }
+
+    /** Takes the plugin's new latency whilst the graph is playing and returns how many
+        samples it changed by. The graph's latency compensation then needs updating to
+        match with a LatencyCompensationUpdater.
+        The automation offset isn't changed so automation will be late or early by the
+        change until the graph is rebuilt.
+        Returns nullopt if the Node can't change its latency without being rebuilt, e.g.
+        if it needs to start delaying its input whilst it's bypassed.
+        This should be called on the message thread.
+    */
+    std::optional<int> updateLatencyFromPlugin();
+
     tracktion::graph::NodeProperties getNodeProperties() override;
     std::vector<Node*> getDirectInputNodes() override   { return { input.get() }; }
+    tracktion::graph::TransformResult transform (TransformOptions&) override;
     bool isReadyToProcess() override                    { return input->hasProcessed(); }
+    bool canProcessSplitTimelineRanges() override       { return true; }
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     void prefetchBlock (juce::Range<int64_t>) override;
     void preProcess (choc::buffer::FrameCount, juce::Range<int64_t>) override;
@@ -71,16 +95,33 @@ private:
     int latencyNumSamples = 0, maxNumChannels = -1;
     tracktion::engine::MidiMessageArray midiMessageArray;
     int subBlockSizeToUse = -1;
-    bool balanceLatency = true, canProcessBypassed = false;
+    bool balanceLatency = true, canProcessBypassed = false, upmixMonoInput = false, bypassWhileScrubbing = false;
     TimeDuration automationAdjustmentTime;
 
     std::shared_ptr<tracktion::graph::LatencyProcessor> latencyProcessor;
     std::optional<NodeProperties> cachedNodeProperties;
     bool isPrepared = false, canUseSourceBuffers = false;
 
+    bool canSleep = false, isSleeping = false;
+    int numSilentSamples = 0, numSilentSamplesBeforeSleeping = 0;
+
+    struct GainStage
+    {
+        Plugin* plugin = nullptr;
+        VolumeAndPanPlugin* volumeAndPan = nullptr; // nullptr for a VCAPlugin, whose gain is applied by the tracks it controls
+    };
+
+    std::vector<GainStage> gainStages;
+    std::vector<std::unique_ptr<Node>> foldedNodes;
+    juce::AudioBuffer<float> gainBuffer;
+
     //==============================================================================
+    void setSleeping (bool);
+    void processGainStages (ProcessContext&);
     void initialisePlugin (double sampleRateToUse, int blockSizeToUse);
     PluginRenderContext getPluginRenderContext (TimeRange, juce::AudioBuffer<float>&);
+    std::span<const ProcessState::TimelineSection> getTimelineSectionsForBlock (choc::buffer::FrameCount blockNumSamples);
+    static TimeRange getSectionEditTimeRange (const ProcessState::TimelineSection&, choc::buffer::FrameCount startSample, choc::buffer::FrameCount numSamples);
     void replaceLatencyProcessorIfPossible (NodeGraph*);
 };
 
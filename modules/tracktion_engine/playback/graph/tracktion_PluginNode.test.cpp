@@ -0,0 +1,222 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLAYBACK
+
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+
+namespace tracktion::inline engine
+{
+
+namespace plugin_node::test
+{
+    /** Outputs a stereo sine wave whilst the gate is open and silence whilst it's closed. */
+    class GatedSinNode final  : public tracktion::graph::Node
+    {
+    public:
+        GatedSinNode (const bool& isOpenToUse, double sampleRate)
+            : isOpen (isOpenToUse),
+              phaseIncrement ((float) (juce::MathConstants<double>::twoPi * 440.0 / sampleRate))
+        {
+        }
+
+        tracktion::graph::NodeProperties getNodeProperties() override
+        {
+            tracktion::graph::NodeProperties props;
+            props.hasAudio = true;
+            props.numberOfChannels = 2;
+            props.nodeID = 1;
+            return props;
+        }
+
+        std::vector<tracktion::graph::Node*> getDirectInputNodes() override    { return {}; }
+        bool isReadyToProcess() override                                        { return true; }
+
+        void process (ProcessContext& pc) override
+        {
+            if (! isOpen)
+            {
+                pc.buffers.audio.clear();
+                return;
+            }
+
+            for (choc::buffer::FrameCount i = 0; i < pc.numSamples; ++i)
+            {
+                const auto sample = 0.5f * std::sin (phase);
+                phase = std::fmod (phase + phaseIncrement, juce::MathConstants<float>::twoPi);
+
+                for (choc::buffer::ChannelCount chan = 0; chan < pc.buffers.audio.getNumChannels(); ++chan)
+                    pc.buffers.audio.getSample (chan, i) = sample;
+            }
+        }
+
+    private:
+        const bool& isOpen;
+        const float phaseIncrement;
+        float phase = 0.0f;
+    };
+
+    /** Plays a plugin through a PluginNode with a GatedSinNode as its input. */
+    struct Player
+    {
+        Player (Plugin& plugin, double sampleRate_, int blockSize_)
+            : sampleRate (sampleRate_), blockSize (blockSize_)
+        {
+            auto node = std::make_unique<PluginNode> (std::make_unique<GatedSinNode> (isInputOn, sampleRate),
+                                                      &plugin, sampleRate, blockSize, nullptr, processState,
+                                                      false, false, -1);
+            player = std::make_unique<TracktionNodePlayer> (std::move (node), processState, sampleRate, blockSize,
+                                                            getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+            player->setNumThreads (0);
+            playHead.play ({ 0, std::numeric_limits<int64_t>::max() }, false);
+        }
+
+        /** Processes the next block and returns its peak level. */
+        float processNextBlock()
+        {
+            const juce::Range<int64_t> referenceSampleRange { referenceSamplePosition, referenceSamplePosition + blockSize };
+            referenceSamplePosition += blockSize;
+
+            choc::buffer::ChannelArrayBuffer<float> audio (2, (choc::buffer::FrameCount) blockSize);
+            audio.clear();
+            MidiMessageArray midi;
+            player->process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { audio.getView(), midi } });
+
+            float peak = 0.0f;
+
+            for (choc::buffer::ChannelCount chan = 0; chan < audio.getNumChannels(); ++chan)
+                for (choc::buffer::FrameCount i = 0; i < audio.getNumFrames(); ++i)
+                    peak = std::max (peak, std::abs (audio.getSample (chan, i)));
+
+            return peak;
+        }
+
+        float processBlocks (int numBlocks)
+        {
+            float peak = 0.0f;
+
+            for (int i = 0; i < numBlocks; ++i)
+                peak = std::max (peak, processNextBlock());
+
+            return peak;
+        }
+
+        const double sampleRate;
+        const int blockSize;
+        int64_t referenceSamplePosition = 0;
+        bool isInputOn = true;
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState };
+        std::unique_ptr<TracktionNodePlayer> player;
+    };
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("PluginNode sleeping")
+    {
+        using namespace plugin_node::test;
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+
+        SUBCASE ("Plugins sleep whilst silent and wake when audio arrives")
+        {
+            auto plugin = edit->getPluginCache().createNewPlugin (LowPassPlugin::xmlTypeName, {});
+            track->pluginList.insertPlugin (plugin, 0, nullptr);
+            REQUIRE (plugin->canSleepWhenSilent());
+
+            Player player (*plugin, 44100.0, 256);
+
+            CHECK (player.processBlocks (20) > 0.1f);
+            CHECK (! plugin->isSleeping());
+
+            // The filter's output dies away so it should sleep a couple of blocks after that
+            player.isInputOn = false;
+            player.processBlocks (20);
+            CHECK (plugin->isSleeping());
+            CHECK_EQ (player.processBlocks (10), 0.0f);
+            CHECK (plugin->isSleeping());
+
+            // The first block of audio should wake it up and be processed
+            player.isInputOn = true;
+            CHECK (player.processNextBlock() > 0.1f);
+            CHECK (! plugin->isSleeping());
+            CHECK (player.processBlocks (20) > 0.1f);
+            CHECK (! plugin->isSleeping());
+
+            // And it should go to sleep again
+            player.isInputOn = false;
+            player.processBlocks (20);
+            CHECK (plugin->isSleeping());
+        }
+
+        SUBCASE ("Plugins that opt out never sleep")
+        {
+            auto plugin = edit->getPluginCache().createNewPlugin (ReverbPlugin::xmlTypeName, {});
+            track->pluginList.insertPlugin (plugin, 0, nullptr);
+            REQUIRE (! plugin->canSleepWhenSilent());
+
+            Player player (*plugin, 44100.0, 256);
+            player.processBlocks (20);
+            player.isInputOn = false;
+            player.processBlocks (100);
+            CHECK (! plugin->isSleeping());
+        }
+
+        SUBCASE ("External plugins only sleep if the EngineBehaviour allows it")
+        {
+            juce::PluginDescription desc;
+            desc.name = "Missing effect";
+            desc.pluginFormatName = "VST3";
+            desc.fileOrIdentifier = "missing_effect.vst3";
+            desc.isInstrument = false;
+
+            auto plugin = edit->getPluginCache().createNewPlugin (ExternalPlugin::xmlTypeName, desc);
+            REQUIRE (dynamic_cast<ExternalPlugin*> (plugin.get()) != nullptr);
+            CHECK (! engine.getEngineBehaviour().canExternalPluginSleepWhenSilent (desc));
+            CHECK (! plugin->canSleepWhenSilent());
+        }
+    }
+
+    TEST_CASE ("PluginNode live latency changes")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine);
+        auto track = getAudioTracks (*edit)[0];
+
+        auto trackPlugin = edit->getPluginCache().createNewPlugin (LowPassPlugin::xmlTypeName, {});
+        track->pluginList.insertPlugin (trackPlugin, 0, nullptr);
+
+        auto rackPlugin = edit->getPluginCache().createNewPlugin (LowPassPlugin::xmlTypeName, {});
+        Plugin::Array plugins;
+        plugins.add (rackPlugin);
+        auto rack = RackType::createTypeToWrapPlugins (plugins, *edit);
+        REQUIRE (rack != nullptr);
+        track->pluginList.insertPlugin (RackInstance::create (*rack), 1, nullptr);
+        edit->dispatchPendingUpdatesSynchronously();
+
+        auto& tc = edit->getTransport();
+        tc.ensureContextAllocated();
+        auto context = tc.getCurrentPlaybackContext();
+        REQUIRE (context != nullptr);
+
+        CHECK (context->updatePluginLatency (*trackPlugin));
+
+        // Plugins in racks don't have their own PluginNodes so the graph has to be rebuilt
+        CHECK (! context->updatePluginLatency (*rackPlugin));
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLAYBACK
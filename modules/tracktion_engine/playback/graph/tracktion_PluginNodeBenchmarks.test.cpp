@@ -35,6 +35,9 @@ public:
         auto& engine = *tracktion::engine::Engine::getEngines()[0];
         runNodePreparationBenchmarks (engine);
         runLargeGraphUpdateBenchmark (engine);
+        runFourOscPolyphonyBenchmarks (engine);
+        runAirWindowsBenchmarks (engine);
+        runReverbBenchmarks (engine);
     }
 
 private:
@@ -149,6 +152,165 @@ private:
             }
         }
     }
+
+    void runFourOscPolyphonyBenchmarks (Engine& engine)
+    {
+        for (int numUnisonVoices : { 1, 4, 8 })
+            runFourOscPolyphonyBenchmark (engine, 16, numUnisonVoices);
+    }
+
+    void runFourOscPolyphonyBenchmark (Engine& engine, int numNotes, int numUnisonVoices)
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = 1000;
+
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto plugin = edit->getPluginCache().createNewPlugin (FourOscPlugin::xmlTypeName, {});
+        auto synth = dynamic_cast<FourOscPlugin*> (plugin.get());
+        jassert (synth != nullptr);
+
+        // A pad with all four oscillators playing detuned, spread saws
+        synth->voiceModeValue = 2;
+        synth->voicesValue = numNotes;
+        synth->filterTypeValue = 1;
+
+        for (auto osc : synth->oscParams)
+        {
+            osc->waveShapeValue = (int) Oscillator::saw;
+            osc->voicesValue = numUnisonVoices;
+            osc->detuneValue = 0.2f;
+            osc->spreadValue = 50.0f;
+        }
+
+        synth->baseClassInitialise ({ 0_tp, sampleRate, blockSize });
+
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        MidiMessageArray midi;
+        const auto mpeSourceID = createUniqueMPESourceID();
+
+        for (int i = 0; i < numNotes; ++i)
+            midi.addMidiMessage (juce::MidiMessage::noteOn (1, 36 + i * 3, 0.8f), 0.0, mpeSourceID);
+
+        const ScopedBenchmark sb (createBenchmarkDescription ("Plugins",
+                                                              juce::String ("4OSC polyphony").toStdString(),
+                                                              juce::String ("Rendering 123 notes with XXYY unison voices")
+                                                                .replace ("123", juce::String (numNotes))
+                                                                .replace ("XXYY", juce::String (numUnisonVoices)).toStdString()));
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const auto blockTime = TimeRange (TimePosition::fromSamples (block * blockSize, sampleRate),
+                                              TimeDuration::fromSamples (blockSize, sampleRate));
+
+            buffer.clear();
+            synth->applyToBuffer (PluginRenderContext (&buffer, juce::AudioChannelSet::stereo(), 0, blockSize,
+                                                       &midi, 0.0, blockTime, true, false, false, false));
+            midi.clear();
+        }
+
+        synth->baseClassDeinitialise();
+    }
+
+    void runAirWindowsBenchmarks (Engine& engine)
+    {
+        for (float dry : { 0.0f, 0.5f })
+        {
+            runAirWindowsBenchmark<AirWindowsConsole5Channel> (engine, 2, dry);
+            runAirWindowsBenchmark<AirWindowsConsole5Buss> (engine, 2, dry);
+        }
+
+        runAirWindowsBenchmark<AirWindowsConsole5Channel> (engine, 1, 0.0f);
+    }
+
+    template<typename AirWindowsType>
+    void runAirWindowsBenchmark (Engine& engine, int numChannels, float dry)
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = 1000;
+
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto state = createValueTree (IDs::PLUGIN,
+                                      IDs::type, AirWindowsType::xmlTypeName);
+        juce::ReferenceCountedObjectPtr<AirWindowsType> plugin (new AirWindowsType (PluginCreationInfo (*edit, state, true)));
+        plugin->dryGain->setParameter (dry, juce::dontSendNotification);
+        plugin->baseClassInitialise ({ 0_tp, sampleRate, blockSize });
+
+        // Some quiet noise so the algorithms aren't processing silence
+        juce::AudioBuffer<float> noise (numChannels, blockSize), buffer (numChannels, blockSize);
+        juce::Random r (42);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample (c, i, r.nextFloat() * 0.5f - 0.25f);
+
+        const ScopedBenchmark sb (createBenchmarkDescription ("Plugins",
+                                                              juce::String ("AirWindows").toStdString(),
+                                                              juce::String ("Processing NAME, CC channel(s), dry DDD")
+                                                                .replace ("NAME", AirWindowsType::getPluginName())
+                                                                .replace ("CC", juce::String (numChannels))
+                                                                .replace ("DDD", juce::String (dry)).toStdString()));
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const auto blockTime = TimeRange (TimePosition::fromSamples (block * blockSize, sampleRate),
+                                              TimeDuration::fromSamples (blockSize, sampleRate));
+
+            buffer.makeCopyOf (noise, true);
+            plugin->applyToBuffer (PluginRenderContext (&buffer, juce::AudioChannelSet::canonicalChannelSet (numChannels), 0, blockSize,
+                                                        nullptr, 0.0, blockTime, true, false, false, false));
+        }
+
+        plugin->baseClassDeinitialise();
+    }
+
+    void runReverbBenchmarks (Engine& engine)
+    {
+        for (auto algorithm : { ReverbPlugin::Algorithm::freeverb, ReverbPlugin::Algorithm::feedbackDelayNetwork })
+            runReverbBenchmark (engine, algorithm);
+    }
+
+    void runReverbBenchmark (Engine& engine, ReverbPlugin::Algorithm algorithm)
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = 1000;
+
+        auto edit = Edit::createSingleTrackEdit (engine);
+        auto plugin = edit->getPluginCache().createNewPlugin (ReverbPlugin::xmlTypeName, {});
+        auto reverb = dynamic_cast<ReverbPlugin*> (plugin.get());
+        jassert (reverb != nullptr);
+
+        reverb->setAlgorithm (algorithm);
+        reverb->baseClassInitialise ({ 0_tp, sampleRate, blockSize });
+
+        // Some quiet noise so the reverb never goes silent
+        juce::AudioBuffer<float> noise (2, blockSize), buffer (2, blockSize);
+        juce::Random r (42);
+
+        for (int c = 0; c < 2; ++c)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample (c, i, r.nextFloat() * 0.5f - 0.25f);
+
+        const ScopedBenchmark sb (createBenchmarkDescription ("Plugins",
+                                                              juce::String ("Reverb").toStdString(),
+                                                              juce::String ("Processing stereo with the NAME algorithm")
+                                                                .replace ("NAME", algorithm == ReverbPlugin::Algorithm::freeverb ? "freeverb"
+                                                                                                                                 : "feedback delay network").toStdString()));
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const auto blockTime = TimeRange (TimePosition::fromSamples (block * blockSize, sampleRate),
+                                              TimeDuration::fromSamples (blockSize, sampleRate));
+
+            buffer.makeCopyOf (noise, true);
+            reverb->applyToBuffer (PluginRenderContext (&buffer, juce::AudioChannelSet::stereo(), 0, blockSize,
+                                                        nullptr, 0.0, blockTime, true, false, false, false));
+        }
+
+        reverb->baseClassDeinitialise();
+    }
 };
 
 static PluginNodeBenchmarks pluginNodeBenchmarks;
@@ -62,7 +62,11 @@ struct InputProvider
 //==============================================================================
 /**
     Simple processor for a Node which uses an InputProvider to pass input in to the graph.
-    This simply iterate all the nodes attempting to process them in a single thread.
+    The graph is processed by the NodePlayerType so this can be used to run a rack on its own.
+
+    N.B. During Edit playback this isn't used. The rack's Nodes are added to the Edit's graph
+    (see createNodeForRackType) so they're scheduled by the Edit's player along with everything
+    else and parallel chains in a rack can be processed on different threads.
 */
 template<typename NodePlayerType>
 class RackNodePlayer
@@ -48,6 +48,11 @@ bool SharedLevelMeasuringNode::isReadyToProcess()
     return input->hasProcessed();
 }
 
+bool SharedLevelMeasuringNode::canProcessSplitTimelineRanges()
+{
+    return true;
+}
+
 void SharedLevelMeasuringNode::prefetchBlock (juce::Range<int64_t> referenceSampleRange)
 {
     levelMeasurer->startNextBlock (tracktion::graph::sampleToTime (referenceSampleRange.getStart(), sampleRate));
@@ -46,6 +46,9 @@ SlotControlNode::SlotControlNode (ProcessState& ps,
 
         if (auto mn = dynamic_cast<LoopingMidiNode*> (n))
             midiNode = mn;
+
+        if (auto wn = dynamic_cast<WaveNodeRealTime*> (n))
+            waveNodes.push_back (wn);
     }
 }
 
@@ -59,6 +62,11 @@ const LaunchHandle* SlotControlNode::getLaunchHandleIfNotUnique() const
     return launchHandle.use_count() > 1 ? launchHandle.get() : nullptr;
 }
 
+void SlotControlNode::setPreloadsStart (bool shouldPreload)
+{
+    preloadsStart = shouldPreload;
+}
+
 tracktion::graph::NodeProperties SlotControlNode::getNodeProperties()
 {
     auto props = input->getNodeProperties();
@@ -81,6 +89,8 @@ void SlotControlNode::prepareToPlay (const tracktion::graph::PlaybackInitialisat
     for (auto& i : orderedNodes)
         i->initialise (info2);
 
+    keepStartReady();
+
     // Find the lastSamples
     const auto numChans = static_cast<size_t> (getNodeProperties().numberOfChannels);
 
@@ -349,6 +359,18 @@ void SlotControlNode::processStop (ProcessContext& pc, double timestampForMidiNo
         launchHandle->stop ({});
 
     launchHandle->advance (getProcessState().getSyncRange());
+
+    // Playing will have moved the upcoming positions on so point them back at the start
+    keepStartReady();
+}
+
+void SlotControlNode::keepStartReady()
+{
+    if (! preloadsStart)
+        return;
+
+    for (auto wn : waveNodes)
+        wn->keepStartReady();
 }
 
 }} // namespace tracktion { inline namespace engine
@@ -31,6 +31,12 @@ public:
     const LaunchHandle& getLaunchHandle() const;
     const LaunchHandle* getLaunchHandleIfNotUnique() const;
 
+    /** If enabled, the start of any audio in the slot is kept ready in the
+        AudioFileCache whilst it's stopped so it doesn't miss when launched.
+        @see SceneList::setPreloadedSceneRange
+    */
+    void setPreloadsStart (bool);
+
     //==============================================================================
     tracktion::graph::NodeProperties getNodeProperties() override;
     std::vector<Node*> getDirectInputNodes() override;
@@ -55,6 +61,8 @@ private:
     std::vector<DynamicallyOffsettableNodeBase*> offsetNodes;
     std::vector<Node*> orderedNodes, leafNodes;
     LoopingMidiNode* midiNode = nullptr;
+    std::vector<WaveNodeRealTime*> waveNodes;
+    bool preloadsStart = false;
     std::shared_ptr<std::vector<float>> lastSamples;
     BeatDuration lastOffset;
 
@@ -62,6 +70,7 @@ private:
     void processSection (ProcessContext&, BeatRange editBeatRange, TimeRange editTimeRange, BeatRange clipBeatRange,
                          bool isPlaying, std::optional<BeatPosition> playStartTime);
     void processStop (ProcessContext&, double timestampForMidiNoteOffs);
+    void keepStartReady();
 };
 
 }} // namespace tracktion { inline namespace engine
@@ -12,17 +12,6 @@ namespace tracktion { inline namespace engine
 {
 
 
-//==============================================================================
-//==============================================================================
-struct SpeedRampWaveNode::PerChannelState
-{
-    PerChannelState()    { resampler.reset(); }
-
-    juce::LagrangeInterpolator resampler;
-    float lastSample = 0;
-};
-
-
 //==============================================================================
 SpeedRampWaveNode::SpeedRampWaveNode (const AudioFile& af,
                                       TimeRange editTime,
@@ -71,15 +60,20 @@ tracktion::graph::NodeProperties SpeedRampWaveNode::getNodeProperties()
 void SpeedRampWaveNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
 {
     reader = audioFile.engine->getAudioFileManager().cache.createReader (audioFile);
+
+    if (reader != nullptr)
+        reader->setOwnerID (editItemID);
+
     outputSampleRate = info.sampleRate;
     editPositionInSamples = tracktion::toSamples ({ editPosition.getStart(), editPosition.getEnd() }, outputSampleRate);
     updateFileSampleRate();
 
-    channelState.clear();
+    createRampMap (rampInMap, speedFadeDescription.inTimeRange);
+    createRampMap (rampOutMap, speedFadeDescription.outTimeRange);
 
-    if (reader != nullptr)
-        for (int i = std::max (channelsToUse.size(), reader->getNumChannels()); --i >= 0;)
-            channelState.add (new PerChannelState());
+    frameIndexes.resize ((size_t) info.blockSize);
+    frameWeights.resize ((size_t) info.blockSize);
+    lastSamples.assign (reader != nullptr ? (size_t) std::max (channelsToUse.size(), reader->getNumChannels()) : 0, 0.0f);
 }
 
 bool SpeedRampWaveNode::isReadyToProcess()
@@ -117,7 +111,7 @@ void SpeedRampWaveNode::process (ProcessContext& pc)
 }
 
 //==============================================================================
-int64_t SpeedRampWaveNode::editTimeToFileSample (TimePosition editTime) const noexcept
+TimePosition SpeedRampWaveNode::getWarpedEditTime (TimePosition editTime) const noexcept
 {
     editTime = juce::jlimit (speedFadeDescription.inTimeRange.getStart(),
                              speedFadeDescription.outTimeRange.getEnd(),
@@ -148,8 +142,52 @@ int64_t SpeedRampWaveNode::editTimeToFileSample (TimePosition editTime) const no
         jassert (speedFadeDescription.outTimeRange.containsInclusive (editTime));
     }
 
-    return (int64_t) ((editTime - (editPosition.getStart() - offset)).inSeconds()
-                       * originalSpeedRatio * audioFileSampleRate + 0.5);
+    return editTime;
+}
+
+double SpeedRampWaveNode::getFilePosition (int64_t timelineSample) const noexcept
+{
+    double warpedTime;
+
+    if (rampInMap.timelineRange.contains (timelineSample))
+        warpedTime = rampInMap.getWarpedTime (timelineSample);
+    else if (rampOutMap.timelineRange.contains (timelineSample))
+        warpedTime = rampOutMap.getWarpedTime (timelineSample);
+    else
+        warpedTime = getWarpedEditTime (TimePosition::fromSamples (timelineSample, outputSampleRate)).inSeconds();
+
+    return (warpedTime - (editPosition.getStart() - offset).inSeconds()) * originalSpeedRatio * audioFileSampleRate;
+}
+
+void SpeedRampWaveNode::createRampMap (RampMap& map, TimeRange rampTimeRange)
+{
+    map.warpedTimes.clear();
+    map.timelineRange = {};
+
+    if (rampTimeRange.isEmpty())
+        return;
+
+    map.timelineRange = tracktion::toSamples (rampTimeRange, outputSampleRate);
+
+    // Includes a point past the end so every sample in the range has one either side of it
+    const auto numPoints = (size_t) (map.timelineRange.getLength() / rampMapInterval) + 2;
+    map.warpedTimes.reserve (numPoints);
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        const auto timelineSample = map.timelineRange.getStart() + (int64_t) i * rampMapInterval;
+        map.warpedTimes.push_back (getWarpedEditTime (TimePosition::fromSamples (timelineSample, outputSampleRate)).inSeconds());
+    }
+}
+
+double SpeedRampWaveNode::RampMap::getWarpedTime (int64_t timelineSample) const noexcept
+{
+    const auto position = timelineSample - timelineRange.getStart();
+    const auto index = (size_t) (position / rampMapInterval);
+    const auto alpha = (double) (position % rampMapInterval) / rampMapInterval;
+    jassert (index + 1 < warpedTimes.size());
+
+    return warpedTimes[index] + alpha * (warpedTimes[index + 1] - warpedTimes[index]);
 }
 
 bool SpeedRampWaveNode::updateFileSampleRate()
@@ -185,9 +223,18 @@ void SpeedRampWaveNode::processSection (ProcessContext& pc, juce::Range<int64_t>
     if (audioFileSampleRate == 0.0 && ! updateFileSampleRate())
         return;
 
-    const auto fileStart       = editTimeToFileSample (sectionEditTime.getStart());
-    const auto fileEnd         = editTimeToFileSample (sectionEditTime.getEnd());
-    const auto numFileSamples  = (int) (fileEnd - fileStart);
+    auto destBuffer = pc.buffers.audio;
+    auto numSamples = destBuffer.getNumFrames();
+
+    if (numSamples > frameIndexes.size())
+    {
+        jassertfalse; // Bigger than the block size this was prepared with
+        return;
+    }
+
+    const auto startPosition   = getFilePosition (timelineRange.getStart());
+    const auto endPosition     = getFilePosition (timelineRange.getEnd());
+    const auto numFileSamples  = (int) ((int64_t) (endPosition + 0.5) - (int64_t) (startPosition + 0.5));
 
     if (numFileSamples <= 3)
     {
@@ -195,22 +242,25 @@ void SpeedRampWaveNode::processSection (ProcessContext& pc, juce::Range<int64_t>
         return;
     }
 
-    reader->setReadPosition (fileStart);
+    // The interpolation needs a sample before and two after each position.
+    // As the speed is never negative, the positions only move forwards through the block.
+    const auto readStart = (int64_t) std::floor (startPosition) - 1;
+    const auto numToRead = (int) ((int64_t) std::floor (endPosition) - readStart) + 3;
+
+    reader->setReadPosition (readStart);
 
-    auto destBuffer = pc.buffers.audio;
-    auto numSamples = destBuffer.getNumFrames();
     const auto destBufferChannels = juce::AudioChannelSet::canonicalChannelSet ((int) destBuffer.getNumChannels());
     auto numChannels = (choc::buffer::ChannelCount) destBufferChannels.size();
     assert (pc.buffers.audio.getNumChannels() == numChannels);
 
-    AudioScratchBuffer fileData ((int) numChannels, numFileSamples + 2);
+    AudioScratchBuffer fileData ((int) numChannels, numToRead);
 
     uint32_t lastSampleFadeLength = 0;
 
     {
         SCOPED_REALTIME_CHECK
 
-        if (reader->readSamples (numFileSamples + 2, fileData.buffer, destBufferChannels, 0,
+        if (reader->readSamples (numToRead, fileData.buffer, destBufferChannels, 0,
                                  channelsToUse,
                                  isOfflineRender ? 5000 : 3))
         {
@@ -243,28 +293,49 @@ void SpeedRampWaveNode::processSection (ProcessContext& pc, juce::Range<int64_t>
     if (ratio <= 0.0)
         return;
 
-    jassert ((int) numChannels <= channelState.size()); // this should always have been made big enough
+    // Work out the 4-point Lagrange weights for each frame once, then apply them to every channel
+    for (choc::buffer::FrameCount i = 0; i < numSamples; ++i)
+    {
+        const auto position = getFilePosition (timelineRange.getStart() + (int64_t) i) - (double) readStart;
+        const auto index = juce::jlimit (1, numToRead - 3, (int) position);
+        const auto x = (float) (position - index);
+
+        frameIndexes[i] = index - 1;
+        frameWeights[i] = { -x * (x - 1.0f) * (x - 2.0f) / 6.0f,
+                            (x + 1.0f) * (x - 1.0f) * (x - 2.0f) / 2.0f,
+                            -(x + 1.0f) * x * (x - 2.0f) / 2.0f,
+                            (x + 1.0f) * x * (x - 1.0f) / 6.0f };
+    }
+
+    jassert (numChannels <= lastSamples.size()); // this should always have been made big enough
 
     for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
     {
-        if (channel < (choc::buffer::ChannelCount) channelState.size())
+        if (channel < (choc::buffer::ChannelCount) lastSamples.size())
         {
             const auto src = fileData.buffer.getReadPointer ((int) channel);
             const auto dest = destBuffer.getChannel (channel).data.data;
+            const auto gain = gains[channel & 1];
+
+            for (choc::buffer::FrameCount i = 0; i < numSamples; ++i)
+            {
+                const auto s = src + frameIndexes[i];
+                const auto& w = frameWeights[i];
+                dest[i] += gain * (w[0] * s[0] + w[1] * s[1] + w[2] * s[2] + w[3] * s[3]);
+            }
 
-            auto& state = *channelState.getUnchecked ((int) channel);
-            state.resampler.processAdding (ratio, src, dest, (int) numSamples, gains[channel & 1]);
+            auto& lastSample = lastSamples[channel];
 
             if (lastSampleFadeLength > 0)
             {
                 for (uint32_t i = 0; i < lastSampleFadeLength; ++i)
                 {
                     auto alpha = i / (float) lastSampleFadeLength;
-                    dest[i] = alpha * dest[i] + state.lastSample * (1.0f - alpha);
+                    dest[i] = alpha * dest[i] + lastSample * (1.0f - alpha);
                 }
             }
 
-            state.lastSample = dest[numSamples - 1];
+            lastSample = dest[numSamples - 1];
         }
         else
         {
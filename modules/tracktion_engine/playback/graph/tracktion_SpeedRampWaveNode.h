@@ -29,7 +29,11 @@ struct SpeedFadeDescription
 
 //==============================================================================
 //==============================================================================
-/** An Node that plays back a wave file. */
+/** An Node that plays back a wave file with its speed ramping up or down at the start or end.
+
+    The position in the file during each ramp is precomputed when the Node is prepared
+    so processing only has to look it up and resample every channel in a single pass.
+*/
 class SpeedRampWaveNode final   : public tracktion::graph::Node,
                                   public TracktionEngineNode
 {
@@ -57,6 +61,9 @@ public:
 
     ~SpeedRampWaveNode() override;
 
+    /** Returns the EditItemID to identify this Node. */
+    EditItemID getItemID() const                            { return editItemID; }
+
     //==============================================================================
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
@@ -79,12 +86,28 @@ private:
     const juce::AudioChannelSet channelsToUse, destChannels;
     AudioFileCache::Reader::Ptr reader;
 
-    struct PerChannelState;
-    juce::OwnedArray<PerChannelState> channelState;
+    /** The warped edit time, i.e. the integral of the speed, at regular intervals across a ramp. */
+    struct RampMap
+    {
+        juce::Range<int64_t> timelineRange;
+        std::vector<double> warpedTimes;
+
+        double getWarpedTime (int64_t timelineSample) const noexcept;
+    };
+
+    static constexpr int rampMapInterval = 16;
+    RampMap rampInMap, rampOutMap;
+
+    // Working space for a block, sized when the Node is prepared
+    std::vector<int> frameIndexes;
+    std::vector<std::array<float, 4>> frameWeights;
+    std::vector<float> lastSamples;
     bool playedLastBlock = false;
 
     //==============================================================================
-    int64_t editTimeToFileSample (TimePosition) const noexcept;
+    TimePosition getWarpedEditTime (TimePosition) const noexcept;
+    double getFilePosition (int64_t timelineSample) const noexcept;
+    void createRampMap (RampMap&, TimeRange rampTimeRange);
     bool updateFileSampleRate();
     void processSection (ProcessContext&, juce::Range<int64_t> timelineRange);
 
@@ -0,0 +1,69 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+StemTapNode::StemTapNode (std::unique_ptr<tracktion::graph::Node> inputNode, EditItemID trackID_)
+    : input (std::move (inputNode)),
+      trackID (trackID_)
+{
+    jassert (input != nullptr);
+
+    setOptimisations ({ tracktion::graph::ClearBuffers::no,
+                        tracktion::graph::AllocateAudioBuffer::no });
+}
+
+choc::buffer::ChannelArrayView<float> StemTapNode::getLastBlock() const
+{
+    return lastBlock.getView().getStart (numFramesInLastBlock);
+}
+
+//==============================================================================
+tracktion::graph::NodeProperties StemTapNode::getNodeProperties()
+{
+    auto props = input->getNodeProperties();
+    props.nodeID = 0;
+
+    return props;
+}
+
+std::vector<tracktion::graph::Node*> StemTapNode::getDirectInputNodes()
+{
+    return { input.get() };
+}
+
+void StemTapNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
+{
+    const auto numChannels = std::max (1, input->getNodeProperties().numberOfChannels);
+    lastBlock.resize ({ (choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) info.blockSize });
+    numFramesInLastBlock = 0;
+}
+
+bool StemTapNode::isReadyToProcess()
+{
+    return input->hasProcessed();
+}
+
+void StemTapNode::process (ProcessContext& pc)
+{
+    auto sourceBuffers = input->getProcessedOutput();
+    jassert (sourceBuffers.audio.getNumFrames() <= lastBlock.getNumFrames());
+
+    numFramesInLastBlock = std::min (sourceBuffers.audio.getNumFrames(), lastBlock.getNumFrames());
+    copyIntersectionAndClearOutside (lastBlock.getView().getStart (numFramesInLastBlock), sourceBuffers.audio);
+
+    pc.buffers.midi.copyFrom (sourceBuffers.midi);
+    setAudioOutput (input.get(), sourceBuffers.audio);
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,52 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A Node that passes its input straight through but keeps a copy of the audio
+    from the last block it processed.
+
+    This is used to capture the output of individual tracks when rendering stems
+    in a single pass.
+    @see Renderer::Parameters::stems
+*/
+class StemTapNode final : public tracktion::graph::Node
+{
+public:
+    StemTapNode (std::unique_ptr<tracktion::graph::Node>, EditItemID trackID);
+
+    /** Returns the ID of the track whose output this is capturing. */
+    EditItemID getTrackID() const                   { return trackID; }
+
+    /** Returns the audio from the last block processed.
+        This is only valid until the next block is processed.
+    */
+    choc::buffer::ChannelArrayView<float> getLastBlock() const;
+
+    //==============================================================================
+    tracktion::graph::NodeProperties getNodeProperties() override;
+    std::vector<Node*> getDirectInputNodes() override;
+    void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
+    bool isReadyToProcess() override;
+    void process (ProcessContext&) override;
+
+private:
+    //==============================================================================
+    std::unique_ptr<tracktion::graph::Node> input;
+    const EditItemID trackID;
+    choc::buffer::ChannelArrayBuffer<float> lastBlock;
+    choc::buffer::FrameCount numFramesInLastBlock = 0;
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -43,6 +43,31 @@ std::vector<tracktion::graph::Node*> TimedMutingNode::getDirectInputNodes()
 void TimedMutingNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
 {
     sampleRate = info.sampleRate;
+
+    muteRanges.clear();
+    muteRanges.reserve ((size_t) muteTimes.size());
+
+    for (auto r : muteTimes)
+        if (auto sampleRange = toSamples (r, sampleRate); ! sampleRange.isEmpty())
+            muteRanges.push_back (sampleRange);
+
+    std::sort (muteRanges.begin(), muteRanges.end(),
+               [] (auto& a, auto& b) { return a.getStart() < b.getStart(); });
+
+    // Merge any ranges that overlap or touch so their ends are sorted too
+    std::vector<juce::Range<int64_t>> merged;
+    merged.reserve (muteRanges.size());
+
+    for (auto r : muteRanges)
+    {
+        if (! merged.empty() && r.getStart() <= merged.back().getEnd())
+            merged.back() = merged.back().getUnionWith (r);
+        else
+            merged.push_back (r);
+    }
+
+    muteRanges = std::move (merged);
+    nextMuteRange = 0;
 }
 
 bool TimedMutingNode::isReadyToProcess()
@@ -68,53 +93,57 @@ void TimedMutingNode::process (ProcessContext& pc)
         return;
     }
 
+    moveCursorTo (timelineRange.getStart());
+
+    if (! hasMutesIn (timelineRange))
+    {
+        setAudioOutput (input.get(), sourceBuffers.audio);
+        return;
+    }
+
     copy (destAudioBlock, sourceBuffers.audio);
-    processSection (destAudioBlock, tracktion::timeRangeFromSamples (timelineRange, sampleRate));
+    processSection (destAudioBlock, timelineRange);
 }
 
-void TimedMutingNode::processSection (choc::buffer::ChannelArrayView<float> view, TimeRange editTime)
+void TimedMutingNode::moveCursorTo (int64_t timelineSample)
 {
-    for (auto r : muteTimes)
+    const bool hasJumpedBack = nextMuteRange > 0 && muteRanges[nextMuteRange - 1].getEnd() > timelineSample;
+    const bool hasPassedNext = nextMuteRange < muteRanges.size() && muteRanges[nextMuteRange].getEnd() <= timelineSample;
+
+    // Playing forwards, this only has to search once each time a range has been passed
+    if (hasJumpedBack || hasPassedNext)
+        nextMuteRange = (size_t) std::distance (muteRanges.begin(),
+                                                std::upper_bound (muteRanges.begin(), muteRanges.end(), timelineSample,
+                                                                  [] (int64_t sample, auto& r) { return sample < r.getEnd(); }));
+}
+
+bool TimedMutingNode::hasMutesIn (juce::Range<int64_t> timelineRange) const
+{
+    return nextMuteRange < muteRanges.size()
+        && muteRanges[nextMuteRange].getStart() < timelineRange.getEnd();
+}
+
+void TimedMutingNode::processSection (choc::buffer::ChannelArrayView<float> view, juce::Range<int64_t> timelineRange)
+{
+    for (auto i = nextMuteRange; i < muteRanges.size(); ++i)
     {
-        if (r.overlaps (editTime))
-        {
-            auto mute = r.getIntersectionWith (editTime);
-
-            if (! mute.isEmpty())
-            {
-                if (mute == editTime)
-                {
-                    view.clear();
-                }
-                else if (editTime.contains (mute))
-                {
-                    auto startSample = tracktion::toSamples (mute.getStart() - editTime.getStart(), sampleRate);
-                    auto numSamples  = tracktion::toSamples (mute.getLength(), sampleRate);
-                    muteSection (view, startSample, numSamples);
-                }
-                else if (mute.getEnd() <= editTime.getEnd())
-                {
-                    auto numSamples = tracktion::toSamples (editTime.getEnd() - mute.getEnd(), sampleRate);
-                    muteSection (view, 0, numSamples);
-                }
-                else if (mute.getStart() >= editTime.getStart())
-                {
-                    auto startSample = tracktion::toSamples (mute.getStart() - editTime.getStart(), sampleRate);
-                    muteSection (view, startSample, choc::buffer::FrameCount (view.getNumFrames()) - startSample);
-                }
-            }
-        }
-
-        if (r.getEnd() >= editTime.getEnd())
+        const auto& r = muteRanges[i];
+
+        if (r.getStart() >= timelineRange.getEnd())
             return;
+
+        const auto mute = r.getIntersectionWith (timelineRange);
+        muteSection (view, mute.getStart() - timelineRange.getStart(), mute.getLength());
     }
 }
 
 void TimedMutingNode::muteSection (choc::buffer::ChannelArrayView<float> block, int64_t startSample, int64_t numSamples)
 {
-    if (numSamples > 0)
+    const auto endSample = std::min (startSample + numSamples, (int64_t) block.getNumFrames());
+
+    if (endSample > startSample)
         block.getFrameRange ({ (choc::buffer::FrameCount) startSample,
-                               (choc::buffer::FrameCount) (startSample + numSamples) }).clear();
+                               (choc::buffer::FrameCount) endSample }).clear();
 }
 
 }} // namespace tracktion { inline namespace engine
@@ -15,6 +15,10 @@ namespace tracktion { inline namespace engine
 //==============================================================================
 /**
     A Node that mutes its input at specific time ranges.
+
+    The ranges are compiled to sorted sample ranges when the Node is prepared and
+    a cursor follows the playhead through them, so blocks without any mutes in
+    them just pass on their input, however many ranges there are.
 */
 class TimedMutingNode final : public tracktion::graph::Node
 {
@@ -37,8 +41,13 @@ private:
     juce::Array<TimeRange> muteTimes;
     double sampleRate = 44100.0;
 
+    std::vector<juce::Range<int64_t>> muteRanges;   // Sorted, non-overlapping timeline sample ranges
+    size_t nextMuteRange = 0;                       // The first range that ends after the last block started
+
     //==============================================================================
-    void processSection (choc::buffer::ChannelArrayView<float>, TimeRange);
+    void moveCursorTo (int64_t timelineSample);
+    bool hasMutesIn (juce::Range<int64_t> timelineRange) const;
+    void processSection (choc::buffer::ChannelArrayView<float>, juce::Range<int64_t> timelineRange);
     void muteSection (choc::buffer::ChannelArrayView<float>, int64_t startSample, int64_t numSamples);
 };
 
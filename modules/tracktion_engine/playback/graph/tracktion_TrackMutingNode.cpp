@@ -24,17 +24,32 @@ TrackMuteState::TrackMuteState (Track& t, bool muteForInputsWhenRecording, bool
                 if (in->isRecordingActive (t.itemID) && in->getTargets().contains (at->itemID))
                     inputDevicesToMuteFor.add (in);
 
+    lastMuteSoloStatusVersion = edit.getMuteSoloStatusVersion();
     wasBeingPlayedFlag = t.shouldBePlayed();
 }
 
 TrackMuteState::TrackMuteState (Edit& e)
     : edit (e)
 {
-    wasBeingPlayedFlag = ! edit.areAnyTracksSolo();
+    lastMuteSoloStatusVersion = edit.getMuteSoloStatusVersion();
+    wasBeingPlayedFlag = ! edit.wereAnyTracksSoloAtLastUpdate();
 }
 
 void TrackMuteState::update()
 {
+    const auto version = edit.getMuteSoloStatusVersion();
+
+    // Mute/solo changes bump the Edit's version so there's nothing to check until
+    // it changes, unless the inputs recording to this track can mute it at any time
+    if (inputDevicesToMuteFor.isEmpty() && version == lastMuteSoloStatusVersion)
+    {
+        wasJustMutedFlag.store (false, std::memory_order_release);
+        wasJustUnMutedFlag.store (false, std::memory_order_release);
+        return;
+    }
+
+    lastMuteSoloStatusVersion = version;
+
     const bool isPlayingNow = isBeingPlayed();
     wasJustMutedFlag.store (wasBeingPlayedFlag && ! isPlayingNow, std::memory_order_release);
     wasJustUnMutedFlag.store (! wasBeingPlayedFlag && isPlayingNow, std::memory_order_release);
@@ -58,7 +73,7 @@ bool TrackMuteState::shouldTrackMidiBeProcessed() const
 
 bool TrackMuteState::isBeingPlayed() const
 {
-    bool playing = track != nullptr ? track->shouldBePlayed() : ! edit.areAnyTracksSolo();
+    bool playing = track != nullptr ? track->shouldBePlayed() : ! edit.wereAnyTracksSoloAtLastUpdate();
 
     if (! playing)
         return false;
@@ -130,6 +145,11 @@ bool TrackMutingNode::isReadyToProcess()
     return input->hasProcessed();
 }
 
+bool TrackMutingNode::canProcessSplitTimelineRanges()
+{
+    return true;
+}
+
 void TrackMutingNode::prefetchBlock (juce::Range<int64_t>)
 {
     trackMuteState->update();
@@ -161,11 +181,14 @@ void TrackMutingNode::process (ProcessContext& pc)
             copyIfNotAliased (destAudioView, sourceBuffers.audio);
         else
             setAudioOutput (input.get(), sourceBuffers.audio);
+
+        pc.buffers.isAudioSilent = sourceBuffers.isAudioSilent;
     }
     else
     {
         destAudioView.clear();
         pc.buffers.midi.clear();
+        pc.buffers.isAudioSilent = true;
     }
 
     if (wasJustMuted)
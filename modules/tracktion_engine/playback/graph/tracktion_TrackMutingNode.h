@@ -25,7 +25,10 @@ public:
     */
     TrackMuteState (Edit&);
 
-    /** Call once per block to update the mute status. */
+    /** Call once per block to update the mute status.
+        Unless the track is being recorded into, this only checks the track again
+        when the Edit's mute/solo statuses have changed.
+    */
     void update();
 
     //==============================================================================
@@ -54,6 +57,7 @@ private:
     Edit& edit;
     juce::ReferenceCountedObjectPtr<Track> track;
     bool wasBeingPlayedFlag = false;
+    uint32_t lastMuteSoloStatusVersion = 0;
     std::atomic<bool> wasJustMutedFlag { false }, wasJustUnMutedFlag { false };
 
     bool callInputWhileMuted = false;
@@ -82,6 +86,7 @@ public:
     std::vector<Node*> getDirectInputNodes() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
+    bool canProcessSplitTimelineRanges() override;
     void prefetchBlock (juce::Range<int64_t>) override;
     void preProcess (choc::buffer::FrameCount, juce::Range<int64_t>) override;
     void process (ProcessContext&) override;
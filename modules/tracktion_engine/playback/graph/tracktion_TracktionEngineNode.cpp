@@ -30,10 +30,13 @@ ProcessState::ProcessState (tracktion::graph::PlayHeadState& phs, const tempo::S
 
 void ProcessState::update (double newSampleRate, juce::Range<int64_t> newReferenceSampleRange, UpdateContinuityFlags updateContinuityFlags)
 {
-    if (sampleRate != newSampleRate)
-        playHeadState.playHead.setScrubbingBlockLength (toSamples (TimeDuration (0.08s), newSampleRate));
+    if (updatesPlayHead)
+    {
+        if (sampleRate != newSampleRate)
+            playHeadState.playHead.setScrubbingBlockLength (toSamples (TimeDuration (0.08s), newSampleRate));
 
-    playHeadState.playHead.setReferenceSampleRange (newReferenceSampleRange);
+        playHeadState.playHead.setReferenceSampleRange (newReferenceSampleRange);
+    }
 
     if (updateContinuityFlags == UpdateContinuityFlags::yes)
         playHeadState.update (newReferenceSampleRange);
@@ -50,6 +53,11 @@ void ProcessState::update (double newSampleRate, juce::Range<int64_t> newReferen
 
     editTimeRange = timeRangeFromSamples (timelineSampleRange, sampleRate);
 
+    numTimelineSections = 1;
+    auto& section = timelineSections[0];
+    section = { 0, numSamples, referenceSampleRange, timelineSampleRange, editTimeRange, editBeatRange,
+                playHeadState.playheadJumped, playHeadState.firstBlockOfLoop, playHeadState.lastBlockOfLoop };
+
     if (! tempoPosition)
         return;
 
@@ -58,6 +66,7 @@ void ProcessState::update (double newSampleRate, juce::Range<int64_t> newReferen
     tempoPosition->set (editTimeRange.getEnd());
     const auto beatEnd = tempoPosition->getBeats();
     editBeatRange = { beatStart, beatEnd };
+    section.editBeatRange = editBeatRange;
 
     if (updateContinuityFlags == UpdateContinuityFlags::no)
         return;
@@ -82,6 +91,63 @@ void ProcessState::update (double newSampleRate, juce::Range<int64_t> newReferen
         onContinuityUpdated();
 }
 
+void ProcessState::updateForSplitTimelineRange (double newSampleRate, juce::Range<int64_t> newReferenceSampleRange)
+{
+    if (updatesPlayHead)
+        playHeadState.playHead.setReferenceSampleRange (newReferenceSampleRange);
+
+    const auto splitTimelineRange = referenceSampleRangeToSplitTimelineRange (playHeadState.playHead, newReferenceSampleRange);
+
+    if (! splitTimelineRange.isSplit)
+    {
+        update (newSampleRate, newReferenceSampleRange, UpdateContinuityFlags::yes);
+        return;
+    }
+
+    // Update each side in turn so the continuity and sync range progress as they
+    // would if the sides were processed separately
+    const auto firstRangeLength = splitTimelineRange.timelineRange1.getLength();
+    const std::array<juce::Range<int64_t>, 2> referenceRanges { newReferenceSampleRange.withLength (firstRangeLength),
+                                                                 newReferenceSampleRange.withStart (newReferenceSampleRange.getStart() + firstRangeLength) };
+    std::array<TimelineSection, 2> sections;
+    std::array<SyncRange, 2> syncRanges;
+
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        update (newSampleRate, referenceRanges[i], UpdateContinuityFlags::yes);
+        sections[i] = timelineSections[0];
+        syncRanges[i] = getSyncRange();
+    }
+
+    sections[1].startSample = sections[0].numSamples;
+    timelineSections = sections;
+    numTimelineSections = 2;
+
+    // Nodes that don't look at the sections see a block running on from the start
+    // of the first one, with the play head flags of the start of the block
+    numSamples = (int) newReferenceSampleRange.getLength();
+    referenceSampleRange = newReferenceSampleRange;
+    timelineSampleRange = sections[0].timelineSampleRange.withLength (newReferenceSampleRange.getLength());
+    editTimeRange = timeRangeFromSamples (timelineSampleRange, sampleRate);
+    editBeatRange = BeatRange (sections[0].editBeatRange.getStart(),
+                               sections[0].editBeatRange.getLength() + sections[1].editBeatRange.getLength());
+
+    playHeadState.playheadJumped = sections[0].playheadJumped;
+    playHeadState.firstBlockOfLoop = sections[0].firstBlockOfLoop;
+    playHeadState.lastBlockOfLoop = sections[0].lastBlockOfLoop;
+
+    if (updatesPlayHead)
+        playHeadState.playHead.setReferenceSampleRange (newReferenceSampleRange);
+
+    if (tempoPosition)
+        syncRange.store ({ syncRanges[0].start, syncRanges[1].end });
+}
+
+std::span<const ProcessState::TimelineSection> ProcessState::getTimelineSections() const
+{
+    return { timelineSections.data(), numTimelineSections };
+}
+
 void ProcessState::setPlaybackSpeedRatio (double newRatio)
 {
     playbackSpeedRatio = newRatio;
@@ -100,6 +166,27 @@ void ProcessState::setTempoSequence (const tempo::Sequence* ts)
         tempoPosition.reset();
 }
 
+void ProcessState::setUpcomingJumpPosition (std::optional<TimePosition> pos)
+{
+    if (pos)
+        upcomingJumpPosition.store (pos->inSeconds(), std::memory_order_relaxed);
+
+    hasUpcomingJumpPosition.store (pos.has_value(), std::memory_order_release);
+}
+
+std::optional<TimePosition> ProcessState::getUpcomingJumpPosition() const
+{
+    if (! hasUpcomingJumpPosition.load (std::memory_order_acquire))
+        return {};
+
+    return TimePosition::fromSeconds (upcomingJumpPosition.load (std::memory_order_relaxed));
+}
+
+void ProcessState::setUpdatesPlayHead (bool shouldUpdatePlayHead)
+{
+    updatesPlayHead = shouldUpdatePlayHead;
+}
+
 const tempo::Sequence* ProcessState::getTempoSequence() const
 {
     return tempoSequence;
@@ -161,6 +248,37 @@ std::optional<BeatPosition> TracktionEngineNode::getBeatOfNextChange() const
     return {};
 }
 
+std::array<std::optional<TimePosition>, 2> TracktionEngineNode::getUpcomingJumpPositions()
+{
+    std::array<std::optional<TimePosition>, 2> positions;
+    positions[0] = processState->getUpcomingJumpPosition();
+    auto& playHead = getPlayHead();
+
+    if (! positions[0] && playHead.isStopped())
+        positions[0] = TimePosition::fromSamples (playHead.getPosition(), getSampleRate());
+
+    if (playHead.isLooping())
+        positions[1] = TimePosition::fromSamples (playHead.getLoopRange().getStart(), getSampleRate());
+
+    return positions;
+}
+
+std::optional<TimePosition> TracktionEngineNode::getUpcomingStartInRange (std::optional<TimePosition> jumpPosition, TimeRange range,
+                                                                          TimeDuration maxLeadIn)
+{
+    if (! jumpPosition)
+        return {};
+
+    if (range.contains (*jumpPosition))
+        return jumpPosition;
+
+    if (*jumpPosition < range.getStart()
+        && range.getStart() - *jumpPosition < maxLeadIn)
+        return range.getStart();
+
+    return {};
+}
+
 void TracktionEngineNode::setProcessState (ProcessState& newProcessState)
 {
     processState = &newProcessState;
@@ -40,6 +40,32 @@ struct ProcessState
     */
     void update (double sampleRate, juce::Range<int64_t> referenceSampleRange, UpdateContinuityFlags);
 
+    /** Updates the state for a block where the timeline wraps around part way
+        through, e.g. at a loop end, so the graph can process it in a single pass.
+        This updates the continuity for each side of the wrap and stores them as
+        the two timeline sections. The block-wide fields cover the whole reference
+        range, running on from the start of the first section.
+        Only Nodes that return true from canProcessSplitTimelineRanges should be
+        processed with this state. @see TracktionEngineNode::forEachTimelineSection
+    */
+    void updateForSplitTimelineRange (double sampleRate, juce::Range<int64_t> referenceSampleRange);
+
+    /** Describes a part of the block that covers a contiguous timeline range. */
+    struct TimelineSection
+    {
+        int startSample = 0, numSamples = 0;    ///< The samples of the block this section covers
+        juce::Range<int64_t> referenceSampleRange, timelineSampleRange;
+        TimeRange editTimeRange;
+        BeatRange editBeatRange;
+        bool playheadJumped = false, firstBlockOfLoop = false, lastBlockOfLoop = false;
+    };
+
+    /** Returns the sections of the current block.
+        This is a single section covering the whole block unless the state was last
+        updated with updateForSplitTimelineRange, in which case there are two.
+    */
+    std::span<const TimelineSection> getTimelineSections() const;
+
     /** Sets a playback speed ratio.
         Some Nodes might use this to adjust their playback speeds.
     */
@@ -69,6 +95,22 @@ struct ProcessState
     */
     SyncPoint getSyncPoint() const;
 
+    /** Sets a position the playhead is expected to jump to soon, e.g. a pending
+        TransportControl position change. Nodes that stream from disk can use this
+        to start reading the audio there before the jump happens.
+        Pass an empty optional to clear it. This can be called from any thread.
+    */
+    void setUpcomingJumpPosition (std::optional<TimePosition>);
+
+    /** Returns the position set by setUpcomingJumpPosition, if there is one. */
+    std::optional<TimePosition> getUpcomingJumpPosition() const;
+
+    /** By default, update also sets the PlayHead's reference sample range.
+        A state used to process ahead of the PlayHead (e.g. by an AnticipativeRenderNode)
+        should disable this as the PlayHead is driven by the audio callback's player.
+    */
+    void setUpdatesPlayHead (bool);
+
     /** Callback which can be set to be called when the continuity changes.
         This will be made on the audio thread so shouldn't block.
     */
@@ -85,9 +127,14 @@ struct ProcessState
     BeatRange editBeatRange;
 
 private:
+    std::array<TimelineSection, 2> timelineSections;
+    size_t numTimelineSections = 1;
     const tempo::Sequence* tempoSequence = nullptr;
     std::unique_ptr<tempo::Sequence::Position> tempoPosition;
     crill::seqlock_object<SyncRange> syncRange { SyncRange() };
+    std::atomic<double> upcomingJumpPosition { 0.0 };
+    std::atomic<bool> hasUpcomingJumpPosition { false };
+    bool updatesPlayHead = true;
 };
 
 
@@ -107,23 +154,37 @@ public:
     virtual ~TracktionEngineNode() = default;
 
     //==============================================================================
-    /** Returns the number of samples in the current process block. */
-    int getNumSamples() const                               { return processState->numSamples; }
+    /** Returns the number of samples in the current process block.
+        Inside forEachTimelineSection, the ranges and flags are those of the current section.
+    */
+    int getNumSamples() const                               { return currentSection != nullptr ? currentSection->numSamples : processState->numSamples; }
 
     /** Returns the sample rate of the current process block. */
     double getSampleRate() const                            { return processState->sampleRate; }
 
     /** Returns the timeline sample range of the current process block. */
-    juce::Range<int64_t> getTimelineSampleRange() const     { return processState->timelineSampleRange; }
+    juce::Range<int64_t> getTimelineSampleRange() const     { return currentSection != nullptr ? currentSection->timelineSampleRange : processState->timelineSampleRange; }
 
     /** Returns the edit time range of the current process block. */
-    TimeRange getEditTimeRange() const                      { return processState->editTimeRange; }
+    TimeRange getEditTimeRange() const                      { return currentSection != nullptr ? currentSection->editTimeRange : processState->editTimeRange; }
 
     /** Returns the edit beat range of the current process block. */
-    BeatRange getEditBeatRange() const                      { return processState->editBeatRange; }
+    BeatRange getEditBeatRange() const                      { return currentSection != nullptr ? currentSection->editBeatRange : processState->editBeatRange; }
 
     /** Returns the reference sample range (from the DeviceManager) of the current process block. */
-    juce::Range<int64_t> getReferenceSampleRange() const    { return processState->referenceSampleRange; }
+    juce::Range<int64_t> getReferenceSampleRange() const    { return currentSection != nullptr ? currentSection->referenceSampleRange : processState->referenceSampleRange; }
+
+    /** Returns true if the play head didn't jump and the current block follows on from the previous one. */
+    bool isContiguousWithPreviousBlock() const              { return ! (didPlayheadJump() || isFirstBlockOfLoop()); }
+
+    /** Returns true if the play head jumped before the current block. */
+    bool didPlayheadJump() const                            { return currentSection != nullptr ? currentSection->playheadJumped : processState->playHeadState.playheadJumped; }
+
+    /** Returns true if the current block is the first block of a loop. */
+    bool isFirstBlockOfLoop() const                         { return currentSection != nullptr ? currentSection->firstBlockOfLoop : processState->playHeadState.firstBlockOfLoop; }
+
+    /** Returns true if the current block is the last block of a loop. */
+    bool isLastBlockOfLoop() const                          { return currentSection != nullptr ? currentSection->lastBlockOfLoop : processState->playHeadState.lastBlockOfLoop; }
 
     /** Returns the key of the current process block. */
     tempo::Key getKey() const;
@@ -138,6 +199,72 @@ public:
     /** May return the time of the next tempo or time sig change. */
     std::optional<BeatPosition> getBeatOfNextChange() const;
 
+    /** Returns the edit times playback is expected to jump to soon.
+        These are a pending position change and, if looping, the start of the loop.
+        While stopped, the first is the playhead's position as that's where playback
+        will start from.
+        Nodes that stream from disk can use these to start reading before the jump.
+        @see ProcessState::setUpcomingJumpPosition
+    */
+    std::array<std::optional<TimePosition>, 2> getUpcomingJumpPositions();
+
+    /** The default for how far after a jump position items are prepared to play. */
+    static constexpr TimeDuration defaultUpcomingLeadIn = TimeDuration::fromSeconds (2.0);
+
+    /** Returns the time an item in the given range will start playing from if
+        playback jumps to a position returned by getUpcomingJumpPositions.
+        This is the position itself if it's in the range, or the start of the range
+        if it begins less than maxLeadIn after it, so items that start just after
+        the playhead can also be ready to play.
+    */
+    static std::optional<TimePosition> getUpcomingStartInRange (std::optional<TimePosition> jumpPosition, TimeRange,
+                                                                TimeDuration maxLeadIn = defaultUpcomingLeadIn);
+
+    //==============================================================================
+    /** Calls a function for each part of the block that covers a contiguous timeline
+        range, passing it a ProcessContext for just that part.
+        This is the whole block unless the timeline wraps around part way through it,
+        which Nodes that return true from canProcessSplitTimelineRanges have to handle.
+        Whilst the function is called, the block getters above return the values for
+        the part being processed. MIDI added in the second part is moved to its
+        position in the block and the output is only marked as silent if every part was.
+        @see ProcessState::updateForSplitTimelineRange
+    */
+    template<typename ProcessSectionFunction>
+    void forEachTimelineSection (tracktion::graph::Node::ProcessContext& pc, ProcessSectionFunction&& processSection)
+    {
+        const auto sections = processState->getTimelineSections();
+
+        if (sections.size() == 1 || (int) pc.numSamples != processState->numSamples)
+        {
+            jassert (sections.size() == 1);
+            processSection (pc);
+            return;
+        }
+
+        bool isAudioSilent = true;
+
+        for (auto& section : sections)
+        {
+            const choc::buffer::FrameRange frameRange { (choc::buffer::FrameCount) section.startSample,
+                                                        (choc::buffer::FrameCount) (section.startSample + section.numSamples) };
+            auto& midi = section.startSample == 0 ? pc.buffers.midi : sectionMidi;
+            tracktion::graph::Node::ProcessContext sectionContext { frameRange.size(), section.referenceSampleRange,
+                                                                    { pc.buffers.audio.getFrameRange (frameRange), midi } };
+
+            currentSection = &section;
+            processSection (sectionContext);
+            currentSection = nullptr;
+
+            isAudioSilent = isAudioSilent && sectionContext.buffers.isAudioSilent;
+
+            if (&midi == &sectionMidi)
+                pc.buffers.midi.mergeFromAndClearWithOffset (sectionMidi, section.startSample / getSampleRate());
+        }
+
+        pc.buffers.isAudioSilent = isAudioSilent;
+    }
+
     //==============================================================================
     /** Returns the PlayHeadState in use. */
     tracktion::graph::PlayHeadState& getPlayHeadState()      { return processState->playHeadState; }
@@ -155,6 +282,8 @@ public:
 private:
     //==============================================================================
     ProcessState* processState; // Must never be nullptr
+    const ProcessState::TimelineSection* currentSection = nullptr;
+    MidiMessageArray sectionMidi;
 };
 
 
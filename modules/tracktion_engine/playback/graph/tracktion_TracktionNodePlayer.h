@@ -58,6 +58,24 @@ public:
         nodePlayer.setNumThreads (numThreads);
     }
 
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::getNumThreads */
+    size_t getNumThreads() const
+    {
+        return nodePlayer.getNumThreads();
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setThreadPoolCreator */
+    void setThreadPoolCreator (tracktion::graph::LockFreeMultiThreadedNodePlayer::ThreadPoolCreator poolCreator)
+    {
+        nodePlayer.setThreadPoolCreator (std::move (poolCreator));
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setThreadAffinityPolicy */
+    void setThreadAffinityPolicy (tracktion::graph::ThreadAffinityPolicy policy)
+    {
+        nodePlayer.setThreadAffinityPolicy (std::move (policy));
+    }
+
     tracktion::graph::Node* getNode()
     {
         return nodePlayer.getNode();
@@ -78,10 +96,73 @@ public:
         nodePlayer.prepareToPlay (sampleRateToUse, blockSizeToUse);
     }
 
+    //==============================================================================
+    /** Determines how the blocks passed to process are divided up before the Node is processed. */
+    enum class BlockSizeMode
+    {
+        /** Blocks are processed as soon as they arrive, only being split at loop points
+            and tempo changes. This adds no latency but if the host passes lots of tiny
+            blocks, the whole graph is processed for each of them.
+        */
+        splitAtEventsOnly,
+
+        /** Blocks are buffered and the Node is processed in blocks of a fixed size,
+            regardless of the size of the blocks passed to process. This adds the fixed
+            block size of latency to the output but keeps the cost of processing the
+            graph constant. Live inputs aren't supported in this mode.
+        */
+        fixed
+    };
+
+    /** Sets the BlockSizeMode to use.
+        This allocates the buffers required so shouldn't be called during playback.
+        @param fixedBlockSizeToUse  The number of samples to process the Node in if the mode is fixed
+        @param numChannels          The maximum number of channels that will be passed to process
+        @param maxBlockSize         The maximum number of samples that will be passed to process
+    */
+    void setBlockSizeMode (BlockSizeMode newMode, int fixedBlockSizeToUse, int numChannels, int maxBlockSize)
+    {
+        auto newFixedBlockState = newMode == BlockSizeMode::fixed && fixedBlockSizeToUse > 0
+                                    ? std::make_unique<FixedBlockState> (fixedBlockSizeToUse, std::max (1, numChannels), maxBlockSize)
+                                    : nullptr;
+
+        const std::scoped_lock sl (fixedBlockStateLock);
+        std::swap (fixedBlockState, newFixedBlockState);
+    }
+
+    /** Returns the current BlockSizeMode. */
+    BlockSizeMode getBlockSizeMode() const
+    {
+        return fixedBlockState != nullptr ? BlockSizeMode::fixed : BlockSizeMode::splitAtEventsOnly;
+    }
+
+    /** Returns the number of samples of latency the BlockSizeMode adds to the output. */
+    int getLatencyNumSamples() const
+    {
+        return fixedBlockState != nullptr ? fixedBlockState->blockSize : 0;
+    }
+
     /** Processes a block of audio and MIDI data.
         Returns the number of times a node was checked but unable to be processed.
     */
     int process (const tracktion::graph::Node::ProcessContext& pc)
+    {
+        if (fixedBlockState != nullptr)
+        {
+            const std::unique_lock l (fixedBlockStateLock, std::try_to_lock);
+
+            // If this fails the mode is being changed so just process the block directly
+            if (l.owns_lock() && fixedBlockState != nullptr)
+                return processFixedBlocks (*fixedBlockState, pc);
+        }
+
+        return processBlock (pc);
+    }
+
+    /** Processes a block of audio and MIDI data, splitting it at loop points and tempo changes.
+        Returns the number of times a node was checked but unable to be processed.
+    */
+    int processBlock (const tracktion::graph::Node::ProcessContext& pc)
     {
         int numMisses = 0;
         playHeadState.playHead.setReferenceSampleRange (pc.referenceSampleRange);
@@ -91,6 +172,19 @@ public:
 
         if (splitTimelineRange.isSplit)
         {
+            if (canProcessSplitInSinglePass (pc, splitTimelineRange))
+            {
+                // The player checks every Node can handle the wrap before the state is updated for it
+                const auto result = nodePlayer.processSplitTimelineRange (pc, [this, &pc]
+                                                                          {
+                                                                              processState.updateForSplitTimelineRange (nodePlayer.getSampleRate(),
+                                                                                                                        pc.referenceSampleRange);
+                                                                          });
+
+                if (result)
+                    return *result;
+            }
+
             const auto firstRangeLength = splitTimelineRange.timelineRange1.getLength();
 
             numMisses += processReferenceRange (pc, pc.referenceSampleRange.withLength (firstRangeLength));
@@ -128,17 +222,179 @@ public:
         nodePlayer.enableNodeMemorySharing (enableNodeMemorySharing);
     }
 
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableStaticBufferAllocation */
+    void enableStaticBufferAllocation (bool shouldBeEnabled)
+    {
+        nodePlayer.enableStaticBufferAllocation (shouldBeEnabled);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableSharedLatencyCompensation */
+    void enableSharedLatencyCompensation (bool shouldBeEnabled)
+    {
+        nodePlayer.enableSharedLatencyCompensation (shouldBeEnabled);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setNodeProfiler */
+    void setNodeProfiler (tracktion::graph::NodeProfiler* profilerToUse)
+    {
+        nodePlayer.setNodeProfiler (profilerToUse);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setDeferredDeleter */
+    void setDeferredDeleter (tracktion::graph::DeferredDeleter* deleterToUse)
+    {
+        nodePlayer.setDeferredDeleter (deleterToUse);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::getLastPreparationTimes */
+    tracktion::graph::LockFreeMultiThreadedNodePlayer::PreparationTimes getLastPreparationTimes() const
+    {
+        return nodePlayer.getLastPreparationTimes();
+    }
+
     /// Enables or disables latency compensation - it is enabled by default.
     void setLatencyCompensationEnabled (bool shouldEnable)
     {
         nodePlayer.setLatencyCompensationEnabled (shouldEnable);
     }
 
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableCriticalPathScheduling */
+    void enableCriticalPathScheduling (bool shouldBeEnabled)
+    {
+        nodePlayer.enableCriticalPathScheduling (shouldBeEnabled);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableChainFusion */
+    void enableChainFusion (bool shouldBeEnabled)
+    {
+        nodePlayer.enableChainFusion (shouldBeEnabled);
+    }
+
+    /** Enables processing blocks where the timeline wraps around, e.g. at a loop end,
+        in a single pass of the graph rather than once for each side of the wrap.
+        This is only done if every Node in the graph supports it and there's no tempo
+        change in the block, otherwise the sides are still processed separately.
+        @see tracktion::graph::Node::canProcessSplitTimelineRanges
+    */
+    void enableSinglePassLoopWraps (bool shouldBeEnabled)
+    {
+        singlePassLoopWraps = shouldBeEnabled;
+    }
+
 private:
+    //==============================================================================
+    struct FixedBlockState
+    {
+        FixedBlockState (int blockSizeToUse, int numChannels, int maxBlockSizeToUse)
+            : blockSize (blockSizeToUse), maxBlockSize (maxBlockSizeToUse),
+              fifo ((choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) (blockSizeToUse * 2 + maxBlockSizeToUse + 1)),
+              scratchBuffer ({ (choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) blockSizeToUse })
+        {
+            pendingMidi.reserve (128);
+            blockMidi.reserve (128);
+        }
+
+        const int blockSize, maxBlockSize;
+        tracktion::graph::AudioFifo fifo;
+        choc::buffer::ChannelArrayBuffer<float> scratchBuffer;
+        MidiMessageArray pendingMidi, blockMidi;
+        std::optional<int64_t> nextReferenceSample;
+        int64_t nextBlockReferenceSample = 0;
+    };
+
     tracktion::graph::PlayHeadState& playHeadState;
     ProcessState& processState;
     MidiMessageArray scratchMidi;
     tracktion::graph::LockFreeMultiThreadedNodePlayer nodePlayer;
+    tracktion::graph::RealTimeSpinLock fixedBlockStateLock;
+    std::unique_ptr<FixedBlockState> fixedBlockState;
+    bool singlePassLoopWraps = false;
+
+    bool canProcessSplitInSinglePass (const tracktion::graph::Node::ProcessContext& pc, const tracktion::graph::SplitTimelineRange& splitTimelineRange) const
+    {
+        if (! singlePassLoopWraps || (int64_t) pc.numSamples != pc.referenceSampleRange.getLength())
+            return false;
+
+        // Tempo changes still need the block splitting at them
+        return ! containsTempoChange (splitTimelineRange.timelineRange1)
+            && ! containsTempoChange (splitTimelineRange.timelineRange2);
+    }
+
+    bool containsTempoChange (juce::Range<int64_t> timelineRange) const
+    {
+        auto sequence = processState.getTempoSequence();
+
+        if (sequence == nullptr)
+            return false;
+
+        const auto timeRange = timeRangeFromSamples (timelineRange, nodePlayer.getSampleRate());
+        tempo::Sequence::Position position (*sequence);
+        position.set (timeRange.getStart());
+        const auto nextChange = position.getTimeOfNextChange();
+
+        return nextChange != timeRange.getStart() && timeRange.contains (nextChange);
+    }
+
+    int processFixedBlocks (FixedBlockState& state, const tracktion::graph::Node::ProcessContext& pc)
+    {
+        const auto numSamples = (int) pc.numSamples;
+
+        // If the host's blocks can't be buffered just process them directly
+        if (numSamples > state.maxBlockSize)
+        {
+            jassertfalse;
+            return processBlock (pc);
+        }
+
+        // Start again with a block of silence at any discontinuities
+        if (state.nextReferenceSample != pc.referenceSampleRange.getStart())
+        {
+            state.fifo.reset();
+            state.fifo.writeSilence ((choc::buffer::FrameCount) state.blockSize);
+            state.pendingMidi.clear();
+            state.nextBlockReferenceSample = pc.referenceSampleRange.getStart();
+        }
+
+        state.nextReferenceSample = pc.referenceSampleRange.getEnd();
+
+        const auto sampleRate = nodePlayer.getSampleRate();
+        int numMisses = 0;
+
+        // Only process whole blocks, which will never be ahead of the input
+        while (state.fifo.getNumReady() < numSamples)
+        {
+            const auto blockRange = juce::Range<int64_t>::withStartAndLength (state.nextBlockReferenceSample, state.blockSize);
+            state.nextBlockReferenceSample = blockRange.getEnd();
+
+            auto blockAudio = state.scratchBuffer.getView();
+            blockAudio.clear();
+            state.blockMidi.clear();
+
+            numMisses += processBlock ({ (choc::buffer::FrameCount) state.blockSize, blockRange, { blockAudio, state.blockMidi } });
+
+            const auto blockOffset = state.fifo.getNumReady() / sampleRate;
+            state.fifo.write (blockAudio);
+            state.pendingMidi.mergeFromAndClearWithOffset (state.blockMidi, blockOffset);
+        }
+
+        const auto numChannels = std::min (pc.buffers.audio.getNumChannels(), state.fifo.getNumChannels());
+        state.fifo.readAdding (pc.buffers.audio.getFirstChannels (numChannels));
+
+        // Pass on the MIDI for this block and make the rest relative to the next one
+        if (state.pendingMidi.isNotEmpty())
+        {
+            const auto blockDuration = numSamples / sampleRate;
+
+            for (auto& m : state.pendingMidi)
+                if (m.getTimeStamp() < blockDuration)
+                    pc.buffers.midi.add (m);
+
+            state.pendingMidi.removeIf ([blockDuration] (auto& m) { return m.getTimeStamp() < blockDuration; });
+            state.pendingMidi.addToTimestamps (-blockDuration);
+        }
+
+        return numMisses;
+    }
 
     tracktion::graph::Node::ProcessContext getSubProcessContext (const tracktion::graph::Node::ProcessContext& pc, juce::Range<int64_t> subReferenceSampleRange)
     {
@@ -244,4 +500,18 @@ private:
     }
 };
 
+
+//==============================================================================
+/** Returns a creator for the thread pool a player processing an Edit should use.
+    This is the Engine's SharedNodeThreadPool if it has one, otherwise a new pool
+    of the type set with EditPlaybackContext::setThreadPoolStrategy.
+*/
+inline tracktion::graph::LockFreeMultiThreadedNodePlayer::ThreadPoolCreator getThreadPoolCreator (Engine& engine, Edit* edit)
+{
+    if (auto sharedPool = engine.getSharedNodeThreadPool())
+        return sharedPool->getPoolCreator (edit != nullptr ? engine.getEngineBehaviour().getSharedNodeThreadPoolPriority (*edit) : 0);
+
+    return tracktion::graph::getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy()));
+}
+
 }} // namespace tracktion { inline namespace engine
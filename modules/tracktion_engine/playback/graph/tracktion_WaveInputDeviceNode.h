@@ -34,7 +34,7 @@ private:
     InputDeviceInstance& instance;
     WaveInputDevice& waveInputDevice;
     uint32_t lastCallbackTime = 0;
-    tracktion::graph::AudioFifo audioFifo { 1, 32 };
+    tracktion::graph::MirroredAudioFifo audioFifo { 1, 32 };
     const juce::AudioChannelSet destChannels;
 };
 
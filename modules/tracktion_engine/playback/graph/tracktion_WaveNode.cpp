@@ -409,6 +409,7 @@ public:
                     case ResamplingQuality::sincMedium: return src::SRC_SINC_MEDIUM_QUALITY;
                     case ResamplingQuality::sincBest:   return src::SRC_SINC_BEST_QUALITY;
                     case ResamplingQuality::lagrange:   [[ fallthrough ]];
+                    case ResamplingQuality::sincPolyphase: [[ fallthrough ]];
                     default: assert (false); return src::SRC_SINC_FASTEST;
                 }
             }();
@@ -573,6 +574,285 @@ public:
     }
 };
 
+//==============================================================================
+/**
+    A windowed-sinc resampler that filters all channels in one pass.
+
+    The filter is stored as a table of phases, each row aligned to a cache line, and
+    shared between all readers with the same cut-off. For each output frame, the
+    coefficients are interpolated between the two nearest phases once and then
+    applied to every channel.
+*/
+class PolyphaseSincResamplerReader final  : public ResamplerReader
+{
+public:
+    PolyphaseSincResamplerReader (std::unique_ptr<AudioReader> input, double sampleRateToConvertTo)
+        : ResamplerReader (std::move (input)),
+          numChannels (source->getNumChannels()),
+          destSampleRate (sampleRateToConvertTo),
+          table (getTable (sampleRatio))
+    {
+    }
+
+    void reset() override
+    {
+        hasBeenReset = true;
+    }
+
+    SampleCount getPosition() override
+    {
+        return static_cast<SampleCount> (readPosition + 0.5);
+    }
+
+    void setPosition (SampleCount t) override
+    {
+        if (! hasBeenReset && std::abs (t - getPosition()) <= 1)
+            return;
+
+        readPosition = (double) t;
+        hasBeenReset = true;
+    }
+
+    void setPosition (TimePosition t) override
+    {
+        setPosition (toSamples (t, destSampleRate));
+    }
+
+    double getSampleRate() override
+    {
+        return destSampleRate;
+    }
+
+    /** Sets a ratio to increase or decrease playback speed. */
+    void setSpeedRatio (double newSpeedRatio) override
+    {
+        assert (newSpeedRatio > 0);
+        speedRatio = newSpeedRatio;
+    }
+
+    /** Sets a l/r gain to apply to channels. */
+    void setGains (float leftGain, float rightGain) override
+    {
+        gains[0] = leftGain;
+        gains[1] = rightGain;
+    }
+
+    bool readSamples (choc::buffer::ChannelArrayView<float>& destBuffer) override
+    {
+        using namespace choc::buffer;
+
+        if (std::exchange (hasBeenReset, false))
+            prime();
+
+        const auto ratio = sampleRatio * speedRatio;
+        const auto numDestChannels = std::min (destBuffer.getNumChannels(), numChannels);
+        const auto numFrames = destBuffer.getNumFrames();
+        alignas (16) float coefficients[numTaps];
+        bool ok = ! failedToRead;
+
+        for (FrameCount frame = 0; frame < numFrames; ++frame)
+        {
+            auto index = static_cast<FrameCount> (inputPosition);
+
+            if (index + numTaps > numInputFrames)
+            {
+                ok = refill (index) && ok;
+                index = static_cast<FrameCount> (inputPosition);
+            }
+
+            const auto phase = (inputPosition - index) * numPhases;
+            const auto phaseIndex = std::min (static_cast<int> (phase), numPhases - 1);
+            interpolateCoefficients (coefficients, table->getPhase (phaseIndex),
+                                     static_cast<float> (phase - phaseIndex));
+
+            for (ChannelCount chan = 0; chan < numDestChannels; ++chan)
+                destBuffer.getSample (chan, frame) = dotProduct (input.getView().getChannel (chan).data.data + index,
+                                                                 coefficients) * gains[chan & 1];
+
+            inputPosition += ratio;
+        }
+
+        for (auto chan = numDestChannels; chan < destBuffer.getNumChannels(); ++chan)
+            destBuffer.getChannel (chan).clear();
+
+        readPosition += numFrames;
+
+        return ok;
+    }
+
+private:
+    //==============================================================================
+    static constexpr int numTaps = 32, numPhases = 256;
+    static constexpr choc::buffer::FrameCount inputChunkSize = 1024;
+    static constexpr choc::buffer::FrameCount inputBufferSize = numTaps + inputChunkSize;
+
+    // The output lies between these two taps so this many frames of history are needed before it
+    static constexpr int latencyNumFrames = numTaps / 2 - 1;
+
+    struct Table
+    {
+        Table (double cutoff)
+        {
+            // Kaiser-windowed sinc, normalised so each phase has unity gain at DC
+            constexpr double beta = 8.0;
+            const auto i0Beta = besselI0 (beta);
+
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                auto row = coefficients[(size_t) phase].data();
+                double sum = 0.0;
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    const auto x = tap - latencyNumFrames - phase / (double) numPhases;
+                    const auto window = x / (numTaps / 2.0);
+                    const auto w = std::abs (window) < 1.0 ? besselI0 (beta * std::sqrt (1.0 - window * window)) / i0Beta : 0.0;
+                    const auto sincX = juce::MathConstants<double>::pi * cutoff * x;
+                    const auto h = (x == 0.0 ? 1.0 : std::sin (sincX) / sincX) * w;
+
+                    row[tap] = static_cast<float> (h);
+                    sum += h;
+                }
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                    row[tap] = static_cast<float> (row[tap] / sum);
+            }
+        }
+
+        const float* getPhase (int phase) const noexcept    { return coefficients[(size_t) phase].data(); }
+
+        static double besselI0 (double x)
+        {
+            double sum = 1.0, term = 1.0;
+
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+
+            return sum;
+        }
+
+        // One row per phase plus one extra so the last phase can be interpolated
+        struct alignas (64) Row : public std::array<float, numTaps> {};
+        std::array<Row, numPhases + 1> coefficients;
+    };
+
+    /** Returns a table for a given source/dest ratio, sharing them between readers. */
+    static std::shared_ptr<const Table> getTable (double ratio)
+    {
+        // Pull the cut-off below the destination's Nyquist when down-sampling
+        const auto cutoff = juce::jlimit (0.05, 0.95, 0.95 / std::max (1.0, ratio));
+        const auto key = juce::roundToInt (cutoff * 100.0);
+
+        static std::mutex mutex;
+        static std::map<int, std::weak_ptr<const Table>> tables;
+        const std::scoped_lock sl (mutex);
+
+        if (auto existing = tables[key].lock())
+            return existing;
+
+        auto newTable = std::make_shared<const Table> (key / 100.0);
+        tables[key] = newTable;
+        return newTable;
+    }
+
+    static void interpolateCoefficients (float* dest, const float* phase, float alpha) noexcept
+    {
+        const auto* next = phase + sizeof (Table::Row) / sizeof (float);
+
+        for (int i = 0; i < numTaps; ++i)
+            dest[i] = phase[i] + alpha * (next[i] - phase[i]);
+    }
+
+    static float dotProduct (const float* x, const float* h) noexcept
+    {
+       #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        auto sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps();
+
+        for (int i = 0; i < numTaps; i += 8)
+        {
+            sum1 = _mm_add_ps (sum1, _mm_mul_ps (_mm_loadu_ps (x + i),     _mm_load_ps (h + i)));
+            sum2 = _mm_add_ps (sum2, _mm_mul_ps (_mm_loadu_ps (x + i + 4), _mm_load_ps (h + i + 4)));
+        }
+
+        alignas (16) float sums[4];
+        _mm_store_ps (sums, _mm_add_ps (sum1, sum2));
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+       #elif TRACKTION_ARM && defined (__ARM_NEON)
+        auto sum1 = vdupq_n_f32 (0.0f), sum2 = vdupq_n_f32 (0.0f);
+
+        for (int i = 0; i < numTaps; i += 8)
+        {
+            sum1 = vmlaq_f32 (sum1, vld1q_f32 (x + i),     vld1q_f32 (h + i));
+            sum2 = vmlaq_f32 (sum2, vld1q_f32 (x + i + 4), vld1q_f32 (h + i + 4));
+        }
+
+        auto sum = vaddq_f32 (sum1, sum2);
+        auto pair = vadd_f32 (vget_low_f32 (sum), vget_high_f32 (sum));
+        return vget_lane_f32 (vpadd_f32 (pair, pair), 0);
+       #else
+        float sum = 0.0f;
+
+        for (int i = 0; i < numTaps; ++i)
+            sum += x[i] * h[i];
+
+        return sum;
+       #endif
+    }
+
+    /** Fills the input buffer with the frames leading up to the current position. */
+    void prime()
+    {
+        const auto sourcePosition = toSamples (TimePosition::fromSamples (getPosition(), destSampleRate), sourceSampleRate);
+        source->setPosition (sourcePosition - latencyNumFrames);
+        numInputFrames = 0;
+        inputPosition = 0.0;
+        refill (0);
+    }
+
+    /** Drops the frames before the given index and reads more from the source. */
+    bool refill (choc::buffer::FrameCount firstFrameNeeded)
+    {
+        auto view = input.getView();
+        const auto numToKeep = numInputFrames - std::min (firstFrameNeeded, numInputFrames);
+
+        // At high ratios the next frame can be beyond the end of the buffer
+        if (firstFrameNeeded > numInputFrames)
+            source->setPosition (source->getPosition() + (SampleCount) (firstFrameNeeded - numInputFrames));
+
+        if (numToKeep > 0 && firstFrameNeeded > 0)
+            for (choc::buffer::ChannelCount chan = 0; chan < numChannels; ++chan)
+                std::memmove (view.getChannel (chan).data.data,
+                              view.getChannel (chan).data.data + firstFrameNeeded,
+                              numToKeep * sizeof (float));
+
+        inputPosition -= firstFrameNeeded;
+        numInputFrames = numToKeep;
+
+        auto dest = view.getFrameRange ({ numInputFrames, inputBufferSize });
+
+        if (failedToRead = ! source->readSamples (dest); failedToRead)
+            dest.clear();
+
+        numInputFrames = inputBufferSize;
+        return ! failedToRead;
+    }
+
+    const choc::buffer::ChannelCount numChannels;
+    const double destSampleRate;
+    const double sourceSampleRate { source->getSampleRate() };
+    const double sampleRatio { sourceSampleRate / destSampleRate };
+    const std::shared_ptr<const Table> table;
+
+    choc::buffer::ChannelArrayBuffer<float> input { numChannels, inputBufferSize };
+    choc::buffer::FrameCount numInputFrames = 0;
+    double inputPosition = 0.0, readPosition = 0.0, speedRatio = 1.0;
+    float gains[2] = { 1.0f, 1.0f };
+    bool hasBeenReset = true, failedToRead = false;
+};
+
 class TimeStretchReaderBase : public SingleInputAudioReader
 
 {
@@ -860,39 +1140,48 @@ struct WarpedTime
     double stretchRatio = 1.0;
 };
 
-inline WarpedTime warpTime (const WarpMap& map, TimePosition time)
+inline WarpIndex createWarpIndex (const WarpMap& map)
+{
+    WarpIndex index;
+
+    for (auto& p : map)
+        index.insert (index.size(), p.sourceTime, p.warpTime);
+
+    return index;
+}
+
+/** Finds the warped time and stretch ratio for a time.
+    @param hint The index of the segment found by the previous call, this gets updated
+                to the one found this time.
+*/
+inline WarpedTime warpTime (const WarpIndex& index, TimePosition time, size_t& hint)
 {
-    if (map.empty())
+    if (index.isEmpty())
         return { time, 1.0 };
 
-    assert (map.size() > (size_t) 1);
+    assert (index.size() > (size_t) 1);
     WarpPoint startMarker, endMarker;
 
-    auto first = map.front();
-    auto last  = map.back();
+    const auto lastIndex = index.size() - 1;
 
-    if (time <= first.warpTime) //below or on the 1st marker
+    if (time <= index.getWarpTime (0)) //below or on the 1st marker
     {
-        const auto durationBefore = time - first.warpTime;
+        const auto durationBefore = time - index.getWarpTime (0);
         return { toPosition (-durationBefore), 1.0 };
     }
-    else if (time > last.warpTime) // after the last marker
+    else if (time > index.getWarpTime (lastIndex)) // after the last marker
     {
-        const auto durationBeyondEnd = time - last.warpTime;
-        return { last.sourceTime + durationBeyondEnd, 1.0 };
+        const auto durationBeyondEnd = time - index.getWarpTime (lastIndex);
+        return { index.getSourceTime (lastIndex) + durationBeyondEnd, 1.0 };
     }
     else
     {
-        size_t index = 0;
-        auto numMarkers = map.size();
+        hint = index.findFirstWarpTimeNotBefore (time, hint);
 
-        while (index < numMarkers && map[index].warpTime < time)
-            index++;
+        if (hint > 0)
+            startMarker = { index.getSourceTime (hint - 1), index.getWarpTime (hint - 1) };
 
-        if (index > 0)
-            startMarker = map[index - 1];
-
-        endMarker = map[index];
+        endMarker = { index.getSourceTime (hint), index.getWarpTime (hint) };
     }
 
     const auto sourceDuration = endMarker.sourceTime - startMarker.sourceTime;
@@ -919,7 +1208,7 @@ public:
                 TimeStretcher::Mode mode,
                 TimeStretcher::ElastiqueProOptions options)
         : SingleInputAudioReader (std::make_unique<TimeStretchReader> (std::move (input), mode, options)),
-          reader (static_cast<TimeStretchReader*> (source.get())), map (std::move (warpMap))
+          reader (static_cast<TimeStretchReader*> (source.get())), index (createWarpIndex (warpMap))
     {
     }
 
@@ -945,7 +1234,7 @@ public:
     bool readSamples (choc::buffer::ChannelArrayView<float>& destBuffer) override
     {
         const auto unwarpedStartTime = TimePosition::fromSamples (readPosition, getSampleRate());
-        const auto ratio = warpTime (map, unwarpedStartTime).stretchRatio;
+        const auto ratio = warpTime (index, unwarpedStartTime, lastSegment).stretchRatio;
 
         reader->setSpeed (ratio);
         readPosition += (SampleCount) destBuffer.getNumFrames();
@@ -955,14 +1244,15 @@ public:
 
 private:
     TimeStretchReader* reader = nullptr;
-    WarpMap map;
+    const WarpIndex index;
+    size_t lastSegment = 0;
     SampleCount readPosition = 0;
 
     void setSourcePosition (SampleCount pos)
     {
         const auto sampleRate = getSampleRate();
         const auto sourceTime = TimePosition::fromSamples (pos, sampleRate);
-        const auto warpedTime = warpTime (map, sourceTime).position;
+        const auto warpedTime = warpTime (index, sourceTime, lastSegment).position;
         const auto warpedSamplePos = toSamples (warpedTime, sampleRate);
         source->setPosition (warpedSamplePos);
     }
@@ -1114,28 +1404,32 @@ public:
         // Clear samples outside of clip position
         // N.B. this shouldn't happen when using a clip combiner as the times should be clipped correctly
         if (! tr.isEmpty())
-        {
-            using choc::buffer::FrameCount;
-            const auto timeToClearAtStart  = editTimeRange.contains (clipPosition.getStart()) ? clipPosition.getStart() - editTimeRange.getStart() : 0_td;
-            const auto timeToClearAtEnd    = editTimeRange.contains (clipPosition.getEnd())   ? editTimeRange.getEnd() - clipPosition.getEnd()     : 0_td;
+            clearSamplesOutsideClip (destBuffer, editTimeRange, clipPosition);
 
-            const auto editTimeRangeLength = editTimeRange.getLength();
-            const auto numFrames = destBuffer.getNumFrames();
+        return readOk;
+    }
 
-            if (timeToClearAtStart > 0_td)
-            {
-                const auto numSamplesToClearAtStart = static_cast<FrameCount> (numFrames * (timeToClearAtStart / editTimeRangeLength) + 0.5);
-                destBuffer.getStart (numSamplesToClearAtStart).clear();
-            }
+    static void clearSamplesOutsideClip (const choc::buffer::ChannelArrayView<float>& destBuffer,
+                                         TimeRange editTimeRange, TimeRange clipPosition)
+    {
+        using choc::buffer::FrameCount;
+        const auto timeToClearAtStart  = editTimeRange.contains (clipPosition.getStart()) ? clipPosition.getStart() - editTimeRange.getStart() : 0_td;
+        const auto timeToClearAtEnd    = editTimeRange.contains (clipPosition.getEnd())   ? editTimeRange.getEnd() - clipPosition.getEnd()     : 0_td;
 
-            if (timeToClearAtEnd > 0_td)
-            {
-                const auto numSamplesToClearAtEnd = static_cast<FrameCount> (numFrames * (timeToClearAtEnd / editTimeRangeLength) + 0.5);
-                destBuffer.getEnd (numSamplesToClearAtEnd).clear();
-            }
+        const auto editTimeRangeLength = editTimeRange.getLength();
+        const auto numFrames = destBuffer.getNumFrames();
+
+        if (timeToClearAtStart > 0_td)
+        {
+            const auto numSamplesToClearAtStart = static_cast<FrameCount> (numFrames * (timeToClearAtStart / editTimeRangeLength) + 0.5);
+            destBuffer.getStart (numSamplesToClearAtStart).clear();
         }
 
-        return readOk;
+        if (timeToClearAtEnd > 0_td)
+        {
+            const auto numSamplesToClearAtEnd = static_cast<FrameCount> (numFrames * (timeToClearAtEnd / editTimeRangeLength) + 0.5);
+            destBuffer.getEnd (numSamplesToClearAtEnd).clear();
+        }
     }
 
     choc::buffer::ChannelCount getNumChannels() override    { return source->getNumChannels(); }
@@ -1505,6 +1799,47 @@ private:
 };
 
 
+//==============================================================================
+/**
+    The fast path for the common case of a time-based clip at its native speed and
+    sample rate with no stretching, pitching, warping or speed fades.
+
+    This reads straight from the AudioFileCache::Reader in to the output buffer,
+    skipping the intermediate buffers of the rest of the reader chain. The clip gain
+    is left to be applied with the block fades.
+*/
+class DirectEditReader
+{
+public:
+    DirectEditReader (std::shared_ptr<SpeedFadeEditReader> chainToKeepAlive,
+                      AudioFileCacheReader& fileReader,
+                      TimeRange sourceTimeRange, TimeDuration offsetTime)
+        : chain (std::move (chainToKeepAlive)), reader (fileReader),
+          clipPosition (sourceTimeRange), offset (offsetTime)
+    {
+    }
+
+    bool read (TimeRange editTimeRange, choc::buffer::ChannelArrayView<float>& destBuffer)
+    {
+        // This mirrors the mapping in EditToClipTimeReader with a speed ratio of 1
+        const auto sourceStart = editTimeRange.getStart() - toDuration (clipPosition.getStart()) + offset;
+
+        reader.setPosition (sourceStart);
+        const auto readOk = reader.readSamples (destBuffer);
+
+        EditToClipTimeReader::clearSamplesOutsideClip (destBuffer, editTimeRange, clipPosition);
+
+        return readOk;
+    }
+
+private:
+    const std::shared_ptr<SpeedFadeEditReader> chain;
+    AudioFileCacheReader& reader;
+    const TimeRange clipPosition;
+    const TimeDuration offset;
+};
+
+
 //==============================================================================
 //==============================================================================
 struct WaveNode::PerChannelState
@@ -1557,6 +1892,10 @@ tracktion::graph::NodeProperties WaveNode::getNodeProperties()
 void WaveNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
 {
     reader = audioFile.engine->getAudioFileManager().cache.createReader (audioFile);
+
+    if (reader != nullptr)
+        reader->setOwnerID (editItemID);
+
     outputSampleRate = info.sampleRate;
     editPositionInSamples = tracktion::toSamples ({ editPosition.getStart(), editPosition.getEnd() }, outputSampleRate);
     updateFileSampleRate();
@@ -1605,6 +1944,7 @@ void WaveNode::process (ProcessContext& pc)
     assert (outputSampleRate == getSampleRate());
 
     //TODO: Might get a performance boost by pre-setting the file position in prepareForNextBlock
+    updateUpcomingReadPositions();
     processSection (pc, getTimelineSampleRange());
 }
 
@@ -1640,6 +1980,23 @@ bool WaveNode::updateFileSampleRate()
     return true;
 }
 
+void WaveNode::updateUpcomingReadPositions()
+{
+    if (reader == nullptr || audioFileSampleRate == 0.0 || isOfflineRender)
+        return;
+
+    auto toFileSample = [this] (std::optional<TimePosition> jumpPosition) -> std::optional<SampleCount>
+    {
+        if (auto editTime = getUpcomingStartInRange (jumpPosition, editPosition))
+            return editTimeToFileSample (*editTime);
+
+        return {};
+    };
+
+    const auto upcoming = getUpcomingJumpPositions();
+    reader->setUpcomingReadPositions (toFileSample (upcoming[0]), toFileSample (upcoming[1]));
+}
+
 void WaveNode::replaceChannelStateIfPossible (NodeGraph* nodeGraphToReplace, int numChannelsToUse)
 {
     const auto nodeID = (size_t) editItemID.getRawID();
@@ -1668,7 +2025,11 @@ void WaveNode::processSection (ProcessContext& pc, juce::Range<int64_t> timeline
     if (reader == nullptr
          || sectionEditTime.getEnd() <= editPosition.getStart()
          || sectionEditTime.getStart() >= editPosition.getEnd())
+    {
+        // Nothing is read outside the clip so the cleared output can be skipped downstream
+        pc.buffers.isAudioSilent = true;
         return;
+    }
 
     SCOPED_REALTIME_CHECK
 
@@ -1770,13 +2131,7 @@ void WaveNode::processSection (ProcessContext& pc, juce::Range<int64_t> timeline
             state.resampler.processAdding (ratio, src, dest, (int) numFrames, gains[channel & 1]);
 
             if (lastSampleFadeLength > 0)
-            {
-                for (uint32_t i = 0; i < lastSampleFadeLength; ++i)
-                {
-                    auto alpha = i / (float) lastSampleFadeLength;
-                    dest[i] = alpha * dest[i] + state.lastSample * (1.0f - alpha);
-                }
-            }
+                AudioFadeCurve::applyLinearFadeFromValue (dest, (int) lastSampleFadeLength, state.lastSample, 1.0f);
 
             state.lastSample = dest[numFrames - 1];
         }
@@ -2055,13 +2410,19 @@ bool WaveNodeRealTime::isReadyToProcess()
     return buildAudioReaderGraph();
 }
 
+bool WaveNodeRealTime::canProcessSplitTimelineRanges()
+{
+    return true;
+}
+
 void WaveNodeRealTime::process (ProcessContext& pc)
 {
     SCOPED_REALTIME_CHECK
     assert (outputSampleRate == getSampleRate());
 
     //TODO: Might get a performance boost by pre-setting the file position in prepareForNextBlock
-    processSection (pc);
+    updateUpcomingReadPositions();
+    forEachTimelineSection (pc, [this] (auto& sectionContext) { processSection (sectionContext); });
 }
 
 //==============================================================================
@@ -2090,10 +2451,17 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
     if (fileCacheReader == nullptr || fileCacheReader->getSampleRate() == 0.0)
         return false;
 
+    fileCacheReader->setOwnerID (editItemID);
+
+    auto fileCacheReaderPtr = fileCacheReader.get();
+
     auto audioFileCacheReader = std::make_unique<AudioFileCacheReader> (std::move (fileCacheReader), isOfflineRender ? 5s : 0ms,
                                                                         destChannels, channelsToUse);
+    auto audioFileCacheReaderPtr = audioFileCacheReader.get();
     std::unique_ptr<AudioReader> loopReader;
 
+    const bool usesWarpMap = warpMap.has_value();
+
     if (warpMap)
     {
         // If we're using a warp map, the looping as to be applied above the warp so the loop times don't get warped
@@ -2114,6 +2482,8 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
 
     if (resamplingQuality == ResamplingQuality::lagrange)
         resamplerAudioReader    = std::make_unique<LagrangeResamplerReader> (std::move (loopReader), outputSampleRate);
+    else if (resamplingQuality == ResamplingQuality::sincPolyphase)
+        resamplerAudioReader    = std::make_unique<PolyphaseSincResamplerReader> (std::move (loopReader), outputSampleRate);
     else
         resamplerAudioReader    = std::make_unique<HighQualityResamplerReader> (std::move (loopReader), outputSampleRate, resamplingQuality);
 
@@ -2130,7 +2500,21 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
 
     auto timeStretcher = timeStretchReader.get();
     std::unique_ptr<TimeRangeReader> timeRangeReader;
-    std::unique_ptr<EditReader> basicEditReader;
+
+    auto createEditReader = [this] (std::unique_ptr<TimeRangeReader> source)
+    {
+        if (syncTempo == SyncTempo::yes || syncPitch == SyncPitch::yes)
+        {
+            assert (fileTempoSequence);
+            auto beatRangeReader    = std::make_unique<BeatRangeReader> (std::move (source),
+                                                                         loopSectionBeats, offsetBeats, dynamicOffsetBeats, *fileTempoPosition);
+            auto editToClipBeatReader    = std::make_unique<EditToClipBeatReader> (std::move (beatRangeReader), editPositionBeats, dynamicOffsetBeats);
+            return std::make_unique<EditReader> (std::move (editToClipBeatReader), nullptr);
+        }
+
+        auto editToClipTimeReader = std::make_unique<EditToClipTimeReader> (std::move (source), editPositionTime, offsetTime, speedRatio);
+        return std::make_unique<EditReader> (nullptr, std::move (editToClipTimeReader));
+    };
 
     if (syncPitch == SyncPitch::yes)
     {
@@ -2160,21 +2544,36 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
         }
     }
 
-    if (syncTempo == SyncTempo::yes || syncPitch == SyncPitch::yes)
-    {
-        assert (fileTempoSequence);
-        auto beatRangeReader    = std::make_unique<BeatRangeReader> (std::move (timeRangeReader),
-                                                                     loopSectionBeats, offsetBeats, dynamicOffsetBeats, *fileTempoPosition);
-        auto editToClipBeatReader    = std::make_unique<EditToClipBeatReader> (std::move (beatRangeReader), editPositionBeats, dynamicOffsetBeats);
-        basicEditReader = std::make_unique<EditReader> (std::move (editToClipBeatReader), nullptr);
-    }
-    else
+    editReader = std::make_shared<SpeedFadeEditReader> (createEditReader (std::move (timeRangeReader)), speedFadeDescription, editTempoSequence);
+
+    // Whilst the user is dragging, the playhead loops small blocks around the drag position.
+    // Stretched and warped clips use a chain that only resamples the file during this so the
+    // time-stretcher doesn't have to be reset and primed every time the scrub loop jumps.
+    // The pitch follows the speed ratio but scrubbing stays cheap regardless of the stretch mode
+    if (! isOfflineRender && (! timestretchDisabled || usesWarpMap))
     {
-        auto editToClipTimeReader = std::make_unique<EditToClipTimeReader> (std::move (timeRangeReader), editPositionTime, offsetTime, speedRatio);
-        basicEditReader = std::make_unique<EditReader> (nullptr, std::move (editToClipTimeReader));
+        if (auto scrubFileReader = audioFile.engine->getAudioFileManager().cache.createReader (audioFile);
+            scrubFileReader != nullptr && scrubFileReader->getSampleRate() > 0.0)
+        {
+            scrubFileReader->setOwnerID (editItemID);
+            auto scrubCacheReader = std::make_unique<AudioFileCacheReader> (std::move (scrubFileReader), 0ms, destChannels, channelsToUse);
+            scrubCacheReader->setLoopRange (loopSectionTime);
+
+            std::unique_ptr<ResamplerReader> scrubResampler = std::make_unique<LagrangeResamplerReader> (std::move (scrubCacheReader), outputSampleRate);
+            scrubResamplerReader = scrubResampler.get();
+            scrubEditReader = createEditReader (std::make_unique<TimeRangeReader> (std::move (scrubResampler)));
+        }
     }
 
-    editReader = std::make_shared<SpeedFadeEditReader> (std::move (basicEditReader), speedFadeDescription, editTempoSequence);
+    // Skip the reader chain when it would just be passing the file through
+    if (timestretchDisabled && ! warpMap && editReader->isTimeBased()
+        && speedRatio == 1.0 && speedFadeDescription.isEmpty()
+        && audioFileCacheReaderPtr->getSampleRate() == outputSampleRate)
+        directEditReader = std::make_shared<DirectEditReader> (editReader, *audioFileCacheReaderPtr, editPositionTime, offsetTime);
+
+    // Upcoming positions can only be mapped to the file directly if it's not stretched or warped
+    if (timestretchDisabled && ! warpMap && editReader->isTimeBased())
+        upcomingPositionsReader = fileCacheReaderPtr;
 
     if (! channelState)
     {
@@ -2192,6 +2591,35 @@ bool WaveNodeRealTime::buildAudioReaderGraph()
     return true;
 }
 
+void WaveNodeRealTime::updateUpcomingReadPositions()
+{
+    if (upcomingPositionsReader == nullptr || isOfflineRender)
+        return;
+
+    auto toFileSample = [this] (std::optional<TimePosition> jumpPosition) -> std::optional<SampleCount>
+    {
+        const auto editTime = getUpcomingStartInRange (jumpPosition, editPositionTime);
+
+        if (! editTime)
+            return {};
+
+        // This mirrors the mapping in EditToClipTimeReader
+        const auto sourceTime = (*editTime - toDuration (editPositionTime.getStart()) + offsetTime) * speedRatio;
+        return toSamples (sourceTime, upcomingPositionsReader->getSampleRate());
+    };
+
+    const auto upcoming = getUpcomingJumpPositions();
+    upcomingPositionsReader->setUpcomingReadPositions (toFileSample (upcoming[0]), toFileSample (upcoming[1]));
+}
+
+void WaveNodeRealTime::keepStartReady()
+{
+    if (upcomingPositionsReader == nullptr || isOfflineRender)
+        return;
+
+    upcomingPositionsReader->setUpcomingReadPositions (toSamples (offsetTime * speedRatio, upcomingPositionsReader->getSampleRate()));
+}
+
 void WaveNodeRealTime::replaceStateIfPossible (NodeGraph* nodeGraphToReplace)
 {
     if (nodeGraphToReplace == nullptr)
@@ -2220,7 +2648,11 @@ void WaveNodeRealTime::replaceStateIfPossible (WaveNodeRealTime& other)
     fileTempoSequence = other.fileTempoSequence;
     fileTempoPosition = other.fileTempoPosition;
     resamplerReader = other.resamplerReader;
+    upcomingPositionsReader = other.upcomingPositionsReader;
     editReader = other.editReader;
+    directEditReader = other.directEditReader;
+    scrubResamplerReader = other.scrubResamplerReader;
+    scrubEditReader = other.scrubEditReader;
     pitchAdjustReader = other.pitchAdjustReader;
     dynamicOffsetBeats = other.dynamicOffsetBeats;
 }
@@ -2233,18 +2665,20 @@ void WaveNodeRealTime::processSection (ProcessContext& pc)
     // Check that the number of channels requested matches the destination buffer num channels
     assert (destChannels.size() == (int) pc.buffers.audio.getNumChannels());
 
-    if (editReader == nullptr)
-        return;
+    // Nothing is read outside the clip so the cleared output can be skipped downstream
+    const bool isOutsideClip = editReader == nullptr
+        || (editReader->isTimeBased()
+            && (sectionEditTime.getEnd() <= editPositionTime.getStart()
+                || sectionEditTime.getStart() >= editPositionTime.getEnd()))
+        || (editReader->isBeatBased()
+            && (sectionEditBeats.getEnd() <= (editPositionBeats.getStart() + *dynamicOffsetBeats)
+                || sectionEditBeats.getStart() >= (editPositionBeats.getEnd() + *dynamicOffsetBeats)));
 
-    if (editReader->isTimeBased()
-        && (sectionEditTime.getEnd() <= editPositionTime.getStart()
-            || sectionEditTime.getStart() >= editPositionTime.getEnd()))
+    if (isOutsideClip)
+    {
+        pc.buffers.isAudioSilent = true;
         return;
-
-    if (editReader->isBeatBased()
-        && (sectionEditBeats.getEnd() <= (editPositionBeats.getStart() + *dynamicOffsetBeats)
-            || sectionEditBeats.getStart() >= (editPositionBeats.getEnd() + *dynamicOffsetBeats)))
-      return;
+    }
 
     const bool sectionContainsStartOfClip = [&]
     {
@@ -2278,20 +2712,43 @@ void WaveNodeRealTime::processSection (ProcessContext& pc)
         gains[1] *= 0.4f;
     }
 
+    // The direct reader can only be used at normal playback speed, otherwise the
+    // resampler is needed. When switching between chains, their state has to be reset
+    const bool scrub = scrubEditReader != nullptr && getPlayHead().isUserDragging();
+    const bool readDirectly = ! scrub && directEditReader != nullptr && getPlaybackSpeedRatio() == 1.0;
+    const bool wasReadingDirectly = std::exchange (lastBlockWasReadDirectly, readDirectly);
+    const bool wasScrubbing = std::exchange (lastBlockWasScrubbed, scrub);
+
     if (resamplerReader != nullptr)
         resamplerReader->setGains (gains[0], gains[1]);
 
+    if (scrubResamplerReader != nullptr)
+        scrubResamplerReader->setGains (gains[0], gains[1]);
+
     if (pitchAdjustReader != nullptr)
         pitchAdjustReader->setKey (getKeyToSyncTo (sectionEditTime.getStart()));
 
     // Read through the audio stack
-    const auto isContiguous = getPlayHeadState().isContiguousWithPreviousBlock();
+    const auto isContiguous = isContiguousWithPreviousBlock();
     uint32_t lastSampleFadeLength = (isFirstBlock && ! sectionContainsStartOfClip) ? std::min (numFrames, 10u) : 0;
     isFirstBlock = false;
 
-    if (editReader->read (sectionEditBeats, sectionEditTime, pc.buffers.audio, isContiguous, getPlaybackSpeedRatio()))
+    const auto readOk = [&]
     {
-        if (! isContiguous && (! getPlayHeadState().isFirstBlockOfLoop()) && (! sectionContainsStartOfClip))
+        if (scrub)
+            return scrubEditReader->read (sectionEditBeats, sectionEditTime, pc.buffers.audio,
+                                          isContiguous && wasScrubbing, getPlaybackSpeedRatio());
+
+        if (readDirectly)
+            return directEditReader->read (sectionEditTime, pc.buffers.audio);
+
+        return editReader->read (sectionEditBeats, sectionEditTime, pc.buffers.audio,
+                                 isContiguous && ! wasReadingDirectly && ! wasScrubbing, getPlaybackSpeedRatio());
+    }();
+
+    if (readOk)
+    {
+        if (! isContiguous && (! isFirstBlockOfLoop()) && (! sectionContainsStartOfClip))
             lastSampleFadeLength = std::min (numFrames, 40u);
     }
     else
@@ -2308,17 +2765,16 @@ void WaveNodeRealTime::processSection (ProcessContext& pc)
         if (channel < (choc::buffer::ChannelCount) channelState->size())
         {
             const auto dest = pc.buffers.audio.getIterator (channel).sample;
+            const auto gain = readDirectly ? gains[channel & 1] : 1.0f;
 
             auto& lastSample = (*channelState)[(size_t) channel];
 
+            // When reading directly, the gain is applied here in the same pass as the fade
             if (lastSampleFadeLength > 0)
-            {
-                for (uint32_t i = 0; i < lastSampleFadeLength; ++i)
-                {
-                    auto alpha = i / (float) lastSampleFadeLength;
-                    dest[i] = alpha * dest[i] + lastSample * (1.0f - alpha);
-                }
-            }
+                AudioFadeCurve::applyLinearFadeFromValue (dest, (int) lastSampleFadeLength, lastSample, gain);
+
+            if (gain != 1.0f)
+                juce::FloatVectorOperations::multiply (dest + lastSampleFadeLength, gain, (int) (numFrames - lastSampleFadeLength));
 
             lastSample = dest[numFrames - 1];
         }
@@ -21,6 +21,8 @@ class EditToClipTimeReader;
 class ResamplerReader;
 class PitchAdjustReader;
 class SpeedFadeEditReader;
+class DirectEditReader;
+class EditReader;
 
 struct WarpPoint
 {
@@ -56,6 +58,9 @@ public:
               EditItemID,
               bool isOfflineRender);
 
+    /** Returns the EditItemID to identify this Node. */
+    EditItemID getItemID() const                            { return editItemID; }
+
     //==============================================================================
     tracktion::graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
@@ -83,6 +88,7 @@ private:
     int64_t editPositionToFileSample (int64_t) const noexcept;
     int64_t editTimeToFileSample (TimePosition) const noexcept;
     bool updateFileSampleRate();
+    void updateUpcomingReadPositions();
     void replaceChannelStateIfPossible (NodeGraph*, int numChannelsToUse);
     void replaceChannelStateIfPossible (WaveNode&, int numChannelsToUse);
     void processSection (ProcessContext&, juce::Range<int64_t> timelineRange);
@@ -204,10 +210,21 @@ public:
     */
     void setDynamicOffsetBeats (BeatDuration) override;
 
+    /** Asks the AudioFileCache to keep the start of the source ready to read.
+        This can be called whilst the Node isn't being processed, e.g. when it's
+        in a stopped launcher clip, so it can start without waiting for the file.
+        This must only be called after prepareToPlay.
+    */
+    void keepStartReady();
+
+    /** Returns the EditItemID to identify this Node. */
+    EditItemID getItemID() const                            { return editItemID; }
+
     //==============================================================================
     graph::NodeProperties getNodeProperties() override;
     void prepareToPlay (const graph::PlaybackInitialisationInfo&) override;
     bool isReadyToProcess() override;
+    bool canProcessSplitTimelineRanges() override;
     void process (ProcessContext&) override;
 
 private:
@@ -232,13 +249,17 @@ private:
     float pitchChangeSemitones = 0.0;
     double outputSampleRate = 44100.0;
     int outputBlockSize = 0;
-    bool isFirstBlock = false;
+    bool isFirstBlock = false, lastBlockWasReadDirectly = false, lastBlockWasScrubbed = false;
     const ReadAhead readAhead;
 
     size_t stateHash = 0;
     ResamplerReader* resamplerReader = nullptr;
     PitchAdjustReader* pitchAdjustReader = nullptr;
+    AudioFileCache::Reader* upcomingPositionsReader = nullptr;
     std::shared_ptr<SpeedFadeEditReader> editReader;
+    std::shared_ptr<DirectEditReader> directEditReader;
+    ResamplerReader* scrubResamplerReader = nullptr;
+    std::shared_ptr<EditReader> scrubEditReader;
     std::shared_ptr<std::vector<float>> channelState;
     std::shared_ptr<BeatDuration> dynamicOffsetBeats = std::make_shared<BeatDuration>();
 
@@ -250,6 +271,7 @@ private:
     std::shared_ptr<tempo::Sequence::Position> chordPitchPosition;
 
     bool buildAudioReaderGraph();
+    void updateUpcomingReadPositions();
     void replaceStateIfPossible (NodeGraph*);
     void replaceStateIfPossible (WaveNodeRealTime&);
     void processSection (ProcessContext&);
@@ -266,15 +288,15 @@ struct std::hash<tracktion::engine::WarpMap>
 {
     size_t operator() (const tracktion::engine::WarpMap& w) const noexcept
     {
-        size_t seed = 0;
+        tracktion::ContentHasher hasher;
 
         for (const auto& p : w)
         {
-            tracktion::hash_combine (seed, p.sourceTime.inSeconds());
-            tracktion::hash_combine (seed, p.warpTime.inSeconds());
+            hasher.add (p.sourceTime.inSeconds());
+            hasher.add (p.warpTime.inSeconds());
         }
 
-        return seed;
+        return (size_t) hasher.getHash();
     }
 };
 #endif
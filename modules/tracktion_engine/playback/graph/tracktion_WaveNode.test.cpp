@@ -34,6 +34,7 @@ public:
             runBasicTests<WaveNode> ("WaveNode", ts, true);
             runBasicTests<WaveNode> ("WaveNode", ts, false);
             runLoopedTimelineTests<WaveNode> ("WaveNode", ts);
+            runFixedBlockSizeTests (ts);
         }
 
         logMessage ("WaveNodeRealTime");
@@ -43,6 +44,7 @@ public:
             runBasicTests<WaveNodeRealTime> ("WaveNodeRealTime", ts, true);
             runBasicTests<WaveNodeRealTime> ("WaveNodeRealTime", ts, false);
             runLoopedTimelineTests<WaveNodeRealTime> ("WaveNodeRealTime", ts);
+            runSinglePassLoopWrapTests (ts);
             runDynamicOffsetTests (ts);
             runTimestretchedTests (ts);
         }
@@ -61,6 +63,117 @@ private:
 
     //==============================================================================
     //==============================================================================
+    //==============================================================================
+    //==============================================================================
+    void runFixedBlockSizeTests (graph::test_utilities::TestSetup ts)
+    {
+        using namespace tracktion::graph::test_utilities;
+        auto& engine = *tracktion_engine::Engine::getEngines()[0];
+
+        const double fileLengthSeconds = 1.0;
+        auto sinFile = getSinFile<juce::WavAudioFormat> (ts.sampleRate, fileLengthSeconds);
+        AudioFile sinAudioFile (engine, sinFile->getFile());
+
+        auto render = [&] (int fixedBlockSize)
+        {
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState (playHead);
+            ProcessState processState (playHeadState);
+            playHead.playSyncedToRange ({ 0, std::numeric_limits<int64_t>::max() });
+
+            auto node = makeNode<WaveNode> (sinAudioFile,
+                                            TimeRange (0.0s, TimeDuration::fromSeconds (fileLengthSeconds)),
+                                            TimeDuration(),
+                                            TimeRange(),
+                                            LiveClipLevel(),
+                                            1.0,
+                                            juce::AudioChannelSet::canonicalChannelSet (sinAudioFile.getNumChannels()),
+                                            juce::AudioChannelSet::canonicalChannelSet (1),
+                                            processState,
+                                            EditItemID(),
+                                            true);
+
+            auto player = std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                 getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+            player->setBlockSizeMode (TracktionNodePlayer::BlockSizeMode::fixed, fixedBlockSize, 1, ts.blockSize);
+            expectEquals (player->getLatencyNumSamples(), fixedBlockSize);
+
+            TestProcess<TracktionNodePlayer> testProcess (std::move (player), ts, 1, fileLengthSeconds + 1.0, true);
+            return testProcess.processAll();
+        };
+
+        beginTest ("Fixed block size");
+        {
+            const int fixedBlockSize = 64;
+            auto reference = render (0);
+            auto fixed = render (fixedBlockSize);
+
+            // The output should be the same, just delayed by the fixed block size
+            expectAudioBuffer (*this, fixed->buffer, 0, juce::Range<int> (0, fixedBlockSize), 0.0f, 0.0f);
+
+            float maxDiff = 0.0f;
+
+            for (int i = 0; i < reference->buffer.getNumSamples() - fixedBlockSize; ++i)
+                maxDiff = std::max (maxDiff, std::abs (fixed->buffer.getSample (0, i + fixedBlockSize) - reference->buffer.getSample (0, i)));
+
+            expectLessOrEqual (maxDiff, 0.0001f);
+        }
+    }
+
+    void runSinglePassLoopWrapTests (graph::test_utilities::TestSetup ts)
+    {
+        using namespace tracktion::graph::test_utilities;
+        auto& engine = *tracktion_engine::Engine::getEngines()[0];
+
+        const double fileLengthSeconds = 1.0;
+        auto sinFile = getSinFile<juce::WavAudioFormat> (ts.sampleRate, fileLengthSeconds);
+        AudioFile sinAudioFile (engine, sinFile->getFile());
+
+        auto render = [&] (bool singlePassLoopWraps)
+        {
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState (playHead);
+            ProcessState processState (playHeadState);
+
+            // Loop playback between 0.25s & 0.75s so the loop end falls inside blocks
+            playHead.play ({ timeToSample (0.25, ts.sampleRate), timeToSample (0.75, ts.sampleRate) }, true);
+
+            auto node = makeNode<WaveNodeRealTime> (sinAudioFile,
+                                                    TimeRange (0.0s, TimeDuration::fromSeconds (fileLengthSeconds)),
+                                                    TimeDuration(),
+                                                    TimeRange(),
+                                                    LiveClipLevel(),
+                                                    1.0,
+                                                    juce::AudioChannelSet::canonicalChannelSet (sinAudioFile.getNumChannels()),
+                                                    juce::AudioChannelSet::canonicalChannelSet (1),
+                                                    processState,
+                                                    EditItemID(),
+                                                    true);
+
+            auto player = std::make_unique<TracktionNodePlayer> (std::move (node), processState, ts.sampleRate, ts.blockSize,
+                                                                 getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+            player->enableSinglePassLoopWraps (singlePassLoopWraps);
+
+            TestProcess<TracktionNodePlayer> testProcess (std::move (player), ts, 1, 3.0, true);
+            return testProcess.processAll();
+        };
+
+        beginTest ("WaveNodeRealTime single pass loop wraps");
+        {
+            auto reference = render (false);
+            auto singlePass = render (true);
+
+            // Processing the wrap in one pass should give the same output as splitting the block
+            float maxDiff = 0.0f;
+
+            for (int i = 0; i < reference->buffer.getNumSamples(); ++i)
+                maxDiff = std::max (maxDiff, std::abs (singlePass->buffer.getSample (0, i) - reference->buffer.getSample (0, i)));
+
+            expectLessOrEqual (maxDiff, 0.0001f);
+            expectGreaterThan (reference->buffer.getMagnitude (0, 0, reference->buffer.getNumSamples()), 0.5f);
+        }
+    }
+
     template<typename NodeType>
     void runBasicTests (juce::String nodeTypeName, graph::test_utilities::TestSetup ts, bool playSyncedToRange)
     {
@@ -414,6 +527,108 @@ private:
 
 static WaveNodeTests waveNodeTests;
 
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("Upcoming start positions")
+    {
+        const TimeRange range (2_tp, 4_tp);
+
+        CHECK (! TracktionEngineNode::getUpcomingStartInRange (std::nullopt, range));
+        CHECK_EQ (TracktionEngineNode::getUpcomingStartInRange (3_tp, range), 3_tp);
+        CHECK_EQ (TracktionEngineNode::getUpcomingStartInRange (2_tp, range), 2_tp);
+        CHECK (! TracktionEngineNode::getUpcomingStartInRange (4_tp, range));
+
+        // Items starting within the lead-in after the position start from the beginning
+        CHECK_EQ (TracktionEngineNode::getUpcomingStartInRange (1_tp, range), 2_tp);
+        CHECK_EQ (TracktionEngineNode::getUpcomingStartInRange (0.5_tp, range), 2_tp);
+        CHECK (! TracktionEngineNode::getUpcomingStartInRange (0_tp, range));
+
+        CHECK_EQ (TracktionEngineNode::getUpcomingStartInRange (0_tp, range, TimeDuration::fromSeconds (3.0)), 2_tp);
+        CHECK (! TracktionEngineNode::getUpcomingStartInRange (1_tp, range, TimeDuration::fromSeconds (0.5)));
+    }
+
+    TEST_CASE ("WaveNode caches a clip starting just after a stopped playhead")
+    {
+        using namespace std::literals;
+        auto& engine = *Engine::getEngines()[0];
+        auto& cache = engine.getAudioFileManager().cache;
+        const double sampleRate = 44100.0;
+        const int blockSize = 256;
+
+        // The clip plays from 3s into the file so the data it starts with isn't
+        // near the start of the file where the reader is first positioned
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (sampleRate, 10.0);
+        AudioFile sinAudioFile (engine, sinFile->getFile());
+        const TimeRange clipRange (1_tp, 3_tp);
+        const auto clipOffset = TimeDuration::fromSeconds (3.0);
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState (playHead);
+        ProcessState processState (playHeadState);
+
+        auto node = makeNode<WaveNode> (sinAudioFile, clipRange, clipOffset, TimeRange(), LiveClipLevel(), 1.0,
+                                        juce::AudioChannelSet::canonicalChannelSet (sinAudioFile.getNumChannels()),
+                                        juce::AudioChannelSet::canonicalChannelSet (1),
+                                        processState, EditItemID::fromRawID (1), false);
+        TracktionNodePlayer player (std::move (node), processState, sampleRate, blockSize,
+                                    getPoolCreatorFunction (ThreadPoolStrategy::realTime));
+        player.setNumThreads (0);
+
+        int64_t referenceSamplePosition = 0;
+        choc::buffer::ChannelArrayBuffer<float> audio (1, (choc::buffer::FrameCount) blockSize);
+        MidiMessageArray midi;
+
+        auto processNextBlock = [&]
+        {
+            audio.clear();
+            midi.clear();
+            player.process ({ (choc::buffer::FrameCount) blockSize, { referenceSamplePosition, referenceSamplePosition + blockSize },
+                              { audio.getView(), midi } });
+            referenceSamplePosition += blockSize;
+        };
+
+        playHead.stop();
+        playHead.setPosition (toSamples (0.5_tp, sampleRate));
+
+        // Whilst stopped, the start of the clip should be mapped ready to play
+        const auto clipStartFileSample = toSamples (toPosition (clipOffset), sinAudioFile.getSampleRate());
+
+        for (int i = 0; i < 200 && ! cache.hasMappedReader (sinAudioFile, clipStartFileSample); ++i)
+        {
+            processNextBlock();
+            std::this_thread::sleep_for (10ms);
+        }
+
+        REQUIRE (cache.hasMappedReader (sinAudioFile, clipStartFileSample));
+        cache.resetStatistics();
+
+        // Play up to and in to the clip without waiting for the cache
+        playHead.play();
+        const auto numBlocksToClip = (int) (toSamples (clipRange.getStart() - 0.5_tp, sampleRate) / blockSize);
+        float peakInClip = 0.0f;
+
+        for (int i = 0; i < numBlocksToClip + 4; ++i)
+        {
+            processNextBlock();
+
+            if (i > numBlocksToClip)
+                for (choc::buffer::FrameCount f = 0; f < audio.getNumFrames(); ++f)
+                    peakInClip = std::max (peakInClip, std::abs (audio.getSample (0, f)));
+        }
+
+        CHECK (peakInClip > 0.5f);
+
+        for (auto& fileStats : cache.getFileStatistics())
+        {
+            if (fileStats.file == sinAudioFile)
+            {
+                CHECK (fileStats.reads.numHits > 0);
+                CHECK (fileStats.reads.numMisses == 0);
+            }
+        }
+    }
+}
+
 #endif
 
 // Currently only works with RubberBand
@@ -0,0 +1,160 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+juce::var AudioCallbackTelemetry::Snapshot::toJSON() const
+{
+    auto obj = new juce::DynamicObject();
+    obj->setProperty ("numCallbacks", (juce::int64) numCallbacks);
+    obj->setProperty ("numMissedDeadlines", (juce::int64) numMissedDeadlines);
+    obj->setProperty ("maxLoad", maxLoad);
+    obj->setProperty ("deadlineSeconds", deadlineSeconds);
+    obj->setProperty ("callbackSeconds", callbackSeconds);
+    obj->setProperty ("graphSeconds", graphSeconds);
+    obj->setProperty ("pluginSeconds", pluginSeconds);
+    obj->setProperty ("fileCacheWaitSeconds", fileCacheWaitSeconds);
+    obj->setProperty ("idleSeconds", getIdleSeconds());
+
+    juce::Array<juce::var> bins;
+
+    for (auto count : histogram)
+        bins.add ((juce::int64) count);
+
+    obj->setProperty ("histogram", bins);
+
+    juce::Array<juce::var> missed;
+
+    for (auto& md : recentMissedDeadlines)
+    {
+        auto mdObj = new juce::DynamicObject();
+        mdObj->setProperty ("index", (juce::int64) md.index);
+        mdObj->setProperty ("timeMs", md.timeMs);
+        mdObj->setProperty ("streamTime", md.streamTime);
+        mdObj->setProperty ("durationSeconds", md.durationSeconds);
+        mdObj->setProperty ("deadlineSeconds", md.deadlineSeconds);
+        missed.add (mdObj);
+    }
+
+    obj->setProperty ("missedDeadlines", missed);
+
+    return obj;
+}
+
+//==============================================================================
+AudioCallbackTelemetry::Snapshot AudioCallbackTelemetry::getSnapshot() const
+{
+    auto ticksToSeconds = [] (const std::atomic<juce::int64>& ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds (ticks.load (std::memory_order_relaxed));
+    };
+
+    Snapshot s;
+    s.numCallbacks = numCallbacks.load (std::memory_order_relaxed);
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        s.histogram[i] = histogram[i].load (std::memory_order_relaxed);
+
+    s.numMissedDeadlines = numMissedDeadlines.load (std::memory_order_acquire);
+    s.recentMissedDeadlines = getMissedDeadlinesSince (0);
+
+    s.maxLoad = maxLoad.load (std::memory_order_relaxed);
+    s.deadlineSeconds = deadlineSeconds.load (std::memory_order_relaxed);
+    s.callbackSeconds = ticksToSeconds (callbackTicks);
+    s.graphSeconds = ticksToSeconds (graphTicks);
+    s.pluginSeconds = ticksToSeconds (pluginTicks);
+    s.fileCacheWaitSeconds = ticksToSeconds (fileCacheWaitTicks);
+
+    return s;
+}
+
+std::vector<AudioCallbackTelemetry::MissedDeadline> AudioCallbackTelemetry::getMissedDeadlinesSince (uint64_t index) const
+{
+    const auto numMissed = numMissedDeadlines.load (std::memory_order_acquire);
+    const auto first = std::max (index, numMissed > (uint64_t) maxNumMissedDeadlines ? numMissed - (uint64_t) maxNumMissedDeadlines : 0);
+
+    std::vector<MissedDeadline> result;
+
+    for (auto i = first; i < numMissed; ++i)
+    {
+        // If it's been overwritten since numMissed was read it'll have a later index
+        auto md = missedDeadlines[(size_t) (i % maxNumMissedDeadlines)].load();
+
+        if (md.index == i)
+            result.push_back (md);
+    }
+
+    return result;
+}
+
+void AudioCallbackTelemetry::reset()
+{
+    if (isActive())
+        resetFlag = true;
+    else
+        clear();
+}
+
+//==============================================================================
+void AudioCallbackTelemetry::callbackStarted()
+{
+    active.store (true, std::memory_order_relaxed);
+
+    if (resetFlag.exchange (false))
+        clear();
+}
+
+void AudioCallbackTelemetry::callbackFinished (juce::int64 startTicks, juce::int64 graphTicksThisTime,
+                                               double deadlineSecondsThisTime, double streamTime)
+{
+    const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+    const auto durationSeconds = juce::Time::highResolutionTicksToSeconds (ticks);
+    const auto load = deadlineSecondsThisTime > 0.0 ? durationSeconds / deadlineSecondsThisTime : 0.0;
+
+    // There's only one writer so these don't need to be read-modify-writes
+    auto increment = [] (std::atomic<uint64_t>& v) { v.store (v.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed); };
+
+    increment (numCallbacks);
+    increment (histogram[(size_t) std::clamp ((int) (load * (numHistogramBins / 2)), 0, numHistogramBins - 1)]);
+
+    if (load > maxLoad.load (std::memory_order_relaxed))
+        maxLoad.store (load, std::memory_order_relaxed);
+
+    deadlineSeconds.store (deadlineSeconds.load (std::memory_order_relaxed) + deadlineSecondsThisTime, std::memory_order_relaxed);
+    callbackTicks.fetch_add (ticks, std::memory_order_relaxed);
+    graphTicks.fetch_add (graphTicksThisTime, std::memory_order_relaxed);
+
+    if (load > 1.0)
+    {
+        const auto index = numMissedDeadlines.load (std::memory_order_relaxed);
+        missedDeadlines[(size_t) (index % maxNumMissedDeadlines)].store ({ index, juce::Time::currentTimeMillis(), streamTime,
+                                                                           durationSeconds, deadlineSecondsThisTime });
+        numMissedDeadlines.store (index + 1, std::memory_order_release);
+    }
+}
+
+void AudioCallbackTelemetry::clear()
+{
+    numCallbacks = 0;
+    numMissedDeadlines = 0;
+
+    for (auto& bin : histogram)
+        bin = 0;
+
+    maxLoad = 0.0;
+    deadlineSeconds = 0.0;
+    callbackTicks = 0;
+    graphTicks = 0;
+    pluginTicks = 0;
+    fileCacheWaitTicks = 0;
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,130 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Collects detailed timing information about the DeviceManager's audio
+    callbacks, for monitoring the real-time health of the engine.
+
+    Each callback is measured against its deadline, i.e. the duration of the
+    block it's processing, and is added to a histogram. Any callbacks that take
+    longer than their deadline are logged along with when they happened.
+    Time is also broken down into that spent processing the playback graph,
+    plugins and waiting for the AudioFileCache, and the time left idle.
+
+    Everything is written from the audio threads without locking and can be
+    read from any thread with getSnapshot. To stream the missed deadlines,
+    call getMissedDeadlinesSince periodically with the last index you saw.
+
+    Get the DeviceManager's instance from DeviceManager::getAudioCallbackTelemetry().
+*/
+class AudioCallbackTelemetry
+{
+public:
+    //==============================================================================
+    AudioCallbackTelemetry() = default;
+
+    /** The number of bins in the histogram.
+        Each covers 5% of the deadline, with the last holding everything over 195%.
+    */
+    static constexpr int numHistogramBins = 40;
+
+    /** The number of missed deadlines that are kept. */
+    static constexpr int maxNumMissedDeadlines = 256;
+
+    /** Describes a callback that took longer than its deadline. */
+    struct MissedDeadline
+    {
+        uint64_t index = 0;             /**< The position of this in the list of all missed deadlines. */
+        juce::int64 timeMs = 0;         /**< The wall-clock time, as returned by juce::Time::currentTimeMillis(). */
+        double streamTime = 0.0;        /**< The DeviceManager's stream time at the start of the callback. */
+        double durationSeconds = 0.0;   /**< How long the callback took. */
+        double deadlineSeconds = 0.0;   /**< The duration of the block being processed. */
+    };
+
+    /** A copy of the telemetry collected since it was last reset. */
+    struct Snapshot
+    {
+        uint64_t numCallbacks = 0;
+        std::array<uint64_t, numHistogramBins> histogram {};
+
+        uint64_t numMissedDeadlines = 0;
+        std::vector<MissedDeadline> recentMissedDeadlines;
+
+        double maxLoad = 0.0;                   /**< The longest callback as a proportion of its deadline. */
+        double deadlineSeconds = 0.0;           /**< The sum of all the callbacks' deadlines. */
+        double callbackSeconds = 0.0;           /**< The time spent in the callbacks. */
+        double graphSeconds = 0.0;              /**< The time spent processing the playback graphs. */
+        double pluginSeconds = 0.0;             /**< The time spent in plugins, summed over all the threads that process them. */
+        double fileCacheWaitSeconds = 0.0;      /**< The time spent waiting for AudioFileCache readers, summed over all threads. */
+
+        /** Returns the time that wasn't spent in the callbacks. */
+        double getIdleSeconds() const           { return std::max (0.0, deadlineSeconds - callbackSeconds); }
+
+        /** Returns a time as a proportion of the sum of the deadlines. */
+        double getShareOfDeadline (double seconds) const    { return deadlineSeconds > 0.0 ? seconds / deadlineSeconds : 0.0; }
+
+        /** Returns the upper bound of a histogram bin, as a proportion of the deadline. */
+        static double getBinUpperBound (int bin)    { return (bin + 1) / (double) (numHistogramBins / 2); }
+
+        /** Returns a JSON object describing this, e.g. for sending to a monitoring service. */
+        juce::var toJSON() const;
+    };
+
+    /** Returns a copy of the current telemetry. */
+    Snapshot getSnapshot() const;
+
+    /** Returns any missed deadlines with an index greater or equal to the one given.
+        Only the most recent maxNumMissedDeadlines are kept so if this is called
+        too infrequently, some may have been lost.
+    */
+    std::vector<MissedDeadline> getMissedDeadlinesSince (uint64_t index) const;
+
+    /** Clears all the telemetry.
+        The clear happens on the next callback so may not be immediately visible.
+    */
+    void reset();
+
+    //==============================================================================
+    /** @internal. Called by the DeviceManager at the start of each callback. */
+    void callbackStarted();
+    /** @internal. Called by the DeviceManager at the end of each callback. */
+    void callbackFinished (juce::int64 startTicks, juce::int64 graphTicks, double deadlineSeconds, double streamTime);
+
+    /** @internal. Adds time spent in a plugin. */
+    void addPluginTime (juce::int64 ticks) noexcept             { if (isActive()) pluginTicks.fetch_add (ticks, std::memory_order_relaxed); }
+    /** @internal. Adds time spent waiting for a file reader. */
+    void addFileCacheWaitTime (juce::int64 ticks) noexcept      { if (isActive()) fileCacheWaitTicks.fetch_add (ticks, std::memory_order_relaxed); }
+
+    /** @internal. Returns true if there are callbacks being measured. */
+    bool isActive() const noexcept                              { return active.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    std::atomic<bool> active { false }, resetFlag { false };
+
+    std::atomic<uint64_t> numCallbacks { 0 }, numMissedDeadlines { 0 };
+    std::array<std::atomic<uint64_t>, numHistogramBins> histogram {};
+    std::array<crill::seqlock_object<MissedDeadline>, maxNumMissedDeadlines> missedDeadlines;
+
+    std::atomic<double> maxLoad { 0.0 }, deadlineSeconds { 0.0 };
+    std::atomic<juce::int64> callbackTicks { 0 }, graphTicks { 0 }, pluginTicks { 0 }, fileCacheWaitTicks { 0 };
+
+    void clear();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioCallbackTelemetry)
+};
+
+}} // namespace tracktion { inline namespace engine
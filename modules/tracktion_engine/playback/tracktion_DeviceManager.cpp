@@ -1512,6 +1512,11 @@ void DeviceManager::audioDeviceIOCallbackInternal (const float* const* inputChan
                                                    float* const* outputChannelData, int totalNumOutputChannels,
                                                    int numSamples)
 {
+    const auto callbackStartTicks = juce::Time::getHighResolutionTicks();
+    const auto callbackStreamTime = streamTime;
+    juce::int64 graphTicks = 0;
+    audioCallbackTelemetry.callbackStarted();
+
     {
         engine.getAudioFileManager().cache.nextBlockStarted();
 
@@ -1535,6 +1540,7 @@ void DeviceManager::audioDeviceIOCallbackInternal (const float* const* inputChan
 
             {
                 SCOPED_REALTIME_CHECK
+                const auto graphStartTicks = juce::Time::getHighResolutionTicks();
                 const std::shared_lock sl (contextLock);
 
                 for (auto c : activeContexts)
@@ -1553,6 +1559,8 @@ void DeviceManager::audioDeviceIOCallbackInternal (const float* const* inputChan
 
                 for (auto c : activeContexts)
                     c->fillNextNodeBlock (outputChannelData, totalNumOutputChannels, numSamples);
+
+                graphTicks = juce::Time::getHighResolutionTicks() - graphStartTicks;
             }
 
             for (int i = totalNumOutputChannels; --i >= 0;)
@@ -1615,6 +1623,8 @@ void DeviceManager::audioDeviceIOCallbackInternal (const float* const* inputChan
     }
 
     performanceStats.store (performanceMeasurement.getStatistics());
+    audioCallbackTelemetry.callbackFinished (callbackStartTicks, graphTicks,
+                                             numSamples / currentSampleRate, callbackStreamTime);
 }
 
 void DeviceManager::audioDeviceAboutToStart (juce::AudioIODevice* device)
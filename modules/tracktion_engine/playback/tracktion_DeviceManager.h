@@ -71,6 +71,11 @@ public:
     PerformanceMeasurement::Statistics getCPUStatistics() const;
     void restCPUStatistics();
 
+    /** Returns the detailed timing information for the audio callbacks, e.g. for
+        monitoring missed deadlines.
+    */
+    AudioCallbackTelemetry& getAudioCallbackTelemetry() noexcept    { return audioCallbackTelemetry; }
+
     void updateNumCPUs(); // should be called when active num CPUs is changed
 
     //==============================================================================
@@ -280,6 +285,7 @@ private:
     PerformanceMeasurement performanceMeasurement { "tracktion_engine::DeviceManager", -1, false };
     crill::seqlock_object<PerformanceMeasurement::Statistics> performanceStats;
     std::atomic<bool> clearStatsFlag { false };
+    AudioCallbackTelemetry audioCallbackTelemetry;
 
     void applyNewMidiDeviceList();
     void restartMidiCheckTimer();
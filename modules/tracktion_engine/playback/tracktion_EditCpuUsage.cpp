@@ -0,0 +1,303 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+namespace edit_cpu_usage
+{
+    /** The items a Node's processing time is charged to. */
+    struct NodeOwner
+    {
+        EditItemID trackID, clipID, pluginID;
+    };
+
+    /** Finds the items a Node belongs to from the IDs the clip, track and plugin Nodes hold. */
+    class NodeOwnerFinder
+    {
+    public:
+        NodeOwnerFinder (Edit& e)
+            : edit (e)
+        {
+            visitAllTrackItems (edit, [this] (TrackItem& item)
+                                {
+                                    trackForClip[item.itemID] = item.getTrackID();
+                                    return true;
+                                });
+        }
+
+        std::optional<NodeOwner> getDirectOwner (tracktion::graph::Node& node) const
+        {
+            if (auto pluginNode = dynamic_cast<PluginNode*> (&node))
+                return getOwnerOfPlugin (pluginNode->getPlugin());
+
+            if (auto clipID = getClipID (node); clipID.isValid())
+                if (auto found = trackForClip.find (clipID); found != trackForClip.end())
+                    return NodeOwner { found->second, clipID, {} };
+
+            if (auto trackID = getTrackID (node); trackID.isValid())
+                if (findTrackForID (edit, trackID) != nullptr)
+                    return NodeOwner { trackID, {}, {} };
+
+            return std::nullopt;
+        }
+
+    private:
+        Edit& edit;
+        std::unordered_map<EditItemID, EditItemID> trackForClip;
+
+        NodeOwner getOwnerOfPlugin (Plugin& plugin) const
+        {
+            NodeOwner owner { {}, {}, plugin.itemID };
+
+            if (auto clip = plugin.getOwnerClip())
+            {
+                owner.clipID = clip->itemID;
+                owner.trackID = clip->getTrackID();
+            }
+            else if (auto track = plugin.getOwnerTrack())
+            {
+                owner.trackID = track->itemID;
+            }
+
+            return owner;
+        }
+
+        static EditItemID getClipID (tracktion::graph::Node& node)
+        {
+            if (auto n = dynamic_cast<WaveNode*> (&node))            return n->getItemID();
+            if (auto n = dynamic_cast<WaveNodeRealTime*> (&node))    return n->getItemID();
+            if (auto n = dynamic_cast<SpeedRampWaveNode*> (&node))   return n->getItemID();
+            if (auto n = dynamic_cast<MidiNode*> (&node))            return n->getItemID();
+            if (auto n = dynamic_cast<LoopingMidiNode*> (&node))     return n->getItemID();
+            if (auto n = dynamic_cast<ContainerClipNode*> (&node))   return n->getItemID();
+
+            return {};
+        }
+
+        static EditItemID getTrackID (tracktion::graph::Node& node)
+        {
+            if (auto n = dynamic_cast<CombiningNode*> (&node))       return n->getItemID();
+            if (auto n = dynamic_cast<StemTapNode*> (&node))         return n->getTrackID();
+
+            return {};
+        }
+    };
+
+    /** Nodes that aren't owned by an item, such as latency or fade Nodes, take
+        the track and clip of their inputs if they all agree.
+    */
+    static NodeOwner getInheritedOwner (tracktion::graph::Node& node,
+                                        const std::unordered_map<tracktion::graph::Node*, NodeOwner>& owners)
+    {
+        auto inputs = node.getDirectInputNodes();
+
+        if (inputs.empty())
+            return {};
+
+        std::optional<NodeOwner> inherited;
+
+        for (auto input : inputs)
+        {
+            auto found = owners.find (input);
+
+            if (found == owners.end())
+                return {};
+
+            if (! inherited)
+            {
+                inherited = NodeOwner { found->second.trackID, found->second.clipID, {} };
+                continue;
+            }
+
+            if (inherited->trackID != found->second.trackID)
+                return {};
+
+            if (inherited->clipID != found->second.clipID)
+                inherited->clipID = {};
+        }
+
+        return *inherited;
+    }
+
+    static void addUsage (std::unordered_map<EditItemID, EditCpuUsage::ItemUsage>& usages,
+                          EditItemID itemID, double proportion, double peakSeconds)
+    {
+        if (! itemID.isValid())
+            return;
+
+        auto& usage = usages[itemID];
+        usage.itemID = itemID;
+        usage.proportionOfCore += proportion;
+        usage.peakNodeSeconds = std::max (usage.peakNodeSeconds, peakSeconds);
+    }
+
+    static std::vector<EditCpuUsage::ItemUsage> toSortedVector (const std::unordered_map<EditItemID, EditCpuUsage::ItemUsage>& usages)
+    {
+        std::vector<EditCpuUsage::ItemUsage> result;
+        result.reserve (usages.size());
+
+        for (auto& [itemID, usage] : usages)
+            result.push_back (usage);
+
+        std::sort (result.begin(), result.end(),
+                   [] (auto& a, auto& b) { return a.proportionOfCore > b.proportionOfCore; });
+
+        return result;
+    }
+}
+
+//==============================================================================
+const EditCpuUsage::ItemUsage* EditCpuUsage::Snapshot::find (EditItemID itemID) const
+{
+    for (auto list : { &tracks, &plugins, &clips })
+        for (auto& usage : *list)
+            if (usage.itemID == itemID)
+                return &usage;
+
+    return nullptr;
+}
+
+//==============================================================================
+EditCpuUsage::EditCpuUsage (Edit& e)
+    : edit (e)
+{
+}
+
+EditCpuUsage::~EditCpuUsage()
+{
+    stopTimer();
+
+    if (auto epc = getPlaybackContext())
+        epc->setNodeProfiler (nullptr);
+}
+
+void EditCpuUsage::setEnabled (bool shouldBeEnabled, int updateIntervalMs)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (! shouldBeEnabled)
+    {
+        stopTimer();
+
+        // The Nodes are left pointing at the profiler until the graph is rebuilt,
+        // so it's kept but stops accepting events
+        if (profiler != nullptr)
+            profiler->setEnabled (false);
+
+        if (auto epc = getPlaybackContext())
+            epc->setNodeProfiler (nullptr);
+
+        snapshot = std::make_shared<Snapshot>();
+        return;
+    }
+
+    if (profiler == nullptr)
+        profiler = std::make_unique<tracktion::graph::NodeProfiler> (65536, 1);
+
+    const bool wasEnabled = isEnabled();
+    profiler->reset();
+    profiler->setEnabled (true);
+    lastNumDroppedEvents = 0;
+    lastUpdateTime = juce::Time::getMillisecondCounterHiRes();
+
+    if (auto epc = getPlaybackContext())
+    {
+        epc->setNodeProfiler (profiler.get());
+
+        if (! wasEnabled && isAvailable())
+            edit.restartPlayback();
+    }
+
+    startTimer (std::max (100, updateIntervalMs));
+}
+
+//==============================================================================
+void EditCpuUsage::timerCallback()
+{
+    CRASH_TRACER
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto intervalSeconds = (now - std::exchange (lastUpdateTime, now)) / 1000.0;
+
+    auto epc = getPlaybackContext();
+
+    if (epc == nullptr || intervalSeconds <= 0.0)
+        return;
+
+    // The context might have been recreated since the last update
+    epc->setNodeProfiler (profiler.get());
+
+    snapshot = std::make_shared<Snapshot> (createSnapshot (*epc, intervalSeconds));
+
+    if (onSnapshotUpdated)
+        onSnapshotUpdated (*snapshot);
+}
+
+EditPlaybackContext* EditCpuUsage::getPlaybackContext() const
+{
+    return edit.getTransport().getCurrentPlaybackContext();
+}
+
+EditCpuUsage::Snapshot EditCpuUsage::createSnapshot (EditPlaybackContext& epc, double intervalSeconds)
+{
+    using namespace edit_cpu_usage;
+
+    Snapshot newSnapshot;
+    newSnapshot.intervalSeconds = intervalSeconds;
+
+    const auto numDropped = profiler->getNumDroppedEvents();
+    newSnapshot.numDroppedEvents = numDropped - std::exchange (lastNumDroppedEvents, numDropped);
+
+    auto statistics = profiler->getStatisticsAndReset();
+
+    if (statistics.empty())
+        return newSnapshot;
+
+    // Nodes are visited inputs first so any Node inheriting its owner can look up its inputs'
+    NodeOwnerFinder ownerFinder (edit);
+    std::unordered_map<tracktion::graph::Node*, NodeOwner> owners;
+    std::unordered_map<EditItemID, ItemUsage> trackUsages, pluginUsages, clipUsages;
+
+    epc.visitNodes ([&] (tracktion::graph::Node& node)
+    {
+        auto directOwner = ownerFinder.getDirectOwner (node);
+        const auto owner = directOwner ? *directOwner : getInheritedOwner (node, owners);
+        owners[&node] = owner;
+
+        const auto nodeID = node.getNodeProperties().nodeID;
+        auto found = statistics.find (nodeID);
+
+        if (nodeID == 0 || found == statistics.end())
+            return;
+
+        const auto& stats = found->second.statistics;
+        const auto proportion = stats.totalSeconds / intervalSeconds;
+
+        // Nodes can share an ID so only count each one's time once
+        statistics.erase (found);
+
+        newSnapshot.totalProportion += proportion;
+
+        if (! owner.trackID.isValid())
+            newSnapshot.unattributedProportion += proportion;
+
+        addUsage (trackUsages, owner.trackID, proportion, stats.maximumSeconds);
+        addUsage (clipUsages, owner.clipID, proportion, stats.maximumSeconds);
+        addUsage (pluginUsages, owner.pluginID, proportion, stats.maximumSeconds);
+    });
+
+    newSnapshot.tracks = toSortedVector (trackUsages);
+    newSnapshot.plugins = toSortedVector (pluginUsages);
+    newSnapshot.clips = toSortedVector (clipUsages);
+
+    return newSnapshot;
+}
+
+} // namespace tracktion::inline engine
@@ -0,0 +1,111 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion::inline engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Measures how much processing time each Track, Plugin and Clip in an Edit
+    is using, to find out which ones are most expensive.
+
+    While enabled, the Nodes in the Edit's playback graph add their processing
+    times to a NodeProfiler. The audio threads only push to a lock-free FIFO, so
+    they are never blocked. A timer on the message thread then collects the times
+    and charges each Node to the items it belongs to. Nodes such as the summing
+    and latency Nodes added when the graph is built are charged to the items of
+    their inputs. Nodes fed by more than one track, such as the master mix, are
+    reported as unattributed.
+
+    The results are published as an immutable Snapshot. Only items that used some
+    time are listed, so the Snapshot stays small for large Edits.
+
+    This needs TRACKTION_GRAPH_NODE_PROFILING to be enabled. Without it, no
+    times are measured and the Snapshots are always empty.
+
+    Every Edit has one of these. @see Edit::getCpuUsage
+*/
+class EditCpuUsage  : private juce::Timer
+{
+public:
+    /** Creates an EditCpuUsage for an Edit. It's disabled by default. */
+    EditCpuUsage (Edit&);
+
+    /** Destructor. */
+    ~EditCpuUsage() override;
+
+    //==============================================================================
+    /** Returns true if Nodes can be profiled in this build. */
+    static constexpr bool isAvailable()     { return TRACKTION_GRAPH_NODE_PROFILING != 0; }
+
+    /** Starts or stops measuring, publishing a new Snapshot at the given interval.
+        Nodes only start being measured once the graph is next built, so this
+        restarts playback when measuring is first enabled.
+        This must be called on the message thread.
+    */
+    void setEnabled (bool shouldBeEnabled, int updateIntervalMs = 1000);
+
+    /** Returns true if measuring is enabled. */
+    bool isEnabled() const noexcept         { return isTimerRunning(); }
+
+    //==============================================================================
+    /** The processing time used by an item over the last update interval. */
+    struct ItemUsage
+    {
+        EditItemID itemID;
+        double proportionOfCore = 0.0;  ///< The time used per second, as a proportion of one core
+        double peakNodeSeconds = 0.0;   ///< The longest time one of the item's Nodes took to process a block
+    };
+
+    /** The processing time used by an Edit's items over the last update interval.
+        The proportions are of one CPU core so, as the graph is processed on
+        multiple threads, the totals can be greater than 1.
+    */
+    struct Snapshot
+    {
+        std::vector<ItemUsage> tracks;      ///< Tracks, including their clips and plugins, most expensive first
+        std::vector<ItemUsage> plugins;     ///< Plugins, most expensive first
+        std::vector<ItemUsage> clips;       ///< Clips, including their clip plugins, most expensive first
+
+        double unattributedProportion = 0.0;    ///< Nodes not owned by any track, such as the master mix
+        double totalProportion = 0.0;           ///< All the Nodes in the graph
+        double intervalSeconds = 0.0;           ///< The length of time the usage was measured over
+        size_t numDroppedEvents = 0;            ///< Timings lost because the FIFO filled up
+
+        /** Returns the usage of a track, plugin or clip, or nullptr if it didn't use any time. */
+        const ItemUsage* find (EditItemID) const;
+    };
+
+    /** Returns the most recently published Snapshot.
+        This is never nullptr, but is empty until the first update after enabling.
+        This must be called on the message thread.
+    */
+    std::shared_ptr<const Snapshot> getSnapshot() const     { return snapshot; }
+
+    /** Called on the message thread each time a new Snapshot is published. */
+    std::function<void (const Snapshot&)> onSnapshotUpdated;
+
+private:
+    //==============================================================================
+    Edit& edit;
+    std::unique_ptr<tracktion::graph::NodeProfiler> profiler;
+    std::shared_ptr<const Snapshot> snapshot { std::make_shared<Snapshot>() };
+    double lastUpdateTime = 0.0;
+    size_t lastNumDroppedEvents = 0;
+
+    void timerCallback() override;
+    EditPlaybackContext* getPlaybackContext() const;
+    Snapshot createSnapshot (EditPlaybackContext&, double intervalSeconds);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditCpuUsage)
+};
+
+} // namespace tracktion::inline engine
@@ -33,12 +33,72 @@ namespace EditPlaybackContextInternal
         return useSharing;
     }
 
+    inline bool& getStaticBufferAllocationFlag()
+    {
+        static bool useStaticBuffers = false;
+        return useStaticBuffers;
+    }
+
+    inline bool& getSharedLatencyCompensationFlag()
+    {
+        static bool useSharedLatencyCompensation = false;
+        return useSharedLatencyCompensation;
+    }
+
+    inline bool& getCriticalPathSchedulingFlag()
+    {
+        static bool useCriticalPath = false;
+        return useCriticalPath;
+    }
+
+    inline bool& getChainFusionFlag()
+    {
+        static bool useChainFusion = false;
+        return useChainFusion;
+    }
+
+    inline bool& getSinglePassLoopWrapsFlag()
+    {
+        static bool useSinglePassLoopWraps = false;
+        return useSinglePassLoopWraps;
+    }
+
+    inline bool& getAutoThreadTuningFlag()
+    {
+        static bool useAutoThreadTuning = false;
+        return useAutoThreadTuning;
+    }
+
     inline bool& getAudioWorkgroupFlag()
     {
         static bool useAudioWorkgroup = false;
         return useAudioWorkgroup;
     }
 
+    inline bool& getAnticipativeRenderingFlag()
+    {
+        static bool useAnticipativeRendering = false;
+        return useAnticipativeRendering;
+    }
+
+    inline int& getFixedProcessingBlockSize()
+    {
+        static int fixedBlockSize = 0;
+        return fixedBlockSize;
+    }
+
+    inline int& getNumGraphBuildingThreads()
+    {
+        static int numThreads = 0;
+        return numThreads;
+    }
+
+    inline TimeDuration& getClipWindowLength()
+    {
+        static TimeDuration windowLength;
+        return windowLength;
+    }
+
     inline juce::AudioWorkgroup getAudioWorkgroupIfEnabled (Engine& e)
     {
         if (! getAudioWorkgroupFlag())
@@ -56,6 +116,41 @@ namespace EditPlaybackContextInternal
         return wg ? wg.getMaxParallelThreadCount() - 1
                   : static_cast<size_t> (juce::SystemStats::getNumCpus() - 1);
     }
+
+    /** Calls finishRecordingFiles for each input, sharing them between some
+        worker threads and the calling thread.
+    */
+    inline void finishRecordingFilesInParallel (const juce::Array<InputDeviceInstance*>& inputs,
+                                                const std::vector<EditItemID>& targetsToStop)
+    {
+        CRASH_TRACER
+        std::atomic<int> nextInput { 0 };
+
+        auto finishInputs = [&]
+        {
+            for (;;)
+            {
+                const auto index = nextInput++;
+
+                if (index >= inputs.size())
+                    return;
+
+                inputs.getUnchecked (index)->finishRecordingFiles (targetsToStop);
+            }
+        };
+
+        const auto numCores = static_cast<int> (std::max (1u, std::thread::hardware_concurrency()));
+        const auto numThreads = std::min (inputs.size(), numCores) - 1;
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.emplace_back (finishInputs);
+
+        finishInputs();
+
+        for (auto& t : threads)
+            t.join();
+    }
 }
 
 
@@ -171,7 +266,7 @@ struct EditPlaybackContext::NodePlaybackContext
     NodePlaybackContext (EditPlaybackContext& epc, size_t numThreads, size_t maxNumThreadsToUse)
         : editPlaybackContext (epc),
           player (processState,
-                  getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (getThreadPoolStrategy())),
+                  getThreadPoolCreator (epc.edit.engine, &epc.edit),
                   EditPlaybackContextInternal::getAudioWorkgroupIfEnabled (tempoSequence.edit.engine)),
           maxNumThreads (maxNumThreadsToUse)
     {
@@ -190,6 +285,12 @@ struct EditPlaybackContext::NodePlaybackContext
         setNumThreads (numThreads);
         player.enablePooledMemoryAllocations (EditPlaybackContextInternal::getPooledMemoryFlag());
         player.enableNodeMemorySharing (EditPlaybackContextInternal::getNodeMemorySharingFlag());
+        player.enableStaticBufferAllocation (EditPlaybackContextInternal::getStaticBufferAllocationFlag());
+        player.enableSharedLatencyCompensation (EditPlaybackContextInternal::getSharedLatencyCompensationFlag());
+        player.enableCriticalPathScheduling (EditPlaybackContextInternal::getCriticalPathSchedulingFlag());
+        player.enableChainFusion (EditPlaybackContextInternal::getChainFusionFlag());
+        player.enableSinglePassLoopWraps (EditPlaybackContextInternal::getSinglePassLoopWrapsFlag());
+        player.setDeferredDeleter (&epc.edit.engine.getDeferredDeleter());
     }
 
     void setNumThreads (size_t numThreads)
@@ -198,6 +299,22 @@ struct EditPlaybackContext::NodePlaybackContext
         player.setNumThreads (std::min (numThreads, maxNumThreads));
     }
 
+    size_t getNumThreads() const
+    {
+        return player.getNumThreads();
+    }
+
+    size_t getMaxNumThreads() const
+    {
+        return maxNumThreads;
+    }
+
+    void setThreadPoolStrategy (tracktion::graph::ThreadPoolStrategy strategy)
+    {
+        CRASH_TRACER
+        player.setThreadPoolCreator (tracktion::graph::getPoolCreatorFunction (strategy));
+    }
+
     void setNode (std::unique_ptr<Node> node, double sampleRate, int blockSize)
     {
         jassert (sampleRate > 0.0);
@@ -205,14 +322,70 @@ struct EditPlaybackContext::NodePlaybackContext
         blockSize = juce::roundToInt (blockSize * (1.0 + (10.0 * 0.01))); // max speed comp
         player.setLatencyCompensationEnabled (editPlaybackContext.edit.isLatencyCompensationEnabled());
         player.setNode (std::move (node), sampleRate, blockSize);
+        latencyUpdater.reset();
 
         if (auto currentNode = player.getNode())
-            latencySamples = currentNode->getNodeProperties().latencyNumSamples;
+        {
+            const auto& props = currentNode->getNodeProperties();
+            updateBlockSizeMode (props.numberOfChannels, blockSize);
+            latencySamples = props.latencyNumSamples + player.getLatencyNumSamples();
+        }
+    }
+
+    void updateBlockSizeMode (int numChannels, int maxBlockSize)
+    {
+        const auto fixedBlockSize = EditPlaybackContextInternal::getFixedProcessingBlockSize();
+        const auto newSettings = std::make_tuple (fixedBlockSize, numChannels, maxBlockSize);
+
+        if (newSettings == blockSizeModeSettings)
+            return;
+
+        blockSizeModeSettings = newSettings;
+        player.setBlockSizeMode (fixedBlockSize > 0 ? TracktionNodePlayer::BlockSizeMode::fixed
+                                                    : TracktionNodePlayer::BlockSizeMode::splitAtEventsOnly,
+                                 fixedBlockSize, numChannels, maxBlockSize);
     }
 
     void clearNode()
     {
         player.clearNode();
+        latencyUpdater.reset();
+    }
+
+    bool updatePluginLatency (Plugin& plugin)
+    {
+        CRASH_TRACER
+        auto node = player.getNode();
+
+        if (node == nullptr)
+            return false;
+
+        // The updater keeps track of the latencies as they change so needs creating before any do
+        if (latencyUpdater == nullptr || &latencyUpdater->getRootNode() != node)
+            latencyUpdater = std::make_unique<tracktion::graph::LatencyCompensationUpdater> (*node);
+
+        std::vector<tracktion::graph::LatencyCompensationUpdater::LatencyChange> changes;
+
+        for (auto n : tracktion::graph::getNodes (*node, tracktion::graph::VertexOrdering::postordering))
+        {
+            if (auto pluginNode = dynamic_cast<PluginNode*> (n); pluginNode != nullptr && &pluginNode->getPlugin() == &plugin)
+            {
+                if (auto delta = pluginNode->updateLatencyFromPlugin())
+                    changes.push_back ({ pluginNode, *delta });
+                else
+                    return false;
+            }
+        }
+
+        // Plugins in racks don't have their own Nodes so the rack needs rebuilding
+        if (changes.empty() || ! latencyUpdater->applyLatencyChanges (changes))
+        {
+            latencyUpdater.reset();
+            return false;
+        }
+
+        latencySamples = latencyUpdater->getLatencyNumSamples() + player.getLatencyNumSamples();
+        return true;
     }
 
     int getLatencySamples() const
@@ -220,6 +393,49 @@ struct EditPlaybackContext::NodePlaybackContext
         return latencySamples;
     }
 
+    size_t getAllocatedBytes()
+    {
+        auto node = player.getNode();
+
+        if (node == nullptr)
+            return 0;
+
+        size_t numBytes = 0;
+
+        for (auto& nodeAndID : tracktion::graph::createNodeMap (tracktion::graph::getNodes (*node, tracktion::graph::VertexOrdering::postordering)))
+            numBytes += nodeAndID.node->getAllocatedBytes();
+
+        return numBytes;
+    }
+
+    std::string exportGraph (tracktion::graph::GraphExportFormat format, tracktion::graph::NodeProfiler* profiler)
+    {
+        auto node = player.getNode();
+
+        if (node == nullptr)
+            return {};
+
+        return tracktion::graph::exportGraph (*node, format,
+                                              profiler != nullptr ? profiler->getStatistics()
+                                                                  : std::unordered_map<size_t, tracktion::graph::NodeProfiler::NodeStatistics>());
+    }
+
+    void visitNodes (const std::function<void (tracktion::graph::Node&)>& visitor)
+    {
+        auto node = player.getNode();
+
+        if (node == nullptr)
+            return;
+
+        for (auto n : tracktion::graph::getNodes (*node, tracktion::graph::VertexOrdering::postordering))
+            visitor (*n);
+    }
+
+    void setNodeProfiler (tracktion::graph::NodeProfiler* profiler)
+    {
+        player.setNodeProfiler (profiler);
+    }
+
     void postPlay()
     {
         playPending.store (true, std::memory_order_release);
@@ -246,6 +462,7 @@ struct EditPlaybackContext::NodePlaybackContext
 
         pendingRollInToLoop.store (false, std::memory_order_release);
         positionUpdatePending = true;
+        processState.setUpcomingJumpPosition (positionToJumpTo);
     }
 
     std::optional<TimePosition> getPendingPositionChange() const
@@ -261,6 +478,7 @@ struct EditPlaybackContext::NodePlaybackContext
         pendingPosition.store (newPosition, std::memory_order_release);
         pendingRollInToLoop.store (true, std::memory_order_release);
         positionUpdatePending = true;
+        processState.setUpcomingJumpPosition (TimePosition::fromSeconds (newPosition));
     }
 
     void setSpeedCompensation (double plusOrMinus)
@@ -323,6 +541,7 @@ struct EditPlaybackContext::NodePlaybackContext
 
     void process (float* const* allChannels, int numChannels, int destNumSamples)
     {
+        const auto startTicks = measureLoad.load (std::memory_order_relaxed) ? juce::Time::getHighResolutionTicks() : 0;
         const auto referenceSampleRange = getReferenceSampleRange();         // Distpatch pending positions
 
         if (positionUpdatePending.load (std::memory_order_acquire))
@@ -346,6 +565,7 @@ struct EditPlaybackContext::NodePlaybackContext
 
                     pendingPosition = 0.0;
                     positionUpdatePending = false;
+                    processState.setUpcomingJumpPosition ({});
 
                     shouldPerformPositionChange = false;
                 }
@@ -365,6 +585,7 @@ struct EditPlaybackContext::NodePlaybackContext
             {
                 if (positionUpdatePending.exchange (false))
                 {
+                    processState.setUpcomingJumpPosition ({});
                     const auto samplePos = timeToSample (pendingPosition.load (std::memory_order_acquire), sampleRate);
 
                     if (pendingRollInToLoop.load (std::memory_order_acquire))
@@ -412,6 +633,9 @@ struct EditPlaybackContext::NodePlaybackContext
 
         tempoState = { tempoSequence.getInternalSequence().hash(),
                        processState.editBeatRange.getEnd() };
+
+        if (startTicks != 0)
+            loadHistogram.addBlock (juce::Time::getHighResolutionTicks() - startTicks, destNumSamples / getSampleRate());
     }
 
     double getSampleRate() const
@@ -424,6 +648,54 @@ struct EditPlaybackContext::NodePlaybackContext
         return processState.getSyncPoint();
     }
 
+    //==============================================================================
+    /** Counts the blocks processed by their load, i.e. their processing time as a
+        proportion of their duration, in 5% bins.
+        Written by the audio thread and read and cleared by the ThreadTuner.
+    */
+    struct LoadHistogram
+    {
+        static constexpr int numBins = 40;
+
+        void addBlock (juce::int64 ticks, double blockSeconds)
+        {
+            const auto load = blockSeconds > 0.0 ? juce::Time::highResolutionTicksToSeconds (ticks) / blockSeconds : 0.0;
+            bins[(size_t) std::clamp ((int) (load * (numBins / 2)), 0, numBins - 1)].fetch_add (1, std::memory_order_relaxed);
+        }
+
+        /** Returns the number of blocks counted and the load the given proportion
+            of them were under, then starts counting again.
+        */
+        std::pair<uint32_t, double> takePercentile (double proportion)
+        {
+            std::array<uint32_t, numBins> counts;
+            uint32_t total = 0;
+
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                counts[i] = bins[i].exchange (0, std::memory_order_relaxed);
+                total += counts[i];
+            }
+
+            uint32_t cumulative = 0;
+
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                cumulative += counts[i];
+
+                if (cumulative >= proportion * total)
+                    return { total, (double) (i + 1) / (numBins / 2) };
+            }
+
+            return { total, 0.0 };
+        }
+
+        std::array<std::atomic<uint32_t>, numBins> bins {};
+    };
+
+    LoadHistogram loadHistogram;
+    std::atomic<bool> measureLoad { false };
+
     EditPlaybackContext& editPlaybackContext;
     const TempoSequence& tempoSequence { editPlaybackContext.edit.tempoSequence };
     tracktion::graph::PlayHead playHead;
@@ -437,6 +709,8 @@ private:
     const size_t maxNumThreads;
 
     int latencySamples = 0;
+    std::unique_ptr<tracktion::graph::LatencyCompensationUpdater> latencyUpdater;
+    std::tuple<int, int, int> blockSizeModeSettings;
     choc::buffer::FrameCount numSamplesToProcess = 0;
     juce::Range<double> referenceStreamRange;
     std::atomic<double> pendingPosition { 0.0 }, pendingPositionJumpTime { 0.0 };
@@ -466,6 +740,279 @@ private:
     }
 };
 
+//==============================================================================
+//==============================================================================
+/**
+    Finds the ThreadPoolStrategy and number of threads that process the Edit
+    with the lowest load on this machine, buffer size and graph.
+
+    Whilst the Edit is playing, each candidate configuration is used for a
+    window and the 99th percentile of its blocks' loads is measured. The one
+    with the lowest is then used, preferring fewer threads when they're equal,
+    until the load gets too high again when the calibration is repeated.
+    Graphs with too few Nodes to benefit from being processed in parallel
+    don't use any worker threads at all.
+*/
+struct EditPlaybackContext::ThreadTuner  : private juce::Timer
+{
+    ThreadTuner (EditPlaybackContext& epc)
+        : owner (epc)
+    {
+        owner.nodePlaybackContext->measureLoad = true;
+        startTimer (windowMs);
+    }
+
+    ~ThreadTuner() override
+    {
+        owner.nodePlaybackContext->measureLoad = false;
+    }
+
+    /** Called when the graph is rebuilt or the number of CPUs to use changes. */
+    void update (size_t newMaxNumThreads, size_t numNodesInGraph)
+    {
+        newMaxNumThreads = std::min ({ newMaxNumThreads,
+                                       owner.nodePlaybackContext->getMaxNumThreads(),
+                                       numNodesInGraph / minNodesPerThread });
+
+        if (newMaxNumThreads != maxNumThreads || candidates.empty())
+        {
+            maxNumThreads = newMaxNumThreads;
+            startCalibration();
+            return;
+        }
+
+        // Rebuilding the graph resets the number of threads so restore the current candidate
+        apply (getCurrentConfiguration());
+    }
+
+    std::optional<ThreadingConfiguration> getChosenConfiguration() const
+    {
+        if (candidates.empty() || isCalibrating())
+            return {};
+
+        return getCurrentConfiguration();
+    }
+
+private:
+    static constexpr int windowMs = 1000;
+    static constexpr uint32_t minBlocksPerWindow = 32;
+    static constexpr double overloadedLoad = 0.8;
+    static constexpr int numOverloadedWindowsBeforeRecalibrating = 3;
+    static constexpr size_t minNodesPerThread = 8;
+
+    EditPlaybackContext& owner;
+    size_t maxNumThreads = 0;
+    std::vector<ThreadingConfiguration> candidates;
+    std::vector<double> candidateLoads;
+    size_t candidateIndex = 0;
+    int appliedStrategy = EditPlaybackContext::getThreadPoolStrategy();
+    bool skipNextWindow = false;
+    int numOverloadedWindows = 0;
+
+    bool isCalibrating() const
+    {
+        return candidateIndex < candidates.size();
+    }
+
+    ThreadingConfiguration getCurrentConfiguration() const
+    {
+        jassert (! candidates.empty());
+        return candidates[std::min (candidateIndex, candidates.size() - 1)];
+    }
+
+    void startCalibration()
+    {
+        using tracktion::graph::ThreadPoolStrategy;
+
+        // The SharedNodeThreadPool's strategy is shared with other Edits so only the number of threads is tuned
+        const auto strategies = owner.edit.engine.getSharedNodeThreadPool() != nullptr
+                                    ? std::vector<int> { EditPlaybackContext::getThreadPoolStrategy() }
+                                    : std::vector<int> { static_cast<int> (ThreadPoolStrategy::lightweightSemHybrid),
+                                                         static_cast<int> (ThreadPoolStrategy::workStealing),
+                                                         static_cast<int> (ThreadPoolStrategy::realTime),
+                                                         static_cast<int> (ThreadPoolStrategy::hybrid) };
+
+        std::vector<size_t> threadCounts { 0 };
+
+        for (size_t n = 1; n <= maxNumThreads; n *= 2)
+            threadCounts.push_back (n);
+
+        if (threadCounts.back() != maxNumThreads)
+            threadCounts.push_back (maxNumThreads);
+
+        candidates.clear();
+
+        // Candidates are in order of the number of threads so the first of equal loads uses the fewest
+        for (auto numThreads : threadCounts)
+        {
+            // Without any worker threads the strategy makes no difference
+            if (numThreads == 0)
+            {
+                candidates.push_back ({ strategies.front(), 0 });
+                continue;
+            }
+
+            for (auto strategy : strategies)
+                candidates.push_back ({ strategy, numThreads });
+        }
+
+        candidateLoads.assign (candidates.size(), 0.0);
+        candidateIndex = 0;
+        numOverloadedWindows = 0;
+
+        // With only one candidate there's nothing to calibrate
+        if (candidates.size() == 1)
+            candidateIndex = 1;
+
+        apply (getCurrentConfiguration());
+    }
+
+    void apply (ThreadingConfiguration config)
+    {
+        auto& npc = *owner.nodePlaybackContext;
+
+        if (owner.edit.engine.getSharedNodeThreadPool() == nullptr && config.threadPoolStrategy != appliedStrategy)
+        {
+            npc.setThreadPoolStrategy (static_cast<tracktion::graph::ThreadPoolStrategy> (config.threadPoolStrategy));
+            appliedStrategy = config.threadPoolStrategy;
+        }
+
+        npc.setNumThreads (config.numThreads);
+
+        // The blocks processed whilst the threads were changing aren't representative
+        skipNextWindow = true;
+    }
+
+    void timerCallback() override
+    {
+        const auto [numBlocks, load] = owner.nodePlaybackContext->loadHistogram.takePercentile (0.99);
+
+        // Only measure blocks that are actually playing the Edit
+        if (candidates.empty() || ! owner.isPlaying() || numBlocks < minBlocksPerWindow)
+            return;
+
+        if (std::exchange (skipNextWindow, false))
+            return;
+
+        if (isCalibrating())
+        {
+            candidateLoads[candidateIndex] = load;
+
+            if (++candidateIndex < candidates.size())
+            {
+                apply (candidates[candidateIndex]);
+                return;
+            }
+
+            const auto best = (size_t) std::distance (candidateLoads.begin(),
+                                                      std::min_element (candidateLoads.begin(), candidateLoads.end()));
+            std::swap (candidates[best], candidates.back());
+            apply (candidates.back());
+            return;
+        }
+
+        if (load > overloadedLoad)
+        {
+            if (++numOverloadedWindows >= numOverloadedWindowsBeforeRecalibrating)
+                startCalibration();
+        }
+        else
+        {
+            numOverloadedWindows = 0;
+        }
+    }
+};
+
+//==============================================================================
+/**
+    Keeps the clips in the playback graph limited to a window around the playhead.
+
+    The windows are chosen each time the graph is built. This checks the playhead
+    periodically and rebuilds the graph once it's getting close to the end of the
+    windows, or has jumped outside them, so the Nodes for the upcoming clips are
+    created and prepared before they're reached. Clips that have been passed are
+    left out of the next graph so their Nodes are deleted with the old one.
+*/
+struct EditPlaybackContext::ClipWindowUpdater  : private juce::Timer
+{
+    ClipWindowUpdater (EditPlaybackContext& epc, TimeDuration windowLengthToUse)
+        : owner (epc), windowLength (windowLengthToUse)
+    {
+        startTimer (checkIntervalMs);
+    }
+
+    /** Called when the graph is built to choose the clips to include. */
+    std::vector<TimeRange> createWindows (TimePosition position)
+    {
+        const auto& transport = owner.transport;
+        loopRange = transport.looping.get() ? std::optional<TimeRange> (transport.getLoopRange())
+                                            : std::nullopt;
+
+        const auto behind = windowLength * 0.25;
+
+        if (! loopRange || ! loopRange->contains (position))
+            windows = { { position - behind, position + windowLength } };
+        else if (loopRange->getLength() <= windowLength)
+            windows = { loopRange->withStart (loopRange->getStart() - behind) };
+        else if (const auto end = position + windowLength; end > loopRange->getEnd())
+            windows = { { position - behind, loopRange->getEnd() },
+                        { loopRange->getStart() - behind, loopRange->getStart() + (end - loopRange->getEnd()) } };
+        else
+            windows = { { position - behind, end } };
+
+        return windows;
+    }
+
+private:
+    static constexpr int checkIntervalMs = 100;
+
+    EditPlaybackContext& owner;
+    const TimeDuration windowLength;
+    std::vector<TimeRange> windows;
+    std::optional<TimeRange> loopRange;
+
+    bool isCovered (TimePosition time) const
+    {
+        for (auto window : windows)
+            if (window.contains (time))
+                return true;
+
+        return false;
+    }
+
+    bool needsUpdating() const
+    {
+        const auto& transport = owner.transport;
+        const auto newLoopRange = transport.looping.get() ? std::optional<TimeRange> (transport.getLoopRange())
+                                                          : std::nullopt;
+
+        if (newLoopRange != loopRange)
+            return true;
+
+        const auto position = owner.getPosition();
+        auto lookAheadPosition = position + windowLength * 0.5;
+
+        if (loopRange && loopRange->contains (position) && lookAheadPosition >= loopRange->getEnd())
+            lookAheadPosition = loopRange->getStart()
+                                  + TimeDuration::fromSeconds (std::fmod ((lookAheadPosition - loopRange->getEnd()).inSeconds(),
+                                                                          loopRange->getLength().inSeconds()));
+
+        return ! isCovered (position) || ! isCovered (lookAheadPosition);
+    }
+
+    void timerCallback() override
+    {
+        if (! owner.isAllocated || owner.edit.isLoading() || windows.empty())
+            return;
+
+        if (needsUpdating())
+        {
+            CRASH_TRACER
+            owner.createNode();
+        }
+    }
+};
+
 //==============================================================================
 EditPlaybackContext::ScopedDeviceListReleaser::ScopedDeviceListReleaser (EditPlaybackContext& e, bool reallocate)
     : owner (e), shouldReallocate (reallocate)
@@ -499,6 +1046,13 @@ EditPlaybackContext::EditPlaybackContext (TransportControl& tc)
                                                                      edit.engine.getEngineBehaviour().getNumberOfCPUsToUseForAudio(),
                                                                      EditPlaybackContextInternal::getMaxNumThreadsToUse (edit));
         contextSyncroniser = std::make_unique<ContextSyncroniser>();
+        edit.setEvaluateModifiersAhead (edit.engine.getEngineBehaviour().shouldEvaluateModifiersAhead());
+
+        if (EditPlaybackContextInternal::getAutoThreadTuningFlag())
+            threadTuner = std::make_unique<ThreadTuner> (*this);
+
+        if (const auto windowLength = EditPlaybackContextInternal::getClipWindowLength(); windowLength > 0_td)
+            clipWindowUpdater = std::make_unique<ClipWindowUpdater> (*this, windowLength);
 
         // This ensures the referenceSampleRange of the new context has been synced
         edit.engine.getDeviceManager().addContext (this);
@@ -516,6 +1070,7 @@ EditPlaybackContext::~EditPlaybackContext()
     TRACKTION_ASSERT_MESSAGE_THREAD
     releaseDeviceList();
     edit.engine.getDeviceManager().removeContext (this);
+    edit.setEvaluateModifiersAhead (false);
 }
 
 void EditPlaybackContext::releaseDeviceList()
@@ -668,9 +1223,25 @@ void EditPlaybackContext::createNode()
     cnp.includeBypassedPlugins = ! engineBehaviour.shouldBypassedPluginsBeRemovedFromPlaybackGraph();
     cnp.allowClipSlots = engineBehaviour.areClipSlotsEnabled();
     cnp.readAheadTimeStretchNodes = engineBehaviour.enableReadAheadForTimeStretchNodes();
+    cnp.usePreRenderedContainerClips = engineBehaviour.shouldPreRenderContainerClips();
+    cnp.directMonitoring = engineBehaviour.shouldUseDirectMonitoring();
+    cnp.renderTracksAnticipatively = EditPlaybackContextInternal::getAnticipativeRenderingFlag();
+    cnp.numThreadsForTrackNodes = EditPlaybackContextInternal::getNumGraphBuildingThreads();
+
+    if (clipWindowUpdater)
+        cnp.clipTimeWindows = clipWindowUpdater->createWindows (transport.getPosition());
+
+    const auto buildStartTime = std::chrono::steady_clock::now();
     auto editNode = createNodeForEdit (*this, audiblePlaybackTime, cnp);
+    const auto buildDuration = std::chrono::steady_clock::now() - buildStartTime;
+
+    if (threadTuner)
+        numNodesInGraph = tracktion::graph::getNodes (*editNode, tracktion::graph::VertexOrdering::postordering).size();
 
     nodePlaybackContext->setNode (std::move (editNode), cnp.sampleRate, cnp.blockSize);
+
+    const auto preparationTimes = nodePlaybackContext->player.getLastPreparationTimes();
+    lastGraphBuildTimes = { buildDuration, preparationTimes.transform, preparationTimes.initialise };
     updateNumCPUs();
 }
 
@@ -846,10 +1417,21 @@ tl::expected<Clip::Array, juce::String> EditPlaybackContext::stopRecording (Time
     for (auto in : allInputs)
         in->prepareToStopRecording (params.targetsToStop);
 
-    for (auto in : allInputs)
-        in->stopRecording (params)
-            .map ([&] (auto c) { clips.addArray (std::move (c)); })
-            .map_error ([&] (auto err) { error = err; });
+    // Writing out the remaining samples and headers is the slow part with many inputs,
+    // so the files are all finished in parallel before any clips are created
+    EditPlaybackContextInternal::finishRecordingFilesInParallel (allInputs, params.targetsToStop);
+
+    {
+        // Adds all the new clips in a single undo transaction, even if a warning shown
+        // whilst creating them lets the transaction timer run
+        edit.getUndoManager().beginNewTransaction();
+        const Edit::UndoTransactionInhibitor undoInhibitor (edit);
+
+        for (auto in : allInputs)
+            in->stopRecording (params)
+                .map ([&] (auto c) { clips.addArray (std::move (c)); })
+                .map_error ([&] (auto err) { error = err; });
+    }
 
     if (! error.isEmpty())
         return tl::unexpected (error);
@@ -1088,6 +1670,36 @@ int EditPlaybackContext::getLatencySamples() const
                                : 0;
 }
 
+size_t EditPlaybackContext::getAllocatedBytes() const
+{
+    return nodePlaybackContext ? nodePlaybackContext->getAllocatedBytes()
+                               : 0;
+}
+
+bool EditPlaybackContext::updatePluginLatency (Plugin& plugin)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    return nodePlaybackContext != nullptr && nodePlaybackContext->updatePluginLatency (plugin);
+}
+
+std::string EditPlaybackContext::exportGraph (tracktion::graph::GraphExportFormat format, tracktion::graph::NodeProfiler* profiler) const
+{
+    return nodePlaybackContext ? nodePlaybackContext->exportGraph (format, profiler)
+                               : std::string();
+}
+
+void EditPlaybackContext::visitNodes (const std::function<void (tracktion::graph::Node&)>& visitor) const
+{
+    if (nodePlaybackContext)
+        nodePlaybackContext->visitNodes (visitor);
+}
+
+void EditPlaybackContext::setNodeProfiler (tracktion::graph::NodeProfiler* profiler)
+{
+    if (nodePlaybackContext)
+        nodePlaybackContext->setNodeProfiler (profiler);
+}
+
 TimePosition EditPlaybackContext::getAudibleTimelineTime()
 {
     return nodePlaybackContext ? TimePosition::fromSeconds (audiblePlaybackTime.load())
@@ -1102,8 +1714,23 @@ double EditPlaybackContext::getSampleRate() const
 
 void EditPlaybackContext::updateNumCPUs()
 {
-    if (nodePlaybackContext)
-        nodePlaybackContext->setNumThreads ((size_t) edit.engine.getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
+    if (! nodePlaybackContext)
+        return;
+
+    const auto numThreads = (size_t) edit.engine.getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1;
+
+    if (threadTuner)
+        threadTuner->update (numThreads, numNodesInGraph);
+    else
+        nodePlaybackContext->setNumThreads (numThreads);
+}
+
+std::optional<EditPlaybackContext::ThreadingConfiguration> EditPlaybackContext::getAutoTunedThreadingConfiguration() const
+{
+    if (threadTuner)
+        return threadTuner->getChosenConfiguration();
+
+    return {};
 }
 
 void EditPlaybackContext::setSpeedCompensation (double plusOrMinus)
@@ -1207,7 +1834,7 @@ void EditPlaybackContext::resyncToGlobalStreamTime (juce::Range<double> globalSt
 void EditPlaybackContext::setThreadPoolStrategy (int type)
 {
     type = juce::jlimit (static_cast<int> (tracktion::graph::ThreadPoolStrategy::conditionVariable),
-                         static_cast<int> (tracktion::graph::ThreadPoolStrategy::lightweightSemHybrid),
+                         static_cast<int> (tracktion::graph::ThreadPoolStrategy::workStealing),
                          type);
 
     EditPlaybackContextInternal::getThreadPoolStrategyType() = type;
@@ -1216,7 +1843,7 @@ void EditPlaybackContext::setThreadPoolStrategy (int type)
 int EditPlaybackContext::getThreadPoolStrategy()
 {
     const int type = juce::jlimit (static_cast<int> (tracktion::graph::ThreadPoolStrategy::conditionVariable),
-                                   static_cast<int> (tracktion::graph::ThreadPoolStrategy::lightweightSemHybrid),
+                                   static_cast<int> (tracktion::graph::ThreadPoolStrategy::workStealing),
                                    EditPlaybackContextInternal::getThreadPoolStrategyType());
 
     return type;
@@ -1232,11 +1859,61 @@ void EditPlaybackContext::enableNodeMemorySharing (bool enable)
     EditPlaybackContextInternal::getNodeMemorySharingFlag() = enable;
 }
 
+void EditPlaybackContext::enableStaticBufferAllocation (bool enable)
+{
+    EditPlaybackContextInternal::getStaticBufferAllocationFlag() = enable;
+}
+
+void EditPlaybackContext::enableSharedLatencyCompensation (bool enable)
+{
+    EditPlaybackContextInternal::getSharedLatencyCompensationFlag() = enable;
+}
+
+void EditPlaybackContext::enableCriticalPathScheduling (bool enable)
+{
+    EditPlaybackContextInternal::getCriticalPathSchedulingFlag() = enable;
+}
+
+void EditPlaybackContext::enableChainFusion (bool enable)
+{
+    EditPlaybackContextInternal::getChainFusionFlag() = enable;
+}
+
+void EditPlaybackContext::enableSinglePassLoopWraps (bool enable)
+{
+    EditPlaybackContextInternal::getSinglePassLoopWrapsFlag() = enable;
+}
+
+void EditPlaybackContext::enableAutoThreadTuning (bool enable)
+{
+    EditPlaybackContextInternal::getAutoThreadTuningFlag() = enable;
+}
+
 void EditPlaybackContext::enableAudioWorkgroup (bool enable)
 {
     EditPlaybackContextInternal::getAudioWorkgroupFlag() = enable;
 }
 
+void EditPlaybackContext::enableAnticipativeRendering (bool enable)
+{
+    EditPlaybackContextInternal::getAnticipativeRenderingFlag() = enable;
+}
+
+void EditPlaybackContext::setFixedProcessingBlockSize (int numSamples)
+{
+    EditPlaybackContextInternal::getFixedProcessingBlockSize() = std::max (0, numSamples);
+}
+
+void EditPlaybackContext::setNumThreadsForGraphBuilding (int numThreads)
+{
+    EditPlaybackContextInternal::getNumGraphBuildingThreads() = std::max (0, numThreads);
+}
+
+void EditPlaybackContext::setClipWindowLength (TimeDuration windowLength)
+{
+    EditPlaybackContextInternal::getClipWindowLength() = std::max (TimeDuration(), windowLength);
+}
+
 int EditPlaybackContext::getNumActivelyRecordingDevices() const
 {
     return activelyRecordingInputDevices.load (std::memory_order_acquire);
@@ -90,6 +90,42 @@ public:
 
     /** Returns the overall latency of the currently prepared graph. */
     int getLatencySamples() const;
+
+    /** Returns the number of bytes the Nodes in the current graph have allocated.
+        This should be called on the message thread so the graph isn't replaced whilst it's counted.
+    */
+    size_t getAllocatedBytes() const;
+
+    /** Returns a DOT or JSON description of the current graph, or an empty string if there isn't one.
+        If a NodeProfiler is passed in, its statistics are used to annotate the Nodes with their timings.
+        This should be called on the message thread so the graph isn't replaced whilst it's walked.
+        @see tracktion::graph::exportGraph
+    */
+    std::string exportGraph (tracktion::graph::GraphExportFormat, tracktion::graph::NodeProfiler* = nullptr) const;
+
+    /** Calls a function for each Node in the current graph, with each Node's inputs before it.
+        This should be called on the message thread so the graph isn't replaced whilst it's walked.
+    */
+    void visitNodes (const std::function<void (tracktion::graph::Node&)>&) const;
+
+    /** Sets a NodeProfiler to collect the processing time of each Node in the graph.
+        This is picked up when the graph is next built, so call Edit::restartPlayback
+        to start profiling straight away. The profiler must outlive this or be
+        removed by passing nullptr. This does nothing unless TRACKTION_GRAPH_NODE_PROFILING
+        is enabled. @see tracktion::graph::LockFreeMultiThreadedNodePlayer::setNodeProfiler
+    */
+    void setNodeProfiler (tracktion::graph::NodeProfiler*);
+
+    /** Updates the latency compensation of the current graph after a plugin's latency has
+        changed, without rebuilding it. The delays that line the tracks up crossfade to
+        their new lengths so playback carries on without a gap.
+        Returns false if this isn't possible, e.g. if a track would need a delay it doesn't
+        have, in which case the graph needs rebuilding with Edit::restartPlayback.
+        This must be called on the message thread.
+        @see tracktion::graph::LatencyCompensationUpdater
+    */
+    bool updatePluginLatency (Plugin&);
+
     TimePosition getAudibleTimelineTime();
     double getSampleRate() const;
     void updateNumCPUs();
@@ -152,11 +188,110 @@ public:
     */
     static void enableNodeMemorySharing (bool);
 
+    /** Enables assigning all the audio buffers up front from a single block of memory,
+        sharing them between Nodes that can't be processing at the same time.
+        @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableStaticBufferAllocation
+    */
+    static void enableStaticBufferAllocation (bool);
+
+    /** Enables summing inputs that need the same latency compensation and delaying
+        them together rather than giving each its own delay line.
+        @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableSharedLatencyCompensation
+    */
+    static void enableSharedLatencyCompensation (bool);
+
+    /** Enables scheduling ready Nodes along the most expensive path first.
+        @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableCriticalPathScheduling
+    */
+    static void enableCriticalPathScheduling (bool);
+
+    /** Enables processing serial chains of Nodes as single tasks.
+        @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableChainFusion
+    */
+    static void enableChainFusion (bool);
+
+    /** Enables processing blocks that wrap around the loop end in a single pass of the graph.
+        Graphs with Nodes that can't handle this still process each side of the wrap separately.
+        @see TracktionNodePlayer::enableSinglePassLoopWraps
+    */
+    static void enableSinglePassLoopWraps (bool);
+
+    /** Enables tuning the ThreadPoolStrategy and number of threads for each Edit as it plays.
+        Each combination is tried for a second of playback and the one with the lowest
+        99th percentile block load is used until the load gets too high, when they're
+        tried again. Graphs too small to benefit from parallelism don't use worker threads.
+        N.B. Changing configuration pauses processing so there may be some dropouts
+        whilst calibrating. This only affects EditPlaybackContexts created afterwards.
+        @see getAutoTunedThreadingConfiguration
+    */
+    static void enableAutoThreadTuning (bool);
+
+    /** A ThreadPoolStrategy and number of worker threads used to process an Edit. */
+    struct ThreadingConfiguration
+    {
+        int threadPoolStrategy = 0;     /**< @see tracktion::graph::ThreadPoolStrategy */
+        size_t numThreads = 0;
+    };
+
+    /** Returns the configuration chosen if auto tuning is enabled and has finished calibrating.
+        @see enableAutoThreadTuning
+    */
+    std::optional<ThreadingConfiguration> getAutoTunedThreadingConfiguration() const;
+
     /** Enables using AudioWorkgroups.
         Currently experimental and only on macOS.
     */
     static void enableAudioWorkgroup (bool);
 
+    /** Enables rendering tracks that don't have any live inputs on background threads,
+        a few blocks ahead of the audio callback. Only the live tracks and the master
+        bus are then processed in the callback so smaller buffer sizes can be used.
+        N.B. Changes to plugin parameters etc. on these tracks will be heard a few blocks late.
+        @see AnticipativeRenderNode
+    */
+    static void enableAnticipativeRendering (bool);
+
+    /** Sets a fixed number of samples to process the graph in, regardless of the size
+        of the device's blocks. This adds the block size of latency but avoids processing
+        the whole graph for lots of tiny blocks when hosts pass variable block sizes.
+        0 (the default) processes blocks as they arrive, only splitting them at events.
+        @see TracktionNodePlayer::BlockSizeMode
+    */
+    static void setFixedProcessingBlockSize (int numSamples);
+
+    /** Sets the number of threads used to create the top-level tracks' Nodes when
+        the playback graph is rebuilt, which can speed up rebuilds of Edits with
+        lots of tracks. 0 or 1 (the default) creates them all on the calling thread.
+        The Edit must not be modified on other threads whilst the graph is built.
+        @see CreateNodeParams::numThreadsForTrackNodes
+    */
+    static void setNumThreadsForGraphBuilding (int numThreads);
+
+    /** Enables a windowed playback graph for very long Edits. Instead of creating Nodes
+        for every arranger clip, only the clips within this length ahead of the playhead
+        (and a quarter of it behind) are included. The graph is rebuilt ahead of time,
+        whilst the current one keeps playing, when the playhead gets within half the
+        length of the end of the window or jumps outside it. The size of the graph then
+        depends on how densely packed the clips are rather than the length of the Edit.
+        When looping, the window wraps around to the loop start.
+        N.B. Jumping outside the window might miss the start of a block or two whilst
+        the graph is rebuilt. 0 (the default) includes all clips.
+        This only affects EditPlaybackContexts created afterwards.
+        @see CreateNodeParams::clipTimeWindows
+    */
+    static void setClipWindowLength (TimeDuration);
+
+    /** The time taken by each stage of rebuilding the playback graph. */
+    struct GraphBuildTimes
+    {
+        std::chrono::duration<double> build {};         /**< Creating the Nodes for the Edit. */
+        std::chrono::duration<double> transform {};     /**< Transforming the Nodes, e.g. adding latency compensation. */
+        std::chrono::duration<double> prepare {};       /**< Initialising the Nodes ready to be played. */
+    };
+
+    /** Returns the times taken by the last rebuild of the playback graph. */
+    GraphBuildTimes getLastGraphBuildTimes() const      { return lastGraphBuildTimes; }
+
     /** @internal */
     int getNumActivelyRecordingDevices() const;
     /** @internal */
@@ -202,9 +337,17 @@ private:
     struct NodePlaybackContext;
     std::unique_ptr<NodePlaybackContext> nodePlaybackContext;
 
+    struct ThreadTuner;
+    std::unique_ptr<ThreadTuner> threadTuner;
+    size_t numNodesInGraph = 0;
+
+    struct ClipWindowUpdater;
+    std::unique_ptr<ClipWindowUpdater> clipWindowUpdater;
+
     juce::WeakReference<EditPlaybackContext> nodeContextToSyncTo;
     std::atomic<double> audiblePlaybackTime { 0.0 };
     std::atomic<int> activelyRecordingInputDevices { 0 };
+    GraphBuildTimes lastGraphBuildTimes;
 
     void createNode();
     void nextBlockStarted();
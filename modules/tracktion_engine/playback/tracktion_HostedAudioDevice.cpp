@@ -187,6 +187,10 @@ public:
 
     void processBlock (juce::MidiBuffer& midi)
     {
+        // Most blocks have no MIDI so avoid taking the lock at all in that case
+        if (midi.isEmpty() && ! hasPendingMidiMessages.load (std::memory_order_acquire))
+            return;
+
         // Process the messages via the base class to update the keyboard state
         for (auto mm : midi)
             MidiInputDevice::handleIncomingMidiMessage (nullptr, mm.getMessage());
@@ -199,6 +203,7 @@ public:
                 hostedInstance->processBlock (pendingMidiMessages);
 
         pendingMidiMessages.clear();
+        hasPendingMidiMessages.store (false, std::memory_order_release);
     }
 
     using MidiInputDevice::handleIncomingMidiMessage;
@@ -207,6 +212,7 @@ public:
     {
         const juce::ScopedLock sl (pendingMidiMessagesMutex);
         pendingMidiMessages.addEvent (m, 0);
+        hasPendingMidiMessages.store (true, std::memory_order_release);
     }
 
     juce::String openDevice() override { return {}; }
@@ -249,6 +255,7 @@ private:
     //==============================================================================
     juce::MidiBuffer pendingMidiMessages;
     juce::CriticalSection pendingMidiMessagesMutex;
+    std::atomic<bool> hasPendingMidiMessages { false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HostedMidiInputDevice)
 };
@@ -270,6 +277,9 @@ public:
 
     void processBlock (juce::MidiBuffer& midi)
     {
+        if (toSend.isEmpty())
+            return;
+
         for (auto m : toSend)
         {
             auto t = m.getTimeStamp() * audioIf.parameters.sampleRate;
@@ -416,8 +426,11 @@ void HostedAudioDeviceInterface::processBlock (juce::AudioBuffer<float>& buffer,
         if (auto hostedInput = dynamic_cast<HostedMidiInputDevice*> (input.get()))
             hostedInput->processBlock (midi);
 
-    midi.clear();
+    if (! midi.isEmpty())
+        midi.clear();
 
+    // The host's channel pointers are passed straight through to the device
+    // callback so the inputs and outputs are read and written in place
     if (deviceType != nullptr)
         deviceType->processBlock (buffer);
 
@@ -12,10 +12,23 @@ namespace tracktion { inline namespace engine
 {
 
 //==============================================================================
-template <typename FloatType>
-static void getSumAndDiff (const juce::AudioBuffer<FloatType>& buffer,
-                           FloatType& sum, FloatType& diff,
-                           int startIndex, int numSamples)
+static float getChannelLevel (const juce::AudioBuffer<float>& buffer, int channel, int startIndex, int numSamples,
+                              LevelMeasurer::Mode mode, int stride)
+{
+    if (buffer.hasBeenCleared() || numSamples <= 0)
+        return 0.0f;
+
+    auto samples = buffer.getReadPointer (channel) + startIndex;
+
+    if (mode == LevelMeasurer::RMSMode)
+        return level_kernels::getRMS (samples, (size_t) numSamples, (size_t) stride);
+
+    return level_kernels::getPeak (samples, (size_t) numSamples, (size_t) stride);
+}
+
+static void getSumAndDiff (const juce::AudioBuffer<float>& buffer,
+                           float& sum, float& diff,
+                           int startIndex, int numSamples, int stride)
 {
     if (buffer.getNumChannels() == 0)
     {
@@ -24,20 +37,20 @@ static void getSumAndDiff (const juce::AudioBuffer<FloatType>& buffer,
     }
     else
     {
-        FloatType s  = 0;
-        FloatType lo = (FloatType) 1;
-        FloatType hi = 0;
+        float s  = 0;
+        float lo = 1.0f;
+        float hi = 0;
 
         for (int i = buffer.getNumChannels(); --i >= 0;)
         {
-            auto mag = buffer.getMagnitude (i, startIndex, numSamples);
+            auto mag = getChannelLevel (buffer, i, startIndex, numSamples, LevelMeasurer::peakMode, stride);
             s += mag;
             lo = juce::jmin (lo, mag);
             hi = juce::jmax (hi, mag);
         }
 
-        sum = s / buffer.getNumChannels();
-        diff = juce::jmax (FloatType(), hi - lo);
+        sum = s / (float) buffer.getNumChannels();
+        diff = juce::jmax (0.0f, hi - lo);
     }
 }
 
@@ -153,36 +166,21 @@ void LevelMeasurer::processBuffer (juce::AudioBuffer<float>& buffer, int start,
     if (clients.isEmpty())
         return;
 
+    if (--blocksUntilNextMeasurement > 0)
+        return;
+
+    blocksUntilNextMeasurement = blockInterval;
+
     auto numChans = std::min ((int) Client::maxNumChannels, buffer.getNumChannels());
     numActiveChannels = numChans;
     auto now = juce::Time::getApproximateMillisecondCounter();
+    const int stride = sampleStride;
 
-    if (mode == LevelMeasurer::peakMode)
-    {
-        // peak mode
-        for (int i = numChans; --i >= 0;)
-        {
-            auto gain = buffer.getMagnitude (i, start, numSamples);
-            bool overloaded = gain > 0.999f;
-            auto newDB = gainToDb (gain);
-
-            for (auto c : clients)
-            {
-                c->updateAudioLevel (i, { now, newDB });
-
-                if (overloaded)
-                    c->setOverload (i, true);
-
-                c->setNumChannelsUsed (numChans);
-            }
-        }
-    }
-    else if (mode == LevelMeasurer::RMSMode)
+    if (mode == LevelMeasurer::peakMode || mode == LevelMeasurer::RMSMode)
     {
-        // rms mode
         for (int i = numChans; --i >= 0;)
         {
-            auto gain = buffer.getRMSLevel (i, start, numSamples);
+            auto gain = getChannelLevel (buffer, i, start, numSamples, mode, stride);
             bool overloaded = gain > 0.999f;
             auto newDB = gainToDb (gain);
 
@@ -201,7 +199,7 @@ void LevelMeasurer::processBuffer (juce::AudioBuffer<float>& buffer, int start,
     {
         // sum + diff
         float sum, diff;
-        getSumAndDiff (buffer, sum, diff, start, numSamples);
+        getSumAndDiff (buffer, sum, diff, start, numSamples, stride);
 
         auto sumDB  = gainToDb (sum);
         auto diffDB = gainToDb (diff);
@@ -221,6 +219,33 @@ void LevelMeasurer::processBuffer (juce::AudioBuffer<float>& buffer, int start,
     }
 }
 
+void LevelMeasurer::processSilence (int numChannels)
+{
+    const std::scoped_lock sl (clientsMutex);
+
+    if (clients.isEmpty())
+        return;
+
+    if (--blocksUntilNextMeasurement > 0)
+        return;
+
+    blocksUntilNextMeasurement = blockInterval;
+
+    // Every mode measures silence as the same level so there's no need to look at the samples
+    auto numChans = mode == LevelMeasurer::sumDiffMode ? 2 : std::min ((int) Client::maxNumChannels, numChannels);
+    numActiveChannels = numChans;
+    auto now = juce::Time::getApproximateMillisecondCounter();
+    auto silentDB = gainToDb (0.0f);
+
+    for (auto c : clients)
+    {
+        for (int i = numChans; --i >= 0;)
+            c->updateAudioLevel (i, { now, silentDB });
+
+        c->setNumChannelsUsed (numChans);
+    }
+}
+
 void LevelMeasurer::processMidi (MidiMessageArray& midiBuffer, const float*)
 {
     const std::scoped_lock sl (clientsMutex);
@@ -287,17 +312,28 @@ void LevelMeasurer::setMode (LevelMeasurer::Mode m)
     mode = m;
 }
 
+void LevelMeasurer::setMeteringOptions (MeteringOptions options)
+{
+    blockInterval = std::max (1, options.blockInterval);
+    sampleStride = std::max (1, options.sampleStride);
+}
+
 void LevelMeasurer::addClient (Client& c)
 {
     const std::scoped_lock sl (clientsMutex);
     jassert (! clients.contains (&c));
     clients.add (&c);
+    numClients = clients.size();
+
+    // Measure the next block so the new client doesn't have to wait for a level
+    blocksUntilNextMeasurement = 0;
 }
 
 void LevelMeasurer::removeClient (Client& c)
 {
     const std::scoped_lock sl (clientsMutex);
     clients.removeFirstMatchingValue (&c);
+    numClients = clients.size();
 }
 
 void LevelMeasurer::setShowMidi (bool show)
@@ -329,6 +365,10 @@ void SharedLevelMeasurer::setSize (int channels, int numSamples)
 
 void SharedLevelMeasurer::addBuffer (const juce::AudioBuffer<float>& inBuffer, int startSample, int numSamples)
 {
+    // The sum is only used to measure its level so there's no point building it up
+    if (! hasClients())
+        return;
+
     setSize (2, numSamples);
 
     juce::SpinLock::ScopedLockType lock (spinLock);
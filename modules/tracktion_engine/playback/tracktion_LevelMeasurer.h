@@ -31,6 +31,10 @@ public:
 
     //==============================================================================
     void processBuffer (juce::AudioBuffer<float>& buffer, int start, int numSamples);
+
+    /** Updates the levels for a silent buffer without having to scan it. */
+    void processSilence (int numChannels);
+
     void processMidi (MidiMessageArray& midiBuffer, const float* gains);
     void processMidiLevel (float level);
 
@@ -53,6 +57,23 @@ public:
 
     int getNumActiveChannels() const noexcept           { return numActiveChannels; }
 
+    //==============================================================================
+    /** Options to make metering cheaper for measurers that only drive meter displays.
+        Skipping blocks or samples means short peaks and overloads can be missed so
+        these shouldn't be used where accurate levels are needed.
+    */
+    struct MeteringOptions
+    {
+        /** Only every Nth block passed to processBuffer is measured. */
+        int blockInterval = 1;
+
+        /** Only every Nth sample of a measured block is read. */
+        int sampleStride = 1;
+    };
+
+    void setMeteringOptions (MeteringOptions);
+    MeteringOptions getMeteringOptions() const noexcept     { return { blockInterval, sampleStride }; }
+
     //==============================================================================
     struct Client
     {
@@ -91,6 +112,9 @@ public:
     void addClient (Client&);
     void removeClient (Client&);
 
+    /** Returns true if any clients are attached, so there's any point measuring. */
+    bool hasClients() const noexcept                        { return numClients.load (std::memory_order_relaxed) > 0; }
+
     void setLevelCache (float dBL, float dBR) noexcept      { levelCacheL = dBL; levelCacheR = dBR; }
     std::pair<float, float> getLevelCache() const           { return { levelCacheL, levelCacheR }; }
 
@@ -100,8 +124,11 @@ private:
     bool showMidi = false;
     float levelCacheL = -100.0f;
     float levelCacheR = -100.0f;
+    std::atomic<int> blockInterval { 1 }, sampleStride { 1 };
+    int blocksUntilNextMeasurement = 0;
 
     juce::Array<Client*> clients;
+    std::atomic<int> numClients { 0 };
     RealTimeSpinLock clientsMutex;
 
     JUCE_DECLARE_WEAK_REFERENCEABLE(LevelMeasurer)
@@ -0,0 +1,303 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace loudness_meter_helpers
+{
+    static constexpr int numTruePeakTaps = 12;
+
+    /** The 4x oversampling interpolation filter from ITU-R BS.1770-4 Annex 2.
+        Each row holds the coefficients of the four phases for one input sample,
+        oldest sample first, so each output sample's four phases can be found at once.
+    */
+    alignas (16) static constexpr float truePeakCoefficients[numTruePeakTaps][4] =
+    {
+        { -0.0083007812500f, -0.0189208984375f, -0.0291748046875f,  0.0017089843750f },
+        {  0.0148925781250f,  0.0330810546875f,  0.0292968750000f,  0.0109863281250f },
+        { -0.0266113281250f, -0.0582275390625f, -0.0517578125000f, -0.0196533203125f },
+        {  0.0476074218750f,  0.1015625000000f,  0.0891113281250f,  0.0332031250000f },
+        { -0.1022949218750f, -0.2003173828125f, -0.1665039062500f, -0.0594482421875f },
+        {  0.9721679687500f,  0.7797851562500f,  0.4650878906250f,  0.1373291015625f },
+        {  0.1373291015625f,  0.4650878906250f,  0.7797851562500f,  0.9721679687500f },
+        { -0.0594482421875f, -0.1665039062500f, -0.2003173828125f, -0.1022949218750f },
+        {  0.0332031250000f,  0.0891113281250f,  0.1015625000000f,  0.0476074218750f },
+        { -0.0196533203125f, -0.0517578125000f, -0.0582275390625f, -0.0266113281250f },
+        {  0.0109863281250f,  0.0292968750000f,  0.0330810546875f,  0.0148925781250f },
+        {  0.0017089843750f, -0.0291748046875f, -0.0189208984375f, -0.0083007812500f }
+    };
+
+    /** Returns the largest absolute value of the four oversampled phases for the
+        given window of the last numTruePeakTaps samples, oldest first.
+    */
+    inline float getOversampledPeak (const float* window) noexcept
+    {
+       #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        auto sum = _mm_setzero_ps();
+
+        for (int i = 0; i < numTruePeakTaps; ++i)
+            sum = _mm_add_ps (sum, _mm_mul_ps (_mm_load_ps (truePeakCoefficients[i]), _mm_set1_ps (window[i])));
+
+        const auto mag = _mm_andnot_ps (_mm_set1_ps (-0.0f), sum);
+        const auto max2 = _mm_max_ps (mag, _mm_movehl_ps (mag, mag));
+        return _mm_cvtss_f32 (_mm_max_ss (max2, _mm_shuffle_ps (max2, max2, 1)));
+       #elif TRACKTION_ARM && defined (__ARM_NEON)
+        auto sum = vdupq_n_f32 (0.0f);
+
+        for (int i = 0; i < numTruePeakTaps; ++i)
+            sum = vmlaq_n_f32 (sum, vld1q_f32 (truePeakCoefficients[i]), window[i]);
+
+        const auto mag = vabsq_f32 (sum);
+        const auto max2 = vmax_f32 (vget_low_f32 (mag), vget_high_f32 (mag));
+        return vget_lane_f32 (vpmax_f32 (max2, max2), 0);
+       #else
+        float sum[4] = {};
+
+        for (int i = 0; i < numTruePeakTaps; ++i)
+            for (int phase = 0; phase < 4; ++phase)
+                sum[phase] += truePeakCoefficients[i][phase] * window[i];
+
+        return std::max ({ std::abs (sum[0]), std::abs (sum[1]), std::abs (sum[2]), std::abs (sum[3]) });
+       #endif
+    }
+
+    inline float energyToLoudness (double energy) noexcept
+    {
+        if (energy <= 0.0)
+            return LoudnessMeter::minLoudness;
+
+        return std::max (LoudnessMeter::minLoudness, (float) (-0.691 + 10.0 * std::log10 (energy)));
+    }
+
+    inline void updateMax (std::atomic<float>& value, float newValue) noexcept
+    {
+        if (newValue > value.load (std::memory_order_relaxed))
+            value.store (newValue, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter()
+{
+    prepare (44100.0, 2);
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+}
+
+void LoudnessMeter::prepare (double sampleRate, int numChannels)
+{
+    jassert (sampleRate > 0.0);
+
+    // These are the BS.1770 K-weighting filters, re-derived for the sample rate
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto vh = std::pow (10.0, gainDb / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        preFilter.b0 = (vh + vb * k / q + k * k) / a0;
+        preFilter.b1 = 2.0 * (k * k - vh) / a0;
+        preFilter.b2 = (vh - vb * k / q + k * k) / a0;
+        preFilter.a1 = 2.0 * (k * k - 1.0) / a0;
+        preFilter.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        highPassFilter.b0 = 1.0;
+        highPassFilter.b1 = -2.0;
+        highPassFilter.b2 = 1.0;
+        highPassFilter.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPassFilter.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    channels.resize ((size_t) std::max (0, numChannels));
+
+    for (size_t i = 0; i < channels.size(); ++i)
+    {
+        // The LFE isn't measured and the surround channels are weighted up by 1.5dB
+        if (numChannels > 4 && i == 3)      channels[i].weight = 0.0;
+        else if (numChannels > 4 && i > 3)  channels[i].weight = 1.41;
+        else                                channels[i].weight = 1.0;
+    }
+
+    samplesPerStep = std::max (1, juce::roundToInt (sampleRate / 10.0));
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    for (auto& c : channels)
+    {
+        std::fill (std::begin (c.z1), std::end (c.z1), 0.0);
+        std::fill (std::begin (c.z2), std::end (c.z2), 0.0);
+        std::fill (std::begin (c.history), std::end (c.history), 0.0f);
+        c.historyPos = 0;
+    }
+
+    samplesInStep = 0;
+    stepEnergy = 0;
+    stepEnergies.fill (0.0);
+    stepIndex = 0;
+    numSteps = 0;
+    histogramEnergies.fill (0.0);
+    histogramCounts.fill (0);
+
+    for (auto l : { &momentaryLoudness, &shortTermLoudness, &integratedLoudness, &maxMomentaryLoudness, &maxShortTermLoudness })
+        l->store (minLoudness, std::memory_order_relaxed);
+
+    truePeak.store (0.0f, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::process (choc::buffer::ChannelArrayView<float> block)
+{
+    using namespace loudness_meter_helpers;
+    const auto numChannels = std::min ((size_t) block.getNumChannels(), channels.size());
+    const auto numFrames = (int) block.getNumFrames();
+    float blockPeak = 0.0f;
+
+    for (int start = 0; start < numFrames;)
+    {
+        // Split the block at the 100ms step boundaries
+        const auto numThisTime = std::min (numFrames - start, samplesPerStep - samplesInStep);
+
+        for (size_t chan = 0; chan < numChannels; ++chan)
+        {
+            auto& state = channels[chan];
+            const auto samples = block.getChannel ((choc::buffer::ChannelCount) chan).data.data + start;
+            double sumOfSquares = 0;
+
+            auto z1a = state.z1[0], z2a = state.z2[0], z1b = state.z1[1], z2b = state.z2[1];
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                const auto x = (double) samples[i];
+
+                const auto y = preFilter.b0 * x + z1a;
+                z1a = preFilter.b1 * x - preFilter.a1 * y + z2a;
+                z2a = preFilter.b2 * x - preFilter.a2 * y;
+
+                const auto weighted = highPassFilter.b0 * y + z1b;
+                z1b = highPassFilter.b1 * y - highPassFilter.a1 * weighted + z2b;
+                z2b = highPassFilter.b2 * y - highPassFilter.a2 * weighted;
+
+                sumOfSquares += weighted * weighted;
+
+                state.history[state.historyPos] = samples[i];
+                state.history[state.historyPos + numTruePeakTaps] = samples[i];
+                state.historyPos = (state.historyPos + 1) % numTruePeakTaps;
+
+                blockPeak = std::max ({ blockPeak, std::abs (samples[i]), getOversampledPeak (state.history + state.historyPos) });
+            }
+
+            state.z1[0] = z1a;
+            state.z2[0] = z2a;
+            state.z1[1] = z1b;
+            state.z2[1] = z2b;
+
+            stepEnergy += state.weight * sumOfSquares;
+        }
+
+        start += numThisTime;
+        samplesInStep += numThisTime;
+
+        if (samplesInStep >= samplesPerStep)
+            endStep();
+    }
+
+    updateMax (truePeak, blockPeak);
+}
+
+void LoudnessMeter::endStep()
+{
+    using namespace loudness_meter_helpers;
+
+    stepEnergies[(size_t) stepIndex] = stepEnergy / samplesPerStep;
+    stepIndex = (stepIndex + 1) % (int) stepEnergies.size();
+    ++numSteps;
+    stepEnergy = 0;
+    samplesInStep = 0;
+
+    double momentaryEnergy = 0, shortTermEnergy = 0;
+
+    for (int i = 0; i < (int) stepEnergies.size(); ++i)
+    {
+        const auto energy = stepEnergies[(size_t) ((stepIndex - 1 - i + (int) stepEnergies.size()) % (int) stepEnergies.size())];
+        shortTermEnergy += energy;
+
+        if (i < 4)
+            momentaryEnergy += energy;
+    }
+
+    momentaryEnergy /= 4.0;
+    shortTermEnergy /= (double) stepEnergies.size();
+
+    const auto momentary = energyToLoudness (momentaryEnergy);
+    const auto shortTerm = energyToLoudness (shortTermEnergy);
+    momentaryLoudness.store (momentary, std::memory_order_relaxed);
+    shortTermLoudness.store (shortTerm, std::memory_order_relaxed);
+
+    // Each 400ms momentary window overlapping by 75% is a gating block
+    if (numSteps >= 4)
+    {
+        updateMax (maxMomentaryLoudness, momentary);
+
+        if (momentary > histogramMinLoudness)
+        {
+            const auto bin = std::clamp ((int) ((momentary - histogramMinLoudness) / histogramBinSize), 0, numHistogramBins - 1);
+            histogramEnergies[(size_t) bin] += momentaryEnergy;
+            ++histogramCounts[(size_t) bin];
+            integratedLoudness.store (calculateIntegratedLoudness(), std::memory_order_relaxed);
+        }
+    }
+
+    if (numSteps >= (int64_t) stepEnergies.size())
+        updateMax (maxShortTermLoudness, shortTerm);
+}
+
+float LoudnessMeter::calculateIntegratedLoudness() const
+{
+    using namespace loudness_meter_helpers;
+
+    auto getGatedLoudness = [this] (int firstBin)
+    {
+        double energy = 0;
+        uint64_t count = 0;
+
+        for (int i = firstBin; i < numHistogramBins; ++i)
+        {
+            energy += histogramEnergies[(size_t) i];
+            count += histogramCounts[(size_t) i];
+        }
+
+        return count > 0 ? energyToLoudness (energy / (double) count) : minLoudness;
+    };
+
+    // The histogram only holds blocks above the absolute gate, so this is the
+    // absolutely gated loudness which is then used to find the relative gate
+    const auto absoluteGated = getGatedLoudness (0);
+
+    if (absoluteGated <= minLoudness)
+        return minLoudness;
+
+    const auto relativeGate = absoluteGated - 10.0;
+    const auto firstBin = std::clamp ((int) std::ceil ((relativeGate - histogramMinLoudness) / histogramBinSize), 0, numHistogramBins - 1);
+
+    return getGatedLoudness (firstBin);
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,115 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Measures loudness and true-peak levels as described by ITU-R BS.1770-4.
+
+    Audio is K-weighted and its mean square taken over 100ms steps, from which the
+    momentary (400ms), short-term (3s) and gated integrated loudness are found.
+    True-peak levels are measured by 4x oversampling with the interpolation filter
+    given in the recommendation.
+
+    The integrated loudness is gated using a histogram of block loudnesses with
+    0.1 LU bins, so it uses a fixed amount of memory however long the measurement is.
+
+    Call prepare before processing any audio. process should then be called from a
+    single thread, but the levels can be read from any thread.
+*/
+class LoudnessMeter
+{
+public:
+    //==============================================================================
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    /** Prepares the meter to measure audio with the given format and resets it.
+        This may allocate so shouldn't be called from the audio thread.
+    */
+    void prepare (double sampleRate, int numChannels);
+
+    /** Clears all the measurements so far. */
+    void reset();
+
+    /** Measures a block of audio.
+        Channels are weighted as described by BS.1770 assuming the usual
+        L, R, C, LFE, Ls, Rs ordering. Any channels past the number the meter was
+        prepared with are ignored.
+    */
+    void process (choc::buffer::ChannelArrayView<float>);
+
+    //==============================================================================
+    /** Returns the loudness of the last 400ms, in LUFS. */
+    float getMomentaryLoudness() const noexcept         { return momentaryLoudness.load (std::memory_order_relaxed); }
+
+    /** Returns the loudness of the last 3s, in LUFS. */
+    float getShortTermLoudness() const noexcept         { return shortTermLoudness.load (std::memory_order_relaxed); }
+
+    /** Returns the gated loudness of everything measured since the last reset, in LUFS. */
+    float getIntegratedLoudness() const noexcept        { return integratedLoudness.load (std::memory_order_relaxed); }
+
+    /** Returns the highest momentary loudness since the last reset, in LUFS. */
+    float getMaxMomentaryLoudness() const noexcept      { return maxMomentaryLoudness.load (std::memory_order_relaxed); }
+
+    /** Returns the highest short-term loudness since the last reset, in LUFS. */
+    float getMaxShortTermLoudness() const noexcept      { return maxShortTermLoudness.load (std::memory_order_relaxed); }
+
+    /** Returns the highest true-peak level of any channel since the last reset, in dBTP. */
+    float getTruePeakDb() const noexcept                { return gainToDb (truePeak.load (std::memory_order_relaxed)); }
+
+    /** The level returned when there's nothing to measure, e.g. for silence. */
+    static constexpr float minLoudness = -100.0f;
+
+private:
+    //==============================================================================
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    };
+
+    struct ChannelState
+    {
+        double weight = 1.0;
+        double z1[2] = {}, z2[2] = {};
+
+        // The last few samples, stored twice so the filter can always read them contiguously
+        float history[24] = {};
+        int historyPos = 0;
+    };
+
+    static constexpr int numHistogramBins = 800;
+    static constexpr double histogramMinLoudness = -70.0, histogramBinSize = 0.1;
+
+    Biquad preFilter, highPassFilter;
+    std::vector<ChannelState> channels;
+    int samplesPerStep = 0, samplesInStep = 0;
+    double stepEnergy = 0;
+
+    std::array<double, 30> stepEnergies {};
+    int stepIndex = 0;
+    int64_t numSteps = 0;
+
+    std::array<double, numHistogramBins> histogramEnergies {};
+    std::array<uint32_t, numHistogramBins> histogramCounts {};
+
+    std::atomic<float> momentaryLoudness { minLoudness }, shortTermLoudness { minLoudness }, integratedLoudness { minLoudness },
+                       maxMomentaryLoudness { minLoudness }, maxShortTermLoudness { minLoudness };
+    std::atomic<float> truePeak { 0.0f };
+
+    void endStep();
+    float calculateIntegratedLoudness() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,81 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_LOUDNESS_METER
+
+#include "../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE("tracktion_engine")
+{
+    static void measureSine (LoudnessMeter& meter, double sampleRate, int numChannels, double frequency,
+                             double gain, double phase, double numSeconds)
+    {
+        constexpr choc::buffer::FrameCount blockSize = 512;
+        choc::buffer::ChannelArrayBuffer<float> buffer ((choc::buffer::ChannelCount) numChannels, blockSize);
+        const auto delta = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+        for (auto numLeft = (int64_t) (numSeconds * sampleRate); numLeft > 0; numLeft -= blockSize)
+        {
+            for (choc::buffer::FrameCount i = 0; i < blockSize; ++i)
+            {
+                const auto sample = (float) (gain * std::sin (phase));
+                phase += delta;
+
+                for (choc::buffer::ChannelCount c = 0; c < (choc::buffer::ChannelCount) numChannels; ++c)
+                    buffer.getSample (c, i) = sample;
+            }
+
+            meter.process (buffer.getView());
+        }
+    }
+
+    TEST_CASE ("LoudnessMeter")
+    {
+        LoudnessMeter meter;
+
+        // A stereo 997Hz sine at -20dBFS should measure -20 LUFS
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0 })
+        {
+            meter.prepare (sampleRate, 2);
+            measureSine (meter, sampleRate, 2, 997.0, 0.1, 0.0, 5.0);
+
+            CHECK (meter.getIntegratedLoudness() == doctest::Approx (-20.0f).epsilon (0.005));
+            CHECK (meter.getMomentaryLoudness() == doctest::Approx (-20.0f).epsilon (0.005));
+            CHECK (meter.getShortTermLoudness() == doctest::Approx (-20.0f).epsilon (0.005));
+            CHECK (meter.getMaxShortTermLoudness() == doctest::Approx (-20.0f).epsilon (0.005));
+            CHECK (meter.getTruePeakDb() == doctest::Approx (-20.0f).epsilon (0.01));
+        }
+
+        // Quiet passages should be gated out of the integrated loudness
+        meter.prepare (48000.0, 2);
+        measureSine (meter, 48000.0, 2, 997.0, 0.1, 0.0, 5.0);
+        measureSine (meter, 48000.0, 2, 997.0, 0.001, 0.0, 20.0);
+        CHECK (meter.getIntegratedLoudness() == doctest::Approx (-20.0f).epsilon (0.01));
+        CHECK (meter.getShortTermLoudness() == doctest::Approx (-60.0f).epsilon (0.01));
+
+        // A quarter sample rate sine with its peaks between samples should find the true-peak
+        meter.prepare (48000.0, 1);
+        measureSine (meter, 48000.0, 1, 12000.0, 0.5, juce::MathConstants<double>::pi / 4.0, 1.0);
+        CHECK (meter.getTruePeakDb() > gainToDb (0.5f * 0.75f));
+        CHECK (meter.getTruePeakDb() == doctest::Approx (gainToDb (0.5f)).epsilon (0.02));
+
+        // Silence has no loudness
+        meter.reset();
+        CHECK_EQ (meter.getIntegratedLoudness(), LoudnessMeter::minLoudness);
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_LOUDNESS_METER
@@ -190,7 +190,7 @@ private:
 
         for (int i = startIndex; --i >= 0;) // Find initial note-on timbre value
         {
-            const auto& m = data.events[(size_t) startIndex].message;
+            const auto& m = data.events[(size_t) i].message;
 
             if (! m.isShortMessage())
                 continue;
@@ -11,28 +11,140 @@
 namespace tracktion { inline namespace engine
 {
 
+namespace
+{
+    /** Sleeps the calling thread until a host time, as given by
+        MidiNoteDispatcher::getHostTimeMicroseconds, using the most precise wait the
+        platform has. Waits are made absolute where possible so they don't drift.
+    */
+    struct PreciseSleeper
+    {
+       #if JUCE_WINDOWS
+        PreciseSleeper()
+        {
+           #ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+            constexpr DWORD CREATE_WAITABLE_TIMER_HIGH_RESOLUTION = 0x00000002;
+           #endif
+
+            timer = CreateWaitableTimerExW (nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+            // High resolution timers are only available from Windows 10 1803
+            if (timer == nullptr)
+                timer = CreateWaitableTimerW (nullptr, TRUE, nullptr);
+        }
+
+        ~PreciseSleeper()
+        {
+            if (timer != nullptr)
+                CloseHandle (timer);
+        }
+       #elif JUCE_MAC || JUCE_IOS
+        PreciseSleeper()
+        {
+            mach_timebase_info (&timebase);
+        }
+       #endif
+
+        void sleepUntil (int64_t hostTimeUs)
+        {
+            const auto numMicroseconds = hostTimeUs - MidiNoteDispatcher::getHostTimeMicroseconds();
+
+            if (numMicroseconds <= 0)
+                return;
+
+           #if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+            // std::chrono::steady_clock is CLOCK_MONOTONIC here so the deadline can be used as-is
+            timespec deadline;
+            deadline.tv_sec = (time_t) (hostTimeUs / 1'000'000);
+            deadline.tv_nsec = (long) ((hostTimeUs % 1'000'000) * 1'000);
+
+            while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+            {}
+           #elif JUCE_MAC || JUCE_IOS
+            const auto numNanoseconds = (uint64_t) numMicroseconds * 1'000;
+            mach_wait_until (mach_absolute_time() + numNanoseconds * timebase.denom / timebase.numer);
+           #elif JUCE_WINDOWS
+            if (timer != nullptr)
+            {
+                // Negative due times are relative, in 100 nanosecond units
+                LARGE_INTEGER dueTime;
+                dueTime.QuadPart = -(LONGLONG) (numMicroseconds * 10);
+
+                if (SetWaitableTimer (timer, &dueTime, 0, nullptr, nullptr, FALSE))
+                {
+                    WaitForSingleObject (timer, INFINITE);
+                    return;
+                }
+            }
+
+            std::this_thread::sleep_for (std::chrono::microseconds (numMicroseconds));
+           #else
+            std::this_thread::sleep_for (std::chrono::microseconds (numMicroseconds));
+           #endif
+        }
+
+       #if JUCE_WINDOWS
+        HANDLE timer = nullptr;
+       #elif JUCE_MAC || JUCE_IOS
+        mach_timebase_info_data_t timebase {};
+       #endif
+    };
+}
+
+//==============================================================================
 MidiNoteDispatcher::MidiNoteDispatcher()
+    : juce::Thread ("MIDI Output Dispatch")
 {
 }
 
 MidiNoteDispatcher::~MidiNoteDispatcher()
 {
-    stopTimer();
+    stopThread (1000);
+}
+
+int64_t MidiNoteDispatcher::getHostTimeMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 void MidiNoteDispatcher::dispatchPendingMessagesForDevices (TimePosition editTime)
 {
-    const std::shared_lock sl (deviceMutex);
+    // The device list is only locked exclusively whilst it's being replaced so rather
+    // than wait for that, leave the messages pending until the next block
+    const std::shared_lock sl (deviceMutex, std::try_to_lock);
+
+    if (! sl.owns_lock())
+    {
+        numDeferredDispatches.fetch_add (1, std::memory_order_relaxed);
+        return;
+    }
+
+    TimePosition time;
+    int64_t hostTimeUs;
+
+    {
+        // The same goes for the time whilst it's being updated
+        const std::unique_lock s (timeLock, std::try_to_lock);
+
+        if (! s.owns_lock())
+        {
+            numDeferredDispatches.fetch_add (1, std::memory_order_relaxed);
+            return;
+        }
+
+        time = masterTime;
+        hostTimeUs = hostTimeOfMasterTimeUs;
+    }
 
     for (auto state : devices)
-        dispatchPendingMessages (*state, editTime);
+        dispatchPendingMessages (*state, editTime, time, hostTimeUs);
 }
 
 void MidiNoteDispatcher::masterTimeUpdate (TimePosition editTime)
 {
     const std::scoped_lock s (timeLock);
     masterTime = editTime;
-    hiResClockOfMasterTime = juce::Time::getMillisecondCounterHiRes();
+    hostTimeOfMasterTimeUs = getHostTimeMicroseconds();
 }
 
 void MidiNoteDispatcher::prepareToPlay (TimePosition editTime)
@@ -40,24 +152,31 @@ void MidiNoteDispatcher::prepareToPlay (TimePosition editTime)
     masterTimeUpdate (editTime);
 }
 
-TimePosition MidiNoteDispatcher::getCurrentTime() const
+void MidiNoteDispatcher::dispatchPendingMessages (DeviceState& state, TimePosition editTime,
+                                                  TimePosition time, int64_t hostTimeUs)
 {
-    const std::scoped_lock s (timeLock);
-    return masterTime + TimeDuration::fromSeconds ((juce::Time::getMillisecondCounterHiRes() - hiResClockOfMasterTime) * 0.001);
-}
-
-void MidiNoteDispatcher::dispatchPendingMessages (DeviceState& state, TimePosition editTime)
-{
-    // N.B. This should only be called under a deviceLock (which is separate to the bufferMutex)
+    // N.B. This should only be called under a deviceLock
     auto& pendingBuffer = state.device.getPendingMessages();
     state.device.context.masterLevels.processMidi (pendingBuffer, nullptr);
     const auto delay = state.device.getMidiOutput().getDeviceDelay();
 
-    if (! state.device.sendMessages (pendingBuffer, editTime - delay))
+    if (state.device.sendMessages (pendingBuffer, editTime - delay))
+        return;
+
+    if (pendingBuffer.isAllNotesOff)
+        state.allNotesOffPending = true;
+
+    // Convert the edit times to the host clock so the dispatch thread doesn't need the master time
+    for (auto& m : pendingBuffer)
     {
-        const std::scoped_lock sl (state.bufferMutex);
-        state.buffer.mergeFromAndClear (pendingBuffer);
+        const auto messageHostTimeUs = hostTimeUs + (int64_t) std::llround ((m.getTimeStamp() - time.inSeconds()) * 1'000'000.0);
+
+        // If the FIFO is full, the dispatch thread has stalled so the rest are dropped
+        if (! state.fifo.push ({ m, messageHostTimeUs }))
+            break;
     }
+
+    pendingBuffer.clear();
 }
 
 void MidiNoteDispatcher::setMidiDeviceList (const juce::OwnedArray<MidiOutputDeviceInstance>& newList)
@@ -69,71 +188,114 @@ void MidiNoteDispatcher::setMidiDeviceList (const juce::OwnedArray<MidiOutputDev
         newDevices.add (new DeviceState (*d));
 
     if (newList.isEmpty())
-        stopTimer();
+        stopThread (1000);
 
-    bool startTimerFlag = false;
+    bool startThreadFlag = false;
 
     {
         const std::unique_lock sl (deviceMutex);
         newDevices.swapWith (devices);
-        startTimerFlag = ! devices.isEmpty();
+        startThreadFlag = ! devices.isEmpty();
     }
 
-    if (startTimerFlag)
-        startTimer (1);
+    if (! startThreadFlag || isThreadRunning())
+        return;
+
+    if (! startRealtimeThread (juce::Thread::RealtimeOptions().withPriority (10).withPeriodMs (1.0)))
+        startThread (juce::Thread::Priority::highest);
 }
 
-void MidiNoteDispatcher::hiResTimerCallback()
+//==============================================================================
+MidiNoteDispatcher::LatencyHistogram MidiNoteDispatcher::getDispatchLatencyHistogram() const
 {
-    struct MessageToSend
+    LatencyHistogram histogram;
+
+    for (size_t i = 0; i < latencyCounts.size(); ++i)
     {
-        MidiOutputDeviceInstance* device;
-        juce::MidiMessage message;
-    };
+        histogram.counts[i] = latencyCounts[i].load (std::memory_order_relaxed);
+        histogram.numMessages += histogram.counts[i];
+    }
+
+    histogram.maxLatencyMicroseconds = maxLatencyUs.load (std::memory_order_relaxed);
+    return histogram;
+}
 
-    juce::Array<MessageToSend> messagesToSend;
-    messagesToSend.ensureStorageAllocated (32);
+void MidiNoteDispatcher::resetDispatchLatencyHistogram()
+{
+    for (auto& count : latencyCounts)
+        count.store (0, std::memory_order_relaxed);
+
+    maxLatencyUs.store (0, std::memory_order_relaxed);
+}
 
+void MidiNoteDispatcher::addToLatencyHistogram (int64_t latencyUs)
+{
+    latencyUs = std::max (latencyUs, (int64_t) 0);
+    const auto bucket = std::min ((size_t) (latencyUs / LatencyHistogram::bucketSizeMicroseconds), latencyCounts.size() - 1);
+    latencyCounts[bucket].fetch_add (1, std::memory_order_relaxed);
+
+    // Only the dispatch thread updates this so it doesn't need a CAS loop
+    if (latencyUs > maxLatencyUs.load (std::memory_order_relaxed))
+        maxLatencyUs.store (latencyUs, std::memory_order_relaxed);
+}
+
+//==============================================================================
+int64_t MidiNoteDispatcher::sendDueMessages (DeviceState& state)
+{
+    auto& midiOut = state.device.getMidiOutput();
+
+    if (state.allNotesOffPending.exchange (false))
+        midiOut.sendNoteOffMessages();
+
+    for (;;)
     {
-        const std::shared_lock sl (deviceMutex);
+        if (! state.hasNextMessage)
+            state.hasNextMessage = state.fifo.pop (state.nextMessage);
+
+        if (! state.hasNextMessage)
+            return std::numeric_limits<int64_t>::max();
 
-        for (auto d : devices)
+        const auto hostTimeUs = state.nextMessage.hostTimeUs;
+        const auto currentHostTimeUs = getHostTimeMicroseconds();
+
+        // Messages too far in the future are from before a reposition so are dropped
+        if (hostTimeUs > currentHostTimeUs + 250'000)
+        {
+            state.hasNextMessage = false;
+        }
+        else if (hostTimeUs <= currentHostTimeUs)
         {
-            auto& device = d->device;
-            auto& buffer = d->buffer;
-            auto& midiOut = device.getMidiOutput();
+            midiOut.fireMessage (state.nextMessage.message);
+            addToLatencyHistogram (currentHostTimeUs - hostTimeUs);
+            state.hasNextMessage = false;
+        }
+        else
+        {
+            return hostTimeUs;
+        }
+    }
+}
 
-            const std::scoped_lock bufferLock (d->bufferMutex);
+void MidiNoteDispatcher::run()
+{
+    // New messages are only pushed once per audio block, so waking at least this
+    // often is enough to pick them up without polling
+    constexpr int64_t maxSleepUs = 1'000;
+    PreciseSleeper sleeper;
 
-            if (buffer.isAllNotesOff)
-                midiOut.sendNoteOffMessages();
-            
-            while (buffer.isNotEmpty())
-            {
-                auto& message = buffer[0];
+    while (! threadShouldExit())
+    {
+        auto nextDeadlineUs = std::numeric_limits<int64_t>::max();
 
-                auto noteTime = TimePosition::fromSeconds (message.getTimeStamp());
-                auto currentTime = getCurrentTime();
+        {
+            const std::shared_lock sl (deviceMutex);
 
-                if (noteTime > currentTime + TimeDuration::fromSeconds (0.25))
-                {
-                    buffer.remove (0);
-                }
-                else if (noteTime <= currentTime)
-                {
-                    messagesToSend.add ({ &device, message });
-                    buffer.remove (0);
-                }
-                else
-                {
-                    break;
-                }
-            }
+            for (auto d : devices)
+                nextDeadlineUs = std::min (nextDeadlineUs, sendDueMessages (*d));
         }
-    }
 
-    for (auto& m : messagesToSend)
-        m.device->getMidiOutput().fireMessage (m.message);
+        sleeper.sleepUntil (std::min (nextDeadlineUs, getHostTimeMicroseconds() + maxSleepUs));
+    }
 }
 
 }} // namespace tracktion { inline namespace engine
@@ -11,7 +11,19 @@
 namespace tracktion { inline namespace engine
 {
 
-class MidiNoteDispatcher   : private juce::HighResolutionTimer
+/**
+    Sends the MIDI messages that MidiOutputDeviceInstances haven't sent themselves
+    to their devices at the right time.
+
+    The audio thread pushes each device's messages onto a lock-free FIFO, timestamped
+    with the host time in microseconds they should be sent, and a real-time thread
+    pops and sends them, so neither thread has to wait for the other.
+
+    Rather than polling on a timer, the thread sleeps until the next message is due
+    using the platform's most precise absolute wait, so messages go out within a few
+    microseconds of their timestamps instead of up to a timer tick late.
+*/
+class MidiNoteDispatcher   : private juce::Thread
 {
 public:
     MidiNoteDispatcher();
@@ -25,17 +37,54 @@ public:
     void masterTimeUpdate (TimePosition editTime);
     void prepareToPlay (TimePosition editTime);
 
-    void hiResTimerCallback() override;
+    //==============================================================================
+    /** A histogram of how late messages were sent compared to their timestamps. */
+    struct LatencyHistogram
+    {
+        static constexpr int bucketSizeMicroseconds = 50;
+        static constexpr int numBuckets = 40;
+
+        /** The number of messages sent in each bucket. The last bucket holds all
+            the messages that were later than its start.
+        */
+        std::array<uint64_t, numBuckets> counts {};
+        uint64_t numMessages = 0;
+        int64_t maxLatencyMicroseconds = 0;
+    };
+
+    /** Returns the dispatch latencies measured since the last reset. */
+    LatencyHistogram getDispatchLatencyHistogram() const;
+
+    /** Clears the dispatch latencies measured so far. */
+    void resetDispatchLatencyHistogram();
+
+    /** Returns the number of times dispatchPendingMessagesForDevices left the messages
+        pending until the next block because the device list or time was being changed.
+    */
+    uint64_t getNumDeferredDispatches() const noexcept  { return numDeferredDispatches.load (std::memory_order_relaxed); }
+
+    /** Returns the monotonic host time in microseconds that messages are scheduled against. */
+    static int64_t getHostTimeMicroseconds();
 
 private:
     //==============================================================================
+    struct TimedMessage
+    {
+        juce::MidiMessage message;
+        int64_t hostTimeUs = 0;
+    };
+
     struct DeviceState
     {
-        DeviceState (MidiOutputDeviceInstance& d) : device (d) {}
+        DeviceState (MidiOutputDeviceInstance& d) : device (d)    { fifo.reset (1024); }
 
         MidiOutputDeviceInstance& device;
-        std::mutex bufferMutex;
-        MidiMessageArray buffer;
+        choc::fifo::SingleReaderSingleWriterFIFO<TimedMessage> fifo;
+        std::atomic<bool> allNotesOffPending { false };
+
+        // Only used by the dispatch thread
+        TimedMessage nextMessage;
+        bool hasNextMessage = false;
     };
 
     //==============================================================================
@@ -43,10 +92,16 @@ private:
     mutable RealTimeSpinLock timeLock;
     std::shared_mutex deviceMutex;
     TimePosition masterTime;
-    double hiResClockOfMasterTime = 0;
+    int64_t hostTimeOfMasterTimeUs = 0;
+
+    std::array<std::atomic<uint64_t>, LatencyHistogram::numBuckets> latencyCounts {};
+    std::atomic<int64_t> maxLatencyUs { 0 };
+    std::atomic<uint64_t> numDeferredDispatches { 0 };
 
-    TimePosition getCurrentTime() const;
-    void dispatchPendingMessages (DeviceState&, TimePosition editTime);
+    void dispatchPendingMessages (DeviceState&, TimePosition editTime, TimePosition masterTime, int64_t hostTimeOfMasterTimeUs);
+    int64_t sendDueMessages (DeviceState&);
+    void addToLatencyHistogram (int64_t latencyUs);
+    void run() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiNoteDispatcher)
 };
@@ -0,0 +1,52 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLAYBACK
+
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+
+namespace tracktion::inline engine
+{
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("MidiNoteDispatcher doesn't wait for time updates")
+    {
+        MidiNoteDispatcher dispatcher;
+        dispatcher.prepareToPlay (0_tp);
+
+        for (int i = 0; i < 100; ++i)
+            dispatcher.dispatchPendingMessagesForDevices (0_tp);
+
+        CHECK_EQ (dispatcher.getNumDeferredDispatches(), 0u);
+
+        // Whilst the time is being updated the messages are left for the next block
+        std::atomic<bool> shouldStop { false };
+        std::thread updateThread ([&]
+                                  {
+                                      while (! shouldStop)
+                                          dispatcher.masterTimeUpdate (1_tp);
+                                  });
+
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds (10);
+
+        while (dispatcher.getNumDeferredDispatches() == 0 && std::chrono::steady_clock::now() < timeout)
+            dispatcher.dispatchPendingMessagesForDevices (1_tp);
+
+        shouldStop = true;
+        updateThread.join();
+
+        CHECK (dispatcher.getNumDeferredDispatches() > 0);
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLAYBACK
@@ -406,6 +406,9 @@ struct TransportControl::FileFlushTimer  : private Timer
         if (owner.edit.isLoading())
             return;
 
+        if (owner.isRecording())
+            owner.engine.getAudioFileManager().requestWriterFlush();
+
         bool active = juce::Process::isForegroundProcess();
 
         if (active && forcePurge)
@@ -65,20 +65,31 @@ public:
                 && (dontCheckMusicalContext ? true : musicalContext != nullptr);
     }
 
+    /** Edits can be nested, only the outermost pair of calls starts and ends an
+        editing cycle with the document controller. This lets lots of clips be
+        updated in a single cycle rather than one each.
+    */
     void beginEditing (bool dontCheckMusicalContext)
     {
         TRACKTION_ASSERT_MESSAGE_THREAD
 
-        if (canEdit (dontCheckMusicalContext))
+        if (editingDepth++ == 0 && canEdit (dontCheckMusicalContext))
+        {
             dci->beginEditing (dcRef);
+            isEditingCycleOpen = true;
+        }
     }
 
-    void endEditing (bool dontCheckMusicalContext)
+    void endEditing (bool /*dontCheckMusicalContext*/)
     {
         TRACKTION_ASSERT_MESSAGE_THREAD
+        jassert (editingDepth > 0);
 
-        if (canEdit (dontCheckMusicalContext))
+        if (--editingDepth == 0 && isEditingCycleOpen)
+        {
+            isEditingCycleOpen = false;
             dci->endEditing (dcRef);
+        }
     }
 
     void flushStateToValueTree (juce::ValueTree& v)
@@ -98,8 +109,9 @@ public:
         }
     }
 
-    /** @note Must not be editing or already restoring the document while restoring
-              from a state.
+    /** @note Must not be already restoring the document while restoring from a state.
+              This can be called inside a beginEditing/endEditing pair so the
+              restored objects are created in the same editing cycle.
     */
     void beginRestoringState (const juce::ValueTree& state)
     {
@@ -167,6 +179,8 @@ public:
 private:
     std::unique_ptr<MelodyneInstance> wrapper;
     std::unique_ptr<ARADocumentControllerHostInstance> hostInstance;
+    int editingDepth = 0;
+    bool isEditingCycleOpen = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ARADocument)
 };
@@ -247,16 +247,31 @@ struct ARAClipPlayer  : private Selectable::Listener
     void startProcessing()  { TRACKTION_ASSERT_MESSAGE_THREAD if (playbackRegionAndSource != nullptr) playbackRegionAndSource->enable(); }
     void stopProcessing()   { TRACKTION_ASSERT_MESSAGE_THREAD if (playbackRegionAndSource != nullptr) playbackRegionAndSource->disable(); }
 
-    class ContentAnalyser
+    /** Requests the source's analysis as soon as it's created, rather than when
+        it's first needed, so the plugin can analyse all the Edit's sources in
+        parallel in the background. The request is posted so it happens after
+        any editing cycle the clip was created in has finished.
+    */
+    class ContentAnalyser  : private juce::AsyncUpdater
     {
     public:
         ContentAnalyser (const ARAClipPlayer& p)  : pimpl (p)
         {
+            triggerAsyncUpdate();
+        }
+
+        ~ContentAnalyser() override
+        {
+            cancelPendingUpdate();
         }
 
         bool isAnalysing()
         {
-            callBlocking ([this] { updateAnalysingContent(); });
+            callBlocking ([this]
+                          {
+                              cancelPendingUpdate();
+                              updateAnalysingContent();
+                          });
 
             return analysingContent;
         }
@@ -324,6 +339,11 @@ struct ARAClipPlayer  : private Selectable::Listener
         volatile bool analysingContent = false;
         bool firstCall = true;
 
+        void handleAsyncUpdate() override
+        {
+            updateAnalysingContent();
+        }
+
         ContentAnalyser() = delete;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ContentAnalyser)
     };
@@ -598,6 +618,8 @@ struct ARADocumentHolder::Pimpl
 
         if (araDocument != nullptr)
         {
+            // Restore all the clips in a single editing cycle rather than one per clip
+            araDocument->beginEditing (true);
             araDocument->beginRestoringState (edit.getARADocument().lastState);
 
             visitAllTrackItems (edit, [] (TrackItem& i)
@@ -609,6 +631,7 @@ struct ARADocumentHolder::Pimpl
             });
 
             araDocument->endRestoringState();
+            araDocument->endEditing (true);
         }
     }
 
@@ -65,6 +65,7 @@ public:
     bool takesAudioInput() override                  { return true; }
     bool takesMidiInput() override                   { return true; }
     bool producesAudioWhenNoAudioInput() override    { return true; }
+    bool canSleepWhenSilent() override               { return false; }
     bool canBeAddedToClip() override                 { return true; }
     bool canBeAddedToRack() override                 { return true; }
 
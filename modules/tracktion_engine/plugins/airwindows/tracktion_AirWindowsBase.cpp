@@ -148,33 +148,23 @@ void AirWindowsPlugin::processBlock (juce::AudioBuffer<float>& buffer)
     auto samps       = buffer.getNumSamples();
     auto pluginChans = std::max (impl->getNumOutputs(), impl->getNumInputs());
 
+    // The algorithms all read each input frame before writing the output frame
+    // so they can process in place without an intermediate output buffer
     if (pluginChans > numChans)
     {
-        AudioScratchBuffer input (pluginChans, samps);
-        AudioScratchBuffer output (pluginChans, samps);
+        AudioScratchBuffer scratch (pluginChans, samps);
+        scratch.buffer.clear();
+        scratch.buffer.copyFrom (0, 0, buffer, 0, 0, samps);
 
-        input.buffer.clear();
-        output.buffer.clear();
+        auto channels = (float**) scratch.buffer.getArrayOfWritePointers();
+        impl->processReplacing (channels, channels, samps);
 
-        input.buffer.copyFrom (0, 0, buffer, 0, 0, samps);
-
-        impl->processReplacing ((float**)input.buffer.getArrayOfWritePointers(),
-                                (float**)output.buffer.getArrayOfWritePointers(),
-                                samps);
-
-        buffer.copyFrom (0, 0, output.buffer, 0, 0, samps);
+        buffer.copyFrom (0, 0, scratch.buffer, 0, 0, samps);
     }
     else
     {
-        AudioScratchBuffer output (numChans, samps);
-        output.buffer.clear();
-
-        impl->processReplacing ((float**)buffer.getArrayOfWritePointers(),
-                                (float**)output.buffer.getArrayOfWritePointers(),
-                                samps);
-
-        for (int i = 0; i < numChans; ++i)
-            buffer.copyFrom (i, 0, output.buffer, i, 0, samps);
+        auto channels = (float**) buffer.getArrayOfWritePointers();
+        impl->processReplacing (channels, channels, samps);
     }
 }
 
@@ -40,14 +40,143 @@ namespace tracktion { inline namespace engine
 
 std::string getCmajorVersion() { return cmaj::Library::getVersion(); }
 
+//==============================================================================
+/**
+    Caches compiled patches in memory so instances of the same patch share the
+    compiled code, falling back to a persistent folder and then an optional
+    read-only folder of patches that were compiled ahead of time.
+*/
+struct CmajorCompilerCache  : public choc::com::ObjectWithAtomicRefCount<cmaj::CacheDatabaseInterface, CmajorCompilerCache>
+{
+    CmajorCompilerCache (cmaj::CacheDatabaseInterface::Ptr persistentCacheToUse,
+                         cmaj::CacheDatabaseInterface::Ptr precompiledCacheToUse)
+        : persistentCache (std::move (persistentCacheToUse)),
+          precompiledCache (std::move (precompiledCacheToUse))
+    {
+    }
+
+    void store (const char* key, const void* dataToSave, uint64_t dataSize) override
+    {
+        storeInMemory (key, dataToSave, dataSize);
+
+        if (persistentCache)
+            persistentCache->store (key, dataToSave, dataSize);
+    }
+
+    uint64_t reload (const char* key, void* destAddress, uint64_t destSize) override
+    {
+        {
+            const std::scoped_lock sl (mutex);
+
+            if (auto found = memoryCache.find (key); found != memoryCache.end())
+            {
+                const auto& data = found->second;
+
+                if (destAddress != nullptr && destSize >= data.size())
+                    std::memcpy (destAddress, data.data(), data.size());
+
+                return data.size();
+            }
+        }
+
+        for (auto& cache : { persistentCache, precompiledCache })
+        {
+            if (! cache)
+                continue;
+
+            if (const auto size = cache->reload (key, nullptr, 0); size > 0)
+            {
+                std::vector<char> data (static_cast<size_t> (size));
+
+                if (cache->reload (key, data.data(), size) == size)
+                {
+                    storeInMemory (key, data.data(), size);
+
+                    if (destAddress != nullptr && destSize >= size)
+                        std::memcpy (destAddress, data.data(), data.size());
+
+                    return size;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+private:
+    static constexpr size_t maxNumInMemory = 32;
+
+    cmaj::CacheDatabaseInterface::Ptr persistentCache, precompiledCache;
+    std::mutex mutex;
+    std::map<std::string, std::vector<char>> memoryCache;
+    std::deque<std::string> memoryCacheOrder;
+
+    void storeInMemory (const char* key, const void* data, uint64_t size)
+    {
+        const std::scoped_lock sl (mutex);
+        auto [item, isNew] = memoryCache.insert_or_assign (key, std::vector<char> (static_cast<const char*> (data),
+                                                                                  static_cast<const char*> (data) + size));
+
+        if (! isNew)
+            return;
+
+        memoryCacheOrder.push_back (item->first);
+
+        if (memoryCacheOrder.size() > maxNumInMemory)
+        {
+            memoryCache.erase (memoryCacheOrder.front());
+            memoryCacheOrder.pop_front();
+        }
+    }
+};
+
+/** Returns a name for the folder compiled patches are cached in.
+    Compiled code can't be shared between Cmajor versions or CPUs with different
+    instruction sets so these are part of the name.
+*/
+static std::string getCompilerCacheFolderName()
+{
+    std::string cpuFeatures;
+
+   #if JUCE_INTEL
+    if (juce::SystemStats::hasAVX512F())    cpuFeatures += "_avx512";
+    if (juce::SystemStats::hasAVX2())       cpuFeatures += "_avx2";
+    if (juce::SystemStats::hasAVX())        cpuFeatures += "_avx";
+    if (juce::SystemStats::hasSSE41())      cpuFeatures += "_sse41";
+   #elif JUCE_ARM
+    if (juce::SystemStats::hasNeon())       cpuFeatures += "_neon";
+   #endif
+
+    auto name = "cmajor_" + getCmajorVersion() + "_" + juce::SystemStats::getCpuModel().toStdString() + cpuFeatures;
+    return juce::File::createLegalFileName (name).replaceCharacter (' ', '_').toStdString();
+}
+
 cmaj::CacheDatabaseInterface::Ptr createCompilerCache (tracktion::Engine& engine)
 {
-    auto cacheFolder = engine.getTemporaryFileManager().getTempDirectory().getChildFile ("cmajor_patch_cache");
+    const auto folderName = getCompilerCacheFolderName();
+    cmaj::CacheDatabaseInterface::Ptr persistentCache, precompiledCache;
+
+    auto cacheFolder = engine.getPropertyStorage().getAppCacheFolder()
+                         .getChildFile ("cmajor_patch_cache")
+                         .getChildFile (folderName);
 
     if (cacheFolder.createDirectory())
-        return choc::com::create<cmaj::FileBasedCacheDatabase> (cacheFolder.getFullPathName().toStdString(), 100u);
+        persistentCache = choc::com::create<cmaj::FileBasedCacheDatabase> (cacheFolder.getFullPathName().toStdString(), 100u);
 
-    return {};
+    if (auto precompiledFolder = engine.getEngineBehaviour().getPrecompiledCmajorPatchFolder();
+        precompiledFolder != juce::File())
+    {
+        // Use a folder for this version and CPU if there is one, otherwise assume it matches
+        auto folder = precompiledFolder.getChildFile (folderName);
+
+        if (! folder.isDirectory())
+            folder = precompiledFolder;
+
+        if (folder.isDirectory())
+            precompiledCache = choc::com::create<cmaj::FileBasedCacheDatabase> (folder.getFullPathName().toStdString(), 10000u);
+    }
+
+    return choc::com::create<CmajorCompilerCache> (std::move (persistentCache), std::move (precompiledCache));
 }
 
 std::unique_ptr<juce::AudioPluginFormat> createCmajorPatchPluginFormat (tracktion::Engine& engine)
@@ -50,9 +50,6 @@ void ChorusPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     SCOPED_REALTIME_CHECK
 
-    float ph = 0.0f;
-    int bufPos = 0;
-
     const float delayMs = 20.0f;
     const float minSweepSamples = (float) ((delayMs * sampleRate) / 1000.0);
     const float maxSweepSamples = (float) (((delayMs + depthMs) * sampleRate) / 1000.0);
@@ -66,54 +63,88 @@ void ChorusPlugin::applyToBuffer (const PluginRenderContext& fc)
     const float lfoFactor = 0.5f * (maxSweepSamples - minSweepSamples);
     const float lfoOffset = minSweepSamples + lfoFactor;
 
+    // The right channel's LFO is offset by a constant phase so can be found from the left's sin and cos
+    const float widthPhase = juce::MathConstants<float>::pi * width;
+    const double widthSin = std::sin (widthPhase), widthCos = std::cos (widthPhase);
+    const double speedSin = std::sin ((double) speed), speedCos = std::cos ((double) speed);
+
     AudioFadeCurve::CrossfadeLevels wetDry (mixProportion);
 
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
-    for (int chan = std::min (2, fc.destBuffer->getNumChannels()); --chan >= 0;)
+    const int numChans = std::min (2, fc.destBuffer->getNumChannels());
+    int bufPos = delayBuffer.bufferPos % lengthInSamples;
+
+    // The LFOs are calculated for a chunk at a time by rotating a phasor, which is
+    // re-seeded from the phase for each chunk so it doesn't drift
+    constexpr int chunkSize = 64;
+    float sweeps[2][chunkSize];
+
+    for (int start = 0; start < fc.bufferNumSamples; start += chunkSize)
     {
-        float* const d = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample);
-        float* const buf = (float*) delayBuffer.buffers[chan].getData();
+        const int numThisTime = std::min (chunkSize, fc.bufferNumSamples - start);
+
+        {
+            double lfoSin = std::sin ((double) phase), lfoCos = std::cos ((double) phase);
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                sweeps[0][i] = lfoOffset + lfoFactor * (float) lfoSin;
+                sweeps[1][i] = lfoOffset + lfoFactor * (float) (lfoSin * widthCos + lfoCos * widthSin);
 
-        ph = phase;
-        if (chan > 0)
-            ph += juce::MathConstants<float>::pi * width;
+                const double nextSin = lfoSin * speedCos + lfoCos * speedSin;
+                lfoCos = lfoCos * speedCos - lfoSin * speedSin;
+                lfoSin = nextSin;
+            }
 
-        bufPos = delayBuffer.bufferPos;
+            phase += speed * (float) numThisTime;
 
-        for (int i = 0; i < fc.bufferNumSamples; ++i)
+            if (phase >= juce::MathConstants<float>::pi * 2)
+                phase -= juce::MathConstants<float>::pi * 2;
+        }
+
+        for (int chan = 0; chan < numChans; ++chan)
         {
-            const float in = d[i];
+            float* const d = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample + start);
+            float* const buf = (float*) delayBuffer.buffers[chan].getData();
+            const float* const sweep = sweeps[chan];
+            int pos = bufPos;
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                const float in = d[i];
 
-            const float sweep = lfoOffset + lfoFactor * sinf (ph);
-            ph += speed;
+                int intSweepPos = juce::roundToInt (sweep[i]);
+                const float interp = sweep[i] - intSweepPos;
 
-            int intSweepPos = juce::roundToInt (sweep);
-            const float interp = sweep - intSweepPos;
-            intSweepPos = bufPos + lengthInSamples - intSweepPos;
+                // The sweep is always shorter than the buffer so this only needs wrapping once
+                int readPos = pos + lengthInSamples - intSweepPos;
 
-            const float out = buf[(intSweepPos - 1) % lengthInSamples] * interp
-                              + buf[intSweepPos % lengthInSamples] * (1.0f - interp);
+                if (readPos >= lengthInSamples)
+                    readPos -= lengthInSamples;
 
-            float n = in + out * feedbackGain;
+                const int prevPos = readPos == 0 ? lengthInSamples - 1 : readPos - 1;
+                const float out = buf[prevPos] * interp + buf[readPos] * (1.0f - interp);
 
-            JUCE_UNDENORMALISE (n);
+                float n = in + out * feedbackGain;
 
-            buf[bufPos] = n;
+                JUCE_UNDENORMALISE (n);
 
-            d[i] = out * wetDry.gain1 + in * wetDry.gain2;
+                buf[pos] = n;
 
-            bufPos = (bufPos + 1) % lengthInSamples;
+                d[i] = out * wetDry.gain1 + in * wetDry.gain2;
+
+                if (++pos == lengthInSamples)
+                    pos = 0;
+            }
         }
+
+        bufPos = (bufPos + numThisTime) % lengthInSamples;
     }
 
     jassert (! hasFloatingPointDenormaliseOccurred());
     zeroDenormalisedValuesIfNeeded (*fc.destBuffer);
 
-    phase = ph;
-    if (phase >= juce::MathConstants<float>::pi * 2)
-        phase -= juce::MathConstants<float>::pi * 2;
-
     delayBuffer.bufferPos = bufPos;
 }
 
@@ -26,6 +26,7 @@ public:
     juce::String getShortName (int) override            { return getName(); }
 
     int getNumOutputChannelsGivenInputs (int numInputChannels) override { return juce::jmin (numInputChannels, 2); }
+    bool canSleepWhenSilent() override                                  { return false; }
     void initialise (const PluginInitialisationInfo&) override;
     void deinitialise() override;
     void applyToBuffer (const PluginRenderContext&) override;
@@ -45,6 +45,7 @@ CompressorPlugin::CompressorPlugin (PluginCreationInfo info)  : Plugin (info)
                         [] (const juce::String& s)   { return dbStringToDb (s); } };
 
     useSidechainTrigger.referTo (state, IDs::sidechainTrigger, getUndoManager());
+    lookAheadMs.referTo (state, IDs::lookAheadMs, getUndoManager(), 0.0f);
 }
 
 CompressorPlugin::~CompressorPlugin()
@@ -70,10 +71,24 @@ void CompressorPlugin::getChannelNames (juce::StringArray* ins,
         ins->add (TRANS("Sidechain Trigger"));
 }
 
-void CompressorPlugin::initialise (const PluginInitialisationInfo&)
+double CompressorPlugin::getLatencySeconds()
+{
+    return sampleRate > 0.0 ? getLookAheadSamples() / sampleRate : 0.0;
+}
+
+int CompressorPlugin::getLookAheadSamples() const
+{
+    return juce::roundToInt (juce::jlimit (0.0f, getMaxLookAheadMs(), lookAheadMs.get()) * sampleRate / 1000.0);
+}
+
+void CompressorPlugin::initialise (const PluginInitialisationInfo& info)
 {
     currentLevel = 0.0;
     lastSamp = 0.0f;
+
+    lookAheadBuffer.setSize (2, juce::roundToInt (getMaxLookAheadMs() * info.sampleRate / 1000.0) + 1);
+    lookAheadBuffer.clear();
+    lookAheadPos = 0;
 }
 
 void CompressorPlugin::deinitialise()
@@ -98,82 +113,91 @@ void CompressorPlugin::applyToBuffer (const PluginRenderContext& fc)
     const bool useSidechain = useSidechainTrigger.get();
     const float sidechainGain = dbToGain (sidechainDb.getCurrentValue());
 
-    float* b1 = fc.destBuffer->getWritePointer (0, fc.bufferStartSample);
+    const int numSamples = fc.bufferNumSamples;
+    const int numChannels = std::min (2, fc.destBuffer->getNumChannels());
+
+    // The gain is worked out for the whole block in a few passes, each over a single buffer
+    AudioScratchBuffer scratch (1, numSamples);
+    auto gain = scratch.buffer.getWritePointer (0);
 
-    if (fc.destBuffer->getNumChannels() >= 2)
+    // Rectify the level to detect
+    if (useSidechain && fc.destBuffer->getNumChannels() > 2)
     {
-        float* b2 = fc.destBuffer->getWritePointer (1, fc.bufferStartSample);
-        float* b3 = fc.destBuffer->getNumChannels() > 2 ? fc.destBuffer->getWritePointer (2, fc.bufferStartSample) : nullptr;
-
-        for (int i = fc.bufferNumSamples; --i >= 0;)
-        {
-            float samp1 = *b1 + 1.0f;
-            samp1 -= 1.0f;
-            float samp2 = *b2 + 1.0f;
-            samp2 -= 1.0f;
-
-            float sampAvg = 0.0f;
-
-            if (useSidechain && b3 != nullptr)
-            {
-                sampAvg = lastSamp * preFilterAmount
-                            + std::abs (*b3++ * sidechainGain) * ((1.0f - preFilterAmount));
-            }
-            else
-            {
-                sampAvg = lastSamp * preFilterAmount
-                            + std::abs (samp1 + samp2) * ((1.0f - preFilterAmount) * 0.5f);
-            }
-
-            JUCE_UNDENORMALISE (sampAvg);
-
-            lastSamp = sampAvg;
-
-            if (sampAvg > thresh)
-                currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
-            else
-                currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
-
-            float r = outputGain;
-
-            if (currentLevel > thresh)
-            {
-                r *= (float)((thresh + (currentLevel - thresh) * rat)
-                              / currentLevel);
-            }
-
-            *b1++ = samp1 * r;
-            *b2++ = samp2 * r;
-        }
+        juce::FloatVectorOperations::copyWithMultiply (gain, fc.destBuffer->getReadPointer (2, fc.bufferStartSample),
+                                                       sidechainGain, numSamples);
+    }
+    else if (numChannels == 2)
+    {
+        juce::FloatVectorOperations::add (gain, fc.destBuffer->getReadPointer (0, fc.bufferStartSample),
+                                          fc.destBuffer->getReadPointer (1, fc.bufferStartSample), numSamples);
+        juce::FloatVectorOperations::multiply (gain, 0.5f, numSamples);
     }
     else
     {
-        for (int i = fc.bufferNumSamples; --i >= 0;)
-        {
-            const float samp = *b1;
-            const float sampAvg = lastSamp * preFilterAmount
-                                    + std::abs (samp) * (1.0f - preFilterAmount);
-            lastSamp = sampAvg;
+        juce::FloatVectorOperations::copy (gain, fc.destBuffer->getReadPointer (0, fc.bufferStartSample), numSamples);
+    }
 
-            JUCE_UNDENORMALISE (lastSamp);
+    juce::FloatVectorOperations::abs (gain, gain, numSamples);
 
-            if (sampAvg > thresh)
-                currentLevel = (currentLevel - sampAvg) * attackFactor + sampAvg;
-            else
-                currentLevel = (currentLevel - sampAvg) * releaseFactor + sampAvg;
+    // Follow the level. This is the only part that has to run sample by sample
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float sampAvg = lastSamp * preFilterAmount + gain[i] * (1.0f - preFilterAmount);
+        JUCE_UNDENORMALISE (sampAvg);
+        lastSamp = sampAvg;
 
-            float r = outputGain;
+        const auto factor = sampAvg > thresh ? attackFactor : releaseFactor;
+        currentLevel = (currentLevel - sampAvg) * factor + sampAvg;
+        gain[i] = (float) currentLevel;
+    }
 
-            if (currentLevel > thresh)
-                r *= (float)((thresh + (currentLevel - thresh) * rat) / currentLevel);
+    // Turn the level into a gain. Clamping the level to the threshold makes the
+    // gain 1 below it without needing to branch
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto level = std::max (gain[i], thresh);
+        gain[i] = outputGain * (thresh + (level - thresh) * rat) / level;
+    }
 
-            *b1++ = samp * r;
-        }
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto data = fc.destBuffer->getWritePointer (ch, fc.bufferStartSample);
+        applyLookAhead (data, ch, numSamples);
+        juce::FloatVectorOperations::multiply (data, gain, numSamples);
     }
 
+    lookAheadPos = (lookAheadPos + numSamples) % lookAheadBuffer.getNumSamples();
+
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 }
 
+void CompressorPlugin::applyLookAhead (float* data, int channel, int numSamples) noexcept
+{
+    const auto delay = getLookAheadSamples();
+
+    if (delay == 0)
+        return;
+
+    const auto size = lookAheadBuffer.getNumSamples();
+    jassert (delay < size);
+
+    auto buffer = lookAheadBuffer.getWritePointer (channel);
+    int writePos = lookAheadPos;
+    int readPos = writePos - delay;
+
+    if (readPos < 0)
+        readPos += size;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        buffer[writePos] = data[i];
+        data[i] = buffer[readPos];
+
+        if (++writePos == size)     writePos = 0;
+        if (++readPos == size)      readPos = 0;
+    }
+}
+
 float CompressorPlugin::getThreshold() const
 {
     return thresholdGain.getCurrentValue();
@@ -206,7 +230,7 @@ void CompressorPlugin::restorePluginStateFromValueTree (const juce::ValueTree& v
     outputDb.setFromValueTree (v);
     sidechainDb.setFromValueTree (v);
 
-    copyPropertiesToCachedValues (v, useSidechainTrigger);
+    copyPropertiesToCachedValues (v, useSidechainTrigger, lookAheadMs);
 }
 
 void CompressorPlugin::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& id)
@@ -214,6 +238,12 @@ void CompressorPlugin::valueTreePropertyChanged (juce::ValueTree& v, const juce:
     if (v == state && id == IDs::sidechainTrigger)
         propertiesChanged();
 
+    if (v == state && id == IDs::lookAheadMs)
+    {
+        lookAheadMs.forceUpdateOfCachedValue();
+        edit.restartPlayback(); // Rebuild the graph so the new latency is compensated for
+    }
+
     Plugin::valueTreePropertyChanged (v, id);
 }
 
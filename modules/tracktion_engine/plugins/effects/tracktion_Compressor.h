@@ -31,8 +31,10 @@ public:
     juce::String getPluginType() override                               { return xmlTypeName; }
     juce::String getShortName (int) override                            { return TRANS("Comp"); }
     int getNumOutputChannelsGivenInputs (int numInputChannels) override { return juce::jmin (numInputChannels, 2); }
+    bool canSleepWhenSilent() override                                  { return false; }
     void getChannelNames (juce::StringArray*, juce::StringArray*) override;
 
+    double getLatencySeconds() override;
     void initialise (const PluginInitialisationInfo&) override;
     void deinitialise() override;
     void applyToBuffer (const PluginRenderContext&) override;
@@ -43,15 +45,27 @@ public:
                             releaseMs, outputDb, sidechainDb;
     juce::CachedValue<bool> useSidechainTrigger;
 
+    /** Delays the audio so the gain can start changing before the level does.
+        This adds the same amount of latency so changing it restarts playback.
+    */
+    juce::CachedValue<float> lookAheadMs;
+
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
 
     static float getMinThreshold()      { return 0.01f; }
     static float getMaxThreshold()      { return 1.0f; }
+    static float getMaxLookAheadMs()    { return 20.0f; }
 
 private:
     double currentLevel = 0.0;
     float lastSamp = 0.0f;
 
+    juce::AudioBuffer<float> lookAheadBuffer;
+    int lookAheadPos = 0;
+
+    int getLookAheadSamples() const;
+    void applyLookAhead (float* data, int channel, int numSamples) noexcept;
+
     void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompressorPlugin)
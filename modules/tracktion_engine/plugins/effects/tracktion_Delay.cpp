@@ -77,21 +77,31 @@ void DelayPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
-    for (int chan = std::min (2, fc.destBuffer->getNumChannels()); --chan >= 0;)
+    const int numChans = std::min (2, fc.destBuffer->getNumChannels());
+
+    // The block is processed in runs that don't wrap around the delay line, so the
+    // inner loop has no modulo or dependencies between samples and can be vectorised
+    for (int start = 0; start < fc.bufferNumSamples;)
     {
-        float* const d = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample);
-        float* const buf = (float*) delayBuffer.buffers[chan].getData();
+        const int pos = (start + offset) % lengthInSamples;
+        const int numThisTime = std::min (fc.bufferNumSamples - start, lengthInSamples - pos);
 
-        for (int i = 0; i < fc.bufferNumSamples; ++i)
+        for (int chan = 0; chan < numChans; ++chan)
         {
-            float* const b = buf + ((i + offset) % lengthInSamples);
-
-            float in = d[i];
-            d[i] = wetDry.gain2 * in + wetDry.gain1 * *b;
-            in += *b * feedbackGain;
-            JUCE_UNDENORMALISE (in);
-            *b = in;
+            float* const d = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample + start);
+            float* const b = (float*) delayBuffer.buffers[chan].getData() + pos;
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                float in = d[i];
+                d[i] = wetDry.gain2 * in + wetDry.gain1 * b[i];
+                in += b[i] * feedbackGain;
+                JUCE_UNDENORMALISE (in);
+                b[i] = in;
+            }
         }
+
+        start += numThisTime;
     }
 
     delayBuffer.bufferPos = (delayBuffer.bufferPos + fc.bufferNumSamples) % lengthInSamples;
@@ -66,6 +66,7 @@ public:
     juce::String getSelectableDescription() override    { return TRANS("Delay Plugin"); }
 
     int getNumOutputChannelsGivenInputs (int numInputChannels) override     { return juce::jmin (numInputChannels, 2); }
+    bool canSleepWhenSilent() override                                      { return false; }
     void initialise (const PluginInitialisationInfo&) override;
     void deinitialise() override;
     void reset() override;
@@ -196,57 +196,41 @@ void EqualiserPlugin::updateIIRFilters()
     if (needToUpdateFilters[0])
     {
         needToUpdateFilters[0] = false;
-
-        auto c = juce::IIRCoefficients::makeLowShelf (lastSampleRate, loFreq->getCurrentValue(), loQ->getCurrentValue(),
-                                                      convertEQLevelToGain (loGain->getCurrentValue()));
-
-        for (int i = EQ_CHANS; --i >= 0;)
-            low[i].setCoefficients (c);
+        filters.setCoefficients (0, juce::IIRCoefficients::makeLowShelf (lastSampleRate, loFreq->getCurrentValue(), loQ->getCurrentValue(),
+                                                                         convertEQLevelToGain (loGain->getCurrentValue())));
     }
 
     if (needToUpdateFilters[1])
     {
         needToUpdateFilters[1] = false;
-
-        auto c = juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq1->getCurrentValue(), midQ1->getCurrentValue(),
-                                                        convertEQLevelToGain (midGain1->getCurrentValue()));
-
-        for (int i = EQ_CHANS; --i >= 0;)
-            mid1[i].setCoefficients (c);
+        filters.setCoefficients (1, juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq1->getCurrentValue(), midQ1->getCurrentValue(),
+                                                                           convertEQLevelToGain (midGain1->getCurrentValue())));
     }
 
     if (needToUpdateFilters[2])
     {
         needToUpdateFilters[2] = false;
-
-        auto c = juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq2->getCurrentValue(), midQ2->getCurrentValue(),
-                                                        convertEQLevelToGain (midGain2->getCurrentValue()));
-
-        for (int i = EQ_CHANS; --i >= 0;)
-            mid2[i].setCoefficients (c);
+        filters.setCoefficients (2, juce::IIRCoefficients::makePeakFilter (lastSampleRate, midFreq2->getCurrentValue(), midQ2->getCurrentValue(),
+                                                                           convertEQLevelToGain (midGain2->getCurrentValue())));
     }
 
     if (needToUpdateFilters[3])
     {
         needToUpdateFilters[3] = false;
-
-        auto c = juce::IIRCoefficients::makeHighShelf (lastSampleRate, hiFreq->getCurrentValue(), hiQ->getCurrentValue(),
-                                                       convertEQLevelToGain (hiGain->getCurrentValue()));
-
-        for (int i = EQ_CHANS; --i >= 0;)
-            high[i].setCoefficients (c);
+        filters.setCoefficients (3, juce::IIRCoefficients::makeHighShelf (lastSampleRate, hiFreq->getCurrentValue(), hiQ->getCurrentValue(),
+                                                                          convertEQLevelToGain (hiGain->getCurrentValue())));
     }
+
+    // Bands with no gain don't change the sound so can be skipped
+    filters.setStageEnabled (0, loGain->getCurrentValue() != 0);
+    filters.setStageEnabled (1, midGain1->getCurrentValue() != 0);
+    filters.setStageEnabled (2, midGain2->getCurrentValue() != 0);
+    filters.setStageEnabled (3, hiGain->getCurrentValue() != 0);
 }
 
 void EqualiserPlugin::initialise (const PluginInitialisationInfo&)
 {
-    for (int i = EQ_CHANS; --i >= 0;)
-    {
-        low[i].reset();
-        mid1[i].reset();
-        mid2[i].reset();
-        high[i].reset();
-    }
+    const juce::ScopedLock sl (filterLock);
 
     if (lastSampleRate != sampleRate)
         curveNeedsUpdating = true;
@@ -257,6 +241,7 @@ void EqualiserPlugin::initialise (const PluginInitialisationInfo&)
         needToUpdateFilters[i] = true;
 
     updateIIRFilters();
+    filters.prepare (sampleRate, 0.01);
 }
 
 void EqualiserPlugin::deinitialise()
@@ -279,15 +264,7 @@ void EqualiserPlugin::applyToBuffer (const PluginRenderContext& fc)
 
         addAntiDenormalisationNoise (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
 
-        for (int i = std::min ((int) EQ_CHANS, fc.destBuffer->getNumChannels()); --i >= 0;)
-        {
-            auto data = fc.destBuffer->getWritePointer (i, fc.bufferStartSample);
-
-            if (loGain->getCurrentValue() != 0)       low[i] .processSamples (data, fc.bufferNumSamples);
-            if (midGain1->getCurrentValue() != 0)     mid1[i].processSamples (data, fc.bufferNumSamples);
-            if (midGain2->getCurrentValue() != 0)     mid2[i].processSamples (data, fc.bufferNumSamples);
-            if (hiGain->getCurrentValue() != 0)       high[i].processSamples (data, fc.bufferNumSamples);
-        }
+        filters.process (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
 
         if (phaseInvert)
             fc.destBuffer->applyGain (fc.bufferStartSample, fc.bufferNumSamples, -1.0f);
@@ -311,10 +288,15 @@ float EqualiserPlugin::getDBGainAtFrequency (float f)
         float samps[sampSize * 2 + 8] = {};
         samps[0] = 1.0f;
 
-        if (loGain->getCurrentValue() != 0)     juce::IIRFilter (low[0]) .processSamples (samps, sampSize);
-        if (midGain1->getCurrentValue() != 0)   juce::IIRFilter (mid1[0]).processSamples (samps, sampSize);
-        if (midGain2->getCurrentValue() != 0)   juce::IIRFilter (mid2[0]).processSamples (samps, sampSize);
-        if (hiGain->getCurrentValue() != 0)     juce::IIRFilter (high[0]).processSamples (samps, sampSize);
+        auto impulseFilters = [this]
+        {
+            const juce::ScopedLock sl (filterLock);
+            return filters;
+        }();
+
+        impulseFilters.prepare (lastSampleRate, 0.0);
+        float* impulse[] = { samps };
+        impulseFilters.process (impulse, 1, sampSize);
 
         fft.performRealOnlyForwardTransform (samps);
 
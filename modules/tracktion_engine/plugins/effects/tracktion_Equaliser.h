@@ -81,7 +81,7 @@ private:
     bool curveNeedsUpdating = true;
 
     enum { EQ_CHANS = 2 };
-    juce::IIRFilter low[EQ_CHANS], mid1[EQ_CHANS], mid2[EQ_CHANS], high[EQ_CHANS];
+    BiquadCascade filters { 4 };
 
     enum { fftOrder = 10 };
     juce::dsp::FFT fft { fftOrder };
@@ -333,10 +333,8 @@ public:
             lfo1.reset();
             lfo2.reset();
 
-            filterL1.reset();
-            filterR1.reset();
-            filterL2.reset();
-            filterR2.reset();
+            filter1.reset();
+            filter2.reset();
 
             for (auto& o : oscillators)
                 o.start();
@@ -387,6 +385,8 @@ public:
             lastLegato = paramValue (synth.legato);
             activeNote.reset (newRate, paramValue (synth.legato) / 1000.0f);
             filterFrequencySmoother.reset (newRate, 0.05f);
+            filter1.prepare (newRate, 0.001);
+            filter2.prepare (newRate, 0.001);
 
             for (auto& itr : smoothers)
                 itr.second.reset (newRate, 0.01f);
@@ -429,16 +429,14 @@ public:
         // Apply filter
         if (synth.filterTypeValue != 0)
         {
-            filterL1.processSamples (renderBuffer.getWritePointer (0), numSamples);
-            filterR1.processSamples (renderBuffer.getWritePointer (1), numSamples);
+            filter1.process (renderBuffer, 0, numSamples);
 
             if (synth.filterSlopeValue == 24)
             {
                 clip (renderBuffer.getWritePointer (0), numSamples);
                 clip (renderBuffer.getWritePointer (1), numSamples);
 
-                filterL2.processSamples (renderBuffer.getWritePointer (0), numSamples);
-                filterR2.processSamples (renderBuffer.getWritePointer (1), numSamples);
+                filter2.process (renderBuffer, 0, numSamples);
             }
         }
 
@@ -648,11 +646,8 @@ public:
                 coefs2 = juce::IIRCoefficients::makeNotchFilter (currentSampleRate, lastFilterFreq, 0.70710678118655f);
             }
 
-            filterL1.setCoefficients (coefs1);
-            filterR1.setCoefficients (coefs1);
-
-            filterL2.setCoefficients (coefs2);
-            filterR2.setCoefficients (coefs2);
+            filter1.setCoefficients (0, coefs1, snapAllValues);
+            filter2.setCoefficients (0, coefs2, snapAllValues);
         }
 
         // Oscillators
@@ -743,7 +738,7 @@ private:
     ExpEnvelope ampAdsr;
     LinEnvelope filterAdsr, modAdsr1, modAdsr2;
     SimpleLFO lfo1, lfo2;
-    juce::IIRFilter filterL1, filterR1, filterL2, filterR2;
+    BiquadCascade filter1, filter2;
 
     ValueSmoother<float> filterFrequencySmoother;
 
@@ -1437,6 +1432,8 @@ void FourOscPlugin::initialise (const PluginInitialisationInfo& info)
 
     for (auto& itr : smoothers)
         itr.second.reset (info.sampleRate, 0.01f);
+
+    masterLevelGains.setSize (1, info.blockSizeSamples);
 }
 
 void FourOscPlugin::deinitialise()
@@ -1471,6 +1468,15 @@ void FourOscPlugin::applyToBuffer (const PluginRenderContext& fc)
             if (fc.bufferForMidiMessages->isAllNotesOff)
                 turnOffAllVoices (true);
 
+        // Follow any master level automation sample by sample
+        auto gains = masterLevelGains.getWritePointer (0);
+        const bool isMasterLevelAutomated = fc.bufferNumSamples <= masterLevelGains.getNumSamples()
+                                             && masterLevel->getValuesForBlock (fc.editTime, gains, fc.bufferNumSamples);
+
+        if (isMasterLevelAutomated)
+            for (int i = 0; i < fc.bufferNumSamples; ++i)
+                gains[i] = juce::Decibels::decibelsToGain (gains[i]);
+
         // Chop the buffer in 32 sample blocks so modulation is smooth
         int todo = fc.bufferNumSamples;
         int pos  = fc.bufferStartSample;
@@ -1493,6 +1499,7 @@ void FourOscPlugin::applyToBuffer (const PluginRenderContext& fc)
                 }
             }
 
+            masterLevelGainsForBlock = isMasterLevelAutomated ? gains + (pos - fc.bufferStartSample) : nullptr;
             applyToBuffer (workBuffer.buffer, midi);
 
             if (fc.destBuffer->getNumChannels() == 1)
@@ -1511,6 +1518,8 @@ void FourOscPlugin::applyToBuffer (const PluginRenderContext& fc)
             pos += thisBlock;
         }
 
+        masterLevelGainsForBlock = nullptr;
+
         for (int ch = 2; ch < fc.destBuffer->getNumChannels(); ch++)
             fc.destBuffer->clear (ch, fc.bufferStartSample, fc.bufferNumSamples);
     }
@@ -1552,7 +1561,17 @@ void FourOscPlugin::applyEffects (juce::AudioBuffer<float>& buffer)
         reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), numSamples);
 
     // Apply master level
-    buffer.applyGain (juce::Decibels::decibelsToGain (paramValue (masterLevel)));
+    const auto masterGain = juce::Decibels::decibelsToGain (paramValue (masterLevel));
+
+    if (masterLevelGainsForBlock != nullptr)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::multiply (buffer.getWritePointer (ch), masterLevelGainsForBlock, numSamples);
+    }
+    else
+    {
+        buffer.applyGain (masterGain);
+    }
 }
 
 void FourOscPlugin::updateParams (juce::AudioBuffer<float>& buffer)
@@ -195,6 +195,7 @@ public:
     bool isSynth() override                             { return true; }
     bool producesAudioWhenNoAudioInput() override       { return true; }
     double getTailLength() const override               { return ampRelease->getCurrentValue(); }
+    bool canSleepWhenSilent() override                  { return false; }
 
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
 
@@ -383,6 +384,9 @@ private:
     std::unique_ptr<FOChorus> chorus;
     std::unordered_map<AutomatableParameter*, ValueSmoother<float>> smoothers;
 
+    juce::AudioBuffer<float> masterLevelGains;
+    const float* masterLevelGainsForBlock = nullptr;
+
     bool flushingState = false;
     float currentTempo = 0.0f;
     LevelMeasurer levelMeasurer;
@@ -30,6 +30,7 @@ ImpulseResponsePlugin::ImpulseResponsePlugin (PluginCreationInfo info)
 
     normalise.referTo (state, IDs::normalise, um, true);
     trimSilence.referTo (state, IDs::trimSilence, um, false);
+    mode.referTo (state, IDs::mode, um, (int) Mode::zeroLatency);
 
     juce::NormalisableRange volumeRange { -12.0f, 6.0f };
     volumeRange.setSkewForCentre (0.0f);
@@ -136,7 +137,10 @@ juce::String ImpulseResponsePlugin::getSelectableDescription()  { return getName
 
 double ImpulseResponsePlugin::getLatencySeconds()
 {
-    return processorChain.get<convolutionIndex>().getLatency() / sampleRate;
+    if (sampleRate <= 0.0)
+        return 0.0;
+
+    return ConvolutionImpulseResponse::getLatencySamples (getConvolutionOptions()) / sampleRate;
 }
 
 void ImpulseResponsePlugin::initialise (const PluginInitialisationInfo& info)
@@ -147,6 +151,12 @@ void ImpulseResponsePlugin::initialise (const PluginInitialisationInfo& info)
     processSpec.numChannels = 2;
     processorChain.prepare (processSpec);
 
+    dryDelay.setMaximumDelayInSamples (ConvolutionImpulseResponse::tailStart);
+    dryDelay.prepare (processSpec);
+
+    isPrepared = true;
+    updateConvolver();
+
     // Update smoothers
     lowFreqSmoother.setTargetValue (midiNoteToFrequency (lowPassCutoffParam->getCurrentValue()));
     highFreqSmoother.setTargetValue (midiNoteToFrequency (highPassCutoffParam->getCurrentValue()));
@@ -167,11 +177,19 @@ void ImpulseResponsePlugin::initialise (const PluginInitialisationInfo& info)
 }
 
 void ImpulseResponsePlugin::deinitialise()
-{}
+{
+    isPrepared = false;
+}
 
 void ImpulseResponsePlugin::reset()
 {
     processorChain.reset();
+
+    const juce::SpinLock::ScopedLockType sl (convolverLock);
+    dryDelay.reset();
+
+    if (convolver != nullptr)
+        convolver->reset();
 }
 
 void ImpulseResponsePlugin::applyToBuffer (const PluginRenderContext& fc)
@@ -193,6 +211,35 @@ void ImpulseResponsePlugin::applyToBuffer (const PluginRenderContext& fc)
 
     AudioScratchBuffer dryBuffer (*fc.destBuffer);
 
+    {
+        const juce::SpinLock::ScopedLockType sl (convolverLock);
+
+        // Delay the dry signal to line up with the convolved one
+        if (latencySamples > 0)
+        {
+            const int numChannels = std::min (2, dryBuffer.buffer.getNumChannels());
+            dryDelay.setDelay ((float) latencySamples);
+
+            auto dryBlock = juce::dsp::AudioBlock<float> (dryBuffer.buffer).getSubsetChannelBlock (0, (size_t) numChannels);
+            dryDelay.process (juce::dsp::ProcessContextReplacing<float> (dryBlock));
+
+            if (convolver == nullptr)
+                for (int c = 0; c < numChannels; ++c)
+                    fc.destBuffer->copyFrom (c, fc.bufferStartSample, dryBuffer.buffer, c, fc.bufferStartSample, fc.bufferNumSamples);
+        }
+
+        if (convolver != nullptr)
+        {
+            float* channels[2] = {};
+            const int numChannels = std::min (2, fc.destBuffer->getNumChannels());
+
+            for (int i = 0; i < numChannels; ++i)
+                channels[i] = fc.destBuffer->getWritePointer (i, fc.bufferStartSample);
+
+            convolver->process (channels, numChannels, fc.bufferNumSamples);
+        }
+    }
+
     if (gainSmoother.isSmoothing() || lowFreqSmoother.isSmoothing() || highFreqSmoother.isSmoothing() || qSmoother.isSmoothing())
     {
         const int blockSize = 32;
@@ -252,7 +299,7 @@ void ImpulseResponsePlugin::applyToBuffer (const PluginRenderContext& fc)
 
 void ImpulseResponsePlugin::restorePluginStateFromValueTree (const juce::ValueTree& v)
 {
-    copyPropertiesToCachedValues (v, gainValue, highPassCutoffValue, lowPassCutoffValue, mixValue, qValue);
+    copyPropertiesToCachedValues (v, gainValue, highPassCutoffValue, lowPassCutoffValue, mixValue, qValue, mode);
 
     state.setProperty (IDs::name, v[IDs::name], getUndoManager());
 
@@ -263,6 +310,26 @@ void ImpulseResponsePlugin::restorePluginStateFromValueTree (const juce::ValueTr
         p->updateFromAttachedValue();
 }
 
+size_t ImpulseResponsePlugin::getAllocatedBytes()
+{
+    auto numBytes = (size_t) impulseResponse.getNumChannels() * (size_t) impulseResponse.getNumSamples() * sizeof (float);
+
+    const juce::SpinLock::ScopedLockType sl (convolverLock);
+
+    if (convolver != nullptr)
+    {
+        auto& ir = *convolver->getImpulseResponse();
+
+        for (int i = 0; i < ir.getNumChannels(); ++i)
+        {
+            auto& c = ir.getChannel (i);
+            numBytes += (c.head.size() + c.earlySpectra.size() + c.lateSpectra.size()) * sizeof (float);
+        }
+    }
+
+    return numBytes;
+}
+
 //==============================================================================
 void ImpulseResponsePlugin::loadImpulseResponseFromState()
 {
@@ -277,24 +344,62 @@ void ImpulseResponsePlugin::loadImpulseResponseFromState()
             reader->read (&loadIRBuffer, 0, (int) reader->lengthInSamples, 0, true, true);
 
             jassert (reader->numChannels > 0);
-            processorChain.get<convolutionIndex>().loadImpulseResponse (std::move (loadIRBuffer),
-                                                                        reader->sampleRate,
-                                                                        reader->numChannels > 1 ? juce::dsp::Convolution::Stereo::yes
-                                                                                                : juce::dsp::Convolution::Stereo::no,
-                                                                        trimSilence.get() ? juce::dsp::Convolution::Trim::yes
-                                                                                          : juce::dsp::Convolution::Trim::no,
-                                                                        normalise.get() ? juce::dsp::Convolution::Normalise::yes
-                                                                                        : juce::dsp::Convolution::Normalise::no);
+            impulseResponse = std::move (loadIRBuffer);
+            impulseResponseSampleRate = reader->sampleRate;
+            updateConvolver();
         }
     }
 }
 
+void ImpulseResponsePlugin::updateConvolver()
+{
+    // The IR can only be prepared once the sample rate's known
+    if (! isPrepared)
+        return;
+
+    const auto options = getConvolutionOptions();
+    std::unique_ptr<PartitionedConvolver> newConvolver;
+
+    if (impulseResponse.getNumSamples() > 0)
+    {
+        auto ir = ConvolutionImpulseResponse::get (impulseResponse, impulseResponseSampleRate, options);
+
+        if (ir->getLength() > 0)
+            newConvolver = std::make_unique<PartitionedConvolver> (std::move (ir), 2,
+                                                                   engine.getEngineBehaviour().getConvolutionBackend());
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType sl (convolverLock);
+        std::swap (convolver, newConvolver);
+        latencySamples = ConvolutionImpulseResponse::getLatencySamples (options);
+    }
+}
+
+ConvolutionImpulseResponse::Options ImpulseResponsePlugin::getConvolutionOptions()
+{
+    ConvolutionImpulseResponse::Options options;
+    options.sampleRate = sampleRate;
+    options.normalise = normalise.get();
+    options.trimSilence = trimSilence.get();
+    options.zeroLatency = mode.get() != (int) Mode::lowCPU;
+    return options;
+}
+
 void ImpulseResponsePlugin::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& id)
 {
     if (v == state)
     {
         if (id == IDs::irFileData || id == IDs::normalise || id == IDs::trimSilence)
+        {
             loadImpulseResponseFromState();
+        }
+        else if (id == IDs::mode)
+        {
+            mode.forceUpdateOfCachedValue();
+            updateConvolver();
+            edit.restartPlayback(); // Rebuild the graph so the new latency is compensated for
+        }
     }
     else
     {
@@ -34,26 +34,35 @@ public:
 
     //==============================================================================
     /** Loads an impulse from binary audio file data i.e. not a block of raw floats.
-        @see juce::Convolution::loadImpulseResponse
+        The IR is shared with any other instances that load the same audio.
     */
     bool loadImpulseResponse (const void* sourceData, size_t sourceDataSize);
 
     /** Loads an impulse from a file.
-        @see juce::Convolution::loadImpulseResponse
+        The IR is shared with any other instances that load the same audio.
     */
     bool loadImpulseResponse (const juce::File& fileImpulseResponse);
 
     /** Loads an impulse from an AudioBuffer<float>.
-        @see juce::Convolution::loadImpulseResponse
+        The IR is shared with any other instances that load the same audio.
     */
     bool loadImpulseResponse (juce::AudioBuffer<float>&& bufferImpulseResponse,
                               double sampleRateToStore,
                               int bitDepthToStore);
 
+    //==============================================================================
+    /** The ways the IR can be convolved. */
+    enum class Mode
+    {
+        zeroLatency,    /**< The start of the IR is convolved on the audio thread so no latency is added. */
+        lowCPU          /**< All of the IR is convolved on background threads, which adds some latency. */
+    };
+
     //==============================================================================
     juce::CachedValue<juce::String> name;           /**< A name property. This isn't used by the IR itselt but useful in UI contexts. */
     juce::CachedValue<bool> normalise;              /**< Normalise the IR file when loading from the state. True by default. */
     juce::CachedValue<bool> trimSilence;            /**< Trim silence from the IR file when loading from the state. False by default. */
+    juce::CachedValue<int> mode;                    /**< The Mode to convolve with. Mode::zeroLatency by default. */
 
     AutomatableParameter::Ptr highPassCutoffParam;  /**< Cutoff frequency for the high pass filter to applied after the IR */
     AutomatableParameter::Ptr lowPassCutoffParam;   /**< Cutoff frequency for the low pass filter to applied after the IR */
@@ -73,6 +82,7 @@ public:
 
     /** @internal */
     double getLatencySeconds() override;
+    bool canSleepWhenSilent() override { return false; }
     /** @internal */
     void initialise (const PluginInitialisationInfo&) override;
     /** @internal */
@@ -83,12 +93,13 @@ public:
     void applyToBuffer (const PluginRenderContext&) override;
     /** @internal */
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
+    /** @internal */
+    size_t getAllocatedBytes() override;
 
 private:
     //==============================================================================
     enum
     {
-        convolutionIndex,
         HPFIndex,
         LPFIndex,
         gainIndex,
@@ -98,10 +109,10 @@ private:
     juce::CachedValue<float> highPassCutoffValue, lowPassCutoffValue;
     juce::CachedValue<float> qValue;
 
-    juce::dsp::ProcessorChain<juce::dsp::Convolution,
-                              juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
+    juce::dsp::ProcessorChain<juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
                               juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
                               juce::dsp::Gain<float>> processorChain;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
     juce::SmoothedValue<float> highFreqSmoother, lowFreqSmoother, gainSmoother, wetGainSmoother, dryGainSmoother, qSmoother;
 
     struct WetDryGain { float wet, dry; };
@@ -113,7 +124,17 @@ private:
 
         return { wet, dry };
     }
+    juce::AudioBuffer<float> impulseResponse;
+    double impulseResponseSampleRate = 0.0;
+    bool isPrepared = false;
+
+    juce::SpinLock convolverLock;
+    std::unique_ptr<PartitionedConvolver> convolver;
+    int latencySamples = 0;
+
+    ConvolutionImpulseResponse::Options getConvolutionOptions();
     void loadImpulseResponseFromState();
+    void updateConvolver();
 
     void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
 
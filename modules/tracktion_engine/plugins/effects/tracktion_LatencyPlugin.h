@@ -35,6 +35,7 @@ public:
     void applyToBuffer (const PluginRenderContext&) override;
 
     double getLatencySeconds() override                     { return latencyTimeSeconds.get(); }
+    bool canSleepWhenSilent() override                      { return false; }
 
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
 
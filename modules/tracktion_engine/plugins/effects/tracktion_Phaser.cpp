@@ -60,46 +60,62 @@ void PhaserPlugin::applyToBuffer (const PluginRenderContext& fc)
 
     clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
-    for (int chan = std::min (2, fc.destBuffer->getNumChannels()); --chan >= 0;)
+    const int numChans = std::min (2, fc.destBuffer->getNumChannels());
+
+    // Both channels share the same sweep, so the filter coefficients are calculated
+    // once for a chunk at a time and the channels' all-pass chains just read them
+    constexpr int chunkSize = 64;
+    double coefs[chunkSize];
+
+    for (int start = 0; start < fc.bufferNumSamples; start += chunkSize)
     {
-        float* b = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample);
-        swp = sweep;
+        const int numThisTime = std::min (chunkSize, fc.bufferNumSamples - start);
 
-        for (int i = fc.bufferNumSamples; --i >= 0;)
+        for (int i = 0; i < numThisTime; ++i)
         {
-            float inval = *b;
-            const double coef = (1.0 - swp) / (1.0 + swp);
-            double* const fv = filterVals[chan];
+            coefs[i] = (1.0 - swp) / (1.0 + swp);
+
+            swp *= swpFactor;
+
+            if (swp > maxSweep)       swpFactor = sweepDown;
+            else if (swp < minSweep)  swpFactor = sweepUp;
+        }
 
-            double t = inval + feedbackGain * fv[7];
+        for (int chan = 0; chan < numChans; ++chan)
+        {
+            float* b = fc.destBuffer->getWritePointer (chan, fc.bufferStartSample + start);
+            double* const fv = filterVals[chan];
 
-            JUCE_UNDENORMALISE (t);
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                float inval = b[i];
+                const double coef = coefs[i];
 
-            fv[1] = coef * (fv[1] + t) - fv[0];
-            JUCE_UNDENORMALISE (fv[1]);
-            fv[0] = t;
+                double t = inval + feedbackGain * fv[7];
 
-            fv[3] = coef * (fv[3] + fv[1]) - fv[2];
-            JUCE_UNDENORMALISE (fv[3]);
-            fv[2] = fv[1];
+                JUCE_UNDENORMALISE (t);
 
-            fv[5] = coef * (fv[5] + fv[3]) - fv[4];
-            JUCE_UNDENORMALISE (fv[5]);
-            fv[4] = fv[3];
+                fv[1] = coef * (fv[1] + t) - fv[0];
+                JUCE_UNDENORMALISE (fv[1]);
+                fv[0] = t;
 
-            fv[7] = coef * (fv[7] + fv[5]) - fv[6];
-            JUCE_UNDENORMALISE (fv[7]);
-            fv[6] = fv[5];
+                fv[3] = coef * (fv[3] + fv[1]) - fv[2];
+                JUCE_UNDENORMALISE (fv[3]);
+                fv[2] = fv[1];
 
-            inval += (float)fv[7];
-            JUCE_UNDENORMALISE (inval);
+                fv[5] = coef * (fv[5] + fv[3]) - fv[4];
+                JUCE_UNDENORMALISE (fv[5]);
+                fv[4] = fv[3];
 
-            *b++ = inval;
+                fv[7] = coef * (fv[7] + fv[5]) - fv[6];
+                JUCE_UNDENORMALISE (fv[7]);
+                fv[6] = fv[5];
 
-            swp *= swpFactor;
+                inval += (float) fv[7];
+                JUCE_UNDENORMALISE (inval);
 
-            if (swp > maxSweep)       swpFactor = sweepDown;
-            else if (swp < minSweep)  swpFactor = sweepUp;
+                b[i] = inval;
+            }
         }
     }
 
@@ -26,6 +26,7 @@ public:
     void initialise (const PluginInitialisationInfo&) override;
     void deinitialise() override;
     int getNumOutputChannelsGivenInputs (int numInputChannels) override  { return juce::jmin (numInputChannels, 2); }
+    bool canSleepWhenSilent() override                                   { return false; }
     void applyToBuffer (const PluginRenderContext&) override;
     juce::String getSelectableDescription() override;
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
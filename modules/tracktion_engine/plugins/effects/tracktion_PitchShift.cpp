@@ -19,8 +19,20 @@ struct PitchShiftPlugin::Pimpl
     {
     }
 
-    void initialise (double sr, float semitonesUp, TimeStretcher::Mode newMode, TimeStretcher::ElastiqueProOptions newOptions)
+    void initialise (double sr, int blockSize, float semitonesUp, TimeStretcher::Mode newMode,
+                     TimeStretcher::ElastiqueProOptions newOptions, bool shouldUseReadAhead)
     {
+        hostBlockSize = std::max (blockSize, 1);
+
+        if (shouldUseReadAhead)
+        {
+            initialiseReadAhead (sr, semitonesUp, newMode, newOptions);
+            return;
+        }
+
+        readAheadStretcher.reset();
+        usingReadAhead = false;
+
         if (timestretcher == nullptr || mode != newMode || elastiqueOptions != newOptions)
         {
             mode = newMode;
@@ -53,18 +65,63 @@ struct PitchShiftPlugin::Pimpl
         latencySeconds = latencySamples / sr;
     }
 
+    void initialiseReadAhead (double sr, float semitonesUp, TimeStretcher::Mode newMode, TimeStretcher::ElastiqueProOptions newOptions)
+    {
+        mode = newMode;
+        elastiqueOptions = newOptions;
+        usingReadAhead = true;
+
+        // A ReadAheadTimeStretcher can only be initialised once so a new one is needed each time
+        readAheadStretcher = std::make_unique<ReadAheadTimeStretcher> (numBlocksToReadAhead);
+        readAheadStretcher->initialise (sr, samplesPerBlock, 2, mode, elastiqueOptions, true);
+        jassert (mode == TimeStretcher::Mode::disabled || readAheadStretcher->isInitialised());
+
+        if (readAheadStretcher->isInitialised())
+        {
+            readAheadStretcher->setSpeedAndPitch (1.0f, semitonesUp);
+
+            // The latency is fixed so it doesn't depend on how quickly the workers get to this instance.
+            // It covers the frames the stretcher needs to produce a block plus a couple of blocks for the
+            // workers to process ahead of the audio thread
+            const auto blockSize = std::max (hostBlockSize, samplesPerBlock);
+            latencySamples = readAheadStretcher->getMaxFramesNeeded() + 2 * blockSize;
+
+            inputFifo.setSize (2, latencySamples + 2 * blockSize);
+            outputFifo.setSize (2, latencySamples + 2 * blockSize);
+        }
+
+        inputFifo.reset();
+        outputFifo.reset();
+
+        outputFifo.writeSilence (latencySamples);
+
+        latencySeconds = latencySamples / sr;
+    }
+
+    bool needsReinitialising() const
+    {
+        return (TimeStretcher::Mode) owner.mode.get() != mode
+            || owner.elastiqueOptions.get() != elastiqueOptions
+            || owner.useReadAhead.get() != usingReadAhead;
+    }
+
     void applyToBuffer (const PluginRenderContext& fc, float semis)
     {
         SCOPED_REALTIME_CHECK
 
-        if (timestretcher->isInitialised())
-        {
-            auto newMode = (TimeStretcher::Mode) owner.mode.get();
-            auto newOptions = owner.elastiqueOptions.get();
+        if (needsReinitialising())
+            initialise (owner.sampleRate, hostBlockSize, semis,
+                        (TimeStretcher::Mode) owner.mode.get(), owner.elastiqueOptions.get(),
+                        owner.useReadAhead.get());
 
-            if (newMode != mode || newOptions != elastiqueOptions)
-                initialise (owner.sampleRate, semis, newMode, newOptions);
+        if (usingReadAhead)
+        {
+            applyToBufferWithReadAhead (fc, semis);
+            return;
+        }
 
+        if (timestretcher->isInitialised())
+        {
             inputFifo.write (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
 
             if (! timestretcher->setSpeedAndPitch (1.0f, semis))
@@ -105,9 +162,69 @@ struct PitchShiftPlugin::Pimpl
         }
     }
 
+    void applyToBufferWithReadAhead (const PluginRenderContext& fc, float semis)
+    {
+        if (! readAheadStretcher->isInitialised())
+            return;
+
+        readAheadStretcher->setSpeedAndPitch (1.0f, semis);
+        inputFifo.write (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+
+        // Hand over as much input as the stretcher can take so the workers can process it
+        while (inputFifo.getNumReady() > 0 && readAheadStretcher->getFreeSpace() > 0)
+        {
+            const int numToPush = std::min ({ inputFifo.getNumReady(), readAheadStretcher->getFreeSpace(), samplesPerBlock });
+            AudioScratchBuffer scratch (2, numToPush);
+            inputFifo.read (scratch.buffer, 0, numToPush);
+            readAheadStretcher->pushData (scratch.buffer.getArrayOfReadPointers(), numToPush);
+        }
+
+        // Collect what the workers have already processed. One sample is left behind as popping
+        // everything that's ready would process the next block on this thread
+        auto popToOutputFifo = [this] (int numToPop)
+        {
+            while (numToPop > 0 && outputFifo.getFreeSpace() > 0)
+            {
+                const int numThisTime = std::min ({ numToPop, outputFifo.getFreeSpace(), samplesPerBlock });
+
+                // Popping more than is ready processes a block which needs enough input
+                if (numThisTime >= readAheadStretcher->getNumReady() && readAheadStretcher->requiresMoreFrames())
+                    break;
+
+                AudioScratchBuffer scratch (2, numThisTime);
+                const int numPopped = readAheadStretcher->popData (scratch.buffer.getArrayOfWritePointers(), numThisTime);
+
+                if (numPopped <= 0)
+                    break;
+
+                outputFifo.write (scratch.buffer, 0, numPopped);
+                numToPop -= numPopped;
+            }
+        };
+
+        popToOutputFifo (readAheadStretcher->getNumReady() - 1);
+
+        // If the workers haven't kept up, the rest has to be processed here
+        if (const int numShort = fc.bufferNumSamples - outputFifo.getNumReady(); numShort > 0)
+            popToOutputFifo (numShort);
+
+        const int numToRead = std::min (fc.bufferNumSamples, outputFifo.getNumReady());
+        outputFifo.read (*fc.destBuffer, fc.bufferStartSample, numToRead);
+
+        if (numToRead < fc.bufferNumSamples)
+            fc.destBuffer->clear (fc.bufferStartSample + numToRead, fc.bufferNumSamples - numToRead);
+
+        if (fc.bufferForMidiMessages != nullptr)
+            fc.bufferForMidiMessages->addToNoteNumbers (juce::roundToInt (semis));
+    }
+
     PitchShiftPlugin& owner;
 
     std::unique_ptr<TimeStretcher> timestretcher;
+    std::unique_ptr<ReadAheadTimeStretcher> readAheadStretcher;
+    static constexpr int numBlocksToReadAhead = 3;
+    bool usingReadAhead = false;
+    int hostBlockSize = samplesPerBlock;
     TimeStretcher::Mode mode = TimeStretcher::disabled;
     TimeStretcher::ElastiqueProOptions elastiqueOptions;
 
@@ -137,6 +254,7 @@ PitchShiftPlugin::PitchShiftPlugin (PluginCreationInfo info) : Plugin (info)
     semitonesValue.referTo (state, IDs::semitonesUp, um);
     mode.referTo (state, IDs::mode, um, (int) TimeStretcher::defaultMode);
     elastiqueOptions.referTo (state, IDs::elastiqueOptions, um);
+    useReadAhead.referTo (state, IDs::readAhead, um, false);
 
     semitones->attachToCurrentValue (semitonesValue);
 }
@@ -164,8 +282,8 @@ const char* PitchShiftPlugin::xmlTypeName = "pitchShifter";
 //==============================================================================
 void PitchShiftPlugin::initialise (const PluginInitialisationInfo& info)
 {
-    pimpl->initialise (info.sampleRate, semitones->getCurrentValue(),
-                       (TimeStretcher::Mode) mode.get(), elastiqueOptions.get());
+    pimpl->initialise (info.sampleRate, info.blockSizeSamples, semitones->getCurrentValue(),
+                       (TimeStretcher::Mode) mode.get(), elastiqueOptions.get(), useReadAhead.get());
 }
 
 void PitchShiftPlugin::deinitialise()
@@ -191,7 +309,7 @@ juce::String PitchShiftPlugin::getSelectableDescription()
 
 void PitchShiftPlugin::restorePluginStateFromValueTree (const juce::ValueTree& v)
 {
-    copyPropertiesToCachedValues (v, semitonesValue, mode);
+    copyPropertiesToCachedValues (v, semitonesValue, mode, useReadAhead);
 
     for (auto p : getAutomatableParameters())
         p->updateFromAttachedValue();
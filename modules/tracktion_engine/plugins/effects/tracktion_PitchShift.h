@@ -32,6 +32,7 @@ public:
     void deinitialise() override;
     double getLatencySeconds() override;
     int getNumOutputChannelsGivenInputs (int numInputChannels) override  { return juce::jmin (numInputChannels, 2); }
+    bool canSleepWhenSilent() override                                   { return false; }
     void applyToBuffer (const PluginRenderContext&) override;
     juce::String getSelectableDescription() override;
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
@@ -39,6 +40,12 @@ public:
     juce::CachedValue<float> semitonesValue;
     juce::CachedValue<int> mode;
     juce::CachedValue<TimeStretcher::ElastiqueProOptions> elastiqueOptions;
+
+    /** If true, the pitch shifting is done by a ReadAheadTimeStretcher so most of
+        the work happens on its background threads rather than the audio thread.
+        This adds a fixed amount of extra latency.
+    */
+    juce::CachedValue<bool> useReadAhead;
     AutomatableParameter::Ptr semitones;
 
     static float getMaximumSemitones()   { return 2.0f * 12.0f; }
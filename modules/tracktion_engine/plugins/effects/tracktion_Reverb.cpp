@@ -15,6 +15,197 @@ static constexpr float scalewet = 3;
 static constexpr float scaledry = 2;
 static constexpr float freezemode = 0.5f;
 
+//==============================================================================
+/**
+    An 8-line feedback delay network, mixed with a Hadamard matrix.
+
+    The lines are processed a sub-block at a time, no longer than the shortest
+    line, so each line's output for the sub-block can be read before any of it
+    is written. That way every stage runs over contiguous runs of samples rather
+    than stepping through all the lines for each sample.
+*/
+struct ReverbPlugin::FeedbackDelayNetwork
+{
+    FeedbackDelayNetwork (double sr)
+        : sampleRate (sr)
+    {
+        bufferSize = getLengthInSamples (numLines - 1, 1.0f) + maxSubBlockSize;
+
+        for (auto& line : lines)
+            line.assign ((size_t) bufferSize, 0.0f);
+
+        setParameters ({});
+    }
+
+    void reset()
+    {
+        for (auto& line : lines)
+            std::fill (line.begin(), line.end(), 0.0f);
+
+        std::fill (std::begin (dampingState), std::end (dampingState), 0.0f);
+        writePos = 0;
+    }
+
+    void setParameters (const juce::Reverb::Parameters& p)
+    {
+        if (memcmp (&p, &parameters, sizeof (p)) == 0)
+            return;
+
+        parameters = p;
+        const bool frozen = p.freezeMode >= freezemode;
+
+        // The decay time is set by the room size and each line's gain chosen so they all decay at the same rate
+        const float decaySeconds = 0.3f + 9.7f * p.roomSize * p.roomSize;
+
+        for (int i = 0; i < numLines; ++i)
+        {
+            lengths[i] = getLengthInSamples (i, p.roomSize);
+            feedback[i] = hadamardScale * (frozen ? 1.0f
+                                                  : std::pow (10.0f, -3.0f * (float) lengths[i] / (decaySeconds * (float) sampleRate)));
+        }
+
+        damping = frozen ? 0.0f : p.damping * 0.4f;
+        inputGain = frozen ? 0.0f : 0.2f;
+
+        const float wet = p.wetLevel * scalewet;
+        wet1 = 0.5f * wet * (1.0f + p.width);
+        wet2 = 0.5f * wet * (1.0f - p.width);
+        dry = p.dryLevel * scaledry;
+    }
+
+    /** Processes a block. If right is nullptr, the left channel is processed as mono. */
+    void process (float* left, float* right, int numSamples)
+    {
+        const int subBlockSize = std::min (maxSubBlockSize, *std::min_element (std::begin (lengths), std::end (lengths)));
+
+        for (int start = 0; start < numSamples; start += subBlockSize)
+            processSubBlock (left + start, right != nullptr ? right + start : nullptr,
+                             std::min (subBlockSize, numSamples - start));
+    }
+
+private:
+    static constexpr int numLines = 8;
+    static constexpr int maxSubBlockSize = 256;
+    static constexpr float hadamardScale = 0.35355339f; // 1 / sqrt (numLines)
+    static constexpr float outputGain = 0.5f;
+
+    const double sampleRate;
+    juce::Reverb::Parameters parameters { -1.0f };
+    std::vector<float> lines[numLines];
+    int bufferSize = 0, writePos = 0;
+    int lengths[numLines] = {};
+    float feedback[numLines] = {};
+    float dampingState[numLines] = {};
+    float damping = 0, inputGain = 0, wet1 = 0, wet2 = 0, dry = 0;
+
+    float mix[numLines][maxSubBlockSize];
+    float wetLeft[maxSubBlockSize], wetRight[maxSubBlockSize];
+
+    int getLengthInSamples (int line, float roomSize) const
+    {
+        // Mutually prime lengths so the echoes don't line up
+        static constexpr float lineLengthsMs[numLines] = { 23.1f, 29.3f, 33.7f, 39.1f, 44.9f, 51.3f, 57.7f, 63.9f };
+        return std::max (1, juce::roundToInt (lineLengthsMs[line] * (0.4f + 0.6f * roomSize) * sampleRate / 1000.0));
+    }
+
+    void processSubBlock (float* left, float* right, int num)
+    {
+        // Read each line's output for the sub-block and damp it
+        for (int i = 0; i < numLines; ++i)
+        {
+            auto line = lines[i].data();
+            auto dest = mix[i];
+
+            int readPos = writePos - lengths[i];
+
+            if (readPos < 0)
+                readPos += bufferSize;
+
+            const int firstRun = std::min (num, bufferSize - readPos);
+            std::copy_n (line + readPos, firstRun, dest);
+            std::copy_n (line, num - firstRun, dest + firstRun);
+
+            float state = dampingState[i];
+
+            for (int s = 0; s < num; ++s)
+            {
+                state = dest[s] + damping * (state - dest[s]);
+                dest[s] = state;
+            }
+
+            JUCE_SNAP_TO_ZERO (state);
+            dampingState[i] = state;
+        }
+
+        // The even lines make up the left output and the odd lines the right
+        std::fill_n (wetLeft, num, 0.0f);
+        std::fill_n (wetRight, num, 0.0f);
+
+        for (int i = 0; i < numLines; i += 2)
+        {
+            juce::FloatVectorOperations::add (wetLeft, mix[i], num);
+            juce::FloatVectorOperations::add (wetRight, mix[i + 1], num);
+        }
+
+        // Mix the lines with a fast Walsh-Hadamard transform, each butterfly running over the whole sub-block
+        for (int h = 1; h < numLines; h *= 2)
+        {
+            for (int i = 0; i < numLines; i += h * 2)
+            {
+                for (int j = i; j < i + h; ++j)
+                {
+                    auto a = mix[j];
+                    auto b = mix[j + h];
+
+                    for (int s = 0; s < num; ++s)
+                    {
+                        const float x = a[s], y = b[s];
+                        a[s] = x + y;
+                        b[s] = x - y;
+                    }
+                }
+            }
+        }
+
+        // Feed the mixed lines back with the input, the left going to the even lines and the right to the odd
+        const float* inputs[] = { left, right != nullptr ? right : left };
+
+        for (int i = 0; i < numLines; ++i)
+        {
+            auto row = mix[i];
+            auto input = inputs[i & 1];
+            const float gain = feedback[i];
+
+            for (int s = 0; s < num; ++s)
+                row[s] = row[s] * gain + input[s] * inputGain;
+
+            auto line = lines[i].data();
+            const int firstRun = std::min (num, bufferSize - writePos);
+            std::copy_n (row, firstRun, line + writePos);
+            std::copy_n (row + firstRun, num - firstRun, line);
+        }
+
+        writePos = (writePos + num) % bufferSize;
+
+        if (right != nullptr)
+        {
+            for (int s = 0; s < num; ++s)
+            {
+                const float l = wetLeft[s] * outputGain, r = wetRight[s] * outputGain;
+                left[s]  = l * wet1 + r * wet2 + left[s]  * dry;
+                right[s] = r * wet1 + l * wet2 + right[s] * dry;
+            }
+        }
+        else
+        {
+            for (int s = 0; s < num; ++s)
+                left[s] = (wetLeft[s] + wetRight[s]) * (0.5f * outputGain * wet1) + left[s] * dry;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (FeedbackDelayNetwork)
+};
+
 //==============================================================================
 ReverbPlugin::ReverbPlugin (PluginCreationInfo info) : Plugin (info)
 {
@@ -50,6 +241,7 @@ ReverbPlugin::ReverbPlugin (PluginCreationInfo info) : Plugin (info)
     dryValue.referTo (state, IDs::dry, um, 0.5f);
     widthValue.referTo (state, IDs::width, um, 1.0f);
     modeValue.referTo (state, IDs::mode, um);
+    algorithmValue.referTo (state, IDs::algorithm, um, (int) Algorithm::freeverb);
 
     roomSizeParam->attachToCurrentValue (roomSizeValue);
     dampParam->attachToCurrentValue (dampValue);
@@ -77,15 +269,20 @@ void ReverbPlugin::initialise (const PluginInitialisationInfo& info)
 {
     outputSilent = true;
     reverb.setSampleRate (info.sampleRate);
+    fdn = std::make_unique<FeedbackDelayNetwork> (info.sampleRate);
 }
 
 void ReverbPlugin::deinitialise()
 {
+    fdn.reset();
 }
 
 void ReverbPlugin::reset()
 {
     reverb.reset();
+
+    if (fdn != nullptr)
+        fdn->reset();
 }
 
 static bool isNotSilent (float v) noexcept
@@ -119,7 +316,18 @@ void ReverbPlugin::applyToBuffer (const PluginRenderContext& fc)
         params.width      = widthParam->getCurrentValue();
         params.freezeMode = modeParam->getCurrentValue();
 
-        if (memcmp (&params, &reverb.getParameters(), sizeof (params)) != 0)
+        const bool useFDN = fdn != nullptr && algorithmValue.get() == (int) Algorithm::feedbackDelayNetwork;
+
+        // Don't let the previous algorithm's tail come back if it's switched back to later
+        if (useFDN != usingFDN)
+        {
+            usingFDN = useFDN;
+            reset();
+        }
+
+        if (useFDN)
+            fdn->setParameters (params);
+        else if (memcmp (&params, &reverb.getParameters(), sizeof (params)) != 0)
             reverb.setParameters (params);
 
         const int num = fc.bufferNumSamples;
@@ -134,7 +342,10 @@ void ReverbPlugin::applyToBuffer (const PluginRenderContext& fc)
             if (outputSilent && isSilent (left, num) && isSilent (right, num))
                 return;
 
-            reverb.processStereo (left, right, num);
+            if (useFDN)
+                fdn->process (left, right, num);
+            else
+                reverb.processStereo (left, right, num);
 
             outputSilent = isSilent (left, num) && isSilent (right, num);
         }
@@ -143,7 +354,10 @@ void ReverbPlugin::applyToBuffer (const PluginRenderContext& fc)
             if (outputSilent && isSilent (left, num))
                 return;
 
-            reverb.processMono (left, num);
+            if (useFDN)
+                fdn->process (left, nullptr, num);
+            else
+                reverb.processMono (left, num);
 
             outputSilent = isSilent (left, num);
         }
@@ -154,7 +368,7 @@ void ReverbPlugin::applyToBuffer (const PluginRenderContext& fc)
 
 void ReverbPlugin::restorePluginStateFromValueTree (const juce::ValueTree& v)
 {
-    copyPropertiesToCachedValues (v, roomSizeValue, dampValue, wetValue, dryValue, widthValue, modeValue);
+    copyPropertiesToCachedValues (v, roomSizeValue, dampValue, wetValue, dryValue, widthValue, modeValue, algorithmValue);
 
     for (auto p : getAutomatableParameters())
         p->updateFromAttachedValue();
@@ -178,4 +392,7 @@ float ReverbPlugin::getWidth()                  { return widthParam->getCurrentV
 void ReverbPlugin::setMode (float value)        { modeParam->setParameter (juce::jlimit (0.0f, 1.0f, value), juce::sendNotification); }
 float ReverbPlugin::getMode()                   { return modeParam->getCurrentValue(); }
 
+void ReverbPlugin::setAlgorithm (Algorithm a)   { algorithmValue = (int) a; }
+ReverbPlugin::Algorithm ReverbPlugin::getAlgorithm() const  { return (Algorithm) algorithmValue.get(); }
+
 }} // namespace tracktion { inline namespace engine
@@ -28,6 +28,7 @@ public:
     void deinitialise() override;
     void reset() override;
     int getNumOutputChannelsGivenInputs (int numInputChannels) override { return juce::jmin (numInputChannels, 2); }
+    bool canSleepWhenSilent() override                                  { return false; }
     void applyToBuffer (const PluginRenderContext&) override;
     juce::String getSelectableDescription() override    { return TRANS("Reverb Plugin"); }
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
@@ -51,15 +52,31 @@ public:
     void setMode (float value);
     float getMode();
 
+    //==============================================================================
+    /** The reverb algorithms that can be used. */
+    enum class Algorithm
+    {
+        freeverb             = 0,   ///< The classic comb and all-pass reverb
+        feedbackDelayNetwork = 1    ///< A denser, cheaper 8-line feedback delay network
+    };
+
+    /** Sets the algorithm to use. The mode, room size and other parameters apply to both. */
+    void setAlgorithm (Algorithm);
+    Algorithm getAlgorithm() const;
+
     juce::CachedValue<float> roomSizeValue, dampValue, wetValue,
                              dryValue, widthValue, modeValue;
+    juce::CachedValue<int> algorithmValue;
 
     AutomatableParameter::Ptr roomSizeParam, dampParam, wetParam,
                               dryParam, widthParam, modeParam;
 
 private:
-    bool outputSilent = true;
+    struct FeedbackDelayNetwork;
+
+    bool outputSilent = true, usingFDN = false;
     juce::Reverb reverb;
+    std::unique_ptr<FeedbackDelayNetwork> fdn;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbPlugin)
 };
@@ -14,39 +14,57 @@ namespace tracktion { inline namespace engine
 // this must be high enough for low freq sounds not to click
 static constexpr int minimumSamplesToPlayWhenStopping = 8;
 static constexpr int maximumSimultaneousNotes = 32;
+static constexpr int maximumStreamedNotesPerSound = 8;
 
 
 struct SamplerPlugin::SampledNote   : public ReferenceCountedObject
 {
 public:
-    SampledNote (int midiNote, int keyNote,
+    SampledNote (SamplerSound& s,
+                 int midiNote,
                  float velocity,
-                 const AudioFile& file,
                  double sampleRate,
-                 int sampleDelayFromBufferStart,
-                 const juce::AudioBuffer<float>& data,
-                 int lengthInSamples,
-                 float gainDb,
-                 float pan,
-                 bool openEnded_)
-       : note (midiNote),
+                 int sampleDelayFromBufferStart)
+       : sound (s),
+         note (midiNote),
          offset (-sampleDelayFromBufferStart),
-         audioData (data),
-         openEnded (openEnded_)
+         audioData (s.audioData),
+         openEnded (s.openEnded)
     {
         resampler[0].reset();
         resampler[1].reset();
 
-        const float volumeSliderPos = decibelsToVolumeFaderPosition (gainDb - (20.0f * (1.0f - velocity)));
-        getGainsFromVolumeFaderPositionAndPan (volumeSliderPos, pan, getDefaultPanLaw(), gains[0], gains[1]);
+        const float volumeSliderPos = decibelsToVolumeFaderPosition (s.gainDb - (20.0f * (1.0f - velocity)));
+        getGainsFromVolumeFaderPositionAndPan (volumeSliderPos, s.pan, getDefaultPanLaw(), gains[0], gains[1]);
 
         const double hz = juce::MidiMessage::getMidiNoteInHertz (midiNote);
-        playbackRatio = hz / juce::MidiMessage::getMidiNoteInHertz (keyNote);
-        playbackRatio *= file.getSampleRate() / sampleRate;
+        playbackRatio = hz / juce::MidiMessage::getMidiNoteInHertz (s.keyNote);
+        playbackRatio *= s.audioFile.getSampleRate() / sampleRate;
+
+        auto lengthInSamples = s.fileLengthSamples;
+
+        if (s.streamed)
+        {
+            streamReader = s.takeStreamReader();
+
+            // Moving the reader to where streaming starts gets the cache reading
+            // that part of the file while the preloaded start is playing
+            if (streamReader != nullptr)
+                streamReader->setReadPosition (s.fileStartSample + s.numPreloadedSamples);
+            else
+                lengthInSamples = s.numPreloadedSamples;
+        }
+
         samplesLeftToPlay = playbackRatio > 0 ? (1 + (int) (lengthInSamples / playbackRatio)) : 0;
     }
 
-    void addNextBlock (juce::AudioBuffer<float>& outBuffer, int startSamp, int numSamples)
+    ~SampledNote() override
+    {
+        if (streamReader != nullptr)
+            sound.returnStreamReader (std::move (streamReader));
+    }
+
+    void addNextBlock (juce::AudioBuffer<float>& outBuffer, int startSamp, int numSamples, int readTimeoutMs)
     {
         jassert (! isFinished);
 
@@ -62,13 +80,27 @@ public:
 
         if (numSamps > 0)
         {
+            const int numSampsNeeded = 2 + juce::roundToInt ((numSamps + 2) * playbackRatio);
+            const juce::AudioBuffer<float>* source = audioData.get();
+            int sourceOffset = offset;
+            std::optional<AudioScratchBuffer> streamedSamples;
+
+            // Once the preloaded start runs out the samples are read into a scratch buffer
+            if (streamReader != nullptr && offset + numSampsNeeded > sound.numPreloadedSamples)
+            {
+                streamedSamples.emplace (audioData->getNumChannels(), numSampsNeeded);
+                readSourceSamples (streamedSamples->buffer, numSampsNeeded, readTimeoutMs);
+                source = &streamedSamples->buffer;
+                sourceOffset = 0;
+            }
+
             int numUsed = 0;
 
             for (int i = std::min (2, outBuffer.getNumChannels()); --i >= 0;)
             {
                 numUsed = resampler[i]
                             .processAdding (playbackRatio,
-                                            audioData.getReadPointer (std::min (i, audioData.getNumChannels() - 1), offset),
+                                            source->getReadPointer (std::min (i, source->getNumChannels() - 1), sourceOffset),
                                             outBuffer.getWritePointer (i, startSamp),
                                             numSamps,
                                             gains[i]);
@@ -77,7 +109,7 @@ public:
             offset += numUsed;
             samplesLeftToPlay -= numSamps;
 
-            jassert (offset <= audioData.getNumSamples());
+            jassert (streamReader != nullptr || offset <= audioData->getNumSamples());
         }
 
         if (numSamples > numSamps && startFade > 0.0f)
@@ -97,17 +129,12 @@ public:
             }
 
             const int numSampsNeeded = 2 + juce::roundToInt ((numSamps + 2) * playbackRatio);
-            AudioScratchBuffer scratch (audioData.getNumChannels(), numSampsNeeded + 8);
+            AudioScratchBuffer scratch (audioData->getNumChannels(), numSampsNeeded + 8);
 
-            if (offset + numSampsNeeded < audioData.getNumSamples())
-            {
-                for (int i = scratch.buffer.getNumChannels(); --i >= 0;)
-                    scratch.buffer.copyFrom (i, 0, audioData, i, offset, numSampsNeeded);
-            }
+            if (offset + numSampsNeeded < getSourceLength())
+                readSourceSamples (scratch.buffer, numSampsNeeded, readTimeoutMs);
             else
-            {
                 scratch.buffer.clear();
-            }
 
             if (numSampsNeeded > 2)
                 AudioFadeCurve::applyCrossfadeSection (scratch.buffer, 0, numSampsNeeded - 2,
@@ -130,17 +157,56 @@ public:
         }
     }
 
+    SamplerSound& sound;
     juce::LagrangeInterpolator resampler[2];
     int note;
     int offset, samplesLeftToPlay = 0;
     float gains[2];
     double playbackRatio = 1.0;
-    const juce::AudioBuffer<float>& audioData;
+    std::shared_ptr<const juce::AudioBuffer<float>> audioData;
+    AudioFileCache::Reader::Ptr streamReader;
     float lastVals[4] = { 0, 0, 0, 0 };
     float startFade = 1.0f;
     bool openEnded, isFinished = false;
 
 private:
+    int getSourceLength() const
+    {
+        return streamReader != nullptr ? sound.fileLengthSamples : audioData->getNumSamples();
+    }
+
+    /** Copies the sound from the current offset into a buffer, reading anything
+        past the preloaded start from the stream reader.
+    */
+    void readSourceSamples (juce::AudioBuffer<float>& dest, int numNeeded, int readTimeoutMs)
+    {
+        const int numInMemory = streamReader != nullptr ? sound.numPreloadedSamples : audioData->getNumSamples();
+        const int numFromMemory = juce::jlimit (0, numNeeded, numInMemory - offset);
+
+        if (numFromMemory > 0)
+            for (int i = dest.getNumChannels(); --i >= 0;)
+                dest.copyFrom (i, 0, *audioData, i, offset, numFromMemory);
+
+        if (numFromMemory >= numNeeded)
+            return;
+
+        if (streamReader == nullptr)
+        {
+            dest.clear (numFromMemory, numNeeded - numFromMemory);
+            return;
+        }
+
+        const auto destChannels = juce::AudioChannelSet::canonicalChannelSet (dest.getNumChannels());
+        streamReader->setReadPosition (sound.fileStartSample + offset + numFromMemory);
+
+        for (int pos = numFromMemory; pos < numNeeded;)
+        {
+            const int numThisTime = std::min (8192, numNeeded - pos);
+            streamReader->readSamples (numThisTime, dest, destChannels, pos, juce::AudioChannelSet::stereo(), readTimeoutMs);
+            pos += numThisTime;
+        }
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampledNote)
 };
 
@@ -252,21 +318,12 @@ void SamplerPlugin::playNotes (const juce::BigInteger& keysDown)
                 {
                     if (ss->minNote <= note
                          && ss->maxNote >= note
-                         && ss->audioData.getNumSamples() > 0
+                         && ss->audioData != nullptr
+                         && ss->audioData->getNumSamples() > 0
                          && (! ss->audioFile.isNull())
                          && playingNotes.size() < maximumSimultaneousNotes)
                     {
-                        playingNotes.add (new SampledNote (note,
-                                                           ss->keyNote,
-                                                           0.75f,
-                                                           ss->audioFile,
-                                                           sampleRate,
-                                                           0,
-                                                           ss->audioData,
-                                                           ss->fileLengthSamples,
-                                                           ss->gainDb,
-                                                           ss->pan,
-                                                           ss->openEnded));
+                        playingNotes.add (new SampledNote (*ss, note, 0.75f, sampleRate, 0));
                     }
                 }
             }
@@ -293,6 +350,8 @@ void SamplerPlugin::applyToBuffer (const PluginRenderContext& fc)
 
         clearChannels (*fc.destBuffer, 2, -1, fc.bufferStartSample, fc.bufferNumSamples);
 
+        const int readTimeoutMs = fc.isRendering ? 5000 : 0;
+
         if (fc.bufferForMidiMessages != nullptr)
         {
             if (fc.bufferForMidiMessages->isAllNotesOff)
@@ -323,22 +382,14 @@ void SamplerPlugin::applyToBuffer (const PluginRenderContext& fc)
                     {
                         if (ss->minNote <= note
                             && ss->maxNote >= note
-                            && ss->audioData.getNumSamples() > 0
+                            && ss->audioData != nullptr
+                            && ss->audioData->getNumSamples() > 0
                             && playingNotes.size() < maximumSimultaneousNotes)
                         {
                             highlightedNotes.setBit (note);
 
-                            playingNotes.add (new SampledNote (note,
-                                                               ss->keyNote,
-                                                               m.getVelocity() / 127.0f,
-                                                               ss->audioFile,
-                                                               sampleRate,
-                                                               noteTimeSample,
-                                                               ss->audioData,
-                                                               ss->fileLengthSamples,
-                                                               ss->gainDb,
-                                                               ss->pan,
-                                                               ss->openEnded));
+                            playingNotes.add (new SampledNote (*ss, note, m.getVelocity() / 127.0f,
+                                                               sampleRate, noteTimeSample));
                         }
                     }
                 }
@@ -371,7 +422,7 @@ void SamplerPlugin::applyToBuffer (const PluginRenderContext& fc)
         {
             auto sn = playingNotes.getUnchecked (i);
 
-            sn->addNextBlock (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+            sn->addNextBlock (*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples, readTimeoutMs);
 
             if (sn->isFinished)
                 playingNotes.remove (i);
@@ -396,6 +447,25 @@ void SamplerPlugin::setSoundName (int index, const juce::String& n)
     getSound (index).setProperty (IDs::name, n, getUndoManager());
 }
 
+size_t SamplerPlugin::getAllocatedBytes()
+{
+    const juce::ScopedLock sl (lock);
+    std::vector<const juce::AudioBuffer<float>*> buffers;
+    size_t numBytes = 0;
+
+    // Sounds using the same part of a file share their audio so it's only counted once
+    for (auto ss : soundList)
+    {
+        if (auto data = ss->audioData.get(); data != nullptr && std::find (buffers.begin(), buffers.end(), data) == buffers.end())
+        {
+            buffers.push_back (data);
+            numBytes += (size_t) data->getNumChannels() * (size_t) data->getNumSamples() * sizeof (float);
+        }
+    }
+
+    return numBytes;
+}
+
 bool SamplerPlugin::hasNameForMidiNoteNumber (int note, int, juce::String& noteName)
 {
     juce::String s;
@@ -470,6 +540,9 @@ juce::String SamplerPlugin::addSound (const juce::String& source, const juce::St
     if (getNumSounds() >= maxNumSamples)
         return TRANS("Can't load any more samples");
 
+    if (! edit.getMemoryBudget().canAllocate (0))
+        return TRANS("Not enough memory to load any more samples");
+
     auto v = createValueTree (IDs::SOUND,
                               IDs::source, source,
                               IDs::name, name,
@@ -591,6 +664,12 @@ void SamplerPlugin::sourceMediaChanged()
 {
     const juce::ScopedLock sl (lock);
 
+    // The files may have changed so their audio needs loading again
+    {
+        const juce::ScopedLock asl (audioDataLock);
+        loadedAudioData.clear();
+    }
+
     for (auto s : soundList)
         s->refreshFile();
 }
@@ -654,60 +733,133 @@ void SamplerPlugin::SamplerSound::setExcerpt (double startTime_, double length_)
         fileStartSample   = juce::roundToInt (startTime * audioFile.getSampleRate());
         fileLengthSamples = juce::roundToInt (length * audioFile.getSampleRate());
 
-        if (auto reader = owner.engine.getAudioFileManager().cache.createReader (audioFile))
-        {
-            audioData.setSize (audioFile.getNumChannels(), fileLengthSamples + 32);
-            audioData.clear();
+        const auto settings = owner.engine.getEngineBehaviour().getSamplerStreamingSettings();
+        streamed = settings.streamFromDisk && fileLengthSamples > settings.preloadSamples;
+        numPreloadedSamples = streamed ? std::max (0, settings.preloadSamples) : fileLengthSamples;
 
-            auto audioDataChannelSet = juce::AudioChannelSet::canonicalChannelSet (audioFile.getNumChannels());
-            auto channelsToUse = juce::AudioChannelSet::stereo();
+        audioData = owner.getAudioData (audioFile, fileStartSample, numPreloadedSamples);
+    }
+    else
+    {
+        audioFile = AudioFile (owner.edit.engine);
+        audioData.reset();
+        streamed = false;
+        numPreloadedSamples = 0;
+    }
 
-            int total = fileLengthSamples;
-            int offset = 0;
+    createStreamReaders();
+}
 
-            while (total > 0)
-            {
-                const int numThisTime = std::min (8192, total);
-                reader->setReadPosition (fileStartSample + offset);
+void SamplerPlugin::SamplerSound::refreshFile()
+{
+    audioFile = AudioFile (owner.edit.engine);
+    setExcerpt (startTime, length);
+}
 
-                if (! reader->readSamples (numThisTime, audioData, audioDataChannelSet, offset, channelsToUse, 2000))
-                {
-                    jassertfalse;
-                    break;
-                }
+AudioFileCache::Reader::Ptr SamplerPlugin::SamplerSound::takeStreamReader()
+{
+    if (freeStreamReaders.empty())
+        return {};
 
-                offset += numThisTime;
-                total -= numThisTime;
-            }
-        }
-        else
+    auto r = std::move (freeStreamReaders.back());
+    freeStreamReaders.pop_back();
+    return r;
+}
+
+void SamplerPlugin::SamplerSound::returnStreamReader (AudioFileCache::Reader::Ptr r)
+{
+    // Readers from before the sound was last refreshed are just released
+    if (streamReaders.contains (r.get()))
+    {
+        parkStreamReader (*r);
+        freeStreamReaders.push_back (std::move (r));
+    }
+}
+
+void SamplerPlugin::SamplerSound::createStreamReaders()
+{
+    streamReaders.clear();
+    freeStreamReaders.clear();
+
+    if (! streamed)
+        return;
+
+    freeStreamReaders.reserve ((size_t) maximumStreamedNotesPerSound);
+
+    for (int i = 0; i < maximumStreamedNotesPerSound; ++i)
+    {
+        if (auto r = owner.engine.getAudioFileManager().cache.createReader (audioFile))
         {
-            audioData.clear();
+            parkStreamReader (*r);
+            streamReaders.add (r);
+            freeStreamReaders.push_back (r);
         }
+    }
+}
 
-        // add a quick fade-in if needed..
-        int fadeLen = 0;
-        for (int i = audioData.getNumChannels(); --i >= 0;)
+void SamplerPlugin::SamplerSound::parkStreamReader (AudioFileCache::Reader& r)
+{
+    // Idle readers sit well before the start of the file so the cache doesn't read ahead
+    // for them, but they keep the point where streaming starts ready for the next note
+    r.setReadPosition (-(SampleCount) std::numeric_limits<int>::max());
+    r.setUpcomingReadPositions (fileStartSample + numPreloadedSamples);
+}
+
+//==============================================================================
+std::shared_ptr<const juce::AudioBuffer<float>> SamplerPlugin::getAudioData (const AudioFile& file, int fileStartSample, int numSamples)
+{
+    const juce::ScopedLock sl (audioDataLock);
+
+    for (auto i = loadedAudioData.begin(); i != loadedAudioData.end();)
+        i = i->second.expired() ? loadedAudioData.erase (i) : std::next (i);
+
+    auto& existing = loadedAudioData[std::make_tuple (file.getHash(), fileStartSample, numSamples)];
+
+    if (auto data = existing.lock())
+        return data;
+
+    auto data = std::make_shared<juce::AudioBuffer<float>> (file.getNumChannels(), numSamples + 32);
+    data->clear();
+
+    if (auto reader = engine.getAudioFileManager().cache.createReader (file))
+    {
+        auto audioDataChannelSet = juce::AudioChannelSet::canonicalChannelSet (file.getNumChannels());
+        auto channelsToUse = juce::AudioChannelSet::stereo();
+
+        int total = numSamples;
+        int offset = 0;
+
+        while (total > 0)
         {
-            const float* d = audioData.getReadPointer (i);
+            const int numThisTime = std::min (8192, total);
+            reader->setReadPosition (fileStartSample + offset);
 
-            if (std::abs (*d) > 0.01f)
-                fadeLen = 30;
-        }
+            if (! reader->readSamples (numThisTime, *data, audioDataChannelSet, offset, channelsToUse, 2000))
+            {
+                jassertfalse;
+                break;
+            }
 
-        if (fadeLen > 0)
-            AudioFadeCurve::applyCrossfadeSection (audioData, 0, fadeLen, AudioFadeCurve::concave, 0.0f, 1.0f);
+            offset += numThisTime;
+            total -= numThisTime;
+        }
     }
-    else
+
+    // add a quick fade-in if needed..
+    int fadeLen = 0;
+    for (int i = data->getNumChannels(); --i >= 0;)
     {
-        audioFile = AudioFile (owner.edit.engine);
+        const float* d = data->getReadPointer (i);
+
+        if (std::abs (*d) > 0.01f)
+            fadeLen = 30;
     }
-}
 
-void SamplerPlugin::SamplerSound::refreshFile()
-{
-    audioFile = AudioFile (owner.edit.engine);
-    setExcerpt (startTime, length);
+    if (fadeLen > 0)
+        AudioFadeCurve::applyCrossfadeSection (*data, 0, fadeLen, AudioFadeCurve::concave, 0.0f, 1.0f);
+
+    existing = data;
+    return data;
 }
 
 }} // namespace tracktion { inline namespace engine
@@ -72,6 +72,7 @@ public:
     void sourceMediaChanged() override;
 
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
+    size_t getAllocatedBytes() override;
 
     //==============================================================================
     struct SamplerSound
@@ -91,9 +92,31 @@ public:
         float gainDb = 0, pan = 0;
         double startTime = 0, length = 0;
         AudioFile audioFile;
-        juce::AudioBuffer<float> audioData { 2, 64 };
+
+        /** The audio for the sound, or just the start of it if it's streamed.
+            This is shared by all the sounds that use the same part of a file.
+        */
+        std::shared_ptr<const juce::AudioBuffer<float>> audioData;
+
+        /** True if only numPreloadedSamples are in audioData and the rest is read from disk as it plays. */
+        bool streamed = false;
+        int numPreloadedSamples = 0;
+
+        /** Returns a reader to stream the rest of the sound with, or nullptr if
+            they're all being used. This must be called with the plugin's lock held.
+        */
+        AudioFileCache::Reader::Ptr takeStreamReader();
+
+        /** Gives back a reader from takeStreamReader once a note has finished with it. */
+        void returnStreamReader (AudioFileCache::Reader::Ptr);
 
     private:
+        juce::ReferenceCountedArray<AudioFileCache::Reader> streamReaders;
+        std::vector<AudioFileCache::Reader::Ptr> freeStreamReaders;
+
+        void createStreamReaders();
+        void parkStreamReader (AudioFileCache::Reader&);
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerSound)
     };
 
@@ -109,6 +132,11 @@ private:
 
     juce::ValueTree getSound (int index) const;
 
+    juce::CriticalSection audioDataLock;
+    std::map<std::tuple<HashCode, int, int>, std::weak_ptr<const juce::AudioBuffer<float>>> loadedAudioData;
+
+    std::shared_ptr<const juce::AudioBuffer<float>> getAudioData (const AudioFile&, int fileStartSample, int numSamples);
+
     void valueTreeChanged() override;
     void handleAsyncUpdate() override;
 
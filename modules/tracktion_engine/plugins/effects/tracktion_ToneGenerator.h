@@ -25,6 +25,7 @@ public:
     juce::String getPluginType() override               { return xmlTypeName; }
     juce::String getShortName (int) override            { return getName(); }
     bool producesAudioWhenNoAudioInput() override       { return true; }
+    bool canSleepWhenSilent() override                  { return false; }
     bool isSynth() override                             { return true; }
 
     int getNumOutputChannelsGivenInputs (int numInputChannels) override { return juce::jmax (1, numInputChannels); }
@@ -73,6 +73,18 @@ public:
 
     void parameterChanged (float newValue, bool byAutomation) override
     {
+        // Automation is updated on the audio thread just before the plugin processes,
+        // so the changes are collected and delivered together when it does
+        if (byAutomation && ! juce::MessageManager::existsAndIsCurrentThread())
+        {
+            pendingValue.store (newValue, std::memory_order_relaxed);
+
+            if (! isPending.exchange (true, std::memory_order_acq_rel))
+                static_cast<ExternalPlugin&> (*plugin).addPendingParameterChange (*this);
+
+            return;
+        }
+
         if (auto p = getParam())
         {
             if (p->getValue() != newValue)
@@ -117,6 +129,17 @@ public:
         return {};
     }
 
+    /** Sends the last value set by automation on the audio thread to the plugin. */
+    void flushPendingValue()
+    {
+        isPending.store (false, std::memory_order_release);
+        auto newValue = pendingValue.load (std::memory_order_relaxed);
+
+        if (auto p = getParam())
+            if (p->getValue() != newValue)
+                p->setValue (newValue);
+    }
+
     void valueChangedByPlugin()
     {
         if (auto p = getParam())
@@ -267,6 +290,9 @@ private:
     const VSTXML::Param* param = nullptr;
     const VSTXML::ValueType* valueType = nullptr;
 
+    std::atomic<float> pendingValue { 0.0f };
+    std::atomic<bool> isPending { false };
+
     juce::AudioPluginInstance* getPlugin() const noexcept
     {
         jassert (plugin != nullptr);
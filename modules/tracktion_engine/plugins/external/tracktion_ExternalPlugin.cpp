@@ -41,6 +41,8 @@ public:
 
     void audioProcessorParameterChanged (juce::AudioProcessor*, int, float) override
     {
+        ++plugin.stateChangeCount;
+
         if (plugin.edit.isLoading())
             return;
 
@@ -50,6 +52,8 @@ public:
 
     void audioProcessorChanged (juce::AudioProcessor*, const ChangeDetails&) override
     {
+        ++plugin.stateChangeCount;
+
         if (plugin.edit.isLoading())
             return;
 
@@ -88,9 +92,15 @@ private:
                     plugin.latencySeconds = plugin.latencySamples / plugin.sampleRate;
                 }
 
-                plugin.edit.restartPlayback(); // Restart playback to rebuild audio graph for the new latency to take effect
+                // Try to compensate for the new latency in the playing graph, only rebuilding it if that's not possible
+                auto epc = plugin.isInstancePrepared ? plugin.edit.getCurrentPlaybackContext() : nullptr;
+
+                if (epc == nullptr || ! epc->updatePluginLatency (plugin))
+                {
+                    plugin.edit.restartPlayback(); // Restart playback to rebuild audio graph for the new latency to take effect
 
-                plugin.edit.getTransport().triggerClearDevicesOnStop(); // This will fully re-initialise plugins
+                    plugin.edit.getTransport().triggerClearDevicesOnStop(); // This will fully re-initialise plugins
+                }
             }
 
             pi->refreshParameterList();
@@ -660,7 +670,11 @@ ExternalPlugin::ExternalPlugin (PluginCreationInfo info)  : Plugin (info)
     desc.manufacturerName = state[IDs::manufacturer];
     identiferString = createIdentifierString (desc);
 
-    initialiseFully();
+    // Whilst the Edit's tracks are loading, the instance is created later along with the others
+    if (auto loader = edit.getExternalPluginBatchLoader())
+        loader->add (*this);
+    else
+        initialiseFully();
 }
 
 juce::ValueTree ExternalPlugin::create (Engine& e, const juce::PluginDescription& desc)
@@ -704,6 +718,27 @@ void ExternalPlugin::initialiseFully()
     }
 }
 
+void ExternalPlugin::initialiseFullyAsync()
+{
+    if (fullyInitialised)
+        return;
+
+    juce::MessageManager::callAsync ([ep = makeSafeRef (*this)]
+    {
+        if (! ep || ep->fullyInitialised)
+            return;
+
+        ep->initialiseFully();
+
+        // Instances that need an unblocked message thread restart playback once they've been created
+        if (ep->hasLoadedInstance)
+        {
+            ep->changed();
+            ep->edit.restartPlayback();
+        }
+    });
+}
+
 void ExternalPlugin::forceFullReinitialise()
 {
     TransportControl::ScopedPlaybackRestarter restarter (edit.getTransport());
@@ -732,6 +767,7 @@ void ExternalPlugin::updateDebugName()
 void ExternalPlugin::buildParameterList()
 {
     CRASH_TRACER_PLUGIN (getDebugName());
+    clearPendingParameterChanges();
     autoParamForParamNumbers.clear();
     clearParameterList();
     std::unordered_map<std::string, int> alreadyUsedParamNames;
@@ -792,10 +828,47 @@ void ExternalPlugin::buildParameterList()
         }
     }
 
+    {
+        // Each parameter can only be pending once so this is all the space the audio thread will need
+        const juce::ScopedLock sl (processMutex);
+        const std::scoped_lock psl (pendingParameterLock);
+        pendingParameterChanges.reserve ((size_t) autoParamForParamNumbers.size());
+        parameterChangesToFlush.reserve ((size_t) autoParamForParamNumbers.size());
+    }
+
     restoreChangedParametersFromState();
     buildParameterTree();
 }
 
+void ExternalPlugin::addPendingParameterChange (ExternalAutomatableParameter& param)
+{
+    const std::scoped_lock sl (pendingParameterLock);
+    jassert (pendingParameterChanges.size() < pendingParameterChanges.capacity());
+    pendingParameterChanges.push_back (&param);
+}
+
+void ExternalPlugin::flushPendingParameterChanges()
+{
+    // N.B. The processMutex is already locked by the calling function
+    {
+        const std::scoped_lock sl (pendingParameterLock);
+        std::swap (pendingParameterChanges, parameterChangesToFlush);
+    }
+
+    for (auto p : parameterChangesToFlush)
+        p->flushPendingValue();
+
+    parameterChangesToFlush.clear();
+}
+
+void ExternalPlugin::clearPendingParameterChanges()
+{
+    const juce::ScopedLock sl (processMutex);
+    const std::scoped_lock psl (pendingParameterLock);
+    pendingParameterChanges.clear();
+    parameterChangesToFlush.clear();
+}
+
 void ExternalPlugin::refreshParameterValues()
 {
     for (auto p : autoParamForParamNumbers)
@@ -915,6 +988,7 @@ void ExternalPlugin::processingChanged()
     }
     else
     {
+        clearPendingParameterChanges();
         clearParameterList();
         autoParamForParamNumbers.clear();
         getParameterTree().clear();
@@ -925,30 +999,38 @@ void ExternalPlugin::processingChanged()
 
 void ExternalPlugin::doFullInitialisation()
 {
-    if (auto foundDesc = findMatchingPlugin())
+    if (auto foundDesc = findDescriptionForInstanceCreation())
     {
-        desc = *foundDesc;
-        identiferString = createIdentifierString (desc);
-        updateDebugName();
+        CRASH_TRACER_PLUGIN (getDebugName());
 
-        if (processing && ! hasLoadedInstance
-            && engine.getEngineBehaviour().shouldLoadPlugin (*this))
+        callBlocking ([this, &foundDesc]
         {
-            if (isDisabled())
-                return;
-
             CRASH_TRACER_PLUGIN (getDebugName());
-            loadError = {};
-
-            callBlocking ([this, &foundDesc]
-            {
-                CRASH_TRACER_PLUGIN (getDebugName());
-                startPluginInstanceCreation (*foundDesc);
-            });
-        }
+            startPluginInstanceCreation (*foundDesc);
+        });
     }
 }
 
+std::unique_ptr<juce::PluginDescription> ExternalPlugin::findDescriptionForInstanceCreation()
+{
+    auto foundDesc = findMatchingPlugin();
+
+    if (! foundDesc)
+        return {};
+
+    desc = *foundDesc;
+    identiferString = createIdentifierString (desc);
+    updateDebugName();
+
+    if (! processing || hasLoadedInstance
+        || ! engine.getEngineBehaviour().shouldLoadPlugin (*this)
+        || isDisabled())
+       return {};
+
+    loadError = {};
+    return foundDesc;
+}
+
 void ExternalPlugin::trackPropertiesChanged()
 {
     juce::MessageManager::callAsync ([this, pluginRef = makeSafeRef (*this)]
@@ -989,6 +1071,48 @@ void ExternalPlugin::selectableAboutToBeDeleted()
 //==============================================================================
 void ExternalPlugin::flushPluginStateToValueTree()
 {
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    flushPluginStateToValueTree (captureState());
+}
+
+std::optional<ExternalPlugin::CapturedState> ExternalPlugin::captureState()
+{
+    const juce::ScopedLock sl (stateLock);
+    auto pi = getAudioPluginInstance();
+
+    if (pi == nullptr)
+        return std::nullopt;
+
+    CRASH_TRACER_PLUGIN (getDebugName());
+
+    // The count is read first so any change made whilst the state is read is caught next time
+    CapturedState captured;
+    captured.changeCount = stateChangeCount.load();
+
+    pi->suspendProcessing (true);
+    pi->getStateInformation (captured.chunk);
+    pi->suspendProcessing (false);
+
+    ContentHasher hasher;
+    hasher.add (captured.chunk.getData(), captured.chunk.getSize());
+    captured.hash = hasher.getHash();
+
+    return captured;
+}
+
+bool ExternalPlugin::hasStateChangedSinceCapture() const
+{
+    return stateChangeCount.load() != lastCapturedChangeCount;
+}
+
+bool ExternalPlugin::canCaptureStateOnBackgroundThread()
+{
+    return engine.getEngineBehaviour().canCapturePluginStateOnBackgroundThread (desc);
+}
+
+void ExternalPlugin::flushPluginStateToValueTree (const std::optional<CapturedState>& captured)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
     Plugin::flushPluginStateToValueTree();
 
     auto* um = getUndoManager();
@@ -1007,20 +1131,20 @@ void ExternalPlugin::flushPluginStateToValueTree()
         if (pi->getNumPrograms() > 0)
             state.setProperty (IDs::programNum,  pi->getCurrentProgram(), um);
 
-        TRACKTION_ASSERT_MESSAGE_THREAD
-        juce::MemoryBlock chunk;
-
-        pi->suspendProcessing (true);
-        pi->getStateInformation (chunk);
         saveChangedParametersToState();
-        pi->suspendProcessing (false);
-
         engine.getEngineBehaviour().saveCustomPluginProperties (state, *pi, um);
 
-        if (chunk.getSize() > 0)
-            state.setProperty (IDs::state, chunk.toBase64Encoding(), um);
-        else
-            state.removeProperty (IDs::state, um);
+        if (captured)
+        {
+            // Encoding and comparing a large chunk is slow so it's only done if the hash has changed
+            if (captured->chunk.getSize() == 0)
+                state.removeProperty (IDs::state, um);
+            else if (captured->hash != lastSavedStateHash || ! state.hasProperty (IDs::state))
+                state.setProperty (IDs::state, captured->chunk.toBase64Encoding(), um);
+
+            lastSavedStateHash = captured->hash;
+            lastCapturedChangeCount = captured->changeCount;
+        }
 
         flushBusesLayoutToValueTree();
     }
@@ -1077,8 +1201,18 @@ void ExternalPlugin::restorePluginStateFromValueTree (const juce::ValueTree& v)
         chunk.fromBase64Encoding (s);
 
         if (chunk.getSize() > 0)
-            callBlockingCatching ([&pi, &chunk] { pi->setStateInformation (chunk.getData(), (int) chunk.getSize()); });
+        {
+            callBlockingCatching ([this, &pi, &chunk]
+                                  {
+                                      const juce::ScopedLock sl (stateLock);
+                                      pi->setStateInformation (chunk.getData(), (int) chunk.getSize());
+                                  });
+        }
     }
+
+    // The ValueTree may no longer match the last state written so the next capture writes it again
+    lastSavedStateHash = 0;
+    lastCapturedChangeCount = ~0u;
 }
 
 void ExternalPlugin::getPluginStateFromTree (juce::MemoryBlock& mb)
@@ -1105,10 +1239,18 @@ void ExternalPlugin::updateFromMirroredPluginIfNeeded (Plugin& changedPlugin)
                 otherInstance && other->desc.isDuplicateOf (desc))
             {
                 juce::MemoryBlock chunk;
-                otherInstance->getStateInformation (chunk);
+
+                {
+                    const juce::ScopedLock sl (other->stateLock);
+                    otherInstance->getStateInformation (chunk);
+                }
 
                 if (chunk.getSize() > 0)
+                {
+                    const juce::ScopedLock sl (stateLock);
                     pi->setStateInformation (chunk.getData(), (int) chunk.getSize());
+                    ++stateChangeCount;
+                }
             }
         }
     }
@@ -1146,6 +1288,12 @@ void ExternalPlugin::initialise (const PluginInitialisationInfo& info)
         lastSampleRate = info.sampleRate;
         lastBlockSizeSamples = info.blockSizeSamples;
 
+        // The plugin is given the destination's channels where it has them so this only
+        // holds any extra ones, e.g. when a sidechain bus needs more than the track has
+        const auto numChannelsToProcess = std::max ({ 1, pi->getTotalNumInputChannels(), pi->getTotalNumOutputChannels() });
+        routedChannels.resize ((size_t) numChannelsToProcess);
+        extraChannels.setSize (numChannelsToProcess, info.blockSizeSamples);
+
         latencySamples = pi->getLatencySamples();
         latencySeconds = latencySamples / info.sampleRate;
 
@@ -1335,6 +1483,8 @@ void ExternalPlugin::applyToBuffer (const PluginRenderContext& fc)
     const juce::ScopedLock sl (processMutex);
     auto pi = getAudioPluginInstance();
 
+    flushPendingParameterChanges();
+
     if (playhead != nullptr)
         playhead->setCurrentContext (&fc);
 
@@ -1356,8 +1506,56 @@ void ExternalPlugin::applyToBuffer (const PluginRenderContext& fc)
         {
             processPluginBlock (*pi, fc, processedBypass);
         }
+        else if (numChansToProcess <= (int) routedChannels.size()
+                 && fc.bufferNumSamples <= extraChannels.getNumSamples())
+        {
+            // Point the plugin at the destination's channels rather than copying them,
+            // only using separate channels for any the destination doesn't have
+            for (int i = 0; i < numChansToProcess; ++i)
+            {
+                if (i < destNumChans)
+                {
+                    routedChannels[(size_t) i] = fc.destBuffer->getWritePointer (i, fc.bufferStartSample);
+                }
+                else
+                {
+                    routedChannels[(size_t) i] = extraChannels.getWritePointer (i);
+                    juce::FloatVectorOperations::clear (routedChannels[(size_t) i], fc.bufferNumSamples);
+                }
+            }
+
+            if (destNumChans == 1 && numInputChannels == 2)
+            {
+                // If we're getting a mono in and need stereo, dupe the channel..
+                juce::FloatVectorOperations::copy (routedChannels[1], routedChannels[0], fc.bufferNumSamples);
+            }
+            else if (destNumChans == 2 && numInputChannels == 1)
+            {
+                // If we're getting a stereo in and need mono, average the input..
+                juce::FloatVectorOperations::add (routedChannels[0], fc.destBuffer->getReadPointer (1, fc.bufferStartSample), fc.bufferNumSamples);
+                juce::FloatVectorOperations::multiply (routedChannels[0], 0.5f, fc.bufferNumSamples);
+            }
+
+            juce::AudioBuffer<float> routedBuffer (routedChannels.data(), numChansToProcess, fc.bufferNumSamples);
+
+            PluginRenderContext fc2 (fc);
+            fc2.destBuffer = &routedBuffer;
+            fc2.bufferStartSample = 0;
+
+            processPluginBlock (*pi, fc2, processedBypass);
+
+            // Clear the unprocessed channels
+            for (int i = numChansToProcess; i < destNumChans; ++i)
+            {
+                if (i < 2) // convert mono output to stereo for next plugin
+                    fc.destBuffer->copyFrom (i, fc.bufferStartSample, *fc.destBuffer, 0, fc.bufferStartSample, fc.bufferNumSamples);
+                else
+                    fc.destBuffer->clear (i, fc.bufferStartSample, fc.bufferNumSamples);
+            }
+        }
         else
         {
+            // The plugin's layout has changed since it was prepared so copy in to a scratch buffer
             AudioScratchBuffer asb (numChansToProcess, fc.bufferNumSamples);
             auto& buffer = asb.buffer;
 
@@ -1666,6 +1864,12 @@ void ExternalPlugin::setCurrentProgram (int index, bool sendChangeMessage)
     }
 }
 
+bool ExternalPlugin::canSleepWhenSilent()
+{
+    // Instruments can have host-synced internal sequencers so never sleep
+    return ! isSynth() && engine.getEngineBehaviour().canExternalPluginSleepWhenSilent (desc);
+}
+
 bool ExternalPlugin::takesMidiInput()
 {
     if (auto pi = getAudioPluginInstance())
@@ -1825,7 +2029,12 @@ void ExternalPlugin::completePluginInstanceCreation (std::unique_ptr<juce::Audio
     }
 
     newInstance->enableAllBuses();
-    loadedInstance = LoadedInstance::create (*this, std::move (newInstance));
+
+    {
+        const juce::ScopedLock sl (stateLock);
+        loadedInstance = LoadedInstance::create (*this, std::move (newInstance));
+    }
+
     hasLoadedInstance = true;
     isAsyncInitialising = false;
 
@@ -1855,9 +2064,17 @@ void ExternalPlugin::deletePluginInstance()
     isAsyncInitialising = false;
     loadError = {};
 
-    if (loadedInstance)
-        if (auto pi = loadedInstance->releaseInstance())
-            AsyncPluginDeleter::getInstance()->deletePlugin (std::move (pi));
+    std::unique_ptr<juce::AudioPluginInstance> pi;
+
+    {
+        const juce::ScopedLock sl (stateLock);
+
+        if (loadedInstance)
+            pi = loadedInstance->releaseInstance();
+    }
+
+    if (pi)
+        AsyncPluginDeleter::getInstance()->deletePlugin (std::move (pi));
 }
 
 //==============================================================================
@@ -2069,6 +2286,12 @@ std::unique_ptr<Plugin::EditorComponent> ExternalPlugin::createEditor()
 //==============================================================================
 bool ExternalPlugin::requiresAsyncInstantiation (Engine& e, const juce::PluginDescription& d)
 {
+    // Sandboxed plugins are loaded by the child process so nothing here needs the message
+    // thread to be running. Creating one does block until the child has loaded it though,
+    // so ExternalPluginBatchLoader creates them on its background threads
+    if (e.getEngineBehaviour().shouldHostPluginInSeparateProcess (d))
+        return false;
+
     for (auto format : e.getPluginManager().pluginFormatManager.getFormats())
     {
         if (format->getName() == d.pluginFormatName
@@ -2080,6 +2303,116 @@ bool ExternalPlugin::requiresAsyncInstantiation (Engine& e, const juce::PluginDe
     return false;
 }
 
+//==============================================================================
+void ExternalPluginBatchLoader::add (ExternalPlugin& plugin)
+{
+    plugins.push_back (makeSafeRef (plugin));
+}
+
+void ExternalPluginBatchLoader::initialiseAll (const std::function<void()>& pluginInitialised,
+                                               const std::function<bool (ExternalPlugin&)>& shouldDeferPlugin)
+{
+    CRASH_TRACER
+
+    struct PendingInstance
+    {
+        ExternalPlugin::Ptr plugin;
+        std::unique_ptr<juce::PluginDescription> description;
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        juce::String error;
+    };
+
+    std::vector<PendingInstance> backgroundThreadInstances, messageThreadInstances;
+
+    for (auto& p : std::exchange (plugins, {}))
+    {
+        if (p == nullptr || p->fullyInitialised
+            || (shouldDeferPlugin && shouldDeferPlugin (*p)))
+        {
+            pluginInitialised();
+            continue;
+        }
+
+        p->fullyInitialised = true;
+
+        CRASH_TRACER_PLUGIN (p->getDebugName());
+        auto description = p->findDescriptionForInstanceCreation();
+
+        if (! description)
+        {
+            pluginInitialised();
+            continue;
+        }
+
+        auto& behaviour = p->engine.getEngineBehaviour();
+        const bool canCreateOnBackgroundThread = ! ExternalPlugin::requiresAsyncInstantiation (p->engine, *description)
+                                                    && (behaviour.shouldHostPluginInSeparateProcess (*description)
+                                                         || behaviour.canCreatePluginInstanceOnBackgroundThread (*description));
+
+        (canCreateOnBackgroundThread ? backgroundThreadInstances : messageThreadInstances)
+            .push_back ({ p.get(), std::move (description), {}, {} });
+    }
+
+    // Create the instances that can be created on background threads concurrently...
+    std::atomic<size_t> nextInstanceToCreate { 0 };
+    std::vector<std::thread> threads;
+    const auto numThreads = std::min (backgroundThreadInstances.size(),
+                                      (size_t) std::max (1, juce::SystemStats::getNumCpus() - 1));
+
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back ([&backgroundThreadInstances, &nextInstanceToCreate]
+        {
+            for (;;)
+            {
+                const auto index = nextInstanceToCreate.fetch_add (1);
+
+                if (index >= backgroundThreadInstances.size())
+                    break;
+
+                auto& pending = backgroundThreadInstances[index];
+                auto& e = pending.plugin->engine;
+                auto& dm = e.getDeviceManager();
+                pending.instance = e.getPluginManager().createPluginInstance (*pending.description,
+                                                                             dm.getSampleRate(), dm.getBlockSize(),
+                                                                             pending.error);
+            }
+        });
+    }
+
+    // ...whilst the rest are started in a single batch on the message thread
+    if (! messageThreadInstances.empty())
+    {
+        callBlocking ([&messageThreadInstances, &pluginInitialised]
+        {
+            for (auto& pending : messageThreadInstances)
+            {
+                CRASH_TRACER_PLUGIN (pending.plugin->getDebugName());
+                pending.plugin->startPluginInstanceCreation (*pending.description);
+                pluginInitialised();
+            }
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    // Then restore the states of those created on background threads together
+    if (! backgroundThreadInstances.empty())
+    {
+        callBlocking ([&backgroundThreadInstances, &pluginInitialised]
+        {
+            for (auto& pending : backgroundThreadInstances)
+            {
+                CRASH_TRACER_PLUGIN (pending.plugin->getDebugName());
+                pending.plugin->loadError = pending.error;
+                pending.plugin->completePluginInstanceCreation (std::move (pending.instance));
+                pluginInitialised();
+            }
+        });
+    }
+}
+
 //==============================================================================
 PluginWetDryAutomatableParam::PluginWetDryAutomatableParam (const juce::String& xmlTag, const juce::String& name, Plugin& owner)
     : AutomatableParameter (xmlTag, name, owner, { 0.0f, 1.0f })
@@ -45,10 +45,54 @@ public:
     */
     bool isInitialisingAsync() const;
 
+    /** Returns true if the instance hasn't been created yet because it has been deferred
+        until the plugin is needed for playback.
+        @see Edit::Options::deferPluginsOnInactiveTracks, initialiseFullyAsync
+    */
+    bool isInitialisationDeferred() const           { return ! fullyInitialised; }
+
+    /** Fully initialises the plugin on the message thread if it hasn't been already,
+        restarting playback once the instance has been created.
+    */
+    void initialiseFullyAsync();
+
     static const char* xmlTypeName;
 
     void flushPluginStateToValueTree() override;
     void flushBusesLayoutToValueTree();
+
+    //==============================================================================
+    /** A copy of the plugin's state taken by captureState. */
+    struct CapturedState
+    {
+        juce::MemoryBlock chunk;
+        uint64_t hash = 0;          ///< A hash of the chunk, used to skip writing states that haven't changed
+        uint32_t changeCount = 0;   ///< The plugin's change count when the state was taken
+    };
+
+    /** Takes a copy of the plugin's state, returning nullopt if it has no instance.
+        If canCaptureStateOnBackgroundThread returns true this can be called on any
+        thread, otherwise it must be called on the message thread.
+        @see PluginStateCapture
+    */
+    std::optional<CapturedState> captureState();
+
+    /** Writes the plugin's properties and a state taken by captureState to the ValueTree.
+        The state is only written if it's different to the one last written. If nullopt
+        is passed, only the other properties are written.
+    */
+    void flushPluginStateToValueTree (const std::optional<CapturedState>&);
+
+    /** Returns true if the plugin has reported a parameter or state change since its
+        state was last written to the ValueTree.
+    */
+    bool hasStateChangedSinceCapture() const;
+
+    /** Returns true if captureState can be called on a background thread.
+        @see EngineBehaviour::canCapturePluginStateOnBackgroundThread
+    */
+    bool canCaptureStateOnBackgroundThread();
+
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
     void getPluginStateFromTree (juce::MemoryBlock&);
 
@@ -77,6 +121,7 @@ public:
     juce::String getTooltip() override      { return getName() + "$vstfilter"; }
     juce::String getPluginType() override   { return xmlTypeName; }
     bool isSynth() override                 { return desc.isInstrument; }
+    bool canSleepWhenSilent() override;
     bool takesMidiInput() override;
     bool takesAudioInput() override         { return (! isSynth()) || (dryGain->getCurrentValue() > 0.0f); }
     bool isMissing() override;
@@ -137,9 +182,18 @@ public:
 
 private:
     //==============================================================================
+    friend class ExternalPluginBatchLoader;
+    friend class ExternalAutomatableParameter;
+
     juce::CriticalSection processMutex;
     juce::String debugName, identiferString, loadError;
 
+    // Held whilst the instance's state is read or set, as captureState can be called on any thread
+    juce::CriticalSection stateLock;
+    std::atomic<uint32_t> stateChangeCount { 0 };
+    uint32_t lastCapturedChangeCount = ~0u;
+    uint64_t lastSavedStateHash = 0;
+
     class ProcessorChangedManager;
     class LoadedInstance;
     std::unique_ptr<LoadedInstance> loadedInstance;
@@ -153,6 +207,8 @@ private:
     int lastBlockSizeSamples = 0;
 
     juce::MidiBuffer midiBuffer;
+    std::vector<float*> routedChannels;
+    juce::AudioBuffer<float> extraChannels;
     MPESourceID midiSourceID = createUniqueMPESourceID();
     std::atomic<bool> midiPanicNeeded { false };
 
@@ -170,6 +226,13 @@ private:
 
     juce::Array<ExternalAutomatableParameter*> autoParamForParamNumbers;
 
+    RealTimeSpinLock pendingParameterLock;
+    std::vector<ExternalAutomatableParameter*> pendingParameterChanges, parameterChangesToFlush;
+
+    void addPendingParameterChange (ExternalAutomatableParameter&);
+    void flushPendingParameterChanges();
+    void clearPendingParameterChanges();
+
     //==============================================================================
     void startPluginInstanceCreation (const juce::PluginDescription&);
     void completePluginInstanceCreation (std::unique_ptr<juce::AudioPluginInstance>);
@@ -181,6 +244,7 @@ private:
 
     //==============================================================================
     void doFullInitialisation();
+    std::unique_ptr<juce::PluginDescription> findDescriptionForInstanceCreation();
     void buildParameterList();
     void refreshParameterValues();
     void updateDebugName();
@@ -197,6 +261,46 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ExternalPlugin)
 };
 
+//==============================================================================
+/**
+    Collects the ExternalPlugins created whilst an Edit's tracks are loading so
+    their instances can be created together afterwards, rather than one at a time
+    on the message thread as each track loads.
+
+    Plugins the EngineBehaviour allows to be created on background threads are
+    created concurrently, plugins that need an unblocked message thread start
+    creating asynchronously and the rest are created in a single batch on the
+    message thread. The states of the plugins created on background threads are
+    then restored together on the message thread.
+
+    @see EngineBehaviour::canCreatePluginInstanceOnBackgroundThread
+*/
+class ExternalPluginBatchLoader
+{
+public:
+    ExternalPluginBatchLoader() = default;
+
+    /** Adds a plugin to be initialised by initialiseAll. */
+    void add (ExternalPlugin&);
+
+    /** Returns the number of plugins that have been added. */
+    int getNumPlugins() const                   { return (int) plugins.size(); }
+
+    /** Initialises all the added plugins that haven't already been initialised.
+        @param pluginInitialised    Called (possibly on the message thread) each time a
+                                    plugin has been initialised or deferred
+        @param shouldDeferPlugin    If this returns true for a plugin, it's left as its
+                                    serialised state until something initialises it
+    */
+    void initialiseAll (const std::function<void()>& pluginInitialised,
+                        const std::function<bool (ExternalPlugin&)>& shouldDeferPlugin = {});
+
+private:
+    std::vector<SafeSelectable<ExternalPlugin>> plugins;
+
+    JUCE_DECLARE_NON_COPYABLE (ExternalPluginBatchLoader)
+};
+
 //==============================================================================
 /** specialised AutomatableParameter for wet/dry.
     Having a subclass just lets it label itself more nicely.
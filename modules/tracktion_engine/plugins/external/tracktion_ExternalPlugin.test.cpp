@@ -0,0 +1,273 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLUGINS
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+namespace external_plugin::test
+{
+    /** Scales each channel by a different gain so any that are mixed up or missed show up. */
+    class ChannelGainInstance  : public juce::AudioPluginInstance
+    {
+    public:
+        ChannelGainInstance (int numInputs, int numOutputs)
+            : juce::AudioPluginInstance (createBuses (numInputs, numOutputs))
+        {
+        }
+
+        static juce::PluginDescription getDescription()
+        {
+            juce::PluginDescription desc;
+            desc.name = "Channel Gain Test";
+            desc.pluginFormatName = "ChannelGainTest";
+            desc.fileOrIdentifier = "channel_gain_test";
+            desc.manufacturerName = "Tracktion";
+            desc.uniqueId = 0x43474e54;
+            desc.isInstrument = false;
+            return desc;
+        }
+
+        static float getGain (int channel)
+        {
+            return 0.25f * (float) (channel + 1);
+        }
+
+        void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override
+        {
+            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                buffer.applyGain (chan, 0, buffer.getNumSamples(), getGain (chan));
+        }
+
+        void fillInPluginDescription (juce::PluginDescription& desc) const override
+        {
+            desc = getDescription();
+            desc.numInputChannels = getTotalNumInputChannels();
+            desc.numOutputChannels = getTotalNumOutputChannels();
+        }
+
+        bool isBusesLayoutSupported (const BusesLayout&) const override     { return true; }
+        const juce::String getName() const override                         { return getDescription().name; }
+        void prepareToPlay (double, int) override                           {}
+        void releaseResources() override                                    {}
+        double getTailLengthSeconds() const override                        { return 0.0; }
+        bool acceptsMidi() const override                                   { return false; }
+        bool producesMidi() const override                                  { return false; }
+        juce::AudioProcessorEditor* createEditor() override                 { return nullptr; }
+        bool hasEditor() const override                                     { return false; }
+        int getNumPrograms() override                                       { return 1; }
+        int getCurrentProgram() override                                    { return 0; }
+        void setCurrentProgram (int) override                               {}
+        const juce::String getProgramName (int) override                    { return {}; }
+        void changeProgramName (int, const juce::String&) override          {}
+        void getStateInformation (juce::MemoryBlock&) override              {}
+        void setStateInformation (const void*, int) override                {}
+
+    private:
+        static BusesProperties createBuses (int numInputs, int numOutputs)
+        {
+            BusesProperties buses;
+
+            if (numInputs > 0)
+                buses = buses.withInput ("Input", juce::AudioChannelSet::canonicalChannelSet (numInputs));
+
+            return buses.withOutput ("Output", juce::AudioChannelSet::canonicalChannelSet (numOutputs));
+        }
+    };
+
+    /** Processes a buffer the way ExternalPlugin::applyToBuffer used to, by copying the
+        channels the plugin needs in to a scratch buffer and back again.
+    */
+    inline void processThroughScratchBuffer (juce::AudioBuffer<float>& dest, int startSample, int numSamples,
+                                             int numInputChannels, int numOutputChannels)
+    {
+        const auto destNumChans = dest.getNumChannels();
+        const auto numChansToProcess = std::max ({ 1, numInputChannels, numOutputChannels });
+
+        auto process = [] (juce::AudioBuffer<float>& buffer, int start, int num)
+        {
+            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                buffer.applyGain (chan, start, num, ChannelGainInstance::getGain (chan));
+        };
+
+        if (destNumChans == numChansToProcess)
+        {
+            process (dest, startSample, numSamples);
+            return;
+        }
+
+        juce::AudioBuffer<float> buffer (numChansToProcess, numSamples);
+
+        for (int i = 0; i < numChansToProcess; ++i)
+        {
+            if (i < destNumChans)
+                buffer.copyFrom (i, 0, dest, i, startSample, numSamples);
+            else
+                buffer.clear (i, 0, numSamples);
+        }
+
+        if (destNumChans == 1 && numInputChannels == 2)
+        {
+            buffer.copyFrom (1, 0, buffer, 0, 0, numSamples);
+        }
+        else if (destNumChans == 2 && numInputChannels == 1)
+        {
+            buffer.addFrom (0, 0, dest, 1, startSample, numSamples);
+            buffer.applyGain (0, 0, numSamples, 0.5f);
+        }
+
+        process (buffer, 0, numSamples);
+
+        for (int i = 0; i < destNumChans; ++i)
+        {
+            if (i < numChansToProcess)
+                dest.copyFrom (i, startSample, buffer, i, 0, numSamples);
+            else if (i < 2)
+                dest.copyFrom (i, startSample, buffer, 0, 0, numSamples);
+            else
+                dest.clear (i, startSample, numSamples);
+        }
+    }
+
+    inline juce::AudioBuffer<float> createInput (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (chan, i, (0.3f + 0.1f * (float) chan) * std::sin ((float) i * 0.1f + (float) chan));
+
+        return buffer;
+    }
+
+    inline float getMaxDifference (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        jassert (a.getNumChannels() == b.getNumChannels() && a.getNumSamples() == b.getNumSamples());
+        float maxDifference = 0.0f;
+
+        for (int chan = 0; chan < a.getNumChannels(); ++chan)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = std::max (maxDifference, std::abs (a.getSample (chan, i) - b.getSample (chan, i)));
+
+        return maxDifference;
+    }
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("ExternalPlugin channel mapping")
+    {
+        using namespace external_plugin::test;
+        auto& engine = *Engine::getEngines()[0];
+        auto& pm = engine.getPluginManager();
+        auto edit = engine::test_utilities::createTestEdit (engine);
+
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 128, startSample = 16, numSamples = 96;
+
+        const auto desc = ChannelGainInstance::getDescription();
+        pm.knownPluginList.addType (desc);
+
+        int numPluginInputs = 2, numPluginOutputs = 2;
+        auto oldCreatePluginInstance = pm.createPluginInstance;
+
+        pm.createPluginInstance = [&] (const juce::PluginDescription& d, double rate, int size, juce::String& error)
+                                    -> std::unique_ptr<juce::AudioPluginInstance>
+        {
+            if (d.pluginFormatName == desc.pluginFormatName)
+                return std::make_unique<ChannelGainInstance> (numPluginInputs, numPluginOutputs);
+
+            return oldCreatePluginInstance (d, rate, size, error);
+        };
+
+        auto createPlugin = [&] (int numInputs, int numOutputs)
+        {
+            numPluginInputs = numInputs;
+            numPluginOutputs = numOutputs;
+
+            auto plugin = edit->getPluginCache().createNewPlugin (ExternalPlugin::xmlTypeName, desc);
+            auto externalPlugin = dynamic_cast<ExternalPlugin*> (plugin.get());
+            REQUIRE (externalPlugin != nullptr);
+            externalPlugin->initialiseFully();
+            REQUIRE (externalPlugin->getAudioPluginInstance() != nullptr);
+
+            plugin->baseClassInitialise ({ 0_tp, sampleRate, blockSize });
+            return plugin;
+        };
+
+        // Processes part of a buffer with the plugin and checks it matches the old scratch buffer output
+        auto checkMatchesScratchBuffer = [&] (Plugin& plugin, int numDestChannels)
+        {
+            auto pi = dynamic_cast<ExternalPlugin&> (plugin).getAudioPluginInstance();
+            const auto numInputs = pi->getTotalNumInputChannels();
+            const auto numOutputs = pi->getTotalNumOutputChannels();
+
+            auto actual = createInput (numDestChannels, blockSize);
+            auto expected = actual;
+            processThroughScratchBuffer (expected, startSample, numSamples, numInputs, numOutputs);
+
+            PluginRenderContext rc (&actual, juce::AudioChannelSet::canonicalChannelSet (numDestChannels),
+                                    startSample, numSamples, nullptr, 0.0,
+                                    TimeRange (0_tp, TimeDuration::fromSamples (numSamples, sampleRate)),
+                                    true, false, false, false);
+            plugin.applyToBuffer (rc);
+
+            CHECK (getMaxDifference (actual, expected) < 1.0e-6f);
+        };
+
+        SUBCASE ("The destination's channels are used directly")
+        {
+            auto plugin = createPlugin (2, 2);
+            checkMatchesScratchBuffer (*plugin, 2);
+            checkMatchesScratchBuffer (*plugin, 4);
+        }
+
+        SUBCASE ("Extra plugin channels are cleared")
+        {
+            auto plugin = createPlugin (4, 4);
+            checkMatchesScratchBuffer (*plugin, 2);
+            checkMatchesScratchBuffer (*plugin, 1);
+        }
+
+        SUBCASE ("Mono input is duplicated for stereo plugins")
+        {
+            auto plugin = createPlugin (2, 2);
+            checkMatchesScratchBuffer (*plugin, 1);
+        }
+
+        SUBCASE ("Stereo input is averaged for mono plugins")
+        {
+            auto plugin = createPlugin (1, 1);
+            checkMatchesScratchBuffer (*plugin, 2);
+            checkMatchesScratchBuffer (*plugin, 3);
+        }
+
+        SUBCASE ("Layouts that grew after preparing use a scratch buffer")
+        {
+            auto plugin = createPlugin (2, 2);
+            auto pi = dynamic_cast<ExternalPlugin&> (*plugin).getAudioPluginInstance();
+            REQUIRE (pi->setChannelLayoutOfBus (false, 0, juce::AudioChannelSet::quadraphonic()));
+            REQUIRE (pi->getTotalNumOutputChannels() == 4);
+
+            checkMatchesScratchBuffer (*plugin, 2);
+            checkMatchesScratchBuffer (*plugin, 1);
+        }
+
+        pm.createPluginInstance = oldCreatePluginInstance;
+        pm.knownPluginList.removeType (desc);
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PLUGINS
@@ -0,0 +1,1110 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace sandbox
+{
+    static constexpr const char* commandLineUID = "PluginHost";
+
+    static constexpr int loadTimeoutMs = 30000;
+    static constexpr int messageTimeoutMs = 10000;
+    static constexpr int maxMidiBytes = 16384;
+    static constexpr uint32_t parameterQueueSize = 1024;
+
+    static juce::MemoryBlock createMessage (const juce::XmlElement& xml)
+    {
+        juce::MemoryOutputStream mo;
+        xml.writeTo (mo, juce::XmlElement::TextFormat().withoutHeader().singleLine());
+        return mo.getMemoryBlock();
+    }
+
+    static juce::String createUniqueName()
+    {
+        // Kept short as some platforms limit shared memory and semaphore names to 31 characters
+        return "tesb" + juce::String::toHexString (juce::Random::getSystemRandom().nextInt64());
+    }
+
+    //==============================================================================
+    /** A block of memory that can be mapped by more than one process. */
+    class SharedMemory
+    {
+    public:
+        SharedMemory (const juce::String& memoryName, size_t numBytes, bool create)
+            : name (memoryName), size (numBytes), isOwner (create)
+        {
+           #if JUCE_WINDOWS
+            auto fullName = "Local\\" + name;
+
+            handle = create ? CreateFileMappingW (INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                                  (DWORD) ((juce::uint64) size >> 32), (DWORD) size,
+                                                  fullName.toWideCharPointer())
+                            : OpenFileMappingW (FILE_MAP_ALL_ACCESS, FALSE, fullName.toWideCharPointer());
+
+            if (handle != nullptr)
+                data = MapViewOfFile (handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+           #elif JUCE_LINUX || JUCE_MAC || JUCE_BSD
+            auto fullName = "/" + name;
+            auto fd = create ? shm_open (fullName.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0600)
+                             : shm_open (fullName.toRawUTF8(), O_RDWR, 0600);
+
+            if (fd >= 0)
+            {
+                if (! create || ftruncate (fd, (off_t) size) == 0)
+                {
+                    auto p = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+                    if (p != MAP_FAILED)
+                        data = p;
+                }
+
+                close (fd);
+            }
+           #endif
+        }
+
+        ~SharedMemory()
+        {
+           #if JUCE_WINDOWS
+            if (data != nullptr)
+                UnmapViewOfFile (data);
+
+            if (handle != nullptr)
+                CloseHandle (handle);
+           #elif JUCE_LINUX || JUCE_MAC || JUCE_BSD
+            if (data != nullptr)
+                munmap (data, size);
+
+            if (isOwner)
+                shm_unlink (("/" + name).toRawUTF8());
+           #endif
+        }
+
+        void* getData() const noexcept     { return data; }
+
+    private:
+        const juce::String name;
+        const size_t size;
+        [[ maybe_unused ]] const bool isOwner;
+        void* data = nullptr;
+
+       #if JUCE_WINDOWS
+        HANDLE handle = nullptr;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (SharedMemory)
+    };
+
+    //==============================================================================
+    /** A counting semaphore that can be signalled by one process and waited on by another.
+        On Linux this is a futex on a word in the shared memory, elsewhere it's a named
+        OS semaphore.
+    */
+    class InterprocessSemaphore
+    {
+    public:
+        InterprocessSemaphore (const juce::String& semaphoreName, std::atomic<uint32_t>& futexWord, bool create)
+            : name (semaphoreName), word (futexWord), isOwner (create)
+        {
+           #if JUCE_WINDOWS
+            auto fullName = "Local\\" + name;
+            handle = create ? CreateSemaphoreW (nullptr, 0, LONG_MAX, fullName.toWideCharPointer())
+                            : OpenSemaphoreW (SEMAPHORE_ALL_ACCESS, FALSE, fullName.toWideCharPointer());
+           #elif JUCE_MAC || JUCE_BSD
+            auto fullName = "/" + name;
+            auto s = create ? sem_open (fullName.toRawUTF8(), O_CREAT | O_EXCL, 0600, 0)
+                            : sem_open (fullName.toRawUTF8(), 0);
+
+            if (s != SEM_FAILED)
+                semaphore = s;
+           #endif
+        }
+
+        ~InterprocessSemaphore()
+        {
+           #if JUCE_WINDOWS
+            if (handle != nullptr)
+                CloseHandle (handle);
+           #elif JUCE_MAC || JUCE_BSD
+            if (semaphore != nullptr)
+                sem_close (semaphore);
+
+            if (isOwner)
+                sem_unlink (("/" + name).toRawUTF8());
+           #endif
+        }
+
+        bool isValid() const noexcept
+        {
+           #if JUCE_WINDOWS
+            return handle != nullptr;
+           #elif JUCE_MAC || JUCE_BSD
+            return semaphore != nullptr;
+           #else
+            return true;
+           #endif
+        }
+
+        void signal() noexcept
+        {
+           #if JUCE_WINDOWS
+            ReleaseSemaphore (handle, 1, nullptr);
+           #elif JUCE_MAC || JUCE_BSD
+            sem_post (semaphore);
+           #elif JUCE_LINUX
+            word.fetch_add (1, std::memory_order_release);
+            syscall (SYS_futex, reinterpret_cast<uint32_t*> (&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+           #endif
+        }
+
+        /** Waits for the semaphore to be signalled, returning false if it times out.
+            A negative timeout waits forever.
+        */
+        bool wait (int timeoutMs) noexcept
+        {
+           #if JUCE_WINDOWS
+            return WaitForSingleObject (handle, timeoutMs < 0 ? INFINITE : (DWORD) timeoutMs) == WAIT_OBJECT_0;
+           #elif JUCE_MAC || JUCE_BSD
+            if (timeoutMs < 0)
+            {
+                while (sem_wait (semaphore) != 0)
+                    if (errno != EINTR)
+                        return false;
+
+                return true;
+            }
+
+            // There's no sem_timedwait on macOS so this polls, yielding at first
+            // to keep the wake-up latency low and then sleeping
+            auto start = juce::Time::getMillisecondCounterHiRes();
+
+            for (;;)
+            {
+                if (sem_trywait (semaphore) == 0)
+                    return true;
+
+                auto elapsed = juce::Time::getMillisecondCounterHiRes() - start;
+
+                if (elapsed >= timeoutMs)
+                    return false;
+
+                if (elapsed < 2.0)
+                    std::this_thread::yield();
+                else
+                    juce::Thread::sleep (1);
+            }
+           #elif JUCE_LINUX
+            auto deadline = juce::Time::getMillisecondCounterHiRes() + timeoutMs;
+
+            for (;;)
+            {
+                auto value = word.load (std::memory_order_acquire);
+
+                if (value > 0)
+                {
+                    if (word.compare_exchange_weak (value, value - 1, std::memory_order_acquire))
+                        return true;
+
+                    continue;
+                }
+
+                timespec timeout, * timeoutPtr = nullptr;
+
+                if (timeoutMs >= 0)
+                {
+                    auto remainingMs = deadline - juce::Time::getMillisecondCounterHiRes();
+
+                    if (remainingMs <= 0)
+                        return false;
+
+                    timeout.tv_sec = (time_t) (remainingMs / 1000.0);
+                    timeout.tv_nsec = (long) ((remainingMs - timeout.tv_sec * 1000.0) * 1000000.0);
+                    timeoutPtr = &timeout;
+                }
+
+                syscall (SYS_futex, reinterpret_cast<uint32_t*> (&word), FUTEX_WAIT, 0, timeoutPtr, nullptr, 0);
+            }
+           #else
+            juce::ignoreUnused (timeoutMs);
+            return false;
+           #endif
+        }
+
+    private:
+        const juce::String name;
+        [[ maybe_unused ]] std::atomic<uint32_t>& word;
+        [[ maybe_unused ]] const bool isOwner;
+
+       #if JUCE_WINDOWS
+        HANDLE handle = nullptr;
+       #elif JUCE_MAC || JUCE_BSD
+        sem_t* semaphore = nullptr;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (InterprocessSemaphore)
+    };
+
+    //==============================================================================
+    struct ParameterChange
+    {
+        int32_t index;
+        float value;
+    };
+
+    /** A lock-free single-producer, single-consumer queue that lives in shared memory. */
+    struct ParameterQueue
+    {
+        std::atomic<uint32_t> writePos { 0 }, readPos { 0 };
+        ParameterChange changes[parameterQueueSize];
+
+        bool push (ParameterChange change) noexcept
+        {
+            auto pos = writePos.load (std::memory_order_relaxed);
+
+            if (pos - readPos.load (std::memory_order_acquire) >= parameterQueueSize)
+                return false;
+
+            changes[pos % parameterQueueSize] = change;
+            writePos.store (pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool pop (ParameterChange& change) noexcept
+        {
+            auto pos = readPos.load (std::memory_order_relaxed);
+
+            if (pos == writePos.load (std::memory_order_acquire))
+                return false;
+
+            change = changes[pos % parameterQueueSize];
+            readPos.store (pos + 1, std::memory_order_release);
+            return true;
+        }
+    };
+
+    static_assert (std::atomic<uint32_t>::is_always_lock_free, "Shared memory atomics must be lock-free");
+
+    //==============================================================================
+    /** The header at the start of the shared memory. The audio channels follow it.
+        Everything other than the atomics is only touched by one side at a time,
+        with the semaphores handing it over.
+    */
+    struct SharedState
+    {
+        static constexpr uint32_t magicNumber = 0x54455342;
+
+        SharedState (int channels, int blockSize)
+            : numChannels (channels), maxBlockSize (blockSize)
+        {
+        }
+
+        static size_t getHeaderSize() noexcept
+        {
+            return (sizeof (SharedState) + 63) & ~(size_t) 63;
+        }
+
+        static size_t getSizeNeeded (int numChannels, int maxBlockSize) noexcept
+        {
+            return getHeaderSize() + sizeof (float) * (size_t) numChannels * (size_t) maxBlockSize;
+        }
+
+        float* getChannel (int channel) noexcept
+        {
+            return reinterpret_cast<float*> (reinterpret_cast<char*> (this) + getHeaderSize()) + channel * maxBlockSize;
+        }
+
+        const uint32_t magic = magicNumber;
+        const int32_t numChannels, maxBlockSize;
+        std::atomic<uint32_t> requestWord { 0 }, replyWord { 0 };
+
+        int32_t numSamples = 0, numMidiBytesIn = 0, numMidiBytesOut = 0;
+        ParameterQueue toChild, fromChild;
+        uint8_t midiIn[maxMidiBytes], midiOut[maxMidiBytes];
+    };
+
+    //==============================================================================
+    static int writeMidi (const juce::MidiBuffer& midi, uint8_t* dest) noexcept
+    {
+        int pos = 0;
+
+        for (auto m : midi)
+        {
+            auto time = (int32_t) m.samplePosition;
+            auto size = (uint16_t) m.numBytes;
+
+            if (pos + (int) (sizeof (time) + sizeof (size)) + m.numBytes > maxMidiBytes)
+                break;
+
+            std::memcpy (dest + pos, &time, sizeof (time));      pos += (int) sizeof (time);
+            std::memcpy (dest + pos, &size, sizeof (size));      pos += (int) sizeof (size);
+            std::memcpy (dest + pos, m.data, (size_t) size);     pos += size;
+        }
+
+        return pos;
+    }
+
+    static void readMidi (const uint8_t* src, int numBytes, juce::MidiBuffer& midi) noexcept
+    {
+        midi.clear();
+        numBytes = std::min (numBytes, maxMidiBytes);
+
+        for (int pos = 0; pos + (int) (sizeof (int32_t) + sizeof (uint16_t)) <= numBytes;)
+        {
+            int32_t time;
+            uint16_t size;
+            std::memcpy (&time, src + pos, sizeof (time));      pos += (int) sizeof (time);
+            std::memcpy (&size, src + pos, sizeof (size));      pos += (int) sizeof (size);
+
+            if (pos + size > numBytes)
+                break;
+
+            midi.addEvent (src + pos, size, time);
+            pos += size;
+        }
+    }
+
+    //==============================================================================
+    /** The host's side of the handshake for one block. The audio and MIDI are copied in to
+        the shared state, the child is woken and this waits for up to timeoutMs for it to reply.
+        If the child hasn't replied to an earlier block it may still be using the shared
+        buffers, so the block is dropped without waking it.
+        @returns false if the block was dropped, in which case the buffers are cleared
+    */
+    static bool exchangeBlock (SharedState& state, InterprocessSemaphore& request, InterprocessSemaphore& reply,
+                               bool& awaitingReply, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi,
+                               int timeoutMs) noexcept
+    {
+        const auto numSamples = buffer.getNumSamples();
+
+        auto dropBlock = [&]
+        {
+            buffer.clear();
+            midi.clear();
+            return false;
+        };
+
+        if (numSamples > state.maxBlockSize)
+            return dropBlock();
+
+        if (awaitingReply)
+        {
+            if (! reply.wait (0))
+                return dropBlock();
+
+            awaitingReply = false;
+        }
+
+        const auto numChannels = std::min (buffer.getNumChannels(), (int) state.numChannels);
+
+        for (int i = 0; i < state.numChannels; ++i)
+        {
+            if (i < numChannels)
+                juce::FloatVectorOperations::copy (state.getChannel (i), buffer.getReadPointer (i), numSamples);
+            else
+                juce::FloatVectorOperations::clear (state.getChannel (i), numSamples);
+        }
+
+        state.numSamples = numSamples;
+        state.numMidiBytesIn = writeMidi (midi, state.midiIn);
+
+        awaitingReply = true;
+        request.signal();
+
+        if (! reply.wait (timeoutMs))
+            return dropBlock();
+
+        awaitingReply = false;
+
+        for (int i = 0; i < numChannels; ++i)
+            buffer.copyFrom (i, 0, state.getChannel (i), numSamples);
+
+        for (int i = numChannels; i < buffer.getNumChannels(); ++i)
+            buffer.clear (i, 0, numSamples);
+
+        readMidi (state.midiOut, state.numMidiBytesOut, midi);
+        return true;
+    }
+
+    /** The child's side of a block. This applies the parameter changes from the host,
+        processes the shared audio and MIDI in place and queues the values of any
+        parameters the plugin has changed. The channels vector must already have room
+        for all the shared channels.
+    */
+    static void processSharedBlock (SharedState& state, juce::AudioProcessor& processor,
+                                    std::vector<float*>& channels, juce::MidiBuffer& midi,
+                                    std::atomic<bool>* changedParameters) noexcept
+    {
+        auto& params = processor.getParameters();
+        ParameterChange change;
+
+        // Using setValue rather than setValueNotifyingHost means these don't get echoed back
+        while (state.toChild.pop (change))
+            if (juce::isPositiveAndBelow (change.index, params.size()))
+                params.getUnchecked (change.index)->setValue (change.value);
+
+        readMidi (state.midiIn, state.numMidiBytesIn, midi);
+        jassert (channels.size() >= (size_t) state.numChannels);
+
+        for (int i = 0; i < state.numChannels; ++i)
+            channels[(size_t) i] = state.getChannel (i);
+
+        juce::AudioBuffer<float> buffer (channels.data(), state.numChannels,
+                                         juce::jlimit (0, (int) state.maxBlockSize, (int) state.numSamples));
+        processor.processBlock (buffer, midi);
+
+        state.numMidiBytesOut = writeMidi (midi, state.midiOut);
+
+        for (int i = 0; i < params.size(); ++i)
+            if (changedParameters[(size_t) i].exchange (false, std::memory_order_acquire))
+                if (! state.fromChild.push ({ i, params.getUnchecked (i)->getValue() }))
+                    changedParameters[(size_t) i] = true;
+    }
+
+    static void addParameterValues (juce::XmlElement& xml, juce::AudioProcessor& processor)
+    {
+        for (auto p : processor.getParameters())
+        {
+            auto e = xml.createNewChildElement ("VALUE");
+            e->setAttribute ("index", p->getParameterIndex());
+            e->setAttribute ("value", p->getValue());
+        }
+    }
+}
+
+//==============================================================================
+struct SandboxedPluginInstance::Connection
+{
+    Connection (const juce::String& connectionName, int numChannels, int maxBlockSize, bool create)
+        : name (connectionName),
+          memory (name, sandbox::SharedState::getSizeNeeded (numChannels, maxBlockSize), create)
+    {
+        if (memory.getData() == nullptr)
+            return;
+
+        auto s = create ? new (memory.getData()) sandbox::SharedState (numChannels, maxBlockSize)
+                        : static_cast<sandbox::SharedState*> (memory.getData());
+
+        if (s->magic != sandbox::SharedState::magicNumber
+             || s->numChannels != numChannels || s->maxBlockSize != maxBlockSize)
+            return;
+
+        requestSemaphore = std::make_unique<sandbox::InterprocessSemaphore> (name + "_rq", s->requestWord, create);
+        replySemaphore   = std::make_unique<sandbox::InterprocessSemaphore> (name + "_rp", s->replyWord, create);
+
+        if (requestSemaphore->isValid() && replySemaphore->isValid())
+            state = s;
+    }
+
+    bool isValid() const noexcept       { return state != nullptr; }
+
+    const juce::String name;
+    sandbox::SharedMemory memory;
+    sandbox::SharedState* state = nullptr;
+    std::unique_ptr<sandbox::InterprocessSemaphore> requestSemaphore, replySemaphore;
+
+    JUCE_DECLARE_NON_COPYABLE (Connection)
+};
+
+//==============================================================================
+struct SandboxedPluginInstance::HostProcess  : private juce::ChildProcessCoordinator
+{
+    HostProcess() = default;
+
+    ~HostProcess() override
+    {
+        killWorkerProcess();
+    }
+
+    bool launch()
+    {
+        // don't get stdout or strerr from the child process. We don't do anything with it and it fills up the pipe and hangs
+        return launchWorkerProcess (juce::File::getSpecialLocation (juce::File::currentExecutableFile),
+                                    sandbox::commandLineUID, 0, 0);
+    }
+
+    std::unique_ptr<juce::XmlElement> sendAndWait (juce::XmlElement& message, int timeoutMs)
+    {
+        auto requestID = ++lastRequestID;
+        message.setAttribute ("id", requestID);
+
+        if (crashed || ! sendMessageToWorker (sandbox::createMessage (message)))
+            return {};
+
+        auto end = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+
+        while (! crashed)
+        {
+            if (auto reply = findReply (requestID))
+                return reply;
+
+            if (juce::Time::getMillisecondCounter() >= end)
+            {
+                TRACKTION_LOG_ERROR ("Timed out waiting for sandboxed plugin: " + message.getTagName());
+                break;
+            }
+
+            replyArrived.wait (10);
+        }
+
+        return {};
+    }
+
+    std::atomic<bool> crashed { false };
+
+private:
+    juce::OwnedArray<juce::XmlElement> replies;
+    juce::CriticalSection replyLock;
+    juce::WaitableEvent replyArrived;
+    std::atomic<int> lastRequestID { 0 };
+
+    std::unique_ptr<juce::XmlElement> findReply (int requestID)
+    {
+        const juce::ScopedLock sl (replyLock);
+
+        for (int i = replies.size(); --i >= 0;)
+            if (replies.getUnchecked (i)->getIntAttribute ("id") == requestID)
+                return std::unique_ptr<juce::XmlElement> (replies.removeAndReturn (i));
+
+        return {};
+    }
+
+    void handleMessageFromWorker (const juce::MemoryBlock& mb) override
+    {
+        if (auto xml = juce::parseXML (mb.toString()))
+        {
+            const juce::ScopedLock sl (replyLock);
+            replies.add (xml.release());
+        }
+
+        replyArrived.signal();
+    }
+
+    void handleConnectionLost() override
+    {
+        TRACKTION_LOG_ERROR ("Sandboxed plugin process has died");
+        crashed = true;
+        replyArrived.signal();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (HostProcess)
+};
+
+//==============================================================================
+struct SandboxedPluginInstance::ChildProcess  : public juce::ChildProcessWorker,
+                                                private juce::AsyncUpdater,
+                                                private juce::Thread,
+                                                private juce::AudioProcessorParameter::Listener
+{
+    ChildProcess()
+        : juce::Thread ("Sandboxed Plugin")
+    {
+        pluginFormatManager.addDefaultFormats();
+    }
+
+    ~ChildProcess() override
+    {
+        cancelPendingUpdate();
+        stopProcessing();
+
+        if (plugin != nullptr)
+            for (auto p : plugin->getParameters())
+                p->removeListener (this);
+    }
+
+    void handleConnectionMade() override {}
+
+    void handleConnectionLost() override
+    {
+        std::exit (0);
+    }
+
+private:
+    juce::AudioPluginFormatManager pluginFormatManager;
+    std::unique_ptr<juce::AudioPluginInstance> plugin;
+    std::unique_ptr<Connection> connection;
+    std::unique_ptr<std::atomic<bool>[]> changedParameters;
+    std::vector<float*> channels;
+    juce::MidiBuffer midi;
+    juce::OwnedArray<juce::XmlElement, juce::CriticalSection> pendingMessages;
+
+    void sendReply (juce::XmlElement& reply, const juce::XmlElement& request)
+    {
+        reply.setAttribute ("id", request.getIntAttribute ("id"));
+        sendMessageToCoordinator (sandbox::createMessage (reply));
+    }
+
+    void handleMessage (const juce::XmlElement& m)
+    {
+        if (m.hasTagName ("LOAD"))          load (m);
+        else if (m.hasTagName ("PREPARE"))  prepare (m);
+        else if (m.hasTagName ("RELEASE"))  release (m);
+        else if (m.hasTagName ("GETSTATE")) getState (m);
+        else if (m.hasTagName ("SETSTATE")) setState (m);
+    }
+
+    void load (const juce::XmlElement& m)
+    {
+        juce::PluginDescription desc;
+        auto descXml = m.getChildElement (0);
+
+        if (plugin != nullptr || descXml == nullptr || ! desc.loadFromXml (*descXml))
+        {
+            juce::XmlElement reply ("LOADED");
+            reply.setAttribute ("error", "Invalid plugin description");
+            sendReply (reply, m);
+            return;
+        }
+
+        // This has to be async as some formats need the message thread to be running whilst they load
+        pluginFormatManager.createPluginInstanceAsync (desc, m.getDoubleAttribute ("rate"), m.getIntAttribute ("blockSize"),
+                                                       [this, request = juce::XmlElement (m)]
+                                                       (std::unique_ptr<juce::AudioPluginInstance> instance, const juce::String& error)
+                                                       {
+                                                           loaded (std::move (instance), error, request);
+                                                       });
+    }
+
+    void loaded (std::unique_ptr<juce::AudioPluginInstance> instance, const juce::String& error, const juce::XmlElement& request)
+    {
+        juce::XmlElement reply ("LOADED");
+
+        if (instance == nullptr)
+        {
+            reply.setAttribute ("error", error.isNotEmpty() ? error : juce::String ("Failed to load plugin"));
+            sendReply (reply, request);
+            return;
+        }
+
+        plugin = std::move (instance);
+        plugin->enableAllBuses();
+
+        reply.setAttribute ("numIns", plugin->getTotalNumInputChannels());
+        reply.setAttribute ("numOuts", plugin->getTotalNumOutputChannels());
+        reply.setAttribute ("acceptsMidi", plugin->acceptsMidi());
+        reply.setAttribute ("producesMidi", plugin->producesMidi());
+        reply.setAttribute ("tail", plugin->getTailLengthSeconds());
+
+        auto& params = plugin->getParameters();
+        changedParameters = std::make_unique<std::atomic<bool>[]> ((size_t) params.size());
+
+        for (auto p : params)
+        {
+            auto e = reply.createNewChildElement ("PARAM");
+            auto hosted = dynamic_cast<juce::HostedAudioProcessorParameter*> (p);
+            e->setAttribute ("id", hosted != nullptr ? hosted->getParameterID() : juce::String (p->getParameterIndex()));
+            e->setAttribute ("name", p->getName (1024));
+            e->setAttribute ("label", p->getLabel());
+            e->setAttribute ("default", p->getDefaultValue());
+            e->setAttribute ("value", p->getValue());
+            e->setAttribute ("numSteps", p->getNumSteps());
+            e->setAttribute ("discrete", p->isDiscrete());
+            e->setAttribute ("boolean", p->isBoolean());
+
+            p->addListener (this);
+        }
+
+        sendReply (reply, request);
+    }
+
+    void prepare (const juce::XmlElement& m)
+    {
+        stopProcessing();
+        connection.reset();
+
+        juce::XmlElement reply ("PREPARED");
+
+        if (plugin != nullptr)
+        {
+            auto c = std::make_unique<Connection> (m.getStringAttribute ("name"),
+                                                   m.getIntAttribute ("numChannels"),
+                                                   m.getIntAttribute ("blockSize"), false);
+
+            if (c->isValid())
+            {
+                connection = std::move (c);
+                channels.resize ((size_t) connection->state->numChannels);
+                midi.ensureSize (sandbox::maxMidiBytes);
+
+                plugin->setRateAndBufferSizeDetails (m.getDoubleAttribute ("rate"), m.getIntAttribute ("blockSize"));
+                plugin->prepareToPlay (m.getDoubleAttribute ("rate"), m.getIntAttribute ("blockSize"));
+                reply.setAttribute ("latency", plugin->getLatencySamples());
+
+                startThread (juce::Thread::Priority::highest);
+            }
+        }
+
+        if (connection == nullptr)
+            reply.setAttribute ("error", "Couldn't open shared memory");
+
+        sendReply (reply, m);
+    }
+
+    void release (const juce::XmlElement& m)
+    {
+        if (connection != nullptr)
+        {
+            stopProcessing();
+            plugin->releaseResources();
+            connection.reset();
+        }
+
+        juce::XmlElement reply ("RELEASED");
+        sendReply (reply, m);
+    }
+
+    void getState (const juce::XmlElement& m)
+    {
+        juce::MemoryBlock mb;
+
+        if (plugin != nullptr)
+            plugin->getStateInformation (mb);
+
+        juce::XmlElement reply ("STATE");
+        reply.setAttribute ("data", mb.toBase64Encoding());
+        sendReply (reply, m);
+    }
+
+    void setState (const juce::XmlElement& m)
+    {
+        juce::XmlElement reply ("STATESET");
+
+        if (plugin != nullptr)
+        {
+            juce::MemoryBlock mb;
+
+            if (mb.fromBase64Encoding (m.getStringAttribute ("data")))
+                plugin->setStateInformation (mb.getData(), (int) mb.getSize());
+
+            sandbox::addParameterValues (reply, *plugin);
+        }
+
+        sendReply (reply, m);
+    }
+
+    //==============================================================================
+    void stopProcessing()
+    {
+        signalThreadShouldExit();
+
+        if (connection != nullptr)
+            connection->requestSemaphore->signal();
+
+        stopThread (-1);
+    }
+
+    void run() override
+    {
+        auto& state = *connection->state;
+
+        for (;;)
+        {
+            connection->requestSemaphore->wait (-1);
+
+            if (threadShouldExit())
+                return;
+
+            sandbox::processSharedBlock (state, *plugin, channels, midi, changedParameters.get());
+            connection->replySemaphore->signal();
+        }
+    }
+
+    void parameterValueChanged (int parameterIndex, float) override
+    {
+        if (juce::isPositiveAndBelow (parameterIndex, plugin->getParameters().size()))
+            changedParameters[(size_t) parameterIndex].store (true, std::memory_order_release);
+    }
+
+    void parameterGestureChanged (int, bool) override {}
+
+    //==============================================================================
+    void handleMessageFromCoordinator (const juce::MemoryBlock& mb) override
+    {
+        if (auto xml = juce::parseXML (mb.toString()))
+        {
+            pendingMessages.add (xml.release());
+            triggerAsyncUpdate();
+        }
+    }
+
+    void handleAsyncUpdate() override
+    {
+        while (pendingMessages.size() > 0)
+            if (auto xml = std::unique_ptr<juce::XmlElement> (pendingMessages.removeAndReturn (0)))
+                handleMessage (*xml);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ChildProcess)
+};
+
+//==============================================================================
+class SandboxedPluginInstance::Parameter  : public juce::HostedAudioProcessorParameter
+{
+public:
+    Parameter (const juce::XmlElement& xml)
+        : paramID (xml.getStringAttribute ("id")),
+          name (xml.getStringAttribute ("name")),
+          label (xml.getStringAttribute ("label")),
+          defaultValue ((float) xml.getDoubleAttribute ("default")),
+          numSteps (xml.getIntAttribute ("numSteps", juce::AudioProcessor::getDefaultNumParameterSteps())),
+          discrete (xml.getBoolAttribute ("discrete")),
+          boolean (xml.getBoolAttribute ("boolean")),
+          value ((float) xml.getDoubleAttribute ("value", defaultValue))
+    {
+    }
+
+    juce::String getParameterID() const override               { return paramID; }
+    float getValue() const override                             { return value; }
+    float getDefaultValue() const override                      { return defaultValue; }
+    juce::String getName (int maximumStringLength) const override { return name.substring (0, maximumStringLength); }
+    juce::String getLabel() const override                      { return label; }
+    int getNumSteps() const override                            { return numSteps; }
+    bool isDiscrete() const override                            { return discrete; }
+    bool isBoolean() const override                             { return boolean; }
+    float getValueForText (const juce::String& text) const override { return text.getFloatValue(); }
+
+    void setValue (float newValue) override
+    {
+        value = newValue;
+        needsSending.store (true, std::memory_order_release);
+    }
+
+    /** Sets the value when it's been changed by the plugin, without sending it back. */
+    void setValueFromChild (float newValue)
+    {
+        value = newValue;
+        sendValueChangedMessageToListeners (newValue);
+    }
+
+    std::atomic<bool> needsSending { false };
+
+private:
+    const juce::String paramID, name, label;
+    const float defaultValue;
+    const int numSteps;
+    const bool discrete, boolean;
+    std::atomic<float> value;
+
+    JUCE_DECLARE_NON_COPYABLE (Parameter)
+};
+
+//==============================================================================
+static juce::AudioProcessor::BusesProperties createSandboxedBuses (const juce::XmlElement& loadReply)
+{
+    juce::AudioProcessor::BusesProperties buses;
+
+    if (auto numIns = loadReply.getIntAttribute ("numIns"); numIns > 0)
+        buses = buses.withInput ("Input", juce::AudioChannelSet::canonicalChannelSet (numIns), true);
+
+    if (auto numOuts = loadReply.getIntAttribute ("numOuts"); numOuts > 0)
+        buses = buses.withOutput ("Output", juce::AudioChannelSet::canonicalChannelSet (numOuts), true);
+
+    return buses;
+}
+
+std::unique_ptr<SandboxedPluginInstance> SandboxedPluginInstance::create (const juce::PluginDescription& desc,
+                                                                          double sampleRate, int blockSize,
+                                                                          juce::String& errorMessage)
+{
+    CRASH_TRACER
+    auto process = std::make_unique<HostProcess>();
+
+    if (! process->launch())
+    {
+        errorMessage = TRANS("Couldn't launch the plugin host process");
+        return {};
+    }
+
+    juce::XmlElement m ("LOAD");
+    m.setAttribute ("rate", sampleRate);
+    m.setAttribute ("blockSize", blockSize);
+    m.addChildElement (desc.createXml().release());
+
+    auto reply = process->sendAndWait (m, sandbox::loadTimeoutMs);
+
+    if (reply == nullptr)
+    {
+        errorMessage = process->crashed ? TRANS("The plugin crashed whilst loading")
+                                        : TRANS("The plugin host process didn't respond");
+        return {};
+    }
+
+    if (reply->hasAttribute ("error"))
+    {
+        errorMessage = reply->getStringAttribute ("error");
+        return {};
+    }
+
+    return std::unique_ptr<SandboxedPluginInstance> (new SandboxedPluginInstance (desc, std::move (process), *reply));
+}
+
+bool SandboxedPluginInstance::startChildProcess (const juce::String& commandLine)
+{
+    auto childProcess = std::make_unique<ChildProcess>();
+
+    if (childProcess->initialiseFromCommandLine (commandLine, sandbox::commandLineUID))
+    {
+        childProcess.release(); // this will handle its own deletion.
+        return true;
+    }
+
+    return false;
+}
+
+SandboxedPluginInstance::SandboxedPluginInstance (const juce::PluginDescription& desc,
+                                                  std::unique_ptr<HostProcess> hostProcess,
+                                                  const juce::XmlElement& loadReply)
+    : juce::AudioPluginInstance (createSandboxedBuses (loadReply)),
+      description (desc),
+      process (std::move (hostProcess)),
+      tailLengthSeconds (loadReply.getDoubleAttribute ("tail")),
+      plugAcceptsMidi (loadReply.getBoolAttribute ("acceptsMidi")),
+      plugProducesMidi (loadReply.getBoolAttribute ("producesMidi"))
+{
+    for (auto e : loadReply.getChildWithTagNameIterator ("PARAM"))
+    {
+        auto p = new Parameter (*e);
+        addHostedParameter (std::unique_ptr<Parameter> (p));
+        sandboxedParameters.add (p);
+    }
+}
+
+SandboxedPluginInstance::~SandboxedPluginInstance()
+{
+    releaseResources();
+    process.reset();
+}
+
+bool SandboxedPluginInstance::hasCrashed() const
+{
+    return process->crashed;
+}
+
+void SandboxedPluginInstance::fillInPluginDescription (juce::PluginDescription& d) const
+{
+    d = description;
+}
+
+const juce::String SandboxedPluginInstance::getName() const
+{
+    return description.name;
+}
+
+void SandboxedPluginInstance::prepareToPlay (double sampleRate, int blockSize)
+{
+    CRASH_TRACER
+    releaseResources();
+    setRateAndBufferSizeDetails (sampleRate, blockSize);
+
+    auto numChannels = std::max ({ 1, getTotalNumInputChannels(), getTotalNumOutputChannels() });
+    auto c = std::make_unique<Connection> (sandbox::createUniqueName(), numChannels, blockSize, true);
+
+    if (! c->isValid())
+    {
+        TRACKTION_LOG_ERROR ("Couldn't create shared memory for sandboxed plugin");
+        return;
+    }
+
+    juce::XmlElement m ("PREPARE");
+    m.setAttribute ("name", c->name);
+    m.setAttribute ("rate", sampleRate);
+    m.setAttribute ("blockSize", blockSize);
+    m.setAttribute ("numChannels", numChannels);
+
+    if (auto reply = process->sendAndWait (m, sandbox::messageTimeoutMs))
+    {
+        if (! reply->hasAttribute ("error"))
+        {
+            connection = std::move (c);
+            setLatencySamples (reply->getIntAttribute ("latency"));
+        }
+    }
+}
+
+void SandboxedPluginInstance::releaseResources()
+{
+    if (connection == nullptr)
+        return;
+
+    juce::XmlElement m ("RELEASE");
+    process->sendAndWait (m, sandbox::messageTimeoutMs);
+    connection.reset();
+    awaitingReply = false;
+}
+
+void SandboxedPluginInstance::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    if (connection == nullptr || process->crashed)
+    {
+        buffer.clear();
+        midi.clear();
+        return;
+    }
+
+    // The parameter queues are lock-free so these are safe even if the child is still busy
+    sendParameterChanges();
+
+    auto timeoutMs = std::max (1, (int) std::ceil (1000.0 * buffer.getNumSamples() / getSampleRate()));
+
+    if (! sandbox::exchangeBlock (*connection->state, *connection->requestSemaphore, *connection->replySemaphore,
+                                  awaitingReply, buffer, midi, timeoutMs))
+        ++numDroppedBlocks;
+
+    readParameterChanges();
+}
+
+void SandboxedPluginInstance::sendParameterChanges() noexcept
+{
+    auto& queue = connection->state->toChild;
+
+    for (int i = 0; i < sandboxedParameters.size(); ++i)
+    {
+        auto p = sandboxedParameters.getUnchecked (i);
+
+        if (p->needsSending.exchange (false, std::memory_order_acquire))
+            if (! queue.push ({ i, p->getValue() }))
+                p->needsSending = true;
+    }
+}
+
+void SandboxedPluginInstance::readParameterChanges() noexcept
+{
+    sandbox::ParameterChange change;
+
+    while (connection->state->fromChild.pop (change))
+        if (auto p = sandboxedParameters[change.index])
+            p->setValueFromChild (change.value);
+}
+
+void SandboxedPluginInstance::updateParameterValues (const juce::XmlElement& xml)
+{
+    for (auto e : xml.getChildWithTagNameIterator ("VALUE"))
+        if (auto p = sandboxedParameters[e->getIntAttribute ("index")])
+            p->setValueFromChild ((float) e->getDoubleAttribute ("value"));
+}
+
+void SandboxedPluginInstance::getStateInformation (juce::MemoryBlock& mb)
+{
+    juce::XmlElement m ("GETSTATE");
+
+    if (auto reply = process->sendAndWait (m, sandbox::messageTimeoutMs))
+        mb.fromBase64Encoding (reply->getStringAttribute ("data"));
+}
+
+void SandboxedPluginInstance::setStateInformation (const void* data, int size)
+{
+    juce::XmlElement m ("SETSTATE");
+    m.setAttribute ("data", juce::MemoryBlock (data, (size_t) size).toBase64Encoding());
+
+    if (auto reply = process->sendAndWait (m, sandbox::messageTimeoutMs))
+        updateParameterValues (*reply);
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,131 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An AudioPluginInstance that hosts a plugin in a child process, so if the
+    plugin crashes or hangs it doesn't take the engine down with it.
+
+    The child process is the app's own executable, launched with a special
+    command line. For this to work the app must call
+    PluginManager::startChildProcessPluginHost from its start-up code, in the
+    same way as it does for PluginManager::startChildProcessPluginScan.
+
+    Each block, the audio, MIDI and any parameter changes are written to a
+    shared-memory region and the child is woken to process them, so crossing
+    the process boundary costs one round trip per block. If the child doesn't
+    reply within the block's duration the output is cleared and the block is
+    dropped, and if it crashes the instance just outputs silence from then on.
+
+    Sandboxed plugins don't show editors.
+
+    You'll usually get one of these by returning true from
+    EngineBehaviour::shouldHostPluginInSeparateProcess, which makes the default
+    PluginManager::createPluginInstance create them.
+*/
+class SandboxedPluginInstance  : public juce::AudioPluginInstance
+{
+public:
+    /** Launches a child process and loads the plugin in it.
+        Returns nullptr and sets the error message if it fails.
+
+        This blocks until the child has loaded the plugin, or for up to 30 seconds if
+        it doesn't respond, so should be called from a background thread if possible.
+        It doesn't need the message thread so it's safe to call from any thread.
+    */
+    static std::unique_ptr<SandboxedPluginInstance> create (const juce::PluginDescription&,
+                                                            double sampleRate, int blockSize,
+                                                            juce::String& errorMessage);
+
+    /** This is called by a child process in the app's start-up code to host a
+        plugin. Returns true if the command-line params launch a host process, or
+        false if this is a normal run.
+        @see PluginManager::startChildProcessPluginHost
+    */
+    static bool startChildProcess (const juce::String& commandLine);
+
+    /** Destructor. Shuts the child process down. */
+    ~SandboxedPluginInstance() override;
+
+    /** Returns true if the child process has died. */
+    bool hasCrashed() const;
+
+    /** Returns the number of blocks that have been dropped because the child
+        didn't reply in time.
+    */
+    int getNumDroppedBlocks() const noexcept                { return numDroppedBlocks; }
+
+    //==============================================================================
+    /** @internal */
+    void fillInPluginDescription (juce::PluginDescription&) const override;
+    /** @internal */
+    const juce::String getName() const override;
+    /** @internal */
+    void prepareToPlay (double sampleRate, int blockSize) override;
+    /** @internal */
+    void releaseResources() override;
+    /** @internal */
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    /** @internal */
+    double getTailLengthSeconds() const override            { return tailLengthSeconds; }
+    /** @internal */
+    bool acceptsMidi() const override                       { return plugAcceptsMidi; }
+    /** @internal */
+    bool producesMidi() const override                      { return plugProducesMidi; }
+    /** @internal */
+    juce::AudioProcessorEditor* createEditor() override     { return nullptr; }
+    /** @internal */
+    bool hasEditor() const override                         { return false; }
+    /** @internal */
+    int getNumPrograms() override                           { return 1; }
+    /** @internal */
+    int getCurrentProgram() override                        { return 0; }
+    /** @internal */
+    void setCurrentProgram (int) override                   {}
+    /** @internal */
+    const juce::String getProgramName (int) override        { return {}; }
+    /** @internal */
+    void changeProgramName (int, const juce::String&) override {}
+    /** @internal */
+    void getStateInformation (juce::MemoryBlock&) override;
+    /** @internal */
+    void setStateInformation (const void*, int) override;
+
+private:
+    //==============================================================================
+    struct HostProcess;
+    struct ChildProcess;
+    struct Connection;
+    class Parameter;
+
+    SandboxedPluginInstance (const juce::PluginDescription&, std::unique_ptr<HostProcess>,
+                             const juce::XmlElement& loadReply);
+
+    juce::PluginDescription description;
+    std::unique_ptr<HostProcess> process;
+    std::unique_ptr<Connection> connection;
+    juce::Array<Parameter*> sandboxedParameters;
+
+    double tailLengthSeconds = 0.0;
+    bool plugAcceptsMidi = false, plugProducesMidi = false;
+    bool awaitingReply = false;
+    std::atomic<int> numDroppedBlocks { 0 };
+
+    void sendParameterChanges() noexcept;
+    void readParameterChanges() noexcept;
+    void updateParameterValues (const juce::XmlElement&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SandboxedPluginInstance)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,324 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+#include "../../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+#if ENGINE_UNIT_TESTS_PLUGINS
+
+namespace sandbox
+{
+    /** A gain processor that can be made to stall, to stand in for a plugin in the child. */
+    struct TestProcessor  : public juce::AudioProcessor
+    {
+        TestProcessor()
+            : juce::AudioProcessor (BusesProperties().withInput ("Input", juce::AudioChannelSet::stereo())
+                                                     .withOutput ("Output", juce::AudioChannelSet::stereo()))
+        {
+            addParameter (gain = new juce::AudioParameterFloat (juce::ParameterID ("gain", 1), "Gain", 0.0f, 1.0f, 1.0f));
+        }
+
+        void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override
+        {
+            if (auto ms = stallMs.load(); ms > 0)
+                juce::Thread::sleep (ms);
+
+            buffer.applyGain (gain->get());
+            ++numBlocksProcessed;
+        }
+
+        const juce::String getName() const override                 { return "Sandbox Test"; }
+        void prepareToPlay (double, int) override                   {}
+        void releaseResources() override                            {}
+        double getTailLengthSeconds() const override                { return 0.0; }
+        bool acceptsMidi() const override                           { return true; }
+        bool producesMidi() const override                          { return true; }
+        juce::AudioProcessorEditor* createEditor() override         { return nullptr; }
+        bool hasEditor() const override                             { return false; }
+        int getNumPrograms() override                               { return 1; }
+        int getCurrentProgram() override                            { return 0; }
+        void setCurrentProgram (int) override                       {}
+        const juce::String getProgramName (int) override            { return {}; }
+        void changeProgramName (int, const juce::String&) override  {}
+        void getStateInformation (juce::MemoryBlock&) override      {}
+        void setStateInformation (const void*, int) override        {}
+
+        juce::AudioParameterFloat* gain = nullptr;
+        std::atomic<int> stallMs { 0 }, numBlocksProcessed { 0 };
+    };
+
+    /** The shared memory and semaphores for one connection, with a thread standing in
+        for the child process, running the same loop as the real one.
+    */
+    struct TestLoopback
+    {
+        TestLoopback (int numChannels, int maxBlockSize)
+            : name (createUniqueName()),
+              memory (name, SharedState::getSizeNeeded (numChannels, maxBlockSize), true),
+              state (new (memory.getData()) SharedState (numChannels, maxBlockSize)),
+              request (name + "_rq", state->requestWord, true),
+              reply (name + "_rp", state->replyWord, true),
+              changedParameters (std::make_unique<std::atomic<bool>[]> ((size_t) processor.getParameters().size())),
+              channels ((size_t) numChannels)
+        {
+            midi.ensureSize (maxMidiBytes);
+
+            child = std::thread ([this]
+            {
+                for (;;)
+                {
+                    request.wait (-1);
+
+                    if (shouldExit)
+                        return;
+
+                    processSharedBlock (*state, processor, channels, midi, changedParameters.get());
+                    reply.signal();
+                    ++numRepliesSent;
+                }
+            });
+        }
+
+        ~TestLoopback()
+        {
+            shouldExit = true;
+            request.signal();
+            child.join();
+        }
+
+        const juce::String name;
+        SharedMemory memory;
+        SharedState* state;
+        InterprocessSemaphore request, reply;
+        TestProcessor processor;
+        std::unique_ptr<std::atomic<bool>[]> changedParameters;
+        std::vector<float*> channels;
+        juce::MidiBuffer midi;
+        std::atomic<bool> shouldExit { false };
+        std::atomic<int> numRepliesSent { 0 };
+        std::thread child;
+    };
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("Sandbox parameter queue")
+    {
+        auto queue = std::make_unique<sandbox::ParameterQueue>();
+        sandbox::ParameterChange change;
+        CHECK (! queue->pop (change));
+
+        // Fill it up, it should refuse anything more until something's popped
+        for (int i = 0; i < (int) sandbox::parameterQueueSize; ++i)
+            CHECK (queue->push ({ i, (float) i * 0.5f }));
+
+        CHECK (! queue->push ({ -1, 0.0f }));
+
+        for (int i = 0; i < (int) sandbox::parameterQueueSize; ++i)
+        {
+            REQUIRE (queue->pop (change));
+            CHECK_EQ (change.index, i);
+            CHECK_EQ (change.value, (float) i * 0.5f);
+        }
+
+        CHECK (! queue->pop (change));
+
+        // Keep going past the end so the positions wrap round the buffer
+        for (int i = 0; i < (int) sandbox::parameterQueueSize * 3; ++i)
+        {
+            CHECK (queue->push ({ i, 1.0f }));
+            REQUIRE (queue->pop (change));
+            CHECK_EQ (change.index, i);
+        }
+
+        // A producer and consumer on different threads shouldn't lose or reorder anything
+        const int numChanges = 100000;
+        std::thread producer ([&]
+        {
+            for (int i = 0; i < numChanges;)
+                if (queue->push ({ i, (float) i }))
+                    ++i;
+        });
+
+        int numReceived = 0;
+        bool inOrder = true;
+
+        while (numReceived < numChanges)
+        {
+            if (queue->pop (change))
+            {
+                inOrder = inOrder && change.index == numReceived && change.value == (float) numReceived;
+                ++numReceived;
+            }
+        }
+
+        producer.join();
+        CHECK (inOrder);
+        CHECK (! queue->pop (change));
+    }
+
+    TEST_CASE ("Sandbox MIDI round trip")
+    {
+        std::vector<uint8_t> data ((size_t) sandbox::maxMidiBytes);
+        juce::MidiBuffer in, out;
+
+        CHECK_EQ (sandbox::writeMidi (in, data.data()), 0);
+        sandbox::readMidi (data.data(), 0, out);
+        CHECK (out.isEmpty());
+
+        in.addEvent (juce::MidiMessage::noteOn (1, 60, 0.5f), 0);
+        in.addEvent (juce::MidiMessage::controllerEvent (2, 7, 100), 17);
+        in.addEvent (juce::MidiMessage::noteOff (1, 60), 511);
+        const uint8_t sysex[] = { 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x7f, 0x00, 0x41 };
+        in.addEvent (juce::MidiMessage::createSysExMessage (sysex, (int) sizeof (sysex)), 256);
+
+        const auto numBytes = sandbox::writeMidi (in, data.data());
+        sandbox::readMidi (data.data(), numBytes, out);
+        CHECK_EQ (out.getNumEvents(), in.getNumEvents());
+
+        for (auto [a, b] = std::pair (in.begin(), out.begin()); a != in.end() && b != out.end(); ++a, ++b)
+        {
+            const auto ma = (*a).getMessage(), mb = (*b).getMessage();
+            CHECK_EQ ((*a).samplePosition, (*b).samplePosition);
+            CHECK_EQ (ma.getRawDataSize(), mb.getRawDataSize());
+            CHECK (std::memcmp (ma.getRawData(), mb.getRawData(), (size_t) ma.getRawDataSize()) == 0);
+        }
+
+        // A truncated buffer should only give back the events that fit
+        sandbox::readMidi (data.data(), numBytes - 1, out);
+        CHECK_EQ (out.getNumEvents(), in.getNumEvents() - 1);
+
+        // Events that don't fit in the shared memory are dropped rather than overrunning it
+        juce::MidiBuffer tooMany;
+
+        for (int i = 0; i < sandbox::maxMidiBytes; ++i)
+            tooMany.addEvent (juce::MidiMessage::noteOn (1, 60, 0.5f), i);
+
+        const auto numTooManyBytes = sandbox::writeMidi (tooMany, data.data());
+        CHECK (numTooManyBytes <= sandbox::maxMidiBytes);
+        sandbox::readMidi (data.data(), numTooManyBytes, out);
+        CHECK (out.getNumEvents() > 0);
+        CHECK (out.getNumEvents() < tooMany.getNumEvents());
+    }
+
+    TEST_CASE ("Sandbox block handshake")
+    {
+        const int numChannels = 2, blockSize = 512, timeoutMs = 1000;
+        sandbox::TestLoopback loopback (numChannels, blockSize);
+        REQUIRE (loopback.memory.getData() != nullptr);
+        REQUIRE (loopback.request.isValid());
+        REQUIRE (loopback.reply.isValid());
+
+        bool awaitingReply = false;
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        auto fillBuffer = [&]
+        {
+            for (int c = 0; c < numChannels; ++c)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample (c, i, 0.5f * std::sin ((float) i * 0.1f + (float) c));
+
+            midi.clear();
+            midi.addEvent (juce::MidiMessage::noteOn (1, 64, 0.8f), 10);
+        };
+
+        auto checkBuffer = [&] (float expectedGain)
+        {
+            float maxDifference = 0.0f;
+
+            for (int c = 0; c < numChannels; ++c)
+                for (int i = 0; i < blockSize; ++i)
+                    maxDifference = std::max (maxDifference, std::abs (buffer.getSample (c, i) - expectedGain * 0.5f * std::sin ((float) i * 0.1f + (float) c)));
+
+            CHECK (maxDifference < 0.00001f);
+        };
+
+        SUBCASE ("Audio, MIDI and parameters make the round trip")
+        {
+            fillBuffer();
+            CHECK (sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, timeoutMs));
+            CHECK (! awaitingReply);
+            checkBuffer (1.0f);
+            CHECK_EQ (midi.getNumEvents(), 1);
+            CHECK_EQ ((*midi.begin()).samplePosition, 10);
+            CHECK ((*midi.begin()).getMessage().isNoteOn());
+
+            // Host -> child
+            CHECK (loopback.state->toChild.push ({ 0, 0.25f }));
+            fillBuffer();
+            CHECK (sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, timeoutMs));
+            checkBuffer (0.25f);
+
+            // Child -> host
+            loopback.changedParameters[0] = true;
+            fillBuffer();
+            CHECK (sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, timeoutMs));
+
+            sandbox::ParameterChange change;
+            REQUIRE (loopback.state->fromChild.pop (change));
+            CHECK_EQ (change.index, 0);
+            CHECK_EQ (change.value, doctest::Approx (0.25f));
+            CHECK (! loopback.state->fromChild.pop (change));
+            CHECK_EQ (loopback.processor.numBlocksProcessed.load(), 3);
+
+            // Oversized blocks are dropped without reaching the child
+            juce::AudioBuffer<float> tooBig (numChannels, blockSize * 2);
+            tooBig.clear();
+            tooBig.setSample (0, 0, 1.0f);
+            CHECK (! sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, tooBig, midi, timeoutMs));
+            CHECK_EQ (tooBig.getMagnitude (0, tooBig.getNumSamples()), 0.0f);
+            CHECK_EQ (loopback.processor.numBlocksProcessed.load(), 3);
+        }
+
+        SUBCASE ("Late blocks are dropped until the child catches up")
+        {
+            fillBuffer();
+            CHECK (sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, timeoutMs));
+            checkBuffer (1.0f);
+
+            // The child misses this block's deadline...
+            loopback.processor.stallMs = 300;
+            fillBuffer();
+            CHECK (! sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, 5));
+            CHECK (awaitingReply);
+            CHECK_EQ (buffer.getMagnitude (0, blockSize), 0.0f);
+            CHECK (midi.isEmpty());
+
+            // ...so whilst it's still busy the next one mustn't touch the shared buffers or wake it again
+            fillBuffer();
+            CHECK (! sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, timeoutMs));
+            CHECK (awaitingReply);
+            CHECK_EQ (buffer.getMagnitude (0, blockSize), 0.0f);
+
+            // Once it's replied to the late block, blocks get through again
+            loopback.processor.stallMs = 0;
+
+            while (loopback.numRepliesSent < 2)
+                juce::Thread::sleep (10);
+
+            fillBuffer();
+            CHECK (sandbox::exchangeBlock (*loopback.state, loopback.request, loopback.reply, awaitingReply, buffer, midi, timeoutMs));
+            CHECK (! awaitingReply);
+            checkBuffer (1.0f);
+            CHECK_EQ (loopback.processor.numBlocksProcessed.load(), 3);
+        }
+    }
+}
+
+#endif
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS
@@ -33,6 +33,7 @@ public:
     bool takesAudioInput() override                  { return true; }
     bool takesMidiInput() override                   { return true; }
     bool producesAudioWhenNoAudioInput() override    { return true; }
+    bool canSleepWhenSilent() override               { return false; }
     bool canBeAddedToClip() override                 { return false; }
     bool canBeAddedToRack() override                 { return false; }
     bool needsConstantBufferSize() override          { return true; }
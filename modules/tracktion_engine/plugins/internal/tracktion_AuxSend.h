@@ -48,6 +48,7 @@ public:
     juce::String getSelectableDescription() override { return TRANS("Aux Send Plugin"); }
 
     bool takesAudioInput() override                  { return true; }
+    bool canSleepWhenSilent() override               { return false; }
     bool canBeAddedToClip() override                 { return false; }
     bool canBeAddedToRack() override                 { return false; }
     bool needsConstantBufferSize() override          { return true; }
@@ -89,6 +89,7 @@ public:
     juce::String getTooltip() override                  { return TRANS("Track will freeze up to this plugin"); }
     juce::String getSelectableDescription() override    { return TRANS("Freeze Point Plugin"); }
     bool producesAudioWhenNoAudioInput() override       { return false; }
+    bool canSleepWhenSilent() override                  { return false; }
     bool canBeAddedToClip() override                    { return false; }
     bool canBeAddedToRack() override                    { return false; }
     bool canBeAddedToMaster() override                  { return false; }
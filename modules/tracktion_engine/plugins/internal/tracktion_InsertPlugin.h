@@ -36,6 +36,7 @@ public:
     void getChannelNames (juce::StringArray*, juce::StringArray*) override;
     bool takesAudioInput() override;
     bool takesMidiInput() override;
+    bool canSleepWhenSilent() override { return false; }
     bool canBeAddedToClip() override;
     bool needsConstantBufferSize() override;
 
@@ -29,6 +29,7 @@ public:
     juce::String getShortName (int) override            { return "Meter"; }
     juce::String getTooltip() override                  { return TRANS("Level meter plugin") + "$levelmeterplugin"; }
     bool canBeDisabled() override                       { return false; }
+    bool canSleepWhenSilent() override                  { return false; }
     bool shouldMeasureCpuUsage() const noexcept final   { return false; }
 
     int getNumOutputChannelsGivenInputs (int numInputChannels) override     { return juce::jmin (numInputChannels, 2); }
@@ -92,6 +92,7 @@ public:
     bool takesMidiInput() override                      { return true; }
     bool takesAudioInput() override                     { return true; }
     bool producesAudioWhenNoAudioInput() override       { return true; }
+    bool canSleepWhenSilent() override                  { return false; }
     bool canBeAddedToClip() override                    { return false; }
     bool needsConstantBufferSize() override             { return true; }
 
@@ -158,6 +158,9 @@ void VolumeAndPanPlugin::initialise (const PluginInitialisationInfo& info)
     smoothedGainL.reset (info.sampleRate, smoothingRampTimeSeconds);
     smoothedGainR.reset (info.sampleRate, smoothingRampTimeSeconds);
     smoothedGain.reset (info.sampleRate, smoothingRampTimeSeconds);
+
+    // Volume, pan and then the left, right and overall gains
+    automationBuffer.setSize (5, info.blockSizeSamples);
 }
 
 void VolumeAndPanPlugin::initialiseWithoutStopping (const PluginInitialisationInfo&)
@@ -233,6 +236,77 @@ void VolumeAndPanPlugin::setSmoothedValueTargets (TimePosition time, bool update
     }
 }
 
+bool VolumeAndPanPlugin::calculateAutomatedGains (const PluginRenderContext& fc, float* gainsL, float* gainsR, float* gains)
+{
+    const auto numSamples = fc.bufferNumSamples;
+
+    if (numSamples > automationBuffer.getNumSamples())
+        return false;
+
+    auto volumes = automationBuffer.getWritePointer (0);
+    auto pans = automationBuffer.getWritePointer (1);
+    const bool isVolumeAutomated = volParam->getValuesForBlock (fc.editTime, volumes, numSamples);
+    const bool isPanAutomated = panParam->getValuesForBlock (fc.editTime, pans, numSamples);
+
+    if (! (isVolumeAutomated || isPanAutomated))
+        return false;
+
+    if (! isVolumeAutomated)
+        juce::FloatVectorOperations::fill (volumes, getSliderPos(), numSamples);
+
+    if (! isPanAutomated)
+        juce::FloatVectorOperations::fill (pans, getPan(), numSamples);
+
+    const auto vcaPosDelta = getVCAPosDelta (fc.editTime.getStart());
+    const auto lawToUse = getPanLaw();
+    const auto polarityGain = polarity ? -1.0f : 1.0f;
+    const auto numChans = fc.destBuffer->getNumChannels();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto sliderPos = volumes[i] + vcaPosDelta;
+        getGainsFromVolumeFaderPositionAndPan (sliderPos, pans[i], lawToUse, gainsL[i], gainsR[i]);
+        gainsL[i] *= polarityGain;
+        gainsR[i] *= polarityGain;
+
+        if (numChans > 2)
+            gains[i] = volumeFaderPositionToGain (sliderPos) * polarityGain;
+    }
+
+    // Jump the smoothed gains to the end of the automation so they don't ramp from a stale value
+    smoothedGainL.setCurrentAndTargetValue (gainsL[numSamples - 1]);
+    smoothedGainR.setCurrentAndTargetValue (gainsR[numSamples - 1]);
+
+    if (numChans > 2)
+        smoothedGain.setCurrentAndTargetValue (gains[numSamples - 1]);
+
+    return true;
+}
+
+bool VolumeAndPanPlugin::applyAutomatedGains (const PluginRenderContext& fc)
+{
+    auto& buffer = *fc.destBuffer;
+    const auto numSamples = fc.bufferNumSamples;
+    auto gainsL = automationBuffer.getWritePointer (2);
+    auto gainsR = automationBuffer.getWritePointer (3);
+    auto gains = automationBuffer.getWritePointer (4);
+
+    if (! calculateAutomatedGains (fc, gainsL, gainsR, gains))
+        return false;
+
+    const auto numChans = buffer.getNumChannels();
+
+    juce::FloatVectorOperations::multiply (buffer.getWritePointer (0, fc.bufferStartSample), gainsL, numSamples);
+
+    if (numChans > 1)
+        juce::FloatVectorOperations::multiply (buffer.getWritePointer (1, fc.bufferStartSample), gainsR, numSamples);
+
+    for (int chan = 2; chan < numChans; ++chan)
+        juce::FloatVectorOperations::multiply (buffer.getWritePointer (chan, fc.bufferStartSample), gains, numSamples);
+
+    return true;
+}
+
 void VolumeAndPanPlugin::applyToBuffer (const PluginRenderContext& fc)
 {
     if (isEnabled())
@@ -245,21 +319,24 @@ void VolumeAndPanPlugin::applyToBuffer (const PluginRenderContext& fc)
 
             setSmoothedValueTargets (fc.editTime.getStart(), numChansIn > 2);
 
-            smoothedGainL.applyGain (buffer->getWritePointer (0, fc.bufferStartSample), fc.bufferNumSamples);
-
-            if (numChansIn > 1)
+            if (! applyAutomatedGains (fc))
             {
-                smoothedGainR.applyGain (buffer->getWritePointer (1, fc.bufferStartSample), fc.bufferNumSamples);
+                smoothedGainL.applyGain (buffer->getWritePointer (0, fc.bufferStartSample), fc.bufferNumSamples);
 
-                // If the number of channels is greater than two, apply volume to the rest
-                if (numChansIn > 2)
+                if (numChansIn > 1)
                 {
-                    auto originalGain = smoothedGain;
+                    smoothedGainR.applyGain (buffer->getWritePointer (1, fc.bufferStartSample), fc.bufferNumSamples);
 
-                    for (int i = 2; i < numChansIn; ++i)
+                    // If the number of channels is greater than two, apply volume to the rest
+                    if (numChansIn > 2)
                     {
-                        smoothedGain = originalGain;
-                        smoothedGain.applyGain (buffer->getWritePointer (i, fc.bufferStartSample), fc.bufferNumSamples);
+                        auto originalGain = smoothedGain;
+
+                        for (int i = 2; i < numChansIn; ++i)
+                        {
+                            smoothedGain = originalGain;
+                            smoothedGain.applyGain (buffer->getWritePointer (i, fc.bufferStartSample), fc.bufferNumSamples);
+                        }
                     }
                 }
             }
@@ -270,6 +347,51 @@ void VolumeAndPanPlugin::applyToBuffer (const PluginRenderContext& fc)
     }
 }
 
+void VolumeAndPanPlugin::getGainsForBlock (const PluginRenderContext& fc, BlockGains& gains)
+{
+    gains.isConstant = true;
+    gains.left[0] = gains.right[0] = gains.other[0] = 1.0f;
+
+    if (! isEnabled() || fc.destBuffer == nullptr)
+        return;
+
+    SCOPED_REALTIME_CHECK
+
+    const auto numChans = fc.destBuffer->getNumChannels();
+    const auto numSamples = fc.bufferNumSamples;
+
+    setSmoothedValueTargets (fc.editTime.getStart(), numChans > 2);
+
+    if (calculateAutomatedGains (fc, gains.left, gains.right, gains.other))
+    {
+        gains.isConstant = false;
+    }
+    else if (smoothedGainL.isSmoothing() || smoothedGainR.isSmoothing()
+             || (numChans > 2 && smoothedGain.isSmoothing()))
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            gains.left[i] = smoothedGainL.getNextValue();
+            gains.right[i] = smoothedGainR.getNextValue();
+        }
+
+        if (numChans > 2)
+            for (int i = 0; i < numSamples; ++i)
+                gains.other[i] = smoothedGain.getNextValue();
+
+        gains.isConstant = false;
+    }
+    else
+    {
+        gains.left[0] = smoothedGainL.getCurrentValue();
+        gains.right[0] = smoothedGainR.getCurrentValue();
+        gains.other[0] = smoothedGain.getCurrentValue();
+    }
+
+    if (applyToMidi && fc.bufferForMidiMessages != nullptr)
+        fc.bufferForMidiMessages->multiplyVelocities (volumeFaderPositionToGain (getSliderPos()));
+}
+
 void VolumeAndPanPlugin::refreshVCATrack()
 {
     juce::ReferenceCountedObjectPtr<AudioTrack> newVcaTrack (ignoreVca ? nullptr : dynamic_cast<AudioTrack*> (getOwnerTrack()));
@@ -65,6 +65,25 @@ public:
 
     void restorePluginStateFromValueTree (const juce::ValueTree&) override;
 
+    //==============================================================================
+    /** The gains applied to a block, for the left, right and any other channels.
+        The arrays are provided by the caller and must hold a value per sample.
+    */
+    struct BlockGains
+    {
+        float* left = nullptr;
+        float* right = nullptr;
+        float* other = nullptr;
+        bool isConstant = true;     /**< If true, only the first value of each array is set. */
+    };
+
+    /** @internal
+        Calculates the gains that applyToBuffer would apply to the context's buffer,
+        without applying them, so that consecutive gain stages can be combined in to
+        a single pass over the audio. Any MIDI velocities are still scaled.
+    */
+    void getGainsForBlock (const PluginRenderContext&, BlockGains&);
+
     //==============================================================================
     juce::CachedValue<float> volume, pan;
     juce::CachedValue<bool> applyToMidi, ignoreVca, polarity;
@@ -80,12 +99,15 @@ public:
 private:
     float lastVolumeBeforeMute = 0.0f;
     juce::SmoothedValue<float> smoothedGainL, smoothedGainR, smoothedGain;
+    juce::AudioBuffer<float> automationBuffer;
 
     RealTimeSpinLock vcaTrackLock;
     juce::ReferenceCountedObjectPtr<AudioTrack> vcaTrack;
     const bool isMasterVolume = false;
 
     void setSmoothedValueTargets (TimePosition, bool);
+    bool calculateAutomatedGains (const PluginRenderContext&, float* gainsL, float* gainsR, float* gains);
+    bool applyAutomatedGains (const PluginRenderContext&);
     void refreshVCATrack();
     float getVCAPosDelta (TimePosition);
 
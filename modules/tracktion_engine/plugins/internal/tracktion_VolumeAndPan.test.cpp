@@ -0,0 +1,84 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+
+namespace tracktion::inline engine
+{
+
+#if ENGINE_UNIT_TESTS_VOLPANPLUGIN
+TEST_SUITE("tracktion_engine")
+{
+    TEST_CASE ("Consecutive volume plugins")
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+        auto um = &edit->getUndoManager();
+        auto track = getAudioTracks (*edit)[0];
+
+        // Sin file must outlive everything!
+        auto fileLength = 5_td;
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, fileLength.inSeconds());
+        insertWaveClip (*track, {}, sinFile->getFile(), { .time = { 0_tp, fileLength } },
+                        DeleteExistingClips::no);
+
+        // Two -6dB stages straight before the track's fader, these get folded in to one pass
+        auto addVolumePlugin = [&]
+        {
+            auto plugin = track->pluginList.insertPlugin (VolumeAndPanPlugin::create(), 0);
+            VolumeAndPanPlugin::Ptr volPan (dynamic_cast<VolumeAndPanPlugin*> (plugin.get()));
+            volPan->setVolumeDb (juce::Decibels::gainToDecibels (0.5f));
+            return volPan;
+        };
+
+        auto firstVolPan = addVolumePlugin();
+        auto secondVolPan = addVolumePlugin();
+
+        SUBCASE ("Constant gains")
+        {
+            auto render = test_utilities::renderToAudioBuffer (*edit);
+            CHECK (test_utilities::getRMSLevel (render, { 0_tp, 5_tp }, 0)
+                    == doctest::Approx (0.707f * 0.25f).epsilon (0.01));
+        }
+
+        SUBCASE ("Bypassed stage")
+        {
+            firstVolPan->setEnabled (false);
+
+            auto render = test_utilities::renderToAudioBuffer (*edit);
+            CHECK (test_utilities::getRMSLevel (render, { 0_tp, 5_tp }, 0)
+                    == doctest::Approx (0.707f * 0.5f).epsilon (0.01));
+        }
+
+        SUBCASE ("Automated stage")
+        {
+            auto volParam = secondVolPan->volParam;
+            auto& volCurve = volParam->getCurve();
+
+            auto firstVal = getValueAt (*volParam, 0_tp);
+            volCurve.addPoint (2.5_tp, firstVal, 0.0, um);
+            volCurve.addPoint (2.5_tp, 0.0f, 0.0, um);
+            CHECK (volParam->isAutomationActive());
+
+            auto render = test_utilities::renderToAudioBuffer (*edit);
+            CHECK (test_utilities::getRMSLevel (render, { 0_tp, 2_tp }, 0)
+                    == doctest::Approx (0.707f * 0.25f).epsilon (0.01));
+            CHECK (test_utilities::getRMSLevel (render, { 3_tp, 5_tp }, 0)
+                    == doctest::Approx (0.0f));
+        }
+    }
+}
+#endif
+
+} // namespace::inline namespace engine
+
+#endif //TRACKTION_UNIT_TESTS
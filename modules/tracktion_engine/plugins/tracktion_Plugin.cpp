@@ -434,6 +434,26 @@ void Plugin::setFrozen (bool shouldBeFrozen)
         cpuUsageMs = 0.0;
 }
 
+double Plugin::getCpuSavedBySleeping() const noexcept
+{
+    if (! isSleeping())
+        return 0.0;
+
+    return juce::jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMsBeforeSleeping.load());
+}
+
+void Plugin::setSleeping (bool shouldSleep) noexcept
+{
+    if (sleeping.exchange (shouldSleep, std::memory_order_relaxed) == shouldSleep)
+        return;
+
+    if (shouldSleep)
+    {
+        cpuUsageMsBeforeSleeping = cpuUsageMs.load();
+        cpuUsageMs = 0.0;
+    }
+}
+
 juce::String Plugin::getTooltip()
 {
     return getName() + "$genericfilter";
@@ -662,6 +682,14 @@ void Plugin::applyToBufferWithAutomation (const PluginRenderContext& pc)
     if (shouldMeasureCpuUsage())
         cpuMeter.emplace (cpuUsageMs, 0.2);
 
+    updateAutomationForBlock (pc);
+    applyToBuffer (pc);
+}
+
+void Plugin::updateAutomationForBlock (const PluginRenderContext& pc)
+{
+    SCOPED_REALTIME_CHECK
+
     auto& arm = edit.getAutomationRecordManager();
     jassert (initialiseCount > 0);
    #if JUCE_DEBUG
@@ -675,25 +703,16 @@ void Plugin::applyToBufferWithAutomation (const PluginRenderContext& pc)
     {
         if (pc.isScrubbing || ! pc.isPlaying)
         {
-            SCOPED_REALTIME_CHECK
             auto& tc = edit.getTransport();
             updateParameterStreams (tc.isPlayContextActive() && ! pc.isRendering
                                         ? tc.getPosition()
                                         : pc.editTime.getStart());
-            applyToBuffer (pc);
         }
         else
         {
-            SCOPED_REALTIME_CHECK
             updateParameterStreams (pc.editTime.getStart());
-            applyToBuffer (pc);
         }
     }
-    else
-    {
-        SCOPED_REALTIME_CHECK
-        applyToBuffer (pc);
-    }
 }
 
 //==============================================================================
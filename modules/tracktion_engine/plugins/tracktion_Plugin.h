@@ -215,6 +215,12 @@ public:
     // wrapper on applyTobuffer, called by the node
     void applyToBufferWithAutomation (const PluginRenderContext&);
 
+    /** Updates the parameters from any automation for the block about to be processed.
+        This is called by applyToBufferWithAutomation but can be used by Nodes that
+        process a plugin's effect themselves instead of calling applyToBuffer.
+    */
+    void updateAutomationForBlock (const PluginRenderContext&);
+
     //==============================================================================
     /** Plugins can return false if they want to avoid the overhead of measuring the CPU usage.
         It's a small overhead but with many tracks, the level meters and vol/pan plugins can make a difference.
@@ -224,6 +230,25 @@ public:
     /** Returns the proportion of the current buffer size spent processing this plugin. */
     double getCpuUsage() const noexcept     { return juce::jlimit (0.0, 1.0, timeToCpuScale * cpuUsageMs.load()); }
 
+    /** Plugins can return false to stop them being put to sleep when they're idle.
+        A plugin is put to sleep and not processed once its input and output have been silent
+        for longer than its tail length and latency, and wakes up as soon as any audio or MIDI
+        arrives. Plugins that can make sound or MIDI without any input, or that have a tail
+        which getTailLength doesn't report, should return false.
+    */
+    virtual bool canSleepWhenSilent()                   { return true; }
+
+    /** Returns true if this plugin isn't currently being processed as it's been silent. */
+    bool isSleeping() const noexcept                    { return sleeping.load (std::memory_order_relaxed); }
+
+    /** Returns the proportion of the current buffer size that's being saved by not processing
+        this plugin while it's asleep, based on its usage before it went to sleep.
+    */
+    double getCpuSavedBySleeping() const noexcept;
+
+    /** Called by the playback graph when the plugin goes to sleep or wakes up. */
+    void setSleeping (bool) noexcept;
+
     //==============================================================================
     /** This must return the number of output channels that the plugin will produce, given
         a number of input channels.
@@ -300,6 +325,11 @@ public:
     /** Plugins can be disabled to avoid them crashing Edits. */
     virtual bool isDisabled()                                           { return false; }
 
+    /** Returns roughly how many bytes the plugin has allocated for things like
+        samples or impulse responses. This is used by EditMemoryBudget reports.
+    */
+    virtual size_t getAllocatedBytes()                                  { return 0; }
+
     bool isInRack() const;
     juce::ReferenceCountedObjectPtr<RackType> getOwnerRackType() const;
 
@@ -440,7 +470,8 @@ private:
 
     std::atomic<int> initialiseCount { 0 };
     double timeToCpuScale = 0;
-    std::atomic<double> cpuUsageMs { 0 };
+    std::atomic<double> cpuUsageMs { 0 }, cpuUsageMsBeforeSleeping { 0 };
+    std::atomic<bool> sleeping { false };
     std::atomic<bool> isClipEffect { false };
 
     juce::ValueTree getConnectionsTree();
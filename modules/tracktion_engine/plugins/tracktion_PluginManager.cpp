@@ -30,12 +30,100 @@ inline SettingID getPluginListPropertyName()
 PluginManager::BuiltInType::BuiltInType (const juce::String& t) : type (t) {}
 PluginManager::BuiltInType::~BuiltInType() {}
 
+//==============================================================================
+/** Rescans any binaries in the formats' default locations that have been added or
+    changed since they were last scanned, on background threads.
+*/
+struct PluginManager::IncrementalScanner  : private juce::Thread,
+                                            private juce::AsyncUpdater
+{
+    IncrementalScanner (PluginManager& pm)
+        : juce::Thread ("Plugin Rescan"), pluginManager (pm),
+          pool (std::max (1, pm.getNumberOfThreadsForScanning()))
+    {
+        startThread (juce::Thread::Priority::background);
+    }
+
+    ~IncrementalScanner() override
+    {
+        cancelPendingUpdate();
+
+        if (pluginManager.abortCurrentPluginScan)
+            pluginManager.abortCurrentPluginScan();
+
+        stopThread (-1);
+        pool.removeAllJobs (true, -1);
+    }
+
+    bool isFinished() const
+    {
+        return finished;
+    }
+
+private:
+    PluginManager& pluginManager;
+    juce::ThreadPool pool;
+    std::atomic<bool> finished { false };
+
+    void run() override
+    {
+        auto& list = pluginManager.knownPluginList;
+
+        for (auto format : pluginManager.pluginFormatManager.getFormats())
+        {
+            if (! format->canScanForPlugins())
+                continue;
+
+            // Remove any plugins that have been deleted
+            for (auto& desc : list.getTypesForFormat (*format))
+                if (! format->doesPluginStillExist (desc))
+                    list.removeType (desc);
+
+            for (auto& fileOrIdentifier : format->searchPathsForPlugins (format->getDefaultLocationsToSearch(), true, false))
+            {
+                if (threadShouldExit())
+                    return;
+
+                if (list.isListingUpToDate (fileOrIdentifier, *format)
+                     || list.getBlacklistedFiles().contains (fileOrIdentifier))
+                    continue;
+
+                pool.addJob ([&list, format, fileOrIdentifier]
+                             {
+                                 juce::OwnedArray<juce::PluginDescription> found;
+                                 list.scanAndAddFile (fileOrIdentifier, true, found, *format);
+                             });
+            }
+        }
+
+        while (pool.getNumJobs() > 0)
+        {
+            if (threadShouldExit())
+                return;
+
+            wait (100);
+        }
+
+        triggerAsyncUpdate();
+    }
+
+    void handleAsyncUpdate() override
+    {
+        finished = true;
+        pluginManager.knownPluginList.scanFinished();
+    }
+};
+
 //==============================================================================
 PluginManager::PluginManager (Engine& e)
     : engine (e)
 {
     createPluginInstance = [this] (const juce::PluginDescription& description, double rate, int blockSize, juce::String& errorMessage)
     {
+        if (engine.getEngineBehaviour().shouldHostPluginInSeparateProcess (description))
+            return std::unique_ptr<juce::AudioPluginInstance> (SandboxedPluginInstance::create (description, rate,
+                                                                                                blockSize, errorMessage));
+
         return std::unique_ptr<juce::AudioPluginInstance> (pluginFormatManager.createPluginInstance (description, rate,
                                                                                                      blockSize, errorMessage));
     };
@@ -69,12 +157,15 @@ void PluginManager::initialise()
     createBuiltInType<ReWirePlugin>();
    #endif
 
-    initialised = true;
     pluginFormatManager.addDefaultFormats();
 
     if (auto patchFormat = createCmajorPatchPluginFormat (engine))
         pluginFormatManager.addFormat (patchFormat.release());
 
+    if (engine.getEngineBehaviour().shouldCachePluginScanResults())
+        scanCache = std::make_unique<PluginScanCache> (engine.getPropertyStorage().getAppCacheFolder()
+                                                         .getChildFile ("PluginScanCache.xml"));
+
     auto customScanner = std::make_unique<PluginScanHelpers::CustomScanner> (engine);
 
     abortCurrentPluginScan = [c = customScanner.get()]
@@ -90,10 +181,26 @@ void PluginManager::initialise()
         knownPluginList.recreateFromXml (*xml);
 
     knownPluginList.addChangeListener (this);
+    initialised = true;
+
+    if (engine.getEngineBehaviour().shouldRescanPluginsOnStartup())
+        startIncrementalPluginScan();
+}
+
+void PluginManager::initialiseIfNeeded()
+{
+    if (initialised)
+        return;
+
+    const std::scoped_lock sl (initialiseMutex);
+
+    if (! initialised)
+        initialise();
 }
 
 PluginManager::~PluginManager()
 {
+    incrementalScanner.reset();
     abortCurrentPluginScan = [] {};
     knownPluginList.removeChangeListener (this);
     cleanUpDanglingPlugins();
@@ -301,7 +408,10 @@ Plugin::Ptr PluginManager::createExistingPlugin (Edit& ed, const juce::ValueTree
 {
     if (auto p = createPlugin (ed, v, false))
     {
-        p->initialiseFully();
+        // ExternalPlugins created whilst the Edit's tracks are loading get initialised together afterwards
+        if (ed.getExternalPluginBatchLoader() == nullptr || dynamic_cast<ExternalPlugin*> (p.get()) == nullptr)
+            p->initialiseFully();
+
         return p;
     }
 
@@ -321,7 +431,7 @@ Plugin::Ptr PluginManager::createNewPlugin (Edit& ed, const juce::ValueTree& v)
 
 Plugin::Ptr PluginManager::createNewPlugin (Edit& ed, const juce::String& type, const juce::PluginDescription& desc)
 {
-    jassert (initialised); // must call PluginManager::initialise() before this!
+    initialiseIfNeeded();
     jassert ((type == ExternalPlugin::xmlTypeName) == type.equalsIgnoreCase (ExternalPlugin::xmlTypeName));
 
     if (type.equalsIgnoreCase (ExternalPlugin::xmlTypeName))
@@ -371,7 +481,7 @@ Plugin::Ptr PluginManager::createNewPlugin (Edit& ed, const juce::String& type,
 
 juce::Array<juce::PluginDescription> PluginManager::getARACompatiblePlugDescriptions()
 {
-    jassert (initialised); // must call PluginManager::initialise() before this!
+    initialiseIfNeeded();
 
     juce::Array<juce::PluginDescription> descs;
 
@@ -412,6 +522,22 @@ void PluginManager::setDoubleClickToOpenWindows (bool b)
     engine.getPropertyStorage().setProperty (SettingID::windowsDoubleClick, b);
 }
 
+void PluginManager::startIncrementalPluginScan()
+{
+    initialiseIfNeeded();
+
+    if (! isIncrementalPluginScanRunning())
+    {
+        incrementalScanner.reset();
+        incrementalScanner = std::make_unique<IncrementalScanner> (*this);
+    }
+}
+
+bool PluginManager::isIncrementalPluginScanRunning() const
+{
+    return incrementalScanner != nullptr && ! incrementalScanner->isFinished();
+}
+
 int PluginManager::getNumberOfThreadsForScanning()
 {
     return juce::jlimit (1, juce::SystemStats::getNumCpus(),
@@ -438,7 +564,7 @@ void PluginManager::setUsesSeparateProcessForScanning (bool b)
 
 Plugin::Ptr PluginManager::createPlugin (Edit& ed, const juce::ValueTree& v, bool isNew)
 {
-    jassert (initialised); // must call PluginManager::initialise() before this!
+    initialiseIfNeeded();
 
     if (! v.isValid())
         return {};
@@ -512,6 +638,20 @@ bool PluginManager::startChildProcessPluginScan (const juce::String& commandLine
     return false;
 }
 
+bool PluginManager::startChildProcessPluginHost (const juce::String& commandLine)
+{
+    if (SandboxedPluginInstance::startChildProcess (commandLine))
+    {
+       #if JUCE_MAC
+        setupSignalHandling();
+       #endif
+
+        return true;
+    }
+
+    return false;
+}
+
 //==============================================================================
 PluginCache::PluginCache (Edit& ed) : edit (ed)
 {
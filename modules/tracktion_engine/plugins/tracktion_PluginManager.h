@@ -19,6 +19,11 @@ public:
 
     void initialise();
 
+    /// Initialises the PluginManager if it hasn't been already. In headless batch
+    /// mode the Engine doesn't initialise it on start-up so this is called when a
+    /// plugin is first needed. @see EngineBehaviour::isHeadlessBatchMode
+    void initialiseIfNeeded();
+
    #if TRACKTION_AIR_WINDOWS
     void initialiseAirWindows();
    #endif
@@ -28,6 +33,11 @@ public:
     /// or false if this is a normal run.
     static bool startChildProcessPluginScan (const juce::String& commandLine);
 
+    /// This is called by a child process in the app's start-up code, to host a
+    /// sandboxed plugin. Returns true if the command-line params launch a host,
+    /// or false if this is a normal run. @see SandboxedPluginInstance
+    static bool startChildProcessPluginHost (const juce::String& commandLine);
+
     //==============================================================================
     bool areGUIsLockedByDefault();
     void setGUIsLockedByDefault (bool);
@@ -54,6 +64,19 @@ public:
     /// May be called by clients to cancel a scan if one is active
     std::function<void()> abortCurrentPluginScan;
 
+    /// Returns the cache of previous scan results, or nullptr if
+    /// EngineBehaviour::shouldCachePluginScanResults returned false.
+    PluginScanCache* getScanCache() const       { return scanCache.get(); }
+
+    /// Scans any binaries in the formats' default locations that are new or have
+    /// changed since they were last scanned, and removes any plugins that no longer
+    /// exist. This runs on background threads and the knownPluginList will send a
+    /// change message as plugins are found.
+    void startIncrementalPluginScan();
+
+    /// Returns true if an incremental scan has been started and hasn't finished yet.
+    bool isIncrementalPluginScanRunning() const;
+
     //==============================================================================
     struct BuiltInType
     {
@@ -117,7 +140,11 @@ private:
 
     juce::CriticalSection existingListLock;
     juce::OwnedArray<BuiltInType> builtInTypes;
-    bool initialised = false;
+    std::unique_ptr<PluginScanCache> scanCache;
+    struct IncrementalScanner;
+    std::unique_ptr<IncrementalScanner> incrementalScanner;
+    std::mutex initialiseMutex;
+    std::atomic<bool> initialised { false };
 
     Plugin::Ptr createPlugin (Edit&, const juce::ValueTree&, bool isNew);
 
@@ -0,0 +1,166 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace plugin_scan_cache
+{
+    static juce::String getKey (const juce::AudioPluginFormat& format, const juce::String& fileOrIdentifier)
+    {
+        return format.getName() + "|" + fileOrIdentifier;
+    }
+
+    static HashCode getFileHash (const juce::String& relativePath, const juce::File& f)
+    {
+        return (relativePath + ":" + juce::String (f.getSize())
+                  + ":" + juce::String (f.getLastModificationTime().toMilliseconds())).hashCode64();
+    }
+}
+
+//==============================================================================
+PluginScanCache::PluginScanCache (const juce::File& file)
+    : cacheFile (file)
+{
+    load();
+}
+
+PluginScanCache::~PluginScanCache()
+{
+    save();
+}
+
+std::optional<HashCode> PluginScanCache::getFingerprint (const juce::String& fileOrIdentifier)
+{
+    if (! juce::File::isAbsolutePath (fileOrIdentifier))
+        return {};
+
+    const juce::File f (fileOrIdentifier);
+
+    if (! f.exists())
+        return {};
+
+    if (! f.isDirectory())
+        return plugin_scan_cache::getFileHash ({}, f);
+
+    // The order the files are found in isn't defined so their hashes are combined
+    // in a way that doesn't depend on it
+    HashCode fingerprint = 0;
+
+    for (const auto& entry : juce::RangedDirectoryIterator (f, true, "*", juce::File::findFiles))
+        fingerprint ^= plugin_scan_cache::getFileHash (entry.getFile().getRelativePathFrom (f), entry.getFile());
+
+    return fingerprint;
+}
+
+std::optional<juce::Array<juce::PluginDescription>> PluginScanCache::find (const juce::AudioPluginFormat& format,
+                                                                           const juce::String& fileOrIdentifier)
+{
+    auto fingerprint = getFingerprint (fileOrIdentifier);
+
+    if (! fingerprint)
+        return {};
+
+    const std::scoped_lock sl (mutex);
+    auto found = entries.find (plugin_scan_cache::getKey (format, fileOrIdentifier));
+
+    if (found == entries.end() || found->second.fingerprint != *fingerprint)
+        return {};
+
+    return found->second.types;
+}
+
+void PluginScanCache::add (const juce::AudioPluginFormat& format, const juce::String& fileOrIdentifier,
+                           const juce::Array<juce::PluginDescription>& types)
+{
+    auto fingerprint = getFingerprint (fileOrIdentifier);
+
+    if (! fingerprint)
+        return;
+
+    const std::scoped_lock sl (mutex);
+    entries[plugin_scan_cache::getKey (format, fileOrIdentifier)] = { *fingerprint, types };
+    isDirty = true;
+}
+
+void PluginScanCache::clear()
+{
+    const std::scoped_lock sl (mutex);
+    isDirty = isDirty || ! entries.empty();
+    entries.clear();
+}
+
+int PluginScanCache::getNumEntries()
+{
+    const std::scoped_lock sl (mutex);
+    return (int) entries.size();
+}
+
+//==============================================================================
+void PluginScanCache::load()
+{
+    auto xml = juce::parseXMLIfTagMatches (cacheFile, "PLUGINSCANCACHE");
+
+    if (xml == nullptr)
+        return;
+
+    const std::scoped_lock sl (mutex);
+
+    for (auto binary : xml->getChildWithTagNameIterator ("BINARY"))
+    {
+        Entry entry;
+        entry.fingerprint = binary->getStringAttribute ("fingerprint").getLargeIntValue();
+
+        for (auto e : binary->getChildIterator())
+        {
+            juce::PluginDescription desc;
+
+            if (desc.loadFromXml (*e))
+                entry.types.add (desc);
+        }
+
+        entries[binary->getStringAttribute ("key")] = std::move (entry);
+    }
+}
+
+bool PluginScanCache::save()
+{
+    juce::XmlElement xml ("PLUGINSCANCACHE");
+
+    {
+        const std::scoped_lock sl (mutex);
+
+        if (! isDirty)
+            return true;
+
+        for (auto& [key, entry] : entries)
+        {
+            auto binary = xml.createNewChildElement ("BINARY");
+            binary->setAttribute ("key", key);
+            binary->setAttribute ("fingerprint", juce::String (entry.fingerprint));
+
+            for (auto& desc : entry.types)
+                binary->addChildElement (desc.createXml().release());
+        }
+
+        isDirty = false;
+    }
+
+    if (cacheFile.getParentDirectory().createDirectory() && xml.writeTo (cacheFile))
+        return true;
+
+    TRACKTION_LOG_ERROR ("Failed to save plugin scan cache: " + cacheFile.getFullPathName());
+
+    const std::scoped_lock sl (mutex);
+    isDirty = true;
+    return false;
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,83 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    A persistent record of the plugins found in each binary the last time it was
+    scanned, so binaries that haven't changed don't have to be loaded again.
+
+    Entries are keyed by the format and the binary's path and store a fingerprint
+    of the binary. For single files this is made from the file's size and
+    modification time. For bundles it's made from the relative path, size and
+    modification time of every file inside the bundle, so changing any of them
+    means the bundle is scanned again.
+
+    Only successful scans are stored. Binaries that crash the scanner are left to
+    the KnownPluginList's blacklist.
+
+    The PluginManager has one of these if
+    EngineBehaviour::shouldCachePluginScanResults returns true.
+*/
+class PluginScanCache
+{
+public:
+    /** Creates a cache that reads from and saves to the given file. */
+    PluginScanCache (const juce::File& cacheFile);
+
+    /** Destructor. Saves the cache if it has changed. */
+    ~PluginScanCache();
+
+    //==============================================================================
+    /** Returns the plugins found in a binary the last time it was scanned, if it
+        hasn't changed since then. Identifiers that aren't files are never cached.
+    */
+    std::optional<juce::Array<juce::PluginDescription>> find (const juce::AudioPluginFormat&,
+                                                              const juce::String& fileOrIdentifier);
+
+    /** Stores the plugins found in a binary. */
+    void add (const juce::AudioPluginFormat&, const juce::String& fileOrIdentifier,
+              const juce::Array<juce::PluginDescription>&);
+
+    /** Removes all the entries, so every binary will be scanned again. */
+    void clear();
+
+    /** Returns the number of binaries the cache has results for. */
+    int getNumEntries();
+
+    /** Writes the cache to disk if it has changed, returning true if it succeeded. */
+    bool save();
+
+    /** Returns a value that changes whenever a binary does, or nullopt if the
+        identifier isn't a file or bundle.
+    */
+    static std::optional<HashCode> getFingerprint (const juce::String& fileOrIdentifier);
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        HashCode fingerprint = 0;
+        juce::Array<juce::PluginDescription> types;
+    };
+
+    const juce::File cacheFile;
+    std::mutex mutex;
+    std::map<juce::String, Entry> entries;
+    bool isDirty = false;
+
+    void load();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginScanCache)
+};
+
+}} // namespace tracktion { inline namespace engine
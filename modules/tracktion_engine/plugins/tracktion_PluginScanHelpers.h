@@ -271,15 +271,49 @@ struct CustomScanner  : public juce::KnownPluginList::CustomScanner
                              const juce::String& fileOrIdentifier) override
     {
         CRASH_TRACER
+        auto cache = engine.getPluginManager().getScanCache();
 
+        if (cache != nullptr)
+        {
+            if (auto types = cache->find (format, fileOrIdentifier))
+            {
+                for (auto& desc : *types)
+                {
+                    auto newDesc = new juce::PluginDescription (desc);
+                    newDesc->lastInfoUpdateTime = juce::Time::getCurrentTime();
+                    result.add (newDesc);
+                }
+
+                return true;
+            }
+        }
+
+        if (! scan (format, result, fileOrIdentifier))
+            return false;
+
+        if (cache != nullptr)
+        {
+            juce::Array<juce::PluginDescription> types;
+
+            for (auto desc : result)
+                types.add (*desc);
+
+            cache->add (format, fileOrIdentifier, types);
+        }
+
+        return true;
+    }
+
+    bool scan (juce::AudioPluginFormat& format,
+               juce::OwnedArray<juce::PluginDescription>& result,
+               const juce::String& fileOrIdentifier)
+    {
         if (engine.getPluginManager().usesSeparateProcessForScanning()
             && shouldUseSeparateProcessToScan (format, fileOrIdentifier))
         {
-            if (masterProcess != nullptr && masterProcess->crashed)
-                masterProcess = nullptr;
-
-            if (masterProcess == nullptr)
-                masterProcess = std::make_unique<PluginScanMasterProcess> (engine);
+            // Each thread that's scanning uses its own child process, so a crash
+            // only loses the binary that was being scanned in it
+            auto masterProcess = takeMasterProcess();
 
             if (masterProcess->ensureChildProcessLaunched())
             {
@@ -290,35 +324,66 @@ struct CustomScanner  : public juce::KnownPluginList::CustomScanner
                      && ! shouldAbortScan())
                 {
                     if (masterProcess->waitForReply (requestID, fileOrIdentifier, result, *this))
+                    {
+                        returnMasterProcess (std::move (masterProcess));
                         return true;
+                    }
 
                     // if there's a crash, give it a second chance with a fresh child process,
                     // in case the real culprit was whatever plugin preceded this one.
-                    if (masterProcess != nullptr && masterProcess->crashed && ! shouldAbortScan())
+                    if (masterProcess->crashed && ! shouldAbortScan())
                     {
-                        masterProcess.reset();
                         masterProcess = std::make_unique<PluginScanMasterProcess> (engine);
 
-                        return masterProcess->ensureChildProcessLaunched()
-                                 && ! shouldAbortScan()
-                                 && masterProcess->sendScanRequest (format, fileOrIdentifier, requestID)
-                                 && ! shouldAbortScan()
-                                 && masterProcess->waitForReply (requestID, fileOrIdentifier, result, *this);
+                        if (masterProcess->ensureChildProcessLaunched()
+                             && ! shouldAbortScan()
+                             && masterProcess->sendScanRequest (format, fileOrIdentifier, requestID)
+                             && ! shouldAbortScan()
+                             && masterProcess->waitForReply (requestID, fileOrIdentifier, result, *this))
+                        {
+                            returnMasterProcess (std::move (masterProcess));
+                            return true;
+                        }
                     }
                 }
 
+                returnMasterProcess (std::move (masterProcess));
                 return false;
             }
 
             // panic! Can't run the child for some reason, so just do it here..
             TRACKTION_LOG_ERROR ("Falling back to scanning in main process..");
-            masterProcess.reset();
         }
 
         format.findAllTypesForFile (result, fileOrIdentifier);
         return true;
     }
 
+    std::unique_ptr<PluginScanMasterProcess> takeMasterProcess()
+    {
+        {
+            const std::scoped_lock sl (processLock);
+
+            if (! idleProcesses.empty())
+            {
+                auto p = std::move (idleProcesses.back());
+                idleProcesses.pop_back();
+                return p;
+            }
+        }
+
+        return std::make_unique<PluginScanMasterProcess> (engine);
+    }
+
+    void returnMasterProcess (std::unique_ptr<PluginScanMasterProcess> p)
+    {
+        if (p->crashed || ! p->launched)
+            return;
+
+        const std::scoped_lock sl (processLock);
+        idleProcesses.push_back (std::move (p));
+    }
+
     static bool shouldUseSeparateProcessToScan (juce::AudioPluginFormat& format, const juce::String fileOrIdentifier)
     {
         auto name = format.getName();
@@ -344,7 +409,14 @@ struct CustomScanner  : public juce::KnownPluginList::CustomScanner
     {
         TRACKTION_LOG ("----- Ended Plugin Scan");
         abortScan = false;
-        masterProcess.reset();
+
+        {
+            const std::scoped_lock sl (processLock);
+            idleProcesses.clear();
+        }
+
+        if (auto cache = engine.getPluginManager().getScanCache())
+            cache->save();
 
         if (auto callback = engine.getPluginManager().scanCompletedCallback)
             callback();
@@ -361,7 +433,8 @@ struct CustomScanner  : public juce::KnownPluginList::CustomScanner
     }
 
     Engine& engine;
-    std::unique_ptr<PluginScanMasterProcess> masterProcess;
+    std::mutex processLock;
+    std::vector<std::unique_ptr<PluginScanMasterProcess>> idleProcesses;
     std::atomic<bool> abortScan { false };
 };
 
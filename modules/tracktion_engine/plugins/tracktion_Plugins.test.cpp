@@ -404,6 +404,36 @@ TEST_SUITE ("tracktion_engine")
         }
     }
 
+    TEST_CASE ("Automation values for a block")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1);
+        auto volParam = getAudioTracks(*edit)[0]->getVolumePlugin()->volParam;
+        auto& volCurve = volParam->getCurve();
+
+        // Linear, curved and steep curved segments
+        volCurve.addPoint (1_tp, 0.0f, 0.0f, nullptr);
+        volCurve.addPoint (2_tp, 1.0f, 0.3f, nullptr);
+        volCurve.addPoint (3_tp, 0.2f, 0.8f, nullptr);
+        volCurve.addPoint (4_tp, 0.6f, 0.0f, nullptr);
+
+        AutomationIterator iter (*volParam);
+        constexpr int numValues = 1000;
+        std::vector<float> values (numValues);
+
+        for (auto range : { TimeRange (0_tp, 5_tp), TimeRange (1.5_tp, 1.6_tp), TimeRange (3_tp, 3_tp) })
+        {
+            iter.getValues (range, values.data(), numValues);
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                AutomationIterator expected (*volParam);
+                expected.setPosition (range.getStart() + range.getLength() * (i / (double) numValues));
+                CHECK (values[(size_t) i] == doctest::Approx (expected.getCurrentValue()).epsilon (0.0001));
+            }
+        }
+    }
+
     TEST_CASE ("Automation active")
     {
         auto& engine = *Engine::getEngines()[0];
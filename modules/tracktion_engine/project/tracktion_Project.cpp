@@ -79,6 +79,8 @@ void Project::load()
                 if (o.fileOffset > 0 && o.itemID != 0)
                     objects.add (o);
             }
+
+            objectIndexes.clear();
         }
     }
     else
@@ -103,7 +105,10 @@ bool Project::readProjectHeader (juce::InputStream& in, bool clearObjectInfo)
     CRASH_TRACER
 
     if (clearObjectInfo)
+    {
         objects.clear();
+        objectIndexes.clear();
+    }
 
     char n[4] = { 0 };
     in.read (n, 4);
@@ -363,6 +368,19 @@ void Project::createNewProjectId()
 
     projectId = newID;
     hasChanged = true;
+    projectManager.invalidateProjectIndex();
+}
+
+int Project::readProjectIDFromFile (const juce::File& f)
+{
+    // Only the start of the file is mapped, so this is cheap even for big projects
+    const juce::MemoryMappedFile mappedFile (f, { 0, 8 }, juce::MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() != nullptr && mappedFile.getSize() >= 8
+         && strncmp (static_cast<const char*> (mappedFile.getData()), magicNumberV1, 4) == 0)
+        return (int) juce::ByteOrder::littleEndianInt (juce::addBytesToPointer (mappedFile.getData(), 4));
+
+    return 0;
 }
 
 void Project::redirectIDsFromProject (int oldProjId, int newProjId)
@@ -504,11 +522,14 @@ int Project::getIndexOf (ProjectItemID mo) const
 
     if (mo.getProjectID() == getProjectID())
     {
-        auto itemID = mo.getItemID();
+        if (objectIndexes.empty())
+            for (int i = objects.size(); --i >= 0;)
+                objectIndexes.emplace (objects.getReference(i).itemID, i);
 
-        for (int i = objects.size(); --i >= 0;)
-            if (objects.getReference(i).itemID == itemID)
-                return i;
+        auto found = objectIndexes.find (mo.getItemID());
+
+        if (found != objectIndexes.end())
+            return found->second;
     }
 
     return -1;
@@ -523,6 +544,7 @@ void Project::moveProjectItem (int indexToMoveFrom, int indexToMoveTo)
         if (indexToMoveFrom >= 0 && indexToMoveFrom < objects.size())
         {
             objects.move (indexToMoveFrom, juce::jlimit (0, objects.size(), indexToMoveTo));
+            objectIndexes.clear();
             changed();
         }
     }
@@ -556,6 +578,8 @@ ProjectItem::Ptr Project::createNewItem (const juce::File& fileToReference,
                 objects.insert (0, o);
             else
                 objects.add (o);
+
+            objectIndexes.clear();
         }
 
         o.item->setSourceFile (fileToReference);
@@ -584,6 +608,7 @@ ProjectItem::Ptr Project::quickAddProjectItem (const juce::String& relPathName,
     {
         const juce::ScopedLock sl (objectLock);
         objects.add (o);
+        objectIndexes.clear();
     }
 
     changed();
@@ -614,6 +639,7 @@ bool Project::removeProjectItem (ProjectItemID item, bool deleteSourceMaterial)
                 }
 
                 objects.remove (index);
+                objectIndexes.clear();
             }
         }
 
@@ -54,6 +54,11 @@ public:
 
     void createNewProjectId();
 
+    /** Reads just the project ID from a project file's header, without opening it
+        as a Project. Returns 0 if the file isn't a valid project file.
+    */
+    static int readProjectIDFromFile (const juce::File&);
+
     juce::String getProjectProperty (const juce::String& name) const;
     void setProjectProperty (const juce::String& name, const juce::String& value);
 
@@ -163,6 +168,7 @@ private:
     };
 
     juce::Array<ObjectInfo> objects;
+    mutable std::unordered_map<int, int> objectIndexes; // item ID to index in objects, built lazily
     int objectOffset = 0, indexOffset = 0;
     bool readOnly = false, hasChanged = false, temporary = false;
 
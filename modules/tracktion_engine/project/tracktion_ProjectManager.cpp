@@ -14,11 +14,13 @@ namespace tracktion { inline namespace engine
 ProjectManager::ProjectManager (Engine& e)
     : engine (e)
 {
+    folders.addListener (this);
 }
 
 ProjectManager::~ProjectManager()
 {
     CRASH_TRACER
+    folders.removeListener (this);
     folders = {};
     jassert (openProjects.isEmpty());
 }
@@ -174,9 +176,16 @@ Project::Ptr ProjectManager::findProjectWithId (const juce::ValueTree& folder, i
 Project::Ptr ProjectManager::findProjectWithFile (const juce::ValueTree& folder,
                                                   const juce::File& f)
 {
-    if (auto p = getProjectFrom (folder))
+    if (auto p = getProjectFrom (folder, false))
+    {
         if (p->getProjectFile() == f)
             return p;
+    }
+    else if (folder.hasType (IDs::PROJECT) && juce::File (folder[IDs::file]) == f)
+    {
+        if (auto newProject = getProjectFrom (folder))
+            return newProject;
+    }
 
     for (int i = 0; i < folder.getNumChildren(); ++i)
         if (auto p = findProjectWithFile (folder.getChild (i), f))
@@ -225,7 +234,19 @@ Project::Ptr ProjectManager::getProject (int pid)
         if (p->getProjectID() == pid)
             return p;
 
-    return findProjectWithId (folders, pid);
+    if (pid == 0)
+        return {};
+
+    auto f = findIndexedProjectFile (pid);
+
+    if (f == juce::File())
+        return {};
+
+    if (auto p = findProjectWithFile (folders, f))
+        if (p->getProjectID() == pid)
+            return p;
+
+    return {};
 }
 
 Project::Ptr ProjectManager::getProject (const juce::File& f)
@@ -239,6 +260,82 @@ Project::Ptr ProjectManager::getProject (const juce::File& f)
     return findProjectWithFile (folders, f);
 }
 
+//==============================================================================
+static void addToProjectIndex (ProjectManager& pm, const juce::ValueTree& folder,
+                               std::unordered_map<int, juce::File>& index)
+{
+    if (folder.hasType (IDs::PROJECT))
+    {
+        const juce::File f (folder[IDs::file]);
+
+        // Projects that are already open might have a new ID that hasn't been saved yet
+        if (auto p = pm.getProjectFrom (folder, false))
+            index.emplace (p->getProjectID(), f);
+        else if (auto pid = Project::readProjectIDFromFile (f); pid != 0)
+            index.emplace (pid, f);
+    }
+
+    for (int i = 0; i < folder.getNumChildren(); ++i)
+        addToProjectIndex (pm, folder.getChild (i), index);
+}
+
+juce::File ProjectManager::findIndexedProjectFile (int pid)
+{
+    const juce::ScopedLock sl (lock);
+
+    if (projectIndexNeedsRebuilding)
+    {
+        CRASH_TRACER
+        std::unordered_map<int, juce::File> files;
+        addToProjectIndex (*this, folders, files);
+
+        projectIndex.clear();
+
+        for (auto& [id, f] : files)
+            projectIndex[id] = { f, f.getLastModificationTime() };
+
+        projectIndexNeedsRebuilding = false;
+    }
+
+    auto found = projectIndex.find (pid);
+
+    if (found == projectIndex.end())
+        return {};
+
+    auto& indexed = found->second;
+    auto lastModified = indexed.file.getLastModificationTime();
+
+    // If the file has changed since it was indexed, it may now be a different project
+    if (lastModified != indexed.lastModified)
+    {
+        if (Project::readProjectIDFromFile (indexed.file) != pid)
+        {
+            invalidateProjectIndex();
+            return findIndexedProjectFile (pid);
+        }
+
+        indexed.lastModified = lastModified;
+    }
+
+    return indexed.file;
+}
+
+void ProjectManager::invalidateProjectIndex()
+{
+    const juce::ScopedLock sl (lock);
+    projectIndexNeedsRebuilding = true;
+}
+
+void ProjectManager::valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier& i)
+{
+    if (i == IDs::file)
+        invalidateProjectIndex();
+}
+
+void ProjectManager::valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&)          { invalidateProjectIndex(); }
+void ProjectManager::valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int)   { invalidateProjectIndex(); }
+void ProjectManager::valueTreeRedirected (juce::ValueTree&)                            { invalidateProjectIndex(); }
+
 //==============================================================================
 Project::Ptr ProjectManager::addProjectToList (const juce::File& f,
                                                bool shouldSaveList,
@@ -256,8 +353,11 @@ Project::Ptr ProjectManager::addProjectToList (const juce::File& f,
 
         if (p->isValid())
         {
-            if (auto existing = findProjectWithId (folders, p->getProjectID()))
-                return existing;
+            auto existingFile = findIndexedProjectFile (p->getProjectID());
+
+            if (existingFile != juce::File() && existingFile != f)
+                if (auto existing = findProjectWithFile (folders, existingFile))
+                    return existing;
 
             auto v = createValueTree (IDs::PROJECT,
                                       IDs::file, f.getFullPathName());
@@ -11,7 +11,7 @@
 namespace tracktion { inline namespace engine
 {
 
-class ProjectManager
+class ProjectManager  : private juce::ValueTree::Listener
 {
 public:
     //==============================================================================
@@ -79,6 +79,8 @@ public:
     Project::Ptr createNewProjectFromTemplate (const juce::String& suggestedName, const juce::File& lastPath, const juce::File& templateArchiveFile, juce::ValueTree folderToAddTo);
 
     Project::Ptr findProjectWithId (const juce::ValueTree& folder, int pid);
+
+    /** Finds the project in a folder for a file. Only the project that matches is opened. */
     Project::Ptr findProjectWithFile (const juce::ValueTree& folder, const juce::File&);
 
     //==============================================================================
@@ -118,6 +120,26 @@ private:
     juce::CriticalSection lock;
     juce::Array<Project*, juce::CriticalSection> openProjects;
 
+    // An index of project ID to the project's file, so looking up a project that
+    // isn't open yet doesn't have to open all the others to find it.
+    // This is built lazily and rebuilt when the folders or any project IDs change.
+    struct IndexedProject
+    {
+        juce::File file;
+        juce::Time lastModified;
+    };
+
+    std::unordered_map<int, IndexedProject> projectIndex;
+    bool projectIndexNeedsRebuilding = true;
+
+    void invalidateProjectIndex();
+    juce::File findIndexedProjectFile (int projectID);
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeRedirected (juce::ValueTree&) override;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProjectManager)
 };
 
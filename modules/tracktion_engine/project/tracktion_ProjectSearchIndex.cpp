@@ -11,50 +11,88 @@
 namespace tracktion { inline namespace engine
 {
 
-struct IndexedWord
+namespace search_index
 {
-    juce::String word;
-    std::vector<int> ids;
-
-    IndexedWord (juce::InputStream& in)  : word (in.readString())
+    // The index is a header, a table of { term offset, postings offset, num IDs } for
+    // each term in sorted order, the null-terminated UTF-8 terms and then the postings,
+    // which are the sorted item IDs stored as variable-length deltas
+    static constexpr int magic = 0x58444e49; // "INDX"
+    static constexpr int version = 1;
+    static constexpr int headerSize = 20;
+    static constexpr int tableEntrySize = 12;
+
+    static void writeVarInt (juce::OutputStream& out, uint32_t v)
     {
-        auto numIDs = in.readShort();
-        ids.resize ((size_t) numIDs);
-        in.read (ids.data(), (int) sizeof (int) * numIDs);
+        while (v >= 0x80)
+        {
+            out.writeByte ((char) ((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+
+        out.writeByte ((char) v);
     }
 
-    IndexedWord (const juce::String& w, int id) : word (w)
+    /** Reads a value, returning false if it runs past the end or is too long. */
+    static bool readVarInt (const uint8_t*& p, const uint8_t* end, uint32_t& v)
     {
-        ids.push_back (id);
+        v = 0;
+
+        for (int shift = 0; shift < 35 && p < end; shift += 7)
+        {
+            auto b = *p++;
+            v |= (uint32_t) (b & 0x7f) << shift;
+
+            if ((b & 0x80) == 0)
+                return true;
+        }
+
+        return false;
     }
 
-    void writeToStream (juce::OutputStream& out)
+    static int readInt (const char* p)
     {
-        out.writeString (word);
-        out.writeShort ((short) ids.size());
-        out.write (ids.data(), ids.size() * sizeof (int));
+        return (int) juce::ByteOrder::littleEndianInt (p);
     }
 
-    void addID (int id)
+    static juce::Array<int> toArray (const std::vector<int>& v)
     {
-        for (auto i : ids)
-            if (i == id)
-                return;
+        return juce::Array<int> (v.data(), (int) v.size());
+    }
 
-        if (ids.size() > 32766)
-            return;
+    static juce::Array<int> getUnion (const juce::Array<int>& a, const juce::Array<int>& b)
+    {
+        std::vector<int> result;
+        result.reserve ((size_t) (a.size() + b.size()));
+        std::set_union (a.begin(), a.end(), b.begin(), b.end(), std::back_inserter (result));
+        return toArray (result);
+    }
 
-        ids.push_back (id);
+    static juce::Array<int> getIntersection (const juce::Array<int>& a, const juce::Array<int>& b)
+    {
+        std::vector<int> result;
+        result.reserve ((size_t) std::min (a.size(), b.size()));
+        std::set_intersection (a.begin(), a.end(), b.begin(), b.end(), std::back_inserter (result));
+        return toArray (result);
     }
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IndexedWord)
-};
+    static juce::Array<int> getDifference (const juce::Array<int>& a, const juce::Array<int>& b)
+    {
+        std::vector<int> result;
+        result.reserve ((size_t) a.size());
+        std::set_difference (a.begin(), a.end(), b.begin(), b.end(), std::back_inserter (result));
+        return toArray (result);
+    }
+}
 
 //==============================================================================
 ProjectSearchIndex::ProjectSearchIndex (Project& p) : project (p)
 {
 }
 
+ProjectSearchIndex::~ProjectSearchIndex()
+{
+}
+
 static bool isNoiseWord (const juce::String& word)
 {
     return     word == "a"
@@ -95,66 +133,227 @@ void ProjectSearchIndex::addClip (const ProjectItem::Ptr& item)
             auto word = newWord.toLowerCase().retainCharacters ("abcdefghijklmnopqrstuvwxyz0123456789");
 
             if (! (word.isEmpty() || isNoiseWord (word)))
-            {
-                if (auto w = findWordMatch (word))
-                {
-                    w->addID (item->getID().getItemID());
-                }
-                else
-                {
-                    index.add (new IndexedWord (word, item->getID().getItemID()));
-
-                    std::sort (index.begin(), index.end(),
-                               [] (IndexedWord* a, IndexedWord* b) { return a->word < b->word; });
-                }
-            }
+                addedWords[word].push_back (item->getID().getItemID());
         }
     }
 }
 
 void ProjectSearchIndex::writeToStream (juce::OutputStream& out)
 {
-    out.writeInt (index.size());
+    using namespace search_index;
 
-    for (auto&& i : index)
-        i->writeToStream (out);
+    // Merge in anything that was read so the whole index is written
+    for (int i = 0; i < numTerms; ++i)
+        if (auto term = getTerm (i); *term != 0)
+            addPostings (i, addedWords[juce::String::fromUTF8 (term)]);
+
+    juce::MemoryOutputStream table, terms, postings;
+
+    for (auto& [word, ids] : addedWords)
+    {
+        std::sort (ids.begin(), ids.end());
+        ids.erase (std::unique (ids.begin(), ids.end()), ids.end());
+
+        table.writeInt ((int) terms.getDataSize());
+        table.writeInt ((int) postings.getDataSize());
+        table.writeInt ((int) ids.size());
+
+        terms.write (word.toRawUTF8(), word.getNumBytesAsUTF8() + 1);
+
+        int lastID = 0;
+
+        for (auto id : ids)
+        {
+            writeVarInt (postings, (uint32_t) (id - lastID));
+            lastID = id;
+        }
+    }
+
+    out.writeInt (magic);
+    out.writeInt (version);
+    out.writeInt ((int) addedWords.size());
+    out.writeInt ((int) terms.getDataSize());
+    out.writeInt ((int) postings.getDataSize());
+    out << table.getMemoryBlock() << terms.getMemoryBlock() << postings.getMemoryBlock();
 }
 
 void ProjectSearchIndex::readFromStream (juce::InputStream& in)
 {
-    index.clear();
+    using namespace search_index;
+
+    addedWords.clear();
+    mappedFile.reset();
+    loadedData.reset();
+    data = nullptr;
+    numTerms = termsSize = postingsSize = 0;
+
+    const auto startPos = in.getPosition();
+    const auto firstInt = in.readInt();
+
+    if (firstInt != magic)
+    {
+        // Older projects store a count followed by each word and its IDs
+        for (int i = firstInt; --i >= 0 && ! in.isExhausted();)
+        {
+            auto& ids = addedWords[in.readString()];
+
+            for (int j = in.readShort(); --j >= 0 && ! in.isExhausted();)
+                ids.push_back (in.readInt());
+        }
+
+        return;
+    }
+
+    if (in.readInt() != version)
+        return;
+
+    const auto numTermsToRead = in.readInt();
+    const auto termsSizeToRead = in.readInt();
+    const auto postingsSizeToRead = in.readInt();
+
+    if (numTermsToRead < 0 || termsSizeToRead < 0 || postingsSizeToRead < 0)
+        return;
+
+    const auto totalSize = (int64_t) headerSize + (int64_t) numTermsToRead * tableEntrySize + termsSizeToRead + postingsSizeToRead;
+
+    // The offsets into the index are ints so anything bigger must be corrupt
+    if (totalSize > std::numeric_limits<int>::max())
+        return;
+
+    const juce::Range<juce::int64> range (startPos, startPos + totalSize);
+
+    // Map the index if it's in a file, otherwise it has to be read
+    if (auto fileStream = dynamic_cast<juce::FileInputStream*> (&in))
+    {
+        auto mf = std::make_unique<juce::MemoryMappedFile> (fileStream->getFile(), range, juce::MemoryMappedFile::readOnly);
+
+        if (mf->getData() != nullptr && mf->getRange().contains (range))
+        {
+            data = static_cast<const char*> (mf->getData()) + (startPos - mf->getRange().getStart());
+            mappedFile = std::move (mf);
+        }
+    }
+
+    if (data == nullptr)
+    {
+        in.setPosition (startPos);
+
+        if (in.readIntoMemoryBlock (loadedData, (ssize_t) totalSize) != (size_t) totalSize)
+            return;
+
+        data = static_cast<const char*> (loadedData.getData());
+    }
+
+    numTerms = numTermsToRead;
+    termsSize = termsSizeToRead;
+    postingsSize = postingsSizeToRead;
+    in.setPosition (startPos + totalSize);
+}
+
+const char* ProjectSearchIndex::getTerm (int index) const
+{
+    using namespace search_index;
+    jassert (juce::isPositiveAndBelow (index, numTerms));
+
+    const auto terms = data + headerSize + numTerms * tableEntrySize;
+    const auto offset = readInt (data + headerSize + index * tableEntrySize);
 
-    for (int i = in.readInt(); --i >= 0;)
-        index.add (new IndexedWord (in));
+    // A corrupt index could point anywhere so only use terms that are terminated within the terms section
+    if (! juce::isPositiveAndBelow (offset, termsSize)
+         || std::memchr (terms + offset, 0, (size_t) (termsSize - offset)) == nullptr)
+        return "";
+
+    return terms + offset;
 }
 
-IndexedWord* ProjectSearchIndex::findWordMatch (const juce::String& word) const
+void ProjectSearchIndex::addPostings (int index, std::vector<int>& ids) const
 {
-    int start = 0;
-    int end = index.size();
+    using namespace search_index;
+    jassert (juce::isPositiveAndBelow (index, numTerms));
+
+    const auto entry = data + headerSize + index * tableEntrySize;
+    const auto offset = readInt (entry + 4);
+    const auto numIDs = readInt (entry + 8);
 
-    for (;;)
+    // Each ID takes at least a byte so there can't be more than there are bytes left
+    if (offset < 0 || offset > postingsSize || numIDs < 0 || numIDs > postingsSize - offset)
+        return;
+
+    const auto postings = reinterpret_cast<const uint8_t*> (data + headerSize + numTerms * tableEntrySize + termsSize);
+    const auto postingsEnd = postings + postingsSize;
+    const auto numIDsBefore = ids.size();
+    auto p = postings + offset;
+    int64_t id = 0;
+
+    for (int i = numIDs; --i >= 0;)
     {
-        if (start >= end)
-            break;
+        uint32_t delta;
+        const bool isValid = readVarInt (p, postingsEnd, delta);
+        id += delta;
 
-        auto w = index.getUnchecked (start);
+        if (! isValid || id > std::numeric_limits<int>::max())
+        {
+            // Don't return any IDs from a corrupt list
+            ids.resize (numIDsBefore);
+            return;
+        }
 
-        if (word == w->word)
-            return w;
+        ids.push_back ((int) id);
+    }
+}
 
-        const int halfway = (start + end) >> 1;
+int ProjectSearchIndex::findFirstTermNotBefore (const char* word) const
+{
+    int start = 0, end = numTerms;
 
-        if (halfway == start)
-            break;
+    while (start < end)
+    {
+        auto mid = (start + end) / 2;
 
-        if (word.compare (index[halfway]->word) >= 0)
-            start = halfway;
+        if (std::strcmp (getTerm (mid), word) < 0)
+            start = mid + 1;
         else
-            end = halfway;
+            end = mid;
     }
 
-    return {};
+    return start;
+}
+
+juce::Array<int> ProjectSearchIndex::findWordMatches (const juce::String& word) const
+{
+    std::vector<int> ids;
+
+    if (auto w = addedWords.find (word); w != addedWords.end())
+        ids = w->second;
+
+    auto utf8 = word.toRawUTF8();
+
+    if (auto index = findFirstTermNotBefore (utf8); index < numTerms && std::strcmp (getTerm (index), utf8) == 0)
+        addPostings (index, ids);
+
+    std::sort (ids.begin(), ids.end());
+    ids.erase (std::unique (ids.begin(), ids.end()), ids.end());
+    return search_index::toArray (ids);
+}
+
+juce::Array<int> ProjectSearchIndex::findPrefixMatches (const juce::String& prefix) const
+{
+    std::vector<int> ids;
+
+    for (auto w = addedWords.lower_bound (prefix); w != addedWords.end() && w->first.startsWith (prefix); ++w)
+        ids.insert (ids.end(), w->second.begin(), w->second.end());
+
+    auto utf8 = prefix.toRawUTF8();
+    auto prefixLength = std::strlen (utf8);
+
+    for (auto index = findFirstTermNotBefore (utf8);
+         index < numTerms && std::strncmp (getTerm (index), utf8, prefixLength) == 0;
+         ++index)
+        addPostings (index, ids);
+
+    std::sort (ids.begin(), ids.end());
+    ids.erase (std::unique (ids.begin(), ids.end()), ids.end());
+    return search_index::toArray (ids);
 }
 
 void ProjectSearchIndex::findMatches (SearchOperation& search, juce::Array<ProjectItemID>& results)
@@ -180,16 +379,22 @@ struct WordMatchOperation : public SearchOperation
 
     juce::Array<int> getMatches (ProjectSearchIndex& psi) override
     {
-        juce::Array<int> found;
+        return psi.findWordMatches (word);
+    }
 
-        if (auto w = psi.findWordMatch (word))
-            for (auto id : w->ids)
-                found.add (id);
+    juce::String word;
+};
+
+struct PrefixMatchOperation : public SearchOperation
+{
+    PrefixMatchOperation (const juce::String& p) : prefix (p.toLowerCase().trim()) {}
 
-        return found;
+    juce::Array<int> getMatches (ProjectSearchIndex& psi) override
+    {
+        return psi.findPrefixMatches (prefix);
     }
 
-    juce::String word;
+    juce::String prefix;
 };
 
 struct OrOperation : public SearchOperation
@@ -207,10 +412,7 @@ struct OrOperation : public SearchOperation
         if (i2.isEmpty())
             return i1;
 
-        for (int i = i2.size(); --i >= 0;)
-            i1.addIfNotAlreadyThere (i2[i]);
-
-        return i1;
+        return search_index::getUnion (i1, i2);
     }
 };
 
@@ -230,8 +432,7 @@ struct AndOperation : public SearchOperation
         if (i2.isEmpty())
             return i2;
 
-        i1.removeValuesNotIn (i2);
-        return i1;
+        return search_index::getIntersection (i1, i2);
     }
 };
 
@@ -241,12 +442,10 @@ struct NotOperation : public SearchOperation
 
     juce::Array<int> getMatches (ProjectSearchIndex& psi)
     {
-        juce::Array<int> i1;
-
-        i1 = psi.project.getAllItemIDs();
-        i1.removeValuesIn (in1->getMatches (psi));
+        auto i1 = psi.project.getAllItemIDs();
+        i1.sort();
 
-        return i1;
+        return search_index::getDifference (i1, in1->getMatches (psi));
     }
 };
 
@@ -261,6 +460,9 @@ struct FalseOperation  : public SearchOperation
 //==============================================================================
 inline SearchOperation* createPluralOptions (juce::String s)
 {
+    if (s.endsWithChar ('*'))
+        return new PrefixMatchOperation (s.trimCharactersAtEnd ("*"));
+
     SearchOperation* c = new WordMatchOperation (s);
 
     if (s.length() > 2 && ! (s.endsWith ("a") || s.endsWith ("i") || s.endsWith ("u")))
@@ -391,7 +593,7 @@ SearchOperation* createSearchForKeywords (const juce::String& keywords)
     auto k = keywords.toLowerCase()
                 .replace ("-", " " + TRANS("Not") + " ")
                 .replace ("+", " " + TRANS("And") + " ")
-                .retainCharacters (juce::CharPointer_UTF8 ("abcdefghijklmnopqrstuvwxyz0123456789\xc3\xa0\xc3\xa1\xc3\xa2\xc3\xa3\xc3\xa4\xc3\xa5\xc3\xa6\xc3\xa7\xc3\xa8\xc3\xa9\xc3\xaa\xc3\xab\xc3\xac\xc3\xad\xc3\xae\xc3\xaf\xc3\xb0\xc3\xb1\xc3\xb2\xc3\xb3\xc3\xb4\xc3\xb5\xc3\xb6\xc3\xb8\xc3\xb9\xc3\xba\xc3\xbb\xc3\xbc\xc3\xbd\xc3\xbf\xc3\x9f"))
+                .retainCharacters (juce::CharPointer_UTF8 ("abcdefghijklmnopqrstuvwxyz0123456789*\xc3\xa0\xc3\xa1\xc3\xa2\xc3\xa3\xc3\xa4\xc3\xa5\xc3\xa6\xc3\xa7\xc3\xa8\xc3\xa9\xc3\xaa\xc3\xab\xc3\xac\xc3\xad\xc3\xae\xc3\xaf\xc3\xb0\xc3\xb1\xc3\xb2\xc3\xb3\xc3\xb4\xc3\xb5\xc3\xb6\xc3\xb8\xc3\xb9\xc3\xba\xc3\xbb\xc3\xbc\xc3\xbd\xc3\xbf\xc3\x9f"))
                 .trim();
 
     juce::StringArray words;
@@ -11,14 +11,22 @@
 namespace tracktion { inline namespace engine
 {
 
-struct IndexedWord;
 class SearchOperation;
 
 //==============================================================================
+/**
+    An inverted index of the words in a Project's items.
+
+    The index is written as a sorted dictionary of words, each of which refers to
+    a delta-encoded list of the IDs of the items that contain it, so words and
+    prefixes can be found with a binary search. When read from a file, the index
+    is memory-mapped rather than loaded.
+*/
 class ProjectSearchIndex
 {
 public:
     ProjectSearchIndex (Project&);
+    ~ProjectSearchIndex();
 
     void addClip (const ProjectItem::Ptr&);
     void findMatches (SearchOperation&, juce::Array<ProjectItemID>& results);
@@ -26,10 +34,25 @@ public:
     void writeToStream (juce::OutputStream&);
     void readFromStream (juce::InputStream&);
 
-    IndexedWord* findWordMatch (const juce::String& word) const;
+    /** Returns the sorted IDs of the items that contain a word. */
+    juce::Array<int> findWordMatches (const juce::String& word) const;
+
+    /** Returns the sorted IDs of the items that contain a word starting with a prefix. */
+    juce::Array<int> findPrefixMatches (const juce::String& prefix) const;
 
     Project& project;
-    juce::OwnedArray<IndexedWord> index;
+
+private:
+    std::map<juce::String, std::vector<int>> addedWords;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    juce::MemoryBlock loadedData;
+    const char* data = nullptr;
+    int numTerms = 0, termsSize = 0, postingsSize = 0;
+
+    const char* getTerm (int index) const;
+    void addPostings (int index, std::vector<int>&) const;
+    int findFirstTermNotBefore (const char*) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProjectSearchIndex)
 };
@@ -46,6 +69,7 @@ public:
                      SearchOperation* in2 = nullptr);
     virtual ~SearchOperation();
 
+    /** Returns the IDs of the items that match, in ascending order. */
     virtual juce::Array<int> getMatches (ProjectSearchIndex&) = 0;
 
 protected:
@@ -0,0 +1,252 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PROJECT_SEARCH_INDEX
+
+#include "../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+namespace search_index::test
+{
+    inline juce::MemoryBlock write (ProjectSearchIndex& index)
+    {
+        juce::MemoryOutputStream out;
+        index.writeToStream (out);
+        return out.getMemoryBlock();
+    }
+
+    inline void read (ProjectSearchIndex& index, const juce::MemoryBlock& block)
+    {
+        juce::MemoryInputStream in (block, false);
+        index.readFromStream (in);
+    }
+
+    inline juce::Array<int> getMatches (ProjectSearchIndex& index, SearchOperation* search)
+    {
+        return std::unique_ptr<SearchOperation> (search)->getMatches (index);
+    }
+
+    inline juce::Array<int> sorted (std::initializer_list<int> ids)
+    {
+        juce::Array<int> result (ids);
+        result.sort();
+        return result;
+    }
+
+    inline void setInt (juce::MemoryBlock& block, int offset, int value)
+    {
+        for (int i = 0; i < 4; ++i)
+            block[offset + i] = (char) ((uint32_t) value >> (8 * i));
+    }
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("ProjectSearchIndex")
+    {
+        using namespace search_index::test;
+        auto& engine = *Engine::getEngines()[0];
+
+        juce::TemporaryFile tempProjectFile (projectFileSuffix);
+        ProjectManager::TempProject tempProject (engine.getProjectManager(), tempProjectFile.getFile(), true);
+        REQUIRE (tempProject.project);
+        auto& project = *tempProject.project;
+
+        auto createItem = [&] (const juce::String& name, const juce::String& description)
+        {
+            return project.createNewItem (project.getDefaultDirectory().getChildFile (name + ".wav"),
+                                          ProjectItem::waveItemType(), name, description,
+                                          ProjectItem::Category::imported, false);
+        };
+
+        const auto kick = createItem ("Kick drum loop", "punchy");
+        const auto snare = createItem ("Snare drum", "bright");
+        const auto bass = createItem ("Bass line", "punchy synth");
+        const auto pad = createItem ("Synth pad", "warm");
+        REQUIRE (kick);
+        REQUIRE (snare);
+        REQUIRE (bass);
+        REQUIRE (pad);
+
+        const int kickID = kick->getID().getItemID(), snareID = snare->getID().getItemID(),
+                  bassID = bass->getID().getItemID(), padID = pad->getID().getItemID();
+
+        ProjectSearchIndex written (project);
+
+        for (auto& item : { kick, snare, bass, pad })
+            written.addClip (item);
+
+        const auto block = write (written);
+
+        // Checks an index has all the items above, whether it was read or built
+        auto checkQueries = [&] (ProjectSearchIndex& index)
+        {
+            CHECK_EQ (index.findWordMatches ("drum"), sorted ({ kickID, snareID }));
+            CHECK_EQ (index.findWordMatches ("punchy"), sorted ({ kickID, bassID }));
+            CHECK_EQ (index.findWordMatches ("dru"), juce::Array<int>());
+            CHECK_EQ (index.findPrefixMatches ("s"), sorted ({ snareID, bassID, padID }));
+            CHECK_EQ (index.findPrefixMatches ("zz"), juce::Array<int>());
+
+            CHECK_EQ (getMatches (index, new AndOperation (new WordMatchOperation ("drum"), new WordMatchOperation ("punchy"))),
+                      sorted ({ kickID }));
+            CHECK_EQ (getMatches (index, new OrOperation (new WordMatchOperation ("drum"), new WordMatchOperation ("synth"))),
+                      sorted ({ kickID, snareID, bassID, padID }));
+            CHECK_EQ (getMatches (index, new NotOperation (new WordMatchOperation ("drum"))),
+                      sorted ({ bassID, padID }));
+            CHECK_EQ (getMatches (index, new AndOperation (new PrefixMatchOperation ("syn"), new NotOperation (new WordMatchOperation ("warm")))),
+                      sorted ({ bassID }));
+            CHECK_EQ (getMatches (index, createSearchForKeywords ("drum punchy")),
+                      sorted ({ kickID }));
+        };
+
+        checkQueries (written);
+
+        // Read from memory
+        {
+            ProjectSearchIndex index (project);
+            read (index, block);
+            checkQueries (index);
+
+            // Writing a read index should give exactly the same data
+            CHECK (write (index) == block);
+        }
+
+        // Read from a memory-mapped file
+        {
+            juce::TemporaryFile file;
+
+            {
+                juce::FileOutputStream out (file.getFile());
+                out.writeInt (1234);
+                out << block;
+                out.writeInt (5678);
+            }
+
+            ProjectSearchIndex index (project);
+            juce::FileInputStream in (file.getFile());
+            in.setPosition (4);
+            index.readFromStream (in);
+            checkQueries (index);
+
+            // The stream should be left after the index
+            CHECK_EQ (in.readInt(), 5678);
+        }
+
+        // Merges read and added items
+        {
+            const auto lead = createItem ("Lead synth", "bright");
+            REQUIRE (lead);
+            const int leadID = lead->getID().getItemID();
+
+            ProjectSearchIndex index (project);
+            read (index, block);
+            index.addClip (lead);
+            CHECK_EQ (index.findWordMatches ("synth"), sorted ({ bassID, padID, leadID }));
+
+            ProjectSearchIndex merged (project);
+            read (merged, write (index));
+            CHECK_EQ (merged.findWordMatches ("synth"), sorted ({ bassID, padID, leadID }));
+            CHECK_EQ (merged.findWordMatches ("bright"), sorted ({ snareID, leadID }));
+            CHECK_EQ (merged.findWordMatches ("drum"), sorted ({ kickID, snareID }));
+        }
+
+        // Reads the legacy format
+        {
+            juce::MemoryOutputStream out;
+            out.writeInt (3);
+
+            for (auto& [word, ids] : std::vector<std::pair<juce::String, std::vector<int>>> { { "drum", { kickID, snareID } },
+                                                                                               { "punchy", { kickID, bassID } },
+                                                                                               { "synth", { bassID, padID } } })
+            {
+                out.writeString (word);
+                out.writeShort ((short) ids.size());
+
+                for (auto id : ids)
+                    out.writeInt (id);
+            }
+
+            ProjectSearchIndex index (project);
+            read (index, out.getMemoryBlock());
+            CHECK_EQ (index.findWordMatches ("drum"), sorted ({ kickID, snareID }));
+            CHECK_EQ (index.findPrefixMatches ("syn"), sorted ({ bassID, padID }));
+            CHECK_EQ (getMatches (index, new AndOperation (new WordMatchOperation ("punchy"), new NotOperation (new WordMatchOperation ("drum")))),
+                      sorted ({ bassID }));
+
+            // It should be upgraded to the current format when written
+            ProjectSearchIndex upgraded (project);
+            read (upgraded, write (index));
+            CHECK_EQ (upgraded.findWordMatches ("synth"), sorted ({ bassID, padID }));
+        }
+
+        // Ignores corrupt offsets and counts
+        {
+            constexpr int headerSize = 20, tableEntrySize = 12;
+            const auto numTerms = juce::ByteOrder::littleEndianInt (block.begin() + 8);
+            const auto termsSize = (int) juce::ByteOrder::littleEndianInt (block.begin() + 12);
+            const auto postingsSize = (int) juce::ByteOrder::littleEndianInt (block.begin() + 16);
+            REQUIRE (numTerms > 2);
+
+            auto checkCorrupted = [&] (std::function<void (juce::MemoryBlock&)> corrupt)
+            {
+                auto corrupted = block;
+                corrupt (corrupted);
+
+                ProjectSearchIndex index (project);
+                read (index, corrupted);
+
+                // The IDs read might be nonsense but shouldn't come from outside the index
+                for (auto& prefix : { "", "b", "d", "p", "s" })
+                    for (auto id : index.findPrefixMatches (prefix))
+                        CHECK (id >= 0);
+
+                CHECK_NOTHROW (write (index));
+            };
+
+            for (int i = 0; i < (int) numTerms; ++i)
+            {
+                const auto entry = headerSize + i * tableEntrySize;
+
+                for (auto value : { -1, termsSize, termsSize - 1, std::numeric_limits<int>::max() })
+                    checkCorrupted ([&] (auto& b) { setInt (b, entry, value); });
+
+                for (auto value : { -1, postingsSize, postingsSize + 1, std::numeric_limits<int>::max() })
+                    checkCorrupted ([&] (auto& b) { setInt (b, entry + 4, value); });
+
+                for (auto value : { -1, postingsSize, std::numeric_limits<int>::max() })
+                    checkCorrupted ([&] (auto& b) { setInt (b, entry + 8, value); });
+            }
+
+            // Terms that aren't terminated and IDs that run off the end of the postings
+            checkCorrupted ([&] (auto& b) { std::memset (b.begin() + headerSize + (int) numTerms * tableEntrySize, 'a', (size_t) termsSize); });
+            checkCorrupted ([&] (auto& b) { std::memset (b.begin() + (int) b.getSize() - postingsSize, 0xff, (size_t) postingsSize); });
+
+            // Sizes that don't match the data shouldn't be read at all
+            for (auto offset : { 8, 12, 16 })
+            {
+                for (auto value : { -1, 1 << 30, std::numeric_limits<int>::max() })
+                {
+                    auto corrupted = block;
+                    setInt (corrupted, offset, value);
+
+                    ProjectSearchIndex index (project);
+                    read (index, corrupted);
+                    CHECK_EQ (index.findPrefixMatches (""), juce::Array<int>());
+                }
+            }
+        }
+    }
+}
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PROJECT_SEARCH_INDEX
@@ -851,6 +851,10 @@ bool Clipboard::Clips::pasteIntoEdit (const EditPastingOptions& options) const
     std::map<EditItemID, EditItemID> remappedIDs;
     SelectableList itemsAdded;
 
+    // Each track is only notified once all the clips have been pasted into it
+    std::vector<std::unique_ptr<ClipOwner::ScopedBulkChange>> bulkChanges;
+    juce::Array<ClipTrack*> bulkChangeTracks;
+
     for (auto& clip : clips)
     {
         auto newClipState = clip.state.createCopy();
@@ -935,6 +939,9 @@ bool Clipboard::Clips::pasteIntoEdit (const EditPastingOptions& options) const
             }
             else if (auto clipTrack = dynamic_cast<ClipTrack*> (targetTrack->getSiblingTrack (clip.trackOffset, false)))
             {
+                if (bulkChangeTracks.addIfNotAlreadyThere (clipTrack))
+                    bulkChanges.push_back (std::make_unique<ClipOwner::ScopedBulkChange> (*clipTrack));
+
                 if (auto newClip = clipTrack->insertClipWithState (newClipState))
                     itemsAdded.add (newClip);
             }
@@ -945,6 +952,8 @@ bool Clipboard::Clips::pasteIntoEdit (const EditPastingOptions& options) const
         }
     }
 
+    bulkChanges.clear();
+
     std::map<EditItemID, EditItemID> groupMap;
     for (auto c : itemsAdded.getItemsOfType<Clip>())
     {
@@ -1742,10 +1751,13 @@ juce::Array<MidiNote*> Clipboard::MIDIEvents::pasteNotesIntoClip (MidiClip& clip
     if (notes.empty())
         return {};
 
+    // The clipboard content is a snapshot that may be pasted again so it's never modified.
+    // Each note is copied once here and that copy is what gets added to the clip.
     juce::Array<MidiNote> midiNotes;
+    midiNotes.ensureStorageAllocated ((int) notes.size());
 
     for (auto& n : notes)
-        midiNotes.add (MidiNote (n));
+        midiNotes.add (MidiNote (n.createCopy()));
 
     auto beatRange = midiNotes.getReference (0).getRangeBeats();
 
@@ -1789,15 +1801,18 @@ juce::Array<MidiNote*> Clipboard::MIDIEvents::pasteNotesIntoClip (MidiClip& clip
     if (snapBeat != nullptr)
         deltaBeats = toDuration (snapBeat (toPosition (deltaBeats)));
 
+    // Large pastes are stored in the undo history as a single compressed change
     auto& sequence = clip.getSequence();
-    auto um = &clip.edit.getUndoManager();
+    const CompactUndoableChange compactChange (clip.edit, sequence.state, midiNotes.size());
+    auto um = compactChange.getUndoManager();
     juce::Array<MidiNote*> notesAdded;
+    const MidiList::ScopedBulkChange bulkChange (sequence);
 
     for (auto& n : midiNotes)
     {
         n.setStartAndLength (n.getStartBeat() + deltaBeats, n.getLengthBeats(), nullptr);
 
-        if (auto note = sequence.addNote (n, um))
+        if (auto note = sequence.addNoteWithState (n.state, um))
             notesAdded.add (note);
     }
 
@@ -1813,10 +1828,12 @@ juce::Array<MidiControllerEvent*> Clipboard::MIDIEvents::pasteControllersIntoCli
     if (controllers.empty())
         return {};
 
+    // As with notes, these are copies so the clipboard content isn't modified
     juce::Array<MidiControllerEvent> midiEvents;
+    midiEvents.ensureStorageAllocated ((int) controllers.size());
 
     for (auto& e : controllers)
-        midiEvents.add (MidiControllerEvent (e));
+        midiEvents.add (MidiControllerEvent (e.createCopy()));
 
     if (notes.size() > 0)
         destController = -1;
@@ -1904,9 +1921,9 @@ juce::Array<MidiControllerEvent*> Clipboard::MIDIEvents::pasteControllersIntoCli
 
     for (auto& e : midiEvents)
     {
-        e.setBeatPosition (e.getBeatPosition() + deltaBeats, um);
+        e.setBeatPosition (e.getBeatPosition() + deltaBeats, nullptr);
 
-        if (auto evt = sequence.addControllerEvent (e, um))
+        if (auto evt = sequence.addControllerEventWithState (e.state, um))
             eventsAdded.add (evt);
     }
 
@@ -191,6 +191,9 @@ public:
         using ContentType::pasteIntoEdit;
         bool pasteIntoEdit (const EditPastingOptions&) const override;
 
+        /** Copies of the events' states. Pasting never modifies these, it takes its own
+            copy of each event, so the same content can be pasted any number of times.
+        */
         std::vector<juce::ValueTree> notes;
         std::vector<juce::ValueTree> controllers;
 
@@ -30,6 +30,18 @@ struct BeatDetect
 
     template <typename Buffer>
     void audioProcess (const Buffer& buffer)
+    {
+        pushEnergy (getEnergy (buffer));
+    }
+
+    /** Adds the energy of the next block, as returned by getEnergy. */
+    void processBlockEnergy (double blockEnergy)
+    {
+        pushEnergy (blockEnergy);
+    }
+
+    template <typename Buffer>
+    static double getEnergy (const Buffer& buffer)
     {
         double blockEnergy = 0;
         auto size = buffer.getSize();
@@ -46,12 +58,120 @@ struct BeatDetect
             }
         }
 
-        pushEnergy (blockEnergy);
+        return blockEnergy;
     }
 
     SampleCount getBlockSize() const                    { return blockSize; }
     const juce::Array<SampleCount>& getBeats() const    { return beatSamples; }
 
+    //==============================================================================
+    /** Detects the beats in a range of a file, returning their positions relative
+        to the start of the range.
+        The block energies are measured on several threads, each reading its own
+        part of the file, and then the beats are picked from them in order so the
+        result is the same as processing the blocks one by one.
+        The beats are kept in the file's AudioFileInfo so the same range is only
+        ever analysed once.
+    */
+    static juce::Array<SampleCount> detectBeatsInFile (Engine& engine, const juce::File& file,
+                                                       juce::Range<SampleCount> range, float sensitivity)
+    {
+        const AudioFile audioFile (engine, file);
+        const auto analysisKey = "TracktionDetectedBeats_" + juce::String (range.getStart()) + "_"
+                                    + juce::String (range.getEnd()) + "_" + juce::String (sensitivity, 3);
+
+        if (auto storedBeats = audioFile.getInfo().metadata.getValue (analysisKey, {}); storedBeats.isNotEmpty())
+        {
+            juce::Array<SampleCount> beats;
+
+            for (auto& beat : juce::StringArray::fromTokens (storedBeats, false))
+                if (beat != "-")
+                    beats.add (beat.getLargeIntValue());
+
+            return beats;
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, file));
+
+        if (reader == nullptr)
+            return {};
+
+        BeatDetect detect;
+        detect.setSensitivity (sensitivity);
+        detect.setSampleRate (reader->sampleRate);
+
+        const auto blockLength = detect.getBlockSize();
+
+        if (blockLength <= 0)
+            return {};
+
+        const auto numBlocks = (int) std::max ((SampleCount) 0, (range.getLength() - 1) / blockLength);
+        std::vector<double> energies ((size_t) numBlocks, 0.0);
+        std::atomic<int> numBlocksRead { numBlocks };
+
+        // Like reading the blocks in order, the beats stop at the first block that can't be read
+        auto blockFailed = [&numBlocksRead] (int block)
+        {
+            for (int current = numBlocksRead; block < current && ! numBlocksRead.compare_exchange_weak (current, block);)
+            {}
+        };
+
+        auto measureBlocks = [&] (juce::AudioFormatReader& blockReader, int startBlock, int endBlock)
+        {
+            choc::buffer::ChannelArrayBuffer<float> buffer (choc::buffer::Size::create (blockReader.numChannels, blockLength));
+
+            for (int block = startBlock; block < endBlock; ++block)
+            {
+                if (! blockReader.read (buffer.getView().data.channels, (int) blockReader.numChannels,
+                                        range.getStart() + block * blockLength, (int) blockLength))
+                {
+                    blockFailed (block);
+                    return;
+                }
+
+                energies[(size_t) block] = getEnergy (buffer);
+            }
+        };
+
+        // Readers can't be shared between threads so each needs its own
+        constexpr int minBlocksPerThread = 1024;
+        const auto numThreads = juce::jlimit (1, juce::SystemStats::getNumCpus(), numBlocks / minBlocksPerThread);
+        const auto blocksPerThread = (numBlocks + numThreads - 1) / numThreads;
+        std::vector<std::thread> threads;
+
+        for (int i = 1; i < numThreads; ++i)
+        {
+            threads.emplace_back ([&, i]
+                                  {
+                                      const auto startBlock = i * blocksPerThread;
+                                      const auto endBlock = std::min (numBlocks, startBlock + blocksPerThread);
+
+                                      if (std::unique_ptr<juce::AudioFormatReader> threadReader { AudioFileUtils::createReaderFor (engine, file) })
+                                          measureBlocks (*threadReader, startBlock, endBlock);
+                                      else if (startBlock < endBlock)
+                                          blockFailed (startBlock);
+                                  });
+        }
+
+        measureBlocks (*reader, 0, std::min (numBlocks, blocksPerThread));
+
+        for (auto& t : threads)
+            t.join();
+
+        for (int i = 0; i < numBlocksRead; ++i)
+            detect.processBlockEnergy (energies[(size_t) i]);
+
+        // The "-" means an empty result is still stored
+        juce::StringArray beatStrings ("-");
+
+        for (auto beat : detect.getBeats())
+            beatStrings.add (juce::String (beat));
+
+        engine.getAudioFileManager().addAnalysisResult (audioFile, analysisKey, beatStrings.joinIntoString (" "));
+
+        return detect.getBeats();
+    }
+
 private:
     static constexpr int historyLength = 43;
     double energy[historyLength] = {};
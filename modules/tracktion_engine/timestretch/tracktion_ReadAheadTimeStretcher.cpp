@@ -11,88 +11,6 @@
 namespace tracktion::inline engine
 {
 
-//==============================================================================
-//==============================================================================
-ReadAheadTimeStretcher::ProcessThread::ProcessThread()
-{
-    thread = std::thread ([this] { process(); });
-}
-
-ReadAheadTimeStretcher::ProcessThread::~ProcessThread()
-{
-    waitingToExitFlag.test_and_set();
-    event.signal();
-    thread.join();
-}
-
-void ReadAheadTimeStretcher::ProcessThread::addInstance (ReadAheadTimeStretcher* instance)
-{
-    breakForAddRemoveInstance.test_and_set();
-
-    const std::unique_lock sl (instancesMutex);
-    instances.emplace_back (instance);
-
-    breakForAddRemoveInstance.clear();
-}
-
-void ReadAheadTimeStretcher::ProcessThread::removeInstance (ReadAheadTimeStretcher* instance)
-{
-    breakForAddRemoveInstance.test_and_set();
-
-    const std::unique_lock sl (instancesMutex);
-    std::erase_if (instances, [&] (auto& i) { return i == instance; });
-
-    breakForAddRemoveInstance.clear();
-}
-
-void ReadAheadTimeStretcher::ProcessThread::flagForProcessing (std::atomic<std::uint64_t>& epoch)
-{
-    epoch = processEpoch.load (std::memory_order_acquire);
-    event.signal();
-}
-
-//==============================================================================
-void ReadAheadTimeStretcher::ProcessThread::process()
-{
-    for (;;)
-    {
-        if (waitingToExitFlag.test (std::memory_order_acquire))
-            return;
-
-        bool anyInstancesProcessed = false;
-
-        {
-            const std::unique_lock sl (instancesMutex);
-            const auto currentEpoch = processEpoch.load (std::memory_order_acquire);
-
-            for (auto instance : instances)
-            {
-                if (waitingToExitFlag.test (std::memory_order_acquire))
-                    return;
-
-                if (breakForAddRemoveInstance.test (std::memory_order_acquire))
-                {
-                    anyInstancesProcessed = false; // Run again asap
-                    break;
-                }
-
-                // Skip unflagged instances
-                if (instance->getEpoch() > currentEpoch)
-                    continue;
-
-                if (instance->processNextBlock (false))
-                     anyInstancesProcessed = true;
-            }
-        }
-
-        processEpoch.fetch_add (1, std::memory_order_release);
-
-        if (! anyInstancesProcessed)
-            event.wait (-1);
-    }
-}
-
-
 //==============================================================================
 //==============================================================================
 ReadAheadTimeStretcher::ReadAheadTimeStretcher (int numBlocksToReadAhead_)
@@ -102,7 +20,7 @@ ReadAheadTimeStretcher::ReadAheadTimeStretcher (int numBlocksToReadAhead_)
 
 ReadAheadTimeStretcher::~ReadAheadTimeStretcher()
 {
-    processThread->removeInstance (this);
+    workerPool->removeClient (*this);
 }
 
 void ReadAheadTimeStretcher::initialise (double sourceSampleRate, int samplesPerBlock,
@@ -113,6 +31,7 @@ void ReadAheadTimeStretcher::initialise (double sourceSampleRate, int samplesPer
 
     numSamplesPerOutputBlock = samplesPerBlock;
     numChannels = numChannelsToUse;
+    sampleRate = sourceSampleRate;
 
     stretcher.initialise (sourceSampleRate, samplesPerBlock,
                           numChannelsToUse, mode, proOpts,
@@ -121,7 +40,7 @@ void ReadAheadTimeStretcher::initialise (double sourceSampleRate, int samplesPer
     if (! isInitialised())
         return;
 
-    processThread->addInstance (this);
+    workerPool->addClient (*this);
     inputFifo.setSize (numChannels, getMaxFramesNeeded() + 1);
     assert (inputFifo.getFreeSpace() >= getMaxFramesNeeded());
     outputFifo.setSize (numChannels, samplesPerBlock * numBlocksToReadAhead);
@@ -195,7 +114,7 @@ int ReadAheadTimeStretcher::pushData (const float* const* inChannels, int numSam
 {
     assert (inputFifo.getFreeSpace() >= numSamples);
     inputFifo.write (inChannels, numSamples);
-    processThread->flagForProcessing (epoch);
+    workerPool->flagForProcessing (*this);
     hasBeenReset.store (false, std::memory_order_release);
 
     return numSamples;
@@ -212,6 +131,13 @@ int ReadAheadTimeStretcher::popData (float* const* outChannels, int numSamples)
 
     if (outputFifo.getNumReady() <= numSamples)
     {
+        // The workers didn't get to this in time so it has to be processed here
+        if (outputFifo.getNumReady() < numSamples)
+        {
+            numUnderruns.fetch_add (1, std::memory_order_relaxed);
+            totalNumUnderruns.fetch_add (1, std::memory_order_relaxed);
+        }
+
         [[ maybe_unused ]] const int numPopped = processNextBlock (true);
         assert (numPopped > 0 && "Not enough input frames pushed");
     }
@@ -255,6 +181,30 @@ void ReadAheadTimeStretcher::tryToSetNewSpeedAndPitch() const
                                 pendingSemitonesUp.load (std::memory_order_acquire));
 }
 
+bool ReadAheadTimeStretcher::canProcessNextBlock() const
+{
+    return outputFifo.getFreeSpace() >= numSamplesPerOutputBlock
+        && inputFifo.getNumReady() > 0;
+}
+
+double ReadAheadTimeStretcher::getSecondsUntilUnderrun() const
+{
+    return outputFifo.getNumReady() / sampleRate;
+}
+
+std::optional<double> ReadAheadTimeStretcher::getSecondsUntilDeadline()
+{
+    if (! canProcessNextBlock())
+        return {};
+
+    return getSecondsUntilUnderrun();
+}
+
+bool ReadAheadTimeStretcher::processNextChunk()
+{
+    return processNextBlock (false) > 0;
+}
+
 int ReadAheadTimeStretcher::processNextBlock (bool block)
 {
     if (outputFifo.getFreeSpace() < numSamplesPerOutputBlock)
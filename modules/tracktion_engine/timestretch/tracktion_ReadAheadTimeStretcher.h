@@ -17,8 +17,11 @@ namespace tracktion::inline engine
     Wraps a TimeStretcher but keeps a larger internal input and output buffer
     and uses a background thread to try and process frames, reducing CPU cost on
     real-time threads.
+
+    All instances share a DeadlineWorkerPool with the AnticipativeRenderNodes, so
+    the instances whose output buffers will run out soonest are processed first.
  */
-class ReadAheadTimeStretcher
+class ReadAheadTimeStretcher  : private tracktion::graph::DeadlineWorkerPool::Client
 {
 public:
     /** Creates a ReadAheadTimeStretcher that will attempt to process the desired number
@@ -104,50 +107,38 @@ public:
     */
     int flush (float* const* outChannels);
 
-private:
     //==============================================================================
-    class ProcessThread
-    {
-    public:
-        ProcessThread();
-        ~ProcessThread();
-
-        void addInstance (ReadAheadTimeStretcher*);
-        void removeInstance (ReadAheadTimeStretcher*);
-
-        void flagForProcessing (std::atomic<std::uint64_t>&);
-
-    private:
-        //==============================================================================
-        std::vector<ReadAheadTimeStretcher*> instances;
-        std::mutex instancesMutex;
-
-        std::thread thread;
-        juce::WaitableEvent event;
-        std::atomic_flag waitingToExitFlag = ATOMIC_FLAG_INIT;
-        std::atomic_flag breakForAddRemoveInstance = ATOMIC_FLAG_INIT;
-        std::atomic<std::uint64_t> processEpoch { 0 };
+    /** Returns the number of times popData has been called without enough samples
+        having been processed in the background, so had to process on the calling thread.
+    */
+    std::uint64_t getNumUnderruns() const           { return numUnderruns.load (std::memory_order_relaxed); }
 
-        //==============================================================================
-        void process();
-    };
+    /** Returns the total number of underruns across all instances. */
+    static std::uint64_t getTotalNumUnderruns()     { return totalNumUnderruns.load (std::memory_order_relaxed); }
 
+private:
     AudioFifo inputFifo { 1, 32 }, outputFifo { 1, 32 };
     mutable TimeStretcher stretcher;
     const int numBlocksToReadAhead;
     int numChannels = 0, numSamplesPerOutputBlock = 0;
     mutable std::mutex processMutex;
-    std::atomic<std::uint64_t> epoch { std::numeric_limits<std::uint64_t>::max() };
+    double sampleRate = 44100.0;
+    std::atomic<std::uint64_t> numUnderruns { 0 };
+    inline static std::atomic<std::uint64_t> totalNumUnderruns { 0 };
 
     mutable std::atomic<float> pendingSpeedRatio { 1.0f }, pendingSemitonesUp { 0.0f };
     mutable std::atomic<bool> newSpeedAndPitchPending { false }, hasBeenReset { true };
 
-    juce::SharedResourcePointer<ProcessThread> processThread;
+    juce::SharedResourcePointer<tracktion::graph::DeadlineWorkerPool> workerPool;
 
     void tryToSetNewSpeedAndPitch() const;
     int processNextBlock (bool shouldBlock);
-    bool canProcessNextBlock();
-    std::uint64_t getEpoch() const { return epoch.load (std::memory_order_acquire); }
+    bool canProcessNextBlock() const;
+    double getSecondsUntilUnderrun() const;
+
+    //==============================================================================
+    std::optional<double> getSecondsUntilDeadline() override;
+    bool processNextChunk() override;
 };
 
 }
@@ -104,6 +104,103 @@ public:
     bool isBpmSensible() const                      { return getSensibleRange().contains (bpm); }
     static juce::Range<float> getSensibleRange()    { return { 29, 200 }; }
 
+    //==============================================================================
+    /** Detects the tempo of a whole file.
+        Long files are split into overlapping sections which are analysed on
+        separate threads and the tempo most of the sections agree on is returned.
+        The result is kept in the file's AudioFileInfo so a file is only ever
+        analysed once.
+        @param progress     updated with the proportion of the file analysed
+        @param shouldExit   polled during the analysis to stop it early
+        @returns the tempo in BPM or 0 if it couldn't be detected
+    */
+    static float detectTempoOfFile (Engine& engine, const juce::File& file, std::atomic<float>& progress,
+                                    const std::function<bool()>& shouldExit)
+    {
+        const AudioFile audioFile (engine, file);
+        const auto storedBpm = audioFile.getInfo().metadata[analysisKey];
+
+        if (storedBpm.isNotEmpty())
+        {
+            progress = 1.0f;
+            return storedBpm.getFloatValue();
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, file));
+
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+            return 0.0f;
+
+        const auto numSamples = reader->lengthInSamples;
+        const auto sectionLength = (SampleCount) (reader->sampleRate * sectionLengthSeconds);
+        const auto overlap = (SampleCount) (reader->sampleRate * sectionOverlapSeconds);
+
+        // Short files are analysed in one go as before
+        std::vector<juce::Range<SampleCount>> sections;
+
+        if (numSamples < sectionLength * 2)
+            sections.push_back ({ 0, numSamples });
+        else
+            for (SampleCount start = 0; start < numSamples; start += sectionLength)
+                sections.push_back ({ std::max ((SampleCount) 0, start - overlap),
+                                      std::min (numSamples, start + sectionLength) });
+
+        std::vector<float> sectionBpms (sections.size(), 0.0f);
+        std::atomic<SampleCount> samplesDone { 0 };
+        SampleCount totalSamples = 0;
+
+        for (auto section : sections)
+            totalSamples += section.getLength();
+
+        auto processSections = [&] (juce::AudioFormatReader& sectionReader, std::atomic<size_t>& nextSection)
+        {
+            for (;;)
+            {
+                const auto index = nextSection.fetch_add (1);
+
+                if (index >= sections.size())
+                    return;
+
+                sectionBpms[index] = processSectionOfReader (sectionReader, sections[index], shouldExit, [&] (int numDone)
+                                                             {
+                                                                 progress = (float) ((samplesDone += numDone) / (double) totalSamples);
+                                                             });
+            }
+        };
+
+        std::atomic<size_t> nextSection { 0 };
+        const auto numThreads = std::min ((size_t) juce::SystemStats::getNumCpus(), sections.size());
+        std::vector<std::thread> threads;
+
+        // Readers can't be shared between threads so each needs its own
+        for (size_t i = 1; i < numThreads; ++i)
+        {
+            threads.emplace_back ([&]
+                                  {
+                                      if (std::unique_ptr<juce::AudioFormatReader> threadReader { AudioFileUtils::createReaderFor (engine, file) })
+                                          processSections (*threadReader, nextSection);
+                                  });
+        }
+
+        processSections (*reader, nextSection);
+
+        for (auto& t : threads)
+            t.join();
+
+        if (shouldExit())
+            return 0.0f;
+
+        std::vector<std::pair<float, double>> weightedBpms;
+
+        for (size_t i = 0; i < sections.size(); ++i)
+            weightedBpms.emplace_back (sectionBpms[i], (double) sections[i].getLength());
+
+        const auto detectedBpm = getMostCommonTempo (weightedBpms);
+        engine.getAudioFileManager().addAnalysisResult (audioFile, analysisKey, juce::String (detectedBpm));
+
+        return detectedBpm;
+    }
+
     //==============================================================================
     /** Processes a non-interleaved buffer section.  */
     void processSection (juce::AudioBuffer<float>& buffer, int numSamplesToProcess)
@@ -136,6 +233,70 @@ private:
     soundtouch::BPMDetect bpmDetect;
     float bpm = -1.0f;
 
+    static constexpr const char* analysisKey = "TracktionDetectedBpm";
+    static constexpr double sectionLengthSeconds = 60.0, sectionOverlapSeconds = 10.0;
+
+    template<typename ProgressCallback>
+    static float processSectionOfReader (juce::AudioFormatReader& reader, juce::Range<SampleCount> section,
+                                         const std::function<bool()>& shouldExit, ProgressCallback&& samplesProcessed)
+    {
+        const auto numChannels = (int) reader.numChannels;
+        const int blockSize = 65536;
+        const bool useRightChan = numChannels > 1;
+
+        TempoDetect detector (numChannels, reader.sampleRate);
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+
+        for (auto startSample = section.getStart(); startSample < section.getEnd();)
+        {
+            if (shouldExit())
+                return 0.0f;
+
+            auto numThisTime = (int) std::min ((SampleCount) blockSize, section.getEnd() - startSample);
+            reader.read (&buffer, 0, numThisTime, startSample, true, useRightChan);
+            detector.processSection (buffer, numThisTime);
+
+            startSample += numThisTime;
+            samplesProcessed (numThisTime);
+        }
+
+        return detector.finishAndDetect();
+    }
+
+    /** Returns the average of the largest group of tempos within 2% of each
+        other, weighted by the length of audio they were detected from.
+    */
+    static float getMostCommonTempo (const std::vector<std::pair<float, double>>& weightedBpms)
+    {
+        float mostCommonBpm = 0.0f;
+        double mostCommonWeight = 0.0;
+
+        for (auto [candidate, candidateWeight] : weightedBpms)
+        {
+            if (candidate <= 0.0f)
+                continue;
+
+            double totalWeight = 0.0, weightedSum = 0.0;
+
+            for (auto [other, weight] : weightedBpms)
+            {
+                if (other > 0.0f && std::abs (other - candidate) <= candidate * 0.02f)
+                {
+                    totalWeight += weight;
+                    weightedSum += other * weight;
+                }
+            }
+
+            if (totalWeight > mostCommonWeight)
+            {
+                mostCommonWeight = totalWeight;
+                mostCommonBpm = (float) (weightedSum / totalWeight);
+            }
+        }
+
+        return mostCommonBpm;
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TempoDetect)
 };
 
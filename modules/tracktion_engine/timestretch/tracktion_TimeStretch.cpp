@@ -89,6 +89,28 @@ struct TimeStretcher::Stretcher
     virtual int flush (float* const* outChannels) = 0;
 };
 
+//==============================================================================
+/** The number of samples pushed through a stretcher at once when processing offline. */
+static constexpr int offlineStretchBlockSize = 16384;
+
+template<typename FloatType>
+static std::vector<FloatType*> offsetChannels (FloatType* const* channels, int numChannels, int offset)
+{
+    std::vector<FloatType*> result ((size_t) numChannels);
+
+    for (int i = 0; i < numChannels; ++i)
+        result[(size_t) i] = channels[i] + offset;
+
+    return result;
+}
+
+static void clearChannels (float* const* channels, int numChannels, int startSample, int numSamples)
+{
+    if (numSamples > 0)
+        for (int i = 0; i < numChannels; ++i)
+            juce::FloatVectorOperations::clear (channels[i] + startSample, numSamples);
+}
+
 //==============================================================================
 #if TRACKTION_ENABLE_TIMESTRETCH_ELASTIQUE
 
@@ -555,6 +577,32 @@ struct SoundTouchStretcher  : public TimeStretcher::Stretcher,
         return readOutput (outChannels, 0, numToRead);
     }
 
+    /** Stretches a whole buffer, pushing it through in large blocks. */
+    static void stretchOffline (const float* const* input, int numInputSamples,
+                                float* const* output, int numOutputSamples, int numChannels,
+                                double sampleRate, bool betterQuality, float speedRatio, float semitonesUp)
+    {
+        CRASH_TRACER
+        SoundTouchStretcher s (sampleRate, offlineStretchBlockSize, numChannels, betterQuality);
+        s.setSpeedAndPitch (speedRatio, semitonesUp);
+        int numDone = 0;
+
+        for (int pos = 0; pos < numInputSamples && numDone < numOutputSamples; pos += offlineStretchBlockSize)
+        {
+            s.writeInput (offsetChannels (input, numChannels, pos).data(),
+                          std::min (offlineStretchBlockSize, numInputSamples - pos));
+            numDone += s.readOutput (output, numDone, numOutputSamples - numDone);
+        }
+
+        if (numDone < numOutputSamples)
+        {
+            s.soundtouch::SoundTouch::flush();
+            numDone += s.readOutput (output, numDone, numOutputSamples - numDone);
+        }
+
+        clearChannels (output, numChannels, numDone, numOutputSamples - numDone);
+    }
+
 private:
     int numChannels = 0, samplesPerOutputBuffer = 0;
     bool hasDoneFinalBlock = false;
@@ -807,7 +855,75 @@ struct RubberBandStretcher  : public TimeStretcher::Stretcher
         return 0;
     }
 
+    /** Stretches a whole buffer using RubberBand's offline mode.
+        This studies the whole input first so it can plan the stretch over the entire buffer.
+    */
+    static void stretchOffline (const float* const* input, int numInputSamples,
+                                float* const* output, int numOutputSamples, int numChannels,
+                                double sampleRate, bool percussive, float speedRatio, float semitonesUp)
+    {
+        CRASH_TRACER
+        using RB = RubberBand::RubberBandStretcher;
+
+        // Offline renders are already spread across threads so don't let RubberBand start its own
+        const auto options = (getOptionFlags (percussive) & ~RB::OptionProcessRealTime)
+                                | RB::OptionProcessOffline | RB::OptionThreadingNever;
+
+        RB stretcher ((size_t) sampleRate, (size_t) numChannels, options);
+        stretcher.setPitchScale (juce::jlimit (0.25f, 4.0f, tracktion::engine::Pitch::semitonesToRatio (semitonesUp)));
+        stretcher.setTimeRatio (speedRatio);
+        stretcher.setExpectedInputDuration ((size_t) numInputSamples);
+        stretcher.setMaxProcessSize ((size_t) offlineStretchBlockSize);
+
+        int numDone = 0;
+
+        if (numInputSamples > 0)
+        {
+            for (int pos = 0; pos < numInputSamples; pos += offlineStretchBlockSize)
+            {
+                const int numThisTime = std::min (offlineStretchBlockSize, numInputSamples - pos);
+                stretcher.study (offsetChannels (input, numChannels, pos).data(), (size_t) numThisTime,
+                                 pos + numThisTime >= numInputSamples);
+            }
+
+            for (int pos = 0; pos < numInputSamples; pos += offlineStretchBlockSize)
+            {
+                const int numThisTime = std::min (offlineStretchBlockSize, numInputSamples - pos);
+                stretcher.process (offsetChannels (input, numChannels, pos).data(), (size_t) numThisTime,
+                                   pos + numThisTime >= numInputSamples);
+                numDone = retrieveOffline (stretcher, output, numChannels, numDone, numOutputSamples);
+            }
+        }
+
+        clearChannels (output, numChannels, numDone, numOutputSamples - numDone);
+    }
+
 private:
+    static int retrieveOffline (RubberBand::RubberBandStretcher& stretcher, float* const* output,
+                                int numChannels, int numDone, int numOutputSamples)
+    {
+        for (;;)
+        {
+            const int numAvailable = stretcher.available();
+
+            if (numAvailable <= 0)
+                return numDone;
+
+            if (numDone < numOutputSamples)
+            {
+                const int numThisTime = std::min (numAvailable, numOutputSamples - numDone);
+                numDone += (int) stretcher.retrieve (offsetChannels (output, numChannels, numDone).data(),
+                                                     (size_t) numThisTime);
+            }
+            else
+            {
+                // Anything past the end of the output isn't needed so just drain it
+                AudioScratchBuffer scratch (numChannels, std::min (numAvailable, offlineStretchBlockSize));
+                stretcher.retrieve (scratch.buffer.getArrayOfWritePointers(), (size_t) scratch.buffer.getNumSamples());
+            }
+        }
+    }
+
     RubberBand::RubberBandStretcher rubberBandStretcher;
     const int maxFramesNeeded = 8192;
     const int samplesPerOutputBuffer = 0;
@@ -819,6 +935,105 @@ private:
 
 #endif // TRACKTION_ENABLE_TIMESTRETCH_RUBBERBAND
 
+//==============================================================================
+/** Stretches a whole buffer by pushing it through a TimeStretcher's block based interface.
+    This is used for modes that don't have a dedicated offline mode.
+*/
+static bool stretchOfflineInBlocks (const float* const* input, int numInputSamples,
+                                    float* const* output, int numOutputSamples, int numChannels,
+                                    double sampleRate, TimeStretcher::Mode mode,
+                                    TimeStretcher::ElastiqueProOptions options,
+                                    float speedRatio, float semitonesUp)
+{
+    constexpr int samplesPerBlock = 1024;
+
+    TimeStretcher stretcher;
+    stretcher.initialise (sampleRate, samplesPerBlock, numChannels, mode, options, false);
+
+    if (! stretcher.isInitialised())
+        return false;
+
+    stretcher.setSpeedAndPitch (speedRatio, semitonesUp);
+
+    juce::AudioBuffer<float> inBuffer (numChannels, stretcher.getMaxFramesNeeded());
+    juce::AudioBuffer<float> outBuffer (numChannels, samplesPerBlock);
+    int numRead = 0, numDone = 0, numEmptyBlocks = 0;
+
+    while (numDone < numOutputSamples)
+    {
+        const int needed = stretcher.getFramesNeeded();
+        int numThisBlock = 0;
+
+        if (needed >= 0)
+        {
+            // Once the input runs out, keep feeding silence to get the tail out
+            const int numFromInput = juce::jlimit (0, needed, numInputSamples - numRead);
+            inBuffer.setSize (numChannels, std::max (needed, 1), false, false, true);
+            inBuffer.clear();
+
+            for (int i = 0; i < numChannels; ++i)
+                inBuffer.copyFrom (i, 0, input[i] + numRead, numFromInput);
+
+            numRead += numFromInput;
+            numThisBlock = stretcher.processData (inBuffer.getArrayOfReadPointers(), needed,
+                                                  outBuffer.getArrayOfWritePointers());
+        }
+        else
+        {
+            numThisBlock = stretcher.flush (outBuffer.getArrayOfWritePointers());
+        }
+
+        if (numThisBlock <= 0)
+        {
+            if (numRead >= numInputSamples && ++numEmptyBlocks > 16)
+                break;
+
+            continue;
+        }
+
+        numEmptyBlocks = 0;
+        const int numToCopy = std::min (numThisBlock, numOutputSamples - numDone);
+
+        for (int i = 0; i < numChannels; ++i)
+            juce::FloatVectorOperations::copy (output[i] + numDone, outBuffer.getReadPointer (i), numToCopy);
+
+        numDone += numToCopy;
+    }
+
+    clearChannels (output, numChannels, numDone, numOutputSamples - numDone);
+    return true;
+}
+
+static bool stretchOfflineChannels (const float* const* input, int numInputSamples,
+                                    float* const* output, int numOutputSamples, int numChannels,
+                                    double sampleRate, TimeStretcher::Mode mode,
+                                    TimeStretcher::ElastiqueProOptions options,
+                                    float speedRatio, float semitonesUp)
+{
+   #if TRACKTION_ENABLE_TIMESTRETCH_SOUNDTOUCH
+    if (mode == TimeStretcher::soundtouchNormal || mode == TimeStretcher::soundtouchBetter)
+    {
+        SoundTouchStretcher::stretchOffline (input, numInputSamples, output, numOutputSamples, numChannels,
+                                             sampleRate, mode == TimeStretcher::soundtouchBetter,
+                                             speedRatio, semitonesUp);
+        return true;
+    }
+   #endif
+
+   #if TRACKTION_ENABLE_TIMESTRETCH_RUBBERBAND
+    if (mode == TimeStretcher::rubberbandMelodic || mode == TimeStretcher::rubberbandPercussive)
+    {
+        tracktion::engine::RubberBandStretcher::stretchOffline (input, numInputSamples, output, numOutputSamples, numChannels,
+                                                                sampleRate, mode == TimeStretcher::rubberbandPercussive,
+                                                                speedRatio, semitonesUp);
+        return true;
+    }
+   #endif
+
+    return stretchOfflineInBlocks (input, numInputSamples, output, numOutputSamples, numChannels,
+                                   sampleRate, mode, options, speedRatio, semitonesUp);
+}
+
 //==============================================================================
 TimeStretcher::TimeStretcher() {}
 TimeStretcher::~TimeStretcher() {}
@@ -1140,4 +1355,96 @@ int TimeStretcher::flush (float* const* outChannels)
     return 0;
 }
 
+//==============================================================================
+bool TimeStretcher::stretchOffline (const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+                                    double sampleRate, Mode mode, ElastiqueProOptions options,
+                                    float speedRatio, float semitonesUp)
+{
+    CRASH_TRACER
+    jassert (! isMelodyne (mode));
+    jassert (input.getNumChannels() == output.getNumChannels());
+
+    return stretchOfflineChannels (input.getArrayOfReadPointers(), input.getNumSamples(),
+                                   output.getArrayOfWritePointers(), output.getNumSamples(),
+                                   std::min (input.getNumChannels(), output.getNumChannels()),
+                                   sampleRate, mode, options, speedRatio, semitonesUp);
+}
+
+bool TimeStretcher::stretchOfflineChannelSplit (const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+                                                double sampleRate, Mode mode, ElastiqueProOptions options,
+                                                float speedRatio, float semitonesUp,
+                                                juce::ThreadPool& pool)
+{
+    const int numChannels = std::min (input.getNumChannels(), output.getNumChannels());
+
+    if (numChannels < 2 || ! canStretchChannelsIndependently (mode))
+        return stretchOffline (input, output, sampleRate, mode, options, speedRatio, semitonesUp);
+
+    CRASH_TRACER
+    jassert (input.getNumChannels() == output.getNumChannels());
+
+    std::atomic<int> nextChannel { 0 }, numChannelsDone { 0 };
+    std::atomic<bool> allOk { true };
+    juce::WaitableEvent channelDone;
+
+    auto stretchRemainingChannels = [&]
+    {
+        for (int chan = nextChannel++; chan < numChannels; chan = nextChannel++)
+        {
+            if (! stretchOfflineChannels (input.getArrayOfReadPointers() + chan, input.getNumSamples(),
+                                          output.getArrayOfWritePointers() + chan, output.getNumSamples(), 1,
+                                          sampleRate, mode, options, speedRatio, semitonesUp))
+                allOk = false;
+
+            ++numChannelsDone;
+            channelDone.signal();
+        }
+    };
+
+    struct ChannelJob  : public juce::ThreadPoolJob
+    {
+        ChannelJob (std::function<void()> f)
+            : ThreadPoolJob ("Stretch channels"), stretch (std::move (f)) {}
+
+        JobStatus runJob() override
+        {
+            juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+            stretch();
+            return jobHasFinished;
+        }
+
+        std::function<void()> stretch;
+    };
+
+    std::vector<std::unique_ptr<ChannelJob>> jobs;
+
+    for (int i = 1; i < numChannels; ++i)
+    {
+        jobs.push_back (std::make_unique<ChannelJob> (stretchRemainingChannels));
+        pool.addJob (jobs.back().get(), false);
+    }
+
+    // Work through the channels here too so this doesn't rely on the pool having free threads
+    stretchRemainingChannels();
+
+    while (numChannelsDone < numChannels)
+        channelDone.wait (50);
+
+    for (auto& job : jobs)
+        pool.removeJob (job.get(), true, -1);
+
+    return allOk;
+}
+
+bool TimeStretcher::canStretchChannelsIndependently (Mode mode)
+{
+   #if TRACKTION_ENABLE_TIMESTRETCH_RUBBERBAND
+    // RubberBand processes channels apart unless asked not to
+    return mode == rubberbandMelodic || mode == rubberbandPercussive;
+   #else
+    juce::ignoreUnused (mode);
+    return false;
+   #endif
+}
+
 }} // namespace tracktion { inline namespace engine
@@ -168,6 +168,42 @@ public:
     */
     int flush (float* const* outChannels);
 
+    //==============================================================================
+    /** Time-stretches and pitch-shifts a whole buffer in one go.
+        This is much faster than pushing small blocks through processData for offline
+        renders as it uses the algorithm's offline mode where there is one (e.g.
+        RubberBand's study pass) and processes large blocks.
+        @param input        The samples to stretch
+        @param output       The destination. This must have the same number of channels as
+                            the input and will be completely filled. If the stretched input
+                            is shorter than this, the remainder will be silent
+        @param sampleRate   The sample rate of the input
+        @param Mode         The Mode to use
+        @param ElastiqueProOptions  The Elastique options to use, ignored in non-ElastiquePro modes
+        @param speedRatio   The ratio for timestretched speed @see setSpeedAndPitch
+        @param semitones    The number of semitones to adjust the pitch by
+        @returns            true if the mode was available and the buffer was processed
+    */
+    static bool stretchOffline (const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+                                double sampleRate, Mode, ElastiqueProOptions,
+                                float speedRatio, float semitones);
+
+    /** Like stretchOffline but stretches each channel on a separate thread.
+        Only modes that process their channels independently (i.e. RubberBand) can be
+        split like this, others are simply stretched on the calling thread.
+        The calling thread also processes any channels the pool hasn't started so this
+        is safe to call from one of the pool's own jobs.
+    */
+    static bool stretchOfflineChannelSplit (const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+                                            double sampleRate, Mode, ElastiqueProOptions,
+                                            float speedRatio, float semitones,
+                                            juce::ThreadPool&);
+
+    /** Returns true if the channels can be stretched separately with this mode
+        without affecting the result @see stretchOfflineChannelSplit.
+    */
+    static bool canStretchChannelsIndependently (Mode);
+
     /** @internal */
     struct Stretcher;
 
@@ -31,6 +31,7 @@ public:
             const auto mode = tracktion::engine::TimeStretcher::soundtouchBetter;
             runPitchShiftTest (mode);
             runTimestretchTest (mode);
+            runOfflineTest (mode);
         }
        #endif
 
@@ -39,6 +40,7 @@ public:
             const auto mode = tracktion::engine::TimeStretcher::rubberbandMelodic;
             runPitchShiftTest (mode);
             runTimestretchTest (mode);
+            runOfflineTest (mode);
         }
        #endif
 
@@ -48,6 +50,7 @@ public:
                 const auto mode = tracktion::engine::TimeStretcher::elastiquePro;
                 runPitchShiftTest (mode);
                 runTimestretchTest (mode);
+                runOfflineTest (mode);
             }
 
             {
@@ -97,6 +100,18 @@ private:
         testStretcher (mode, 2.0f, 0.0f);
     }
 
+    void runOfflineTest (tracktion::engine::TimeStretcher::Mode mode)
+    {
+        beginTest ("Offline: " + tracktion::engine::TimeStretcher::getNameOfMode (mode));
+
+        for (bool splitChannels : { false, true })
+        {
+            testOfflineStretcher (mode, 0.5f, 0.0f, splitChannels);
+            testOfflineStretcher (mode, 2.0f, 0.0f, splitChannels);
+            testOfflineStretcher (mode, 1.0f, 12.0f, splitChannels);
+        }
+    }
+
     //==============================================================================
     void testStretcher (tracktion::engine::TimeStretcher::Mode mode, float stretchRatio, float semitonesUp)
     {
@@ -136,6 +151,36 @@ private:
         expectWithinAbsoluteError (resultBuffer.getNumSamples(), expectedSize, juce::roundToInt (expectedSize * 0.05f));
     }
 
+    void testOfflineStretcher (tracktion::engine::TimeStretcher::Mode mode, float stretchRatio, float semitonesUp, bool splitChannels)
+    {
+        const double sampleRate = 44100.0;
+        const float sourcePitch = 440.0f;
+
+        const auto sourceBuffer = createSinBuffer (sampleRate, 2, sourcePitch);
+        juce::AudioBuffer<float> resultBuffer (2, (int) std::ceil (sourceBuffer.getNumSamples() * stretchRatio));
+
+        if (splitChannels)
+        {
+            juce::ThreadPool pool (2);
+            expect (tracktion::engine::TimeStretcher::stretchOfflineChannelSplit (sourceBuffer, resultBuffer, sampleRate, mode, {},
+                                                                                  stretchRatio, semitonesUp, pool));
+        }
+        else
+        {
+            expect (tracktion::engine::TimeStretcher::stretchOffline (sourceBuffer, resultBuffer, sampleRate, mode, {},
+                                                                      stretchRatio, semitonesUp));
+        }
+
+        // Most of the output should be filled, only the very end can be padded with silence
+        const auto numToCheck = juce::roundToInt (resultBuffer.getNumSamples() * 0.9f);
+        expectGreaterThan (resultBuffer.getMagnitude (0, numToCheck - 2048, 2048), 0.1f);
+
+        const float expectedPitchValue = sourcePitch * tracktion::engine::Pitch::semitonesToRatio (semitonesUp);
+        juce::AudioBuffer<float> checkedBuffer (resultBuffer.getArrayOfWritePointers(), 1, 0, numToCheck);
+        const float shiftedPitch = getPitchFromNumZeroCrossings (getNumZeroCrossings (checkedBuffer), numToCheck, sampleRate);
+        expectWithinAbsoluteError (shiftedPitch, expectedPitchValue, expectedPitchValue * 0.06f);
+    }
+
     //==============================================================================
     static juce::AudioBuffer<float> createSinBuffer (double sampleRate, int numChannels, float pitch)
     {
@@ -25,7 +25,7 @@
   website:          http://www.tracktion.com
   license:          Proprietary
 
-  dependencies:     juce_audio_devices juce_audio_utils juce_dsp juce_osc, juce_gui_extra tracktion_graph
+  dependencies:     juce_audio_devices juce_audio_utils juce_dsp juce_osc, juce_gui_extra juce_cryptography tracktion_graph
 
  END_JUCE_MODULE_DECLARATION
 
@@ -53,16 +53,19 @@
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_osc/juce_osc.h>
+#include <juce_cryptography/juce_cryptography.h>
 
 #if __has_include(<choc/audio/choc_SampleBuffers.h>)
  #include <choc/audio/choc_SampleBuffers.h>
  #include <choc/audio/choc_MIDI.h>
  #include <choc/containers/choc_SingleReaderSingleWriterFIFO.h>
+ #include <choc/containers/choc_SingleReaderMultipleWriterFIFO.h>
  #include <choc/containers/choc_NonAllocatingStableSort.h>
 #else
  #include "../3rd_party/choc/audio/choc_SampleBuffers.h"
  #include "../3rd_party/choc/audio/choc_MIDI.h"
  #include "../3rd_party/choc/containers/choc_SingleReaderSingleWriterFIFO.h"
+ #include "../3rd_party/choc/containers/choc_SingleReaderMultipleWriterFIFO.h"
  #include "../3rd_party/choc/containers/choc_NonAllocatingStableSort.h"
 #endif
 
@@ -258,14 +261,21 @@
 #endif
 
 //==============================================================================
+namespace tracktion::inline engine
+{
+    inline bool isCurrentThreadRunningMessageThreadCallback() noexcept;
+}
+
 #define TRACKTION_ASSERT_MESSAGE_THREAD \
-    jassert (juce::MessageManager::getInstance()->currentThreadHasLockedMessageManager());
+    jassert (juce::MessageManager::getInstance()->currentThreadHasLockedMessageManager() \
+              || tracktion::engine::isCurrentThreadRunningMessageThreadCallback());
 
 //==============================================================================
 namespace tracktion::inline graph
 {
     class PlayHead;
     struct LatencyProcessor;
+    class SharedNodeThreadPool;
 }
 
 //==============================================================================
@@ -280,6 +290,10 @@ namespace tracktion { inline namespace engine
     class DeviceManager;
     class GrooveTemplateManager;
     class Edit;
+    class EditMemoryBudget;
+    class PluginStateCapture;
+    class EditCpuUsage;
+    class UndoHistoryStore;
     class Track;
     class Clip;
     class ClipOwner;
@@ -361,6 +375,7 @@ namespace tracktion { inline namespace engine
     class ChordClip;
     struct TimecodeSnapType;
     class MidiNote;
+    class QuantisationType;
     class AutomationCurveSource;
     struct Modifier;
     class MidiTimecodeGenerator;
@@ -424,7 +439,9 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_MouseHoverDetector.h"
 #include "utilities/tracktion_CurveEditor.h"
 #include "utilities/tracktion_Envelope.h"
+#include "utilities/tracktion_BiquadCascade.h"
 #include "utilities/tracktion_Oscillators.h"
+#include "utilities/tracktion_PartitionedConvolution.h"
 #include "utilities/tracktion_ScreenSaverDefeater.h"
 
 #include "project/tracktion_ProjectItemID.h"
@@ -469,6 +486,7 @@ namespace tracktion { inline namespace engine
 #include "plugins/tracktion_PluginWindowState.h"
 #include "plugins/tracktion_Plugin.h"
 #include "plugins/tracktion_PluginList.h"
+#include "plugins/tracktion_PluginScanCache.h"
 #include "plugins/tracktion_PluginManager.h"
 #include "utilities/tracktion_ParameterHelpers.h"
 
@@ -482,9 +500,11 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_Engine.h"
 
 #include "playback/tracktion_LevelMeasurer.h"
+#include "playback/tracktion_LoudnessMeter.h"
 
 #include "plugins/external/tracktion_VSTXML.h"
 #include "plugins/external/tracktion_ExternalPlugin.h"
+#include "plugins/external/tracktion_SandboxedPluginInstance.h"
 
 #include "plugins/internal/tracktion_VCA.h"
 #include "plugins/internal/tracktion_VolumeAndPan.h"
@@ -507,8 +527,12 @@ namespace tracktion { inline namespace engine
 #include "model/edit/tracktion_PitchSetting.h"
 #include "model/edit/tracktion_PitchSequence.h"
 #include "model/edit/tracktion_Edit.h"
+#include "model/edit/tracktion_BinaryEditFile.h"
 #include "model/edit/tracktion_EditFileOperations.h"
 #include "model/edit/tracktion_EditLoader.h"
+#include "model/edit/tracktion_EditMemoryBudget.h"
+#include "model/edit/tracktion_CompactUndo.h"
+#include "model/edit/tracktion_PluginStateCapture.h"
 
 #include "playback/tracktion_TransportControl.h"
 #include "playback/tracktion_AbletonLink.h"
@@ -528,7 +552,9 @@ namespace tracktion { inline namespace engine
 
 #include "audio_files/tracktion_AudioFileCache.h"
 #include "audio_files/tracktion_SmartThumbnail.h"
+#include "audio_files/tracktion_MipMapAudioThumbnail.h"
 #include "audio_files/tracktion_AudioProxyGenerator.h"
+#include "audio_files/tracktion_AudioFileInfoCache.h"
 #include "audio_files/tracktion_AudioFileManager.h"
 #include "audio_files/tracktion_AudioFileWriter.h"
 #include "audio_files/tracktion_BufferedAudioReader.h"
@@ -567,6 +593,8 @@ namespace tracktion { inline namespace engine
 #include "model/export/tracktion_ReferencedMaterialList.h"
 #include "model/export/tracktion_Renderer.h"
 #include "model/export/tracktion_RenderManager.h"
+#include "model/export/tracktion_ParallelRenderer.h"
+#include "model/export/tracktion_DistributedRenderer.h"
 
 #include "model/edit/tracktion_QuantisationType.h"
 
@@ -602,6 +630,7 @@ namespace tracktion { inline namespace engine
 #include "model/tracks/tracktion_TrackCompManager.h"
 #include "model/export/tracktion_RenderOptions.h"
 #include "model/clips/tracktion_EditClipRenderJob.h"
+#include "model/clips/tracktion_ContainerClipRenderJob.h"
 
 #include "selection/tracktion_Clipboard.h"
 
@@ -621,10 +650,12 @@ namespace tracktion { inline namespace engine
  #include "playback/tracktion_ScopedSteadyLoad.h"
 #endif
 
+#include "playback/tracktion_AudioCallbackTelemetry.h"
 #include "playback/tracktion_DeviceManager.h"
 #include "playback/tracktion_HostedAudioDevice.h"
 #include "playback/tracktion_MidiNoteDispatcher.h"
 #include "playback/tracktion_EditPlaybackContext.h"
+#include "playback/tracktion_EditCpuUsage.h"
 #include "playback/tracktion_EditInputDevices.h"
 
 #if TRACKTION_AIR_WINDOWS
@@ -32,6 +32,12 @@ extern "C"
  #include <Windows.h>
 #endif
 
+#if JUCE_LINUX || JUCE_ANDROID || JUCE_MAC || JUCE_IOS || JUCE_BSD
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/mman.h>
+#endif
+
 #include <string>
 #include <bitset>
 
@@ -47,16 +53,23 @@ extern "C"
 
 #include "audio_files/tracktion_BufferedFileReader.h"
 #include "audio_files/tracktion_BufferedFileReader.cpp"
+#include "audio_files/tracktion_PreallocatingFileOutputStream.h"
+#include "audio_files/tracktion_PreallocatingFileOutputStream.cpp"
 
 #include "audio_files/tracktion_AudioFileCache.cpp"
 #include "audio_files/tracktion_AudioFileCache.test.cpp"
+#include "audio_files/tracktion_AudioFileInfoCache.cpp"
+#include "audio_files/tracktion_AudioFileInfoCache.test.cpp"
 #include "audio_files/tracktion_AudioFile.cpp"
 #include "audio_files/tracktion_AudioFile.test.cpp"
 #include "audio_files/tracktion_AudioFileUtils.cpp"
 #include "audio_files/tracktion_AudioFormatManager.cpp"
 #include "audio_files/tracktion_BufferedAudioReader.cpp"
+#include "audio_files/tracktion_MipMapAudioThumbnail.cpp"
+#include "audio_files/tracktion_MipMapAudioThumbnail.test.cpp"
 
 #include "midi/tracktion_MidiList.cpp"
+#include "midi/tracktion_MidiList.test.cpp"
 #include "midi/tracktion_MidiProgramManager.cpp"
 #include "midi/tracktion_Musicality.cpp"
 #include "midi/tracktion_SelectedMidiEvents.cpp"
@@ -88,6 +88,7 @@ using namespace std::literals;
 #include "model/clips/tracktion_ClipEffects.cpp"
 #include "model/clips/tracktion_ClipOwner.cpp"
 #include "model/clips/tracktion_WarpTimeManager.cpp"
+#include "model/clips/tracktion_WarpTimeManager.test.cpp"
 
 #ifdef __GNUC__
  #pragma GCC diagnostic pop
@@ -63,9 +63,17 @@ using namespace std::literals;
 #include "model/edit/tracktion_TimecodeDisplayFormat.cpp"
 #include "model/edit/tracktion_TimeSigSetting.cpp"
 #include "model/edit/tracktion_EditSnapshot.cpp"
+#include "model/edit/tracktion_EditSnapshot.test.cpp"
+#include "model/edit/tracktion_BinaryEditFile.cpp"
+#include "model/edit/tracktion_BinaryEditFile.test.cpp"
 #include "model/edit/tracktion_EditFileOperations.cpp"
+#include "model/edit/tracktion_EditFileOperations.test.cpp"
 #include "model/edit/tracktion_EditInsertPoint.cpp"
 #include "model/edit/tracktion_EditLoader.cpp"
+#include "model/edit/tracktion_EditMemoryBudget.cpp"
+#include "model/edit/tracktion_CompactUndo.cpp"
+#include "model/edit/tracktion_PluginStateCapture.cpp"
+#include "model/edit/tracktion_PluginStateCapture.test.cpp"
 #include "model/edit/tracktion_EditLoader.test.cpp"
 
 #include "model/export/tracktion_Exportable.cpp"
@@ -73,9 +81,13 @@ using namespace std::literals;
 #include "model/export/tracktion_Renderer.cpp"
 #include "model/export/tracktion_Renderer.test.cpp"
 #include "model/export/tracktion_RenderManager.cpp"
+#include "model/export/tracktion_ParallelRenderer.cpp"
+#include "model/export/tracktion_DistributedRenderer.cpp"
+#include "model/export/tracktion_DistributedRenderer.test.cpp"
 #include "model/export/tracktion_ArchiveFile.cpp"
 #include "model/export/tracktion_RenderOptions.cpp"
 #include "model/clips/tracktion_EditClipRenderJob.cpp"
+#include "model/clips/tracktion_ContainerClipRenderJob.cpp"
 #include "model/clips/tracktion_AudioSegmentList.cpp"
 #include "audio_files/tracktion_LoopInfo.cpp"
 #include "audio_files/tracktion_LoopInfo.test.cpp"
@@ -85,6 +97,7 @@ using namespace std::literals;
 #include "project/tracktion_Project.cpp"
 #include "project/tracktion_ProjectManager.cpp"
 #include "project/tracktion_ProjectSearchIndex.cpp"
+#include "project/tracktion_ProjectSearchIndex.test.cpp"
 
 #ifdef __GNUC__
  #pragma GCC diagnostic pop
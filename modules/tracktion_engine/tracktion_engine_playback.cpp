@@ -12,6 +12,7 @@
 
 #include "3rd_party/magic_enum/tracktion_magic_enum.hpp"
 
+#include <bit>
 #include <shared_mutex>
 
 #if TRACKTION_ENABLE_ABLETON_LINK
@@ -118,6 +119,18 @@ extern "C"
 //==============================================================================
 #include "tracktion_engine.h"
 
+#if JUCE_WINDOWS
+ #define NOGDI
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <Windows.h>
+#elif JUCE_MAC || JUCE_IOS
+ #include <mach/mach_time.h>
+#elif JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+ #include <time.h>
+#endif
+
 
 //==============================================================================
 //==============================================================================
@@ -179,6 +192,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_BenchmarkUtilities.h"
 
 #include "playback/graph/tracktion_TrackMutingNode.h"
+#include "playback/graph/tracktion_AnticipativeRenderNode.h"
 #include "playback/graph/tracktion_ArrangerLauncherSwitchingNode.h"
 #include "playback/graph/tracktion_AuxSendNode.h"
 #include "playback/graph/tracktion_ClickNode.h"
@@ -190,6 +204,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_InsertSendNode.h"
 #include "playback/graph/tracktion_LevelMeasurerProcessingNode.h"
 #include "playback/graph/tracktion_LevelMeasuringNode.h"
+#include "playback/graph/tracktion_LoudnessMeasuringNode.h"
 #include "playback/graph/tracktion_LiveMidiInjectingNode.h"
 #include "playback/graph/tracktion_LiveMidiOutputNode.h"
 #include "playback/graph/tracktion_LoopingMidiNode.h"
@@ -211,10 +226,13 @@ using namespace std::literals;
 #include "playback/graph/tracktion_SharedLevelMeasuringNode.h"
 #include "playback/graph/tracktion_SlotControlNode.h"
 #include "playback/graph/tracktion_SpeedRampWaveNode.h"
+#include "playback/graph/tracktion_StemTapNode.h"
 #include "playback/graph/tracktion_MidiInputDeviceNode.h"
 #include "playback/graph/tracktion_HostedMidiInputDeviceNode.h"
 #include "playback/graph/tracktion_WaveInputDeviceNode.h"
 
+#include "playback/graph/tracktion_AnticipativeRenderNode.cpp"
+#include "playback/graph/tracktion_AnticipativeRenderNode.test.cpp"
 #include "playback/graph/tracktion_ArrangerLauncherSwitchingNode.cpp"
 #include "playback/graph/tracktion_AuxSendNode.cpp"
 #include "playback/graph/tracktion_ClickNode.cpp"
@@ -225,6 +243,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_FadeInOutNode.cpp"
 #include "playback/graph/tracktion_InsertSendNode.cpp"
 #include "playback/graph/tracktion_LevelMeasuringNode.cpp"
+#include "playback/graph/tracktion_LoudnessMeasuringNode.cpp"
 #include "playback/graph/tracktion_LiveMidiInjectingNode.cpp"
 #include "playback/graph/tracktion_LiveMidiOutputNode.cpp"
 #include "playback/graph/tracktion_LoopingMidiNode.cpp"
@@ -239,6 +258,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_RackNode.test.cpp"
 #include "playback/graph/tracktion_RackReturnNode.cpp"
 #include "playback/graph/tracktion_PluginNode.cpp"
+#include "playback/graph/tracktion_PluginNode.test.cpp"
 #include "playback/graph/tracktion_PluginNodeBenchmarks.test.cpp"
 #include "playback/graph/tracktion_ModifierNode.cpp"
 
@@ -250,6 +270,7 @@ using namespace std::literals;
 #include "playback/graph/tracktion_SharedLevelMeasuringNode.cpp"
 #include "playback/graph/tracktion_SlotControlNode.cpp"
 #include "playback/graph/tracktion_SpeedRampWaveNode.cpp"
+#include "playback/graph/tracktion_StemTapNode.cpp"
 #include "playback/graph/tracktion_MidiInputDeviceNode.cpp"
 #include "playback/graph/tracktion_HostedMidiInputDeviceNode.cpp"
 #include "playback/graph/tracktion_WaveInputDeviceNode.cpp"
@@ -266,12 +287,18 @@ using namespace std::literals;
 #include "playback/graph/tracktion_WaveNode.test.cpp"
 #include "playback/graph/tracktion_MidiNode.test.cpp"
 #include "playback/graph/tracktion_RackBenchmarks.test.cpp"
+#include "playback/graph/tracktion_EditPlaybackBenchmarks.test.cpp"
 
+#include "playback/tracktion_AudioCallbackTelemetry.cpp"
 #include "playback/tracktion_DeviceManager.cpp"
 #include "playback/tracktion_EditPlaybackContext.cpp"
+#include "playback/tracktion_EditCpuUsage.cpp"
 #include "playback/tracktion_EditInputDevices.cpp"
 #include "playback/tracktion_LevelMeasurer.cpp"
+#include "playback/tracktion_LoudnessMeter.cpp"
+#include "playback/tracktion_LoudnessMeter.test.cpp"
 #include "playback/tracktion_MidiNoteDispatcher.cpp"
+#include "playback/tracktion_MidiNoteDispatcher.test.cpp"
 #include "playback/tracktion_TransportControl.test.cpp"
 #include "playback/tracktion_TransportControl.cpp"
 #include "playback/tracktion_AbletonLink.cpp"
@@ -49,12 +49,14 @@ using namespace std::literals;
 
 #include "plugins/tracktion_Plugin.cpp"
 #include "plugins/tracktion_PluginList.cpp"
+#include "plugins/tracktion_PluginScanCache.cpp"
 #include "plugins/tracktion_PluginManager.cpp"
 #include "plugins/tracktion_PluginWindowState.cpp"
 
 #include "plugins/external/tracktion_ExternalAutomatableParameter.h"
 #include "plugins/external/tracktion_ExternalPluginBlacklist.h"
 #include "plugins/external/tracktion_ExternalPlugin.cpp"
+#include "plugins/external/tracktion_ExternalPlugin.test.cpp"
 
 #include "plugins/internal/tracktion_AuxReturn.cpp"
 #include "plugins/internal/tracktion_AuxSend.cpp"
@@ -68,6 +70,7 @@ using namespace std::literals;
 #include "plugins/internal/tracktion_TextPlugin.cpp"
 #include "plugins/internal/tracktion_VCA.cpp"
 #include "plugins/internal/tracktion_VolumeAndPan.cpp"
+#include "plugins/internal/tracktion_VolumeAndPan.test.cpp"
 #include "plugins/internal/tracktion_InternalPlugins.test.cpp"
 
 #include "plugins/effects/tracktion_Chorus.cpp"
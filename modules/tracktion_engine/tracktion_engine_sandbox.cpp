@@ -0,0 +1,45 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if ! JUCE_PROJUCER_LIVE_BUILD
+
+#include <atomic>
+#include <thread>
+
+#include <tracktion_core/tracktion_TestConfig.h>
+
+#include "tracktion_engine.h"
+
+// The sandbox needs the OS shared memory and semaphore APIs so it's kept in its
+// own translation unit rather than letting windows.h leak in to the others
+#if JUCE_WINDOWS
+ #ifndef NOGDI
+  #define NOGDI
+ #endif
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#elif JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <fcntl.h>
+ #include <semaphore.h>
+ #include <unistd.h>
+ #include <sys/mman.h>
+#endif
+
+#if JUCE_LINUX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
+#include "plugins/external/tracktion_SandboxedPluginInstance.cpp"
+#include "plugins/external/tracktion_SandboxedPluginInstance.test.cpp"
+
+#endif
@@ -154,6 +154,43 @@ private:
 };
 
 
+//==============================================================================
+namespace detail
+{
+    inline std::atomic<bool> runMessageThreadCallbacksOnCallingThread { false };
+    inline thread_local bool isRunningMessageThreadCallback = false;
+
+    inline std::recursive_mutex& getMessageThreadCallbackMutex()
+    {
+        static std::recursive_mutex mutex;
+        return mutex;
+    }
+}
+
+/** In a headless process there may not be a message loop running to deliver the
+    functions passed to callBlocking. Enabling this makes them run on the calling
+    thread instead, one at a time, so the engine can be used without a message thread.
+    The Engine enables this if EngineBehaviour::isHeadlessBatchMode returns true.
+*/
+inline void setRunMessageThreadCallbacksOnCallingThread (bool shouldRunOnCallingThread)
+{
+    detail::runMessageThreadCallbacksOnCallingThread = shouldRunOnCallingThread;
+}
+
+/** Returns true if setRunMessageThreadCallbacksOnCallingThread has been enabled. */
+inline bool shouldRunMessageThreadCallbacksOnCallingThread() noexcept
+{
+    return detail::runMessageThreadCallbacksOnCallingThread.load (std::memory_order_relaxed);
+}
+
+/** Returns true if the calling thread is running a message thread callback in place
+    of the message thread. @see setRunMessageThreadCallbacksOnCallingThread
+*/
+inline bool isCurrentThreadRunningMessageThreadCallback() noexcept
+{
+    return detail::isRunningMessageThreadCallback;
+}
+
 //==============================================================================
 /** Calls a function on the message thread checking a calling thread for an exit signal. */
 class MessageThreadCallback   : private juce::AsyncUpdater
@@ -176,6 +213,14 @@ public:
             return;
         }
 
+        if (shouldRunMessageThreadCallbacksOnCallingThread())
+        {
+            const std::scoped_lock sl (detail::getMessageThreadCallbackMutex());
+            const juce::ScopedValueSetter<bool> svs (detail::isRunningMessageThreadCallback, true);
+            handleAsyncUpdate();
+            return;
+        }
+
         triggerAsyncUpdate();
 
         if (auto job = juce::ThreadPoolJob::getCurrentThreadPoolJob())
@@ -92,6 +92,45 @@ struct AudioFadeCurve
         }
     }
 
+    /** The number of intervals in the tables used by alphaToGainFromTable. */
+    static constexpr int tableSize = 1024;
+
+    /** Returns a table of the gains for a curve type at tableSize + 1 evenly spaced alphas.
+        The tables are created the first time they're needed and then shared.
+    */
+    static const std::array<float, tableSize + 1>& getTable (Type) noexcept;
+
+    /** Converts an alpha position along the curve (0 to 1.0) into the gain at that point
+        by interpolating the curve's table, which is much quicker than alphaToGainForType.
+    */
+    static float alphaToGainFromTable (Type type, float alpha) noexcept
+    {
+        const auto& table = getTable (type);
+        const auto pos = juce::jlimit (0.0f, 1.0f, alpha) * tableSize;
+        const auto index = std::min ((int) pos, tableSize - 1);
+
+        return table[(size_t) index] + (pos - (float) index) * (table[(size_t) index + 1] - table[(size_t) index]);
+    }
+
+    /** Fills an array with the gains of a curve between two alpha-positions, using the
+        curve's table. The gains are in the same positions as renderBlock would apply them.
+    */
+    static void fillGains (float* gains, int numSamples, Type type,
+                           float startAlpha, float endAlpha) noexcept;
+
+    /** Multiplies some channels by the curve shape between two alpha-positions.
+        The gains are calculated once from the curve's table and then multiplied in to
+        each channel with vectorised operations.
+    */
+    static void applyGainRamp (choc::buffer::ChannelArrayView<float>, Type type,
+                               float startAlpha, float endAlpha) noexcept;
+
+    /** Linearly crossfades the start of a block from a previous value, multiplying it
+        by a gain at the same time. This is used to avoid clicks at discontinuities.
+    */
+    static void applyLinearFadeFromValue (float* dest, int numSamples,
+                                          float previousValue, float gain) noexcept;
+
     /** Multiplies a block of samples by the curve shape between two alpha-positions.
         The DestSamplePointer object must be a class that implements an apply() method that
         gets called with each gain level.
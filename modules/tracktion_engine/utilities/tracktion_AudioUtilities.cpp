@@ -330,27 +330,113 @@ void convertFloatsToInts (juce::AudioBuffer<float>& buffer)
 }
 
 //==============================================================================
-struct OneChannelDestination
+namespace AudioFadeCurveHelpers
 {
-    float* channel0;
+    // Gains are calculated in chunks of this size on the stack
+    static constexpr int gainChunkSize = 256;
 
-    inline void apply (float value) noexcept
+    template <typename CurveClass>
+    static std::array<float, AudioFadeCurve::tableSize + 1> createTable()
     {
-        *channel0++ *= value;
+        std::array<float, AudioFadeCurve::tableSize + 1> table;
+
+        for (size_t i = 0; i < table.size(); ++i)
+            table[i] = AudioFadeCurve::alphaToGain<CurveClass> ((float) i / AudioFadeCurve::tableSize);
+
+        return table;
     }
-};
 
-struct TwoChannelDestination
+    /** Calls a function with each chunk of gains between two alpha-positions. */
+    template <typename ApplyFn>
+    static void forEachGainChunk (int numSamples, AudioFadeCurve::Type type,
+                                  float startAlpha, float endAlpha, ApplyFn&& apply) noexcept
+    {
+        float gains[gainChunkSize];
+        const auto delta = (endAlpha - startAlpha) / (float) numSamples;
+
+        for (int offset = 0; offset < numSamples; offset += gainChunkSize)
+        {
+            const auto num = std::min (gainChunkSize, numSamples - offset);
+            AudioFadeCurve::fillGains (gains, num, type,
+                                       startAlpha + delta * (float) offset,
+                                       startAlpha + delta * (float) (offset + num));
+            apply (gains, offset, num);
+        }
+    }
+}
+
+const std::array<float, AudioFadeCurve::tableSize + 1>& AudioFadeCurve::getTable (Type type) noexcept
 {
-    float* channel0;
-    float* channel1;
+    using namespace AudioFadeCurveHelpers;
+    static const auto linearTable = createTable<Linear>();
+    static const auto convexTable = createTable<Convex>();
+    static const auto concaveTable = createTable<Concave>();
+    static const auto sCurveTable = createTable<SCurve>();
 
-    inline void apply (float value) noexcept
+    switch (type)
     {
-        *channel0++ *= value;
-        *channel1++ *= value;
+        case convex:    return convexTable;
+        case concave:   return concaveTable;
+        case sCurve:    return sCurveTable;
+        case linear:
+        default:        jassert (type == linear); return linearTable;
     }
-};
+}
+
+void AudioFadeCurve::fillGains (float* gains, int numSamples, Type type, float startAlpha, float endAlpha) noexcept
+{
+    jassert (numSamples > 0);
+
+    if (type == linear)
+    {
+        const auto delta = (endAlpha - startAlpha) / (float) numSamples;
+
+        for (int i = 0; i < numSamples; ++i)
+            gains[i] = startAlpha + delta * (float) i;
+
+        return;
+    }
+
+    // Working in table positions avoids a multiply and clamp per sample
+    const auto& table = getTable (type);
+    const auto startPos = juce::jlimit (0.0f, 1.0f, startAlpha) * tableSize;
+    const auto endPos = juce::jlimit (0.0f, 1.0f, endAlpha) * tableSize;
+    const auto delta = (endPos - startPos) / (float) numSamples;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto pos = startPos + delta * (float) i;
+        const auto index = std::min ((int) pos, tableSize - 1);
+        gains[i] = table[(size_t) index] + (pos - (float) index) * (table[(size_t) index + 1] - table[(size_t) index]);
+    }
+}
+
+void AudioFadeCurve::applyGainRamp (choc::buffer::ChannelArrayView<float> view, Type type,
+                                    float startAlpha, float endAlpha) noexcept
+{
+    const auto numSamples = (int) view.getNumFrames();
+
+    if (numSamples == 0)
+        return;
+
+    AudioFadeCurveHelpers::forEachGainChunk (numSamples, type, startAlpha, endAlpha,
+                                             [&] (const float* gains, int offset, int num)
+                                             {
+                                                 for (choc::buffer::ChannelCount c = 0; c < view.getNumChannels(); ++c)
+                                                     juce::FloatVectorOperations::multiply (view.getIterator (c).sample + offset, gains, num);
+                                             });
+}
+
+void AudioFadeCurve::applyLinearFadeFromValue (float* dest, int numSamples, float previousValue, float gain) noexcept
+{
+    const auto delta = 1.0f / (float) numSamples;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto alpha = delta * (float) i;
+        dest[i] = alpha * gain * dest[i] + previousValue * (1.0f - alpha);
+    }
+}
 
 void AudioFadeCurve::applyCrossfadeSection (juce::AudioBuffer<float>& buffer,
                                             int channel, int startSample, int numSamples,
@@ -358,10 +444,11 @@ void AudioFadeCurve::applyCrossfadeSection (juce::AudioBuffer<float>& buffer,
 {
     jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
 
-    if (! buffer.hasBeenCleared())
+    if (! buffer.hasBeenCleared() && numSamples > 0)
     {
-        OneChannelDestination d = { buffer.getWritePointer (channel, startSample) };
-        AudioFadeCurve::renderBlockForType (d, numSamples, startAlpha, endAlpha, type);
+        auto dest = buffer.getWritePointer (channel, startSample);
+        applyGainRamp (choc::buffer::createChannelArrayView (&dest, 1, (choc::buffer::FrameCount) numSamples),
+                       type, startAlpha, endAlpha);
     }
 }
 
@@ -372,33 +459,11 @@ void AudioFadeCurve::applyCrossfadeSection (juce::AudioBuffer<float>& buffer,
     jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples() && numSamples > 0);
 
     if (! buffer.hasBeenCleared())
-    {
-        if (buffer.getNumChannels() == 2)
-        {
-            TwoChannelDestination d = { buffer.getWritePointer (0, startSample),
-                                        buffer.getWritePointer (1, startSample) };
-
-            AudioFadeCurve::renderBlockForType (d, numSamples, startAlpha, endAlpha, type);
-        }
-        else
-        {
-            for (int i = buffer.getNumChannels(); --i >= 0;)
-                applyCrossfadeSection (buffer, i, startSample, numSamples, type, startAlpha, endAlpha);
-        }
-    }
+        applyGainRamp (tracktion::graph::toBufferView (buffer).getFrameRange ({ (choc::buffer::FrameCount) startSample,
+                                                                                (choc::buffer::FrameCount) (startSample + numSamples) }),
+                       type, startAlpha, endAlpha);
 }
 
-struct AddingFadeApplier
-{
-    float* dest;
-    const float* src;
-
-    inline void apply (float value) noexcept
-    {
-        *dest++ += *src++ * value;
-    }
-};
-
 void AudioFadeCurve::addWithCrossfade (juce::AudioBuffer<float>& dest,
                                        const juce::AudioBuffer<float>& src,
                                        int destChannel, int destStartIndex,
@@ -416,10 +481,14 @@ void AudioFadeCurve::addWithCrossfade (juce::AudioBuffer<float>& dest,
         }
         else
         {
-            AddingFadeApplier d = { dest.getWritePointer (destChannel, destStartIndex),
-                                    src.getReadPointer (sourceChannel, sourceStartIndex) };
-
-            AudioFadeCurve::renderBlockForType (d, numSamples, startAlpha, endAlpha, type);
+            auto destData = dest.getWritePointer (destChannel, destStartIndex);
+            auto srcData = src.getReadPointer (sourceChannel, sourceStartIndex);
+
+            AudioFadeCurveHelpers::forEachGainChunk (numSamples, type, startAlpha, endAlpha,
+                                                     [&] (const float* gains, int offset, int num)
+                                                     {
+                                                         juce::FloatVectorOperations::addWithMultiply (destData + offset, srcData + offset, gains, num);
+                                                     });
         }
     }
 }
@@ -20,7 +20,8 @@ enum class ResamplingQuality
     lagrange,   /**< Lagrange interpolation */
     sincFast,   /**< Fast sinc interpolation provided by libsamplerate */
     sincMedium, /**< Medium quality sinc interpolation provided by libsamplerate */
-    sincBest    /**< Best quality sinc interpolation provided by libsamplerate */
+    sincBest,   /**< Best quality sinc interpolation provided by libsamplerate */
+    sincPolyphase /**< Polyphase sinc interpolation that processes all channels together */
 };
 
 float dbToGain (float db) noexcept;
@@ -270,6 +271,7 @@ namespace juce
             if (s == "sincFast")    return tracktion::engine::ResamplingQuality::sincFast;
             if (s == "sincMedium")  return tracktion::engine::ResamplingQuality::sincMedium;
             if (s == "sincBest")    return tracktion::engine::ResamplingQuality::sincBest;
+            if (s == "sincPolyphase") return tracktion::engine::ResamplingQuality::sincPolyphase;
 
             return tracktion::engine::ResamplingQuality::lagrange;
         }
@@ -279,6 +281,7 @@ namespace juce
             if (v == tracktion::engine::ResamplingQuality::sincFast)    return "sincFast";
             if (v == tracktion::engine::ResamplingQuality::sincMedium)  return "sincMedium";
             if (v == tracktion::engine::ResamplingQuality::sincBest)    return "sincBest";
+            if (v == tracktion::engine::ResamplingQuality::sincPolyphase) return "sincPolyphase";
 
             return "lagrange";
         }
@@ -0,0 +1,185 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+BiquadCascade::Coefficients::Coefficients (const juce::IIRCoefficients& c) noexcept
+    : b0 (c.coefficients[0]), b1 (c.coefficients[1]), b2 (c.coefficients[2]),
+      a1 (c.coefficients[3]), a2 (c.coefficients[4])
+{
+}
+
+void BiquadCascade::Stage::snapToTarget() noexcept
+{
+    current = target;
+    delta.b0 = delta.b1 = delta.b2 = delta.a1 = delta.a2 = 0.0f;
+    samplesToTarget = 0;
+}
+
+//==============================================================================
+BiquadCascade::BiquadCascade (int numStagesToUse)
+    : numStages (juce::jlimit (1, maxNumStages, numStagesToUse))
+{
+    jassert (numStagesToUse <= maxNumStages);
+}
+
+void BiquadCascade::prepare (double sampleRate, double smoothingTimeSeconds)
+{
+    smoothingSamples = std::max (0, juce::roundToInt (sampleRate * smoothingTimeSeconds));
+    reset();
+}
+
+void BiquadCascade::reset() noexcept
+{
+    for (auto& s : stages)
+    {
+        std::fill (std::begin (s.z1), std::end (s.z1), 0.0f);
+        std::fill (std::begin (s.z2), std::end (s.z2), 0.0f);
+        s.snapToTarget();
+    }
+}
+
+void BiquadCascade::setCoefficients (int stage, Coefficients newCoefficients, bool snap) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stage, numStages));
+    auto& s = stages[(size_t) stage];
+    s.target = newCoefficients;
+
+    // There's no point ramping a stage that isn't being heard
+    if (snap || smoothingSamples == 0 || ! s.enabled)
+    {
+        s.snapToTarget();
+        return;
+    }
+
+    const auto scale = 1.0f / (float) smoothingSamples;
+    s.delta.b0 = (s.target.b0 - s.current.b0) * scale;
+    s.delta.b1 = (s.target.b1 - s.current.b1) * scale;
+    s.delta.b2 = (s.target.b2 - s.current.b2) * scale;
+    s.delta.a1 = (s.target.a1 - s.current.a1) * scale;
+    s.delta.a2 = (s.target.a2 - s.current.a2) * scale;
+    s.samplesToTarget = smoothingSamples;
+}
+
+BiquadCascade::Coefficients BiquadCascade::getCoefficients (int stage) const noexcept
+{
+    jassert (juce::isPositiveAndBelow (stage, numStages));
+    return stages[(size_t) stage].target;
+}
+
+void BiquadCascade::setStageEnabled (int stage, bool shouldBeEnabled) noexcept
+{
+    jassert (juce::isPositiveAndBelow (stage, numStages));
+    stages[(size_t) stage].enabled = shouldBeEnabled;
+}
+
+void BiquadCascade::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    float* channels[maxNumChannels] = {};
+    const auto numChannels = std::min (buffer.getNumChannels(), (int) maxNumChannels);
+
+    for (int i = 0; i < numChannels; ++i)
+        channels[i] = buffer.getWritePointer (i, startSample);
+
+    process (channels, numChannels, numSamples);
+}
+
+void BiquadCascade::process (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    jassert (numChannels <= maxNumChannels);
+    numChannels = std::min (numChannels, (int) maxNumChannels);
+
+    for (int done = 0; done < numSamples;)
+    {
+        // Ramp in sections that end when the next stage reaches its target
+        int numToRamp = 0;
+
+        for (int i = 0; i < numStages; ++i)
+            if (auto n = stages[(size_t) i].samplesToTarget; n > 0)
+                numToRamp = numToRamp == 0 ? n : std::min (numToRamp, n);
+
+        if (numToRamp == 0)
+        {
+            processBlock<false> (channels, numChannels, done, numSamples - done);
+            break;
+        }
+
+        const auto num = std::min (numToRamp, numSamples - done);
+        processBlock<true> (channels, numChannels, done, num);
+        done += num;
+
+        for (int i = 0; i < numStages; ++i)
+        {
+            auto& s = stages[(size_t) i];
+
+            if (s.samplesToTarget > 0 && (s.samplesToTarget -= num) == 0)
+                s.snapToTarget();
+        }
+    }
+
+    // Flush any denormals left in the state
+    for (auto& s : stages)
+    {
+        for (auto& z : s.z1)    z = std::abs (z) < 1.0e-8f ? 0.0f : z;
+        for (auto& z : s.z2)    z = std::abs (z) < 1.0e-8f ? 0.0f : z;
+    }
+}
+
+template <bool isSmoothing>
+void BiquadCascade::processBlock (float* const* channels, int numChannels, int startSample, int numSamples) noexcept
+{
+    Stage* active[maxNumStages];
+    int numActive = 0;
+
+    for (int i = 0; i < numStages; ++i)
+        if (stages[(size_t) i].enabled)
+            active[numActive++] = &stages[(size_t) i];
+
+    if (numActive == 0)
+        return;
+
+    for (int n = startSample; n < startSample + numSamples; ++n)
+    {
+        // Always run every lane so the inner loops have a fixed length
+        float x[maxNumChannels] = {};
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            x[ch] = channels[ch][n];
+
+        for (int i = 0; i < numActive; ++i)
+        {
+            auto& s = *active[i];
+            auto& c = s.current;
+
+            if constexpr (isSmoothing)
+            {
+                c.b0 += s.delta.b0;
+                c.b1 += s.delta.b1;
+                c.b2 += s.delta.b2;
+                c.a1 += s.delta.a1;
+                c.a2 += s.delta.a2;
+            }
+
+            for (int ch = 0; ch < maxNumChannels; ++ch)
+            {
+                const auto y = c.b0 * x[ch] + s.z1[ch];
+                s.z1[ch] = c.b1 * x[ch] - c.a1 * y + s.z2[ch];
+                s.z2[ch] = c.b2 * x[ch] - c.a2 * y;
+                x[ch] = y;
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch][n] = x[ch];
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
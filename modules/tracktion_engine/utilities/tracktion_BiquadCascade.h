@@ -0,0 +1,88 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    A series of biquad filters that processes all its channels together.
+
+    Each channel is a lane in a fixed-size array, so a sample of every channel
+    goes through every stage in one pass over the buffer, rather than one pass
+    per filter per channel. The stages use transposed direct form II.
+
+    When coefficients change, they can be ramped to the new values over a
+    smoothing time to avoid zipper noise.
+*/
+class BiquadCascade
+{
+public:
+    static constexpr int maxNumChannels = 2;
+    static constexpr int maxNumStages = 4;
+
+    /** The normalised coefficients of a single biquad. */
+    struct Coefficients
+    {
+        Coefficients() = default;
+
+        /** Creates a set of coefficients from some juce::IIRCoefficients. */
+        Coefficients (const juce::IIRCoefficients&) noexcept;
+
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    /** Creates a cascade with a number of stages, all of which initially pass audio through unchanged. */
+    BiquadCascade (int numStages = 1);
+
+    /** Sets the time coefficient changes are ramped over. 0 means they change immediately. */
+    void prepare (double sampleRate, double smoothingTimeSeconds);
+
+    /** Clears the filters' state and jumps any coefficients that are ramping to their targets. */
+    void reset() noexcept;
+
+    /** Returns the number of stages this was created with. */
+    int getNumStages() const noexcept                   { return numStages; }
+
+    /** Sets a stage's coefficients, ramping to them unless snap is true. */
+    void setCoefficients (int stage, Coefficients, bool snap = false) noexcept;
+
+    /** Returns the coefficients a stage is set to, or ramping towards. */
+    Coefficients getCoefficients (int stage) const noexcept;
+
+    /** Disabled stages are skipped when processing. Stages are enabled by default. */
+    void setStageEnabled (int stage, bool) noexcept;
+
+    /** Filters some channels in place. */
+    void process (float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Filters a section of a buffer in place. Only the first maxNumChannels channels are filtered. */
+    void process (juce::AudioBuffer<float>&, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct Stage
+    {
+        Coefficients current, target, delta;
+        float z1[maxNumChannels] = {}, z2[maxNumChannels] = {};
+        int samplesToTarget = 0;
+        bool enabled = true;
+
+        void snapToTarget() noexcept;
+    };
+
+    std::array<Stage, maxNumStages> stages;
+    int numStages = 1, smoothingSamples = 0;
+
+    template <bool isSmoothing>
+    void processBlock (float* const* channels, int numChannels, int startSample, int numSamples) noexcept;
+};
+
+}} // namespace tracktion { inline namespace engine
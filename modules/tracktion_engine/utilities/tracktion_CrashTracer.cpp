@@ -15,147 +15,157 @@ struct CrashStackTracer::CrashTraceThreads
 {
     CrashTraceThreads()
     {
-        entries.ensureStorageAllocated (64);
+        stacks.ensureStorageAllocated (64);
     }
 
-    inline void push (CrashStackTracer* c)
+    // These are only called when a thread first uses a CRASH_TRACER and when it exits
+    void add (ThreadStack* s)
     {
-        entries.add (c);
+        stacks.add (s);
     }
 
-    inline void pop (CrashStackTracer* c)
+    void remove (ThreadStack* s)
     {
-        entries.removeFirstMatchingValue (c);
+        stacks.removeFirstMatchingValue (s);
+    }
+
+    /** Calls a function for each frame of a thread's stack, innermost first. */
+    template<typename FrameVisitor>
+    static void visitFrames (const ThreadStack& s, FrameVisitor&& visit)
+    {
+        for (int i = std::min (s.depth.load (std::memory_order_acquire), ThreadStack::maxDepth); --i >= 0;)
+            if (! visit (s.frames[(size_t) i]))
+                return;
+    }
+
+    static juce::String getLocation (const ThreadStack::Frame& f)
+    {
+        return juce::File::createFileWithoutCheckingPath (f.file).getFileName()
+                + ":" + juce::String (f.function) + ":" + juce::String (f.line);
     }
 
     void dump() const
     {
       #if TRACKTION_LOG_ENABLED
-        juce::Array<juce::Thread::ThreadID> threads;
+        const juce::SpinLock::ScopedLockType sl (stacks.getLock());
+        int j = 0;
 
-        for (int i = entries.size(); --i >= 0;)
-            threads.addIfNotAlreadyThere (entries.getUnchecked (i)->threadID);
-
-        for (int j = 0; j < threads.size(); ++j)
+        for (auto s : stacks)
         {
-            TRACKTION_LOG ("Thread " + juce::String (j) + ":");
+            if (s->depth.load (std::memory_order_acquire) <= 0)
+                continue;
 
-            auto thread = threads.getUnchecked(j);
+            TRACKTION_LOG ("Thread " + juce::String (j++) + ":");
             int n = 0;
 
-            for (int i = entries.size(); --i >= 0;)
-            {
-                auto& s = *entries.getUnchecked (i);
-
-                if (s.threadID == thread)
-                {
-                    if (s.pluginName != nullptr)
-                        TRACKTION_LOG ("  ** Plugin crashed: " + juce::String (s.pluginName));
-
-                    TRACKTION_LOG ("  " + juce::String (n++) + ": "
-                                    + juce::File::createFileWithoutCheckingPath (s.file).getFileName()
-                                    + ":" + juce::String (s.function) + ":" + juce::String (s.line));
+            visitFrames (*s, [&n] (auto& f)
+                         {
+                             if (f.pluginName != nullptr)
+                                 TRACKTION_LOG ("  ** Plugin crashed: " + juce::String (f.pluginName));
 
-                }
-            }
+                             TRACKTION_LOG ("  " + juce::String (n++) + ": " + getLocation (f));
+                             return true;
+                         });
         }
       #endif
     }
 
     void dump (juce::OutputStream& os, juce::Thread::ThreadID threadIDToDump) const
     {
-        juce::Array<juce::Thread::ThreadID> threads;
+        const juce::SpinLock::ScopedLockType sl (stacks.getLock());
+        int j = 0;
 
-        for (int i = entries.size(); --i >= 0;)
+        for (auto s : stacks)
         {
-            auto entryThreadID = entries.getUnchecked (i)->threadID;
+            if (s->depth.load (std::memory_order_acquire) <= 0)
+                continue;
 
-            if (entryThreadID == threadIDToDump || entryThreadID == juce::Thread::ThreadID())
-                threads.addIfNotAlreadyThere (entryThreadID);
-        }
+            if (! (s->threadID == threadIDToDump || s->threadID == juce::Thread::ThreadID()))
+                continue;
 
-        for (int j = 0; j < threads.size(); ++j)
-        {
-            os.writeText ("Thread " + juce::String (j) + ":\n", false, false, nullptr);
-
-            auto thread = threads.getUnchecked (j);
+            os.writeText ("Thread " + juce::String (j++) + ":\n", false, false, nullptr);
             int n = 0;
 
-            for (int i = entries.size(); --i >= 0;)
-            {
-                auto& s = *entries.getUnchecked (i);
-
-                if (s.threadID == thread)
-                {
-                    if (s.pluginName != nullptr)
-                        os.writeText ("  ** Plugin crashed: " + juce::String (s.pluginName) + "\n", false, false, nullptr);
-
-                    os.writeText ("  " + juce::String (n++) + ": "
-                                   + juce::File::createFileWithoutCheckingPath (s.file).getFileName()
-                                   + ":" + juce::String (s.function) + ":" + juce::String (s.line) + "\n", false, false, nullptr);
+            visitFrames (*s, [&] (auto& f)
+                         {
+                             if (f.pluginName != nullptr)
+                                 os.writeText ("  ** Plugin crashed: " + juce::String (f.pluginName) + "\n", false, false, nullptr);
 
-                }
-            }
+                             os.writeText ("  " + juce::String (n++) + ": " + getLocation (f) + "\n", false, false, nullptr);
+                             return true;
+                         });
         }
     }
 
     juce::StringArray getCrashedPlugins() const
     {
+        const juce::SpinLock::ScopedLockType sl (stacks.getLock());
         juce::StringArray plugins;
 
-        for (auto s : entries)
-            if (s->pluginName != nullptr)
-                plugins.add (s->pluginName);
+        for (auto s : stacks)
+            visitFrames (*s, [&plugins] (auto& f)
+                         {
+                             if (f.pluginName != nullptr)
+                                 plugins.add (f.pluginName);
+
+                             return true;
+                         });
 
         return plugins;
     }
 
     juce::String getCrashedPlugin (juce::Thread::ThreadID thread)
     {
-        for (int i = entries.size(); --i >= 0;)
-        {
-            auto& s = *entries.getUnchecked (i);
+        const juce::SpinLock::ScopedLockType sl (stacks.getLock());
+        juce::String plugin;
 
-            if (s.threadID == thread)
-                if (s.pluginName != nullptr)
-                    return s.pluginName;
-        }
+        for (auto s : stacks)
+            if (s->threadID == thread)
+                visitFrames (*s, [&plugin] (auto& f)
+                             {
+                                 if (f.pluginName == nullptr)
+                                     return true;
+
+                                 plugin = f.pluginName;
+                                 return false;
+                             });
 
-        return {};
+        return plugin;
     }
 
     juce::String getCrashLocation (juce::Thread::ThreadID thread)
     {
-        for (int i = entries.size(); --i >= 0;)
+        const juce::SpinLock::ScopedLockType sl (stacks.getLock());
+
+        for (auto s : stacks)
         {
-            auto& s = *entries.getUnchecked (i);
+            if (s->threadID != thread)
+                continue;
 
-            if (s.threadID == thread)
-                return juce::File::createFileWithoutCheckingPath (s.file).getFileName()
-                     + ":" + juce::String (s.function) + ":" + juce::String (s.line);
+            juce::String location;
+            visitFrames (*s, [&location] (auto& f) { location = getLocation (f); return false; });
+
+            if (location.isNotEmpty())
+                return location;
         }
 
         return "UnknownLocation";
     }
 
-    juce::Array<CrashStackTracer*, juce::SpinLock, 100> entries;
+    juce::Array<ThreadStack*, juce::SpinLock> stacks;
 };
 
 static CrashStackTracer::CrashTraceThreads crashStack;
 
-CrashStackTracer::CrashStackTracer (const char* f, const char* fn, int l, const char* plugin)
-    : file (f), function (fn), pluginName (plugin), line (l), threadID (juce::Thread::getCurrentThreadId())
+CrashStackTracer::ThreadStack::ThreadStack()
+    : threadID (juce::Thread::getCurrentThreadId())
 {
-    crashStack.push (this);
-
-   #if ! TRACKTION_LOG_ENABLED
-    juce::ignoreUnused (file, function, pluginName, line);
-   #endif
+    crashStack.add (this);
 }
 
-CrashStackTracer::~CrashStackTracer()
+CrashStackTracer::ThreadStack::~ThreadStack()
 {
-    crashStack.pop (this);
+    crashStack.remove (this);
 }
 
 juce::StringArray CrashStackTracer::getCrashedPlugins()
@@ -13,11 +13,31 @@ namespace tracktion { inline namespace engine
 
 /**
     Used by the CRASH_TRACER macros to help provide a useful crash log of the stack.
+
+    Each thread has its own fixed-size stack of frames so creating one of these
+    just stores the location in the next frame, without any locks or lookups.
+    The location strings are the literals from the macros and are only turned
+    in to text when a crash is dumped. Frames deeper than maxDepth are counted
+    but not recorded.
 */
 struct CrashStackTracer
 {
-    CrashStackTracer (const char* file, const char* fn, int line, const char* pluginName);
-    ~CrashStackTracer();
+    CrashStackTracer (const char* file, const char* fn, int line, const char* pluginName) noexcept
+    {
+        auto& stack = ThreadStack::get();
+        const auto depth = stack.depth.load (std::memory_order_relaxed);
+
+        if (depth < ThreadStack::maxDepth)
+            stack.frames[(size_t) depth] = { file, fn, pluginName, line };
+
+        stack.depth.store (depth + 1, std::memory_order_release);
+    }
+
+    ~CrashStackTracer() noexcept
+    {
+        auto& stack = ThreadStack::get();
+        stack.depth.store (stack.depth.load (std::memory_order_relaxed) - 1, std::memory_order_release);
+    }
 
     static juce::StringArray getCrashedPlugins();
     static void dump();
@@ -29,12 +49,34 @@ struct CrashStackTracer
 
     struct CrashTraceThreads;
 
-private:
-    const char* file;
-    const char* function;
-    const char* pluginName;
-    int line;
-    juce::Thread::ThreadID threadID;
+    /** @internal. The frames for a single thread. */
+    struct ThreadStack
+    {
+        ThreadStack();
+        ~ThreadStack();
+
+        struct Frame
+        {
+            const char* file = nullptr;
+            const char* function = nullptr;
+            const char* pluginName = nullptr;
+            int line = 0;
+        };
+
+        static constexpr int maxDepth = 64;
+        std::array<Frame, maxDepth> frames;
+        std::atomic<int> depth { 0 };
+        const juce::Thread::ThreadID threadID;
+
+        /** Returns the stack for the calling thread. */
+        static ThreadStack& get() noexcept
+        {
+            thread_local ThreadStack stack;
+            return stack;
+        }
+    };
+
+    JUCE_DECLARE_NON_COPYABLE (CrashStackTracer)
 };
 
 /** This macro adds the current location to a stack which gets logged if a crash happens. */
@@ -12,53 +12,118 @@ namespace tracktion { inline namespace engine
 {
 
 /**
-    An extremely naive ditherer.
-    TODO: this could be done much better!
+    Adds TPDF dither to float samples that are about to be reduced to a lower bit depth.
+
+    The noise is high-passed triangular noise made from the difference of successive
+    uniform random values. With noise shaping on, it's also run through a second-order
+    filter that moves more of it above the range where the ear is most sensitive.
+
+    The noise is generated a block at a time, from several independent xorshift
+    generators. Nothing depends on the input, so every loop can be vectorised.
 */
 struct Ditherer
 {
-    void reset (int numBits) noexcept
+    /** Prepares the ditherer for a bit depth and resets its state. */
+    void reset (int numBits, bool useNoiseShaping = true) noexcept
     {
         auto wordLen = std::pow (2.0f, (float)(numBits - 1));
         auto invWordLen = 1.0f / wordLen;
-        amp = invWordLen / RAND_MAX;
+        amp = invWordLen;
         offset = invWordLen * 0.5f;
+        noiseShaping = useNoiseShaping;
+        lastRandom = 0.0f;
+        e1 = e2 = 0.0f;
+
+        // Each instance gets its own seeds so channels aren't dithered with the same noise
+        static std::atomic<uint32_t> seedCounter { 0 };
+        auto seed = seedCounter.fetch_add (1, std::memory_order_relaxed) * 0x9e3779b9u;
+
+        for (auto& state : generators)
+        {
+            seed += 0x6d2b79f5u;
+            auto z = seed;
+            z = (z ^ (z >> 15)) * 0x2c1b3c6du;
+            z = (z ^ (z >> 12)) * 0x297a2d39u;
+            z ^= z >> 15;
+            state = z != 0 ? z : 0x1234567u;
+        }
     }
 
     //==============================================================================
     void process (float* samps, int num) noexcept
     {
-        while (--num >= 0)
+        while (num > 0)
         {
-            random2 = random1;
-            random1 = rand();
+            const int numThisTime = std::min (num, blockSize);
+            fillNoise (numThisTime);
 
-            auto in = *samps;
-
-            // check for dodgy numbers coming in..
-            if (in < -0.000001f || in > 0.000001f)
+            for (int i = 0; i < numThisTime; ++i)
             {
-                in += 0.5f * (s1 + s1 - s2);
-                auto out = in + offset + amp * (float)(random1 - random2);
-                *samps++ = out;
-                s2 = s1;
-                s1 = in - out;
-            }
-            else
-            {
-                *samps++ = in;
-                in += 0.5f * (s1 + s1 - s2);
-                auto out = in + offset + amp * (float)(random1 - random2);
-                s2 = s1;
-                s1 = in - out;
+                // check for dodgy numbers coming in..
+                const auto in = samps[i];
+                samps[i] = (in < -0.000001f || in > 0.000001f) ? in + noise[i] : in;
             }
+
+            samps += numThisTime;
+            num -= numThisTime;
         }
     }
 
+private:
     //==============================================================================
-    int random1 = 0, random2 = 0;
-    float amp = 0, offset = 0;
-    float s1 = 0, s2 = 0;
+    static constexpr int blockSize = 64;
+    static constexpr int numGenerators = 8;
+    static_assert (blockSize % numGenerators == 0);
+
+    uint32_t generators[numGenerators] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    float uniform[blockSize] = {}, dither[blockSize] = {}, noise[blockSize] = {};
+    float amp = 0, offset = 0, lastRandom = 0;
+    float e1 = 0, e2 = 0;
+    bool noiseShaping = true;
+
+    void fillNoise (int num) noexcept
+    {
+        jassert (num > 0 && num <= blockSize);
+
+        // Each generator fills every numGenerators'th value so they can all run side by side
+        for (int i = 0; i < blockSize; i += numGenerators)
+        {
+            for (int g = 0; g < numGenerators; ++g)
+            {
+                auto x = generators[g];
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                generators[g] = x;
+                uniform[i + g] = (float) (x >> 8) * (1.0f / 16777216.0f);
+            }
+        }
+
+        dither[0] = offset + amp * (uniform[0] - lastRandom);
+
+        for (int i = 1; i < num; ++i)
+            dither[i] = offset + amp * (uniform[i] - uniform[i - 1]);
+
+        lastRandom = uniform[num - 1];
+
+        if (! noiseShaping)
+        {
+            std::copy_n (dither, num, noise);
+            return;
+        }
+
+        // The error fed back is the dither itself, so the shaping is just a filter on the noise
+        noise[0] = dither[0] - e1 + 0.5f * e2;
+
+        if (num > 1)
+            noise[1] = dither[1] - dither[0] + 0.5f * e1;
+
+        for (int i = 2; i < num; ++i)
+            noise[i] = dither[i] - dither[i - 1] + 0.5f * dither[i - 2];
+
+        e2 = num > 1 ? dither[num - 2] : e1;
+        e1 = dither[num - 1];
+    }
 };
 
 }} // namespace tracktion { inline namespace engine
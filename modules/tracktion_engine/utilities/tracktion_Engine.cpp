@@ -63,8 +63,12 @@ void Engine::initialise()
     midiProgramManager         = std::make_unique<MidiProgramManager> (*this);
     externalControllerManager  = std::unique_ptr<ExternalControllerManager> (new ExternalControllerManager (*this));
     backgroundJobManager       = std::make_unique<BackgroundJobManager>();
+    deferredDeleter            = std::make_unique<tracktion::graph::DeferredDeleter>();
     pluginManager              = std::make_unique<PluginManager> (*this);
 
+    if (auto numSharedThreads = engineBehaviour->getNumThreadsForSharedNodeThreadPool(); numSharedThreads > 0)
+        sharedNodeThreadPool = std::make_unique<tracktion::graph::SharedNodeThreadPool> ((size_t) numSharedThreads);
+
     if (engineBehaviour->autoInitialiseDeviceManager())
     {
         deviceManager->initialise (getEngineBehaviour().shouldOpenAudioInputByDefault()
@@ -72,6 +76,15 @@ void Engine::initialise()
                                    DeviceManager::defaultNumChannelsToOpen);
     }
 
+    if (engineBehaviour->isHeadlessBatchMode())
+    {
+        // Plugins will be initialised when they're first needed and there are no
+        // controllers to talk to
+        setRunMessageThreadCallbacksOnCallingThread (true);
+        getProjectManager().initialise();
+        return;
+    }
+
     pluginManager->initialise();
     getProjectManager().initialise();
 
@@ -97,6 +110,9 @@ Engine::~Engine()
     midiProgramManager.reset();
 
     MelodyneFileReader::cleanUpOnShutdown();
+
+    // Any retired graphs may still be holding plugins
+    deferredDeleter.reset();
     pluginManager.reset();
 
     temporaryFileManager.reset();
@@ -106,15 +122,22 @@ Engine::~Engine()
     externalControllerManager.reset();
     propertyStorage.reset();
     uiBehaviour.reset();
+
+    if (engineBehaviour->isHeadlessBatchMode())
+        setRunMessageThreadCallbacksOnCallingThread (false);
+
     engineBehaviour.reset();
     audioFileManager.reset();
     midiLearnState.reset();
     audioFileFormatManager.reset();
     backToArrangerUpdateTimer.reset();
     bufferedAudioFileManager.reset();
+    sharedNodeThreadPool.reset();
 
-    instance = nullptr;
     engines.removeFirstMatchingValue (this);
+
+    if (instance == this)
+        instance = engines.getLast();
 }
 
 juce::String Engine::getVersion()
@@ -243,6 +266,17 @@ ActiveEdits& Engine::getActiveEdits() const noexcept
     return *activeEdits;
 }
 
+tracktion::graph::SharedNodeThreadPool* Engine::getSharedNodeThreadPool() const
+{
+    return sharedNodeThreadPool.get();
+}
+
+tracktion::graph::DeferredDeleter& Engine::getDeferredDeleter() const
+{
+    jassert (deferredDeleter != nullptr);
+    return *deferredDeleter;
+}
+
 GrooveTemplateManager& Engine::getGrooveTemplateManager()
 {
     if (! grooveTemplateManager)
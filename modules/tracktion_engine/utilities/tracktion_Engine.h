@@ -79,6 +79,8 @@ public:
     ProjectManager& getProjectManager() const;                          ///< Returns the ProjectManager instance.
     SharedTimer& getBackToArrangerUpdateTimer() const;                  ///< Returns the SharedTimer instance.
     BufferedAudioFileManager& getBufferedAudioFileManager();            ///< Returns the BufferedAudioFileManager instance
+    tracktion::graph::SharedNodeThreadPool* getSharedNodeThreadPool() const;   ///< Returns the SharedNodeThreadPool, if EngineBehaviour::getNumThreadsForSharedNodeThreadPool enabled one.
+    tracktion::graph::DeferredDeleter& getDeferredDeleter() const;      ///< Returns the DeferredDeleter used to destroy retired playback graphs off the audio and message threads.
 
     using WeakRef = juce::WeakReference<Engine>;
 
@@ -108,6 +110,8 @@ private:
     mutable std::unique_ptr<WarpTimeFactory> warpTimeFactory;
     mutable std::unique_ptr<SharedTimer> backToArrangerUpdateTimer;
     std::unique_ptr<BufferedAudioFileManager> bufferedAudioFileManager;
+    std::unique_ptr<tracktion::graph::SharedNodeThreadPool> sharedNodeThreadPool;
+    std::unique_ptr<tracktion::graph::DeferredDeleter> deferredDeleter;
 
     JUCE_DECLARE_WEAK_REFERENCEABLE (Engine)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Engine)
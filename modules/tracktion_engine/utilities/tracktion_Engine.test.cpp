@@ -0,0 +1,77 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_HEADLESSENGINE
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class HeadlessEngineBenchmarks  : public juce::UnitTest
+{
+public:
+    HeadlessEngineBenchmarks()
+        : juce::UnitTest ("HeadlessEngine", "tracktion_benchmarks")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Benchmark: Cold start to first render");
+
+        juce::TemporaryFile destFile (".wav");
+        bool wasRendered = false;
+
+        {
+            ScopedBenchmark sb (getDescription ("Cold start to first render"));
+
+            Engine engine ("HeadlessEngineBenchmarks", nullptr, std::make_unique<HeadlessBehaviour>());
+            auto edit = Edit::createSingleTrackEdit (engine, Edit::forRendering);
+            auto track = getAudioTracks (*edit)[0];
+
+            if (auto synth = edit->getPluginCache().createNewPlugin (FourOscPlugin::xmlTypeName, {}))
+                track->pluginList.insertPlugin (synth, 0, nullptr);
+
+            auto midiClip = track->insertMIDIClip ({ 0.0s, TimePosition (1.0s) }, nullptr);
+            midiClip->getSequence().addNote (69, BeatPosition::fromBeats (0.0), BeatDuration::fromBeats (1.0), 127, 0, nullptr);
+
+            Renderer::Parameters params (*edit);
+            params.destFile = destFile.getFile();
+            params.audioFormat = engine.getAudioFileFormatManager().getWavFormat();
+            params.time = { 0.0s, TimePosition (1.0s) };
+            params.tracksToDo = toBitSet (getAllTracks (*edit));
+
+            wasRendered = Renderer::renderToFile ({}, params).existsAsFile();
+        }
+
+        expect (wasRendered);
+    }
+
+private:
+    struct HeadlessBehaviour  : public EngineBehaviour
+    {
+        bool isHeadlessBatchMode() override     { return true; }
+    };
+
+    BenchmarkDescription getDescription (std::string bmName)
+    {
+        const auto bmCategory = (getName() + "/" + getCategory()).toStdString();
+        const auto bmDescription = bmName;
+
+        return { std::hash<std::string>{} (bmName + bmCategory + bmDescription),
+                 bmCategory, bmName, bmDescription };
+    }
+};
+
+static HeadlessEngineBenchmarks headlessEngineBenchmarks;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif //TRACKTION_BENCHMARKS
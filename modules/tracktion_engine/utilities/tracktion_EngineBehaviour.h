@@ -34,6 +34,15 @@ public:
     EngineBehaviour() = default;
     virtual ~EngineBehaviour() = default;
 
+    //==============================================================================
+    /// Return true to run the engine with no devices or UI, e.g. for batch rendering
+    /// in a container. This doesn't open any audio or MIDI devices or create control
+    /// surfaces, only initialises the PluginManager when a plugin is first needed and
+    /// runs callBlocking functions on the calling thread so Edits can be loaded and
+    /// rendered without a message loop running. Renderer will also render on the
+    /// calling thread rather than using UIBehaviour::runTaskWithProgressBar.
+    virtual bool isHeadlessBatchMode()                                              { return false; }
+
     //==============================================================================
     // Plugin related settings:
 
@@ -59,6 +68,27 @@ public:
     /// or examining. Override this if you always need a plugin loaded
     virtual bool shouldLoadPlugin (ExternalPlugin&);
 
+    /// Should return true if instances of this plugin can be created on a background thread.
+    /// When an Edit loads, these are created concurrently whilst the others are created on
+    /// the message thread. JUCE's plugin formats create their instances on the message thread
+    /// so only return true if PluginManager::createPluginInstance has been replaced with
+    /// something that doesn't need it (e.g. one that hosts plugins out-of-process).
+    virtual bool canCreatePluginInstanceOnBackgroundThread (const juce::PluginDescription&)   { return false; }
+
+    /// Should return true to keep a cache of AudioFileInfos on disk so audio file
+    /// headers don't have to be re-read each session. @see AudioFileInfoCache
+    virtual bool shouldCacheAudioFileInfo()                                         { return true; }
+
+    /// Should return true to save Edits as BinaryEditFiles rather than XML.
+    /// These are quicker to load and save but can't be read by older versions of the engine.
+    virtual bool shouldSaveEditsAsBinaryEditFiles()                                 { return false; }
+
+    /// Should return true if the state of this plugin can be read on a background thread whilst
+    /// the message thread carries on. PluginStateCapture reads these states in parallel and the
+    /// others one at a time on the message thread. By default only AudioUnits are allowed as
+    /// VST and VST3 plugins commonly expect their state to be read on the message thread.
+    virtual bool canCapturePluginStateOnBackgroundThread (const juce::PluginDescription& d)  { return d.pluginFormatName == "AudioUnit"; }
+
     /// Gives plugins an opportunity to save custom data when the plugin state gets flushed.
     virtual void saveCustomPluginProperties (juce::ValueTree&, juce::AudioPluginInstance&, juce::UndoManager*)  {}
 
@@ -76,12 +106,27 @@ public:
     */
     virtual bool canScanPluginsOutOfProcess()                                       { return false; }
 
+    /// Should return true to keep a record of the plugins found in each binary so
+    /// binaries that haven't changed aren't loaded again by later scans. @see PluginScanCache
+    virtual bool shouldCachePluginScanResults()                                     { return true; }
+
+    /// Should return true to rescan any new or changed plugins in the background
+    /// when the PluginManager is initialised. @see PluginManager::startIncrementalPluginScan
+    virtual bool shouldRescanPluginsOnStartup()                                     { return false; }
+
+    /// Should return true to load this plugin in a child process so it can't crash
+    /// or stall the engine. The app must call PluginManager::startChildProcessPluginHost
+    /// in its start-up code for this to work. Creating these blocks until the child has
+    /// loaded the plugin, so when an Edit is loaded they're created on background threads
+    /// whatever canCreatePluginInstanceOnBackgroundThread returns. @see SandboxedPluginInstance
+    virtual bool shouldHostPluginInSeparateProcess (const juce::PluginDescription&) { return false; }
+
     //==============================================================================
     // Playback settings
 
     /// You may want to disable auto initialisation of the device manager if you
     /// are using the engine in a plugin.
-    virtual bool autoInitialiseDeviceManager()                                      { return true; }
+    virtual bool autoInitialiseDeviceManager()                                      { return ! isHeadlessBatchMode(); }
 
     /// In plugin builds, you might want to avoid adding the system audio devices
     /// and only use the host inputs.
@@ -107,15 +152,65 @@ public:
     /// which means they won't introduce latency which can be useful for tracking.
     virtual bool shouldBypassedPluginsBeRemovedFromPlaybackGraph()                  { return false; }
 
+    /// If this returns true for a plugin, it won't be processed whilst the user is dragging the
+    /// playhead and its input is passed through instead. This can be used for plugins that are
+    /// too heavy to keep scrubbing responsive. Offline renders always process every plugin.
+    virtual bool shouldBypassPluginWhileScrubbing (Plugin&)                         { return false; }
+
+    /// If this returns true for an effect, it'll be put to sleep and not processed whilst its
+    /// input and output are silent. This is off by default as some plugins make sound without
+    /// any input or have tails they don't report. Instruments are never put to sleep.
+    /// @see Plugin::canSleepWhenSilent
+    virtual bool canExternalPluginSleepWhenSilent (const juce::PluginDescription&)  { return false; }
+
     /// Whether or not to include muted track contents in aux send plugins.
     /// Returning true here enables you to still listen to return busses when send tracks are
     /// muted or other tracks are soloed.
     virtual bool shouldProcessAuxSendWhenTrackIsMuted (AuxSendPlugin&)              { return true; }
 
-    /// TEMPORARY: If enabled, real-time time-stretch Nodes will use a larger buffer and background
-    /// thread to reduce audio CPU use.
+    /// If enabled, real-time time-stretch Nodes will use a larger buffer and a pool of background
+    /// threads to reduce audio CPU use.
     virtual bool enableReadAheadForTimeStretchNodes()                               { return false; }
 
+    /// If enabled, the contents of ContainerClips are rendered to files in the background and
+    /// played back from those. Clips are played live again whilst their contents are changing.
+    virtual bool shouldPreRenderContainerClips()                                    { return false; }
+
+    /// If enabled, tracks that are monitoring live audio input are mixed in after the master
+    /// plugins and aren't delayed to line up with the latency of the rest of the Edit, so
+    /// they're only held back by their own plugins. Anything else on those tracks is early.
+    virtual bool shouldUseDirectMonitoring()                                        { return false; }
+
+    /// If enabled, Modifiers that only change once per block, like LFOs, are evaluated a block
+    /// ahead on a background thread during playback instead of on the audio thread.
+    virtual bool shouldEvaluateModifiersAhead()                                     { return false; }
+
+    /// If this returns a folder, compiled Cmajor patches will be loaded from it before being
+    /// JIT compiled. This lets deployments ship patches compiled ahead of time by copying the
+    /// patch cache folder from a machine that has loaded them. The folder is never written to.
+    virtual juce::File getPrecompiledCmajorPatchFolder()                            { return {}; }
+
+    /// Determines how the pages of memory-mapped audio files are treated.
+    struct MemoryMappedAudioSettings
+    {
+        bool useHugePages = false;      ///< Asks the OS to back mapped files with huge pages where supported to reduce TLB misses
+        bool prefaultPages = false;     ///< Faults in the pages about to be read on a background thread as soon as they're mapped
+    };
+
+    /// Returns the settings to use when memory-mapping audio files.
+    /// N.B. this is called from background threads so should be thread safe and quick to return.
+    virtual MemoryMappedAudioSettings getMemoryMappedAudioSettings()                { return {}; }
+
+    /// Determines how SamplerPlugin holds the audio for its sounds.
+    struct SamplerStreamingSettings
+    {
+        bool streamFromDisk = false;    ///< Keeps only the start of long sounds in memory and reads the rest from the AudioFileCache as they play
+        int preloadSamples = 65536;     ///< The number of samples at the start of each streamed sound that are held in memory
+    };
+
+    /// Returns the settings SamplerPlugin uses when loading its sounds.
+    virtual SamplerStreamingSettings getSamplerStreamingSettings()                  { return {}; }
+
     /// Should return true if the incoming timestamp for MIDI messages should be used.
     /// If this returns false, the current system time will be used (which could be less accurate).
     /// N.B. this is called from multiple threads, including the MIDI thread for every
@@ -127,6 +222,28 @@ public:
 
     virtual int getNumberOfCPUsToUseForAudio()                                      { return juce::jmax (1, juce::SystemStats::getNumCpus()); }
 
+    /// If this returns more than 0, the Engine creates a SharedNodeThreadPool with this
+    /// many threads and every Edit's playback and renders use it rather than creating
+    /// their own threads. Use this when running many Edits at once so the number of
+    /// threads doesn't grow with the number of Edits.
+    virtual int getNumThreadsForSharedNodeThreadPool()                              { return 0; }
+
+    /// When using a shared pool, Edits with a higher priority are processed first.
+    /// This is called when playback or a render starts for the Edit.
+    virtual int getSharedNodeThreadPoolPriority (Edit&)                             { return 0; }
+
+    /// If this returns a backend, ImpulseResponsePlugins use it to convolve the late
+    /// parts of their IRs, e.g. batched together on a GPU, instead of the CPU threads.
+    /// This is called whenever a plugin's convolver is created.
+    virtual std::shared_ptr<ConvolutionBackend> getConvolutionBackend()             { return {}; }
+
+    /// If this returns more than 0, parameters that are attached to a CachedValue and
+    /// moved from the UI or a controller only write to their ValueTree at most this
+    /// often, in milliseconds, until they stop moving or their gesture ends.
+    /// The audio thread always sees the new value immediately, this just avoids a
+    /// synchronous ValueTree update and its listener callbacks for every move.
+    virtual int getParameterStateUpdateIntervalMs (Edit&)                           { return 0; }
+
     /// Should muted tracks processing be disabled to save CPU
     virtual bool shouldProcessMutedTracks()                                         { return false; }
 
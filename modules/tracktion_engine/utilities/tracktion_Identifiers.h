@@ -231,8 +231,10 @@ namespace IDs
     DECLARE_ID (SIDECHAINCONNECTIONS)
     DECLARE_ID (sidechainTrigger)
     DECLARE_ID (sidechainDb)
+    DECLARE_ID (lookAheadMs)
     DECLARE_ID (frequency)
     DECLARE_ID (mode)
+    DECLARE_ID (algorithm)
     DECLARE_ID (loFreq)
     DECLARE_ID (loGain)
     DECLARE_ID (loQ)
@@ -355,6 +357,7 @@ namespace IDs
     DECLARE_ID (channels)
     DECLARE_ID (elastiqueMode)
     DECLARE_ID (elastiqueOptions)
+    DECLARE_ID (readAhead)
     DECLARE_ID (timeStretch)
     DECLARE_ID (stretchMode)
     DECLARE_ID (pitchChange)
@@ -17,45 +17,23 @@ inline int oddEven (int x)
 }
 
 //==============================================================================
-static float sine (float phase)
+// Fourier series coefficients of the shapes, i.e. the gain of the sine at harmonic k
+static double triangleHarmonic (int k)
 {
-    return std::sin (phase * 2 * juce::MathConstants<float>::pi);
-}
+    if (k % 2 == 0)
+        return 0.0;
 
-static float triangle (float phase, float freq, double sampleRate)
-{
-    float sum = 0;
-    int k = 1;
-    while (freq * k < sampleRate / 2)
-    {
-        sum += std::pow (-1.0f, (k - 1.0f) / 2.0f) / (k * k) * std::sin (k * (phase * 2 * juce::MathConstants<float>::pi));
-        k += 2;
-    }
-    return float (8.0f / (juce::MathConstants<float>::pi * juce::MathConstants<float>::pi) * sum);
+    return (((k - 1) / 2) % 2 == 0 ? 1.0 : -1.0) * 8.0 / (juce::MathConstants<double>::pi * juce::MathConstants<double>::pi * k * k);
 }
 
-static float sawUp (float phase, float freq, double sampleRate)
+static double sawUpHarmonic (int k)
 {
-    float sum = 0;
-    int k = 1;
-    while (freq * k < sampleRate / 2)
-    {
-        sum += oddEven (k) * std::sin (k * (phase * 2 * juce::MathConstants<float>::pi)) / k;
-        k++;
-    }
-    return float (-2.0f / juce::MathConstants<float>::pi * sum);
+    return -2.0 / juce::MathConstants<double>::pi * oddEven (k) / k;
 }
 
-static float sawDown (float phase, float freq, double sampleRate)
+static double sawDownHarmonic (int k)
 {
-    float sum = 0;
-    int k = 1;
-    while (freq * k < sampleRate / 2)
-    {
-        sum += oddEven (k) * std::sin (k * (phase * 2 * juce::MathConstants<float>::pi)) / k;
-        k++;
-    }
-    return float (2.0f / juce::MathConstants<float>::pi * sum);
+    return -sawUpHarmonic (k);
 }
 
 //==============================================================================
@@ -82,8 +60,8 @@ void Oscillator::process (juce::AudioBuffer<float>& buffer, int startSample, int
             case none:      break;
             case sine:      processSine (buffer, startSample, numSamples);  break;
             case square:    processSquare (buffer, startSample, numSamples);  break;
-            case saw:       processLookup (buffer, startSample, numSamples, lookupTables->sawUpFunctions);    break;
-            case triangle:  processLookup (buffer, startSample, numSamples, lookupTables->triangleFunctions); break;
+            case saw:       processLookup (buffer, startSample, numSamples, BandlimitedWaveLookupTables::Shape::sawUp);    break;
+            case triangle:  processLookup (buffer, startSample, numSamples, BandlimitedWaveLookupTables::Shape::triangle); break;
             case noise:     processNoise (buffer, startSample, numSamples); break;
         }
     }
@@ -99,9 +77,11 @@ void Oscillator::processSine (juce::AudioBuffer<float>& buffer, int startSample,
     auto* channels = buffer.getArrayOfWritePointers();
     const int numChannels = buffer.getNumChannels();
 
+    auto& table = lookupTables->getSineTable();
+
     for (int samp = 0; samp < numSamples; samp++)
     {
-        float value = lookupTables->sineFunction[phase] * gain;
+        float value = table.getSample (phase) * gain;
         for (int ch = 0; ch < numChannels; ch++)
             channels[ch][startSample + samp] += value;
 
@@ -125,7 +105,7 @@ void Oscillator::processNoise (juce::AudioBuffer<float>& buffer, int startSample
 }
 
 void Oscillator::processLookup (juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
-                                const juce::OwnedArray<juce::dsp::LookupTableTransform<float>>& tableSet)
+                                BandlimitedWaveLookupTables::Shape shape)
 {
     const float frequency = std::min (float (sampleRate) / 2.0f, 440.0f * std::pow (2.0f, (note - 69.0f) / 12.0f));
     const float period = 1.0f / float (frequency);
@@ -135,23 +115,17 @@ void Oscillator::processLookup (juce::AudioBuffer<float>& buffer, int startSampl
     auto* channels = buffer.getArrayOfWritePointers();
     const int numChannels = buffer.getNumChannels();
 
-    int tableIndex = juce::jlimit (0, tableSet.size() - 1, int ((note - 0.5) / lookupTables->tablePerNumNotes));
+    auto& table = lookupTables->getTable (shape, note);
 
-    auto table = tableSet[tableIndex];
-    jassert (table != nullptr);
-
-    if (table != nullptr)
+    for (int samp = 0; samp < numSamples; samp++)
     {
-        for (int samp = 0; samp < numSamples; samp++)
-        {
-            float value = table->processSampleUnchecked (phase) * gain;
-            for (int ch = 0; ch < numChannels; ch++)
-                channels[ch][startSample + samp] += value;
+        float value = table.getSample (phase) * gain;
+        for (int ch = 0; ch < numChannels; ch++)
+            channels[ch][startSample + samp] += value;
 
-            phase += delta;
-            while (phase >= 1.0f)
-                phase -= 1.0f;
-        }
+        phase += delta;
+        while (phase >= 1.0f)
+            phase -= 1.0f;
     }
 }
 
@@ -165,65 +139,55 @@ void Oscillator::processSquare (juce::AudioBuffer<float>& buffer, int startSampl
     auto* channels = buffer.getArrayOfWritePointers();
     const int numChannels = buffer.getNumChannels();
 
-    int tableIndex = juce::jlimit (0, lookupTables->sawUpFunctions.size() - 1, int ((note - 0.5) / lookupTables->tablePerNumNotes));
-
-    auto saw1 = lookupTables->sawUpFunctions[tableIndex];
-    auto saw2 = lookupTables->sawDownFunctions[tableIndex];
-
-    jassert (saw1 != nullptr && saw2 != nullptr);
+    auto& saw1 = lookupTables->getTable (BandlimitedWaveLookupTables::Shape::sawUp, note);
+    auto& saw2 = lookupTables->getTable (BandlimitedWaveLookupTables::Shape::sawDown, note);
 
-    if (saw1 != nullptr && saw2 != nullptr)
+    for (int samp = 0; samp < numSamples; samp++)
     {
-        for (int samp = 0; samp < numSamples; samp++)
-        {
-            float phaseUp   = phase + 0.5f * pulseWidth;
-            float phaseDown = phase - 0.5f * pulseWidth;
+        float phaseUp   = phase + 0.5f * pulseWidth;
+        float phaseDown = phase - 0.5f * pulseWidth;
 
-            if (phaseUp   > 1.0f) phaseUp   -= 1.0f;
-            if (phaseDown < 0.0f) phaseDown += 1.0f;
+        if (phaseUp   > 1.0f) phaseUp   -= 1.0f;
+        if (phaseDown < 0.0f) phaseDown += 1.0f;
 
-            float value = (saw1->processSampleUnchecked (phaseUp) +
-                           saw2->processSampleUnchecked (phaseDown)) * gain;
+        float value = (saw1.getSample (phaseUp) + saw2.getSample (phaseDown)) * gain;
 
-            for (int ch = 0; ch < numChannels; ch++)
-                channels[ch][startSample + samp] += value;
+        for (int ch = 0; ch < numChannels; ch++)
+            channels[ch][startSample + samp] += value;
 
-            phase += delta;
-            while (phase >= 1.0f)
-                phase -= 1.0f;
-        }
+        phase += delta;
+        while (phase >= 1.0f)
+            phase -= 1.0f;
     }
 }
 
 //==============================================================================
 MultiVoiceOscillator::MultiVoiceOscillator (int maxVoices)
+    : phases ((size_t) maxVoices), deltas ((size_t) maxVoices),
+      leftGains ((size_t) maxVoices), rightGains ((size_t) maxVoices),
+      tables ((size_t) maxVoices), secondTables ((size_t) maxVoices)
 {
-    for (int i = 0; i < maxVoices * 2; i++)
-        oscillators.add (new Oscillator());
 }
 
 void MultiVoiceOscillator::start()
 {
     static juce::Random r;
 
-    for (int i = 0; i < oscillators.size(); i += 2)
-    {
-        float phase = r.nextFloat();
-        oscillators[i + 0]->start (phase);
-        oscillators[i + 1]->start (phase);
-    }
+    for (auto& p : phases)
+        p = r.nextFloat();
 }
 
 void MultiVoiceOscillator::setSampleRate (double sr)
 {
-    for (auto o : oscillators)
-        o->setSampleRate (sr);
+    sampleRate = sr;
+
+    if (lookupTables == nullptr || sampleRate != lookupTables->sampleRate)
+        lookupTables = BandlimitedWaveLookupTables::getLookupTables (sampleRate);
 }
 
 void MultiVoiceOscillator::setWave (Oscillator::Waves w)
 {
-    for (auto o : oscillators)
-        o->setWave (w);
+    wave = w;
 }
 
 void MultiVoiceOscillator::setNote (float n)
@@ -243,8 +207,7 @@ void MultiVoiceOscillator::setPan (float p)
 
 void MultiVoiceOscillator::setPulseWidth (float p)
 {
-    for (auto o : oscillators)
-        o->setPulseWidth (p);
+    pulseWidth = p;
 }
 
 void MultiVoiceOscillator::setNumVoices (int n)
@@ -262,106 +225,225 @@ void MultiVoiceOscillator::setSpread (float s)
     spread = s;
 }
 
-void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+int MultiVoiceOscillator::updateLanes()
 {
-    if (voices == 1)
+    const int numLanes = std::min (voices, (int) phases.size());
+
+    using Shape = BandlimitedWaveLookupTables::Shape;
+
+    for (int i = 0; i < numLanes; ++i)
     {
-        float leftGain  = 1.0f - pan;
-        float rightGain = 1.0f + pan;
+        float laneNote = note;
+        float localPan = pan;
 
-        for (int i = 0; i < 2; i++)
+        if (voices > 1)
         {
-            bool left = (i % 2) == 0;
-            float panGain = left ? leftGain : rightGain;
-
-            float* data = buffer.getWritePointer (left ? 0 : 1, startSample);
-            float* dataPointers[] = {data};
+            laneNote = (note - detune / 2) + detune / (voices - 1) * i;
+            localPan = juce::jlimit (-1.0f, 1.0f, ((i % 2 == 0) ? 1 : -1) * spread);
+        }
 
-            juce::AudioBuffer<float> channelBuffer (dataPointers, 1, numSamples);
+        const float frequency = std::min (float (sampleRate) / 2.0f, 440.0f * std::pow (2.0f, (laneNote - 69.0f) / 12.0f));
+        deltas[(size_t) i] = float (frequency / sampleRate);
 
-            auto& o = *oscillators[i];
+        leftGains[(size_t) i]  = gain * (1.0f - localPan) / voices;
+        rightGains[(size_t) i] = gain * (1.0f + localPan) / voices;
 
-            o.setGain (gain * panGain / voices);
-            o.setNote (note);
-            o.process (channelBuffer, 0, numSamples);
+        switch (wave)
+        {
+            case Oscillator::sine:      tables[(size_t) i] = &lookupTables->getSineTable(); break;
+            case Oscillator::saw:       tables[(size_t) i] = &lookupTables->getTable (Shape::sawUp, laneNote); break;
+            case Oscillator::triangle:  tables[(size_t) i] = &lookupTables->getTable (Shape::triangle, laneNote); break;
+            case Oscillator::square:
+                tables[(size_t) i]       = &lookupTables->getTable (Shape::sawUp, laneNote);
+                secondTables[(size_t) i] = &lookupTables->getTable (Shape::sawDown, laneNote);
+                break;
+            case Oscillator::none:
+            case Oscillator::noise:
+            default:
+                break;
         }
     }
-    else
+
+    return numLanes;
+}
+
+template<typename LaneFunction>
+void MultiVoiceOscillator::processLanes (float* left, float* right, int numLanes, int numSamples, LaneFunction&& getLaneValue)
+{
+    auto* phase = phases.data();
+    auto* delta = deltas.data();
+    auto* leftGain = leftGains.data();
+    auto* rightGain = rightGains.data();
+
+    for (int samp = 0; samp < numSamples; ++samp)
     {
-        for (int i = 0; i < std::min (voices * 2, oscillators.size()); i++)
+        float l = 0.0f, r = 0.0f;
+
+        for (int i = 0; i < numLanes; ++i)
         {
-            int voiceIndex = (i / 2);
-            float localPan = juce::jlimit (-1.0f, 1.0f, ((voiceIndex % 2 == 0) ? 1 : -1) * spread);
+            const float value = getLaneValue (i, phase[i]);
+            l += value * leftGain[i];
+            r += value * rightGain[i];
+        }
+
+        left[samp]  += l;
+        right[samp] += r;
+
+        // The deltas are never more than 0.5 so one wrap is enough and this vectorises
+        for (int i = 0; i < numLanes; ++i)
+        {
+            const float p = phase[i] + delta[i];
+            phase[i] = p >= 1.0f ? p - 1.0f : p;
+        }
+    }
+}
+
+void MultiVoiceOscillator::processNoise (float* left, float* right, int numLanes, int numSamples)
+{
+    // Every voice would generate the same noise so it's only generated once
+    float leftGain = 0.0f, rightGain = 0.0f;
 
-            float leftGain  = 1.0f - localPan;
-            float rightGain = 1.0f + localPan;
+    for (int i = 0; i < numLanes; ++i)
+    {
+        leftGain  += leftGains[(size_t) i];
+        rightGain += rightGains[(size_t) i];
+    }
 
-            float base = note - detune / 2;
-            float delta = detune / (voices - 1);
-            bool left = (i % 2) == 0;
-            float panGain = left ? leftGain : rightGain;
+    for (int samp = 0; samp < numSamples; ++samp)
+    {
+        const float value = normalDistribution (generator);
+        left[samp]  += value * leftGain;
+        right[samp] += value * rightGain;
+    }
+}
 
-            float* data = buffer.getWritePointer (left ? 0 : 1, startSample);
-            float* dataPointers[] = {data};
+void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (lookupTables == nullptr || wave == Oscillator::none)
+        return;
+
+    const int numLanes = updateLanes();
 
-            juce::AudioBuffer<float> channelBuffer (dataPointers, 1, numSamples);
+    if (numLanes <= 0)
+        return;
 
-            auto& o = *oscillators[i];
+    float* left  = buffer.getWritePointer (0, startSample);
+    float* right = buffer.getWritePointer (1, startSample);
+
+    switch (wave)
+    {
+        case Oscillator::sine:
+        case Oscillator::saw:
+        case Oscillator::triangle:
+        {
+            auto* laneTables = tables.data();
+            processLanes (left, right, numLanes, numSamples,
+                          [laneTables] (int i, float phase) { return laneTables[i]->getSample (phase); });
+            break;
+        }
 
-            o.setGain (gain * panGain / voices);
-            o.setNote (base + delta * (i / 2));
-            o.process (channelBuffer, 0, numSamples);
+        case Oscillator::square:
+        {
+            auto* upTables = tables.data();
+            auto* downTables = secondTables.data();
+            const float halfWidth = 0.5f * pulseWidth;
+
+            processLanes (left, right, numLanes, numSamples,
+                          [upTables, downTables, halfWidth] (int i, float phase)
+                          {
+                              float phaseUp   = phase + halfWidth;
+                              float phaseDown = phase - halfWidth;
+
+                              if (phaseUp   > 1.0f) phaseUp   -= 1.0f;
+                              if (phaseDown < 0.0f) phaseDown += 1.0f;
+
+                              return upTables[i]->getSample (phaseUp)
+                                      + downTables[i]->getSample (phaseDown);
+                          });
+            break;
         }
+
+        case Oscillator::noise:
+            processNoise (left, right, numLanes, numSamples);
+            break;
+
+        case Oscillator::none:
+        default:
+            break;
     }
 }
 
 //==============================================================================
-static juce::Array<BandlimitedWaveLookupTables*> tableCache;
-
 BandlimitedWaveLookupTables::Ptr BandlimitedWaveLookupTables::getLookupTables (double sampleRate)
 {
+    // Banks are small so they're kept for the lifetime of the app rather than
+    // being rebuilt each time the last oscillator using a rate goes away
+    static juce::CriticalSection cacheLock;
+    static juce::ReferenceCountedArray<BandlimitedWaveLookupTables> tableCache;
+
+    const juce::ScopedLock sl (cacheLock);
+
     for (auto table : tableCache)
         if (table->sampleRate == sampleRate)
             return table;
 
-    Ptr table = new BandlimitedWaveLookupTables (sampleRate, 1024);
+    Ptr table = new BandlimitedWaveLookupTables (sampleRate);
+    tableCache.add (table);
     return table;
 }
 
-BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr, int tableSize)
-    : sampleRate (sr),
-      sineFunction ([] (float in) { return sine (in); }, 0.0f, 1.0f, (size_t) tableSize)
+BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr)
+    : sampleRate (sr)
 {
-    auto getMidiNoteInHertz = [](float noteNumber)
-    {
-        return 440.0f * std::pow (2.0f, (noteNumber - 69) / 12.0f);
-    };
+    static_assert (juce::isPowerOfTwo (tableSize), "The harmonic lookups below wrap with a mask");
+
+    // An exact cycle of a sine, so harmonic k at sample n can be read from index (k * n) % tableSize
+    std::vector<double> cycle ((size_t) tableSize);
 
-    auto start = juce::Time::getCurrentTime();
+    for (int n = 0; n < tableSize; ++n)
+        cycle[(size_t) n] = std::sin (n * juce::MathConstants<double>::twoPi / tableSize);
 
-    for (float note = tablePerNumNotes + 0.5f; note < 127; note += tablePerNumNotes)
+    // Two guard points are added so a phase of exactly 1 can still be interpolated
+    auto makeTable = [] (const std::vector<double>& source, Table& dest)
     {
-        const float freq = getMidiNoteInHertz (note);
+        dest.samples.resize ((size_t) tableSize + 2);
 
-        triangleFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                               { return triangle (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+        for (int n = 0; n < tableSize + 2; ++n)
+            dest.samples[(size_t) n] = (float) source[(size_t) (n & (tableSize - 1))];
+    };
 
-        sawUpFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                            { return sawUp (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+    // Each octave has as many harmonics as will fit below Nyquist for the highest note in it
+    auto getNumHarmonics = [sr] (int octave)
+    {
+        const double topFrequency = 440.0 * std::pow (2.0, (12 * (octave + 1) - 69) / 12.0);
+        return juce::jlimit (1, tableSize / 2 - 1, (int) (sr / 2.0 / topFrequency));
+    };
 
-        sawDownFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                              { return sawDown (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
-    }
+    auto buildOctaves = [&] (std::array<Table, numOctaves>& octaveTables, double (*getHarmonicGain) (int))
+    {
+        std::vector<double> sum ((size_t) tableSize, 0.0);
+        int numHarmonicsAdded = 0;
 
-    auto elapsed = (juce::Time::getCurrentTime() - start);
-    DBG ("Generating waves: " + juce::String (elapsed.inMilliseconds()) + "ms");
+        // Lower octaves contain all the harmonics of the higher ones, so they're
+        // built from the top down by adding to a running sum
+        for (int octave = numOctaves; --octave >= 0;)
+        {
+            const int numHarmonics = getNumHarmonics (octave);
 
-    tableCache.add (this);
-}
+            for (int k = numHarmonicsAdded + 1; k <= numHarmonics; ++k)
+                if (const auto harmonicGain = getHarmonicGain (k); harmonicGain != 0.0)
+                    for (int n = 0; n < tableSize; ++n)
+                        sum[(size_t) n] += harmonicGain * cycle[(size_t) ((k * n) & (tableSize - 1))];
 
-BandlimitedWaveLookupTables::~BandlimitedWaveLookupTables()
-{
-    tableCache.removeFirstMatchingValue (this);
+            numHarmonicsAdded = std::max (numHarmonicsAdded, numHarmonics);
+            makeTable (sum, octaveTables[(size_t) octave]);
+        }
+    };
+
+    makeTable (cycle, sineTable);
+    buildOctaves (tables[(size_t) Shape::triangle], triangleHarmonic);
+    buildOctaves (tables[(size_t) Shape::sawUp], sawUpHarmonic);
+    buildOctaves (tables[(size_t) Shape::sawDown], sawDownHarmonic);
 }
 
 }} // namespace tracktion { inline namespace engine
@@ -11,26 +11,65 @@ namespace tracktion { inline namespace engine
 {
 
 //==============================================================================
+/**
+    A bank of band-limited, single-cycle wavetables for a sample rate, with one
+    table per octave for each shape so higher notes don't alias.
+
+    Banks are built the first time a sample rate is used and are then shared by
+    every oscillator running at that rate.
+*/
 class BandlimitedWaveLookupTables : public juce::ReferenceCountedObject
 {
 public:
-    ~BandlimitedWaveLookupTables();
-
     using Ptr = juce::ReferenceCountedObjectPtr<BandlimitedWaveLookupTables>;
 
+    /** Returns the shared bank for a sample rate, building it if it's the first time it's been used. */
     static Ptr getLookupTables (double sampleRate);
 
     double sampleRate = 44100.0;
 
     //==============================================================================
-    juce::dsp::LookupTableTransform<float> sineFunction;
+    static constexpr int tableSize = 2048;
+    static constexpr int numOctaves = 11;
+
+    /** A single cycle of a waveform, stored contiguously with guard points at the
+        end so it can be interpolated without having to wrap the index.
+    */
+    struct Table
+    {
+        /** Returns the linearly interpolated value at a phase in the range [0, 1]. */
+        float getSample (float phase) const noexcept
+        {
+            const float pos = phase * (float) tableSize;
+            const auto index = (int) pos;
+            const float* s = samples.data() + index;
+            return s[0] + (pos - (float) index) * (s[1] - s[0]);
+        }
+
+        std::vector<float> samples;
+    };
 
-    juce::OwnedArray<juce::dsp::LookupTableTransform<float>> triangleFunctions, sawUpFunctions, sawDownFunctions;
+    enum class Shape
+    {
+        triangle,
+        sawUp,
+        sawDown
+    };
 
-    const int tablePerNumNotes = 3;
+    /** Returns the table for a shape that won't alias when played at a MIDI note. */
+    const Table& getTable (Shape shape, float midiNote) const noexcept
+    {
+        const auto octave = juce::jlimit (0, numOctaves - 1, (int) std::floor (midiNote / 12.0f));
+        return tables[(size_t) shape][(size_t) octave];
+    }
+
+    const Table& getSineTable() const noexcept          { return sineTable; }
 
 private:
-    BandlimitedWaveLookupTables (double sampleRate, int tableSize);
+    BandlimitedWaveLookupTables (double sampleRate);
+
+    Table sineTable;
+    std::array<std::array<Table, numOctaves>, 3> tables;
 };
 
 //==============================================================================
@@ -69,7 +108,7 @@ private:
     void processNoise (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
     void processLookup (juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
-                        const juce::OwnedArray<juce::dsp::LookupTableTransform<float>>& tableSet);
+                        BandlimitedWaveLookupTables::Shape);
 
     //==============================================================================
     Waves wave = sine;
@@ -83,6 +122,12 @@ private:
 };
 
 //==============================================================================
+/**
+    A bank of detuned, panned unison voices.
+    Each voice is a lane in a set of arrays rather than an Oscillator object, so all
+    the voices are advanced together in the inner loop and each is only rendered
+    once for both channels.
+*/
 class MultiVoiceOscillator
 {
 public:
@@ -103,10 +148,27 @@ public:
     void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
 private:
-    juce::OwnedArray<Oscillator> oscillators;
+    using Table = BandlimitedWaveLookupTables::Table;
+
+    int updateLanes();
+
+    template<typename LaneFunction>
+    void processLanes (float* left, float* right, int numLanes, int numSamples, LaneFunction&&);
+
+    void processNoise (float* left, float* right, int numLanes, int numSamples);
+
+    std::vector<float> phases, deltas, leftGains, rightGains;
+    std::vector<const Table*> tables, secondTables;
+
+    BandlimitedWaveLookupTables::Ptr lookupTables;
+    Oscillator::Waves wave = Oscillator::sine;
+    double sampleRate = 44100.0;
+
+    std::default_random_engine generator;
+    std::normal_distribution<float> normalDistribution {0.0f, 0.1f};
 
     int voices = 1;
-    float detune = 0, spread = 0, gain = 1.0f, note = 69.0f, pan = 0.0f;
+    float detune = 0, spread = 0, gain = 1.0f, note = 69.0f, pan = 0.0f, pulseWidth = 0.5f;
 };
 
 }} // namespace tracktion { inline namespace engine
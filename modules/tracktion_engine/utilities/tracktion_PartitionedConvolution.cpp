@@ -0,0 +1,620 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace convolution
+{
+    static int getFFTOrder (int blockSize)
+    {
+        return juce::roundToInt (std::log2 (2 * blockSize));
+    }
+
+    /** Adds the product of two spectra in the interleaved format the FFT produces. */
+    static void multiplyAdd (float* dest, const float* a, const float* b, int numBins) noexcept
+    {
+        for (int i = 0; i < numBins; ++i)
+        {
+            const auto ar = a[2 * i], ai = a[2 * i + 1];
+            const auto br = b[2 * i], bi = b[2 * i + 1];
+
+            dest[2 * i]     += ar * br - ai * bi;
+            dest[2 * i + 1] += ar * bi + ai * br;
+        }
+    }
+
+    /** Splits part of an IR into zero-padded partitions and transforms them. */
+    static std::vector<float> createSpectra (const float* ir, int numSamples, int blockSize, int numPartitions)
+    {
+        const auto spectrumSize = ConvolutionImpulseResponse::getSpectrumSize (blockSize);
+        std::vector<float> spectra ((size_t) (numPartitions * spectrumSize));
+
+        juce::dsp::FFT fft (getFFTOrder (blockSize));
+        std::vector<float> buffer ((size_t) (4 * blockSize));
+
+        for (int i = 0; i < numPartitions; ++i)
+        {
+            std::fill (buffer.begin(), buffer.end(), 0.0f);
+
+            const auto start = i * blockSize;
+            const auto num = std::min (blockSize, numSamples - start);
+            std::copy (ir + start, ir + start + num, buffer.begin());
+
+            fft.performRealOnlyForwardTransform (buffer.data(), true);
+            std::copy (buffer.begin(), buffer.begin() + spectrumSize, spectra.begin() + i * spectrumSize);
+        }
+
+        return spectra;
+    }
+
+    /** What a cached IR was created from. The hash it's stored under can collide so
+        this is compared too, using a checksum rather than keeping a copy of the samples.
+    */
+    struct CacheEntry
+    {
+        CacheEntry (const juce::AudioBuffer<float>& buffer, double rate, ConvolutionImpulseResponse::Options o)
+            : numChannels (buffer.getNumChannels()), numSamples (buffer.getNumSamples()),
+              irSampleRate (rate), options (o), checksum (createChecksum (buffer))
+        {
+        }
+
+        bool matches (const CacheEntry& other) const
+        {
+            return numChannels == other.numChannels
+                && numSamples == other.numSamples
+                && irSampleRate == other.irSampleRate
+                && options.sampleRate == other.options.sampleRate
+                && options.normalise == other.options.normalise
+                && options.trimSilence == other.options.trimSilence
+                && options.zeroLatency == other.options.zeroLatency
+                && checksum == other.checksum;
+        }
+
+        static juce::SHA256 createChecksum (const juce::AudioBuffer<float>& buffer)
+        {
+            juce::MemoryOutputStream mo;
+
+            for (int i = 0; i < buffer.getNumChannels(); ++i)
+                mo.write (buffer.getReadPointer (i), sizeof (float) * (size_t) buffer.getNumSamples());
+
+            return juce::SHA256 (mo.getData(), mo.getDataSize());
+        }
+
+        int numChannels, numSamples;
+        double irSampleRate;
+        ConvolutionImpulseResponse::Options options;
+        juce::SHA256 checksum;
+        std::weak_ptr<const ConvolutionImpulseResponse> ir;
+    };
+}
+
+//==============================================================================
+std::shared_ptr<const ConvolutionImpulseResponse> ConvolutionImpulseResponse::get (const juce::AudioBuffer<float>& buffer,
+                                                                                   double irSampleRate, Options options)
+{
+    size_t key = 0;
+
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+    {
+        auto data = buffer.getReadPointer (i);
+        hash_range (key, data, data + buffer.getNumSamples());
+    }
+
+    hash_combine (key, buffer.getNumChannels());
+    hash_combine (key, irSampleRate);
+    hash_combine (key, options.sampleRate);
+    hash_combine (key, options.normalise);
+    hash_combine (key, options.trimSilence);
+    hash_combine (key, options.zeroLatency);
+
+    convolution::CacheEntry entry (buffer, irSampleRate, options);
+
+    static std::mutex cacheMutex;
+    static std::multimap<size_t, convolution::CacheEntry> cache;
+
+    const std::scoped_lock sl (cacheMutex);
+
+    for (auto i = cache.begin(); i != cache.end();)
+        i = i->second.ir.expired() ? cache.erase (i) : std::next (i);
+
+    for (auto [i, end] = cache.equal_range (key); i != end; ++i)
+        if (i->second.matches (entry))
+            if (auto existing = i->second.ir.lock())
+                return existing;
+
+    auto ir = std::make_shared<const ConvolutionImpulseResponse> (buffer, irSampleRate, options);
+    entry.ir = ir;
+    cache.emplace (key, std::move (entry));
+    return ir;
+}
+
+ConvolutionImpulseResponse::ConvolutionImpulseResponse (const juce::AudioBuffer<float>& source,
+                                                        double irSampleRate, Options options)
+{
+    const int numChannels = std::min (2, source.getNumChannels());
+    int start = 0, end = source.getNumSamples();
+
+    if (numChannels == 0 || end == 0)
+        return;
+
+    if (options.trimSilence)
+    {
+        const auto threshold = juce::Decibels::decibelsToGain (-80.0f);
+        auto isSilent = [&] (int index)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                if (std::abs (source.getSample (i, index)) > threshold)
+                    return false;
+
+            return true;
+        };
+
+        while (start < end && isSilent (start))
+            ++start;
+
+        while (end > start && isSilent (end - 1))
+            --end;
+
+        if (start == end)
+            return;
+    }
+
+    // Resample the IR to the rate it'll be used at
+    const auto ratio = irSampleRate > 0.0 && options.sampleRate > 0.0 ? irSampleRate / options.sampleRate : 1.0;
+    length = ratio == 1.0 ? end - start : (int) std::ceil ((end - start) / ratio);
+
+    juce::AudioBuffer<float> ir (numChannels, length);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        if (ratio == 1.0)
+        {
+            ir.copyFrom (i, 0, source, i, start, length);
+        }
+        else
+        {
+            // The interpolator reads a few samples ahead so give it some silence to read
+            std::vector<float> padded ((size_t) (end - start + 16), 0.0f);
+            std::copy (source.getReadPointer (i, start), source.getReadPointer (i, end), padded.begin());
+
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process (ratio, padded.data(), ir.getWritePointer (i), length);
+        }
+    }
+
+    if (options.normalise)
+    {
+        float maxEnergy = 0.0f;
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            auto data = ir.getReadPointer (i);
+            maxEnergy = std::max (maxEnergy, std::inner_product (data, data + length, data, 0.0f));
+        }
+
+        if (maxEnergy > 0.0f)
+            ir.applyGain (1.0f / std::sqrt (maxEnergy));
+    }
+
+    // Without the head and early partitions, the late ones start at the beginning of the IR
+    const auto lateStart = options.zeroLatency ? tailStart : 0;
+    headLength = options.zeroLatency ? std::min (length, headSize) : 0;
+
+    const auto earlyLength = std::max (0, std::min (length, lateStart) - headSize);
+    const auto lateLength = std::max (0, length - lateStart);
+    numEarlyPartitions = (earlyLength + earlyBlockSize - 1) / earlyBlockSize;
+    numLatePartitions = (lateLength + lateBlockSize - 1) / lateBlockSize;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        auto data = ir.getReadPointer (i);
+
+        Channel c;
+        c.head.assign (data, data + getHeadLength());
+        c.earlySpectra = convolution::createSpectra (data + headSize, earlyLength, earlyBlockSize, numEarlyPartitions);
+        c.lateSpectra = convolution::createSpectra (data + lateStart, lateLength, lateBlockSize, numLatePartitions);
+        channels.push_back (std::move (c));
+    }
+}
+
+//==============================================================================
+/** Runs the late tasks of all the convolvers that have posted a block. */
+class PartitionedConvolver::LateThreadPool
+{
+public:
+    LateThreadPool()
+    {
+        const auto numThreads = juce::jlimit (1, maxNumThreads, juce::SystemStats::getNumCpus() / 2);
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.push_back (std::make_unique<Worker> (*this));
+    }
+
+    ~LateThreadPool()
+    {
+        for (auto& t : threads)
+            t->signalThreadShouldExit();
+
+        notify();
+
+        for (auto& t : threads)
+            t->stopThread (5000);
+    }
+
+    int getNumThreads() const noexcept
+    {
+        return (int) threads.size();
+    }
+
+    void add (PartitionedConvolver& c)
+    {
+        const juce::ScopedWriteLock sl (lock);
+        convolvers.add (&c);
+    }
+
+    void remove (PartitionedConvolver& c)
+    {
+        // This waits for any task the convolver is running to finish
+        const juce::ScopedWriteLock sl (lock);
+        convolvers.removeFirstMatchingValue (&c);
+    }
+
+    void notify() noexcept
+    {
+        for (auto& t : threads)
+            t->event.signal();
+    }
+
+private:
+    static constexpr int maxNumThreads = 4;
+
+    struct Worker  : public juce::Thread
+    {
+        Worker (LateThreadPool& p)
+            : juce::Thread ("Convolution Tails"), pool (p)
+        {
+            startThread (juce::Thread::Priority::high);
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                event.wait (100);
+
+                for (bool anyRun = true; anyRun && ! threadShouldExit();)
+                {
+                    anyRun = false;
+                    const juce::ScopedReadLock sl (pool.lock);
+
+                    for (auto c : pool.convolvers)
+                        anyRun = c->tryRunLateTask() || anyRun;
+                }
+            }
+        }
+
+        LateThreadPool& pool;
+        juce::WaitableEvent event;
+    };
+
+    juce::ReadWriteLock lock;
+    juce::Array<PartitionedConvolver*> convolvers;
+    std::vector<std::unique_ptr<Worker>> threads;
+};
+
+//==============================================================================
+PartitionedConvolver::PartitionedConvolver (std::shared_ptr<const ConvolutionImpulseResponse> irToUse, int numChannels,
+                                            std::shared_ptr<ConvolutionBackend> backendToUse)
+    : ir (std::move (irToUse)),
+      earlyFFT (convolution::getFFTOrder (ConvolutionImpulseResponse::earlyBlockSize)),
+      lateFFT (convolution::getFFTOrder (ConvolutionImpulseResponse::lateBlockSize))
+{
+    jassert (ir != nullptr);
+    constexpr int earlyBlockSize = ConvolutionImpulseResponse::earlyBlockSize;
+    constexpr int lateBlockSize = ConvolutionImpulseResponse::lateBlockSize;
+    constexpr int earlySpectrumSize = ConvolutionImpulseResponse::getSpectrumSize (earlyBlockSize);
+    constexpr int lateSpectrumSize = ConvolutionImpulseResponse::getSpectrumSize (lateBlockSize);
+
+    const auto numEarly = ir->getNumEarlyPartitions();
+    const auto numLate = ir->getNumLatePartitions();
+
+    channelStates.resize ((size_t) numChannels);
+
+    for (auto& s : channelStates)
+    {
+        s.earlyInput.resize (2 * earlyBlockSize);
+        s.earlyOutput.resize (earlyBlockSize);
+        s.earlyHistory.resize ((size_t) (numEarly * earlySpectrumSize));
+        s.blockOutput.resize (earlyBlockSize);
+
+        if (numLate > 0)
+        {
+            s.lateInput.resize (2 * lateBlockSize);
+            s.lateJobInput.resize (2 * lateBlockSize);
+            s.lateOutput.resize (lateBlockSize);
+            s.lateHistory.resize ((size_t) (numLate * lateSpectrumSize));
+        }
+    }
+
+    earlyFFTBuffer.resize (4 * earlyBlockSize);
+    earlyAccumulator.resize (earlySpectrumSize);
+
+    if (numLate > 0 && backendToUse != nullptr)
+    {
+        backendStream = backendToUse->createStream (ir, numChannels);
+
+        if (backendStream != nullptr)
+        {
+            backend = std::move (backendToUse);
+
+            for (auto& s : channelStates)
+            {
+                lateInputPointers.push_back (s.lateInput.data());
+                lateOutputPointers.push_back (s.lateOutput.data());
+            }
+        }
+    }
+
+    if (numLate > 0 && backendStream == nullptr)
+    {
+        latePool = std::make_unique<juce::SharedResourcePointer<LateThreadPool>>();
+
+        // Split the partitions into one range per thread, unless that would leave
+        // too little work in each for it to be worth scheduling separately
+        constexpr int minPartitionsPerTask = 8;
+        const auto numTasks = juce::jlimit (1, (*latePool)->getNumThreads(),
+                                            numLate / minPartitionsPerTask);
+
+        for (int i = 0; i < numTasks; ++i)
+        {
+            auto task = std::make_unique<LateTask>();
+            task->partitions = { i * numLate / numTasks, (i + 1) * numLate / numTasks };
+            task->fftBuffer.resize (4 * lateBlockSize);
+            task->accumulator.resize (lateSpectrumSize);
+            task->output.resize ((size_t) (numChannels * lateBlockSize));
+            lateTasks.push_back (std::move (task));
+        }
+
+        (*latePool)->add (*this);
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    if (latePool != nullptr)
+        (*latePool)->remove (*this);
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    waitForLateTasks();
+
+    for (auto& s : channelStates)
+        for (auto* v : { &s.earlyInput, &s.earlyHistory, &s.earlyOutput, &s.lateInput, &s.lateHistory,
+                         &s.lateJobInput, &s.lateOutput })
+            std::fill (v->begin(), v->end(), 0.0f);
+
+    for (auto& t : lateTasks)
+        std::fill (t->output.begin(), t->output.end(), 0.0f);
+
+    if (backendStream != nullptr)
+        backendStream->reset();
+
+    earlyPos = latePos = earlyHistoryIndex = lateHistoryIndex = 0;
+}
+
+void PartitionedConvolver::process (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    constexpr int earlyBlockSize = ConvolutionImpulseResponse::earlyBlockSize;
+    constexpr int lateBlockSize = ConvolutionImpulseResponse::lateBlockSize;
+
+    if (ir->getNumChannels() == 0)
+        return;
+
+    numChannels = std::min (numChannels, (int) channelStates.size());
+    const bool hasLate = ir->getNumLatePartitions() > 0;
+    const int headLength = ir->getHeadLength();
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int num = std::min (numSamples - done, earlyBlockSize - earlyPos);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& s = channelStates[(size_t) ch];
+            auto& head = ir->getChannel (ch).head;
+            auto* data = channels[ch] + done;
+
+            // The input is kept after the previous block so the head can read back into it
+            auto* input = s.earlyInput.data() + earlyBlockSize + earlyPos;
+            juce::FloatVectorOperations::copy (input, data, num);
+
+            if (hasLate)
+                juce::FloatVectorOperations::copy (s.lateInput.data() + lateBlockSize + latePos, data, num);
+
+            auto* out = s.blockOutput.data();
+            juce::FloatVectorOperations::copy (out, s.earlyOutput.data() + earlyPos, num);
+
+            if (hasLate)
+                juce::FloatVectorOperations::add (out, s.lateOutput.data() + latePos, num);
+
+            for (int k = 0; k < headLength; ++k)
+                juce::FloatVectorOperations::addWithMultiply (out, input - k, head[(size_t) k], num);
+
+            juce::FloatVectorOperations::copy (data, out, num);
+        }
+
+        done += num;
+        earlyPos += num;
+
+        if (hasLate)
+            latePos += num;
+
+        if (earlyPos == earlyBlockSize)
+        {
+            processEarlyBlock();
+            earlyPos = 0;
+        }
+
+        if (latePos == lateBlockSize)
+        {
+            finishLateBlock();
+            latePos = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::convolveBlock (const juce::dsp::FFT& fft, std::vector<float>& fftBuffer, std::vector<float>& accumulator,
+                                          const float* input, std::vector<float>& history, int historyIndex,
+                                          const std::vector<float>& spectra, juce::Range<int> partitions, int numPartitions,
+                                          int blockSize, float* output) noexcept
+{
+    const auto spectrumSize = ConvolutionImpulseResponse::getSpectrumSize (blockSize);
+
+    // Overlap-save: transform the last two blocks of input and add it to the history of spectra.
+    // Only the first partition uses this block's input so other ranges can run at the same time.
+    if (partitions.getStart() == 0)
+    {
+        std::copy (input, input + 2 * blockSize, fftBuffer.begin());
+        std::fill (fftBuffer.begin() + 2 * blockSize, fftBuffer.end(), 0.0f);
+        fft.performRealOnlyForwardTransform (fftBuffer.data(), true);
+        std::copy (fftBuffer.begin(), fftBuffer.begin() + spectrumSize, history.begin() + historyIndex * spectrumSize);
+    }
+
+    // Each partition is applied to the input spectrum from as many blocks ago as its index
+    std::fill (accumulator.begin(), accumulator.end(), 0.0f);
+
+    for (int i = partitions.getStart(); i < partitions.getEnd(); ++i)
+    {
+        auto inputIndex = historyIndex - i;
+
+        if (inputIndex < 0)
+            inputIndex += numPartitions;
+
+        convolution::multiplyAdd (accumulator.data(), spectra.data() + i * spectrumSize,
+                                  history.data() + inputIndex * spectrumSize, blockSize + 1);
+    }
+
+    std::copy (accumulator.begin(), accumulator.end(), fftBuffer.begin());
+    std::fill (fftBuffer.begin() + spectrumSize, fftBuffer.end(), 0.0f);
+    fft.performRealOnlyInverseTransform (fftBuffer.data());
+
+    // The second half is the part that hasn't wrapped around
+    std::copy (fftBuffer.begin() + blockSize, fftBuffer.begin() + 2 * blockSize, output);
+}
+
+void PartitionedConvolver::processEarlyBlock() noexcept
+{
+    constexpr int blockSize = ConvolutionImpulseResponse::earlyBlockSize;
+    const auto numPartitions = ir->getNumEarlyPartitions();
+
+    for (size_t ch = 0; ch < channelStates.size(); ++ch)
+    {
+        auto& s = channelStates[ch];
+
+        // The output of this block's partitions is played during the next block, which
+        // lines up with them starting one block into the IR
+        if (numPartitions > 0)
+            convolveBlock (earlyFFT, earlyFFTBuffer, earlyAccumulator, s.earlyInput.data(), s.earlyHistory, earlyHistoryIndex,
+                           ir->getChannel ((int) ch).earlySpectra, { 0, numPartitions }, numPartitions,
+                           blockSize, s.earlyOutput.data());
+
+        std::copy (s.earlyInput.begin() + blockSize, s.earlyInput.end(), s.earlyInput.begin());
+    }
+
+    if (numPartitions > 0)
+        earlyHistoryIndex = (earlyHistoryIndex + 1) % numPartitions;
+}
+
+void PartitionedConvolver::finishLateBlock() noexcept
+{
+    constexpr int blockSize = ConvolutionImpulseResponse::lateBlockSize;
+
+    if (backendStream != nullptr)
+    {
+        const auto numChannels = (int) channelStates.size();
+        backendStream->getResult (lateOutputPointers.data(), numChannels);
+        backendStream->submit (lateInputPointers.data(), numChannels);
+
+        for (auto& s : channelStates)
+            std::copy (s.lateInput.begin() + blockSize, s.lateInput.end(), s.lateInput.begin());
+
+        return;
+    }
+
+    // The tasks posted at the end of the last block are played during the next one,
+    // which lines up with the late partitions starting two blocks into the IR
+    waitForLateTasks();
+
+    for (size_t ch = 0; ch < channelStates.size(); ++ch)
+    {
+        auto& s = channelStates[ch];
+        auto* out = s.lateOutput.data();
+        juce::FloatVectorOperations::clear (out, blockSize);
+
+        for (auto& t : lateTasks)
+            juce::FloatVectorOperations::add (out, t->output.data() + ch * blockSize, blockSize);
+
+        std::copy (s.lateInput.begin(), s.lateInput.end(), s.lateJobInput.begin());
+        std::copy (s.lateInput.begin() + blockSize, s.lateInput.end(), s.lateInput.begin());
+    }
+
+    lateHistoryIndex = (lateHistoryIndex + 1) % ir->getNumLatePartitions();
+
+    for (auto& t : lateTasks)
+        t->state.store (TaskState::pending, std::memory_order_release);
+
+    (*latePool)->notify();
+}
+
+void PartitionedConvolver::waitForLateTasks() noexcept
+{
+    // If the pool hasn't got to these yet it's quicker to run them here
+    for (auto& t : lateTasks)
+        tryRunLateTask (*t);
+
+    for (auto& t : lateTasks)
+        while (t->state.load (std::memory_order_acquire) != TaskState::idle)
+            std::this_thread::yield();
+}
+
+bool PartitionedConvolver::tryRunLateTask() noexcept
+{
+    for (auto& t : lateTasks)
+        if (tryRunLateTask (*t))
+            return true;
+
+    return false;
+}
+
+bool PartitionedConvolver::tryRunLateTask (LateTask& task) noexcept
+{
+    constexpr int blockSize = ConvolutionImpulseResponse::lateBlockSize;
+    auto expected = TaskState::pending;
+
+    if (! task.state.compare_exchange_strong (expected, TaskState::running, std::memory_order_acquire))
+        return false;
+
+    const auto numPartitions = ir->getNumLatePartitions();
+
+    for (size_t ch = 0; ch < channelStates.size(); ++ch)
+    {
+        auto& s = channelStates[ch];
+        convolveBlock (lateFFT, task.fftBuffer, task.accumulator, s.lateJobInput.data(), s.lateHistory, lateHistoryIndex,
+                       ir->getChannel ((int) ch).lateSpectra, task.partitions, numPartitions,
+                       blockSize, task.output.data() + ch * blockSize);
+    }
+
+    task.state.store (TaskState::idle, std::memory_order_release);
+    return true;
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,229 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    An impulse response that has been resampled, split into partitions and
+    transformed to the frequency domain, ready to be used by PartitionedConvolvers.
+
+    The IR is split into three parts so it can be convolved with no latency:
+     - The first headSize samples are convolved directly in the time domain.
+     - Up to tailStart, partitions of earlyBlockSize samples are convolved in
+       the frequency domain on the audio thread.
+     - The rest is split into partitions of lateBlockSize samples which are
+       convolved on background threads, with a block's grace to finish in.
+
+    If Options::zeroLatency is false, the whole IR is split into late partitions
+    so none of it is convolved on the audio thread, at the cost of tailStart
+    samples of latency.
+
+    These are immutable once created so can be shared by any number of convolvers.
+*/
+class ConvolutionImpulseResponse
+{
+public:
+    /** The settings used to prepare an IR. */
+    struct Options
+    {
+        double sampleRate = 44100.0;    /**< The sample rate the IR will be used at. */
+        bool normalise = true;          /**< Scales the IR so its loudest channel has unit energy. */
+        bool trimSilence = false;       /**< Removes any silence from the start and end of the IR. */
+        bool zeroLatency = true;        /**< Convolves the start of the IR on the audio thread so no latency is added. */
+    };
+
+    /** Returns a prepared IR, shared with anything else that has asked for an IR
+        with the same content and options.
+        Callers should keep hold of the returned pointer for as long as they use it
+        as IRs are removed from the cache when they're no longer used.
+    */
+    static std::shared_ptr<const ConvolutionImpulseResponse> get (const juce::AudioBuffer<float>&,
+                                                                  double irSampleRate, Options);
+
+    /** Prepares an IR. You'll usually want to use get() so it's shared. */
+    ConvolutionImpulseResponse (const juce::AudioBuffer<float>&, double irSampleRate, Options);
+
+    //==============================================================================
+    static constexpr int headSize = 64;
+    static constexpr int earlyBlockSize = 64;
+    static constexpr int lateBlockSize = 1024;
+    static constexpr int tailStart = 2 * lateBlockSize;
+
+    /** The number of floats in a partition's spectrum, i.e. the non-negative
+        frequency bins of an FFT of twice the block size.
+    */
+    static constexpr int getSpectrumSize (int blockSize)    { return 2 * blockSize + 2; }
+
+    /** Returns the latency a convolver using an IR prepared with these options will add. */
+    static constexpr int getLatencySamples (Options o)      { return o.zeroLatency ? 0 : tailStart; }
+
+    /** The prepared partitions for one channel. */
+    struct Channel
+    {
+        std::vector<float> head;
+        std::vector<float> earlySpectra, lateSpectra;
+    };
+
+    const Channel& getChannel (int index) const noexcept    { return channels[(size_t) std::min (index, getNumChannels() - 1)]; }
+    int getNumChannels() const noexcept                     { return (int) channels.size(); }
+    int getLength() const noexcept                          { return length; }
+    int getHeadLength() const noexcept                      { return headLength; }
+    int getNumEarlyPartitions() const noexcept              { return numEarlyPartitions; }
+    int getNumLatePartitions() const noexcept               { return numLatePartitions; }
+
+private:
+    std::vector<Channel> channels;
+    int length = 0, headLength = 0, numEarlyPartitions = 0, numLatePartitions = 0;
+};
+
+//==============================================================================
+/**
+    An alternative way to convolve the late partitions of PartitionedConvolvers,
+    e.g. on a GPU, batching the blocks of every convolver using it together.
+
+    Each convolver submits a block of input every lateBlockSize samples and
+    collects the result when it submits the next one. That's the same grace the
+    background threads get, so using a backend doesn't change the latency. The
+    head and early partitions are still convolved on the audio thread.
+
+    Set one up by returning it from EngineBehaviour::getConvolutionBackend().
+*/
+class ConvolutionBackend
+{
+public:
+    /** Destructor. */
+    virtual ~ConvolutionBackend() = default;
+
+    /** Convolves the late partitions of an IR for one convolver. */
+    struct Stream
+    {
+        /** Destructor. */
+        virtual ~Stream() = default;
+
+        /** Starts convolving a block.
+            This is called on the audio thread every lateBlockSize samples so mustn't
+            block or allocate. The inputs must be copied before this returns.
+            @param inputs   For each channel, the previous block of input followed by
+                            the one that's just finished, 2 * lateBlockSize samples
+        */
+        virtual void submit (const float* const* inputs, int numChannels) noexcept = 0;
+
+        /** Writes lateBlockSize samples of the last submitted block's result to each output.
+            This is called on the audio thread just before the next submit so should
+            only wait if the result isn't ready yet. If nothing has been submitted
+            since the stream was created or reset, it should write silence.
+        */
+        virtual void getResult (float* const* outputs, int numChannels) noexcept = 0;
+
+        /** Clears any history of the input and any results not yet collected. */
+        virtual void reset() noexcept = 0;
+    };
+
+    /** Creates a Stream to convolve an IR's late partitions with.
+        Return nullptr if this IR can't be handled and it'll be convolved on the
+        background threads instead.
+    */
+    virtual std::unique_ptr<Stream> createStream (std::shared_ptr<const ConvolutionImpulseResponse>, int numChannels) = 0;
+};
+
+//==============================================================================
+/**
+    Convolves audio with a ConvolutionImpulseResponse with no added latency.
+
+    The convolver doesn't allocate once it's been created so process can be
+    called on the audio thread. The late partitions are split into ranges which
+    are convolved as separate tasks on a shared pool of background threads. If
+    a task hasn't been started by the time its output is needed, the audio thread
+    will run it instead.
+
+    If a ConvolutionBackend is given and can handle the IR, it convolves the late
+    partitions instead of the background threads.
+*/
+class PartitionedConvolver
+{
+public:
+    /** Creates a convolver for a number of channels.
+        If the IR has fewer channels than this, its last channel is used for the rest.
+    */
+    PartitionedConvolver (std::shared_ptr<const ConvolutionImpulseResponse>, int numChannels,
+                          std::shared_ptr<ConvolutionBackend> backend = {});
+
+    /** Destructor. */
+    ~PartitionedConvolver();
+
+    /** Returns the IR this is using. */
+    const std::shared_ptr<const ConvolutionImpulseResponse>& getImpulseResponse() const noexcept  { return ir; }
+
+    /** Returns true if the late partitions are being convolved by a ConvolutionBackend. */
+    bool isUsingBackend() const noexcept                    { return backendStream != nullptr; }
+
+    /** Returns the number of ranges the late partitions are split into, each of
+        which can be convolved on a different background thread.
+    */
+    int getNumLateTasks() const noexcept                    { return (int) lateTasks.size(); }
+
+    /** Convolves some channels in place. */
+    void process (float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Clears any audio from the convolver's state. */
+    void reset() noexcept;
+
+private:
+    //==============================================================================
+    struct ChannelState
+    {
+        std::vector<float> earlyInput, earlyHistory, earlyOutput;
+        std::vector<float> lateInput, lateHistory, lateJobInput, lateOutput;
+        std::vector<float> blockOutput;
+    };
+
+    enum class TaskState { idle, pending, running };
+
+    /** A range of late partitions that can be convolved independently of the others. */
+    struct LateTask
+    {
+        juce::Range<int> partitions;
+        std::atomic<TaskState> state { TaskState::idle };
+        std::vector<float> fftBuffer, accumulator, output;
+    };
+
+    class LateThreadPool;
+
+    std::shared_ptr<const ConvolutionImpulseResponse> ir;
+    std::vector<ChannelState> channelStates;
+    juce::dsp::FFT earlyFFT, lateFFT;
+    std::vector<float> earlyFFTBuffer, earlyAccumulator;
+    int earlyPos = 0, latePos = 0, earlyHistoryIndex = 0, lateHistoryIndex = 0;
+
+    std::vector<std::unique_ptr<LateTask>> lateTasks;
+    std::unique_ptr<juce::SharedResourcePointer<LateThreadPool>> latePool;
+
+    std::shared_ptr<ConvolutionBackend> backend;
+    std::unique_ptr<ConvolutionBackend::Stream> backendStream;
+    std::vector<const float*> lateInputPointers;
+    std::vector<float*> lateOutputPointers;
+
+    void processEarlyBlock() noexcept;
+    void finishLateBlock() noexcept;
+    void waitForLateTasks() noexcept;
+    bool tryRunLateTask() noexcept;
+    bool tryRunLateTask (LateTask&) noexcept;
+
+    static void convolveBlock (const juce::dsp::FFT&, std::vector<float>& fftBuffer, std::vector<float>& accumulator,
+                               const float* input, std::vector<float>& history, int historyIndex,
+                               const std::vector<float>& spectra, juce::Range<int> partitions, int numPartitions,
+                               int blockSize, float* output) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolver)
+};
+
+}} // namespace tracktion { inline namespace engine
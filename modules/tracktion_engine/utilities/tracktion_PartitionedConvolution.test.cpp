@@ -0,0 +1,271 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+
+#include "../../3rd_party/doctest/tracktion_doctest.hpp"
+
+namespace tracktion::inline engine
+{
+
+#if ENGINE_UNIT_TESTS_CONVOLUTION
+
+namespace convolution::test
+{
+    /** A decaying noise IR, different on each channel. */
+    inline juce::AudioBuffer<float> createImpulseResponse (int numChannels, int length, int64_t seed)
+    {
+        juce::Random r (seed);
+        juce::AudioBuffer<float> ir (numChannels, length);
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < length; ++i)
+                ir.setSample (c, i, (r.nextFloat() * 2.0f - 1.0f) * 0.1f * std::exp (-3.0f * (float) i / (float) length));
+
+        return ir;
+    }
+
+    /** A burst of noise followed by some impulses and silence, so the direct
+        convolution only has to visit the non-zero samples.
+    */
+    inline juce::AudioBuffer<float> createInput (int numChannels, int length, int64_t seed)
+    {
+        juce::Random r (seed);
+        juce::AudioBuffer<float> input (numChannels, length);
+        input.clear();
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            for (int i = 0; i < std::min (length, 1500); ++i)
+                input.setSample (c, i, r.nextFloat() - 0.5f);
+
+            for (int pos = 2000 + c * 37; pos < length; pos += 3001)
+                input.setSample (c, pos, 1.0f);
+        }
+
+        return input;
+    }
+
+    inline juce::AudioBuffer<float> convolveDirectly (const juce::AudioBuffer<float>& input, const juce::AudioBuffer<float>& ir)
+    {
+        const auto numSamples = input.getNumSamples();
+        std::vector<double> sum ((size_t) numSamples);
+        juce::AudioBuffer<float> output (input.getNumChannels(), numSamples);
+
+        for (int c = 0; c < input.getNumChannels(); ++c)
+        {
+            auto x = input.getReadPointer (c);
+            auto h = ir.getReadPointer (std::min (c, ir.getNumChannels() - 1));
+            std::fill (sum.begin(), sum.end(), 0.0);
+
+            for (int i = 0; i < numSamples; ++i)
+                if (x[i] != 0.0f)
+                    for (int k = 0; k < std::min (ir.getNumSamples(), numSamples - i); ++k)
+                        sum[(size_t) (i + k)] += (double) x[i] * (double) h[k];
+
+            for (int i = 0; i < numSamples; ++i)
+                output.setSample (c, i, (float) sum[(size_t) i]);
+        }
+
+        return output;
+    }
+
+    /** Runs the input through a convolver in blocks of the given sizes, cycling through them. */
+    inline juce::AudioBuffer<float> process (PartitionedConvolver& convolver, juce::AudioBuffer<float> buffer,
+                                             const std::vector<int>& blockSizes)
+    {
+        std::vector<float*> channels ((size_t) buffer.getNumChannels());
+
+        for (int pos = 0, block = 0; pos < buffer.getNumSamples(); ++block)
+        {
+            const auto num = std::min (blockSizes[(size_t) block % blockSizes.size()], buffer.getNumSamples() - pos);
+
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                channels[(size_t) c] = buffer.getWritePointer (c, pos);
+
+            convolver.process (channels.data(), buffer.getNumChannels(), num);
+            pos += num;
+        }
+
+        return buffer;
+    }
+
+    /** Returns the largest difference between a buffer and the expected one delayed by some samples. */
+    inline float getMaxDifference (const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& expected, int delay = 0)
+    {
+        float maxDifference = 0.0f;
+
+        for (int c = 0; c < actual.getNumChannels(); ++c)
+            for (int i = 0; i < actual.getNumSamples(); ++i)
+                maxDifference = std::max (maxDifference, std::abs (actual.getSample (c, i)
+                                                                   - (i >= delay ? expected.getSample (c, i - delay) : 0.0f)));
+
+        return maxDifference;
+    }
+}
+
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("PartitionedConvolver matches direct convolution")
+    {
+        using namespace convolution::test;
+        constexpr int headSize = ConvolutionImpulseResponse::headSize;
+        constexpr int tailStart = ConvolutionImpulseResponse::tailStart;
+        constexpr int lateBlockSize = ConvolutionImpulseResponse::lateBlockSize;
+
+        ConvolutionImpulseResponse::Options options;
+        options.sampleRate = 44100.0;
+        options.normalise = false;
+
+        // Block sizes that don't divide the early or late block sizes
+        const std::vector<int> blockSizes { 37, 100, 511, 1, 999, 63, 1025 };
+
+        for (auto irLength : { headSize / 2 + 3, tailStart - 500, tailStart + 10 * lateBlockSize + 123 })
+        {
+            CAPTURE (irLength);
+            const auto ir = createImpulseResponse (2, irLength, irLength);
+            const auto input = createInput (2, irLength + 3 * lateBlockSize + 211, irLength + 1);
+            const auto expected = convolveDirectly (input, ir);
+
+            // Zero latency
+            {
+                auto prepared = std::make_shared<const ConvolutionImpulseResponse> (ir, 44100.0, options);
+                CHECK_EQ (prepared->getLength(), irLength);
+                CHECK_EQ (prepared->getHeadLength(), std::min (irLength, headSize));
+                CHECK_EQ (prepared->getNumLatePartitions() > 0, irLength > tailStart);
+
+                PartitionedConvolver convolver (prepared, 2);
+                CHECK (getMaxDifference (process (convolver, input, blockSizes), expected) < 0.0005f);
+
+                // Resetting should give the same result again
+                convolver.reset();
+                CHECK (getMaxDifference (process (convolver, input, { 1024 }), expected) < 0.0005f);
+            }
+
+            // Low CPU
+            {
+                auto lowCPUOptions = options;
+                lowCPUOptions.zeroLatency = false;
+                CHECK_EQ (ConvolutionImpulseResponse::getLatencySamples (lowCPUOptions), tailStart);
+
+                auto prepared = std::make_shared<const ConvolutionImpulseResponse> (ir, 44100.0, lowCPUOptions);
+                CHECK_EQ (prepared->getHeadLength(), 0);
+                CHECK_EQ (prepared->getNumEarlyPartitions(), 0);
+
+                // It should be exactly the same, just delayed by tailStart
+                PartitionedConvolver convolver (prepared, 2);
+                CHECK (getMaxDifference (process (convolver, input, blockSizes), expected, tailStart) < 0.0005f);
+            }
+        }
+    }
+
+    TEST_CASE ("PartitionedConvolver parallel late tasks")
+    {
+        using namespace convolution::test;
+        constexpr int tailStart = ConvolutionImpulseResponse::tailStart;
+        constexpr int lateBlockSize = ConvolutionImpulseResponse::lateBlockSize;
+
+        ConvolutionImpulseResponse::Options options;
+        options.normalise = false;
+
+        // Enough late partitions to be split in to several ranges, if there are threads for them
+        const auto irLength = tailStart + 24 * lateBlockSize + 17;
+        const auto ir = createImpulseResponse (2, irLength, 42);
+        const auto input = createInput (2, irLength + 3 * lateBlockSize, 43);
+        const auto expected = convolveDirectly (input, ir);
+        auto prepared = std::make_shared<const ConvolutionImpulseResponse> (ir, 44100.0, options);
+
+        if (juce::SystemStats::getNumCpus() >= 4)
+            CHECK (PartitionedConvolver (prepared, 2).getNumLateTasks() > 1);
+        else
+            MESSAGE ("Too few CPUs to split the late partitions, only checking a single range");
+
+        // Small blocks with a pause every so often give the pool time to run the ranges
+        // at the same time, with the first one writing its slot of the history whilst
+        // the others read theirs
+        auto processWithPool = [&]
+        {
+            PartitionedConvolver convolver (prepared, 2);
+            auto output = input;
+            std::vector<float*> channels (2);
+
+            for (int pos = 0; pos < output.getNumSamples(); pos += 256)
+            {
+                const auto num = std::min (256, output.getNumSamples() - pos);
+                channels = { output.getWritePointer (0, pos), output.getWritePointer (1, pos) };
+                convolver.process (channels.data(), 2, num);
+
+                if ((pos / 256) % 4 == 3)
+                    std::this_thread::sleep_for (std::chrono::milliseconds (1));
+            }
+
+            return output;
+        };
+
+        const auto pooled = processWithPool();
+        CHECK (getMaxDifference (pooled, expected) < 0.0005f);
+
+        // Processing it all in one go means the next block's usually due before the
+        // pool has started the ranges, so the audio thread runs them itself
+        PartitionedConvolver stealingConvolver (prepared, 2);
+        const auto stolen = process (stealingConvolver, input, { input.getNumSamples() });
+        CHECK (getMaxDifference (stolen, expected) < 0.0005f);
+
+        // The ranges are always summed in the same order so whichever thread ran
+        // them, the results should be identical
+        CHECK_EQ (getMaxDifference (stolen, pooled), 0.0f);
+
+        // Several convolvers sharing the pool shouldn't affect each other
+        std::vector<juce::AudioBuffer<float>> results (3);
+        std::vector<std::thread> threads;
+
+        for (auto& r : results)
+            threads.emplace_back ([&r, &processWithPool] { r = processWithPool(); });
+
+        for (auto& t : threads)
+            t.join();
+
+        for (auto& r : results)
+            CHECK_EQ (getMaxDifference (r, pooled), 0.0f);
+    }
+
+    TEST_CASE ("ConvolutionImpulseResponse cache")
+    {
+        using namespace convolution::test;
+        const auto ir = createImpulseResponse (2, 3000, 1);
+        ConvolutionImpulseResponse::Options options;
+
+        auto a = ConvolutionImpulseResponse::get (ir, 44100.0, options);
+        auto b = ConvolutionImpulseResponse::get (ir, 44100.0, options);
+        CHECK (a == b);
+
+        // Any difference in the samples, rate or options should give a different IR
+        auto changed = ir;
+        changed.setSample (1, 2999, changed.getSample (1, 2999) + 0.001f);
+        CHECK (ConvolutionImpulseResponse::get (changed, 44100.0, options) != a);
+        CHECK (ConvolutionImpulseResponse::get (ir, 48000.0, options) != a);
+
+        auto otherOptions = options;
+        otherOptions.zeroLatency = false;
+        CHECK (ConvolutionImpulseResponse::get (ir, 44100.0, otherOptions) != a);
+
+        // Once nothing's using an IR it shouldn't be kept
+        std::weak_ptr<const ConvolutionImpulseResponse> weak = a;
+        a.reset();
+        b.reset();
+        CHECK (weak.expired());
+    }
+}
+
+#endif
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS
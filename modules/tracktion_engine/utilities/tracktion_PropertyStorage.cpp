@@ -82,6 +82,8 @@ juce::StringRef PropertyStorage::settingToString (SettingID setting)
         case SettingID::safeRecord:                         return "safeRecord";
         case SettingID::resetCursorOnPlay:                  return "resetCursorOnPlay";
         case SettingID::retrospectiveRecord:                return "retrospectiveRecord";
+        case SettingID::retrospectiveRecordBitDepth:        return "retrospectiveRecordBitDepth";
+        case SettingID::retrospectiveRecordUseTempFile:     return "retrospectiveRecordUseTempFile";
         case SettingID::reWireEnabled:                      return "ReWireEnabled";
         case SettingID::simplifyAfterRecording:             return "simplifyAfterRecording";
         case SettingID::sendControllerOffMessages:          return "sendControllerOffMessages";
@@ -80,6 +80,8 @@ enum class SettingID
     renderRecentFilesList,
     resetCursorOnPlay,
     retrospectiveRecord,
+    retrospectiveRecordBitDepth,
+    retrospectiveRecordUseTempFile,
     reWireEnabled,
     safeRecord,
     sendControllerOffMessages,
@@ -204,6 +204,8 @@ static juce::String getFileProxyPrefix()                { return "proxy_"; }
 static juce::String getDeviceFreezePrefix (Edit& edit)  { return "freeze_" + edit.getProjectItemID().toStringSuitableForFilename() + "_"; }
 static juce::String getTrackFreezePrefix()              { return "trackFreeze_"; }
 static juce::String getCompPrefix()                     { return "comp_"; }
+static juce::String getTrackRenderPrefix()              { return "trackRender_"; }
+static juce::String getDecodedSidecarPrefix()          { return "decoded_"; }
 
 static AudioFile getCachedEditFile (Edit& edit, const juce::String& prefix, HashCode hash)
 {
@@ -230,6 +232,50 @@ AudioFile TemporaryFileManager::getFileForCachedFileRender (Edit& edit, HashCode
     return getCachedEditFile (edit, getFileProxyPrefix(), hash);
 }
 
+AudioFile TemporaryFileManager::getFileForCachedTrackRender (const Track& track, HashCode hash, const juce::String& fileExtension)
+{
+    auto file = getCachedEditFile (track.edit, getTrackRenderPrefix() + "0_" + track.itemID.toString() + "_", hash).getFile();
+    return AudioFile (track.edit.engine, file.withFileExtension (fileExtension));
+}
+
+AudioFile TemporaryFileManager::getFileForDecodedSidecar (const AudioFile& source) const
+{
+    auto sourceFile = source.getFile();
+    auto hash = source.getHash()
+                 ^ (HashCode) sourceFile.getSize() * 7919
+                 ^ (HashCode) sourceFile.getLastModificationTime().toMilliseconds();
+
+    return AudioFile (engine, getTempFile (getDecodedSidecarPrefix() + juce::String::toHexString (hash) + ".wav"));
+}
+
+void TemporaryFileManager::purgeDecodedSidecars (int64_t maxBytesToKeep)
+{
+    CRASH_TRACER
+    auto files = tempDir.findChildFiles (juce::File::findFiles, false, getDecodedSidecarPrefix() + "*");
+
+    std::sort (files.begin(), files.end(),
+               [] (const juce::File& first, const juce::File& second) -> bool
+               {
+                   return first.getLastAccessTime().toMilliseconds() < second.getLastAccessTime().toMilliseconds();
+               });
+
+    int64_t totalBytes = 0;
+
+    for (auto& f : files)
+        totalBytes += f.getSize();
+
+    for (auto& f : files)
+    {
+        if (totalBytes <= maxBytesToKeep)
+            break;
+
+        auto size = f.getSize();
+
+        if (f.deleteFile())
+            totalBytes -= size;
+    }
+}
+
 juce::File TemporaryFileManager::getFreezeFileForDevice (Edit& edit, OutputDevice& device)
 {
     return edit.getTempDirectory (true)
@@ -354,6 +400,11 @@ void TemporaryFileManager::purgeOrphanFreezeAndProxyFiles (Edit& edit)
                     if (! at->isFrozen (Track::individualFreeze))
                         filesToDelete.add (entry.getFile());
             }
+            else if (name.startsWith (getTrackRenderPrefix()))
+            {
+                if (findTrackForID (edit, itemID) == nullptr)
+                    filesToDelete.add (entry.getFile());
+            }
         }
         else if (name.startsWith (RenderManager::getFileRenderPrefix()))
         {
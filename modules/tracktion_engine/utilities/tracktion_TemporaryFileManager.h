@@ -74,6 +74,23 @@ public:
     /** */
     static AudioFile getFileForCachedFileRender (Edit&, HashCode hash);
 
+    /** Returns the file a render of a track with the given hash is cached in.
+        @see RenderManager::findCachedTrackRender
+    */
+    static AudioFile getFileForCachedTrackRender (const Track&, HashCode hash, const juce::String& fileExtension);
+
+    /** Returns the file a decoded copy of a compressed source file is kept in.
+        The name depends on the source's path, size and modification time so a
+        changed source will get a new file.
+        @see AudioFileCache::setDecodedSidecarDiskQuota
+    */
+    AudioFile getFileForDecodedSidecar (const AudioFile& source) const;
+
+    /** Deletes the least recently used decoded sidecar files until their total
+        size is within the given number of bytes.
+    */
+    void purgeDecodedSidecars (int64_t maxBytesToKeep);
+
     /** */
     static juce::File getFreezeFileForDevice (Edit&, OutputDevice&);
 
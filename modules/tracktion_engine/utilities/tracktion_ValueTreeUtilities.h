@@ -137,27 +137,82 @@ public:
     virtual void objectRemoved (ObjectType*) = 0;
     virtual void objectOrderChanged() = 0;
 
+    /** Called once at the end of a ScopedBulkChange with the objects that were
+        added and removed during it. The removed objects are deleted after this returns.
+        By default this calls newObjectAdded, objectRemoved and objectOrderChanged as
+        they would have been called for each change, but it can be overridden to
+        send a single notification for all of them.
+    */
+    virtual void bulkChangeEnded (const juce::Array<ObjectType*>& added,
+                                  const juce::Array<ObjectType*>& removed,
+                                  bool orderChanged)
+    {
+        for (auto o : removed)
+            objectRemoved (o);
+
+        for (auto o : added)
+            newObjectAdded (o);
+
+        if (orderChanged)
+            objectOrderChanged();
+    }
+
+    //==============================================================================
+    /** Defers the notifications and sorting for children added, removed or moved
+        whilst it's in scope, e.g. when importing or pasting lots of items at once.
+        Objects are still created and removed from the list straight away so they
+        can be looked up, but the list is only put back in order and bulkChangeEnded
+        only called once the last ScopedBulkChange for the list is destroyed.
+    */
+    struct ScopedBulkChange
+    {
+        ScopedBulkChange (ValueTreeObjectList& l)
+            : list (l)
+        {
+            ++list.bulkChangeDepth;
+        }
+
+        ~ScopedBulkChange()
+        {
+            if (--list.bulkChangeDepth == 0)
+                list.endBulkChange();
+        }
+
+        ValueTreeObjectList& list;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBulkChange)
+    };
+
     //==============================================================================
     void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree& tree) override
     {
         if (isChildTree (tree))
         {
-            auto index = parent.indexOf (tree);
-            juce::ignoreUnused (index);
-            jassert (index >= 0);
+            // Children are nearly always appended so check that first, as searching
+            // for the index would make adding lots of children quadratic
+            const bool isLastChild = parent.getChild (parent.getNumChildren() - 1) == tree;
+            jassert (isLastChild || parent.indexOf (tree) >= 0);
 
             if (auto* newObject = createNewObject (tree))
             {
                 {
                     const ScopedLockType sl (arrayLock);
 
-                    if (index == parent.getNumChildren() - 1)
+                    if (isLastChild || bulkChangeDepth > 0)
                         objects.add (newObject);
                     else
                         objects.addSorted (*this, newObject);
                 }
 
-                newObjectAdded (newObject);
+                if (bulkChangeDepth > 0)
+                {
+                    bulkChangeOrderChanged = bulkChangeOrderChanged || ! isLastChild;
+                    bulkChangeAdded.add (newObject);
+                }
+                else
+                {
+                    newObjectAdded (newObject);
+                }
             }
             else
                 jassertfalse;
@@ -179,6 +234,22 @@ public:
                     o = objects.removeAndReturn (oldIndex);
                 }
 
+                if (bulkChangeDepth > 0)
+                {
+                    // Objects added and removed in the same change were never announced
+                    if (bulkChangeAdded.contains (o))
+                    {
+                        bulkChangeAdded.removeFirstMatchingValue (o);
+                        deleteObject (o);
+                    }
+                    else
+                    {
+                        bulkChangeRemoved.add (o);
+                    }
+
+                    return;
+                }
+
                 objectRemoved (o);
                 deleteObject (o);
             }
@@ -189,6 +260,12 @@ public:
     {
         if (tree == parent)
         {
+            if (bulkChangeDepth > 0)
+            {
+                bulkChangeOrderChanged = true;
+                return;
+            }
+
             {
                 const ScopedLockType sl (arrayLock);
                 sortArray();
@@ -225,7 +302,9 @@ protected:
 
     int indexOf (const juce::ValueTree& v) const noexcept
     {
-        for (int i = 0; i < objects.size(); ++i)
+        // Search backwards as children are usually removed from the end when lots
+        // are removed at once, which would otherwise make that quadratic
+        for (int i = objects.size(); --i >= 0;)
             if (objects.getUnchecked(i)->state == v)
                 return i;
 
@@ -234,9 +313,58 @@ protected:
 
     void sortArray()
     {
-        objects.sort (*this);
+        // The objects are nearly always in order already, so walk the children and only
+        // search for the objects that aren't next, rather than finding the index of every
+        // object for each comparison in a sort
+        juce::Array<ObjectType*> sorted;
+        sorted.ensureStorageAllocated (objects.size());
+        int nextIndex = 0;
+
+        for (const auto& v : parent)
+        {
+            if (! isSuitableType (v))
+                continue;
+
+            const int index = (nextIndex < objects.size() && objects.getUnchecked (nextIndex)->state == v)
+                                ? nextIndex : indexOf (v);
+
+            if (index >= 0)
+            {
+                sorted.add (objects.getUnchecked (index));
+                nextIndex = index + 1;
+            }
+        }
+
+        if (sorted.size() == objects.size())
+            objects.swapWith (sorted);
+        else
+            objects.sort (*this);
     }
 
+    void endBulkChange()
+    {
+        auto added = std::move (bulkChangeAdded);
+        auto removed = std::move (bulkChangeRemoved);
+        const bool orderChanged = std::exchange (bulkChangeOrderChanged, false);
+
+        if (orderChanged)
+        {
+            const ScopedLockType sl (arrayLock);
+            sortArray();
+        }
+
+        if (orderChanged || ! added.isEmpty() || ! removed.isEmpty())
+            bulkChangeEnded (added, removed, orderChanged);
+
+        for (auto o : removed)
+            deleteObject (o);
+    }
+
+private:
+    int bulkChangeDepth = 0;
+    juce::Array<ObjectType*> bulkChangeAdded, bulkChangeRemoved;
+    bool bulkChangeOrderChanged = false;
+
 public:
     int compareElements (ObjectType* first, ObjectType* second) const
     {
@@ -712,6 +840,25 @@ inline void getChildTreesRecursive (juce::Array<juce::ValueTree>& result,
     }
 }
 
+/** Combines the type and properties of a tree, and optionally all its children,
+    into a hash.
+*/
+inline void hashValueTreeProperties (size_t& hash, const juce::ValueTree& tree, bool recursive)
+{
+    hash_combine (hash, tree.getType().toString().hashCode64());
+
+    for (int i = 0; i < tree.getNumProperties(); ++i)
+    {
+        auto name = tree.getPropertyName (i);
+        hash_combine (hash, name.toString().hashCode64());
+        hash_combine (hash, tree[name].toString().hashCode64());
+    }
+
+    if (recursive)
+        for (const auto& child : tree)
+            hashValueTreeProperties (hash, child, true);
+}
+
 inline void renamePropertyRecursive (juce::ValueTree& tree,
                                      const juce::Identifier& oldName,
                                      const juce::Identifier& newName,
@@ -39,17 +39,37 @@
 #include "tracktion_graph/tracktion_Node.test.cpp"
 #include "tracktion_graph/tracktion_NodeVisiting.test.cpp"
 #include "tracktion_graph/tracktion_Utility.cpp"
+#include "tracktion_graph/tracktion_GraphExport.cpp"
+#include "tracktion_graph/tracktion_GraphExport.test.cpp"
 
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_NodePlayerThreadPools.cpp"
+#include "tracktion_graph/tracktion_SharedNodeThreadPool.cpp"
+#include "tracktion_graph/tracktion_SharedNodeThreadPool.test.cpp"
+#include "tracktion_graph/tracktion_LoadGeneration.test.cpp"
+#include "tracktion_graph/tracktion_RandomGraph.test.cpp"
 
 #include "tracktion_graph/nodes/tracktion_ConnectedNode.test.cpp"
 
+#include "tracktion_graph/tracktion_LatencyCompensationUpdater.cpp"
+#include "tracktion_graph/tracktion_LatencyCompensationUpdater.test.cpp"
+
 #include "utilities/tracktion_AudioBufferPool.tests.cpp"
+#include "utilities/tracktion_NodeProfiler.test.cpp"
+#include "utilities/tracktion_PackedMidiBuffer.test.cpp"
+#include "utilities/tracktion_TraceRecorder.test.cpp"
+#include "utilities/tracktion_MirroredAudioFifo.test.cpp"
+#include "utilities/tracktion_SummingKernels.test.cpp"
+#include "utilities/tracktion_LevelKernels.test.cpp"
 #include "utilities/tracktion_Semaphore.cpp"
 #include "utilities/tracktion_Semaphore.tests.cpp"
 #include "utilities/tracktion_Threads.cpp"
+#include "utilities/tracktion_DeadlineWorkerPool.cpp"
+#include "utilities/tracktion_DeadlineWorkerPool.test.cpp"
+#include "utilities/tracktion_DeferredDeleter.test.cpp"
+#include "utilities/tracktion_LockFreeObject.test.cpp"
+#include "utilities/tracktion_RealTimeSpinLock.test.cpp"
 
 // Put this last to avoid macro leakage
 #include "utilities/tracktion_Allocation.test.cpp"
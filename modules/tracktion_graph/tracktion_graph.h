@@ -58,12 +58,38 @@
  #define GRAPH_UNIT_TESTS_QUICK_VALIDATE 0
 #endif
 
+/** Config: TRACKTION_GRAPH_NODE_PROFILING
+
+    If this is enabled, Nodes will time each process call and add the results
+    to any NodeProfiler set on them. When disabled, there is no overhead.
+*/
+#ifndef TRACKTION_GRAPH_NODE_PROFILING
+ #define TRACKTION_GRAPH_NODE_PROFILING 0
+#endif
+
+/** Config: TRACKTION_GRAPH_TRACING
+
+    If this is enabled, spans for Node processing, thread pool waits etc. will be
+    added to the active TraceRecorder so they can be viewed on a timeline.
+    When disabled, the TRACKTION_GRAPH_TRACE_SCOPE macros compile to nothing.
+*/
+#ifndef TRACKTION_GRAPH_TRACING
+ #define TRACKTION_GRAPH_TRACING 0
+#endif
+
 //==============================================================================
 //==============================================================================
 #include <cassert>
 #include <thread>
 #include <optional>
 #include <any>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 //==============================================================================
 #if __has_include(<choc/audio/choc_SampleBuffers.h>)
@@ -93,21 +119,32 @@
 //==============================================================================
 #include "utilities/tracktion_MidiMessageWithSource.h"
 #include "utilities/tracktion_MidiMessageArray.h"
+#include "utilities/tracktion_PackedMidiBuffer.h"
 namespace tracktion_engine = tracktion::engine;
 
+#include "utilities/tracktion_NodeProfiler.h"
+#include "utilities/tracktion_TraceRecorder.h"
+#include "utilities/tracktion_NodeAllocationArena.h"
 #include "tracktion_graph/tracktion_Node.h"
 #include "tracktion_graph/tracktion_Utility.h"
+#include "tracktion_graph/tracktion_GraphExport.h"
 
 #include "utilities/tracktion_AudioBufferPool.h"
 #include "utilities/tracktion_AudioBufferStack.h"
 #include "utilities/tracktion_GlueCode.h"
 #include "utilities/tracktion_AudioFifo.h"
+#include "utilities/tracktion_MirroredAudioFifo.h"
 #include "utilities/tracktion_PerformanceMeasurement.h"
 #include "utilities/tracktion_RealTimeSpinLock.h"
 #include "utilities/tracktion_Semaphore.h"
 #include "utilities/tracktion_Threads.h"
+#include "utilities/tracktion_DeadlineWorkerPool.h"
 #include "utilities/tracktion_LatencyProcessor.h"
 #include "utilities/tracktion_LockFreeObject.h"
+#include "utilities/tracktion_DeferredDeleter.h"
+#include "utilities/tracktion_WorkStealingDeque.h"
+#include "utilities/tracktion_SummingKernels.h"
+#include "utilities/tracktion_LevelKernels.h"
 
 #include "tracktion_graph/tracktion_PlayHead.h"
 
@@ -119,10 +156,12 @@ namespace tracktion_engine = tracktion::engine;
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.h"
 #include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.h"
 #include "tracktion_graph/tracktion_NodePlayerThreadPools.h"
+#include "tracktion_graph/tracktion_SharedNodeThreadPool.h"
 
 #include "tracktion_graph/nodes/tracktion_ConnectedNode.h"
 #include "tracktion_graph/nodes/tracktion_LatencyNode.h"
 #include "tracktion_graph/nodes/tracktion_SummingNode.h"
+#include "tracktion_graph/tracktion_LatencyCompensationUpdater.h"
 
 #include "tracktion_graph/players/tracktion_SimpleNodePlayer.h"
 
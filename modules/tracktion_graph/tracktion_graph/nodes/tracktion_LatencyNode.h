@@ -45,6 +45,27 @@ public:
                             tracktion::graph::AllocateAudioBuffer::yes });
     }
 
+    /** Returns the number of samples the input is delayed by. */
+    int getLatencyNumSamples() const
+    {
+        return latencyProcessor->getLatencyNumSamples();
+    }
+
+    /** Returns true if setLatencyNumSamplesLive can change to this delay. */
+    bool canSetLatencyNumSamplesLive (int numSamplesToDelay) const
+    {
+        return latencyProcessor->canSetLatencyNumSamplesLive (numSamplesToDelay);
+    }
+
+    /** Changes the delay whilst the node is playing, crossfading to it over the next block.
+        Returns false if the node needs preparing again to use this delay.
+        @see LatencyProcessor::setLatencyNumSamplesLive
+    */
+    bool setLatencyNumSamplesLive (int numSamplesToDelay)
+    {
+        return latencyProcessor->setLatencyNumSamplesLive (numSamplesToDelay);
+    }
+
     NodeProperties getNodeProperties() override
     {
         auto props = input->getNodeProperties();
@@ -68,6 +89,11 @@ public:
         return input->hasProcessed();
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void prepareToPlay (const PlaybackInitialisationInfo& info) override
     {
         latencyProcessor->prepareToPlay (info.sampleRate, info.blockSize, getNodeProperties().numberOfChannels);
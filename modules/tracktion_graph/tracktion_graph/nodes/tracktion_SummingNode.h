@@ -65,6 +65,25 @@ public:
         useDoublePrecision = shouldSumInDoublePrecision;
     }
 
+    /** By default, inputs with less latency are delayed to line up with the one with the most.
+        Disabling this sums the inputs as they arrive, which is useful when some of them need to
+        be heard as soon as possible rather than in time with the others, e.g. live monitoring.
+        Nodes like this aren't flattened in to or out of other SummingNodes.
+        This must be set before the node is initialised.
+    */
+    void setLatencyCompensationEnabled (bool shouldCompensateForLatency)
+    {
+        compensateForLatency = shouldCompensateForLatency;
+    }
+
+    /** Returns true if the inputs are delayed to line up with each other.
+        @see setLatencyCompensationEnabled
+    */
+    bool isLatencyCompensationEnabled() const
+    {
+        return compensateForLatency;
+    }
+
     //==============================================================================
     NodeProperties getNodeProperties() override
     {
@@ -102,7 +121,9 @@ public:
     TransformResult transform (TransformOptions& options) override
     {
         const bool hasFlattened = flattenSummingNodes();
-        const bool hasCreatedLatency = ! options.disableLatencyCompensation && createLatencyNodes();
+        const bool hasCreatedLatency = ! options.disableLatencyCompensation
+                                        && compensateForLatency
+                                        && createLatencyNodes (options.shareLatencyCompensation);
 
         if (hasFlattened)
             return TransformResult::nodesDeleted;
@@ -113,13 +134,16 @@ public:
         return TransformResult::none;
     }
 
-    void prepareToPlay (const PlaybackInitialisationInfo& info) override
+    void prepareToPlay (const PlaybackInitialisationInfo&) override
     {
         useDoublePrecision = useDoublePrecision && nodes.size() > 1;
+        channelSources.resize (nodes.size());
+        midiSources.reserve (nodes.size() + 1);
+        midiCursors.reserve (nodes.size() + 1);
 
-        if (useDoublePrecision)
-            tempDoubleBuffer.resize ({ (choc::buffer::ChannelCount) getNodeProperties().numberOfChannels,
-                                       (choc::buffer::FrameCount) info.blockSize });
+        const auto numChannels = getNodeProperties().numberOfChannels;
+        processFunction = useDoublePrecision ? getProcessFunction<true> (numChannels)
+                                             : getProcessFunction<false> (numChannels);
 
         isPrepared = true;
     }
@@ -133,12 +157,14 @@ public:
         return true;
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void process (ProcessContext& pc) override
     {
-        if (useDoublePrecision)
-            processDoublePrecision (pc);
-        else
-            processSinglePrecision (pc);
+        (this->*processFunction) (pc);
     }
 
 private:
@@ -149,79 +175,177 @@ private:
     std::optional<NodeProperties> cachedNodeProperties;
     bool isPrepared = false;
 
-    bool useDoublePrecision = false;
-    choc::buffer::ChannelArrayBuffer<double> tempDoubleBuffer;
+    bool useDoublePrecision = false, compensateForLatency = true;
+    std::vector<const float*> channelSources;
 
-    static void sortByTimestampUnstable (tracktion_engine::MidiMessageArray& messages) noexcept
+    using ProcessFunction = void (SummingNode::*) (ProcessContext&);
+    ProcessFunction processFunction = nullptr;
+
+    struct MidiCursor
     {
-        std::sort (messages.begin(), messages.end(), [] (const juce::MidiMessage& a, const juce::MidiMessage& b)
-        {
-            auto t1 = a.getTimeStamp();
-            auto t2 = b.getTimeStamp();
+        const tracktion_engine::MidiMessageWithSource* current;
+        const tracktion_engine::MidiMessageWithSource* end;
+        size_t sourceIndex;
+    };
 
-            if (t1 < t2) return true;
-            if (t2 < t1) return false;
+    std::vector<const tracktion_engine::MidiMessageArray*> midiSources;
+    std::vector<MidiCursor> midiCursors;
+    tracktion_engine::MidiMessageArray existingMidi;
 
-            return a.isNoteOff() && ! b.isNoteOff();
-        });
+    static bool isEarlier (const juce::MidiMessage& a, const juce::MidiMessage& b) noexcept
+    {
+        auto t1 = a.getTimeStamp();
+        auto t2 = b.getTimeStamp();
+
+        if (t1 < t2) return true;
+        if (t2 < t1) return false;
+
+        return a.isNoteOff() && ! b.isNoteOff();
     }
 
-    //==============================================================================
-    void processSinglePrecision (const ProcessContext& pc)
+    static void sortByTimestampUnstable (tracktion_engine::MidiMessageArray& messages) noexcept
     {
-        const auto numChannels = pc.buffers.audio.getNumChannels();
+        std::sort (messages.begin(), messages.end(), isEarlier);
+    }
+
+    /** Merges the MIDI from all the inputs in to dest.
+        Inputs are nearly always already in time order so these are merged with a
+        k-way heap merge. If any aren't sorted, this falls back to concatenating then sorting.
+    */
+    void mergeInputMidi (tracktion_engine::MidiMessageArray& dest)
+    {
+        midiSources.clear();
+        bool allSourcesSorted = true;
+
+        auto addSource = [&] (const tracktion_engine::MidiMessageArray& source)
+        {
+            dest.isAllNotesOff = dest.isAllNotesOff || source.isAllNotesOff;
 
-        int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
+            if (source.isEmpty())
+                return;
+
+            allSourcesSorted = allSourcesSorted && std::is_sorted (source.begin(), source.end(), isEarlier);
+            midiSources.push_back (&source);
+        };
+
+        // Any MIDI already in the dest buffer gets merged as another source
+        existingMidi.clear();
+
+        if (dest.isNotEmpty())
+        {
+            existingMidi.swapWith (dest);
+            addSource (existingMidi);
+        }
 
-        // Get each of the inputs and add them to dest
         for (auto& node : nodes)
+            addSource (node->getProcessedOutput().midi);
+
+        if (midiSources.size() <= 1 || ! allSourcesSorted)
         {
-            auto inputFromNode = node->getProcessedOutput();
+            for (auto source : midiSources)
+                dest.mergeFrom (*source);
+
+            if (midiSources.size() > 1)
+                sortByTimestampUnstable (dest);
 
-            if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (pc.buffers.audio.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+            return;
+        }
 
-            if (inputFromNode.midi.isNotEmpty())
-                nodesWithMidi++;
+        int totalNumMessages = 0;
+        midiCursors.clear();
 
-            pc.buffers.midi.mergeFrom (inputFromNode.midi);
+        for (size_t i = 0; i < midiSources.size(); ++i)
+        {
+            totalNumMessages += midiSources[i]->size();
+            midiCursors.push_back ({ midiSources[i]->begin(), midiSources[i]->end(), i });
         }
 
-        if (nodesWithMidi > 1)
-            sortByTimestampUnstable (pc.buffers.midi);
+        dest.reserve (totalNumMessages);
+
+        // A min-heap on the next message of each source, using the source index
+        // to break ties so the order is deterministic
+        auto comesAfter = [] (const MidiCursor& a, const MidiCursor& b)
+        {
+            if (isEarlier (*b.current, *a.current)) return true;
+            if (isEarlier (*a.current, *b.current)) return false;
+
+            return a.sourceIndex > b.sourceIndex;
+        };
+
+        std::make_heap (midiCursors.begin(), midiCursors.end(), comesAfter);
+
+        while (! midiCursors.empty())
+        {
+            std::pop_heap (midiCursors.begin(), midiCursors.end(), comesAfter);
+            auto& cursor = midiCursors.back();
+            dest.add (*cursor.current);
+
+            if (++cursor.current == cursor.end)
+                midiCursors.pop_back();
+            else
+                std::push_heap (midiCursors.begin(), midiCursors.end(), comesAfter);
+        }
     }
 
-    void processDoublePrecision (const ProcessContext& pc)
+    //==============================================================================
+    /** Returns the version of sumInputs specialised for the precision and, for
+        mono and stereo, the number of channels, so these aren't checked every block.
+    */
+    template<bool sumInDoublePrecision>
+    static ProcessFunction getProcessFunction (int numChannels)
     {
-        const auto numChannels = pc.buffers.audio.getNumChannels();
-        auto doubleView = tempDoubleBuffer.getView().getStart (pc.buffers.audio.getNumFrames());
-        doubleView.clear();
+        switch (numChannels)
+        {
+            case 1:     return &SummingNode::sumInputs<sumInDoublePrecision, 1>;
+            case 2:     return &SummingNode::sumInputs<sumInDoublePrecision, 2>;
+            default:    return &SummingNode::sumInputs<sumInDoublePrecision, 0>;
+        }
+    }
 
-        int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
+    /** Sums the inputs in to the output.
+        If fixedNumChannels is 0 the number of channels is taken from the output buffer.
+    */
+    template<bool sumInDoublePrecision, choc::buffer::ChannelCount fixedNumChannels>
+    void sumInputs (ProcessContext& pc)
+    {
+        const auto numChannels = fixedNumChannels > 0 ? fixedNumChannels : pc.buffers.audio.getNumChannels();
+        const auto numFrames = pc.buffers.audio.getNumFrames();
+        assert (numChannels == pc.buffers.audio.getNumChannels());
 
-        // Get each of the inputs and add them to dest
-        for (auto& node : nodes)
+        mergeInputMidi (pc.buffers.midi);
+        bool hasAddedAudio = false;
+
+        // Add all the non-silent inputs to each dest channel in a single pass
+        for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
         {
-            auto inputFromNode = node->getProcessedOutput();
+            size_t numSources = 0;
 
-            if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (doubleView.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+            for (auto& node : nodes)
+            {
+                auto inputBuffers = node->getProcessedOutput();
 
-            if (inputFromNode.midi.isNotEmpty())
-                nodesWithMidi++;
+                if (channel < inputBuffers.audio.getNumChannels() && ! inputBuffers.isAudioSilent)
+                {
+                    assert (inputBuffers.audio.getNumFrames() == numFrames);
+                    channelSources[numSources++] = inputBuffers.audio.getChannel (channel).data.data;
+                }
+            }
 
-            pc.buffers.midi.mergeFrom (inputFromNode.midi);
+            if (numSources > 0)
+            {
+                if constexpr (sumInDoublePrecision)
+                    summing_kernels::addMultipleWithDoubleAccumulation (pc.buffers.audio.getChannel (channel).data.data,
+                                                                        channelSources.data(), numSources, numFrames);
+                else
+                    summing_kernels::addMultiple (pc.buffers.audio.getChannel (channel).data.data,
+                                                  channelSources.data(), numSources, numFrames);
+
+                hasAddedAudio = true;
+            }
         }
 
-        assert (doubleView.getNumChannels() == (choc::buffer::ChannelCount) numChannels);
-
-        if (numChannels != 0)
-            add (pc.buffers.audio.getFirstChannels (numChannels), doubleView);
-
-        if (nodesWithMidi > 1)
-            sortByTimestampUnstable (pc.buffers.midi);
+        // The output is cleared before processing so if nothing's been added it's still silent
+        pc.buffers.isAudioSilent = ! hasAddedAudio;
     }
 
     //==============================================================================
@@ -229,12 +353,16 @@ private:
     {
         bool hasChanged = false;
 
+        if (! compensateForLatency)
+            return hasChanged;
+
         std::vector<std::unique_ptr<Node>> ownedNodesToAdd;
         std::vector<Node*> nodesToAdd, nodesToErase;
 
         for (auto& n : ownedNodes)
         {
-            if (auto summingNode = dynamic_cast<SummingNode*> (n.get()))
+            if (auto summingNode = dynamic_cast<SummingNode*> (n.get());
+                summingNode != nullptr && summingNode->compensateForLatency)
             {
                 for (auto& ownedNodeToAdd : summingNode->ownedNodes)
                     ownedNodesToAdd.push_back (std::move (ownedNodeToAdd));
@@ -264,41 +392,87 @@ private:
         return hasChanged;
     }
 
-    bool createLatencyNodes()
+    bool createLatencyNodes (bool shareLatencyCompensation)
     {
         bool topologyChanged = false;
         const int maxLatency = getNodeProperties().latencyNumSamples;
         std::vector<std::unique_ptr<Node>> ownedNodesToAdd;
 
-        for (auto& node : nodes)
+        auto getOwnedNode = [this] (auto nodeToFind)
         {
-            auto props = node->getNodeProperties();
-            const int nodeLatency = props.latencyNumSamples;
-            const int latencyToAdd = subtractNoWrap (maxLatency, nodeLatency);
+            for (auto& ownedN : ownedNodes)
+            {
+                if (ownedN.get() == nodeToFind)
+                {
+                    auto nodeToReturn = std::move (ownedN);
+                    ownedN.reset();
+                    return nodeToReturn;
+                }
+            }
+
+            return std::unique_ptr<Node>();
+        };
+
+        auto getLatencyToAdd = [maxLatency] (Node* n)
+        {
+            return subtractNoWrap (maxLatency, n->getNodeProperties().latencyNumSamples);
+        };
+
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            auto node = nodes[i];
+
+            if (node == nullptr)
+                continue;
+
+            const int latencyToAdd = getLatencyToAdd (node);
 
             if (latencyToAdd <= 0)
                 continue;
 
-            auto getOwnedNode = [this] (auto nodeToFind)
+            std::unique_ptr<Node> latencyNode;
+
+            // If sharing, sum all the inputs that need the same delay and then delay that
+            // so there's only a single delay line for them rather than one each
+            std::vector<std::unique_ptr<Node>> ownedNodesToShare;
+            std::vector<Node*> nodesToShare;
+
+            if (shareLatencyCompensation)
             {
-                for (auto& ownedN : ownedNodes)
+                for (size_t j = i + 1; j < nodes.size(); ++j)
                 {
-                    if (ownedN.get() == nodeToFind)
-                    {
-                        auto nodeToReturn = std::move (ownedN);
-                        ownedN.reset();
-                        return nodeToReturn;
-                    }
+                    if (nodes[j] == nullptr || getLatencyToAdd (nodes[j]) != latencyToAdd)
+                        continue;
+
+                    if (auto ownedNode = getOwnedNode (nodes[j]))
+                        ownedNodesToShare.push_back (std::move (ownedNode));
+                    else
+                        nodesToShare.push_back (nodes[j]);
+
+                    nodes[j] = nullptr;
                 }
+            }
 
-                return std::unique_ptr<Node>();
-            };
+            if (ownedNodesToShare.empty() && nodesToShare.empty())
+            {
+                auto ownedNode = getOwnedNode (node);
+                latencyNode = ownedNode != nullptr ? makeNode<LatencyNode> (std::move (ownedNode), latencyToAdd)
+                                                   : makeNode<LatencyNode> (node, latencyToAdd);
+            }
+            else
+            {
+                if (auto ownedNode = getOwnedNode (node))
+                    ownedNodesToShare.insert (ownedNodesToShare.begin(), std::move (ownedNode));
+                else
+                    nodesToShare.insert (nodesToShare.begin(), node);
+
+                auto sharedSummingNode = std::make_unique<SummingNode> (std::move (ownedNodesToShare), std::move (nodesToShare));
+                sharedSummingNode->setDoubleProcessingPrecision (useDoublePrecision);
+                latencyNode = makeNode<LatencyNode> (std::move (sharedSummingNode), latencyToAdd);
+            }
 
-            auto ownedNode = getOwnedNode (node);
-            auto latencyNode = ownedNode != nullptr ? makeNode<LatencyNode> (std::move (ownedNode), latencyToAdd)
-                                                    : makeNode<LatencyNode> (node, latencyToAdd);
             ownedNodesToAdd.push_back (std::move (latencyNode));
-            node = nullptr;
+            nodes[i] = nullptr;
             topologyChanged = true;
             cachedNodeProperties = std::nullopt;
         }
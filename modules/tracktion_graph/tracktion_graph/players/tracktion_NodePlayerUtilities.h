@@ -85,18 +85,21 @@ namespace node_player_utils
     {
         size_t numCycles = 0;
 
+        std::unordered_map<Node*, size_t> nodePositions;
+        nodePositions.reserve (orderedNodes.size());
+
+        for (size_t i = 0; i < orderedNodes.size(); ++i)
+            nodePositions[orderedNodes[i]] = i;
+
         // Iterate from the first node to the last
         // Find each input of the Node
         // Ensure that the input is in a lower position than the current
-        for (auto iter = orderedNodes.begin(); iter != orderedNodes.end(); ++iter)
+        for (size_t position = 0; position < orderedNodes.size(); ++position)
         {
-            auto node = *iter;
-            auto position = std::distance (orderedNodes.begin(), iter);
-
-            for (auto inputNode : node->getDirectInputNodes())
+            for (auto inputNode : orderedNodes[position]->getDirectInputNodes())
             {
-                const auto inputPosition = std::distance (orderedNodes.begin(),
-                                                          std::find (orderedNodes.begin(), orderedNodes.end(), inputNode));
+                const auto found = nodePositions.find (inputNode);
+                const auto inputPosition = found != nodePositions.end() ? found->second : orderedNodes.size();
 
                 if (inputPosition > position)
                     ++numCycles;
@@ -106,19 +109,240 @@ namespace node_player_utils
         return numCycles > 0;
     }
 
-    /** Prepares a specific Node to be played and returns all the Nodes. */
+    /** Assigns each Node's audio buffer a fixed region of a single contiguous block
+        of memory owned by the NodeGraph.
+
+        Regions are shared between Nodes whose buffers can never be in use at the same
+        time, regardless of which threads the Nodes are processed on. A Node can only
+        reuse a region if every Node that reads from the previous occupant is one of its
+        inputs (directly or indirectly) so is guaranteed to have been processed first.
+        Nodes that might pass on an input buffer extend the lifetime of that buffer to
+        their own outputs (@see Node::mayForwardInputBuffers).
+
+        N.B. As this is calculated up front, Nodes with more than one input that allocate
+        their own buffer must not pass on their input buffers with setAudioOutput.
+
+        This must be called after the Nodes have been initialised.
+        @returns the number of bytes allocated for the graph's buffers
+    */
+    inline size_t allocateStaticBuffers (NodeGraph& nodeGraph)
+    {
+        const auto& nodes = nodeGraph.orderedNodes;
+        const auto numNodes = nodes.size();
+
+        std::unordered_map<Node*, size_t> nodeIndices;
+        nodeIndices.reserve (numNodes);
+
+        for (size_t i = 0; i < numNodes; ++i)
+            nodeIndices[nodes[i]] = i;
+
+        std::vector<std::vector<size_t>> inputs (numNodes), outputs (numNodes);
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            for (auto input : nodes[i]->getDirectInputNodes())
+            {
+                if (auto found = nodeIndices.find (input); found != nodeIndices.end())
+                {
+                    inputs[i].push_back (found->second);
+                    outputs[found->second].push_back (i);
+                }
+            }
+        }
+
+        // Find all the Nodes guaranteed to have been processed before each Node
+        // orderedNodes has inputs before outputs so these can be built in one pass
+        const size_t numWords = (numNodes + 63) / 64;
+        std::vector<uint64_t> ancestors (numNodes * numWords, 0);
+
+        auto getAncestors = [&] (size_t i) { return ancestors.data() + i * numWords; };
+        auto isAncestor = [&] (size_t possibleAncestor, size_t i) { return (getAncestors (i)[possibleAncestor / 64] >> (possibleAncestor % 64)) & 1; };
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            auto nodeAncestors = getAncestors (i);
+
+            for (auto input : inputs[i])
+            {
+                auto inputAncestors = getAncestors (input);
+
+                for (size_t w = 0; w < numWords; ++w)
+                    nodeAncestors[w] |= inputAncestors[w];
+
+                nodeAncestors[input / 64] |= (uint64_t (1) << (input % 64));
+            }
+        }
+
+        // Find the Nodes that need to have been processed before each Node's buffer can be reused.
+        // Buffers that reach the root (or a Node with no outputs) are needed until the end of the block
+        std::vector<std::vector<size_t>> readers (numNodes);
+        std::vector<bool> isNeededUntilEnd (numNodes, false);
+
+        for (size_t i = numNodes; i-- > 0;)
+        {
+            if (outputs[i].empty())
+            {
+                isNeededUntilEnd[i] = true;
+                continue;
+            }
+
+            auto& nodeReaders = readers[i];
+
+            for (auto output : outputs[i])
+            {
+                nodeReaders.push_back (output);
+
+                if (nodes[output]->mayForwardInputBuffers())
+                {
+                    if (isNeededUntilEnd[output])
+                        isNeededUntilEnd[i] = true;
+
+                    nodeReaders.insert (nodeReaders.end(), readers[output].begin(), readers[output].end());
+                }
+            }
+
+            std::sort (nodeReaders.begin(), nodeReaders.end());
+            nodeReaders.erase (std::unique (nodeReaders.begin(), nodeReaders.end()), nodeReaders.end());
+        }
+
+        // Assign Nodes to regions, reusing any region whose last occupant has finished being read
+        struct Region
+        {
+            size_t numSamples = 0;
+            size_t lastNode = 0;
+        };
+
+        std::vector<Region> regions;
+        constexpr size_t noRegion = std::numeric_limits<size_t>::max();
+        std::vector<size_t> nodeRegions (numNodes, noRegion);
+
+        auto canReuse = [&] (const Region& region, size_t nodeIndex)
+        {
+            if (isNeededUntilEnd[region.lastNode])
+                return false;
+
+            for (auto reader : readers[region.lastNode])
+                if (! isAncestor (reader, nodeIndex))
+                    return false;
+
+            return true;
+        };
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            const auto size = nodes[i]->getInternalAudioBufferSize();
+            const auto numSamples = (size_t) size.numChannels * (size_t) size.numFrames;
+
+            if (numSamples == 0)
+                continue;
+
+            // Prefer the smallest region that fits, otherwise grow the largest
+            size_t bestFit = noRegion, largest = noRegion;
+
+            for (size_t r = 0; r < regions.size(); ++r)
+            {
+                if (! canReuse (regions[r], i))
+                    continue;
+
+                if (regions[r].numSamples >= numSamples
+                    && (bestFit == noRegion || regions[r].numSamples < regions[bestFit].numSamples))
+                    bestFit = r;
+
+                if (largest == noRegion || regions[r].numSamples > regions[largest].numSamples)
+                    largest = r;
+            }
+
+            auto regionIndex = bestFit != noRegion ? bestFit : largest;
+
+            if (regionIndex == noRegion)
+            {
+                regionIndex = regions.size();
+                regions.emplace_back();
+            }
+
+            auto& region = regions[regionIndex];
+            region.numSamples = std::max (region.numSamples, numSamples);
+            region.lastNode = i;
+            nodeRegions[i] = regionIndex;
+        }
+
+        // Lay out the regions, aligning them to help vectorisation
+        constexpr size_t alignment = 16;
+        std::vector<size_t> regionOffsets;
+        size_t totalNumSamples = 0, totalNumChannels = 0;
+
+        for (auto& region : regions)
+        {
+            regionOffsets.push_back (totalNumSamples);
+            totalNumSamples += (region.numSamples + alignment - 1) / alignment * alignment;
+        }
+
+        for (size_t i = 0; i < numNodes; ++i)
+            if (nodeRegions[i] != noRegion)
+                totalNumChannels += nodes[i]->getInternalAudioBufferSize().numChannels;
+
+        auto arena = std::make_unique<NodeBufferArena>();
+        arena->samples.resize (totalNumSamples + alignment, 0.0f);
+        arena->channels.resize (totalNumChannels, nullptr);
+
+        auto firstSample = arena->samples.data();
+
+        if (const auto misalignment = (reinterpret_cast<uintptr_t> (firstSample) / sizeof (float)) % alignment; misalignment != 0)
+            firstSample += alignment - misalignment;
+
+        size_t channelIndex = 0;
+
+        for (size_t i = 0; i < numNodes; ++i)
+        {
+            if (nodeRegions[i] == noRegion)
+                continue;
+
+            const auto size = nodes[i]->getInternalAudioBufferSize();
+            auto regionStart = firstSample + regionOffsets[nodeRegions[i]];
+            auto nodeChannels = arena->channels.data() + channelIndex;
+
+            for (choc::buffer::ChannelCount c = 0; c < size.numChannels; ++c)
+                nodeChannels[c] = regionStart + c * size.numFrames;
+
+            channelIndex += size.numChannels;
+            nodes[i]->useExternalAudioBuffer (choc::buffer::createChannelArrayView (nodeChannels, size.numChannels, size.numFrames));
+        }
+
+        const auto numBytes = arena->samples.size() * sizeof (float);
+        nodeGraph.bufferArena = std::move (arena);
+
+        return numBytes;
+    }
+
+    /** Prepares a specific Node to be played and returns all the Nodes.
+
+        Every Node in the new graph is transformed and initialised, whether it has
+        changed or not. The Nodes in oldGraph can't be reused as it may still be being
+        processed until the new graph replaces it. Instead, Nodes with state such as
+        delay lines or file readers take it over from the Node with the same ID in
+        oldGraph when they're initialised, using findNodeWithID. So unchanged Nodes
+        carry on where they left off but the time taken still grows with the size of
+        the whole graph, not just the parts that changed.
+
+        If useStaticBufferAllocation is true and no allocateAudioBuffer function is
+        supplied, buffers will be assigned with allocateStaticBuffers.
+        If shareLatencyCompensation is true, inputs that need the same latency compensation
+        will share a delay line (@see Node::TransformOptions::shareLatencyCompensation).
+    */
     static std::unique_ptr<NodeGraph> prepareToPlay (std::unique_ptr<Node> node, NodeGraph* oldGraph,
                                                      double sampleRate, int blockSize,
                                                      std::function<NodeBuffer (choc::buffer::Size)> allocateAudioBuffer = nullptr,
                                                      std::function<void (NodeBuffer&&)> deallocateAudioBuffer = nullptr,
                                                      bool nodeMemorySharingEnabled = false,
-                                                     bool disableLatencyCompensation = false)
+                                                     bool disableLatencyCompensation = false,
+                                                     bool useStaticBufferAllocation = false,
+                                                     bool shareLatencyCompensation = false)
     {
         if (node == nullptr)
             return {};
 
         // First give the Nodes a chance to transform
-        auto nodeGraph = createNodeGraph (std::move (node), disableLatencyCompensation);
+        auto nodeGraph = createNodeGraph (std::move (node), disableLatencyCompensation, shareLatencyCompensation);
         assert (! areThereAnyCycles (nodeGraph->orderedNodes));
         jassert (areNodeIDsUnique (nodeGraph->orderedNodes, true));
 
@@ -128,9 +352,16 @@ namespace node_player_utils
                                                 allocateAudioBuffer, deallocateAudioBuffer,
                                                 nodeMemorySharingEnabled };
 
+        const auto initialiseStart = std::chrono::steady_clock::now();
+
         for (auto n : nodeGraph->orderedNodes)
             n->initialise (info);
 
+        nodeGraph->initialiseDuration = std::chrono::steady_clock::now() - initialiseStart;
+
+        if (useStaticBufferAllocation && ! allocateAudioBuffer)
+            allocateStaticBuffers (*nodeGraph);
+
         return nodeGraph;
     }
 
@@ -0,0 +1,205 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if __has_include(<choc/text/choc_JSON.h>)
+ #include <choc/text/choc_JSON.h>
+#else
+ #include "../../3rd_party/choc/text/choc_JSON.h"
+#endif
+
+#if __has_include (<cxxabi.h>)
+ #include <cxxabi.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+namespace detail
+{
+    struct ExportedNode
+    {
+        Node* node = nullptr;
+        std::string typeName;
+        NodeProperties properties;
+        size_t allocatedBytes = 0;
+        size_t numInputs = 0, numOutputs = 0;
+        bool hasInternalNodes = false;
+        const NodeProfiler::NodeStatistics* statistics = nullptr;
+    };
+
+    inline std::string getShortTypeName (const std::string& typeName)
+    {
+        return choc::text::replace (typeName,
+                                    "tracktion::engine::", "te::",
+                                    "tracktion::graph::", "tg::");
+    }
+
+    inline std::string formatMicroseconds (double seconds)
+    {
+        return choc::text::floatToString (seconds * 1.0e6, 1) + "us";
+    }
+}
+
+std::string getNodeTypeName (const Node& node)
+{
+    std::string name (typeid (node).name());
+
+   #if __has_include (<cxxabi.h>)
+    int status = 0;
+
+    if (char* demangled = abi::__cxa_demangle (name.c_str(), nullptr, nullptr, &status); status == 0)
+    {
+        name = demangled;
+        free (demangled);
+    }
+   #endif
+
+    // MSVC prefixes names with "class " or "struct "
+    for (auto prefix : { "class ", "struct " })
+        if (choc::text::startsWith (name, prefix))
+            name = name.substr (std::string_view (prefix).size());
+
+    return name;
+}
+
+std::string exportGraph (Node& rootNode, GraphExportFormat format,
+                         const std::unordered_map<size_t, NodeProfiler::NodeStatistics>& statistics)
+{
+    std::vector<detail::ExportedNode> nodes;
+    std::unordered_map<Node*, size_t> indices;
+    std::vector<std::pair<size_t, size_t>> edges;
+
+    // Postordering means every Node's inputs are listed before it
+    visitNodes (rootNode, [&] (Node& n)
+                {
+                    indices[&n] = nodes.size();
+
+                    detail::ExportedNode exported;
+                    exported.node = &n;
+                    exported.typeName = getNodeTypeName (n);
+                    exported.properties = n.getNodeProperties();
+                    exported.allocatedBytes = n.getAllocatedBytes();
+                    exported.hasInternalNodes = ! n.getInternalNodes().empty();
+
+                    if (auto found = statistics.find (exported.properties.nodeID); found != statistics.end())
+                        exported.statistics = &found->second;
+
+                    nodes.push_back (std::move (exported));
+                }, false);
+
+    for (auto& exported : nodes)
+    {
+        const auto destIndex = indices[exported.node];
+
+        for (auto input : exported.node->getDirectInputNodes())
+        {
+            const auto sourceIndex = indices[input];
+            edges.emplace_back (sourceIndex, destIndex);
+            ++exported.numInputs;
+            ++nodes[sourceIndex].numOutputs;
+        }
+    }
+
+    if (format == GraphExportFormat::json)
+    {
+        auto nodesArray = choc::value::createEmptyArray();
+
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            auto& exported = nodes[i];
+            auto object = choc::value::createObject ("Node",
+                                                     "index", (int64_t) i,
+                                                     "type", exported.typeName,
+                                                     "nodeID", std::to_string (exported.properties.nodeID),
+                                                     "hasAudio", exported.properties.hasAudio,
+                                                     "hasMidi", exported.properties.hasMidi,
+                                                     "numChannels", (int32_t) exported.properties.numberOfChannels,
+                                                     "latencySamples", (int32_t) exported.properties.latencyNumSamples,
+                                                     "allocatedBytes", (int64_t) exported.allocatedBytes,
+                                                     "numInputs", (int64_t) exported.numInputs,
+                                                     "numOutputs", (int64_t) exported.numOutputs,
+                                                     "hasInternalNodes", exported.hasInternalNodes);
+
+            if (auto s = exported.statistics)
+                object.addMember ("timing", choc::value::createObject ("Timing",
+                                                                       "numRuns", (int64_t) s->statistics.numRuns,
+                                                                       "meanSeconds", s->statistics.meanSeconds,
+                                                                       "maxSeconds", s->statistics.maximumSeconds,
+                                                                       "p99Seconds", s->p99Seconds,
+                                                                       "totalSeconds", s->statistics.totalSeconds));
+
+            nodesArray.addArrayElement (std::move (object));
+        }
+
+        auto edgesArray = choc::value::createEmptyArray();
+
+        for (auto [source, dest] : edges)
+            edgesArray.addArrayElement (choc::value::createObject ("Edge",
+                                                                   "source", (int64_t) source,
+                                                                   "dest", (int64_t) dest));
+
+        return choc::json::toString (choc::value::createObject ("Graph",
+                                                                "nodes", std::move (nodesArray),
+                                                                "edges", std::move (edgesArray)),
+                                     true);
+    }
+
+    // The DOT nodes are shaded by their share of the total processing time
+    double totalSeconds = 0.0;
+
+    for (auto& exported : nodes)
+        if (exported.statistics != nullptr)
+            totalSeconds += exported.statistics->statistics.totalSeconds;
+
+    std::string output = "digraph {\n";
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        auto& exported = nodes[i];
+        auto& props = exported.properties;
+
+        auto label = detail::getShortTypeName (exported.typeName)
+                        + "\\nID: " + std::to_string (props.nodeID)
+                        + "\\nCh: " + std::to_string (props.numberOfChannels)
+                        + (props.hasMidi ? " +MIDI" : "");
+
+        if (props.latencyNumSamples > 0)
+            label += "\\nLt: " + std::to_string (props.latencyNumSamples);
+
+        if (exported.allocatedBytes > 0)
+            label += "\\nMem: " + std::to_string (exported.allocatedBytes);
+
+        std::string attributes = exported.hasInternalNodes ? " shape=box" : "";
+
+        if (auto s = exported.statistics)
+        {
+            label += "\\nMean: " + detail::formatMicroseconds (s->statistics.meanSeconds)
+                   + " p99: " + detail::formatMicroseconds (s->p99Seconds);
+
+            if (totalSeconds > 0.0)
+            {
+                const auto share = s->statistics.totalSeconds / totalSeconds;
+                label += "\\n" + choc::text::floatToString (share * 100.0, 1) + "%";
+                attributes += " style=filled fillcolor=\"0.0 " + choc::text::floatToString (std::clamp (share, 0.0, 1.0), 3) + " 1.0\"";
+            }
+        }
+
+        output += "n" + std::to_string (i) + " [label=\"" + choc::text::replace (label, "\"", "\\\"") + "\"" + attributes + "]\n";
+    }
+
+    for (auto [source, dest] : edges)
+        output += "n" + std::to_string (source) + " -> n" + std::to_string (dest) + "\n";
+
+    output += "}\n";
+
+    return output;
+}
+
+}}
@@ -0,0 +1,42 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+/** The formats exportGraph can write. */
+enum class GraphExportFormat
+{
+    dot,    /**< A graphviz digraph, e.g. `dot -Tsvg graph.dot > graph.svg` */
+    json    /**< An object with "nodes" and "edges" arrays. */
+};
+
+/** Writes the structure of a graph along with the properties of each Node so
+    the topology that was actually built, including any latency and summing
+    Nodes added when transforming it, can be inspected.
+
+    Each Node lists its type, NodeProperties, the bytes returned by
+    getAllocatedBytes and its number of inputs and outputs. If statistics from
+    NodeProfiler::getStatistics are passed in, the mean, max and 99th
+    percentile processing times of each Node are added and, in the DOT format,
+    the Nodes are shaded by their share of the total time to show the worst offenders.
+
+    This walks the graph so call it when the Nodes can't be replaced or deleted,
+    e.g. on the message thread for an EditPlaybackContext's graph.
+*/
+std::string exportGraph (Node& rootNode, GraphExportFormat,
+                         const std::unordered_map<size_t, NodeProfiler::NodeStatistics>& statistics = {});
+
+/** Returns the demangled class name of a Node, where the platform supports it. */
+std::string getNodeTypeName (const Node&);
+
+}}
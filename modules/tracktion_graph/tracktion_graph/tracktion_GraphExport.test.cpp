@@ -0,0 +1,83 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_GRAPHEXPORT
+
+class GraphExportTests  : public juce::UnitTest
+{
+public:
+    GraphExportTests()
+        : juce::UnitTest ("GraphExport", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        std::vector<std::unique_ptr<Node>> inputs;
+        inputs.push_back (makeNode<SinNode> (220.0f, 2, 1));
+        inputs.push_back (makeNode<LatencyNode> (makeNode<SinNode> (440.0f, 1, 2), 100));
+        auto rootNode = makeNode<SummingNode> (std::move (inputs));
+
+        std::unordered_map<size_t, NodeProfiler::NodeStatistics> statistics;
+        statistics[1].statistics.addResult (0.001, 1000);
+        statistics[1].p99Seconds = 0.001;
+
+        beginTest ("JSON export");
+        {
+            const auto graph = choc::json::parse (exportGraph (*rootNode, GraphExportFormat::json, statistics));
+            const auto nodes = graph["nodes"];
+            expectEquals ((int) nodes.size(), 4);
+            expectEquals ((int) graph["edges"].size(), 3);
+
+            int numTimed = 0, numWithLatency = 0;
+
+            for (uint32_t i = 0; i < nodes.size(); ++i)
+            {
+                const auto node = nodes[i];
+
+                if (node.hasObjectMember ("timing"))
+                {
+                    ++numTimed;
+                    expectEquals (node["nodeID"].getWithDefault<std::string> ({}), std::string ("1"));
+                    expectEquals (node["numChannels"].getWithDefault<int> (0), 2);
+                    expectEquals (node["timing"]["meanSeconds"].getWithDefault<double> (0.0), 0.001);
+                }
+
+                if (node["latencySamples"].getWithDefault<int> (0) == 100)
+                    ++numWithLatency;
+            }
+
+            expectEquals (numTimed, 1);
+            expect (numWithLatency > 0);
+
+            // The root is listed last as the Nodes are postordered
+            expectEquals (nodes[3]["numInputs"].getWithDefault<int> (0), 2);
+            expectEquals (nodes[3]["numOutputs"].getWithDefault<int> (-1), 0);
+        }
+
+        beginTest ("DOT export");
+        {
+            const auto dot = exportGraph (*rootNode, GraphExportFormat::dot, statistics);
+            expect (choc::text::startsWith (dot, "digraph {"));
+            expect (dot.find ("SinNode") != std::string::npos);
+            expect (dot.find ("Lt: 100") != std::string::npos);
+            expect (dot.find ("fillcolor") != std::string::npos);
+            expectEquals ((int) std::count (dot.begin(), dot.end(), '>'), 3);
+        }
+    }
+};
+
+static GraphExportTests graphExportTests;
+
+#endif
+
+}} // namespace tracktion
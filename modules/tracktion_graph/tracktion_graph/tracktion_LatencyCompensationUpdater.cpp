@@ -0,0 +1,139 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+LatencyCompensationUpdater::LatencyCompensationUpdater (Node& root)
+    : rootNode (root),
+      orderedNodes (getNodes (root, VertexOrdering::postordering))
+{
+    for (auto node : orderedNodes)
+    {
+        latencies[node] = node->getNodeProperties().latencyNumSamples;
+
+        for (auto input : node->getDirectInputNodes())
+            ++numOutputs[input];
+    }
+}
+
+int LatencyCompensationUpdater::getLatencyNumSamples() const
+{
+    const auto found = latencies.find (&rootNode);
+    return found != latencies.end() ? found->second : 0;
+}
+
+bool LatencyCompensationUpdater::applyLatencyChanges (const std::vector<LatencyChange>& changes)
+{
+    auto newLatencies = latencies;
+    std::vector<std::pair<LatencyNode*, int>> newDelays;
+
+    auto getOwnDelta = [&changes] (Node* node)
+    {
+        int delta = 0;
+
+        for (auto& change : changes)
+            if (change.node == node)
+                delta += change.deltaNumSamples;
+
+        return delta;
+    };
+
+    // Only LatencyNodes that feed nothing else can be changed without affecting other Nodes
+    auto getCompensatingNode = [&] (Node* input) -> LatencyNode*
+    {
+        if (auto latencyNode = dynamic_cast<LatencyNode*> (input))
+            if (numOutputs[input] == 1 && getOwnDelta (input) == 0)
+                return latencyNode;
+
+        return nullptr;
+    };
+
+    // Nodes are visited inputs first so their inputs' new latencies are already known
+    for (auto node : orderedNodes)
+    {
+        const auto inputs = node->getDirectInputNodes();
+        auto summingNode = dynamic_cast<SummingNode*> (node);
+
+        if (summingNode == nullptr || ! summingNode->isLatencyCompensationEnabled() || inputs.empty())
+        {
+            // Anything else passes its inputs' latency through so they all have to change by the same amount
+            std::optional<int> inputDelta;
+
+            for (auto input : inputs)
+            {
+                const auto delta = newLatencies[input] - latencies[input];
+
+                if (inputDelta && *inputDelta != delta)
+                    return false;
+
+                inputDelta = delta;
+            }
+
+            newLatencies[node] = latencies[node] + inputDelta.value_or (0) + getOwnDelta (node);
+            continue;
+        }
+
+        auto getUndelayedLatency = [&] (Node* input)
+        {
+            if (auto latencyNode = getCompensatingNode (input))
+                return newLatencies[latencyNode->getDirectInputNodes().front()];
+
+            return newLatencies[input];
+        };
+
+        int maxLatency = std::numeric_limits<int>::min();
+
+        for (auto input : inputs)
+            maxLatency = std::max (maxLatency, getUndelayedLatency (input));
+
+        for (auto input : inputs)
+        {
+            // Inputs that weren't lined up, e.g. when compensation was disabled, are left as they are
+            if (latencies[input] != latencies[node])
+                continue;
+
+            if (auto latencyNode = getCompensatingNode (input))
+            {
+                const auto newDelay = maxLatency - getUndelayedLatency (input);
+
+                if (newDelay != latencyNode->getLatencyNumSamples())
+                {
+                    if (! latencyNode->canSetLatencyNumSamplesLive (newDelay))
+                        return false;
+
+                    newDelays.emplace_back (latencyNode, newDelay);
+                }
+
+                newLatencies[input] = maxLatency;
+            }
+            else if (newLatencies[input] != maxLatency)
+            {
+                // This input would need a delay line it doesn't have
+                return false;
+            }
+        }
+
+        newLatencies[node] = maxLatency;
+    }
+
+    for (auto& [latencyNode, newDelay] : newDelays)
+    {
+        [[ maybe_unused ]] const bool wasSet = latencyNode->setLatencyNumSamplesLive (newDelay);
+        jassert (wasSet);
+    }
+
+    latencies = std::move (newLatencies);
+
+    return true;
+}
+
+}}
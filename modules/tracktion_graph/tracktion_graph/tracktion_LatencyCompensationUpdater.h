@@ -0,0 +1,68 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Re-solves the latency compensation of a playing graph when some of its Nodes
+    change their latency, without the graph having to be rebuilt.
+
+    SummingNodes line their inputs up by delaying them with LatencyNodes. When a Node's
+    latency changes, these delays are changed to match and each LatencyNode crossfades
+    to its new delay. This is only possible if every input that needs a different delay
+    already has its own LatencyNode, the Nodes in between pass their inputs' latency
+    straight through and the delay lines are big enough. Otherwise nothing is changed
+    and the graph needs rebuilding.
+
+    Many Nodes cache their NodeProperties so won't report the new latencies. Instead,
+    this keeps track of the latency of every Node so one should be kept for each graph
+    and used for all the changes made to it.
+
+    This should be used on the message thread.
+*/
+class LatencyCompensationUpdater
+{
+public:
+    /** Creates an updater for a prepared graph, taking the current latency of its Nodes. */
+    LatencyCompensationUpdater (Node& rootNode);
+
+    /** Returns the Node this was created for. */
+    Node& getRootNode() const                   { return rootNode; }
+
+    /** Returns the latency of the root Node, including any changes made. */
+    int getLatencyNumSamples() const;
+
+    /** A change to the latency a Node adds to its input. */
+    struct LatencyChange
+    {
+        Node* node = nullptr;
+        int deltaNumSamples = 0;
+    };
+
+    /** Changes the delays of the graph's LatencyNodes to compensate for some Nodes
+        changing their latency.
+        Returns false if the graph can't be compensated without being rebuilt, in which
+        case nothing is changed.
+    */
+    bool applyLatencyChanges (const std::vector<LatencyChange>&);
+
+private:
+    Node& rootNode;
+    std::vector<Node*> orderedNodes;
+    std::unordered_map<Node*, int> latencies;
+    std::unordered_map<Node*, int> numOutputs;
+};
+
+}}
@@ -0,0 +1,241 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_LATENCYCOMPENSATIONUPDATER
+
+class LatencyCompensationUpdaterTests  : public juce::UnitTest
+{
+public:
+    LatencyCompensationUpdaterTests()
+        : juce::UnitTest ("LatencyCompensationUpdater", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runLatencyProcessorTests();
+        runUpdaterTests();
+    }
+
+private:
+    //==============================================================================
+    void runLatencyProcessorTests()
+    {
+        beginTest ("LatencyProcessor live changes");
+        {
+            constexpr int blockSize = 64;
+            LatencyProcessor processor;
+            processor.setLatencyNumSamples (10);
+            processor.prepareToPlay (44100.0, blockSize, 1);
+
+            choc::buffer::ChannelArrayBuffer<float> input (1, blockSize), output (1, blockSize);
+            int numSamplesWritten = 0;
+
+            // The input is a ramp so the delay can be read from the output
+            auto processBlock = [&]
+            {
+                setAllFrames (input, [&numSamplesWritten] (auto frame) { return (float) (numSamplesWritten + (int) frame); });
+                processor.writeAudio (input.getView());
+                processor.readAudioOverwriting (output.getView());
+                numSamplesWritten += blockSize;
+            };
+
+            auto expectDelay = [&] (int delay)
+            {
+                const auto firstSample = output.getSample (0, 0);
+                const auto lastSample = output.getSample (0, blockSize - 1);
+                expectEquals ((int) firstSample, numSamplesWritten - blockSize - delay);
+                expectEquals ((int) lastSample, numSamplesWritten - 1 - delay);
+            };
+
+            for (int i = 0; i < 4; ++i)
+                processBlock();
+
+            expectDelay (10);
+
+            for (int newLatency : { 60, 3, 0, 50 })
+            {
+                expect (processor.setLatencyNumSamplesLive (newLatency));
+                expectEquals (processor.getLatencyNumSamples(), newLatency);
+
+                // The changing block is a crossfade between the two delays so ends on the new one
+                processBlock();
+                expectEquals ((int) output.getSample (0, blockSize - 1), numSamplesWritten - 1 - newLatency);
+
+                processBlock();
+                expectDelay (newLatency);
+            }
+
+            expect (! processor.canSetLatencyNumSamplesLive (1'000'000));
+            expect (! processor.setLatencyNumSamplesLive (1'000'000));
+            expectEquals (processor.getLatencyNumSamples(), 50);
+        }
+    }
+
+    void runUpdaterTests()
+    {
+        // Sines at this frequency cancel out when they're 200 samples apart so any misalignment shows
+        constexpr float frequency = 330.0f;
+        test_utilities::TestSetup testSetup;
+        const auto oneSecond = (int) testSetup.sampleRate;
+
+        auto getCompensatingNodes = [] (Node& rootNode, LatencyNode* nodeToIgnore)
+        {
+            std::vector<LatencyNode*> latencyNodes;
+
+            for (auto node : getNodes (rootNode, VertexOrdering::postordering))
+                if (auto latencyNode = dynamic_cast<LatencyNode*> (node); latencyNode != nullptr && latencyNode != nodeToIgnore)
+                    latencyNodes.push_back (latencyNode);
+
+            return latencyNodes;
+        };
+
+        beginTest ("Changing the latency of an input");
+        {
+            auto changingNode = makeNode<LatencyNode> (makeNode<SinNode> (frequency, 1, 1), 100);
+            auto changingNodePtr = changingNode.get();
+
+            std::vector<std::unique_ptr<Node>> inputs;
+            inputs.push_back (makeNode<SinNode> (frequency, 1, 2));
+            inputs.push_back (makeNode<ForwardingNode> (std::move (changingNode)));
+
+            TestProcess<NodePlayer> testProcess (std::make_unique<NodePlayer> (makeNode<SummingNode> (std::move (inputs))),
+                                                 testSetup, 1, 4.0, true);
+            testProcess.process (oneSecond);
+
+            auto& rootNode = testProcess.getNode();
+            auto compensatingNodes = getCompensatingNodes (rootNode, changingNodePtr);
+            expectEquals ((int) compensatingNodes.size(), 1);
+
+            LatencyCompensationUpdater updater (rootNode);
+            expectEquals (updater.getLatencyNumSamples(), 100);
+
+            for (int newLatency : { 300, 50, 0 })
+            {
+                const auto delta = newLatency - changingNodePtr->getLatencyNumSamples();
+                expect (changingNodePtr->setLatencyNumSamplesLive (newLatency));
+                expect (updater.applyLatencyChanges ({ { changingNodePtr, delta } }));
+                expectEquals (updater.getLatencyNumSamples(), newLatency);
+                expectEquals (compensatingNodes.front()->getLatencyNumSamples(), newLatency);
+
+                testProcess.process (oneSecond / 2);
+            }
+
+            testProcess.process (oneSecond / 2);
+            auto testContext = testProcess.getTestResult();
+
+            // If the inputs are still lined up they sum to twice the level
+            test_utilities::expectAudioBuffer (*this, testContext->buffer, 0,
+                                               juce::Range<int>::withStartAndLength (testContext->buffer.getNumSamples() - oneSecond / 4, oneSecond / 4),
+                                               2.0f, 1.414f);
+        }
+
+        beginTest ("Changes that need a rebuild");
+        {
+            auto changingNode = makeNode<LatencyNode> (makeNode<SinNode> (frequency, 1, 1), 50);
+            auto changingNodePtr = changingNode.get();
+
+            std::vector<std::unique_ptr<Node>> inputs;
+            inputs.push_back (makeNode<SinNode> (frequency, 1, 2));
+            inputs.push_back (makeNode<ForwardingNode> (makeNode<LatencyNode> (makeNode<SinNode> (frequency, 1, 3), 100)));
+            inputs.push_back (makeNode<ForwardingNode> (std::move (changingNode)));
+
+            TestProcess<NodePlayer> testProcess (std::make_unique<NodePlayer> (makeNode<SummingNode> (std::move (inputs))),
+                                                 testSetup, 1, 1.0, false);
+            testProcess.process (oneSecond / 2);
+
+            auto& rootNode = testProcess.getNode();
+            LatencyCompensationUpdater updater (rootNode);
+            expectEquals (updater.getLatencyNumSamples(), 100);
+
+            // The input with the most latency has no delay line to line it up with a longer one
+            expect (! updater.applyLatencyChanges ({ { changingNodePtr, 100 } }));
+            expectEquals (updater.getLatencyNumSamples(), 100);
+
+            for (auto latencyNode : getCompensatingNodes (rootNode, changingNodePtr))
+                expect (latencyNode->getLatencyNumSamples() == 100 || latencyNode->getLatencyNumSamples() == 50);
+
+            // But it can still get shorter
+            expect (updater.applyLatencyChanges ({ { changingNodePtr, -50 } }));
+            expectEquals (updater.getLatencyNumSamples(), 100);
+        }
+
+        // Sums two sines of different frequencies, one of them delayed, so they can't cancel out
+        auto createUnmatchedGraph = [] (int latency, LatencyNode*& changingNodePtr)
+        {
+            auto changingNode = makeNode<LatencyNode> (makeNode<SinNode> (220.0f, 1, 1), latency);
+            changingNodePtr = changingNode.get();
+
+            std::vector<std::unique_ptr<Node>> inputs;
+            inputs.push_back (makeNode<SinNode> (330.0f, 1, 2));
+            inputs.push_back (makeNode<ForwardingNode> (std::move (changingNode)));
+
+            return makeNode<SummingNode> (std::move (inputs));
+        };
+
+        beginTest ("Delay lines that are too small need a rebuild");
+        {
+            LatencyNode* changingNodePtr = nullptr;
+            TestProcess<NodePlayer> testProcess (std::make_unique<NodePlayer> (createUnmatchedGraph (100, changingNodePtr)),
+                                                 testSetup, 1, 1.0, false);
+            testProcess.process (oneSecond / 2);
+
+            auto& rootNode = testProcess.getNode();
+            auto compensatingNodes = getCompensatingNodes (rootNode, changingNodePtr);
+            expectEquals ((int) compensatingNodes.size(), 1);
+
+            LatencyCompensationUpdater updater (rootNode);
+            expect (! updater.applyLatencyChanges ({ { changingNodePtr, 1'000'000 } }));
+            expectEquals (updater.getLatencyNumSamples(), 100);
+            expectEquals (compensatingNodes.front()->getLatencyNumSamples(), 100);
+        }
+
+        beginTest ("Live changes match a rebuilt graph");
+        {
+            constexpr int initialLatency = 300;
+            const auto changeSample = oneSecond / 2;
+
+            for (int newLatency : { 100, 0, 250 })
+            {
+                LatencyNode* changingNodePtr = nullptr;
+                TestProcess<NodePlayer> liveProcess (std::make_unique<NodePlayer> (createUnmatchedGraph (initialLatency, changingNodePtr)),
+                                                     testSetup, 1, 1.0, true);
+                liveProcess.process (changeSample);
+
+                LatencyCompensationUpdater updater (liveProcess.getNode());
+                expect (changingNodePtr->setLatencyNumSamplesLive (newLatency));
+                expect (updater.applyLatencyChanges ({ { changingNodePtr, newLatency - initialLatency } }));
+                auto live = liveProcess.processAll();
+
+                LatencyNode* rebuiltNodePtr = nullptr;
+                auto rebuilt = TestProcess<NodePlayer> (std::make_unique<NodePlayer> (createUnmatchedGraph (newLatency, rebuiltNodePtr)),
+                                                        testSetup, 1, 1.0, true).processAll();
+
+                expectEquals (live->buffer.getNumSamples(), rebuilt->buffer.getNumSamples());
+
+                // The block after the change crossfades between the delays, after that they should be identical
+                float maxDifference = 0.0f;
+
+                for (int i = changeSample + testSetup.blockSize; i < live->buffer.getNumSamples(); ++i)
+                    maxDifference = std::max (maxDifference, std::abs (live->buffer.getSample (0, i) - rebuilt->buffer.getSample (0, i)));
+
+                expectLessThan (maxDifference, 0.0001f);
+            }
+        }
+    }
+};
+
+static LatencyCompensationUpdaterTests latencyCompensationUpdaterTests;
+
+#endif
+
+}}
@@ -0,0 +1,172 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_LOADGENERATION
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_LOADGENERATION
+
+using namespace test_utilities;
+
+//==============================================================================
+//==============================================================================
+/**
+    Finds the most load each ThreadPoolStrategy can sustain without missing a
+    deadline, for graphs of LoadNodes with different LoadProfiles.
+
+    The graphs are played in real time, one block per block duration as a
+    device would, and the total load is binary-searched. The load is the
+    processing time of all the Nodes as a proportion of the block duration so
+    can be more than 1 when several threads are used. As the loads are seeded,
+    runs on the same machine are repeatable and can be used to pick a strategy.
+*/
+class LoadGenerationBenchmarks  : public juce::UnitTest
+{
+public:
+    LoadGenerationBenchmarks()
+        : juce::UnitTest ("Load generation", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+
+        const auto numThreads = (size_t) std::max (1, juce::SystemStats::getNumCpus() - 1);
+
+        for (auto shape : { LoadProfile::Shape::constant, LoadProfile::Shape::bursty, LoadProfile::Shape::heavyTailed })
+        {
+            LoadProfile profile;
+            profile.shape = shape;
+            profile.seed = 42;
+
+            auto bestStrategy = ThreadPoolStrategy::realTime;
+            double bestLoad = -1.0;
+
+            for (auto strategy : getThreadPoolStrategies())
+            {
+                const auto description = getName (strategy) + ", " + getName (shape) + ", "
+                                          + juce::String ((int) numThreads) + " threads";
+                beginTest ("Max sustainable load: " + description);
+
+                const auto maxLoad = findMaxSustainableLoad (strategy, profile, numThreads, ts);
+
+                BenchmarkResult bmr { createBenchmarkDescription ("Load", ("Max sustainable load: " + getName (shape)).toStdString(),
+                                                                  description.toStdString()) };
+                bmr.totalSeconds = maxLoad; // N.B. This is a proportion of the block duration, not seconds
+                BenchmarkList::getInstance().addResult (bmr);
+
+                std::cout << description << ": " << maxLoad << "\n";
+                expect (maxLoad >= 0.0);
+
+                if (maxLoad > bestLoad)
+                {
+                    bestLoad = maxLoad;
+                    bestStrategy = strategy;
+                }
+            }
+
+            std::cout << "Best strategy for " << getName (shape) << " loads: " << getName (bestStrategy) << "\n\n";
+        }
+    }
+
+private:
+    static constexpr int numNodes = 32;
+    static constexpr int numWarmUpBlocks = 8;
+    static constexpr double secondsPerRun = 0.5;
+    static constexpr int numSearchSteps = 7;
+
+    /** Plays a graph with a total load in real time and returns the number of blocks that missed their deadline. */
+    static int countMissedDeadlines (ThreadPoolStrategy strategy, LoadProfile profile, double totalLoad,
+                                     size_t numThreads, TestSetup ts)
+    {
+        std::vector<std::unique_ptr<Node>> nodes;
+
+        for (int i = 0; i < numNodes; ++i)
+        {
+            auto nodeProfile = profile;
+            nodeProfile.meanLoad = totalLoad / numNodes;
+            nodeProfile.seed = profile.seed + i;
+
+            nodes.push_back (makeNode<LoadNode> (makeNode<SinNode> (220.0f, 2), nodeProfile, (size_t) i + 1));
+        }
+
+        LockFreeMultiThreadedNodePlayer player (getPoolCreatorFunction (strategy));
+        player.setNumThreads (numThreads);
+        player.setNode (makeNode<BasicSummingNode> (std::move (nodes)), ts.sampleRate, ts.blockSize);
+
+        choc::buffer::ChannelArrayBuffer<float> buffer (2, (choc::buffer::FrameCount) ts.blockSize);
+        tracktion_engine::MidiMessageArray midi;
+
+        const auto period = juce::Time::secondsToHighResolutionTicks (ts.blockSize / ts.sampleRate);
+        const auto numBlocks = numWarmUpBlocks + (int) (secondsPerRun * ts.sampleRate / ts.blockSize);
+        auto blockStart = juce::Time::getHighResolutionTicks();
+        int numMissed = 0;
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            // Wait for the next block to be due, as a device would
+            while (juce::Time::getHighResolutionTicks() < blockStart)
+                std::this_thread::yield();
+
+            midi.clear();
+            buffer.clear();
+            const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength ((int64_t) blockIndex * ts.blockSize, (int64_t) ts.blockSize);
+            player.process ({ (choc::buffer::FrameCount) ts.blockSize, referenceSampleRange, { buffer.getView(), midi } });
+
+            const auto now = juce::Time::getHighResolutionTicks();
+
+            if (now > blockStart + period)
+            {
+                if (blockIndex >= numWarmUpBlocks)
+                    ++numMissed;
+
+                // Start again from now rather than trying to catch up
+                blockStart = now;
+            }
+            else
+            {
+                blockStart += period;
+            }
+        }
+
+        return numMissed;
+    }
+
+    /** Returns the highest total load that can be played without any missed deadlines. */
+    static double findMaxSustainableLoad (ThreadPoolStrategy strategy, LoadProfile profile, size_t numThreads, TestSetup ts)
+    {
+        double low = 0.0, high = (double) (numThreads + 1);
+
+        for (int step = 0; step < numSearchSteps; ++step)
+        {
+            const auto load = (low + high) / 2.0;
+
+            if (countMissedDeadlines (strategy, profile, load, numThreads, ts) == 0)
+                low = load;
+            else
+                high = load;
+        }
+
+        return low;
+    }
+};
+
+static LoadGenerationBenchmarks loadGenerationBenchmarks;
+
+#endif
+
+}}
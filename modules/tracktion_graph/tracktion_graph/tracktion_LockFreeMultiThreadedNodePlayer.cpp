@@ -18,21 +18,141 @@
 namespace tracktion { inline namespace graph
 {
 
+namespace
+{
+    thread_local int workerIndexForCurrentThread = -1;
+
+    /** Sets the worker index for the duration of a process call, restoring
+        the previous one in case this is a nested player being processed
+        from another player's worker thread.
+    */
+    struct ScopedWorkerIndex
+    {
+        ScopedWorkerIndex (int newIndex)
+            : previousIndex (std::exchange (workerIndexForCurrentThread, newIndex))
+        {}
+
+        ~ScopedWorkerIndex()
+        {
+            workerIndexForCurrentThread = previousIndex;
+        }
+
+        const int previousIndex;
+    };
+}
+
+void LockFreeMultiThreadedNodePlayer::ThreadPool::setWorkerIndexForCurrentThread (int index)
+{
+    workerIndexForCurrentThread = index;
+}
+
+int LockFreeMultiThreadedNodePlayer::ThreadPool::getWorkerIndexForCurrentThread()
+{
+    return workerIndexForCurrentThread;
+}
+
+void LockFreeMultiThreadedNodePlayer::ThreadPool::applyThreadAffinity (std::thread& t, size_t threadIndex)
+{
+    const auto& cores = player.threadAffinityCores;
+
+    if (! cores.empty())
+        setThreadAffinity (t, cores[threadIndex % cores.size()]);
+}
+
+//==============================================================================
+/** A low priority thread used to prepare Nodes in the background. */
+struct LockFreeMultiThreadedNodePlayer::AsyncPreparer
+{
+    AsyncPreparer()
+    {
+        setThreadPriority (thread, 0);
+    }
+
+    /** Stops the thread, any jobs not yet started are dropped. */
+    ~AsyncPreparer()
+    {
+        {
+            const std::scoped_lock sl (mutex);
+            shouldExit = true;
+        }
+
+        condition.notify_one();
+        thread.join();
+    }
+
+    void addJob (std::packaged_task<void()> job)
+    {
+        {
+            const std::scoped_lock sl (mutex);
+            jobs.push_back (std::move (job));
+        }
+
+        condition.notify_one();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::packaged_task<void()>> jobs;
+    bool shouldExit = false;
+    std::thread thread { [this] { run(); } };
+
+    void run()
+    {
+        for (;;)
+        {
+            std::packaged_task<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock (mutex);
+                condition.wait (lock, [this] { return shouldExit || ! jobs.empty(); });
+
+                if (shouldExit)
+                    return;
+
+                job = std::move (jobs.front());
+                jobs.pop_front();
+            }
+
+            job();
+        }
+    }
+};
+
+//==============================================================================
 LockFreeMultiThreadedNodePlayer::LockFreeMultiThreadedNodePlayer()
 {
     threadPool = getPoolCreatorFunction (ThreadPoolStrategy::realTime) (*this);
+    usePerThreadQueues = threadPool->usesPerThreadQueues();
 }
 
 LockFreeMultiThreadedNodePlayer::LockFreeMultiThreadedNodePlayer (ThreadPoolCreator poolCreator, juce::AudioWorkgroup audioWorkgroup_)
     : audioWorkgroup (std::move (audioWorkgroup_))
 {
     threadPool = poolCreator (*this);
+    usePerThreadQueues = threadPool->usesPerThreadQueues();
 }
 
 LockFreeMultiThreadedNodePlayer::~LockFreeMultiThreadedNodePlayer()
 {
+    // Stop any background preparation first as this uses the threads
+    asyncPreparer.reset();
+
     if (numThreadsToUse > 0)
         clearThreads();
+
+    // Make sure any graphs this retired have gone before the things they refer to
+    if (auto deleter = deferredDeleter.load (std::memory_order_acquire))
+        deleter->flush();
+}
+
+void LockFreeMultiThreadedNodePlayer::setThreadAffinityPolicy (ThreadAffinityPolicy newPolicy)
+{
+    clearThreads();
+    threadAffinityPolicy = std::move (newPolicy);
+    threadAffinityCores = threadAffinityPolicy.isDefault() ? std::vector<int>()
+                                                           : threadAffinityPolicy.getCoresToUse();
+    createThreads();
 }
 
 void LockFreeMultiThreadedNodePlayer::setNumThreads (size_t newNumThreads)
@@ -45,6 +165,17 @@ void LockFreeMultiThreadedNodePlayer::setNumThreads (size_t newNumThreads)
     createThreads();
 }
 
+void LockFreeMultiThreadedNodePlayer::setThreadPoolCreator (ThreadPoolCreator poolCreator)
+{
+    auto newPool = poolCreator (*this);
+
+    const std::scoped_lock<RealTimeSpinLock> sl (processMutex);
+    threadPool->clearThreads();
+    threadPool = std::move (newPool);
+    usePerThreadQueues = threadPool->usesPerThreadQueues();
+    threadPool->createThreads (numThreadsToUse.load(), audioWorkgroup);
+}
+
 void LockFreeMultiThreadedNodePlayer::setNode (std::unique_ptr<Node> newNode)
 {
     setNode (std::move (newNode), getSampleRate(), blockSize);
@@ -52,6 +183,8 @@ void LockFreeMultiThreadedNodePlayer::setNode (std::unique_ptr<Node> newNode)
 
 void LockFreeMultiThreadedNodePlayer::setNode (std::unique_ptr<Node> newNode, double sampleRateToUse, int blockSizeToUse)
 {
+    const std::scoped_lock sl (graphPreparationMutex);
+
     // The prepare and set the new Node, passing in the old graph
     postNewGraph (prepareToPlay (std::move (newNode), lastGraphPosted,
                                  sampleRateToUse, blockSizeToUse,
@@ -59,11 +192,48 @@ void LockFreeMultiThreadedNodePlayer::setNode (std::unique_ptr<Node> newNode, do
                                  disableLatencyComp));
 }
 
+std::future<void> LockFreeMultiThreadedNodePlayer::setNodeAsync (std::unique_ptr<Node> newNode, double sampleRateToUse, int blockSizeToUse,
+                                                                 bool fadeBetweenGraphs)
+{
+    std::call_once (asyncPreparerCreated, [this] { asyncPreparer = std::make_unique<AsyncPreparer>(); });
+
+    std::packaged_task<void()> job ([this, node = std::move (newNode), sampleRateToUse, blockSizeToUse, fadeBetweenGraphs] () mutable
+                                    {
+                                        // This stops the old graph being removed whilst the new one is prepared
+                                        const std::scoped_lock sl (graphPreparationMutex);
+
+                                        auto newGraph = prepareToPlay (std::move (node), lastGraphPosted,
+                                                                       sampleRateToUse, blockSizeToUse,
+                                                                       useMemoryPool,
+                                                                       disableLatencyComp);
+
+                                        const bool shouldFade = fadeBetweenGraphs && newGraph != nullptr && lastGraphPosted != nullptr;
+
+                                        if (shouldFade)
+                                            fadeOutCurrentGraph();
+
+                                        postNewGraph (std::move (newGraph), shouldFade);
+                                    });
+
+    auto future = job.get_future();
+    asyncPreparer->addJob (std::move (job));
+
+    return future;
+}
+
 void LockFreeMultiThreadedNodePlayer::prepareToPlay (double sampleRateToUse, int blockSizeToUse)
 {
+    const std::scoped_lock sl (graphPreparationMutex);
+
     if (sampleRateToUse == sampleRate && blockSizeToUse == blockSize)
         return;
 
+    reprepareCurrentGraph (sampleRateToUse, blockSizeToUse);
+}
+
+void LockFreeMultiThreadedNodePlayer::reprepareCurrentGraph (double sampleRateToUse, int blockSizeToUse)
+{
+    const std::scoped_lock sl (graphPreparationMutex);
     std::unique_ptr<NodeGraph> currentGraph;
 
     // Ensure we've flushed any pending Node to the current prepared Node
@@ -85,23 +255,37 @@ void LockFreeMultiThreadedNodePlayer::prepareToPlay (double sampleRateToUse, int
 
 int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
 {
+    TRACKTION_GRAPH_TRACE_SCOPE ("LockFreeMultiThreadedNodePlayer::process", "player", 0)
     const std::unique_lock<RealTimeSpinLock> l (processMutex, std::try_to_lock);
 
-    // If this fails, it's because the clearNode function is being called
+    // If this fails, it's because the threads or node are being changed so
+    // rather than wait for that, this block is skipped
     if (! l.owns_lock())
-        return -1;
+        return outputSilence (pc);
 
     const auto scopedAccess = preparedNodeObject.getScopedAccess();
-    const auto preparedNode = scopedAccess.get();
 
+    return processPreparedNode (scopedAccess.get(), pc);
+}
+
+int LockFreeMultiThreadedNodePlayer::outputSilence (const Node::ProcessContext& pc)
+{
+    // If there's nothing to process, output silence rather than leave whatever was in the buffers
+    pc.buffers.audio.clear();
+    pc.buffers.midi.clear();
+    return -1;
+}
+
+int LockFreeMultiThreadedNodePlayer::processPreparedNode (PreparedNode* preparedNode, const Node::ProcessContext& pc)
+{
     if (preparedNode == nullptr)
-        return -1;
+        return outputSilence (pc);
 
     if (! preparedNode->graph)
-        return -1;
+        return outputSilence (pc);
 
     if (! preparedNode->graph->rootNode)
-        return -1;
+        return outputSilence (pc);
 
     // Reset the stream range
     numSamplesToProcess = pc.numSamples;
@@ -121,6 +305,9 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     }
     else
     {
+        // The calling thread always owns the first queue
+        const ScopedWorkerIndex scopedWorkerIndex (0);
+
         // Reset the queue to be processed
         jassert (preparedNode->playbackNodes.size() == preparedNode->graph->orderedNodes.size());
         resetProcessQueue (*preparedNode);
@@ -132,7 +319,10 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
                 break;
 
             if (! processNextFreeNode (*preparedNode))
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::waitForFinalNode", "thread_pool", 0)
                 threadPool->waitForFinalNode();
+            }
         }
     }
 
@@ -141,9 +331,37 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
         auto output = preparedNode->graph->rootNode->getProcessedOutput();
         auto numAudioChannels = std::min (output.audio.getNumChannels(), pc.buffers.audio.getNumChannels());
 
+        // Check if we're fading between graphs
+        float startGain = 1.0f, endGain = 1.0f;
+
+        if (preparedNode->graph.get() == graphToFadeOut.load (std::memory_order_acquire))
+        {
+            // Once faded out, stay silent until the new graph is swapped in
+            startGain = hasFadedOut.exchange (true, std::memory_order_acq_rel) ? 0.0f : 1.0f;
+            endGain = 0.0f;
+        }
+        else if (std::exchange (preparedNode->fadeInOutput, false))
+        {
+            startGain = 0.0f;
+        }
+
         if (numAudioChannels > 0)
-            add (pc.buffers.audio.getFirstChannels (numAudioChannels),
-                 output.audio.getFirstChannels (numAudioChannels));
+        {
+            if (startGain == 1.0f && endGain == 1.0f)
+            {
+                add (pc.buffers.audio.getFirstChannels (numAudioChannels),
+                     output.audio.getFirstChannels (numAudioChannels));
+            }
+            else if (startGain != 0.0f || endGain != 0.0f)
+            {
+                auto destBuffer = toAudioBuffer (pc.buffers.audio.getFirstChannels (numAudioChannels));
+                auto sourceBuffer = toAudioBuffer (output.audio.getFirstChannels (numAudioChannels));
+
+                for (int c = 0; c < (int) numAudioChannels; ++c)
+                    destBuffer.addFromWithRamp (c, 0, sourceBuffer.getReadPointer (c), sourceBuffer.getNumSamples(),
+                                                startGain, endGain);
+            }
+        }
 
         pc.buffers.midi.mergeFrom (output.midi);
     }
@@ -156,6 +374,8 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
 
 void LockFreeMultiThreadedNodePlayer::clearNode()
 {
+    const std::scoped_lock sl (graphPreparationMutex);
+
     // N.B. The threads will be trying to read the preparedNodes so we need to actually stop these first
     clearThreads();
 
@@ -171,19 +391,56 @@ void LockFreeMultiThreadedNodePlayer::clearNode()
 void LockFreeMultiThreadedNodePlayer::enablePooledMemoryAllocations (bool usePool)
 {
     if (useMemoryPool.exchange (usePool) != usePool)
-        prepareToPlay (sampleRate, blockSize);
+        reprepareCurrentGraph (sampleRate, blockSize);
 }
 
 void LockFreeMultiThreadedNodePlayer::enableNodeMemorySharing (bool shouldBeEnabled)
 {
     if (std::exchange (nodeMemorySharingEnabled, shouldBeEnabled) != shouldBeEnabled)
-        prepareToPlay (sampleRate, blockSize);
+        reprepareCurrentGraph (sampleRate, blockSize);
+}
+
+void LockFreeMultiThreadedNodePlayer::enableStaticBufferAllocation (bool shouldBeEnabled)
+{
+    if (std::exchange (staticBufferAllocationEnabled, shouldBeEnabled) != shouldBeEnabled)
+        reprepareCurrentGraph (sampleRate, blockSize);
+}
+
+void LockFreeMultiThreadedNodePlayer::enableSharedLatencyCompensation (bool shouldBeEnabled)
+{
+    sharedLatencyCompensationEnabled = shouldBeEnabled;
 }
 
 void LockFreeMultiThreadedNodePlayer::setLatencyCompensationEnabled (bool shouldEnable)
 {
     if (disableLatencyComp.exchange (! shouldEnable) != ! shouldEnable)
-        prepareToPlay (sampleRate, blockSize);
+        reprepareCurrentGraph (sampleRate, blockSize);
+}
+
+void LockFreeMultiThreadedNodePlayer::enableCriticalPathScheduling (bool shouldBeEnabled)
+{
+    useCriticalPathScheduling.store (shouldBeEnabled, std::memory_order_release);
+}
+
+void LockFreeMultiThreadedNodePlayer::enableChainFusion (bool shouldBeEnabled)
+{
+    useChainFusion.store (shouldBeEnabled, std::memory_order_release);
+}
+
+void LockFreeMultiThreadedNodePlayer::setNodeProfiler (NodeProfiler* profilerToUse)
+{
+    nodeProfiler.store (profilerToUse, std::memory_order_release);
+}
+
+void LockFreeMultiThreadedNodePlayer::setDeferredDeleter (DeferredDeleter* deleterToUse)
+{
+    deferredDeleter.store (deleterToUse, std::memory_order_release);
+}
+
+LockFreeMultiThreadedNodePlayer::PreparationTimes LockFreeMultiThreadedNodePlayer::getLastPreparationTimes() const
+{
+    return { std::chrono::duration<double> (lastTransformSeconds.load (std::memory_order_acquire)),
+             std::chrono::duration<double> (lastInitialiseSeconds.load (std::memory_order_acquire)) };
 }
 
 //==============================================================================
@@ -203,7 +460,9 @@ std::unique_ptr<NodeGraph> LockFreeMultiThreadedNodePlayer::prepareToPlay (std::
                                                  sampleRateToUse, blockSizeToUse,
                                                  nullptr, nullptr,
                                                  nodeMemorySharingEnabled,
-                                                 disableLatencyCompensation);
+                                                 disableLatencyCompensation,
+                                                 staticBufferAllocationEnabled,
+                                                 sharedLatencyCompensationEnabled);
 
     return node_player_utils::prepareToPlay (std::move (node), oldGraph,
                                              sampleRateToUse, blockSizeToUse,
@@ -217,7 +476,9 @@ std::unique_ptr<NodeGraph> LockFreeMultiThreadedNodePlayer::prepareToPlay (std::
                                                 lastAudioBufferPoolPosted->release (std::move (b.data));
                                              },
                                              nodeMemorySharingEnabled,
-                                             disableLatencyCompensation);
+                                             disableLatencyCompensation,
+                                             false,
+                                             sharedLatencyCompensationEnabled);
 }
 
 //==============================================================================
@@ -240,7 +501,22 @@ inline void LockFreeMultiThreadedNodePlayer::pause()
 }
 
 //==============================================================================
-void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> newGraph)
+void LockFreeMultiThreadedNodePlayer::fadeOutCurrentGraph()
+{
+    hasFadedOut.store (false, std::memory_order_release);
+    graphToFadeOut.store (lastGraphPosted, std::memory_order_release);
+
+    // Wait for a block to be faded out. If the player isn't being processed,
+    // there's nothing to fade so just time out and continue
+    const auto blockDuration = std::chrono::duration<double> (getBlockSize() / getSampleRate());
+    const auto timeout = std::chrono::steady_clock::now() + std::max (std::chrono::duration<double> (0.1), blockDuration * 4);
+
+    while (! hasFadedOut.load (std::memory_order_acquire)
+           && std::chrono::steady_clock::now() < timeout)
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+}
+
+void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> newGraph, bool fadeInOutput)
 {
     if (! newGraph)
     {
@@ -248,6 +524,9 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
         return;
     }
 
+    lastTransformSeconds.store (newGraph->transformDuration.count(), std::memory_order_release);
+    lastInitialiseSeconds.store (newGraph->initialiseDuration.count(), std::memory_order_release);
+
     std::stable_sort (newGraph->orderedNodes.begin(), newGraph->orderedNodes.end(),
                       [] (auto n1, auto n2)
                       {
@@ -256,11 +535,39 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
 
     rootNode = newGraph->rootNode.get();
 
+   #if TRACKTION_GRAPH_NODE_PROFILING
+    for (auto node : newGraph->orderedNodes)
+        node->setNodeProfiler (nodeProfiler.load (std::memory_order_acquire));
+   #endif
+
     PreparedNode newPreparedNode;
     newPreparedNode.graph = std::move (newGraph);
     newPreparedNode.nodesReadyToBeProcessed = std::make_unique<LockFreeFifo<Node*>> ((int) newPreparedNode.graph->orderedNodes.size());
+    newPreparedNode.canProcessSplitTimelineRanges = std::all_of (newPreparedNode.graph->sortedNodes.begin(), newPreparedNode.graph->sortedNodes.end(),
+                                                                 [] (auto& n) { return n.node->canProcessSplitTimelineRanges(); });
     buildNodesOutputLists (newPreparedNode);
 
+    if (useChainFusion)
+        fuseNodeChains (newPreparedNode);
+
+    if (useCriticalPathScheduling)
+    {
+        newPreparedNode.measureProcessingCosts = true;
+        buildCriticalPathWeights (newPreparedNode, lastGraphPosted);
+    }
+
+    buildScheduleState (newPreparedNode);
+
+    if (usePerThreadQueues)
+    {
+        // Each Node is only queued once per block so a queue
+        // can never need to hold more than all the Nodes
+        const auto numNodes = newPreparedNode.graph->orderedNodes.size();
+
+        for (size_t i = 0; i < numThreadsToUse.load() + 1; ++i)
+            newPreparedNode.workerQueues.push_back (std::make_unique<WorkStealingDeque<Node*>> (numNodes));
+    }
+
     if (useMemoryPool)
     {
         const size_t poolCapacity = newPreparedNode.graph->orderedNodes.size();
@@ -272,9 +579,17 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
                                                    numThreadsToUse, blockSize);
     }
 
+    newPreparedNode.fadeInOutput = fadeInOutput;
+
     lastGraphPosted = newPreparedNode.graph.get();
     lastAudioBufferPoolPosted = newPreparedNode.audioBufferPool.get();
-    preparedNodeObject.pushNonRealTime (std::move (newPreparedNode));
+    auto replacedPreparedNode = preparedNodeObject.pushNonRealTime (std::move (newPreparedNode));
+
+    if (auto deleter = deferredDeleter.load (std::memory_order_acquire); deleter != nullptr && replacedPreparedNode.graph != nullptr)
+        deleter->retire (std::move (replacedPreparedNode));
+
+    // Any graph being faded out has now been replaced
+    graphToFadeOut.store (nullptr, std::memory_order_release);
 }
 
 //==============================================================================
@@ -310,6 +625,123 @@ void LockFreeMultiThreadedNodePlayer::buildNodesOutputLists (PreparedNode& prepa
     }
 }
 
+void LockFreeMultiThreadedNodePlayer::fuseNodeChains (PreparedNode& preparedNode)
+{
+    // A Node can be processed straight after its input if that is its only input
+    // and it's the input's only output. It will then never be queued or counted down
+    for (auto& playbackNode : preparedNode.playbackNodes)
+    {
+        if (playbackNode->outputs.size() != 1)
+            continue;
+
+        auto output = playbackNode->outputs.front();
+
+        if (static_cast<PlaybackNode*> (output->internal)->numInputs == 1
+            && output->getOptimisations().chainFusion == ChainFusion::yes)
+            playbackNode->fusedOutput = output;
+    }
+}
+
+void LockFreeMultiThreadedNodePlayer::buildCriticalPathWeights (PreparedNode& preparedNode, NodeGraph* oldGraph)
+{
+    // Carry over any costs measured for the previous graph
+    // N.B. The old PlaybackNodes are still alive until the new graph is posted
+    if (oldGraph != nullptr)
+    {
+        std::unordered_map<size_t, uint64_t> previousCosts;
+
+        for (auto n : oldGraph->orderedNodes)
+            if (auto oldPlaybackNode = static_cast<PlaybackNode*> (n->internal))
+                if (const auto nodeID = n->getNodeProperties().nodeID; nodeID != 0)
+                    previousCosts[nodeID] = oldPlaybackNode->processingCost.load (std::memory_order_relaxed);
+
+        for (auto& playbackNode : preparedNode.playbackNodes)
+            if (const auto nodeID = playbackNode->node.getNodeProperties().nodeID; nodeID != 0)
+                if (auto found = previousCosts.find (nodeID); found != previousCosts.end())
+                    playbackNode->processingCost.store (found->second, std::memory_order_relaxed);
+    }
+
+    // Nodes without a measured cost are assumed to be average
+    uint64_t totalCost = 0, numCosts = 0;
+
+    for (auto& playbackNode : preparedNode.playbackNodes)
+    {
+        if (const auto cost = playbackNode->processingCost.load (std::memory_order_relaxed); cost > 0)
+        {
+            totalCost += cost;
+            ++numCosts;
+        }
+    }
+
+    const uint64_t defaultCost = numCosts > 0 ? std::max (totalCost / numCosts, (uint64_t) 1) : 1;
+
+    // orderedNodes has inputs before outputs so iterating backwards
+    // means all the outputs of a Node will have been weighted first
+    auto& orderedNodes = preparedNode.graph->orderedNodes;
+
+    for (auto iter = orderedNodes.rbegin(); iter != orderedNodes.rend(); ++iter)
+    {
+        auto playbackNode = static_cast<PlaybackNode*> ((*iter)->internal);
+        const auto cost = playbackNode->processingCost.load (std::memory_order_relaxed);
+        uint64_t heaviestOutputWeight = 0;
+
+        for (auto output : playbackNode->outputs)
+            heaviestOutputWeight = std::max (heaviestOutputWeight, static_cast<PlaybackNode*> (output->internal)->criticalPathWeight);
+
+        playbackNode->criticalPathWeight = (cost > 0 ? cost : defaultCost) + heaviestOutputWeight;
+    }
+
+    const auto isHeavier = [] (const auto& pn1, const auto& pn2) { return pn1->criticalPathWeight > pn2->criticalPathWeight; };
+
+    // Sort the outputs so the heaviest becomes the one processed on the same thread
+    for (auto& playbackNode : preparedNode.playbackNodes)
+        std::stable_sort (playbackNode->outputs.begin(), playbackNode->outputs.end(),
+                          [&isHeavier] (auto n1, auto n2)
+                          {
+                              return isHeavier (static_cast<PlaybackNode*> (n1->internal),
+                                                static_cast<PlaybackNode*> (n2->internal));
+                          });
+
+    // And sort the Nodes so the heaviest initial Nodes get queued first
+    std::stable_sort (preparedNode.playbackNodes.begin(), preparedNode.playbackNodes.end(), isHeavier);
+}
+
+void LockFreeMultiThreadedNodePlayer::buildScheduleState (PreparedNode& preparedNode)
+{
+    auto& schedule = preparedNode.schedule;
+    const auto numNodes = preparedNode.playbackNodes.size();
+
+    for (size_t i = 0; i < numNodes; ++i)
+        preparedNode.playbackNodes[i]->scheduleIndex = (uint32_t) i;
+
+    schedule.nodes.resize (numNodes);
+    schedule.numInputs.resize (numNodes);
+    schedule.numInputsToBeProcessed = CacheAlignedVector<std::atomic<uint32_t>> (numNodes);
+    schedule.hasBeenQueued = CacheAlignedVector<std::atomic<bool>> (numNodes);
+    schedule.firstOutput.resize (numNodes + 1);
+    schedule.fusedOutputs.resize (numNodes);
+    schedule.outputs.clear();
+
+    // The outputs keep the order set by buildCriticalPathWeights so the heaviest is processed on the same thread
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+        auto& playbackNode = *preparedNode.playbackNodes[i];
+        schedule.nodes[i] = &playbackNode.node;
+        schedule.numInputs[i] = (uint32_t) playbackNode.numInputs;
+        schedule.hasBeenQueued[i].store (true, std::memory_order_relaxed);
+        schedule.firstOutput[i] = (uint32_t) schedule.outputs.size();
+
+        for (auto output : playbackNode.outputs)
+            schedule.outputs.push_back (static_cast<PlaybackNode*> (output->internal)->scheduleIndex);
+
+        schedule.fusedOutputs[i] = playbackNode.fusedOutput != nullptr
+                                     ? static_cast<PlaybackNode*> (playbackNode.fusedOutput->internal)->scheduleIndex
+                                     : ScheduleState::noFusedOutput;
+    }
+
+    schedule.firstOutput[numNodes] = (uint32_t) schedule.outputs.size();
+}
+
 void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedNode)
 {
     // Clear the nodesReadyToBeProcessed list
@@ -323,44 +755,35 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
 
     numNodesQueued.store (0, std::memory_order_release);
 
+    auto& schedule = preparedNode.schedule;
+    const auto numNodes = schedule.nodes.size();
+
     // Reset all the counters
     // And then move any Nodes that are ready to the correct queue
-    for (auto& playbackNode : preparedNode.playbackNodes)
+    for (size_t i = 0; i < numNodes; ++i)
     {
-        jassert (playbackNode->hasBeenQueued);
-        playbackNode->hasBeenQueued = false;
-        playbackNode->numInputsToBeProcessed.store (playbackNode->numInputs, std::memory_order_release);
+        jassert (schedule.hasBeenQueued[i]);
+        schedule.hasBeenQueued[i].store (false, std::memory_order_relaxed);
+        schedule.numInputsToBeProcessed[i].store (schedule.numInputs[i], std::memory_order_release);
 
         // Check only ready nodes will be queued
-       #if JUCE_DEBUG
-        if (playbackNode->node.isReadyToProcess())
-            jassert (playbackNode->numInputsToBeProcessed == 0);
-
-        if (playbackNode->numInputsToBeProcessed == 0)
-            jassert (playbackNode->node.isReadyToProcess());
-       #endif
+        jassert (schedule.nodes[i]->isReadyToProcess() == (schedule.numInputs[i] == 0));
     }
 
    #if JUCE_DEBUG
     for (auto& playbackNode : preparedNode.playbackNodes)
-    {
         playbackNode->hasBeenDequeued = false;
-        jassert (! playbackNode->hasBeenQueued);
-        jassert (playbackNode->numInputsToBeProcessed == playbackNode->numInputs);
-        jassert (playbackNode->numInputsToBeProcessed.load (std::memory_order_acquire) == playbackNode->numInputs);
-    }
    #endif
 
     size_t numNodesJustQueued = 0;
 
     // Make sure the counters are reset for all nodes before queueing any
-    for (auto& playbackNode : preparedNode.playbackNodes)
+    for (size_t i = 0; i < numNodes; ++i)
     {
-        if (playbackNode->numInputsToBeProcessed.load (std::memory_order_acquire) == 0)
+        if (schedule.numInputs[i] == 0)
         {
-            jassert (! playbackNode->hasBeenQueued);
-            playbackNode->hasBeenQueued = true;
-            preparedNode.nodesReadyToBeProcessed->try_enqueue (&playbackNode->node);
+            schedule.hasBeenQueued[i].store (true, std::memory_order_relaxed);
+            preparedNode.nodesReadyToBeProcessed->try_enqueue (schedule.nodes[i]);
             ++numNodesJustQueued;
         }
     }
@@ -377,43 +800,44 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
 
 Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode& preparedNode, Node& node)
 {
-    auto playbackNode = static_cast<PlaybackNode*> (node.internal);
+    auto& schedule = preparedNode.schedule;
+    const auto nodeIndex = static_cast<PlaybackNode*> (node.internal)->scheduleIndex;
+    const auto firstOutput = schedule.firstOutput[nodeIndex];
+    const auto endOutput = schedule.firstOutput[nodeIndex + 1];
 
    #if RETURN_MID_NODES_OPTIMISATION
     Node* nodeToReturn = nullptr;
    #endif
 
-    for (auto output : playbackNode->outputs)
+    for (auto i = firstOutput; i < endOutput; ++i)
     {
-        auto outputPlaybackNode = static_cast<PlaybackNode*> (output->internal);
+        const auto outputIndex = schedule.outputs[i];
 
         // fetch_sub returns the previous value so it will now be 0
-        if (outputPlaybackNode->numInputsToBeProcessed.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        if (schedule.numInputsToBeProcessed[outputIndex].fetch_sub (1, std::memory_order_acq_rel) == 1)
         {
-            jassert (outputPlaybackNode->node.isReadyToProcess());
-            jassert (! outputPlaybackNode->hasBeenQueued);
-            outputPlaybackNode->hasBeenQueued = true;
+            auto& outputNode = *schedule.nodes[outputIndex];
+            jassert (outputNode.isReadyToProcess());
+            jassert (! schedule.hasBeenQueued[outputIndex]);
+            schedule.hasBeenQueued[outputIndex].store (true, std::memory_order_relaxed);
 
            #if RETURN_MID_NODES_OPTIMISATION
             // We can return one Node to be processed on this thread, otherwise we can
             // queue it for another thread to possibly process
             if (nodeToReturn == nullptr)
             {
-                nodeToReturn = &outputPlaybackNode->node;
+                nodeToReturn = &outputNode;
             }
             else
             {
-                preparedNode.nodesReadyToBeProcessed->try_enqueue (&outputPlaybackNode->node);
-                numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+                enqueueNode (preparedNode, outputNode);
             }
            #else
             // If there is only one Node or we're at the last Node we can return this to be processed by the same thread
-            if (playbackNode->outputs.size() == 1
-                || output == playbackNode->outputs.back())
-                return &outputPlaybackNode->node;
+            if (endOutput - firstOutput == 1 || i == endOutput - 1)
+                return &outputNode;
 
-            preparedNode.nodesReadyToBeProcessed->try_enqueue (&outputPlaybackNode->node);
-            numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+            enqueueNode (preparedNode, outputNode);
            #endif
         }
     }
@@ -425,6 +849,60 @@ Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode&
    #endif
 }
 
+void LockFreeMultiThreadedNodePlayer::enqueueNode (PreparedNode& preparedNode, Node& node)
+{
+    bool queued = false;
+
+    if (const auto workerIndex = workerIndexForCurrentThread;
+        workerIndex >= 0 && (size_t) workerIndex < preparedNode.workerQueues.size())
+    {
+        // Keep the Node local to this thread so its inputs are likely still in cache
+        queued = preparedNode.workerQueues[(size_t) workerIndex]->push (&node);
+    }
+
+    // Threads without their own queue fall back to the shared one
+    if (! queued)
+        preparedNode.nodesReadyToBeProcessed->try_enqueue (&node);
+
+    numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+}
+
+bool LockFreeMultiThreadedNodePlayer::dequeueNode (PreparedNode& preparedNode, Node*& node)
+{
+    auto& workerQueues = preparedNode.workerQueues;
+
+    if (workerQueues.empty())
+        return preparedNode.nodesReadyToBeProcessed->try_dequeue (node);
+
+    const auto numQueues = workerQueues.size();
+    const auto workerIndex = workerIndexForCurrentThread;
+    const bool hasOwnQueue = workerIndex >= 0 && (size_t) workerIndex < numQueues;
+
+    // First try the most recently queued Node on this thread...
+    if (hasOwnQueue && workerQueues[(size_t) workerIndex]->pop (node))
+        return true;
+
+    // ...then the shared queue which holds the initial Nodes...
+    if (preparedNode.nodesReadyToBeProcessed->try_dequeue (node))
+        return true;
+
+    // ...and finally steal the oldest Node from another thread
+    const auto firstVictim = hasOwnQueue ? (size_t) workerIndex + 1 : 0;
+
+    for (size_t i = 0; i < numQueues; ++i)
+    {
+        const auto victim = (firstVictim + i) % numQueues;
+
+        if (hasOwnQueue && victim == (size_t) workerIndex)
+            continue;
+
+        if (workerQueues[victim]->steal (node))
+            return true;
+    }
+
+    return false;
+}
+
 //==============================================================================
 bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode)
 {
@@ -433,7 +911,7 @@ bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& prepare
     if (numNodesQueued.load (std::memory_order_acquire) == 0)
         return false;
 
-    if (! preparedNode.nodesReadyToBeProcessed->try_dequeue (nodeToProcess))
+    if (! dequeueNode (preparedNode, nodeToProcess))
         return false;
 
     numNodesQueued.fetch_sub (1, std::memory_order_acq_rel);
@@ -446,6 +924,7 @@ bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& prepare
 
 void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node)
 {
+    auto& schedule = preparedNode.schedule;
     auto* nodeToProcess = &node;
 
     // Attempt to process serial Node chains on this thread
@@ -458,7 +937,31 @@ void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, N
         #endif
 
         // Process Node
-        nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
+        if (preparedNode.measureProcessingCosts)
+        {
+            const auto startCycles = rdtsc();
+            nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
+            const auto numCycles = rdtsc() - startCycles;
+
+            // Smooth out the cost so one slow block doesn't reorder everything
+            auto& cost = static_cast<PlaybackNode*> (nodeToProcess->internal)->processingCost;
+            const auto lastCost = cost.load (std::memory_order_relaxed);
+            cost.store (lastCost == 0 ? numCycles : (lastCost * 7 + numCycles) / 8, std::memory_order_relaxed);
+        }
+        else
+        {
+            nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
+        }
+
+        // Fused outputs are only ever reached from their input so can skip the queue entirely
+        if (const auto fusedIndex = schedule.fusedOutputs[static_cast<PlaybackNode*> (nodeToProcess->internal)->scheduleIndex];
+            fusedIndex != ScheduleState::noFusedOutput)
+        {
+            schedule.hasBeenQueued[fusedIndex].store (true, std::memory_order_relaxed);
+            nodeToProcess = schedule.nodes[fusedIndex];
+            continue;
+        }
+
         nodeToProcess = updateProcessQueueForNode (preparedNode, *nodeToProcess);
 
         if (! nodeToProcess)
@@ -59,19 +59,62 @@ private:
         Node& node;
         const size_t numInputs;
         std::vector<Node*> outputs;
-        std::atomic<size_t> numInputsToBeProcessed { 0 };
-        std::atomic<bool> hasBeenQueued { true };
+        std::atomic<uint64_t> processingCost { 0 };
+        uint64_t criticalPathWeight = 0;
+        Node* fusedOutput = nullptr;
+        uint32_t scheduleIndex = 0;
        #if JUCE_DEBUG
         std::atomic<bool> hasBeenDequeued { false };
        #endif
     };
 
+    template<typename Type>
+    struct CacheAlignedAllocator
+    {
+        using value_type = Type;
+
+        CacheAlignedAllocator() = default;
+        template<typename Other> CacheAlignedAllocator (const CacheAlignedAllocator<Other>&) noexcept {}
+
+        Type* allocate (size_t n)                   { return static_cast<Type*> (::operator new (n * sizeof (Type), std::align_val_t (64))); }
+        void deallocate (Type* p, size_t) noexcept  { ::operator delete (p, std::align_val_t (64)); }
+
+        template<typename Other> bool operator== (const CacheAlignedAllocator<Other>&) const noexcept { return true; }
+    };
+
+    template<typename Type>
+    using CacheAlignedVector = std::vector<Type, CacheAlignedAllocator<Type>>;
+
+    /** The state touched when scheduling Nodes, held in arrays indexed by each
+        PlaybackNode's scheduleIndex rather than in the PlaybackNodes themselves.
+        Resolving the dependencies of a Node then reads a few contiguous
+        arrays instead of visiting every output's PlaybackNode.
+        The indices follow the order of PreparedNode::playbackNodes.
+    */
+    struct ScheduleState
+    {
+        static constexpr uint32_t noFusedOutput = std::numeric_limits<uint32_t>::max();
+
+        CacheAlignedVector<Node*> nodes;
+        CacheAlignedVector<uint32_t> numInputs;
+        CacheAlignedVector<std::atomic<uint32_t>> numInputsToBeProcessed;
+        CacheAlignedVector<std::atomic<bool>> hasBeenQueued;
+        CacheAlignedVector<uint32_t> firstOutput;       // The outputs of Node i are outputs[firstOutput[i]] to outputs[firstOutput[i + 1]]
+        CacheAlignedVector<uint32_t> outputs;
+        CacheAlignedVector<uint32_t> fusedOutputs;
+    };
+
     struct PreparedNode
     {
         std::unique_ptr<NodeGraph> graph;
         std::vector<std::unique_ptr<PlaybackNode>> playbackNodes;
+        ScheduleState schedule;
         std::unique_ptr<LockFreeFifo<Node*>> nodesReadyToBeProcessed;
+        std::vector<std::unique_ptr<WorkStealingDeque<Node*>>> workerQueues;
         std::unique_ptr<AudioBufferPool> audioBufferPool;
+        bool measureProcessingCosts = false;
+        bool fadeInOutput = false;
+        bool canProcessSplitTimelineRanges = false;
     };
 
 public:
@@ -118,6 +161,27 @@ public:
         */
         virtual void waitForFinalNode() = 0;
 
+        /** Subclasses can return true here to have the player keep a queue of ready
+            Nodes for each thread rather than a single shared one.
+            Threads will then process Nodes from their own queue first, only stealing
+            from other threads' queues when their own is empty.
+            If you do this, you must call setWorkerIndexForCurrentThread in each of
+            your threads, starting at 1 (0 is reserved for the thread calling process).
+        */
+        virtual bool usesPerThreadQueues() const { return false; }
+
+        /** Sets the queue index the calling thread should use if usesPerThreadQueues returns true. */
+        static void setWorkerIndexForCurrentThread (int);
+
+        /** Returns the queue index set with setWorkerIndexForCurrentThread or -1 if it hasn't been set. */
+        static int getWorkerIndexForCurrentThread();
+
+        /** Pins a newly created thread according to the player's ThreadAffinityPolicy.
+            Subclasses should call this for each thread they create, with the index of the thread.
+            @see LockFreeMultiThreadedNodePlayer::setThreadAffinityPolicy
+        */
+        void applyThreadAffinity (std::thread&, size_t threadIndex);
+
         //==============================================================================
         /** Signals the pool that all the threads should exit. */
         void signalShouldExit()
@@ -207,12 +271,45 @@ public:
     */
     void setNumThreads (size_t);
 
+    /** Returns the number of threads set with setNumThreads. */
+    size_t getNumThreads() const                                    { return numThreadsToUse.load(); }
+
+    /** Replaces the ThreadPool used to process the Node, e.g. to change ThreadPoolStrategy.
+        Like setNumThreads, this will pause processing whilst the threads are recreated.
+        Pools that use per-thread queues will only use them once the next Node has been set,
+        until then they'll share a single queue.
+    */
+    void setThreadPoolCreator (ThreadPoolCreator);
+
+    /** Sets the cores the worker threads should be pinned to.
+        By default threads aren't pinned and can be moved between cores by the OS.
+        This reads the system topology and recreates the threads so shouldn't be
+        called during playback.
+    */
+    void setThreadAffinityPolicy (ThreadAffinityPolicy);
+
+    /** Returns the policy set with setThreadAffinityPolicy. */
+    const ThreadAffinityPolicy& getThreadAffinityPolicy() const     { return threadAffinityPolicy; }
+
     /** Sets the Node to process. */
     void setNode (std::unique_ptr<Node>);
 
     /** Sets the Node to process with a new sample rate and block size. */
     void setNode (std::unique_ptr<Node> newNode, double sampleRateToUse, int blockSizeToUse);
 
+    /** Prepares a Node on a background thread and then sets it to be processed.
+        This avoids blocking the calling thread whilst the Node is prepared, which
+        can take some time for large graphs. The new Node will be swapped in at the
+        start of the next block after it has been prepared.
+
+        @param fadeBetweenGraphs    If true, the output of the old Node is faded out
+                                    over one block and the new Node's output faded in
+                                    over its first block to avoid any discontinuities.
+        @returns a future which becomes ready once the Node has been set
+    */
+    std::future<void> setNodeAsync (std::unique_ptr<Node>, double sampleRateToUse, int blockSizeToUse,
+                                    bool fadeBetweenGraphs = false);
+
     /** Prepares the current Node to be played.
         Calling this will cause a drop in the output stream as the Node is re-prepared.
     */
@@ -227,6 +324,34 @@ public:
     /** Process a block of the Node. */
     int process (const Node::ProcessContext&);
 
+    /** Processes a block where the timeline wraps around part way through, e.g. at
+        a loop end, in a single pass of the graph.
+        This is only possible if every Node in the current graph returns true from
+        Node::canProcessSplitTimelineRanges. If they do, beforeProcessing is called
+        to let the caller update any state the Nodes use to find the two timeline
+        ranges and then the block is processed. If not, nothing is called and this
+        returns nullopt so the caller can process each side of the wrap separately.
+        The check and the processing use the same graph so it can't be swapped in between.
+    */
+    template<typename BeforeProcessingFunction>
+    std::optional<int> processSplitTimelineRange (const Node::ProcessContext& pc, BeforeProcessingFunction&& beforeProcessing)
+    {
+        const std::unique_lock<RealTimeSpinLock> l (processMutex, std::try_to_lock);
+
+        if (! l.owns_lock())
+            return outputSilence (pc);
+
+        const auto scopedAccess = preparedNodeObject.getScopedAccess();
+        const auto preparedNode = scopedAccess.get();
+
+        if (preparedNode == nullptr || ! preparedNode->canProcessSplitTimelineRanges)
+            return std::nullopt;
+
+        beforeProcessing();
+
+        return processPreparedNode (preparedNode, pc);
+    }
+
     /** Clears the current Node.
         Note that this shouldn't be called concurrently with setNode.
         If it's called concurrently with process, it will block until the current process call has finished.
@@ -257,31 +382,111 @@ public:
     /* @internal. */
     void enableNodeMemorySharing (bool shouldBeEnabled);
 
+    /** Enables or disables allocating all the Node buffers from a single block of
+        memory when the Node is prepared. Buffers are shared between Nodes that can't
+        be in use at the same time so this can reduce memory use and improve cache
+        locality without any buffer pool lookups during processing.
+        This is ignored if pooled memory allocations are enabled.
+        If a Node has already been set, it's prepared again straight away so there
+        will be a gap in the audio.
+        @see node_player_utils::allocateStaticBuffers
+    */
+    void enableStaticBufferAllocation (bool shouldBeEnabled);
+
+    /** Enables or disables sharing latency compensation between inputs that need
+        to be delayed by the same amount. Rather than each input having its own delay
+        line, they are summed and then delayed once which can save a lot of memory
+        when there are high-latency plugins on busses with many inputs.
+        This takes effect the next time a Node is set.
+        @see Node::TransformOptions::shareLatencyCompensation
+    */
+    void enableSharedLatencyCompensation (bool shouldBeEnabled);
+
     /// Enables or disables latency compensation - it is enabled by default.
     void setLatencyCompensationEnabled (bool);
 
+    /** Enables or disables critical-path scheduling - it is disabled by default.
+        When enabled, the processing cost of each Node is measured and when a new
+        Node is set, each Node is given a weight of the most expensive path from it
+        to the root. Ready Nodes are then queued heaviest-first so long chains start
+        as early as possible and the block can finish sooner.
+        Costs are carried over to new graphs for Nodes with matching nodeIDs.
+        This takes effect the next time a Node is set.
+    */
+    void enableCriticalPathScheduling (bool);
+
+    /** Enables or disables fusing chains of Nodes - it is disabled by default.
+        When enabled, any Node whose only input feeds nothing else is processed
+        straight after that input on the same thread, without going through the
+        ready queues or updating any counters. A chain of plugins is then processed
+        as a single task, which reduces scheduling overhead and keeps the buffers
+        passed between them in cache.
+        Nodes can opt out of this with NodeOptimisations::chainFusion.
+        This takes effect the next time a Node is set.
+    */
+    void enableChainFusion (bool);
+
+    /** Sets a NodeProfiler to collect the processing time of each Node.
+        The profiler must outlive this player or be removed by setting a nullptr.
+        This takes effect the next time a Node is set and only records anything
+        if TRACKTION_GRAPH_NODE_PROFILING is enabled.
+    */
+    void setNodeProfiler (NodeProfiler*);
+
+    /** Sets a DeferredDeleter to destroy the graphs this player replaces.
+        Without one, they're destroyed on the thread setting the next Node, which
+        can hold up the preparation if they own lots of plugins. The deleter must
+        outlive this player and is flushed when this player is destroyed.
+    */
+    void setDeferredDeleter (DeferredDeleter*);
+
+    /** The time spent in each stage of preparing a Node to be played. */
+    struct PreparationTimes
+    {
+        std::chrono::duration<double> transform {};     /**< Transforming the Nodes, e.g. adding latency compensation. */
+        std::chrono::duration<double> initialise {};    /**< Initialising the Nodes, which calls prepareToPlay on them. */
+    };
+
+    /** Returns the time taken to prepare the last Node that was set. */
+    PreparationTimes getLastPreparationTimes() const;
+
 private:
     //==============================================================================
     std::atomic<size_t> numThreadsToUse { std::max ((size_t) 0, (size_t) std::thread::hardware_concurrency() - 1) };
     juce::Range<int64_t> referenceSampleRange;
     choc::buffer::FrameCount numSamplesToProcess = 0;
-    std::atomic<bool> threadsShouldExit { false }, useMemoryPool { false }, disableLatencyComp { false };
+    std::atomic<bool> threadsShouldExit { false }, useMemoryPool { false }, disableLatencyComp { false },
+                      useCriticalPathScheduling { false }, useChainFusion { false };
+    std::atomic<bool> usePerThreadQueues { false };
 
     RealTimeSpinLock processMutex;
     std::unique_ptr<ThreadPool> threadPool;
     juce::AudioWorkgroup audioWorkgroup;
+    ThreadAffinityPolicy threadAffinityPolicy;
+    std::vector<int> threadAffinityCores;
 
+    std::recursive_mutex graphPreparationMutex;
     LockFreeObject<PreparedNode> preparedNodeObject;
     Node* rootNode = nullptr;
     NodeGraph* lastGraphPosted = nullptr;
     AudioBufferPool* lastAudioBufferPoolPosted = nullptr;
+    std::atomic<NodeProfiler*> nodeProfiler { nullptr };
+    std::atomic<DeferredDeleter*> deferredDeleter { nullptr };
+    std::atomic<double> lastTransformSeconds { 0.0 }, lastInitialiseSeconds { 0.0 };
 
     std::atomic<size_t> numNodesQueued { 0 };
 
+    struct AsyncPreparer;
+    std::unique_ptr<AsyncPreparer> asyncPreparer;
+    std::once_flag asyncPreparerCreated;
+    std::atomic<NodeGraph*> graphToFadeOut { nullptr };
+    std::atomic<bool> hasFadedOut { false };
+
     //==============================================================================
     std::atomic<double> sampleRate { 44100.0 };
     std::atomic<int> blockSize { 512 };
-    bool nodeMemorySharingEnabled = false;
+    bool nodeMemorySharingEnabled = false, staticBufferAllocationEnabled = false,
+         sharedLatencyCompensationEnabled = false;
 
     //==============================================================================
     /** Prepares a specific Node to be played and returns all the Nodes. */
@@ -290,21 +495,32 @@ private:
                                               bool useCurrentAudioBufferPool,
                                               bool disableLatencyCompensation);
 
+    /** Prepares the current Node again, e.g. after an option that affects how it's prepared has changed. */
+    void reprepareCurrentGraph (double sampleRateToUse, int blockSizeToUse);
+
     //==============================================================================
     void clearThreads();
     void createThreads();
     void pause();
 
     //==============================================================================
-    void postNewGraph (std::unique_ptr<NodeGraph>);
+    void postNewGraph (std::unique_ptr<NodeGraph>, bool fadeInOutput = false);
+    void fadeOutCurrentGraph();
 
     //==============================================================================
     static void buildNodesOutputLists (PreparedNode&);
+    static void fuseNodeChains (PreparedNode&);
+    static void buildCriticalPathWeights (PreparedNode&, NodeGraph* oldGraph);
+    static void buildScheduleState (PreparedNode&);
     void resetProcessQueue (PreparedNode&);
     Node* updateProcessQueueForNode (PreparedNode&, Node&);
+    void enqueueNode (PreparedNode&, Node&);
+    bool dequeueNode (PreparedNode&, Node*&);
     void processNode (PreparedNode&, Node&);
 
     //==============================================================================
+    static int outputSilence (const Node::ProcessContext&);
+    int processPreparedNode (PreparedNode*, const Node::ProcessContext&);
     bool processNextFreeNode (PreparedNode&);
 };
 
@@ -117,20 +117,36 @@ inline bool operator== (NodeAndID n1, NodeAndID n2)
     return n1.node == n2.node && n1.id == n2.id;
 }
 
+/**
+    Holds a contiguous block of audio memory that Node output buffers can be
+    assigned from when a graph is prepared.
+    @see node_player_utils::allocateStaticBuffers
+*/
+struct NodeBufferArena
+{
+    std::vector<float> samples;
+    std::vector<float*> channels;
+};
+
 /**
     Holds a graph in an order ready for processing and a sorted map for quick lookups.
 */
 struct NodeGraph
 {
+    std::unique_ptr<NodeBufferArena> bufferArena;
     std::unique_ptr<Node> rootNode;
     std::vector<Node*> orderedNodes;
     std::vector<NodeAndID> sortedNodes;
+
+    std::chrono::duration<double> transformDuration {};     /**< The time taken to transform the Nodes in createNodeGraph. */
+    std::chrono::duration<double> initialiseDuration {};    /**< The time taken to initialise the Nodes when preparing them. */
 };
 
 
 /** Transforms a Node and then returns a NodeGraph of it ready to be initialised. */
 std::unique_ptr<NodeGraph> createNodeGraph (std::unique_ptr<Node>,
-                                            bool disableLatencyCompensation);
+                                            bool disableLatencyCompensation,
+                                            bool shareLatencyCompensation = false);
 
 
 //==============================================================================
@@ -142,7 +158,7 @@ struct PlaybackInitialisationInfo
     double sampleRate;
     int blockSize;
     NodeGraph& nodeGraph;
-    NodeGraph* nodeGraphToReplace = nullptr;
+    NodeGraph* nodeGraphToReplace = nullptr;   /**< The graph being replaced, if any. Nodes can take over the state of ones in it with the same ID. */
     std::function<NodeBuffer (choc::buffer::Size)> allocateAudioBuffer = nullptr;
     std::function<void (NodeBuffer&&)> deallocateAudioBuffer = nullptr;
     bool enableNodeMemorySharing = false; //** @internal */
@@ -180,11 +196,18 @@ enum class AllocateAudioBuffer
     yes /**< Do allocate an audio buffer so your subclass use the dest buffer passed to process. */
 };
 
+enum class ChainFusion
+{
+    no, /**< Always schedule this Node on its own. */
+    yes /**< If this Node's only input has no other outputs, players may process this Node straight after that input on the same thread, without scheduling it separately. */
+};
+
 /** Holds some hints that _might_ be used by the Node or players to improve efficiency. */
 struct NodeOptimisations
 {
     ClearBuffers clear = ClearBuffers::yes;
     AllocateAudioBuffer allocate = AllocateAudioBuffer::yes;
+    ChainFusion chainFusion = ChainFusion::yes;
 };
 
 //==============================================================================
@@ -220,6 +243,17 @@ public:
     Node() = default;
     virtual ~Node() = default;
 
+    //==============================================================================
+    /** Nodes are allocated from the current NodeAllocationArena, if there is one.
+        @see NodeAllocationArena::ScopedUse
+    */
+    static void* operator new (size_t size)                     { return NodeAllocationArena::allocate (size); }
+    static void operator delete (void* data) noexcept           { NodeAllocationArena::deallocate (data); }
+
+    /** Over-aligned Nodes always use the heap. */
+    static void* operator new (size_t size, std::align_val_t alignment)             { return ::operator new (size, alignment); }
+    static void operator delete (void* data, std::align_val_t alignment) noexcept   { ::operator delete (data, alignment); }
+
     //==============================================================================
     /** Call once after the graph has been constructed to initialise buffers etc. */
     void initialise (const PlaybackInitialisationInfo&);
@@ -247,6 +281,13 @@ public:
     {
         choc::buffer::ChannelArrayView<float> audio;
         tracktion_engine::MidiMessageArray& midi;
+
+        /** True if every sample of the audio is known to be zero.
+            Nodes can set this on their output during process so the Nodes they feed
+            can skip work. As not every Node checks it, it must only be set if the
+            audio really is silent.
+        */
+        bool isAudioSilent = false;
     };
 
     /** Returns the processed audio and MIDI output.
@@ -267,6 +308,10 @@ public:
         TransformCache& cache;
 
         bool disableLatencyCompensation = false;
+
+        /// If true, Nodes that compensate the latency of several inputs by the same
+        /// amount may sum them first and delay the sum, rather than delaying each one.
+        bool shareLatencyCompensation = false;
     };
 
     /** Called after construction to give the node a chance to modify its topology.
@@ -305,6 +350,14 @@ public:
     */
     virtual bool isReadyToProcess() = 0;
 
+    /** Should return true if this Node can process a block where the timeline wraps
+        around, e.g. at a loop end, part way through.
+        A player can then process the graph once for such a block rather than once for
+        each side of the wrap, but only if every Node in the graph returns true.
+        Nodes that don't use the timeline position can simply return true.
+    */
+    virtual bool canProcessSplitTimelineRanges() { return false; }
+
     /** Struct to describe a single iteration of a process call. */
     struct ProcessContext
     {
@@ -333,6 +386,32 @@ public:
     virtual size_t getAllocatedBytes() const;
     void enablePreProcess (bool);
 
+    /** @internal Returns the size of the audio buffer this Node allocates for itself
+        or an empty size if it doesn't allocate one.
+        Must only be called after initialise.
+    */
+    choc::buffer::Size getInternalAudioBufferSize() const;
+
+    /** @internal Returns true if this Node might pass on one of its input's buffers
+        as its own output, either with setBufferViewToUse or setAudioOutput.
+        This is assumed to be any Node that doesn't allocate its own buffer or
+        only has a single input.
+    */
+    bool mayForwardInputBuffers() const;
+
+    /** @internal Returns the hints set with setOptimisations. */
+    NodeOptimisations getOptimisations() const;
+
+    /** @internal Replaces the internally allocated audio buffer with an externally owned view.
+        The view must be the size returned from getInternalAudioBufferSize and live as long as this Node.
+    */
+    void useExternalAudioBuffer (const choc::buffer::ChannelArrayView<float>&);
+
+    /** @internal Sets a NodeProfiler to add the timing of each process call to.
+        This does nothing unless TRACKTION_GRAPH_NODE_PROFILING is enabled.
+    */
+    void setNodeProfiler (NodeProfiler*);
+
 protected:
     /** Called once before playback begins for each node.
         Use this to allocate buffers etc.
@@ -387,6 +466,15 @@ private:
     tracktion_engine::MidiMessageArray midiBuffer;
     std::atomic<int> numSamplesProcessed { 0 }, retainCount { 0 };
     NodeOptimisations nodeOptimisations;
+    bool hasExternalAudioBuffer = false, isAudioSilent = false;
+
+   #if TRACKTION_GRAPH_NODE_PROFILING
+    NodeProfiler* nodeProfiler = nullptr;
+   #endif
+
+   #if TRACKTION_GRAPH_NODE_PROFILING || TRACKTION_GRAPH_TRACING
+    size_t cachedNodeID = 0;
+   #endif
 
 
     std::vector<Node*> directInputNodes;
@@ -434,7 +522,8 @@ static inline std::vector<Node*> getNodes (Node&, VertexOrdering);
     repeatedly for Node until they all return false indicating no topological
     changes have been made.
 */
-static inline std::vector<Node*> transformNodes (Node& rootNode, bool disableLatencyCompensation)
+static inline std::vector<Node*> transformNodes (Node& rootNode, bool disableLatencyCompensation,
+                                                 bool shareLatencyCompensation = false)
 {
     for (;;)
     {
@@ -445,7 +534,7 @@ static inline std::vector<Node*> transformNodes (Node& rootNode, bool disableLat
 
         for (auto node : allNodes)
         {
-            Node::TransformOptions options { rootNode, allNodes, cache, disableLatencyCompensation };
+            Node::TransformOptions options { rootNode, allNodes, cache, disableLatencyCompensation, shareLatencyCompensation };
             const auto res = node->transform (options);
 
             if (res == TransformResult::none)
@@ -471,12 +560,20 @@ static inline std::vector<Node*> transformNodes (Node& rootNode, bool disableLat
 //==============================================================================
 inline void Node::initialise (const PlaybackInitialisationInfo& info)
 {
+    // Any external buffer will belong to a previous graph
+    hasExternalAudioBuffer = false;
+    allocatedView = {};
+
     prepareToPlay (info);
 
     auto props = getNodeProperties();
     audioBufferSize = choc::buffer::Size::create ((choc::buffer::ChannelCount) props.numberOfChannels,
                                                   (choc::buffer::FrameCount) info.blockSize);
 
+   #if TRACKTION_GRAPH_NODE_PROFILING || TRACKTION_GRAPH_TRACING
+    cachedNodeID = props.nodeID;
+   #endif
+
     if (info.allocateAudioBuffer)
     {
         allocateAudioBuffer = info.allocateAudioBuffer;
@@ -517,6 +614,12 @@ inline void Node::process (choc::buffer::FrameCount numSamples, juce::Range<int6
         assert (n->hasProcessed());
    #endif
 
+   #if TRACKTION_GRAPH_NODE_PROFILING
+    const NodeProfiler::ScopedMeasurement profilerMeasurement (nodeProfiler, cachedNodeID);
+   #endif
+
+    TRACKTION_GRAPH_TRACE_SCOPE ("Node::process", "node", cachedNodeID)
+
     preProcess (numSamples, referenceSampleRange);
 
     // First, allocate buffers if possible
@@ -530,7 +633,11 @@ inline void Node::process (choc::buffer::FrameCount numSamples, juce::Range<int6
 
     if (nodeOptimisations.clear == ClearBuffers::yes)
     {
-        audioBuffer.clear();
+        if (hasExternalAudioBuffer)
+            allocatedView.clear();
+        else
+            audioBuffer.clear();
+
         midiBuffer.clear();
     }
 
@@ -559,6 +666,7 @@ inline void Node::process (choc::buffer::FrameCount numSamples, juce::Range<int6
     auto destAudioView = audioView;
     ProcessContext pc { numSamples, referenceSampleRange, { destAudioView, midiBuffer } };
     process (pc);
+    isAudioSilent = pc.buffers.isAudioSilent;
     numSamplesProcessed.store ((int) numSamples, std::memory_order_release);
 
     jassert (numChannelsBeforeProcessing == audioBuffer.getNumChannels());
@@ -595,7 +703,7 @@ inline Node::AudioAndMidiBuffer Node::getProcessedOutput()
    #endif
 
     return { audioView.getStart ((choc::buffer::FrameCount) numSamplesProcessed.load (std::memory_order_acquire)),
-             midiBuffer };
+             midiBuffer, isAudioSilent };
 }
 
 inline size_t Node::getAllocatedBytes() const
@@ -604,11 +712,47 @@ inline size_t Node::getAllocatedBytes() const
         + (size_t (midiBuffer.size()) * sizeof (tracktion_engine::MidiMessageWithSource));
 }
 
+inline choc::buffer::Size Node::getInternalAudioBufferSize() const
+{
+    if (allocateAudioBuffer || nodeOptimisations.allocate == AllocateAudioBuffer::no)
+        return {};
+
+    return audioBufferSize;
+}
+
+inline bool Node::mayForwardInputBuffers() const
+{
+    return nodeOptimisations.allocate == AllocateAudioBuffer::no
+        || directInputNodes.size() == 1;
+}
+
+inline void Node::useExternalAudioBuffer (const choc::buffer::ChannelArrayView<float>& view)
+{
+    assert (view.getSize() == audioBufferSize);
+    assert (! allocateAudioBuffer);
+
+    audioBuffer = {};
+    allocatedView = view;
+    hasExternalAudioBuffer = true;
+}
+
+inline void Node::setNodeProfiler ([[ maybe_unused ]] NodeProfiler* profilerToUse)
+{
+   #if TRACKTION_GRAPH_NODE_PROFILING
+    nodeProfiler = profilerToUse;
+   #endif
+}
+
 inline void Node::setOptimisations (NodeOptimisations newOptimisations)
 {
     nodeOptimisations = newOptimisations;
 }
 
+inline NodeOptimisations Node::getOptimisations() const
+{
+    return nodeOptimisations;
+}
+
 inline void Node::setBufferViewToUse (Node* sourceNode, const choc::buffer::ChannelArrayView<float>& view)
 {
     if (sourceNode)
@@ -659,17 +803,41 @@ inline void Node::release()
 //==============================================================================
 namespace detail
 {
+    /** Keeps the visited Nodes in order along with a set for quick lookups.
+        Without the set, visiting becomes quadratic which is noticeable on large graphs.
+    */
+    struct VisitedNodes
+    {
+        VisitedNodes (std::vector<Node*>& nodes)
+            : orderedNodes (nodes)
+        {}
+
+        bool contains (Node* n) const
+        {
+            return nodeSet.find (n) != nodeSet.end();
+        }
+
+        void add (Node* n)
+        {
+            nodeSet.insert (n);
+            orderedNodes.push_back (n);
+        }
+
+        std::vector<Node*>& orderedNodes;
+        std::unordered_set<Node*> nodeSet;
+    };
+
     struct VisitNodesWithRecord
     {
         template<typename Visitor>
-        static void visit (std::vector<Node*>& visitedNodes, Node& visitingNode, Visitor&& visitor, bool preordering)
+        static void visit (VisitedNodes& visitedNodes, Node& visitingNode, Visitor&& visitor, bool preordering)
         {
-            if (std::find (visitedNodes.begin(), visitedNodes.end(), &visitingNode) != visitedNodes.end())
+            if (visitedNodes.contains (&visitingNode))
                 return;
 
             if (preordering)
             {
-                visitedNodes.push_back (&visitingNode);
+                visitedNodes.add (&visitingNode);
                 visitor (visitingNode);
             }
 
@@ -678,7 +846,7 @@ namespace detail
 
             if (! preordering)
             {
-                visitedNodes.push_back (&visitingNode);
+                visitedNodes.add (&visitingNode);
                 visitor (visitingNode);
             }
         }
@@ -687,11 +855,11 @@ namespace detail
     struct VisitNodesWithRecordBFS
     {
         template<typename Visitor>
-        static void visit (std::vector<Node*>& visitedNodes, Node& visitingNode, Visitor&& visitor)
+        static void visit (VisitedNodes& visitedNodes, Node& visitingNode, Visitor&& visitor)
         {
-            if (std::find (visitedNodes.begin(), visitedNodes.end(), &visitingNode) == visitedNodes.end())
+            if (! visitedNodes.contains (&visitingNode))
             {
-                visitedNodes.push_back (&visitingNode);
+                visitedNodes.add (&visitingNode);
                 visitor (visitingNode);
             }
 
@@ -700,9 +868,9 @@ namespace detail
             // Visit each node then go back to the first and recurse
             for (auto n : inputs)
             {
-                if (std::find (visitedNodes.begin(), visitedNodes.end(), n) == visitedNodes.end())
+                if (! visitedNodes.contains (n))
                 {
-                    visitedNodes.push_back (n);
+                    visitedNodes.add (n);
                     visitor (visitingNode);
                 }
             }
@@ -717,14 +885,16 @@ template<typename Visitor>
 inline void visitNodes (Node& node, Visitor&& visitor, bool preordering)
 {
     std::vector<Node*> visitedNodes;
-    detail::VisitNodesWithRecord::visit (visitedNodes, node, visitor, preordering);
+    detail::VisitedNodes visited (visitedNodes);
+    detail::VisitNodesWithRecord::visit (visited, node, visitor, preordering);
 }
 
 template<typename Visitor>
 inline void visitNodesBFS (Node& node, Visitor&& visitor)
 {
     std::vector<Node*> visitedNodes;
-    detail::VisitNodesWithRecordBFS::visit (visitedNodes, node, visitor);
+    detail::VisitedNodes visited (visitedNodes);
+    detail::VisitNodesWithRecordBFS::visit (visited, node, visitor);
 }
 
 inline std::vector<Node*> getNodes (Node& node, VertexOrdering vertexOrdering)
@@ -733,7 +903,8 @@ inline std::vector<Node*> getNodes (Node& node, VertexOrdering vertexOrdering)
         || vertexOrdering == VertexOrdering::bfsReversePreordering)
     {
         std::vector<Node*> visitedNodes;
-        detail::VisitNodesWithRecordBFS::visit (visitedNodes, node, [](auto&){});
+        detail::VisitedNodes visited (visitedNodes);
+        detail::VisitNodesWithRecordBFS::visit (visited, node, [](auto&){});
 
         if (vertexOrdering == VertexOrdering::bfsReversePreordering)
             std::reverse (visitedNodes.begin(), visitedNodes.end());
@@ -745,7 +916,8 @@ inline std::vector<Node*> getNodes (Node& node, VertexOrdering vertexOrdering)
                     || vertexOrdering == VertexOrdering::reversePreordering;
 
     std::vector<Node*> visitedNodes;
-    detail::VisitNodesWithRecord::visit (visitedNodes, node, [](auto&){}, preordering);
+    detail::VisitedNodes visited (visitedNodes);
+    detail::VisitNodesWithRecord::visit (visited, node, [](auto&){}, preordering);
 
     if (vertexOrdering == VertexOrdering::reversePreordering
         || vertexOrdering == VertexOrdering::reversePostordering)
@@ -777,10 +949,12 @@ inline std::vector<NodeAndID> createNodeMap (const std::vector<Node*>& nodes)
 }
 
 inline std::unique_ptr<NodeGraph> createNodeGraph (std::unique_ptr<Node> rootNode,
-                                                   bool disableLatencyCompensation)
+                                                   bool disableLatencyCompensation,
+                                                   bool shareLatencyCompensation)
 {
     assert (rootNode != nullptr);
-    auto orderedNodes = transformNodes (*rootNode, disableLatencyCompensation);
+    const auto startTime = std::chrono::steady_clock::now();
+    auto orderedNodes = transformNodes (*rootNode, disableLatencyCompensation, shareLatencyCompensation);
     auto sortedNodes = createNodeMap (orderedNodes);
 
     // Iterate all nodes, for each input, increment the dest Node output count
@@ -795,6 +969,7 @@ inline std::unique_ptr<NodeGraph> createNodeGraph (std::unique_ptr<Node> rootNod
     nodeGraph->rootNode = std::move (rootNode);
     nodeGraph->orderedNodes = std::move (orderedNodes);
     nodeGraph->sortedNodes = std::move (sortedNodes);
+    nodeGraph->transformDuration = std::chrono::steady_clock::now() - startTime;
 
     return nodeGraph;
 }
@@ -41,6 +41,7 @@ public:
             runSinOctaveTests (setup);
             runSendReturnTests (setup);
             runLatencyTests (setup);
+            runSilenceTests (setup);
 
             // MIDI tests
             runMidiTests (setup);
@@ -300,6 +301,34 @@ private:
             test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, numLatencySamples, 0.0f, 0.0f, 1.0f, 0.707f);
         }
 
+        beginTest ("Multiple send/return with gains");
+        {
+            /*  This has three sends of the same sin to a bus with different gains and a return with a silent input.
+                The gains should be applied to each send as it's summed in to the bus, giving a mag 1 sin.
+            */
+            const double sinFrequency = testSetup.sampleRate / 100.0;
+
+            auto track1 = makeNode<SinNode> ((float) sinFrequency);
+            track1 = makeNode<SendNode> (std::move (track1), 1, [] { return 0.25f; });
+            track1 = makeGainNode (std::move (track1), 0.0f);
+
+            auto track2 = makeNode<SinNode> ((float) sinFrequency);
+            track2 = makeNode<SendNode> (std::move (track2), 1, [] { return 1.0f; });
+            track2 = makeGainNode (std::move (track2), 0.0f);
+
+            auto track3 = makeNode<SinNode> ((float) sinFrequency);
+            track3 = makeNode<SendNode> (std::move (track3), 1, [] { return -0.25f; });
+            track3 = makeGainNode (std::move (track3), 0.0f);
+
+            auto track4 = makeNode<SilentNode> (1);
+            track4 = makeNode<ReturnNode> (std::move (track4), 1);
+
+            auto node = makeSummingNode ({ track1.release(), track2.release(), track3.release(), track4.release() });
+
+            auto testContext = createBasicTestContext (std::move (node), testSetup, 1, 5.0);
+            test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+
         beginTest ("Send, send/return with two stage latency");
         {
             /*  This has a sin input to a latency node leading to a another latency block and another send on a different bus.
@@ -332,6 +361,120 @@ private:
             // Part of buffer after latency which should be all sin +-1.0
             test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, numLatencySamples, 0.0f, 0.0f, 1.0f, 0.707f);
         }
+
+        beginTest ("Shared latency compensation");
+        {
+            /*  This has one sin input with latency and three without.
+                With shared latency compensation, the three inputs without latency should be
+                summed and delayed by a single LatencyNode rather than getting one each.
+            */
+            auto createNode = []
+            {
+                std::vector<std::unique_ptr<Node>> inputs;
+                inputs.push_back (makeNode<LatencyNode> (makeNode<SinNode> (220.0f), 100));
+
+                for (int i = 0; i < 3; ++i)
+                    inputs.push_back (makeGainNode (makeNode<SinNode> (220.0f), 0.5f));
+
+                return std::make_unique<SummingNode> (std::move (inputs));
+            };
+
+            auto getNumLatencyNodes = [] (NodeGraph& nodeGraph)
+            {
+                return std::count_if (nodeGraph.orderedNodes.begin(), nodeGraph.orderedNodes.end(),
+                                      [] (auto n) { return dynamic_cast<LatencyNode*> (n) != nullptr; });
+            };
+
+            auto separateGraph = createNodeGraph (createNode(), false, false);
+            expectEquals ((int) getNumLatencyNodes (*separateGraph), 4);
+
+            auto sharedGraph = createNodeGraph (createNode(), false, true);
+            expectEquals ((int) getNumLatencyNodes (*sharedGraph), 2);
+            expectEquals ((int) sharedGraph->rootNode->getDirectInputNodes().size(), 2);
+
+            for (auto input : sharedGraph->rootNode->getDirectInputNodes())
+                expectEquals (input->getNodeProperties().latencyNumSamples, 100);
+
+            // Delaying the sum rather than each input shouldn't change the output
+            auto render = [&] (bool shareLatencyCompensation)
+            {
+                auto player = std::make_unique<LockFreeMultiThreadedNodePlayer>();
+                player->enableSharedLatencyCompensation (shareLatencyCompensation);
+                player->setNode (createNode(), testSetup.sampleRate, testSetup.blockSize);
+
+                return createTestContext (std::move (player), testSetup, 1, 1.0);
+            };
+
+            auto separate = render (false);
+            auto shared = render (true);
+            expectEquals (shared->buffer.getNumSamples(), separate->buffer.getNumSamples());
+            expectGreaterThan (separate->buffer.getMagnitude (0, separate->buffer.getNumSamples()), 1.0f);
+
+            float maxDiff = 0.0f;
+
+            for (int s = 0; s < std::min (shared->buffer.getNumSamples(), separate->buffer.getNumSamples()); ++s)
+                maxDiff = std::max (maxDiff, std::abs (shared->buffer.getSample (0, s) - separate->buffer.getSample (0, s)));
+
+            // The inputs are summed in a different order so allow for rounding
+            expectLessOrEqual (maxDiff, 1.0e-6f);
+        }
+
+        beginTest ("Latency compensation disabled");
+        {
+            /*  This is the same as the doubling test but with latency compensation disabled
+                on the SummingNode so the undelayed sin isn't held back and they cancel instead.
+                Wrapping it in a compensating SummingNode checks it isn't flattened in to it.
+            */
+            const double sampleRate = testSetup.sampleRate;
+            const double sinFrequency = sampleRate / 100.0;
+            const double numSamplesPerCycle = sampleRate / sinFrequency;
+            const int numLatencySamples = juce::roundToInt (numSamplesPerCycle / 2.0);
+
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.push_back (makeNode<SinNode> ((float) sinFrequency));
+            nodes.push_back (makeNode<LatencyNode> (makeNode<SinNode> ((float) sinFrequency), numLatencySamples));
+
+            auto sumNode = std::make_unique<SummingNode> (std::move (nodes));
+            sumNode->setLatencyCompensationEnabled (false);
+
+            std::vector<std::unique_ptr<Node>> outerNodes;
+            outerNodes.push_back (std::move (sumNode));
+
+            auto testContext = createBasicTestContext (makeNode<SummingNode> (std::move (outerNodes)), testSetup, 1, 5.0);
+            test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, numLatencySamples, 1.0f, 0.707f, 0.0f, 0.0f);
+        }
+    }
+
+    void runSilenceTests (TestSetup testSetup)
+    {
+        auto makeSilentNode = [] { return makeNode<GainNode> (makeNode<SinNode> (220.0f, 1), [] { return 0.0f; }); };
+
+        beginTest ("Silent inputs are skipped when summing");
+        {
+            auto node = makeSummingNode ({ makeSilentNode().release(), makeNode<SinNode> (220.0f, 1).release() });
+
+            auto testContext = createBasicTestContext (std::move (node), testSetup, 1, 5.0);
+            test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+
+        beginTest ("Silence propagates through the graph");
+        {
+            auto sumNode = makeSummingNode ({ makeSilentNode().release(), makeSilentNode().release() });
+            auto sumNodePtr = sumNode.get();
+            auto sendNode = makeNode<SendNode> (std::move (sumNode), 1);
+            auto sendNodePtr = sendNode.get();
+
+            NodePlayer player (std::move (sendNode));
+            player.prepareToPlay (testSetup.sampleRate, testSetup.blockSize);
+
+            choc::buffer::ChannelArrayBuffer<float> buffer (1, (choc::buffer::FrameCount) testSetup.blockSize);
+            tracktion_engine::MidiMessageArray midi;
+            player.process ({ (choc::buffer::FrameCount) testSetup.blockSize, { 0, testSetup.blockSize }, { buffer.getView(), midi } });
+
+            expect (sumNodePtr->getProcessedOutput().isAudioSilent);
+            expect (sendNodePtr->getProcessedOutput().isAudioSilent);
+            test_utilities::expectAudioBuffer (*this, toAudioBuffer (buffer.getView()), 0, 0.0f, 0.0f);
+        }
     }
 
     void runMidiTests (TestSetup testSetup)
@@ -352,6 +495,25 @@ private:
             test_utilities::expectMidiBuffer (*this, testContext->midi, sampleRate, sequence);
         }
 
+        beginTest ("Summed MIDI");
+        {
+            // Each input is already sorted so these should get merged in order
+            juce::MidiMessageSequence expectedSequence;
+            std::vector<std::unique_ptr<Node>> midiNodes;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const auto inputSequence = test_utilities::createRandomMidiMessageSequence (duration - 0.5, juce::Random (testSetup.random.nextInt64()));
+                expectedSequence.addSequence (inputSequence, 0.0);
+                midiNodes.push_back (makeNode<MidiNode> (inputSequence));
+            }
+
+            expectedSequence.updateMatchedPairs();
+
+            auto testContext = createBasicTestContext (std::make_unique<SummingNode> (std::move (midiNodes)), testSetup, 1, duration);
+            test_utilities::expectMidiBuffer (*this, testContext->midi, sampleRate, expectedSequence);
+        }
+
         beginTest ("Delayed MIDI");
         {
             expectGreaterThan (sequence.getNumEvents(), 0);
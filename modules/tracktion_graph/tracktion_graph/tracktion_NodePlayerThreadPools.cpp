@@ -57,6 +57,7 @@ struct ThreadPoolCV : public LockFreeMultiThreadedNodePlayer::ThreadPool
         {
             threads.emplace_back ([this] { runThread(); });
             setThreadPriority (threads.back(), 10);
+            applyThreadAffinity (threads.back(), i);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
     }
@@ -161,7 +162,10 @@ private:
                 return;
 
             if (! process())
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::wait", "thread_pool", 0)
                 wait();
+            }
         }
     }
 };
@@ -192,6 +196,7 @@ struct ThreadPoolRT : public LockFreeMultiThreadedNodePlayer::ThreadPool
         {
             threads.emplace_back ([this] { runThread(); });
             setThreadPriority (threads.back(), 10);
+            applyThreadAffinity (threads.back(), i);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
     }
@@ -265,7 +270,10 @@ private:
                 return;
 
             if (! process())
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::wait", "thread_pool", 0)
                 wait();
+            }
         }
     }
 
@@ -302,6 +310,7 @@ struct ThreadPoolHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
         {
             threads.emplace_back ([this] { runThread(); });
             setThreadPriority (threads.back(), 10);
+            applyThreadAffinity (threads.back(), i);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
     }
@@ -425,7 +434,10 @@ private:
                 return;
 
             if (! process())
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::wait", "thread_pool", 0)
                 wait();
+            }
         }
     }
 };
@@ -458,6 +470,7 @@ struct ThreadPoolSem : public LockFreeMultiThreadedNodePlayer::ThreadPool
         {
             threads.emplace_back ([this] { runThread(); });
             setThreadPriority (threads.back(), 10);
+            applyThreadAffinity (threads.back(), i);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
     }
@@ -532,7 +545,10 @@ private:
                 return;
 
             if (! process())
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::wait", "thread_pool", 0)
                 wait();
+            }
         }
     }
 };
@@ -565,6 +581,7 @@ struct ThreadPoolSemHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
         {
             threads.emplace_back ([this] { runThread(); });
             setThreadPriority (threads.back(), 10);
+            applyThreadAffinity (threads.back(), i);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
     }
@@ -666,10 +683,165 @@ private:
                 return;
 
             if (! process())
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::wait", "thread_pool", 0)
+                wait();
+            }
+        }
+    }
+};
+
+
+//==============================================================================
+//==============================================================================
+/**
+    Keeps a queue of ready Nodes per worker thread.
+    Worker threads process the most recently readied Nodes from their own queue first
+    (whose inputs were probably just processed on the same core), only stealing the
+    oldest Nodes from other threads when they run out of work.
+    Waiting behaves in the same way as ThreadPoolSemHybrid.
+*/
+struct ThreadPoolWorkStealing : public LockFreeMultiThreadedNodePlayer::ThreadPool
+{
+    ThreadPoolWorkStealing (LockFreeMultiThreadedNodePlayer& p)
+        : ThreadPool (p)
+    {
+    }
+
+    bool usesPerThreadQueues() const override
+    {
+        return true;
+    }
+
+    void createThreads (size_t numThreads, juce::AudioWorkgroup workgroupToUse) override
+    {
+        if (threads.size() == numThreads)
+            return;
+
+        resetExitSignal();
+        semaphore = std::make_unique<LightweightSemaphore> ((int) numThreads);
+        workgroup = workgroupToUse;
+
+        const auto rtOpts = juce::Thread::RealtimeOptions()
+                      .withPriority (10)
+                      .withApproximateAudioProcessingTime (player.getBlockSize(), player.getSampleRate());
+
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            // Index 0 is used by the thread calling process
+            threads.emplace_back ([this, workerIndex = (int) i + 1] { runThread (workerIndex); });
+            setThreadPriority (threads.back(), 10);
+            applyThreadAffinity (threads.back(), i);
+            tryToUpgradeCurrentThreadToRealtime (rtOpts);
+        }
+    }
+
+    void clearThreads() override
+    {
+        signalShouldExit();
+
+        for (auto& t : threads)
+            t.join();
+
+        threads.clear();
+        semaphore.reset();
+    }
+
+    void signalOne() override
+    {
+        if (semaphore) semaphore->signal();
+    }
+
+    void signal (int numToSignal) override
+    {
+        if (semaphore) semaphore->signal (std::min (numToSignal, (int) threads.size()));
+    }
+
+    void signalAll() override
+    {
+        if (semaphore) semaphore->signal ((int) threads.size());
+    }
+
+    void wait()
+    {
+        thread_local int pauseCount = 0;
+
+        if (shouldExit())
+            return;
+
+        if (shouldWait())
+        {
+            ++pauseCount;
+
+            if (pauseCount < 25)
+            {
+                pause();
+            }
+            else if (pauseCount < 50)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                pauseCount = 0;
+
+                // Fall back to locking
+                if (timeOutMilliseconds < 0)
+                {
+                    semaphore->wait();
+                }
+                else
+                {
+                    using namespace std::chrono;
+                    semaphore->timed_wait ((std::uint64_t) duration_cast<microseconds> (milliseconds (timeOutMilliseconds)).count());
+                }
+            }
+        }
+        else
+        {
+            pauseCount = 0;
+        }
+    }
+
+    void waitForFinalNode() override
+    {
+        if (isFinalNodeReady())
+            return;
+
+        if (! shouldWait())
+            return;
+
+        pause();
+        return;
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::unique_ptr<LightweightSemaphore> semaphore;
+    juce::AudioWorkgroup workgroup;
+
+    void runThread (int workerIndex)
+    {
+        juce::WorkgroupToken token;
+        workgroup.join (token);
+
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+        setWorkerIndexForCurrentThread (workerIndex);
+
+        for (;;)
+        {
+            if (shouldExit())
+                return;
+
+            if (! process())
+            {
+                TRACKTION_GRAPH_TRACE_SCOPE ("ThreadPool::wait", "thread_pool", 0)
                 wait();
+            }
         }
     }
 };
+
 //==============================================================================
 //==============================================================================
 LockFreeMultiThreadedNodePlayer::ThreadPoolCreator getPoolCreatorFunction (ThreadPoolStrategy poolType)
@@ -686,6 +858,8 @@ LockFreeMultiThreadedNodePlayer::ThreadPoolCreator getPoolCreatorFunction (Threa
             return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolSem<LightweightSemaphore>> (p); };
         case ThreadPoolStrategy::lightweightSemHybrid:
             return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolSemHybrid<LightweightSemaphore>> (p); };
+        case ThreadPoolStrategy::workStealing:
+            return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolWorkStealing> (p); };
         case ThreadPoolStrategy::realTime:
         default:
             return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolRT> (p); };
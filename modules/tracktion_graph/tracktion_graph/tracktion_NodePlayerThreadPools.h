@@ -27,7 +27,8 @@ enum class ThreadPoolStrategy
     hybrid,                 /**< Uses a combination of the above, avoiding CVs on the audio thread. */
     semaphore,              /**< Uses a semaphore to suspend threads. */
     lightweightSemaphore,   /**< Uses a semaphore/spin mechanism to suspend threads.*/
-    lightweightSemHybrid    /**< Uses a combination of semaphores/spin and yields to suspend threads.*/
+    lightweightSemHybrid,   /**< Uses a combination of semaphores/spin and yields to suspend threads.*/
+    workStealing            /**< Uses a queue per thread, stealing from other threads when empty. Suspends threads like lightweightSemHybrid. */
 };
 
 /** Returns a function to create a ThreadPool for the given stategy. */
@@ -139,6 +139,14 @@ public:
     /** Converts a linear timeline position to a position wrapped in the loop. */
     static int64_t linearPositionToLoopPosition (int64_t position, juce::Range<int64_t> loopRange);
 
+    /** Returns a number that changes whenever the mapping of reference sample positions to
+        timeline positions changes, e.g. the position is set, playback starts or stops or the
+        loop range changes.
+        Things that process ahead of the current reference sample range can use this to
+        check if what they processed is still valid.
+    */
+    uint32_t getTimelineMappingVersion() const noexcept;
+
     //==============================================================================
     /** Sets the reference sample count, adjusting the timeline if the play head is playing. */
     void setReferenceSampleRange (juce::Range<int64_t> sampleRange);
@@ -169,14 +177,16 @@ private:
 
     std::atomic<int> speed { 0 };
     std::atomic<bool> looping { false }, userDragging { false }, rollInToLoop { false };
+    std::atomic<uint32_t> timelineMappingVersion { 0 };
 
     std::atomic<std::chrono::system_clock::time_point> userInteractionTime { std::chrono::system_clock::now() };
 
     //==============================================================================
     SyncPositions getSyncPositions() const              { return syncPositions.load(); }
-    void setSyncPositions (SyncPositions newPositions)  { syncPositions.store (newPositions); }
+    void setSyncPositions (SyncPositions newPositions)  { syncPositions.store (newPositions); timelineMappingChanged(); }
 
     void userInteraction()  { userInteractionTime = std::chrono::system_clock::now(); }
+    void timelineMappingChanged()   { timelineMappingVersion.fetch_add (1, std::memory_order_release); }
 };
 
 
@@ -202,12 +212,14 @@ inline void PlayHead::play (juce::Range<int64_t> rangeToPlay, bool looped)
     looping = looped && (rangeToPlay.getLength() > 50);
     setPosition (rangeToPlay.getStart());
     speed = 1;
+    timelineMappingChanged();
 }
 
 inline void PlayHead::play()
 {
     setPosition (getPosition());
     speed = 1;
+    timelineMappingChanged();
 }
 
 inline void PlayHead::playSyncedToRange (juce::Range<int64_t> rangeToPlay)
@@ -221,6 +233,7 @@ inline void PlayHead::stop()
     auto t = getPosition();
     speed = 0;
     setPosition (t);
+    timelineMappingChanged();
 }
 
 inline int64_t PlayHead::getPosition() const
@@ -267,6 +280,8 @@ inline void PlayHead::setLoopRange (bool loop, juce::Range<int64_t> loopRange, b
 
         if (updatePosition)
             setPosition (lastPos);
+
+        timelineMappingChanged();
     }
 }
 
@@ -285,6 +300,7 @@ inline void PlayHead::setUserIsDragging (bool b)
 {
     userInteraction();
     userDragging = b;
+    timelineMappingChanged();
 }
 
 inline bool PlayHead::isUserDragging() const
@@ -300,7 +316,8 @@ inline std::chrono::system_clock::time_point PlayHead::getLastUserInteractionTim
 //==============================================================================
 inline void PlayHead::setScrubbingBlockLength (int64_t numSamples)
 {
-    scrubbingBlockLength = numSamples;
+    if (scrubbingBlockLength.exchange (numSamples) != numSamples)
+        timelineMappingChanged();
 }
 
 inline int64_t PlayHead::getScrubbingBlockLength() const
@@ -341,13 +358,21 @@ inline int64_t PlayHead::linearPositionToLoopPosition (int64_t position, juce::R
     return loopStart + juce::negativeAwareModulo ((position - loopStart), loopRange.getLength());
 }
 
+inline uint32_t PlayHead::getTimelineMappingVersion() const noexcept
+{
+    return timelineMappingVersion.load (std::memory_order_acquire);
+}
+
 //==============================================================================
 inline void PlayHead::setReferenceSampleRange (juce::Range<int64_t> sampleRange)
 {
     referenceSampleRange.store (sampleRange);
 
     if (rollInToLoop && getPosition() >= timelinePlayRange.load().getStart())
+    {
         rollInToLoop = false;
+        timelineMappingChanged();
+    }
 }
 
 inline juce::Range<int64_t> PlayHead::getReferenceSampleRange() const
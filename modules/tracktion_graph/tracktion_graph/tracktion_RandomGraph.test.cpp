@@ -0,0 +1,341 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_RANDOMGRAPHS
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_RANDOMGRAPH
+
+//==============================================================================
+//==============================================================================
+class RandomGraphTests  : public juce::UnitTest
+{
+public:
+    RandomGraphTests()
+        : juce::UnitTest ("RandomGraph", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        RandomGraphOptions options;
+        options.numNodes = 500;
+        options.width = 20;
+        options.minFanIn = 2;
+        options.maxFanIn = 3;
+        options.maxFanOut = 2;
+        options.seed = 1234;
+
+        beginTest ("Graphs depend only on the seed");
+        {
+            auto graph1 = createRandomGraph (options);
+            auto graph2 = createRandomGraph (options);
+            expect (exportGraph (*graph1, GraphExportFormat::json) == exportGraph (*graph2, GraphExportFormat::json));
+
+            auto otherOptions = options;
+            otherOptions.seed = 4321;
+            auto graph3 = createRandomGraph (otherOptions);
+            expect (exportGraph (*graph1, GraphExportFormat::json) != exportGraph (*graph3, GraphExportFormat::json));
+        }
+
+        beginTest ("Graphs respect the fan-in and fan-out limits");
+        {
+            auto rootNode = createRandomGraph (options);
+            std::unordered_map<Node*, int> numOutputs;
+            int numRandomGraphNodes = 0, numLatencyNodes = 0;
+
+            visitNodes (*rootNode, [&] (Node& n)
+                        {
+                            if (dynamic_cast<LatencyNode*> (&n) != nullptr)
+                                ++numLatencyNodes;
+                            else if (dynamic_cast<RandomGraphNode*> (&n) != nullptr)
+                                ++numRandomGraphNodes;
+
+                            if (&n == rootNode.get())
+                                return;
+
+                            const auto numInputs = (int) n.getDirectInputNodes().size();
+                            expect (numInputs <= options.maxFanIn);
+
+                            for (auto input : n.getDirectInputNodes())
+                                ++numOutputs[input];
+                        }, false);
+
+            expectEquals (numRandomGraphNodes, options.numNodes + 1);
+            expect (numLatencyNodes > 0);
+
+            for (auto [node, num] : numOutputs)
+                expect (num <= options.maxFanOut);
+        }
+
+        beginTest ("Graphs can be played with several threads");
+        {
+            options.load.meanLoad = 0.0;
+            constexpr int blockSize = 256;
+
+            LockFreeMultiThreadedNodePlayer player;
+            player.setNumThreads (2);
+            player.setNode (createRandomGraph (options), 44100.0, blockSize);
+
+            choc::buffer::ChannelArrayBuffer<float> buffer (2, (choc::buffer::FrameCount) blockSize);
+            tracktion_engine::MidiMessageArray midi;
+            bool hasMidi = false;
+
+            for (int i = 0; i < 20; ++i)
+            {
+                buffer.clear();
+                midi.clear();
+                const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength ((int64_t) i * blockSize, (int64_t) blockSize);
+                player.process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { buffer.getView(), midi } });
+                hasMidi = hasMidi || ! midi.isEmpty();
+            }
+
+            expect (buffer.getSample (0, 0) > 0.0f);
+            expect (hasMidi);
+        }
+
+        options.numNodes = 200;
+        options.width = 10;
+        options.minFanIn = 1;
+
+        beginTest ("Chain fusion doesn't change the output");
+        {
+            expectSameOutput (options, [] (LockFreeMultiThreadedNodePlayer& player) { player.enableChainFusion (true); });
+        }
+
+        // Give the Nodes a small cost so the critical paths measured from the first graph vary
+        options.load.meanLoad = 0.001;
+
+        beginTest ("Critical-path scheduling doesn't change the output");
+        {
+            expectSameOutput (options, [] (LockFreeMultiThreadedNodePlayer& player) { player.enableCriticalPathScheduling (true); });
+        }
+
+        beginTest ("Critical-path scheduling with chain fusion doesn't change the output");
+        {
+            expectSameOutput (options, [] (LockFreeMultiThreadedNodePlayer& player)
+                                       {
+                                           player.enableCriticalPathScheduling (true);
+                                           player.enableChainFusion (true);
+                                       });
+        }
+    }
+
+private:
+    /** The audio samples and descriptions of the MIDI messages rendered by a graph. */
+    struct Output
+    {
+        std::vector<float> audio;
+        std::vector<juce::String> midi;
+    };
+
+    /** Plays two graphs made from the options, one after the other so anything
+        measured while playing the first can be used by the second, and returns
+        the output of the second.
+    */
+    static Output render (const RandomGraphOptions& options, ThreadPoolStrategy strategy, size_t numThreads,
+                          const std::function<void (LockFreeMultiThreadedNodePlayer&)>& configurePlayer)
+    {
+        constexpr int blockSize = 256;
+        constexpr int numBlocks = 20;
+
+        LockFreeMultiThreadedNodePlayer player (getPoolCreatorFunction (strategy));
+        player.setNumThreads (numThreads);
+        configurePlayer (player);
+
+        choc::buffer::ChannelArrayBuffer<float> buffer ((choc::buffer::ChannelCount) options.numChannels, (choc::buffer::FrameCount) blockSize);
+        tracktion_engine::MidiMessageArray midi;
+        int64_t position = 0;
+        Output output;
+
+        for (int graph = 0; graph < 2; ++graph)
+        {
+            player.setNode (createRandomGraph (options), 44100.0, blockSize);
+            output = {};
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buffer.clear();
+                midi.clear();
+                const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength (position, (int64_t) blockSize);
+                position += blockSize;
+                player.process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { buffer.getView(), midi } });
+
+                for (choc::buffer::ChannelCount c = 0; c < buffer.getNumChannels(); ++c)
+                    for (choc::buffer::FrameCount f = 0; f < buffer.getNumFrames(); ++f)
+                        output.audio.push_back (buffer.getSample (c, f));
+
+                for (auto& m : midi)
+                    output.midi.push_back (juce::String (i) + ": " + juce::String (m.getTimeStamp()) + " " + m.getDescription());
+            }
+        }
+
+        return output;
+    }
+
+    /** Checks that graphs played with a configured player on each of the thread
+        pools give exactly the same output as a single-threaded player.
+    */
+    void expectSameOutput (const RandomGraphOptions& options,
+                           const std::function<void (LockFreeMultiThreadedNodePlayer&)>& configurePlayer)
+    {
+        const auto expected = render (options, ThreadPoolStrategy::realTime, 0, [] (LockFreeMultiThreadedNodePlayer&) {});
+        expect (! expected.midi.empty());
+
+        for (auto strategy : test_utilities::getThreadPoolStrategies())
+        {
+            for (auto numThreads : { 0, 1, 3 })
+            {
+                const auto actual = render (options, strategy, (size_t) numThreads, configurePlayer);
+                const auto description = test_utilities::getName (strategy) + ", " + juce::String (numThreads) + " threads";
+
+                expect (actual.audio == expected.audio, "Audio differs: " + description);
+                expect (actual.midi == expected.midi, "MIDI differs: " + description);
+            }
+        }
+    }
+};
+
+static RandomGraphTests randomGraphTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_RANDOMGRAPHS
+
+using namespace test_utilities;
+
+//==============================================================================
+//==============================================================================
+/**
+    Measures how each ThreadPoolStrategy and scheduling feature scales with the
+    number of Nodes and threads, using graphs made by createRandomGraph.
+
+    Blocks are processed as fast as possible and the throughput, in blocks per
+    second, and the 99th percentile block time are reported for each run.
+*/
+class RandomGraphBenchmarks  : public juce::UnitTest
+{
+public:
+    RandomGraphBenchmarks()
+        : juce::UnitTest ("Random graphs", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (auto numNodes : { 10, 100, 1000, 10000, 100000 })
+            for (auto numThreads : getThreadCounts())
+                for (auto strategy : getThreadPoolStrategies())
+                    for (auto feature : { Feature::none, Feature::criticalPath, Feature::chainFusion })
+                        runBenchmark (numNodes, numThreads, strategy, feature);
+    }
+
+private:
+    enum class Feature { none, criticalPath, chainFusion };
+
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numWarmUpBlocks = 10;
+    static constexpr int numBlocks = 200;
+
+    static juce::String getName (Feature feature)
+    {
+        switch (feature)
+        {
+            case Feature::criticalPath:     return "critical path";
+            case Feature::chainFusion:      return "chain fusion";
+            case Feature::none:             break;
+        }
+
+        return "default";
+    }
+
+    static std::vector<size_t> getThreadCounts()
+    {
+        std::vector<size_t> counts;
+        const auto maxNumThreads = (size_t) std::max (1, juce::SystemStats::getNumCpus() - 1);
+
+        for (size_t n = 1; n < maxNumThreads; n *= 2)
+            counts.push_back (n);
+
+        counts.push_back (maxNumThreads);
+
+        return counts;
+    }
+
+    void runBenchmark (int numNodes, size_t numThreads, ThreadPoolStrategy strategy, Feature feature)
+    {
+        const auto description = juce::String (numNodes) + " nodes, " + juce::String ((int) numThreads) + " threads, "
+                                   + test_utilities::getName (strategy) + ", " + getName (feature);
+        beginTest (description);
+
+        // Each graph has the same total synthetic cost so only the overhead changes with its size
+        RandomGraphOptions options;
+        options.numNodes = numNodes;
+        options.width = std::max (4, (int) std::sqrt ((double) numNodes) * 2);
+        options.load.meanLoad = 0.5 / numNodes;
+        options.load.seed = 42;
+        options.seed = 42;
+
+        LockFreeMultiThreadedNodePlayer player (getPoolCreatorFunction (strategy));
+        player.setNumThreads (numThreads);
+        player.enableCriticalPathScheduling (feature == Feature::criticalPath);
+        player.enableChainFusion (feature == Feature::chainFusion);
+        player.setNode (createRandomGraph (options), sampleRate, blockSize);
+
+        choc::buffer::ChannelArrayBuffer<float> buffer (2, (choc::buffer::FrameCount) blockSize);
+        tracktion_engine::MidiMessageArray midi;
+
+        PerformanceMeasurement::Statistics stats;
+        std::vector<double> blockSeconds;
+        blockSeconds.reserve (numBlocks);
+
+        for (int i = 0; i < numWarmUpBlocks + numBlocks; ++i)
+        {
+            buffer.clear();
+            midi.clear();
+
+            const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength ((int64_t) i * blockSize, (int64_t) blockSize);
+            const auto start = std::chrono::steady_clock::now();
+            const auto startCycles = rdtsc();
+            player.process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { buffer.getView(), midi } });
+            const auto numCycles = rdtsc() - startCycles;
+            const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+            if (i < numWarmUpBlocks)
+                continue;
+
+            stats.addResult (seconds, numCycles);
+            blockSeconds.push_back (seconds);
+        }
+
+        std::sort (blockSeconds.begin(), blockSeconds.end());
+        const auto p99Seconds = blockSeconds[(blockSeconds.size() * 99) / 100];
+        const auto blocksPerSecond = numBlocks / stats.totalSeconds;
+
+        BenchmarkList::getInstance().addResult (createBenchmarkResult (createBenchmarkDescription ("Scheduling", "Random graph",
+                                                                                                  description.toStdString()),
+                                                                       stats));
+
+        std::cout << description << ": " << blocksPerSecond << " blocks/s, p99 "
+                  << p99Seconds * 1000.0 << "ms\n";
+        expect (blocksPerSecond > 0.0);
+    }
+};
+
+static RandomGraphBenchmarks randomGraphBenchmarks;
+
+#endif
+
+}}
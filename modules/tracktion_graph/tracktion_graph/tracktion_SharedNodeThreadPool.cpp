@@ -0,0 +1,215 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/** The ThreadPool given to each player, which just registers the player with
+    the shared pool rather than creating any threads of its own.
+*/
+struct SharedNodeThreadPool::Client  : public LockFreeMultiThreadedNodePlayer::ThreadPool
+{
+    Client (LockFreeMultiThreadedNodePlayer& p, SharedNodeThreadPool& o, int priorityToUse)
+        : ThreadPool (p), owner (o), priority (priorityToUse)
+    {
+    }
+
+    ~Client() override
+    {
+        clearThreads();
+    }
+
+    void createThreads (size_t numThreads, juce::AudioWorkgroup) override
+    {
+        if (isRegistered && maxNumWorkers == numThreads)
+            return;
+
+        clearThreads();
+
+        if (numThreads == 0)
+            return;
+
+        resetExitSignal();
+        maxNumWorkers = numThreads;
+        owner.addClient (*this);
+        isRegistered = true;
+    }
+
+    void clearThreads() override
+    {
+        if (! isRegistered)
+            return;
+
+        signalShouldExit();
+        owner.removeClient (*this);
+        isRegistered = false;
+
+        // Once removed, no new workers can pick this up but any that already
+        // have need to finish before the player can change its Nodes
+        while (numActiveWorkers.load (std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+    }
+
+    void signalOne() override
+    {
+        owner.signal (1);
+    }
+
+    void signal (int numToSignal) override
+    {
+        owner.signal (std::min (numToSignal, (int) maxNumWorkers));
+    }
+
+    void signalAll() override
+    {
+        owner.signal ((int) maxNumWorkers);
+    }
+
+    void waitForFinalNode() override
+    {
+        if (isFinalNodeReady())
+            return;
+
+        if (! shouldWait())
+            return;
+
+        tracktion::core::pause();
+        tracktion::core::pause();
+    }
+
+    /** Returns true if a worker could process a Node for this player now. */
+    bool canTakeWorker()
+    {
+        return ! shouldExit()
+            && ! shouldWait()
+            && numActiveWorkers.load (std::memory_order_relaxed) < maxNumWorkers;
+    }
+
+    SharedNodeThreadPool& owner;
+    const int priority;
+    size_t maxNumWorkers = 0;
+    std::atomic<size_t> numActiveWorkers { 0 };
+    bool isRegistered = false;
+};
+
+
+//==============================================================================
+SharedNodeThreadPool::SharedNodeThreadPool (size_t numThreads)
+{
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back ([this] { runThread(); });
+        setThreadPriority (threads.back(), 10);
+    }
+}
+
+SharedNodeThreadPool::~SharedNodeThreadPool()
+{
+    // All the players using this pool should have been deleted first
+    jassert (clients.empty());
+
+    threadsShouldExit = true;
+    semaphore.signal ((int) threads.size());
+
+    for (auto& t : threads)
+        t.join();
+}
+
+LockFreeMultiThreadedNodePlayer::ThreadPoolCreator SharedNodeThreadPool::getPoolCreator (int priority)
+{
+    return [this, priority] (LockFreeMultiThreadedNodePlayer& p)
+           {
+               return std::make_unique<Client> (p, *this, priority);
+           };
+}
+
+//==============================================================================
+void SharedNodeThreadPool::addClient (Client& c)
+{
+    const std::scoped_lock sl (clientsMutex);
+
+    // Keep the clients sorted by descending priority so each priority's
+    // clients are next to each other
+    auto insertPos = std::find_if (clients.begin(), clients.end(),
+                                   [&c] (auto other) { return other->priority < c.priority; });
+    clients.insert (insertPos, &c);
+}
+
+void SharedNodeThreadPool::removeClient (Client& c)
+{
+    const std::scoped_lock sl (clientsMutex);
+    clients.erase (std::remove (clients.begin(), clients.end(), &c), clients.end());
+}
+
+SharedNodeThreadPool::Client* SharedNodeThreadPool::takeClientToProcess()
+{
+    const std::scoped_lock sl (clientsMutex);
+    const auto numClients = clients.size();
+
+    for (size_t groupStart = 0; groupStart < numClients;)
+    {
+        auto groupEnd = groupStart + 1;
+
+        while (groupEnd < numClients && clients[groupEnd]->priority == clients[groupStart]->priority)
+            ++groupEnd;
+
+        // Start from a different client each time so the ones with the same priority take turns
+        const auto groupSize = groupEnd - groupStart;
+
+        for (size_t i = 0; i < groupSize; ++i)
+        {
+            auto c = clients[groupStart + (roundRobinIndex + i) % groupSize];
+
+            if (c->canTakeWorker())
+            {
+                ++roundRobinIndex;
+                c->numActiveWorkers.fetch_add (1, std::memory_order_acq_rel);
+                return c;
+            }
+        }
+
+        groupStart = groupEnd;
+    }
+
+    return nullptr;
+}
+
+void SharedNodeThreadPool::signal (int numToSignal)
+{
+    if (numToSignal > 0)
+        semaphore.signal (std::min (numToSignal, (int) threads.size()));
+}
+
+void SharedNodeThreadPool::runThread()
+{
+    tryToUpgradeCurrentThreadToRealtime (juce::Thread::RealtimeOptions().withPriority (10));
+
+    for (;;)
+    {
+        if (threadsShouldExit.load (std::memory_order_acquire))
+            return;
+
+        if (auto c = takeClientToProcess())
+        {
+            while (! c->shouldExit() && c->process())
+            {}
+
+            c->numActiveWorkers.fetch_sub (1, std::memory_order_acq_rel);
+            continue;
+        }
+
+        TRACKTION_GRAPH_TRACE_SCOPE ("SharedNodeThreadPool::wait", "thread_pool", 0)
+        semaphore.wait();
+    }
+}
+
+}}
@@ -0,0 +1,76 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    A fixed set of worker threads that can be shared by any number of
+    LockFreeMultiThreadedNodePlayers.
+
+    Normally each player creates its own threads so running lots of players at
+    once, e.g. when rendering many graphs in parallel, can end up with far more
+    threads than there are cores. Instead, pass the creator returned from
+    getPoolCreator to each player and they'll all be processed by this pool's
+    workers.
+
+    Each player is given a priority when its creator is made. Free workers
+    always pick a player with Nodes ready to process from the highest priority
+    that has any, taking turns between players of the same priority so they
+    all get a fair share. A player will never use more workers at once than
+    the number of threads it asks for with setNumThreads.
+
+    The pool must outlive any players using it.
+*/
+class SharedNodeThreadPool
+{
+public:
+    /** Creates a pool with a number of worker threads. */
+    SharedNodeThreadPool (size_t numThreads);
+
+    /** Destructor.
+        All the players using this should have been deleted before this is.
+    */
+    ~SharedNodeThreadPool();
+
+    /** Returns the number of worker threads. */
+    size_t getNumThreads() const            { return threads.size(); }
+
+    /** Returns a creator to pass to a LockFreeMultiThreadedNodePlayer so it
+        uses this pool's threads.
+        Players with a higher priority are always processed in preference to
+        those with a lower one.
+    */
+    LockFreeMultiThreadedNodePlayer::ThreadPoolCreator getPoolCreator (int priority = 0);
+
+private:
+    //==============================================================================
+    struct Client;
+
+    std::vector<std::thread> threads;
+    LightweightSemaphore semaphore;
+    std::atomic<bool> threadsShouldExit { false };
+
+    std::mutex clientsMutex;
+    std::vector<Client*> clients;
+    size_t roundRobinIndex = 0;
+
+    void addClient (Client&);
+    void removeClient (Client&);
+    Client* takeClientToProcess();
+    void signal (int numToSignal);
+    void runThread();
+};
+
+}}
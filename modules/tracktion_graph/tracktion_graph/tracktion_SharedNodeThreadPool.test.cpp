@@ -0,0 +1,107 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_SHAREDNODETHREADPOOL
+
+using namespace test_utilities;
+
+//==============================================================================
+//==============================================================================
+class SharedNodeThreadPoolTests : public juce::UnitTest
+{
+public:
+    SharedNodeThreadPoolTests()
+        : juce::UnitTest ("SharedNodeThreadPool", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        for (auto setup : getTestSetups (*this))
+        {
+            runPlayerTests (setup, 1, 1);
+            runPlayerTests (setup, 4, 8);
+        }
+    }
+
+private:
+    static std::unique_ptr<Node> createNode()
+    {
+        std::vector<std::unique_ptr<Node>> nodes;
+
+        for (int i = 0; i < 16; ++i)
+            nodes.push_back (makeNode<SinNode> (220.0f));
+
+        return makeNode<BasicSummingNode> (std::move (nodes));
+    }
+
+    static std::shared_ptr<TestContext> render (std::unique_ptr<LockFreeMultiThreadedNodePlayer> player, TestSetup ts, size_t numThreads)
+    {
+        player->setNumThreads (numThreads);
+        player->setNode (createNode(), ts.sampleRate, ts.blockSize);
+
+        return createTestContext (std::move (player), ts, 1, 1.0);
+    }
+
+    void runPlayerTests (TestSetup ts, size_t numPoolThreads, int numPlayers)
+    {
+        beginTest ("Players sharing " + juce::String ((int) numPoolThreads) + " threads: "
+                   + juce::String (numPlayers) + " players");
+
+        // Render a reference on the calling thread only
+        ts.random.setSeed (42);
+        auto expected = render (std::make_unique<LockFreeMultiThreadedNodePlayer>(), ts, 0);
+
+        SharedNodeThreadPool pool (numPoolThreads);
+        expectEquals ((int) pool.getNumThreads(), (int) numPoolThreads);
+
+        // Process the players concurrently, with a mix of priorities
+        std::vector<std::shared_ptr<TestContext>> results ((size_t) numPlayers);
+        std::vector<std::thread> renderThreads;
+
+        for (int i = 0; i < numPlayers; ++i)
+        {
+            auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (pool.getPoolCreator (i % 2));
+            auto playerSetup = ts;
+            playerSetup.random.setSeed (42);
+
+            renderThreads.emplace_back ([&results, i, playerSetup, p = player.release()]() mutable
+                                        {
+                                            results[(size_t) i] = render (std::unique_ptr<LockFreeMultiThreadedNodePlayer> (p), playerSetup, 2);
+                                        });
+        }
+
+        for (auto& t : renderThreads)
+            t.join();
+
+        for (auto& result : results)
+        {
+            expect (result != nullptr);
+            expectEquals (result->buffer.getNumSamples(), expected->buffer.getNumSamples());
+
+            float maxDiff = 0.0f;
+
+            for (int s = 0; s < result->buffer.getNumSamples(); ++s)
+                maxDiff = std::max (maxDiff, std::abs (result->buffer.getSample (0, s) - expected->buffer.getSample (0, s)));
+
+            expectLessOrEqual (maxDiff, 0.0001f);
+        }
+    }
+};
+
+static SharedNodeThreadPoolTests sharedNodeThreadPoolTests;
+
+#endif
+
+}}
@@ -79,9 +79,11 @@ private:
 class MidiNode final    : public Node
 {
 public:
-    MidiNode (juce::MidiMessageSequence sequenceToPlay)
-        : sequence (std::move (sequenceToPlay))
+    MidiNode (const juce::MidiMessageSequence& sequenceToPlay)
+        : events ((size_t) sequenceToPlay.getNumEvents(), getNumSysexBytes (sequenceToPlay))
     {
+        for (auto eventHolder : sequenceToPlay)
+            events.add (eventHolder->message, {});
     }
 
     NodeProperties getNodeProperties() override
@@ -105,29 +107,38 @@ public:
         const double blockDuration = numSamples / sampleRate;
         const auto timeRange = juce::Range<double>::withStartAndLength (lastTime, blockDuration);
 
-        for (int index = sequence.getNextIndexAtTime (timeRange.getStart()); index >= 0; ++index)
-        {
-            if (auto eventHolder = sequence.getEventPointer (index))
-            {
-                auto time = sequence.getEventTime (index);
+        while (nextIndex < events.size() && events[nextIndex].timeStamp < timeRange.getStart())
+            ++nextIndex;
 
-                if (! timeRange.contains (time))
-                    break;
+        for (; nextIndex < events.size(); ++nextIndex)
+        {
+            auto& e = events[nextIndex];
 
-                pc.buffers.midi.addMidiMessage (eventHolder->message, time - timeRange.getStart(), {});
-            }
-            else
-            {
+            if (! timeRange.contains (e.timeStamp))
                 break;
-            }
+
+            pc.buffers.midi.addMidiMessage (juce::MidiMessage (events.getData (e), (int) e.size),
+                                            e.timeStamp - timeRange.getStart(), e.mpeSourceID);
         }
 
         lastTime = timeRange.getEnd();
     }
 
 private:
-    juce::MidiMessageSequence sequence;
+    PackedMidiBuffer events;
+    size_t nextIndex = 0;
     double sampleRate = 0.0, lastTime = 0.0;
+
+    static size_t getNumSysexBytes (const juce::MidiMessageSequence& sequence)
+    {
+        size_t numBytes = 0;
+
+        for (auto eventHolder : sequence)
+            if (auto size = (size_t) eventHolder->message.getRawDataSize(); size > PackedMidiBuffer::maxInlineSize)
+                numBytes += size;
+
+        return numBytes;
+    }
 };
 
 
@@ -205,6 +216,11 @@ public:
         return true;
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void prepareToPlay (const PlaybackInitialisationInfo& info) override
     {
         audioBuffer.resize (choc::buffer::Size::create ((choc::buffer::ChannelCount) numChannels,
@@ -368,6 +384,325 @@ static inline std::unique_ptr<Node> makeGainNode (std::unique_ptr<Node> input, f
     return makeNode<FunctionNode> (std::move (input), [gain] (float s) { return s * gain; });
 }
 
+//==============================================================================
+//==============================================================================
+/**
+    Describes the synthetic load a LoadNode generates.
+    The load is the proportion of each block's duration spent processing. The
+    sequence of loads only depends on the seed so runs can be repeated exactly.
+*/
+struct LoadProfile
+{
+    enum class Shape
+    {
+        constant,       /**< Every block has the mean load. */
+        bursty,         /**< Occasional blocks have a multiple of the mean, the rest are lighter. */
+        heavyTailed     /**< Loads follow a Pareto distribution so there are rare, very long blocks. */
+    };
+
+    Shape shape = Shape::constant;
+    double meanLoad = 0.1;              /**< The average proportion of each block to spend processing. */
+    double burstProbability = 0.05;     /**< For bursty profiles, the chance of each block being a burst. */
+    double burstMultiplier = 8.0;       /**< For bursty profiles, how much bigger than the mean a burst is. */
+    double tailIndex = 2.5;             /**< For heavy-tailed profiles, the Pareto shape. Lower is heavier. */
+    juce::int64 seed = 0;               /**< The seed for the random loads. */
+
+    /** Returns the load for the next block. */
+    double getNextLoad (juce::Random& r) const
+    {
+        switch (shape)
+        {
+            case Shape::bursty:
+            {
+                // Scale the quiet blocks down so the mean stays the same
+                const auto quietLoad = meanLoad * std::max (0.0, 1.0 - burstProbability * burstMultiplier) / (1.0 - burstProbability);
+                return r.nextDouble() < burstProbability ? meanLoad * burstMultiplier : quietLoad;
+            }
+
+            case Shape::heavyTailed:
+            {
+                const auto minLoad = meanLoad * (tailIndex - 1.0) / tailIndex;
+                const auto u = std::max (1.0e-9, 1.0 - r.nextDouble());
+                return std::min (minLoad / std::pow (u, 1.0 / tailIndex), meanLoad * 50.0);
+            }
+
+            case Shape::constant:
+                break;
+        }
+
+        return meanLoad;
+    }
+};
+
+/** Returns a name for a LoadProfile::Shape. */
+static inline juce::String getName (LoadProfile::Shape shape)
+{
+    switch (shape)
+    {
+        case LoadProfile::Shape::constant:      return "constant";
+        case LoadProfile::Shape::bursty:        return "bursty";
+        case LoadProfile::Shape::heavyTailed:   return "heavy-tailed";
+    }
+
+    return {};
+}
+
+//==============================================================================
+/**
+    Passes its input through after busy-waiting for a time determined by a
+    LoadProfile, to simulate an expensive Node such as a plugin.
+*/
+class LoadNode final    : public Node
+{
+public:
+    LoadNode (std::unique_ptr<Node> inputNode, LoadProfile profileToUse, size_t nodeIDToUse)
+        : input (std::move (inputNode)), profile (profileToUse), nodeID (nodeIDToUse)
+    {
+    }
+
+    NodeProperties getNodeProperties() override
+    {
+        auto props = input->getNodeProperties();
+        props.nodeID = nodeID;
+
+        return props;
+    }
+
+    std::vector<Node*> getDirectInputNodes() override
+    {
+        return { input.get() };
+    }
+
+    bool isReadyToProcess() override
+    {
+        return input->hasProcessed();
+    }
+
+    void prepareToPlay (const PlaybackInitialisationInfo& info) override
+    {
+        sampleRate = info.sampleRate;
+        random.setSeed (profile.seed);
+    }
+
+    void process (ProcessContext& pc) override
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        auto inputBuffers = input->getProcessedOutput();
+        copy (pc.buffers.audio, inputBuffers.audio);
+        pc.buffers.midi.copyFrom (inputBuffers.midi);
+
+        const auto blockSeconds = pc.referenceSampleRange.getLength() / sampleRate;
+        const auto ticksToBurn = juce::Time::secondsToHighResolutionTicks (profile.getNextLoad (random) * blockSeconds);
+
+        while (juce::Time::getHighResolutionTicks() - startTicks < ticksToBurn)
+        {}
+    }
+
+private:
+    std::unique_ptr<Node> input;
+    const LoadProfile profile;
+    const size_t nodeID;
+    double sampleRate = 44100.0;
+    juce::Random random;
+};
+
+
+//==============================================================================
+//==============================================================================
+/**
+    A Node with any number of inputs it doesn't own, used to build random graphs.
+    Nodes without inputs output a constant signal, the others sum their inputs.
+    Each Node can add MIDI events and busy-wait for a LoadProfile like a LoadNode.
+    @see createRandomGraph
+*/
+class RandomGraphNode final    : public Node
+{
+public:
+    RandomGraphNode (std::vector<Node*> inputNodes, int numChannelsToUse,
+                     double midiDensityToUse, LoadProfile profileToUse, size_t nodeIDToUse,
+                     std::vector<std::unique_ptr<Node>> nodesToOwn = {})
+        : inputs (std::move (inputNodes)), ownedNodes (std::move (nodesToOwn)),
+          numChannels (numChannelsToUse), midiDensity (midiDensityToUse),
+          profile (profileToUse), nodeID (nodeIDToUse)
+    {
+    }
+
+    NodeProperties getNodeProperties() override
+    {
+        NodeProperties props;
+        props.hasAudio = true;
+        props.hasMidi = midiDensity > 0.0;
+        props.numberOfChannels = numChannels;
+        props.nodeID = nodeID;
+
+        for (auto input : inputs)
+        {
+            auto inputProps = input->getNodeProperties();
+            props.hasMidi = props.hasMidi || inputProps.hasMidi;
+            props.latencyNumSamples = std::max (props.latencyNumSamples, inputProps.latencyNumSamples);
+        }
+
+        return props;
+    }
+
+    std::vector<Node*> getDirectInputNodes() override
+    {
+        return inputs;
+    }
+
+    bool isReadyToProcess() override
+    {
+        for (auto input : inputs)
+            if (! input->hasProcessed())
+                return false;
+
+        return true;
+    }
+
+    void prepareToPlay (const PlaybackInitialisationInfo& info) override
+    {
+        sampleRate = info.sampleRate;
+        random.setSeed (profile.seed);
+    }
+
+    void process (ProcessContext& pc) override
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const auto numSamples = (int) pc.referenceSampleRange.getLength();
+
+        if (inputs.empty())
+            setAllFrames (pc.buffers.audio, [] { return 0.01f; });
+
+        for (auto input : inputs)
+        {
+            auto inputBuffers = input->getProcessedOutput();
+
+            if (auto numChannelsToAdd = std::min (inputBuffers.audio.getNumChannels(), pc.buffers.audio.getNumChannels()))
+                add (pc.buffers.audio.getFirstChannels (numChannelsToAdd),
+                     inputBuffers.audio.getFirstChannels (numChannelsToAdd));
+
+            pc.buffers.midi.mergeFrom (inputBuffers.midi);
+        }
+
+        if (midiDensity > 0.0 && random.nextDouble() < midiDensity)
+            pc.buffers.midi.addMidiMessage (juce::MidiMessage::noteOn (1, random.nextInt (128), 0.5f),
+                                            random.nextDouble() * numSamples / sampleRate, {});
+
+        if (profile.meanLoad > 0.0)
+        {
+            const auto ticksToBurn = juce::Time::secondsToHighResolutionTicks (profile.getNextLoad (random) * numSamples / sampleRate);
+
+            while (juce::Time::getHighResolutionTicks() - startTicks < ticksToBurn)
+            {}
+        }
+    }
+
+private:
+    const std::vector<Node*> inputs;
+    const std::vector<std::unique_ptr<Node>> ownedNodes;
+    const int numChannels;
+    const double midiDensity;
+    const LoadProfile profile;
+    const size_t nodeID;
+    double sampleRate = 44100.0;
+    juce::Random random;
+};
+
+/** Describes the shape of a graph made by createRandomGraph. */
+struct RandomGraphOptions
+{
+    int numNodes = 1000;                /**< The number of RandomGraphNodes, not including any LatencyNodes or the root. */
+    int width = 32;                     /**< The number of Nodes in each layer, the depth is numNodes / width. */
+    int minFanIn = 1;                   /**< The fewest inputs a Node outside the first layer has. */
+    int maxFanIn = 4;                   /**< The most inputs a Node has. */
+    int maxFanOut = 4;                  /**< The most Nodes that can use a Node as an input, other than the root. */
+    int maxLayerSkip = 2;               /**< How many layers back inputs can be taken from. */
+    int numChannels = 2;                /**< The number of audio channels each Node has. */
+    double latencyProbability = 0.05;   /**< The chance of a Node's output passing through a LatencyNode. */
+    int maxLatencyNumSamples = 1024;    /**< The most latency a LatencyNode adds, the amounts are uniformly distributed. */
+    double midiDensity = 0.1;           /**< The chance of each Node adding a MIDI event each block. */
+    LoadProfile load { LoadProfile::Shape::constant, 0.0 };  /**< The synthetic cost of each Node, the seed is offset for each one. */
+    juce::int64 seed = 0;               /**< The seed for the structure. */
+};
+
+/** Creates a random layered graph from some RandomGraphOptions.
+    The same options always create the same graph. Every Node that isn't used as
+    an input is summed by the returned root, which owns all the other Nodes.
+    Latency between branches isn't compensated, as these graphs are for
+    measuring scheduling rather than the output.
+*/
+static inline std::unique_ptr<Node> createRandomGraph (const RandomGraphOptions& options)
+{
+    juce::Random random (options.seed);
+    std::vector<std::unique_ptr<Node>> ownedNodes;
+    std::vector<std::vector<Node*>> layers;
+    std::unordered_map<Node*, int> numOutputs;
+
+    const auto width = std::max (1, options.width);
+    const auto numNodes = std::max (1, options.numNodes);
+
+    for (int i = 0; i < numNodes; ++i)
+    {
+        const auto layerIndex = i / width;
+
+        if ((size_t) layerIndex == layers.size())
+            layers.emplace_back();
+
+        std::vector<Node*> inputs;
+
+        if (layerIndex > 0)
+        {
+            // Candidates are any Nodes in the previous few layers that can take another output
+            std::vector<Node*> candidates;
+            const auto firstLayer = std::max (0, layerIndex - std::max (1, options.maxLayerSkip));
+
+            for (int l = firstLayer; l < layerIndex; ++l)
+                for (auto n : layers[(size_t) l])
+                    if (numOutputs[n] < options.maxFanOut)
+                        candidates.push_back (n);
+
+            const auto maxFanIn = std::max (1, options.maxFanIn);
+            const auto minFanIn = std::clamp (options.minFanIn, 1, maxFanIn);
+            const auto numInputs = std::min ((int) candidates.size(), minFanIn + random.nextInt (maxFanIn - minFanIn + 1));
+
+            for (int j = 0; j < numInputs; ++j)
+            {
+                const auto index = (size_t) random.nextInt ((int) candidates.size());
+                inputs.push_back (candidates[index]);
+                ++numOutputs[candidates[index]];
+                candidates.erase (candidates.begin() + (std::ptrdiff_t) index);
+            }
+        }
+
+        auto load = options.load;
+        load.seed = options.load.seed + i;
+
+        ownedNodes.push_back (std::make_unique<RandomGraphNode> (std::move (inputs), options.numChannels,
+                                                                 options.midiDensity, load, (size_t) i + 1));
+        Node* output = ownedNodes.back().get();
+
+        if (random.nextDouble() < options.latencyProbability)
+        {
+            ownedNodes.push_back (std::make_unique<LatencyNode> (output, 1 + random.nextInt (std::max (1, options.maxLatencyNumSamples))));
+            output = ownedNodes.back().get();
+        }
+
+        layers.back().push_back (output);
+    }
+
+    std::vector<Node*> sinks;
+
+    for (auto& layer : layers)
+        for (auto n : layer)
+            if (numOutputs[n] == 0)
+                sinks.push_back (n);
+
+    return std::make_unique<RandomGraphNode> (std::move (sinks), options.numChannels, 0.0,
+                                              LoadProfile { LoadProfile::Shape::constant, 0.0 },
+                                              (size_t) numNodes + 1, std::move (ownedNodes));
+}
+
+
 //==============================================================================
 //==============================================================================
 class GainNode final : public Node
@@ -418,16 +753,30 @@ public:
         return input->hasProcessed();
     }
 
-    void process (ProcessContext& pc) override
+    bool canProcessSplitTimelineRanges() override
     {
-        jassert (pc.buffers.audio.getNumChannels() == input->getProcessedOutput().audio.getNumChannels());
+        return true;
+    }
 
-        // Just pass out input on to our output
-        copy (pc.buffers.audio, input->getProcessedOutput().audio);
-        pc.buffers.midi.mergeFrom (input->getProcessedOutput().midi);
+    void process (ProcessContext& pc) override
+    {
+        auto inputBuffers = input->getProcessedOutput();
+        jassert (pc.buffers.audio.getNumChannels() == inputBuffers.audio.getNumChannels());
 
+        pc.buffers.midi.mergeFrom (inputBuffers.midi);
         float gain = gainFunction();
 
+        // The output has already been cleared so silence, or a gain that stays at zero, needs no processing
+        if (inputBuffers.isAudioSilent || (gain == 0.0f && lastGain == 0.0f))
+        {
+            pc.buffers.isAudioSilent = true;
+            lastGain = gain;
+            return;
+        }
+
+        // Just pass out input on to our output
+        copy (pc.buffers.audio, inputBuffers.audio);
+
         if (gain == lastGain)
         {
             if (gain == 0.0f)
@@ -507,6 +856,11 @@ public:
         return input->hasProcessed();
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void process (ProcessContext& pc) override
     {
         auto source = input->getProcessedOutput();
@@ -515,6 +869,7 @@ public:
         // Just pass out input on to our output
         // N.B We need to clear manually here due to optimisations
         setAudioOutput (input.get(), source.audio);
+        pc.buffers.isAudioSilent = source.isAudioSilent;
 
         // If the source only outputs to this node, we can steal its data
         if (input->numOutputNodes == 1)
@@ -531,6 +886,185 @@ private:
 };
 
 
+//==============================================================================
+//==============================================================================
+/**
+    Sums the outputs of a number of SendNodes, applying each of their gains as
+    it goes. This is used by ReturnNodes in place of a GainNode per send so no
+    intermediate buffers are needed: sends with a constant gain are multiplied
+    in to the sum directly and those at unity are summed in a single pass with
+    the summing kernels.
+    Sends with less latency than the others are delayed with a LatencyNode.
+*/
+class SendBusNode final  : public Node
+{
+public:
+    SendBusNode (std::vector<SendNode*> sendsToSum, size_t nodeHashToUse)
+        : nodeHash (nodeHashToUse)
+    {
+        for (auto send : sendsToSum)
+        {
+            assert (send != nullptr);
+            auto gainFunction = send->getGainFunction();
+            const auto initialGain = gainFunction ? gainFunction() : 1.0f;
+            sends.push_back ({ send, std::move (gainFunction), initialGain });
+        }
+    }
+
+    NodeProperties getNodeProperties() override
+    {
+        NodeProperties props;
+        props.hasAudio = false;
+        props.hasMidi = false;
+        props.numberOfChannels = 0;
+
+        for (auto& send : sends)
+        {
+            auto nodeProps = send.node->getNodeProperties();
+            props.hasAudio = props.hasAudio || nodeProps.hasAudio;
+            props.hasMidi = props.hasMidi || nodeProps.hasMidi;
+            props.numberOfChannels = std::max (props.numberOfChannels, nodeProps.numberOfChannels);
+            props.latencyNumSamples = std::max (props.latencyNumSamples, nodeProps.latencyNumSamples);
+
+            if (props.nodeID != 0 || nodeProps.nodeID != 0)
+                hash_combine (props.nodeID, nodeProps.nodeID);
+        }
+
+        constexpr size_t sendBusNodeMagicHash = size_t (0x73656e64427573);
+
+        if (props.nodeID != 0)
+        {
+            hash_combine (props.nodeID, nodeHash);
+            hash_combine (props.nodeID, sendBusNodeMagicHash);
+        }
+
+        return props;
+    }
+
+    std::vector<Node*> getDirectInputNodes() override
+    {
+        std::vector<Node*> inputs;
+
+        for (auto& send : sends)
+            inputs.push_back (send.node);
+
+        return inputs;
+    }
+
+    TransformResult transform (TransformOptions& options) override
+    {
+        if (hasCreatedLatencyNodes || options.disableLatencyCompensation)
+            return TransformResult::none;
+
+        hasCreatedLatencyNodes = true;
+        const auto maxLatency = getNodeProperties().latencyNumSamples;
+        bool topologyChanged = false;
+
+        // Each send keeps its own delay so its gain can still be applied whilst summing
+        for (auto& send : sends)
+        {
+            const auto latencyToAdd = subtractNoWrap (maxLatency, send.node->getNodeProperties().latencyNumSamples);
+
+            if (latencyToAdd <= 0)
+                continue;
+
+            auto& latencyNode = latencyNodes.emplace_back (makeNode<LatencyNode> (send.node, latencyToAdd));
+            send.node = latencyNode.get();
+            topologyChanged = true;
+        }
+
+        return topologyChanged ? TransformResult::connectionsMade
+                               : TransformResult::none;
+    }
+
+    void prepareToPlay (const PlaybackInitialisationInfo&) override
+    {
+        unityGainSources.resize (sends.size());
+    }
+
+    bool isReadyToProcess() override
+    {
+        for (auto& send : sends)
+            if (! send.node->hasProcessed())
+                return false;
+
+        return true;
+    }
+
+    void process (ProcessContext& pc) override
+    {
+        const auto numChannels = pc.buffers.audio.getNumChannels();
+        const auto numFrames = pc.buffers.audio.getNumFrames();
+
+        for (auto& send : sends)
+        {
+            pc.buffers.midi.mergeFrom (send.node->getProcessedOutput().midi);
+            send.lastGain = std::exchange (send.gain, send.gainFunction ? send.gainFunction() : 1.0f);
+        }
+
+        pc.buffers.midi.sortByTimestamp();
+        bool hasAddedAudio = false;
+
+        for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
+        {
+            auto dest = pc.buffers.audio.getChannel (channel).data.data;
+            size_t numUnityGainSources = 0;
+
+            for (auto& send : sends)
+            {
+                auto inputBuffers = send.node->getProcessedOutput();
+                auto inputAudio = inputBuffers.audio;
+
+                if (channel >= inputAudio.getNumChannels() || inputBuffers.isAudioSilent)
+                    continue;
+
+                hasAddedAudio = true;
+
+                assert (inputAudio.getNumFrames() == numFrames);
+                auto src = inputAudio.getChannel (channel).data.data;
+
+                if (send.gain != send.lastGain)
+                {
+                    // Ramp between the gains to avoid zipper noise
+                    const auto delta = (send.gain - send.lastGain) / (float) numFrames;
+
+                    for (choc::buffer::FrameCount i = 0; i < numFrames; ++i)
+                        dest[i] += src[i] * (send.lastGain + delta * (float) i);
+                }
+                else if (send.gain == 1.0f)
+                {
+                    unityGainSources[numUnityGainSources++] = src;
+                }
+                else if (send.gain != 0.0f)
+                {
+                    juce::FloatVectorOperations::addWithMultiply (dest, src, send.gain, (int) numFrames);
+                }
+            }
+
+            if (numUnityGainSources > 0)
+                summing_kernels::addMultiple (dest, unityGainSources.data(), numUnityGainSources, numFrames);
+        }
+
+        // The output is cleared before processing so if no sends had any audio it's still silent
+        pc.buffers.isAudioSilent = ! hasAddedAudio;
+    }
+
+private:
+    struct Send
+    {
+        Node* node = nullptr;
+        std::function<float()> gainFunction;
+        float gain = 1.0f, lastGain = 1.0f;
+    };
+
+    std::vector<Send> sends;
+    std::vector<std::unique_ptr<Node>> latencyNodes;
+    std::vector<const float*> unityGainSources;
+    const size_t nodeHash;
+    bool hasCreatedLatencyNodes = false;
+};
+
+
 //==============================================================================
 //==============================================================================
 class ReturnNode final  : public Node
@@ -626,6 +1160,11 @@ public:
         return ! input || input->hasProcessed();
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void preProcess (choc::buffer::FrameCount, juce::Range<int64_t>) override
     {
         if (canUseSourceBuffers)
@@ -639,6 +1178,7 @@ public:
             // N.B We need to clear manually here due to optimisations
             pc.buffers.midi.clear();
             pc.buffers.audio.clear();
+            pc.buffers.isAudioSilent = true;
 
             return;
         }
@@ -649,6 +1189,7 @@ public:
         // Copy the input on to our output, the SummingNode will copy all the sends and get all the input
         setAudioOutput (input.get(), source.audio);
         pc.buffers.midi.copyFrom (source.midi);
+        pc.buffers.isAudioSilent = source.isAudioSilent;
     }
 
 private:
@@ -705,36 +1246,29 @@ private:
                                      [&] (auto n) { return std::find (sendsToRemove.begin(), sendsToRemove.end(), n) != sendsToRemove.end(); }),
                      sends.end());
 
-        // Create a summing node if required
+        // Sum the sends, with their gains, in to a single bus
         if (sends.size() > 0)
         {
             const auto returnNodeID = getNodeProperties().nodeID;
-            std::vector<std::unique_ptr<Node>> ownedNodes;
-
-            if (input)
-                ownedNodes.push_back (std::move (input));
-
-            // For each of the sends create a live gain node
-            for (int i = (int) sends.size(); --i >= 0;)
-            {
-                auto gainFunction = sends[(size_t) i]->getGainFunction();
-
-                if (! gainFunction)
-                    continue;
 
-                ownedNodes.push_back (makeNode<GainNode> (std::move (sends[(size_t) i]), std::move (gainFunction), returnNodeID));
-				sends.erase (std::find (sends.begin(), sends.end(), sends[(size_t) i]));
-			}
-
-            if (ownedNodes.empty() && sends.size() == 1)
+            if (! input && sends.size() == 1 && ! sends[0]->getGainFunction())
             {
                 auto node = makeNode<ForwardingNode> (sends[0], returnNodeID);
                 input.swap (node);
             }
             else
             {
-                auto node = makeNode<SummingNode> (std::move (ownedNodes), std::vector<Node*> (sends.begin(), sends.end()));
-                input.swap (node);
+                std::unique_ptr<Node> busNode = makeNode<SendBusNode> (sends, returnNodeID);
+
+                if (input)
+                {
+                    std::vector<std::unique_ptr<Node>> ownedNodes;
+                    ownedNodes.push_back (std::move (input));
+                    ownedNodes.push_back (std::move (busNode));
+                    busNode = makeNode<SummingNode> (std::move (ownedNodes));
+                }
+
+                input.swap (busNode);
             }
         }
 
@@ -799,6 +1333,11 @@ public:
         return input->hasProcessed();
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void process (ProcessContext& pc) override
     {
         auto inputBuffers = input->getProcessedOutput();
@@ -807,6 +1346,13 @@ public:
         if (passMIDI)
             pc.buffers.midi.mergeFrom (inputBuffers.midi);
 
+        // The output is cleared so a silent input can be left as it is
+        if (inputBuffers.isAudioSilent)
+        {
+            pc.buffers.isAudioSilent = true;
+            return;
+        }
+
         // Remap audio
         for (auto channel : channelMap)
             if (channel.first < (int) inputBuffers.audio.getNumChannels())
@@ -863,6 +1409,11 @@ public:
         return input->hasProcessed();
     }
 
+    bool canProcessSplitTimelineRanges() override
+    {
+        return true;
+    }
+
     void process (ProcessContext&) override
     {
     }
@@ -223,6 +223,7 @@ namespace test_utilities
             case ThreadPoolStrategy::semaphore:             return "semaphore";
             case ThreadPoolStrategy::lightweightSemaphore:  return "lightweightSemaphore";
             case ThreadPoolStrategy::lightweightSemHybrid:  return "lightweightSemaphoreHybrid";
+            case ThreadPoolStrategy::workStealing:          return "workStealing";
         }
 
         jassertfalse;
@@ -231,7 +232,8 @@ namespace test_utilities
 
     inline std::vector<ThreadPoolStrategy> getThreadPoolStrategies()
     {
-        return { ThreadPoolStrategy::lightweightSemHybrid,
+        return { ThreadPoolStrategy::workStealing,
+                 ThreadPoolStrategy::lightweightSemHybrid,
                  ThreadPoolStrategy::lightweightSemaphore,
                  ThreadPoolStrategy::semaphore,
                  ThreadPoolStrategy::conditionVariable,
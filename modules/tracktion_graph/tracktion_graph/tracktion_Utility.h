@@ -78,22 +78,20 @@ NodeType* findNode (NodeGraph& nodeGraph, Predicate pred)
 }
 
 /** Attempts to find a Node of a given type with a specified ID.
-    This uses the sortedNodes vector so should be relatively quick (much quicker
-    than traversing from the root node.
+    This binary searches the sortedNodes vector so is O(log n) in the number of
+    Nodes, rather than traversing from the root node.
 */
 template<typename NodeType>
 NodeType* findNodeWithID (NodeGraph& nodeGraph, size_t nodeIDToLookFor)
 {
-    auto found = std::find_if (nodeGraph.sortedNodes.begin(),
-                               nodeGraph.sortedNodes.end(),
-                               [nodeIDToLookFor] (auto nodeAndID)
-                               {
-                                   return nodeAndID.id == nodeIDToLookFor
-                                       && dynamic_cast<NodeType*> (nodeAndID.node) != nullptr;
-                               });
-
-    if (found != nodeGraph.sortedNodes.end())
-        return dynamic_cast<NodeType*> (found->node);
+    // sortedNodes is sorted by ID so we only need to check the type of Nodes with a matching ID
+    const auto matchingIDs = std::equal_range (nodeGraph.sortedNodes.begin(),
+                                               nodeGraph.sortedNodes.end(),
+                                               NodeAndID { nullptr, nodeIDToLookFor });
+
+    for (auto iter = matchingIDs.first; iter != matchingIDs.second; ++iter)
+        if (auto foundType = dynamic_cast<NodeType*> (iter->node))
+            return foundType;
 
     return nullptr;
 }
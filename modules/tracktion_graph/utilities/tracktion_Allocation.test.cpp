@@ -26,6 +26,7 @@ public:
     void runTest() override
     {
         runRPMallocTests();
+        runNodeAllocationArenaTests();
     }
 
 private:
@@ -218,6 +219,55 @@ private:
             expect (true);
         }
     }
+
+    void runNodeAllocationArenaTests()
+    {
+        beginTest ("Node allocation arena");
+        {
+            NodeAllocationArena::Ptr arena (new NodeAllocationArena (1024));
+            std::vector<std::unique_ptr<Node>> nodes;
+
+            {
+                const NodeAllocationArena::ScopedUse scopedArena (arena.get());
+                expect (NodeAllocationArena::getCurrent() == arena.get());
+
+                for (int i = 0; i < 100; ++i)
+                    nodes.push_back (makeNode<SinNode> (220.0f));
+            }
+
+            expect (NodeAllocationArena::getCurrent() == nullptr);
+            expect (arena->getNumBytesAllocated() >= nodes.size() * sizeof (SinNode));
+            expectEquals (arena->getReferenceCount(), 101);
+
+            // Nodes created outside the scope use the heap
+            auto heapNode = makeNode<SinNode> (220.0f);
+            expectEquals (arena->getReferenceCount(), 101);
+
+            // Nodes can be deleted on any thread
+            std::thread ([&nodes] { nodes.erase (nodes.begin(), nodes.begin() + 50); }).join();
+            expectEquals (arena->getReferenceCount(), 51);
+
+            nodes.clear();
+            expectEquals (arena->getReferenceCount(), 1);
+        }
+
+        beginTest ("Node allocation arena outlives its owner");
+        {
+            std::unique_ptr<Node> node;
+
+            {
+                NodeAllocationArena::Ptr arena (new NodeAllocationArena());
+                const NodeAllocationArena::ScopedUse scopedArena (arena.get());
+                node = makeNode<SinNode> (440.0f, 2);
+            }
+
+            // The arena is freed along with the last Node
+            auto sinNode = dynamic_cast<SinNode*> (node.get());
+            expect (sinNode != nullptr);
+            expectEquals (sinNode->getNodeProperties().numberOfChannels, 2);
+            node.reset();
+        }
+    }
 };
 
 static AllocationTests allocationTests;
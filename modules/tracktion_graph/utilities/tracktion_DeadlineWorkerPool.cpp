@@ -0,0 +1,130 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+DeadlineWorkerPool::DeadlineWorkerPool (int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto& worker = *workers.emplace_back (std::make_unique<Worker>());
+        worker.thread = std::thread ([this, &worker] { process (worker); });
+    }
+}
+
+DeadlineWorkerPool::~DeadlineWorkerPool()
+{
+    waitingToExitFlag.test_and_set();
+
+    for (auto& worker : workers)
+        worker->event.signal();
+
+    for (auto& worker : workers)
+        worker->thread.join();
+}
+
+int DeadlineWorkerPool::getDefaultNumWorkers()
+{
+    return std::clamp (juce::SystemStats::getNumCpus() - 1, 1, 16);
+}
+
+//==============================================================================
+void DeadlineWorkerPool::addClient (Client& client)
+{
+    ++numPendingAddOrRemoves;
+
+    const std::unique_lock sl (clientsMutex);
+    client.hasBeenFlagged.store (false, std::memory_order_release);
+
+    if (std::find (clients.begin(), clients.end(), &client) == clients.end())
+        clients.push_back (&client);
+
+    --numPendingAddOrRemoves;
+}
+
+void DeadlineWorkerPool::removeClient (Client& client)
+{
+    ++numPendingAddOrRemoves;
+
+    const std::unique_lock sl (clientsMutex);
+    std::erase (clients, &client);
+
+    --numPendingAddOrRemoves;
+}
+
+void DeadlineWorkerPool::flagForProcessing (Client& client)
+{
+    client.hasBeenFlagged.store (true, std::memory_order_release);
+
+    if (workers.empty())
+        return;
+
+    // Wake the workers in turn so the load is spread between them
+    const auto index = nextWorkerToSignal.fetch_add (1, std::memory_order_relaxed) % workers.size();
+    workers[index]->event.signal();
+}
+
+//==============================================================================
+bool DeadlineWorkerPool::processNextPass()
+{
+    std::vector<std::pair<double, Client*>> candidates;
+    return processNextPass (candidates);
+}
+
+bool DeadlineWorkerPool::processNextPass (std::vector<std::pair<double, Client*>>& candidates)
+{
+    const std::shared_lock sl (clientsMutex);
+
+    // Process the flagged clients that will run out soonest first
+    candidates.clear();
+
+    for (auto client : clients)
+        if (client->hasBeenFlagged.load (std::memory_order_acquire))
+            if (auto secondsUntilDeadline = client->getSecondsUntilDeadline())
+                candidates.emplace_back (*secondsUntilDeadline, client);
+
+    std::stable_sort (candidates.begin(), candidates.end(),
+                      [] (auto& a, auto& b) { return a.first < b.first; });
+
+    bool anyWorkDone = false;
+
+    for (auto& candidate : candidates)
+    {
+        if (waitingToExitFlag.test (std::memory_order_acquire))
+            return false;
+
+        // Release the lock so the clients can be updated, then run again
+        if (numPendingAddOrRemoves.load (std::memory_order_acquire) > 0)
+            return true;
+
+        // This will skip clients another worker is already processing
+        if (candidate.second->processNextChunk())
+            anyWorkDone = true;
+    }
+
+    return anyWorkDone;
+}
+
+void DeadlineWorkerPool::process (Worker& worker)
+{
+    std::vector<std::pair<double, Client*>> candidates;
+
+    for (;;)
+    {
+        if (waitingToExitFlag.test (std::memory_order_acquire))
+            return;
+
+        if (! processNextPass (candidates))
+            worker.event.wait (-1);
+    }
+}
+
+}} // namespace tracktion
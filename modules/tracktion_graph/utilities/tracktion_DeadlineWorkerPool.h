@@ -0,0 +1,111 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A pool of background threads that process work for a number of clients ahead
+    of when a real-time thread will need it, e.g. time-stretching or rendering
+    audio a few blocks in advance.
+
+    Each pass, the workers process the flagged clients that will run out of
+    processed data soonest first. Use it through a juce::SharedResourcePointer so
+    every client in the process shares the same threads.
+*/
+class DeadlineWorkerPool
+{
+public:
+    //==============================================================================
+    /** Something that has work processed on the pool's threads. */
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        /** Returns the number of seconds until this client's processed data will run
+            out, or an empty optional if it doesn't need processing at the moment.
+            This is called on the worker threads.
+        */
+        virtual std::optional<double> getSecondsUntilDeadline() = 0;
+
+        /** Processes the next chunk of work. If another thread is already processing
+            this client, this should return false straight away rather than wait.
+            @returns true if any work was done
+        */
+        virtual bool processNextChunk() = 0;
+
+    private:
+        friend class DeadlineWorkerPool;
+        std::atomic<bool> hasBeenFlagged { false };
+    };
+
+    //==============================================================================
+    /** Creates a pool with a number of worker threads.
+        With no workers, the clients are only processed by calling processNextPass.
+    */
+    DeadlineWorkerPool (int numWorkers = getDefaultNumWorkers());
+
+    /** Destructor. Stops and joins the workers. */
+    ~DeadlineWorkerPool();
+
+    /** Returns the number of workers used by default, one per core but leaving one
+        free for the audio thread.
+    */
+    static int getDefaultNumWorkers();
+
+    /** Returns the number of worker threads. */
+    size_t getNumWorkers() const noexcept           { return workers.size(); }
+
+    //==============================================================================
+    /** Adds a client. It won't be processed until flagForProcessing is called for it. */
+    void addClient (Client&);
+
+    /** Removes a client. Once this returns, none of the workers can be processing it. */
+    void removeClient (Client&);
+
+    /** Marks a client as ready to be processed and wakes one of the workers.
+        This doesn't allocate or block so can be called from the audio thread.
+    */
+    void flagForProcessing (Client&);
+
+    /** Processes each flagged client that needs it once, earliest deadline first.
+        The workers call this in a loop but it can also be called from another thread.
+        @returns true if any work was done
+    */
+    bool processNextPass();
+
+private:
+    //==============================================================================
+    struct Worker
+    {
+        std::thread thread;
+        juce::WaitableEvent event;
+    };
+
+    std::vector<Client*> clients;
+    std::shared_mutex clientsMutex;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> nextWorkerToSignal { 0 };
+    std::atomic_flag waitingToExitFlag = ATOMIC_FLAG_INIT;
+    std::atomic<int> numPendingAddOrRemoves { 0 };
+
+    //==============================================================================
+    bool processNextPass (std::vector<std::pair<double, Client*>>&);
+    void process (Worker&);
+
+    JUCE_DECLARE_NON_COPYABLE (DeadlineWorkerPool)
+};
+
+}} // namespace tracktion
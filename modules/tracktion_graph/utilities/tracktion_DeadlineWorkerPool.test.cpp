@@ -0,0 +1,151 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_DEADLINEWORKERPOOL
+
+//==============================================================================
+//==============================================================================
+class DeadlineWorkerPoolTests  : public juce::UnitTest
+{
+public:
+    DeadlineWorkerPoolTests()
+        : juce::UnitTest ("DeadlineWorkerPool", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        beginTest ("Clients are processed earliest deadline first");
+        {
+            DeadlineWorkerPool pool (0);
+            expectEquals ((int) pool.getNumWorkers(), 0);
+
+            std::vector<double> processedDeadlines;
+            TestClient client3 (3.0, processedDeadlines), client1 (1.0, processedDeadlines), client2 (2.0, processedDeadlines);
+
+            for (auto client : { &client3, &client1, &client2 })
+            {
+                pool.addClient (*client);
+                pool.flagForProcessing (*client);
+            }
+
+            expect (pool.processNextPass());
+            expect (processedDeadlines == std::vector<double> { 1.0, 2.0, 3.0 });
+
+            for (auto client : { &client3, &client1, &client2 })
+                pool.removeClient (*client);
+        }
+
+        beginTest ("Only flagged clients with a deadline are processed");
+        {
+            DeadlineWorkerPool pool (0);
+            std::vector<double> processedDeadlines;
+            TestClient flagged (2.0, processedDeadlines), unflagged (1.0, processedDeadlines), noDeadline ({}, processedDeadlines);
+
+            for (auto client : { &flagged, &unflagged, &noDeadline })
+                pool.addClient (*client);
+
+            pool.flagForProcessing (flagged);
+            pool.flagForProcessing (noDeadline);
+
+            expect (pool.processNextPass());
+            expect (processedDeadlines == std::vector<double> { 2.0 });
+
+            // Removed clients are never processed
+            pool.removeClient (flagged);
+            processedDeadlines.clear();
+            expect (! pool.processNextPass());
+            expect (processedDeadlines.empty());
+
+            pool.removeClient (unflagged);
+            pool.removeClient (noDeadline);
+        }
+
+        beginTest ("Workers process flagged clients");
+        {
+            DeadlineWorkerPool pool (2);
+            expectEquals ((int) pool.getNumWorkers(), 2);
+
+            CountingClient client (100);
+            pool.addClient (client);
+            pool.flagForProcessing (client);
+
+            for (int i = 0; i < 1000 && client.numChunksLeft > 0; ++i)
+                std::this_thread::sleep_for (std::chrono::milliseconds (5));
+
+            expectEquals (client.numChunksLeft.load(), 0);
+            pool.removeClient (client);
+        }
+    }
+
+private:
+    /** Records its deadline when it's processed. */
+    struct TestClient  : public DeadlineWorkerPool::Client
+    {
+        TestClient (std::optional<double> deadline, std::vector<double>& processedDeadlinesToUse)
+            : secondsUntilDeadline (deadline), processedDeadlines (processedDeadlinesToUse)
+        {
+        }
+
+        std::optional<double> getSecondsUntilDeadline() override
+        {
+            return secondsUntilDeadline;
+        }
+
+        bool processNextChunk() override
+        {
+            processedDeadlines.push_back (*secondsUntilDeadline);
+            return true;
+        }
+
+        const std::optional<double> secondsUntilDeadline;
+        std::vector<double>& processedDeadlines;
+    };
+
+    /** Needs a number of chunks processing, one at a time. */
+    struct CountingClient  : public DeadlineWorkerPool::Client
+    {
+        CountingClient (int numChunks)
+            : numChunksLeft (numChunks)
+        {
+        }
+
+        std::optional<double> getSecondsUntilDeadline() override
+        {
+            if (numChunksLeft > 0)
+                return 0.0;
+
+            return {};
+        }
+
+        bool processNextChunk() override
+        {
+            const std::unique_lock sl (mutex, std::try_to_lock);
+
+            if (! sl.owns_lock() || numChunksLeft == 0)
+                return false;
+
+            --numChunksLeft;
+            return true;
+        }
+
+        std::atomic<int> numChunksLeft;
+        std::mutex mutex;
+    };
+};
+
+static DeadlineWorkerPoolTests deadlineWorkerPoolTests;
+
+#endif
+
+}} // namespace tracktion
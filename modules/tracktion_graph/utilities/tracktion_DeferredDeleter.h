@@ -0,0 +1,175 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    Deletes objects on a background thread so their destructors never run on
+    the thread that retired them.
+
+    Objects are retired by pushing them on to a lock-free queue which is emptied
+    in batches by the background thread. Retiring a std::unique_ptr doesn't lock
+    or allocate so is safe on the audio thread, any other object is moved in to
+    a heap allocation first so should be retired from a non-real-time thread.
+
+    This is intended for things that can take a long time to tear down, like
+    old graphs and the plugins they hold. Call flush before destroying anything
+    the retired objects refer to.
+*/
+class DeferredDeleter
+{
+public:
+    /** Creates a DeferredDeleter and starts its thread.
+        @param capacity The number of objects that can be waiting to be deleted.
+                        If more than this are retired, they're deleted on the
+                        thread retiring them.
+    */
+    DeferredDeleter (size_t capacity = 4096)
+        : queue (capacity)
+    {
+        thread = std::thread ([this] { run(); });
+    }
+
+    /** Stops the thread and deletes anything still waiting. */
+    ~DeferredDeleter()
+    {
+        {
+            const std::scoped_lock sl (mutex);
+            threadShouldExit = true;
+        }
+
+        threadCondition.notify_all();
+        thread.join();
+        deleteRetiredObjects();
+    }
+
+    //==============================================================================
+    /** Queues an object to be destroyed on the background thread. */
+    template<typename ObjectType>
+    void retire (ObjectType&& object)
+    {
+        using Type = std::decay_t<ObjectType>;
+
+        if constexpr (IsUniquePtr<Type>::value)
+        {
+            if (object == nullptr)
+                return;
+
+            using PointeeType = typename Type::element_type;
+            RetiredObject retired { object.get(), [] (void* o) { delete static_cast<PointeeType*> (o); } };
+
+            if (queue.try_push (retired))
+            {
+                object.release();
+                numRetired.fetch_add (1, std::memory_order_release);
+            }
+            else
+            {
+                // The queue is full so this will be deleted here
+                jassertfalse;
+                object.reset();
+            }
+        }
+        else
+        {
+            retire (std::make_unique<Type> (std::forward<ObjectType> (object)));
+        }
+    }
+
+    /** Blocks until everything retired before this call has been deleted. */
+    void flush()
+    {
+        if (std::this_thread::get_id() == thread.get_id())
+        {
+            deleteRetiredObjects();
+            return;
+        }
+
+        const auto target = numRetired.load (std::memory_order_acquire);
+        std::unique_lock lock (mutex);
+
+        if (numDeleted >= target)
+            return;
+
+        flushRequested = true;
+        threadCondition.notify_all();
+        flushCondition.wait (lock, [this, target] { return numDeleted >= target; });
+    }
+
+private:
+    //==============================================================================
+    template<typename Type> struct IsUniquePtr : std::false_type {};
+    template<typename Type> struct IsUniquePtr<std::unique_ptr<Type>> : std::true_type {};
+
+    struct RetiredObject
+    {
+        void* object = nullptr;
+        void (*deleter) (void*) = nullptr;
+    };
+
+    static constexpr auto batchInterval = std::chrono::milliseconds (10);
+
+    rigtorp::MPMCQueue<RetiredObject> queue;
+    std::atomic<size_t> numRetired { 0 };
+
+    std::mutex mutex;
+    std::condition_variable threadCondition, flushCondition;
+    size_t numDeleted = 0;
+    bool threadShouldExit = false, flushRequested = false;
+    std::thread thread;
+
+    void run()
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock lock (mutex);
+                threadCondition.wait_for (lock, batchInterval, [this] { return threadShouldExit || flushRequested; });
+
+                if (threadShouldExit)
+                    return;
+
+                flushRequested = false;
+            }
+
+            deleteRetiredObjects();
+        }
+    }
+
+    void deleteRetiredObjects()
+    {
+        size_t numDeletedThisTime = 0;
+        RetiredObject retired;
+
+        while (queue.try_pop (retired))
+        {
+            retired.deleter (retired.object);
+            ++numDeletedThisTime;
+        }
+
+        if (numDeletedThisTime == 0)
+            return;
+
+        {
+            const std::scoped_lock sl (mutex);
+            numDeleted += numDeletedThisTime;
+        }
+
+        flushCondition.notify_all();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (DeferredDeleter)
+};
+
+}} // namespace tracktion
@@ -0,0 +1,153 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_DEFERREDDELETER
+
+class DeferredDeleterTests  : public juce::UnitTest
+{
+public:
+    DeferredDeleterTests()
+        : juce::UnitTest ("DeferredDeleter", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runDeletionTests();
+        runPlayerTests();
+    }
+
+private:
+    struct Tracker
+    {
+        Tracker (std::atomic<int>& numDeletedToUse, std::thread::id& deletingThreadToUse)
+            : numDeleted (&numDeletedToUse), deletingThread (&deletingThreadToUse) {}
+
+        Tracker (Tracker&& other) noexcept
+            : numDeleted (std::exchange (other.numDeleted, nullptr)), deletingThread (other.deletingThread) {}
+
+        ~Tracker()
+        {
+            if (numDeleted != nullptr)
+            {
+                *deletingThread = std::this_thread::get_id();
+                ++*numDeleted;
+            }
+        }
+
+        std::atomic<int>* numDeleted;
+        std::thread::id* deletingThread;
+    };
+
+    void runDeletionTests()
+    {
+        beginTest ("Objects are deleted on the background thread");
+        {
+            std::atomic<int> numDeleted { 0 };
+            std::thread::id deletingThread;
+            DeferredDeleter deleter;
+
+            for (int i = 0; i < 10; ++i)
+                deleter.retire (std::make_unique<Tracker> (numDeleted, deletingThread));
+
+            deleter.retire (Tracker (numDeleted, deletingThread));
+            deleter.flush();
+
+            expectEquals (numDeleted.load(), 11);
+            expect (deletingThread != std::this_thread::get_id());
+        }
+
+        beginTest ("Objects are retired from several threads");
+        {
+            std::atomic<int> numDeleted { 0 };
+            std::thread::id deletingThread;
+            DeferredDeleter deleter;
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < 4; ++t)
+                threads.emplace_back ([&]
+                                      {
+                                          for (int i = 0; i < 100; ++i)
+                                              deleter.retire (std::make_unique<Tracker> (numDeleted, deletingThread));
+                                      });
+
+            for (auto& t : threads)
+                t.join();
+
+            deleter.flush();
+            expectEquals (numDeleted.load(), 400);
+        }
+
+        beginTest ("Pending objects are deleted with the deleter");
+        {
+            std::atomic<int> numDeleted { 0 };
+            std::thread::id deletingThread;
+
+            {
+                DeferredDeleter deleter;
+                deleter.retire (std::make_unique<Tracker> (numDeleted, deletingThread));
+            }
+
+            expectEquals (numDeleted.load(), 1);
+        }
+    }
+
+    struct TrackedSinNode  : public SinNode
+    {
+        TrackedSinNode (float frequency, std::atomic<int>& numDeletedToUse)
+            : SinNode (frequency), numDeleted (numDeletedToUse) {}
+
+        ~TrackedSinNode() override
+        {
+            ++numDeleted;
+        }
+
+        std::atomic<int>& numDeleted;
+    };
+
+    void runPlayerTests()
+    {
+        beginTest ("Replaced graphs are retired");
+        {
+            std::atomic<int> numDeleted { 0 };
+            constexpr double sampleRate = 44100.0;
+            constexpr int blockSize = 256;
+
+            DeferredDeleter deleter;
+            LockFreeMultiThreadedNodePlayer player;
+            player.setNumThreads (0);
+            player.setDeferredDeleter (&deleter);
+
+            choc::buffer::ChannelArrayBuffer<float> buffer (1, (choc::buffer::FrameCount) blockSize);
+            tracktion_engine::MidiMessageArray midi;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                player.setNode (makeNode<TrackedSinNode> (220.0f + (float) i, numDeleted), sampleRate, blockSize);
+
+                const auto referenceSampleRange = juce::Range<int64_t>::withStartAndLength ((int64_t) i * blockSize, (int64_t) blockSize);
+                player.process ({ (choc::buffer::FrameCount) blockSize, referenceSampleRange, { buffer.getView(), midi } });
+            }
+
+            // Each graph is retired once the next has been picked up, so all but the last one should be gone
+            deleter.flush();
+            expectEquals (numDeleted.load(), 9);
+            expect (player.getNode() != nullptr);
+        }
+    }
+};
+
+static DeferredDeleterTests deferredDeleterTests;
+
+#endif
+
+}} // namespace tracktion
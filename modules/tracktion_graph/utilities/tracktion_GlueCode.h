@@ -205,16 +205,16 @@ struct std::hash<juce::MidiMessageSequence>
 {
     size_t operator() (const juce::MidiMessageSequence& sequence) const noexcept
     {
-        size_t seed = 0;
+        tracktion::ContentHasher hasher;
 
         for (auto meh : sequence)
         {
             auto& me = meh->message;
-            tracktion::hash_combine (seed, me.getTimeStamp());
-            tracktion::hash_range (seed, me.getRawData(), me.getRawData() + me.getRawDataSize());
+            hasher.add (me.getTimeStamp());
+            hasher.add (me.getRawData(), (size_t) me.getRawDataSize());
         }
 
-        return seed;
+        return (size_t) hasher.getHash();
     }
 };
 
@@ -223,7 +223,12 @@ struct std::hash<std::vector<juce::MidiMessageSequence>>
 {
     size_t operator() (const std::vector<juce::MidiMessageSequence>& sequences) const noexcept
     {
-        return tracktion::hash_range (sequences);
+        tracktion::ContentHasher hasher;
+
+        for (auto& sequence : sequences)
+            hasher.add ((uint64_t) std::hash<juce::MidiMessageSequence>() (sequence));
+
+        return (size_t) hasher.getHash();
     }
 };
 #endif
@@ -22,7 +22,7 @@ struct LatencyProcessor
     /** Returns ture if the the sample rate, channels etc. are the same between the two objects. */
     bool hasSameConfigurationAs (const LatencyProcessor& o) const
     {
-        return latencyNumSamples == o.latencyNumSamples
+        return getLatencyNumSamples() == o.getLatencyNumSamples()
             && sampleRate == o.sampleRate
             && fifo.getNumChannels() == o.fifo.getNumChannels();
     }
@@ -30,30 +30,67 @@ struct LatencyProcessor
     /** Returns ture if the the sample rate, channels etc. are those specified. */
     bool hasConfiguration (int numLatencySamples, double preparedSampleRate, int numberOfChannels) const
     {
-        return latencyNumSamples == numLatencySamples
+        return getLatencyNumSamples() == numLatencySamples
             && sampleRate == preparedSampleRate
             && fifo.getNumChannels() == (choc::buffer::ChannelCount) numberOfChannels;
     }
 
+    /** Returns the latency, including any change made by setLatencyNumSamplesLive that
+        hasn't been applied yet.
+    */
     int getLatencyNumSamples() const
     {
-        return latencyNumSamples;
+        return latencyNumSamples.load (std::memory_order_acquire);
     }
 
+    /** Sets the latency. This must be called before prepareToPlay. */
     void setLatencyNumSamples (int numLatencySamples)
     {
         assert (numLatencySamples < (196'000 * 60) && "Invalid latency size");
         latencyNumSamples = numLatencySamples;
+        audioLatencyNumSamples = numLatencySamples;
+        midiLatencyNumSamples = numLatencySamples;
+    }
+
+    /** Returns true if setLatencyNumSamplesLive can change to this latency without
+        the FIFO needing to be resized.
+    */
+    bool canSetLatencyNumSamplesLive (int numLatencySamples) const
+    {
+        return numLatencySamples >= 0
+            && numLatencySamples + maxBlockSize + 1 <= (int) fifo.getCapacity();
+    }
+
+    /** Changes the latency whilst the processor is in use.
+        This can be called from any thread. The change is applied by the next read, which
+        crossfades from the old delay to the new one so there isn't a discontinuity.
+        Delayed MIDI is moved by the change, any that would then be late being sent at the
+        start of the next block.
+        Returns false if the FIFO isn't big enough, in which case prepareToPlay needs to be
+        called again with the new latency.
+    */
+    bool setLatencyNumSamplesLive (int numLatencySamples)
+    {
+        if (! canSetLatencyNumSamplesLive (numLatencySamples))
+            return false;
+
+        latencyNumSamples.store (numLatencySamples, std::memory_order_release);
+        return true;
     }
 
     void prepareToPlay (double sampleRateToUse, int blockSize, int numChannels)
     {
         sampleRate = sampleRateToUse;
-        latencyTimeSeconds = sampleToTime (latencyNumSamples, sampleRate);
+        maxBlockSize = blockSize;
+        audioLatencyNumSamples = getLatencyNumSamples();
+        midiLatencyNumSamples = audioLatencyNumSamples;
+        latencyTimeSeconds = sampleToTime (midiLatencyNumSamples, sampleRate);
+
+        fifo.setSize ((choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) (audioLatencyNumSamples + blockSize + 1));
+        fifo.writeSilence ((choc::buffer::FrameCount) audioLatencyNumSamples);
+        jassert (fifo.getNumReady() == audioLatencyNumSamples);
 
-        fifo.setSize ((choc::buffer::ChannelCount) numChannels, (choc::buffer::FrameCount) (latencyNumSamples + blockSize + 1));
-        fifo.writeSilence ((choc::buffer::FrameCount) latencyNumSamples);
-        jassert (fifo.getNumReady() == latencyNumSamples);
+        crossfadeBuffer.resize ({ (choc::buffer::ChannelCount) numChannels * 2, (choc::buffer::FrameCount) blockSize });
     }
 
     void writeAudio (choc::buffer::ChannelArrayView<float> src)
@@ -76,7 +113,9 @@ struct LatencyProcessor
             return;
 
         jassert (fifo.getNumReady() >= (int) dst.getNumFrames());
-        fifo.readAdding (dst);
+
+        if (! readCrossfadingToNewLatency (dst, true))
+            fifo.readAdding (dst);
     }
 
     void readAudioOverwriting (choc::buffer::ChannelArrayView<float> dst)
@@ -85,11 +124,15 @@ struct LatencyProcessor
             return;
 
         jassert (fifo.getNumReady() >= (int) dst.getNumFrames());
-        fifo.readOverwriting (dst);
+
+        if (! readCrossfadingToNewLatency (dst, false))
+            fifo.readOverwriting (dst);
     }
 
     void readMIDI (tracktion_engine::MidiMessageArray& dst, int numSamples)
     {
+        applyMIDILatencyChange();
+
         // And read out any delayed items
         const double blockTimeSeconds = sampleToTime (numSamples, sampleRate);
 
@@ -119,10 +162,19 @@ struct LatencyProcessor
     void clearAudio (int numSamples)
     {
         fifo.removeSamples (numSamples);
+
+        // Nothing is being output so the delay can change without crossfading
+        if (const auto newLatency = getLatencyNumSamples(); newLatency != audioLatencyNumSamples)
+        {
+            fifo.setNumReady (std::max (0, fifo.getNumReady() + newLatency - audioLatencyNumSamples));
+            audioLatencyNumSamples = newLatency;
+        }
     }
 
     void clearMIDI (int numSamples)
     {
+        applyMIDILatencyChange();
+
         // And read out any delayed items
         const double blockTimeSeconds = sampleToTime (numSamples, sampleRate);
 
@@ -143,11 +195,77 @@ struct LatencyProcessor
     }
 
 private:
-    int latencyNumSamples = 0;
+    std::atomic<int> latencyNumSamples { 0 };
+    int audioLatencyNumSamples = 0, midiLatencyNumSamples = 0, maxBlockSize = 0;
     double sampleRate = 44100.0;
     double latencyTimeSeconds = 0.0;
-    AudioFifo fifo { 1, 32 };
+    MirroredAudioFifo fifo { 1, 32 };
+    choc::buffer::ChannelArrayBuffer<float> crossfadeBuffer;
     tracktion_engine::MidiMessageArray midi;
+
+    bool readCrossfadingToNewLatency (choc::buffer::ChannelArrayView<float> dst, bool adding)
+    {
+        const auto newLatency = getLatencyNumSamples();
+
+        if (newLatency == audioLatencyNumSamples)
+            return false;
+
+        // The old and new delays are read as taps behind the write position and crossfaded
+        // over this block, then the read position is moved to carry on from the new one
+        const auto numFrames = dst.getNumFrames();
+        const auto numChannels = dst.getNumChannels();
+        const auto oldDelay = (choc::buffer::FrameCount) (fifo.getNumReady() - (int) numFrames);
+        const auto newDelay = (choc::buffer::FrameCount) std::max (0, (int) oldDelay + newLatency - audioLatencyNumSamples);
+
+        if (numFrames > crossfadeBuffer.getNumFrames() || numChannels * 2 > crossfadeBuffer.getNumChannels())
+        {
+            jassertfalse;
+            return false;
+        }
+
+        auto oldTap = crossfadeBuffer.getView().getChannelRange ({ 0, numChannels }).getStart (numFrames);
+        auto newTap = crossfadeBuffer.getView().getChannelRange ({ numChannels, numChannels * 2 }).getStart (numFrames);
+
+        if (! fifo.readTapOverwriting (oldDelay, oldTap) || ! fifo.readTapOverwriting (newDelay, newTap))
+        {
+            jassertfalse;
+            return false;
+        }
+
+        for (choc::buffer::ChannelCount channel = 0; channel < numChannels; ++channel)
+        {
+            auto oldData = oldTap.getIterator (channel).sample;
+            auto newData = newTap.getIterator (channel).sample;
+            auto destData = dst.getIterator (channel).sample;
+
+            for (choc::buffer::FrameCount i = 0; i < numFrames; ++i)
+            {
+                const auto gain = (float) (i + 1) / (float) numFrames;
+                const auto sample = oldData[i] * (1.0f - gain) + newData[i] * gain;
+                destData[i] = adding ? destData[i] + sample : sample;
+            }
+        }
+
+        fifo.setNumReady ((int) newDelay);
+        audioLatencyNumSamples = newLatency;
+        return true;
+    }
+
+    void applyMIDILatencyChange()
+    {
+        const auto newLatency = getLatencyNumSamples();
+
+        if (newLatency == midiLatencyNumSamples)
+            return;
+
+        midi.addToTimestamps (sampleToTime (newLatency - midiLatencyNumSamples, sampleRate));
+        midiLatencyNumSamples = newLatency;
+        latencyTimeSeconds = sampleToTime (midiLatencyNumSamples, sampleRate);
+
+        for (auto& m : midi)
+            if (m.getTimeStamp() < 0.0)
+                m.setTimeStamp (0.0);
+    }
 };
 
 }}
@@ -0,0 +1,248 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#if TRACKTION_ARM && __has_include(<arm_neon.h>)
+ #include <arm_neon.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Vectorised reductions for metering a block of samples.
+
+    The peak is exact. Sums of squares are accumulated in several single precision
+    lanes so RMS values may differ very slightly from a scalar double precision sum.
+
+    Like the summing_kernels, these use AVX if it's enabled at compile time, else
+    SSE2 on x86 and NEON on ARM, with a scalar fallback for anything else.
+*/
+namespace level_kernels
+{
+    /** Returns the largest absolute value of the samples. */
+    inline float getPeak (const float* samples, size_t numSamples) noexcept;
+
+    /** Returns the RMS level of the samples. */
+    inline float getRMS (const float* samples, size_t numSamples) noexcept;
+
+    /** Versions of the above that only read every stride'th sample.
+        This is much cheaper when the levels are only used to drive a meter display
+        but may miss short peaks. A stride of 1 uses the vectorised versions.
+    */
+    inline float getPeak (const float* samples, size_t numSamples, size_t stride) noexcept;
+    inline float getRMS (const float* samples, size_t numSamples, size_t stride) noexcept;
+
+    /** Scalar versions of the above, mainly useful to compare against. */
+    inline float getPeakScalar (const float* samples, size_t numSamples) noexcept;
+    inline float getRMSScalar (const float* samples, size_t numSamples) noexcept;
+}
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+
+namespace level_kernels
+{
+    namespace detail
+    {
+        inline float getPeak (const float* samples, size_t startSample, size_t endSample, size_t stride, float peak) noexcept
+        {
+            for (size_t i = startSample; i < endSample; i += stride)
+                peak = std::max (peak, std::abs (samples[i]));
+
+            return peak;
+        }
+
+        inline double getSumOfSquares (const float* samples, size_t startSample, size_t endSample, size_t stride) noexcept
+        {
+            double sum = 0.0;
+
+            for (size_t i = startSample; i < endSample; i += stride)
+            {
+                const auto sample = (double) samples[i];
+                sum += sample * sample;
+            }
+
+            return sum;
+        }
+
+        inline float getSumOfSquares (const float* samples, size_t numSamples, size_t& numDone) noexcept
+        {
+            size_t i = 0;
+            float sum = 0.0f;
+
+           #if defined (__AVX__)
+            {
+                auto sum1 = _mm256_setzero_ps(), sum2 = _mm256_setzero_ps();
+
+                for (; i + 16 <= numSamples; i += 16)
+                {
+                    const auto a = _mm256_loadu_ps (samples + i);
+                    const auto b = _mm256_loadu_ps (samples + i + 8);
+                    sum1 = _mm256_add_ps (sum1, _mm256_mul_ps (a, a));
+                    sum2 = _mm256_add_ps (sum2, _mm256_mul_ps (b, b));
+                }
+
+                const auto sum8 = _mm256_add_ps (sum1, sum2);
+                const auto sum4 = _mm_add_ps (_mm256_castps256_ps128 (sum8), _mm256_extractf128_ps (sum8, 1));
+                const auto sum2Lanes = _mm_add_ps (sum4, _mm_movehl_ps (sum4, sum4));
+                sum += _mm_cvtss_f32 (_mm_add_ss (sum2Lanes, _mm_shuffle_ps (sum2Lanes, sum2Lanes, 1)));
+            }
+           #endif
+
+           #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+            {
+                auto sum4 = _mm_setzero_ps();
+
+                for (; i + 4 <= numSamples; i += 4)
+                {
+                    const auto a = _mm_loadu_ps (samples + i);
+                    sum4 = _mm_add_ps (sum4, _mm_mul_ps (a, a));
+                }
+
+                const auto sum2Lanes = _mm_add_ps (sum4, _mm_movehl_ps (sum4, sum4));
+                sum += _mm_cvtss_f32 (_mm_add_ss (sum2Lanes, _mm_shuffle_ps (sum2Lanes, sum2Lanes, 1)));
+            }
+           #elif TRACKTION_ARM && defined (__ARM_NEON)
+            {
+                auto sum1 = vdupq_n_f32 (0.0f), sum2 = vdupq_n_f32 (0.0f);
+
+                for (; i + 8 <= numSamples; i += 8)
+                {
+                    const auto a = vld1q_f32 (samples + i);
+                    const auto b = vld1q_f32 (samples + i + 4);
+                    sum1 = vmlaq_f32 (sum1, a, a);
+                    sum2 = vmlaq_f32 (sum2, b, b);
+                }
+
+                const auto sum4 = vaddq_f32 (sum1, sum2);
+                const auto sum2Lanes = vadd_f32 (vget_low_f32 (sum4), vget_high_f32 (sum4));
+                sum += vget_lane_f32 (vpadd_f32 (sum2Lanes, sum2Lanes), 0);
+            }
+           #endif
+
+            numDone = i;
+            return sum;
+        }
+    }
+
+    inline float getPeakScalar (const float* samples, size_t numSamples) noexcept
+    {
+        return detail::getPeak (samples, 0, numSamples, 1, 0.0f);
+    }
+
+    inline float getRMSScalar (const float* samples, size_t numSamples) noexcept
+    {
+        if (numSamples == 0)
+            return 0.0f;
+
+        return (float) std::sqrt (detail::getSumOfSquares (samples, 0, numSamples, 1) / (double) numSamples);
+    }
+
+    //==============================================================================
+    inline float getPeak (const float* samples, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+        float peak = 0.0f;
+
+       #if defined (__AVX__)
+        {
+            const auto signMask = _mm256_set1_ps (-0.0f);
+            auto max1 = _mm256_setzero_ps(), max2 = _mm256_setzero_ps();
+
+            for (; i + 16 <= numSamples; i += 16)
+            {
+                max1 = _mm256_max_ps (max1, _mm256_andnot_ps (signMask, _mm256_loadu_ps (samples + i)));
+                max2 = _mm256_max_ps (max2, _mm256_andnot_ps (signMask, _mm256_loadu_ps (samples + i + 8)));
+            }
+
+            const auto max8 = _mm256_max_ps (max1, max2);
+            const auto max4 = _mm_max_ps (_mm256_castps256_ps128 (max8), _mm256_extractf128_ps (max8, 1));
+            const auto max2Lanes = _mm_max_ps (max4, _mm_movehl_ps (max4, max4));
+            peak = std::max (peak, _mm_cvtss_f32 (_mm_max_ss (max2Lanes, _mm_shuffle_ps (max2Lanes, max2Lanes, 1))));
+        }
+       #endif
+
+       #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        {
+            const auto signMask = _mm_set1_ps (-0.0f);
+            auto max4 = _mm_setzero_ps();
+
+            for (; i + 4 <= numSamples; i += 4)
+                max4 = _mm_max_ps (max4, _mm_andnot_ps (signMask, _mm_loadu_ps (samples + i)));
+
+            const auto max2Lanes = _mm_max_ps (max4, _mm_movehl_ps (max4, max4));
+            peak = std::max (peak, _mm_cvtss_f32 (_mm_max_ss (max2Lanes, _mm_shuffle_ps (max2Lanes, max2Lanes, 1))));
+        }
+       #elif TRACKTION_ARM && defined (__ARM_NEON)
+        {
+            auto max1 = vdupq_n_f32 (0.0f), max2 = vdupq_n_f32 (0.0f);
+
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                max1 = vmaxq_f32 (max1, vabsq_f32 (vld1q_f32 (samples + i)));
+                max2 = vmaxq_f32 (max2, vabsq_f32 (vld1q_f32 (samples + i + 4)));
+            }
+
+            const auto max4 = vmaxq_f32 (max1, max2);
+            const auto max2Lanes = vmax_f32 (vget_low_f32 (max4), vget_high_f32 (max4));
+            peak = std::max (peak, vget_lane_f32 (vpmax_f32 (max2Lanes, max2Lanes), 0));
+        }
+       #endif
+
+        return detail::getPeak (samples, i, numSamples, 1, peak);
+    }
+
+    inline float getRMS (const float* samples, size_t numSamples) noexcept
+    {
+        if (numSamples == 0)
+            return 0.0f;
+
+        size_t numDone = 0;
+        auto sum = (double) detail::getSumOfSquares (samples, numSamples, numDone);
+        sum += detail::getSumOfSquares (samples, numDone, numSamples, 1);
+
+        return (float) std::sqrt (sum / (double) numSamples);
+    }
+
+    inline float getPeak (const float* samples, size_t numSamples, size_t stride) noexcept
+    {
+        if (stride <= 1)
+            return getPeak (samples, numSamples);
+
+        return detail::getPeak (samples, 0, numSamples, stride, 0.0f);
+    }
+
+    inline float getRMS (const float* samples, size_t numSamples, size_t stride) noexcept
+    {
+        if (stride <= 1)
+            return getRMS (samples, numSamples);
+
+        if (numSamples == 0)
+            return 0.0f;
+
+        const auto numRead = (numSamples + stride - 1) / stride;
+        return (float) std::sqrt (detail::getSumOfSquares (samples, 0, numSamples, stride) / (double) numRead);
+    }
+}
+
+}}
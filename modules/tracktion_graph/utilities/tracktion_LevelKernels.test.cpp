@@ -0,0 +1,68 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_LEVELKERNELS
+
+class LevelKernelsTests  : public juce::UnitTest
+{
+public:
+    LevelKernelsTests()
+        : juce::UnitTest ("LevelKernels", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        for (int numSamples : { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 512, 4099 })
+            runComparisonTests (numSamples);
+    }
+
+private:
+    void runComparisonTests (int numSamples)
+    {
+        beginTest ("Samples: " + juce::String (numSamples));
+
+        auto r = getRandom();
+        juce::AudioBuffer<float> buffer (1, std::max (1, numSamples));
+
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample (0, i, (r.nextFloat() * 2.0f - 1.0f) * 1.5f);
+
+        const auto samples = buffer.getReadPointer (0);
+        const auto size = (size_t) numSamples;
+
+        // Peaks should match exactly, RMS levels to within the single precision accumulation
+        expectEquals (level_kernels::getPeak (samples, size), level_kernels::getPeakScalar (samples, size));
+        expectEquals (level_kernels::getPeak (samples, size), numSamples > 0 ? buffer.getMagnitude (0, 0, numSamples) : 0.0f);
+
+        const auto rms = level_kernels::getRMSScalar (samples, size);
+        expectWithinAbsoluteError (level_kernels::getRMS (samples, size), rms, rms * 1.0e-5f);
+        expectWithinAbsoluteError (rms, numSamples > 0 ? buffer.getRMSLevel (0, 0, numSamples) : 0.0f, 1.0e-6f);
+
+        // Decimated levels should only read every stride'th sample
+        expectEquals (level_kernels::getPeak (samples, size, 1), level_kernels::getPeak (samples, size));
+
+        float decimatedPeak = 0.0f;
+
+        for (int i = 0; i < numSamples; i += 4)
+            decimatedPeak = std::max (decimatedPeak, std::abs (samples[i]));
+
+        expectEquals (level_kernels::getPeak (samples, size, 4), decimatedPeak);
+        expect (level_kernels::getRMS (samples, size, 4) >= 0.0f);
+    }
+};
+
+static LevelKernelsTests levelKernelsTests;
+
+#endif
+
+}}
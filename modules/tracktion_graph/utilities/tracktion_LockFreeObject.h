@@ -59,14 +59,21 @@ public:
         pendingObject = nullptr;
     }
 
-    /** Pushes a new object to be picked up on the real time thread. */
-    void pushNonRealTime (ObjectType&& newObj)
+    /** Pushes a new object to be picked up on the real time thread.
+        This returns the object it replaced, i.e. the one previously being used
+        or a pending one that was never picked up. This is returned rather than
+        destroyed so the lock isn't held whilst it's destroyed and the caller
+        can choose where that happens.
+    */
+    ObjectType pushNonRealTime (ObjectType&& newObj)
     {
         // Obtain the lock on the pending object
         std::scoped_lock sl (pushingObjectMutex);
 
-        pendingObjectStorage = std::move (newObj);
+        auto replacedObj = std::exchange (pendingObjectStorage, std::move (newObj));
         pendingObject = &pendingObjectStorage;
+
+        return replacedObj;
     }
 
     /** Retains the object for use in a real time thread.
@@ -158,4 +165,168 @@ private:
     bool needToUnlockPushingObjectMutex = false, needToUnlockClearObjectsMutex = true;
 };
 
+
+//==============================================================================
+//==============================================================================
+/**
+    Like LockFreeObject but can be accessed by several real-time threads at once,
+    for example each of the threads processing a graph.
+
+    Each reader has its own slot, identified by an index less than the number
+    of readers passed to the constructor. Retaining the object publishes the
+    pointer in that slot, a hazard pointer, and pushNonRealTime waits until no
+    slot holds the object being replaced before returning it. Retaining and
+    releasing never block, retainRealTime only retries if a push happens at the
+    same moment.
+
+    A slot must only be used by one thread at a time and retains can't be nested
+    on the same slot, so a thread pool would typically use its worker index.
+
+    @see LockFreeObject
+*/
+template<typename ObjectType>
+class LockFreeMultiReaderObject
+{
+public:
+    /** Constructs an initially empty object that can be read by a number of threads at once. */
+    LockFreeMultiReaderObject (size_t maxNumReadersToUse)
+        : maxNumReaders (maxNumReadersToUse),
+          slots (std::make_unique<ReaderSlot[]> (maxNumReadersToUse))
+    {
+        static_assert (std::is_move_constructible_v<ObjectType>);
+    }
+
+    /** Destructor. No readers should be holding the object when this is called. */
+    ~LockFreeMultiReaderObject()
+    {
+        for (size_t i = 0; i < maxNumReaders; ++i)
+            assert (slots[i].object.load() == nullptr);
+
+        delete current.load();
+    }
+
+    /** Returns the number of readers this was created for. */
+    size_t getMaxNumReaders() const noexcept
+    {
+        return maxNumReaders;
+    }
+
+    //==============================================================================
+    /** Clears the object, waiting for any readers to release it before deleting it.
+        Whilst this is happening, retainRealTime will return nullptr.
+    */
+    void clear()
+    {
+        replace (nullptr);
+    }
+
+    /** Replaces the object, making it immediately available to readers.
+        This waits until none of the readers are using the old object and then
+        returns it, so it can be destroyed outside of any locks.
+    */
+    std::unique_ptr<ObjectType> pushNonRealTime (ObjectType&& newObj)
+    {
+        return replace (std::make_unique<ObjectType> (std::move (newObj)));
+    }
+
+    //==============================================================================
+    /** Retains the current object for use in a real time thread.
+        This returns nullptr if no object has been pushed or it's been cleared.
+
+        This must be matched with a corresponding call to releaseRealTime() with
+        the same readerIndex. To ensure this, use the ScopedRealTimeAccess helper class.
+    */
+    ObjectType* retainRealTime (size_t readerIndex) noexcept
+    {
+        assert (readerIndex < maxNumReaders);
+        auto& slotObject = slots[readerIndex].object;
+        assert (slotObject.load (std::memory_order_relaxed) == nullptr); // Retains can't be nested
+
+        auto obj = current.load (std::memory_order_acquire);
+
+        // The object can only be used once it's been published in the slot before
+        // the writer replaced it, otherwise the writer might not have seen it
+        for (;;)
+        {
+            slotObject.store (obj, std::memory_order_seq_cst);
+            const auto latest = current.load (std::memory_order_seq_cst);
+
+            if (latest == obj)
+                return obj;
+
+            obj = latest;
+        }
+    }
+
+    /** Releases the use of the object from a previous call to retainRealTime. */
+    void releaseRealTime (size_t readerIndex) noexcept
+    {
+        assert (readerIndex < maxNumReaders);
+        slots[readerIndex].object.store (nullptr, std::memory_order_release);
+    }
+
+    //==============================================================================
+    /**
+        Helper class to automatically retain/release real time access to an object.
+    */
+    class ScopedRealTimeAccess
+    {
+    public:
+        /** Retains real time access to an object for a reader. */
+        ScopedRealTimeAccess (LockFreeMultiReaderObject& lfo, size_t readerIndexToUse)
+            : lockFreeObject (lfo), readerIndex (readerIndexToUse)
+        {}
+
+        /** Releases real time access to the object. */
+        ~ScopedRealTimeAccess()
+        {
+            lockFreeObject.releaseRealTime (readerIndex);
+        }
+
+        /** Returns a pointer to the object if there is one. */
+        ObjectType* get() const
+        {
+            return object;
+        }
+
+    private:
+        LockFreeMultiReaderObject& lockFreeObject;
+        const size_t readerIndex;
+        ObjectType* object { lockFreeObject.retainRealTime (readerIndex) };
+    };
+
+    /** Creates a ScopedRealTimeAccess for a reader of this LockFreeMultiReaderObject. */
+    ScopedRealTimeAccess getScopedAccess (size_t readerIndex)
+    {
+        return ScopedRealTimeAccess { *this, readerIndex };
+    }
+
+private:
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<ObjectType*> object { nullptr };
+    };
+
+    const size_t maxNumReaders;
+    std::unique_ptr<ReaderSlot[]> slots;
+    std::atomic<ObjectType*> current { nullptr };
+    std::mutex pushingObjectMutex;
+
+    std::unique_ptr<ObjectType> replace (std::unique_ptr<ObjectType> newObj)
+    {
+        std::scoped_lock sl (pushingObjectMutex);
+        std::unique_ptr<ObjectType> oldObj (current.exchange (newObj.release(), std::memory_order_seq_cst));
+
+        if (oldObj != nullptr)
+        {
+            // Readers only hold the object for a block so this won't be waiting long
+            for (size_t i = 0; i < maxNumReaders; ++i)
+                while (slots[i].object.load (std::memory_order_seq_cst) == oldObj.get())
+                    std::this_thread::yield();
+        }
+
+        return oldObj;
+    }
+};
+
 }} // namespace tracktion_engine
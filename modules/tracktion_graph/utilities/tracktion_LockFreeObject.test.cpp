@@ -0,0 +1,118 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_LOCKFREEOBJECT
+
+class LockFreeObjectTests  : public juce::UnitTest
+{
+public:
+    LockFreeObjectTests()
+        : juce::UnitTest ("LockFreeObject", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runMultiReaderTests();
+    }
+
+private:
+    struct Snapshot
+    {
+        Snapshot (int v) : value (v), check (v) {}
+        Snapshot (Snapshot&& other) noexcept : value (other.value), check (other.check.load()) {}
+        ~Snapshot()     { check = -1; }
+
+        bool isValid() const    { return check.load() == value; }
+
+        int value;
+        std::atomic<int> check;
+    };
+
+    void runMultiReaderTests()
+    {
+        beginTest ("Multi-reader object is empty until pushed");
+        {
+            LockFreeMultiReaderObject<Snapshot> object (2);
+            expectEquals ((int) object.getMaxNumReaders(), 2);
+            expect (object.getScopedAccess (0).get() == nullptr);
+
+            expect (object.pushNonRealTime (Snapshot (1)) == nullptr);
+
+            {
+                auto access0 = object.getScopedAccess (0);
+                auto access1 = object.getScopedAccess (1);
+                expect (access0.get() != nullptr && access0.get() == access1.get());
+                expectEquals (access1.get()->value, 1);
+            }
+
+            auto replaced = object.pushNonRealTime (Snapshot (2));
+            expect (replaced != nullptr);
+            expectEquals (replaced->value, 1);
+            expectEquals (object.getScopedAccess (1).get()->value, 2);
+
+            object.clear();
+            expect (object.getScopedAccess (0).get() == nullptr);
+        }
+
+        beginTest ("Multi-reader objects aren't replaced whilst they're being read");
+        {
+            constexpr int numReaders = 4;
+            LockFreeMultiReaderObject<Snapshot> object (numReaders);
+            object.pushNonRealTime (Snapshot (0));
+
+            std::atomic<bool> finished { false };
+            std::atomic<int> numInvalid { 0 }, numReads { 0 };
+            std::vector<std::thread> readers;
+
+            for (int i = 0; i < numReaders; ++i)
+                readers.emplace_back ([&, i]
+                                      {
+                                          int lastValue = 0;
+
+                                          while (! finished)
+                                          {
+                                              const auto access = object.getScopedAccess ((size_t) i);
+
+                                              if (auto s = access.get())
+                                              {
+                                                  if (! s->isValid() || s->value < lastValue)
+                                                      ++numInvalid;
+
+                                                  lastValue = s->value;
+                                                  ++numReads;
+                                              }
+                                          }
+                                      });
+
+            for (int i = 1; i <= 1000; ++i)
+            {
+                auto replaced = object.pushNonRealTime (Snapshot (i));
+                expect (replaced != nullptr && replaced->value == i - 1);
+            }
+
+            finished = true;
+
+            for (auto& t : readers)
+                t.join();
+
+            expectEquals (numInvalid.load(), 0);
+            expect (numReads.load() > 0);
+        }
+    }
+};
+
+static LockFreeObjectTests lockFreeObjectTests;
+
+#endif
+
+}} // namespace tracktion
@@ -0,0 +1,244 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    A single-producer, single-consumer audio FIFO with the same interface as
+    AudioFifo but which never has to split a read in to two parts.
+
+    The capacity is rounded up to a power of two and each channel stores two
+    copies of it, one after the other. Every frame is written to both halves
+    so any run of up to the capacity frames, starting anywhere in the first
+    half, is contiguous. Reads are then a single vectorised copy per channel
+    and peek can return the frames without copying them at all.
+
+    As well as the usual read position, frames can be read at a delay behind
+    the write position with readTapAdding/readTapOverwriting. This lets several
+    readers share one delay line, each with its own latency.
+*/
+class MirroredAudioFifo
+{
+public:
+    /** Creates a FIFO that can hold at least the given number of frames. */
+    MirroredAudioFifo (choc::buffer::ChannelCount numChannels,
+                       choc::buffer::FrameCount minNumFrames)
+    {
+        setSize (numChannels, minNumFrames);
+    }
+
+    /** Resizes the FIFO to hold at least the given number of frames.
+        This allocates and clears the FIFO so shouldn't be called on the audio thread.
+    */
+    void setSize (choc::buffer::ChannelCount numChannels,
+                  choc::buffer::FrameCount minNumFrames)
+    {
+        capacity = (choc::buffer::FrameCount) juce::nextPowerOfTwo ((int) std::max (minNumFrames, (choc::buffer::FrameCount) 1));
+        buffer.resize ({ numChannels, capacity * 2 });
+        buffer.clear();
+        reset();
+    }
+
+    /** Returns the number of frames the FIFO can hold. */
+    choc::buffer::FrameCount getCapacity() const noexcept           { return capacity; }
+
+    int getFreeSpace() const noexcept                               { return (int) capacity - getNumReady(); }
+    int getNumReady() const noexcept                                { return (int) (writePos.load (std::memory_order_acquire) - readPos.load (std::memory_order_acquire)); }
+
+    choc::buffer::ChannelCount getNumChannels() const noexcept      { return buffer.getNumChannels(); }
+
+    void reset() noexcept
+    {
+        readPos = 0;
+        writePos = 0;
+    }
+
+    void ensureFreeSpace (int numFrames)
+    {
+        auto freeSpace = getFreeSpace();
+
+        if (numFrames > freeSpace)
+        {
+            auto required = numFrames - freeSpace;
+            jassert (required <= getNumReady());
+            removeSamples (required);
+        }
+    }
+
+    bool write (choc::buffer::ChannelArrayView<float> block)
+    {
+        jassert (block.getNumChannels() <= buffer.getNumChannels());
+        const auto numFrames = block.getNumFrames();
+
+        if ((int) numFrames > getFreeSpace())
+            return false;
+
+        const auto start = getOffset (writePos.load (std::memory_order_relaxed));
+
+        for (choc::buffer::ChannelCount channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            if (channel < block.getNumChannels())
+                writeMirrored (channel, start, numFrames, [src = block.getIterator (channel).sample] (float* dest, choc::buffer::FrameCount offset, choc::buffer::FrameCount num)
+                               { juce::FloatVectorOperations::copy (dest, src + offset, (int) num); });
+            else
+                writeMirrored (channel, start, numFrames, [] (float* dest, choc::buffer::FrameCount, choc::buffer::FrameCount num)
+                               { juce::FloatVectorOperations::clear (dest, (int) num); });
+        }
+
+        writePos.fetch_add (numFrames, std::memory_order_release);
+        return true;
+    }
+
+    bool writeSilence (choc::buffer::FrameCount numFrames)
+    {
+        if (numFrames == 0)
+            return true;
+
+        if ((int) numFrames > getFreeSpace())
+            return false;
+
+        const auto start = getOffset (writePos.load (std::memory_order_relaxed));
+
+        for (choc::buffer::ChannelCount channel = 0; channel < buffer.getNumChannels(); ++channel)
+            writeMirrored (channel, start, numFrames, [] (float* dest, choc::buffer::FrameCount, choc::buffer::FrameCount num)
+                           { juce::FloatVectorOperations::clear (dest, (int) num); });
+
+        writePos.fetch_add (numFrames, std::memory_order_release);
+        return true;
+    }
+
+    /** Returns a view of the next frames to be read, without removing them.
+        The view is only valid until the frames are removed or overwritten.
+    */
+    choc::buffer::ChannelArrayView<float> peek (choc::buffer::FrameCount numFrames) const
+    {
+        jassert ((int) numFrames <= getNumReady());
+        const auto start = getOffset (readPos.load (std::memory_order_relaxed));
+        return buffer.getView().getFrameRange ({ start, start + numFrames });
+    }
+
+    bool readAdding (choc::buffer::ChannelArrayView<float> dest)
+    {
+        if ((int) dest.getNumFrames() > getNumReady())
+            return false;
+
+        readFrom (readPos.load (std::memory_order_relaxed), dest, true);
+        removeSamples ((int) dest.getNumFrames());
+        return true;
+    }
+
+    bool readOverwriting (choc::buffer::ChannelArrayView<float> dest)
+    {
+        if ((int) dest.getNumFrames() > getNumReady())
+            return false;
+
+        readFrom (readPos.load (std::memory_order_relaxed), dest, false);
+        removeSamples ((int) dest.getNumFrames());
+        return true;
+    }
+
+    void removeSamples (int numSamples)
+    {
+        jassert (numSamples <= getNumReady());
+        readPos.fetch_add ((uint64_t) numSamples, std::memory_order_release);
+    }
+
+    /** Moves the read position so the given number of frames are ready to be read.
+        This must only be called by the reader. Raising the number makes frames that have
+        already been read available again, which are only valid whilst they haven't been
+        overwritten, so it can't be more than the capacity.
+    */
+    void setNumReady (int numFrames)
+    {
+        jassert (numFrames >= 0 && numFrames <= (int) capacity);
+        readPos.store (writePos.load (std::memory_order_acquire) - (uint64_t) numFrames, std::memory_order_release);
+    }
+
+    //==============================================================================
+    /** Adds the frames that end the given number of frames before the write position
+        to a destination, without removing anything.
+        Frames from before the first write after setSize are silent. The delay plus the
+        number of frames must be no more than the capacity. Writes still need free space
+        so if only taps are being read, call ensureFreeSpace before each write.
+    */
+    bool readTapAdding (choc::buffer::FrameCount delayFrames, choc::buffer::ChannelArrayView<float> dest)
+    {
+        if (delayFrames + dest.getNumFrames() > capacity)
+            return false;
+
+        readFrom (writePos.load (std::memory_order_acquire) - delayFrames - dest.getNumFrames(), dest, true);
+        return true;
+    }
+
+    /** Copies the frames that end the given number of frames before the write position
+        to a destination, without removing anything.
+        @see readTapAdding
+    */
+    bool readTapOverwriting (choc::buffer::FrameCount delayFrames, choc::buffer::ChannelArrayView<float> dest)
+    {
+        if (delayFrames + dest.getNumFrames() > capacity)
+            return false;
+
+        readFrom (writePos.load (std::memory_order_acquire) - delayFrames - dest.getNumFrames(), dest, false);
+        return true;
+    }
+
+private:
+    choc::buffer::ChannelArrayBuffer<float> buffer;
+    choc::buffer::FrameCount capacity = 0;
+    std::atomic<uint64_t> readPos { 0 }, writePos { 0 };
+
+    choc::buffer::FrameCount getOffset (uint64_t position) const noexcept
+    {
+        // The capacity is a power of two so this is the same as a modulo, even after the positions wrap
+        return (choc::buffer::FrameCount) (position & (capacity - 1));
+    }
+
+    template<typename WriteFn>
+    void writeMirrored (choc::buffer::ChannelCount channel, choc::buffer::FrameCount start,
+                        choc::buffer::FrameCount numFrames, WriteFn&& writeFn)
+    {
+        auto data = buffer.getView().getIterator (channel).sample;
+        writeFn (data + start, 0, numFrames);
+
+        // Frames in the first half are mirrored after it, those that ran in to the second half are mirrored at the start
+        const auto numInFirstHalf = std::min (numFrames, capacity - start);
+        writeFn (data + start + capacity, 0, numInFirstHalf);
+
+        if (numFrames > numInFirstHalf)
+            writeFn (data, numInFirstHalf, numFrames - numInFirstHalf);
+    }
+
+    void readFrom (uint64_t position, choc::buffer::ChannelArrayView<float> dest, bool adding)
+    {
+        jassert (dest.getNumChannels() <= buffer.getNumChannels());
+        const auto start = getOffset (position);
+        const auto numFrames = (int) dest.getNumFrames();
+
+        for (choc::buffer::ChannelCount channel = 0; channel < dest.getNumChannels(); ++channel)
+        {
+            const auto src = buffer.getView().getIterator (channel).sample + start;
+            const auto destData = dest.getIterator (channel).sample;
+
+            if (adding)
+                juce::FloatVectorOperations::add (destData, src, numFrames);
+            else
+                juce::FloatVectorOperations::copy (destData, src, numFrames);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (MirroredAudioFifo)
+};
+
+}} // namespace tracktion
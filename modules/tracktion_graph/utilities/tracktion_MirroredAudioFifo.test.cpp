@@ -0,0 +1,149 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_MIRROREDAUDIOFIFO
+
+class MirroredAudioFifoTests  : public juce::UnitTest
+{
+public:
+    MirroredAudioFifoTests()
+        : juce::UnitTest ("MirroredAudioFifo", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        for (choc::buffer::FrameCount size : { 1u, 7u, 64u, 100u, 1000u })
+            runComparisonTests (size);
+
+        runTapTests();
+    }
+
+private:
+    static void fillRandom (choc::buffer::ChannelArrayView<float> view, juce::Random& r)
+    {
+        setAllSamples (view, [&r] { return r.nextFloat() * 2.0f - 1.0f; });
+    }
+
+    void runComparisonTests (choc::buffer::FrameCount minSize)
+    {
+        beginTest ("Matches AudioFifo: " + juce::String (minSize));
+
+        auto r = getRandom();
+        MirroredAudioFifo mirrored (2, minSize);
+        AudioFifo reference (2, mirrored.getCapacity() + 1);
+
+        expect (mirrored.getCapacity() >= minSize);
+        expect (juce::isPowerOfTwo (mirrored.getCapacity()));
+        expectEquals (mirrored.getFreeSpace(), reference.getFreeSpace());
+
+        choc::buffer::ChannelArrayBuffer<float> block (2, mirrored.getCapacity());
+        choc::buffer::ChannelArrayBuffer<float> mirroredDest (2, mirrored.getCapacity() + 1), referenceDest (2, mirrored.getCapacity()),
+                                                peekDest (2, mirrored.getCapacity());
+
+        for (int i = 0; i < 200; ++i)
+        {
+            // Write a random number of frames, sometimes silence and sometimes to fewer channels
+            const auto numToWrite = (choc::buffer::FrameCount) r.nextInt ((int) mirrored.getFreeSpace() + 1);
+            auto toWrite = block.getStart (numToWrite);
+            fillRandom (toWrite, r);
+
+            if (r.nextInt (4) == 0)
+            {
+                expect (mirrored.writeSilence (numToWrite));
+                expect (reference.writeSilence (numToWrite));
+            }
+            else if (r.nextBool())
+            {
+                expect (mirrored.write (toWrite.getFirstChannels (1)));
+                expect (reference.write (toWrite.getFirstChannels (1)));
+            }
+            else
+            {
+                expect (mirrored.write (toWrite));
+                expect (reference.write (toWrite));
+            }
+
+            expectEquals (mirrored.getNumReady(), reference.getNumReady());
+
+            // Then read a random number of them back
+            const auto numToRead = (choc::buffer::FrameCount) r.nextInt (mirrored.getNumReady() + 1);
+            auto mirroredView = mirroredDest.getStart (numToRead);
+            auto referenceView = referenceDest.getStart (numToRead);
+
+            auto peekView = peekDest.getStart (numToRead);
+            copy (peekView, mirrored.peek (numToRead));
+
+            if (r.nextBool())
+            {
+                mirroredView.clear();
+                referenceView.clear();
+                expect (mirrored.readAdding (mirroredView));
+                expect (reference.readAdding (referenceView));
+            }
+            else
+            {
+                expect (mirrored.readOverwriting (mirroredView));
+                expect (reference.readOverwriting (referenceView));
+            }
+
+            expect (contentMatches (mirroredView, referenceView), "Read frames differ");
+            expect (contentMatches (peekView, referenceView), "Peeked frames differ");
+        }
+
+        // Reads past the end should fail without changing anything
+        const auto numReady = mirrored.getNumReady();
+        expect (! mirrored.readOverwriting (mirroredDest.getStart ((choc::buffer::FrameCount) numReady + 1)));
+        expectEquals (mirrored.getNumReady(), numReady);
+    }
+
+    void runTapTests()
+    {
+        beginTest ("Taps");
+
+        auto r = getRandom();
+        const choc::buffer::FrameCount blockSize = 37;
+        MirroredAudioFifo fifo (1, 256);
+
+        choc::buffer::ChannelArrayBuffer<float> history (1, blockSize * 40);
+        fillRandom (history.getView(), r);
+
+        choc::buffer::ChannelArrayBuffer<float> dest (1, blockSize);
+
+        for (choc::buffer::FrameCount blockStart = 0; blockStart + blockSize <= history.getNumFrames(); blockStart += blockSize)
+        {
+            fifo.ensureFreeSpace ((int) blockSize);
+            expect (fifo.write (history.getFrameRange ({ blockStart, blockStart + blockSize })));
+
+            // Each tap should read the frames written its delay ago, or silence before the start
+            for (choc::buffer::FrameCount delay : { 0u, 1u, 50u, 256u - blockSize })
+            {
+                expect (fifo.readTapOverwriting (delay, dest.getView()));
+
+                for (choc::buffer::FrameCount i = 0; i < blockSize; ++i)
+                {
+                    const auto pos = (int64_t) (blockStart + i) - (int64_t) delay;
+                    const auto expected = pos >= 0 ? history.getSample (0, (choc::buffer::FrameCount) pos) : 0.0f;
+                    expectEquals (dest.getSample (0, i), expected);
+                }
+            }
+
+            expect (! fifo.readTapOverwriting (256u - blockSize + 1, dest.getView()), "Taps longer than the capacity should fail");
+        }
+    }
+};
+
+static MirroredAudioFifoTests mirroredAudioFifoTests;
+
+#endif
+
+}}
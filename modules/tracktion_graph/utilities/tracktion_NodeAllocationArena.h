@@ -0,0 +1,154 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    A monotonic arena that Nodes can be allocated from when a graph is built.
+
+    Whilst a ScopedUse is alive on a thread, any Nodes created on that thread
+    are bump-allocated from the arena's blocks instead of the heap. This is
+    much cheaper than a heap allocation per Node and keeps Nodes that were
+    created together, and are usually processed together, close in memory.
+
+    Deleting a Node from an arena doesn't free anything, it just drops a
+    reference to the arena. The blocks are all freed at once when the last
+    Node and any other references are gone, so it doesn't matter which thread
+    or owner retires the graph.
+
+    Allocations from different threads are serialised with a lock so this
+    shouldn't be used for Nodes created on the audio thread.
+*/
+class NodeAllocationArena   : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<NodeAllocationArena>;
+
+    /** Creates an arena that allocates blocks of the given size. */
+    explicit NodeAllocationArena (size_t blockSizeToUse = 64 * 1024)
+        : blockSize (blockSizeToUse)
+    {
+    }
+
+    //==============================================================================
+    /** Makes Nodes created on this thread use an arena for the lifetime of this object.
+        Passing nullptr makes them use the heap. These can be nested.
+    */
+    struct ScopedUse
+    {
+        ScopedUse (NodeAllocationArena* arenaToUse)
+            : previous (std::exchange (getCurrentRef(), arenaToUse))
+        {
+        }
+
+        ~ScopedUse()
+        {
+            getCurrentRef() = previous;
+        }
+
+        NodeAllocationArena* const previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedUse)
+    };
+
+    /** Returns the arena being used on this thread, if there is one. */
+    static NodeAllocationArena* getCurrent()
+    {
+        return getCurrentRef();
+    }
+
+    //==============================================================================
+    /** Allocates some memory from the current arena or the heap if there isn't one.
+        This must be freed with deallocate.
+    */
+    static void* allocate (size_t numBytes)
+    {
+        auto arena = getCurrent();
+        auto block = arena != nullptr ? arena->allocateFromBlocks (headerSize + numBytes)
+                                      : ::operator new (headerSize + numBytes);
+
+        new (block) Header { arena };
+
+        if (arena != nullptr)
+            arena->incReferenceCount();
+
+        return static_cast<char*> (block) + headerSize;
+    }
+
+    /** Frees some memory returned by allocate. */
+    static void deallocate (void* data) noexcept
+    {
+        if (data == nullptr)
+            return;
+
+        auto block = static_cast<char*> (data) - headerSize;
+
+        if (auto arena = reinterpret_cast<Header*> (block)->arena)
+            arena->decReferenceCount();
+        else
+            ::operator delete (block);
+    }
+
+    /** Returns the number of bytes that have been allocated from this arena. */
+    size_t getNumBytesAllocated() const
+    {
+        const std::scoped_lock sl (mutex);
+        return numBytesAllocated;
+    }
+
+private:
+    //==============================================================================
+    struct Header
+    {
+        NodeAllocationArena* arena;
+    };
+
+    // Keeps the memory after the header aligned for any fundamental type
+    static constexpr size_t headerSize = alignof (std::max_align_t);
+    static_assert (sizeof (Header) <= headerSize);
+
+    const size_t blockSize;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t currentBlockSize = 0, positionInBlock = 0, numBytesAllocated = 0;
+
+    void* allocateFromBlocks (size_t numBytes)
+    {
+        numBytes = (numBytes + headerSize - 1) & ~(headerSize - 1);
+        const std::scoped_lock sl (mutex);
+
+        if (blocks.empty() || positionInBlock + numBytes > currentBlockSize)
+        {
+            currentBlockSize = std::max (blockSize, numBytes);
+            blocks.emplace_back (new char[currentBlockSize]);
+            positionInBlock = 0;
+        }
+
+        auto data = blocks.back().get() + positionInBlock;
+        positionInBlock += numBytes;
+        numBytesAllocated += numBytes;
+
+        return data;
+    }
+
+    static NodeAllocationArena*& getCurrentRef()
+    {
+        thread_local NodeAllocationArena* current = nullptr;
+        return current;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (NodeAllocationArena)
+};
+
+}} // namespace tracktion
@@ -0,0 +1,276 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#include "tracktion_PerformanceMeasurement.h"
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Collects the processing time of individual Nodes.
+
+    Set one of these on a player (e.g. LockFreeMultiThreadedNodePlayer::setNodeProfiler)
+    and, if TRACKTION_GRAPH_NODE_PROFILING is enabled, each Node will add an Event
+    every time it is processed. Events are pushed to a lock-free FIFO so this is
+    safe to use from multiple real-time threads.
+
+    Periodically call getStatistics from a non-real-time thread to collect the
+    pending Events and get the aggregated stats for each Node.
+*/
+class NodeProfiler
+{
+public:
+    //==============================================================================
+    /** Creates a NodeProfiler.
+        @param maxNumPendingEvents      The number of Events that can be added before
+                                        they have to be collected with getStatistics.
+                                        Any Events added after this will be dropped.
+        @param maxNumResultsPerNode     The number of recent results to keep for each
+                                        Node to calculate the percentiles from.
+    */
+    NodeProfiler (size_t maxNumPendingEvents = 16384,
+                  size_t maxNumResultsPerNode = 1024);
+
+    /** Enables or disables adding Events, enabled by default. */
+    void setEnabled (bool);
+
+    /** Returns true if Events are being added. */
+    bool isEnabled() const;
+
+    //==============================================================================
+    /** The timing of a single Node's process call. */
+    struct Event
+    {
+        size_t nodeID = 0;
+        std::thread::id threadID;
+        std::chrono::steady_clock::time_point startTime;
+        double durationSeconds = 0.0;
+        uint64_t durationCycles = 0;
+    };
+
+    /** Adds an Event to be collected.
+        This is real-time safe and can be called from any thread.
+        @returns false if the FIFO was full and the Event was dropped
+    */
+    bool addEvent (const Event&) noexcept;
+
+    /** Returns the number of Events that have been dropped because the FIFO was full. */
+    size_t getNumDroppedEvents() const;
+
+    //==============================================================================
+    /** The aggregated stats of a single Node. */
+    struct NodeStatistics
+    {
+        PerformanceMeasurement::Statistics statistics;  /**< The mean, min and max over all the Events. */
+        double p99Seconds = 0.0;                        /**< The 99th percentile of recent Events. */
+        uint64_t p99Cycles = 0;                         /**< The 99th percentile of recent Events. */
+    };
+
+    /** Collects any pending Events and returns the stats for each Node, keyed by nodeID.
+        This isn't real-time safe so should be called from a background or message thread.
+    */
+    std::unordered_map<size_t, NodeStatistics> getStatistics();
+
+    /** Collects any pending Events, returns the stats for each Node and then clears
+        them, so each call returns the stats since the last one.
+        This isn't real-time safe so should be called from a background or message thread.
+    */
+    std::unordered_map<size_t, NodeStatistics> getStatisticsAndReset();
+
+    /** Removes any pending Events and clears the accumulated stats. */
+    void reset();
+
+    //==============================================================================
+    /** Measures the time from construction to destruction and adds it as an Event.
+        If the profiler is nullptr or disabled this does nothing.
+    */
+    struct ScopedMeasurement
+    {
+        ScopedMeasurement (NodeProfiler*, size_t nodeID) noexcept;
+        ~ScopedMeasurement() noexcept;
+
+        NodeProfiler* const profiler;
+        const size_t nodeID;
+        std::chrono::steady_clock::time_point startTime;
+        uint64_t startCycles = 0;
+    };
+
+private:
+    //==============================================================================
+    struct NodeHistory
+    {
+        PerformanceMeasurement::Statistics statistics;
+        std::vector<double> recentSeconds;
+        std::vector<uint64_t> recentCycles;
+        size_t nextIndex = 0;
+    };
+
+    rigtorp::MPMCQueue<Event> pendingEvents;
+    const size_t maxNumResultsPerNode;
+    std::atomic<bool> enabled { true };
+    std::atomic<size_t> numDroppedEvents { 0 };
+
+    std::mutex historyMutex;
+    std::unordered_map<size_t, NodeHistory> histories;
+
+    void collectPendingEvents();
+    std::unordered_map<size_t, NodeStatistics> createStatistics() const;
+};
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+
+inline NodeProfiler::NodeProfiler (size_t maxNumPendingEvents, size_t maxNumResults)
+    : pendingEvents (std::max ((size_t) 1, maxNumPendingEvents)),
+      maxNumResultsPerNode (std::max ((size_t) 1, maxNumResults))
+{
+}
+
+inline void NodeProfiler::setEnabled (bool shouldBeEnabled)
+{
+    enabled.store (shouldBeEnabled, std::memory_order_release);
+}
+
+inline bool NodeProfiler::isEnabled() const
+{
+    return enabled.load (std::memory_order_acquire);
+}
+
+inline bool NodeProfiler::addEvent (const Event& event) noexcept
+{
+    if (pendingEvents.try_push (event))
+        return true;
+
+    numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+    return false;
+}
+
+inline size_t NodeProfiler::getNumDroppedEvents() const
+{
+    return numDroppedEvents.load (std::memory_order_relaxed);
+}
+
+inline std::unordered_map<size_t, NodeProfiler::NodeStatistics> NodeProfiler::getStatistics()
+{
+    const std::scoped_lock sl (historyMutex);
+    collectPendingEvents();
+
+    return createStatistics();
+}
+
+inline std::unordered_map<size_t, NodeProfiler::NodeStatistics> NodeProfiler::getStatisticsAndReset()
+{
+    const std::scoped_lock sl (historyMutex);
+    collectPendingEvents();
+
+    auto results = createStatistics();
+    histories.clear();
+
+    return results;
+}
+
+inline std::unordered_map<size_t, NodeProfiler::NodeStatistics> NodeProfiler::createStatistics() const
+{
+    std::unordered_map<size_t, NodeStatistics> results;
+    results.reserve (histories.size());
+
+    for (auto& [nodeID, history] : histories)
+    {
+        auto& result = results[nodeID];
+        result.statistics = history.statistics;
+
+        if (history.recentSeconds.empty())
+            continue;
+
+        const auto p99Index = (history.recentSeconds.size() * 99) / 100;
+
+        auto seconds = history.recentSeconds;
+        std::nth_element (seconds.begin(), seconds.begin() + (std::ptrdiff_t) p99Index, seconds.end());
+        result.p99Seconds = seconds[p99Index];
+
+        auto cycles = history.recentCycles;
+        std::nth_element (cycles.begin(), cycles.begin() + (std::ptrdiff_t) p99Index, cycles.end());
+        result.p99Cycles = cycles[p99Index];
+    }
+
+    return results;
+}
+
+inline void NodeProfiler::reset()
+{
+    const std::scoped_lock sl (historyMutex);
+
+    for (Event event; pendingEvents.try_pop (event);)
+    {}
+
+    histories.clear();
+    numDroppedEvents.store (0, std::memory_order_relaxed);
+}
+
+inline void NodeProfiler::collectPendingEvents()
+{
+    for (Event event; pendingEvents.try_pop (event);)
+    {
+        auto& history = histories[event.nodeID];
+        history.statistics.addResult (event.durationSeconds, event.durationCycles);
+
+        if (history.recentSeconds.size() < maxNumResultsPerNode)
+        {
+            history.recentSeconds.push_back (event.durationSeconds);
+            history.recentCycles.push_back (event.durationCycles);
+        }
+        else
+        {
+            history.recentSeconds[history.nextIndex] = event.durationSeconds;
+            history.recentCycles[history.nextIndex] = event.durationCycles;
+        }
+
+        history.nextIndex = (history.nextIndex + 1) % maxNumResultsPerNode;
+    }
+}
+
+//==============================================================================
+inline NodeProfiler::ScopedMeasurement::ScopedMeasurement (NodeProfiler* p, size_t nodeIDToUse) noexcept
+    : profiler (p != nullptr && p->isEnabled() ? p : nullptr), nodeID (nodeIDToUse)
+{
+    if (profiler == nullptr)
+        return;
+
+    startTime = std::chrono::steady_clock::now();
+    startCycles = rdtsc();
+}
+
+inline NodeProfiler::ScopedMeasurement::~ScopedMeasurement() noexcept
+{
+    if (profiler == nullptr)
+        return;
+
+    const auto endCycles = rdtsc();
+    const auto endTime = std::chrono::steady_clock::now();
+
+    profiler->addEvent ({ nodeID, std::this_thread::get_id(), startTime,
+                          std::chrono::duration<double> (endTime - startTime).count(),
+                          endCycles - startCycles });
+}
+
+}}
@@ -0,0 +1,129 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_NODEPROFILER
+
+class NodeProfilerTests  : public juce::UnitTest
+{
+public:
+    NodeProfilerTests()
+        : juce::UnitTest ("NodeProfiler", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runStatisticsTests();
+        runDroppedEventTests();
+    }
+
+private:
+    static NodeProfiler::Event createEvent (size_t nodeID, double seconds)
+    {
+        return { nodeID, std::this_thread::get_id(), std::chrono::steady_clock::now(),
+                 seconds, (uint64_t) (seconds * 1'000'000.0) };
+    }
+
+    void runStatisticsTests()
+    {
+        beginTest ("Statistics");
+        {
+            NodeProfiler profiler (1024, 100);
+
+            for (int i = 1; i <= 100; ++i)
+                expect (profiler.addEvent (createEvent (1, i / 1000.0)));
+
+            expect (profiler.addEvent (createEvent (2, 0.5)));
+
+            auto stats = profiler.getStatistics();
+            expectEquals<int> ((int) stats.size(), 2);
+
+            auto& node1 = stats[1];
+            expectEquals<int> ((int) node1.statistics.numRuns, 100);
+            expectWithinAbsoluteError (node1.statistics.meanSeconds, 0.0505, 0.000001);
+            expectWithinAbsoluteError (node1.statistics.maximumSeconds, 0.1, 0.000001);
+            expectWithinAbsoluteError (node1.p99Seconds, 0.1, 0.000001);
+            expectEquals<int> ((int) node1.p99Cycles, 100'000);
+
+            auto& node2 = stats[2];
+            expectEquals<int> ((int) node2.statistics.numRuns, 1);
+            expectWithinAbsoluteError (node2.p99Seconds, 0.5, 0.000001);
+
+            // Statistics should accumulate between calls
+            expect (profiler.addEvent (createEvent (2, 0.25)));
+            stats = profiler.getStatistics();
+            expectEquals<int> ((int) stats[2].statistics.numRuns, 2);
+            expectWithinAbsoluteError (stats[2].statistics.minimumSeconds, 0.25, 0.000001);
+
+            profiler.reset();
+            expect (profiler.getStatistics().empty());
+
+            // Resetting statistics should only return the Events since the last call
+            expect (profiler.addEvent (createEvent (3, 0.1)));
+            expectEquals<int> ((int) profiler.getStatisticsAndReset()[3].statistics.numRuns, 1);
+            expect (profiler.getStatistics().empty());
+
+            expect (profiler.addEvent (createEvent (3, 0.2)));
+            stats = profiler.getStatisticsAndReset();
+            expectEquals<int> ((int) stats[3].statistics.numRuns, 1);
+            expectWithinAbsoluteError (stats[3].statistics.totalSeconds, 0.2, 0.000001);
+        }
+
+        beginTest ("Scoped measurement");
+        {
+            NodeProfiler profiler;
+
+            {
+                const NodeProfiler::ScopedMeasurement sm (&profiler, 42);
+                std::this_thread::sleep_for (std::chrono::milliseconds (1));
+            }
+
+            profiler.setEnabled (false);
+
+            {
+                const NodeProfiler::ScopedMeasurement sm (&profiler, 42);
+            }
+
+            {
+                const NodeProfiler::ScopedMeasurement sm (nullptr, 42);
+            }
+
+            auto stats = profiler.getStatistics();
+            expectEquals<int> ((int) stats.size(), 1);
+            expectEquals<int> ((int) stats[42].statistics.numRuns, 1);
+            expectGreaterOrEqual (stats[42].statistics.meanSeconds, 0.001);
+        }
+    }
+
+    void runDroppedEventTests()
+    {
+        beginTest ("Dropped events");
+        {
+            NodeProfiler profiler (4);
+
+            for (int i = 0; i < 4; ++i)
+                expect (profiler.addEvent (createEvent (1, 0.001)));
+
+            expect (! profiler.addEvent (createEvent (1, 0.001)));
+            expectEquals<int> ((int) profiler.getNumDroppedEvents(), 1);
+
+            expectEquals<int> ((int) profiler.getStatistics()[1].statistics.numRuns, 4);
+            expect (profiler.addEvent (createEvent (1, 0.001)));
+        }
+    }
+};
+
+static NodeProfilerTests nodeProfilerTests;
+
+#endif
+
+}}
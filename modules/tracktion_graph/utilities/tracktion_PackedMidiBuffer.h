@@ -0,0 +1,291 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A fixed-capacity buffer of MIDI events stored contiguously.
+
+    Unlike a MidiMessageArray, which holds a juce::MidiMessage per event, each
+    Event here is a small POD with the timestamp, MPESourceID and the bytes of
+    short messages stored inline. Longer messages such as sysex are stored
+    out-of-line in a separate byte pool.
+
+    Storage is only allocated by the constructor or reserve so, once sized, adding,
+    merging, sorting and converting events never allocates. If an event doesn't fit
+    it's dropped and add returns false.
+*/
+class PackedMidiBuffer
+{
+public:
+    //==============================================================================
+    /** The maximum number of bytes that are stored inline in an Event. */
+    static constexpr size_t maxInlineSize = 8;
+
+    /** A single MIDI event. */
+    struct Event
+    {
+        double timeStamp = 0.0;
+        MPESourceID mpeSourceID = {};
+        uint32_t size = 0;
+
+        union
+        {
+            uint8_t bytes[maxInlineSize];   /**< Used if size <= maxInlineSize. */
+            uint32_t sysexOffset;           /**< The offset in to the sysex pool otherwise. */
+        };
+
+        /** Returns true if the data is stored in the sysex pool. */
+        bool isStoredOutOfLine() const noexcept     { return size > maxInlineSize; }
+    };
+
+    //==============================================================================
+    /** Creates an empty buffer with no capacity. */
+    PackedMidiBuffer() = default;
+
+    /** Creates a buffer with space for the given number of events and sysex bytes. */
+    PackedMidiBuffer (size_t maxNumEvents, size_t maxNumSysexBytes);
+
+    /** Allocates space for the given number of events and sysex bytes.
+        This will allocate so should be called from prepareToPlay or similar,
+        not the audio thread.
+    */
+    void reserve (size_t maxNumEvents, size_t maxNumSysexBytes);
+
+    /** Returns the maximum number of events this can hold. */
+    size_t getEventCapacity() const noexcept                { return events.capacity(); }
+
+    /** Returns the maximum number of out-of-line bytes this can hold. */
+    size_t getSysexCapacity() const noexcept                { return sysexPool.capacity(); }
+
+    //==============================================================================
+    bool isEmpty() const noexcept                           { return events.empty(); }
+    bool isNotEmpty() const noexcept                        { return ! events.empty(); }
+    size_t size() const noexcept                            { return events.size(); }
+
+    const Event& operator[] (size_t i) const noexcept       { return events[i]; }
+    const Event* begin() const noexcept                     { return events.data(); }
+    const Event* end() const noexcept                       { return events.data() + events.size(); }
+
+    /** Returns the bytes of an Event in this buffer. */
+    const uint8_t* getData (const Event&) const noexcept;
+
+    /** Returns a juce::MidiMessage for an Event in this buffer.
+        This won't allocate for events that are stored inline.
+    */
+    juce::MidiMessage toMidiMessage (const Event&) const;
+
+    /** Returns true if an Event in this buffer is a note-on with a non-zero velocity. */
+    bool isNoteOn (const Event&) const noexcept;
+
+    /** Returns true if an Event in this buffer is a note-off or a note-on with zero velocity. */
+    bool isNoteOff (const Event&) const noexcept;
+
+    //==============================================================================
+    /** Removes all the events, keeping the allocated storage. */
+    void clear() noexcept;
+
+    /** Adds an event, returning false if there wasn't space for it. */
+    bool add (const uint8_t* data, size_t numBytes, double timeStamp, MPESourceID) noexcept;
+
+    /** Adds a juce::MidiMessage using its timestamp, returning false if there wasn't space for it. */
+    bool add (const juce::MidiMessage&, MPESourceID) noexcept;
+
+    /** Adds a juce::MidiMessage with a new timestamp, returning false if there wasn't space for it. */
+    bool add (const juce::MidiMessage&, double timeStamp, MPESourceID) noexcept;
+
+    /** Adds a MidiMessageWithSource, returning false if there wasn't space for it. */
+    bool add (const MidiMessageWithSource&) noexcept;
+
+    //==============================================================================
+    /** Adds all the events from another buffer.
+        @returns false if any events had to be dropped
+    */
+    bool mergeFrom (const PackedMidiBuffer&) noexcept;
+
+    /** Adds all the events from a MidiMessageArray.
+        @returns false if any events had to be dropped
+    */
+    bool mergeFrom (const MidiMessageArray&) noexcept;
+
+    /** Adds all the events in this buffer to a MidiMessageArray.
+        This won't allocate if the destination has enough space reserved.
+    */
+    void mergeInto (MidiMessageArray&) const;
+
+    /** Adds a delta to all the timestamps. */
+    void addToTimestamps (double delta) noexcept;
+
+    /** Sorts the events by timestamp, putting note-offs before any other events at
+        the same time. This is stable and doesn't allocate.
+    */
+    void sortByTimestamp() noexcept;
+
+    /** Set to true if the buffer represents an all-notes-off condition. */
+    bool isAllNotesOff = false;
+
+private:
+    //==============================================================================
+    std::vector<Event> events;
+    std::vector<uint8_t> sysexPool;
+};
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+
+inline PackedMidiBuffer::PackedMidiBuffer (size_t maxNumEvents, size_t maxNumSysexBytes)
+{
+    reserve (maxNumEvents, maxNumSysexBytes);
+}
+
+inline void PackedMidiBuffer::reserve (size_t maxNumEvents, size_t maxNumSysexBytes)
+{
+    events.reserve (maxNumEvents);
+    sysexPool.reserve (maxNumSysexBytes);
+}
+
+inline const uint8_t* PackedMidiBuffer::getData (const Event& e) const noexcept
+{
+    return e.isStoredOutOfLine() ? sysexPool.data() + e.sysexOffset
+                                 : e.bytes;
+}
+
+inline juce::MidiMessage PackedMidiBuffer::toMidiMessage (const Event& e) const
+{
+    return juce::MidiMessage (getData (e), (int) e.size, e.timeStamp);
+}
+
+inline bool PackedMidiBuffer::isNoteOn (const Event& e) const noexcept
+{
+    auto data = getData (e);
+    return e.size >= 3 && (data[0] & 0xf0) == 0x90 && data[2] != 0;
+}
+
+inline bool PackedMidiBuffer::isNoteOff (const Event& e) const noexcept
+{
+    auto data = getData (e);
+    return e.size >= 3 && ((data[0] & 0xf0) == 0x80 || ((data[0] & 0xf0) == 0x90 && data[2] == 0));
+}
+
+inline void PackedMidiBuffer::clear() noexcept
+{
+    isAllNotesOff = false;
+    events.clear();
+    sysexPool.clear();
+}
+
+inline bool PackedMidiBuffer::add (const uint8_t* data, size_t numBytes, double timeStamp, MPESourceID mpeSourceID) noexcept
+{
+    if (numBytes == 0 || events.size() == events.capacity())
+        return false;
+
+    Event e;
+    e.timeStamp = timeStamp;
+    e.mpeSourceID = mpeSourceID;
+    e.size = (uint32_t) numBytes;
+
+    if (numBytes <= maxInlineSize)
+    {
+        std::memcpy (e.bytes, data, numBytes);
+    }
+    else
+    {
+        if (sysexPool.size() + numBytes > sysexPool.capacity())
+            return false;
+
+        e.sysexOffset = (uint32_t) sysexPool.size();
+        sysexPool.insert (sysexPool.end(), data, data + numBytes);
+    }
+
+    events.push_back (e);
+    return true;
+}
+
+inline bool PackedMidiBuffer::add (const juce::MidiMessage& m, MPESourceID mpeSourceID) noexcept
+{
+    return add (m, m.getTimeStamp(), mpeSourceID);
+}
+
+inline bool PackedMidiBuffer::add (const juce::MidiMessage& m, double timeStamp, MPESourceID mpeSourceID) noexcept
+{
+    return add (m.getRawData(), (size_t) m.getRawDataSize(), timeStamp, mpeSourceID);
+}
+
+inline bool PackedMidiBuffer::add (const MidiMessageWithSource& m) noexcept
+{
+    return add (m, m.mpeSourceID);
+}
+
+inline bool PackedMidiBuffer::mergeFrom (const PackedMidiBuffer& source) noexcept
+{
+    isAllNotesOff = isAllNotesOff || source.isAllNotesOff;
+    bool addedAll = true;
+
+    for (auto& e : source)
+        addedAll = add (source.getData (e), e.size, e.timeStamp, e.mpeSourceID) && addedAll;
+
+    return addedAll;
+}
+
+inline bool PackedMidiBuffer::mergeFrom (const MidiMessageArray& source) noexcept
+{
+    isAllNotesOff = isAllNotesOff || source.isAllNotesOff;
+    bool addedAll = true;
+
+    for (auto& m : source)
+        addedAll = add (m) && addedAll;
+
+    return addedAll;
+}
+
+inline void PackedMidiBuffer::mergeInto (MidiMessageArray& dest) const
+{
+    dest.isAllNotesOff = dest.isAllNotesOff || isAllNotesOff;
+    dest.reserve (dest.size() + (int) events.size());
+
+    for (auto& e : events)
+        dest.addMidiMessage (toMidiMessage (e), e.mpeSourceID);
+}
+
+inline void PackedMidiBuffer::addToTimestamps (double delta) noexcept
+{
+    for (auto& e : events)
+        e.timeStamp += delta;
+}
+
+inline void PackedMidiBuffer::sortByTimestamp() noexcept
+{
+    // Only note-offs are moved ahead of events at the same time. Comparing note-offs
+    // with note-ons alone wouldn't be a strict weak ordering if other events were
+    // between them, so a note-off could still end up after a note-on.
+    choc::sorting::stable_sort (events.begin(), events.end(), [this] (const Event& a, const Event& b)
+    {
+        if (a.timeStamp == b.timeStamp)
+            return isNoteOff (a) && ! isNoteOff (b);
+
+        return a.timeStamp < b.timeStamp;
+    });
+}
+
+}} // namespace tracktion
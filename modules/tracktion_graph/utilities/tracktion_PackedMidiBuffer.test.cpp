@@ -0,0 +1,183 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_PACKEDMIDIBUFFER
+
+class PackedMidiBufferTests  : public juce::UnitTest
+{
+public:
+    PackedMidiBufferTests()
+        : juce::UnitTest ("PackedMidiBuffer", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runAddTests();
+        runSortTests();
+        runConversionTests();
+    }
+
+private:
+    static juce::MidiMessage createSysex (int numBytes)
+    {
+        juce::HeapBlock<uint8_t> data ((size_t) numBytes);
+
+        for (int i = 0; i < numBytes; ++i)
+            data[i] = (uint8_t) (i % 0x7f);
+
+        return juce::MidiMessage::createSysExMessage (data.get(), numBytes);
+    }
+
+    void runAddTests()
+    {
+        beginTest ("Adding events");
+        {
+            PackedMidiBuffer buffer (3, 64);
+            expect (buffer.isEmpty());
+
+            const auto noteOn = juce::MidiMessage::noteOn (1, 60, (uint8_t) 100);
+            const auto sysex = createSysex (20);
+
+            expect (buffer.add (noteOn, 0.5, 1));
+            expect (buffer.add (sysex, 1.0, 2));
+            expect (buffer.add (juce::MidiMessage::noteOff (1, 60), 1.5, 1));
+            expectEquals ((int) buffer.size(), 3);
+
+            expect (! buffer[0].isStoredOutOfLine());
+            expect (buffer[1].isStoredOutOfLine());
+            expectEquals (buffer[1].mpeSourceID, (MPESourceID) 2);
+            expect (buffer.toMidiMessage (buffer[0]).getDescription() == noteOn.getDescription());
+            expect (std::memcmp (buffer.getData (buffer[1]), sysex.getRawData(), (size_t) sysex.getRawDataSize()) == 0);
+
+            // Full, so events should be dropped rather than allocating
+            expect (! buffer.add (noteOn, 2.0, 1));
+            expectEquals ((int) buffer.size(), 3);
+            expectEquals ((int) buffer.getEventCapacity(), 3);
+
+            buffer.clear();
+            expect (buffer.isEmpty());
+            expectEquals ((int) buffer.getEventCapacity(), 3);
+        }
+
+        beginTest ("Sysex pool capacity");
+        {
+            PackedMidiBuffer buffer (4, 24);
+            expect (buffer.add (createSysex (20), 0));
+            expect (! buffer.add (createSysex (20), 0));
+            expect (buffer.add (juce::MidiMessage::noteOn (1, 60, (uint8_t) 100), 0));
+            expectEquals ((int) buffer.size(), 2);
+        }
+    }
+
+    void runSortTests()
+    {
+        beginTest ("Sorting");
+        {
+            PackedMidiBuffer buffer (4, 0);
+            buffer.add (juce::MidiMessage::noteOn (1, 62, (uint8_t) 100), 1.0, 0);
+            buffer.add (juce::MidiMessage::controllerEvent (1, 7, 64), 1.0, 0);
+            buffer.add (juce::MidiMessage::noteOff (1, 60), 1.0, 0);
+            buffer.add (juce::MidiMessage::noteOn (1, 60, (uint8_t) 100), 0.5, 0);
+            buffer.sortByTimestamp();
+
+            expectEquals (buffer[0].timeStamp, 0.5);
+            expect (buffer.toMidiMessage (buffer[1]).isNoteOff());
+            expect (buffer.toMidiMessage (buffer[2]).isNoteOn());
+            expect (buffer.toMidiMessage (buffer[3]).isController());
+        }
+
+        beginTest ("Sorting note-offs with other events at the same time");
+        {
+            // Controllers between note-ons and note-offs mustn't stop the note-offs moving first.
+            // Each event has a unique note number or controller value to check the order by.
+            constexpr int numEvents = 120;
+            PackedMidiBuffer buffer (numEvents, 0);
+            juce::Random random (42);
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                const auto time = (double) random.nextInt (4);
+
+                switch (random.nextInt (4))
+                {
+                    case 0:     buffer.add (juce::MidiMessage::noteOn (1, i, (uint8_t) 100), time, 0); break;
+                    case 1:     buffer.add (juce::MidiMessage::noteOff (1, i), time, 0); break;
+                    case 2:     buffer.add (juce::MidiMessage::noteOn (1, i, (uint8_t) 0), time, 0); break;
+                    default:    buffer.add (juce::MidiMessage::controllerEvent (1, 7, i), time, 0); break;
+                }
+            }
+
+            auto getID = [&buffer] (const PackedMidiBuffer::Event& e)
+            {
+                auto data = buffer.getData (e);
+                return (data[0] & 0xf0) == 0xb0 ? data[2] : data[1];
+            };
+
+            // The expected order: by time, then note-offs, then everything else, otherwise unchanged
+            std::vector<std::tuple<double, bool, int>> expected;
+
+            for (int i = 0; i < numEvents; ++i)
+                expected.emplace_back (buffer[(size_t) i].timeStamp, ! buffer.isNoteOff (buffer[(size_t) i]), i);
+
+            std::sort (expected.begin(), expected.end());
+
+            buffer.sortByTimestamp();
+            expectEquals ((int) buffer.size(), numEvents);
+
+            bool allMatch = true;
+
+            for (size_t i = 0; i < buffer.size(); ++i)
+                allMatch = allMatch && getID (buffer[i]) == std::get<2> (expected[i]);
+
+            expect (allMatch);
+        }
+    }
+
+    void runConversionTests()
+    {
+        beginTest ("Converting to and from MidiMessageArray");
+        {
+            MidiMessageArray source;
+            source.addMidiMessage (juce::MidiMessage::noteOn (1, 60, (uint8_t) 100), 0.25, 3);
+            source.addMidiMessage (createSysex (32), 0.5, 4);
+            source.isAllNotesOff = true;
+
+            PackedMidiBuffer buffer (8, 64);
+            expect (buffer.mergeFrom (source));
+            expect (buffer.isAllNotesOff);
+
+            PackedMidiBuffer copy (8, 64);
+            expect (copy.mergeFrom (buffer));
+            copy.addToTimestamps (1.0);
+
+            MidiMessageArray dest;
+            copy.mergeInto (dest);
+            expectEquals (dest.size(), 2);
+            expect (dest.isAllNotesOff);
+
+            for (int i = 0; i < dest.size(); ++i)
+            {
+                expectEquals (dest[i].getTimeStamp(), source[i].getTimeStamp() + 1.0);
+                expectEquals (dest[i].mpeSourceID, source[i].mpeSourceID);
+                expectEquals (dest[i].getRawDataSize(), source[i].getRawDataSize());
+                expect (std::memcmp (dest[i].getRawData(), source[i].getRawData(), (size_t) source[i].getRawDataSize()) == 0);
+            }
+        }
+    }
+};
+
+static PackedMidiBufferTests packedMidiBufferTests;
+
+#endif
+
+}}
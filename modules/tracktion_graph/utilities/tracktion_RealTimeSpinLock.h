@@ -11,12 +11,22 @@
 #pragma once
 
 #include "../../tracktion_core/utilities/tracktion_CPU.h"
+#include <thread>
 
 namespace tracktion { inline namespace graph
 {
 
 /** A basic spin lock that uses an atomic_flag to store the locked state so should never result in a system call.
     Note that only try_lock should be called from a real-time thread. If you can't take the lock you should exit quickly.
+
+    Whilst waiting, lock backs off exponentially, pausing for longer between each
+    attempt and eventually yielding the thread. That gives a thread holding the
+    lock a chance to run and finish with it rather than being starved by a
+    waiter spinning on the same core. Yielding only helps threads of the same or
+    higher priority though, which is why real-time threads should use try_lock.
+
+    The number of contended locks and failed try_locks are counted so contention
+    can be measured. These are only updated when the lock is contended.
 */
 class RealTimeSpinLock
 {
@@ -24,18 +34,25 @@ public:
     /** Takes the lock, blocking if necessary. */
     void lock() noexcept
     {
-        for (;;)
+        if (try_lock())
+            return;
+
+        numContendedLocks.fetch_add (1, std::memory_order_relaxed);
+
+        for (int numPauses = 1;; numPauses = std::min (numPauses * 2, maxPausesBeforeYielding))
         {
-            for (int i = 0; i < 5; ++i)
-                if (try_lock())
-                    return;
+            // Spin on a load rather than the exchange so the cache line isn't contended
+            if (! flag.test (std::memory_order_relaxed) && try_lock())
+                return;
 
-            for (int i = 0; i < 10; ++i)
+            if (numPauses < maxPausesBeforeYielding)
             {
-                tracktion::core::pause();
-
-                if (try_lock())
-                    return;
+                for (int i = 0; i < numPauses; ++i)
+                    tracktion::core::pause();
+            }
+            else
+            {
+                std::this_thread::yield();
             }
         }
     }
@@ -49,11 +66,32 @@ public:
     /** Attempts to take the lock once, returning true if successful. */
     bool try_lock() noexcept
     {
-        return ! flag.test_and_set (std::memory_order_acquire);
+        if (! flag.test_and_set (std::memory_order_acquire))
+            return true;
+
+        numFailedTryLocks.fetch_add (1, std::memory_order_relaxed);
+        return false;
+    }
+
+    //==============================================================================
+    /** Returns the number of calls to lock that had to wait for the lock. */
+    uint32_t getNumContendedLocks() const noexcept      { return numContendedLocks.load (std::memory_order_relaxed); }
+
+    /** Returns the number of attempts to take the lock that failed, including those made whilst waiting in lock. */
+    uint32_t getNumFailedTryLocks() const noexcept      { return numFailedTryLocks.load (std::memory_order_relaxed); }
+
+    /** Resets the contention counters. */
+    void resetContentionCounters() noexcept
+    {
+        numContendedLocks.store (0, std::memory_order_relaxed);
+        numFailedTryLocks.store (0, std::memory_order_relaxed);
     }
 
 private:
+    static constexpr int maxPausesBeforeYielding = 64;
+
     std::atomic_flag flag = ATOMIC_FLAG_INIT;
+    std::atomic<uint32_t> numContendedLocks { 0 }, numFailedTryLocks { 0 };
 };
 
 }}
@@ -0,0 +1,188 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_REALTIMESPINLOCK
+
+//==============================================================================
+//==============================================================================
+class RealTimeSpinLockTests  : public juce::UnitTest
+{
+public:
+    RealTimeSpinLockTests()
+        : juce::UnitTest ("RealTimeSpinLock", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        runContentionCounterTests();
+        runPlayerTests();
+    }
+
+private:
+    //==============================================================================
+    /** Outputs a constant level, waiting in process until it's released. */
+    class BlockingNode final  : public Node
+    {
+    public:
+        BlockingNode (std::atomic<bool>& isProcessingToUse, std::atomic<bool>& isReleasedToUse)
+            : isProcessing (isProcessingToUse), isReleased (isReleasedToUse)
+        {
+        }
+
+        NodeProperties getNodeProperties() override
+        {
+            NodeProperties props;
+            props.hasAudio = true;
+            props.numberOfChannels = 1;
+            props.nodeID = 1;
+            return props;
+        }
+
+        std::vector<Node*> getDirectInputNodes() override   { return {}; }
+        bool isReadyToProcess() override                    { return true; }
+
+        void process (ProcessContext& pc) override
+        {
+            isProcessing = true;
+
+            while (! isReleased)
+                std::this_thread::sleep_for (std::chrono::milliseconds (1));
+
+            for (choc::buffer::ChannelCount chan = 0; chan < pc.buffers.audio.getNumChannels(); ++chan)
+                for (choc::buffer::FrameCount i = 0; i < pc.buffers.audio.getNumFrames(); ++i)
+                    pc.buffers.audio.getSample (chan, i) = 0.5f;
+        }
+
+    private:
+        std::atomic<bool>& isProcessing;
+        std::atomic<bool>& isReleased;
+    };
+
+    //==============================================================================
+    void runContentionCounterTests()
+    {
+        beginTest ("Uncontended locks aren't counted");
+        {
+            RealTimeSpinLock lock;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                lock.lock();
+                lock.unlock();
+                expect (lock.try_lock());
+                lock.unlock();
+            }
+
+            expectEquals ((int) lock.getNumContendedLocks(), 0);
+            expectEquals ((int) lock.getNumFailedTryLocks(), 0);
+        }
+
+        beginTest ("Failed try_locks are counted");
+        {
+            RealTimeSpinLock lock;
+            lock.lock();
+            expect (! lock.try_lock());
+            expect (! lock.try_lock());
+            expectEquals ((int) lock.getNumFailedTryLocks(), 2);
+            expectEquals ((int) lock.getNumContendedLocks(), 0);
+            lock.unlock();
+
+            lock.resetContentionCounters();
+            expectEquals ((int) lock.getNumFailedTryLocks(), 0);
+        }
+
+        beginTest ("Contended locks are counted");
+        {
+            RealTimeSpinLock lock;
+            std::atomic<bool> isWaiting { false }, hasLocked { false };
+            lock.lock();
+
+            std::thread waitingThread ([&]
+                                       {
+                                           isWaiting = true;
+                                           lock.lock();
+                                           hasLocked = true;
+                                           lock.unlock();
+                                       });
+
+            // Hold the lock until the other thread has had to wait for it
+            while (! isWaiting || lock.getNumContendedLocks() == 0)
+                std::this_thread::sleep_for (std::chrono::milliseconds (1));
+
+            expect (! hasLocked);
+            lock.unlock();
+            waitingThread.join();
+
+            expect (hasLocked);
+            expectEquals ((int) lock.getNumContendedLocks(), 1);
+            expect (lock.getNumFailedTryLocks() >= 1);
+        }
+    }
+
+    void runPlayerTests()
+    {
+        beginTest ("Players output silence when they can't take their lock");
+        {
+            constexpr int blockSize = 256;
+            const auto numFrames = (choc::buffer::FrameCount) blockSize;
+            std::atomic<bool> isProcessing { false }, isReleased { false };
+
+            LockFreeMultiThreadedNodePlayer player;
+            player.setNumThreads (0);
+            player.setNode (std::make_unique<BlockingNode> (isProcessing, isReleased), 44100.0, blockSize);
+
+            // Processing a block on another thread holds the player's lock until the Node is released
+            choc::buffer::ChannelArrayBuffer<float> blockedBuffer (1, numFrames);
+            tracktion_engine::MidiMessageArray blockedMidi;
+            blockedBuffer.clear();
+
+            std::thread blockedThread ([&]
+                                       {
+                                           player.process ({ numFrames, { 0, blockSize }, { blockedBuffer.getView(), blockedMidi } });
+                                       });
+
+            while (! isProcessing)
+                std::this_thread::sleep_for (std::chrono::milliseconds (1));
+
+            // Anything left in the buffers would be output so they should be cleared
+            choc::buffer::ChannelArrayBuffer<float> buffer (1, numFrames);
+            tracktion_engine::MidiMessageArray midi;
+
+            for (choc::buffer::FrameCount i = 0; i < numFrames; ++i)
+                buffer.getSample (0, i) = 1.0f;
+
+            midi.addMidiMessage (juce::MidiMessage::noteOn (1, 60, 1.0f), 0.0, {});
+
+            expectEquals (player.process ({ numFrames, { blockSize, blockSize * 2 }, { buffer.getView(), midi } }), -1);
+            expect (midi.isEmpty());
+
+            float maxLevel = 0.0f;
+
+            for (choc::buffer::FrameCount i = 0; i < numFrames; ++i)
+                maxLevel = std::max (maxLevel, std::abs (buffer.getSample (0, i)));
+
+            expectEquals (maxLevel, 0.0f);
+
+            isReleased = true;
+            blockedThread.join();
+            expectEquals (blockedBuffer.getSample (0, numFrames - 1), 0.5f);
+        }
+    }
+};
+
+static RealTimeSpinLockTests realTimeSpinLockTests;
+
+#endif
+
+}}
@@ -13,6 +13,39 @@
 #include "../3rd_party/concurrentqueue.h"
 #include "../3rd_party/lightweightsemaphore.h"
 
+#if defined (__linux__)
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #define TRACKTION_ADDRESS_WAIT 1
+#elif defined (_WIN32)
+ // These are declared here rather than including windows.h, as moodycamel does for its semaphore
+ extern "C"
+ {
+     __declspec(dllimport) int __stdcall WaitOnAddress (volatile void* address, void* compareAddress, size_t addressSize, unsigned long milliseconds);
+     __declspec(dllimport) void __stdcall WakeByAddressSingle (void* address);
+ }
+
+ #ifdef _MSC_VER
+  #pragma comment (lib, "Synchronization.lib")
+ #endif
+
+ #define TRACKTION_ADDRESS_WAIT 1
+#elif defined (__APPLE__) && __has_include(<os/os_sync_wait_on_address.h>)
+ #include <os/os_sync_wait_on_address.h>
+ #include <os/clock.h>
+
+ // Only available from macOS 14.4 and iOS 17.4 so earlier targets use the mach semaphore
+ #if (defined (__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 140400) \
+     || (defined (__IPHONE_OS_VERSION_MIN_REQUIRED) && __IPHONE_OS_VERSION_MIN_REQUIRED >= 170400)
+  #define TRACKTION_ADDRESS_WAIT 1
+ #endif
+#endif
+
+#ifndef TRACKTION_ADDRESS_WAIT
+ #define TRACKTION_ADDRESS_WAIT 0
+#endif
+
 namespace tracktion { inline namespace graph
 {
 
@@ -49,10 +82,232 @@ void Semaphore::signal (int count)
 
 
 //==============================================================================
+//==============================================================================
+namespace detail
+{
+   #if TRACKTION_ADDRESS_WAIT
+    static_assert (sizeof (std::atomic<int32_t>) == sizeof (int32_t) && std::atomic<int32_t>::is_always_lock_free);
+
+    /** Blocks whilst an atomic holds an expected value.
+        This can return spuriously so callers must check the value again.
+        @param timeoutUs    The maximum time to wait, or -1 to wait indefinitely
+    */
+    inline void waitOnAddress (std::atomic<int32_t>& value, int32_t expected, std::int64_t timeoutUs)
+    {
+        auto address = reinterpret_cast<int32_t*> (&value);
+
+       #if defined (__linux__)
+        timespec timeout;
+        timeout.tv_sec = (time_t) (timeoutUs / 1'000'000);
+        timeout.tv_nsec = (long) ((timeoutUs % 1'000'000) * 1000);
+        syscall (SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeoutUs >= 0 ? &timeout : nullptr, nullptr, 0);
+       #elif defined (_WIN32)
+        const auto timeoutMs = timeoutUs >= 0 ? (unsigned long) ((timeoutUs + 999) / 1000) : 0xffffffffUL;
+        WaitOnAddress (address, &expected, sizeof (expected), timeoutMs);
+       #else
+        if (timeoutUs >= 0)
+            os_sync_wait_on_address_with_timeout (address, (uint64_t) (uint32_t) expected, sizeof (expected), OS_SYNC_WAIT_ON_ADDRESS_NONE,
+                                                  OS_CLOCK_MACH_ABSOLUTE_TIME, (uint64_t) timeoutUs * 1000);
+        else
+            os_sync_wait_on_address (address, (uint64_t) (uint32_t) expected, sizeof (expected), OS_SYNC_WAIT_ON_ADDRESS_NONE);
+       #endif
+    }
+
+    /** Wakes up to a number of threads blocked in waitOnAddress. */
+    inline void wakeAddress (std::atomic<int32_t>& value, int numToWake)
+    {
+        auto address = reinterpret_cast<int32_t*> (&value);
+
+       #if defined (__linux__)
+        syscall (SYS_futex, address, FUTEX_WAKE_PRIVATE, numToWake, nullptr, nullptr, 0);
+       #elif defined (_WIN32)
+        for (int i = 0; i < numToWake; ++i)
+            WakeByAddressSingle (address);
+       #else
+        for (int i = 0; i < numToWake; ++i)
+            if (os_sync_wake_by_address_any (address, sizeof (int32_t), OS_SYNC_WAKE_BY_ADDRESS_NONE) != 0)
+                break;
+       #endif
+    }
+   #endif
+
+    //==============================================================================
+    /** The semaphore threads block on once they've finished spinning.
+        Each signal wakes a single waiter so signalling a few threads doesn't wake them all.
+    */
+    class WakeupSemaphore
+    {
+    public:
+        /** Takes a wakeup, blocking until one is available or the timeout expires.
+            @param timeoutUs    The maximum time to wait, or -1 to wait indefinitely
+        */
+        bool wait (std::int64_t timeoutUs)
+        {
+           #if TRACKTION_ADDRESS_WAIT
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds (std::max (timeoutUs, (std::int64_t) 0));
+
+            for (;;)
+            {
+                if (tryWait())
+                    return true;
+
+                std::int64_t remainingUs = -1;
+
+                if (timeoutUs >= 0)
+                {
+                    remainingUs = std::chrono::duration_cast<std::chrono::microseconds> (deadline - std::chrono::steady_clock::now()).count();
+
+                    if (remainingUs <= 0)
+                        return false;
+                }
+
+                waitOnAddress (numWakeups, 0, remainingUs);
+            }
+           #else
+            return timeoutUs < 0 ? semaphore.wait()
+                                 : semaphore.timed_wait ((std::uint64_t) timeoutUs);
+           #endif
+        }
+
+        /** Takes a wakeup if one is available. */
+        bool tryWait()
+        {
+           #if TRACKTION_ADDRESS_WAIT
+            auto num = numWakeups.load (std::memory_order_relaxed);
+
+            while (num > 0)
+                if (numWakeups.compare_exchange_weak (num, num - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+
+            return false;
+           #else
+            return semaphore.try_wait();
+           #endif
+        }
+
+        /** Adds some wakeups, unblocking that many waiting threads. */
+        void signal (int count)
+        {
+           #if TRACKTION_ADDRESS_WAIT
+            numWakeups.fetch_add (count, std::memory_order_release);
+            wakeAddress (numWakeups, count);
+           #else
+            semaphore.signal (count);
+           #endif
+        }
+
+    private:
+       #if TRACKTION_ADDRESS_WAIT
+        std::atomic<int32_t> numWakeups { 0 };
+       #else
+        moodycamel::details::Semaphore semaphore;
+       #endif
+    };
+}
+
+//==============================================================================
+struct LightweightSemaphore::Pimpl
+{
+    Pimpl (int initialCount)
+        : count (initialCount)
+    {
+        assert (initialCount >= 0);
+    }
+
+    bool tryWait()
+    {
+        auto oldCount = count.load (std::memory_order_relaxed);
+
+        while (oldCount > 0)
+            if (count.compare_exchange_weak (oldCount, oldCount - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+
+        return false;
+    }
+
+    bool wait (std::int64_t timeoutUs)
+    {
+        return tryWait() || waitWithSpinning (timeoutUs);
+    }
+
+    void signal (int numToSignal)
+    {
+        assert (numToSignal >= 0);
+        const auto oldCount = count.fetch_add (numToSignal, std::memory_order_release);
+
+        // Only the threads that have given up spinning need waking
+        if (const auto numToRelease = std::min ((std::int64_t) numToSignal, -oldCount); numToRelease > 0)
+            wakeups.signal ((int) numToRelease);
+    }
+
+private:
+    static constexpr int minSpins = 16, maxSpins = 10'000;
+
+    // Blocks shorter than this would probably have been avoided by spinning for longer
+    static constexpr auto shortBlockTime = std::chrono::microseconds (20);
+
+    std::atomic<std::int64_t> count;
+    std::atomic<int> numSpins { 1000 };
+    detail::WakeupSemaphore wakeups;
+
+    void adaptSpinCount (int targetSpins)
+    {
+        // Moves an eighth of the way to the target each time so one odd wait doesn't swing it
+        const auto current = numSpins.load (std::memory_order_relaxed);
+        numSpins.store (current + (std::clamp (targetSpins, minSpins, maxSpins) - current) / 8, std::memory_order_relaxed);
+    }
+
+    bool waitWithSpinning (std::int64_t timeoutUs)
+    {
+        const auto spinsToUse = numSpins.load (std::memory_order_relaxed);
+
+        for (int spin = 0; spin < spinsToUse; ++spin)
+        {
+            auto oldCount = count.load (std::memory_order_relaxed);
+
+            if (oldCount > 0 && count.compare_exchange_strong (oldCount, oldCount - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                adaptSpinCount (spin * 2);
+                return true;
+            }
+
+            tracktion::core::pause();
+        }
+
+        if (count.fetch_sub (1, std::memory_order_acquire) > 0)
+            return true;
+
+        if (timeoutUs != 0)
+        {
+            const auto blockStart = std::chrono::steady_clock::now();
+
+            if (wakeups.wait (timeoutUs))
+            {
+                const bool wasShortBlock = std::chrono::steady_clock::now() - blockStart < shortBlockTime;
+                adaptSpinCount (wasShortBlock ? maxSpins : minSpins);
+                return true;
+            }
+        }
+
+        // The wait timed out but the count is still decremented so this has to be
+        // undone, unless a signal has arrived since, in which case take that wakeup
+        for (;;)
+        {
+            auto oldCount = count.load (std::memory_order_acquire);
+
+            if (oldCount >= 0 && wakeups.tryWait())
+                return true;
+
+            if (oldCount < 0 && count.compare_exchange_strong (oldCount, oldCount + 1, std::memory_order_relaxed, std::memory_order_relaxed))
+                return false;
+        }
+    }
+};
+
 //==============================================================================
 LightweightSemaphore::LightweightSemaphore (int initialCount)
 {
-    pimpl = std::make_unique<moodycamel::LightweightSemaphore> (initialCount);
+    pimpl = std::make_unique<Pimpl> (initialCount);
 }
 
 LightweightSemaphore::~LightweightSemaphore()
@@ -61,7 +316,7 @@ LightweightSemaphore::~LightweightSemaphore()
 
 bool LightweightSemaphore::wait()
 {
-    return pimpl->wait();
+    return pimpl->wait (-1);
 }
 
 bool LightweightSemaphore::try_wait()
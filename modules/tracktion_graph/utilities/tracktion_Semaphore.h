@@ -12,7 +12,6 @@
 
 namespace moodycamel
 {
-    class LightweightSemaphore;
     namespace details { class Semaphore; }
 }
 
@@ -75,6 +74,12 @@ private:
 /**
     A counting semaphore that spins on a atomic before waiting so will avoid
     system calls if wait periods are very short.
+
+    The number of spins adapts to how long previous waits took: waits that were
+    satisfied quickly increase it, waits that blocked for a long time reduce it.
+    Blocking waits use futexes on Linux, WaitOnAddress on Windows and
+    os_sync_wait_on_address on macOS 14.4+, falling back to a system semaphore
+    elsewhere, and signalling wakes only as many waiters as the count allows.
 */
 class LightweightSemaphore
 {
@@ -115,7 +120,8 @@ public:
 
 private:
     //==============================================================================
-    std::unique_ptr<moodycamel::LightweightSemaphore> pimpl;
+    struct Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
 
     LightweightSemaphore(const LightweightSemaphore&) = delete;
     LightweightSemaphore& operator= (const LightweightSemaphore& other) = delete;
@@ -0,0 +1,192 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#if TRACKTION_ARM && __has_include(<arm_neon.h>)
+ #include <arm_neon.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Vectorised kernels for summing a number of inputs in to a destination in a
+    single pass. Each block of samples of the destination is loaded in to a register
+    once, all the sources added to it and then stored again, rather than reading and
+    writing the whole destination once per source.
+
+    Sources are added in order so the results are identical to adding them one by one.
+
+    These use AVX if it's enabled at compile time, else SSE2 on x86 and NEON on ARM,
+    with a scalar fallback for anything else.
+*/
+namespace summing_kernels
+{
+    /** Adds the given number of sources to dest. */
+    inline void addMultiple (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept;
+
+    /** Sums the sources in double precision and then adds the result to dest. */
+    inline void addMultipleWithDoubleAccumulation (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept;
+
+    /** Scalar versions of the above, mainly useful to compare against. */
+    inline void addMultipleScalar (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept;
+
+    inline void addMultipleWithDoubleAccumulationScalar (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept;
+}
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+
+namespace summing_kernels
+{
+    namespace detail
+    {
+        inline void addRange (float* dest, const float* const* sources, size_t numSources, size_t startSample, size_t endSample) noexcept
+        {
+            for (size_t i = startSample; i < endSample; ++i)
+            {
+                auto sum = dest[i];
+
+                for (size_t s = 0; s < numSources; ++s)
+                    sum += sources[s][i];
+
+                dest[i] = sum;
+            }
+        }
+
+        inline void addRangeWithDoubleAccumulation (float* dest, const float* const* sources, size_t numSources, size_t startSample, size_t endSample) noexcept
+        {
+            for (size_t i = startSample; i < endSample; ++i)
+            {
+                double sum = 0.0;
+
+                for (size_t s = 0; s < numSources; ++s)
+                    sum += (double) sources[s][i];
+
+                dest[i] += (float) sum;
+            }
+        }
+    }
+
+    inline void addMultipleScalar (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept
+    {
+        detail::addRange (dest, sources, numSources, 0, numSamples);
+    }
+
+    inline void addMultipleWithDoubleAccumulationScalar (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept
+    {
+        detail::addRangeWithDoubleAccumulation (dest, sources, numSources, 0, numSamples);
+    }
+
+    //==============================================================================
+    inline void addMultiple (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if defined (__AVX__)
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            auto sum = _mm256_loadu_ps (dest + i);
+
+            for (size_t s = 0; s < numSources; ++s)
+                sum = _mm256_add_ps (sum, _mm256_loadu_ps (sources[s] + i));
+
+            _mm256_storeu_ps (dest + i, sum);
+        }
+       #endif
+
+       #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto sum = _mm_loadu_ps (dest + i);
+
+            for (size_t s = 0; s < numSources; ++s)
+                sum = _mm_add_ps (sum, _mm_loadu_ps (sources[s] + i));
+
+            _mm_storeu_ps (dest + i, sum);
+        }
+       #elif TRACKTION_ARM && defined (__ARM_NEON)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto sum = vld1q_f32 (dest + i);
+
+            for (size_t s = 0; s < numSources; ++s)
+                sum = vaddq_f32 (sum, vld1q_f32 (sources[s] + i));
+
+            vst1q_f32 (dest + i, sum);
+        }
+       #endif
+
+        detail::addRange (dest, sources, numSources, i, numSamples);
+    }
+
+    inline void addMultipleWithDoubleAccumulation (float* dest, const float* const* sources, size_t numSources, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if defined (__AVX__)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto sum = _mm256_setzero_pd();
+
+            for (size_t s = 0; s < numSources; ++s)
+                sum = _mm256_add_pd (sum, _mm256_cvtps_pd (_mm_loadu_ps (sources[s] + i)));
+
+            _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), _mm256_cvtpd_ps (sum)));
+        }
+       #elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto sumLow = _mm_setzero_pd(), sumHigh = _mm_setzero_pd();
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                const auto source = _mm_loadu_ps (sources[s] + i);
+                sumLow = _mm_add_pd (sumLow, _mm_cvtps_pd (source));
+                sumHigh = _mm_add_pd (sumHigh, _mm_cvtps_pd (_mm_movehl_ps (source, source)));
+            }
+
+            const auto sum = _mm_movelh_ps (_mm_cvtpd_ps (sumLow), _mm_cvtpd_ps (sumHigh));
+            _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), sum));
+        }
+       #elif TRACKTION_ARM && defined (__ARM_NEON) && defined (__aarch64__)
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto sumLow = vdupq_n_f64 (0.0), sumHigh = vdupq_n_f64 (0.0);
+
+            for (size_t s = 0; s < numSources; ++s)
+            {
+                const auto source = vld1q_f32 (sources[s] + i);
+                sumLow = vaddq_f64 (sumLow, vcvt_f64_f32 (vget_low_f32 (source)));
+                sumHigh = vaddq_f64 (sumHigh, vcvt_high_f64_f32 (source));
+            }
+
+            const auto sum = vcvt_high_f32_f64 (vcvt_f32_f64 (sumLow), sumHigh);
+            vst1q_f32 (dest + i, vaddq_f32 (vld1q_f32 (dest + i), sum));
+        }
+       #endif
+
+        detail::addRangeWithDoubleAccumulation (dest, sources, numSources, i, numSamples);
+    }
+}
+
+}}
@@ -0,0 +1,209 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNELS || (TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING)
+
+namespace summing_kernels_test_utilities
+{
+    struct Inputs
+    {
+        Inputs (size_t numInputs, choc::buffer::Size size, juce::Random& r)
+        {
+            for (size_t i = 0; i < numInputs; ++i)
+            {
+                auto& buffer = buffers.emplace_back (size);
+                setAllSamples (buffer.getView(), [&r] { return r.nextFloat() * 2.0f - 1.0f; });
+            }
+        }
+
+        std::vector<const float*> getChannelPointers (choc::buffer::ChannelCount channel) const
+        {
+            std::vector<const float*> pointers;
+
+            for (auto& b : buffers)
+                pointers.push_back (b.getView().getChannel (channel).data.data);
+
+            return pointers;
+        }
+
+        std::vector<choc::buffer::ChannelArrayBuffer<float>> buffers;
+    };
+}
+
+#endif
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNELS
+
+class SummingKernelsTests  : public juce::UnitTest
+{
+public:
+    SummingKernelsTests()
+        : juce::UnitTest ("SummingKernels", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        for (size_t numInputs : { 0, 1, 2, 3, 17, 64 })
+            for (choc::buffer::FrameCount numFrames : { 1u, 3u, 4u, 7u, 8u, 31u, 512u })
+                runComparisonTests (numInputs, numFrames);
+    }
+
+private:
+    void runComparisonTests (size_t numInputs, choc::buffer::FrameCount numFrames)
+    {
+        beginTest ("Inputs: " + juce::String (numInputs) + ", frames: " + juce::String (numFrames));
+
+        auto r = getRandom();
+        summing_kernels_test_utilities::Inputs inputs (numInputs, choc::buffer::Size::create (1u, numFrames), r);
+        auto sources = inputs.getChannelPointers (0);
+
+        choc::buffer::ChannelArrayBuffer<float> initial (1u, numFrames);
+        setAllSamples (initial.getView(), [&r] { return r.nextFloat(); });
+
+        // Single precision should exactly match adding each input in turn
+        {
+            choc::buffer::ChannelArrayBuffer<float> expected (initial), actual (initial);
+
+            for (auto& b : inputs.buffers)
+                add (expected.getView(), b.getView());
+
+            summing_kernels::addMultiple (actual.getView().getChannel (0).data.data, sources.data(), sources.size(), numFrames);
+            expect (contentMatches (expected.getView(), actual.getView()));
+        }
+
+        // Double precision should exactly match summing to a double buffer then adding that
+        {
+            choc::buffer::ChannelArrayBuffer<float> expected (initial), actual (initial);
+            choc::buffer::ChannelArrayBuffer<double> doubleSum (1u, numFrames);
+            doubleSum.clear();
+
+            for (auto& b : inputs.buffers)
+                add (doubleSum.getView(), b.getView());
+
+            add (expected.getView(), doubleSum.getView());
+
+            summing_kernels::addMultipleWithDoubleAccumulation (actual.getView().getChannel (0).data.data, sources.data(), sources.size(), numFrames);
+            expect (contentMatches (expected.getView(), actual.getView()));
+        }
+    }
+};
+
+static SummingKernelsTests summingKernelsTests;
+
+#endif
+
+//==============================================================================
+//==============================================================================
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING
+
+class SummingKernelsBenchmarks  : public juce::UnitTest
+{
+public:
+    SummingKernelsBenchmarks()
+        : juce::UnitTest ("SummingKernels", "tracktion_benchmarks") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        for (size_t numInputs : { 2, 16, 64 })
+            runBenchmarks (numInputs, { 2, 512 });
+    }
+
+private:
+    void runBenchmarks (size_t numInputs, choc::buffer::Size size)
+    {
+        beginTest ("Summing " + juce::String (numInputs) + " inputs");
+
+        juce::Random r (42);
+        summing_kernels_test_utilities::Inputs inputs (numInputs, size, r);
+        choc::buffer::ChannelArrayBuffer<float> dest (size);
+        choc::buffer::ChannelArrayBuffer<double> doubleDest (size);
+
+        const auto description = std::to_string (numInputs) + " inputs, "
+                                    + std::to_string (size.numChannels) + " channels, "
+                                    + std::to_string (size.numFrames) + " frames";
+        constexpr int numRuns = 10'000;
+
+        auto runBenchmark = [&] (std::string name, auto&& fn)
+        {
+            Benchmark benchmark (createBenchmarkDescription ("Summing", std::move (name), description));
+            dest.clear();
+
+            for (int i = 0; i < numRuns; ++i)
+            {
+                benchmark.start();
+                fn();
+                benchmark.stop();
+            }
+
+            BenchmarkList::getInstance().addResult (benchmark.getResult());
+        };
+
+        std::vector<std::vector<const float*>> channelSources;
+
+        for (choc::buffer::ChannelCount c = 0; c < size.numChannels; ++c)
+            channelSources.push_back (inputs.getChannelPointers (c));
+
+        runBenchmark ("Sum: choc::buffer::add", [&]
+        {
+            for (auto& b : inputs.buffers)
+                add (dest.getView(), b.getView());
+        });
+
+        runBenchmark ("Sum: scalar", [&]
+        {
+            for (choc::buffer::ChannelCount c = 0; c < size.numChannels; ++c)
+                summing_kernels::addMultipleScalar (dest.getView().getChannel (c).data.data,
+                                                    channelSources[c].data(), numInputs, size.numFrames);
+        });
+
+        runBenchmark ("Sum: SIMD", [&]
+        {
+            for (choc::buffer::ChannelCount c = 0; c < size.numChannels; ++c)
+                summing_kernels::addMultiple (dest.getView().getChannel (c).data.data,
+                                              channelSources[c].data(), numInputs, size.numFrames);
+        });
+
+        runBenchmark ("Sum double: choc::buffer::add", [&]
+        {
+            doubleDest.clear();
+
+            for (auto& b : inputs.buffers)
+                add (doubleDest.getView(), b.getView());
+
+            add (dest.getView(), doubleDest.getView());
+        });
+
+        runBenchmark ("Sum double: scalar", [&]
+        {
+            for (choc::buffer::ChannelCount c = 0; c < size.numChannels; ++c)
+                summing_kernels::addMultipleWithDoubleAccumulationScalar (dest.getView().getChannel (c).data.data,
+                                                                          channelSources[c].data(), numInputs, size.numFrames);
+        });
+
+        runBenchmark ("Sum double: SIMD", [&]
+        {
+            for (choc::buffer::ChannelCount c = 0; c < size.numChannels; ++c)
+                summing_kernels::addMultipleWithDoubleAccumulation (dest.getView().getChannel (c).data.data,
+                                                                    channelSources[c].data(), numInputs, size.numFrames);
+        });
+
+        expect (true);
+    }
+};
+
+static SummingKernelsBenchmarks summingKernelsBenchmarks;
+
+#endif
+
+}}
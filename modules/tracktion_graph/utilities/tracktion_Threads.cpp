@@ -14,6 +14,12 @@
  #include <windows.h>
 #endif
 
+#if JUCE_LINUX
+ #include <fstream>
+ #include <sstream>
+ #include <sched.h>
+#endif
+
 namespace tracktion { inline namespace graph
 {
 
@@ -119,4 +125,126 @@ bool setThreadPriority (std::thread& t, int priority)
     return setThreadPriority (t.native_handle(), priority);
 }
 
+//==============================================================================
+#if JUCE_LINUX
+namespace affinity_helpers
+{
+    /** Parses a sysfs CPU list such as "0-3,8,10-11". */
+    inline std::vector<int> parseCPUList (const std::string& list)
+    {
+        std::vector<int> cpus;
+        std::istringstream is (list);
+
+        for (std::string range; std::getline (is, range, ',');)
+        {
+            if (range.empty() || ! std::isdigit ((unsigned char) range[0]))
+                continue;
+
+            const auto dash = range.find ('-');
+            const int first = std::stoi (range.substr (0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi (range.substr (dash + 1));
+
+            for (int cpu = first; cpu <= last; ++cpu)
+                cpus.push_back (cpu);
+        }
+
+        return cpus;
+    }
+
+    inline std::optional<std::vector<int>> readCPUList (const std::string& path)
+    {
+        std::ifstream file (path);
+        std::string list;
+
+        if (! std::getline (file, list))
+            return std::nullopt;
+
+        return parseCPUList (list);
+    }
+
+    inline bool contains (const std::vector<int>& cpus, int cpu)
+    {
+        return std::find (cpus.begin(), cpus.end(), cpu) != cpus.end();
+    }
+}
+
+std::vector<int> ThreadAffinityPolicy::getCoresToUse() const
+{
+    using namespace affinity_helpers;
+    auto candidates = cores;
+
+    if (candidates.empty())
+    {
+        if (auto online = readCPUList ("/sys/devices/system/cpu/online"))
+        {
+            candidates = std::move (*online);
+        }
+        else
+        {
+            for (int i = 0; i < (int) std::thread::hardware_concurrency(); ++i)
+                candidates.push_back (i);
+        }
+    }
+
+    if (preferredNumaNode >= 0)
+    {
+        if (auto nodeCPUs = readCPUList ("/sys/devices/system/node/node" + std::to_string (preferredNumaNode) + "/cpulist"))
+            candidates.erase (std::remove_if (candidates.begin(), candidates.end(),
+                                              [&] (int cpu) { return ! contains (*nodeCPUs, cpu); }),
+                              candidates.end());
+    }
+
+    if (avoidSMTSiblings)
+    {
+        // Only keep a core if it's the first of its siblings
+        candidates.erase (std::remove_if (candidates.begin(), candidates.end(),
+                                          [] (int cpu)
+                                          {
+                                              auto siblings = readCPUList ("/sys/devices/system/cpu/cpu" + std::to_string (cpu) + "/topology/thread_siblings_list");
+                                              return siblings && ! siblings->empty() && siblings->front() != cpu;
+                                          }),
+                          candidates.end());
+    }
+
+    return candidates;
+}
+
+bool setThreadAffinity (std::thread& t, int core)
+{
+    if (core < 0 || core >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t cpuSet;
+    CPU_ZERO (&cpuSet);
+    CPU_SET ((size_t) core, &cpuSet);
+
+    return pthread_setaffinity_np (t.native_handle(), sizeof (cpuSet), &cpuSet) == 0;
+}
+#elif defined (_WIN32)
+std::vector<int> ThreadAffinityPolicy::getCoresToUse() const
+{
+    // Topology isn't queried here so only explicit cores are used
+    return cores;
+}
+
+bool setThreadAffinity (std::thread& t, int core)
+{
+    if (core < 0 || core >= (int) (sizeof (DWORD_PTR) * 8))
+        return false;
+
+    return SetThreadAffinityMask ((HANDLE) t.native_handle(), DWORD_PTR (1) << core) != 0;
+}
+#else
+std::vector<int> ThreadAffinityPolicy::getCoresToUse() const
+{
+    // Threads can't be pinned on this platform
+    return {};
+}
+
+bool setThreadAffinity (std::thread&, int)
+{
+    return false;
+}
+#endif
+
 }} // namespace tracktion_engine
@@ -25,4 +25,37 @@ bool setThreadPriority (std::thread&, int priority);
 /** Tries to upgrade the current thread to realtime priority. */
 bool tryToUpgradeCurrentThreadToRealtime (const juce::Thread::RealtimeOptions&);
 
+//==============================================================================
+/** Describes which CPU cores a set of threads should be run on. */
+struct ThreadAffinityPolicy
+{
+    /** The logical cores to pin threads to, these are assigned to threads in turn.
+        If this is empty, all the cores allowed by the other options will be used.
+    */
+    std::vector<int> cores;
+
+    /** If true, only the first logical core of each physical core will be used so
+        threads don't compete for the same execution units.
+    */
+    bool avoidSMTSiblings = false;
+
+    /** If this is 0 or more, only cores on this NUMA node will be used. */
+    int preferredNumaNode = -1;
+
+    /** Returns true if this doesn't restrict the threads in any way. */
+    bool isDefault() const      { return cores.empty() && ! avoidSMTSiblings && preferredNumaNode < 0; }
+
+    /** Returns the logical cores threads should be assigned to, in order.
+        This reads the system topology so shouldn't be called from a real-time thread.
+        It may return an empty list if the policy can't be applied on this platform,
+        in which case threads shouldn't be pinned.
+    */
+    std::vector<int> getCoresToUse() const;
+};
+
+/** Pins a thread to a single logical core.
+    May return false if this isn't supported on this platform or the core isn't available.
+*/
+bool setThreadAffinity (std::thread&, int core);
+
 }} // namespace tracktion_engine
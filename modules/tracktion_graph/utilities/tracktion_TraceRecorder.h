@@ -0,0 +1,302 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#include <iomanip>
+#include <ostream>
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Records timed spans from any thread and writes them out in the Chrome
+    trace-event JSON format. This can then be loaded in to chrome://tracing or
+    https://ui.perfetto.dev to view a timeline of processing on each thread.
+
+    Create one of these, call setActive with it and any TRACKTION_GRAPH_TRACE_SCOPE
+    macros will add a span to it (as long as TRACKTION_GRAPH_TRACING is enabled).
+    Spans are added to a lock-free FIFO so this is safe to use from real-time threads.
+
+    e.g. @code
+        TraceRecorder recorder;
+        TraceRecorder::setActive (&recorder);
+
+        // Play back for a while...
+
+        TraceRecorder::setActive (nullptr);
+        std::ofstream file ("trace.json");
+        recorder.writeChromeTrace (file);
+    @endcode
+*/
+class TraceRecorder
+{
+public:
+    //==============================================================================
+    /** Creates a TraceRecorder.
+        @param maxNumPendingEvents  The number of Events that can be added before they
+                                    are collected. Events are collected when writing or
+                                    when collectPendingEvents is called.
+    */
+    TraceRecorder (size_t maxNumPendingEvents = 65536);
+
+    /** Destructor.
+        If this is the active recorder, it will be deactivated. Make sure you've
+        stopped any threads that might be adding to it before deleting it.
+    */
+    ~TraceRecorder();
+
+    //==============================================================================
+    /** Sets the recorder that spans will be added to, or nullptr to stop recording. */
+    static void setActive (TraceRecorder*);
+
+    /** Returns the recorder that spans are being added to, if any. */
+    static TraceRecorder* getActive();
+
+    //==============================================================================
+    /** A single timed span. */
+    struct Event
+    {
+        const char* name = nullptr;         /**< Must be a string literal or outlive the recorder. */
+        const char* category = nullptr;     /**< Must be a string literal or outlive the recorder. */
+        size_t id = 0;                      /**< An optional ID e.g. a nodeID. */
+        std::thread::id threadID;
+        std::chrono::steady_clock::time_point startTime, endTime;
+    };
+
+    /** Adds an Event to be written.
+        This is real-time safe and can be called from any thread.
+        @returns false if the FIFO was full and the Event was dropped
+    */
+    bool addEvent (const Event&) noexcept;
+
+    /** Returns the number of Events that have been dropped because the FIFO was full. */
+    size_t getNumDroppedEvents() const;
+
+    /** Moves any pending Events to the recorded list, freeing up space in the FIFO.
+        This isn't real-time safe so call it periodically from a background thread
+        if you're recording for long periods.
+    */
+    void collectPendingEvents();
+
+    /** Returns the number of Events that have been collected. */
+    size_t getNumEvents();
+
+    /** Removes all the Events added so far. */
+    void clear();
+
+    //==============================================================================
+    /** Collects any pending Events and writes all the Events recorded so far as
+        Chrome trace-event JSON.
+    */
+    void writeChromeTrace (std::ostream&);
+
+private:
+    //==============================================================================
+    rigtorp::MPMCQueue<Event> pendingEvents;
+    std::atomic<size_t> numDroppedEvents { 0 };
+    const std::chrono::steady_clock::time_point creationTime { std::chrono::steady_clock::now() };
+
+    std::mutex eventsMutex;
+    std::vector<Event> events;
+
+    static std::atomic<TraceRecorder*>& getActiveRecorder();
+    static void writeEscaped (std::ostream&, const char*);
+};
+
+
+//==============================================================================
+//==============================================================================
+/**
+    Adds a span from construction to destruction to the active TraceRecorder.
+    If there is no active recorder this does nothing.
+    You'll usually use this via TRACKTION_GRAPH_TRACE_SCOPE so it's compiled out
+    unless TRACKTION_GRAPH_TRACING is enabled.
+*/
+struct ScopedTraceEvent
+{
+    ScopedTraceEvent (const char* name, const char* category, size_t id = 0) noexcept;
+    ~ScopedTraceEvent() noexcept;
+
+    TraceRecorder* const recorder;
+    TraceRecorder::Event event;
+};
+
+#if TRACKTION_GRAPH_TRACING
+ #define TRACKTION_GRAPH_TRACE_SCOPE(name, category, id) \
+    const tracktion::graph::ScopedTraceEvent JUCE_JOIN_MACRO (scopedTraceEvent_, __LINE__) (name, category, id);
+#else
+ #define TRACKTION_GRAPH_TRACE_SCOPE(name, category, id)
+#endif
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+
+inline TraceRecorder::TraceRecorder (size_t maxNumPendingEvents)
+    : pendingEvents (std::max ((size_t) 1, maxNumPendingEvents))
+{
+}
+
+inline TraceRecorder::~TraceRecorder()
+{
+    auto self = this;
+    getActiveRecorder().compare_exchange_strong (self, nullptr, std::memory_order_acq_rel);
+}
+
+inline void TraceRecorder::setActive (TraceRecorder* recorder)
+{
+    getActiveRecorder().store (recorder, std::memory_order_release);
+}
+
+inline TraceRecorder* TraceRecorder::getActive()
+{
+    return getActiveRecorder().load (std::memory_order_acquire);
+}
+
+inline bool TraceRecorder::addEvent (const Event& event) noexcept
+{
+    if (pendingEvents.try_push (event))
+        return true;
+
+    numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+    return false;
+}
+
+inline size_t TraceRecorder::getNumDroppedEvents() const
+{
+    return numDroppedEvents.load (std::memory_order_relaxed);
+}
+
+inline void TraceRecorder::collectPendingEvents()
+{
+    const std::scoped_lock sl (eventsMutex);
+
+    for (Event event; pendingEvents.try_pop (event);)
+        events.push_back (event);
+}
+
+inline size_t TraceRecorder::getNumEvents()
+{
+    const std::scoped_lock sl (eventsMutex);
+    return events.size();
+}
+
+inline void TraceRecorder::clear()
+{
+    const std::scoped_lock sl (eventsMutex);
+
+    for (Event event; pendingEvents.try_pop (event);)
+    {}
+
+    events.clear();
+    numDroppedEvents.store (0, std::memory_order_relaxed);
+}
+
+inline void TraceRecorder::writeChromeTrace (std::ostream& os)
+{
+    collectPendingEvents();
+
+    const std::scoped_lock sl (eventsMutex);
+
+    // Use small sequential thread IDs so they're easy to read in the viewer
+    std::unordered_map<std::thread::id, int> threadIndices;
+
+    auto toMicroseconds = [] (auto duration) { return std::chrono::duration<double, std::micro> (duration).count(); };
+
+    const auto oldFlags = os.flags();
+    const auto oldPrecision = os.precision (3);
+    os << std::fixed << "{\"traceEvents\":[";
+    bool isFirst = true;
+
+    for (auto& event : events)
+    {
+        auto [threadIter, isNewThread] = threadIndices.emplace (event.threadID, (int) threadIndices.size() + 1);
+        const auto tid = threadIter->second;
+
+        if (isNewThread)
+        {
+            os << (isFirst ? "\n" : ",\n")
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+               << ",\"args\":{\"name\":\"Thread " << tid << "\"}}";
+            isFirst = false;
+        }
+
+        os << (isFirst ? "\n" : ",\n") << "{\"name\":\"";
+        writeEscaped (os, event.name);
+        os << "\",\"cat\":\"";
+        writeEscaped (os, event.category);
+        os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+           << ",\"ts\":" << toMicroseconds (event.startTime - creationTime)
+           << ",\"dur\":" << toMicroseconds (event.endTime - event.startTime)
+           << ",\"args\":{\"id\":" << event.id << "}}";
+        isFirst = false;
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    os.flags (oldFlags);
+    os.precision (oldPrecision);
+}
+
+inline std::atomic<TraceRecorder*>& TraceRecorder::getActiveRecorder()
+{
+    static std::atomic<TraceRecorder*> activeRecorder { nullptr };
+    return activeRecorder;
+}
+
+inline void TraceRecorder::writeEscaped (std::ostream& os, const char* text)
+{
+    if (text == nullptr)
+        return;
+
+    for (auto c = text; *c != 0; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            os << '\\';
+
+        os << *c;
+    }
+}
+
+//==============================================================================
+inline ScopedTraceEvent::ScopedTraceEvent (const char* name, const char* category, size_t id) noexcept
+    : recorder (TraceRecorder::getActive())
+{
+    if (recorder == nullptr)
+        return;
+
+    event.name = name;
+    event.category = category;
+    event.id = id;
+    event.startTime = std::chrono::steady_clock::now();
+}
+
+inline ScopedTraceEvent::~ScopedTraceEvent() noexcept
+{
+    if (recorder == nullptr)
+        return;
+
+    event.endTime = std::chrono::steady_clock::now();
+    event.threadID = std::this_thread::get_id();
+    recorder->addEvent (event);
+}
+
+}}
@@ -0,0 +1,91 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_TRACERECORDER
+
+class TraceRecorderTests  : public juce::UnitTest
+{
+public:
+    TraceRecorderTests()
+        : juce::UnitTest ("TraceRecorder", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        beginTest ("Recording");
+        {
+            TraceRecorder recorder;
+
+            {
+                const ScopedTraceEvent ste ("inactive", "test");
+            }
+
+            expectEquals<int> ((int) recorder.getNumEvents(), 0);
+
+            TraceRecorder::setActive (&recorder);
+            expect (TraceRecorder::getActive() == &recorder);
+
+            {
+                const ScopedTraceEvent ste ("main", "test", 42);
+            }
+
+            std::thread ([] { const ScopedTraceEvent ste ("other \"thread\"", "test"); }).join();
+
+            recorder.collectPendingEvents();
+            expectEquals<int> ((int) recorder.getNumEvents(), 2);
+
+            std::ostringstream os;
+            recorder.writeChromeTrace (os);
+            const auto json = juce::JSON::parse (os.str());
+
+            auto events = json["traceEvents"];
+            expect (events.isArray());
+
+            int numSpans = 0;
+            juce::StringArray names;
+
+            for (auto& e : *events.getArray())
+            {
+                if (e["ph"].toString() == "X")
+                {
+                    ++numSpans;
+                    names.add (e["name"].toString());
+                }
+            }
+
+            expectEquals (numSpans, 2);
+            expect (names.contains ("main"));
+            expect (names.contains ("other \"thread\""));
+            expectEquals ((int) events[1]["args"]["id"], 42);
+
+            recorder.clear();
+            expectEquals<int> ((int) recorder.getNumEvents(), 0);
+        }
+
+        beginTest ("Deactivating");
+        {
+            {
+                TraceRecorder recorder;
+                TraceRecorder::setActive (&recorder);
+            }
+
+            expect (TraceRecorder::getActive() == nullptr);
+        }
+    }
+};
+
+static TraceRecorderTests traceRecorderTests;
+
+#endif
+
+}}
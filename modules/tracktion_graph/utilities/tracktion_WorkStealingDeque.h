@@ -0,0 +1,141 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    A fixed capacity, lock-free, single-owner/multiple-thief deque.
+
+    This is a bounded version of the Chase-Lev work-stealing deque.
+    Only a single "owner" thread may call push and pop, these operate at the
+    LIFO end of the deque. Any number of other threads may call steal which
+    takes items from the FIFO end.
+
+    The capacity is fixed on construction (and rounded up to a power of two)
+    and no allocation happens after that, so this can be used on real-time threads.
+    If the deque is full, push will return false.
+
+    ItemType should be small and trivially copyable, usually a pointer.
+*/
+template<typename ItemType>
+class WorkStealingDeque
+{
+public:
+    /** Creates a deque that can hold at least the given number of items. */
+    WorkStealingDeque (size_t minCapacity)
+        : capacity (juce::nextPowerOfTwo ((int) std::max ((size_t) 1, minCapacity))),
+          mask ((int64_t) capacity - 1),
+          items (capacity)
+    {
+        static_assert (std::is_trivially_copyable_v<ItemType>);
+    }
+
+    /** Returns the number of items this deque can hold. */
+    size_t getCapacity() const
+    {
+        return capacity;
+    }
+
+    /** Returns true if there are no items in the deque.
+        This is only an approximation if called from a thief thread.
+    */
+    bool isEmpty() const
+    {
+        return bottom.load (std::memory_order_acquire) <= top.load (std::memory_order_acquire);
+    }
+
+    //==============================================================================
+    /** Pushes an item to the LIFO end of the deque.
+        This must only be called by the owner thread.
+        @returns false if the deque was full
+    */
+    bool push (ItemType item)
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        const auto t = top.load (std::memory_order_acquire);
+
+        if (b - t >= (int64_t) capacity)
+            return false;
+
+        items[(size_t) (b & mask)].store (item, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /** Pops an item from the LIFO end of the deque.
+        This must only be called by the owner thread.
+        @returns false if the deque was empty
+    */
+    bool pop (ItemType& item)
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Empty
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = items[(size_t) (b & mask)].load (std::memory_order_relaxed);
+
+        if (t != b)
+            return true;
+
+        // Last item so race any thieves for it
+        const bool won = top.compare_exchange_strong (t, t + 1,
+                                                      std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed);
+        bottom.store (b + 1, std::memory_order_relaxed);
+
+        return won;
+    }
+
+    /** Steals an item from the FIFO end of the deque.
+        This can be called from any thread.
+        @returns false if the deque was empty or the item was taken by another thread
+    */
+    bool steal (ItemType& item)
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        item = items[(size_t) (t & mask)].load (std::memory_order_relaxed);
+
+        return top.compare_exchange_strong (t, t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+private:
+    //==============================================================================
+    const size_t capacity;
+    const int64_t mask;
+    std::vector<std::atomic<ItemType>> items;
+
+    alignas(64) std::atomic<int64_t> top { 0 };
+    alignas(64) std::atomic<int64_t> bottom { 0 };
+};
+
+}}